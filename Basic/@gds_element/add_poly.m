@@ -11,6 +11,8 @@ function oelm = add_poly(ielm, xy)
 % Initial version, Ulf Griesmann, December 2011
 % extend to path elements; U. Griesmann, November 2012
 
+    ielm.data = lazy_decode(ielm.data);
+
     % works only with boundary and path elements
     if strcmp(get_etype(ielm.data.internal), 'boundary') || ...
             strcmp(get_etype(ielm.data.internal), 'path')
@@ -11,6 +11,9 @@ function [gelm] = and(gelm1, gelm2)
 
 % Ulf Griesmann, NIST, April 2014
 
+   gelm1.data = lazy_decode(gelm1.data);
+   gelm2.data = lazy_decode(gelm2.data);
+
    % global variables
    global gdsii_uunit;
    
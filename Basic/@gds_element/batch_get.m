@@ -0,0 +1,29 @@
+function [V] = batch_get(gelm, varargin)
+%function [V] = batch_get(gelm, varargin)
+%
+% batch_get :  returns a numeric property of many elements with
+%              a single call to get_element_data.
+%
+% gelm, varargin :  gds_element objects followed by the name of a
+%                   numeric property: plex, layer, dtype, ptype,
+%                   ttype, ntype, btype, width, font, verj, horj.
+% V :               row vector with the property values; NaN for
+%                   elements that do not have the property.
+%
+% Example:
+%          L = batch_get(gs.el{:}, 'layer');  % all layers of a structure
+
+% Initial version, October 2026
+
+    if isempty(varargin) || ~ischar(varargin{end})
+        error('gds_element.batch_get :  property name is missing.');
+    end
+
+    E = [{gelm}, varargin(1:end-1)];
+    I = cell(1, numel(E));
+    for k = 1:numel(E)
+        I{k} = E{k}.data.internal;
+    end
+    V = get_element_data(I, varargin{end});
+
+end
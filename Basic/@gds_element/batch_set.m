@@ -0,0 +1,34 @@
+function [E] = batch_set(gelm, varargin)
+%function [E] = batch_set(gelm, varargin)
+%
+% batch_set :  sets a numeric property of many elements with a
+%              single call to set_element_data, e.g. to remap the
+%              layers or data types of all elements in a structure.
+%
+% gelm, varargin :  gds_element objects followed by the name of a
+%                   numeric property (e.g. 'layer', 'dtype') and a
+%                   vector with one value per element, or a scalar.
+%                   Elements with a NaN value are not changed.
+% E :               cell array with the modified elements
+%
+% Example:
+%          L = batch_get(gs.el{:}, 'layer');
+%          E = batch_set(gs.el{:}, 'layer', L + 100);
+
+% Initial version, October 2026
+
+    if numel(varargin) < 2 || ~ischar(varargin{end-1})
+        error('gds_element.batch_set :  property name and values are missing.');
+    end
+
+    E = [{gelm}, varargin(1:end-2)];
+    I = cell(1, numel(E));
+    for k = 1:numel(E)
+        I{k} = E{k}.data.internal;
+    end
+    I = set_element_data(I, varargin{end-1}, double(varargin{end}));
+    for k = 1:numel(E)
+        E{k}.data.internal = I{k};
+    end
+
+end
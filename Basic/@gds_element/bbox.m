@@ -17,6 +17,8 @@ function [bbx] = bbox(gelm)
 
 % Initial version, Ulf Griesmann, November 2015
     
+    gelm.data = lazy_decode(gelm.data);
+
     switch etype(gelm)
         
       case 'boundary'
@@ -39,10 +41,7 @@ function [bbx] = bbox(gelm)
               ptype = get_element_data(gelm.data.internal, 'ptype');
           end
           
-          cab = cell(numel(gelm.data.xy),1);
-          for k = 1:numel(cab)
-              cab{k} = path_to_polygon(gelm.data.xy{k}, pwidth, ptype, ext);
-          end
+          cab = gds_pathpoly_mex(gelm.data.xy(:), [], pwidth, ptype, [ext.beg, ext.end]);
           bbx = calc_bbox(cab);
         
       case 'box'
@@ -4,6 +4,8 @@ function display(gelm)
 % display method for GDS elements
 %
 
+    gelm.data = lazy_decode(gelm.data);
+
     % print variable name
     fprintf('\n%s is a GDSII element:\n\n', inputname(1));
 
@@ -12,6 +12,8 @@ function lpidx = end(gelm, kide, nide)
 %         (should be 1)
 % lpidx : index of the last polygon or location
 
+    gelm.data = lazy_decode(gelm.data);
+
     if kide ~= 1 || nide ~= 1
         error('gds_element :  has only one index.');
     end
@@ -41,13 +41,15 @@ function gelm = gds_element(etype, varargin)
 %             Boundary element:
 %             -----------------
 %                xy :    a cell array of N x 2 matrices containing one or
-%                        more closed polygons with up to 8191 vertices. 
+%                        more closed polygons. Polygons with more than
+%                        8191 vertices are written as several XY records.
 %                nume :  number of polygons in the boundary element
 %
 %             Path element:
 %             -------------
 %                xy :    a cell array of N x 2 matrices describing one or 
-%                        more paths with up to 8191 vertex coordinates. 
+%                        more paths. Paths with more than 8191 vertices
+%                        are written as several XY records.
 %                ptype : path type 0,1, 2, or 4. Default is 0.
 %                width : width of the path in user units
 %                        Negative numbers imply absolute widths 
@@ -146,8 +148,9 @@ function gelm = gds_element(etype, varargin)
         
     end
     
-    % check critical element properties
-    if ~isfield(data, 'xy')
+    % check critical element properties; elements read in lazy
+    % mode have raw records instead of xy and prop (see lazy_decode)
+    if ~isfield(data, 'xy') && ~isfield(data, 'raw')
         if isref(data.internal)
             data.xy = [0,0];  % default [0,0] for reference elements
         else
@@ -160,7 +163,7 @@ function gelm = gds_element(etype, varargin)
     switch get_etype(data.internal)
         
       case {'boundary', 'path'}
-        if ~iscell(data.xy) 
+        if isfield(data, 'xy') && ~iscell(data.xy) 
             data.xy = {data.xy}; 
         end
         
@@ -6,7 +6,7 @@ function s = get(gelm, p)
 
     % called with only one argument, return a structure with all data
     if nargin == 1
-        s = gelm.data;
+        s = lazy_decode(gelm.data);
         return
     end
 
@@ -18,6 +18,7 @@ function s = get(gelm, p)
             s = get_etype(gelm.data.internal);
             
           case {'xy','path','prop','text'}
+            gelm.data = lazy_decode(gelm.data);
             s = gelm.data.(p);
             
           otherwise
@@ -13,6 +13,9 @@ function [gelm] = plus(gelm1, gelm2)
 
     % Ulf Griesmann, NIST, November 2012
 
+    gelm1.data = lazy_decode(gelm1.data);
+    gelm2.data = lazy_decode(gelm2.data);
+
     t1 = get_etype(gelm1.data.internal);
     t2 = get_etype(gelm2.data.internal);
     if ~strcmp(t1, t2)
@@ -10,6 +10,8 @@ function A = poly_area(bei)
 
 % Initial version, Ulf Griesmann, NIST, November 2016
 
+    bei.data = lazy_decode(bei.data);
+
     % check input element type
     if ~strcmp(get_etype(bei.data.internal), 'boundary')
         error('poly_area :  element must be a boundary element.');
@@ -26,7 +26,15 @@ function [bo] = poly_bool(ba, bb, op, varargin)
 %           'notb' -  set difference; points that are in ba and 
 %                     not in bb.
 % varargin :  property - value pairs that modify the properties of
-%             the output boundary element. 
+%             the output boundary element. In addition, the following
+%             options control the processing of large elements:
+%               'tiles'   -  [nx, ny] or n; the bounding box of the
+%                            polygons is divided into nx x ny tiles,
+%                            which are processed in parallel. This
+%                            is much faster for large elements, e.g.
+%                            for all polygons on a layer.
+%               'threads' -  number of threads used for the tiles.
+%                            Default is the number of processors.
 % bo :    output boundary element, the result of the boolean set
 %         operation. Can contain more than one polygon. By default,
 %         the output polygon is on the same layer as ba and has the 
@@ -45,11 +53,19 @@ function [bo] = poly_bool(ba, bb, op, varargin)
 % function currently exits with an error when the output polygons are
 % not all simple.
 %
-% 2) This function is based on the Clipper library by 
+% 2) With tiles, the result polygons that cross tile borders are 
+% merged after the tiles were processed. Polygon edges that cross
+% a tile border at an angle acquire an additional vertex on the
+% database grid.
+%
+% 3) This function is based on the Clipper library by 
 % Angus Johnson (www.angusj.com).
 
 % Initial version, Ulf Griesman, August 2012
 
+    ba.data = lazy_decode(ba.data);
+    bb.data = lazy_decode(bb.data);
+
     % global variables
     global gdsii_uunit;
 
@@ -77,8 +93,25 @@ function [bo] = poly_bool(ba, bb, op, varargin)
         udf = gdsii_uunit;      % conversion factor to db units
     end
     
+    % tiling options
+    tiles = [];
+    nthreads = [];
+    k = 1;
+    while k < numel(varargin)
+        switch varargin{k}
+          case 'tiles'
+            tiles = varargin{k+1};
+            varargin(k:k+1) = [];
+          case 'threads'
+            nthreads = varargin{k+1};
+            varargin(k:k+1) = [];
+          otherwise
+            k = k + 2;
+        end
+    end
+
     % apply boolean set operation
-    [xyo, hf] = poly_boolmex(ba.data.xy, bb.data.xy, op, udf);
+    [xyo, hf] = poly_boolmex(ba.data.xy, bb.data.xy, op, udf, tiles, nthreads);
     if any(hf)
         error('gds_element.poly_bool :  a polygon with a hole was created.');
     end
@@ -9,6 +9,8 @@ function pelm = poly_box(belm)
 
 % Initial version, Ulf Griesmann, December 2011
 
+    belm.data = lazy_decode(belm.data);
+
     % check if input is a box
     if ~strcmp(get_etype(belm.data.internal), 'box')
         error('gds_element.poly_box :  input must be box element.');
@@ -15,6 +15,8 @@ function beo = poly_cw(bei, makecw)
 
 % Initial version, Ulf Griesmann, NIST, November 2012
 
+    bei.data = lazy_decode(bei.data);
+
     % check arguments
     if ~strcmp(get_etype(bei.data.internal), 'boundary')
         error('poly_cw :  element must be a boundary element.');
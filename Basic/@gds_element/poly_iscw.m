@@ -12,6 +12,8 @@ function cw = poly_iscw(belm)
 
 % Initial version, Ulf Griesmann, NIST, November 2012
 
+    belm.data = lazy_decode(belm.data);
+
     % check argument
     if ~strcmp(get_etype(belm.data.internal), 'boundary')
         error('poly_iscw :  element must be a boundary element.');
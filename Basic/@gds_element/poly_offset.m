@@ -0,0 +1,131 @@
+function [bo] = poly_offset(ba, delta, varargin)
+%function [bo] = poly_offset(ba, delta, varargin)
+%
+% poly_offset - method for offsetting (sizing) the polygons of
+%               boundary elements.
+%
+%             bo = poly_offset(ba, delta)
+%
+%             IMPORTANT: user and database units must be defined
+%             before calls to 'poly_offset' either by creating the
+%             library object or with a call to 'gdsii_units'.
+%             This is necessary because the offset polygons
+%             are computed on the database grid.
+%
+% ba :    input boundary element. If ba is a compound element
+%         (i.e. contains more than one polygon) all polygons are
+%         merged before they are offset.
+% delta : offset in user units. The polygons grow when delta > 0
+%         and shrink when delta < 0.
+% varargin :  property - value pairs that modify the properties of
+%             the output boundary element. In addition, the following
+%             options control the offset operation:
+%               'join'    -  join type at the corners: 'miter' (default),
+%                            'round', or 'square'.
+%               'limit'   -  for miter joins, the maximum distance
+%                            of a mitered corner from the original
+%                            corner in multiples of delta (default is
+%                            2, the smallest value). For round joins,
+%                            the maximum deviation of the rounded
+%                            corners from a true arc in user units.
+%               'tiles'   -  [nx, ny] or n; the bounding box of the
+%                            polygons is divided into nx x ny tiles,
+%                            which are processed in parallel (see
+%                            poly_bool).
+%               'threads' -  number of threads used for the tiles.
+%                            Default is the number of processors.
+% bo :    output boundary element with the offset polygons. By
+%         default, the output polygons are on the same layer as ba
+%         and have the same data type. bo is empty when no polygon
+%         remains after shrinking.
+%
+% Example:
+%          out = poly_offset(metal, 0.5, 'join','round', 'layer',10);
+%
+%          returns a boundary element with the polygons of 'metal'
+%          enlarged by 0.5 user units and rounded corners on
+%          layer 10.
+%
+% NOTES:
+% 1) Offsetting can result in complex polygons containing holes.
+% The function exits with an error when the output polygons are
+% not all simple.
+%
+% 2) This function is based on the Clipper library by
+% Angus Johnson (www.angusj.com).
+
+% Initial version, October 2026
+
+    ba.data = lazy_decode(ba.data);
+
+    % global variables
+    global gdsii_uunit;
+
+    % check arguments
+    if nargin < 2
+        error('gds_element.poly_offset :  expecting at least 2 input arguments');
+    end
+
+    % only works with boundary elements
+    if ~strcmp(get_etype(ba.data.internal), 'boundary')
+        error('gds_element.poly_offset :  input element must be a boundary element');
+    end
+
+    % units must be defined
+    if isempty(gdsii_uunit)
+        warning('undefined GDSII units');
+        fprintf('\n  +--------- WARNING in gds_element.poly_offset -------+\n');
+        fprintf('  | Units are not defined; setting uunit/dbunit = 1000.|\n');
+        fprintf('  | Define units by creating the library object or     |\n');
+        fprintf('  | by first calling  gdsii_units.                     |\n');
+        fprintf('  +----------------------------------------------------+\n\n');
+        udf = 1000;
+    else
+        udf = gdsii_uunit;      % conversion factor to db units
+    end
+
+    % offset and tiling options
+    jtype = 'miter';
+    limit = [];
+    tiles = [];
+    nthreads = [];
+    k = 1;
+    while k < numel(varargin)
+        switch varargin{k}
+          case 'join'
+            jtype = varargin{k+1};
+            varargin(k:k+1) = [];
+          case 'limit'
+            limit = varargin{k+1};
+            varargin(k:k+1) = [];
+          case 'tiles'
+            tiles = varargin{k+1};
+            varargin(k:k+1) = [];
+          case 'threads'
+            nthreads = varargin{k+1};
+            varargin(k:k+1) = [];
+          otherwise
+            k = k + 2;
+        end
+    end
+
+    % offset the polygons
+    [xyo, hf] = poly_offsetmex(ba.data.xy, delta, udf, jtype, limit, tiles, nthreads);
+    if any(hf)
+        error('gds_element.poly_offset :  a polygon with a hole was created.');
+    end
+    if isempty(xyo)
+        bo = [];
+        return
+    end
+
+    % create a boundary element for the output polygons
+    bo = ba;
+    bo.data.xy = xyo;
+
+    % add any property arguments
+    if ~isempty(varargin)
+        bo.data.internal = set_element_data(bo.data.internal, varargin);
+    end
+
+end
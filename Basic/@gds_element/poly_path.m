@@ -10,6 +10,9 @@ function belm = poly_path(pelm)
 % Initial version, Ulf Griesmann, December 2011
 % Convert paths with multiple path segments; Ulf Griesmann, August2012
 % Convert to new internal data structure; Ulf Griesmann, July 2013
+% Convert all path segments with gds_pathpoly_mex, October 2026
+
+    pelm.data = lazy_decode(pelm.data);
 
     % check if input is a path
     if ~strcmp(get_etype(pelm.data.internal), 'path')
@@ -44,10 +47,7 @@ function belm = poly_path(pelm)
         ext = get_element_data(pelm.data.internal, 'ext');
     end
 
-    data.xy = cell(1,length(pelm.data.xy));
-    for k=1:length(pelm.data.xy)
-        data.xy{k} = path_to_polygon(pelm.data.xy{k}, width, ptype, ext);
-    end
+    data.xy = gds_pathpoly_mex(pelm.data.xy(:)', [], width, ptype, [ext.beg, ext.end]);
     
     % create new element
     belm = gds_element([], data); 
@@ -0,0 +1,77 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * decodes the XY and property records of an element that was
+ * read from a library file in lazy mode (see gds_read_element)
+ *
+ * [xy, prop] = decode_raw(internal, raw);
+ *
+ * Input:
+ * internal :  an array containing the internal element data.
+ * raw :       a uint8 array with the raw element records
+ *
+ * Output:
+ * xy :    the xy field of the element
+ * prop :  the prop field of the element
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "elread.h"
+#include "gdsstats.h"
+
+
+/*-- Data ---------------------------------------------------------*/
+
+/* buffer for the decoded element */
+static el_buffer_t eldec;
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+free_buffer(void)
+{
+   el_buffer_free(&eldec);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   element_t *pe;        /* pointer to element */
+   mxArray *pxy, *pprop;
+
+   /* check argument number */
+   if (nrhs != 2)
+      mexErrMsgTxt("decode_raw :  must have exactly two arguments.");
+   if (nlhs > 2)
+      mexErrMsgTxt("decode_raw :  at most two output arguments.");
+
+   /* get arguments */
+   pe = (element_t *)mxGetData(prhs[0]);
+
+   /* decode element */
+   if (eldec.el == NULL)
+      mexAtExit(free_buffer);
+   read_lazy_element(prhs[1], pe->kind, &eldec, &pxy, &pprop);
+
+   /* return data */
+   plhs[0] = pxy;
+   if (nlhs > 1)
+      plhs[1] = pprop;
+   else
+      mxDestroyArray(pprop);
+
+   STATS_FLUSH();
+}
+
+/*-----------------------------------------------------------------*/
@@ -6,13 +6,19 @@
  * retrieves element properties from the internal data structure
  * 
  * value = get_element_data(internal, property);
+ * values = get_element_data(internals, property);
  *
  * Input:
  * internal :  an array containing the internal element data. 
+ * internals : a cell array with the internal data of many elements
  * property :  a string with a property name
  * 
  * Output:
  * value :  the value of the property 
+ * values : a row vector with the values of a numeric property
+ *          (plex, layer, dtype, ptype, ttype, ntype, btype, width,
+ *          font, verj, horj) of all elements in one call; it is NaN
+ *          for elements that do not have the property.
  */
 
 #include <stdio.h>
@@ -26,8 +32,24 @@
 #define ERR_LEN 64
 
 
+/*-- numeric properties for many elements -------------------------*/
+
+static const struct {
+   const char *name;
+   property_kind prop;
+} num_props[] = {
+   {"plex",  PROP_PLEX},  {"layer", PROP_LAYER}, {"dtype", PROP_DTYPE},
+   {"ptype", PROP_PTYPE}, {"ttype", PROP_TTYPE}, {"ntype", PROP_NTYPE},
+   {"btype", PROP_BTYPE}, {"width", PROP_WIDTH}, {"font",  PROP_FONT},
+   {"verj",  PROP_VERJ},  {"horj",  PROP_HORJ},  {NULL, 0}
+};
+
+
 /*-- local function prototypes ------------------------------------*/
 
+static mxArray* get_numbers(const mxArray *pcell, const char *pstr);
+static double get_number(element_t *pe, property_kind prop);
+
 static mxArray* get_elflags(element_t *pe);
 static mxArray* get_plex(element_t *pe);
 static mxArray* get_layer(element_t *pe);
@@ -62,12 +84,18 @@ mexFunction(int nlhs, mxArray *plhs[],
    if (nrhs != 2)
       mexErrMsgTxt("get_element_data :  must have exactly two arguments.");
 
-   /* get pointer to element */
-   pe = (element_t *)mxGetData(prhs[0]);
-
    /* get property string */
    mxGetString(prhs[1], pstr, PS_LEN);
 
+   /* a property of many elements */
+   if ( mxIsCell(prhs[0]) ) {
+      plhs[0] = get_numbers(prhs[0], pstr);
+      return;
+   }
+
+   /* get pointer to element */
+   pe = (element_t *)mxGetData(prhs[0]);
+
    /* decode property argument using the hash function in prop_hash.h */
    pk = (struct keyword *)in_word_set(pstr, strlen(pstr));
    if (pk == NULL) {
@@ -79,6 +107,104 @@ mexFunction(int nlhs, mxArray *plhs[],
 }
 
 
+/*=================================================================*/
+
+static mxArray* 
+get_numbers(const mxArray *pcell, const char *pstr)
+{
+   mxArray *pa, *pi;
+   double *pd;
+   size_t k, n;
+   int j;
+   char errmsg[ERR_LEN];
+
+   for (j=0; num_props[j].name; j++)
+      if ( !strcmp(pstr, num_props[j].name) )
+	 break;
+   if (num_props[j].name == NULL) {
+      sprintf(errmsg, "get_element_data :  not a numeric property -> %s", pstr); 
+      mexErrMsgTxt(errmsg);
+   }
+
+   n = mxGetNumberOfElements(pcell);
+   pa = mxCreateDoubleMatrix(1,n, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<n; k++) {
+      pi = mxGetCell(pcell, k);
+      if (pi == NULL || mxGetElementSize(pi)*mxGetNumberOfElements(pi) < sizeof(element_t))
+	 mexErrMsgTxt("get_element_data :  cell array must contain internal element data.");
+      pd[k] = get_number((element_t *)mxGetData(pi), num_props[j].prop);
+   }
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* value of a numeric property, NaN when the element does not have it */
+static double
+get_number(element_t *pe, property_kind prop)
+{
+   int32_t plex;
+   int isref = pe->kind == GDS_SREF || pe->kind == GDS_AREF;
+
+   switch (prop) {
+      case PROP_PLEX:
+	 if ( !(pe->has & HAS_PLEX) )
+	    break;
+	 plex = pe->plex;
+	 if ( plex & (1<<23) )
+	    plex = -(plex & ~(1<<23));
+	 return (double)plex;
+      case PROP_LAYER:
+	 if (!isref)
+	    return (double)pe->layer;
+	 break;
+      case PROP_DTYPE:
+	 if (!isref)
+	    return (double)pe->dtype;
+	 break;
+      case PROP_PTYPE:
+	 if ((pe->kind == GDS_PATH || pe->kind == GDS_TEXT) && (pe->has & HAS_PTYPE))
+	    return (double)pe->ptype;
+	 break;
+      case PROP_TTYPE:
+	 if (pe->kind == GDS_TEXT)
+	    return (double)pe->ttype;
+	 break;
+      case PROP_NTYPE:
+	 if (pe->kind == GDS_NODE)
+	    return (double)pe->ntype;
+	 break;
+      case PROP_BTYPE:
+	 if (pe->kind == GDS_BOX)
+	    return (double)pe->btype;
+	 break;
+      case PROP_WIDTH:
+	 if (pe->has & HAS_WIDTH)
+	    return (double)pe->width;
+	 break;
+      case PROP_FONT:
+	 if (pe->has & HAS_PRESTN)
+	    return (double)((pe->present & (3<<4)) >> 4);
+	 break;
+      case PROP_VERJ:
+	 if (pe->has & HAS_PRESTN)
+	    return (double)((pe->present & (3<<2)) >> 2);
+	 break;
+      case PROP_HORJ:
+	 if (pe->has & HAS_PRESTN)
+	    return (double)(pe->present & 3);
+	 break;
+      default:
+	 break;
+   }
+
+   return mxGetNaN();
+}
+
+
 /*=================================================================*/
 
 static mxArray* 
@@ -0,0 +1,13 @@
+function data = lazy_decode(data)
+%function data = lazy_decode(data)
+%
+% decodes the xy and prop fields of an element that was read
+% in lazy mode. The raw element records are stored in the
+% field 'raw' until the element data are needed.
+
+    if isfield(data, 'raw')
+        [data.xy, data.prop] = decode_raw(data.internal, data.raw);
+        data = rmfield(data, 'raw');
+    end
+
+end
@@ -6,13 +6,20 @@
  * stores element properties in the internal data structure
  * 
  * internal = set_element_data(internal, varargin);
+ * internals = set_element_data(internals, property, values);
  *
  * Input:
  * internal :  an array containing the internal element data. 
  * varargin :  a cell array of property/value pairs
+ * internals : a cell array with the internal data of many elements
+ * property :  name of a numeric property, e.g. 'layer' or 'dtype'
+ * values :    a vector with one value per element, or a scalar
+ *             that is set in all elements. Elements with a NaN
+ *             value are not changed.
  * 
  * Output:
  * internal :  the modified internal data structure 
+ * internals : the modified internal data of all elements
  *
  * NOTE: when an optional property is set to its default value,
  * the HAS_PROPERTY flag is cleared.
@@ -51,6 +58,8 @@ static void set_adim(element_t *pe, mxArray *val);
 /* include hash function */
 #include "set_prop_hash.h"
 
+static mxArray *set_numbers(const mxArray *pcell, const mxArray *pprop, const mxArray *pval);
+
 /*-----------------------------------------------------------------*/
 
 void 
@@ -66,6 +75,12 @@ mexFunction(int nlhs, mxArray *plhs[],
    char errmsg[ERR_LEN];
 
 
+   /* a property of many elements */
+   if (nrhs == 3 && mxIsCell(prhs[0])) {
+      plhs[0] = set_numbers(prhs[0], prhs[1], prhs[2]);
+      return;
+   }
+
    if (nrhs != 2)
       mexErrMsgTxt("set_element_data :  must have exactly two arguments.");
 
@@ -108,6 +123,59 @@ mexFunction(int nlhs, mxArray *plhs[],
    plhs[0] = copy_element_to_array(&el);
 }
 
+/*=================================================================*/
+
+static mxArray *
+set_numbers(const mxArray *pcell, const mxArray *pprop, const mxArray *pval)
+{
+   struct keyword *pk;
+   mxArray *pout, *pi, *pv;
+   element_t el;
+   double *pd, *ps;
+   size_t k, n, nv;
+   char pstr[PS_LEN];
+   char errmsg[ERR_LEN];
+
+   if ( !mxIsChar(pprop) )
+      mexErrMsgTxt("set_element_data :  properties must be character strings.");
+   mxGetString(pprop, pstr, PS_LEN);
+   pk = (struct keyword *)in_word_set(pstr, strlen(pstr));
+   if (pk == NULL || !strcmp(pstr, "elflags") || !strcmp(pstr, "ext") ||
+       !strcmp(pstr, "strans") || !strcmp(pstr, "adim")) {
+      sprintf(errmsg, "set_element_data :  not a numeric property -> %s", pstr); 
+      mexErrMsgTxt(errmsg);
+   }
+
+   n = mxGetNumberOfElements(pcell);
+   nv = mxGetNumberOfElements(pval);
+   if ( !mxIsDouble(pval) || (nv != 1 && nv != n) )
+      mexErrMsgTxt("set_element_data :  values must be a scalar or one value per element.");
+   pd = mxGetPr(pval);
+
+   /* the scalar value passed to the property functions */
+   pv = mxCreateDoubleMatrix(1,1, mxREAL);
+   ps = mxGetPr(pv);
+
+   pout = mxCreateCellMatrix(1,n);
+   for (k=0; k<n; k++) {
+      pi = mxGetCell(pcell, k);
+      if (pi == NULL || mxGetElementSize(pi)*mxGetNumberOfElements(pi) < sizeof(element_t))
+	 mexErrMsgTxt("set_element_data :  cell array must contain internal element data.");
+      *ps = pd[nv == 1 ? 0 : k];
+      if ( mxIsNaN(*ps) ) {
+	 mxSetCell(pout, k, mxDuplicateArray(pi));
+	 continue;
+      }
+      memcpy(&el, mxGetData(pi), sizeof(element_t));
+      (*pk->set_prop_func)(&el, pv);
+      mxSetCell(pout, k, copy_element_to_array(&el));
+   }
+   mxDestroyArray(pv);
+
+   return pout;
+}
+
+
 /*=================================================================*/
 
 
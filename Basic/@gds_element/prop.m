@@ -6,6 +6,8 @@ function [p] = prop(gelm)
 % gelm :  a gds_element object
 % p :     a structure array with element properties
 
+    gelm.data = lazy_decode(gelm.data);
+
     if ~isfield(gelm.data, 'prop')
         error('gds_element.prop :  element has no property data.');
     end
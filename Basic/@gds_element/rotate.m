@@ -11,6 +11,8 @@ function [gelmo] = rotate(gelmi, ang)
 
 % Ulf Griesmann, NIST, October 2015
 
+    gelmi.data = lazy_decode(gelmi.data);
+
     % check arguments
     if nargin < 2
         error('gds_element.rotate: two input arguments required.');
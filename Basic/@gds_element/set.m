@@ -21,6 +21,7 @@ function s = set(gelm, varargin)
         % check if property is stored outside the internal structure
         if ~isempty(elvalue)
             if is_not_internal(elproperty) % xy, prop, text
+                s.data = lazy_decode(s.data);
                 s.data.(elproperty) = elvalue;
             else
                 ipropval = [ipropval, {elproperty,elvalue}];
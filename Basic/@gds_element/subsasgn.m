@@ -15,6 +15,7 @@ function gelm = subsasgn(gelm, ins, val)
   
       case '.'
           if is_not_internal(ins.subs)
+              gelm.data = lazy_decode(gelm.data);
               gelm.data.(ins.subs) = val;
           else
               gelm.data.internal = set_element_data(gelm.data.internal, {ins.subs,val});
@@ -22,6 +23,7 @@ function gelm = subsasgn(gelm, ins, val)
 
       case '()'
           idx = ins.subs{:};
+          gelm.data = lazy_decode(gelm.data);
  
           switch get_etype(gelm.data.internal)
               
@@ -17,6 +17,7 @@ function prop = subsref(gelm, ins)
  
       case '.'
           if is_not_internal(ins.subs)
+              gelm.data = lazy_decode(gelm.data);
               prop = gelm.data.(ins.subs);
           else
               prop = get_element_data(gelm.data.internal, ins.subs);
@@ -24,6 +25,7 @@ function prop = subsref(gelm, ins)
         
       case '()'
           idx = ins.subs{:};
+          gelm.data = lazy_decode(gelm.data);
         
           switch get_etype(gelm.data.internal)
             
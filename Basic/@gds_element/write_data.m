@@ -0,0 +1,23 @@
+function [D] = write_data(gelm, varargin)
+%function [D] = write_data(gelm, varargin)
+%
+% write_data :  returns the data structures of elements in the
+%               form expected by the functions that write them
+%               to a library file (see gds_write_structures_mex).
+%               Elements read in lazy mode are decoded.
+%
+% gelm, varargin :  gds_element objects
+% D :               cell array with the element data structures
+%
+% Example:
+%          D = write_data(gs.el{:});
+
+% Initial version, October 2026
+
+    E = [{gelm}, varargin];
+    D = cell(1, numel(E));
+    for k = 1:numel(E)
+        D{k} = lazy_decode(E{k}.data);
+    end
+
+end
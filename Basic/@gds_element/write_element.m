@@ -12,6 +12,8 @@ function write_element(gelm, gf, uunit, dbunit, compound)
 % Ulf Griesmann, NIST, June 2011
 % modified for new low-level I/O, Ulf Griesmann, January 2013
 
+    gelm.data = lazy_decode(gelm.data);
+
     gds_write_element(gf, gelm.data, uunit/dbunit, compound); 
 
 end
@@ -7,6 +7,8 @@ function [pos] = xy(gelm)
 % pos :    a cell array containing one or more nx2 matrices 
 %          with reference positions
 
+    gelm.data = lazy_decode(gelm.data);
+
     if ~isfield(gelm.data, 'xy')
         error('gds_element.xy :  element has no position data.');
     end
@@ -21,14 +21,22 @@ function [olib] = add_struct(ilib, varargin);
        S = varargin{k};
        if isa(S, 'gds_structure')
           olib.st{end+1} = S;
+          olib = name_set(olib, numel(olib.st), sname(S));
        elseif iscell(S)
           if ~all(cellfun(@(x)isa(x,'gds_structure'), S))
              error('gds_library.add_struct :  input cell array member is not a gds_structure.');
           end
-          olib.st = [ilib.st, S(:)']; % make row vector 
+          olib.st = [olib.st, S(:)']; % make row vector 
+          for m = numel(olib.st)-numel(S)+1:numel(olib.st)
+             olib = name_set(olib, m, sname(olib.st{m}));
+          end
        else
           error('gds_library.add_struct : arguments must be gds_structures or cell arrays.');
        end 
     end
 
+    % the hierarchical summaries must be recomputed
+    olib.hinfo = [];
+    olib.graph = [];
+
 end
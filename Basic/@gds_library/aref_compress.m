@@ -0,0 +1,68 @@
+function [olib] = aref_compress(glib, minrep, prefix)
+%function [olib] = aref_compress(glib, minrep, prefix)
+% 
+% replaces regular arrays of identical boundaries and of
+% identical structure references with array references (aref).
+% Large layouts often contain many copies of the same polygon, or
+% of the same structure, on regular grids, e.g. contact holes or
+% memory cells. Replacing them with arefs makes the library files
+% much smaller.
+% 
+% glib :     input gds_library object
+% minrep :   (Optional) minimum number of elements that are
+%            replaced by one aref. Default is 4.
+% prefix :   (Optional) prefix of the names of the structures that
+%            are created for arrays of boundaries. A number is
+%            appended to the prefix. Default is 'ARC'. The prefix
+%            is extended with '_' until no structure in the library
+%            has a name that starts with it.
+% olib :     output gds_library object
+%
+% Example:
+%        olib = aref_compress(glib, 10);
+%
+% NOTE:
+% Only boundaries with a single polygon and srefs with a single
+% position are replaced, and only when they have no properties,
+% elflags, or plex. Boundaries are identical when their layer,
+% data type, and shape in database units are the same; an array
+% of boundaries becomes an aref of a new structure that contains
+% the boundary. Identical boundaries in different structures
+% share the new structure. srefs are identical when they have the
+% same structure name and strans. The structures of the library
+% are searched with a single call to gds_aref_compress_mex.
+%
+
+% Initial version, October 2026
+
+    if nargin < 3, prefix = []; end
+    if nargin < 2, minrep = []; end
+    if isempty(minrep), minrep = 4; end
+    if isempty(prefix), prefix = 'ARC'; end
+
+    % names of new structures must be unique
+    N = glib.names;
+    while any(strncmp(N, prefix, length(prefix)))
+        prefix = [prefix, '_'];
+    end
+
+    % element data of all structures
+    E = cell(size(glib.st));
+    for k = 1:numel(glib.st)
+        S = write_data(glib.st{k});
+        E{k} = S.el;
+    end
+
+    % find the arrays
+    [C, A, R] = gds_aref_compress_mex(E, glib.uunit/glib.dbunit, minrep, prefix);
+    olib = glib;
+    olib.st = cellfun(@aref_compress, glib.st, A, R, 'UniformOutput',0);
+
+    % structures with the arrayed boundaries
+    for k = 1:numel(C)
+        olib = add_struct(olib, gds_structure(C(k).sname, gds_element('_file_', C(k).el)));
+    end
+    olib.hinfo = [];
+    olib.graph = [];
+    
+end
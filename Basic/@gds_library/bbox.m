@@ -1,17 +1,38 @@
-function [bbx] = bbox(glib)
-%function [bbx] = bbox(glib)
+function [bbx] = bbox(glib, sname)
+%function [bbx] = bbox(glib, sname)
 %
 % Method returns the bounding box of gds_library objects.
 % 
 % Input:
 % glib :   a gds_library object
+% sname :  (Optional) name of a structure. When it is given,
+%          the bounding box of the resolved structure is returned.
 %
 % Output: 
 % bbx :    a vector [llx,lly,urx,ury] with the coordinates of the
 %          lower left and upper right corners of the bounding box. 
+%
+% NOTE:
+% The bounding box is taken from the hierarchical summaries
+% cached in the library (see summary) when they are valid.
 
 % Initial version, Ulf Griesmann, November 2015
     
-    bbx = bbox_tree(glib.st);
+    H = glib.hinfo;
+    if isempty(H) || ~all(H.valid)
+        H = tree_summary(glib.st, H);
+    end
+
+    if nargin < 2
+        T = find(sum(H.A,1)==0); % top level structures
+        bbst = H.bbox(T,:);
+        bbx = [min(bbst(:,1:2),[],1),max(bbst(:,3:4),[],1)];
+    else
+        idx = find(strcmp(sname, H.names));
+        if isempty(idx)
+            error(sprintf('gds_library.bbox :  structure >>> %s <<< not found', sname));
+        end
+        bbx = H.bbox(idx(1),:);
+    end
     
 end
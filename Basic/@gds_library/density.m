@@ -0,0 +1,115 @@
+function [A, xe, ye] = density(glib, sname, layers, pitch, varargin)
+%function [A, xe, ye] = density(glib, sname, layers, pitch, varargin)
+%
+% density :  computes a layer density map of the resolved structure
+%            hierarchy below a structure in a library. The area
+%            covered by shapes (boundary, box, and path elements)
+%            on each layer is computed for each tile of a grid.
+%
+%     A = density(glib, sname, layers, pitch)
+%     [A, xe, ye] = density(glib, sname, layers, pitch, 'window', win)
+%
+% Input:
+% glib :     a gds_library object
+% sname :    name of the top structure. When it is empty, the first
+%            top level structure of the library is used.
+% layers :   vector with layer numbers (shapes with all data
+%            types are included)
+% pitch :    tile size in user units; a scalar for square tiles or
+%            a vector [dx, dy]
+% varargin : (Optional) property - value pairs
+%            'window' :   [llx,lly,urx,ury] rectangle covered by the
+%                         grid. Default is the bounding box of the
+%                         shapes on the layers.
+%            'exact' :    when true, all structure instances are
+%                         expanded and clipped to the tiles. By
+%                         default, instances lying within a single
+%                         tile contribute their area without being
+%                         expanded (see below). Default is false.
+%            'nthreads' : number of threads for processing the
+%                         tiles. Default is the number of processors.
+%
+% Output:
+% A :    ny x nx x L array with the covered area in user units^2 of
+%        each tile on each layer; A(j,i,k) is the area of the tile
+%        in column i and row j on layer layers(k). The density is
+%        A / (dx*dy).
+% xe :   (Optional) 1 x (nx+1) vector with the x coordinates of the
+%        tile edges
+% ye :   (Optional) 1 x (ny+1) vector with the y coordinates of the
+%        tile edges
+%
+% NOTE:
+% The area of each structure on each layer is computed only once.
+% Overlapping shapes are merged in all tiles, but the shapes of a
+% structure instance that is not expanded are assumed not to overlap
+% other shapes on the same layer. Use the 'exact' option for
+% layouts in which instances overlap.
+%
+% Example:
+%          [A, xe, ye] = density(glib, 'TOP', [1,2], 100);
+%          imagesc(xe, ye, A(:,:,1) / 100^2); axis xy
+%
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 4
+        error('gds_library.density :  expecting at least 4 arguments.');
+    end
+    if isempty(layers) || isempty(pitch) || any(pitch <= 0)
+        error('gds_library.density :  layers and a positive pitch are required.');
+    end
+
+    % options
+    win = [];
+    exact = 0;
+    nthreads = [];
+    k = 1;
+    while k < numel(varargin)
+        switch varargin{k}
+          case 'window'
+            win = varargin{k+1};
+          case 'exact'
+            exact = double(varargin{k+1});
+          case 'nthreads'
+            nthreads = varargin{k+1};
+          otherwise
+            error('gds_library.density :  unknown option %s.', varargin{k});
+        end
+        k = k + 2;
+    end
+
+    % top structure
+    if isempty(sname)
+        ts = topstruct(glib);
+        if iscell(ts)
+            sname = ts{1};
+        else
+            sname = ts;
+        end
+    end
+
+    % element data of the structures below the top structure; each
+    % structure is converted only once
+    cas = subtree(glib, sname);
+    names = cellfun(@(s) get(s, 'sname'), cas, 'UniformOutput', false);
+    top = find(strcmp(names, sname), 1);
+    el_data = cell(size(cas));
+    for k = 1:numel(cas)
+        el_data{k} = cellfun(@get, get(cas{k}), 'UniformOutput', false);
+    end
+
+    % compute the density map
+    ud = glib.uunit / glib.dbunit;
+    [A, gwin] = poly_densitymex(el_data, names, top, double(layers(:))', ...
+                                win, pitch, ud, exact, nthreads);
+
+    if nargout > 1
+        dx = pitch(1);
+        dy = pitch(end);
+        xe = gwin(1) + dx * (0:size(A,2));
+        ye = gwin(2) + dy * (0:size(A,1));
+    end
+
+end
@@ -29,6 +29,10 @@ function glib = gds_library(lname, varargin)
     glib.st = {};       % cell array of structures
     glib.uunit = 1e-6;  % default user unit
     glib.dbunit = 1e-9; % default database unit
+    glib.hinfo = [];    % hierarchical summaries (see summary)
+    glib.graph = [];    % reference graph (see refgraph)
+    glib.names = {};    % structure names (see name_index)
+    glib.nhash = [];    % hash table of structure names
     
     % add the structures to the library
     while length(varargin) > 0
@@ -59,5 +63,6 @@ function glib = gds_library(lname, varargin)
     
     % create the library object
     glib = class(glib, 'gds_library');
+    glib = name_index(glib);
     
 end
@@ -23,14 +23,12 @@ function cas = getstruct(glib, sname)
         sname = {sname};
     end
     
-    % find all structure names from library
-    N = cellfun(@sname, glib.st, 'UniformOutput',0);
-
     % find indices of structures
-    stri = find(ismember(N,sname) > 0);
-    if length(stri) < length(sname)
+    stri = namehashmex(glib.nhash, glib.names, sname);
+    if ~all(stri)
         error('One or more structures not found in library.');
     end
+    stri = sort(stri);
     
     % return structures
     cas = glib.st(stri);
@@ -1,43 +1,62 @@
-function [S,L] = layerinfo(glib)
-%function [S,L] = layerinfo(glib)
+function [S,L] = layerinfo(glib, sname)
+%function [S,L] = layerinfo(glib, sname)
 %
 % layerinfo :  displays information about the
 %              distribution of elements on layers
 %              in a gds_library object.
 %
 % glib :  a gds_library object
+% sname : (Optional) name of a structure. When it is given, the
+%         elements of the resolved structure hierarchy are counted,
+%         i.e. each element is counted once for every instance of
+%         the structure containing it.
 % S :     (Optional) structure array with number of element 
 %         per layer.
 %         S(k).(etype) contains the number of elements of 
 %         type 'etype' on layer k. E.g.: S(10).boundary
+%         S(k).vertices is the number of vertices on layer k.
 %         When the output argument is omitted, the layer
 %         information is printed on the screen.
 % L :     (Optional) a vector with layers that contain elements
 %
+% NOTE: the statistics of a GDSII file, including data types and
+%       element areas, can be computed without reading the file
+%       into a gds_library object with gds_layer_stats.
+%
 
 % initial version, Ulf Griesmann, NIST, November 16, 2012
 
-    % initialize variables for accounting
-    numl = 256; % max number of layers
-    Si = repmat(struct('boundary',0,'path',0,'box',0,'node',0,'text',0),1,numl);
+    % element counts from the structure summaries
+    if nargin < 2
+        C = sparse(65536,6);
+        for k = 1:numel(glib.st)
+            sm = summary(glib.st{k});
+            C = C + sm.lcnt;
+        end
+    else
+        H = glib.hinfo;
+        if isempty(H) || ~all(H.valid)
+            H = tree_summary(glib.st, H);
+        end
+        idx = find(strcmp(sname, H.names));
+        if isempty(idx)
+            error(sprintf('gds_library.layerinfo :  structure >>> %s <<< not found', sname));
+        end
+        C = H.cnt{idx(1)};
+    end
+    
+    numl = max([256; find(any(C,2), 1, 'last')]);
+    Si = repmat(struct('boundary',0,'path',0,'box',0,'node',0,'text',0,'vertices',0),1,numl);
     Li = zeros(1,numl);
     
-    % iterate over all structures
-    for k=1:numel(glib.st)
-        
-        % structure
-        st = glib.st{k};
-        
-        % iterate over all elements
-	elms = st(:);  % get cell array of all elements in structure
-        for m=1:numel(elms)
-	    el = elms{m};
-	    if ~is_ref(el)
-	        numl = layer(el) + 1;  % gds layer numbers start with 0
-                Li(numl) = Li(numl) + 1; 
-                Si(numl).(etype(el)) = Si(numl).(etype(el)) + 1;
-            end
-        end
+    for l = find(any(C,2))'
+        Li(l) = full(sum(C(l,1:5)));
+        Si(l).boundary = full(C(l,1));
+        Si(l).path     = full(C(l,2));
+        Si(l).box      = full(C(l,3));
+        Si(l).node     = full(C(l,4));
+        Si(l).text     = full(C(l,5));
+        Si(l).vertices = full(C(l,6));
     end
 
     %display
@@ -1,22 +1,42 @@
-function [cstruc] = poly_convert(glib)
-%function [cstruc] = poly_convert(glib)
+function [olib] = poly_convert(glib, nthreads)
+%function [olib] = poly_convert(glib, nthreads)
 % 
 % converts path or box elements into 
 % equivalent boundary elements. Text and
 % node elements are removed. The structure
 % hierarchy is preserved.
 % 
-% glib :   input gds_library object
-% olib :   output gds_library object
+% glib :     input gds_library object
+% nthreads : (Optional) number of threads used for converting
+%            the paths. Default is 0, which uses one thread per
+%            processor.
+% olib :     output gds_library object
 %
 % Example:
 %        olib = poly_convert(glib);
 %
+% NOTE:
+% The boxes and paths of all structures are converted with a
+% single call to gds_poly_convert_mex; the structures are
+% processed in parallel.
+%
 
 % Initial version, Ulf Griesmann, December 2011
+% Convert all structures with gds_poly_convert_mex, October 2026
+
+    if nargin < 2, nthreads = []; end
+
+    % element data of all structures
+    E = cell(size(glib.st));
+    for k = 1:numel(glib.st)
+        S = write_data(glib.st{k});
+        E{k} = S.el;
+    end
 
     % create output library
+    [D, R] = gds_poly_convert_mex(E, nthreads);
     olib = glib;
-    olib.st = cellfun(@poly_convert, glib.st, 'UniformOutput',0);
+    olib.st = cellfun(@poly_convert, glib.st, D, R, 'UniformOutput',0);
+    olib.hinfo = [];
     
 end
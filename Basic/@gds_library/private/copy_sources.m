@@ -0,0 +1,52 @@
+function [copy] = copy_sources(glib, fname)
+%function [copy] = copy_sources(glib, fname)
+%
+% copy_sources :  finds the structures of a library that can be
+%                 copied from the file they were read from when the
+%                 library is written. These are the structures that
+%                 were not modified after they were read (see
+%                 read_gds_library) from a file that was not changed
+%                 since and that is not the output file, with the
+%                 database unit of the library.
+%
+% glib :   a gds_library object
+% fname :  name of the output file
+% copy :   logical vector; true for structures that can be copied
+
+% Initial version, October 2026
+
+    copy = false(1, numel(glib.st));
+    src = cellfun(@(x)get(x,'src'), glib.st, 'UniformOutput',0);
+    has = find(~cellfun(@isempty, src));
+    if isempty(has)
+        return
+    end
+
+    % absolute path of the output file
+    if fname(1) == '!'
+        fname = fname(2:end);
+    end
+    if fname(1) ~= filesep && ~(ispc && numel(fname) > 1 && fname(2) == ':')
+        fname = fullfile(pwd, fname);
+    end
+
+    % size and time stamp of the source files
+    files = unique(cellfun(@(x)x.file, src(has), 'UniformOutput',0));
+    stamp = zeros(numel(files), 2);
+    for k = 1:numel(files)
+        d = dir(files{k});
+        if numel(d) == 1 && ~strcmp(files{k}, fname)
+            stamp(k,:) = [d.bytes, d.datenum];
+        else
+            stamp(k,:) = NaN;  % missing or overwritten
+        end
+    end
+
+    for k = has(:)'
+        s = src{k};
+        f = find(strcmp(s.file, files));
+        copy(k) = stamp(f,1) == s.fsize && stamp(f,2) == s.fdate && ...
+                  abs(s.dbunit - glib.dbunit) <= 1e-12 * glib.dbunit;
+    end
+
+end
@@ -0,0 +1,17 @@
+function [glib] = name_index(glib)
+%function [glib] = name_index(glib)
+%
+% name_index :  rebuilds the structure name index of a library.
+%               glib.names holds the structure names in library
+%               order and glib.nhash a hash table of the names (see
+%               namehashmex), which makes the lookup of a structure
+%               by name independent of the number of structures.
+%
+% glib :  gds_library object
+
+% Initial version, October 2026
+
+    glib.names = cellfun(@sname, glib.st, 'UniformOutput',0);
+    glib.nhash = namehashmex(glib.names);
+
+end
@@ -0,0 +1,41 @@
+function [glib] = name_set(glib, idx, name)
+%function [glib] = name_set(glib, idx, name)
+%
+% name_set :  enters the name of a new or renamed structure
+%             in the structure name index of a library.
+%
+% glib :  gds_library object
+% idx :   index of the structure; structures are appended
+%         when idx is one larger than the number of names.
+% name :  new name of the structure
+
+% Initial version, October 2026
+
+    if idx <= numel(glib.names)
+        old = glib.names{idx};
+        if strcmp(old, name)
+            return
+        end
+        if namehashmex(glib.nhash, glib.names, old) == idx
+            dupl = glib.nhash(1) < numel(glib.names);
+            glib.nhash = namehashmex(glib.nhash, glib.names, old, 0);
+            glib.names{idx} = name;
+
+            % another structure may still have the old name
+            if dupl
+                j = find(strcmp(glib.names, old), 1);
+                if ~isempty(j)
+                    glib.nhash = namehashmex(glib.nhash, glib.names, old, j);
+                end
+            end
+        end
+    end
+    glib.names{idx} = name;
+
+    % the first of several structures with the same name is found
+    k = namehashmex(glib.nhash, glib.names, name);
+    if ~k || k > idx
+        glib.nhash = namehashmex(glib.nhash, glib.names, name, idx);
+    end
+
+end
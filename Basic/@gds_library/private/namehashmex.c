@@ -0,0 +1,322 @@
+/*
+ * A mex function for a hash table of structure names
+ *
+ * tab = namehashmex(names);
+ * idx = namehashmex(tab, names, key);
+ * tab = namehashmex(tab, names, key, k);
+ *
+ * names :  cell array with the names of the structures in a library
+ * tab :    uint32 column vector with the hash table. tab(1) is the
+ *          number of names in the table, the remaining entries are
+ *          the slots of an open addressing table with linear probing;
+ *          each slot contains the index of a structure in names, or
+ *          0 when it is empty. The names themselves are not stored;
+ *          the table must be used with the names it was built for.
+ * key :    a structure name or a cell array of structure names
+ * idx :    row vector with the indices of the structures in names,
+ *          or 0 for names that are not in the table
+ * k :      new index of structure key; key is removed from the table
+ *          when k is 0. The table grows when it is half full.
+ *
+ * The table is built with nametab_t (refgraph.h) and the slots have
+ * its layout, with the slot entries mapped to indices in names; all
+ * probing uses nametab_hash. When a name occurs more than once, the
+ * table contains the first occurrence. Keys are removed with backward shift deletion, which
+ * keeps the probe sequences of all other keys intact; the names of
+ * all entries must therefore still be in names when a key is set.
+ *
+ * This software is in the Public Domain
+ * Copyright (c) 2026
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include <mex.h>
+#include "refgraph.h"
+
+#define NLEN      512
+#define MIN_SLOTS 16
+
+
+/*-- local prototypes -----------------------------------------*/
+
+static mxArray *build_table(const mxArray *pnames);
+static mxArray *find_keys(const mxArray *ptab, const mxArray *pnames,
+                          const mxArray *pkey);
+static mxArray *set_key(const mxArray *ptab, const mxArray *pnames,
+                        const mxArray *pkey, const mxArray *pk);
+static mxArray *new_table(size_t nslot);
+static size_t find_slot(const uint32_t *slot, size_t nslot, const mxArray *pnames,
+                        const char *key, uint32_t h);
+static void insert_entry(uint32_t *slot, size_t nslot, const mxArray *pnames,
+                         uint32_t idx);
+static void remove_slot(uint32_t *slot, size_t nslot, const mxArray *pnames, size_t s);
+static const char *read_name(const mxArray *pnames, uint32_t idx, char *buf);
+static void get_name(const mxArray *pnames, uint32_t idx, char *buf);
+static void get_key(const mxArray *pkey, char *buf);
+
+
+/*-------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   if (nrhs == 1) {
+      if ( !mxIsCell(prhs[0]) )
+	 mexErrMsgTxt("namehashmex :  structure names must be a cell array.");
+      plhs[0] = build_table(prhs[0]);
+      return;
+   }
+
+   if (nrhs < 3 || !mxIsUint32(prhs[0]) || mxGetNumberOfElements(prhs[0]) < MIN_SLOTS+1)
+      mexErrMsgTxt("namehashmex :  expected a name table, names, and a key.");
+   if ( !mxIsCell(prhs[1]) )
+      mexErrMsgTxt("namehashmex :  structure names must be a cell array.");
+
+   if (nrhs == 3)
+      plhs[0] = find_keys(prhs[0], prhs[1], prhs[2]);
+   else
+      plhs[0] = set_key(prhs[0], prhs[1], prhs[2], prhs[3]);
+}
+
+
+/*-------------------------------------------------------------*/
+
+static mxArray *
+build_table(const mxArray *pnames)
+{
+   mxArray *ptab;
+   nametab_t nt;
+   uint32_t *tab, *first;
+   const char *msg = NULL;
+   size_t k, n;
+   int32_t j;
+   int added;
+   char name[NLEN];
+
+   n = mxGetNumberOfElements(pnames);
+   first = (uint32_t *)mxMalloc((n ? n : 1)*sizeof(uint32_t));
+   if ( nametab_init(&nt, n) )
+      mexErrMsgTxt("namehashmex :  failed to allocate memory.");
+
+   /* first[j] is the first structure with name j */
+   for (k=0; k<n; k++) {
+      if ( (msg = read_name(pnames, k+1, name)) )
+	 break;
+      if ( (j = nametab_intern(&nt, name, &added)) < 0 ) {
+	 msg = "namehashmex :  failed to allocate memory.";
+	 break;
+      }
+      if (added)
+	 first[j] = k+1;
+   }
+   if (msg) {
+      nametab_free(&nt);
+      mexErrMsgTxt(msg);
+   }
+
+   ptab = new_table(nt.nslot);
+   tab = (uint32_t *)mxGetData(ptab);
+   tab[0] = nt.n;
+   for (k=0; k<nt.nslot; k++)
+      tab[1+k] = nt.slot[k] ? first[nt.slot[k]-1] : 0;
+
+   nametab_free(&nt);
+   mxFree(first);
+
+   return ptab;
+}
+
+
+/*-------------------------------------------------------------*/
+
+static mxArray *
+find_keys(const mxArray *ptab, const mxArray *pnames, const mxArray *pkey)
+{
+   mxArray *pidx;
+   const uint32_t *tab = (const uint32_t *)mxGetData(ptab);
+   size_t nslot = mxGetNumberOfElements(ptab) - 1;
+   double *pd;
+   size_t k, n;
+   char key[NLEN];
+
+   n = mxIsCell(pkey) ? mxGetNumberOfElements(pkey) : 1;
+   pidx = mxCreateDoubleMatrix(1, n, mxREAL);
+   pd = mxGetPr(pidx);
+   for (k=0; k<n; k++) {
+      get_key(mxIsCell(pkey) ? mxGetCell(pkey, k) : pkey, key);
+      pd[k] = tab[1 + find_slot(tab+1, nslot, pnames, key, nametab_hash(key))];
+   }
+
+   return pidx;
+}
+
+
+/*-------------------------------------------------------------*/
+
+static mxArray *
+set_key(const mxArray *ptab, const mxArray *pnames,
+        const mxArray *pkey, const mxArray *pk)
+{
+   mxArray *pout;
+   const uint32_t *tab = (const uint32_t *)mxGetData(ptab);
+   uint32_t *out, idx;
+   size_t nslot = mxGetNumberOfElements(ptab) - 1;
+   size_t s, m, nout;
+   double k;
+   char key[NLEN];
+
+   k = mxGetScalar(pk);
+   if (k < 0 || k > mxGetNumberOfElements(pnames))
+      mexErrMsgTxt("namehashmex :  structure index out of range.");
+   get_key(pkey, key);
+
+   /* a larger table when it would be more than half full */
+   nout = nslot;
+   if (k > 0 && 2*(tab[0]+1) > nslot)
+      nout = 2*nslot;
+   pout = new_table(nout);
+   out = (uint32_t *)mxGetData(pout);
+   out[0] = tab[0];
+   if (nout == nslot)
+      memcpy(out+1, tab+1, nslot*sizeof(uint32_t));
+   else {
+      for (m=0; m<nslot; m++)
+	 if (tab[1+m])
+	    insert_entry(out+1, nout, pnames, tab[1+m]);
+   }
+
+   /* remove the key, then enter it with its new index */
+   s = find_slot(out+1, nout, pnames, key, nametab_hash(key));
+   if (out[1+s]) {
+      remove_slot(out+1, nout, pnames, s);
+      out[0]--;
+   }
+   if (k > 0) {
+      idx = (uint32_t)k;
+      s = find_slot(out+1, nout, pnames, key, nametab_hash(key));
+      out[1+s] = idx;
+      out[0]++;
+   }
+
+   return pout;
+}
+
+
+/*-------------------------------------------------------------*/
+
+static mxArray *
+new_table(size_t nslot)
+{
+   mxArray *ptab;
+
+   ptab = mxCreateNumericMatrix(nslot+1, 1, mxUINT32_CLASS, mxREAL);
+   memset(mxGetData(ptab), 0, (nslot+1)*sizeof(uint32_t));
+
+   return ptab;
+}
+
+
+/*-------------------------------------------------------------*/
+
+/* slot of a key, or the empty slot where it would be entered */
+static size_t
+find_slot(const uint32_t *slot, size_t nslot, const mxArray *pnames,
+          const char *key, uint32_t h)
+{
+   size_t s = h & (nslot - 1);
+   char name[NLEN];
+
+   while (slot[s]) {
+      get_name(pnames, slot[s], name);
+      if ( !strcmp(name, key) )
+	 break;
+      s = (s + 1) & (nslot - 1);
+   }
+
+   return s;
+}
+
+
+/*-------------------------------------------------------------*/
+
+/* enters structure idx, whose name is not in the table */
+static void
+insert_entry(uint32_t *slot, size_t nslot, const mxArray *pnames, uint32_t idx)
+{
+   size_t s;
+   char name[NLEN];
+
+   get_name(pnames, idx, name);
+   s = nametab_hash(name) & (nslot - 1);
+   while (slot[s])
+      s = (s + 1) & (nslot - 1);
+   slot[s] = idx;
+}
+
+
+/*-------------------------------------------------------------*/
+
+/* backward shift deletion: entries behind the removed one move up
+   unless their home slot lies between the gap and their slot */
+static void
+remove_slot(uint32_t *slot, size_t nslot, const mxArray *pnames, size_t s)
+{
+   size_t gap = s, home;
+   char name[NLEN];
+
+   slot[gap] = 0;
+   s = (gap + 1) & (nslot - 1);
+   while (slot[s]) {
+      get_name(pnames, slot[s], name);
+      home = nametab_hash(name) & (nslot - 1);
+      if ( ((s - home) & (nslot - 1)) >= ((s - gap) & (nslot - 1)) ) {
+	 slot[gap] = slot[s];
+	 slot[s] = 0;
+	 gap = s;
+      }
+      s = (s + 1) & (nslot - 1);
+   }
+}
+
+
+/*-------------------------------------------------------------*/
+
+static const char *
+read_name(const mxArray *pnames, uint32_t idx, char *buf)
+{
+   mxArray *pc;
+
+   if (idx < 1 || idx > mxGetNumberOfElements(pnames) ||
+       (pc = mxGetCell(pnames, idx-1)) == NULL || !mxIsChar(pc))
+      return "namehashmex :  name table does not match the names.";
+   if ( mxGetString(pc, buf, NLEN) )
+      return "namehashmex :  structure name is too long.";
+
+   return NULL;
+}
+
+
+/*-------------------------------------------------------------*/
+
+static void
+get_name(const mxArray *pnames, uint32_t idx, char *buf)
+{
+   const char *msg;
+
+   if ( (msg = read_name(pnames, idx, buf)) )
+      mexErrMsgTxt(msg);
+}
+
+
+/*-------------------------------------------------------------*/
+
+static void
+get_key(const mxArray *pkey, char *buf)
+{
+   if (pkey == NULL || !mxIsChar(pkey))
+      mexErrMsgTxt("namehashmex :  structure names must be strings.");
+   if ( mxGetString(pkey, buf, NLEN) )
+      mexErrMsgTxt("namehashmex :  structure name is too long.");
+}
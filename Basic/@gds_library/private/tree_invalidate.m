@@ -0,0 +1,38 @@
+function [H] = tree_invalidate(H, idx, gstruc)
+%function [H] = tree_invalidate(H, idx, gstruc)
+%
+% tree_invalidate :  marks the hierarchical summaries of a
+%                    replaced structure and of all structures
+%                    referencing it as invalid (see summary).
+%
+% H :       hierarchical summaries of a library (see tree_summary)
+% idx :     index of the replaced structure
+% gstruc :  the new structure
+
+% Initial version, October 2026
+
+    if isempty(H)
+        return
+    end
+
+    % a new or renamed structure can change the references of
+    % any other structure
+    if idx > numel(H.valid) || ~strcmp(sname(gstruc), H.names{idx})
+        H = [];
+        return
+    end
+
+    % find all ancestors of the structure
+    mark = false(numel(H.valid),1);
+    mark(idx) = true;
+    front = idx;
+    while ~isempty(front)
+        par = find(any(H.A(:,front),2));
+        par = par(~mark(par));
+        mark(par) = true;
+        front = par;
+    end
+
+    H.valid(mark) = false;
+
+end
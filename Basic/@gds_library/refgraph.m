@@ -0,0 +1,25 @@
+function [G, glib] = refgraph(glib)
+%function [G, glib] = refgraph(glib)
+%
+% refgraph :  returns the reference graph of the structures in
+%             a library (see funcs/refgraph). The graph is cached
+%             in the library object when the second output
+%             argument is used; it is discarded when structures
+%             are added, removed, renamed, or replaced.
+%
+% glib :      a gds_library object
+% G :         reference graph of the library
+% glib :      (Optional) the library with the cached graph
+%
+% Example:
+%          [G, glib] = refgraph(glib);
+%          ts = topstruct(glib);      % uses the cached graph
+
+% Initial version, October 2026
+
+    if isempty(glib.graph)
+        glib.graph = refgraph(glib.st);
+    end
+    G = glib.graph;
+
+end
@@ -0,0 +1,25 @@
+function [olib] = remap(glib, lmap, dmap)
+%function [olib] = remap(glib, lmap, dmap)
+% 
+% remap :  changes the layers and data types of the elements in
+%          all structures of a library (see gds_structure/remap).
+% 
+% glib :   input gds_library object
+% lmap :   vector with new layers; layer L becomes lmap(L+1)
+% dmap :   (Optional) vector with new data types
+% olib :   output gds_library object
+%
+% Example:
+%        lmap = 0:255; lmap(32) = 131;   % layer 31 --> 131
+%        olib = remap(glib, lmap);
+%
+
+% Initial version, October 2026
+
+    if nargin < 3, dmap = []; end
+
+    olib = glib;
+    olib.st = cellfun(@(s)remap(s, lmap, dmap), glib.st, 'UniformOutput',0);
+    olib.hinfo = [];
+    
+end
@@ -19,6 +19,11 @@ function s = set(glib, varargin)
             error('gds_library.set :  property name must be a string.');
         end
         s.(prop) = val;
+        if strcmp(prop, 'st')
+            s.hinfo = [];
+            s.graph = [];
+            s = name_index(s);
+        end
         varargin(1:2) = [];
         
     end
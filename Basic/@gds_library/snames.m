@@ -12,7 +12,7 @@ function [N,SN] = snames(glib)
 % initial version, August 2013, Ulf Griesmann
 
     % find structure names
-    N = cellfun(@sname, glib.st, 'UniformOutput',0);
+    N = glib.names;
     
     % create struct with GDS structure names
     if nargout > 1
@@ -13,18 +13,20 @@ function [olib] = sremove(ilib, rsname)
     olib = ilib;
 
     % find the structure to remove
-    idx =  1;
-    while idx <= numel(ilib.st)  
-        if strcmp(rsname, sname(ilib.st{idx}))
-            break
-        end
-        idx = idx + 1;
+    idx = namehashmex(ilib.nhash, ilib.names, rsname);
+    if ~idx
+        error(sprintf('gds_library.sremove :  structure >> %s << not found', rsname));
     end
     
-    % remove the structure
+    % remove the structure; the indices of all following
+    % structures change and the name table is rebuilt
     olib.st(idx) = [];
+    olib.names(idx) = [];
+    olib.nhash = namehashmex(olib.names);
     
     % remove all references to the deleted structure
     olib.st = cellfun(@(x)refremove(x,rsname), olib.st, 'UniformOutput',0);
+    olib.hinfo = [];
+    olib.graph = [];
     
 end
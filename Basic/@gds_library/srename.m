@@ -14,20 +14,20 @@ function [olib] = srename(ilib, osname, nsname)
     olib = ilib;
 
     % find the structure that needs to be renamed
-    sidx =  1;
-    while sidx <= numel(ilib.st)  
-        if strcmp(osname, sname(ilib.st{sidx}))
-            break
-        end
-        sidx = sidx + 1;
+    sidx = namehashmex(ilib.nhash, ilib.names, osname);
+    if ~sidx
+        error(sprintf('gds_library.srename :  structure >> %s << not found', osname));
     end
     
     % rename the structure
     olib.st{sidx} = rename(ilib.st{sidx}, nsname);
+    olib = name_set(olib, sidx, nsname);
     
     % rename all references to the renamed structure
     for k = setdiff(1:length(olib.st), sidx)
         olib.st{k} = refrename(ilib.st{k}, osname, nsname);
     end
+    olib.hinfo = [];
+    olib.graph = [];
     
 end
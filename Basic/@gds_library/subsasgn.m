@@ -15,24 +15,32 @@ function glib = subsasgn(glib, ins, val)
   
       case '()'
         idx = ins.subs{:};
+        glib.graph = [];
         if isa(val, 'gds_structure')
             glib.st{idx} = val;
+            glib.hinfo = tree_invalidate(glib.hinfo, idx, val);
+            if isscalar(idx) && idx <= numel(glib.names)+1
+                glib = name_set(glib, idx, sname(val));
+            else
+                glib = name_index(glib);
+            end
         elseif iscell(val) || isempty(val)
             glib.st(idx) = val;
+            glib.hinfo = [];
+            glib = name_index(glib);
         else
             error('gds_library.subsasgn :  rhs. must be gds_structure or cell array.');
         end
         
       case '.'
-        for k = 1:length(glib.st)
-            if strcmp(ins.subs, glib.st{k}.sname)
-                glib.st{k} = val;   
-                break
-            end
+        k = namehashmex(glib.nhash, glib.names, ins.subs);
+        if ~k
+            error(sprintf('gds_library.susasgn :  structure >>> %s <<< not found', ins.subs));
         end
-        
-        % structure was not found if we get here ...
-        error(sprintf('gds_library.susasgn :  structure >>> %s <<< not found', ins.subs));
+        glib.st{k} = val;   
+        glib.graph = [];
+        glib.hinfo = tree_invalidate(glib.hinfo, k, val);
+        glib = name_set(glib, k, sname(val));
         
       otherwise
         error('gds_structure.subsasgn :  must use array indexing.');
@@ -33,14 +33,10 @@ function gstrs = subsref(glib, ins)
         
       case '.'                        % look up structure name
         
-        for k = 1:length(glib.st)
-            if strcmp(idx, sname(glib.st{k})) 
-                gstrs = glib.st{k};
-                break;
-            end
-        end 
-    
-        if isempty(gstrs)
+        k = namehashmex(glib.nhash, glib.names, idx);
+        if k
+            gstrs = glib.st{k};
+        else
             error(sprintf('gds_library.subsref :  structure >> %s << not found', ins.subs));   
         end
         
@@ -26,46 +26,33 @@ function [cas,si] = subtree(glib, sname)
         error('Structure name argument is not a character string.');
     end
     
-    % indices of structures in subtree
-    subtree_ind = [];
-
-    % compute adjacency matrix of input library
-    [A,N] = adjmatrix(glib.st);
+    % reference graph of the library
+    G = refgraph(glib);
 
     % find index of structure 'sname'
-    stri = find(ismember(N,{sname}) > 0);
-    if isempty(stri)
+    stri = namehashmex(glib.nhash, glib.names, sname);
+    if ~stri
         error(sprintf('Structure >>> %s <<< not found in library.', sname));
     end
 
-    % find the indices of all children
-    find_children(A, stri);
-    si = sort(unique(subtree_ind));
-    cas = glib.st(si);
+    % mark all structures reachable from the top structure;
+    % each structure is visited once
+    mark = false(numel(G.names),1);
+    mark(stri) = true;
+    stack = zeros(numel(G.names),1);
+    stack(1) = stri;
+    sp = 1;
+    while sp
+        p = stack(sp);
+        sp = sp - 1;
+        chi = G.child(G.rowptr(p)+1:G.rowptr(p+1));
+        chi = chi(~mark(chi));
+        mark(chi) = true;
+        stack(sp+1:sp+numel(chi)) = chi;
+        sp = sp + numel(chi);
+    end
 
-    function find_children(A, pai);
-      %
-      % Recursively find all children of node pai.
-      %
-      for p = pai
-  
-         % add index to array
-         subtree_ind(end+1) = p;
-    
-         % find the children
-         chi = find(A(p,:)>0);
-    
-         % no more children
-         if isempty(chi)
-            continue
-         end
-    
-         % look for the next generation
-         for c = chi
-            find_children(A, c);
-         end
-         
-      end
-   end % nested function
+    si = find(mark)';
+    cas = glib.st(si);
 
 end
@@ -0,0 +1,27 @@
+function [H, glib] = summary(glib)
+%function [H, glib] = summary(glib)
+%
+% summary :  returns hierarchical summaries of all structures in
+%            a library: the bounding box and the per-layer element
+%            and vertex counts of each resolved structure. The
+%            summaries are computed bottom-up in topological order
+%            and cached in the library object. When a structure in
+%            the library is replaced, only the summaries of the
+%            structure and of the structures referencing it are
+%            recomputed.
+%
+% glib :     a gds_library object
+% H :        a structure with the hierarchical summaries
+%            (see tree_summary)
+% glib :     (Optional) the library with the cached summaries
+%
+% Example:
+%          [H, glib] = summary(glib);
+%          bbx = bbox(glib, 'TOP');   % now O(1)
+
+% Initial version, October 2026
+
+    [H, glib.st] = tree_summary(glib.st, glib.hinfo);
+    glib.hinfo = H;
+
+end
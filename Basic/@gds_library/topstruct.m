@@ -10,11 +10,9 @@ function [ts] = topstruct(glib)
 
 % Initial version, Ulf Griesmann, December 2011
 
-    % calculate the adjacency matrix of the structure tree
-    [A,N] = adjmatrix(glib.st);
-
-    % find top level structure name(s)
-    tops = N(find(sum(A)==0));
+    % top level structures have no parents
+    G = refgraph(glib);
+    tops = G.names(G.top);
 
     % display or return the structure names
     if nargout
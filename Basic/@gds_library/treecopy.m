@@ -11,46 +11,7 @@ function struc = treecopy(glib, sname);
 
 % Initial version, Ulf Griesmann, December 2011
 
-% indices of structures in subtree
-subtree_ind = [];
-
-% compute adjacency matrix of input library
-[A,N] = adjmatrix(glib.st);
-
-% find index of structure 'sname'
-si = find( ismember(N,{sname}) > 0);
-if isempty(si)
-   error(sprintf('Structure >>> %s <<< not found in library.', sname));
-end
-
-% find the indices of all children
-find_children(A, si);
-
-struc = glib.st(unique(subtree_ind));
-
-   function find_children(A, pai);
-      %
-      % Recursively find all children of node si.
-      %
-      for p = pai
-  
-         % add index to array
-         subtree_ind(end+1) = p;
-    
-         % find the children
-         chi = find(A(p,:));
-    
-         % no more children
-         if isempty(chi)
-            continue
-         end
-    
-         % look for the next generation
-         for c = chi
-            find_children(A, c);
-         end
-
-      end
-   end % nested function
+% all structures in the subtree below sname
+struc = subtree(glib, sname);
 
 end
@@ -11,19 +11,19 @@ function treeview(glib);
 % initial version, Ulf Griesmann, NIST, December 2011
 
     % calculate the adjacency matrix of the structure tree
-    [A,N] = adjmatrix(glib.st);
+    G = refgraph(glib);
 
     % find top level structure(s) - they have no parents
-    pai = find(sum(A)==0);  % top parent index (or indices)
+    pai = G.top;  % top parent index (or indices)
     
     % display names beginning with the top
     fprintf('\n');
-    display_tree(A, N, pai, 0);
+    display_tree(G, pai, 0);
     fprintf('\n');
 
 end
 
-function display_tree(A, N, pai, indent);
+function display_tree(G, pai, indent);
 %
 % Function, called recursively, to display the structure 
 % tree described by an adjacency matrix.
@@ -33,13 +33,13 @@ function display_tree(A, N, pai, indent);
         % print parent name
         if indent
             blank(1:indent) = ' ';
-            fprintf('%s%s\n', blank, N{p}); % parent
+            fprintf('%s%s\n', blank, G.names{p}); % parent
         else
-            fprintf('%s\n', N{p}); % parent
+            fprintf('%s\n', G.names{p}); % parent
         end
    
         % find children
-        chi = find(A(p,:));
+        chi = G.child(G.rowptr(p)+1:G.rowptr(p+1))';
    
         % next parent if there are no children
         if isempty(chi)
@@ -48,7 +48,7 @@ function display_tree(A, N, pai, indent);
    
         % otherwise print child generation
         for c = chi
-            display_tree(A, N, c, indent+6);      
+            display_tree(G, c, indent+6);      
         end
    
     end
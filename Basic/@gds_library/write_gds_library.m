@@ -6,6 +6,12 @@ function write_gds_library(glib, fname, varargin)
 % glib  :     a gds_library object
 % fname :     GDS file name. When the file name has the extension .cgds 
 %             a compound GDS file is created instead of a standard GDS file.
+%             When it ends with .gz or .zst, the file is compressed with
+%             gzip or zstd while it is written (see gds_open). When it
+%             ends with .oas, an OASIS file is written. Libraries with
+%             node elements, paths with round ends, or arrays with a
+%             pitch that is not a multiple of the database unit cannot
+%             be written as OASIS files; an error is raised.
 % varargin :  optional argument/value pairs 
 %
 %             verbose : when == 1, print out information about the
@@ -23,8 +29,34 @@ function write_gds_library(glib, fname, varargin)
 %                 option allows the check to be turned off because
 %                 it can be slow. Default is 1 (check uniqueness). 
 %
+%             bufsize : size of the output buffer in MB. The library
+%                 is written to the file in blocks of this size.
+%                 Default is 16 MB.
+%
+%             threads : number of threads used for encoding the
+%                 structures. The structures are encoded into memory
+%                 buffers in parallel and written to the file in the
+%                 order of the library; the file is identical to the
+%                 file written with a single thread. Default is the
+%                 number of processors.
+%
+%             copy : when == 1, structures that were read with
+%                 read_gds_library and were not modified since are
+%                 copied from the library file they were read from
+%                 instead of being encoded, provided the library
+%                 file was not changed, is not the output file, and
+%                 has the database unit of the library. Default is 1.
+%
+%             arefs : when > 0, regular arrays of at least this many
+%                 identical boundaries or structure references are
+%                 replaced with array references before the library
+%                 is written (see gds_library/aref_compress). Default
+%                 is 0 (no replacement).
+%
 
 % Ulf Griesmann, NIST, November 2011
+% Option to write arrays of identical elements as arefs, October 2026
+% Write OASIS files, October 2026
 
     % check argument number
     if nargin < 3, varargin = []; end
@@ -40,6 +72,10 @@ function write_gds_library(glib, fname, varargin)
     verbose = 1;
     compound = 0;
     uniq = 1;
+    bufsize = 16;
+    nthreads = [];
+    copy = 1;
+    arefs = 0;
     
     % process varargin
     if ~isempty(varargin)
@@ -53,6 +89,14 @@ function write_gds_library(glib, fname, varargin)
                 compound = valu;
               case 'unique'
                 uniq = valu;
+              case 'bufsize'
+                bufsize = valu;
+              case 'threads'
+                nthreads = valu;
+              case 'copy'
+                copy = valu;
+              case 'arefs'
+                arefs = valu;
               otherwise
                 error(sprintf('unknown property --> %s\n', prop));
             end
@@ -101,12 +145,46 @@ function write_gds_library(glib, fname, varargin)
     % start time
     t_start = cputime();
     
+    % replace arrays of identical elements
+    if arefs > 0
+        glib = aref_compress(glib, arefs);
+    end
+    
+    % unmodified structures are copied from their library file;
+    % must be determined before an existing output file is renamed
+    if copy
+        copy = copy_sources(glib, fname);
+    else
+        copy = false(1, numel(glib.st));
+    end
+    if verbose && any(copy)
+        fprintf('Copied        : %d unmodified structures\n\n', sum(copy));
+    end
+    
     % initialize the library file
     gf = gds_initialize(fname, glib.uunit, glib.dbunit, ...
-                        glib.lname, glib.reflibs, glib.fonts);
+                        glib.lname, glib.reflibs, glib.fonts, ...
+                        bufsize * 2^20);
     
-    % write all structures in library to file
-    cellfun(@(x)write_structure(x,gf,glib.uunit,glib.dbunit,compound), glib.st);
+    % write all structures in library to file. The element data are
+    % passed to gds_write_structures_mex in chunks of about CHUNK
+    % elements, which limits the memory for decoded lazy elements.
+    CHUNK = 2^20;
+    nel = cellfun(@(x)numel(x), glib.st);
+    nel(copy) = 0;
+    ks = 1;
+    while ks <= numel(glib.st)
+        ke = ks;
+        ne = nel(ks);
+        while ke < numel(glib.st) && ne + nel(ke+1) <= CHUNK
+            ke = ke + 1;
+            ne = ne + nel(ke);
+        end
+        S = cellfun(@(x,c)write_data(x,c), glib.st(ks:ke), num2cell(copy(ks:ke)), ...
+                    'UniformOutput',0);
+        gds_write_structures_mex(gf, S, glib.uunit/glib.dbunit, compound, nthreads);
+        ks = ke + 1;
+    end
     
     % close file
     gds_endlib(gf);
@@ -18,6 +18,7 @@ function [ostruc] = add_element(istruc, varargin)
 
    % copy input to output
    ostruc = istruc;
+   nold = numel(istruc.el);
 
    for k=1:length(varargin)
 
@@ -34,4 +35,16 @@ function [ostruc] = add_element(istruc, varargin)
        end 
     end
 
+    % the spatial index must be rebuilt
+    ostruc.ebox = [];
+    ostruc.rtree = [];
+    ostruc.cols = [];
+    ostruc.src = [];
+
+    % add the new elements to the summary
+    if ~isempty(ostruc.info)
+        ostruc.info = merge_summary(ostruc.info, ...
+                                    summarize_elements(ostruc.el(nold+1:end)));
+    end
+
 end
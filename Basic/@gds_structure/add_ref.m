@@ -53,4 +53,18 @@ function [ostruc] = add_ref(istruc, struc, varargin)
    % add them to output structure
    ostruc.el = [ostruc.el, rel];
 
+   % reference elements have no bounding box; the spatial index
+   % remains valid
+   if ~isempty(ostruc.ebox)
+      ostruc.ebox = [ostruc.ebox; repmat([Inf,Inf,-Inf,-Inf], numel(rel), 1)];
+   end
+
+   ostruc.cols = [];
+   ostruc.src = [];
+
+   % add the references to the summary
+   if ~isempty(ostruc.info)
+      ostruc.info = merge_summary(ostruc.info, summarize_elements(rel));
+   end
+
 end
@@ -0,0 +1,37 @@
+function [cstruc] = aref_compress(gstruc, A, R)
+%function [cstruc] = aref_compress(gstruc, A, R)
+% 
+% replaces regular arrays of identical elements in a structure
+% with array references. This method applies the arrays found by
+% gds_aref_compress_mex and is called by gds_library/aref_compress,
+% which finds the arrays in all structures of a library.
+% 
+% gstruc :   input gds_structure object
+% A :        cell array with the data structures of the aref
+%            elements returned by gds_aref_compress_mex for
+%            this structure.
+% R :        logical row vector that is true for the elements
+%            replaced by the arefs.
+% cstruc :   output gds_structure object
+%
+
+% Initial version, October 2026
+
+    cstruc = gstruc;
+    if ~any(R)
+        return
+    end
+
+    % remove the replaced elements and append the arefs
+    cstruc.el(R) = [];
+    for k = 1:numel(A)
+        cstruc.el{end+1} = gds_element('_file_', A{k});
+    end
+
+    cstruc.ebox = [];
+    cstruc.rtree = [];
+    cstruc.info = [];
+    cstruc.cols = [];
+    cstruc.src = [];
+
+end
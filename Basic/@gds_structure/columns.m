@@ -0,0 +1,48 @@
+function [C, gstruc] = columns(gstruc)
+%function [C, gstruc] = columns(gstruc)
+%
+% columns :  returns the elements of a structure in columnar
+%            form: packed arrays with the type, layer, data type,
+%            and flags of all elements, one slab with the vertices
+%            of all elements, and a side table with the properties.
+%            Vectorized queries on the table (see selectel) do not
+%            access the gds_element objects. The table is created
+%            when the structure is read (see read_gds_library), or
+%            computed once from the elements and cached in the
+%            structure object. It is discarded when the elements of
+%            the structure change.
+%
+% gstruc :   a gds_structure object
+% C :        a structure with the fields
+%              C.kind :  nel x 1 uint8 element types; 1 = boundary,
+%                        2 = path, 3 = box, 4 = node, 5 = text,
+%                        6 = sref, 7 = aref
+%              C.layer : nel x 1 uint16 layers (0 for references)
+%              C.dtype : nel x 1 uint16 data types (0 for references)
+%              C.flags : nel x 1 uint16 element flags; bit 14 is the
+%                        'E' flag and bit 15 the 'T' flag (see
+%                        gds_element)
+%              C.poff :  (nel+1) x 1 polygon offsets; the polygons of
+%                        element k are C.poff(k)+1:C.poff(k+1)
+%              C.voff :  (npol+1) x 1 vertex offsets; polygon p has
+%                        the vertices C.xy(C.voff(p)+1:C.voff(p+1),:)
+%              C.xy :    vertex slab; boundaries and paths have one
+%                        polygon per XY record, all other elements
+%                        one polygon with their positions
+%              C.pel :   element index of each property
+%              C.pattr : property attributes
+%              C.pval :  cell array with property values
+% gstruc :   (Optional) the structure with the cached table
+%
+% Example:
+%          [C, gs] = columns(gs);  % repeated calls are O(1)
+%          nb = sum(C.kind == 1 & C.layer == 31);
+
+% Initial version, October 2026
+
+    if isempty(gstruc.cols)
+        gstruc.cols = element_columns(gstruc.el);
+    end
+    C = gstruc.cols;
+
+end
@@ -1,11 +1,14 @@
-function rnam = find_ref(gstruct)
-%function rnam = find_ref(gstruct)
+function [rnam, ninst] = find_ref(gstruct)
+%function [rnam, ninst] = find_ref(gstruct)
 %
 % A method that finds and returns the names of all structures
 % referenced in a structure
 %
 % gstruct :  a gds_structure object
 % rnam :     a cell array of structure names referenced by gstruct 
+% ninst :    (Optional) a vector with the number of structure
+%            instances placed by each reference element
+%            (columns x rows for arefs)
 %
 
 % Ulf Griesmann, NIST, November 2011
@@ -13,6 +16,7 @@ function rnam = find_ref(gstruct)
    % max. length of output cell array
    nel = length(gstruct.el);
    rnam = cell(1,nel);
+   ninst = zeros(1,nel);
    
    m = 0;
    for k = 1:nel
@@ -20,10 +24,19 @@ function rnam = find_ref(gstruct)
        if is_ref(E)
            m = m + 1;
            rnam{m} = sname(E);
+           if nargout > 1
+               if strcmp(etype(E), 'aref')
+                   ad = adim(E);
+                   ninst(m) = ad.row * ad.col;
+               else
+                   ninst(m) = size(xy(E),1);
+               end
+           end
        end
    end
    
-   % truncate output array
+   % truncate output arrays
    rnam = rnam(1:m);
+   ninst = ninst(1:m);
    
 end
@@ -1,16 +1,23 @@
-function gelms = findel(gstruct, ffunc)
-%function gelms = findel(gstruct, ffunc)
+function [gelms, idx] = findel(gstruct, ffunc, varargin)
+%function [gelms, idx] = findel(gstruct, ffunc)
+%function [gelms, idx] = findel(gstruct, win, ffunc)
 %
 % Find method for the gds_structure class. Can be used to find 
-% elements with specific properties.
+% elements with specific properties or elements in a window.
 %
 % gstruct :  a gds_structure object
 % ffunc :    the handle of a function that is applied to each 
 %            element contained in the structure gstruct. It returns 
 %            either 0 or ~= 0. The elements for which ffunc returns
 %            a value ~= o are returned in a cell array.
+% win :      a window [llx,lly,urx,ury] or a point [x,y]. Only the
+%            elements whose bounding boxes overlap the window are
+%            returned, or tested with ffunc when it is given.
+%            Reference, text, and node elements have no bounding
+%            box and are never in a window.
 % gelms :    a cell array of gds_element objects for which
 %            ffunc(gelm) ~= 0
+% idx :      (Optional) the indices of the elements in gstruct
 % 
 % Example:
 %
@@ -23,6 +30,15 @@ function gelms = findel(gstruct, ffunc)
 %
 % returns all sref (and aref) elements contained in structure gstruct.
 %
+%  gelms = findel(gstruct, [0,0,50,50], @(x) x.layer == 3);
+%
+% returns the elements on layer 3 that overlap the window. Window
+% queries use the spatial index of the structure (see spindex). When
+% the structure has no index, it is built for the query.
+%
+% Selections by element type, layer, and data type are faster with
+% selectel, which does not call a function for every element.
+%
 
 % Ulf Griesmann, NIST, November 2011
 
@@ -30,7 +46,23 @@ function gelms = findel(gstruct, ffunc)
         error('gds_structure.find : missing argument.');
     end
 
+    % window or point query
+    if isnumeric(ffunc)
+        if isempty(gstruct.rtree)
+            gstruct = spindex(gstruct);
+        end
+        idx = rtreemex(gstruct.rtree, ffunc);
+        gelms = gstruct.el(idx);
+        if ~isempty(varargin)
+            sel = cellfun(varargin{1}, gelms) ~= 0;
+            gelms = gelms(sel);
+            idx = idx(sel);
+        end
+        return
+    end
+
     % return all elements with desired property
-    gelms = gstruct.el( cellfun(ffunc, gstruct.el) ~= 0 );
+    idx = find( cellfun(ffunc, gstruct.el) ~= 0 );
+    gelms = gstruct.el(idx);
       
-end  
+end
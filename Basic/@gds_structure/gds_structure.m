@@ -24,6 +24,22 @@ function gstruc = gds_structure(sname, varargin)
     gstruc.cdate = datevec(now);              % creation date
     gstruc.cdate(6) = round(gstruc.cdate(6)); % to nearest second
     gstruc.mdate = [];                        % modification date
+
+    % element bounding boxes and spatial index (see spindex)
+    gstruc.ebox = [];
+    gstruc.rtree = [];
+
+    % cached summary of the elements (see summary)
+    gstruc.info = [];
+
+    % columnar element table (see columns)
+    gstruc.cols = [];
+
+    % source of a structure that was read from a file and was not
+    % modified since; it is copied from the file when the library
+    % is written (see write_gds_library). All methods that change
+    % the structure clear the source.
+    gstruc.src = [];
     
     % add the elements to the structure
     while length(varargin) > 0
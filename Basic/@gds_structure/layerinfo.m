@@ -10,6 +10,7 @@ function [S,L] = layerinfo(gstruc)
 %          per layer.
 %          S(k).(etype) contains the number of elements of 
 %          type 'etype' on layer k. E.g.: S(10).boundary
+%          S(k).vertices is the number of vertices on layer k.
 %          When the output argument is omitted, the layer
 %          information is printed on the screen.
 % L :      (Optional) a vector with layers that contain elements
@@ -17,19 +18,21 @@ function [S,L] = layerinfo(gstruc)
 
 % initial version, Ulf Griesmann, NIST, August 30, 2016
 
-    % initialize variables for accounting
-    numl = 256; % max number of layers
-    Si = repmat(struct('boundary',0,'path',0,'box',0,'node',0,'text',0),1,numl);
+    % element counts from the structure summary
+    sm = summary(gstruc);
+    C = sm.lcnt;
+    numl = max([256; find(any(C,2), 1, 'last')]);
+    Si = repmat(struct('boundary',0,'path',0,'box',0,'node',0,'text',0,'vertices',0),1,numl);
     Li = zeros(1,numl);
     
-    % iterate over all elements
-    for s=1:numel(gstruc.el)
-        el = gstruc.el{s};
-        if ~is_ref(el)            % sref and aref have no layer information
-            numl = layer(el) + 1; % gds layer numbers start with 0
-            Li(numl) = Li(numl) + 1; 
-            Si(numl).(etype(el)) = Si(numl).(etype(el)) + 1;
-        end
+    for l = find(any(C,2))'
+        Li(l) = full(sum(C(l,1:5)));
+        Si(l).boundary = full(C(l,1));
+        Si(l).path     = full(C(l,2));
+        Si(l).box      = full(C(l,3));
+        Si(l).node     = full(C(l,4));
+        Si(l).text     = full(C(l,5));
+        Si(l).vertices = full(C(l,6));
     end
 
     %display
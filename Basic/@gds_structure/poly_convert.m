@@ -1,11 +1,15 @@
-function [cstruc] = poly_convert(gstruc)
-%function [cstruc] = poly_convert(gstruc)
+function [cstruc] = poly_convert(gstruc, D, R)
+%function [cstruc] = poly_convert(gstruc, D, R)
 % 
 % converts path or box elements into 
 % equivalent boundary elements. Text and
 % node elements are removed.
 % 
 % gstruc :   input gds_structure object
+% D, R :     (Optional) converted elements returned by
+%            gds_poly_convert_mex for this structure. They are
+%            passed by gds_library/poly_convert, which converts
+%            all structures of a library in one call.
 % cstruc :   output gds_structure object
 %
 % Example:
@@ -19,38 +23,31 @@ function [cstruc] = poly_convert(gstruc)
 % structure !
 
 % Initial version, Ulf Griesmann, December 2011
+% Convert all elements with gds_poly_convert_mex, October 2026
 
-    % copy structure
-    cstruc = gstruc;
-    m = 1;
-    
-    % this isn't elegant, but I couldn't think of a better way yet ..
-    for k = 1:length(gstruc.el)    % loop over elements
-        
-        switch etype(gstruc.el{k})
-            
-          case 'path'
-            cstruc.el{m} = poly_path(gstruc.el{k}); 
-            m = m + 1;
-            
-          case 'box'
-            cstruc.el{m} = poly_box(gstruc.el{k}); 
-            m = m + 1;
-            
-          case {'text','node'}
-            % ignore - don't copy   
-            
-          otherwise
-            cstruc.el{m} = gstruc.el{k};    
-            m = m + 1;
-            
+    % convert boxes and paths
+    if nargin < 3
+        if isempty(gstruc.el)
+            D = {};
+            R = false(1,0);
+        else
+            [D, R] = gds_poly_convert_mex({write_data(gstruc.el{:})});
+            D = D{1};
+            R = R{1};
         end
-        
     end
-    
-    % shorten if text elements were removed
-    if m <= length(gstruc.el)
-        cstruc.el(m:end) = [];
+
+    % copy structure and replace the converted elements
+    cstruc = gstruc;
+    for k = find(~cellfun(@isempty, D))
+        cstruc.el{k} = gds_element('_file_', D{k});
     end
+    cstruc.el(R) = [];
+
+    cstruc.ebox = [];
+    cstruc.rtree = [];
+    cstruc.info = [];
+    cstruc.cols = [];
+    cstruc.src = [];
 
 end
@@ -0,0 +1,69 @@
+function [C] = element_columns(el)
+%function [C] = element_columns(el)
+%
+% element_columns :  creates the columnar table of a list of
+%                    elements (see columns). This is the fallback
+%                    for structures that were not read with columns
+%                    (see read_gds_library), and it accesses every
+%                    element once.
+%
+% el :  a cell array of gds_element objects
+% C :   columnar element table
+
+% Initial version, October 2026
+
+    etypes = {'boundary','path','box','node','text','sref','aref'};
+
+    nel = numel(el);
+    C.kind  = zeros(nel,1,'uint8');
+    C.layer = zeros(nel,1,'uint16');
+    C.dtype = zeros(nel,1,'uint16');
+    C.flags = zeros(nel,1,'uint16');
+
+    P = cell(1,nel);     % polygons of each element
+    pnum = zeros(nel,1); % number of polygons
+    R = cell(1,nel);     % properties of each element
+    E = cell(1,nel);     % element index of each property
+
+    for k = 1:nel
+        elk = el{k};
+        C.kind(k) = find(strcmp(etype(elk), etypes));
+        if ~is_ref(elk)
+            [C.layer(k), C.dtype(k)] = layer(elk);
+        end
+        ef = get(elk, 'elflags');
+        C.flags(k) = 2^14 * any(ef == 'E') + 2^15 * any(ef == 'T');
+        d = get(elk);
+        if isfield(d, 'xy') && ~isempty(d.xy)
+            if iscell(d.xy)
+                P{k} = d.xy(:)';
+            else
+                P{k} = {d.xy};
+            end
+            pnum(k) = numel(P{k});
+        end
+        if isfield(d, 'prop') && ~isempty(d.prop)
+            R{k} = d.prop(:)';
+            E{k} = repmat(k, numel(d.prop), 1);
+        end
+    end
+
+    % polygon and vertex offsets, vertex slab
+    P = [P{:}];
+    vnum = cellfun(@(c)size(c,1), P);
+    C.poff = [0; cumsum(pnum)];
+    C.voff = [0; cumsum(vnum(:))];
+    C.xy = vertcat(zeros(0,2), P{:});
+
+    % property side table
+    R = [R{:}];
+    C.pel = vertcat(zeros(0,1), E{:});
+    if isempty(R)
+        C.pattr = zeros(0,1,'int16');
+        C.pval = cell(0,1);
+    else
+        C.pattr = int16([R.attr]');
+        C.pval = {R.name}';
+    end
+
+end
@@ -0,0 +1,13 @@
+function [S] = merge_summary(S, T)
+%function [S] = merge_summary(S, T)
+%
+% merge_summary :  adds the summary T of new elements to the
+%                  summary S of a structure.
+
+% Initial version, October 2026
+
+    S.bbox = [min(S.bbox(1:2), T.bbox(1:2)), max(S.bbox(3:4), T.bbox(3:4))];
+    S.ref = [S.ref, T.ref];
+    S.lcnt = S.lcnt + T.lcnt;
+
+end
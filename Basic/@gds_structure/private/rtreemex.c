@@ -0,0 +1,281 @@
+/*
+ * A mex function for a packed R-tree of element bounding boxes
+ *
+ * tree = rtreemex(bbox);
+ * idx = rtreemex(tree, win);
+ *
+ * bbox :  nel x 4 matrix with element bounding boxes [llx,lly,urx,ury]
+ *         (see gds_element/bbox). Rows with NaN or empty bounding
+ *         boxes (llx > urx) are not entered into the tree.
+ * tree :  6 x M matrix with the nodes of the R-tree. Each column
+ *         contains the bounding box of a node followed by the index
+ *         of its first child and the number of children. For leaf
+ *         nodes the number of children is 0 and the index is that
+ *         of the element (row in bbox). The root is in the last
+ *         column.
+ * win :   a window [llx,lly,urx,ury] or a point [x,y]
+ * idx :   row vector with the indices of all elements whose
+ *         bounding boxes overlap the window, in ascending order.
+ *
+ * The tree is bulk loaded with the Sort-Tile-Recursive (STR)
+ * algorithm: the boxes of each level are sorted into vertical
+ * slices by their centers, each slice is sorted from bottom to
+ * top, and consecutive runs of NODE_SIZE boxes become the nodes
+ * of the next level. A window query visits O(log n + k) nodes.
+ *
+ * Reference:
+ * S. T. Leutenegger, M. A. Lopez, J. Edgington, "STR: A Simple and
+ * Efficient Algorithm for R-Tree Packing", Proc. 13th ICDE (1997)
+ *
+ * This software is in the Public Domain
+ * Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <mex.h>
+
+#define NODE_SIZE  16
+#define MAX_STACK  1024   /* > tree height * NODE_SIZE */
+#define NROWS      6
+
+
+/*-- local prototypes -----------------------------------------*/
+
+static mxArray *build_tree(const mxArray *pbox);
+static mxArray *query_tree(const mxArray *ptree, const mxArray *pwin);
+static void str_order(double *box, size_t n, size_t *ord);
+static int cmp_key(const void *a, const void *b);
+
+
+/*-- data -----------------------------------------------------*/
+
+static const double *sort_key;    /* sort keys for cmp_key */
+
+
+/*-------------------------------------------------------------*/
+
+void 
+mexFunction(int nlhs, mxArray *plhs[], 
+	    int nrhs, const mxArray *prhs[])
+{
+   if (nrhs == 1) {
+      if ( !mxIsDouble(prhs[0]) || (mxGetN(prhs[0]) != 4 && !mxIsEmpty(prhs[0])) )
+	 mexErrMsgTxt("rtreemex :  argument must be a nel x 4 matrix.");
+      plhs[0] = build_tree(prhs[0]);
+   }
+   else if (nrhs == 2) {
+      if ( !mxIsDouble(prhs[0]) || mxGetM(prhs[0]) != NROWS )
+	 mexErrMsgTxt("rtreemex :  first argument must be an R-tree.");
+      if ( !mxIsDouble(prhs[1]) ||
+	   (mxGetNumberOfElements(prhs[1]) != 4 && mxGetNumberOfElements(prhs[1]) != 2) )
+	 mexErrMsgTxt("rtreemex :  window must be [llx,lly,urx,ury] or [x,y].");
+      plhs[0] = query_tree(prhs[0], prhs[1]);
+   }
+   else
+      mexErrMsgTxt("rtreemex :  expected 1 or 2 arguments.");
+}
+
+
+/*-------------------------------------------------------------*/
+
+/*
+ * bulk loads the tree level by level. The boxes of a level are
+ * stored in STR order, then their parents are created.
+ */
+static mxArray *
+build_tree(const mxArray *pbox)
+{
+   mxArray *ptree;
+   double *pb, *pt, *lev, *tmp, *pn;
+   size_t *ord;
+   size_t nel, n, m, k, j, c, nnodes, first;
+
+   nel = mxGetM(pbox);
+   pb = mxGetData(pbox);
+
+   /* level boxes with payload: x0,y0,x1,y1,first,count */
+   lev = mxMalloc((nel+1) * NROWS * sizeof(double));
+   for (n=0,k=0; k<nel; k++) {
+      if (isnan(pb[k]) || isnan(pb[k+nel]) || isnan(pb[k+2*nel]) || isnan(pb[k+3*nel]))
+	 continue;
+      if (pb[k] > pb[k+2*nel] || pb[k+nel] > pb[k+3*nel])
+	 continue;
+      pn = lev + NROWS*n++;
+      pn[0] = pb[k];
+      pn[1] = pb[k+nel];
+      pn[2] = pb[k+2*nel];
+      pn[3] = pb[k+3*nel];
+      pn[4] = (double)(k+1);
+      pn[5] = 0.0;
+   }
+   if (!n) {
+      mxFree(lev);
+      return mxCreateDoubleMatrix(NROWS, 0, mxREAL);
+   }
+
+   /* total number of nodes */
+   for (nnodes=n, m=n; m>1; ) {
+      m = (m + NODE_SIZE - 1) / NODE_SIZE;
+      nnodes += m;
+   }
+   ptree = mxCreateDoubleMatrix(NROWS, nnodes, mxREAL);
+   pt = mxGetData(ptree);
+   ord = mxMalloc(n * sizeof(size_t));
+   tmp = mxMalloc(n * NROWS * sizeof(double));
+
+   first = 0;
+   while (1) {
+
+      /* store the level in STR order */
+      str_order(lev, n, ord);
+      for (k=0; k<n; k++)
+	 memcpy(pt + NROWS*(first+k), lev + NROWS*ord[k], NROWS*sizeof(double));
+      if (n == 1)
+	 break;
+
+      /* parents of the level */
+      m = (n + NODE_SIZE - 1) / NODE_SIZE;
+      for (j=0; j<m; j++) {
+	 pn = tmp + NROWS*j;
+	 c = j*NODE_SIZE;
+	 memcpy(pn, pt + NROWS*(first+c), 4*sizeof(double));
+	 pn[4] = (double)(first+c);
+	 pn[5] = (double)(n - c < NODE_SIZE ? n - c : NODE_SIZE);
+	 for (k=c+1; k<c+(size_t)pn[5]; k++) {
+	    pb = pt + NROWS*(first+k);
+	    if (pb[0] < pn[0]) pn[0] = pb[0];
+	    if (pb[1] < pn[1]) pn[1] = pb[1];
+	    if (pb[2] > pn[2]) pn[2] = pb[2];
+	    if (pb[3] > pn[3]) pn[3] = pb[3];
+	 }
+      }
+      memcpy(lev, tmp, m * NROWS * sizeof(double));
+      first += n;
+      n = m;
+   }
+
+   mxFree(tmp);
+   mxFree(ord);
+   mxFree(lev);
+
+   return ptree;
+}
+
+
+/*-------------------------------------------------------------*/
+
+static mxArray *
+query_tree(const mxArray *ptree, const mxArray *pwin)
+{
+   mxArray *pidx;
+   double *pt, *pw, *pn, *pd;
+   double w[4];
+   size_t stack[MAX_STACK];
+   size_t *res;
+   size_t M, ns, nres, ares, k, c;
+
+   M = mxGetN(ptree);
+   pt = mxGetData(ptree);
+   pw = mxGetData(pwin);
+   if (mxGetNumberOfElements(pwin) == 4) {
+      w[0] = pw[0]; w[1] = pw[1]; w[2] = pw[2]; w[3] = pw[3];
+   }
+   else {
+      w[0] = w[2] = pw[0];
+      w[1] = w[3] = pw[1];
+   }
+
+   nres = 0;
+   ares = 64;
+   res = mxMalloc(ares * sizeof(size_t));
+
+   /* depth first traversal starting at the root */
+   ns = 0;
+   if (M)
+      stack[ns++] = M-1;
+   while (ns) {
+      pn = pt + NROWS*stack[--ns];
+      if (pn[0] > w[2] || pn[2] < w[0] || pn[1] > w[3] || pn[3] < w[1])
+	 continue;
+      if (pn[5] == 0.0) {
+	 if (nres == ares) {
+	    ares *= 2;
+	    res = mxRealloc(res, ares * sizeof(size_t));
+	 }
+	 res[nres++] = (size_t)pn[4];
+      }
+      else {
+	 c = (size_t)pn[5];
+	 if (ns + c > MAX_STACK)
+	    mexErrMsgTxt("rtreemex :  invalid R-tree.");
+	 for (k=0; k<c; k++)
+	    stack[ns++] = (size_t)pn[4] + k;
+      }
+   }
+
+   /* return the indices in element order */
+   qsort(res, nres, sizeof(size_t), cmp_key);
+   pidx = mxCreateDoubleMatrix(1, nres, mxREAL);
+   pd = mxGetData(pidx);
+   for (k=0; k<nres; k++)
+      pd[k] = (double)res[k];
+   mxFree(res);
+
+   return pidx;
+}
+
+
+/*-------------------------------------------------------------*/
+
+/*
+ * compares two sort positions by their keys, or two indices
+ * when no keys are set
+ */
+static int
+cmp_key(const void *a, const void *b)
+{
+   size_t ia = *(const size_t *)a;
+   size_t ib = *(const size_t *)b;
+
+   if (sort_key) {
+      if (sort_key[ia] < sort_key[ib]) return -1;
+      if (sort_key[ia] > sort_key[ib]) return 1;
+   }
+   return ia < ib ? -1 : (ia > ib ? 1 : 0);
+}
+
+
+/*-------------------------------------------------------------*/
+
+/*
+ * returns the Sort-Tile-Recursive order of n boxes in ord
+ */
+static void
+str_order(double *box, size_t n, size_t *ord)
+{
+   double *key;
+   size_t k, s, nslice, ns;
+
+   key = mxMalloc(n * sizeof(double));
+
+   /* sort by the x coordinate of the centers */
+   for (k=0; k<n; k++) {
+      ord[k] = k;
+      key[k] = box[NROWS*k] + box[NROWS*k+2];
+   }
+   sort_key = key;
+   qsort(ord, n, sizeof(size_t), cmp_key);
+
+   /* sort vertical slices by the y coordinate of the centers */
+   nslice = (size_t)ceil(sqrt(ceil((double)n / NODE_SIZE)));
+   ns = nslice * NODE_SIZE;
+   for (k=0; k<n; k++)
+      key[k] = box[NROWS*k+1] + box[NROWS*k+3];
+   for (s=0; s<n; s+=ns)
+      qsort(ord + s, n - s < ns ? n - s : ns, sizeof(size_t), cmp_key);
+   sort_key = NULL;
+
+   mxFree(key);
+}
@@ -0,0 +1,79 @@
+function [S] = summarize_elements(el, ebox, C)
+%function [S] = summarize_elements(el, ebox, C)
+%
+% summarize_elements :  computes the summary of a list of
+%                       elements (see summary).
+%
+% el :    a cell array of gds_element objects
+% ebox :  (Optional) a matrix with the element bounding boxes.
+%         Rows with NaN entries are computed.
+% C :     (Optional) columnar table of the elements (see columns).
+%         Element types, layers, and vertex counts are taken from
+%         the table; only references and elements with unknown
+%         bounding boxes are accessed.
+% S :     summary structure with fields bbox, ref, and lcnt
+
+% Initial version, October 2026
+
+    nel = numel(el);
+    if nargin < 2 || size(ebox,1) ~= nel
+        ebox = NaN(nel,4);
+    end
+
+    S.bbox = [Inf,Inf,-Inf,-Inf];
+    S.ref = struct('sname',{}, 'strans',{}, 'xy',{}, 'adim',{});
+    S.lcnt = sparse(65536,6);
+
+    etypes = {'boundary','path','box','node','text'};
+    lay = zeros(nel,1);  % layer of each element
+    ety = zeros(nel,1);  % element type index, 0 for references
+    vnum = zeros(nel,1); % number of vertices
+    rec = 0;
+
+    % use the columnar table when there is one
+    if nargin > 2 && ~isempty(C)
+        ety = double(C.kind);
+        ety(ety > 5) = 0;
+        lay = double(C.layer);
+        vnum = C.voff(C.poff(2:end)+1) - C.voff(C.poff(1:end-1)+1);
+        todo = find(~ety | isnan(ebox(:,1)))';
+    else
+        todo = 1:nel;
+    end
+
+    for k = todo
+        elk = el{k};
+        if is_ref(elk)
+            rec = rec + 1;
+            S.ref(rec).sname  = sname(elk);
+            S.ref(rec).strans = strans(elk);
+            S.ref(rec).xy     = xy(elk);
+            S.ref(rec).adim   = adim(elk);
+        else
+            lay(k) = layer(elk);
+            ety(k) = find(strcmp(etype(elk), etypes));
+            pxy = xy(elk);
+            if iscell(pxy)
+                vnum(k) = sum(cellfun(@(c)size(c,1), pxy));
+            else
+                vnum(k) = size(pxy,1);
+            end
+            if isnan(ebox(k,1))
+                ebox(k,:) = bbox(elk);
+            end
+        end
+    end
+
+    % bounding box of all elements that are not references
+    els = find(ety);
+    if ~isempty(els)
+        S.bbox = [min(ebox(els,1:2),[],1), max(ebox(els,3:4),[],1)];
+    end
+
+    % element and vertex counts on each layer
+    if ~isempty(els)
+        S.lcnt = sparse([lay(els);lay(els)] + 1, [ety(els);6*ones(numel(els),1)], ...
+                        [ones(numel(els),1);vnum(els)], 65536, 6);
+    end
+
+end
@@ -18,6 +18,13 @@ function [ostruc] = refremove(istruc, rsname)
     % remove them
     if any(rel)
         ostruc.el = ostruc.el(~rel);
+        ostruc.ebox = [];
+        ostruc.rtree = [];
+        ostruc.cols = [];
+        ostruc.src = [];
+        if ~isempty(ostruc.info)
+            ostruc.info.ref = ostruc.info.ref(~strcmp(rsname, {ostruc.info.ref.sname}));
+        end
     end
     
 end
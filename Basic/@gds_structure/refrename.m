@@ -20,8 +20,16 @@ function [ostruc] = refrename(istruc, osname, nsname)
             if strcmp(osname, E.sname)    % check referenced structure name
                 E.sname = nsname;          % replace name
                 ostruc.el{k} = E;
+                ostruc.src = [];
             end
         end
     end
+
+    % rename the references in the summary
+    if ~isempty(ostruc.info)
+        for k = find(strcmp(osname, {ostruc.info.ref.sname}))
+            ostruc.info.ref(k).sname = nsname;
+        end
+    end
     
 end
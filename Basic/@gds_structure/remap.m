@@ -0,0 +1,69 @@
+function [gstruc] = remap(gstruc, lmap, dmap)
+%function [gstruc] = remap(gstruc, lmap, dmap)
+%
+% remap :  changes the layers and data types of all elements in a
+%          structure with one call to set_element_data per property
+%          (see batch_set).
+%
+% gstruc :  a gds_structure object
+% lmap :    vector with new layers; elements on layer L are moved
+%           to layer lmap(L+1). Layers without an entry in lmap,
+%           or with a NaN entry, are not changed. No layers are
+%           changed when lmap is empty.
+% dmap :    (Optional) vector with new data types; data type D
+%           becomes dmap(D+1), as for lmap.
+%
+% Example:
+%          lmap = 0:255; lmap(32) = 131;   % layer 31 --> 131
+%          gs = remap(gs, lmap);
+
+% Initial version, October 2026
+
+    if nargin < 3, dmap = []; end
+    if isempty(gstruc.el)
+        return
+    end
+
+    % current layers and data types; from the columnar table
+    % when the structure has one
+    if ~isempty(gstruc.cols)
+        isref = gstruc.cols.kind > 5;
+        lay = double(gstruc.cols.layer)';
+        dty = double(gstruc.cols.dtype)';
+        lay(isref) = NaN;
+        dty(isref) = NaN;
+    else
+        lay = batch_get(gstruc.el{:}, 'layer');
+        dty = batch_get(gstruc.el{:}, 'dtype');
+    end
+
+    if ~isempty(lmap)
+        gstruc = apply_map(gstruc, 'layer', lay, lmap);
+    end
+    if ~isempty(dmap)
+        gstruc = apply_map(gstruc, 'dtype', dty, dmap);
+    end
+
+    % element counts per layer must be recomputed
+    gstruc.info = [];
+
+end
+
+
+function gstruc = apply_map(gstruc, prop, old, map)
+%
+% sets the mapped values of a property in all elements
+%
+    new = NaN(size(old));
+    sel = ~isnan(old) & old < numel(map);
+    new(sel) = map(old(sel) + 1);
+    if ~any(~isnan(new) & new ~= old)
+        return
+    end
+    gstruc.el = batch_set(gstruc.el{:}, prop, new);
+    gstruc.src = [];
+    if ~isempty(gstruc.cols)
+        sel = ~isnan(new);
+        gstruc.cols.(prop)(sel) = new(sel);
+    end
+end
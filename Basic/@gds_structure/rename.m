@@ -14,5 +14,6 @@ function s = rename(gstruc, sname)
     
     s = gstruc;
     s.sname = sname;
+    s.src = [];
     
 end
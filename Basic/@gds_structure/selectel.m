@@ -0,0 +1,73 @@
+function [idx, P] = selectel(gstruc, etype, lay, dtype)
+%function [idx, P] = selectel(gstruc, etype, lay, dtype)
+%
+% selectel :  selects elements by element type, layer, and data
+%             type with a vectorized query on the columnar element
+%             table of a structure (see columns). No gds_element
+%             objects are accessed when the table exists.
+%
+% gstruc :   a gds_structure object
+% etype :    a string or a cell array of strings with element types
+%            ('boundary', 'path', 'box', 'node', 'text', 'sref',
+%            'aref'). All types are selected when etype is empty.
+% lay :      (Optional) vector with layers. All layers are selected
+%            when lay is empty or omitted.
+% dtype :    (Optional) vector with data types. All data types are
+%            selected when dtype is empty or omitted.
+% idx :      indices of the selected elements in the structure
+% P :        (Optional) cell array with the polygons (or positions)
+%            of the selected elements, taken from the vertex slab
+%            of the table.
+%
+% Example:
+%          idx = selectel(gs, 'boundary', 31);  % boundaries on layer 31
+%          [idx, P] = selectel(gs, {'boundary','box'}, [31,32]);
+%
+% NOTE:
+%   Layers and data types select only boundary, path, box, node,
+%   and text elements.
+
+% Initial version, October 2026
+
+    if nargin < 4, dtype = []; end
+    if nargin < 3, lay = []; end
+    if nargin < 2, etype = []; end
+
+    C = columns(gstruc);
+
+    % element types
+    if isempty(etype)
+        sel = true(numel(C.kind),1);
+    else
+        if ischar(etype)
+            etype = {etype};
+        end
+        [tf, kinds] = ismember(etype, {'boundary','path','box','node','text','sref','aref'});
+        if ~all(kinds)
+            error('gds_structure.selectel :  unknown element type.');
+        end
+        sel = ismember(double(C.kind), kinds);
+    end
+
+    % layers and data types
+    if ~isempty(lay)
+        sel = sel & C.kind <= 5 & ismember(double(C.layer), lay);
+    end
+    if ~isempty(dtype)
+        sel = sel & C.kind <= 5 & ismember(double(C.dtype), dtype);
+    end
+    idx = find(sel)';
+
+    % polygons of the selected elements
+    if nargout > 1
+        P = cell(1, sum(C.poff(idx+1) - C.poff(idx)));
+        m = 0;
+        for k = idx
+            for p = C.poff(k)+1:C.poff(k+1)
+                m = m + 1;
+                P{m} = C.xy(C.voff(p)+1:C.voff(p+1),:);
+            end
+        end
+    end
+
+end
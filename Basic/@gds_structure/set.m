@@ -19,6 +19,13 @@ function gs = set(gstruc, varargin)
             error('gds_structure.set :  property must be a string.');
         end
         gs.(prop) = val;
+        if strcmp(prop, 'el')
+            gs.info = [];
+            gs.cols = [];
+        end
+        if ~any(strcmp(prop, {'src','ebox','rtree','info','cols'}))
+            gs.src = [];  % structure was changed
+        end
         varargin(1:2) = [];
         
     end
@@ -0,0 +1,36 @@
+function [gstruc] = spindex(gstruc)
+%function [gstruc] = spindex(gstruc)
+%
+% spindex :  builds a spatial index (a packed R-tree) of the
+%            element bounding boxes in a structure. The index
+%            is used by findel for window and point queries.
+%
+% gstruc :   a gds_structure object
+%
+% Example:
+%          gs = spindex(gs);
+%          els = findel(gs, [0,0,100,100]);
+%
+% NOTES:
+% - The element bounding boxes are computed when structures are
+%   read with read_gds_library. For other structures, they are
+%   computed with the bbox method of the elements.
+% - The index is discarded when elements are added to or removed
+%   from the structure. Each structure is indexed once; references
+%   to it do not create more indices.
+
+% Initial version, October 2026
+
+    % element bounding boxes that are not known yet
+    nel = numel(gstruc.el);
+    if size(gstruc.ebox,1) ~= nel
+        gstruc.ebox = NaN(nel,4);
+    end
+    for k = find(isnan(gstruc.ebox(:,1)))'
+        gstruc.ebox(k,:) = bbox(gstruc.el{k});
+    end
+
+    % bulk load the R-tree
+    gstruc.rtree = rtreemex(gstruc.ebox);
+
+end
@@ -20,10 +20,16 @@ function gstruc = subsasgn(gstruc, ins, val)
        else
           gstruc.el{idx} = val;
        end
+       gstruc.ebox = [];
+       gstruc.rtree = [];
+       gstruc.info = [];
+       gstruc.cols = [];
+       gstruc.src = [];
 
     case '.'
        if strcmp(ins.subs, 'sname') || strcmp(ins.subs, 'cdate') || strcmp(ins.subs, 'mdate')
           gstruc.(ins.subs) = val;
+          gstruc.src = [];
        else
           error(sprintf('invalid GDS structure property >> %s <<', ins.subs));
        end
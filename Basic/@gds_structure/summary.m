@@ -0,0 +1,34 @@
+function [S, gstruc] = summary(gstruc)
+%function [S, gstruc] = summary(gstruc)
+%
+% summary :  returns a summary of the elements in a structure.
+%            The summary is computed once and cached in the
+%            structure object; it is updated when elements are
+%            added with add_element or add_ref, or removed with
+%            refremove. When the structure has a columnar element
+%            table (see columns), only the references and the
+%            elements without a known bounding box are accessed.
+%
+% gstruc :   a gds_structure object
+% S :        a structure with the fields
+%              S.bbox :  bounding box [llx,lly,urx,ury] of all
+%                        elements that are not references
+%              S.ref :   a structure array describing the reference
+%                        elements (fields sname, strans, xy, adim)
+%              S.lcnt :  sparse 65536 x 6 matrix; row L+1 contains
+%                        the number of boundary, path, box, node, and
+%                        text elements, and the number of vertices on
+%                        layer L.
+% gstruc :   (Optional) the structure with the cached summary
+%
+% Example:
+%          [S, gs] = summary(gs);  % repeated calls are O(1)
+
+% Initial version, October 2026
+
+    if isempty(gstruc.info)
+        gstruc.info = summarize_elements(gstruc.el, gstruc.ebox, gstruc.cols);
+    end
+    S = gstruc.info;
+
+end
@@ -0,0 +1,35 @@
+function [S] = write_data(gstruc, copy)
+%function [S] = write_data(gstruc, copy)
+%
+% write_data :  returns the name and the element data of a
+%               structure in the form expected by
+%               gds_write_structures_mex.
+%
+% gstruc :  a gds_structure object
+% copy :    (Optional) when > 0, the structure is copied from the
+%           file it was read from instead of being encoded. The
+%           structure must be unmodified (see write_gds_library).
+%           Default is 0.
+% S :       a structure with the fields
+%             S.sname : structure name
+%             S.el :    cell array with element data structures
+%                       (see gds_element/write_data)
+%             S.src :   source file and span of a copied structure;
+%                       S.el is empty when the structure is copied
+
+% Initial version, October 2026
+
+    if nargin < 2, copy = 0; end
+
+    S.sname = gstruc.sname;
+    if copy && ~isempty(gstruc.src)
+        S.el = {};
+        S.src.file = gstruc.src.file;
+        S.src.span = gstruc.src.span;
+    elseif isempty(gstruc.el)
+        S.el = {};
+    else
+        S.el = write_data(gstruc.el{:});
+    end
+
+end
@@ -19,8 +19,11 @@
 % poly_text     - convert text to boundary element
 % poly_path     - convert path to boundary element
 % poly_bool     - Boolean set algebra with boundary elements
+% poly_boolbatch- Boolean set algebra with many pairs of elements
+% poly_offset   - offset (size) the polygons of boundary elements
 % poly_cw       - make polygons in boundary elements clockwise
 % poly_iscw     - check orientation of bounday element polygons
+% poly_stats    - area, orientation, perimeter, bbox of many polygons
 % add_poly      - add a polygon to a compound boundary element
 % and           - operator for Boolean set intersection 'and'
 % or            - operator for Boolean set union 'or'
@@ -41,7 +44,9 @@
 % display         - display method for the gds_structure class
 % find            - find elements with certain properties
 % findref         - find names of referenced structures
-% findel          - find elements with specified properties
+% findel          - find elements with specified properties or
+%                   in a window
+% spindex         - build a spatial index for window queries
 % get             - to retrieve structure properties
 % set             - set structure properties
 % numel           - number of elements in a structure
@@ -67,6 +72,7 @@
 % display          - display method for the gds_library class
 % treeview         - structure hierarchy view method
 % subtree          - copy structure with referenced structures
+% density          - layer density map on a grid of tiles
 % topstruct        - return name(s) of the top structure(s)
 % get              - method to retrieve class properties
 % set              - method to set class properties
@@ -75,6 +81,7 @@
 % srename          - rename structure and all references to it
 % snames           - list of structure names
 % poly_convert     - convert path and box elements to boundary elements
+% aref_compress    - replace arrays of identical elements with arefs
 % numst            - number of structures in the library
 % numel            - alias for 'numst'
 % length           - alias for 'numst'
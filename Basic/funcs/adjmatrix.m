@@ -20,21 +20,24 @@ function [A,N] = adjmatrix(S)
 
 % Initial version, Ulf Griesmann, December 2011
 % converted to sparse matrix, Ulf Griesmann, November 2012
+% built from the reference graph (refgraph), October 2026
 
-    % find all structure names
-    N = cellfun(@sname, S, 'UniformOutput',0);
+    % the adjacency matrix is built from the reference graph
+    G = refgraph(S);
+    N = G.names;
+    n = numel(N);
+    row = edge_rows(G.rowptr);
+    A = sparse(row, G.child, 1, n, n);
+    
+end
 
-    % compute the adjacency matrix
-    A = sparse(length(N),length(N));
 
-    for k = 1:length(N) % loop over structures
-  
-        % find names of all referenced structures in the k-th structure
-        R = find_ref(S{k});
-        
-        % look up indices of all reference names in name list N
-        A(k,:) = ismember(N,R);
-        
-    end
-    
+function [row] = edge_rows(rowptr)
+%
+% row (parent structure) index of each edge in a CSR graph
+%
+    nz = find(diff(rowptr));
+    start = zeros(rowptr(end),1);
+    start(rowptr(nz)+1) = 1;
+    row = nz(cumsum(start));
 end
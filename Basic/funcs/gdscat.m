@@ -11,6 +11,10 @@ function gdscat(inpfil, outfil, inptop, outtop, libnam, uunit, dbunit)
 %            NOTE: this function assumes that the user knows what 
 %            s/he is doing.
 %
+%            NOTE: gds_merge copies the structures without decoding
+%            them, renames duplicate structures, and rescales the
+%            coordinates when the units differ.
+%
 % inpfil :  structure array with input file names
 %               inpfil(k).name is the name of the k-th input file
 % outfil :  output file name
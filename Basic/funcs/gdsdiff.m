@@ -0,0 +1,161 @@
+function [D, S] = gdsdiff(A, B, varargin)
+%function [D, S] = gdsdiff(A, B, varargin)
+%
+% gdsdiff :  computes the geometric difference (exclusive or) of
+%            two layouts, e.g. two revisions of a layout file. The
+%            resolved structure hierarchies below the top structures
+%            are compared on each (layer, data type) pair.
+%
+%     D = gdsdiff('rev1.gds', 'rev2.gds')
+%     [D, S] = gdsdiff(glibA, glibB, 'top', 'CHIP', 'layers', [1,5])
+%
+% Input:
+% A, B :     names of GDSII (or OASIS) files, or gds_library objects
+% varargin : (Optional) property - value pairs
+%            'top' :      name of the top structure, or a cell array
+%                         {topA, topB} with the names of the top
+%                         structures in A and B. Default is the
+%                         first top level structure of each layout.
+%            'layers' :   vector with layer numbers; only shapes on
+%                         these layers (all data types) are compared.
+%                         Default is all layers.
+%            'nthreads' : number of threads for the exclusive or.
+%                         Default is the number of processors.
+%
+% Output:
+% D :        structure array with one entry for each (layer, data
+%            type) pair on which the layouts differ, with the fields
+%               layer : layer number
+%               dtype : data type
+%               xy    : cell array with the polygons of the difference
+%               hole  : logical array, true for polygons that are holes
+%               area  : area of the difference in user units^2
+%            D is empty when the layouts are geometrically identical.
+%            When no output argument is present, a table with the
+%            differences is printed.
+% S :        (Optional) structure with comparison statistics:
+%               ncell  : structures below the top structures of A and B
+%               nsame  : of these, structures that have an identical
+%                        copy below the other top structure
+%               npair  : pairs of structures that were compared
+%               nskip  : of these, identical pairs that were skipped
+%               nwin   : windows in which the layouts may differ
+%               nshape : shapes of A and B that were expanded
+%
+% NOTE:
+% The comparison is hierarchical. Structures are hashed from the
+% bottom up, and identical structures are skipped together with
+% everything below them, independent of their names. Only the shapes
+% that overlap the bounding boxes of differing elements are expanded,
+% and their exclusive or is computed in parallel tiles. Boundary,
+% box and path elements are compared with database unit resolution;
+% text and node elements are ignored. Files are read with lazy
+% element decoding (see read_gds_library).
+%
+% Example:
+%          D = gdsdiff('chip_v1.gds', 'chip_v2.gds', 'layers', 1);
+%          for k = 1:numel(D)
+%              gel = gds_element('boundary', 'xy',D(k).xy, 'layer',D(k).layer);
+%          end
+%
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 2
+        error('gdsdiff :  expecting at least 2 arguments.');
+    end
+
+    % options
+    top = {[], []};
+    layers = [];
+    nthreads = [];
+    k = 1;
+    while k < numel(varargin)
+        switch varargin{k}
+          case 'top'
+            top = varargin{k+1};
+            if ~iscell(top)
+                top = {top, top};
+            end
+          case 'layers'
+            layers = varargin{k+1};
+          case 'nthreads'
+            nthreads = varargin{k+1};
+          otherwise
+            error('gdsdiff :  unknown option %s.', varargin{k});
+        end
+        k = k + 2;
+    end
+
+    % read the layouts
+    if ischar(A), A = read_gds_library(A, 0, 0, [], 1); end
+    if ischar(B), B = read_gds_library(B, 0, 0, [], 1); end
+    if ~isa(A, 'gds_library') || ~isa(B, 'gds_library')
+        error('gdsdiff :  arguments must be file names or gds_library objects.');
+    end
+
+    % units
+    if abs(get(A,'uunit') - get(B,'uunit')) > 1e-9 * get(A,'uunit')
+        error('gdsdiff :  the layouts must have the same user unit.');
+    end
+    ud = get(A,'uunit') / min(get(A,'dbunit'), get(B,'dbunit'));
+
+    % element data of the structures below the top structures
+    [elA, namA, topA] = tree_data(A, top{1});
+    [elB, namB, topB] = tree_data(B, top{2});
+
+    % compare
+    [D, S] = layout_diffmex(elA, namA, topA, elB, namB, topB, ...
+                            double(layers(:))', ud, nthreads);
+
+    % print a table of the differences
+    if ~nargout
+        fprintf('\n   %d of %d structures in A and %d of %d in B are identical\n', ...
+                S.nsame(1), S.ncell(1), S.nsame(2), S.ncell(2));
+        fprintf('   %d windows, %d + %d shapes compared\n\n', ...
+                S.nwin, S.nshape(1), S.nshape(2));
+        if isempty(D)
+            fprintf('   The layouts are identical.\n\n');
+        else
+            fprintf('   Layer  Dtype  Polygons        Area\n');
+            for k = 1:numel(D)
+                fprintf('   %5d  %5d  %8d  %10.4g\n', D(k).layer, D(k).dtype, ...
+                        numel(D(k).xy), D(k).area);
+            end
+            fprintf('\n');
+        end
+        clear D
+    end
+
+end
+
+
+%-----------------------------------------------------------------
+
+function [el_data, names, top] = tree_data(glib, sname)
+%
+% element data of the structures below a top structure; each
+% structure is converted only once
+%
+    if isempty(sname)
+        ts = topstruct(glib);
+        if iscell(ts)
+            sname = ts{1};
+        else
+            sname = ts;
+        end
+    end
+
+    cas = subtree(glib, sname);
+    names = cellfun(@(s) get(s, 'sname'), cas, 'UniformOutput', false);
+    top = find(strcmp(names, sname), 1);
+    if isempty(top)
+        error('gdsdiff :  structure %s not found.', sname);
+    end
+    el_data = cell(size(cas));
+    for k = 1:numel(cas)
+        el_data{k} = cellfun(@get, get(cas{k}), 'UniformOutput', false);
+    end
+
+end
@@ -0,0 +1,110 @@
+function [bo] = poly_boolbatch(ba, bb, op, varargin)
+%function [bo] = poly_boolbatch(ba, bb, op, varargin)
+%
+% poly_boolbatch - boolean set algebra on many pairs of
+%                  boundary elements with a single call to
+%                  the Clipper library.
+%
+%             bo = poly_boolbatch(ba, bb, op)
+%
+%             This function returns the same results as calling
+%             poly_bool(ba{k}, bb{k}, op) for all k, but is much
+%             faster when many operations are needed, e.g. for the
+%             tiles of a layer or the polygons of many nets.
+%             User and database units must be defined (see poly_bool).
+%
+% ba :    cell array with input boundary elements (may be compound
+%         elements).
+% bb :    cell array with 2nd input boundary elements, one for each
+%         element in ba, or a single boundary element that is used
+%         with all elements in ba.
+% op :    operation applied to the inputs: 'and', 'or', 'xor', or
+%         'notb' (see poly_bool).
+% varargin :  property - value pairs that modify the properties of
+%             the output boundary elements.
+% bo :    cell array with output boundary elements. bo{k} is on the
+%         same layer as ba{k} and has the same data type. When an
+%         operation has no result, bo{k} is empty.
+%
+% Example:
+%          tiles = poly_boolbatch(tiles, metal, 'and');
+%
+%          returns the intersection of each tile in the cell array
+%          'tiles' with the boundary element 'metal'.
+%
+% This function is based on the Clipper library by
+% Angus Johnson (www.angusj.com).
+
+% Initial version, October 2026
+
+    % global variables
+    global gdsii_uunit;
+
+    % check arguments
+    if nargin < 3
+        error('poly_boolbatch :  expecting at least 3 input arguments');
+    end
+    if ~iscell(ba)
+        ba = {ba};
+    end
+    if iscell(bb) && numel(bb) ~= numel(ba)
+        error('poly_boolbatch :  number of input elements must match.');
+    end
+    if isempty(ba)
+        bo = {};
+        return
+    end
+
+    % units must be defined
+    if isempty(gdsii_uunit)
+        warning('undefined GDSII units');
+        fprintf('\n  +--------- WARNING in poly_boolbatch ---------------+\n');
+        fprintf('  | Units are not defined; setting uunit/dbunit = 1000.|\n');
+        fprintf('  | Define units by creating the library object or     |\n');
+        fprintf('  | by first calling  gdsii_units.                     |\n');
+        fprintf('  +----------------------------------------------------+\n\n');
+        udf = 1000;
+    else
+        udf = gdsii_uunit;      % conversion factor to db units
+    end
+
+    % collect the operand groups
+    ga = cell(1, numel(ba));
+    for k = 1:numel(ba)
+        if ~is_etype(ba{k}, 'boundary')
+            error('poly_boolbatch :  input elements must be boundary elements');
+        end
+        ga{k} = xy(ba{k});
+    end
+    if iscell(bb)
+        gb = cell(1, numel(bb));
+        for k = 1:numel(bb)
+            if ~is_etype(bb{k}, 'boundary')
+                error('poly_boolbatch :  input elements must be boundary elements');
+            end
+            gb{k} = xy(bb{k});
+        end
+    else
+        if ~is_etype(bb, 'boundary')
+            error('poly_boolbatch :  input elements must be boundary elements');
+        end
+        gb = xy(bb);
+    end
+
+    % apply boolean set operation to all groups
+    [xyo, hf, ng] = poly_boolmex(ga, gb, op, udf);
+    if any(hf)
+        error('poly_boolbatch :  a polygon with a hole was created.');
+    end
+
+    % create boundary elements for the output polygons
+    bo = cell(1, numel(ba));
+    last = cumsum(ng);
+    first = last - ng + 1;
+    for k = 1:numel(ba)
+        if ng(k)
+            bo{k} = set(ba{k}, 'xy', xyo(first(k):last(k)), varargin{:});
+        end
+    end
+
+end
@@ -0,0 +1,107 @@
+function [S] = poly_stats(pa, nv, nthreads)
+%function [S] = poly_stats(pa, nv, nthreads)
+%
+% poly_stats :  computes area, orientation, perimeter, and bounding
+%               box of many polygons in a single pass. Large polygon
+%               sets are processed by several threads.
+%
+%     S = poly_stats(pa)
+%     S = poly_stats(xy, nv)
+%     S = poly_stats(gstruc, layers)
+%
+% pa :       cell array of polygons (n x 2 matrices)
+% xy :       V x 2 matrix with the vertices of all polygons, e.g. the
+%            vertices of a layer returned by gds_flatten_for_3d
+% nv :       vector with the number of vertices of each polygon in xy
+% gstruc :   a gds_structure object; the polygons of all boundary
+%            elements in the structure are used.
+% layers :   (Optional) vector with the layers of the boundary elements
+%            when gstruc is a structure. Default is all layers.
+% nthreads : (Optional) number of threads. Default is 0 (one thread per
+%            processor).
+%
+% S :  structure with the fields
+%        S.area  : N x 1 vector with signed polygon areas; the area
+%                  is positive for counter-clockwise polygons.
+%        S.perim : N x 1 vector with polygon perimeters
+%        S.bbox  : N x 4 matrix with polygon bounding boxes
+%        S.cw    : N x 1 logical vector; true for clockwise polygons
+%      When the input is a structure, S has the additional fields
+%        S.layer : N x 1 vector with the layer of each polygon
+%        S.el    : N x 1 vector with the index of the element in
+%                  the structure that contains the polygon
+%
+% Example:
+%          S = poly_stats(gstruc, 3);
+%          A = sum(abs(S.area));  % total area of layer 3
+%
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 1
+        error('poly_stats :  at least 1 argument required.');
+    end
+    if nargin < 2, nv = []; end
+    if nargin < 3, nthreads = []; end
+    if isempty(nthreads), nthreads = 0; end
+
+    if isa(pa, 'gds_structure')
+
+        [pa, lay, eli] = boundary_polygons(pa, nv);
+        [S.area, S.perim, S.bbox, S.cw] = gds_polystats_mex(pa, [], nthreads);
+        S.layer = lay;
+        S.el = eli;
+
+    elseif iscell(pa)
+
+        [S.area, S.perim, S.bbox, S.cw] = gds_polystats_mex(pa, [], nthreads);
+
+    else
+
+        if isempty(nv)
+            error('poly_stats :  vertex numbers nv are missing.');
+        end
+        [S.area, S.perim, S.bbox, S.cw] = gds_polystats_mex(pa, nv, nthreads);
+
+    end
+
+end
+
+
+function [pa, lay, eli] = boundary_polygons(gstruc, layers)
+%
+% collect the polygons of the boundary elements in a structure
+%
+    el = gstruc(:);
+    pc = cell(1, numel(el));
+    lc = cell(1, numel(el));
+    ec = cell(1, numel(el));
+
+    for k = 1:numel(el)
+        if ~is_etype(el{k}, 'boundary')
+            continue
+        end
+        L = layer(el{k});
+        if ~isempty(layers) && ~any(L == layers)
+            continue
+        end
+        p = xy(el{k});
+        if ~iscell(p)
+            p = {p};
+        end
+        pc{k} = p(:)';
+        lc{k} = repmat(L, numel(p), 1);
+        ec{k} = repmat(k, numel(p), 1);
+    end
+
+    pa = [pc{:}];
+    lay = vertcat(lc{:});
+    eli = vertcat(ec{:});
+    if isempty(lay)
+        pa = {};
+        lay = zeros(0,1);
+        eli = zeros(0,1);
+    end
+
+end
@@ -0,0 +1,45 @@
+function [G] = refgraph(cas)
+%function [G] = refgraph(cas)
+%
+% returns the reference graph of a structure tree. Structure
+% names are interned in a hash table and the references are
+% stored as a sparse graph in compressed row (CSR) format with
+% the number of placed instances for each edge. The graph also
+% contains the topological order of the structures and marks the
+% structures that are part of reference cycles. It is computed
+% in time linear in the number of structures and references.
+%
+% cas :  a cell array of gds_structure objects
+% G :    a structure with the fields
+%          G.names   : cell array with the structure names
+%          G.rowptr  : (N+1) x 1 vector; the children of structure k
+%                      are G.child(G.rowptr(k)+1:G.rowptr(k+1))
+%          G.child   : vector with child structure indices
+%          G.count   : vector with the number of child instances
+%                      (arefs count columns x rows instances)
+%          G.nparent : N x 1 vector with the number of parents
+%          G.order   : topological order; each structure follows
+%                      all structures it references. Structures in
+%                      or above reference cycles are not included.
+%          G.top     : indices of the top level structures
+%          G.cyclic  : N x 1 logical vector; true for structures
+%                      that are part of a reference cycle
+%          G.missing : names of referenced structures that are not
+%                      in cas
+%
+% Example:
+%          G = refgraph(get(glib));
+%          chi = G.child(G.rowptr(k)+1:G.rowptr(k+1)); % children of k
+
+% Initial version, October 2026
+
+    N = cellfun(@sname, cas, 'UniformOutput',0);
+    R = cell(size(cas));
+    C = cell(size(cas));
+    for k = 1:numel(cas)
+        [R{k}, C{k}] = find_ref(cas{k});
+    end
+
+    G = gds_refgraph_mex(N, R, C);
+
+end
@@ -10,11 +10,9 @@ function [ts] = topstruct(cas)
 
 % Initial version, Ulf Griesmann, December 2012
 
-    % calculate the adjacency matrix of the structure tree
-    [A,N] = adjmatrix(cas);
-
-    % find top level structure name(s)
-    tops = N(find(sum(A)==0));
+    % top level structures have no parents
+    G = refgraph(cas);
+    tops = G.names(G.top);
 
     % display or return the structure names
     if nargout
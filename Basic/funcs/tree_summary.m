@@ -0,0 +1,214 @@
+function [H, cas] = tree_summary(cas, H)
+%function [H, cas] = tree_summary(cas, H)
+%
+% Computes hierarchical summaries (bounding box and per-layer
+% element and vertex counts of the resolved structure hierarchy)
+% for all structures in a structure tree. The summaries are
+% computed bottom-up in topological order; the summary of each
+% structure is computed only once.
+%
+% Input:
+% cas :  a cell array of gds_structure objects
+% H :    (Optional) summaries returned by an earlier call. Only the
+%        summaries of structures marked as invalid are recomputed.
+%
+% Output:
+% H :    a structure with the fields
+%          H.names :  cell array with the structure names
+%          H.A :      sparse matrix; A(i,j) is the number of instances
+%                     of structure j that are placed in structure i.
+%          H.bbox :   N x 4 matrix with the bounding boxes of the
+%                     resolved structures.
+%          H.cnt :    cell array with a sparse 65536 x 6 matrix for
+%                     each structure containing the element and vertex
+%                     counts of the resolved structure (see
+%                     gds_structure/summary).
+%          H.valid :  logical vector; false for summaries that must
+%                     be recomputed.
+% cas :  (Optional) the structures with cached element summaries
+
+% Initial version, October 2026
+
+    N = numel(cas);
+
+    % start from scratch
+    if nargin < 2 || isempty(H) || numel(H.valid) ~= N
+        H.names = cellfun(@sname, cas, 'UniformOutput',0);
+        H.A = sparse(N,N);
+        H.bbox = repmat([Inf,Inf,-Inf,-Inf], N,1);
+        H.cnt = cell(N,1);
+        H.valid = false(N,1);
+    end
+    inv = find(~H.valid);
+    if isempty(inv)
+        return
+    end
+
+    % update the references of the invalid structures
+    S = cell(N,1);
+    L = cell(N,1);            % indices of referenced structures
+    ci = cell(numel(inv),1);  % child structure indices
+    cn = cell(numel(inv),1);  % number of instances
+    ri = cell(numel(inv),1);
+    for m = 1:numel(inv)
+        k = inv(m);
+        [S{k}, cas{k}] = summary(cas{k});
+        [tf, L{k}] = ismember({S{k}.ref.sname}, H.names);
+        ni = arrayfun(@num_instances, S{k}.ref);
+        ci{m} = L{k}(tf);
+        cn{m} = ni(tf);
+        ri{m} = repmat(k, 1, numel(ci{m}));
+    end
+    [i,j,v] = find(H.A);
+    keep = H.valid(i);
+    H.A = sparse([i(keep);[ri{:}]'], [j(keep);[ci{:}]'], [v(keep);[cn{:}]'], N,N);
+
+    % topological order of the invalid structures: a structure
+    % is processed after all invalid structures it references
+    pending = full(sum(H.A(inv,inv) ~= 0, 2));
+    queue = inv(pending == 0);
+    pending(pending == 0) = -1;
+    pos = zeros(N,1);
+    pos(inv) = 1:numel(inv);
+    nproc = 0;
+
+    while ~isempty(queue)
+
+        k = queue(end);
+        queue(end) = [];
+        nproc = nproc + 1;
+
+        % combine local summary and summaries of referenced structures
+        bb = S{k}.bbox;
+        cnt = S{k}.lcnt;
+        for r = find(L{k} > 0)
+            c = L{k}(r);
+            ref = S{k}.ref(r);
+            cnt = cnt + num_instances(ref) * H.cnt{c};
+            if all(isfinite(H.bbox(c,:)))
+                if isempty(ref.adim)  % sref
+                    b = bbox_strans(H.bbox(c,:), ref.strans);
+                    b = [min(ref.xy,[],1), max(ref.xy,[],1)] + b;
+                else                   % aref
+                    b = bbox_aref(H.bbox(c,:), ref.strans, ref.xy, ref.adim);
+                end
+                bb = [min(bb(1:2), b(1:2)), max(bb(3:4), b(3:4))];
+            end
+        end
+        H.bbox(k,:) = bb;
+        H.cnt{k} = cnt;
+        H.valid(k) = true;
+
+        % parents that are ready now
+        par = find(H.A(:,k));
+        par = par(pos(par) > 0);
+        par = par(pending(pos(par)) > 0);
+        pending(pos(par)) = pending(pos(par)) - 1;
+        par = par(pending(pos(par)) == 0);
+        pending(pos(par)) = -1;
+        queue = [queue; par];
+
+    end
+
+    % structures that were not processed are part of a cycle
+    if nproc < numel(inv)
+        error('tree_summary :  the structure hierarchy contains a cycle.');
+    end
+
+end
+
+
+function [n] = num_instances(ref)
+%
+% number of structure instances placed by a reference
+%
+    if isempty(ref.adim)
+        n = size(ref.xy,1);
+    else
+        n = ref.adim.row * ref.adim.col;
+    end
+end
+
+
+function [bbt] = bbox_strans(bb, strans)
+%
+% apply transformations defined in an strans record to a boundary box
+%
+
+    % make sure strans is not empty
+    if isempty(strans)
+        bbt = bb;
+        return
+    end
+
+    % matrix with all 4 box corners
+    box = [bb(1,1),bb(1,2); ...
+           bb(1,3),bb(1,2); ...
+           bb(1,3),bb(1,4); ...
+           bb(1,1),bb(1,4)];
+
+    box = apply_strans(box, strans);
+
+    % return to boundary box format
+    bbt = [min(box),max(box)];
+
+end
+
+
+function [bba] = bbox_aref(bbr, strans, xy, adim)
+%
+% calculates the bounding box of an aref
+%
+    % matrix with all 4 box corners of referenced box
+    box = [bbr(1,1),bbr(1,2); ...
+           bbr(1,3),bbr(1,2); ...
+           bbr(1,3),bbr(1,4); ...
+           bbr(1,1),bbr(1,4)];
+
+    % apply an strans to the box if one exists
+    if ~isempty(strans)
+        box = apply_strans(box, strans);
+    end
+
+    % calculate the boxes in the four corners of the array
+    xy1 = xy(1,:);
+    xy2 = xy1 + (adim.col-1) * (xy(2,:) - xy1) / adim.col;
+    xy3 = xy1 + (adim.row-1) * (xy(3,:) - xy1) / adim.row;
+    fourbox = zeros(16,2);
+    fourbox(1:4,:)   = bsxfun(@plus, box, xy1);
+    fourbox(5:8,:)   = bsxfun(@plus, box, xy2);
+    fourbox(9:12,:)  = bsxfun(@plus, box, xy3);
+    fourbox(13:16,:) = bsxfun(@plus, box, xy2 + xy3 - xy1);
+
+    % return bounding box
+    bba = [min(fourbox), max(fourbox)];
+
+end
+
+
+function [box] = apply_strans(box, strans)
+
+    % reflection comes after rotation
+    if isfield(strans,'reflect') && strans.reflect
+        box(:,2) = -box(:,2);
+    end
+
+    % first rotate
+    if isfield(strans,'angle') && ~isempty(strans.angle) && strans.angle~=0
+        box = poly_rotzd(box, strans.angle); % rotated box
+    end
+
+    % magnification
+    if isfield(strans,'mag') && ~isempty(strans.mag)
+        box = strans.mag * box;
+    end
+
+    if isfield(strans,'absmag') && strans.absmag
+        error('tree_summary: strans.absmag not suported.');
+    end
+
+    if isfield(strans,'absang') && strans.absang
+        error('tree_summary: strans.absang not suported.');
+    end
+
+end
@@ -0,0 +1,358 @@
+/*
+ * Detection of regular arrays of identical elements
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "arefcomp.h"
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * a row of equally spaced elements of one class
+ */
+typedef struct {
+   uint32_t cls;         /* class of the elements */
+   int32_t x, y;         /* position of the first element */
+   int32_t d;            /* pitch; 0 for a single element */
+   uint32_t n;           /* number of elements */
+   size_t first;         /* index of the first element in the items */
+} ac_run_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static uint32_t hash_key(const int32_t *key, size_t n);
+static int grow_table(ac_classes_t *cl);
+static int same_key(const ac_classes_t *cl, uint32_t k, const int32_t *key, size_t n);
+static int cmp_item(const void *a, const void *b);
+static int cmp_run(const void *a, const void *b);
+static int fits(int32_t x, uint32_t n, int32_t d);
+
+
+/*-----------------------------------------------------------------*/
+
+uint32_t
+ac_class(ac_classes_t *cl, const int32_t *key, size_t n)
+{
+   uint32_t h, k;
+   void *pn;
+
+   /* the table is at most half full */
+   if (2*(cl->n + 1) > cl->size) {
+      if ( grow_table(cl) )
+	 return UINT32_MAX;
+   }
+
+   /* look up the key */
+   h = hash_key(key, n) & (cl->size - 1);
+   while (cl->slot[h]) {
+      k = cl->slot[h] - 1;
+      if ( same_key(cl, k, key, n) )
+	 return k;
+      h = (h + 1) & (cl->size - 1);
+   }
+
+   /* new class */
+   if (cl->nkey + n > cl->akey) {
+      size_t a = cl->akey ? cl->akey : 1024;
+      while (a < cl->nkey + n)
+	 a *= 2;
+      pn = realloc(cl->key, a*sizeof(int32_t));
+      if (pn == NULL)
+	 return UINT32_MAX;
+      cl->key = pn;
+      cl->akey = a;
+   }
+   if (cl->n + 2 > cl->aoff) {
+      uint32_t a = cl->aoff ? 2*cl->aoff : 64;
+      pn = realloc(cl->off, a*sizeof(size_t));
+      if (pn == NULL)
+	 return UINT32_MAX;
+      cl->off = pn;
+      cl->aoff = a;
+   }
+
+   k = cl->n++;
+   cl->off[k] = cl->nkey;
+   memcpy(cl->key + cl->nkey, key, n*sizeof(int32_t));
+   cl->nkey += n;
+   cl->off[k+1] = cl->nkey;
+   cl->slot[h] = k + 1;
+
+   return k;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ac_class_free(ac_classes_t *cl)
+{
+   free(cl->slot);
+   free(cl->off);
+   free(cl->key);
+   memset(cl, 0, sizeof(ac_classes_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+ac_find_arrays(ac_item_t *it, size_t nit, unsigned int minrep,
+               ac_array_t **arr, size_t *narr)
+{
+   ac_run_t *run;
+   ac_array_t *pa;
+   size_t nrun, na, aa, k, s, e, j;
+   uint32_t n, m, i;
+   int64_t d;
+   void *pn;
+
+   *arr = NULL;
+   *narr = 0;
+   if (minrep < 2)
+      minrep = 2;
+
+   for (k=0; k<nit; k++)
+      it[k].array = -1;
+   if (nit < minrep)
+      return 0;
+
+   /* sort by class, row, and column */
+   qsort(it, nit, sizeof(ac_item_t), cmp_item);
+
+   /*
+    * divide the rows into runs of equally spaced elements. Elements
+    * at the same position are not combined.
+    */
+   run = malloc(nit*sizeof(ac_run_t));
+   if (run == NULL)
+      return -1;
+   nrun = 0;
+
+   for (s=0; s<nit; s=e) {
+      e = s + 1;
+      d = 0;
+      if (e < nit && it[e].cls == it[s].cls && it[e].y == it[s].y) {
+	 d = (int64_t)it[e].x - it[s].x;
+	 if (d > 0 && d <= INT32_MAX) {
+	    for (e++; e<nit && e-s<AC_MAXDIM; e++) {
+	       if (it[e].cls != it[s].cls || it[e].y != it[s].y ||
+		   (int64_t)it[e].x - it[e-1].x != d)
+		  break;
+	    }
+	 }
+	 else {
+	    d = 0;
+	 }
+      }
+      run[nrun].cls = it[s].cls;
+      run[nrun].x = it[s].x;
+      run[nrun].y = it[s].y;
+      run[nrun].d = (int32_t)d;
+      run[nrun].n = e - s;
+      run[nrun].first = s;
+      nrun++;
+   }
+
+   /*
+    * runs with the same first column, pitch, and length are stacked
+    * into arrays when the rows are equally spaced
+    */
+   qsort(run, nrun, sizeof(ac_run_t), cmp_run);
+
+   pa = NULL;
+   na = aa = 0;
+   for (s=0; s<nrun; s=e) {
+      e = s + 1;
+      d = 0;
+      if (e < nrun && run[e].cls == run[s].cls && run[e].x == run[s].x &&
+	  run[e].d == run[s].d && run[e].n == run[s].n) {
+	 d = (int64_t)run[e].y - run[s].y;
+	 if (d > 0 && d <= INT32_MAX) {
+	    for (e++; e<nrun && e-s<AC_MAXDIM; e++) {
+	       if (run[e].cls != run[s].cls || run[e].x != run[s].x ||
+		   run[e].d != run[s].d || run[e].n != run[s].n ||
+		   (int64_t)run[e].y - run[e-1].y != d)
+		  break;
+	    }
+	 }
+	 else {
+	    e = s + 1;
+	    d = 0;
+	 }
+      }
+
+      n = run[s].n;            /* columns */
+      m = e - s;               /* rows */
+      if ((uint64_t)n * m < minrep)
+	 continue;
+
+      if (pa == NULL || na == aa) {
+	 aa = aa ? 2*aa : 64;
+	 pn = realloc(pa, aa*sizeof(ac_array_t));
+	 if (pn == NULL) {
+	    free(pa);
+	    free(run);
+	    return -1;
+	 }
+	 pa = pn;
+      }
+
+      /* a single row or column repeats the other pitch */
+      pa[na].cls = run[s].cls;
+      pa[na].item = it[run[s].first].item;
+      pa[na].x = run[s].x;
+      pa[na].y = run[s].y;
+      pa[na].dc = n > 1 ? run[s].d : (int32_t)d;
+      pa[na].dr = m > 1 ? (int32_t)d : run[s].d;
+      pa[na].ncol = (uint16_t)n;
+      pa[na].nrow = (uint16_t)m;
+
+      /* the corner points must be representable */
+      if ( !fits(pa[na].x, n, pa[na].dc) || !fits(pa[na].y, m, pa[na].dr) )
+	 continue;
+
+      for (j=s; j<e; j++) {
+	 for (i=0; i<run[j].n; i++)
+	    it[run[j].first + i].array = (int32_t)na;
+      }
+      na++;
+   }
+
+   free(run);
+   *arr = pa;
+   *narr = na;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static uint32_t
+hash_key(const int32_t *key, size_t n)
+{
+   uint32_t h = 2166136261U;
+   uint32_t v;
+   size_t k;
+   int b;
+
+   for (k=0; k<n; k++) {
+      v = (uint32_t)key[k];
+      for (b=0; b<4; b++) {
+	 h ^= v & 0xff;
+	 h *= 16777619U;
+	 v >>= 8;
+      }
+   }
+
+   return h;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * doubles the size of the hash table
+ */
+static int
+grow_table(ac_classes_t *cl)
+{
+   uint32_t *slot;
+   uint32_t size, k, h;
+
+   size = cl->size ? 2*cl->size : 1024;
+   slot = calloc(size, sizeof(uint32_t));
+   if (slot == NULL)
+      return 1;
+
+   for (k=0; k<cl->n; k++) {
+      h = hash_key(cl->key + cl->off[k], cl->off[k+1] - cl->off[k]) & (size - 1);
+      while (slot[h])
+	 h = (h + 1) & (size - 1);
+      slot[h] = k + 1;
+   }
+
+   free(cl->slot);
+   cl->slot = slot;
+   cl->size = size;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+same_key(const ac_classes_t *cl, uint32_t k, const int32_t *key, size_t n)
+{
+   return cl->off[k+1] - cl->off[k] == n &&
+          !memcmp(cl->key + cl->off[k], key, n*sizeof(int32_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * order of elements: class, y, x
+ */
+static int
+cmp_item(const void *a, const void *b)
+{
+   const ac_item_t *pa = a;
+   const ac_item_t *pb = b;
+
+   if (pa->cls != pb->cls)
+      return pa->cls < pb->cls ? -1 : 1;
+   if (pa->y != pb->y)
+      return pa->y < pb->y ? -1 : 1;
+   if (pa->x != pb->x)
+      return pa->x < pb->x ? -1 : 1;
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * order of runs: class, first column, pitch, length, y
+ */
+static int
+cmp_run(const void *a, const void *b)
+{
+   const ac_run_t *pa = a;
+   const ac_run_t *pb = b;
+
+   if (pa->cls != pb->cls)
+      return pa->cls < pb->cls ? -1 : 1;
+   if (pa->x != pb->x)
+      return pa->x < pb->x ? -1 : 1;
+   if (pa->d != pb->d)
+      return pa->d < pb->d ? -1 : 1;
+   if (pa->n != pb->n)
+      return pa->n < pb->n ? -1 : 1;
+   if (pa->y != pb->y)
+      return pa->y < pb->y ? -1 : 1;
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * checks if x + n*d is a 32-bit integer
+ */
+static int
+fits(int32_t x, uint32_t n, int32_t d)
+{
+   int64_t c = (int64_t)x + (int64_t)n * d;
+
+   return c >= INT32_MIN && c <= INT32_MAX;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,108 @@
+/*
+ * Detection of regular arrays of identical elements.
+ *
+ * Layouts often contain many identical boundaries, or references
+ * to the same structure, on regular grids. Such elements can be
+ * replaced by one array reference (AREF) to a structure that
+ * contains the element once. The functions in this file find the
+ * candidates in two steps:
+ *
+ *  - elements are sorted into classes of identical elements. The
+ *    caller describes each element with an integer key, e.g. the
+ *    layer, data type and vertices of a boundary relative to its
+ *    first vertex; elements with equal keys belong to one class.
+ *
+ *  - for each class, the positions of the elements are searched
+ *    for regular arrays: rows of equally spaced elements with the
+ *    same first column, column pitch, and length are combined into
+ *    arrays with a constant row pitch.
+ *
+ * Coordinates are integers in database units. The functions do not
+ * use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _AREFCOMP_H
+#define _AREFCOMP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* maximum number of rows and columns of an AREF */
+#define AC_MAXDIM  32767
+
+
+/*
+ * table of element classes; set to zero before the first call
+ * of ac_class.
+ */
+typedef struct {
+   uint32_t size;        /* size of the hash table (power of 2) */
+   uint32_t n;           /* number of classes */
+   uint32_t *slot;       /* hash table; class number + 1, 0 when unused */
+   size_t *off;          /* keys of class k are key[off[k]] ... key[off[k+1]-1] */
+   uint32_t aoff;        /* allocated length of off */
+   int32_t *key;         /* keys of all classes */
+   size_t nkey, akey;    /* used and allocated length of key */
+} ac_classes_t;
+
+
+/*
+ * an element that can be part of an array
+ */
+typedef struct {
+   uint32_t cls;         /* class of the element */
+   int32_t x, y;         /* position */
+   uint32_t item;        /* index of the element (set by the caller) */
+   int32_t array;        /* array of the element or -1 (output) */
+} ac_item_t;
+
+
+/*
+ * a regular array of elements of one class. The element at the
+ * origin is in the first row and first column.
+ */
+typedef struct {
+   uint32_t cls;         /* class of the elements */
+   uint32_t item;        /* element at the origin */
+   int32_t x, y;         /* origin */
+   int32_t dc, dr;       /* column pitch (x) and row pitch (y) */
+   uint16_t ncol, nrow;  /* number of columns and rows */
+} ac_array_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * returns the class of an element described by a key with n
+ * integers. A new class is created when no class has this key.
+ * Returns UINT32_MAX when memory cannot be allocated.
+ */
+uint32_t ac_class(ac_classes_t *cl, const int32_t *key, size_t n);
+
+/*
+ * release the class table
+ */
+void ac_class_free(ac_classes_t *cl);
+
+/*
+ * find the regular arrays with at least minrep elements among
+ * nit elements; minrep must be >= 2. The items are sorted by
+ * class and position, and each item is assigned to an array or
+ * to no array (-1). The arrays are returned in a new array that
+ * must be released with free. Returns 0 on success or -1 when
+ * memory cannot be allocated.
+ *
+ * it :      elements
+ * nit :     number of elements
+ * minrep :  minimum number of elements in an array
+ * arr :     returns a pointer to the arrays
+ * narr :    returns the number of arrays
+ */
+int ac_find_arrays(ac_item_t *it, size_t nit, unsigned int minrep,
+                   ac_array_t **arr, size_t *narr);
+
+#endif /* _AREFCOMP_H */
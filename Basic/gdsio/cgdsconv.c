@@ -0,0 +1,387 @@
+/*
+ * Conversion of compound GDSII libraries to standard GDSII
+ * Copyright (c) 2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gdstypes.h"
+#include "cgdsconv.h"
+
+#define VERTEX_BYTES  (2*sizeof(int32_t))
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * a growing byte buffer
+ */
+typedef struct {
+   uint8_t *p;       /* data */
+   size_t n;         /* number of bytes used */
+   size_t a;         /* number of bytes allocated */
+} cg_buffer_t;
+
+
+/*
+ * the records of one element. The element header records and
+ * the XY records are stored in order in el, all records after
+ * the first XY record except XY and ENDEL are stored in tl.
+ */
+typedef struct {
+   cg_buffer_t el;   /* header and XY records */
+   cg_buffer_t tl;   /* trailing records, e.g. properties */
+   size_t head;      /* length of the header records */
+   size_t *xy;       /* positions of the XY records in el */
+   size_t nxy;       /* number of XY records */
+   size_t axy;       /* allocated length of xy */
+} cg_element_t;
+
+
+static const uint8_t endel[4] = {0x00, 0x04, 0x11, 0x00};
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static const char *read_element(FILE *fin, cg_element_t *ce);
+static const char *write_polygons(FILE *fob, cg_element_t *ce, uint64_t *nout);
+static const char *write_positions(FILE *fob, cg_element_t *ce, uint64_t *nout);
+static const char *write_parts(FILE *fob, cg_element_t *ce,
+                               const uint8_t *pxy, size_t nxy);
+static int is_continued(const cg_element_t *ce, size_t k);
+static int read_header(FILE *fin, uint8_t *hdr, uint16_t *rtype, uint16_t *rlen);
+static int read_data(FILE *fin, cg_buffer_t *b, const uint8_t *hdr, uint16_t rlen);
+static int reserve(cg_buffer_t *b, size_t n);
+static int is_element(uint16_t rtype);
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+cgds_convert(FILE *fin, FILE *fob, cgds_stats_t *st)
+{
+   cg_element_t ce;
+   cg_buffer_t rec;
+   cgds_stats_t lst;
+   const char *msg = NULL;
+   uint8_t hdr[4];
+   uint16_t rtype, rlen;
+   uint64_t nout;
+   int first = 1;
+
+   if (st == NULL)
+      st = &lst;
+   memset(st, 0, sizeof(cgds_stats_t));
+   memset(&ce, 0, sizeof(cg_element_t));
+   memset(&rec, 0, sizeof(cg_buffer_t));
+
+   while (1) {
+
+      if ( read_header(fin, hdr, &rtype, &rlen) ) {
+	 msg = first ? "not a GDSII library file." : "library ends without ENDLIB record.";
+	 break;
+      }
+      if (first && rtype != HEADER) {
+	 msg = "not a GDSII library file.";
+	 break;
+      }
+      first = 0;
+
+      if (is_element(rtype))
+	 st->nel++;
+
+      /* elements that can be compound elements */
+      if (rtype == BOUNDARY || rtype == PATH || rtype == SREF) {
+
+	 ce.el.n = 0;
+	 if ( read_data(fin, &ce.el, hdr, rlen) ) {
+	    msg = "failed to read element.";
+	    break;
+	 }
+	 if ( (msg = read_element(fin, &ce)) )
+	    break;
+
+	 nout = 1;
+	 if (rtype == SREF)
+	    msg = write_positions(fob, &ce, &nout);
+	 else
+	    msg = write_polygons(fob, &ce, &nout);
+	 if (msg)
+	    break;
+	 if (nout > 1) {
+	    st->ncomp++;
+	    st->nsplit += nout;
+	 }
+	 continue;
+      }
+
+      /* all other records are copied */
+      rec.n = 0;
+      if ( read_data(fin, &rec, hdr, rlen) ) {
+	 msg = "failed to read record.";
+	 break;
+      }
+      if ( fwrite(rec.p, 1, rec.n, fob) != rec.n ) {
+	 msg = "failed to write record.";
+	 break;
+      }
+
+      if (rtype == ENDLIB)
+	 break;
+   }
+
+   free(ce.el.p);
+   free(ce.tl.p);
+   free(ce.xy);
+   free(rec.p);
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads the records of an element up to the ENDEL record, which
+ * is not stored
+ */
+static const char *
+read_element(FILE *fin, cg_element_t *ce)
+{
+   uint8_t hdr[4];
+   uint16_t rtype, rlen;
+   cg_buffer_t *b;
+   void *pn;
+
+   ce->tl.n = 0;
+   ce->nxy = 0;
+   ce->head = 0;
+
+   while (1) {
+
+      if ( read_header(fin, hdr, &rtype, &rlen) )
+	 return "failed to read element.";
+      if (rtype == ENDEL)
+	 break;
+      if (rtype == ENDSTR || rtype == ENDLIB || is_element(rtype))
+	 return "element without ENDEL record.";
+
+      if (rtype == XY) {
+	 if (ce->nxy == ce->axy) {
+	    ce->axy = ce->axy ? 2*ce->axy : 16;
+	    pn = realloc(ce->xy, ce->axy * sizeof(size_t));
+	    if (pn == NULL)
+	       return "failed to allocate memory.";
+	    ce->xy = pn;
+	 }
+	 if (ce->nxy == 0)
+	    ce->head = ce->el.n;
+	 ce->xy[ce->nxy++] = ce->el.n;
+	 b = &ce->el;
+      }
+      else
+	 b = ce->nxy ? &ce->tl : &ce->el;
+
+      if ( read_data(fin, b, hdr, rlen) )
+	 return "failed to read element.";
+   }
+
+   if (ce->nxy == 0)
+      return "element has no XY record.";
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a boundary or path with several polygons is written as one
+ * element per polygon. A full XY record that is continued by the
+ * next record (see put_xy in elwrite.c) is part of the same polygon.
+ */
+static const char *
+write_polygons(FILE *fob, cg_element_t *ce, uint64_t *nout)
+{
+   const char *msg;
+   size_t k, b, e;
+
+   /* count the polygons */
+   *nout = 1;
+   for (k=1; k<ce->nxy; k++) {
+      if ( !is_continued(ce, k) )
+	 *nout += 1;
+   }
+
+   if (*nout == 1)
+      return write_parts(fob, ce, ce->el.p + ce->head, ce->el.n - ce->head);
+
+   /* one element for each polygon */
+   for (b=0; b<ce->nxy; b=e) {
+      for (e=b+1; e<ce->nxy && is_continued(ce, e); e++)
+	 ;
+      k = e < ce->nxy ? ce->xy[e] : ce->el.n;
+      if ( (msg = write_parts(fob, ce, ce->el.p + ce->xy[b], k - ce->xy[b])) )
+	 return msg;
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * an sref with several positions is written as one sref per
+ * position. The positions of all XY records are used.
+ */
+static const char *
+write_positions(FILE *fob, cg_element_t *ce, uint64_t *nout)
+{
+   const char *msg;
+   uint8_t xy[4 + VERTEX_BYTES];
+   size_t k, e, pos, rlen;
+
+   *nout = (ce->el.n - ce->head - 4*ce->nxy) / VERTEX_BYTES;
+   if (*nout <= 1)
+      return write_parts(fob, ce, ce->el.p + ce->head, ce->el.n - ce->head);
+
+   xy[0] = 0;
+   xy[1] = 4 + VERTEX_BYTES;
+   xy[2] = XY >> 8;
+   xy[3] = XY & 0xff;
+
+   for (k=0; k<ce->nxy; k++) {
+      e = k+1 < ce->nxy ? ce->xy[k+1] : ce->el.n;
+      rlen = e - ce->xy[k];
+      for (pos=4; pos+VERTEX_BYTES<=rlen; pos+=VERTEX_BYTES) {
+	 memcpy(xy + 4, ce->el.p + ce->xy[k] + pos, VERTEX_BYTES);
+	 if ( (msg = write_parts(fob, ce, xy, sizeof(xy))) )
+	    return msg;
+      }
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes an element with the header records, the XY records
+ * pxy, the trailing records and the ENDEL record
+ */
+static const char *
+write_parts(FILE *fob, cg_element_t *ce, const uint8_t *pxy, size_t nxy)
+{
+   if ( fwrite(ce->el.p, 1, ce->head, fob) != ce->head ||
+        fwrite(pxy, 1, nxy, fob) != nxy ||
+        fwrite(ce->tl.p, 1, ce->tl.n, fob) != ce->tl.n ||
+        fwrite(endel, 1, sizeof(endel), fob) != sizeof(endel) )
+      return "failed to write element.";
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * checks if XY record k continues the polygon of record k-1: the
+ * previous record is full and ends with the first vertex of record k
+ */
+static int
+is_continued(const cg_element_t *ce, size_t k)
+{
+   const uint8_t *p = ce->el.p + ce->xy[k];
+
+   return (ce->xy[k] - ce->xy[k-1] - 4) / VERTEX_BYTES == MAX_XY_VERTICES &&
+          !memcmp(p + 4, p - VERTEX_BYTES, VERTEX_BYTES);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads a record header. Returns 1 at the end of the file or when
+ * the record length is invalid.
+ */
+static int
+read_header(FILE *fin, uint8_t *hdr, uint16_t *rtype, uint16_t *rlen)
+{
+   if ( fread(hdr, 1, 4, fin) != 4 )
+      return 1;
+
+   *rlen  = ((uint16_t)hdr[0] << 8) | hdr[1];
+   *rtype = ((uint16_t)hdr[2] << 8) | hdr[3];
+
+   return *rlen < 4 || *rlen % 2;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * appends a record with header hdr to a buffer
+ */
+static int
+read_data(FILE *fin, cg_buffer_t *b, const uint8_t *hdr, uint16_t rlen)
+{
+   if ( reserve(b, rlen) )
+      return 1;
+
+   memcpy(b->p + b->n, hdr, 4);
+   if ( fread(b->p + b->n + 4, 1, rlen - 4, fin) != (size_t)(rlen - 4) )
+      return 1;
+   b->n += rlen;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+reserve(cg_buffer_t *b, size_t n)
+{
+   void *pn;
+   size_t a;
+
+   if (b->n + n <= b->a)
+      return 0;
+
+   a = b->a ? b->a : 4096;
+   while (a < b->n + n)
+      a *= 2;
+   pn = realloc(b->p, a);
+   if (pn == NULL)
+      return 1;
+   b->p = pn;
+   b->a = a;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+is_element(uint16_t rtype)
+{
+   switch (rtype) {
+      case BOUNDARY:
+      case PATH:
+      case SREF:
+      case AREF:
+      case TEXT:
+      case NODE:
+      case BOX:
+	 return 1;
+      default:
+	 return 0;
+   }
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,49 @@
+/*
+ * Conversion of compound GDSII libraries (.cgds) to standard GDSII.
+ *
+ * Libraries written in compound format contain boundaries and paths
+ * with several XY records, one for each polygon or path, and
+ * srefs with several positions in one XY record. The conversion
+ * splits these elements into one element per polygon, path, or
+ * position; all other records are copied unchanged. The records
+ * are processed as a stream: only the records of one element are
+ * held in memory, and the memory needed does not depend on the
+ * size of the library. The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _CGDSCONV_H
+#define _CGDSCONV_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*
+ * conversion statistics
+ */
+typedef struct {
+   uint64_t nel;         /* number of elements read */
+   uint64_t ncomp;       /* number of compound elements */
+   uint64_t nsplit;      /* number of elements written for them */
+} cgds_stats_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * copy a library from an input stream to an output stream and
+ * split all compound elements. The streams must be positioned at
+ * the beginning of the library; copying ends with the ENDLIB
+ * record. Returns NULL on success or an error message.
+ *
+ * fin :  input stream with a compound library
+ * fob :  output stream
+ * st :   conversion statistics; can be NULL
+ */
+const char *cgds_convert(FILE *fin, FILE *fob, cgds_stats_t *st);
+
+#endif /* _CGDSCONV_H */
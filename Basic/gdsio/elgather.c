@@ -0,0 +1,288 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Collects element data for the element writer (see elgather.h).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "mexfuncs.h"
+#include "elgather.h"
+#include "gdsstats.h"
+
+#define VLEN         128     /* maximum length of property values + 1 */
+#define TXTLEN       512     /* maximum length of text strings + 1 */
+#define MSGLEN       256
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static void gather_xy(ew_list_t *ls, ew_element_t *pe, mxArray *data,
+                      const char *fname, const char *etype);
+static void gather_properties(ew_list_t *ls, ew_element_t *pe, mxArray *data);
+static size_t gather_string(ew_list_t *ls, mxArray *pstr, size_t maxlen);
+static void check_strans(const element_t *pel, const char *fname, const char *etype);
+static void element_error(const char *fname, const char *etype, const char *msg);
+static void *grow(void *p, size_t *alloc, size_t n, size_t size);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+gather_element(ew_list_t *ls, mxArray *data, const char *fname)
+{
+   mxArray *internal, *field;
+   ew_element_t *pe;
+   const ew_xy_t *pxy;
+
+   /* a new element */
+   if (ls->nel == ls->ael)
+      ls->el = grow(ls->el, &ls->ael, ls->nel+1, sizeof(ew_element_t));
+   pe = &ls->el[ls->nel];
+   memset(pe, 0, sizeof(ew_element_t));
+
+   /* internal structure */
+   if ( !get_field_ptr(data, "internal", &internal) )
+      element_error(fname, NULL, "missing internal data field.");
+   memcpy(&pe->el, mxGetData(internal), sizeof(element_t));
+
+   switch (pe->el.kind) {
+
+      case GDS_BOUNDARY:
+	 gather_xy(ls, pe, data, fname, "boundary");
+	 break;
+
+      case GDS_PATH:
+	 gather_xy(ls, pe, data, fname, "path");
+	 break;
+
+      case GDS_SREF:
+      case GDS_AREF:
+	 if ( !get_field_ptr(data, "sname", &field) || !mxIsChar(field) )
+	    element_error(fname, pe->el.kind == GDS_SREF ? "sref" : "aref",
+			  "missing name of referenced structure.");
+	 pe->str = gather_string(ls, field, 0);
+	 check_strans(&pe->el, fname, pe->el.kind == GDS_SREF ? "sref" : "aref");
+	 if (pe->el.kind == GDS_SREF) {
+	    gather_xy(ls, pe, data, fname, "sref");
+	    break;
+	 }
+	 if ( !pe->el.nrow )
+	    element_error(fname, "aref", "number of rows is 0; must be > 0.");
+	 if ( !pe->el.ncol )
+	    element_error(fname, "aref", "number of columns is 0; must be > 0.");
+	 gather_xy(ls, pe, data, fname, "aref");
+	 pxy = &ls->xy[pe->xy];
+	 if ( pxy->m != 3 || mxGetN(mxGetField(data, 0, "xy")) != 2 )
+	    element_error(fname, "aref", "xy must be 3x2 matrix.");
+	 break;
+
+      case GDS_TEXT:
+	 check_strans(&pe->el, fname, "text");
+	 gather_xy(ls, pe, data, fname, "text");
+	 ls->xy[pe->xy].m = 1;  /* only the first vertex is used */
+	 if ( !get_field_ptr(data, "text", &field) || !mxIsChar(field) )
+	    element_error(fname, "text", "missing text field.");
+	 pe->str = gather_string(ls, field, TXTLEN);
+	 break;
+
+      case GDS_NODE:
+	 gather_xy(ls, pe, data, fname, "node");
+	 break;
+
+      case GDS_BOX:
+	 gather_xy(ls, pe, data, fname, "box");
+	 pxy = &ls->xy[pe->xy];
+	 if (pxy->m < 4 || pxy->m > 5)
+	    element_error(fname, "box", "must supply 4 or 5 vertices.");
+	 break;
+
+      default:
+	 element_error(fname, NULL, "unknown element type.");
+   }
+
+   gather_properties(ls, pe, data);
+   ls->nel++;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ew_list_clear(ew_list_t *ls)
+{
+   ls->nel = 0;
+   ls->nxy = 0;
+   ls->nprop = 0;
+   ls->nstr = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ew_list_free(ew_list_t *ls)
+{
+   mxFree(ls->el);
+   mxFree(ls->xy);
+   mxFree(ls->prop);
+   mxFree(ls->str);
+   memset(ls, 0, sizeof(ew_list_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the vertices of boundaries and paths are stored in a cell array
+ * with one matrix per polygon or path, those of all other elements
+ * in one matrix.
+ */
+static void
+gather_xy(ew_list_t *ls, ew_element_t *pe, mxArray *data,
+          const char *fname, const char *etype)
+{
+   mxArray *pxy, *pa;
+   size_t k, n;
+
+   if ( !get_field_ptr(data, "xy", &pxy) )
+      element_error(fname, etype, "missing or empty xy field.");
+
+   n = mxIsCell(pxy) ? mxGetNumberOfElements(pxy) : 1;
+   if (ls->nxy + n > ls->axy)
+      ls->xy = grow(ls->xy, &ls->axy, ls->nxy + n, sizeof(ew_xy_t));
+   pe->xy = ls->nxy;
+   pe->nxy = n;
+
+   for (k=0; k<n; k++) {
+      pa = mxIsCell(pxy) ? mxGetCell(pxy, k) : pxy;
+      if (pa == NULL || !mxIsDouble(pa) || mxIsEmpty(pa))
+	 element_error(fname, etype, "missing or empty xy field.");
+      ls->xy[ls->nxy].xy = (const double *)mxGetData(pa);
+      ls->xy[ls->nxy].m = mxGetM(pa);
+      ls->nxy++;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gather_properties(ew_list_t *ls, ew_element_t *pe, mxArray *data)
+{
+   mxArray *prop, *pa;
+   ew_prop_t *pp;
+   size_t k, np;
+
+   if ( !get_field_ptr(data, "prop", &prop) )
+      return;
+
+   np = mxGetM(prop) * mxGetN(prop);
+   if (ls->nprop + np > ls->aprop)
+      ls->prop = grow(ls->prop, &ls->aprop, ls->nprop + np, sizeof(ew_prop_t));
+   pe->prop = ls->nprop;
+   pe->nprop = np;
+
+   for (k=0; k<np; k++) {
+      pp = &ls->prop[ls->nprop++];
+
+      pa = mxGetField(prop, k, "attr");
+      if (pa == NULL)
+	 mexErrMsgTxt("Element property has no field named \"attr\".");
+      if ( !mxIsNumeric(pa) )
+	 mexErrMsgTxt("Element property attribute must be a real number.");
+      pp->attr = (int16_t)((double *)mxGetData(pa))[0];
+
+      pa = mxGetField(prop, k, "name");
+      if (pa == NULL)
+	 mexErrMsgTxt("Element property has no field named \"name\".");
+      if ( !mxIsChar(pa) )
+	 mexErrMsgTxt("Element property name (value) must be a string.");
+      pp->value = gather_string(ls, pa, VLEN);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies a string into the string array of a list and returns its
+ * offset. Strings are truncated to maxlen-1 characters when
+ * maxlen > 0.
+ */
+static size_t
+gather_string(ew_list_t *ls, mxArray *pstr, size_t maxlen)
+{
+   size_t off, len;
+
+   len = mxGetNumberOfElements(pstr) + 1;
+   if (maxlen && len > maxlen)
+      len = maxlen;
+   if (ls->nstr + len > ls->astr)
+      ls->str = grow(ls->str, &ls->astr, ls->nstr + len, sizeof(char));
+
+   off = ls->nstr;
+   mxGetString(pstr, ls->str + off, len);
+   ls->nstr += strlen(ls->str + off) + 1;
+
+   return off;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * magnification and angle must be representable as 8-byte reals
+ */
+static void
+check_strans(const element_t *pel, const char *fname, const char *etype)
+{
+   if ( !(pel->has & HAS_STRANS) )
+      return;
+   if ( pel->has & HAS_MAG && pel->strans.mag != 1.0 && !real8_valid(pel->strans.mag) )
+      element_error(fname, etype, "magnification cannot be represented in excess-64 format.");
+   if ( pel->has & HAS_ANGLE && pel->strans.angle != 0.0 && !real8_valid(pel->strans.angle) )
+      element_error(fname, etype, "angle cannot be represented in excess-64 format.");
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+element_error(const char *fname, const char *etype, const char *msg)
+{
+   char buf[MSGLEN];
+
+   if (etype)
+      snprintf(buf, MSGLEN, "%s (%s) :  %s", fname, etype, msg);
+   else
+      snprintf(buf, MSGLEN, "%s :  %s", fname, msg);
+   mexErrMsgTxt(buf);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * grows an array to at least n entries
+ */
+static void *
+grow(void *p, size_t *alloc, size_t n, size_t size)
+{
+   size_t na;
+
+   na = *alloc ? 2 * *alloc : 64;
+   while (na < n)
+      na *= 2;
+   *alloc = na;
+   STATS_ALLOC(na*size);
+
+   return mxRealloc(p, na*size);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,46 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Collects the data of gds_element objects into element lists
+ * that can be encoded into GDSII records (see elwrite.h). The
+ * functions use the MATLAB API and must be called in the thread
+ * that called the mex function.
+ */
+
+#ifndef _ELGATHER_H
+#define _ELGATHER_H
+
+#include "mex.h"
+#include "elwrite.h"
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * checks the data structure of an element and appends the element
+ * to a list. The vertices are not copied. Errors are reported with
+ * mexErrMsgTxt; the messages start with fname.
+ *
+ * ls :     element list (initially set to zero)
+ * data :   element data structure with the fields internal, xy,
+ *          and, depending on the element type, prop, sname, text.
+ *          Elements read in lazy mode must have been decoded.
+ * fname :  name of the calling function
+ */
+void gather_element(ew_list_t *ls, mxArray *data, const char *fname);
+
+/*
+ * removes all elements from a list and keeps the memory
+ */
+void ew_list_clear(ew_list_t *ls);
+
+/*
+ * releases the memory of a list
+ */
+void ew_list_free(ew_list_t *ls);
+
+#endif /* _ELGATHER_H */
@@ -0,0 +1,888 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Functions that read GDSII elements from a library file and
+ * return them as MATLAB/Octave data structures. They are shared
+ * by gds_read_element and gds_read_library_mex.
+ *
+ * The decoding functions use only the C library and can be called
+ * from several threads at once, provided each thread uses its own
+ * element buffer.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <float.h>
+#include "gdsio.h"
+#include "mapio.h"
+#include "xyconv.h"
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "eldata.h"
+#include "mexfuncs.h"
+#include "elread.h"
+#include "gdsstats.h"
+
+#define CHUNK 64
+
+/* element kinds in which a record may occur */
+#define K(kind)   (1U << (kind))
+#define K_ALL     (K(GDS_BOUNDARY) | K(GDS_PATH) | K(GDS_BOX) | K(GDS_NODE) | \
+                   K(GDS_TEXT) | K(GDS_SREF) | K(GDS_AREF))
+#define K_SHAPES  (K(GDS_BOUNDARY) | K(GDS_PATH) | K(GDS_BOX) | K(GDS_NODE) | K(GDS_TEXT))
+#define K_STRANS  (K(GDS_TEXT) | K(GDS_SREF) | K(GDS_AREF))
+
+
+/*-- Data ---------------------------------------------------------*/
+
+static const char *kind_name[] = {"", "boundary", "path", "box", "node",
+                                  "text", "sref", "aref"};
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static err_id decode_records(map_file_t *mf, element_kind kind, double dbu_to_uu,
+			     el_buffer_t *eb);
+static element_kind etype_to_kind(int etype);
+static unsigned int record_kinds(uint16_t rtype);
+static err_id decode_xy(map_file_t *mf, int rlen, double dbu_to_uu,
+                        el_buffer_t *eb, el_decoded_t *de);
+static void xy_bbox(map_file_t *mf, int rlen, double dbu_to_uu, el_decoded_t *de);
+static err_id decode_string(map_file_t *mf, int rlen, el_buffer_t *eb, size_t *offset);
+static el_prop_t *prop_entry(el_buffer_t *eb, el_decoded_t *de, size_t k);
+static mxArray *xy_matrix(el_buffer_t *eb, size_t first, size_t nrec);
+static mxArray *prop_array(el_buffer_t *eb, el_decoded_t *de);
+static void *grow(void *pa, size_t *alloc, size_t need, size_t size);
+static err_id set_error(el_buffer_t *eb, err_id err, const char *fmt, ...);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+el_buffer_clear(el_buffer_t *eb)
+{
+   eb->nel = eb->nxyr = eb->nprop = eb->nxy = eb->nstr = 0;
+   eb->errmsg[0] = '\0';
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+el_buffer_free(el_buffer_t *eb)
+{
+   free(eb->el);
+   free(eb->xyr);
+   free(eb->prop);
+   free(eb->xy);
+   free(eb->str);
+   memset(eb, 0, sizeof(el_buffer_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+decode_element(map_file_t *mf, int etype, double dbu_to_uu, el_buffer_t *eb)
+{
+   element_kind kind;
+   err_id err;
+   STATS_TIMER(t);
+
+   kind = etype_to_kind(etype);
+   if (!kind)
+      return set_error(eb, READ_REC_TYPE, "gds_read_element :  unknown element type.");
+
+   err = decode_records(mf, kind, dbu_to_uu, eb);
+   STATS_EL_READ(kind, t);
+
+   return err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+mxArray *
+element_to_array(el_buffer_t *eb, size_t k)
+{
+   el_decoded_t *de = &eb->el[k];
+   mxArray *pstruct, *pc, *praw;
+   uint8_t *pr;
+   size_t j;
+   int nf, fs;
+   const char *fields[] = {"internal", "xy", "prop", "sname"};
+
+   /* lazy elements have a raw field instead of xy and prop */
+   if (de->raw) {
+      fields[1] = "raw";
+      fields[2] = "sname";
+      fs = 2;
+   }
+   else
+      fs = 3;
+
+   /* output data structure */
+   switch (de->el.kind) {
+      case GDS_TEXT:
+	 fields[fs] = "text";
+	 nf = fs + 1;
+	 break;
+      case GDS_SREF:
+      case GDS_AREF:
+	 nf = fs + 1;
+	 break;
+      default:
+	 nf = fs;
+   }
+   pstruct = mxCreateStructMatrix(1,1, nf, fields);
+
+   if (de->raw) {
+
+      /* unit conversion factor followed by the records */
+      praw = mxCreateNumericMatrix(sizeof(double) + de->nraw, 1, mxUINT8_CLASS, mxREAL);
+      pr = mxGetData(praw);
+      memcpy(pr, &eb->dbu_to_uu, sizeof(double));
+      memcpy(pr + sizeof(double), de->raw, de->nraw);
+      mxSetFieldByNumber(pstruct, 0, 1, praw);
+   }
+   else {
+
+      /* boundaries and paths have a cell array with XY records,
+	 all other elements a single matrix */
+      if (de->el.kind == GDS_BOUNDARY || de->el.kind == GDS_PATH) {
+	 pc = mxCreateCellMatrix(1, de->nxyrec);
+	 for (j=0; j<de->nxyrec; j++)
+	    mxSetCell(pc, j, xy_matrix(eb, de->xyrec + j, 1));
+	 mxSetFieldByNumber(pstruct, 0, 1, pc);
+      }
+      else if (de->nxyrec) {
+	 mxSetFieldByNumber(pstruct, 0, 1, xy_matrix(eb, de->xyrec, de->nxyrec));
+      }
+      else if (de->el.kind == GDS_SREF || de->el.kind == GDS_AREF) {
+	 mxSetFieldByNumber(pstruct, 0, 1, mxCreateDoubleMatrix(1,2, mxREAL));  /* [0,0] */
+      }
+
+      /* set prop field */
+      if (de->nprop)
+	 mxSetFieldByNumber(pstruct, 0, 2, prop_array(eb, de));
+      else
+	 mxSetFieldByNumber(pstruct, 0, 2, empty_matrix());
+   }
+
+   /* text or structure name */
+   if (de->has_str)
+      struct_set_string(pstruct, fs, eb->str + de->str);
+
+   /* store structure with internal element data */
+   mxSetFieldByNumber(pstruct, 0, 0, copy_element_to_array(&de->el));
+
+   return pstruct;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+mxArray *
+element_bboxes(el_buffer_t *eb)
+{
+   mxArray *pa;
+   el_decoded_t *de;
+   double *pd;
+   size_t k, n;
+
+   n = eb->nel;
+   pa = mxCreateDoubleMatrix(n,4, mxREAL);
+   pd = mxGetData(pa);
+   for (k=0; k<n; k++) {
+      de = &eb->el[k];
+      if (de->el.kind == GDS_PATH) {
+	 pd[k] = pd[k+n] = pd[k+2*n] = pd[k+3*n] = mxGetNaN();
+      }
+      else if (de->bbox[0] > de->bbox[2]) {
+	 pd[k] = pd[k+n] = mxGetInf();
+	 pd[k+2*n] = pd[k+3*n] = -mxGetInf();
+      }
+      else {
+	 pd[k]     = de->bbox[0];
+	 pd[k+n]   = de->bbox[1];
+	 pd[k+2*n] = de->bbox[2];
+	 pd[k+3*n] = de->bbox[3];
+      }
+   }
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+mxArray *
+element_columns(el_buffer_t *eb)
+{
+   mxArray *pcols, *pa, *pval;
+   el_decoded_t *de;
+   el_xyrec_t *pr;
+   uint8_t *pkind;
+   uint16_t *play, *pdt, *pfl;
+   int16_t *pattr;
+   double *ppo, *pvo, *pxy, *pel;
+   size_t k, j, n, npol, nver, nprop, p, v, q;
+   const char *fields[] = {"kind", "layer", "dtype", "flags", "poff", "voff",
+                           "xy", "pel", "pattr", "pval"};
+
+   if (eb->lazy)
+      return empty_matrix();
+
+   /* count polygons and vertices */
+   n = eb->nel;
+   npol = nver = nprop = 0;
+   for (k=0; k<n; k++) {
+      de = &eb->el[k];
+      if (de->el.kind == GDS_BOUNDARY || de->el.kind == GDS_PATH)
+	 npol += de->nxyrec;
+      else if (de->nxyrec)
+	 npol++;
+      for (j=0; j<de->nxyrec; j++)
+	 nver += eb->xyr[de->xyrec + j].m;
+      nprop += de->nprop;
+   }
+
+   pcols = mxCreateStructMatrix(1,1, 10, fields);
+
+   pa = mxCreateNumericMatrix(n,1, mxUINT8_CLASS, mxREAL);
+   pkind = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 0, pa);
+   pa = mxCreateNumericMatrix(n,1, mxUINT16_CLASS, mxREAL);
+   play = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 1, pa);
+   pa = mxCreateNumericMatrix(n,1, mxUINT16_CLASS, mxREAL);
+   pdt = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 2, pa);
+   pa = mxCreateNumericMatrix(n,1, mxUINT16_CLASS, mxREAL);
+   pfl = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 3, pa);
+   pa = mxCreateDoubleMatrix(n+1,1, mxREAL);
+   ppo = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 4, pa);
+   pa = mxCreateDoubleMatrix(npol+1,1, mxREAL);
+   pvo = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 5, pa);
+   pa = mxCreateDoubleMatrix(nver,2, mxREAL);
+   pxy = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 6, pa);
+   pa = mxCreateDoubleMatrix(nprop,1, mxREAL);
+   pel = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 7, pa);
+   pa = mxCreateNumericMatrix(nprop,1, mxINT16_CLASS, mxREAL);
+   pattr = mxGetData(pa);
+   mxSetFieldByNumber(pcols, 0, 8, pa);
+   pval = mxCreateCellMatrix(nprop,1);
+   mxSetFieldByNumber(pcols, 0, 9, pval);
+
+   /* one polygon per XY record of a boundary or path; the XY
+      records of all other elements are a single polygon */
+   p = v = q = 0;
+   ppo[0] = pvo[0] = 0.0;
+   for (k=0; k<n; k++) {
+      de = &eb->el[k];
+      pkind[k] = (uint8_t)de->el.kind;
+      if (de->el.kind != GDS_SREF && de->el.kind != GDS_AREF) {
+	 play[k] = de->el.layer;
+	 pdt[k] = de->el.dtype;
+      }
+      pfl[k] = de->el.elflags;
+      for (j=0; j<de->nxyrec; j++) {
+	 pr = &eb->xyr[de->xyrec + j];
+	 xy_deinterleave(eb->xy + pr->idx, pxy + v, pxy + v + nver, pr->m);
+	 v += pr->m;
+	 if (de->el.kind == GDS_BOUNDARY || de->el.kind == GDS_PATH ||
+	     j == de->nxyrec - 1)
+	    pvo[++p] = (double)v;
+      }
+      ppo[k+1] = (double)p;
+      for (j=0; j<de->nprop; j++, q++) {
+	 pel[q] = (double)(k+1);
+	 pattr[q] = eb->prop[de->prop + j].attr;
+	 mxSetCell(pval, q, mxCreateString(eb->str + eb->prop[de->prop + j].name));
+      }
+   }
+
+   return pcols;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+mxArray *
+read_element(map_file_t *mf, int etype, double dbu_to_uu, el_buffer_t *eb)
+{
+   el_buffer_clear(eb);
+   if ( decode_element(mf, etype, dbu_to_uu, eb) )
+      mexErrMsgTxt(eb->errmsg);
+
+   return element_to_array(eb, 0);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+read_lazy_element(const mxArray *praw, element_kind kind, el_buffer_t *eb,
+		  mxArray **pxy, mxArray **pprop)
+{
+   map_file_t mf;
+   mxArray *pstruct;
+   double dbu_to_uu;
+   uint8_t *pr;
+   size_t nr;
+
+   pr = (uint8_t *)mxGetData(praw);
+   nr = mxGetNumberOfElements(praw);
+   if ( !mxIsUint8(praw) || nr < sizeof(double) )
+      mexErrMsgTxt("gds_read_element :  invalid raw element data.");
+   memcpy(&dbu_to_uu, pr, sizeof(double));
+
+   /* the records are decoded from memory */
+   memset(&mf, 0, sizeof(map_file_t));
+   mf.base = pr + sizeof(double);
+   mf.size = nr - sizeof(double);
+
+   el_buffer_clear(eb);
+   eb->lazy = 0;
+   if ( decode_records(&mf, kind, dbu_to_uu, eb) )
+      mexErrMsgTxt(eb->errmsg);
+
+   /* take the xy and prop fields from the element structure */
+   pstruct = element_to_array(eb, 0);
+   *pxy = mxGetFieldByNumber(pstruct, 0, 1);
+   *pprop = mxGetFieldByNumber(pstruct, 0, 2);
+   if (*pxy == NULL)
+      *pxy = empty_matrix();
+   mxSetFieldByNumber(pstruct, 0, 1, NULL);
+   mxSetFieldByNumber(pstruct, 0, 2, NULL);
+   mxDestroyArray(pstruct);
+}
+
+
+/*=================================================================*/
+
+/*
+ * decodes the records of an element of the given kind up to
+ * and including the ENDEL record.
+ */
+static err_id
+decode_records(map_file_t *mf, element_kind kind, double dbu_to_uu, el_buffer_t *eb)
+{
+   el_decoded_t *de;
+   el_prop_t *pp;
+   uint16_t rtype, rlen;
+   uint16_t colrow[2];
+   int16_t attr;
+   int32_t ival;
+   size_t start;
+   void *pn;
+   err_id ret;
+
+   /* new element */
+   if (eb->nel == eb->ael) {
+      if ( !(pn = grow(eb->el, &eb->ael, eb->nel+1, sizeof(el_decoded_t))) )
+	 return set_error(eb, READ_REC_DATA, "gds_read_element :  out of memory.");
+      eb->el = pn;
+   }
+   de = &eb->el[eb->nel];
+   memset(de, 0, sizeof(el_decoded_t));
+   de->el.kind = kind;
+   de->xyrec = eb->nxyr;
+   de->prop = eb->nprop;
+   de->bbox[0] = de->bbox[1] = DBL_MAX;
+   de->bbox[2] = de->bbox[3] = -DBL_MAX;
+   eb->dbu_to_uu = dbu_to_uu;
+   start = mf->pos;
+
+   /* read element properties */
+   while (1) {
+
+      if ( map_record_hdr(mf, &rtype, &rlen) )
+	 return set_error(eb, READ_REC_HEADER,
+			  "gds_read_element (%s) :  could not read record header.",
+			  kind_name[kind]);
+
+      if (rtype == ENDEL)
+	 break;
+
+      if ( !(record_kinds(rtype) & K(kind)) ) {
+	 return set_error(eb, READ_REC_TYPE,
+			  "gds_read_element (%s) :  found unknown element property (0x%x).",
+			  kind_name[kind], rtype);
+      }
+
+      switch (rtype) {
+
+         case XY:
+	    if (kind == GDS_BOUNDARY || kind == GDS_BOX)
+	       xy_bbox(mf, rlen, dbu_to_uu, de);
+	    if (eb->lazy) {
+	       ret = map_ignore(mf, rlen);
+	       de->nxyrec++;
+	    }
+	    else
+	       ret = decode_xy(mf, rlen, dbu_to_uu, eb, de);
+	    break;
+
+         case LAYER:
+	    ret = map_word(mf, &de->el.layer);
+	    break;
+
+         case DATATYPE:
+	    ret = map_word(mf, &de->el.dtype);
+	    break;
+
+         case TEXTTYPE:
+	    ret = map_word(mf, &de->el.ttype);
+	    break;
+
+         case NODETYPE:
+	    ret = map_word(mf, &de->el.ntype);
+	    break;
+
+         case BOXTYPE:
+	    ret = map_word(mf, &de->el.btype);
+	    break;
+
+         case PATHTYPE:
+	    ret = map_word(mf, &de->el.ptype);
+	    de->el.has |= HAS_PTYPE;
+	    break;
+
+         case WIDTH:
+	    ret = map_int(mf, &ival);
+	    de->el.width = dbu_to_uu * (double)ival;
+	    de->el.has |= HAS_WIDTH;
+	    break;
+
+         case BGNEXTN:
+	    ret = map_int(mf, &ival);
+	    de->el.bgnextn = dbu_to_uu * ival;
+	    de->el.has |= HAS_BGNEXTN;
+	    break;
+
+         case ENDEXTN:
+	    ret = map_int(mf, &ival);
+	    de->el.endextn = dbu_to_uu * ival;
+	    de->el.has |= HAS_ENDEXTN;
+	    break;
+
+         case ELFLAGS:
+	    ret = map_word(mf, &de->el.elflags);
+	    de->el.has |= HAS_ELFLAGS;
+	    break;
+
+         case PLEX:
+	    ret = map_int(mf, &ival);
+	    if ( ival & (1<<23) ) {
+	       ival = ival & ~(1<<23);
+	       ival = -ival;
+	    }
+	    de->el.plex = ival;
+	    de->el.has |= HAS_PLEX;
+	    break;
+
+         case SNAME:
+         case STRING:
+	    ret = decode_string(mf, rlen, eb, &de->str);
+	    de->has_str = 1;
+	    break;
+
+         case COLROW:
+	    ret = map_word_n(mf, colrow, 2);
+	    de->el.nrow = colrow[1];
+	    de->el.ncol = colrow[0];
+	    break;
+
+         case PRESENTATION:
+	    ret = map_word(mf, &de->el.present);
+	    de->el.has |= HAS_PRESTN;
+	    break;
+
+         case STRANS:
+	    ret = map_word(mf, &de->el.strans.flags);
+	    de->el.has |= HAS_STRANS;
+	    break;
+
+         case MAG:
+	    ret = map_real8(mf, &de->el.strans.mag);
+	    de->el.has |= HAS_MAG;
+	    break;
+
+         case ANGLE:
+	    ret = map_real8(mf, &de->el.strans.angle);
+	    de->el.has |= HAS_ANGLE;
+	    break;
+
+         case PROPATTR:
+	    if (eb->lazy) {
+	       ret = map_ignore(mf, rlen);
+	       de->nprop++;
+	       break;
+	    }
+	    if ( (ret = map_word(mf, (uint16_t *)&attr)) )
+	       break;
+	    if ( !(pp = prop_entry(eb, de, de->nprop++)) )
+	       return set_error(eb, READ_REC_DATA, "gds_read_element :  out of memory.");
+	    pp->attr = attr;
+	    break;
+
+         case PROPVALUE:
+	    if (eb->lazy) {
+	       ret = map_ignore(mf, rlen);
+	       de->nval++;
+	       break;
+	    }
+	    if ( !(pp = prop_entry(eb, de, de->nval++)) )
+	       return set_error(eb, READ_REC_DATA, "gds_read_element :  out of memory.");
+	    ret = decode_string(mf, rlen, eb, &pp->name);
+	    break;
+
+         default: /* not reached */
+	    ret = READ_REC_TYPE;
+      }
+
+      if (ret)
+	 return set_error(eb, ret,
+			  "gds_read_element (%s) :  failed to read record 0x%04x.",
+			  kind_name[kind], rtype);
+   }
+
+   /* check element */
+   if ( !de->nxyrec && (kind == GDS_BOUNDARY || kind == GDS_PATH || kind == GDS_SREF) )
+      return set_error(eb, READ_REC_DATA,
+		       "gds_read_element (%s) :  element has no XY record.",
+		       kind_name[kind]);
+   if (de->nprop && de->nprop != de->nval)
+      return set_error(eb, READ_REC_DATA,
+		       "gds_read_element (%s) :  name and attribute lists do not match.",
+		       kind_name[kind]);
+
+   /* keep the records of lazy elements */
+   if (eb->lazy) {
+      de->raw = mf->base + start;
+      de->nraw = mf->pos - start;
+   }
+
+   eb->nel++;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static element_kind
+etype_to_kind(int etype)
+{
+   switch (etype) {
+      case BOUNDARY: return GDS_BOUNDARY;
+      case PATH:     return GDS_PATH;
+      case SREF:     return GDS_SREF;
+      case AREF:     return GDS_AREF;
+      case TEXT:     return GDS_TEXT;
+      case NODE:     return GDS_NODE;
+      case BOX:      return GDS_BOX;
+      default:       return 0;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns the element kinds in which a record may occur
+ */
+static unsigned int
+record_kinds(uint16_t rtype)
+{
+   switch (rtype) {
+      case XY:
+      case ELFLAGS:
+      case PLEX:
+      case PROPATTR:
+      case PROPVALUE:    return K_ALL;
+      case LAYER:
+      case DATATYPE:     return K_SHAPES;
+      case PATHTYPE:
+      case WIDTH:        return K(GDS_PATH) | K(GDS_TEXT);
+      case BGNEXTN:
+      case ENDEXTN:      return K(GDS_PATH);
+      case STRANS:
+      case MAG:
+      case ANGLE:        return K_STRANS;
+      case SNAME:        return K(GDS_SREF) | K(GDS_AREF);
+      case COLROW:       return K(GDS_AREF);
+      case STRING:
+      case TEXTTYPE:
+      case PRESENTATION: return K(GDS_TEXT);
+      case NODETYPE:     return K(GDS_NODE);
+      case BOXTYPE:      return K(GDS_BOX);
+      default:           return 0;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * Boundaries and paths keep all XY records, references catenate
+ * them, and in all other elements the last XY record is used.
+ * A full XY record of a boundary or path is continued by the next
+ * record when that record starts with the same vertex.
+ */
+static err_id
+decode_xy(map_file_t *mf, int rlen, double dbu_to_uu,
+	  el_buffer_t *eb, el_decoded_t *de)
+{
+   el_xyrec_t *pr;
+   double *pd;
+   uint8_t *pb;
+   size_t m;
+   void *pn;
+
+   m = rlen / (2*sizeof(int32_t));
+   if ( !(pb = map_data(mf, rlen)) )
+      return READ_INT;
+
+   if (de->nxyrec && de->el.kind != GDS_BOUNDARY &&
+       de->el.kind != GDS_PATH && de->el.kind != GDS_SREF) {
+      eb->nxyr = de->xyrec;
+      de->nxyrec = 0;
+   }
+
+   /* make room */
+   if (eb->nxyr == eb->axyr) {
+      if ( !(pn = grow(eb->xyr, &eb->axyr, eb->nxyr+1, sizeof(el_xyrec_t))) )
+	 return READ_REC_DATA;
+      eb->xyr = pn;
+   }
+   if (eb->nxy + 2*m > eb->axy) {
+      if ( !(pn = grow(eb->xy, &eb->axy, eb->nxy + 2*m, sizeof(double))) )
+	 return READ_REC_DATA;
+      eb->xy = pn;
+   }
+
+   /* convert the vertices */
+   pd = eb->xy + eb->nxy;
+   xy_decode(pb, pd, 2*m, dbu_to_uu);
+   STATS_ADD(ST_VERT_READ, m);
+
+   /* continuation record */
+   if (de->nxyrec && m && (de->el.kind == GDS_BOUNDARY || de->el.kind == GDS_PATH)) {
+      pr = &eb->xyr[eb->nxyr-1];
+      if (pr->mlast == MAX_XY_VERTICES && pd[0] == pd[-2] && pd[1] == pd[-1]) {
+	 memmove(pd, pd+2, 2*(m-1)*sizeof(double));
+	 pr->m += m-1;
+	 pr->mlast = m;
+	 eb->nxy += 2*(m-1);
+	 return A_OK;
+      }
+   }
+
+   pr = &eb->xyr[eb->nxyr++];
+   pr->idx = eb->nxy;
+   pr->m = m;
+   pr->mlast = m;
+   eb->nxy += 2*m;
+   de->nxyrec++;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * extends the bounding box of an element by the vertices of an
+ * XY record without advancing the read position. Boxes only use
+ * the last XY record (see decode_xy).
+ */
+static void
+xy_bbox(map_file_t *mf, int rlen, double dbu_to_uu, el_decoded_t *de)
+{
+   uint8_t *pb;
+   int32_t v[2], lo[2], hi[2];
+   size_t m, k;
+
+   m = rlen / (2*sizeof(int32_t));
+   if (!m || mf->size - mf->pos < (size_t)rlen)
+      return;  /* reported when the record is read */
+   pb = mf->base + mf->pos;
+
+   memcpy(v, pb, sizeof(v));
+   byte_reverse32(&v[0]);
+   byte_reverse32(&v[1]);
+   lo[0] = hi[0] = v[0];
+   lo[1] = hi[1] = v[1];
+   for (k=1; k<m; k++) {
+      memcpy(v, pb + k*sizeof(v), sizeof(v));
+      byte_reverse32(&v[0]);
+      byte_reverse32(&v[1]);
+      if (v[0] < lo[0]) lo[0] = v[0];
+      if (v[0] > hi[0]) hi[0] = v[0];
+      if (v[1] < lo[1]) lo[1] = v[1];
+      if (v[1] > hi[1]) hi[1] = v[1];
+   }
+
+   if (de->el.kind == GDS_BOX) {
+      de->bbox[0] = de->bbox[1] = DBL_MAX;
+      de->bbox[2] = de->bbox[3] = -DBL_MAX;
+   }
+   if (dbu_to_uu * lo[0] < de->bbox[0]) de->bbox[0] = dbu_to_uu * lo[0];
+   if (dbu_to_uu * lo[1] < de->bbox[1]) de->bbox[1] = dbu_to_uu * lo[1];
+   if (dbu_to_uu * hi[0] > de->bbox[2]) de->bbox[2] = dbu_to_uu * hi[0];
+   if (dbu_to_uu * hi[1] > de->bbox[3]) de->bbox[3] = dbu_to_uu * hi[1];
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static err_id
+decode_string(map_file_t *mf, int rlen, el_buffer_t *eb, size_t *offset)
+{
+   void *pn;
+
+   if (eb->nstr + rlen + 1 > eb->astr) {
+      if ( !(pn = grow(eb->str, &eb->astr, eb->nstr + rlen + 1, sizeof(char))) )
+	 return READ_REC_DATA;
+      eb->str = pn;
+   }
+
+   if ( map_string(mf, eb->str + eb->nstr, rlen) )
+      return READ_CHAR;
+   *offset = eb->nstr;
+   eb->nstr += rlen + 1;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns property k of an element. PROPATTR and PROPVALUE records
+ * are counted separately and are paired in the order they occur.
+ */
+static el_prop_t *
+prop_entry(el_buffer_t *eb, el_decoded_t *de, size_t k)
+{
+   el_prop_t *pp;
+   void *pn;
+
+   if (de->prop + k < eb->nprop)
+      return &eb->prop[de->prop + k];
+
+   if (eb->nprop == eb->aprop) {
+      if ( !(pn = grow(eb->prop, &eb->aprop, eb->nprop+1, sizeof(el_prop_t))) )
+	 return NULL;
+      eb->prop = pn;
+   }
+   pp = &eb->prop[eb->nprop++];
+   pp->attr = 0;
+   pp->name = 0;
+
+   return pp;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns an m x 2 matrix with the vertices of nrec XY records
+ */
+static mxArray *
+xy_matrix(el_buffer_t *eb, size_t first, size_t nrec)
+{
+   mxArray *pa;
+   double *pd, *ps;
+   el_xyrec_t *pr;
+   size_t m, j, row;
+
+   for (m=0,j=0; j<nrec; j++)
+      m += eb->xyr[first + j].m;
+
+   pa = mxCreateDoubleMatrix(m,2, mxREAL);
+   pd = mxGetData(pa);
+   for (row=0,j=0; j<nrec; j++) {
+      pr = &eb->xyr[first + j];
+      ps = eb->xy + pr->idx;
+      xy_deinterleave(ps, pd+row, pd+row+m, pr->m);
+      row += pr->m;
+   }
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray *
+prop_array(el_buffer_t *eb, el_decoded_t *de)
+{
+   mxArray *pprop;
+   el_prop_t *pp;
+   size_t k;
+   const char *pfields[] = {"attr","name"};
+
+   pprop = mxCreateStructMatrix(1,de->nprop, 2, pfields);
+   for (k=0; k<de->nprop; k++) {
+      pp = &eb->prop[de->prop + k];
+      mxSetFieldByNumber(pprop, k, 0, mxCreateDoubleScalar((double)pp->attr));
+      mxSetFieldByNumber(pprop, k, 1, mxCreateString(eb->str + pp->name));
+   }
+
+   return pprop;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * grows an array to hold at least need entries of the given size.
+ * Returns the new array or NULL if no memory is available.
+ */
+static void *
+grow(void *pa, size_t *alloc, size_t need, size_t size)
+{
+   void *pn;
+   size_t na;
+
+   na = *alloc ? *alloc : CHUNK;
+   while (na < need)
+      na *= 2;
+   pn = realloc(pa, na*size);
+   if (pn == NULL)
+      return NULL;
+   *alloc = na;
+   STATS_ALLOC(na*size);
+
+   return pn;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static err_id
+set_error(el_buffer_t *eb, err_id err, const char *fmt, ...)
+{
+   va_list ap;
+
+   va_start(ap, fmt);
+   vsnprintf(eb->errmsg, ERRLEN, fmt, ap);
+   va_end(ap);
+
+   return err;
+}
+
+/*-----------------------------------------------------------------*/
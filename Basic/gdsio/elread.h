@@ -0,0 +1,178 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Functions for reading GDSII elements into MATLAB/Octave
+ * data structures.
+ *
+ * Reading an element is done in two steps. The element records
+ * are first decoded into an element buffer (decode_element), which
+ * does not use the MATLAB API and can be run in any thread. The
+ * decoded elements are then converted into the data structures
+ * expected by gds_element('_file_', data) (element_to_array),
+ * which must be done in the thread that called the mex function.
+ *
+ * In lazy mode, the XY and property records are not decoded.
+ * Instead, the element data structure contains the raw records
+ * of the element in a field 'raw', which are decoded when the
+ * vertices or properties are needed (see read_lazy_element).
+ */
+
+#ifndef _ELREAD_H
+#define _ELREAD_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "mex.h"
+#include "gdstypes.h"
+#include "mapio.h"
+
+#define ERRLEN 128
+
+
+/*
+ * the vertices of an XY record, or of a sequence of XY records
+ * that describe one polygon or path (see MAX_XY_VERTICES)
+ */
+typedef struct {
+   size_t idx;       /* index of first vertex in xy array */
+   size_t m;         /* number of vertices */
+   size_t mlast;     /* vertices in the last of several XY records */
+} el_xyrec_t;
+
+
+/*
+ * an element property
+ */
+typedef struct {
+   int16_t attr;     /* property attribute */
+   size_t name;      /* offset of property value in string array */
+} el_prop_t;
+
+
+/*
+ * a decoded element
+ */
+typedef struct {
+   element_t el;     /* internal element data */
+   size_t xyrec;     /* first XY record */
+   size_t nxyrec;    /* number of XY records */
+   size_t prop;      /* first property */
+   size_t nprop;     /* number of PROPATTR records */
+   size_t nval;      /* number of PROPVALUE records */
+   size_t str;       /* offset of text or sname in string array */
+   int has_str;      /* 1 if the element has a text or sname */
+   uint8_t *raw;     /* element records in lazy mode */
+   size_t nraw;      /* number of bytes in raw records */
+   double bbox[4];   /* bounding box of boundary and box vertices */
+} el_decoded_t;
+
+
+/*
+ * buffer with decoded elements. Vertices are stored as x,y
+ * pairs. All arrays grow as needed and are reused when the
+ * buffer is cleared. In lazy mode, the raw records point into
+ * the memory of the file and are only valid while it is mapped.
+ */
+typedef struct {
+   el_decoded_t *el;  size_t nel, ael;
+   el_xyrec_t *xyr;   size_t nxyr, axyr;
+   el_prop_t *prop;   size_t nprop, aprop;
+   double *xy;        size_t nxy, axy;
+   char *str;         size_t nstr, astr;
+   double dbu_to_uu;  /* unit conversion factor */
+   int lazy;          /* 1 = keep XY and property records undecoded */
+   char errmsg[ERRLEN];  /* error message when decoding failed */
+} el_buffer_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * discard all elements in a buffer but keep the memory. A buffer
+ * must be set to zero before it is used for the first time.
+ */
+void el_buffer_clear(el_buffer_t *eb);
+
+/*
+ * release the memory of an element buffer
+ */
+void el_buffer_free(el_buffer_t *eb);
+
+/*
+ * decode the element data following an element record header
+ * of type etype and append the element to the buffer. Returns
+ * A_OK on success; otherwise an error message is in eb->errmsg.
+ * This function does not call the MATLAB API.
+ *
+ * mf :        file or element data in memory (see mapio.h)
+ * etype :     element record type (BOUNDARY, PATH, ...)
+ * dbu_to_uu : conversion factor database units --> user units
+ * eb :        element buffer
+ */
+err_id decode_element(map_file_t *mf, int etype, double dbu_to_uu, el_buffer_t *eb);
+
+/*
+ * return element k of a buffer in a structure with the fields
+ * internal, xy, prop (and text or sname). This is the structure
+ * expected by gds_element('_file_', data). In lazy mode, the
+ * fields xy and prop are replaced by a field raw, a uint8 array
+ * with the unit conversion factor (a double) followed by the
+ * element records up to and including ENDEL.
+ */
+mxArray *element_to_array(el_buffer_t *eb, size_t k);
+
+/*
+ * return an nel x 4 matrix with the bounding boxes [llx,lly,urx,ury]
+ * of all elements in a buffer. The bounding boxes of boundary and
+ * box elements are computed from the XY records while they are
+ * decoded, also in lazy mode. Path elements have a NaN bounding box
+ * because it depends on how the path is rendered; all other elements
+ * have the bounding box [Inf,Inf,-Inf,-Inf] (see gds_element/bbox).
+ */
+mxArray *element_bboxes(el_buffer_t *eb);
+
+/*
+ * return the elements of a buffer in columnar form, a structure
+ * with the fields
+ *   kind :  nel x 1 uint8 element kinds (see element_kind)
+ *   layer : nel x 1 uint16 layers (0 for references)
+ *   dtype : nel x 1 uint16 data types (0 for references)
+ *   flags : nel x 1 uint16 element flags (ELFLAGS)
+ *   poff :  (nel+1) x 1 offsets; the polygons of element k are
+ *           poff(k)+1 .. poff(k+1)
+ *   voff :  (npol+1) x 1 offsets; the vertices of polygon p are
+ *           rows voff(p)+1 .. voff(p+1) of xy
+ *   xy :    vertex slab with the vertices of all elements
+ *   pel, pattr, pval : element index, attribute and value of each
+ *           element property
+ * Boundaries and paths have one polygon per XY record, all other
+ * elements a single polygon with their positions. Returns an empty
+ * matrix in lazy mode because the XY records are not decoded.
+ */
+mxArray *element_columns(el_buffer_t *eb);
+
+/*
+ * decode one element and return it in a structure (see above).
+ * Errors are reported with mexErrMsgTxt.
+ */
+mxArray *read_element(map_file_t *mf, int etype, double dbu_to_uu, el_buffer_t *eb);
+
+/*
+ * decode the raw records of an element that was read in lazy
+ * mode and return its XY and property data. Errors are reported
+ * with mexErrMsgTxt.
+ *
+ * praw :   raw element data (see element_to_array)
+ * kind :   element kind
+ * eb :     element buffer
+ * pxy :    returns the xy field of the element
+ * pprop :  returns the prop field of the element
+ */
+void read_lazy_element(const mxArray *praw, element_kind kind, el_buffer_t *eb,
+                       mxArray **pxy, mxArray **pprop);
+
+#endif /* _ELREAD_H */
@@ -0,0 +1,650 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Encoding of GDSII elements into memory buffers (see elwrite.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "gdstypes.h"
+#include "elwrite.h"
+#include "gdsstats.h"
+
+#ifdef __GNUC__
+   #define INLINE __inline__
+#else
+   #define INLINE
+#endif
+
+#include "byteswap.h"
+#if defined __GNUC__
+#include "convert_float_gcc.h"
+#else
+#include "convert_float_generic.h"
+#endif
+#include "xyconv.h"
+
+#define MINBUF    65536    /* initial buffer size in bytes */
+#define MINXY     8192     /* initial vertex buffer size */
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static void encode_boundary(ew_buffer_t *wb, const ew_list_t *ls,
+                            const ew_element_t *pe, double uu_to_dbu, int compound);
+static void encode_path(ew_buffer_t *wb, const ew_list_t *ls,
+                        const ew_element_t *pe, double uu_to_dbu, int compound);
+static void encode_sref(ew_buffer_t *wb, const ew_list_t *ls,
+                        const ew_element_t *pe, double uu_to_dbu, int compound);
+static void encode_aref(ew_buffer_t *wb, const ew_list_t *ls,
+                        const ew_element_t *pe, double uu_to_dbu);
+static void encode_text(ew_buffer_t *wb, const ew_list_t *ls,
+                        const ew_element_t *pe, double uu_to_dbu);
+static void encode_node(ew_buffer_t *wb, const ew_list_t *ls,
+                        const ew_element_t *pe, double uu_to_dbu);
+static void encode_box(ew_buffer_t *wb, const ew_list_t *ls,
+                       const ew_element_t *pe, double uu_to_dbu);
+static void put_header(ew_buffer_t *wb, uint16_t rtype, const element_t *pel);
+static void put_strans(ew_buffer_t *wb, const element_t *pel);
+static void put_properties(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe);
+static void put_xy(ew_buffer_t *wb, const int32_t *xy, size_t m, int cont);
+static void put_string(ew_buffer_t *wb, uint16_t rtype, const char *str);
+static void put_record(ew_buffer_t *wb, uint16_t rtype, uint16_t rlen);
+static void put_word(ew_buffer_t *wb, uint16_t data);
+static void put_int(ew_buffer_t *wb, int32_t data);
+static void put_real8(ew_buffer_t *wb, double rnum);
+static void put_bytes(ew_buffer_t *wb, const void *data, size_t n);
+static int32_t *vertex_buffer(ew_buffer_t *wb, size_t m);
+
+
+/*-----------------------------------------------------------------*/
+
+int
+encode_elements(ew_buffer_t *wb, const ew_list_t *ls, double uu_to_dbu, int compound)
+{
+   const ew_element_t *pe;
+   size_t k;
+
+   for (k=0; k<ls->nel && !wb->err; k++) {
+
+      STATS_TIMER(t);
+      pe = &ls->el[k];
+
+      switch (pe->el.kind) {
+
+         case GDS_BOUNDARY:
+	    encode_boundary(wb, ls, pe, uu_to_dbu, compound);
+	    break;
+
+         case GDS_PATH:
+	    encode_path(wb, ls, pe, uu_to_dbu, compound);
+	    break;
+
+         case GDS_SREF:
+	    encode_sref(wb, ls, pe, uu_to_dbu, compound);
+	    break;
+
+         case GDS_AREF:
+	    encode_aref(wb, ls, pe, uu_to_dbu);
+	    break;
+
+         case GDS_TEXT:
+	    encode_text(wb, ls, pe, uu_to_dbu);
+	    break;
+
+         case GDS_NODE:
+	    encode_node(wb, ls, pe, uu_to_dbu);
+	    break;
+
+         case GDS_BOX:
+	    encode_box(wb, ls, pe, uu_to_dbu);
+	    break;
+      }
+      STATS_EL_WRITTEN(pe->el.kind, t);
+   }
+
+   return wb->err ? -1 : 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+real8_valid(double d)
+{
+   uint64_t bits;
+   unsigned int e;
+
+   memcpy(&bits, &d, sizeof(uint64_t));
+   e = (unsigned int)((bits >> 52) & 0x7ff);
+
+   return e >= 767 && e <= 1275;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ew_buffer_clear(ew_buffer_t *wb)
+{
+   wb->size = 0;
+   wb->err = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ew_buffer_free(ew_buffer_t *wb)
+{
+   free(wb->base);
+   free(wb->xy);
+   memset(wb, 0, sizeof(ew_buffer_t));
+}
+
+
+/*-- Boundary -----------------------------------------------------*/
+
+/*
+ * a boundary with several polygons is written as one boundary per
+ * polygon, or as one compound boundary with several XY records
+ */
+static void
+encode_boundary(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+                double uu_to_dbu, int compound)
+{
+   const ew_xy_t *pxy;
+   int32_t *xy;
+   size_t k, m;
+
+   for (k=0; k<pe->nxy; k++) {
+
+      if (!k || !compound) {
+	 put_header(wb, BOUNDARY, &pe->el);
+	 put_record(wb, LAYER, sizeof(uint16_t));
+	 put_word(wb, pe->el.layer);
+	 put_record(wb, DATATYPE, sizeof(uint16_t));
+	 put_word(wb, pe->el.dtype);
+      }
+
+      /* XY */
+      pxy = &ls->xy[pe->xy + k];
+      m = pxy->m;
+      if ( (xy = vertex_buffer(wb, m+1)) == NULL )
+	 return;
+      xy_encode(pxy->xy, pxy->xy + m, xy, m, uu_to_dbu);
+      if ( (xy[0] != xy[2*m-2]) || (xy[1] != xy[2*m-1]) ) {
+	 xy[2*m]   = xy[0];  /* close polygon */
+	 xy[2*m+1] = xy[1];
+	 m += 1;
+      }
+      put_xy(wb, xy, m, 1);
+
+      if (k+1 == pe->nxy || !compound) {
+	 put_properties(wb, ls, pe);
+	 put_record(wb, ENDEL, 0);
+      }
+   }
+}
+
+
+/*-- Path ---------------------------------------------------------*/
+
+static void
+encode_path(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+            double uu_to_dbu, int compound)
+{
+   const element_t *pel = &pe->el;
+   const ew_xy_t *pxy;
+   int32_t *xy;
+   size_t k;
+
+   for (k=0; k<pe->nxy; k++) {
+
+      if (!k || !compound) {
+	 put_header(wb, PATH, pel);
+	 put_record(wb, LAYER, sizeof(uint16_t));
+	 put_word(wb, pel->layer);
+	 put_record(wb, DATATYPE, sizeof(uint16_t));
+	 put_word(wb, pel->dtype);
+
+	 /* PATHTYPE */
+	 if ( pel->has & HAS_PTYPE ) {
+	    put_record(wb, PATHTYPE, sizeof(uint16_t));
+	    put_word(wb, pel->ptype);
+	 }
+
+	 /* WIDTH */
+	 if ( pel->has & HAS_WIDTH ) {
+	    put_record(wb, WIDTH, sizeof(int32_t));
+	    put_int(wb, (int32_t)floor(pel->width * uu_to_dbu + 0.5));
+	 }
+
+	 /* path extensions */
+	 if (pel->has & HAS_PTYPE && pel->ptype == 4) {
+	    if ( pel->has & HAS_BGNEXTN ) {
+	       put_record(wb, BGNEXTN, sizeof(int32_t));
+	       put_int(wb, (int32_t)floor(pel->bgnextn * uu_to_dbu + 0.5));
+	    }
+	    if ( pel->has & HAS_ENDEXTN ) {
+	       put_record(wb, ENDEXTN, sizeof(int32_t));
+	       put_int(wb, (int32_t)floor(pel->endextn * uu_to_dbu + 0.5));
+	    }
+	 }
+      }
+
+      /* XY */
+      pxy = &ls->xy[pe->xy + k];
+      if ( (xy = vertex_buffer(wb, pxy->m)) == NULL )
+	 return;
+      xy_encode(pxy->xy, pxy->xy + pxy->m, xy, pxy->m, uu_to_dbu);
+      put_xy(wb, xy, pxy->m, 1);
+
+      if (k+1 == pe->nxy || !compound) {
+	 put_properties(wb, ls, pe);
+	 put_record(wb, ENDEL, 0);
+      }
+   }
+}
+
+
+/*-- Sref ---------------------------------------------------------*/
+
+/*
+ * an sref with several positions is written as one sref per
+ * position, or as one compound sref with all positions
+ */
+static void
+encode_sref(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+            double uu_to_dbu, int compound)
+{
+   const ew_xy_t *pxy = &ls->xy[pe->xy];
+   int32_t *xy;
+   size_t k, m;
+
+   m = compound ? 1 : pxy->m;
+   for (k=0; k<m; k++) {
+
+      put_header(wb, SREF, &pe->el);
+      put_string(wb, SNAME, ls->str + pe->str);
+      put_strans(wb, &pe->el);
+
+      /* XY */
+      if (compound) {
+	 if ( (xy = vertex_buffer(wb, pxy->m)) == NULL )
+	    return;
+	 xy_encode(pxy->xy, pxy->xy + pxy->m, xy, pxy->m, uu_to_dbu);
+	 put_xy(wb, xy, pxy->m, 0);
+      }
+      else {
+	 if ( (xy = vertex_buffer(wb, 1)) == NULL )
+	    return;
+	 xy_encode(pxy->xy + k, pxy->xy + k + pxy->m, xy, 1, uu_to_dbu);
+	 put_xy(wb, xy, 1, 0);
+      }
+
+      put_properties(wb, ls, pe);
+      put_record(wb, ENDEL, 0);
+   }
+}
+
+
+/*-- Aref ---------------------------------------------------------*/
+
+static void
+encode_aref(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+            double uu_to_dbu)
+{
+   const ew_xy_t *pxy = &ls->xy[pe->xy];
+   int32_t xy[6];
+
+   put_header(wb, AREF, &pe->el);
+   put_string(wb, SNAME, ls->str + pe->str);
+   put_strans(wb, &pe->el);
+
+   /* COLROW */
+   put_record(wb, COLROW, 2*sizeof(uint16_t));
+   put_word(wb, pe->el.ncol);
+   put_word(wb, pe->el.nrow);
+
+   /* XY */
+   xy_encode(pxy->xy, pxy->xy + 3, xy, 3, uu_to_dbu);
+   put_xy(wb, xy, 3, 0);
+
+   put_properties(wb, ls, pe);
+   put_record(wb, ENDEL, 0);
+}
+
+
+/*-- Text ---------------------------------------------------------*/
+
+static void
+encode_text(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+            double uu_to_dbu)
+{
+   const element_t *pel = &pe->el;
+   const ew_xy_t *pxy = &ls->xy[pe->xy];
+   int32_t xy[2];
+
+   put_header(wb, TEXT, pel);
+   put_record(wb, LAYER, sizeof(uint16_t));
+   put_word(wb, pel->layer);
+
+   /* DATATYPE (only if explicitely set) */
+   if ( pel->has & HAS_DTYPE ) {
+      put_record(wb, DATATYPE, sizeof(uint16_t));
+      put_word(wb, pel->dtype);
+   }
+
+   /* TEXTTYPE */
+   put_record(wb, TEXTTYPE, sizeof(uint16_t));
+   put_word(wb, pel->ttype);
+
+   /* PRESENTATION */
+   if ( pel->has & HAS_PRESTN ) {
+      put_record(wb, PRESENTATION, sizeof(uint16_t));
+      put_word(wb, pel->present);
+   }
+
+   /* PATHTYPE */
+   if ( pel->has & HAS_PTYPE ) {
+      put_record(wb, PATHTYPE, sizeof(uint16_t));
+      put_word(wb, pel->ptype);
+   }
+
+   /* WIDTH */
+   if ( pel->has & HAS_WIDTH ) {
+      put_record(wb, WIDTH, sizeof(int32_t));
+      put_int(wb, (int32_t)pel->width);
+   }
+
+   put_strans(wb, pel);
+
+   /* XY */
+   xy_encode(pxy->xy, pxy->xy + 1, xy, 1, uu_to_dbu);
+   put_xy(wb, xy, 1, 0);
+
+   /* STRING */
+   put_string(wb, STRING, ls->str + pe->str);
+
+   put_properties(wb, ls, pe);
+   put_record(wb, ENDEL, 0);
+}
+
+
+/*-- Node ---------------------------------------------------------*/
+
+static void
+encode_node(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+            double uu_to_dbu)
+{
+   const ew_xy_t *pxy = &ls->xy[pe->xy];
+   int32_t *xy;
+
+   put_header(wb, NODE, &pe->el);
+   put_record(wb, LAYER, sizeof(uint16_t));
+   put_word(wb, pe->el.layer);
+   put_record(wb, DATATYPE, sizeof(uint16_t));
+   put_word(wb, pe->el.dtype);
+
+   /* NODETYPE */
+   put_record(wb, NODETYPE, sizeof(uint16_t));
+   put_word(wb, pe->el.ntype);
+
+   /* XY */
+   if ( (xy = vertex_buffer(wb, pxy->m)) == NULL )
+      return;
+   xy_encode(pxy->xy, pxy->xy + pxy->m, xy, pxy->m, uu_to_dbu);
+   put_xy(wb, xy, pxy->m, 0);
+
+   put_properties(wb, ls, pe);
+   put_record(wb, ENDEL, 0);
+}
+
+
+/*-- Box ----------------------------------------------------------*/
+
+static void
+encode_box(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe,
+           double uu_to_dbu)
+{
+   const ew_xy_t *pxy = &ls->xy[pe->xy];
+   int32_t xy[10];
+
+   put_header(wb, BOX, &pe->el);
+   put_record(wb, LAYER, sizeof(uint16_t));
+   put_word(wb, pe->el.layer);
+   put_record(wb, DATATYPE, sizeof(uint16_t));
+   put_word(wb, pe->el.dtype);
+
+   /* BOXTYPE */
+   put_record(wb, BOXTYPE, sizeof(uint16_t));
+   put_word(wb, pe->el.btype);
+
+   /* XY */
+   xy_encode(pxy->xy, pxy->xy + pxy->m, xy, pxy->m, uu_to_dbu);
+   if (pxy->m == 4) { /* polygon is not closed */
+      xy[8] = xy[0]; xy[9] = xy[1];
+   }
+   put_xy(wb, xy, 5, 0);
+
+   put_properties(wb, ls, pe);
+   put_record(wb, ENDEL, 0);
+}
+
+
+/*-- Common -------------------------------------------------------*/
+
+/*
+ * element record with the optional ELFLAGS and PLEX records
+ */
+static void
+put_header(ew_buffer_t *wb, uint16_t rtype, const element_t *pel)
+{
+   put_record(wb, rtype, 0);
+
+   if ( pel->has & HAS_ELFLAGS ) {
+      put_record(wb, ELFLAGS, sizeof(uint16_t));
+      put_word(wb, pel->elflags);
+   }
+
+   if ( pel->has & HAS_PLEX ) {
+      put_record(wb, PLEX, sizeof(int32_t));
+      put_int(wb, pel->plex);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_strans(ew_buffer_t *wb, const element_t *pel)
+{
+   if ( pel->has & HAS_STRANS ) {
+      put_record(wb, STRANS, sizeof(uint16_t));
+      put_word(wb, pel->strans.flags);
+      if ( pel->has & HAS_MAG && pel->strans.mag != 1.0) {
+	 put_record(wb, MAG, 8);
+	 put_real8(wb, pel->strans.mag);
+      }
+      if ( pel->has & HAS_ANGLE && pel->strans.angle != 0.0) {
+	 put_record(wb, ANGLE, 8);
+	 put_real8(wb, pel->strans.angle);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_properties(ew_buffer_t *wb, const ew_list_t *ls, const ew_element_t *pe)
+{
+   const ew_prop_t *pp;
+   size_t k;
+
+   for (k=0; k<pe->nprop; k++) {
+      pp = &ls->prop[pe->prop + k];
+      put_record(wb, PROPATTR, sizeof(int16_t));
+      put_word(wb, (uint16_t)pp->attr);
+      put_string(wb, PROPVALUE, ls->str + pp->value);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes m vertices, already in file byte order (see xy_encode),
+ * in one or more XY records. With cont > 0, every continuation
+ * record starts with the last vertex of the preceding full record
+ * (see MAX_XY_VERTICES in gdstypes.h).
+ */
+static void
+put_xy(ew_buffer_t *wb, const int32_t *xy, size_t m, int cont)
+{
+   size_t n;
+
+   STATS_ADD(ST_VERT_WRITTEN, m);
+   while (1) {
+      n = m > MAX_XY_VERTICES ? MAX_XY_VERTICES : m;
+      put_record(wb, XY, 2*n*sizeof(int32_t));
+      put_bytes(wb, xy, 2*n*sizeof(int32_t));
+      if (n == m)
+	 break;
+
+      if (cont)
+	 n -= 1;
+      xy += 2*n;
+      m -= n;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a string record; strings with an odd number of characters are
+ * padded with a null character
+ */
+static void
+put_string(ew_buffer_t *wb, uint16_t rtype, const char *str)
+{
+   size_t len = strlen(str);
+
+   put_record(wb, rtype, (uint16_t)(len + len % 2));
+   put_bytes(wb, str, len);
+   if (len % 2)
+      put_bytes(wb, "", 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_record(ew_buffer_t *wb, uint16_t rtype, uint16_t rlen)
+{
+   uint16_t hdr[2];
+
+   hdr[0] = rlen + 2*sizeof(uint16_t);
+   hdr[1] = rtype;
+   STATS_REC_WRITTEN(rtype, hdr[0]);
+   byte_reverse_n(hdr, 2);
+   put_bytes(wb, hdr, sizeof(hdr));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_word(ew_buffer_t *wb, uint16_t data)
+{
+   byte_reverse(&data);
+   put_bytes(wb, &data, sizeof(uint16_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_int(ew_buffer_t *wb, int32_t data)
+{
+   byte_reverse32(&data);
+   put_bytes(wb, &data, sizeof(int32_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* the number must have been checked with real8_valid */
+static void
+put_real8(ew_buffer_t *wb, double rnum)
+{
+   uint64_t e64num;
+
+   ieee754_to_excess64(rnum, &e64num);
+   put_bytes(wb, &e64num, sizeof(uint64_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_bytes(ew_buffer_t *wb, const void *data, size_t n)
+{
+   uint8_t *pn;
+   size_t na;
+
+   if (wb->err)
+      return;
+
+   if (wb->size + n > wb->alloc) {
+      na = wb->alloc ? wb->alloc : MINBUF;
+      while (na < wb->size + n)
+	 na *= 2;
+      if ( (pn = realloc(wb->base, na)) == NULL ) {
+	 wb->err = 1;
+	 return;
+      }
+      wb->base = pn;
+      wb->alloc = na;
+      STATS_ALLOC(na);
+   }
+   memcpy(wb->base + wb->size, data, n);
+   wb->size += n;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns a buffer for at least m vertices
+ */
+static int32_t *
+vertex_buffer(ew_buffer_t *wb, size_t m)
+{
+   int32_t *pn;
+   size_t na;
+
+   if (m > wb->axy) {
+      na = wb->axy ? wb->axy : MINXY;
+      while (na < m)
+	 na *= 2;
+      if ( (pn = realloc(wb->xy, 2*na*sizeof(int32_t))) == NULL ) {
+	 wb->err = 1;
+	 return NULL;
+      }
+      wb->xy = pn;
+      wb->axy = na;
+      STATS_ALLOC(2*na*sizeof(int32_t));
+   }
+
+   return wb->xy;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,123 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Functions for encoding GDSII elements into memory buffers.
+ *
+ * Writing an element is the reverse of reading it (see elread.h)
+ * and is also done in two steps. The element data are first
+ * collected from the MATLAB/Octave data structures into an
+ * element list (see elgather.h), which must be done in the thread
+ * that called the mex function. The elements of the list are then
+ * encoded into GDSII records in a memory buffer (encode_elements),
+ * which does not use the MATLAB API and can be run in any thread.
+ *
+ * All elements in a list must have been checked when they were
+ * collected; encoding only fails when no memory is available.
+ * The records are identical to the records written by
+ * gds_write_element, which uses the same functions.
+ */
+
+#ifndef _ELWRITE_H
+#define _ELWRITE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gdstypes.h"
+
+
+/*
+ * a matrix with m vertices (m x 2, column major)
+ */
+typedef struct {
+   const double *xy;  /* x coordinates; y coordinates start at xy + m */
+   size_t m;          /* number of vertices */
+} ew_xy_t;
+
+
+/*
+ * an element property
+ */
+typedef struct {
+   int16_t attr;      /* property attribute */
+   size_t value;      /* offset of property value in string array */
+} ew_prop_t;
+
+
+/*
+ * an element to be written
+ */
+typedef struct {
+   element_t el;      /* internal element data */
+   size_t xy;         /* first vertex matrix */
+   size_t nxy;        /* number of vertex matrices */
+   size_t prop;       /* first property */
+   size_t nprop;      /* number of properties */
+   size_t str;        /* offset of structure name (sref, aref) or
+                         text string (text) in string array */
+} ew_element_t;
+
+
+/*
+ * a list of elements with their vertices, properties and strings.
+ * The vertices are not copied; they must remain valid until the
+ * elements are encoded.
+ */
+typedef struct {
+   ew_element_t *el;  size_t nel, ael;      /* elements */
+   ew_xy_t *xy;       size_t nxy, axy;      /* vertex matrices */
+   ew_prop_t *prop;   size_t nprop, aprop;  /* properties */
+   char *str;         size_t nstr, astr;    /* strings */
+} ew_list_t;
+
+
+/*
+ * a buffer with encoded GDSII records in file byte order
+ */
+typedef struct {
+   uint8_t *base;     /* records */
+   size_t size;       /* number of bytes in buffer */
+   size_t alloc;      /* size of allocated buffer */
+   int32_t *xy;       /* encoded vertices */
+   size_t axy;        /* allocated vertices */
+   int err;           /* 1 when no memory was available */
+} ew_buffer_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * appends the records of the elements in a list to a buffer. Only
+ * C library functions are called.
+ *
+ * wb :         an encoding buffer (initially set to zero)
+ * ls :         the elements
+ * uu_to_dbu :  conversion factor user units --> database units
+ * compound :   when != 0, compound elements are written as one
+ *              element with multiple XY records.
+ *
+ * Returns 0 on success and -1 when no memory is available.
+ */
+int encode_elements(ew_buffer_t *wb, const ew_list_t *ls, double uu_to_dbu,
+                    int compound);
+
+/*
+ * returns 1 when a number can be stored in an 8-byte real
+ * (excess-64) record, 0 otherwise
+ */
+int real8_valid(double d);
+
+/*
+ * discards the records in a buffer and keeps the memory
+ */
+void ew_buffer_clear(ew_buffer_t *wb);
+
+/*
+ * releases the memory of a buffer
+ */
+void ew_buffer_free(ew_buffer_t *wb);
+
+#endif /* _ELWRITE_H */
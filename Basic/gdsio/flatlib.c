@@ -0,0 +1,181 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Conversion of structure element data into a library for the
+ * hierarchy functions in flatten.h (see flatlib.h).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "flatlib.h"
+
+#define NLEN  256
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int find_name(const char *name, char **names, size_t *order, size_t n);
+static int cmp_names(const void *a, const void *b);
+
+static char **sort_names;   /* used by cmp_names */
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+fl_build_library(fl_library_t *lib, const mxArray *cells, const mxArray *snames)
+{
+   mxArray *pc, *pd, *pf, *pp;
+   element_t *pe;
+   fl_cell_t *c;
+   char **names;
+   size_t *order;
+   double *xy, rxy[6];
+   size_t k, m, n, r, nr, nel, np, nnames;
+   int32_t target;
+   char sname[NLEN];
+   const char *msg = NULL;
+   fl_status st = FL_OK;
+
+   nnames = mxGetNumberOfElements(snames);
+   if ( fl_library_init(lib, nnames) )
+      return fl_message(FL_MEMORY);
+
+   /* structure names sorted for the lookup of references */
+   names = mxCalloc(nnames ? nnames : 1, sizeof(char *));
+   order = mxCalloc(nnames ? nnames : 1, sizeof(size_t));
+   for (k=0; k<nnames; k++) {
+      if ( mxGetString(mxGetCell(snames, k), sname, NLEN) ) {
+	 msg = "structure names must be strings";
+	 goto done;
+      }
+      names[k] = mxCalloc(strlen(sname)+1, 1);
+      strcpy(names[k], sname);
+      order[k] = k;
+   }
+   sort_names = names;
+   qsort(order, nnames, sizeof(size_t), cmp_names);
+
+   for (k=0; k<lib->ncell && !msg; k++) {
+
+      pc = mxGetCell(cells, k);
+      if (pc == NULL || mxIsEmpty(pc))
+	 continue;
+      if ( !mxIsCell(pc) ) {
+	 msg = "structure elements must be in cell arrays";
+	 break;
+      }
+      c = &lib->cell[k];
+      nel = mxGetNumberOfElements(pc);
+
+      for (m=0; m<nel && !st && !msg; m++) {
+
+	 /* element data */
+	 pd = mxGetCell(pc, m);
+	 if (pd == NULL || !mxIsStruct(pd)) {
+	    msg = "element data must be structures";
+	    break;
+	 }
+	 pf = mxGetField(pd, 0, "internal");
+	 if (pf == NULL ||
+	     mxGetNumberOfElements(pf) * mxGetElementSize(pf) < sizeof(element_t)) {
+	    msg = "element data have no internal field";
+	    break;
+	 }
+	 pe = (element_t *)mxGetData(pf);
+	 pf = mxGetField(pd, 0, "xy");
+
+	 if (pe->kind == GDS_SREF || pe->kind == GDS_AREF) {
+	    if (pf == NULL || !mxIsDouble(pf) ||
+		mxGetM(pf) < (pe->kind == GDS_AREF ? 3 : 1) || mxGetN(pf) != 2) {
+	       msg = "invalid reference position";
+	       break;
+	    }
+	    pp = mxGetField(pd, 0, "sname");
+	    if (pp == NULL || mxGetString(pp, sname, NLEN)) {
+	       msg = "reference element without structure name";
+	       break;
+	    }
+	    target = find_name(sname, names, order, lib->ncell);
+
+	    /* reference positions are stored x,y */
+	    xy = mxGetPr(pf);
+	    nr = mxGetM(pf);
+	    memset(rxy, 0, sizeof(rxy));
+	    for (r=0; r<nr && r<3; r++) {
+	       rxy[2*r] = xy[r];
+	       rxy[2*r+1] = xy[nr+r];
+	    }
+	    st = fl_add_ref(c, m, target, pe, rxy);
+	    continue;
+	 }
+
+	 if ( (st = fl_add_shape(c, m, pe)) )
+	    break;
+	 if (pf == NULL)
+	    continue;
+	 np = mxIsCell(pf) ? mxGetNumberOfElements(pf) : 1;
+	 for (n=0; n<np && !st; n++) {
+	    pp = mxIsCell(pf) ? mxGetCell(pf, n) : pf;
+	    if (pp == NULL || mxIsEmpty(pp))
+	       continue;
+	    if ( !mxIsDouble(pp) || mxGetN(pp) != 2 ) {
+	       msg = "vertices must be stored in n x 2 matrices";
+	       break;
+	    }
+	    xy = mxGetPr(pp);
+	    st = fl_add_vertices(c, xy, xy + mxGetM(pp), mxGetM(pp), 1);
+	 }
+      }
+
+      if (st)
+	 msg = fl_message(st);
+   }
+
+ done:
+   for (k=0; k<nnames; k++)
+      if (names[k])
+	 mxFree(names[k]);
+   mxFree(names);
+   mxFree(order);
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cmp_names(const void *a, const void *b)
+{
+   return strcmp(sort_names[*(const size_t *)a], sort_names[*(const size_t *)b]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* binary search for a structure name; returns -1 if not found */
+static int
+find_name(const char *name, char **names, size_t *order, size_t n)
+{
+   size_t lo = 0, hi = n, mid;
+   int c;
+
+   while (lo < hi) {
+      mid = (lo + hi) / 2;
+      c = strcmp(name, names[order[mid]]);
+      if (c == 0)
+	 return (int)order[mid];
+      if (c < 0)
+	 hi = mid;
+      else
+	 lo = mid + 1;
+   }
+
+   return -1;
+}
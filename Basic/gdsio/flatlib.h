@@ -0,0 +1,37 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Conversion of the element data of MATLAB/Octave structures into a
+ * library for the hierarchy functions in flatten.h. Shared by the
+ * mex functions that operate on flattened structures.
+ */
+
+#ifndef _FLATLIB_H
+#define _FLATLIB_H
+
+#include "mex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "flatten.h"
+
+/*
+ * build a library from a cell array with one entry per structure,
+ * each a cell array with the element data structures of the
+ * structure (as returned by get(gelm)), and a cell array with the
+ * structure names. References are resolved by name. Returns NULL
+ * on success or an error message; in both cases the library must
+ * be released with fl_library_free.
+ */
+const char *fl_build_library(fl_library_t *lib, const mxArray *cells,
+                             const mxArray *names);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLATLIB_H */
@@ -0,0 +1,946 @@
+/*
+ * Hierarchy flattening for GDSII libraries (see flatten.h)
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gdstypes.h"
+#include "flatten.h"
+#include "pathpoly.h"
+
+#define CHUNK      64
+#define MAX_DEPTH  1024   /* deeper hierarchies are certainly cyclic */
+
+#ifndef M_PI
+   #define M_PI 3.14159265358979323846
+#endif
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int grow(void **p, size_t *alloc, size_t need, size_t size);
+static void box_transform(double *tb, const double *bb, const affine_t *T);
+static int box_overlap(const double *a, const double *b);
+static int affine_invert(affine_t *R, const affine_t *T);
+static int lattice_row(const double *tb, const double *dc, const double *dr,
+                       int j, int ncol, const double *win, int *i0, int *i1);
+static void ref_box(fl_library_t *lib, const fl_ref_t *r, double *b);
+static fl_status cell_bbox(fl_library_t *lib, size_t k, int depth);
+static fl_status topo_order(fl_library_t *lib, size_t k, char *mark,
+                            size_t *order, size_t *n, int depth);
+static void window_ref(fl_library_t *lib, const fl_ref_t *r,
+                       const double *w, double *cw);
+static int output_layer(fl_result_t *res, fl_shape_t *sh);
+static fl_status emit_shape(fl_result_t *res, fl_cell_t *c, uint32_t k,
+                            fl_shape_t *sh, const affine_t *T, int outline);
+static fl_status emit_ref(fl_library_t *lib, const fl_options_t *opt,
+                          fl_result_t *res, fl_ref_t *r,
+                          const affine_t *T, int depth);
+static fl_status flatten_cell(fl_library_t *lib, const fl_options_t *opt,
+                              fl_result_t *res, size_t k,
+                              const affine_t *T, int depth);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+affine_strans(affine_t *T, const strans_t *st, unsigned int has,
+              double x, double y)
+{
+   double mag = 1.0, ang = 0.0, c, s;
+   int reflect = 0;
+
+   if (has & HAS_STRANS) {
+      reflect = (st->flags & 0x8000) != 0;
+      if (has & HAS_MAG)
+	 mag = st->mag;
+      if (has & HAS_ANGLE)
+	 ang = st->angle;
+   }
+
+   /* exact values for multiples of 90 degrees */
+   if ( fmod(ang, 90.0) == 0.0 ) {
+      switch ( ((int)(ang / 90.0) % 4 + 4) % 4 ) {
+	 case 0:  c =  1.0;  s =  0.0;  break;
+	 case 1:  c =  0.0;  s =  1.0;  break;
+	 case 2:  c = -1.0;  s =  0.0;  break;
+	 default: c =  0.0;  s = -1.0;  break;
+      }
+   }
+   else {
+      c = cos(M_PI * ang / 180.0);
+      s = sin(M_PI * ang / 180.0);
+   }
+
+   /* T = translate * mag * rotate * reflect */
+   T->a11 = mag * c;
+   T->a21 = mag * s;
+   T->a12 = reflect ?  mag * s : -mag * s;
+   T->a22 = reflect ? -mag * c :  mag * c;
+   T->tx = x;
+   T->ty = y;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+affine_compose(affine_t *R, const affine_t *P, const affine_t *C)
+{
+   affine_t t;
+
+   t.a11 = P->a11 * C->a11 + P->a12 * C->a21;
+   t.a12 = P->a11 * C->a12 + P->a12 * C->a22;
+   t.a21 = P->a21 * C->a11 + P->a22 * C->a21;
+   t.a22 = P->a21 * C->a12 + P->a22 * C->a22;
+   t.tx = P->a11 * C->tx + P->a12 * C->ty + P->tx;
+   t.ty = P->a21 * C->tx + P->a22 * C->ty + P->ty;
+   *R = t;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_library_init(fl_library_t *lib, size_t ncell)
+{
+   lib->ncell = ncell;
+   lib->cell = calloc(ncell ? ncell : 1, sizeof(fl_cell_t));
+
+   return lib->cell ? FL_OK : FL_MEMORY;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+fl_library_free(fl_library_t *lib)
+{
+   size_t k;
+
+   if (lib->cell == NULL)
+      return;
+
+   for (k=0; k<lib->ncell; k++) {
+      free(lib->cell[k].sh);
+      free(lib->cell[k].ref);
+      free(lib->cell[k].poly);
+      free(lib->cell[k].xy);
+   }
+   free(lib->cell);
+   lib->cell = NULL;
+   lib->ncell = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_add_shape(fl_cell_t *c, uint32_t el, const element_t *pe)
+{
+   fl_shape_t *sh;
+   double w;
+
+   if ( grow((void **)&c->sh, &c->ash, c->nsh+1, sizeof(fl_shape_t)) )
+      return FL_MEMORY;
+
+   sh = &c->sh[c->nsh++];
+   sh->el = el;
+   sh->kind = pe->kind;
+   sh->layer = pe->layer;
+   switch (pe->kind) {
+      case GDS_TEXT: sh->dtype = pe->ttype; break;
+      case GDS_NODE: sh->dtype = pe->ntype; break;
+      case GDS_BOX:  sh->dtype = pe->btype; break;
+      default:       sh->dtype = pe->dtype;
+   }
+
+   /* paths extend beyond their vertices */
+   sh->pad = sh->hw = 0.0;
+   sh->ptype = pe->kind == GDS_PATH && (pe->has & HAS_PTYPE) ? pe->ptype : 0;
+   sh->ext[0] = (pe->has & HAS_BGNEXTN) ? pe->bgnextn : 0.0;
+   sh->ext[1] = (pe->has & HAS_ENDEXTN) ? pe->endextn : 0.0;
+   if (pe->kind == GDS_PATH && (pe->has & HAS_WIDTH)) {
+      w = sh->hw = fabs(pe->width) / 2;
+      if ((pe->has & HAS_BGNEXTN) && fabs(pe->bgnextn) > w)
+	 w = fabs(pe->bgnextn);
+      if ((pe->has & HAS_ENDEXTN) && fabs(pe->endextn) > w)
+	 w = fabs(pe->endextn);
+      sh->pad = w;
+   }
+
+   sh->poly = c->npoly;
+   sh->npoly = 0;
+   sh->bbox[0] = sh->bbox[1] = HUGE_VAL;
+   sh->bbox[2] = sh->bbox[3] = -HUGE_VAL;
+   sh->olay = -1;
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_add_vertices(fl_cell_t *c, const double *x, const double *y,
+                size_t n, size_t stride)
+{
+   fl_shape_t *sh;
+   double *pv;
+   size_t k;
+
+   if (!c->nsh)
+      return FL_ARGUMENT;
+   sh = &c->sh[c->nsh-1];
+
+   if ( grow((void **)&c->poly, &c->apoly, c->npoly+1, sizeof(fl_poly_t)) ||
+        grow((void **)&c->xy, &c->axy, 2*(c->nxy+n), sizeof(double)) )
+      return FL_MEMORY;
+
+   c->poly[c->npoly].v = c->nxy;
+   c->poly[c->npoly].nv = n;
+   c->npoly++;
+   sh->npoly++;
+
+   pv = c->xy + 2*c->nxy;
+   for (k=0; k<n; k++) {
+      pv[2*k] = x[k*stride];
+      pv[2*k+1] = y[k*stride];
+      if (pv[2*k]   - sh->pad < sh->bbox[0]) sh->bbox[0] = pv[2*k]   - sh->pad;
+      if (pv[2*k+1] - sh->pad < sh->bbox[1]) sh->bbox[1] = pv[2*k+1] - sh->pad;
+      if (pv[2*k]   + sh->pad > sh->bbox[2]) sh->bbox[2] = pv[2*k]   + sh->pad;
+      if (pv[2*k+1] + sh->pad > sh->bbox[3]) sh->bbox[3] = pv[2*k+1] + sh->pad;
+   }
+   c->nxy += n;
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_add_ref(fl_cell_t *c, uint32_t el, int32_t cell,
+           const element_t *pe, const double *xy)
+{
+   fl_ref_t *r;
+
+   if ( grow((void **)&c->ref, &c->aref, c->nref+1, sizeof(fl_ref_t)) )
+      return FL_MEMORY;
+
+   r = &c->ref[c->nref++];
+   r->el = el;
+   r->cell = cell;
+   affine_strans(&r->T, &pe->strans, pe->has, xy[0], xy[1]);
+   r->absolute = (pe->has & HAS_STRANS) && (pe->strans.flags & 0x0006);
+   r->is_aref = pe->kind == GDS_AREF && pe->ncol > 0 && pe->nrow > 0;
+   if (r->is_aref) {
+      r->ncol = pe->ncol;
+      r->nrow = pe->nrow;
+      r->dcol[0] = (xy[2] - xy[0]) / pe->ncol;
+      r->dcol[1] = (xy[3] - xy[1]) / pe->ncol;
+      r->drow[0] = (xy[4] - xy[0]) / pe->nrow;
+      r->drow[1] = (xy[5] - xy[1]) / pe->nrow;
+   }
+   else {
+      r->ncol = r->nrow = 1;
+      r->dcol[0] = r->dcol[1] = r->drow[0] = r->drow[1] = 0.0;
+   }
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_flatten(fl_library_t *lib, size_t top, const fl_options_t *opt,
+           fl_result_t *res)
+{
+   affine_t I = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+   fl_status st;
+   size_t k, m;
+
+   if (top >= lib->ncell)
+      return FL_ARGUMENT;
+
+   /* output layers are assigned again for each result */
+   res->nlay = res->nins = 0;
+   res->nsref = res->naref = res->ncreated = 0;
+   res->nmissing = res->nabsolute = 0;
+   res->depth = 0;
+   for (k=0; k<lib->ncell; k++) {
+      lib->cell[k].active = 0;
+      for (m=0; m<lib->cell[k].nsh; m++)
+	 lib->cell[k].sh[m].olay = -1;
+   }
+
+   /* the structure bounding boxes are needed to cull references */
+   if (opt->has_window) {
+      if ( (st = cell_bbox(lib, top, 0)) )
+	 return st;
+   }
+
+   if ( (st = flatten_cell(lib, opt, res, top, &I, 0)) )
+      return st;
+
+   /* layer stack entries of the output layers */
+   for (k=0; k<res->nlay; k++)
+      res->lay[k].entry = opt->table ?
+	 opt->table[FL_TABLE_INDEX(res->lay[k].layer, res->lay[k].dtype)] : 0;
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_cell_bbox(fl_library_t *lib, size_t k, double *bbox)
+{
+   fl_status st;
+
+   if (k >= lib->ncell)
+      return FL_ARGUMENT;
+
+   /* a cycle leaves the structures in progress; they are retried */
+   if ( (st = cell_bbox(lib, k, 0)) ) {
+      for (k=0; k<lib->ncell; k++)
+	 if (lib->cell[k].bbox_state == 1)
+	    lib->cell[k].bbox_state = 0;
+      return st;
+   }
+
+   memcpy(bbox, lib->cell[k].bbox, 4*sizeof(double));
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_ref_bbox(fl_library_t *lib, const fl_ref_t *r, double *bbox)
+{
+   double cb[4];
+   fl_status st;
+
+   bbox[0] = bbox[1] = HUGE_VAL;
+   bbox[2] = bbox[3] = -HUGE_VAL;
+   if (r->cell < 0)
+      return FL_OK;
+   if ( (st = fl_cell_bbox(lib, r->cell, cb)) )
+      return st;
+   ref_box(lib, r, bbox);
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+fl_status
+fl_window_cells(fl_library_t *lib, size_t top, const double *win, double *lwin)
+{
+   size_t *order;
+   char *mark;
+   double tb[4], *w;
+   fl_status st;
+   size_t k, m, r, n = 0;
+
+   if (top >= lib->ncell)
+      return FL_ARGUMENT;
+   if ( (st = fl_cell_bbox(lib, top, tb)) )
+      return st;
+
+   order = malloc(lib->ncell * sizeof(size_t));
+   mark = calloc(lib->ncell, 1);
+   if (order == NULL || mark == NULL) {
+      free(order);
+      free(mark);
+      return FL_MEMORY;
+   }
+   st = topo_order(lib, top, mark, order, &n, 0);
+   free(mark);
+   if (st) {
+      free(order);
+      return st;
+   }
+
+   for (k=0; k<lib->ncell; k++) {
+      lwin[4*k] = lwin[4*k+1] = HUGE_VAL;
+      lwin[4*k+2] = lwin[4*k+3] = -HUGE_VAL;
+   }
+   memcpy(lwin + 4*top, win, 4*sizeof(double));
+
+   /* the windows of all parents are complete before they are
+      passed on to the children */
+   for (m=n; m-- > 0; ) {
+      k = order[m];
+      w = lwin + 4*k;
+      if (w[0] > w[2] || w[1] > w[3])
+	 continue;
+      for (r=0; r<lib->cell[k].nref; r++) {
+	 if (lib->cell[k].ref[r].cell >= 0)
+	    window_ref(lib, &lib->cell[k].ref[r], w,
+	               lwin + 4*lib->cell[k].ref[r].cell);
+      }
+   }
+
+   free(order);
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+fl_result_free(fl_result_t *res)
+{
+   size_t k;
+
+   for (k=0; k<res->alay; k++) {
+      free(res->lay[k].xy);
+      free(res->lay[k].nv);
+   }
+   free(res->lay);
+   free(res->ins);
+   memset(res, 0, sizeof(fl_result_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+fl_message(fl_status st)
+{
+   switch (st) {
+      case FL_OK:       return "no error";
+      case FL_MEMORY:   return "out of memory";
+      case FL_CYCLE:    return "the structure hierarchy contains a cycle";
+      case FL_ARGUMENT: return "invalid argument";
+   }
+
+   return "unknown error";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* returns 1 if the memory could not be allocated */
+static int
+grow(void **p, size_t *alloc, size_t need, size_t size)
+{
+   size_t n;
+   void *q;
+
+   if (need <= *alloc)
+      return 0;
+
+   n = *alloc ? 2 * *alloc : CHUNK;
+   while (n < need)
+      n *= 2;
+   q = realloc(*p, n * size);
+   if (q == NULL)
+      return 1;
+
+   /* new elements are set to zero */
+   memset((char *)q + *alloc * size, 0, (n - *alloc) * size);
+   *p = q;
+   *alloc = n;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* bounding box of a transformed bounding box */
+static void
+box_transform(double *tb, const double *bb, const affine_t *T)
+{
+   double x, y;
+   int k;
+
+   tb[0] = tb[1] = HUGE_VAL;
+   tb[2] = tb[3] = -HUGE_VAL;
+   if (bb[0] > bb[2])   /* empty */
+      return;
+
+   for (k=0; k<4; k++) {
+      x = bb[k & 1 ? 2 : 0];
+      y = bb[k & 2 ? 3 : 1];
+      tb[0] = fmin(tb[0], T->a11 * x + T->a12 * y + T->tx);
+      tb[2] = fmax(tb[2], T->a11 * x + T->a12 * y + T->tx);
+      tb[1] = fmin(tb[1], T->a21 * x + T->a22 * y + T->ty);
+      tb[3] = fmax(tb[3], T->a21 * x + T->a22 * y + T->ty);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+box_overlap(const double *a, const double *b)
+{
+   return a[0] <= b[2] && a[2] >= b[0] && a[1] <= b[3] && a[3] >= b[1];
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* inverse of an affine transformation; returns 1 if T is singular */
+static int
+affine_invert(affine_t *R, const affine_t *T)
+{
+   double det = T->a11 * T->a22 - T->a12 * T->a21;
+   affine_t I;
+
+   if (det == 0.0)
+      return 1;
+
+   I.a11 =  T->a22 / det;
+   I.a12 = -T->a12 / det;
+   I.a21 = -T->a21 / det;
+   I.a22 =  T->a11 / det;
+   I.tx = -(I.a11 * T->tx + I.a12 * T->ty);
+   I.ty = -(I.a21 * T->tx + I.a22 * T->ty);
+   *R = I;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * columns i0 ... i1 of row j of an array whose instance boxes
+ * tb + i*dc + j*dr overlap the window; returns 0 when no instance
+ * of the row overlaps. The overlap conditions are linear in i, so
+ * the overlapping columns are found without visiting the others.
+ */
+static int
+lattice_row(const double *tb, const double *dc, const double *dr,
+            int j, int ncol, const double *win, int *i0, int *i1)
+{
+   double lo, hi, a, b, f0 = 0.0, f1 = ncol - 1, ib[4];
+   int d, n;
+
+   for (d=0; d<2; d++) {
+      lo = win[d] - tb[d+2] - j * dr[d];
+      hi = win[d+2] - tb[d] - j * dr[d];
+      if (dc[d] == 0.0) {
+	 if (lo > 0.0 || hi < 0.0)
+	    return 0;
+	 continue;
+      }
+      a = (dc[d] > 0.0 ? lo : hi) / dc[d];
+      b = (dc[d] > 0.0 ? hi : lo) / dc[d];
+      f0 = fmax(f0, ceil(a) - 1.0);   /* one column of slack for */
+      f1 = fmin(f1, floor(b) + 1.0);  /* rounding; see below */
+   }
+   if (!(f0 <= f1))
+      return 0;
+   *i0 = (int)f0;
+   *i1 = (int)f1;
+
+   /* exact overlap tests of the first and the last column */
+   for (n=0; n<2; n++) {
+      while (*i0 <= *i1) {
+	 d = n ? *i1 : *i0;
+	 ib[0] = tb[0] + d * dc[0] + j * dr[0];
+	 ib[2] = tb[2] + d * dc[0] + j * dr[0];
+	 ib[1] = tb[1] + d * dc[1] + j * dr[1];
+	 ib[3] = tb[3] + d * dc[1] + j * dr[1];
+	 if ( box_overlap(ib, win) )
+	    break;
+	 if (n)
+	    (*i1)--;
+	 else
+	    (*i0)++;
+      }
+   }
+
+   return *i0 <= *i1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* adds the bounding box of all instances of a reference to b; the
+   bounding box of the referenced structure must be valid */
+static void
+ref_box(fl_library_t *lib, const fl_ref_t *r, double *b)
+{
+   double tb[4], dx, dy;
+   int n;
+
+   box_transform(tb, lib->cell[r->cell].bbox, &r->T);
+   if (tb[0] > tb[2])
+      return;
+
+   /* the array instances in the four corners */
+   for (n=0; n<4; n++) {
+      dx = dy = 0.0;
+      if (n & 1) {
+	 dx += (r->ncol - 1) * r->dcol[0];
+	 dy += (r->ncol - 1) * r->dcol[1];
+      }
+      if (n & 2) {
+	 dx += (r->nrow - 1) * r->drow[0];
+	 dy += (r->nrow - 1) * r->drow[1];
+      }
+      b[0] = fmin(b[0], tb[0] + dx);
+      b[1] = fmin(b[1], tb[1] + dy);
+      b[2] = fmax(b[2], tb[2] + dx);
+      b[3] = fmax(b[3], tb[3] + dy);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* computes the bounding box of the flattened structure k */
+static fl_status
+cell_bbox(fl_library_t *lib, size_t k, int depth)
+{
+   fl_cell_t *c = &lib->cell[k];
+   fl_ref_t *r;
+   double *b = c->bbox;
+   fl_status st;
+   size_t m;
+
+   if (c->bbox_state == 2)
+      return FL_OK;
+   if (c->bbox_state == 1 || depth > MAX_DEPTH)
+      return FL_CYCLE;
+   c->bbox_state = 1;
+
+   b[0] = b[1] = HUGE_VAL;
+   b[2] = b[3] = -HUGE_VAL;
+   for (m=0; m<c->nsh; m++) {
+      b[0] = fmin(b[0], c->sh[m].bbox[0]);
+      b[1] = fmin(b[1], c->sh[m].bbox[1]);
+      b[2] = fmax(b[2], c->sh[m].bbox[2]);
+      b[3] = fmax(b[3], c->sh[m].bbox[3]);
+   }
+
+   for (m=0; m<c->nref; m++) {
+      r = &c->ref[m];
+      if (r->cell < 0)
+	 continue;
+      if ( (st = cell_bbox(lib, r->cell, depth+1)) )
+	 return st;
+      ref_box(lib, r, b);
+   }
+
+   c->bbox_state = 2;
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* structures below k in post-order; each structure once */
+static fl_status
+topo_order(fl_library_t *lib, size_t k, char *mark,
+           size_t *order, size_t *n, int depth)
+{
+   fl_cell_t *c = &lib->cell[k];
+   fl_status st;
+   size_t m;
+
+   if (mark[k] == 2)
+      return FL_OK;
+   if (mark[k] == 1 || depth > MAX_DEPTH)
+      return FL_CYCLE;
+   mark[k] = 1;
+
+   for (m=0; m<c->nref; m++) {
+      if (c->ref[m].cell >= 0 &&
+          (st = topo_order(lib, c->ref[m].cell, mark, order, n, depth+1)))
+	 return st;
+   }
+
+   mark[k] = 2;
+   order[(*n)++] = k;
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * adds the part of the window w of a structure that is covered by
+ * instances of reference r, in the coordinates of the referenced
+ * structure, to the window cw of the referenced structure
+ */
+static void
+window_ref(fl_library_t *lib, const fl_ref_t *r, const double *w, double *cw)
+{
+   const double *cb = lib->cell[r->cell].bbox;
+   double tb[4], u[4], lb[4], ox, oy;
+   affine_t I;
+   int i, j, i0, i1, n;
+
+   box_transform(tb, cb, &r->T);
+   if (tb[0] > tb[2])
+      return;
+
+   /* union of the window relative to the overlapping instances,
+      in the coordinates of the first instance; the union of a row
+      is spanned by its first and last overlapping column */
+   u[0] = u[1] = HUGE_VAL;
+   u[2] = u[3] = -HUGE_VAL;
+   for (j=0; j<r->nrow; j++) {
+      if ( !lattice_row(tb, r->dcol, r->drow, j, r->ncol, w, &i0, &i1) )
+	 continue;
+      for (n=0; n<2; n++) {
+	 i = n ? i1 : i0;
+	 ox = i * r->dcol[0] + j * r->drow[0];
+	 oy = i * r->dcol[1] + j * r->drow[1];
+	 u[0] = fmin(u[0], w[0] - ox);
+	 u[1] = fmin(u[1], w[1] - oy);
+	 u[2] = fmax(u[2], w[2] - ox);
+	 u[3] = fmax(u[3], w[3] - oy);
+      }
+   }
+   if (u[0] > u[2])
+      return;
+
+   /* in the coordinates of the referenced structure */
+   if ( affine_invert(&I, &r->T) )
+      memcpy(lb, cb, 4*sizeof(double));
+   else {
+      box_transform(lb, u, &I);
+      lb[0] = fmax(lb[0], cb[0]);
+      lb[1] = fmax(lb[1], cb[1]);
+      lb[2] = fmin(lb[2], cb[2]);
+      lb[3] = fmin(lb[3], cb[3]);
+      if (lb[0] > lb[2] || lb[1] > lb[3])
+	 return;
+   }
+
+   cw[0] = fmin(cw[0], lb[0]);
+   cw[1] = fmin(cw[1], lb[1]);
+   cw[2] = fmax(cw[2], lb[2]);
+   cw[3] = fmax(cw[3], lb[3]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* returns the output layer of a shape or -1 */
+static int
+output_layer(fl_result_t *res, fl_shape_t *sh)
+{
+   size_t k;
+
+   if (sh->olay >= 0)
+      return sh->olay;
+
+   for (k=0; k<res->nlay; k++) {
+      if (res->lay[k].layer == sh->layer && res->lay[k].dtype == sh->dtype)
+	 break;
+   }
+   if (k == res->nlay) {
+      if ( grow((void **)&res->lay, &res->alay, res->nlay+1, sizeof(fl_layer_t)) )
+	 return -1;
+      res->lay[k].layer = sh->layer;
+      res->lay[k].dtype = sh->dtype;
+      res->lay[k].nxy = res->lay[k].npoly = 0;
+      res->nlay++;
+   }
+   sh->olay = (int32_t)k;
+
+   return sh->olay;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* writes the transformed vertices of a shape to its output layer;
+   paths are converted to polygons when outline is set */
+static fl_status
+emit_shape(fl_result_t *res, fl_cell_t *c, uint32_t k,
+           fl_shape_t *sh, const affine_t *T, int outline)
+{
+   fl_layer_t *L;
+   fl_poly_t *p;
+   fl_instance_t *in;
+   const double *s;
+   double *d, t;
+   size_t m, n, np, nv = 0;
+   int lk;
+
+   if ( (lk = output_layer(res, sh)) < 0 )
+      return FL_MEMORY;
+   L = &res->lay[lk];
+
+   for (m=0; m<sh->npoly; m++) {
+      p = &c->poly[sh->poly + m];
+      nv += outline ? pathpoly_size(c->xy + 2*p->v, c->xy + 2*p->v + 1,
+                                    p->nv, 2, sh->ptype)
+                    : p->nv;
+   }
+   if ( grow((void **)&L->xy, &L->axy, 2*(L->nxy + nv), sizeof(double)) ||
+        grow((void **)&L->nv, &L->apoly, L->npoly + sh->npoly, sizeof(uint32_t)) ||
+        grow((void **)&res->ins, &res->ains, res->nins+1, sizeof(fl_instance_t)) )
+      return FL_MEMORY;
+
+   in = &res->ins[res->nins++];
+   in->cell = k;
+   in->el = sh->el;
+   in->layer = lk;
+   in->poly = L->npoly;
+   in->npoly = 0;
+   in->mag = sqrt(fabs(T->a11 * T->a22 - T->a12 * T->a21));
+
+   d = L->xy + 2*L->nxy;
+   for (m=0; m<sh->npoly; m++) {
+      p = &c->poly[sh->poly + m];
+      s = c->xy + 2*p->v;
+      if (outline) {
+	 /* the polygon is computed in the structure coordinates
+	    and transformed in place */
+	 np = pathpoly(s, s + 1, p->nv, 2, sh->hw, sh->ptype, sh->ext,
+	               d, d + 1, 2);
+	 if (np == 0)
+	    continue;
+	 for (n=0; n<np; n++, d+=2) {
+	    t    = T->a11 * d[0] + T->a12 * d[1] + T->tx;
+	    d[1] = T->a21 * d[0] + T->a22 * d[1] + T->ty;
+	    d[0] = t;
+	 }
+      }
+      else {
+	 np = p->nv;
+	 for (n=0; n<np; n++, s+=2, d+=2) {
+	    d[0] = T->a11 * s[0] + T->a12 * s[1] + T->tx;
+	    d[1] = T->a21 * s[0] + T->a22 * s[1] + T->ty;
+	 }
+      }
+      L->nv[L->npoly++] = np;
+      in->npoly++;
+   }
+   L->nxy += nv;
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* expands all instances of a reference */
+static fl_status
+emit_ref(fl_library_t *lib, const fl_options_t *opt, fl_result_t *res,
+         fl_ref_t *r, const affine_t *T, int depth)
+{
+   affine_t W;
+   double dc[2], dr[2], tb[4], ib[4], tx0, ty0;
+   fl_status st;
+   int i, j, i0, i1;
+
+   if (r->cell < 0) {
+      res->nmissing++;
+      return FL_OK;
+   }
+   if (r->absolute)
+      res->nabsolute++;
+   if (r->is_aref)
+      res->naref++;
+   else
+      res->nsref++;
+
+   /* transformation of the first instance and the lattice vectors
+      in the coordinates of the flattened structure */
+   affine_compose(&W, T, &r->T);
+   dc[0] = T->a11 * r->dcol[0] + T->a12 * r->dcol[1];
+   dc[1] = T->a21 * r->dcol[0] + T->a22 * r->dcol[1];
+   dr[0] = T->a11 * r->drow[0] + T->a12 * r->drow[1];
+   dr[1] = T->a21 * r->drow[0] + T->a22 * r->drow[1];
+   if (opt->has_window)
+      box_transform(tb, lib->cell[r->cell].bbox, &W);
+
+   tx0 = W.tx;
+   ty0 = W.ty;
+   for (j=0; j<r->nrow; j++) {
+
+      /* only the columns of the row that can overlap the window */
+      i0 = 0;
+      i1 = r->ncol - 1;
+      if (opt->has_window && !lattice_row(tb, dc, dr, j, r->ncol, opt->win, &i0, &i1))
+	 continue;
+
+      for (i=i0; i<=i1; i++) {
+	 W.tx = tx0 + i*dc[0] + j*dr[0];
+	 W.ty = ty0 + i*dc[1] + j*dr[1];
+	 if (opt->has_window) {
+	    ib[0] = tb[0] + W.tx - tx0;  ib[2] = tb[2] + W.tx - tx0;
+	    ib[1] = tb[1] + W.ty - ty0;  ib[3] = tb[3] + W.ty - ty0;
+	    if ( !box_overlap(ib, opt->win) )
+	       continue;
+	 }
+	 if ( (st = flatten_cell(lib, opt, res, r->cell, &W, depth+1)) )
+	    return st;
+      }
+   }
+
+   return FL_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static fl_status
+flatten_cell(fl_library_t *lib, const fl_options_t *opt, fl_result_t *res,
+             size_t k, const affine_t *T, int depth)
+{
+   fl_cell_t *c = &lib->cell[k];
+   fl_shape_t *sh;
+   fl_status st = FL_OK;
+   double tb[4];
+   size_t ms = 0, mr = 0;
+   int expand;
+
+   if (c->active || depth > MAX_DEPTH)
+      return FL_CYCLE;
+   c->active = 1;
+   if (depth > res->depth)
+      res->depth = depth;
+
+   /* references in structures below max_depth are not expanded */
+   expand = opt->max_depth < 0 || depth <= opt->max_depth;
+
+   /* shapes and references in the order of the elements */
+   while (ms < c->nsh || mr < c->nref) {
+
+      if (mr == c->nref || (ms < c->nsh && c->sh[ms].el < c->ref[mr].el)) {
+	 sh = &c->sh[ms++];
+	 if (opt->kinds && !(opt->kinds & (1u << sh->kind)))
+	    continue;
+	 if (opt->table && (sh->layer > 255 || sh->dtype > 255 ||
+	                    !opt->table[FL_TABLE_INDEX(sh->layer, sh->dtype)]))
+	    continue;
+	 if (opt->has_window) {
+	    box_transform(tb, sh->bbox, T);
+	    if ( !box_overlap(tb, opt->win) )
+	       continue;
+	 }
+	 if ( (st = emit_shape(res, c, k, sh, T,
+	                       opt->path_polygons && sh->kind == GDS_PATH)) )
+	    break;
+	 if (depth > 0)
+	    res->ncreated++;
+      }
+      else {
+	 if (expand && (st = emit_ref(lib, opt, res, &c->ref[mr], T, depth)))
+	    break;
+	 mr++;
+      }
+   }
+
+   c->active = 0;
+   return st;
+}
@@ -0,0 +1,267 @@
+/*
+ * Hierarchy flattening for GDSII libraries.
+ *
+ * The structures of a library are described by their shapes
+ * (boundary, path, box, text and node elements, each with one or
+ * more vertex lists) and their references. Flattening a structure
+ * composes the strans transformations of all references along each
+ * path through the hierarchy into affine transformations and writes
+ * the transformed vertices of all shapes into one contiguous vertex
+ * buffer per (layer, data type) pair. Array references are expanded
+ * in place; no copies of referenced structures are made.
+ *
+ * The functions do not use the MATLAB API and are shared by the
+ * mex function gds_flatten_mex and by the WebAssembly module.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _FLATTEN_H
+#define _FLATTEN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "gdstypes.h"
+
+
+/*
+ * affine transformation x' = a11*x + a12*y + tx, y' = a21*x + a22*y + ty
+ */
+typedef struct {
+   double a11, a12, a21, a22;
+   double tx, ty;
+} affine_t;
+
+
+/*
+ * a vertex list of a shape
+ */
+typedef struct {
+   size_t v;             /* first vertex */
+   size_t nv;            /* number of vertices */
+} fl_poly_t;
+
+
+/*
+ * a boundary, path, box, text, or node element
+ */
+typedef struct {
+   uint32_t el;          /* index of the element in the structure */
+   element_kind kind;
+   uint16_t layer;
+   uint16_t dtype;       /* data, text, node or box type */
+   double pad;           /* half width of paths, 0 otherwise */
+   double hw;            /* half width and path type of paths */
+   uint16_t ptype;
+   double ext[2];        /* begin and end extensions of type 4 paths */
+   size_t poly;          /* first vertex list */
+   size_t npoly;         /* number of vertex lists */
+   double bbox[4];       /* bounding box of the vertices plus pad */
+   int32_t olay;         /* output layer, -1 when not yet assigned */
+} fl_shape_t;
+
+
+/*
+ * an sref or aref element
+ */
+typedef struct {
+   uint32_t el;          /* index of the element in the structure */
+   int32_t cell;         /* referenced structure, -1 if missing */
+   affine_t T;           /* transformation of the (first) instance */
+   uint16_t ncol, nrow;  /* array dimensions, 1 x 1 for srefs */
+   double dcol[2];       /* column and row lattice vectors */
+   double drow[2];
+   int is_aref;
+   int absolute;         /* 1 if absmag or absang are set */
+} fl_ref_t;
+
+
+/*
+ * a structure
+ */
+typedef struct {
+   fl_shape_t *sh;  size_t nsh, ash;
+   fl_ref_t *ref;   size_t nref, aref;
+   fl_poly_t *poly; size_t npoly, apoly;
+   double *xy;      size_t nxy, axy;   /* x,y pairs */
+   double bbox[4];  /* bounding box of the flattened structure */
+   int bbox_state;  /* 0 = unknown, 1 = in progress, 2 = valid */
+   int active;      /* 1 while the structure is being flattened */
+} fl_cell_t;
+
+
+/*
+ * the structures of a library. References are stored as indices
+ * into the structure array.
+ */
+typedef struct {
+   fl_cell_t *cell;
+   size_t ncell;
+} fl_library_t;
+
+
+/*
+ * a layer table maps (layer, data type) pairs to the entries of a
+ * layer stack, which are numbered from 1; 0 means that the pair is
+ * not in the stack. The table is stored like a 256 x 256 MATLAB
+ * matrix indexed by (layer+1, dtype+1), i.e. in the same order as
+ * the layer_map of a layer configuration (gds_read_layer_config).
+ */
+#define FL_TABLE_SIZE  65536
+#define FL_TABLE_INDEX(layer, dtype)  ((size_t)(layer) + 256 * (size_t)(dtype))
+
+
+/*
+ * flattening options
+ */
+typedef struct {
+   int max_depth;        /* references below this depth are not expanded;
+                            -1 expands all references */
+   int has_window;       /* 1 if only shapes overlapping win are output */
+   double win[4];        /* window [llx,lly,urx,ury] */
+   unsigned int kinds;   /* bit mask of element kinds (1 << GDS_BOUNDARY,
+                            ...) that are output; 0 means all kinds */
+   int path_polygons;    /* 1 if paths are output as polygons (see
+                            pathpoly.h) instead of their center lines */
+   const uint16_t *table;  /* layer table (FL_TABLE_SIZE entries) or NULL;
+                              when set, only shapes on (layer, dtype)
+                              pairs with a stack entry are output */
+} fl_options_t;
+
+
+/*
+ * the vertices of all shapes on one (layer, data type) pair
+ */
+typedef struct {
+   uint16_t layer;
+   uint16_t dtype;
+   uint16_t entry;  /* layer stack entry; 0 without a layer table */
+   double *xy;      size_t nxy, axy;     /* x,y pairs */
+   uint32_t *nv;    size_t npoly, apoly; /* vertices of each polygon */
+} fl_layer_t;
+
+
+/*
+ * an instance of a shape in the flattened structure
+ */
+typedef struct {
+   uint32_t cell;        /* structure containing the shape */
+   uint32_t el;          /* index of the shape element in the structure */
+   uint32_t layer;       /* output layer */
+   size_t poly;          /* first polygon in the output layer */
+   uint32_t npoly;       /* number of polygons */
+   double mag;           /* accumulated magnification */
+} fl_instance_t;
+
+
+/*
+ * the result of flattening a structure
+ */
+typedef struct {
+   fl_layer_t *lay;     size_t nlay, alay;
+   fl_instance_t *ins;  size_t nins, ains;
+   size_t nsref;        /* expanded sref elements */
+   size_t naref;        /* expanded aref elements */
+   size_t ncreated;     /* shape instances from referenced structures */
+   size_t nmissing;     /* references to structures not in the library */
+   size_t nabsolute;    /* references with absmag or absang */
+   int depth;           /* maximum depth reached */
+} fl_result_t;
+
+
+typedef enum {FL_OK = 0, FL_MEMORY, FL_CYCLE, FL_ARGUMENT} fl_status;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * compose the transformation of a reference at position (x,y)
+ * from its strans record: reflection about the x-axis, then
+ * rotation, magnification and translation. has are the element
+ * property flags (HAS_STRANS, HAS_MAG, HAS_ANGLE).
+ */
+void affine_strans(affine_t *T, const strans_t *st, unsigned int has,
+                   double x, double y);
+
+/*
+ * R = P o C, i.e. C is applied first. R may be the same as P or C.
+ */
+void affine_compose(affine_t *R, const affine_t *P, const affine_t *C);
+
+/*
+ * allocate a library with ncell empty structures
+ */
+fl_status fl_library_init(fl_library_t *lib, size_t ncell);
+
+/*
+ * release the memory of a library
+ */
+void fl_library_free(fl_library_t *lib);
+
+/*
+ * append a shape (boundary, path, box, text, or node) described
+ * by the internal element data pe to a structure. The vertex lists
+ * of the shape are added with fl_add_vertices.
+ */
+fl_status fl_add_shape(fl_cell_t *c, uint32_t el, const element_t *pe);
+
+/*
+ * append a vertex list with n vertices to the last shape of a
+ * structure. The coordinates are x[k*stride], y[k*stride].
+ */
+fl_status fl_add_vertices(fl_cell_t *c, const double *x, const double *y,
+                          size_t n, size_t stride);
+
+/*
+ * append an sref or aref element to a structure. cell is the index
+ * of the referenced structure or -1 when it is not in the library;
+ * xy contains the x,y pairs of the reference position and, for
+ * arefs, of the column and row end points.
+ */
+fl_status fl_add_ref(fl_cell_t *c, uint32_t el, int32_t cell,
+                     const element_t *pe, const double *xy);
+
+/*
+ * flatten structure top. The result must be set to zero before it
+ * is used for the first time and is released with fl_result_free.
+ */
+fl_status fl_flatten(fl_library_t *lib, size_t top, const fl_options_t *opt,
+                     fl_result_t *res);
+
+/*
+ * bounding box [llx,lly,urx,ury] of structure k with all its
+ * references expanded. An empty structure has llx > urx.
+ */
+fl_status fl_cell_bbox(fl_library_t *lib, size_t k, double *bbox);
+
+/*
+ * bounding box of all instances of reference r in the coordinates
+ * of the structure that contains it. The box is empty when the
+ * referenced structure is missing or empty.
+ */
+fl_status fl_ref_bbox(fl_library_t *lib, const fl_ref_t *r, double *bbox);
+
+/*
+ * windows of all structures below structure top. lwin (4 x ncell)
+ * returns, for each structure, a box in its own coordinates that
+ * contains all parts of the structure that are visible through the
+ * window win of structure top. It is empty (llx > urx) when no
+ * instance of the structure overlaps the window. Array rows and
+ * columns outside the window are not visited.
+ */
+fl_status fl_window_cells(fl_library_t *lib, size_t top, const double *win,
+                          double *lwin);
+
+/*
+ * release the memory of a result
+ */
+void fl_result_free(fl_result_t *res);
+
+/*
+ * return a message describing a status code
+ */
+const char *fl_message(fl_status st);
+
+#endif /* _FLATTEN_H */
@@ -0,0 +1,429 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Finds regular arrays of identical boundaries and of identical
+ * structure references in the structures of a library and
+ * replaces them with array references (see arefcomp.h).
+ *
+ * [C, A, R] = gds_aref_compress_mex(E, uu_to_dbu, minrep, prefix);
+ *
+ * Input
+ * E :         cell array with one entry per structure; each entry
+ *             is a cell array with the element data structures of
+ *             the structure (see gds_element/write_data).
+ * uu_to_dbu : conversion factor from user units to database units
+ * minrep :    minimum number of elements replaced by an array
+ * prefix :    prefix of the names of new structures
+ *
+ * Output
+ * C :         structure array with the new structures, each with
+ *             one boundary element. C(k).sname is the structure
+ *             name and C(k).el the element data structure.
+ * A :         cell array with one entry per structure; A{k} is a
+ *             cell array with the data structures of the aref
+ *             elements that replace elements of structure k.
+ * R :         cell array with one logical row vector per structure
+ *             that is true for the elements replaced by arefs.
+ *
+ * Only boundaries with one polygon and srefs with one position
+ * that have no properties, elflags or plex are replaced. Two
+ * boundaries are identical when they have the same layer, data
+ * type, and vertices relative to the first vertex, in database
+ * units; an array of boundaries becomes an aref to a new structure
+ * with the boundary placed at the origin. Two srefs are identical
+ * when they have the same structure name and strans. The new
+ * structures are shared by all structures of the library.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "eldata.h"
+#include "mexfuncs.h"
+#include "arefcomp.h"
+
+#define KEY_POLY  0
+#define KEY_SREF  1
+#define NAMELEN   64
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int poly_key(mxArray *pe, const element_t *pel, double uu_to_dbu,
+                    int32_t **key, size_t *akey, size_t *nkey,
+                    int32_t *x, int32_t *y);
+static int sref_key(mxArray *pe, const element_t *pel, double uu_to_dbu,
+                    int32_t **key, size_t *akey, size_t *nkey,
+                    int32_t *x, int32_t *y);
+static int to_dbu(double v, double uu_to_dbu, int32_t *d);
+static mxArray *new_aref(const ac_array_t *pa, mxArray *pe, const char *sname,
+                         double uu_to_dbu);
+static mxArray *child_boundary(const int32_t *key, double uu_to_dbu);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   mxArray *ps, *pe, *internal, *pd, *pr, *pc;
+   ac_classes_t cl;
+   ac_item_t *it;
+   ac_array_t *arr;
+   element_t el;
+   int32_t *key, *child;
+   uint32_t *child_cls;
+   mxLogical *rm;
+   double uu_to_dbu;
+   unsigned int minrep;
+   size_t nst, nel, nit, narr, akey, nkey, nchild, nclass, achild;
+   size_t k, j, m;
+   uint32_t c;
+   int32_t x, y;
+   int ok;
+   char prefix[NAMELEN], name[NAMELEN];
+   const char *fields[] = {"sname", "el"};
+
+   /* check arguments */
+   if (nrhs != 4)
+      mexErrMsgTxt("gds_aref_compress_mex :  4 input arguments expected.");
+   if ( !mxIsCell(prhs[0]) )
+      mexErrMsgTxt("gds_aref_compress_mex :  first argument must be a cell array.");
+   uu_to_dbu = mxGetScalar(prhs[1]);
+   if (uu_to_dbu <= 0.0)
+      mexErrMsgTxt("gds_aref_compress_mex :  invalid unit conversion factor.");
+   minrep = (unsigned int)mxGetScalar(prhs[2]);
+   if ( !mxIsChar(prhs[3]) || mxGetString(prhs[3], prefix, NAMELEN-16) )
+      mexErrMsgTxt("gds_aref_compress_mex :  invalid structure name prefix.");
+
+   memset(&cl, 0, sizeof(ac_classes_t));
+   akey = 256;
+   key = mxMalloc(akey * sizeof(int32_t));
+   achild = 64;
+   child = mxMalloc(achild * sizeof(int32_t));        /* new structure of a class */
+   child_cls = mxMalloc(achild * sizeof(uint32_t));   /* class of a new structure */
+   nchild = nclass = 0;
+
+   nst = mxGetNumberOfElements(prhs[0]);
+   plhs[1] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+   plhs[2] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+
+   for (k=0; k<nst; k++) {
+
+      ps = mxGetCell(prhs[0], k);
+      nel = (ps == NULL) ? 0 : mxGetNumberOfElements(ps);
+      if (nel && !mxIsCell(ps))
+	 mexErrMsgTxt("gds_aref_compress_mex :  element data must be cell arrays.");
+      pr = mxCreateLogicalMatrix(1, nel);
+      rm = mxGetLogicals(pr);
+
+      /* classify the elements that can be replaced */
+      it = mxMalloc((nel ? nel : 1) * sizeof(ac_item_t));
+      nit = 0;
+      for (j=0; j<nel; j++) {
+	 pe = mxGetCell(ps, j);
+	 if ( pe == NULL || !get_field_ptr(pe, "internal", &internal) )
+	    mexErrMsgTxt("gds_aref_compress_mex :  missing internal element data.");
+	 memcpy(&el, mxGetData(internal), sizeof(element_t));
+
+	 if (el.has & (HAS_ELFLAGS | HAS_PLEX) || get_field_ptr(pe, "prop", &pc))
+	    continue;
+	 if (el.kind == GDS_BOUNDARY)
+	    ok = poly_key(pe, &el, uu_to_dbu, &key, &akey, &nkey, &x, &y);
+	 else if (el.kind == GDS_SREF)
+	    ok = sref_key(pe, &el, uu_to_dbu, &key, &akey, &nkey, &x, &y);
+	 else
+	    ok = 0;
+	 if ( !ok )
+	    continue;
+
+	 c = ac_class(&cl, key, nkey);
+	 if (c == UINT32_MAX)
+	    mexErrMsgTxt("gds_aref_compress_mex :  failed to allocate memory.");
+	 it[nit].cls = c;
+	 it[nit].x = x;
+	 it[nit].y = y;
+	 it[nit].item = (uint32_t)j;
+	 nit++;
+      }
+
+      /* classes found in this structure have no new structure yet */
+      if (cl.n > achild) {
+	 while (cl.n > achild)
+	    achild *= 2;
+	 child = mxRealloc(child, achild * sizeof(int32_t));
+	 child_cls = mxRealloc(child_cls, achild * sizeof(uint32_t));
+      }
+      for (; nclass<cl.n; nclass++)
+	 child[nclass] = -1;
+
+      /* find the arrays */
+      if ( ac_find_arrays(it, nit, minrep, &arr, &narr) )
+	 mexErrMsgTxt("gds_aref_compress_mex :  failed to allocate memory.");
+
+      pd = mxCreateCellMatrix(1, narr);
+      for (m=0; m<narr; m++) {
+	 pe = mxGetCell(ps, arr[m].item);
+	 c = arr[m].cls;
+	 if (cl.key[cl.off[c]] == KEY_POLY) {
+	    if (child[c] < 0) {
+	       child_cls[nchild] = c;
+	       child[c] = (int32_t)nchild++;
+	    }
+	    snprintf(name, NAMELEN, "%s%d", prefix, child[c] + 1);
+	    mxSetCell(pd, m, new_aref(&arr[m], pe, name, uu_to_dbu));
+	 }
+	 else
+	    mxSetCell(pd, m, new_aref(&arr[m], pe, NULL, uu_to_dbu));
+      }
+
+      for (m=0; m<nit; m++) {
+	 if (it[m].array >= 0)
+	    rm[it[m].item] = 1;
+      }
+
+      free(arr);
+      mxFree(it);
+      mxSetCell(plhs[1], k, pd);
+      mxSetCell(plhs[2], k, pr);
+   }
+
+   /* new structures */
+   plhs[0] = mxCreateStructMatrix(1, nchild, 2, fields);
+   for (m=0; m<nchild; m++) {
+      snprintf(name, NAMELEN, "%s%u", prefix, (unsigned int)(m+1));
+      mxSetFieldByNumber(plhs[0], m, 0, mxCreateString(name));
+      mxSetFieldByNumber(plhs[0], m, 1,
+                         child_boundary(cl.key + cl.off[child_cls[m]], uu_to_dbu));
+   }
+
+   ac_class_free(&cl);
+   mxFree(child_cls);
+   mxFree(child);
+   mxFree(key);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * key of a boundary with one polygon: layer, data type, number
+ * of vertices, and the vertices relative to the first vertex.
+ * Returns 0 when the boundary cannot be replaced.
+ */
+static int
+poly_key(mxArray *pe, const element_t *pel, double uu_to_dbu,
+         int32_t **key, size_t *akey, size_t *nkey,
+         int32_t *x, int32_t *y)
+{
+   mxArray *pxy;
+   double *pd;
+   size_t nv, k;
+   int32_t vx, vy;
+   int64_t dx, dy;
+
+   if ( !get_field_ptr(pe, "xy", &pxy) )
+      return 0;
+   if ( mxIsCell(pxy) ) {
+      if (mxGetNumberOfElements(pxy) != 1)
+	 return 0;
+      pxy = mxGetCell(pxy, 0);
+      if (pxy == NULL)
+	 return 0;
+   }
+   if ( !mxIsDouble(pxy) || mxGetN(pxy) != 2 || mxGetM(pxy) == 0 )
+      return 0;
+
+   nv = mxGetM(pxy);
+   pd = mxGetPr(pxy);
+   if (4 + 2*nv > *akey) {
+      while (4 + 2*nv > *akey)
+	 *akey *= 2;
+      *key = mxRealloc(*key, *akey * sizeof(int32_t));
+   }
+
+   if ( !to_dbu(pd[0], uu_to_dbu, x) || !to_dbu(pd[nv], uu_to_dbu, y) )
+      return 0;
+   (*key)[0] = KEY_POLY;
+   (*key)[1] = pel->layer;
+   (*key)[2] = pel->dtype;
+   (*key)[3] = (int32_t)nv;
+   for (k=0; k<nv; k++) {
+      if ( !to_dbu(pd[k], uu_to_dbu, &vx) || !to_dbu(pd[k+nv], uu_to_dbu, &vy) )
+	 return 0;
+      dx = (int64_t)vx - *x;
+      dy = (int64_t)vy - *y;
+      if (dx < INT32_MIN || dx > INT32_MAX || dy < INT32_MIN || dy > INT32_MAX)
+	 return 0;
+      (*key)[4+2*k]   = (int32_t)dx;
+      (*key)[4+2*k+1] = (int32_t)dy;
+   }
+   *nkey = 4 + 2*nv;
+
+   return 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * key of an sref with one position: strans and structure name.
+ * Returns 0 when the sref cannot be replaced.
+ */
+static int
+sref_key(mxArray *pe, const element_t *pel, double uu_to_dbu,
+         int32_t **key, size_t *akey, size_t *nkey,
+         int32_t *x, int32_t *y)
+{
+   mxArray *pxy, *psn;
+   char name[NAMELEN];
+   double mag, angle;
+   size_t len, n;
+
+   if ( !get_field_ptr(pe, "xy", &pxy) || !mxIsDouble(pxy) ||
+        mxGetNumberOfElements(pxy) != 2 )
+      return 0;
+   if ( !get_field_ptr(pe, "sname", &psn) || !mxIsChar(psn) ||
+        mxGetString(psn, name, NAMELEN) )
+      return 0;
+   if ( !to_dbu(mxGetPr(pxy)[0], uu_to_dbu, x) ||
+        !to_dbu(mxGetPr(pxy)[1], uu_to_dbu, y) )
+      return 0;
+
+   len = strlen(name);
+   n = 8 + (len + 3) / 4;
+   if (n > *akey) {
+      while (n > *akey)
+	 *akey *= 2;
+      *key = mxRealloc(*key, *akey * sizeof(int32_t));
+   }
+
+   mag = pel->has & HAS_MAG ? pel->strans.mag : 0.0;
+   angle = pel->has & HAS_ANGLE ? pel->strans.angle : 0.0;
+   memset(*key, 0, n * sizeof(int32_t));
+   (*key)[0] = KEY_SREF;
+   (*key)[1] = (int32_t)(pel->has & (HAS_STRANS | HAS_ANGLE | HAS_MAG));
+   (*key)[2] = pel->has & HAS_STRANS ? pel->strans.flags : 0;
+   memcpy(*key + 3, &mag, sizeof(double));
+   memcpy(*key + 5, &angle, sizeof(double));
+   (*key)[7] = (int32_t)len;
+   memcpy(*key + 8, name, len);
+   *nkey = n;
+
+   return 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * converts a coordinate to database units. Returns 0 when it
+ * is not a 32-bit integer.
+ */
+static int
+to_dbu(double v, double uu_to_dbu, int32_t *d)
+{
+   double t = floor(v * uu_to_dbu + 0.5);
+
+   if ( !(t >= INT32_MIN && t <= INT32_MAX) )
+      return 0;
+   *d = (int32_t)t;
+
+   return 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * data structure of an aref element. Arrays of srefs keep the
+ * structure name and strans of the sref pe; arrays of boundaries
+ * reference the structure sname.
+ */
+static mxArray *
+new_aref(const ac_array_t *pa, mxArray *pe, const char *sname,
+         double uu_to_dbu)
+{
+   element_t ael;
+   mxArray *ps, *pxy, *internal, *psn;
+   double *pd;
+   const char *fields[] = {"internal", "xy", "sname"};
+
+   if (sname == NULL) {
+      get_field_ptr(pe, "internal", &internal);
+      memcpy(&ael, mxGetData(internal), sizeof(element_t));
+      get_field_ptr(pe, "sname", &psn);
+      psn = mxDuplicateArray(psn);
+   }
+   else {
+      memset(&ael, 0, sizeof(element_t));
+      psn = mxCreateString(sname);
+   }
+   ael.kind = GDS_AREF;
+   ael.ncol = pa->ncol;
+   ael.nrow = pa->nrow;
+
+   /* origin and the corners of the first row and column */
+   pxy = mxCreateDoubleMatrix(3, 2, mxREAL);
+   pd = mxGetPr(pxy);
+   pd[0] = pa->x / uu_to_dbu;
+   pd[1] = ((double)pa->x + (double)pa->ncol * pa->dc) / uu_to_dbu;
+   pd[2] = pa->x / uu_to_dbu;
+   pd[3] = pa->y / uu_to_dbu;
+   pd[4] = pa->y / uu_to_dbu;
+   pd[5] = ((double)pa->y + (double)pa->nrow * pa->dr) / uu_to_dbu;
+
+   ps = mxCreateStructMatrix(1, 1, 3, fields);
+   mxSetFieldByNumber(ps, 0, 0, copy_element_to_array(&ael));
+   mxSetFieldByNumber(ps, 0, 1, pxy);
+   mxSetFieldByNumber(ps, 0, 2, psn);
+
+   return ps;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * data structure of the boundary in a new structure; the first
+ * vertex is at the origin
+ */
+static mxArray *
+child_boundary(const int32_t *key, double uu_to_dbu)
+{
+   element_t bel;
+   mxArray *ps, *pxy;
+   double *pd;
+   size_t nv, k;
+   const char *fields[] = {"internal", "xy"};
+
+   memset(&bel, 0, sizeof(element_t));
+   bel.kind = GDS_BOUNDARY;
+   bel.layer = (uint16_t)key[1];
+   bel.dtype = (uint16_t)key[2];
+
+   nv = (size_t)key[3];
+   pxy = mxCreateDoubleMatrix(nv, 2, mxREAL);
+   pd = mxGetPr(pxy);
+   for (k=0; k<nv; k++) {
+      pd[k]    = key[4+2*k] / uu_to_dbu;
+      pd[k+nv] = key[4+2*k+1] / uu_to_dbu;
+   }
+
+   ps = mxCreateStructMatrix(1, 1, 2, fields);
+   mxSetFieldByNumber(ps, 0, 0, copy_element_to_array(&bel));
+   mxSetFieldByNumber(ps, 0, 1, mxCreateCellMatrix(1, 1));
+   mxSetCell(mxGetFieldByNumber(ps, 0, 1), 0, pxy);
+
+   return ps;
+}
+
+/*-----------------------------------------------------------------*/
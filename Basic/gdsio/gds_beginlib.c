@@ -20,6 +20,7 @@
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 #define NLEN   256
 
@@ -134,6 +135,8 @@ mexFunction(int nlhs, mxArray *plhs[],
       mexErrMsgTxt("failed to write dbunit/uunit.");
    if ( write_real8(fob, dbunit[0]) )
       mexErrMsgTxt("failed to write dbunit.");
+
+   STATS_FLUSH();
 }
 
 /*-----------------------------------------------------------------*/
@@ -18,6 +18,7 @@
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 /*-----------------------------------------------------------------*/
 
@@ -61,6 +62,8 @@ mexFunction(int nlhs, mxArray *plhs[],
       mexErrMsgTxt("failed to write STRNAME record header.");
    if ( write_string(fob, sname, strlen(sname)) )
       mexErrMsgTxt("failed to write STRNAME record (sname).");
+
+   STATS_FLUSH();
 }
 
 /*-----------------------------------------------------------------*/
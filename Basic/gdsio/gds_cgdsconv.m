@@ -0,0 +1,72 @@
+function [st] = gds_cgdsconv(inpfil, outfil, bufsize)
+%function [st] = gds_cgdsconv(inpfil, outfil, bufsize)
+%
+% gds_cgdsconv :  converts a library file in compound GDSII format
+%                 (.cgds) to standard GDSII format. Boundaries and
+%                 paths with several polygons, and srefs with several
+%                 positions, are split into one element per polygon
+%                 or position. The file is converted record by record
+%                 without creating a library object; the memory
+%                 needed does not depend on the size of the file.
+%
+% inpfil :   name of the compound GDSII file
+% outfil :   (Optional) name of the output file. Default is the
+%            input file name with the extension .gds. An existing
+%            file is overwritten only when the file name begins
+%            with a '!'.
+% bufsize :  (Optional) size of the input and output stream buffers
+%            in bytes. Default is 4 MB.
+% st :       (Optional) structure with conversion statistics
+%              st.nel   : number of elements in the input file
+%              st.ncomp : number of compound elements
+%              st.nsplit: number of elements written for them
+%
+% Example:
+%          gds_cgdsconv('layout.cgds');  % writes layout.gds
+%
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 3, bufsize = []; end
+    if nargin < 2, outfil = []; end
+    if nargin < 1
+       error('gds_cgdsconv :  missing input file name.');
+    end
+    if isempty(bufsize), bufsize = 4194304; end
+
+    % output file name
+    if isempty(outfil)
+       [pnam, fnam] = fileparts(inpfil);
+       outfil = ['!', fullfile(pnam, [fnam, '.gds'])];
+    end
+    if outfil(1) == '!'
+       outfil = outfil(2:end);
+    elseif gds_file_exists(outfil)
+       error('gds_cgdsconv :  file %s exists; use ''!%s'' to overwrite it.', ...
+             outfil, outfil);
+    end
+    if strcmp(outfil, inpfil)
+       error('gds_cgdsconv :  input and output files must be different.');
+    end
+
+    % convert
+    fi = gds_open(inpfil, 'rb', bufsize);
+    fo = gds_open(outfil, 'wb', bufsize);
+    try
+       s = gds_cgdsconv_mex(fi, fo);
+    catch
+       gds_close(fi);
+       gds_close(fo);
+       error(lasterr);
+    end
+    gds_close(fi);
+    gds_close(fo);
+
+    if nargout
+       st.nel = s(1);
+       st.ncomp = s(2);
+       st.nsplit = s(3);
+    end
+
+end
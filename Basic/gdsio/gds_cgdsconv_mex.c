@@ -0,0 +1,68 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Converts a library in compound GDSII format (.cgds) to standard
+ * GDSII by splitting all compound elements. The library is copied
+ * record by record; only the records of one element are held in
+ * memory.
+ *
+ * st = gds_cgdsconv_mex(fi, fo);
+ *
+ * Input
+ * fi :     a file handle of the compound library returned by
+ *          gds_open, positioned at the beginning of the file
+ * fo :     a file handle of the output file returned by gds_open
+ *
+ * Output
+ * st :     1x3 vector with the number of elements in the input
+ *          library, the number of compound elements, and the
+ *          number of elements that were written for them.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mex.h"
+
+#include "mexfuncs.h"
+#include "cgdsconv.h"
+
+#define MSGLEN  256
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fin, *fob;
+   cgds_stats_t st;
+   const char *msg;
+   char buf[MSGLEN];
+   double *pd;
+
+   /* check arguments */
+   if (nrhs != 2)
+      mexErrMsgTxt("gds_cgdsconv_mex :  2 input arguments expected.");
+
+   /* get file handle arguments */
+   fin = get_file_ptr((mxArray *)prhs[0]);
+   fob = get_file_ptr((mxArray *)prhs[1]);
+
+   /* convert the library */
+   if ( (msg = cgds_convert(fin, fob, &st)) ) {
+      snprintf(buf, MSGLEN, "gds_cgdsconv_mex :  %s", msg);
+      mexErrMsgTxt(buf);
+   }
+
+   /* return the statistics */
+   plhs[0] = mxCreateDoubleMatrix(1, 3, mxREAL);
+   pd = mxGetPr(plhs[0]);
+   pd[0] = (double)st.nel;
+   pd[1] = (double)st.ncomp;
+   pd[2] = (double)st.nsplit;
+}
+
+/*-----------------------------------------------------------------*/
@@ -8,10 +8,15 @@
  * gds_close(gf);
  *
  * Input
- * gf :    a file handle returned by gds_open. 
+ * gf :    a file handle returned by gds_open. The stream buffer
+ *         allocated by gds_open, if any, is released. Compressed
+ *         and OASIS files are closed by gds_open (see there); when
+ *         an OASIS file cannot be written, the reason is reported.
  * 
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
@@ -23,6 +28,10 @@ mexFunction(int nlhs, mxArray *plhs[],
 	    int nrhs, const mxArray *prhs[])
 {
    FILE *fob;                  /* file object pointer */
+   char *buf = NULL;           /* stream buffer */
+   mxArray *pgf, *pmsg;
+   char msg[200];
+   char emsg[256];
 
    /* check argument number */
    if (nrhs != 1) {
@@ -31,10 +40,31 @@ mexFunction(int nlhs, mxArray *plhs[],
    
    /* get file handle argument */
    fob = get_file_ptr((mxArray *)prhs[0]);
+   if (mxGetNumberOfElements(prhs[0]) > 1)
+      memcpy(&buf, (FILE **)mxGetData(prhs[0]) + 1, sizeof(char *));
 
-   /* close file */
-   if ( fclose(fob) )
+   /* the functions of compressed and OASIS streams are in gds_open */
+   if (mxGetNumberOfElements(prhs[0]) > 2) {
+      pgf = (mxArray *)prhs[0];
+      msg[0] = '\0';
+      if ( !mexCallMATLAB(1, &pmsg, 1, &pgf, "gds_open") ) {
+	 mxGetString(pmsg, msg, sizeof(msg));
+	 mxDestroyArray(pmsg);
+      }
+      free(buf);
+      if (msg[0]) {
+	 snprintf(emsg, sizeof(emsg), "gds_close :  %s", msg);
+	 mexErrMsgTxt(emsg);
+      }
+      return;
+   }
+
+   /* close file; this flushes the buffer */
+   if ( fclose(fob) ) {
+      free(buf);
       mexErrMsgTxt("gds_close :  failed to close file.");
+   }
+   free(buf);
 }
 
 /*-----------------------------------------------------------------*/
@@ -15,6 +15,7 @@
 #include "mex.h"
 #include "mexfuncs.h"
 #include "gdsio.h"
+#include "gdsstats.h"
 
 /*-----------------------------------------------------------------*/
 
@@ -35,6 +36,8 @@ mexFunction(int nlhs, mxArray *plhs[],
    /* write record header */
    if ( write_record_hdr(fob, ENDLIB, 0) )
       mexErrMsgTxt("gds_endlib :  failed to write ENDLIB record.");
+
+   STATS_FLUSH();
 }
 
 /*-----------------------------------------------------------------*/
@@ -15,6 +15,7 @@
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 /*-----------------------------------------------------------------*/
 
@@ -35,6 +36,8 @@ mexFunction(int nlhs, mxArray *plhs[],
    /* write record header */
    if ( write_record_hdr(fob, ENDSTR, 0) )
       mexErrMsgTxt("gds_endstruct :  failed to write ENDSTR record.");
+
+   STATS_FLUSH();
 }
 
 /*-----------------------------------------------------------------*/
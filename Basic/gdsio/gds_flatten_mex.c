@@ -0,0 +1,247 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Flattens the hierarchy below a structure (see flatten.h). The
+ * transformations of all references are composed into affine
+ * transformations and the shapes of all referenced structures are
+ * written, transformed, into one vertex buffer per layer.
+ *
+ * [lay, ins, stats] = gds_flatten_mex(cells, names, top, max_depth, window, paths, table);
+ *
+ * Input:
+ * cells :     cell array with one entry per structure; each entry
+ *             is a cell array with the element data structures of
+ *             the structure (as returned by get(gelm) for an element
+ *             gelm).
+ * names :     cell array with the structure names
+ * top :       index of the structure that is flattened
+ * max_depth : (Optional) references in structures deeper than
+ *             max_depth are not expanded. Default is -1 (no limit).
+ * window :    (Optional) [llx,lly,urx,ury]; when not empty, only
+ *             shapes whose bounding box overlaps the window are
+ *             returned and references outside the window are skipped.
+ * paths :     (Optional) when > 0, paths are returned as closed
+ *             polygons (see pathpoly.h) instead of their center lines.
+ *             Default is 0.
+ * table :     (Optional) 256 x 256 layer table; table(layer+1, dtype+1)
+ *             is the layer stack entry of a (layer, data type) pair,
+ *             or 0 when the pair is not in the stack (see the
+ *             layer_map of gds_read_layer_config). When given, only
+ *             boundaries, boxes, and (with paths > 0) path polygons on
+ *             pairs with a stack entry are returned; the mapping is
+ *             done while the hierarchy is flattened.
+ *
+ * Output:
+ * lay :    structure array with one entry per layer and data type
+ *            lay(k).layer : layer number
+ *            lay(k).dtype : data type (text, node, or box type)
+ *            lay(k).xy    : V x 2 matrix with all vertices on the layer
+ *            lay(k).nv    : 1 x P vector with the number of vertices
+ *                           of each polygon in lay(k).xy
+ *            lay(k).entry : layer stack entry (0 without a table)
+ * ins :    N x 6 matrix with one row for each shape instance in
+ *          the flattened structure, in element order:
+ *          [structure, element, layer, first polygon, polygons, mag]
+ *          structure and element identify the element in cells,
+ *          layer is an index into lay, the polygons are counted
+ *          in lay(layer).nv, and mag is the magnification of
+ *          the instance.
+ * stats :  structure with the fields refs_resolved, arefs_resolved,
+ *          elements_created, max_depth_reached, missing_refs and
+ *          absolute_strans.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "mexfuncs.h"
+#include "flatlib.h"
+
+#define NLEN  256
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static mxArray *layers_to_array(fl_result_t *res);
+static mxArray *instances_to_array(fl_result_t *res);
+static mxArray *stats_to_array(fl_result_t *res);
+static void failed(const char *msg);
+
+static fl_library_t lib;
+static fl_result_t res;
+static uint16_t table[FL_TABLE_SIZE];
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   fl_options_t opt;
+   fl_status st;
+   const char *msg;
+   double *pd;
+   size_t nnames, top, k;
+
+   /* check arguments */
+   if (nrhs < 3)
+      mexErrMsgTxt("gds_flatten_mex :  at least 3 arguments required.");
+   if ( !mxIsCell(prhs[0]) || !mxIsCell(prhs[1]) )
+      mexErrMsgTxt("gds_flatten_mex :  cells and names must be cell arrays.");
+   nnames = mxGetNumberOfElements(prhs[1]);
+   if (mxGetNumberOfElements(prhs[0]) != nnames)
+      mexErrMsgTxt("gds_flatten_mex :  cells and names must have the same length.");
+   top = (size_t)mxGetScalar(prhs[2]);
+   if (top < 1 || top > nnames)
+      mexErrMsgTxt("gds_flatten_mex :  invalid top structure index.");
+   top--;
+
+   memset(&opt, 0, sizeof(fl_options_t));
+   opt.max_depth = -1;
+   if (nrhs > 3 && !mxIsEmpty(prhs[3]))
+      opt.max_depth = (int)mxGetScalar(prhs[3]);
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      if (mxGetNumberOfElements(prhs[4]) != 4)
+	 mexErrMsgTxt("gds_flatten_mex :  window must have 4 elements.");
+      pd = mxGetPr(prhs[4]);
+      opt.has_window = 1;
+      opt.win[0] = pd[0] < pd[2] ? pd[0] : pd[2];
+      opt.win[2] = pd[0] < pd[2] ? pd[2] : pd[0];
+      opt.win[1] = pd[1] < pd[3] ? pd[1] : pd[3];
+      opt.win[3] = pd[1] < pd[3] ? pd[3] : pd[1];
+   }
+   if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+      opt.path_polygons = mxGetScalar(prhs[5]) > 0;
+   if (nrhs > 6 && !mxIsEmpty(prhs[6])) {
+      if ( !mxIsDouble(prhs[6]) || mxGetNumberOfElements(prhs[6]) != FL_TABLE_SIZE )
+	 mexErrMsgTxt("gds_flatten_mex :  layer table must be a 256 x 256 matrix.");
+      pd = mxGetPr(prhs[6]);
+      for (k=0; k<FL_TABLE_SIZE; k++)
+	 table[k] = pd[k] > 0 && pd[k] < 65536 ? (uint16_t)pd[k] : 0;
+      opt.table = table;
+      opt.kinds = (1u << GDS_BOUNDARY) | (1u << GDS_BOX);
+      if (opt.path_polygons)
+	 opt.kinds |= 1u << GDS_PATH;
+   }
+
+   /* flatten the structure */
+   if ( (msg = fl_build_library(&lib, prhs[0], prhs[1])) )
+      failed(msg);
+   memset(&res, 0, sizeof(fl_result_t));
+   if ( (st = fl_flatten(&lib, top, &opt, &res)) )
+      failed(fl_message(st));
+
+   /* return results */
+   plhs[0] = layers_to_array(&res);
+   if (nlhs > 1)
+      plhs[1] = instances_to_array(&res);
+   if (nlhs > 2)
+      plhs[2] = stats_to_array(&res);
+
+   fl_result_free(&res);
+   fl_library_free(&lib);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+failed(const char *msg)
+{
+   char errmsg[NLEN];
+
+   fl_result_free(&res);
+   fl_library_free(&lib);
+   sprintf(errmsg, "gds_flatten_mex :  %s.", msg);
+   mexErrMsgTxt(errmsg);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*-----------------------------------------------------------------*/
+
+static mxArray *
+layers_to_array(fl_result_t *res)
+{
+   mxArray *pa, *pf;
+   fl_layer_t *L;
+   double *pd;
+   size_t k, m;
+   const char *fields[] = {"layer", "dtype", "xy", "nv", "entry"};
+
+   pa = mxCreateStructMatrix(1, res->nlay, 5, fields);
+   for (k=0; k<res->nlay; k++) {
+      L = &res->lay[k];
+      mxSetFieldByNumber(pa, k, 0, mxCreateDoubleScalar(L->layer));
+      mxSetFieldByNumber(pa, k, 1, mxCreateDoubleScalar(L->dtype));
+
+      pf = mxCreateDoubleMatrix(L->nxy, 2, mxREAL);
+      pd = mxGetPr(pf);
+      for (m=0; m<L->nxy; m++) {
+	 pd[m] = L->xy[2*m];
+	 pd[L->nxy + m] = L->xy[2*m+1];
+      }
+      mxSetFieldByNumber(pa, k, 2, pf);
+
+      pf = mxCreateDoubleMatrix(1, L->npoly, mxREAL);
+      pd = mxGetPr(pf);
+      for (m=0; m<L->npoly; m++)
+	 pd[m] = L->nv[m];
+      mxSetFieldByNumber(pa, k, 3, pf);
+      mxSetFieldByNumber(pa, k, 4, mxCreateDoubleScalar(L->entry));
+   }
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray *
+instances_to_array(fl_result_t *res)
+{
+   mxArray *pa;
+   double *pd;
+   size_t k, n = res->nins;
+
+   pa = mxCreateDoubleMatrix(n, 6, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<n; k++) {
+      pd[k]       = res->ins[k].cell + 1;
+      pd[n + k]   = res->ins[k].el + 1;
+      pd[2*n + k] = res->ins[k].layer + 1;
+      pd[3*n + k] = res->ins[k].poly + 1;
+      pd[4*n + k] = res->ins[k].npoly;
+      pd[5*n + k] = res->ins[k].mag;
+   }
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray *
+stats_to_array(fl_result_t *res)
+{
+   mxArray *pa;
+   const char *fields[] = {"refs_resolved", "arefs_resolved", "elements_created",
+			   "max_depth_reached", "missing_refs", "absolute_strans"};
+
+   pa = mxCreateStructMatrix(1, 1, 6, fields);
+   mxSetFieldByNumber(pa, 0, 0, mxCreateDoubleScalar(res->nsref));
+   mxSetFieldByNumber(pa, 0, 1, mxCreateDoubleScalar(res->naref));
+   mxSetFieldByNumber(pa, 0, 2, mxCreateDoubleScalar(res->ncreated));
+   mxSetFieldByNumber(pa, 0, 3, mxCreateDoubleScalar(res->depth));
+   mxSetFieldByNumber(pa, 0, 4, mxCreateDoubleScalar(res->nmissing));
+   mxSetFieldByNumber(pa, 0, 5, mxCreateDoubleScalar(res->nabsolute));
+
+   return pa;
+}
@@ -0,0 +1,50 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026 (based on gds_ftell.c, Copyright (c) 2013, Ulf Griesmann)
+ *
+ * Description:
+ * Sets the position of the file pointer
+ * 
+ * gds_fseek(gf, fpos);
+ *
+ * Input
+ * gf :    a file handle returned by gds_open.
+ * fpos :  the new file position (e.g. from gds_library_index)
+ * 
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include "gdsio.h"
+#include "mex.h"
+#include "mexfuncs.h"
+
+/*-----------------------------------------------------------------*/
+
+void 
+mexFunction(int nlhs, mxArray *plhs[], 
+	    int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;         /* file object pointer */
+   double *pd;
+
+   /* 
+    * check argument number 
+    */
+   if (nrhs != 2)
+      mexErrMsgTxt("expected 2 input arguments.");
+   
+   /* 
+    * get file handle argument 
+    */
+   fob = get_file_ptr((mxArray *)prhs[0]);
+
+   /*
+    * set file position
+    */
+   pd = mxGetData(prhs[1]);
+   if ( fseek(fob, (long int)pd[0], SEEK_SET) < 0 )
+      mexErrMsgTxt("failed to set file position with fseek().");
+}
+
+/*-----------------------------------------------------------------*/
@@ -1,5 +1,5 @@
-function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts)
-%function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts)
+function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts, bufsize)
+%function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts, bufsize)
 %
 % gds_initialize : this function creates a new file in GDSII stream
 %                  format and writes the header section of the file.
@@ -16,6 +16,8 @@ function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts)
 % reflibs : (Optional) cell array of strings with names of 
 %           referenced libraries. Strings must have <= 44
 % fonts :  (Optional) cell array of strings with font names (up to 4).
+% bufsize : (Optional) size of the output buffer in bytes. Default
+%           is 0 (use the buffer of the C library).
 %
 
 % Initial version: Ulf Griesmann, NIST, January 2008
@@ -35,6 +37,7 @@ function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts)
     global gdsii_dbunit;
 
     % check parameters
+    if nargin < 7, bufsize = 0; end
     if isempty(uunit), uunit = 1.0e-6; end
     if isempty(dbunit), dbunit = 1.0e-9; end
 
@@ -79,7 +82,7 @@ function [gf] = gds_initialize(fname, uunit, dbunit, lname, reflibs, fonts)
     end
 
     % open the library file
-    gf = gds_open(fname, 'wb'); % the 'b' is for Windows
+    gf = gds_open(fname, 'wb', bufsize); % the 'b' is for Windows
     
     % write the HEADER record (format version 7 permits 8192 polygon vertices)
     gds_beginlib(gf, uunit, dbunit, lname, reflibs, fonts);
@@ -0,0 +1,91 @@
+function [S] = gds_layer_stats(gdsname, sname, nthreads)
+%function [S] = gds_layer_stats(gdsname, sname, nthreads)
+%
+% gds_layer_stats :  computes the number of elements, vertices,
+%                    and the area on each (layer, data type) pair
+%                    of a GDSII file, both flat (each element counted
+%                    once) and hierarchical (each element counted
+%                    once for every instance of its structure). No
+%                    element objects are created; the statistics of
+%                    the structures are computed in parallel while
+%                    the file is read (see gds_read_library_mex).
+%
+% gdsname :   name of a GDSII file
+% sname :     (Optional) name of the top structure. When given, only
+%             the structures in its subtree are read (the structure
+%             offsets are taken from the structure index of the file,
+%             see gds_library_index), and the hierarchical statistics
+%             count the instances below this structure. Default is
+%             all structures that are not referenced.
+% nthreads :  (Optional) number of threads. Default is the number of
+%             processors.
+% S :         (Optional) a structure with the fields
+%               S.layer :  K x 1 layers
+%               S.dtype :  K x 1 data types
+%               S.flat :   K x 7 matrix with the number of boundary,
+%                          path, box, node, and text elements, the
+%                          number of vertices, and the element area
+%                          in user units^2 on each (layer, data type)
+%               S.hier :   K x 7 matrix, as S.flat, with the elements
+%                          counted once for every instance
+%               S.names :  names of the structures
+%               S.inst :   number of instances of each structure
+%             When the output argument is omitted, the statistics
+%             are printed on the screen.
+%
+% NOTES:
+% - All 65536 layers and data types are supported.
+% - Areas are the sum of the areas of boundaries, boxes, and the
+%   polygons of paths. Overlapping elements are not merged.
+%
+% Example:
+%          S = gds_layer_stats('chip.gds', 'TOP');
+%          k = S.layer == 31 & S.dtype == 0;
+%          fprintf('%d boundaries on 31/0\n', S.hier(k,1));
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 3, nthreads = []; end
+    if nargin < 2, sname = []; end
+    if nargin < 1
+        error('gds_layer_stats :  missing file name.');
+    end
+
+    if ~gds_file_exists(gdsname)
+        if gds_file_exists([gdsname,'.gds'])
+            gdsname = [gdsname, '.gds'];
+        else
+            error('gds_layer_stats :  input file does not exist.');
+        end
+    end
+
+    % structure offsets when only a subtree is read
+    offsets = [];
+    if ~isempty(sname)
+        idx = gds_library_index(gdsname, sname);
+        offsets = [idx.offset];
+    end
+
+    gf = gds_open(gdsname, 'rb');
+    ldata = gds_libdata(gf);
+    S = gds_read_library_mex(gf, ldata.uunit, ldata.dbunit, [], 0, offsets, nthreads, ...
+                             [], [], sname, [], 1);
+    gds_close(gf);
+
+    % display
+    if ~nargout
+        names = {'Bnd','Pth','Box','Nde','Txt'};
+        fprintf('\n   Layer/Dtype      Elements (flat / hierarchical)\n');
+        for k = 1:numel(S.layer)
+            fprintf('   L %5d / %-5d ->  ', S.layer(k), S.dtype(k));
+            for c = find(S.flat(k,1:5))
+                fprintf('%s %d / %d  ', names{c}, S.flat(k,c), S.hier(k,c));
+            end
+            fprintf(' Area %g / %g\n', S.flat(k,7), S.hier(k,7));
+        end
+        fprintf('\n');
+        clear S
+    end
+
+end
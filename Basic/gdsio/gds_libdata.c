@@ -26,6 +26,7 @@
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 #define NLEN   256
 #define TLEN   64
@@ -112,6 +113,7 @@ mexFunction(int nlhs, mxArray *plhs[],
 	       mexErrMsgTxt("gds_libdata :  failed to read DBUNIT.");
 	    struct_set_float(plhs[0], 4, dbunit / uunit); /* actual user unit */
 	    struct_set_float(plhs[0], 5, dbunit);
+	    STATS_FLUSH();
 	    return;  /* last record in header */
 
          case REFLIBS:
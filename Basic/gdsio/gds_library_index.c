@@ -0,0 +1,228 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Returns the structure index (table of contents) of a GDSII
+ * library file. The index is stored in a sidecar file with the
+ * extension '.idx'. It is rebuilt when the size or the modification
+ * time of the library file have changed, or when the structures
+ * are no longer found at the positions recorded in the index.
+ *
+ * [idx] = gds_library_index(gdsname, sname, rebuild);
+ *
+ * Input
+ * gdsname : name of a GDSII library file
+ * sname :   (Optional) name of a structure. When given, only the index
+ *           entries of this structure and of all structures in its
+ *           subtree are returned.
+ * rebuild : (Optional) ignore an existing index file when > 0.
+ *           Default is 0.
+ *
+ * Output:
+ * idx :     structure array with one entry per structure in file order
+ *             idx(k).sname  : structure name
+ *             idx(k).offset : file position of the BGNSTR record
+ *             idx(k).nbytes : length of the structure in bytes
+ *             idx(k).nel    : number of elements
+ *             idx(k).refs   : cell array with referenced structure names
+ *             idx(k).layers : layers used in the structure
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gdsio.h"
+#include "mapio.h"
+#include "libindex.h"
+#include "gdsstream.h"
+#include "mex.h"
+#include "mexfuncs.h"
+
+#define FNAME_LEN   1024
+#define SNAME_LEN   256
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static void subtree(lib_index_t *li, int top, char *mark);
+static mxArray* index_entry_refs(struct_index_t *si);
+static mxArray* index_entry_layers(struct_index_t *si);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;
+   mxArray *pidx;
+   lib_index_t li;
+   map_file_t mf;
+   uint64_t fsize;
+   int64_t mtime;
+   char fname[FNAME_LEN];
+   char iname[FNAME_LEN+4];
+   char sname[SNAME_LEN];
+   char *mark = NULL;
+   stream_kind kind;
+   double *pd;
+   int rebuild = 0;
+   int nidx, top, k, n;
+   const char *fields[] = {"sname", "offset", "nbytes", "nel", "refs", "layers"};
+
+
+   /* check arguments */
+   if (nrhs < 1)
+      mexErrMsgTxt("gds_library_index :  at least 1 input argument expected.");
+   if ( mxGetString(prhs[0], fname, FNAME_LEN) )
+      mexErrMsgTxt("gds_library_index :  failed to access file name argument.");
+   sname[0] = '\0';
+   if (nrhs > 1 && !mxIsEmpty(prhs[1])) {
+      if ( mxGetString(prhs[1], sname, SNAME_LEN) )
+	 mexErrMsgTxt("gds_library_index :  failed to access structure name argument.");
+   }
+   if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+      pd = mxGetData(prhs[2]);
+      rebuild = pd[0] > 0;
+   }
+
+   /* library file size and time stamp */
+   if ( index_stat(fname, &fsize, &mtime) )
+      mexErrMsgTxt("gds_library_index :  could not access library file.");
+   strcpy(iname, fname);
+   strcat(iname, ".idx");
+   fob = stream_open(fname, "rb", &kind);
+   if (fob == NULL)
+      mexErrMsgTxt("gds_library_index :  could not open library file.");
+
+   /* try the sidecar file first */
+   memset(&li, 0, sizeof(lib_index_t));
+   if ( rebuild || index_load(&li, iname, fsize, mtime) || index_verify(&li, fob) ) {
+
+      /* scan the library */
+      index_free(&li);
+      if ( fseek(fob, 0L, SEEK_SET) < 0 ) {
+	 fclose(fob);
+	 mexErrMsgTxt("gds_library_index :  could not rewind library file.");
+      }
+      if ( map_open(&mf, fob) ) {
+	 fclose(fob);
+	 mexErrMsgTxt("gds_library_index :  failed to map file into memory.");
+      }
+      if ( index_build(&li, &mf) ) {
+	 map_close(&mf, NULL);
+	 fclose(fob);
+	 index_free(&li);
+	 mexErrMsgTxt("gds_library_index :  failed to scan library file.");
+      }
+      map_close(&mf, NULL);
+
+      /* save it; failure is not an error (e.g. read-only directory) */
+      li.fsize = fsize;
+      li.mtime = mtime;
+      index_save(&li, iname);
+   }
+   fclose(fob);
+
+   /* select the structures in the subtree */
+   if ( sname[0] ) {
+      top = index_find(&li, sname);
+      if (top < 0) {
+	 index_free(&li);
+	 mexErrMsgTxt("gds_library_index :  structure not found in library.");
+      }
+      mark = mxCalloc(li.nstruct, sizeof(char));
+      subtree(&li, top, mark);
+      for (nidx=0,k=0; k<(int)li.nstruct; k++)
+	 nidx += mark[k];
+   }
+   else
+      nidx = li.nstruct;
+
+   /* return the index */
+   pidx = mxCreateStructMatrix(1,nidx, 6, fields);
+   for (n=0,k=0; k<(int)li.nstruct; k++) {
+      if (mark && !mark[k])
+	 continue;
+      mxSetFieldByNumber(pidx, n, 0, mxCreateString(li.st[k].sname));
+      mxSetFieldByNumber(pidx, n, 1, mxCreateDoubleScalar((double)li.st[k].offset));
+      mxSetFieldByNumber(pidx, n, 2, mxCreateDoubleScalar((double)li.st[k].nbytes));
+      mxSetFieldByNumber(pidx, n, 3, mxCreateDoubleScalar((double)li.st[k].nel));
+      mxSetFieldByNumber(pidx, n, 4, index_entry_refs(&li.st[k]));
+      mxSetFieldByNumber(pidx, n, 5, index_entry_layers(&li.st[k]));
+      n++;
+   }
+   index_free(&li);
+
+   plhs[0] = pidx;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * marks all structures in the subtree of structure top
+ */
+static void
+subtree(lib_index_t *li, int top, char *mark)
+{
+   int *stack;
+   int ns, k, j;
+   struct_index_t *si;
+
+   stack = mxMalloc(li->nstruct*sizeof(int));
+   ns = 0;
+   stack[ns++] = top;
+   mark[top] = 1;
+
+   while (ns) {
+      si = &li->st[stack[--ns]];
+      for (j=0; j<(int)si->nref; j++) {
+	 k = si->rsi[j];
+	 if (k >= 0 && !mark[k]) {  /* ignore external references */
+	    mark[k] = 1;
+	    stack[ns++] = k;
+	 }
+      }
+   }
+
+   mxFree(stack);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray*
+index_entry_refs(struct_index_t *si)
+{
+   mxArray *pc;
+   uint32_t k;
+
+   pc = mxCreateCellMatrix(1, si->nref);
+   for (k=0; k<si->nref; k++)
+      mxSetCell(pc, k, mxCreateString(si->refs[k]));
+
+   return pc;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray*
+index_entry_layers(struct_index_t *si)
+{
+   mxArray *pa;
+   double *pd;
+   uint32_t k;
+
+   pa = mxCreateDoubleMatrix(1, si->nlay, mxREAL);
+   pd = mxGetData(pa);
+   for (k=0; k<si->nlay; k++)
+      pd[k] = (double)si->layers[k];
+
+   return pa;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,87 @@
+function [R] = gds_merge(outfil, inpfil, top, uunit, dbunit, libnam)
+%function [R] = gds_merge(outfil, inpfil, top, uunit, dbunit, libnam)
+%
+% gds_merge :  merges two or more GDSII library files into one file.
+%              The structures are copied from the input files without
+%              decoding the elements, which is much faster than
+%              reading and writing the libraries and works for files
+%              of any size. Only the records that must change are
+%              rewritten: structure names (STRNAME, SNAME) when a
+%              name is already used by an earlier input file, and
+%              coordinates (XY, WIDTH, BGNEXTN, ENDEXTN) when the
+%              database unit of an input file differs from the
+%              database unit of the output file.
+%
+% outfil :  name of the output file. An existing file is renamed
+%           unless the file name begins with a '!' (see
+%           gds_initialize).
+% inpfil :  cell array with the names of the input files
+% top :     (Optional) name of a new top level structure with
+%           references to the top level structures of all input
+%           files. Default is no new top level structure.
+% uunit :   (Optional) user unit of the output file in m. Default
+%           is the user unit of the first input file.
+% dbunit :  (Optional) database unit of the output file in m.
+%           Default is the database unit of the first input file.
+% libnam :  (Optional) library name. Default is the output file name.
+% R :       (Optional) structure array with the renamed structures
+%             R(k).file : index of the input file in inpfil
+%             R(k).old  : original structure name
+%             R(k).new  : new structure name
+%           A structure is renamed to NAME_n, where n is the
+%           smallest positive integer for which the name is unique.
+%           When the output argument is omitted, the renamed
+%           structures are printed on the screen.
+%
+% NOTE: the structure offsets are taken from the structure index
+% sidecar file of an input file when it is up to date (see
+% gds_library_index), otherwise the input file is scanned.
+%
+% Example:
+%          gds_merge('chip.gds', {'block1.gds','block2.gds'}, 'CHIP');
+
+% Initial version, October 2026
+
+    % check arguments
+    if nargin < 6, libnam = []; end
+    if nargin < 5, dbunit = []; end
+    if nargin < 4, uunit = []; end
+    if nargin < 3, top = []; end
+    if nargin < 2
+       error('gds_merge :  at least two input arguments required.');
+    end
+    if ischar(inpfil), inpfil = {inpfil}; end
+    if isempty(inpfil)
+       error('gds_merge :  no input files.');
+    end
+
+    % default units are those of the first library
+    if isempty(uunit) || isempty(dbunit)
+       fi = gds_open(inpfil{1}, 'rb');
+       ldata = gds_libdata(fi);
+       gds_close(fi);
+       if isempty(uunit), uunit = ldata.uunit; end
+       if isempty(dbunit), dbunit = ldata.dbunit; end
+    end
+
+    % copy the structures
+    gf = gds_initialize(outfil, uunit, dbunit, libnam, [], []);
+    try
+       S = gds_merge_mex(gf, inpfil, dbunit, top);
+    catch
+       gds_close(gf);
+       error(lasterr);
+    end
+    gds_endlib(gf);
+    gds_close(gf);
+
+    % return or display renamed structures
+    if nargout
+       R = S;
+    else
+       for k = 1:length(S)
+          fprintf('%s :  %s --> %s\n', inpfil{S(k).file}, S(k).old, S(k).new);
+       end
+    end
+
+end
@@ -0,0 +1,115 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Copies the structures of several GDSII library files to an
+ * output file without decoding the elements.
+ *
+ * R = gds_merge_mex(gf, files, dbunit, top);
+ *
+ * Input
+ * gf :     a file handle returned by gds_initialize
+ * files :  cell array with the names of the input files
+ * dbunit : database unit of the output file in m. Coordinates
+ *          of libraries with a different database unit are
+ *          rescaled.
+ * top :    (Optional) name of a new top level structure with
+ *          references to the top level structures of all input
+ *          libraries. No top level structure is written when
+ *          top is empty.
+ *
+ * Output
+ * R :      structure array with the renamed structures
+ *            R(k).file : index of the input file
+ *            R(k).old  : original structure name
+ *            R(k).new  : new structure name
+ *
+ * Structures with a name that is already used in an earlier
+ * input file are renamed (see gdsmerge.h). The library header
+ * and the ENDLIB record must be written by the caller.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mex.h"
+
+#include "mexfuncs.h"
+#include "gdsmerge.h"
+
+#define MSGLEN  256
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;
+   mxArray *pa;
+   merge_t mg;
+   const char **fnames;
+   const char *msg;
+   char *top = NULL;
+   char buf[MSGLEN];
+   int nfiles, k;
+   const char *fields[] = {"file", "old", "new"};
+
+   /* check arguments */
+   if (nrhs < 3)
+      mexErrMsgTxt("gds_merge_mex :  at least 3 input arguments expected.");
+   if ( !mxIsCell(prhs[1]) )
+      mexErrMsgTxt("gds_merge_mex :  file names must be a cell array.");
+
+   /* get file handle argument */
+   fob = get_file_ptr((mxArray *)prhs[0]);
+
+   /* input files */
+   nfiles = (int)mxGetNumberOfElements(prhs[1]);
+   fnames = mxCalloc(nfiles ? nfiles : 1, sizeof(char *));
+   for (k=0; k<nfiles; k++) {
+      pa = mxGetCell(prhs[1], k);
+      if (pa == NULL || !mxIsChar(pa))
+	 mexErrMsgTxt("gds_merge_mex :  file names must be strings.");
+      fnames[k] = mxArrayToString(pa);
+   }
+
+   /* output units and top structure */
+   memset(&mg, 0, sizeof(merge_t));
+   mg.dbunit = ((double *)mxGetData(prhs[2]))[0];
+   if (mg.dbunit <= 0.0)
+      mexErrMsgTxt("gds_merge_mex :  database unit must be > 0.");
+   if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+      if ( !mxIsChar(prhs[3]) )
+	 mexErrMsgTxt("gds_merge_mex :  top structure name must be a string.");
+      top = mxArrayToString(prhs[3]);
+      mg.top = top;
+   }
+
+   /* copy the structures */
+   msg = merge_libraries(fob, fnames, nfiles, &mg);
+
+   for (k=0; k<nfiles; k++)
+      mxFree((void *)fnames[k]);
+   mxFree(fnames);
+   if (top)
+      mxFree(top);
+
+   if (msg) {
+      merge_free(&mg);
+      snprintf(buf, MSGLEN, "gds_merge_mex :  %s", msg);
+      mexErrMsgTxt(buf);
+   }
+
+   /* return the renamed structures */
+   plhs[0] = mxCreateStructMatrix(1, mg.nren, 3, fields);
+   for (k=0; k<(int)mg.nren; k++) {
+      mxSetFieldByNumber(plhs[0], k, 0, mxCreateDoubleScalar((double)(mg.ren[k].file + 1)));
+      mxSetFieldByNumber(plhs[0], k, 1, mxCreateString(mg.ren[k].oname));
+      mxSetFieldByNumber(plhs[0], k, 2, mxCreateString(mg.ren[k].nname));
+   }
+   merge_free(&mg);
+}
+
+/*-----------------------------------------------------------------*/
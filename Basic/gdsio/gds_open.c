@@ -3,19 +3,48 @@
  * Copyright (c) 2012, Ulf Griesmann
  *
  * Description:
- * Opens a GDSII library file for reading or writing.
+ * Opens a GDSII library file for reading or writing. Library files
+ * compressed with gzip or zstd are decompressed (compressed) on the
+ * fly when the mex function was compiled with HAVE_ZLIB or HAVE_ZSTD
+ * (see gdsstream.h). Compressed files are recognized by their content
+ * when reading and by the file name extension ('.gz', '.zst') when
+ * writing. OASIS files (extension '.oas' when writing) are converted
+ * from and to GDSII libraries in temporary files (see oasis.h).
  * 
- * [gf,size] = gds_open(name, mode);
+ * [gf,size] = gds_open(name, mode, bufsize);
+ * msg = gds_open(gf);
  *
  * Input:
- * name :  string with file name.
- * mode :  string specifying the open mode, either 'rb' or 'wb'. 
+ * name :    string with file name.
+ * mode :    string specifying the open mode, either 'rb' or 'wb'. 
+ * bufsize : (Optional) size of the stream buffer in bytes. Records
+ *           are collected in the buffer and written to the file in
+ *           blocks of this size. A large buffer (several MB) speeds
+ *           up writing of large libraries. Default is 0 (use the
+ *           buffer of the C library).
  *
  * Output:
  * gf :    a file handle (actually a FILE *, stored in a 4 byte 
  *         or 8 byte integer variable, depending on architecture).
+ *         When a buffer was allocated, gf has a second element with
+ *         a pointer to the buffer, which is released by gds_close.
+ *         For compressed files, and for OASIS files opened for
+ *         writing, gf has a third element with the format of the
+ *         file (see gdsstream.h); the second element is 0 when no
+ *         buffer was allocated. For compressed files, a fourth
+ *         element holds the descriptor of the compressed file, from
+ *         which the progress of reading is computed.
  * size :  the file size in bytes; it is returned only when a file
- *         is opened for reading.
+ *         is opened for reading. For compressed files this is the
+ *         size of the compressed file, for OASIS files the size of
+ *         the converted GDSII library.
+ *
+ * The second form is called by gds_close to close a compressed or
+ * OASIS file. The functions of these streams are part of this mex
+ * function, which stays locked in memory until all of them were
+ * closed. The stream buffer is not released.
+ * msg :   empty string, or the reason why the file could not be
+ *         closed, e.g. when an OASIS file could not be written.
  * 
  * NOTE:
  * This function bypasses the Octave (MATLAB) file i/o functions. It is
@@ -23,14 +52,24 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include "gdsio.h"
+#include "gdsstream.h"
 #include "mex.h"
 
 #define FNAME_LEN   256
 #define MODE_LEN    4
 
 
+/*-- Local Functions ----------------------------------------------*/
+
+static mxArray *close_stream(const mxArray *pgf);
+
+
 /*-----------------------------------------------------------------*/
 
 void 
@@ -39,17 +78,32 @@ mexFunction(int nlhs, mxArray *plhs[],
 {
    FILE *fob;                  /* file object pointer */
    FILE **pfob;                /* pointer to fob */
+   char *buf = NULL;           /* stream buffer */
+   const char *msg;
+   char emsg[256];
+   int nel, cookie;
+   stream_kind kind;           /* compression */
+   struct stat st;
+   size_t bufsize = 0;
    double *pd;
    long int fsize;
    char fname[FNAME_LEN];      /* file name */
    char mode[MODE_LEN];        /* string with polygon operation */
 
 
+   /*
+    * close a stream opened by this function
+    */
+   if (nrhs == 1 && !mxIsChar(prhs[0])) {
+      plhs[0] = close_stream(prhs[0]);
+      return;
+   }
+
    /* 
     * check argument number 
     */
-   if (nrhs != 2)
-      mexErrMsgTxt("expected 2 input arguments.");
+   if (nrhs < 2 || nrhs > 3)
+      mexErrMsgTxt("expected 2 or 3 input arguments.");
    
    /* 
     * get file name argument 
@@ -65,34 +119,88 @@ mexFunction(int nlhs, mxArray *plhs[],
    if ( (mode[0] != 'r') && (mode[0] != 'w') )
       mexErrMsgTxt("mode must be either r or w.");
 
+   /* 
+    * get buffer size argument 
+    */
+   if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+      pd = (double *)mxGetData(prhs[2]);
+      if (pd[0] > 0)
+	 bufsize = (size_t)pd[0];
+   }
+
    /* 
     * open the file 
     */
-   fob = fopen(fname, mode);
+   fob = stream_open(fname, mode, &kind);
    if (fob == NULL) {
       mexPrintf("gds_open: file >> %s <<\n", fname);
+      if (kind == STREAM_OASIS) {
+	 if ( (msg = stream_error()) ) {
+	    snprintf(emsg, sizeof(emsg), "could not convert OASIS file: %s", msg);
+	    mexErrMsgTxt(emsg);
+	 }
+	 mexErrMsgTxt("could not open or convert OASIS file.");
+      }
+      if (kind != STREAM_PLAIN)
+	 mexErrMsgTxt("could not open compressed file (not supported by this build?).");
       mexErrMsgTxt("could not open file.");
    }
 
+   /*
+    * install the stream buffer. The buffer must outlive this
+    * function and is allocated with malloc, not mxMalloc.
+    */
+   if (bufsize) {
+      buf = malloc(bufsize);
+      if (buf == NULL) {
+	 fclose(fob);
+	 mexErrMsgTxt("failed to allocate stream buffer.");
+      }
+      if ( setvbuf(fob, buf, _IOFBF, bufsize) ) {
+	 fclose(fob);
+	 free(buf);
+	 mexErrMsgTxt("failed to set stream buffer.");
+      }
+   }
+
    /* 
     * return the file pointer 
     */
+   cookie = (kind == STREAM_GZIP || kind == STREAM_ZSTD ||
+	     (kind == STREAM_OASIS && mode[0] == 'w'));
+   nel = cookie ? (kind == STREAM_OASIS ? 3 : 4) : (buf ? 2 : 1);
    if ( sizeof(FILE *) == 4 ) { 
-      plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT32_CLASS, mxREAL);
+      plhs[0] = mxCreateNumericMatrix(1, nel, mxUINT32_CLASS, mxREAL);
    }
    else if ( sizeof(FILE *) == 8 ) {
-      plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+      plhs[0] = mxCreateNumericMatrix(1, nel, mxUINT64_CLASS, mxREAL);
    }
    else
       mexErrMsgTxt("pointer size is neither 4 nor 8 bytes.");
 
    pfob  = (FILE **)mxGetData(plhs[0]);
    *pfob = fob;
+   if (buf)
+      memcpy(pfob+1, &buf, sizeof(char *));
+   if (cookie) {
+      uintptr_t k = (uintptr_t)kind;
+      memcpy(pfob+2, &k, sizeof(k));
+      if (nel == 4) {
+	 k = (uintptr_t)stream_fileno();
+	 memcpy(pfob+3, &k, sizeof(k));
+      }
+      mexLock();
+   }
 
    /* 
     * also return file size if opened for reading 
     */
-   if (mode[0] == 'r') {
+   if (mode[0] == 'r' && (kind == STREAM_GZIP || kind == STREAM_ZSTD)) {
+      if ( stat(fname, &st) )
+	 mexErrMsgTxt("failed to obtain size of compressed file.");
+      plhs[1] = mxCreateDoubleScalar((double)st.st_size);
+   }
+   else if (mode[0] == 'r') {
       if (fseek(fob, 0L, SEEK_END) < 0)
 	 mexErrMsgTxt("fseek to end of file failed.");
       fsize = ftell(fob);
@@ -106,4 +214,34 @@ mexFunction(int nlhs, mxArray *plhs[],
    }
 }
 
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * closes a compressed or OASIS stream and releases the lock on
+ * this mex function
+ */
+static mxArray *
+close_stream(const mxArray *pgf)
+{
+   FILE *fob;
+   uintptr_t kind;
+   const char *msg = "";
+
+   if ( mxGetNumberOfElements(pgf) < 3 )
+      mexErrMsgTxt("not a handle of a compressed or OASIS file.");
+   memcpy(&fob, mxGetData(pgf), sizeof(FILE *));
+   memcpy(&kind, (FILE **)mxGetData(pgf) + 2, sizeof(kind));
+
+   /* closing converts OASIS files */
+   if ( fclose(fob) ) {
+      msg = kind == STREAM_OASIS ? stream_error() : NULL;
+      if (msg == NULL)
+	 msg = "failed to close file.";
+   }
+   mexUnlock();
+
+   return mxCreateString(msg);
+}
+
 /*-----------------------------------------------------------------*/
@@ -0,0 +1,184 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Converts many paths to polygons in one call (see pathpoly.h). The
+ * paths are passed either in a packed vertex buffer, e.g. the layer
+ * output of gds_flatten_mex, or in a cell array.
+ *
+ * [pxy, np] = gds_pathpoly_mex(xy, nv, width, ptype, ext);
+ * pa = gds_pathpoly_mex(pc, [], width, ptype, ext);
+ *
+ * Input:
+ * xy :     V x 2 matrix with the vertices of all paths
+ * nv :     vector with the number of vertices of each path
+ * pc :     cell array of paths (n x 2 matrices)
+ * width :  path width; a scalar or a vector with one entry per path
+ * ptype :  path type (0, 1, 2, or 4); a scalar or a vector
+ * ext :    (Optional) begin and end extensions of type 4 paths;
+ *          a 1 x 2 vector or an N x 2 matrix. Default is [0,0].
+ *
+ * Output:
+ * pxy :    P x 2 matrix with the vertices of the closed polygons
+ * np :     N x 1 vector with the number of vertices of each polygon;
+ *          0 for paths with fewer than 2 distinct vertices
+ * pa :     cell array with the polygons, the same size as pc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+
+#include "pathpoly.h"
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   mxArray *pc;
+   size_t *off, *poff;
+   double *x, *y, *px, *py, *pd, *hw, *ext = NULL;
+   int *ptype;
+   size_t k, n, nv, nw, nt, ne, V, P;
+   int is_cell;
+
+   /* check arguments */
+   if (nrhs < 4)
+      mexErrMsgTxt("gds_pathpoly_mex :  at least 4 arguments required.");
+   is_cell = mxIsCell(prhs[0]);
+
+   if (is_cell) {
+
+      /* pack the paths in the cell array */
+      n = mxGetNumberOfElements(prhs[0]);
+      off = mxMalloc((n + 1) * sizeof(size_t));
+      off[0] = 0;
+      for (k=0; k<n; k++) {
+	 pc = mxGetCell(prhs[0], k);
+	 if (pc == NULL || !mxIsDouble(pc) || (mxGetN(pc) != 2 && !mxIsEmpty(pc)))
+	    mexErrMsgTxt("gds_pathpoly_mex :  paths must be n x 2 matrices.");
+	 off[k+1] = off[k] + mxGetM(pc);
+      }
+      V = off[n];
+      x = mxMalloc((V ? V : 1) * sizeof(double));
+      y = mxMalloc((V ? V : 1) * sizeof(double));
+      for (k=0; k<n; k++) {
+	 pc = mxGetCell(prhs[0], k);
+	 nv = off[k+1] - off[k];
+	 if (nv) {
+	    memcpy(x + off[k], mxGetPr(pc), nv * sizeof(double));
+	    memcpy(y + off[k], mxGetPr(pc) + nv, nv * sizeof(double));
+	 }
+      }
+   }
+   else {
+
+      /* packed vertex buffer */
+      if ( !mxIsDouble(prhs[0]) || (mxGetN(prhs[0]) != 2 && !mxIsEmpty(prhs[0])) )
+	 mexErrMsgTxt("gds_pathpoly_mex :  xy must be a V x 2 matrix.");
+      if ( !mxIsDouble(prhs[1]) )
+	 mexErrMsgTxt("gds_pathpoly_mex :  nv must be a vector of doubles.");
+      V = mxGetM(prhs[0]);
+      n = mxGetNumberOfElements(prhs[1]);
+      pd = mxGetPr(prhs[1]);
+      off = mxMalloc((n + 1) * sizeof(size_t));
+      off[0] = 0;
+      for (k=0; k<n; k++) {
+	 if (pd[k] < 0)
+	    mexErrMsgTxt("gds_pathpoly_mex :  vertex numbers must be positive.");
+	 off[k+1] = off[k] + (size_t)pd[k];
+      }
+      if (off[n] != V)
+	 mexErrMsgTxt("gds_pathpoly_mex :  sum(nv) must equal the number of vertices.");
+      x = mxGetPr(prhs[0]);
+      y = x + V;
+   }
+
+   /* path parameters */
+   nw = mxGetNumberOfElements(prhs[2]);
+   nt = mxGetNumberOfElements(prhs[3]);
+   if ( !mxIsDouble(prhs[2]) || (nw != 1 && nw != n) )
+      mexErrMsgTxt("gds_pathpoly_mex :  width must be a scalar or have one entry per path.");
+   if ( !mxIsDouble(prhs[3]) || (nt != 1 && nt != n) )
+      mexErrMsgTxt("gds_pathpoly_mex :  ptype must be a scalar or have one entry per path.");
+   hw = mxMalloc(nw * sizeof(double));
+   pd = mxGetPr(prhs[2]);
+   for (k=0; k<nw; k++)
+      hw[k] = 0.5 * fabs(pd[k]);
+   ptype = mxMalloc(nt * sizeof(int));
+   pd = mxGetPr(prhs[3]);
+   for (k=0; k<nt; k++) {
+      ptype[k] = (int)pd[k];
+      if (ptype[k] != 0 && ptype[k] != 1 && ptype[k] != 2 && ptype[k] != 4)
+	 mexErrMsgTxt("gds_pathpoly_mex :  path type must be 0, 1, 2, or 4.");
+   }
+   ne = 0;
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      if ( !mxIsDouble(prhs[4]) || mxGetN(prhs[4]) != 2 ||
+           (mxGetM(prhs[4]) != 1 && mxGetM(prhs[4]) != n) )
+	 mexErrMsgTxt("gds_pathpoly_mex :  ext must be a 1 x 2 vector or an N x 2 matrix.");
+      ne = mxGetM(prhs[4]);
+      pd = mxGetPr(prhs[4]);
+      ext = mxMalloc(2 * ne * sizeof(double));
+      for (k=0; k<ne; k++) {
+	 ext[2*k] = pd[k];
+	 ext[2*k+1] = pd[k+ne];
+      }
+   }
+
+   /* convert */
+   poff = mxMalloc((n + 1) * sizeof(size_t));
+   pathpoly_offsets(x, y, off, n, ptype, nt == 1, poff);
+   P = poff[n];
+   px = mxMalloc((P ? P : 1) * sizeof(double));
+   py = mxMalloc((P ? P : 1) * sizeof(double));
+   pathpoly_batch(x, y, off, n, hw, nw == 1, ptype, nt == 1, ext, ne == 1,
+                  poff, px, py);
+
+   /* return results */
+   if (is_cell) {
+      plhs[0] = mxCreateCellMatrix(mxGetM(prhs[0]), mxGetN(prhs[0]));
+      for (k=0; k<n; k++) {
+	 nv = poff[k+1] - poff[k];
+	 pc = mxCreateDoubleMatrix(nv, nv ? 2 : 0, mxREAL);
+	 if (nv) {
+	    memcpy(mxGetPr(pc), px + poff[k], nv * sizeof(double));
+	    memcpy(mxGetPr(pc) + nv, py + poff[k], nv * sizeof(double));
+	 }
+	 mxSetCell(plhs[0], k, pc);
+      }
+   }
+   else {
+      plhs[0] = mxCreateDoubleMatrix(P, 2, mxREAL);
+      if (P) {
+	 memcpy(mxGetPr(plhs[0]), px, P * sizeof(double));
+	 memcpy(mxGetPr(plhs[0]) + P, py, P * sizeof(double));
+      }
+      if (nlhs > 1) {
+	 plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+	 pd = mxGetPr(plhs[1]);
+	 for (k=0; k<n; k++)
+	    pd[k] = (double)(poff[k+1] - poff[k]);
+      }
+   }
+
+   /* clean up */
+   if (is_cell) {
+      mxFree(x);
+      mxFree(y);
+   }
+   mxFree(off);
+   mxFree(poff);
+   mxFree(px);
+   mxFree(py);
+   mxFree(hw);
+   mxFree(ptype);
+   if (ext != NULL)
+      mxFree(ext);
+}
@@ -0,0 +1,244 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Converts the box and path elements of many structures to
+ * boundary elements in one call. The paths are converted to
+ * polygons by several threads, each working on a range of
+ * structures (see polyconv.h).
+ *
+ * [D, R] = gds_poly_convert_mex(E, nthreads);
+ *
+ * Input
+ * E :        cell array with one entry per structure; each entry
+ *            is a cell array with the element data structures of
+ *            the structure (see gds_element/write_data).
+ * nthreads : (Optional) number of threads. Default is 0, which
+ *            uses one thread per processor.
+ *
+ * Output
+ * D :        cell array with one entry per structure; D{k} is a
+ *            cell array with one entry per element of structure k:
+ *            the data structure of the boundary element that
+ *            replaces a box or path element, or [] for elements
+ *            that are not changed.
+ * R :        cell array with one logical row vector per structure
+ *            that is true for the elements that are removed: text
+ *            and node elements, and paths without a polygon (paths
+ *            with fewer than 2 distinct vertices).
+ *
+ * Each path segment becomes one polygon of the boundary. The
+ * boundaries keep the layer, data type (the box type of boxes),
+ * elflags, plex, and properties of the converted elements.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "eldata.h"
+#include "mexfuncs.h"
+#include "polyconv.h"
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static mxArray *new_boundary(const element_t *pel, mxArray *data, mxArray *xy);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   mxArray *ps, *pe, *internal, *pxy, *pa, *pd, *pr, *xy;
+   mxArray **poly;
+   element_t el;
+   pc_path_t *pp, *p;
+   size_t *first;
+   size_t nst, nel, npath, apath, nseg, npoly;
+   size_t k, j, m, n;
+   mxLogical *rm;
+   int nthreads = 0;
+
+   /* check arguments */
+   if (nrhs < 1)
+      mexErrMsgTxt("gds_poly_convert_mex :  at least 1 input argument expected.");
+   if ( !mxIsCell(prhs[0]) )
+      mexErrMsgTxt("gds_poly_convert_mex :  argument must be a cell array.");
+   if (nrhs > 1 && !mxIsEmpty(prhs[1]))
+      nthreads = (int)mxGetScalar(prhs[1]);
+
+   /*
+    * collect the path segments of all structures
+    */
+   nst = mxGetNumberOfElements(prhs[0]);
+   first = mxMalloc((nst + 1) * sizeof(size_t));
+   apath = 1024;
+   pp = mxMalloc(apath * sizeof(pc_path_t));
+   npath = 0;
+
+   for (k=0; k<nst; k++) {
+      first[k] = npath;
+      ps = mxGetCell(prhs[0], k);
+      if (ps == NULL || mxIsEmpty(ps))
+	 continue;
+      if ( !mxIsCell(ps) )
+	 mexErrMsgTxt("gds_poly_convert_mex :  element data must be cell arrays.");
+
+      nel = mxGetNumberOfElements(ps);
+      for (j=0; j<nel; j++) {
+	 pe = mxGetCell(ps, j);
+	 if ( pe == NULL || !get_field_ptr(pe, "internal", &internal) )
+	    mexErrMsgTxt("gds_poly_convert_mex :  missing internal element data.");
+	 memcpy(&el, mxGetData(internal), sizeof(element_t));
+	 if (el.kind != GDS_PATH)
+	    continue;
+
+	 if ( !(el.has & HAS_WIDTH) )
+	    mexErrMsgTxt("gds_poly_convert_mex :  path must have width property.");
+	 if ( !get_field_ptr(pe, "xy", &pxy) )
+	    mexErrMsgTxt("gds_poly_convert_mex :  path has no xy field.");
+
+	 nseg = mxIsCell(pxy) ? mxGetNumberOfElements(pxy) : 1;
+	 if (npath + nseg > apath) {
+	    while (npath + nseg > apath)
+	       apath *= 2;
+	    pp = mxRealloc(pp, apath * sizeof(pc_path_t));
+	 }
+	 for (m=0; m<nseg; m++) {
+	    pa = mxIsCell(pxy) ? mxGetCell(pxy, m) : pxy;
+	    p = &pp[npath++];
+	    memset(p, 0, sizeof(pc_path_t));
+	    if (pa != NULL && !mxIsEmpty(pa)) {
+	       if ( !mxIsDouble(pa) || mxGetN(pa) != 2 )
+		  mexErrMsgTxt("gds_poly_convert_mex :  path vertices must be n x 2 matrices.");
+	       p->xy = mxGetPr(pa);
+	       p->nv = mxGetM(pa);
+	    }
+	    p->hw = 0.5 * fabs((double)el.width);
+	    p->ptype = el.has & HAS_PTYPE ? el.ptype : 0;
+	    p->ext[0] = el.has & HAS_BGNEXTN ? el.bgnextn : 0.0;
+	    p->ext[1] = el.has & HAS_ENDEXTN ? el.endextn : 0.0;
+	 }
+      }
+   }
+   first[nst] = npath;
+
+   /*
+    * convert the paths; the polygons are written directly to the
+    * output matrices
+    */
+   polyconv_size(pp, first, nst, nthreads);
+   poly = mxCalloc(npath ? npath : 1, sizeof(mxArray *));
+   for (k=0; k<npath; k++) {
+      if (pp[k].np) {
+	 poly[k] = mxCreateDoubleMatrix(pp[k].np, 2, mxREAL);
+	 pp[k].pxy = mxGetPr(poly[k]);
+      }
+   }
+   polyconv_paths(pp, first, nst, nthreads);
+
+   /*
+    * new boundary elements and removed elements
+    */
+   plhs[0] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+   plhs[1] = mxCreateCellArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]));
+   n = 0;
+   for (k=0; k<nst; k++) {
+      ps = mxGetCell(prhs[0], k);
+      nel = (ps == NULL) ? 0 : mxGetNumberOfElements(ps);
+      pd = mxCreateCellMatrix(1, nel);
+      pr = mxCreateLogicalMatrix(1, nel);
+      rm = mxGetLogicals(pr);
+
+      for (j=0; j<nel; j++) {
+	 pe = mxGetCell(ps, j);
+	 get_field_ptr(pe, "internal", &internal);
+	 memcpy(&el, mxGetData(internal), sizeof(element_t));
+
+	 switch (el.kind) {
+
+	    case GDS_PATH:
+	       get_field_ptr(pe, "xy", &pxy);
+	       nseg = mxIsCell(pxy) ? mxGetNumberOfElements(pxy) : 1;
+	       npoly = 0;
+	       for (m=0; m<nseg; m++)
+		  npoly += poly[n+m] != NULL;
+	       if (npoly == 0)
+		  rm[j] = 1;
+	       else if ( mxIsCell(pxy) ) {
+		  xy = mxCreateCellMatrix(1, npoly);
+		  npoly = 0;
+		  for (m=0; m<nseg; m++)
+		     if (poly[n+m])
+			mxSetCell(xy, npoly++, poly[n+m]);
+		  mxSetCell(pd, j, new_boundary(&el, pe, xy));
+	       }
+	       else
+		  mxSetCell(pd, j, new_boundary(&el, pe, poly[n]));
+	       n += nseg;
+	       break;
+
+	    case GDS_BOX:
+	       if ( !get_field_ptr(pe, "xy", &pxy) )
+		  mexErrMsgTxt("gds_poly_convert_mex :  box has no xy field.");
+	       mxSetCell(pd, j, new_boundary(&el, pe, mxDuplicateArray(pxy)));
+	       break;
+
+	    case GDS_TEXT:
+	    case GDS_NODE:
+	       rm[j] = 1;
+	       break;
+
+	    default:
+	       break;
+	 }
+      }
+
+      mxSetCell(plhs[0], k, pd);
+      mxSetCell(plhs[1], k, pr);
+   }
+
+   mxFree(poly);
+   mxFree(pp);
+   mxFree(first);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * data structure of a boundary that replaces a box or path
+ */
+static mxArray *
+new_boundary(const element_t *pel, mxArray *data, mxArray *xy)
+{
+   element_t bel;
+   mxArray *ps, *prop;
+   const char *fields[] = {"internal", "xy", "prop"};
+   int has_prop;
+
+   memset(&bel, 0, sizeof(element_t));
+   bel.kind = GDS_BOUNDARY;
+   bel.has = pel->has & (HAS_ELFLAGS | HAS_PLEX);
+   bel.elflags = pel->elflags;
+   bel.plex = pel->plex;
+   bel.layer = pel->layer;
+   bel.dtype = pel->kind == GDS_BOX ? pel->btype : pel->dtype;
+
+   has_prop = get_field_ptr(data, "prop", &prop);
+   ps = mxCreateStructMatrix(1, 1, has_prop ? 3 : 2, fields);
+   mxSetFieldByNumber(ps, 0, 0, copy_element_to_array(&bel));
+   mxSetFieldByNumber(ps, 0, 1, xy);
+   if (has_prop)
+      mxSetFieldByNumber(ps, 0, 2, mxDuplicateArray(prop));
+
+   return ps;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,144 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Computes the signed area, perimeter, bounding box, and orientation
+ * of many polygons in one pass (see polystats.h). The polygons are
+ * passed either in a packed vertex buffer, e.g. the layer output of
+ * gds_flatten_mex, or in a cell array.
+ *
+ * [A, P, bb, cw] = gds_polystats_mex(xy, nv, nthreads);
+ * [A, P, bb, cw] = gds_polystats_mex(pa, [], nthreads);
+ *
+ * Input:
+ * xy :       V x 2 matrix with the vertices of all polygons
+ * nv :       vector with the number of vertices of each polygon
+ * pa :       cell array of polygons (n x 2 matrices)
+ * nthreads : (Optional) number of threads used for large polygon
+ *            sets. Default is 0 (one thread per processor).
+ *
+ * Output:
+ * A :   N x 1 vector with signed polygon areas; positive for
+ *       counter-clockwise polygons
+ * P :   N x 1 vector with polygon perimeters
+ * bb :  N x 4 matrix with polygon bounding boxes [llx,lly,urx,ury]
+ * cw :  N x 1 logical vector; true for clockwise polygons
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "polystats.h"
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   mxArray *pc, *pl = NULL;
+   polystats_t ps;
+   size_t *off;
+   double *x, *y, *pv;
+   mxLogical *pcw;
+   unsigned char *cw = NULL;
+   size_t k, m, n, nv, V;
+   int nthreads = 0;
+
+   /* check arguments */
+   if (nrhs < 1)
+      mexErrMsgTxt("gds_polystats_mex :  at least 1 argument required.");
+   if (nrhs > 2 && !mxIsEmpty(prhs[2]))
+      nthreads = (int)mxGetScalar(prhs[2]);
+
+   if ( mxIsCell(prhs[0]) ) {
+
+      /* pack the polygons in the cell array */
+      n = mxGetNumberOfElements(prhs[0]);
+      off = mxMalloc((n + 1) * sizeof(size_t));
+      off[0] = 0;
+      for (k=0; k<n; k++) {
+	 pc = mxGetCell(prhs[0], k);
+	 if (pc == NULL || !mxIsDouble(pc) || (mxGetN(pc) != 2 && !mxIsEmpty(pc)))
+	    mexErrMsgTxt("gds_polystats_mex :  polygons must be n x 2 matrices.");
+	 off[k+1] = off[k] + mxGetM(pc);
+      }
+      V = off[n];
+      x = mxMalloc((V ? V : 1) * sizeof(double));
+      y = mxMalloc((V ? V : 1) * sizeof(double));
+      for (k=0; k<n; k++) {
+	 pc = mxGetCell(prhs[0], k);
+	 nv = off[k+1] - off[k];
+	 if (nv) {
+	    memcpy(x + off[k], mxGetPr(pc), nv * sizeof(double));
+	    memcpy(y + off[k], mxGetPr(pc) + nv, nv * sizeof(double));
+	 }
+      }
+   }
+   else {
+
+      /* packed vertex buffer */
+      if (nrhs < 2)
+	 mexErrMsgTxt("gds_polystats_mex :  vertex numbers nv are missing.");
+      if ( !mxIsDouble(prhs[0]) || (mxGetN(prhs[0]) != 2 && !mxIsEmpty(prhs[0])) )
+	 mexErrMsgTxt("gds_polystats_mex :  xy must be a V x 2 matrix.");
+      if ( !mxIsDouble(prhs[1]) )
+	 mexErrMsgTxt("gds_polystats_mex :  nv must be a vector of doubles.");
+      V = mxGetM(prhs[0]);
+      n = mxGetNumberOfElements(prhs[1]);
+      pv = mxGetPr(prhs[1]);
+      off = mxMalloc((n + 1) * sizeof(size_t));
+      off[0] = 0;
+      for (k=0; k<n; k++) {
+	 if (pv[k] < 0)
+	    mexErrMsgTxt("gds_polystats_mex :  vertex numbers must be positive.");
+	 off[k+1] = off[k] + (size_t)pv[k];
+      }
+      if (off[n] != V)
+	 mexErrMsgTxt("gds_polystats_mex :  sum(nv) must equal the number of vertices.");
+      x = mxGetPr(prhs[0]);
+      y = x + V;
+   }
+
+   /* output arrays */
+   plhs[0] = mxCreateDoubleMatrix(n, 1, mxREAL);
+   ps.area = mxGetPr(plhs[0]);
+   ps.perim = NULL;
+   ps.bbox = NULL;
+   ps.cw = NULL;
+   if (nlhs > 1) {
+      plhs[1] = mxCreateDoubleMatrix(n, 1, mxREAL);
+      ps.perim = mxGetPr(plhs[1]);
+   }
+   if (nlhs > 2) {
+      plhs[2] = mxCreateDoubleMatrix(n, 4, mxREAL);
+      ps.bbox = mxGetPr(plhs[2]);
+   }
+   if (nlhs > 3) {
+      pl = mxCreateLogicalMatrix(n, 1);
+      cw = mxMalloc((n ? n : 1) * sizeof(unsigned char));
+      ps.cw = cw;
+   }
+
+   if ( polystats(x, y, off, n, &ps, nthreads) )
+      mexErrMsgTxt("gds_polystats_mex :  polygons must have 3 or more vertices.");
+
+   if (pl != NULL) {
+      pcw = mxGetLogicals(pl);
+      for (m=0; m<n; m++)
+	 pcw[m] = cw[m];
+      mxFree(cw);
+      plhs[3] = pl;
+   }
+
+   /* clean up */
+   if ( mxIsCell(prhs[0]) ) {
+      mxFree(x);
+      mxFree(y);
+   }
+   mxFree(off);
+}
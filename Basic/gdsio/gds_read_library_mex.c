@@ -0,0 +1,1559 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Reads all structures, or a selected set of structures, from a
+ * GDSII library file with a single call. The elements are returned
+ * in the same data structures that are returned by gds_read_element.
+ *
+ * [sdata, nel] = gds_read_library_mex(gf, uunit, dbunit, snames, verbose, offsets, nthreads, lazy, window, top, columns);
+ * stats = gds_read_library_mex(gf, uunit, dbunit, snames, verbose, offsets, nthreads, [], [], top, [], 1);
+ *
+ * Input
+ * gf :       a file handle returned by gds_open. The file must
+ *            be positioned after the library header (see gds_libdata).
+ * uunit :    user unit in m
+ * dbunit :   database unit in m
+ * snames :   (Optional) cell array with the names of the structures
+ *            to read. All structures are read when snames is empty
+ *            or omitted.
+ * verbose :  (Optional) print progress information when > 0.
+ *            Default is 0.
+ * offsets :  (Optional) vector with the file positions of the BGNSTR
+ *            records of the structures to read (see gds_library_index).
+ *            Only these structures are read when offsets is not empty.
+ * nthreads : (Optional) number of threads used for decoding the
+ *            structures. Default is the number of processors.
+ * lazy :     (Optional) when > 0, the XY and property records of the
+ *            elements are not decoded (see gds_read_element).
+ *            Default is 0.
+ * window :   (Optional) [llx,lly,urx,ury] in user units. When not
+ *            empty, only the structures with instances that overlap
+ *            the window below the top structure are returned, and of
+ *            these only the elements that overlap the window (in lazy
+ *            mode, only boundary and box elements are tested).
+ * top :      (Optional) name of the top structure for the window.
+ *            Default is all structures that are not referenced.
+ * columns :  (Optional) when > 0, the elements of each structure are
+ *            also returned in columnar form (see element_columns in
+ *            elread.h). Ignored in lazy mode. Default is 0.
+ * stats :    (Optional) when > 0, no elements are returned. Instead,
+ *            the layer statistics of the structures (see layerstats.h)
+ *            are computed in the decoding threads and returned in a
+ *            structure with the fields
+ *              stats.names : names of the structures
+ *              stats.inst :  number of instances of each structure
+ *                            below the top structure(s)
+ *              stats.layer : K x 1 layers
+ *              stats.dtype : K x 1 data types
+ *              stats.flat :  K x 7 matrix; the number of boundary,
+ *                            path, box, node, and text elements, of
+ *                            vertices, and the area on each (layer,
+ *                            data type) pair, counting each element
+ *                            once
+ *              stats.hier :  K x 7 matrix as flat, counting each
+ *                            element once for every instance of its
+ *                            structure
+ *            lazy and window are ignored. Default is 0.
+ *
+ * Output:
+ * sdata :    structure array with one entry per structure
+ *              sdata(k).sname : structure name
+ *              sdata(k).cdate : creation date
+ *              sdata(k).mdate : modification date
+ *              sdata(k).el    : 1 x nel structure array with a single
+ *                               field 'data' that holds the element
+ *                               data structure; it has the layout of
+ *                               a gds_element object array
+ *              sdata(k).bbox  : nel x 4 matrix with element bounding
+ *                               boxes (see element_bboxes in elread.h)
+ *              sdata(k).cols  : columnar element table, or [] when
+ *                               columns is 0 or in lazy mode
+ *              sdata(k).span  : [offset, nbytes], the file position
+ *                               of the BGNSTR record and the number
+ *                               of bytes up to and including ENDSTR,
+ *                               or [] when a window is used
+ * nel :      (Optional) total number of elements that were read
+ *
+ * The structures are located in a quick pass over the record
+ * headers. They are then decoded by a pool of threads, each
+ * working on its own structure, while the calling thread creates
+ * the output data in file order. The MATLAB API is not thread-safe
+ * and is only used by the calling thread.
+ *
+ * Of compressed files, only a window of the decompressed data is
+ * kept in memory (see map_open). The structures are then decoded in
+ * batches that fit into the window, which grows only for structures
+ * larger than the window. Progress is reported from the position in
+ * the compressed file.
+ *
+ * With a window, the structures are decoded twice. The first pass
+ * only records the structure hierarchy and one bounding box per
+ * structure, from which the part of each structure that is visible
+ * through the window is found (see fl_window_cells); array rows and
+ * columns outside the window are skipped. The second pass converts
+ * only the visible structures and elements, so that the number of
+ * MATLAB objects that are created is proportional to the window.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "gdsio.h"
+#include "mapio.h"
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "mexfuncs.h"
+#include "elread.h"
+#include "flatten.h"
+#include "layerstats.h"
+#include "gdsstats.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define NLEN       256
+#define MAXTHREADS 256
+#define WINDOW     4      /* structures in flight per thread */
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * a structure decoded by one of the threads
+ */
+typedef struct {
+   long job;          /* structure in the slot; -1 when unused */
+   err_id err;        /* decoding status */
+   size_t start;      /* file position of BGNSTR */
+   size_t end;        /* file position after ENDSTR */
+   date_t cdate;      /* creation date */
+   date_t mdate;      /* modification date */
+   char *sname;       /* structure name */
+   size_t asname;     /* allocated length of sname */
+   el_buffer_t eb;    /* decoded elements */
+} struct_slot;
+
+
+/*
+ * file positions of a structure
+ */
+typedef struct {
+   size_t beg;        /* BGNSTR record */
+   size_t end;        /* after the ENDSTR record */
+} struct_pos_t;
+
+
+/*
+ * state shared by the decoding threads
+ */
+typedef struct {
+   map_file_t *mf;    /* library file in memory */
+   struct_pos_t *pos; /* file positions of the structures */
+   long njobs;        /* end of the structures in memory */
+   long next;         /* next structure to decode */
+   long nconv;        /* number of structures converted */
+   int nslot;         /* number of slots */
+   struct_slot *slot; /* slots for decoded structures */
+   double dbu_to_uu;  /* unit conversion factor */
+   ls_struct_t *stats; /* layer statistics of the structures or NULL;
+                          computed by the decoding threads */
+   int abort;         /* stop decoding */
+#if defined HAVE_PTHREADS
+   pthread_mutex_t lock;
+   pthread_cond_t decoded;  /* a structure was decoded */
+   pthread_cond_t freed;    /* a slot was released */
+#endif
+} pool_t;
+
+
+/*
+ * consumes a decoded structure in the calling thread; returns an
+ * error message or NULL
+ */
+typedef const char *(*consume_fn)(struct_slot *ps, long job, void *arg);
+
+
+/*
+ * the structure hierarchy for a window (see above)
+ */
+typedef struct {
+   fl_library_t lib;  /* one bounding shape and the references per structure */
+   char **sname;      /* structure names */
+   char **rname;      /* names of the referenced structures */
+   size_t *rcell;     /* structure with the reference */
+   size_t nref, aref; /* number of references */
+   double *lwin;      /* window of each structure (see fl_window_cells);
+                         allocated with mxCalloc */
+   size_t endpos;     /* read position after the last structure */
+} window_t;
+
+
+/*
+ * conversion of the decoded structures into the output data
+ */
+typedef struct {
+   mxArray *psdata;   /* structure array */
+   long *cell;        /* structure index in the window hierarchy */
+   window_t *pw;      /* window hierarchy or NULL */
+   int totnel;        /* number of elements */
+   int verbose;       /* print progress */
+   int columns;       /* return the columnar element tables */
+   int cfd;           /* descriptor of the compressed file or -1 */
+   size_t fsize;      /* size of the (compressed) file */
+   size_t endpos;     /* read position after the last structure */
+} output_t;
+
+
+/*
+ * layer statistics of the structures
+ */
+typedef struct {
+   ls_struct_t *st;   /* statistics of each structure */
+   char **names;      /* structure names */
+   size_t endpos;     /* read position after the last structure */
+} stats_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int read_structures(struct_pos_t *pos, long njobs, int nthreads, int lazy,
+                           double dbu_to_uu, ls_struct_t *stats,
+                           consume_fn consume, void *arg, char *errmsg);
+static const char *convert_structure(struct_slot *ps, long job, void *arg);
+static const char *hierarchy_structure(struct_slot *ps, long job, void *arg);
+static const char *stats_structure(struct_slot *ps, long job, void *arg);
+static err_id structure_stats(el_buffer_t *eb, ls_struct_t *st);
+static mxArray *library_stats(stats_t *pst, long njobs, const mxArray *ptop);
+static const char *window_structures(window_t *pw, const mxArray *ptop,
+                                     const double *win);
+static void window_elements(window_t *pw, long k, el_buffer_t *eb);
+static int element_box(el_buffer_t *eb, el_decoded_t *de, double *b);
+static int box_overlap(const double *a, const double *b);
+static void free_window(window_t *pw);
+static int cmp_names(const void *a, const void *b);
+static struct_pos_t *find_structures(map_file_t *mf, const mxArray *snames,
+				     double *poff, int noff, long *njobs, size_t *endpos);
+static err_id skip_structure(map_file_t *mf);
+static long load_batch(map_file_t *mf, struct_pos_t *pos, long first, long njobs);
+static void decode_structure(pool_t *pool, long job, struct_slot *ps);
+static err_id decode_header(map_file_t *mf, struct_slot *ps);
+static mxArray *slot_elements(struct_slot *ps);
+static int default_threads(void);
+static double file_offset(int fd);
+static void unmap_file(void);
+static int is_selected(const mxArray *snames, const char *sname);
+static mxArray* date_array(uint16_t *date);
+
+#if defined HAVE_PTHREADS
+static void *decode_thread(void *arg);
+#endif
+
+
+/*-- Data ---------------------------------------------------------*/
+
+/* the library file in memory; kept static so that it can be
+   unmapped after an error or when the mex function is cleared */
+static map_file_t libmap;
+
+/* window hierarchy; static so that it can be released after an error */
+static window_t whier;
+
+static char **sort_names;   /* used by cmp_names */
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;
+   const mxArray *snames = NULL;
+   const mxArray *ptop = NULL;
+   output_t out;
+   struct_pos_t *spos;
+   size_t endpos;
+   double *pd;
+   double *poff = NULL;
+   double uunit, dbunit, win[4];
+   long k, n, njobs;
+   int nthreads = 0;
+   int noff = 0;
+   int lazy = 0;
+   int has_window = 0;
+   int stats = 0;
+   char errmsg[ERRLEN];
+   const char *msg;
+   const char *fields[] = {"sname", "cdate", "mdate", "el", "bbox", "cols", "span"};
+
+
+   /* check argument number */
+   if (nrhs < 3) {
+      mexErrMsgTxt("gds_read_library_mex :  at least 3 input arguments expected.");
+   }
+   if (nlhs < 1) {
+      mexErrMsgTxt("gds_read_library_mex :  at least one output argument expected.");
+   }
+
+   /* get file handle argument */
+   fob = get_file_ptr((mxArray *)prhs[0]);
+
+   /* get units */
+   pd = mxGetData(prhs[1]);
+   uunit = pd[0];
+   pd = mxGetData(prhs[2]);
+   dbunit = pd[0];
+
+   /* structure selection */
+   if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+      if ( !mxIsCell(prhs[3]) )
+	 mexErrMsgTxt("gds_read_library_mex :  structure names must be a cell array.");
+      snames = prhs[3];
+   }
+
+   /* verbosity */
+   memset(&out, 0, sizeof(output_t));
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      pd = mxGetData(prhs[4]);
+      out.verbose = pd[0] > 0;
+   }
+
+   /* structure offsets */
+   if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+      poff = mxGetData(prhs[5]);
+      noff = mxGetNumberOfElements(prhs[5]);
+   }
+
+   /* number of threads */
+   if (nrhs > 6 && !mxIsEmpty(prhs[6])) {
+      pd = mxGetData(prhs[6]);
+      nthreads = (int)pd[0];
+   }
+   if (nthreads < 1)
+      nthreads = default_threads();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+
+   /* decoding of XY and property records on demand */
+   if (nrhs > 7 && !mxIsEmpty(prhs[7])) {
+      pd = mxGetData(prhs[7]);
+      lazy = pd[0] > 0;
+   }
+
+   /* window and top structure */
+   if (nrhs > 8 && !mxIsEmpty(prhs[8])) {
+      if ( !mxIsDouble(prhs[8]) || mxGetNumberOfElements(prhs[8]) != 4 )
+	 mexErrMsgTxt("gds_read_library_mex :  window must have 4 elements.");
+      pd = mxGetPr(prhs[8]);
+      win[0] = pd[0] < pd[2] ? pd[0] : pd[2];
+      win[2] = pd[0] < pd[2] ? pd[2] : pd[0];
+      win[1] = pd[1] < pd[3] ? pd[1] : pd[3];
+      win[3] = pd[1] < pd[3] ? pd[3] : pd[1];
+      has_window = 1;
+   }
+   if (nrhs > 9 && !mxIsEmpty(prhs[9])) {
+      if ( !mxIsChar(prhs[9]) )
+	 mexErrMsgTxt("gds_read_library_mex :  top structure name must be a string.");
+      ptop = prhs[9];
+   }
+
+   /* layer statistics instead of elements */
+   if (nrhs > 11 && !mxIsEmpty(prhs[11])) {
+      pd = mxGetData(prhs[11]);
+      stats = pd[0] > 0;
+   }
+
+   /* columnar element tables */
+   if (nrhs > 10 && !mxIsEmpty(prhs[10])) {
+      pd = mxGetData(prhs[10]);
+      out.columns = pd[0] > 0 && !lazy;
+   }
+
+   /* map the library file into memory */
+   unmap_file();
+   mexAtExit(unmap_file);
+   if ( map_open(&libmap, fob) )
+      mexErrMsgTxt("gds_read_library_mex :  failed to map file into memory.");
+   out.fsize = libmap.offset + libmap.size;
+
+   /* progress in a compressed file (see gds_open) */
+   out.cfd = -1;
+   if (mxGetNumberOfElements(prhs[0]) > 3) {
+      uintptr_t fd;
+      struct stat st;
+      memcpy(&fd, (FILE **)mxGetData(prhs[0]) + 3, sizeof(fd));
+      if ( !fstat((int)fd, &st) ) {
+	 out.cfd = (int)fd;
+	 out.fsize = (size_t)st.st_size;
+      }
+   }
+
+   /* find the structures that must be read */
+   spos = find_structures(&libmap, snames, poff, noff, &njobs, &endpos);
+   out.endpos = endpos;
+
+   /* layer statistics of the structures */
+   if (stats) {
+      stats_t sd;
+      sd.st = mxCalloc(njobs ? njobs : 1, sizeof(ls_struct_t));
+      sd.names = mxCalloc(njobs ? njobs : 1, sizeof(char *));
+      sd.endpos = endpos;
+      if ( read_structures(spos, njobs, nthreads, 0, dbunit / uunit, sd.st,
+			   stats_structure, &sd, errmsg) ) {
+	 for (k=0; k<njobs; k++) {
+	    ls_struct_free(&sd.st[k]);
+	    free(sd.names[k]);
+	 }
+	 free(spos);
+	 unmap_file();
+	 mexErrMsgTxt(errmsg);
+      }
+      free(spos);
+      if (noff)
+	 endpos = sd.endpos;
+      if ( map_seek(&libmap, endpos) || map_close(&libmap, fob) )
+	 mexErrMsgTxt("gds_read_library_mex :  failed to set file position.");
+      plhs[0] = library_stats(&sd, njobs, ptop);
+      STATS_FLUSH();
+      return;
+   }
+
+   /* the structures visible through the window */
+   if (has_window) {
+      if ( fl_library_init(&whier.lib, njobs) ) {
+	 free(spos);
+	 unmap_file();
+	 mexErrMsgTxt("gds_read_library_mex :  out of memory.");
+      }
+      strcpy(errmsg, "gds_read_library_mex :  out of memory.");
+      whier.sname = calloc(njobs ? njobs : 1, sizeof(char *));
+      whier.endpos = endpos;
+      if ( whier.sname == NULL ||
+	   read_structures(spos, njobs, nthreads, 0, dbunit / uunit, NULL,
+			   hierarchy_structure, &whier, errmsg) ) {
+	 free(spos);
+	 unmap_file();
+	 mexErrMsgTxt(errmsg);
+      }
+      if ( (msg = window_structures(&whier, ptop, win)) ) {
+	 free(spos);
+	 unmap_file();
+	 mexErrMsgTxt(msg);
+      }
+      out.endpos = whier.endpos;
+
+      /* keep the visible structures */
+      out.pw = &whier;
+      out.cell = mxCalloc(njobs ? njobs : 1, sizeof(long));
+      for (n=0,k=0; k<njobs; k++) {
+	 if (whier.lwin[4*k] <= whier.lwin[4*k+2]) {
+	    out.cell[n] = k;
+	    spos[n++] = spos[k];
+	 }
+      }
+      njobs = n;
+   }
+
+   /* create the output data in file order */
+   out.psdata = mxCreateStructMatrix(1,njobs, 7, fields);
+   if ( read_structures(spos, njobs, nthreads, lazy, dbunit / uunit, NULL,
+			convert_structure, &out, errmsg) ) {
+      free(spos);
+      unmap_file();
+      mexErrMsgTxt(errmsg);
+   }
+   free(spos);
+   free_window(&whier);
+
+   /* reposition the stream and release the memory */
+   if (noff)
+      endpos = out.endpos;
+   if ( map_seek(&libmap, endpos) || map_close(&libmap, fob) )
+      mexErrMsgTxt("gds_read_library_mex :  failed to set file position.");
+
+   /* return data */
+   plhs[0] = out.psdata;
+   if (nlhs > 1) {
+      plhs[1] = mxCreateDoubleMatrix(1,1, mxREAL);
+      pd = mxGetData(plhs[1]);
+      *pd = (double)out.totnel;
+   }
+
+   STATS_FLUSH();
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * decodes the structures at the file positions pos with a pool of
+ * threads and passes them, in file order, to a function that
+ * consumes them in the calling thread. The structures are decoded
+ * in batches that are in memory at once. Returns 1 after an error,
+ * with the error message in errmsg.
+ */
+static int
+read_structures(struct_pos_t *pos, long njobs, int nthreads, int lazy,
+                double dbu_to_uu, ls_struct_t *stats,
+                consume_fn consume, void *arg, char *errmsg)
+{
+   pool_t pool;
+   struct_slot *ps;
+   const char *msg;
+   long k, first, last;
+   int j;
+   int nstarted = 0;
+#if defined HAVE_PTHREADS
+   pthread_t tid[MAXTHREADS];
+#endif
+
+   if (nthreads > njobs)
+      nthreads = njobs > 0 ? (int)njobs : 1;
+
+   /* decoding state */
+   memset(&pool, 0, sizeof(pool_t));
+   pool.mf = &libmap;
+   pool.pos = pos;
+   pool.dbu_to_uu = dbu_to_uu;
+   pool.stats = stats;
+   pool.nslot = nthreads > 1 ? WINDOW*nthreads : 1;
+   pool.slot = mxCalloc(pool.nslot, sizeof(struct_slot));
+   for (j=0; j<pool.nslot; j++) {
+      pool.slot[j].job = -1;
+      pool.slot[j].eb.lazy = lazy;
+   }
+
+#if defined HAVE_PTHREADS
+   if (nthreads > 1) {
+      pthread_mutex_init(&pool.lock, NULL);
+      pthread_cond_init(&pool.decoded, NULL);
+      pthread_cond_init(&pool.freed, NULL);
+   }
+#endif
+
+   errmsg[0] = '\0';
+   for (first=0; first<njobs && !errmsg[0]; first=last) {
+
+      /* the structures of the next batch must be in memory */
+      last = load_batch(&libmap, pos, first, njobs);
+      if (last == first) {
+	 strcpy(errmsg, "gds_read_library_mex :  failed to read structure data.");
+	 break;
+      }
+      pool.next = pool.nconv = first;
+      pool.njobs = last;
+      pool.abort = 0;
+
+#if defined HAVE_PTHREADS
+      if (nthreads > 1) {
+	 for (nstarted=0; nstarted<nthreads && nstarted<last-first; nstarted++) {
+	    if ( pthread_create(&tid[nstarted], NULL, decode_thread, &pool) )
+	       break;
+	 }
+      }
+#endif
+
+      for (k=first; k<last; k++) {
+
+	 ps = &pool.slot[k % pool.nslot];
+
+	 /* wait for the structure */
+#if defined HAVE_PTHREADS
+	 if (nstarted) {
+	    pthread_mutex_lock(&pool.lock);
+	    while (ps->job != k)
+	       pthread_cond_wait(&pool.decoded, &pool.lock);
+	    pthread_mutex_unlock(&pool.lock);
+	 }
+	 else
+#endif
+	    decode_structure(&pool, k, ps);
+
+	 if (ps->err) {
+	    strcpy(errmsg, ps->eb.errmsg);
+	    break;
+	 }
+	 if ( (msg = consume(ps, k, arg)) ) {
+	    strncpy(errmsg, msg, ERRLEN-1);
+	    errmsg[ERRLEN-1] = '\0';
+	    break;
+	 }
+
+	 /* the slot can be reused */
+	 el_buffer_clear(&ps->eb);
+#if defined HAVE_PTHREADS
+	 if (nstarted) {
+	    pthread_mutex_lock(&pool.lock);
+	    pool.nconv = k+1;
+	    pthread_cond_broadcast(&pool.freed);
+	    pthread_mutex_unlock(&pool.lock);
+	 }
+	 else
+#endif
+	    pool.nconv = k+1;
+      }
+
+      /* stop the threads */
+#if defined HAVE_PTHREADS
+      if (nstarted) {
+	 pthread_mutex_lock(&pool.lock);
+	 pool.abort = 1;
+	 pthread_cond_broadcast(&pool.freed);
+	 pthread_mutex_unlock(&pool.lock);
+	 for (j=0; j<nstarted; j++)
+	    pthread_join(tid[j], NULL);
+	 nstarted = 0;
+      }
+#endif
+   }
+
+#if defined HAVE_PTHREADS
+   if (nthreads > 1) {
+      pthread_mutex_destroy(&pool.lock);
+      pthread_cond_destroy(&pool.decoded);
+      pthread_cond_destroy(&pool.freed);
+   }
+#endif
+
+   /* release decoding buffers */
+   for (j=0; j<pool.nslot; j++) {
+      el_buffer_free(&pool.slot[j].eb);
+      free(pool.slot[j].sname);
+   }
+   mxFree(pool.slot);
+
+   return errmsg[0] != '\0';
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * keeps the name of a structure whose statistics were computed
+ * by a decoding thread
+ */
+static const char *
+stats_structure(struct_slot *ps, long job, void *arg)
+{
+   stats_t *pst = (stats_t *)arg;
+
+   if ( (pst->names[job] = malloc(strlen(ps->sname)+1)) == NULL )
+      return "gds_read_library_mex :  out of memory.";
+   strcpy(pst->names[job], ps->sname);
+   pst->endpos = ps->end;
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * computes the layer statistics of a decoded structure. Only C
+ * library functions may be called here.
+ */
+static err_id
+structure_stats(el_buffer_t *eb, ls_struct_t *st)
+{
+   el_decoded_t *de;
+   el_xyrec_t *pr;
+   element_t *pe;
+   double nv, a, ra, ext[2], *pxy;
+   size_t k, r;
+   int res = 0;
+
+   for (k=0; k<eb->nel && !res; k++) {
+
+      de = &eb->el[k];
+      pe = &de->el;
+
+      if (pe->kind == GDS_SREF) {
+	 res = ls_add_ref(st, eb->str + de->str, 1.0);
+	 continue;
+      }
+      if (pe->kind == GDS_AREF) {
+	 res = ls_add_ref(st, eb->str + de->str, (double)pe->nrow * (double)pe->ncol);
+	 continue;
+      }
+
+      nv = a = 0.0;
+      ext[0] = pe->has & HAS_BGNEXTN ? pe->bgnextn : 0.0;
+      ext[1] = pe->has & HAS_ENDEXTN ? pe->endextn : 0.0;
+      for (r=0; r<de->nxyrec; r++) {
+	 pr = &eb->xyr[de->xyrec + r];
+	 pxy = eb->xy + pr->idx;
+	 nv += (double)pr->m;
+	 switch (pe->kind) {
+	    case GDS_BOUNDARY:
+	    case GDS_BOX:
+	       a += ls_polygon_area(pxy, pxy+1, pr->m, 2);
+	       break;
+	    case GDS_PATH:
+	       ra = ls_path_area(st, pxy, pxy+1, pr->m, 2, 0.5*fabs(pe->width),
+				 pe->has & HAS_PTYPE ? pe->ptype : 0, ext);
+	       if (ra < 0.0)
+		  res = -1;
+	       a += ra;
+	       break;
+	    default:
+	       break;
+	 }
+      }
+      if (!res)
+	 res = ls_add(st, pe->layer, pe->dtype, (int)pe->kind - GDS_BOUNDARY, 1.0, nv, a);
+   }
+
+   if (res) {
+      strcpy(eb->errmsg, "gds_read_library_mex :  out of memory.");
+      return READ_REC_DATA;
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * flat and hierarchical statistics of the library; releases the
+ * statistics of the structures
+ */
+static mxArray *
+library_stats(stats_t *pst, long njobs, const mxArray *ptop)
+{
+   mxArray *pstats, *pa;
+   ls_struct_t flat, hier;
+   const ls_entry_t *ph;
+   double *pinst, *pl, *pdt, *pf, *ph_out;
+   char top[NLEN];
+   size_t k, K;
+   long j;
+   int c, res;
+   const char *fields[] = {"names", "inst", "layer", "dtype", "flat", "hier"};
+
+   memset(&flat, 0, sizeof(ls_struct_t));
+   memset(&hier, 0, sizeof(ls_struct_t));
+   pstats = mxCreateStructMatrix(1,1, 6, fields);
+
+   /* structure names and instances */
+   pa = mxCreateCellMatrix(1, njobs);
+   for (j=0; j<njobs; j++)
+      mxSetCell(pa, j, mxCreateString(pst->names[j]));
+   mxSetFieldByNumber(pstats, 0, 0, pa);
+   pa = mxCreateDoubleMatrix(1, njobs, mxREAL);
+   pinst = mxGetPr(pa);
+   mxSetFieldByNumber(pstats, 0, 1, pa);
+   if (ptop)
+      mxGetString(ptop, top, NLEN);
+   res = ls_instances(pst->st, (const char **)pst->names, njobs, ptop ? top : NULL, pinst);
+   if (!res)
+      res = ls_total(pst->st, njobs, NULL, &flat);
+   if (!res)
+      res = ls_total(pst->st, njobs, pinst, &hier);
+
+   for (j=0; j<njobs; j++) {
+      ls_struct_free(&pst->st[j]);
+      free(pst->names[j]);
+   }
+   mxFree(pst->st);
+   mxFree(pst->names);
+
+   if (res) {
+      ls_struct_free(&flat);
+      ls_struct_free(&hier);
+      mxDestroyArray(pstats);
+      switch (res) {
+	 case -2:
+	    mexErrMsgTxt("gds_read_library_mex :  top structure not found.");
+	 case -3:
+	    mexErrMsgTxt("gds_read_library_mex :  structures reference each other in a cycle.");
+	 default:
+	    mexErrMsgTxt("gds_read_library_mex :  out of memory.");
+      }
+   }
+
+   /* statistics on each (layer, data type) pair */
+   K = flat.nent;
+   pa = mxCreateDoubleMatrix(K,1, mxREAL);
+   pl = mxGetPr(pa);
+   mxSetFieldByNumber(pstats, 0, 2, pa);
+   pa = mxCreateDoubleMatrix(K,1, mxREAL);
+   pdt = mxGetPr(pa);
+   mxSetFieldByNumber(pstats, 0, 3, pa);
+   pa = mxCreateDoubleMatrix(K,LS_NCOL, mxREAL);
+   pf = mxGetPr(pa);
+   mxSetFieldByNumber(pstats, 0, 4, pa);
+   pa = mxCreateDoubleMatrix(K,LS_NCOL, mxREAL);
+   ph_out = mxGetPr(pa);
+   mxSetFieldByNumber(pstats, 0, 5, pa);
+   for (k=0; k<K; k++) {
+      pl[k] = (double)(flat.ent[k].key & 0xffff);
+      pdt[k] = (double)(flat.ent[k].key >> 16);
+      ph = ls_find(&hier, flat.ent[k].key);
+      for (c=0; c<LS_NCOL; c++) {
+	 pf[k + c*K] = flat.ent[k].val[c];
+	 ph_out[k + c*K] = ph ? ph->val[c] : 0.0;
+      }
+   }
+   ls_struct_free(&flat);
+   ls_struct_free(&hier);
+
+   return pstats;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * creates the output data of a decoded structure
+ */
+static const char *
+convert_structure(struct_slot *ps, long job, void *arg)
+{
+   output_t *po = (output_t *)arg;
+   mxArray *pspan;
+   double *pd, done;
+   int nel;
+
+   if (po->pw)
+      window_elements(po->pw, po->cell[job], &ps->eb);
+
+   nel = (int)ps->eb.nel;
+   mxSetFieldByNumber(po->psdata, job, 0, mxCreateString(ps->sname));
+   mxSetFieldByNumber(po->psdata, job, 1, date_array(ps->cdate));
+   mxSetFieldByNumber(po->psdata, job, 2, date_array(ps->mdate));
+   mxSetFieldByNumber(po->psdata, job, 3, slot_elements(ps));
+   mxSetFieldByNumber(po->psdata, job, 4, element_bboxes(&ps->eb));
+   if (po->columns)
+      mxSetFieldByNumber(po->psdata, job, 5, element_columns(&ps->eb));
+   if (!po->pw) {  /* structures in a window are incomplete */
+      pspan = mxCreateDoubleMatrix(1,2, mxREAL);
+      pd = mxGetData(pspan);
+      pd[0] = (double)ps->start;
+      pd[1] = (double)(ps->end - ps->start);
+      mxSetFieldByNumber(po->psdata, job, 6, pspan);
+   }
+   po->totnel += nel;
+
+   if (po->verbose) {
+      done = po->cfd >= 0 ? file_offset(po->cfd) : (double)ps->end;
+      mexPrintf("%ld ... %3.1f%% ... %s (%d)\n",
+		job+1, po->fsize ? 100.0*done/(double)po->fsize : 0.0,
+		ps->sname, nel);
+   }
+   if (!po->pw)
+      po->endpos = ps->end;
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * records the references of a decoded structure and the bounding
+ * box of its other elements, which is stored as a single shape
+ */
+static const char *
+hierarchy_structure(struct_slot *ps, long job, void *arg)
+{
+   window_t *pw = (window_t *)arg;
+   fl_cell_t *c = &pw->lib.cell[job];
+   el_buffer_t *eb = &ps->eb;
+   el_decoded_t *de;
+   el_xyrec_t *pr;
+   element_t e;
+   double b[4], eb_box[4], rxy[6], x[2], y[2];
+   size_t m, r, nv;
+   char *pn;
+   void *pa;
+
+   if ( (pw->sname[job] = malloc(strlen(ps->sname)+1)) == NULL )
+      return "gds_read_library_mex :  out of memory.";
+   strcpy(pw->sname[job], ps->sname);
+   pw->endpos = ps->end;
+
+   b[0] = b[1] = HUGE_VAL;
+   b[2] = b[3] = -HUGE_VAL;
+   for (m=0; m<eb->nel; m++) {
+
+      de = &eb->el[m];
+      if (de->el.kind != GDS_SREF && de->el.kind != GDS_AREF) {
+	 if ( element_box(eb, de, eb_box) ) {
+	    b[0] = fmin(b[0], eb_box[0]);
+	    b[1] = fmin(b[1], eb_box[1]);
+	    b[2] = fmax(b[2], eb_box[2]);
+	    b[3] = fmax(b[3], eb_box[3]);
+	 }
+	 continue;
+      }
+
+      /* reference position; arrays need three points */
+      e = de->el;
+      memset(rxy, 0, sizeof(rxy));
+      for (nv=0,r=0; r<de->nxyrec && nv<3; r++) {
+	 pr = &eb->xyr[de->xyrec + r];
+	 memcpy(rxy + 2*nv, eb->xy + pr->idx,
+		2*(pr->m < 3-nv ? pr->m : 3-nv)*sizeof(double));
+	 nv += pr->m < 3-nv ? pr->m : 3-nv;
+      }
+      if (e.kind == GDS_AREF && nv < 3)
+	 e.ncol = e.nrow = 0;
+      if ( fl_add_ref(c, m, -1, &e, rxy) )
+	 return "gds_read_library_mex :  out of memory.";
+
+      /* the referenced structure is found by name later */
+      if (pw->nref == pw->aref) {
+	 pw->aref = pw->aref ? 2*pw->aref : 256;
+	 if ( (pa = realloc(pw->rname, pw->aref*sizeof(char *))) == NULL )
+	    return "gds_read_library_mex :  out of memory.";
+	 pw->rname = pa;
+	 if ( (pa = realloc(pw->rcell, pw->aref*sizeof(size_t))) == NULL )
+	    return "gds_read_library_mex :  out of memory.";
+	 pw->rcell = pa;
+      }
+      pn = de->has_str ? eb->str + de->str : "";
+      if ( (pw->rname[pw->nref] = malloc(strlen(pn)+1)) == NULL )
+	 return "gds_read_library_mex :  out of memory.";
+      strcpy(pw->rname[pw->nref], pn);
+      pw->rcell[pw->nref++] = job;
+   }
+
+   if (b[0] <= b[2]) {
+      memset(&e, 0, sizeof(element_t));
+      e.kind = GDS_BOUNDARY;
+      x[0] = b[0];  x[1] = b[2];
+      y[0] = b[1];  y[1] = b[3];
+      if ( fl_add_shape(c, 0, &e) || fl_add_vertices(c, x, y, 2, 1) )
+	 return "gds_read_library_mex :  out of memory.";
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * resolves the references of the hierarchy by name and computes
+ * the window of every structure
+ */
+static const char *
+window_structures(window_t *pw, const mxArray *ptop, const double *win)
+{
+   fl_library_t *lib = &pw->lib;
+   size_t *order, *nr;
+   double *lw;
+   size_t k, m, lo, hi, mid;
+   fl_status st = FL_OK;
+   char *refd;
+   char tname[NLEN];
+   int c;
+
+   order = mxCalloc(lib->ncell ? lib->ncell : 1, sizeof(size_t));
+   nr = mxCalloc(lib->ncell ? lib->ncell : 1, sizeof(size_t));
+   refd = mxCalloc(lib->ncell ? lib->ncell : 1, 1);
+   for (k=0; k<lib->ncell; k++)
+      order[k] = k;
+   sort_names = pw->sname;
+   qsort(order, lib->ncell, sizeof(size_t), cmp_names);
+
+   /* the references of a structure are in element order */
+   for (m=0; m<pw->nref; m++) {
+      lo = 0;
+      hi = lib->ncell;
+      while (lo < hi) {
+	 mid = (lo + hi) / 2;
+	 c = strcmp(pw->rname[m], pw->sname[order[mid]]);
+	 if (c == 0) {
+	    lib->cell[pw->rcell[m]].ref[nr[pw->rcell[m]]].cell = (int32_t)order[mid];
+	    refd[order[mid]] = 1;
+	    break;
+	 }
+	 if (c < 0)
+	    hi = mid;
+	 else
+	    lo = mid + 1;
+      }
+      nr[pw->rcell[m]]++;
+   }
+
+   /* the windows of the top structures are combined */
+   if (ptop) {
+      mxGetString(ptop, tname, NLEN);
+      memset(refd, 1, lib->ncell);
+      for (k=0; k<lib->ncell; k++) {
+	 if ( !strcmp(tname, pw->sname[k]) ) {
+	    refd[k] = 0;
+	    break;
+	 }
+      }
+      if (k == lib->ncell)
+	 return "gds_read_library_mex :  top structure not found.";
+   }
+
+   pw->lwin = mxCalloc(8*(lib->ncell ? lib->ncell : 1), sizeof(double));
+   lw = pw->lwin + 4*lib->ncell;
+   for (k=0; k<lib->ncell; k++) {
+      pw->lwin[4*k] = pw->lwin[4*k+1] = HUGE_VAL;
+      pw->lwin[4*k+2] = pw->lwin[4*k+3] = -HUGE_VAL;
+   }
+   for (k=0; k<lib->ncell && !st; k++) {
+      if (refd[k])
+	 continue;
+      if ( (st = fl_window_cells(lib, k, win, lw)) )
+	 break;
+      for (m=0; m<lib->ncell; m++) {
+	 pw->lwin[4*m]   = fmin(pw->lwin[4*m],   lw[4*m]);
+	 pw->lwin[4*m+1] = fmin(pw->lwin[4*m+1], lw[4*m+1]);
+	 pw->lwin[4*m+2] = fmax(pw->lwin[4*m+2], lw[4*m+2]);
+	 pw->lwin[4*m+3] = fmax(pw->lwin[4*m+3], lw[4*m+3]);
+      }
+   }
+
+   mxFree(order);
+   mxFree(nr);
+   mxFree(refd);
+
+   return st ? "gds_read_library_mex :  cyclic structure references." : NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * removes the elements of structure k that are not visible through
+ * its window. Elements without a known bounding box are kept, and
+ * so are references to structures that were not read.
+ */
+static void
+window_elements(window_t *pw, long k, el_buffer_t *eb)
+{
+   fl_cell_t *c = &pw->lib.cell[k];
+   const double *w = pw->lwin + 4*k;
+   el_decoded_t *de;
+   double b[4];
+   size_t m, n, r;
+   int keep;
+
+   for (m=0,n=0,r=0; m<eb->nel; m++) {
+      de = &eb->el[m];
+      if (de->el.kind == GDS_SREF || de->el.kind == GDS_AREF) {
+	 keep = r >= c->nref || c->ref[r].cell < 0 ||
+	        (!fl_ref_bbox(&pw->lib, &c->ref[r], b) && box_overlap(b, w));
+	 r++;
+      }
+      else
+	 keep = !element_box(eb, de, b) || box_overlap(b, w);
+      if (keep) {
+	 if (n != m)
+	    eb->el[n] = *de;
+	 n++;
+      }
+   }
+   eb->nel = n;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * bounding box of the vertices of an element, including the extent
+ * of paths beyond their center lines (see fl_add_shape). In lazy
+ * mode, only the bounding boxes of boundaries and boxes are known.
+ * Returns 0 when the bounding box is not known.
+ */
+static int
+element_box(el_buffer_t *eb, el_decoded_t *de, double *b)
+{
+   element_t *pe = &de->el;
+   el_xyrec_t *pr;
+   double *pxy, w;
+   size_t j, n;
+
+   if (eb->lazy) {
+      if (de->bbox[0] > de->bbox[2])
+	 return 0;
+      memcpy(b, de->bbox, 4*sizeof(double));
+      return 1;
+   }
+
+   b[0] = b[1] = HUGE_VAL;
+   b[2] = b[3] = -HUGE_VAL;
+   for (j=0; j<de->nxyrec; j++) {
+      pr = &eb->xyr[de->xyrec + j];
+      pxy = eb->xy + pr->idx;
+      for (n=0; n<pr->m; n++, pxy+=2) {
+	 b[0] = fmin(b[0], pxy[0]);
+	 b[1] = fmin(b[1], pxy[1]);
+	 b[2] = fmax(b[2], pxy[0]);
+	 b[3] = fmax(b[3], pxy[1]);
+      }
+   }
+   if (b[0] > b[2])
+      return 0;
+
+   if (pe->kind == GDS_PATH && (pe->has & HAS_WIDTH)) {
+      w = fabs(pe->width) / 2;
+      if ((pe->has & HAS_BGNEXTN) && fabs(pe->bgnextn) > w)
+	 w = fabs(pe->bgnextn);
+      if ((pe->has & HAS_ENDEXTN) && fabs(pe->endextn) > w)
+	 w = fabs(pe->endextn);
+      b[0] -= w;  b[1] -= w;
+      b[2] += w;  b[3] += w;
+   }
+
+   return 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+box_overlap(const double *a, const double *b)
+{
+   return a[0] <= b[2] && b[0] <= a[2] && a[1] <= b[3] && b[1] <= a[3];
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+free_window(window_t *pw)
+{
+   size_t k;
+
+   if (pw->sname) {
+      for (k=0; k<pw->lib.ncell; k++)
+	 free(pw->sname[k]);
+      free(pw->sname);
+   }
+   for (k=0; k<pw->nref; k++)
+      free(pw->rname[k]);
+   free(pw->rname);
+   free(pw->rcell);
+   fl_library_free(&pw->lib);
+   memset(pw, 0, sizeof(window_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cmp_names(const void *a, const void *b)
+{
+   return strcmp(sort_names[*(const size_t *)a], sort_names[*(const size_t *)b]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns the file positions of all structures that must be read.
+ * When no offsets are given, the record headers are scanned up to
+ * the ENDLIB record, or until all selected structures were found.
+ * The returned array must be freed.
+ */
+static struct_pos_t *
+find_structures(map_file_t *mf, const mxArray *snames,
+		double *poff, int noff, long *njobs, size_t *endpos)
+{
+   struct_pos_t *spos = NULL;
+   struct_pos_t *pn;
+   size_t pos;
+   long nalloc = 0;
+   long nsel = 0;
+   long n = 0;
+   uint16_t rtype, rlen;
+   char sname[NLEN];
+   int k;
+
+   /* positions are given */
+   if (noff) {
+      spos = malloc(noff*sizeof(struct_pos_t));
+      if (spos == NULL)
+	 mexErrMsgTxt("gds_read_library_mex :  out of memory.");
+      for (k=0; k<noff; k++) {
+	 if ( map_seek(mf, (size_t)poff[k]) || skip_structure(mf) ) {
+	    free(spos);
+	    mexErrMsgTxt("gds_read_library_mex :  invalid structure offset.");
+	 }
+	 spos[k].beg = (size_t)poff[k];
+	 spos[k].end = map_tell(mf);
+      }
+      *njobs = noff;
+      *endpos = (size_t)poff[noff-1];
+      return spos;
+   }
+
+   if (snames != NULL)
+      nsel = mxGetNumberOfElements(snames);
+
+   /* scan the library */
+   while (1) {
+
+      pos = map_tell(mf);
+      if ( map_record_hdr(mf, &rtype, &rlen) ) {
+	 free(spos);
+	 mexErrMsgTxt("gds_read_library_mex :  could not read record header.");
+      }
+
+      if (rtype == ENDLIB)
+	 break;
+
+      if (rtype != BGNSTR) {
+	 free(spos);
+	 mexErrMsgTxt("gds_read_library_mex :  invalid GDS file - ENDLIB or BGNSTR expected.");
+      }
+
+      /* structure name */
+      sname[0] = '\0';
+      if ( map_ignore(mf, rlen) || map_record_hdr(mf, &rtype, &rlen) || rtype != STRNAME ) {
+	 free(spos);
+	 mexErrMsgTxt("gds_read_library_mex :  invalid STRNAME record.");
+      }
+      if (rlen < NLEN)
+	 map_string(mf, sname, rlen);
+      else
+	 map_ignore(mf, rlen);
+
+      /* skip to the end of the structure */
+      if ( skip_structure(mf) ) {
+	 free(spos);
+	 mexErrMsgTxt("gds_read_library_mex :  could not read record header.");
+      }
+
+      if ( !is_selected(snames, sname) )
+	 continue;
+
+      if (n == nalloc) {
+	 nalloc = nalloc ? 2*nalloc : 256;
+	 pn = realloc(spos, nalloc*sizeof(struct_pos_t));
+	 if (pn == NULL) {
+	    free(spos);
+	    mexErrMsgTxt("gds_read_library_mex :  out of memory.");
+	 }
+	 spos = pn;
+      }
+      spos[n].beg = pos;
+      spos[n++].end = map_tell(mf);
+
+      /* stop when all selected structures were found */
+      if (nsel && n == nsel)
+	 break;
+   }
+
+   *njobs = n;
+   *endpos = map_tell(mf);
+
+   return spos;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * skips the records of a structure up to and including ENDSTR
+ */
+static err_id
+skip_structure(map_file_t *mf)
+{
+   uint16_t rtype, rlen;
+   err_id err;
+
+   while (1) {
+      if ( (err = map_record_hdr(mf, &rtype, &rlen)) )
+	 return err;
+      if (rtype == ENDSTR)
+	 return A_OK;
+      if ( (err = map_ignore(mf, rlen)) )
+	 return err;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * makes sure that the structures from first on are in memory, as
+ * many as fit into the window of a compressed file, but at least
+ * one. Returns the end of the batch, or first after an error.
+ */
+static long
+load_batch(map_file_t *mf, struct_pos_t *pos, long first, long njobs)
+{
+   long k;
+
+   /* the whole file is in memory */
+   if (mf->fob == NULL)
+      return njobs;
+
+   if ( map_seek(mf, pos[first].beg) || map_fill(mf, pos[first].end - pos[first].beg) )
+      return first;
+   for (k=first+1; k<njobs; k++) {
+      if (pos[k].beg < mf->offset || pos[k].end > mf->offset + mf->size)
+	 break;
+   }
+
+   return k;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#if defined HAVE_PTHREADS
+
+/*
+ * decoding thread; takes the next structure and decodes it
+ * as soon as its slot is free.
+ */
+static void *
+decode_thread(void *arg)
+{
+   pool_t *pool = (pool_t *)arg;
+   struct_slot *ps;
+   long job;
+
+   while (1) {
+
+      pthread_mutex_lock(&pool->lock);
+      while (!pool->abort && pool->next < pool->njobs &&
+	     pool->next >= pool->nconv + pool->nslot)
+	 pthread_cond_wait(&pool->freed, &pool->lock);
+      if (pool->abort || pool->next >= pool->njobs) {
+	 pthread_mutex_unlock(&pool->lock);
+	 return NULL;
+      }
+      job = pool->next++;
+      pthread_mutex_unlock(&pool->lock);
+
+      ps = &pool->slot[job % pool->nslot];
+      decode_structure(pool, job, ps);
+
+      pthread_mutex_lock(&pool->lock);
+      pthread_cond_broadcast(&pool->decoded);
+      pthread_mutex_unlock(&pool->lock);
+   }
+}
+
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * decodes a structure into a slot. Only C library functions
+ * may be called here.
+ */
+static void
+decode_structure(pool_t *pool, long job, struct_slot *ps)
+{
+   map_file_t mf;
+   uint16_t rtype, rlen;
+   err_id err;
+
+   /* every thread has its own read position; the window of a
+      compressed file is only moved by the calling thread */
+   mf = *pool->mf;
+   mf.fob = NULL;
+   ps->start = pool->pos[job].beg;
+
+   el_buffer_clear(&ps->eb);
+   if ( map_seek(&mf, ps->start) ) {
+      strcpy(ps->eb.errmsg, "gds_read_library_mex :  invalid structure position.");
+      err = READ_REC_HEADER;
+   }
+   else
+      err = decode_header(&mf, ps);
+
+   while (!err) {
+
+      if ( map_record_hdr(&mf, &rtype, &rlen) ) {
+	 strcpy(ps->eb.errmsg, "gds_read_library_mex :  could not read record header.");
+	 err = READ_REC_HEADER;
+	 break;
+      }
+
+      if (rtype == ENDSTR)
+	 break;
+
+      err = decode_element(&mf, rtype, pool->dbu_to_uu, &ps->eb);
+   }
+
+   /* statistics are computed in parallel */
+   if (!err && pool->stats)
+      err = structure_stats(&ps->eb, &pool->stats[job]);
+
+   ps->end = map_tell(&mf);
+   ps->err = err;
+
+   /* publish the result */
+#if defined HAVE_PTHREADS
+   if (pool->nslot > 1) {
+      pthread_mutex_lock(&pool->lock);
+      ps->job = job;
+      pthread_mutex_unlock(&pool->lock);
+      return;
+   }
+#endif
+   ps->job = job;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads the BGNSTR record with the dates and the STRNAME record
+ */
+static err_id
+decode_header(map_file_t *mf, struct_slot *ps)
+{
+   uint16_t rtype, rlen;
+   char *pn;
+
+   if ( map_record_hdr(mf, &rtype, &rlen) || rtype != BGNSTR ) {
+      strcpy(ps->eb.errmsg, "gds_read_library_mex :  invalid GDS file - BGNSTR expected.");
+      return READ_REC_TYPE;
+   }
+
+   /* read dates */
+   if ( map_word_n(mf, ps->cdate, 6) || map_word_n(mf, ps->mdate, 6) ) {
+      strcpy(ps->eb.errmsg, "gds_read_library_mex :  failed to read structure dates.");
+      return READ_WORD;
+   }
+
+   /* STRNAME record */
+   if ( map_record_hdr(mf, &rtype, &rlen) || rtype != STRNAME ) {
+      strcpy(ps->eb.errmsg, "gds_read_library_mex :  invalid STRNAME record.");
+      return READ_REC_TYPE;
+   }
+   if ((size_t)rlen + 1 > ps->asname) {
+      pn = realloc(ps->sname, rlen + 1);
+      if (pn == NULL) {
+	 strcpy(ps->eb.errmsg, "gds_read_library_mex :  out of memory.");
+	 return READ_REC_DATA;
+      }
+      ps->sname = pn;
+      ps->asname = rlen + 1;
+   }
+   if ( map_string(mf, ps->sname, rlen) ) {
+      strcpy(ps->eb.errmsg, "gds_read_library_mex :  failed to read structure name.");
+      return READ_CHAR;
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns the elements of a decoded structure as a structure array
+ * with the layout of gds_element objects (a single field 'data'),
+ * which is converted to an object array with one call to 'class'
+ */
+static mxArray *
+slot_elements(struct_slot *ps)
+{
+   const char *fields[] = {"data"};
+   mxArray *pa;
+   size_t k;
+
+   pa = mxCreateStructMatrix(1, ps->eb.nel, 1, fields);
+   for (k=0; k<ps->eb.nel; k++)
+      mxSetFieldByNumber(pa, k, 0, element_to_array(&ps->eb, k));
+
+   return pa;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+default_threads(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * how much of a file was read through a descriptor
+ */
+static double
+file_offset(int fd)
+{
+#if !defined _WIN32
+   return (double)lseek(fd, 0, SEEK_CUR);
+#else
+   return 0.0;  /* no compressed files */
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+unmap_file(void)
+{
+   map_close(&libmap, NULL);
+   free_window(&whier);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+is_selected(const mxArray *snames, const char *sname)
+{
+   char buf[NLEN];
+   int k, n;
+
+   if (snames == NULL)
+      return 1;
+
+   n = mxGetNumberOfElements(snames);
+   for (k=0; k<n; k++) {
+      if ( mxGetString(mxGetCell(snames, k), buf, NLEN) )
+	 continue;
+      if ( !strcmp(buf, sname) )
+	 return 1;
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray*
+date_array(uint16_t *date)
+{
+   mxArray *pa;
+   double *pd;
+   int k;
+
+   pa = mxCreateDoubleMatrix(1, 6, mxREAL);
+   pd = mxGetData(pa);
+   for (k=0; k<6; k++)
+      pd[k] = (double)date[k];
+
+   return pa;
+}
+
+/*-----------------------------------------------------------------*/
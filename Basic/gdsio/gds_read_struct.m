@@ -1,12 +1,32 @@
-function [gst] = gds_read_struct(gf, uunit, dbunit)
+function [gst] = gds_read_struct(gf, uunit, dbunit, offset, lazy)
 %
 % read all elements contained in a structure and return 
 % a gds_structure object 
 %
+% gf :      file handle returned by gds_open
+% uunit :   user unit in m
+% dbunit :  database unit in m
+% offset :  (Optional) file position of the BGNSTR record of the
+%           structure (see gds_library_index). When omitted, the 
+%           BGNSTR record header must have been read already.
+% lazy :    (Optional) when > 0, the XY and property records of the
+%           elements are decoded when they are accessed (see
+%           read_gds_library). Default is 0.
+%
 
 % renamed 'gdsii_read_struct' --> gds_read_struct' and rewritten
 % for the new C-based low level I/O. U. Griesmann, Jan. 2013
 
+    if nargin < 5, lazy = 0; end
+
+    % go directly to the structure
+    if nargin > 3 && ~isempty(offset)
+        gds_fseek(gf, offset);
+        if gds_record_info(gf) ~= 1282 % BGNSTR
+            error('gds_read_struct :  no structure at file position.');
+        end
+    end
+
     % read structure header data
     [sname, cdate, mdate] = gds_structdata(gf);
 
@@ -23,7 +43,7 @@ function [gst] = gds_read_struct(gf, uunit, dbunit)
         end
         
         % if not, read element data
-        data = gds_read_element(gf, rtype, dbunit/uunit);
+        data = gds_read_element(gf, rtype, dbunit/uunit, lazy);
         
         % create element object and add to cell array
         elist{end+1} = gds_element('_file_', data);
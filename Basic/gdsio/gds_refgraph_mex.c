@@ -0,0 +1,236 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Builds the reference graph of the structures in a library (see
+ * refgraph.h). The structure names are interned in a hash table,
+ * the references are stored as a sparse graph in compressed row
+ * format, and the topological order of the structures and the
+ * structures in cycles are determined in linear time.
+ *
+ * G = gds_refgraph_mex(names, refs, counts);
+ *
+ * Input:
+ * names :   cell array with the N structure names
+ * refs :    cell array with N cell arrays containing the names
+ *           of the structures referenced by each structure
+ * counts :  (Optional) cell array with N vectors containing the
+ *           number of instances placed by each reference. Default
+ *           is 1 instance per reference.
+ *
+ * Output:
+ * G :  structure with the fields
+ *        G.names   : the structure names
+ *        G.rowptr  : (N+1) x 1 vector; the children of structure k
+ *                    are G.child(G.rowptr(k)+1:G.rowptr(k+1))
+ *        G.child   : E x 1 vector with child structure indices
+ *        G.count   : E x 1 vector with the number of child instances
+ *        G.nparent : N x 1 vector with the number of parents
+ *        G.order   : topological order of the structures; each
+ *                    structure follows all structures it references.
+ *                    Structures in or above cycles are missing.
+ *        G.top     : indices of the structures without parents
+ *        G.cyclic  : N x 1 logical vector; true for structures in cycles
+ *        G.missing : cell array with the names of referenced
+ *                    structures that are not in names
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "refgraph.h"
+
+#define NLEN  256
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static mxArray *graph_to_array(refgraph_t *g, const mxArray *names, nametab_t *missing);
+static void failed(const char *msg);
+
+static nametab_t tab, missing;
+static refgraph_t graph;
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   mxArray *pr, *pc;
+   uint32_t *src, *dst;
+   double *cnt = NULL, *pd;
+   size_t k, m, n, nr, nedge;
+   int32_t idx;
+   int added;
+   char sname[NLEN];
+
+   /* check arguments */
+   if (nrhs < 2)
+      mexErrMsgTxt("gds_refgraph_mex :  at least 2 arguments required.");
+   if ( !mxIsCell(prhs[0]) || !mxIsCell(prhs[1]) )
+      mexErrMsgTxt("gds_refgraph_mex :  names and refs must be cell arrays.");
+   n = mxGetNumberOfElements(prhs[0]);
+   if (mxGetNumberOfElements(prhs[1]) != n)
+      mexErrMsgTxt("gds_refgraph_mex :  names and refs must have the same length.");
+   if (nrhs > 2 && !mxIsEmpty(prhs[2])) {
+      if ( !mxIsCell(prhs[2]) || mxGetNumberOfElements(prhs[2]) != n )
+	 mexErrMsgTxt("gds_refgraph_mex :  counts must be a cell array like refs.");
+   }
+
+   /* intern the structure names; duplicates refer to the first one */
+   if ( nametab_init(&tab, n) || nametab_init(&missing, 16) )
+      failed("out of memory");
+   for (k=0; k<n; k++) {
+      if ( mxGetString(mxGetCell(prhs[0], k), sname, NLEN) )
+	 failed("structure names must be strings");
+      if (nametab_intern(&tab, sname, &added) < 0)
+	 failed("out of memory");
+   }
+
+   /* collect the references */
+   nedge = 0;
+   for (k=0; k<n; k++) {
+      pr = mxGetCell(prhs[1], k);
+      if (pr != NULL)
+	 nedge += mxGetNumberOfElements(pr);
+   }
+   src = mxMalloc((nedge ? nedge : 1) * sizeof(uint32_t));
+   dst = mxMalloc((nedge ? nedge : 1) * sizeof(uint32_t));
+   if (nrhs > 2 && !mxIsEmpty(prhs[2]))
+      cnt = mxMalloc((nedge ? nedge : 1) * sizeof(double));
+
+   nedge = 0;
+   for (k=0; k<n; k++) {
+      pr = mxGetCell(prhs[1], k);
+      if (pr == NULL || mxIsEmpty(pr))
+	 continue;
+      if ( !mxIsCell(pr) )
+	 failed("references must be cell arrays of names");
+      nr = mxGetNumberOfElements(pr);
+      pd = NULL;
+      if (cnt) {
+	 pc = mxGetCell(prhs[2], k);
+	 if (pc == NULL || !mxIsDouble(pc) || mxGetNumberOfElements(pc) != nr)
+	    failed("counts must have one entry per reference");
+	 pd = mxGetPr(pc);
+      }
+      for (m=0; m<nr; m++) {
+	 if ( mxGetString(mxGetCell(pr, m), sname, NLEN) )
+	    failed("referenced structure names must be strings");
+	 if ( (idx = nametab_find(&tab, sname)) < 0 ) {
+	    if (nametab_intern(&missing, sname, &added) < 0)
+	       failed("out of memory");
+	    continue;
+	 }
+	 src[nedge] = k;
+	 dst[nedge] = idx;
+	 if (cnt)
+	    cnt[nedge] = pd[m];
+	 nedge++;
+      }
+   }
+
+   /* build the graph */
+   if ( refgraph_build(&graph, n, src, dst, cnt, nedge) )
+      failed("out of memory");
+   mxFree(src);
+   mxFree(dst);
+   if (cnt)
+      mxFree(cnt);
+
+   plhs[0] = graph_to_array(&graph, prhs[0], &missing);
+
+   refgraph_free(&graph);
+   nametab_free(&tab);
+   nametab_free(&missing);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+failed(const char *msg)
+{
+   char errmsg[NLEN];
+
+   refgraph_free(&graph);
+   nametab_free(&tab);
+   nametab_free(&missing);
+   sprintf(errmsg, "gds_refgraph_mex :  %s.", msg);
+   mexErrMsgTxt(errmsg);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static mxArray *
+graph_to_array(refgraph_t *g, const mxArray *names, nametab_t *missing)
+{
+   const char *fields[] = {"names", "rowptr", "child", "count", "nparent",
+			   "order", "top", "cyclic", "missing"};
+   mxArray *ps, *pa;
+   mxLogical *pl;
+   double *pd;
+   size_t k, ntop;
+
+   ps = mxCreateStructMatrix(1, 1, 9, fields);
+
+   mxSetFieldByNumber(ps, 0, 0, mxDuplicateArray(names));
+
+   pa = mxCreateDoubleMatrix(g->n + 1, 1, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<=g->n; k++)
+      pd[k] = g->rowptr[k];
+   mxSetFieldByNumber(ps, 0, 1, pa);
+
+   pa = mxCreateDoubleMatrix(g->nedge, 1, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<g->nedge; k++)
+      pd[k] = g->child[k] + 1;
+   mxSetFieldByNumber(ps, 0, 2, pa);
+
+   pa = mxCreateDoubleMatrix(g->nedge, 1, mxREAL);
+   if (g->nedge)
+      memcpy(mxGetPr(pa), g->count, g->nedge * sizeof(double));
+   mxSetFieldByNumber(ps, 0, 3, pa);
+
+   pa = mxCreateDoubleMatrix(g->n, 1, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0, ntop=0; k<g->n; k++) {
+      pd[k] = g->nparent[k];
+      if (!g->nparent[k])
+	 ntop++;
+   }
+   mxSetFieldByNumber(ps, 0, 4, pa);
+
+   pa = mxCreateDoubleMatrix(1, g->norder, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<g->norder; k++)
+      pd[k] = g->order[k] + 1;
+   mxSetFieldByNumber(ps, 0, 5, pa);
+
+   pa = mxCreateDoubleMatrix(1, ntop, mxREAL);
+   pd = mxGetPr(pa);
+   for (k=0; k<g->n; k++)
+      if (!g->nparent[k])
+	 *pd++ = k + 1;
+   mxSetFieldByNumber(ps, 0, 6, pa);
+
+   pa = mxCreateLogicalMatrix(g->n, 1);
+   pl = mxGetLogicals(pa);
+   for (k=0; k<g->n; k++)
+      pl[k] = g->cyclic[k];
+   mxSetFieldByNumber(ps, 0, 7, pa);
+
+   pa = mxCreateCellMatrix(1, missing->n);
+   for (k=0; k<missing->n; k++)
+      mxSetCell(pa, k, mxCreateString(missing->name[k]));
+   mxSetFieldByNumber(ps, 0, 8, pa);
+
+   return ps;
+}
@@ -0,0 +1,185 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Returns the counters and timers of the functions that read and
+ * write GDSII libraries and of poly_boolmex (see gdsstats.h). The
+ * counters are only collected when the mex functions were compiled
+ * with GDS_STATS defined, e.g. with 'GDS_STATS=1 ./makemex-octave';
+ * otherwise all counters are zero.
+ *
+ * S = gds_stats;
+ * S = gds_stats('reset');
+ *
+ * Input
+ * 'reset' : (Optional) clears the counters after they are returned.
+ *
+ * Output
+ * S :  a structure with the fields
+ *      records_read      : number of records read
+ *      bytes_read        : number of bytes read
+ *      records_written   : number of records written
+ *      bytes_written     : number of bytes written
+ *      vertices_read     : vertices of the elements read
+ *      vertices_written  : vertices of the elements written
+ *      allocations       : number of buffer and element list allocations
+ *      allocated_bytes   : bytes of these allocations
+ *      clipper_calls     : number of Clipper executions in poly_boolmex
+ *      clipper_vertices_in  : vertices of the Clipper operands
+ *      clipper_vertices_out : vertices of the Clipper results
+ *      clipper_time      : time spent in Clipper in seconds
+ *      rec_read          : structure with the number of records read
+ *                          for each record type, e.g. S.rec_read.XY
+ *      rec_written       : the same for the records written
+ *      el_read           : structure with the number of elements read
+ *                          for each element type, e.g. S.el_read.boundary
+ *      el_read_time      : time spent reading each element type in seconds
+ *      el_written        : number of elements written for each element type
+ *      el_written_time   : time spent writing each element type in seconds
+ *      Record and element types that do not occur are omitted.
+ */
+
+#include <string.h>
+#include <stddef.h>
+#include "mex.h"
+
+#include "gdsstats.h"
+
+#define ARGLEN 8
+
+/* index of the first counter of an array in gds_stats_t */
+#define ST_OFFSET(f) (offsetof(gds_stats_t, f) / sizeof(uint64_t))
+
+
+/*-- Data ---------------------------------------------------------*/
+
+static const char *rec_name[] = {
+   "HEADER", "BGNLIB", "LIBNAME", "UNITS", "ENDLIB", "BGNSTR",
+   "STRNAME", "ENDSTR", "BOUNDARY", "PATH", "SREF", "AREF", "TEXT",
+   "LAYER", "DATATYPE", "WIDTH", "XY", "ENDEL", "SNAME", "COLROW",
+   "TEXTNODE", "NODE", "TEXTTYPE", "PRESENTATION", "SPACING", "STRING",
+   "STRANS", "MAG", "ANGLE", "UINTEGER", "USTRING", "REFLIBS", "FONTS",
+   "PATHTYPE", "GENERATIONS", "ATTRTABLE", "STYPTABLE", "STRTYPE",
+   "ELFLAGS", "ELKEY", "LINKTYPE", "LINKKEYS", "NODETYPE", "PROPATTR",
+   "PROPVALUE", "BOX", "BOXTYPE", "PLEX", "BGNEXTN", "ENDEXTN",
+   "TAPENUM", "TAPECODE", "STRCLASS", "RESERVED", "FORMAT", "MASK",
+   "ENDMASKS", "LIBDIRSIZE", "SRFNAME", "LIBSECUR"};
+
+#define NREC (sizeof(rec_name) / sizeof(rec_name[0]))
+
+static const char *kind_name[] = {"", "boundary", "path", "box", "node",
+                                  "text", "sref", "aref"};
+
+static const char *count_name[] = {
+   "records_read", "bytes_read", "records_written", "bytes_written",
+   "vertices_read", "vertices_written", "allocations", "allocated_bytes",
+   "clipper_calls", "clipper_vertices_in", "clipper_vertices_out",
+   "clipper_time"};
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static mxArray *count_struct(const double *pc, const char **names, int n, double scale);
+static void set_scalar(mxArray *ps, const char *name, double val);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   mxArray *pv;
+   const double *pc;
+   double *pz;
+   char arg[ARGLEN];
+   int reset = 0;
+   int k;
+
+   /* check arguments */
+   if (nrhs > 1)
+      mexErrMsgTxt("gds_stats :  at most one input argument expected.");
+   if (nrhs == 1) {
+      if ( !mxIsChar(prhs[0]) || mxGetString(prhs[0], arg, ARGLEN) || strcmp(arg, "reset") )
+	 mexErrMsgTxt("gds_stats :  argument must be 'reset'.");
+      reset = 1;
+   }
+
+   /* counters of all mex functions */
+   pv = mexGetVariable("global", GDS_STATS_VAR);
+   if (pv == NULL || !mxIsDouble(pv) || mxGetNumberOfElements(pv) != ST_NTOTAL) {
+      if (pv != NULL)
+	 mxDestroyArray(pv);
+      pv = mxCreateDoubleMatrix(1, ST_NTOTAL, mxREAL);
+   }
+   pc = mxGetPr(pv);
+
+   /* return them as a structure */
+   if (nlhs > 0 || !reset) {
+      plhs[0] = mxCreateStructMatrix(1,1, 0, NULL);
+      for (k=0; k<ST_NCOUNT; k++)
+	 set_scalar(plhs[0], count_name[k], k == ST_CLIP_NS ? 1e-9 * pc[k] : pc[k]);
+      mxAddField(plhs[0], "rec_read");
+      mxSetField(plhs[0], 0, "rec_read",
+		 count_struct(pc + ST_OFFSET(rec_read), rec_name, NREC, 1.0));
+      mxAddField(plhs[0], "rec_written");
+      mxSetField(plhs[0], 0, "rec_written",
+		 count_struct(pc + ST_OFFSET(rec_written), rec_name, NREC, 1.0));
+      mxAddField(plhs[0], "el_read");
+      mxSetField(plhs[0], 0, "el_read",
+		 count_struct(pc + ST_OFFSET(el_read), kind_name, ST_NKIND, 1.0));
+      mxAddField(plhs[0], "el_read_time");
+      mxSetField(plhs[0], 0, "el_read_time",
+		 count_struct(pc + ST_OFFSET(ns_read), kind_name, ST_NKIND, 1e-9));
+      mxAddField(plhs[0], "el_written");
+      mxSetField(plhs[0], 0, "el_written",
+		 count_struct(pc + ST_OFFSET(el_written), kind_name, ST_NKIND, 1.0));
+      mxAddField(plhs[0], "el_written_time");
+      mxSetField(plhs[0], 0, "el_written_time",
+		 count_struct(pc + ST_OFFSET(ns_written), kind_name, ST_NKIND, 1e-9));
+   }
+
+   /* clear the counters */
+   if (reset) {
+      pz = mxGetPr(pv);
+      for (k=0; k<(int)ST_NTOTAL; k++)
+	 pz[k] = 0.0;
+      mexPutVariable("global", GDS_STATS_VAR, pv);
+   }
+
+   mxDestroyArray(pv);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * structure with one field for each non-zero counter
+ */
+static mxArray *
+count_struct(const double *pc, const char **names, int n, double scale)
+{
+   mxArray *ps;
+   int k;
+
+   ps = mxCreateStructMatrix(1,1, 0, NULL);
+   for (k=0; k<n; k++) {
+      if (pc[k] != 0.0 && names[k][0])
+	 set_scalar(ps, names[k], scale * pc[k]);
+   }
+
+   return ps;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+set_scalar(mxArray *ps, const char *name, double val)
+{
+   mxAddField(ps, name);
+   mxSetField(ps, 0, name, mxCreateDoubleScalar(val));
+}
+
+/*-----------------------------------------------------------------*/
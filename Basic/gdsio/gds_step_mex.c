@@ -0,0 +1,376 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Extrudes polygons into prisms and writes them as B-rep solids to
+ * a STEP file (see stepwrite.h). The polygons are passed in a packed
+ * vertex buffer, e.g. the layer output of gds_flatten_mex, with the
+ * z range of every polygon.
+ *
+ * ns = gds_step_mex(fname, xy, nv, z, scale, group, names, rgb, ...
+ *                   schema, tol, product);
+ *
+ * A file can also be written in parts, e.g. tile by tile:
+ *
+ * h = gds_step_mex('open', fname, names, rgb, schema, tol, product);
+ * gds_step_mex('write', h, xy, nv, z, scale, group);
+ * ns = gds_step_mex('close', h);
+ *
+ * Input:
+ * fname :   name of the STEP file
+ * xy :      V x 2 matrix with the vertices of all polygons
+ * nv :      vector with the number of vertices of each polygon
+ * z :       N x 2 matrix with the bottom and top of each polygon
+ * scale :   (Optional) factor applied to all coordinates. Default 1.
+ * group :   (Optional) vector with the group (e.g. the layer) of each
+ *           polygon; one-based indices into names and rgb.
+ * names :   (Optional) cell array with the group names; solids are
+ *           named by their group.
+ * rgb :     (Optional) G x 3 matrix with group colors (0..1); only
+ *           written to AP214 files.
+ * schema :  (Optional) 'AP203' or 'AP214'. Default is 'AP214'.
+ * tol :     (Optional) length uncertainty. Default 1e-6.
+ * product : (Optional) product name. Default is 'gds_solids'.
+ *
+ * Output:
+ * ns :  number of solids written to the STEP file
+ * h :   handle of a STEP file that is written in parts (a pointer,
+ *       stored like the file handles of gds_open)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "stepwrite.h"
+
+
+/*-----------------------------------------------------------------*/
+
+static const char *
+step_error(int err)
+{
+   switch (err) {
+   case STEP_ERR_OPEN:
+      return "gds_step_mex :  could not open STEP file.";
+   case STEP_ERR_WRITE:
+      return "gds_step_mex :  could not write STEP file.";
+   case STEP_ERR_MEMORY:
+      return "gds_step_mex :  out of memory.";
+   case STEP_ERR_GROUP:
+      return "gds_step_mex :  group index out of range.";
+   }
+   return "gds_step_mex :  unknown error.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * prisms from the xy, nv and z arguments; returns the polygon
+ * offsets, which must be freed with mxFree
+ */
+static size_t *
+get_prisms(const mxArray *axy, const mxArray *anv, const mxArray *az, prisms_t *pr)
+{
+   size_t *off;
+   double *pv;
+   size_t k, n, V;
+
+   if ( !mxIsDouble(axy) || (mxGetN(axy) != 2 && !mxIsEmpty(axy)) )
+      mexErrMsgTxt("gds_step_mex :  xy must be a V x 2 matrix.");
+   if ( !mxIsDouble(anv) )
+      mexErrMsgTxt("gds_step_mex :  nv must be a vector of doubles.");
+
+   V = mxGetM(axy);
+   n = mxGetNumberOfElements(anv);
+   if ( !mxIsDouble(az) || mxGetM(az) != n || mxGetN(az) != 2 )
+      mexErrMsgTxt("gds_step_mex :  z must be a N x 2 matrix.");
+
+   /* polygon offsets */
+   pv = mxGetPr(anv);
+   off = mxMalloc((n + 1) * sizeof(size_t));
+   off[0] = 0;
+   for (k=0; k<n; k++) {
+      if (pv[k] < 0)
+	 mexErrMsgTxt("gds_step_mex :  vertex numbers must be positive.");
+      off[k+1] = off[k] + (size_t)pv[k];
+   }
+   if (off[n] != V)
+      mexErrMsgTxt("gds_step_mex :  sum(nv) must equal the number of vertices.");
+
+   pr->x = mxGetPr(axy);
+   pr->y = pr->x + V;
+   pr->off = off;
+   pr->zb = mxGetPr(az);
+   pr->zt = pr->zb + n;
+   pr->npoly = n;
+   pr->scale = 1.0;
+
+   return off;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * zero-based groups from one-based group indices; G is the number
+ * of groups or 0 when the range is checked when the file is written
+ */
+static uint32_t *
+get_group(const mxArray *ag, size_t n, size_t G)
+{
+   uint32_t *group;
+   double *pv;
+   size_t k;
+
+   if ( !mxIsDouble(ag) || mxGetNumberOfElements(ag) != n )
+      mexErrMsgTxt("gds_step_mex :  group must have one element per polygon.");
+   pv = mxGetPr(ag);
+   group = mxMalloc((n ? n : 1) * sizeof(uint32_t));
+   for (k=0; k<n; k++) {
+      if (pv[k] < 1 || (G && pv[k] > G))
+	 mexErrMsgTxt("gds_step_mex :  group index out of range.");
+      group[k] = (uint32_t)pv[k] - 1;
+   }
+
+   return group;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * file options from the names, rgb, schema, tol and product
+ * arguments; unused arguments are NULL
+ */
+typedef struct {
+   step_options_t opt;
+   char **gname;
+   char *product;
+   size_t G;
+} step_args_t;
+
+
+static void
+get_options(const mxArray *anames, const mxArray *argb, const mxArray *aschema,
+	    const mxArray *atol, const mxArray *aproduct, step_args_t *sa)
+{
+   char *schema;
+   size_t k;
+
+   memset(sa, 0, sizeof(step_args_t));
+   sa->opt.ap214 = 1;
+   sa->opt.tolerance = 1e-6;
+
+   /* names and colors */
+   if (anames && !mxIsEmpty(anames)) {
+      if ( !mxIsCell(anames) )
+	 mexErrMsgTxt("gds_step_mex :  names must be a cell array.");
+      sa->G = mxGetNumberOfElements(anames);
+      sa->gname = mxCalloc(sa->G, sizeof(char *));
+      for (k=0; k<sa->G; k++) {
+	 if ( !mxIsChar(mxGetCell(anames, k)) )
+	    mexErrMsgTxt("gds_step_mex :  names must be strings.");
+	 sa->gname[k] = mxArrayToString(mxGetCell(anames, k));
+      }
+   }
+   if (argb && !mxIsEmpty(argb)) {
+      if ( !mxIsDouble(argb) || mxGetN(argb) != 3 )
+	 mexErrMsgTxt("gds_step_mex :  rgb must be a G x 3 matrix.");
+      if (sa->G == 0)
+	 sa->G = mxGetM(argb);
+      else if (mxGetM(argb) != sa->G)
+	 mexErrMsgTxt("gds_step_mex :  rgb must have one row per name.");
+      sa->opt.rgb = mxGetPr(argb);
+   }
+   sa->opt.ngroup = sa->G;
+   sa->opt.gname = (const char *const *)sa->gname;
+
+   if (aschema && !mxIsEmpty(aschema)) {
+      schema = mxArrayToString(aschema);
+      if ( !strcmp(schema, "AP203") || !strcmp(schema, "ap203") )
+	 sa->opt.ap214 = 0;
+      else if ( strcmp(schema, "AP214") && strcmp(schema, "ap214") )
+	 mexErrMsgTxt("gds_step_mex :  schema must be 'AP203' or 'AP214'.");
+      mxFree(schema);
+   }
+   if (atol && !mxIsEmpty(atol))
+      sa->opt.tolerance = mxGetScalar(atol);
+   if (aproduct && !mxIsEmpty(aproduct)) {
+      sa->product = mxArrayToString(aproduct);
+      sa->opt.product = sa->product;
+   }
+}
+
+
+static void
+free_options(step_args_t *sa)
+{
+   size_t k;
+
+   if (sa->gname) {
+      for (k=0; k<sa->G; k++)
+	 mxFree(sa->gname[k]);
+      mxFree(sa->gname);
+   }
+   if (sa->product)
+      mxFree(sa->product);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * handles of files written in parts
+ */
+static mxArray *
+make_handle(step_file_t *st)
+{
+   mxArray *h;
+
+   if ( sizeof(step_file_t *) == 4 )
+      h = mxCreateNumericMatrix(1, 1, mxUINT32_CLASS, mxREAL);
+   else if ( sizeof(step_file_t *) == 8 )
+      h = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+   else
+      mexErrMsgTxt("gds_step_mex :  pointer size is neither 4 nor 8 bytes.");
+   *(step_file_t **)mxGetData(h) = st;
+
+   return h;
+}
+
+
+static step_file_t *
+get_handle(const mxArray *h)
+{
+   step_file_t *st;
+
+   if ( (sizeof(step_file_t *) == 4 && !mxIsUint32(h)) ||
+        (sizeof(step_file_t *) == 8 && !mxIsUint64(h)) ||
+        mxGetNumberOfElements(h) != 1 )
+      mexErrMsgTxt("gds_step_mex :  argument is not a STEP file handle.");
+   st = *(step_file_t **)mxGetData(h);
+   if (st == NULL)
+      mexErrMsgTxt("gds_step_mex :  STEP file is not open.");
+
+   return st;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#define ARG(k)  (nrhs > (k) ? prhs[k] : NULL)
+
+/*
+ * open, write and close commands
+ */
+static void
+step_command(int nlhs, mxArray *plhs[],
+	     int nrhs, const mxArray *prhs[])
+{
+   prisms_t pr;
+   step_args_t sa;
+   step_file_t *st;
+   uint32_t *group = NULL;
+   size_t *off, nsolid;
+   char cmd[8], *fname;
+   int err;
+
+   (void)nlhs;
+   if ( mxGetString(prhs[0], cmd, sizeof(cmd)) )
+      mexErrMsgTxt("gds_step_mex :  unknown command.");
+
+   if ( !strcmp(cmd, "open") ) {
+      if ( !mxIsChar(prhs[1]) )
+	 mexErrMsgTxt("gds_step_mex :  file name must be a string.");
+      get_options(ARG(2), ARG(3), ARG(4), ARG(5), ARG(6), &sa);
+      fname = mxArrayToString(prhs[1]);
+      st = step_open(fname, &sa.opt, &err);
+      mxFree(fname);
+      free_options(&sa);
+      if (st == NULL)
+	 mexErrMsgTxt(step_error(err));
+      plhs[0] = make_handle(st);
+   }
+   else if ( !strcmp(cmd, "write") ) {
+      if (nrhs < 5)
+	 mexErrMsgTxt("gds_step_mex :  write requires a handle, xy, nv and z.");
+      st = get_handle(prhs[1]);
+      off = get_prisms(prhs[2], prhs[3], prhs[4], &pr);
+      if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+	 pr.scale = mxGetScalar(prhs[5]);
+      if (nrhs > 6 && !mxIsEmpty(prhs[6]))
+	 group = get_group(prhs[6], pr.npoly, 0);
+      err = step_append_prisms(st, &pr, group);
+      mxFree(off);
+      if (group)
+	 mxFree(group);
+      if (err)
+	 mexErrMsgTxt(step_error(err));
+   }
+   else if ( !strcmp(cmd, "close") ) {
+      st = get_handle(prhs[1]);
+      err = step_close(st, &nsolid);
+      if (err)
+	 mexErrMsgTxt(step_error(err));
+      plhs[0] = mxCreateDoubleScalar((double)nsolid);
+   }
+   else
+      mexErrMsgTxt("gds_step_mex :  unknown command.");
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   prisms_t pr;
+   step_args_t sa;
+   size_t *off;
+   uint32_t *group = NULL;
+   char *fname;
+   size_t nsolid;
+   int err;
+
+   /* commands for files written in parts */
+   if (nrhs >= 2 && mxIsChar(prhs[0]) && !mxIsDouble(prhs[1])) {
+      step_command(nlhs, plhs, nrhs, prhs);
+      return;
+   }
+
+   /* check arguments */
+   if (nrhs < 4)
+      mexErrMsgTxt("gds_step_mex :  at least 4 arguments required.");
+   if ( !mxIsChar(prhs[0]) )
+      mexErrMsgTxt("gds_step_mex :  file name must be a string.");
+
+   off = get_prisms(prhs[1], prhs[2], prhs[3], &pr);
+   if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+      pr.scale = mxGetScalar(prhs[4]);
+
+   /* groups, names and colors */
+   get_options(ARG(6), ARG(7), ARG(8), ARG(9), ARG(10), &sa);
+   if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+      group = get_group(prhs[5], pr.npoly, sa.G);
+   sa.opt.group = group;
+   if (group == NULL)
+      sa.opt.ngroup = 0;
+
+   fname = mxArrayToString(prhs[0]);
+   err = step_write_prisms(fname, &pr, &sa.opt, &nsolid);
+
+   mxFree(fname);
+   mxFree(off);
+   if (group)
+      mxFree(group);
+   free_options(&sa);
+   if (err)
+      mexErrMsgTxt(step_error(err));
+
+   plhs[0] = mxCreateDoubleScalar((double)nsolid);
+}
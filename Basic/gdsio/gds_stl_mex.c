@@ -0,0 +1,282 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Extrudes polygons into prisms and writes them to a binary STL
+ * file, or returns them as an indexed mesh (see stlwrite.h). The
+ * polygons are passed in a packed vertex buffer, e.g. the layer
+ * output of gds_flatten_mex, with the z range of every polygon.
+ *
+ * nf = gds_stl_mex(fname, xy, nv, z, scale, nthreads);
+ * [V, F] = gds_stl_mex([], xy, nv, z, scale, nthreads);
+ *
+ * A file can also be written in parts, e.g. tile by tile:
+ *
+ * h = gds_stl_mex('open', fname, nthreads);
+ * gds_stl_mex('write', h, xy, nv, z, scale);
+ * nf = gds_stl_mex('close', h);
+ *
+ * Input:
+ * fname :    name of the STL file. When empty, no file is written
+ *            and the indexed mesh is returned.
+ * xy :       V x 2 matrix with the vertices of all polygons
+ * nv :       vector with the number of vertices of each polygon
+ * z :        N x 2 matrix with the bottom and top of each polygon
+ * scale :    (Optional) factor applied to all coordinates. Default 1.
+ * nthreads : (Optional) number of threads. Default is 0 (one thread
+ *            per processor).
+ *
+ * Output:
+ * nf :  number of facets written to the STL file
+ * V :   M x 3 matrix with the prism vertices; caps and side walls
+ *       of a prism share their vertices
+ * F :   K x 3 matrix with one-based vertex indices of the outward
+ *       facing triangles
+ * h :   handle of an STL file that is written in parts (a pointer,
+ *       stored like the file handles of gds_open)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+
+#include "stlwrite.h"
+
+#define STL_HEADER "Binary STL file created by gdsii-toolbox-146 (gds_write_stl)"
+
+
+/*-----------------------------------------------------------------*/
+
+static const char *
+stl_error(int err)
+{
+   switch (err) {
+   case STL_ERR_OPEN:
+      return "gds_stl_mex :  could not open STL file.";
+   case STL_ERR_WRITE:
+      return "gds_stl_mex :  could not write STL file.";
+   case STL_ERR_MEMORY:
+      return "gds_stl_mex :  out of memory.";
+   case STL_ERR_COUNT:
+      return "gds_stl_mex :  too many facets for an STL file.";
+   }
+   return "gds_stl_mex :  unknown error.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * prisms from the xy, nv and z arguments; returns the polygon
+ * offsets, which must be freed with mxFree
+ */
+static size_t *
+get_prisms(const mxArray *axy, const mxArray *anv, const mxArray *az, prisms_t *pr)
+{
+   size_t *off;
+   double *pv;
+   size_t k, n, V;
+
+   if ( !mxIsDouble(axy) || (mxGetN(axy) != 2 && !mxIsEmpty(axy)) )
+      mexErrMsgTxt("gds_stl_mex :  xy must be a V x 2 matrix.");
+   if ( !mxIsDouble(anv) )
+      mexErrMsgTxt("gds_stl_mex :  nv must be a vector of doubles.");
+
+   V = mxGetM(axy);
+   n = mxGetNumberOfElements(anv);
+   if ( !mxIsDouble(az) || mxGetM(az) != n || mxGetN(az) != 2 )
+      mexErrMsgTxt("gds_stl_mex :  z must be a N x 2 matrix.");
+
+   /* polygon offsets */
+   pv = mxGetPr(anv);
+   off = mxMalloc((n + 1) * sizeof(size_t));
+   off[0] = 0;
+   for (k=0; k<n; k++) {
+      if (pv[k] < 0)
+	 mexErrMsgTxt("gds_stl_mex :  vertex numbers must be positive.");
+      off[k+1] = off[k] + (size_t)pv[k];
+   }
+   if (off[n] != V)
+      mexErrMsgTxt("gds_stl_mex :  sum(nv) must equal the number of vertices.");
+
+   pr->x = mxGetPr(axy);
+   pr->y = pr->x + V;
+   pr->off = off;
+   pr->zb = mxGetPr(az);
+   pr->zt = pr->zb + n;
+   pr->npoly = n;
+   pr->scale = 1.0;
+
+   return off;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * handles of files written in parts
+ */
+static mxArray *
+make_handle(stl_file_t *sf)
+{
+   mxArray *h;
+
+   if ( sizeof(stl_file_t *) == 4 )
+      h = mxCreateNumericMatrix(1, 1, mxUINT32_CLASS, mxREAL);
+   else if ( sizeof(stl_file_t *) == 8 )
+      h = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+   else
+      mexErrMsgTxt("gds_stl_mex :  pointer size is neither 4 nor 8 bytes.");
+   *(stl_file_t **)mxGetData(h) = sf;
+
+   return h;
+}
+
+
+static stl_file_t *
+get_handle(const mxArray *h)
+{
+   stl_file_t *sf;
+
+   if ( (sizeof(stl_file_t *) == 4 && !mxIsUint32(h)) ||
+        (sizeof(stl_file_t *) == 8 && !mxIsUint64(h)) ||
+        mxGetNumberOfElements(h) != 1 )
+      mexErrMsgTxt("gds_stl_mex :  argument is not an STL file handle.");
+   sf = *(stl_file_t **)mxGetData(h);
+   if (sf == NULL)
+      mexErrMsgTxt("gds_stl_mex :  STL file is not open.");
+
+   return sf;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * open, write and close commands
+ */
+static void
+stl_command(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   prisms_t pr;
+   stl_file_t *sf;
+   size_t *off, nfacet;
+   char cmd[8], *fname;
+   int nthreads = 0, err;
+
+   (void)nlhs;
+   if ( mxGetString(prhs[0], cmd, sizeof(cmd)) )
+      mexErrMsgTxt("gds_stl_mex :  unknown command.");
+
+   if ( !strcmp(cmd, "open") ) {
+      if ( !mxIsChar(prhs[1]) )
+	 mexErrMsgTxt("gds_stl_mex :  file name must be a string.");
+      if (nrhs > 2 && !mxIsEmpty(prhs[2]))
+	 nthreads = (int)mxGetScalar(prhs[2]);
+      sf = malloc(sizeof(stl_file_t));
+      if (sf == NULL)
+	 mexErrMsgTxt(stl_error(STL_ERR_MEMORY));
+      fname = mxArrayToString(prhs[1]);
+      err = stl_open(sf, fname, STL_HEADER, nthreads);
+      mxFree(fname);
+      if (err) {
+	 free(sf);
+	 mexErrMsgTxt(stl_error(err));
+      }
+      plhs[0] = make_handle(sf);
+   }
+   else if ( !strcmp(cmd, "write") ) {
+      if (nrhs < 5)
+	 mexErrMsgTxt("gds_stl_mex :  write requires a handle, xy, nv and z.");
+      sf = get_handle(prhs[1]);
+      off = get_prisms(prhs[2], prhs[3], prhs[4], &pr);
+      if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+	 pr.scale = mxGetScalar(prhs[5]);
+      err = stl_append_prisms(sf, &pr);
+      mxFree(off);
+      if (err)
+	 mexErrMsgTxt(stl_error(err));
+   }
+   else if ( !strcmp(cmd, "close") ) {
+      sf = get_handle(prhs[1]);
+      err = stl_close(sf, &nfacet);
+      free(sf);
+      if (err)
+	 mexErrMsgTxt(stl_error(err));
+      plhs[0] = mxCreateDoubleScalar((double)nfacet);
+   }
+   else
+      mexErrMsgTxt("gds_stl_mex :  unknown command.");
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   prisms_t pr;
+   prism_mesh_t mesh;
+   size_t *off;
+   double *pd;
+   char *fname = NULL;
+   size_t k, nfacet;
+   int nthreads = 0, err;
+
+   /* commands for files written in parts */
+   if (nrhs >= 2 && mxIsChar(prhs[0]) && !mxIsDouble(prhs[1])) {
+      stl_command(nlhs, plhs, nrhs, prhs);
+      return;
+   }
+
+   /* check arguments */
+   if (nrhs < 4)
+      mexErrMsgTxt("gds_stl_mex :  at least 4 arguments required.");
+   if ( !mxIsEmpty(prhs[0]) && !mxIsChar(prhs[0]) )
+      mexErrMsgTxt("gds_stl_mex :  file name must be a string.");
+
+   off = get_prisms(prhs[1], prhs[2], prhs[3], &pr);
+   if (nrhs > 4 && !mxIsEmpty(prhs[4]))
+      pr.scale = mxGetScalar(prhs[4]);
+   if (nrhs > 5 && !mxIsEmpty(prhs[5]))
+      nthreads = (int)mxGetScalar(prhs[5]);
+
+   if ( !mxIsEmpty(prhs[0]) ) {
+
+      /* binary STL file */
+      fname = mxArrayToString(prhs[0]);
+      err = stl_write_prisms(fname, STL_HEADER, &pr, nthreads, &nfacet);
+      mxFree(fname);
+      mxFree(off);
+      if (err)
+	 mexErrMsgTxt(stl_error(err));
+      plhs[0] = mxCreateDoubleScalar((double)nfacet);
+   }
+   else {
+
+      /* indexed mesh */
+      err = prism_mesh(&pr, nthreads, &mesh);
+      mxFree(off);
+      if (err)
+	 mexErrMsgTxt(stl_error(err));
+
+      plhs[0] = mxCreateDoubleMatrix(mesh.nvert, 3, mxREAL);
+      if (mesh.nvert)
+	 memcpy(mxGetPr(plhs[0]), mesh.vert, 3 * mesh.nvert * sizeof(double));
+
+      if (nlhs > 1) {
+	 plhs[1] = mxCreateDoubleMatrix(mesh.nface, 3, mxREAL);
+	 pd = mxGetPr(plhs[1]);
+	 for (k=0; k<mesh.nface; k++) {
+	    pd[k] = mesh.face[3*k] + 1;
+	    pd[mesh.nface+k] = mesh.face[3*k+1] + 1;
+	    pd[2*mesh.nface+k] = mesh.face[3*k+2] + 1;
+	 }
+      }
+      prism_mesh_free(&mesh);
+   }
+}
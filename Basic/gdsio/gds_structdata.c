@@ -20,6 +20,7 @@
 #include "gdsio.h"
 #include "mex.h"
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 
 /*-----------------------------------------------------------------*/
@@ -78,6 +79,8 @@ mexFunction(int nlhs, mxArray *plhs[],
    for (k=0; k<6; k++) {
       pd[k] = (double)mdate[k];
    }
+
+   STATS_FLUSH();
 }
 
 /*-----------------------------------------------------------------*/
@@ -0,0 +1,438 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Writes structures to a GDSII library file with a single call.
+ *
+ * gds_write_structures_mex(gf, sdata, uu_to_dbu, compound, nthreads);
+ *
+ * Input
+ * gf :        a file handle returned by gds_open or gds_initialize
+ * sdata :     cell array with one structure per GDSII structure
+ *               sdata{k}.sname : structure name
+ *               sdata{k}.el    : cell array with element data
+ *                                structures (see write_data)
+ *               sdata{k}.src   : (Optional) source of an unmodified
+ *                                structure with the fields
+ *                                  src.file : library file name
+ *                                  src.span : [offset, nbytes] of the
+ *                                             structure in the file
+ *                                When src is present, the structure
+ *                                is copied from the library file and
+ *                                el is ignored (see spancopy.h).
+ * uu_to_dbu : conversion factor user units --> database units
+ * compound :  controls the creation of compound elements.
+ * nthreads :  (Optional) number of threads used for encoding the
+ *             structures. Default is the number of processors.
+ *
+ * The elements of all structures are first collected and checked
+ * in the calling thread. The structures are then encoded into
+ * memory buffers by a pool of threads, each working on its own
+ * structure, while the calling thread writes the encoded
+ * structures to the file in the order of sdata. The MATLAB API is
+ * not thread-safe and is only used by the calling thread.
+ *
+ * The file contents are identical to the contents written with
+ * gds_beginstruct, gds_write_element, and gds_endstruct, which use
+ * the same functions for encoding the records (see elwrite.h).
+ * Structures that are copied from a library file are written
+ * unchanged, including the dates in the BGNSTR record.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gdsio.h"
+#include "mex.h"
+
+#include "gdstypes.h"
+#include "mexfuncs.h"
+#include "elwrite.h"
+#include "elgather.h"
+#include "spancopy.h"
+#include "gdsstats.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+#define WINDOW     4      /* structures in flight per thread */
+#define ERRLEN     256
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * a structure encoded by one of the threads
+ */
+typedef struct {
+   long job;          /* structure in the slot; -1 when unused */
+   ew_buffer_t wb;    /* encoded elements */
+} struct_slot;
+
+
+/*
+ * state shared by the encoding threads
+ */
+typedef struct {
+   const ew_list_t *ls; /* elements of the structures */
+   long njobs;        /* number of structures */
+   long next;         /* next structure to encode */
+   long nwritten;     /* number of structures written */
+   int nslot;         /* number of slots */
+   struct_slot *slot; /* slots for encoded structures */
+   double uu_to_dbu;  /* unit conversion factor */
+   int compound;      /* write compound elements */
+   int abort;         /* stop encoding */
+#if defined HAVE_PTHREADS
+   pthread_mutex_t lock;
+   pthread_cond_t encoded;  /* a structure was encoded */
+   pthread_cond_t freed;    /* a slot was released */
+#endif
+} pool_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int write_structures(FILE *fob, const ew_list_t *ls, char **snames,
+                            char **sfile, const double *span, long njobs,
+                            int nthreads, double uu_to_dbu, int compound,
+                            char *errmsg);
+static void encode_structure(pool_t *pool, long job, struct_slot *ps);
+static int write_header(FILE *fob, char *sname);
+static int default_threads(void);
+#if defined HAVE_PTHREADS
+static void *encode_thread(void *arg);
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;
+   mxArray *ps, *pel, *psrc;
+   ew_list_t *ls;
+   char **snames, **sfile;
+   char errmsg[ERRLEN];
+   double *pd, *span;
+   int err;
+   double uu_to_dbu;
+   int compound, nthreads = 0;
+   long k, j, njobs;
+
+   /* check arguments */
+   if (nrhs < 4)
+      mexErrMsgTxt("gds_write_structures_mex :  at least 4 input arguments expected.");
+   if ( !mxIsCell(prhs[1]) )
+      mexErrMsgTxt("gds_write_structures_mex :  structure data must be a cell array.");
+
+   /* get file handle argument */
+   fob = get_file_ptr((mxArray *)prhs[0]);
+
+   /* unit conversion and compound elements */
+   pd = mxGetData(prhs[2]);
+   uu_to_dbu = pd[0];
+   pd = mxGetData(prhs[3]);
+   compound = (int)pd[0];
+
+   /* number of threads */
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      pd = mxGetData(prhs[4]);
+      nthreads = (int)pd[0];
+   }
+   if (nthreads < 1)
+      nthreads = default_threads();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+
+   /* collect and check the elements of all structures */
+   njobs = (long)mxGetNumberOfElements(prhs[1]);
+   ls = mxCalloc(njobs ? njobs : 1, sizeof(ew_list_t));
+   snames = mxCalloc(njobs ? njobs : 1, sizeof(char *));
+   sfile = mxCalloc(njobs ? njobs : 1, sizeof(char *));
+   span = mxCalloc(njobs ? 2*njobs : 1, sizeof(double));
+   for (k=0; k<njobs; k++) {
+      ps = mxGetCell(prhs[1], k);
+      if (ps == NULL || !mxIsStruct(ps))
+	 mexErrMsgTxt("gds_write_structures_mex :  structure data must be structures.");
+      if ( !get_field_ptr(ps, "sname", &pel) || !mxIsChar(pel) )
+	 mexErrMsgTxt("gds_write_structures_mex :  missing structure name.");
+      snames[k] = mxArrayToString(pel);
+      if ( get_field_ptr(ps, "src", &psrc) ) {  /* copied from a file */
+	 if ( !get_field_ptr(psrc, "file", &pel) || !mxIsChar(pel) )
+	    mexErrMsgTxt("gds_write_structures_mex :  missing source file name.");
+	 sfile[k] = mxArrayToString(pel);
+	 if ( !get_field_ptr(psrc, "span", &pel) || mxGetNumberOfElements(pel) != 2 )
+	    mexErrMsgTxt("gds_write_structures_mex :  structure span must have 2 elements.");
+	 pd = mxGetData(pel);
+	 span[2*k] = pd[0];
+	 span[2*k+1] = pd[1];
+	 continue;
+      }
+      if ( !get_field_ptr(ps, "el", &pel) )
+	 continue;  /* no elements */
+      if ( !mxIsCell(pel) )
+	 mexErrMsgTxt("gds_write_structures_mex :  elements must be a cell array.");
+      for (j=0; j<(long)mxGetNumberOfElements(pel); j++)
+	 gather_element(&ls[k], mxGetCell(pel, j), "gds_write_structures_mex");
+   }
+
+   /* encode and write the structures */
+   err = write_structures(fob, ls, snames, sfile, span, njobs, nthreads,
+			  uu_to_dbu, compound, errmsg);
+
+   for (k=0; k<njobs; k++) {
+      ew_list_free(&ls[k]);
+      mxFree(snames[k]);
+      if (sfile[k])
+	 mxFree(sfile[k]);
+   }
+   mxFree(ls);
+   mxFree(snames);
+   mxFree(sfile);
+   mxFree(span);
+
+   if (err)
+      mexErrMsgTxt(errmsg);
+
+   STATS_FLUSH();
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * encodes the structures with a pool of threads and writes them,
+ * in order, in the calling thread. Structures with a source file
+ * (sfile[k] != NULL) are copied instead; their element lists are
+ * empty. Returns 1 after an error, with the error message in errmsg.
+ */
+static int
+write_structures(FILE *fob, const ew_list_t *ls, char **snames,
+                 char **sfile, const double *span, long njobs,
+                 int nthreads, double uu_to_dbu, int compound, char *errmsg)
+{
+   pool_t pool;
+   struct_slot *ps;
+   span_src_t src;
+   const char *msg = NULL;
+   long k;
+   int j;
+   int nstarted = 0;
+#if defined HAVE_PTHREADS
+   pthread_t tid[MAXTHREADS];
+#endif
+
+   if (nthreads > njobs)
+      nthreads = njobs > 0 ? (int)njobs : 1;
+   memset(&src, 0, sizeof(span_src_t));
+
+   /* encoding state */
+   memset(&pool, 0, sizeof(pool_t));
+   pool.ls = ls;
+   pool.njobs = njobs;
+   pool.uu_to_dbu = uu_to_dbu;
+   pool.compound = compound;
+   pool.nslot = nthreads > 1 ? WINDOW*nthreads : 1;
+   pool.slot = mxCalloc(pool.nslot, sizeof(struct_slot));
+   for (j=0; j<pool.nslot; j++)
+      pool.slot[j].job = -1;
+
+#if defined HAVE_PTHREADS
+   if (nthreads > 1) {
+      pthread_mutex_init(&pool.lock, NULL);
+      pthread_cond_init(&pool.encoded, NULL);
+      pthread_cond_init(&pool.freed, NULL);
+      for (nstarted=0; nstarted<nthreads; nstarted++) {
+	 if ( pthread_create(&tid[nstarted], NULL, encode_thread, &pool) )
+	    break;
+      }
+   }
+#endif
+
+   for (k=0; k<njobs; k++) {
+
+      ps = &pool.slot[k % pool.nslot];
+
+      /* wait for the structure */
+#if defined HAVE_PTHREADS
+      if (nstarted) {
+	 pthread_mutex_lock(&pool.lock);
+	 while (ps->job != k)
+	    pthread_cond_wait(&pool.encoded, &pool.lock);
+	 pthread_mutex_unlock(&pool.lock);
+      }
+      else
+#endif
+      {
+	 encode_structure(&pool, k, ps);
+	 ps->job = k;
+      }
+
+      if (ps->wb.err) {
+	 msg = "failed to allocate memory.";
+	 break;
+      }
+
+      /* write it */
+      if (sfile[k]) {
+	 if ( (msg = span_copy(fob, &src, sfile[k], (uint64_t)span[2*k],
+			       (uint64_t)span[2*k+1])) )
+	    break;
+      }
+      else if ( write_header(fob, snames[k]) ||
+		fwrite(ps->wb.base, 1, ps->wb.size, fob) != ps->wb.size ||
+		write_record_hdr(fob, ENDSTR, 0) ) {
+	 msg = "failed to write structure.";
+	 break;
+      }
+
+      /* the slot can be reused */
+      ew_buffer_clear(&ps->wb);
+#if defined HAVE_PTHREADS
+      if (nstarted) {
+	 pthread_mutex_lock(&pool.lock);
+	 pool.nwritten = k+1;
+	 pthread_cond_broadcast(&pool.freed);
+	 pthread_mutex_unlock(&pool.lock);
+      }
+      else
+#endif
+	 pool.nwritten = k+1;
+   }
+
+   /* stop the threads */
+#if defined HAVE_PTHREADS
+   if (nthreads > 1) {
+      pthread_mutex_lock(&pool.lock);
+      pool.abort = 1;
+      pthread_cond_broadcast(&pool.freed);
+      pthread_mutex_unlock(&pool.lock);
+      for (j=0; j<nstarted; j++)
+	 pthread_join(tid[j], NULL);
+      pthread_mutex_destroy(&pool.lock);
+      pthread_cond_destroy(&pool.encoded);
+      pthread_cond_destroy(&pool.freed);
+   }
+#endif
+
+   /* release encoding buffers */
+   for (j=0; j<pool.nslot; j++)
+      ew_buffer_free(&pool.slot[j].wb);
+   mxFree(pool.slot);
+   span_close(&src);
+
+   if (msg) {
+      if (k < njobs)
+	 snprintf(errmsg, ERRLEN, "gds_write_structures_mex :  %s :  %s", snames[k], msg);
+      else
+	 snprintf(errmsg, ERRLEN, "gds_write_structures_mex :  %s", msg);
+      return 1;
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#if defined HAVE_PTHREADS
+
+/*
+ * encoding thread; takes the next structure and encodes it
+ * as soon as its slot is free.
+ */
+static void *
+encode_thread(void *arg)
+{
+   pool_t *pool = (pool_t *)arg;
+   struct_slot *ps;
+   long job;
+
+   while (1) {
+
+      pthread_mutex_lock(&pool->lock);
+      while (!pool->abort && pool->next < pool->njobs &&
+	     pool->next >= pool->nwritten + pool->nslot)
+	 pthread_cond_wait(&pool->freed, &pool->lock);
+      if (pool->abort || pool->next >= pool->njobs) {
+	 pthread_mutex_unlock(&pool->lock);
+	 return NULL;
+      }
+      job = pool->next++;
+      pthread_mutex_unlock(&pool->lock);
+
+      ps = &pool->slot[job % pool->nslot];
+      encode_structure(pool, job, ps);
+
+      pthread_mutex_lock(&pool->lock);
+      ps->job = job;
+      pthread_cond_broadcast(&pool->encoded);
+      pthread_mutex_unlock(&pool->lock);
+   }
+}
+
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * encodes the elements of a structure into a slot. Only C library
+ * functions may be called here.
+ */
+static void
+encode_structure(pool_t *pool, long job, struct_slot *ps)
+{
+   encode_elements(&ps->wb, &pool->ls[job], pool->uu_to_dbu, pool->compound);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * BGNSTR and STRNAME records, as written by gds_beginstruct
+ */
+static int
+write_header(FILE *fob, char *sname)
+{
+   date_t cdate, mdate;
+
+   if ( write_record_hdr(fob, BGNSTR, 2*sizeof(date_t)) )
+      return 1;
+   now(cdate);
+   if ( write_word_n(fob, cdate, 6) )
+      return 1;
+   now(mdate);
+   if ( write_word_n(fob, mdate, 6) )
+      return 1;
+   if ( write_record_hdr(fob, STRNAME, strlen(sname)) )
+      return 1;
+   if ( write_string(fob, sname, strlen(sname)) )
+      return 1;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+default_threads(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+/*-----------------------------------------------------------------*/
@@ -8,6 +8,7 @@
 #include <time.h>
 #include <math.h>
 #include "gdsio.h"
+#include "gdsstats.h"
 
 /* GNU C has inline */
 #if defined __GNUC__
@@ -76,6 +77,7 @@ read_record_hdr(FILE* fob, uint16_t *rtype, uint16_t *rlen)
 
    *rtype = hdr[1];
    *rlen  = hdr[0] - 2*sizeof(uint16_t);
+   STATS_REC_READ(hdr[1], hdr[0]);
 
    return A_OK;
 }
@@ -94,6 +96,7 @@ write_record_hdr(FILE* fob, uint16_t rtype, uint16_t rlen)
 
    hdr[0] = rlen + 2*sizeof(uint16_t);
    hdr[1] = rtype;
+   STATS_REC_WRITTEN(rtype, hdr[0]);
    byte_reverse_n(hdr, 2);
 
    nw = (int)fwrite(hdr, sizeof(uint16_t), (size_t)2, fob);
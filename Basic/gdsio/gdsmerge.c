@@ -0,0 +1,667 @@
+/*
+ * Merging of GDSII library files without decoding the elements
+ * Copyright (c) 2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gdstypes.h"
+#include "gdsio.h"
+#include "mapio.h"
+#include "libindex.h"
+#include "gdsstream.h"
+#include "gdsmerge.h"
+
+#define NLEN    1024    /* maximum length of structure names + 1 */
+#define NCONV   256     /* coordinates converted in one step */
+#define UNIT_TOL 1e-9   /* relative tolerance for equal units */
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * structure names of all input files; owner[k] is the input file
+ * using name k, -1 when none
+ */
+typedef struct {
+   nametab_t tab;
+   int *owner;
+} name_table_t;
+
+
+/*
+ * renamed structures of one input file; nname[k] is the new name
+ * of the structure with name k
+ */
+typedef struct {
+   nametab_t tab;
+   const char **nname;
+} rename_map_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static const char *load_index(lib_index_t *li, const char *fname);
+static const char *rename_structure(merge_t *mg, name_table_t *names,
+                                    const char *oname, int file);
+static const char *file_renames(rename_map_t *map, merge_t *mg, int file);
+static const char *copy_library(FILE *fob, const char *fname, lib_index_t *li,
+                                rename_map_t *map, double dbunit);
+static const char *copy_structure(FILE *fob, map_file_t *mf, size_t nbytes,
+                                  rename_map_t *map, double scale);
+static const char *copy_records(FILE *fob, map_file_t *mf, size_t end,
+                                rename_map_t *map, double scale);
+static const char *library_dbunit(map_file_t *mf, double *dbunit);
+static const char *write_top(FILE *fob, merge_t *mg, lib_index_t *li, int nfiles);
+static int write_name(FILE *fob, uint16_t rtype, const char *name);
+static int write_scaled(FILE *fob, uint16_t rtype, const uint8_t *p, int n, double scale);
+static void record_name(char *name, const uint8_t *p, int rlen);
+static void map_free(rename_map_t *map);
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+merge_libraries(FILE *fob, const char **fnames, int nfiles, merge_t *mg)
+{
+   lib_index_t *li;
+   name_table_t names;
+   rename_map_t map;
+   const char *msg = NULL;
+   uint32_t nst, k;
+   int32_t j;
+   int f, added;
+
+   mg->nren = 0;
+   mg->ren = NULL;
+   memset(&names, 0, sizeof(name_table_t));
+   memset(&map, 0, sizeof(rename_map_t));
+
+   li = calloc(nfiles ? nfiles : 1, sizeof(lib_index_t));
+   if (li == NULL)
+      return "failed to allocate memory.";
+
+   /* structure index of all libraries */
+   for (nst=0,f=0; f<nfiles; f++) {
+      if ( (msg = load_index(&li[f], fnames[f])) )
+	 goto done;
+      nst += li[f].nstruct;
+   }
+
+   /* all names in the input files are reserved; each structure
+      adds at most one more name when it is renamed */
+   names.owner = malloc((2*(size_t)nst + 1)*sizeof(int));
+   if ( names.owner == NULL || nametab_init(&names.tab, nst + 1) ) {
+      msg = "failed to allocate memory.";
+      goto done;
+   }
+   for (k=0; k<2*nst+1; k++)
+      names.owner[k] = -1;
+   for (f=0; f<nfiles; f++) {
+      for (k=0; k<li[f].nstruct; k++) {
+	 if ( nametab_intern(&names.tab, li[f].st[k].sname, &added) < 0 ) {
+	    msg = "failed to allocate memory.";
+	    goto done;
+	 }
+      }
+   }
+   if (mg->top) {
+      if ( (j = nametab_intern(&names.tab, mg->top, &added)) < 0 ) {
+	 msg = "failed to allocate memory.";
+	 goto done;
+      }
+      names.owner[j] = nfiles;
+   }
+
+   /* a name belongs to the first library that uses it */
+   for (f=0; f<nfiles; f++) {
+      for (k=0; k<li[f].nstruct; k++) {
+	 j = nametab_find(&names.tab, li[f].st[k].sname);
+	 if (names.owner[j] < 0)
+	    names.owner[j] = f;
+	 else if (names.owner[j] == f) {
+	    msg = "structure name occurs twice in a library.";
+	    goto done;
+	 }
+	 else if ( (msg = rename_structure(mg, &names, li[f].st[k].sname, f)) )
+	    goto done;
+      }
+   }
+
+   /* copy the structures */
+   for (f=0; f<nfiles; f++) {
+      if ( (msg = file_renames(&map, mg, f)) )
+	 goto done;
+      msg = copy_library(fob, fnames[f], &li[f], &map, mg->dbunit);
+      map_free(&map);
+      if (msg)
+	 goto done;
+   }
+
+   /* new top level structure */
+   if (mg->top)
+      msg = write_top(fob, mg, li, nfiles);
+
+ done:
+   map_free(&map);
+   nametab_free(&names.tab);
+   free(names.owner);
+   for (f=0; f<nfiles; f++)
+      index_free(&li[f]);
+   free(li);
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+merge_free(merge_t *mg)
+{
+   uint32_t k;
+
+   for (k=0; k<mg->nren; k++) {
+      free(mg->ren[k].oname);
+      free(mg->ren[k].nname);
+   }
+   free(mg->ren);
+   mg->ren = NULL;
+   mg->nren = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the index is read from the sidecar file when it is up to date,
+ * otherwise the library is scanned.
+ */
+static const char *
+load_index(lib_index_t *li, const char *fname)
+{
+   FILE *fin;
+   map_file_t mf;
+   stream_kind kind;
+   uint64_t fsize;
+   int64_t mtime;
+   char *iname;
+   int ret;
+
+   if ( index_stat(fname, &fsize, &mtime) )
+      return "could not access library file.";
+   fin = stream_open(fname, "rb", &kind);
+   if (fin == NULL)
+      return "could not open library file.";
+
+   iname = malloc(strlen(fname) + 5);
+   if (iname == NULL) {
+      fclose(fin);
+      return "failed to allocate memory.";
+   }
+   strcpy(iname, fname);
+   strcat(iname, ".idx");
+   ret = index_load(li, iname, fsize, mtime);
+   free(iname);
+   if (ret == A_OK && index_verify(li, fin) == A_OK) {
+      fclose(fin);
+      return NULL;
+   }
+   index_free(li);
+
+   if ( fseek(fin, 0L, SEEK_SET) < 0 || map_open(&mf, fin) ) {
+      fclose(fin);
+      return "failed to map file into memory.";
+   }
+   ret = index_build(li, &mf);
+   map_close(&mf, NULL);
+   fclose(fin);
+   if (ret) {
+      index_free(li);
+      return "failed to scan library file.";
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * finds a unique new name for a structure of an input file
+ */
+static const char *
+rename_structure(merge_t *mg, name_table_t *names, const char *oname, int file)
+{
+   merge_rename_t *pr;
+   char *nname;
+   int32_t j;
+   int k, added;
+
+   nname = malloc(strlen(oname) + 16);
+   if (nname == NULL)
+      return "failed to allocate memory.";
+   for (k=1; ; k++) {
+      sprintf(nname, "%s_%d", oname, k);
+      if ( nametab_find(&names->tab, nname) < 0 )
+	 break;
+   }
+
+   /* the list grows in powers of 2 */
+   if ( !(mg->nren & (mg->nren - 1)) ) {
+      pr = realloc(mg->ren, (mg->nren ? 2*mg->nren : 1)*sizeof(merge_rename_t));
+      if (pr == NULL) {
+	 free(nname);
+	 return "failed to allocate memory.";
+      }
+      mg->ren = pr;
+   }
+   pr = &mg->ren[mg->nren];
+   pr->file = file;
+   pr->oname = malloc(strlen(oname) + 1);
+   pr->nname = nname;
+   if (pr->oname == NULL) {
+      free(nname);
+      return "failed to allocate memory.";
+   }
+   strcpy(pr->oname, oname);
+   mg->nren++;
+
+   if ( (j = nametab_intern(&names->tab, nname, &added)) < 0 )
+      return "failed to allocate memory.";
+   names->owner[j] = file;
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * table with the renamed structures of one input file
+ */
+static const char *
+file_renames(rename_map_t *map, merge_t *mg, int file)
+{
+   uint32_t k, n;
+   int32_t j;
+   int added;
+
+   for (n=0,k=0; k<mg->nren; k++)
+      n += mg->ren[k].file == file;
+   map->nname = malloc((n ? n : 1)*sizeof(const char *));
+   if ( map->nname == NULL || nametab_init(&map->tab, n) )
+      return "failed to allocate memory.";
+
+   for (k=0; k<mg->nren; k++) {
+      if (mg->ren[k].file != file)
+	 continue;
+      if ( (j = nametab_intern(&map->tab, mg->ren[k].oname, &added)) < 0 )
+	 return "failed to allocate memory.";
+      map->nname[j] = mg->ren[k].nname;
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies the structures of a library in the order of the index.
+ * Structures are copied in one piece when neither names nor
+ * coordinates must be changed.
+ */
+static const char *
+copy_library(FILE *fob, const char *fname, lib_index_t *li,
+             rename_map_t *map, double dbunit)
+{
+   FILE *fin;
+   map_file_t mf;
+   stream_kind kind;
+   struct_index_t *si;
+   const char *msg = NULL;
+   uint8_t *p;
+   double libunit, scale;
+   uint32_t k;
+
+   fin = stream_open(fname, "rb", &kind);
+   if (fin == NULL)
+      return "could not open library file.";
+   if ( map_open(&mf, fin) ) {
+      fclose(fin);
+      return "failed to map file into memory.";
+   }
+
+   /* coordinate conversion */
+   if ( (msg = library_dbunit(&mf, &libunit)) )
+      goto done;
+   scale = libunit / dbunit;
+   if (fabs(scale - 1.0) < UNIT_TOL)
+      scale = 1.0;
+
+   for (k=0; k<li->nstruct; k++) {
+      si = &li->st[k];
+      if ( map_seek(&mf, (size_t)si->offset) ) {
+	 msg = "structure index does not match library file.";
+	 break;
+      }
+      if (map->tab.n == 0 && scale == 1.0) {
+	 if ( !(p = map_data(&mf, (size_t)si->nbytes)) ) {
+	    msg = "structure index does not match library file.";
+	    break;
+	 }
+	 if ( fwrite(p, 1, (size_t)si->nbytes, fob) != (size_t)si->nbytes ) {
+	    msg = "failed to write structure.";
+	    break;
+	 }
+      }
+      else if ( (msg = copy_structure(fob, &mf, (size_t)si->nbytes, map, scale)) )
+	 break;
+   }
+
+ done:
+   map_close(&mf, NULL);
+   fclose(fin);
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies the records of a structure. The whole structure must be
+ * in memory; the window of a compressed file is not refilled while
+ * the records are copied.
+ */
+static const char *
+copy_structure(FILE *fob, map_file_t *mf, size_t nbytes,
+               rename_map_t *map, double scale)
+{
+   const char *msg;
+   FILE *fin;
+
+   if ( !map_peek(mf, nbytes) )
+      return "structure index does not match library file.";
+   fin = mf->fob;
+   mf->fob = NULL;
+   msg = copy_records(fob, mf, mf->pos + nbytes, map, scale);
+   mf->fob = fin;
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies the records up to read position end. Runs of records that
+ * are not changed are written with a single call to fwrite.
+ */
+static const char *
+copy_records(FILE *fob, map_file_t *mf, size_t end,
+             rename_map_t *map, double scale)
+{
+   int32_t j = -1;
+   uint8_t *run, *p;
+   uint16_t rtype, rlen;
+   char name[NLEN];
+   int err;
+
+   run = mf->base + mf->pos;
+
+   while (mf->pos < end) {
+
+      if ( map_record_hdr(mf, &rtype, &rlen) || !(p = map_data(mf, rlen)) )
+	 return "structure index does not match library file.";
+
+      switch (rtype) {
+
+         case STRNAME:
+         case SNAME:
+	    if (map->tab.n == 0)
+	       continue;
+	    record_name(name, p, rlen);
+	    if ( (j = nametab_find(&map->tab, name)) < 0 )
+	       continue;
+	    break;
+
+         case XY:
+         case WIDTH:
+         case BGNEXTN:
+         case ENDEXTN:
+	    if (scale == 1.0)
+	       continue;
+	    break;
+
+         default:
+	    continue;
+      }
+
+      /* write the unchanged records before this one */
+      if ( fwrite(run, 1, p - 4 - run, fob) != (size_t)(p - 4 - run) )
+	 return "failed to write structure.";
+
+      if (rtype == STRNAME || rtype == SNAME)
+	 err = write_name(fob, rtype, map->nname[j]);
+      else
+	 err = write_scaled(fob, rtype, p, rlen/sizeof(int32_t), scale);
+      if (err == 2)
+	 return "coordinates out of range after unit conversion.";
+      if (err)
+	 return "failed to write structure.";
+
+      run = p + rlen;
+   }
+
+   p = mf->base + mf->pos;
+   if ( fwrite(run, 1, p - run, fob) != (size_t)(p - run) )
+      return "failed to write structure.";
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads the database unit from the library header
+ */
+static const char *
+library_dbunit(map_file_t *mf, double *dbunit)
+{
+   uint16_t rtype, rlen;
+   double uunit;
+
+   if ( map_seek(mf, 0) )
+      return "could not read library header.";
+   while (1) {
+      if ( map_record_hdr(mf, &rtype, &rlen) )
+	 break;
+      if (rtype == BGNSTR || rtype == ENDLIB)
+	 break;
+      if (rtype == UNITS) {
+	 if ( map_real8(mf, &uunit) || map_real8(mf, dbunit) )
+	    break;
+	 return *dbunit > 0.0 ? NULL : "invalid database unit in library header.";
+      }
+      if ( map_ignore(mf, rlen) )
+	 break;
+   }
+
+   return "missing UNITS record in library header.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a structure with references to the top level structures of all
+ * input libraries, i.e. the structures that are not referenced
+ * within their library.
+ */
+static const char *
+write_top(FILE *fob, merge_t *mg, lib_index_t *li, int nfiles)
+{
+   nametab_t refs;
+   rename_map_t map;
+   struct_index_t *si;
+   const char *msg = NULL;
+   date_t cdate, mdate;
+   int32_t xy[2];
+   uint32_t nref, k, j;
+   int32_t r;
+   int f, added;
+
+   if ( write_record_hdr(fob, BGNSTR, 2*sizeof(date_t)) )
+      return "failed to write top level structure.";
+   now(cdate);
+   now(mdate);
+   if ( write_word_n(fob, cdate, 6) || write_word_n(fob, mdate, 6) ||
+	write_name(fob, STRNAME, mg->top) )
+      return "failed to write top level structure.";
+
+   for (f=0; f<nfiles; f++) {
+
+      /* structures referenced in the library */
+      for (nref=0,k=0; k<li[f].nstruct; k++)
+	 nref += li[f].st[k].nref;
+      if ( nametab_init(&refs, nref) )
+	 return "failed to allocate memory.";
+      memset(&map, 0, sizeof(rename_map_t));
+      for (k=0; k<li[f].nstruct && !msg; k++) {
+	 si = &li[f].st[k];
+	 for (j=0; j<si->nref; j++) {
+	    if ( nametab_intern(&refs, si->refs[j], &added) < 0 ) {
+	       msg = "failed to allocate memory.";
+	       break;
+	    }
+	 }
+      }
+      if ( !msg )
+	 msg = file_renames(&map, mg, f);
+      if (msg) {
+	 nametab_free(&refs);
+	 map_free(&map);
+	 return msg;
+      }
+
+      /* an SREF for each top level structure */
+      for (k=0; k<li[f].nstruct; k++) {
+	 si = &li[f].st[k];
+	 if ( nametab_find(&refs, si->sname) >= 0 )
+	    continue;
+	 r = nametab_find(&map.tab, si->sname);
+	 xy[0] = xy[1] = 0;
+	 if ( write_record_hdr(fob, SREF, 0) ||
+	      write_name(fob, SNAME, r >= 0 ? map.nname[r] : si->sname) ||
+	      write_record_hdr(fob, XY, 2*sizeof(int32_t)) ||
+	      write_int_n(fob, xy, 2) ||
+	      write_record_hdr(fob, ENDEL, 0) ) {
+	    msg = "failed to write top level structure.";
+	    break;
+	 }
+      }
+
+      nametab_free(&refs);
+      map_free(&map);
+      if (msg)
+	 return msg;
+   }
+
+   if ( write_record_hdr(fob, ENDSTR, 0) )
+      return "failed to write top level structure.";
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes a STRNAME or SNAME record. Names with an odd number of
+ * characters are padded with a NUL character.
+ */
+static int
+write_name(FILE *fob, uint16_t rtype, const char *name)
+{
+   int len = (int)strlen(name);
+   int pad = len & 1;
+
+   if ( write_record_hdr(fob, rtype, len + pad) )
+      return 1;
+   if ( fwrite(name, 1, len, fob) != (size_t)len )
+      return 1;
+   if ( pad && fputc('\0', fob) == EOF )
+      return 1;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes a record with n rescaled 4-byte integers. Returns 2
+ * when a coordinate does not fit into an int32.
+ */
+static int
+write_scaled(FILE *fob, uint16_t rtype, const uint8_t *p, int n, double scale)
+{
+   int32_t buf[NCONV];
+   double d;
+   int k, m;
+
+   if ( write_record_hdr(fob, rtype, n*sizeof(int32_t)) )
+      return 1;
+
+   while (n > 0) {
+      m = n > NCONV ? NCONV : n;
+      memcpy(buf, p, m*sizeof(int32_t));
+      byte_reverse32_n(buf, m);
+      for (k=0; k<m; k++) {
+	 d = floor(scale * buf[k] + 0.5);
+	 if (d > INT32_MAX || d < INT32_MIN)
+	    return 2;
+	 buf[k] = (int32_t)d;
+      }
+      if ( write_int_n(fob, buf, m) )  /* swaps the bytes back */
+	 return 1;
+      p += m*sizeof(int32_t);
+      n -= m;
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies a name from a record; the padding is removed.
+ */
+static void
+record_name(char *name, const uint8_t *p, int rlen)
+{
+   if (rlen > NLEN-1)
+      rlen = NLEN-1;
+   memcpy(name, p, rlen);
+   name[rlen] = '\0';
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+map_free(rename_map_t *map)
+{
+   nametab_free(&map->tab);
+   free(map->nname);
+   memset(map, 0, sizeof(rename_map_t));
+}
+
+/*-----------------------------------------------------------------*/
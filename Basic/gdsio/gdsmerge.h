@@ -0,0 +1,82 @@
+/*
+ * Merging of GDSII library files without decoding the elements.
+ *
+ * The structures of the input libraries are copied from the input
+ * files to the output file record by record, or in one piece when
+ * nothing has to be changed. Only two kinds of records are
+ * rewritten:
+ *
+ *  - STRNAME and SNAME records of structures whose names are
+ *    already used by a library earlier in the list of input
+ *    files. Such structures are renamed to NAME_k, where k is the
+ *    smallest positive integer for which the name is unique.
+ *
+ *  - XY, WIDTH, BGNEXTN, and ENDEXTN records of libraries with a
+ *    database unit that differs from the database unit of the
+ *    output file. The coordinates are rescaled and rounded to the
+ *    nearest integer.
+ *
+ * The positions of the structures in the input files are taken
+ * from the structure index (see libindex.h), which is loaded from
+ * a sidecar file when one exists. The functions do not use the
+ * MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _GDSMERGE_H
+#define _GDSMERGE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+
+/*
+ * a renamed structure
+ */
+typedef struct {
+   int file;             /* input file of the structure */
+   char *oname;          /* original name */
+   char *nname;          /* new name */
+} merge_rename_t;
+
+
+/*
+ * merge parameters and results
+ */
+typedef struct {
+   double dbunit;        /* database unit of the output in m */
+   const char *top;      /* name of a new top level structure or NULL */
+   uint32_t nren;        /* number of renamed structures */
+   merge_rename_t *ren;  /* renamed structures */
+} merge_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * copy the structures of several library files to a stream. The
+ * library header and the ENDLIB record of the output must be
+ * written by the caller. When mg->top is not NULL, a new structure
+ * with this name is written after the copied structures; it
+ * contains a reference to each top level structure of each input
+ * library. Input structures with the same name as the new top
+ * structure are renamed. Returns NULL on success or an error
+ * message. The renamed structures are returned in mg, which must
+ * be released with merge_free, also after an error.
+ *
+ * fob :     output stream positioned after the library header
+ * fnames :  names of the input library files
+ * nfiles :  number of input files
+ * mg :      merge parameters and results
+ */
+const char *merge_libraries(FILE *fob, const char **fnames, int nfiles, merge_t *mg);
+
+/*
+ * release the list of renamed structures
+ */
+void merge_free(merge_t *mg);
+
+#endif /* _GDSMERGE_H */
@@ -0,0 +1,118 @@
+/*
+ * Counters and timers for the GDSII input and output functions
+ * and the Boolean functions.
+ *
+ * The counters are only compiled in when GDS_STATS is defined
+ * (e.g. GDS_STATS=1 ./makemex-octave); otherwise all STATS_* macros
+ * expand to nothing and the instrumented functions are unchanged.
+ *
+ * Every mex function is a separate shared library with its own
+ * counters. A mex function adds its counters to the global variable
+ * GDS_STATS_VAR with stats_flush() before it returns, and gds_stats
+ * returns them as a structure. The counters, stats_flush and
+ * stats_ns are defined in mexfuncs.c.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _GDSSTATS_H
+#define _GDSSTATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* name of the global variable with the counters */
+#define GDS_STATS_VAR "GDSII_STATISTICS__"
+
+/* scalar counters */
+enum {ST_REC_READ = 0,     /* records read */
+      ST_BYTES_READ,       /* bytes read, including headers */
+      ST_REC_WRITTEN,      /* records written */
+      ST_BYTES_WRITTEN,    /* bytes written */
+      ST_VERT_READ,        /* vertices of elements read */
+      ST_VERT_WRITTEN,     /* vertices of elements written */
+      ST_ALLOC,            /* buffer and element list allocations */
+      ST_ALLOC_BYTES,      /* bytes of these allocations */
+      ST_CLIP_CALLS,       /* Clipper executions */
+      ST_CLIP_VERT_IN,     /* vertices of Clipper operands */
+      ST_CLIP_VERT_OUT,    /* vertices of Clipper results */
+      ST_CLIP_NS,          /* time in Clipper (ns) */
+      ST_NCOUNT};
+
+#define ST_NRTYPE 64       /* record types (upper byte of record type) */
+#define ST_NKIND   8       /* element kinds (element_kind), 0 unused */
+
+typedef struct {
+   uint64_t count[ST_NCOUNT];
+   uint64_t rec_read[ST_NRTYPE];     /* records read by type */
+   uint64_t rec_written[ST_NRTYPE];  /* records written by type */
+   uint64_t el_read[ST_NKIND];       /* elements read by kind */
+   uint64_t ns_read[ST_NKIND];       /* time reading elements (ns) */
+   uint64_t el_written[ST_NKIND];    /* elements written by kind */
+   uint64_t ns_written[ST_NKIND];    /* time writing elements (ns) */
+} gds_stats_t;
+
+/* number of counters in gds_stats_t */
+#define ST_NTOTAL (sizeof(gds_stats_t) / sizeof(uint64_t))
+
+
+#if defined GDS_STATS
+
+extern gds_stats_t gds_stats;
+
+/*
+ * adds the counters to the global variable GDS_STATS_VAR and
+ * clears them. Must be called from the thread of the mex function.
+ */
+void stats_flush(void);
+
+/*
+ * returns a monotonic time in ns
+ */
+uint64_t stats_ns(void);
+
+/* counters may be updated by the reading and writing threads */
+#if defined __GNUC__
+   #define STATS_INC(c, n) __atomic_fetch_add(&(c), (uint64_t)(n), __ATOMIC_RELAXED)
+#else
+   #define STATS_INC(c, n) ((c) += (uint64_t)(n))
+#endif
+
+#define STATS_ADD(i, n)          STATS_INC(gds_stats.count[i], n)
+#define STATS_REC_READ(rt, nb)   do { STATS_INC(gds_stats.rec_read[((rt) >> 8) & (ST_NRTYPE-1)], 1); \
+                                      STATS_ADD(ST_REC_READ, 1); STATS_ADD(ST_BYTES_READ, nb); } while (0)
+#define STATS_REC_WRITTEN(rt, nb) do { STATS_INC(gds_stats.rec_written[((rt) >> 8) & (ST_NRTYPE-1)], 1); \
+                                      STATS_ADD(ST_REC_WRITTEN, 1); STATS_ADD(ST_BYTES_WRITTEN, nb); } while (0)
+#define STATS_ALLOC(nb)          do { STATS_ADD(ST_ALLOC, 1); STATS_ADD(ST_ALLOC_BYTES, nb); } while (0)
+#define STATS_TIMER(t)           uint64_t t = stats_ns()
+#define STATS_EL_READ(k, t)      do { STATS_INC(gds_stats.el_read[(k) & (ST_NKIND-1)], 1); \
+                                      STATS_INC(gds_stats.ns_read[(k) & (ST_NKIND-1)], stats_ns() - (t)); } while (0)
+#define STATS_EL_WRITTEN(k, t)   do { STATS_INC(gds_stats.el_written[(k) & (ST_NKIND-1)], 1); \
+                                      STATS_INC(gds_stats.ns_written[(k) & (ST_NKIND-1)], stats_ns() - (t)); } while (0)
+#define STATS_ELAPSED(i, t)      STATS_ADD(i, stats_ns() - (t))
+#define STATS_FLUSH()            stats_flush()
+
+#else
+
+#define STATS_ADD(i, n)
+#define STATS_REC_READ(rt, nb)
+#define STATS_REC_WRITTEN(rt, nb)
+#define STATS_ALLOC(nb)
+#define STATS_TIMER(t)
+#define STATS_EL_READ(k, t)
+#define STATS_EL_WRITTEN(k, t)
+#define STATS_ELAPSED(i, t)
+#define STATS_FLUSH()
+
+#endif /* GDS_STATS */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GDSSTATS_H */
@@ -0,0 +1,837 @@
+/*
+ * Opening of GDSII library files with transparent compression.
+ * Compressed files are accessed through stdio streams created with
+ * fopencookie (glibc) or funopen (BSD, macOS). OASIS files are
+ * converted to and from GDSII libraries in temporary files.
+ *
+ * Copyright (c) 2026
+ */
+
+#define _GNU_SOURCE   /* for fopencookie */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "gdsstream.h"
+#include "oasis.h"
+
+#if defined HAVE_ZLIB
+   #include <zlib.h>
+#endif
+#if defined HAVE_ZSTD
+   #include <zstd.h>
+#endif
+
+#if defined __GLIBC__
+   #define HAVE_FOPENCOOKIE
+#elif defined __APPLE__ || defined __FreeBSD__ || defined __NetBSD__ || defined __OpenBSD__
+   #define HAVE_FUNOPEN
+#endif
+
+#if (defined HAVE_ZLIB || defined HAVE_ZSTD) && (defined HAVE_FOPENCOOKIE || defined HAVE_FUNOPEN)
+   #define HAVE_CSTREAM
+   #include <unistd.h>
+   #include <fcntl.h>
+#endif
+
+#if defined HAVE_FOPENCOOKIE || defined HAVE_FUNOPEN
+   #define HAVE_OSTREAM
+#endif
+
+#define BLKSIZE   262144   /* size of decompressed blocks */
+
+
+/*-- Types --------------------------------------------------------*/
+
+#if defined HAVE_CSTREAM
+
+/*
+ * state of a compressed stream
+ */
+typedef struct {
+   stream_kind kind;
+   int writing;
+   int fd;              /* descriptor of the compressed file */
+#if defined HAVE_ZLIB
+   gzFile gz;           /* gzip file */
+#endif
+#if defined HAVE_ZSTD
+   FILE *fob;           /* zstd compressed file */
+   ZSTD_DCtx *dctx;
+   ZSTD_CCtx *cctx;
+   ZSTD_inBuffer in;    /* compressed input when reading */
+   uint8_t *zbuf;       /* buffer for compressed data */
+   size_t zsize;
+#endif
+   uint8_t *blk;        /* two buffers for decompressed blocks */
+   uint8_t *data;       /* current block */
+   size_t nblk;         /* number of bytes in block */
+   size_t nother;       /* number of bytes in other block */
+   int other;           /* other block precedes (-1) or follows (1)
+			   the current block, or is empty (0) */
+   size_t cur;          /* read position in block */
+   int64_t pos;         /* stream position of block (reading) or
+			   number of bytes written */
+} cstream_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static FILE *cstream_open(const char *fname, const char *mode, stream_kind kind);
+static int64_t fill_block(cstream_t *cs);
+static int rewind_stream(cstream_t *cs);
+static int64_t cs_read(cstream_t *cs, char *buf, size_t size);
+static int64_t cs_write(cstream_t *cs, const char *buf, size_t size);
+static int cs_seek(cstream_t *cs, int64_t *offset, int whence);
+static int cs_close(cstream_t *cs);
+
+#endif
+
+
+#if defined HAVE_OSTREAM
+
+/*
+ * state of a stream writing an OASIS file. The GDSII library is
+ * written to a temporary file, which is converted when the stream
+ * is closed.
+ */
+typedef struct {
+   FILE *tmp;           /* GDSII library */
+   char *fname;         /* name of the OASIS file */
+} ostream_t;
+
+static FILE *ostream_open(const char *fname);
+static int os_close(ostream_t *os);
+
+#endif
+
+static FILE *oasis_read(FILE *fob);
+
+/* message of the most recent failed OASIS conversion */
+static const char *conv_msg = NULL;
+
+/* descriptor of the most recently opened compressed file */
+static int cfd = -1;
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns 1 if the string str ends with ext
+ */
+static int
+has_extension(const char *str, const char *ext)
+{
+   size_t ls = strlen(str), le = strlen(ext);
+
+   return ls >= le && !strcmp(str + ls - le, ext);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+stream_error(void)
+{
+   return conv_msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+stream_fileno(void)
+{
+   return cfd;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+FILE *
+stream_open(const char *fname, const char *mode, stream_kind *kind)
+{
+   FILE *fob;
+   unsigned char magic[OAS_MAGIC_LEN];
+   size_t nr;
+
+   *kind = STREAM_PLAIN;
+   conv_msg = NULL;
+   cfd = -1;
+
+   if (mode[0] == 'r') {
+      fob = fopen(fname, mode);
+      if (fob == NULL)
+	 return NULL;
+
+      /* check the magic number of compressed and OASIS files */
+      nr = fread(magic, 1, OAS_MAGIC_LEN, fob);
+      if (nr >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+	 *kind = STREAM_GZIP;
+      else if (nr >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 &&
+	       magic[2] == 0x2f && magic[3] == 0xfd)
+	 *kind = STREAM_ZSTD;
+      else if (nr == OAS_MAGIC_LEN && !memcmp(magic, OAS_MAGIC, OAS_MAGIC_LEN))
+	 *kind = STREAM_OASIS;
+
+      if (*kind == STREAM_PLAIN || *kind == STREAM_OASIS) {
+	 if ( fseek(fob, 0L, SEEK_SET) < 0 ) {
+	    fclose(fob);
+	    return NULL;
+	 }
+	 return *kind == STREAM_OASIS ? oasis_read(fob) : fob;
+      }
+      fclose(fob);
+   }
+   else {
+      if ( has_extension(fname, ".gz") )
+	 *kind = STREAM_GZIP;
+      else if ( has_extension(fname, ".zst") )
+	 *kind = STREAM_ZSTD;
+      else if ( has_extension(fname, ".oas") ) {
+	 *kind = STREAM_OASIS;
+#if defined HAVE_OSTREAM
+	 return ostream_open(fname);
+#else
+	 return NULL;
+#endif
+      }
+      else
+	 return fopen(fname, mode);
+   }
+
+#if defined HAVE_CSTREAM
+   return cstream_open(fname, mode, *kind);
+#else
+   return NULL;
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#if defined HAVE_CSTREAM
+
+#if defined HAVE_FOPENCOOKIE
+
+static ssize_t
+cookie_read(void *c, char *buf, size_t size)
+{
+   return (ssize_t)cs_read((cstream_t *)c, buf, size);
+}
+
+static ssize_t
+cookie_write(void *c, const char *buf, size_t size)
+{
+   return (ssize_t)cs_write((cstream_t *)c, buf, size);
+}
+
+static int
+cookie_seek(void *c, off64_t *offset, int whence)
+{
+   int64_t off = *offset;
+   int ret;
+
+   ret = cs_seek((cstream_t *)c, &off, whence);
+   *offset = off;
+   return ret;
+}
+
+static int
+cookie_close(void *c)
+{
+   return cs_close((cstream_t *)c);
+}
+
+#else /* funopen */
+
+static int
+cookie_read(void *c, char *buf, int size)
+{
+   return (int)cs_read((cstream_t *)c, buf, (size_t)size);
+}
+
+static int
+cookie_write(void *c, const char *buf, int size)
+{
+   return (int)cs_write((cstream_t *)c, buf, (size_t)size);
+}
+
+static fpos_t
+cookie_seek(void *c, fpos_t offset, int whence)
+{
+   int64_t off = (int64_t)offset;
+
+   if ( cs_seek((cstream_t *)c, &off, whence) )
+      return (fpos_t)-1;
+   return (fpos_t)off;
+}
+
+static int
+cookie_close(void *c)
+{
+   return cs_close((cstream_t *)c);
+}
+
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+static FILE *
+cstream_open(const char *fname, const char *mode, stream_kind kind)
+{
+   cstream_t *cs;
+   FILE *fs;
+
+   cs = calloc(1, sizeof(cstream_t));
+   if (cs == NULL)
+      return NULL;
+   cs->kind = kind;
+   cs->writing = (mode[0] == 'w');
+
+   switch (kind) {
+
+#if defined HAVE_ZLIB
+      case STREAM_GZIP:
+	 {
+	    /* opened here to know the descriptor */
+	    int fd = cs->writing ? open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0666)
+	                         : open(fname, O_RDONLY);
+	    if (fd < 0)
+	       goto fail;
+	    cs->gz = gzdopen(fd, cs->writing ? "wb" : "rb");
+	    if (cs->gz == NULL) {
+	       close(fd);
+	       goto fail;
+	    }
+	    gzbuffer(cs->gz, BLKSIZE);
+	    cs->fd = fd;
+	 }
+	 break;
+#endif
+
+#if defined HAVE_ZSTD
+      case STREAM_ZSTD:
+	 cs->fob = fopen(fname, cs->writing ? "wb" : "rb");
+	 if (cs->fob == NULL)
+	    goto fail;
+	 cs->fd = fileno(cs->fob);
+	 if (cs->writing) {
+	    cs->cctx = ZSTD_createCCtx();
+	    if (cs->cctx == NULL)
+	       goto fail;
+	    /* compress with all processors; ignored without zstd MT support */
+	    ZSTD_CCtx_setParameter(cs->cctx, ZSTD_c_nbWorkers,
+				   (int)sysconf(_SC_NPROCESSORS_ONLN));
+	    cs->zsize = ZSTD_CStreamOutSize();
+	 }
+	 else {
+	    cs->dctx = ZSTD_createDCtx();
+	    if (cs->dctx == NULL)
+	       goto fail;
+	    cs->zsize = ZSTD_DStreamInSize();
+	 }
+	 cs->zbuf = malloc(cs->zsize);
+	 if (cs->zbuf == NULL)
+	    goto fail;
+	 cs->in.src = cs->zbuf;
+	 break;
+#endif
+
+      default:
+	 goto fail;
+   }
+
+   if ( !cs->writing ) {
+      cs->blk = malloc(2*BLKSIZE);
+      if (cs->blk == NULL)
+	 goto fail;
+   }
+
+   /* the stdio stream */
+#if defined HAVE_FOPENCOOKIE
+   {
+      cookie_io_functions_t iof = {cookie_read, cookie_write, cookie_seek, cookie_close};
+      fs = fopencookie(cs, cs->writing ? "w" : "r", iof);
+   }
+#else
+   fs = funopen(cs, cs->writing ? NULL : cookie_read, cs->writing ? cookie_write : NULL,
+		cookie_seek, cookie_close);
+#endif
+   if (fs == NULL)
+      goto fail;
+   cfd = cs->fd;
+
+   return fs;
+
+ fail:
+   cs_close(cs);
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * switches to the other block
+ */
+static void
+swap_block(cstream_t *cs)
+{
+   size_t n;
+
+   if (cs->other > 0)
+      cs->pos += cs->nblk;
+   else
+      cs->pos -= cs->nother;
+   n = cs->nblk;
+   cs->nblk = cs->nother;
+   cs->nother = n;
+   cs->other = -cs->other;
+   cs->data = (cs->data == cs->blk) ? cs->blk + BLKSIZE : cs->blk;
+   cs->cur = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * advances to the next block. Returns the number of bytes in the
+ * block, 0 at the end of the file, or -1 on error. The preceding
+ * block is kept in the other buffer, which makes short backward
+ * seeks cheap, e.g. from the end of the file.
+ */
+static int64_t
+fill_block(cstream_t *cs)
+{
+   uint8_t *pb;
+   size_t n = 0;
+
+   /* the next block was already decompressed */
+   if (cs->other > 0) {
+      swap_block(cs);
+      return (int64_t)cs->nblk;
+   }
+
+   /* decompress into the other buffer */
+   pb = (cs->data == cs->blk) ? cs->blk + BLKSIZE : cs->blk;
+
+   switch (cs->kind) {
+
+#if defined HAVE_ZLIB
+      case STREAM_GZIP:
+	 {
+	    int nr = gzread(cs->gz, pb, BLKSIZE);
+	    if (nr < 0)
+	       return -1;
+	    n = (size_t)nr;
+	 }
+	 break;
+#endif
+
+#if defined HAVE_ZSTD
+      case STREAM_ZSTD:
+	 {
+	    ZSTD_outBuffer out = {pb, BLKSIZE, 0};
+	    size_t ret;
+
+	    while (out.pos < out.size) {
+	       if (cs->in.pos == cs->in.size) {
+		  cs->in.size = fread(cs->zbuf, 1, cs->zsize, cs->fob);
+		  cs->in.pos = 0;
+		  if (cs->in.size == 0)
+		     break;
+	       }
+	       ret = ZSTD_decompressStream(cs->dctx, &out, &cs->in);
+	       if ( ZSTD_isError(ret) )
+		  return -1;
+	    }
+	    n = out.pos;
+	 }
+	 break;
+#endif
+
+      default:
+	 return -1;
+   }
+
+   if (n) {
+      cs->nother = cs->nblk;
+      cs->other = cs->nblk ? -1 : 0;
+      cs->pos += cs->nblk;
+      cs->nblk = n;
+      cs->cur = 0;
+      cs->data = pb;
+   }
+
+   return (int64_t)n;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * restarts decompression at the beginning of the file
+ */
+static int
+rewind_stream(cstream_t *cs)
+{
+   cs->pos = 0;
+   cs->nblk = 0;
+   cs->cur = 0;
+   cs->other = 0;
+
+   switch (cs->kind) {
+
+#if defined HAVE_ZLIB
+      case STREAM_GZIP:
+	 return gzrewind(cs->gz);
+#endif
+
+#if defined HAVE_ZSTD
+      case STREAM_ZSTD:
+	 cs->in.size = cs->in.pos = 0;
+	 if ( ZSTD_isError(ZSTD_DCtx_reset(cs->dctx, ZSTD_reset_session_only)) )
+	    return -1;
+	 return fseek(cs->fob, 0L, SEEK_SET);
+#endif
+
+      default:
+	 return -1;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int64_t
+cs_read(cstream_t *cs, char *buf, size_t size)
+{
+   size_t n, nr = 0;
+   int64_t ret;
+
+   while (nr < size) {
+      if (cs->cur == cs->nblk) {
+	 ret = fill_block(cs);
+	 if (ret < 0)
+	    return nr ? (int64_t)nr : -1;
+	 if (ret == 0)
+	    break;
+      }
+      n = cs->nblk - cs->cur;
+      if (n > size - nr)
+	 n = size - nr;
+      memcpy(buf + nr, cs->data + cs->cur, n);
+      cs->cur += n;
+      nr += n;
+   }
+
+   return (int64_t)nr;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int64_t
+cs_write(cstream_t *cs, const char *buf, size_t size)
+{
+   switch (cs->kind) {
+
+#if defined HAVE_ZLIB
+      case STREAM_GZIP:
+	 if (size && gzwrite(cs->gz, buf, (unsigned)size) == 0)
+	    return -1;
+	 break;
+#endif
+
+#if defined HAVE_ZSTD
+      case STREAM_ZSTD:
+	 {
+	    ZSTD_inBuffer in = {buf, size, 0};
+	    ZSTD_outBuffer out;
+	    size_t ret;
+
+	    while (in.pos < in.size) {
+	       out.dst = cs->zbuf;
+	       out.size = cs->zsize;
+	       out.pos = 0;
+	       ret = ZSTD_compressStream2(cs->cctx, &out, &in, ZSTD_e_continue);
+	       if ( ZSTD_isError(ret) )
+		  return -1;
+	       if (fwrite(cs->zbuf, 1, out.pos, cs->fob) != out.pos)
+		  return -1;
+	    }
+	 }
+	 break;
+#endif
+
+      default:
+	 return -1;
+   }
+
+   cs->pos += size;
+
+   return (int64_t)size;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cs_seek(cstream_t *cs, int64_t *offset, int whence)
+{
+   int64_t target;
+
+   /* current position */
+   target = cs->writing ? cs->pos : cs->pos + (int64_t)cs->cur;
+
+   if (whence == SEEK_CUR)
+      target += *offset;
+   else if (whence == SEEK_SET)
+      target = *offset;
+   else
+      return -1;   /* size of decompressed data is not known */
+
+   if (target < 0)
+      return -1;
+
+   if (cs->writing) {
+      if (target != cs->pos)
+	 return -1;
+      *offset = target;
+      return 0;
+   }
+
+   /* decompress up to the target position */
+   if (target < cs->pos) {
+      if (cs->other < 0 && target >= cs->pos - (int64_t)cs->nother)
+	 swap_block(cs);
+      else if ( rewind_stream(cs) )
+	 return -1;
+   }
+   while (target > cs->pos + (int64_t)cs->nblk) {
+      if (fill_block(cs) <= 0)
+	 return -1;
+   }
+   cs->cur = (size_t)(target - cs->pos);
+   *offset = target;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cs_close(cstream_t *cs)
+{
+   int ret = 0;
+
+#if defined HAVE_ZLIB
+   if (cs->gz != NULL && gzclose(cs->gz) != Z_OK)
+      ret = -1;
+#endif
+
+#if defined HAVE_ZSTD
+   if (cs->cctx != NULL && cs->fob != NULL) {
+      ZSTD_inBuffer in = {NULL, 0, 0};
+      ZSTD_outBuffer out;
+      size_t rem;
+
+      /* flush the end of the frame */
+      do {
+	 out.dst = cs->zbuf;
+	 out.size = cs->zsize;
+	 out.pos = 0;
+	 rem = ZSTD_compressStream2(cs->cctx, &out, &in, ZSTD_e_end);
+	 if ( ZSTD_isError(rem) ) {
+	    ret = -1;
+	    break;
+	 }
+	 if (fwrite(cs->zbuf, 1, out.pos, cs->fob) != out.pos) {
+	    ret = -1;
+	    break;
+	 }
+      } while (rem);
+   }
+   ZSTD_freeCCtx(cs->cctx);
+   ZSTD_freeDCtx(cs->dctx);
+   if (cs->fob != NULL && fclose(cs->fob))
+      ret = -1;
+   free(cs->zbuf);
+#endif
+
+   free(cs->blk);
+   free(cs);
+
+   return ret;
+}
+
+#endif /* HAVE_CSTREAM */
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * converts an OASIS file into a GDSII library in a temporary
+ * file, which is deleted when it is closed. The OASIS file is
+ * closed.
+ */
+static FILE *
+oasis_read(FILE *fob)
+{
+   FILE *tmp;
+
+   tmp = tmpfile();
+   if (tmp == NULL)
+      conv_msg = "failed to create temporary file.";
+   else {
+      if ( (conv_msg = oas_read(fob, tmp)) || fseek(tmp, 0L, SEEK_SET) < 0 ) {
+	 fclose(tmp);
+	 tmp = NULL;
+      }
+   }
+   fclose(fob);
+
+   return tmp;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#if defined HAVE_OSTREAM
+
+#if defined HAVE_FOPENCOOKIE
+
+static ssize_t
+ocookie_write(void *c, const char *buf, size_t size)
+{
+   return (ssize_t)fwrite(buf, 1, size, ((ostream_t *)c)->tmp);
+}
+
+static int
+ocookie_seek(void *c, off64_t *offset, int whence)
+{
+   FILE *tmp = ((ostream_t *)c)->tmp;
+
+   if ( fseeko(tmp, (off_t)*offset, whence) )
+      return -1;
+   *offset = ftello(tmp);
+   return 0;
+}
+
+static int
+ocookie_close(void *c)
+{
+   return os_close((ostream_t *)c);
+}
+
+#else /* funopen */
+
+static int
+ocookie_write(void *c, const char *buf, int size)
+{
+   return (int)fwrite(buf, 1, (size_t)size, ((ostream_t *)c)->tmp);
+}
+
+static fpos_t
+ocookie_seek(void *c, fpos_t offset, int whence)
+{
+   FILE *tmp = ((ostream_t *)c)->tmp;
+
+   if ( fseeko(tmp, (off_t)offset, whence) )
+      return (fpos_t)-1;
+   return (fpos_t)ftello(tmp);
+}
+
+static int
+ocookie_close(void *c)
+{
+   return os_close((ostream_t *)c);
+}
+
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+static FILE *
+ostream_open(const char *fname)
+{
+   ostream_t *os;
+   FILE *fs;
+
+   os = calloc(1, sizeof(ostream_t));
+   if (os == NULL)
+      return NULL;
+   os->fname = malloc(strlen(fname) + 1);
+   if (os->fname == NULL)
+      goto fail;
+   strcpy(os->fname, fname);
+
+   /* the OASIS file must be writable */
+   fs = fopen(fname, "wb");
+   if (fs == NULL)
+      goto fail;
+   fclose(fs);
+
+   os->tmp = tmpfile();
+   if (os->tmp == NULL)
+      goto fail;
+
+#if defined HAVE_FOPENCOOKIE
+   {
+      cookie_io_functions_t iof = {NULL, ocookie_write, ocookie_seek, ocookie_close};
+      fs = fopencookie(os, "w", iof);
+   }
+#else
+   fs = funopen(os, NULL, ocookie_write, ocookie_seek, ocookie_close);
+#endif
+   if (fs != NULL)
+      return fs;
+
+ fail:
+   if (os->tmp != NULL)
+      fclose(os->tmp);
+   free(os->fname);
+   free(os);
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * converts the GDSII library to an OASIS file with compressed
+ * cells
+ */
+static int
+os_close(ostream_t *os)
+{
+   FILE *fob;
+   const char *msg = "failed to write OASIS file.";
+
+   if ( !fflush(os->tmp) && !fseek(os->tmp, 0L, SEEK_SET) ) {
+      fob = fopen(os->fname, "wb");
+      if (fob != NULL) {
+	 msg = oas_write(os->tmp, fob, 1);
+	 if ( fclose(fob) && !msg )
+	    msg = "failed to write OASIS file.";
+	 if (msg)
+	    remove(os->fname);   /* no incomplete OASIS files */
+      }
+   }
+   conv_msg = msg;
+
+   fclose(os->tmp);
+   free(os->fname);
+   free(os);
+
+   return msg ? -1 : 0;
+}
+
+#endif /* HAVE_OSTREAM */
+
+/*-----------------------------------------------------------------*/
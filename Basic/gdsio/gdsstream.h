@@ -0,0 +1,74 @@
+/*
+ * Opening of GDSII library files with transparent compression and
+ * of OASIS files.
+ *
+ * Library files compressed with gzip or zstd are read and written
+ * through a stdio stream (FILE *) that compresses or decompresses
+ * the data on the fly. All functions working on streams, including
+ * the record functions in gdsio.h, can be used with these streams
+ * just like with uncompressed files. Compressed streams are
+ * available when the toolbox is compiled with HAVE_ZLIB (gzip)
+ * and/or HAVE_ZSTD (zstd) on systems with fopencookie or funopen.
+ *
+ * Seeking in a compressed stream opened for reading is supported
+ * but slow: forward seeks decompress and skip the data, backward
+ * seeks outside the most recently decompressed block restart from
+ * the beginning of the file. Compressed streams opened for writing
+ * cannot be repositioned.
+ *
+ * OASIS files are converted (see oasis.h): when reading, into a
+ * GDSII library in a temporary file, which is returned; when
+ * writing, the returned stream writes a GDSII library into a
+ * temporary file that is converted to OASIS when the stream is
+ * closed. Errors of the conversion on closing are reported by
+ * fclose; the reason of a failed conversion is returned by
+ * stream_error. Writing OASIS files requires fopencookie or funopen.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _GDSSTREAM_H
+#define _GDSSTREAM_H
+
+#include <stdio.h>
+
+/* compression formats */
+typedef enum {STREAM_PLAIN = 0, STREAM_GZIP, STREAM_ZSTD, STREAM_OASIS} stream_kind;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * open a library file. When reading, the compression format or
+ * an OASIS file is detected from the first bytes of the file. When
+ * writing, it is selected by the file name extension ('.gz', '.zst'
+ * or '.oas'). Returns NULL when the file cannot be opened, when the
+ * compression format is not supported, or when an OASIS file cannot
+ * be converted; the format is returned in kind.
+ *
+ * fname :  file name
+ * mode :   'rb' or 'wb'
+ * kind :   compression format of the file
+ */
+FILE *stream_open(const char *fname, const char *mode, stream_kind *kind);
+
+/*
+ * returns the error message of the most recent OASIS conversion
+ * when it failed, otherwise NULL. The message is reset by
+ * stream_open and set when an OASIS file is opened for reading or
+ * when the stream of an OASIS file opened for writing is closed.
+ */
+const char *stream_error(void);
+
+/*
+ * returns the file descriptor of the compressed file behind the
+ * stream most recently opened by stream_open, or -1 when the file
+ * is not compressed. The file offset of the descriptor tells how
+ * much of the compressed file was read, e.g. for reporting the
+ * progress of reading a library.
+ */
+int stream_fileno(void);
+
+#endif /* _GDSSTREAM_H */
@@ -89,6 +89,15 @@
 #define HAS_MAG       (1<<18)
 
 
+/*
+ * maximum number of vertices in an XY record. Boundaries and paths
+ * with more vertices are written as a sequence of XY records in
+ * which each continuation record starts with the last vertex of the
+ * preceding (full) record.
+ */
+#define MAX_XY_VERTICES  8191
+
+
 /* 
  * dates 
  */
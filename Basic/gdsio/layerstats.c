@@ -0,0 +1,368 @@
+/*
+ * Layer statistics of GDSII libraries (see layerstats.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "layerstats.h"
+#include "pathpoly.h"
+
+#define MIN_SLOTS  64
+
+
+typedef struct {
+   const char *name;
+   size_t idx;
+} name_idx_t;
+
+
+/*-- local functions ----------------------------------------------*/
+
+static ls_entry_t *get_entry(ls_struct_t *st, uint32_t key);
+static int rehash(ls_struct_t *st, size_t nslot);
+static size_t key_slot(uint32_t key, size_t nslot);
+static int cmp_entries(const void *a, const void *b);
+static int cmp_names(const void *a, const void *b);
+
+
+/*-----------------------------------------------------------------*/
+
+int
+ls_add(ls_struct_t *st, uint16_t layer, uint16_t dtype, int col,
+       double nel, double nv, double a)
+{
+   ls_entry_t *pe;
+
+   if ( (pe = get_entry(st, LS_KEY(layer,dtype))) == NULL )
+      return -1;
+   pe->val[col] += nel;
+   pe->val[LS_VERTICES] += nv;
+   pe->val[LS_AREA] += a;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+ls_add_ref(ls_struct_t *st, const char *name, double mult)
+{
+   char **pr;
+   double *pm;
+   size_t na;
+
+   if (st->nref == st->aref) {
+      na = st->aref ? 2*st->aref : 16;
+      if ( (pr = realloc(st->ref, na*sizeof(char *))) == NULL )
+	 return -1;
+      st->ref = pr;
+      if ( (pm = realloc(st->mult, na*sizeof(double))) == NULL )
+	 return -1;
+      st->mult = pm;
+      st->aref = na;
+   }
+   if ( (st->ref[st->nref] = malloc(strlen(name)+1)) == NULL )
+      return -1;
+   strcpy(st->ref[st->nref], name);
+   st->mult[st->nref++] = mult;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+double
+ls_polygon_area(const double *x, const double *y, size_t nv, size_t stride)
+{
+   double a = 0.0;
+   size_t k, j;
+
+   if (nv < 3)
+      return 0.0;
+   for (k=0,j=nv-1; k<nv; j=k++)
+      a += x[j*stride] * y[k*stride] - x[k*stride] * y[j*stride];
+
+   return 0.5 * fabs(a);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+double
+ls_path_area(ls_struct_t *st, const double *x, const double *y, size_t nv,
+             size_t stride, double hw, int ptype, const double *ext)
+{
+   double *pn;
+   size_t m;
+
+   m = pathpoly_size(x, y, nv, stride, ptype);
+   if (!m || hw <= 0.0)
+      return 0.0;
+   if (m > st->apoly) {
+      if ( (pn = realloc(st->px, 2*m*sizeof(double))) == NULL )
+	 return -1.0;
+      st->px = pn;
+      st->py = pn + m;
+      st->apoly = m;
+   }
+   m = pathpoly(x, y, nv, stride, hw, ptype, ext, st->px, st->py, 1);
+
+   return ls_polygon_area(st->px, st->py, m, 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+const ls_entry_t *
+ls_find(const ls_struct_t *st, uint32_t key)
+{
+   size_t s;
+
+   if (!st->nslot)
+      return NULL;
+   for (s=key_slot(key, st->nslot); st->slot[s]; s=(s+1) & (st->nslot-1)) {
+      if (st->ent[st->slot[s]-1].key == key)
+	 return &st->ent[st->slot[s]-1];
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+ls_instances(ls_struct_t *st, const char **names, size_t n,
+             const char *top, double *inst)
+{
+   name_idx_t *sorted = NULL, key, *pf;
+   size_t *nin = NULL, *queue = NULL;
+   size_t k, r, p, c, head, tail;
+   int ret = 0;
+
+   sorted = malloc((n ? n : 1)*sizeof(name_idx_t));
+   nin = calloc(n ? n : 1, sizeof(size_t));
+   queue = malloc((n ? n : 1)*sizeof(size_t));
+   if (sorted == NULL || nin == NULL || queue == NULL) {
+      ret = -1;
+      goto done;
+   }
+   for (k=0; k<n; k++) {
+      sorted[k].name = names[k];
+      sorted[k].idx = k;
+      inst[k] = 0.0;
+   }
+   qsort(sorted, n, sizeof(name_idx_t), cmp_names);
+
+   /* number of references to each structure */
+   for (k=0; k<n; k++) {
+      for (r=0; r<st[k].nref; r++) {
+	 key.name = st[k].ref[r];
+	 pf = bsearch(&key, sorted, n, sizeof(name_idx_t), cmp_names);
+	 if (pf)
+	    nin[pf->idx]++;
+      }
+   }
+
+   /* the top structures */
+   if (top) {
+      key.name = top;
+      pf = bsearch(&key, sorted, n, sizeof(name_idx_t), cmp_names);
+      if (pf == NULL) {
+	 ret = -2;
+	 goto done;
+      }
+      inst[pf->idx] = 1.0;
+   }
+   else {
+      for (k=0; k<n; k++)
+	 if (!nin[k])
+	    inst[k] = 1.0;
+   }
+
+   /* pass the instances down in topological order */
+   head = tail = 0;
+   for (k=0; k<n; k++)
+      if (!nin[k])
+	 queue[tail++] = k;
+   while (head < tail) {
+      p = queue[head++];
+      for (r=0; r<st[p].nref; r++) {
+	 key.name = st[p].ref[r];
+	 pf = bsearch(&key, sorted, n, sizeof(name_idx_t), cmp_names);
+	 if (pf == NULL)
+	    continue;
+	 c = pf->idx;
+	 inst[c] += inst[p] * st[p].mult[r];
+	 if (--nin[c] == 0)
+	    queue[tail++] = c;
+      }
+   }
+   if (tail < n)
+      ret = -3;
+
+ done:
+   free(sorted);
+   free(nin);
+   free(queue);
+
+   return ret;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+ls_total(const ls_struct_t *st, size_t n, const double *w, ls_struct_t *sum)
+{
+   const ls_entry_t *ps;
+   ls_entry_t *pe;
+   double wk;
+   size_t k, j;
+   int c;
+
+   for (k=0; k<n; k++) {
+      wk = w ? w[k] : 1.0;
+      if (wk == 0.0)
+	 continue;
+      for (j=0; j<st[k].nent; j++) {
+	 ps = &st[k].ent[j];
+	 if ( (pe = get_entry(sum, ps->key)) == NULL )
+	    return -1;
+	 for (c=0; c<LS_NCOL; c++)
+	    pe->val[c] += wk * ps->val[c];
+      }
+   }
+
+   /* sort the entries and index them again */
+   qsort(sum->ent, sum->nent, sizeof(ls_entry_t), cmp_entries);
+
+   return rehash(sum, sum->nslot);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+ls_struct_free(ls_struct_t *st)
+{
+   size_t k;
+
+   for (k=0; k<st->nref; k++)
+      free(st->ref[k]);
+   free(st->ref);
+   free(st->mult);
+   free(st->ent);
+   free(st->slot);
+   free(st->px);
+   memset(st, 0, sizeof(ls_struct_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* returns the entry of a key; a new entry is created when needed */
+static ls_entry_t *
+get_entry(ls_struct_t *st, uint32_t key)
+{
+   ls_entry_t *pn;
+   size_t s, na;
+
+   if (st->nslot) {
+      for (s=key_slot(key, st->nslot); st->slot[s]; s=(s+1) & (st->nslot-1)) {
+	 if (st->ent[st->slot[s]-1].key == key)
+	    return &st->ent[st->slot[s]-1];
+      }
+   }
+
+   /* new entry */
+   if (st->nent == st->aent) {
+      na = st->aent ? 2*st->aent : 16;
+      if ( (pn = realloc(st->ent, na*sizeof(ls_entry_t))) == NULL )
+	 return NULL;
+      st->ent = pn;
+      st->aent = na;
+   }
+   pn = &st->ent[st->nent++];
+   memset(pn, 0, sizeof(ls_entry_t));
+   pn->key = key;
+
+   /* the hash table is at most half full */
+   if (2*st->nent > st->nslot) {
+      if ( rehash(st, st->nslot ? 2*st->nslot : MIN_SLOTS) )
+	 return NULL;
+   }
+   else {
+      for (s=key_slot(key, st->nslot); st->slot[s]; s=(s+1) & (st->nslot-1))
+	 ;
+      st->slot[s] = (uint32_t)st->nent;
+   }
+
+   return pn;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+rehash(ls_struct_t *st, size_t nslot)
+{
+   uint32_t *pn;
+   size_t k, s;
+
+   if (!nslot)
+      return 0;
+   if (nslot != st->nslot) {
+      if ( (pn = realloc(st->slot, nslot*sizeof(uint32_t))) == NULL )
+	 return -1;
+      st->slot = pn;
+      st->nslot = nslot;
+   }
+   memset(st->slot, 0, nslot*sizeof(uint32_t));
+   for (k=0; k<st->nent; k++) {
+      for (s=key_slot(st->ent[k].key, nslot); st->slot[s]; s=(s+1) & (nslot-1))
+	 ;
+      st->slot[s] = (uint32_t)(k+1);
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static size_t
+key_slot(uint32_t key, size_t nslot)
+{
+   return (size_t)((key * 2654435761u) >> 7) & (nslot - 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cmp_entries(const void *a, const void *b)
+{
+   uint32_t ka = ((const ls_entry_t *)a)->key;
+   uint32_t kb = ((const ls_entry_t *)b)->key;
+
+   /* by layer, then by data type */
+   ka = (ka << 16) | (ka >> 16);
+   kb = (kb << 16) | (kb >> 16);
+
+   return (ka > kb) - (ka < kb);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+cmp_names(const void *a, const void *b)
+{
+   return strcmp(((const name_idx_t *)a)->name, ((const name_idx_t *)b)->name);
+}
@@ -0,0 +1,119 @@
+/*
+ * Layer statistics of GDSII libraries.
+ *
+ * For every structure, the number of boundary, path, box, node, and
+ * text elements, the number of vertices, and the area of the
+ * elements are accumulated for each (layer, data type) pair. The
+ * references of the structure are recorded with their multiplicity
+ * (1 for sref elements, rows x columns for aref elements), from which
+ * the number of instances of each structure below a top structure is
+ * found. The hierarchical statistics are the sum of the statistics
+ * of all structures, weighted with their number of instances.
+ *
+ * Areas are the areas of boundaries and boxes, and of the polygons
+ * of paths (see pathpoly.h). Overlaps are not removed. All 65536
+ * layers and data types are supported.
+ *
+ * The functions do not use the MATLAB API. The statistics of
+ * different structures can be computed in different threads.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _LAYERSTATS_H
+#define _LAYERSTATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* columns of the statistics */
+enum {LS_BOUNDARY=0, LS_PATH, LS_BOX, LS_NODE, LS_TEXT, LS_VERTICES, LS_AREA,
+      LS_NCOL};
+
+/* key of a (layer, data type) pair */
+#define LS_KEY(layer,dtype)  ((uint32_t)(layer) | ((uint32_t)(dtype) << 16))
+
+
+/*
+ * statistics of one (layer, data type) pair
+ */
+typedef struct {
+   uint32_t key;
+   double val[LS_NCOL];
+} ls_entry_t;
+
+
+/*
+ * statistics of one structure. A structure must be set to zero
+ * before it is used for the first time.
+ */
+typedef struct {
+   ls_entry_t *ent;   size_t nent, aent;   /* statistics */
+   uint32_t *slot;    size_t nslot;        /* hash table of keys */
+   char **ref;        size_t nref, aref;   /* referenced structures */
+   double *mult;                           /* multiplicity of references */
+   double *px, *py;   size_t apoly;        /* path polygon buffer */
+} ls_struct_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * adds nel elements of column col (LS_BOUNDARY ... LS_TEXT) with nv
+ * vertices and area a on a (layer, data type) pair. Returns 0 on
+ * success and -1 when no memory is available.
+ */
+int ls_add(ls_struct_t *st, uint16_t layer, uint16_t dtype, int col,
+           double nel, double nv, double a);
+
+/*
+ * records a reference to structure name with multiplicity mult.
+ * Returns 0 on success and -1 when no memory is available.
+ */
+int ls_add_ref(ls_struct_t *st, const char *name, double mult);
+
+/*
+ * area of a closed polygon with vertices x[k*stride], y[k*stride]
+ */
+double ls_polygon_area(const double *x, const double *y, size_t nv, size_t stride);
+
+/*
+ * area of the polygon of a path (see pathpoly.h) with half width hw,
+ * path type ptype and extensions ext (may be NULL). Returns -1 when
+ * no memory is available.
+ */
+double ls_path_area(ls_struct_t *st, const double *x, const double *y, size_t nv,
+                    size_t stride, double hw, int ptype, const double *ext);
+
+/*
+ * returns the statistics entry of a (layer, data type) key or NULL
+ */
+const ls_entry_t *ls_find(const ls_struct_t *st, uint32_t key);
+
+/*
+ * finds the number of instances of n structures below a top
+ * structure, or below all structures that are not referenced when
+ * top is NULL. References to structures that are not in names are
+ * ignored. Returns 0 on success, -1 when no memory is available,
+ * -2 when the top structure is not found, and -3 when the
+ * structures reference each other in a cycle.
+ */
+int ls_instances(ls_struct_t *st, const char **names, size_t n,
+                 const char *top, double *inst);
+
+/*
+ * adds the statistics of n structures, weighted with w (NULL for
+ * weight 1), to the statistics in sum. The entries of sum are sorted
+ * by layer and data type. Returns 0 on success and -1 when no memory
+ * is available.
+ */
+int ls_total(const ls_struct_t *st, size_t n, const double *w, ls_struct_t *sum);
+
+/*
+ * release the memory of the statistics of a structure
+ */
+void ls_struct_free(ls_struct_t *st);
+
+#endif /* _LAYERSTATS_H */
@@ -0,0 +1,591 @@
+/*
+ * Structure index (table of contents) for GDSII libraries
+ * Copyright (c) 2026
+ */
+
+#if !defined _WIN32 && !defined _POSIX_C_SOURCE
+   #define _POSIX_C_SOURCE 200809L   /* for st_mtim */
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "gdstypes.h"
+#include "libindex.h"
+
+#define INDEX_MAGIC    "GDSIDX02"
+#define BYTE_ORDER_TAG 0x01020304U
+#define CHUNK          256
+
+
+/*
+ * state of the library scan
+ */
+typedef struct {
+   uint8_t lmap[65536/8];  /* layer bitmap */
+   uint32_t *seen;         /* last structure (1-based) that referenced
+                              each name, for merging repeated references */
+   size_t nseen;
+} scan_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static err_id scan_structure(lib_index_t *li, struct_index_t *si, map_file_t *mf, scan_t *sc);
+static err_id add_ref(lib_index_t *li, struct_index_t *si, scan_t *sc, const char *sname);
+static err_id resolve_names(lib_index_t *li);
+static char *copy_string(const uint8_t *p, int n);
+static int put_name(FILE *fob, const char *str);
+static char *get_name(FILE *fob);
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+index_build(lib_index_t *li, map_file_t *mf)
+{
+   struct_index_t *si;
+   scan_t *sc;
+   uint16_t rtype, rlen;
+   size_t spos;
+   err_id ret;
+
+   memset(li, 0, sizeof(lib_index_t));
+   li->fsize = mf->offset + mf->size;
+
+   sc = calloc(1, sizeof(scan_t));
+   if (sc == NULL)
+      return READ_REC_DATA;
+   if ( nametab_init(&li->names, CHUNK) ) {
+      free(sc);
+      return READ_REC_DATA;
+   }
+
+   if ( (ret = map_seek(mf, 0)) )
+      goto done;
+   while (1) {
+
+      spos = map_tell(mf);
+      if ( (ret = map_record_hdr(mf, &rtype, &rlen)) )
+	 goto done;
+
+      if (rtype == ENDLIB)
+	 break;
+
+      if (rtype != BGNSTR) {  /* library header records */
+	 if ( (ret = map_ignore(mf, rlen)) )
+	    goto done;
+	 continue;
+      }
+
+      /* new index entry */
+      if (li->nstruct == li->alloc) {
+	 struct_index_t *ps;
+	 ps = realloc(li->st, (li->alloc + CHUNK)*sizeof(struct_index_t));
+	 if (ps == NULL) {
+	    ret = READ_REC_DATA;
+	    goto done;
+	 }
+	 li->st = ps;
+	 li->alloc += CHUNK;
+      }
+      si = &li->st[li->nstruct++];
+      memset(si, 0, sizeof(struct_index_t));
+      si->offset = spos;
+
+      /* skip dates */
+      if ( (ret = map_ignore(mf, rlen)) )
+	 goto done;
+
+      if ( (ret = scan_structure(li, si, mf, sc)) )
+	 goto done;
+      si->nbytes = map_tell(mf) - spos;
+   }
+   ret = resolve_names(li);
+
+ done:
+   free(sc->seen);
+   free(sc);
+   return ret;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static err_id
+scan_structure(lib_index_t *li, struct_index_t *si, map_file_t *mf, scan_t *sc)
+{
+   uint8_t *lmap = sc->lmap;
+   uint16_t rtype, rlen;
+   uint16_t layer;
+   uint8_t *p;
+   uint32_t k;
+   err_id ret;
+
+   memset(lmap, 0, 65536/8);
+
+   while (1) {
+
+      if ( (ret = map_record_hdr(mf, &rtype, &rlen)) )
+	 return ret;
+
+      switch (rtype) {
+
+         case ENDSTR:
+	    goto done;
+
+         case STRNAME:
+	    if ( !(p = map_data(mf, rlen)) )
+	       return READ_CHAR;
+	    if ( !(si->sname = copy_string(p, rlen)) )
+	       return READ_REC_DATA;
+	    break;
+
+         case BOUNDARY:
+         case PATH:
+         case SREF:
+         case AREF:
+         case TEXT:
+         case NODE:
+         case BOX:
+	    si->nel++;
+	    break;
+
+         case SNAME:
+	    if ( !(p = map_data(mf, rlen)) )
+	       return READ_CHAR;
+	    {
+	       char *sname = copy_string(p, rlen);
+	       if (sname == NULL)
+		  return READ_REC_DATA;
+	       ret = add_ref(li, si, sc, sname);
+	       free(sname);
+	       if (ret)
+		  return ret;
+	    }
+	    break;
+
+         case LAYER:
+	    if ( (ret = map_word(mf, &layer)) )
+	       return ret;
+	    if ( !(lmap[layer >> 3] & (1 << (layer & 7))) ) {
+	       lmap[layer >> 3] |= (1 << (layer & 7));
+	       si->nlay++;
+	    }
+	    break;
+
+         default:
+	    if ( (ret = map_ignore(mf, rlen)) )
+	       return ret;
+      }
+   }
+
+ done:
+   if (si->sname == NULL)
+      return READ_REC_TYPE;
+
+   /* collect layers in ascending order */
+   if (si->nlay) {
+      si->layers = malloc(si->nlay*sizeof(uint16_t));
+      if (si->layers == NULL)
+	 return READ_REC_DATA;
+      for (k=0,layer=0; k<si->nlay; layer++) {
+	 if (lmap[layer >> 3] & (1 << (layer & 7)))
+	    si->layers[k++] = layer;
+      }
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static err_id
+add_ref(lib_index_t *li, struct_index_t *si, scan_t *sc, const char *sname)
+{
+   uint32_t *ps;
+   char **pr;
+   int32_t id;
+   int added;
+
+   /* record each referenced name only once per structure */
+   if ( (id = nametab_intern(&li->names, sname, &added)) < 0 )
+      return READ_REC_DATA;
+   if ((size_t)id >= sc->nseen) {
+      ps = realloc(sc->seen, li->names.alloc*sizeof(uint32_t));
+      if (ps == NULL)
+	 return READ_REC_DATA;
+      memset(ps + sc->nseen, 0, (li->names.alloc - sc->nseen)*sizeof(uint32_t));
+      sc->seen = ps;
+      sc->nseen = li->names.alloc;
+   }
+   if (sc->seen[id] == li->nstruct)
+      return A_OK;
+   sc->seen[id] = li->nstruct;
+
+   pr = realloc(si->refs, (si->nref + 1)*sizeof(char *));
+   if (pr == NULL)
+      return READ_REC_DATA;
+   si->refs = pr;
+   if ( !(si->refs[si->nref] = copy_string((const uint8_t *)sname, strlen(sname))) )
+      return READ_REC_DATA;
+   si->nref++;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static char *
+copy_string(const uint8_t *p, int n)
+{
+   char *str;
+
+   str = malloc(n + 1);
+   if (str == NULL)
+      return NULL;
+   memcpy(str, p, n);
+   str[n] = '\0';
+
+   return str;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * interns the structure names and resolves the names of referenced
+ * structures to index entries. When a name occurs more than once,
+ * the first structure with the name is used.
+ */
+static err_id
+resolve_names(lib_index_t *li)
+{
+   struct_index_t *si;
+   int32_t *sid;
+   int32_t id;
+   uint32_t k, j;
+   int added;
+
+   if (li->names.slot == NULL && nametab_init(&li->names, li->nstruct))
+      return READ_REC_DATA;
+
+   sid = malloc((li->nstruct + 1)*sizeof(int32_t));
+   if (sid == NULL)
+      return READ_REC_DATA;
+   for (k=0; k<li->nstruct; k++) {
+      if ( (sid[k] = nametab_intern(&li->names, li->st[k].sname, &added)) < 0 ) {
+	 free(sid);
+	 return READ_REC_DATA;
+      }
+   }
+
+   li->spos = malloc((li->names.n + 1)*sizeof(int32_t));
+   if (li->spos == NULL) {
+      free(sid);
+      return READ_REC_DATA;
+   }
+   for (k=0; k<li->names.n; k++)
+      li->spos[k] = -1;
+   for (k=0; k<li->nstruct; k++) {
+      if (li->spos[sid[k]] < 0)
+	 li->spos[sid[k]] = (int32_t)k;
+   }
+   free(sid);
+
+   for (k=0; k<li->nstruct; k++) {
+      si = &li->st[k];
+      si->rsi = malloc((si->nref + 1)*sizeof(int32_t));
+      if (si->rsi == NULL)
+	 return READ_REC_DATA;
+      for (j=0; j<si->nref; j++) {
+	 id = nametab_find(&li->names, si->refs[j]);
+	 si->rsi[j] = id < 0 ? -1 : li->spos[id];
+      }
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+index_find(const lib_index_t *li, const char *sname)
+{
+   int32_t id;
+
+   if (li->spos == NULL)
+      return -1;
+   id = nametab_find(&li->names, sname);
+
+   return id < 0 ? -1 : li->spos[id];
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+index_stat(const char *fname, uint64_t *fsize, int64_t *mtime)
+{
+   struct stat st;
+
+   if ( stat(fname, &st) )
+      return READ_OPEN_CLOSE;
+
+   *fsize = (uint64_t)st.st_size;
+#if defined __APPLE__
+   *mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined _WIN32
+   *mtime = (int64_t)st.st_mtime * 1000000000;
+#else
+   *mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+index_verify(lib_index_t *li, FILE *fob)
+{
+   struct_index_t *si;
+   uint8_t hdr[4];
+   char *name;
+   uint16_t rlen, rtype;
+   uint32_t k;
+   err_id ret = READ_REC_DATA;
+
+   name = malloc(65536);
+   if (name == NULL)
+      return READ_REC_DATA;
+
+   for (k=0; k<li->nstruct; k++) {
+      si = &li->st[k];
+
+      /* BGNSTR record */
+      if ( fseek(fob, (long)si->offset, SEEK_SET) < 0 || fread(hdr, 1, 4, fob) != 4 )
+	 goto done;
+      rlen = (hdr[0] << 8) | hdr[1];
+      rtype = (hdr[2] << 8) | hdr[3];
+      if (rtype != BGNSTR || rlen < 4 || fseek(fob, (long)(rlen - 4), SEEK_CUR) < 0)
+	 goto done;
+
+      /* followed by STRNAME with the name of the entry */
+      if ( fread(hdr, 1, 4, fob) != 4 )
+	 goto done;
+      rlen = (hdr[0] << 8) | hdr[1];
+      rtype = (hdr[2] << 8) | hdr[3];
+      if (rtype != STRNAME || rlen < 4)
+	 goto done;
+      if ( fread(name, 1, rlen - 4, fob) != (size_t)(rlen - 4) )
+	 goto done;
+      name[rlen - 4] = '\0';
+      if ( strcmp(name, si->sname) )
+	 goto done;
+   }
+   ret = A_OK;
+
+ done:
+   free(name);
+   return ret;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * Sidecar file layout (host byte order):
+ *
+ *   magic[8], byte order tag, library size, library mtime,
+ *   number of structures, then for each structure:
+ *   name, offset, nbytes, nel, nref, nref names, nlay, nlay layers
+ *
+ * Strings are stored as uint16 length followed by the characters.
+ */
+err_id
+index_save(lib_index_t *li, const char *fname)
+{
+   FILE *fob;
+   struct_index_t *si;
+   uint32_t tag = BYTE_ORDER_TAG;
+   uint32_t k, j;
+   int err = 0;
+
+   fob = fopen(fname, "wb");
+   if (fob == NULL)
+      return WRITE_OPEN_CLOSE;
+
+   err |= fwrite(INDEX_MAGIC, 1, 8, fob) != 8;
+   err |= fwrite(&tag, sizeof(uint32_t), 1, fob) != 1;
+   err |= fwrite(&li->fsize, sizeof(uint64_t), 1, fob) != 1;
+   err |= fwrite(&li->mtime, sizeof(int64_t), 1, fob) != 1;
+   err |= fwrite(&li->nstruct, sizeof(uint32_t), 1, fob) != 1;
+
+   for (k=0; k<li->nstruct && !err; k++) {
+      si = &li->st[k];
+      err |= put_name(fob, si->sname);
+      err |= fwrite(&si->offset, sizeof(uint64_t), 1, fob) != 1;
+      err |= fwrite(&si->nbytes, sizeof(uint64_t), 1, fob) != 1;
+      err |= fwrite(&si->nel, sizeof(uint32_t), 1, fob) != 1;
+      err |= fwrite(&si->nref, sizeof(uint32_t), 1, fob) != 1;
+      for (j=0; j<si->nref; j++)
+	 err |= put_name(fob, si->refs[j]);
+      err |= fwrite(&si->nlay, sizeof(uint32_t), 1, fob) != 1;
+      if (si->nlay)
+	 err |= fwrite(si->layers, sizeof(uint16_t), si->nlay, fob) != si->nlay;
+   }
+
+   if ( fclose(fob) || err ) {
+      remove(fname);
+      return WRITE_CHAR;
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+index_load(lib_index_t *li, const char *fname, uint64_t fsize, int64_t mtime)
+{
+   FILE *fob;
+   struct_index_t *si;
+   char magic[8];
+   uint32_t tag;
+   uint32_t k, j;
+   int err = 0;
+
+   memset(li, 0, sizeof(lib_index_t));
+
+   fob = fopen(fname, "rb");
+   if (fob == NULL)
+      return READ_OPEN_CLOSE;
+
+   /* check if the index belongs to the library */
+   err |= fread(magic, 1, 8, fob) != 8;
+   err |= fread(&tag, sizeof(uint32_t), 1, fob) != 1;
+   err |= fread(&li->fsize, sizeof(uint64_t), 1, fob) != 1;
+   err |= fread(&li->mtime, sizeof(int64_t), 1, fob) != 1;
+   err |= fread(&li->nstruct, sizeof(uint32_t), 1, fob) != 1;
+   if ( err || memcmp(magic, INDEX_MAGIC, 8) || tag != BYTE_ORDER_TAG ||
+	li->fsize != fsize || li->mtime != mtime ) {
+      fclose(fob);
+      li->nstruct = 0;
+      return READ_REC_DATA;
+   }
+
+   li->st = calloc(li->nstruct + 1, sizeof(struct_index_t));
+   if (li->st == NULL) {
+      fclose(fob);
+      li->nstruct = 0;
+      return READ_REC_DATA;
+   }
+   li->alloc = li->nstruct;
+
+   for (k=0; k<li->nstruct && !err; k++) {
+      si = &li->st[k];
+      err |= !(si->sname = get_name(fob));
+      err |= fread(&si->offset, sizeof(uint64_t), 1, fob) != 1;
+      err |= fread(&si->nbytes, sizeof(uint64_t), 1, fob) != 1;
+      err |= fread(&si->nel, sizeof(uint32_t), 1, fob) != 1;
+      err |= fread(&si->nref, sizeof(uint32_t), 1, fob) != 1;
+      if (err) break;
+      si->refs = calloc(si->nref + 1, sizeof(char *));
+      err |= si->refs == NULL;
+      for (j=0; j<si->nref && !err; j++)
+	 err |= !(si->refs[j] = get_name(fob));
+      if (err) break;
+      err |= fread(&si->nlay, sizeof(uint32_t), 1, fob) != 1;
+      if (err) break;
+      si->layers = malloc((si->nlay + 1)*sizeof(uint16_t));
+      err |= si->layers == NULL;
+      if (si->nlay && !err)
+	 err |= fread(si->layers, sizeof(uint16_t), si->nlay, fob) != si->nlay;
+   }
+   fclose(fob);
+
+   if ( err || resolve_names(li) ) {
+      index_free(li);
+      return READ_REC_DATA;
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+index_free(lib_index_t *li)
+{
+   struct_index_t *si;
+   uint32_t k, j;
+
+   for (k=0; k<li->nstruct; k++) {
+      si = &li->st[k];
+      free(si->sname);
+      if (si->refs) {
+	 for (j=0; j<si->nref; j++)
+	    free(si->refs[j]);
+	 free(si->refs);
+      }
+      free(si->rsi);
+      free(si->layers);
+   }
+   free(li->st);
+   free(li->spos);
+   nametab_free(&li->names);
+
+   memset(li, 0, sizeof(lib_index_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+put_name(FILE *fob, const char *str)
+{
+   uint16_t n;
+
+   n = (uint16_t)strlen(str);
+   if (fwrite(&n, sizeof(uint16_t), 1, fob) != 1)
+      return 1;
+   if (n && fwrite(str, 1, n, fob) != n)
+      return 1;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static char *
+get_name(FILE *fob)
+{
+   uint16_t n;
+   char *str;
+
+   if (fread(&n, sizeof(uint16_t), 1, fob) != 1)
+      return NULL;
+   str = malloc(n + 1);
+   if (str == NULL)
+      return NULL;
+   if (n && fread(str, 1, n, fob) != n) {
+      free(str);
+      return NULL;
+   }
+   str[n] = '\0';
+
+   return str;
+}
+
+/*-----------------------------------------------------------------*/
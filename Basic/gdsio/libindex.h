@@ -0,0 +1,102 @@
+/*
+ * Structure index (table of contents) for GDSII libraries.
+ *
+ * The index records the position and size of all structures in a
+ * library file together with the number of elements, the names of
+ * referenced structures and the layers used in each structure. It
+ * is built in a single pass over the record headers and can be
+ * stored in a sidecar file next to the library.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _LIBINDEX_H
+#define _LIBINDEX_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "gdsio.h"
+#include "mapio.h"
+#include "refgraph.h"
+
+
+/*
+ * index entry for one structure
+ */
+typedef struct {
+   char *sname;          /* structure name */
+   uint64_t offset;      /* file position of BGNSTR record */
+   uint64_t nbytes;      /* number of bytes up to and including ENDSTR */
+   uint32_t nel;         /* number of elements */
+   uint32_t nref;        /* number of referenced structures */
+   char **refs;          /* names of referenced structures */
+   int32_t *rsi;         /* index entries of the referenced structures,
+                            -1 for external references */
+   uint32_t nlay;        /* number of layers */
+   uint16_t *layers;     /* layers in ascending order */
+} struct_index_t;
+
+
+/*
+ * index of a library file
+ */
+typedef struct {
+   uint64_t fsize;       /* size of the library file */
+   int64_t mtime;        /* modification time of the library file in ns */
+   uint32_t nstruct;     /* number of structures */
+   uint32_t alloc;       /* allocated index entries */
+   struct_index_t *st;   /* index entries */
+   nametab_t names;      /* structure and reference names */
+   int32_t *spos;        /* index entry of each name, -1 for names
+                            of external structures */
+} lib_index_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * build the index by scanning the record headers of a library
+ * in memory, starting at the beginning of the file. The names of
+ * referenced structures are resolved to index entries.
+ */
+err_id index_build(lib_index_t *li, map_file_t *mf);
+
+/*
+ * return the size and the modification time of a library file;
+ * the time is in nanoseconds where the file system provides it.
+ */
+err_id index_stat(const char *fname, uint64_t *fsize, int64_t *mtime);
+
+/*
+ * write the index to a sidecar file
+ */
+err_id index_save(lib_index_t *li, const char *fname);
+
+/*
+ * read an index from a sidecar file. Returns READ_REC_DATA when the
+ * index does not belong to a library with size fsize and
+ * modification time mtime (see index_stat).
+ */
+err_id index_load(lib_index_t *li, const char *fname, uint64_t fsize, int64_t mtime);
+
+/*
+ * check that a BGNSTR record with the structure name of the entry
+ * is found at the offset of each index entry in the library file.
+ * Returns READ_REC_DATA when the index does not match the file.
+ */
+err_id index_verify(lib_index_t *li, FILE *fob);
+
+/*
+ * return the position of a structure in the index or -1 if
+ * the structure is not in the index.
+ */
+int index_find(const lib_index_t *li, const char *sname);
+
+/*
+ * release the memory used by an index
+ */
+void index_free(lib_index_t *li);
+
+#endif /* _LIBINDEX_H */
@@ -0,0 +1,242 @@
+/*
+ * Functions for reading GDSII records from memory
+ * Copyright (c) 2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mapio.h"
+
+#if !defined _WIN32
+   #include <sys/types.h>
+   #include <sys/stat.h>
+   #include <sys/mman.h>
+   #include <unistd.h>
+   #define HAVE_MMAP
+#endif
+
+#define CHUNK 4096
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+map_open(map_file_t *mf, FILE *fob)
+{
+   long int fpos;
+
+   memset(mf, 0, sizeof(map_file_t));
+
+   fpos = ftell(fob);
+   if (fpos < 0)
+      return READ_OPEN_CLOSE;
+
+   /* compressed streams have no file descriptor; keep a window */
+   if (fileno(fob) < 0) {
+      mf->offset = (size_t)fpos;
+      mf->fob = fob;
+      if ( map_fill(mf, 1) ) {
+	 free(mf->base);
+	 memset(mf, 0, sizeof(map_file_t));
+	 return READ_REC_DATA;
+      }
+      return A_OK;
+   }
+
+#if defined HAVE_MMAP
+   {
+      struct stat st;
+      void *pm;
+
+      if ( fstat(fileno(fob), &st) )
+	 return READ_OPEN_CLOSE;
+      if (st.st_size == 0)
+	 return READ_OPEN_CLOSE;
+
+      pm = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(fob), 0);
+      if (pm != MAP_FAILED) {
+	 madvise(pm, (size_t)st.st_size, MADV_SEQUENTIAL);
+	 mf->base = (uint8_t *)pm;
+	 mf->size = (size_t)st.st_size;
+	 mf->pos = (size_t)fpos;
+	 mf->mapped = 1;
+	 return A_OK;
+      }
+   }
+#endif
+
+   /* no memory mapping; read the rest of the file into a buffer */
+   {
+      long int fsize;
+      size_t nr;
+
+      if (fseek(fob, 0L, SEEK_END) < 0)
+	 return READ_OPEN_CLOSE;
+      fsize = ftell(fob);
+      if (fsize < 0 || fseek(fob, fpos, SEEK_SET) < 0)
+	 return READ_OPEN_CLOSE;
+
+      mf->alloc = (size_t)(fsize - fpos);
+      mf->base = malloc(mf->alloc + 1);
+      if (mf->base == NULL)
+	 return READ_OPEN_CLOSE;
+      nr = fread(mf->base, sizeof(uint8_t), mf->alloc, fob);
+      if (nr != mf->alloc) {
+	 free(mf->base);
+	 mf->base = NULL;
+	 return READ_REC_DATA;
+      }
+      mf->size = mf->alloc;
+      mf->offset = (size_t)fpos;
+      mf->pos = 0;
+      mf->mapped = 0;
+   }
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+map_fill(map_file_t *mf, size_t n)
+{
+   size_t na, nr;
+   uint8_t *pn;
+
+   if (mf->fob == NULL)
+      return READ_REC_DATA;
+
+   /* discard the data before the read position */
+   if (mf->pos) {
+      memmove(mf->base, mf->base + mf->pos, mf->size - mf->pos);
+      mf->offset += mf->pos;
+      mf->size -= mf->pos;
+      mf->pos = 0;
+   }
+
+   /* the window must hold n bytes */
+   if (n > mf->alloc || mf->alloc == 0) {
+      na = mf->alloc ? mf->alloc : MAP_WINDOW;
+      while (na < n)
+	 na *= 2;
+      pn = realloc(mf->base, na);
+      if (pn == NULL)
+	 return READ_REC_DATA;
+      STATS_ALLOC(na);
+      mf->base = pn;
+      mf->alloc = na;
+   }
+
+   /* the stream is positioned at the end of the window */
+   while (mf->size < mf->alloc) {
+      nr = fread(mf->base + mf->size, sizeof(uint8_t), mf->alloc - mf->size, mf->fob);
+      if (nr == 0)
+	 break;
+      mf->size += nr;
+   }
+   if ( ferror(mf->fob) || mf->size < n )
+      return READ_REC_DATA;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+map_window(map_file_t *mf, size_t fpos)
+{
+   if (mf->fob == NULL || fseek(mf->fob, (long int)fpos, SEEK_SET) < 0)
+      return READ_REC_HEADER;
+   mf->offset = fpos;
+   mf->size = 0;
+   mf->pos = 0;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+map_close(map_file_t *mf, FILE *fob)
+{
+   err_id ret = A_OK;
+
+   if (mf->base == NULL)
+      return A_OK;
+
+   /* synchronize stream position */
+   if (fob != NULL && fseek(fob, (long int)map_tell(mf), SEEK_SET) < 0)
+      ret = READ_OPEN_CLOSE;
+
+#if defined HAVE_MMAP
+   if (mf->mapped)
+      munmap(mf->base, mf->size);
+   else
+#endif
+      free(mf->base);
+
+   memset(mf, 0, sizeof(map_file_t));
+
+   return ret;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+err_id
+map_read_element(map_file_t *mf, FILE *fob)
+{
+   uint16_t hdr[2];
+   uint16_t rtype, rlen;
+   size_t need;
+
+   mf->size = 0;
+   mf->pos = 0;
+   mf->offset = 0;
+   mf->mapped = 0;
+
+   do {
+
+      /* read record header */
+      if ( fread(hdr, sizeof(uint16_t), (size_t)2, fob) != 2 )
+	 return READ_REC_HEADER;
+      memcpy(&rtype, &hdr[1], sizeof(uint16_t));
+      memcpy(&rlen,  &hdr[0], sizeof(uint16_t));
+      byte_reverse(&rtype);
+      byte_reverse(&rlen);
+      if (rlen < 2*sizeof(uint16_t))
+	 return READ_REC_HEADER;
+
+      /* grow the buffer if needed */
+      need = mf->size + rlen;
+      if (need > mf->alloc) {
+	 uint8_t *pb;
+	 size_t na = mf->alloc ? mf->alloc : CHUNK;
+	 while (na < need)
+	    na *= 2;
+	 pb = realloc(mf->base, na);
+	 if (pb == NULL)
+	    return READ_REC_DATA;
+	 STATS_ALLOC(na);
+	 mf->base = pb;
+	 mf->alloc = na;
+      }
+
+      /* copy record */
+      memcpy(mf->base + mf->size, hdr, 2*sizeof(uint16_t));
+      rlen -= 2*sizeof(uint16_t);
+      if ( fread(mf->base + mf->size + 2*sizeof(uint16_t), sizeof(uint8_t), (size_t)rlen, fob) != rlen )
+	 return READ_REC_DATA;
+      mf->size += rlen + 2*sizeof(uint16_t);
+
+   } while (rtype != ENDEL);
+
+   return A_OK;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,272 @@
+/*
+ * Low-level functions for reading GDSII records directly from a
+ * memory mapped file or from a memory buffer. This avoids one
+ * stdio call per record when large libraries are read. The
+ * functions correspond to the read_* functions in gdsio.h.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _MAPIO_H
+#define _MAPIO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "gdsio.h"
+#include "gdsstats.h"
+
+#include "byteswap.h"
+#if defined __GNUC__
+#include "convert_float_gcc.h"
+#else
+#include "convert_float_generic.h"
+#endif
+
+
+/* size of the window of a compressed stream in memory */
+#ifndef MAP_WINDOW
+   #define MAP_WINDOW  4194304
+#endif
+
+
+/*
+ * a file (or part of a file) in memory
+ */
+typedef struct {
+   uint8_t *base;  /* start of data */
+   size_t size;    /* number of bytes in memory */
+   size_t pos;     /* current read position */
+   size_t offset;  /* file position of the first byte in memory */
+   size_t alloc;   /* size of allocated buffer (0 when mapped) */
+   int mapped;     /* 1 if memory is a mapped file */
+   FILE *fob;      /* stream from which the window is refilled, or NULL */
+} map_file_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * map the file behind a stream into memory. The read position
+ * is set to the current position of the stream. Falls back to
+ * reading the file into a buffer when memory mapping is not
+ * available. Of streams without a file descriptor (compressed
+ * streams, see gdsstream.h) only a window of MAP_WINDOW bytes is
+ * kept in memory. The window is refilled from the stream when
+ * data beyond its end are read; it grows when more data must be
+ * in memory at once. Pointers into the window are invalidated
+ * when it is refilled.
+ */
+err_id map_open(map_file_t *mf, FILE *fob);
+
+/*
+ * unmap a file. When fob is not NULL, the position of the stream
+ * is set to the current read position.
+ */
+err_id map_close(map_file_t *mf, FILE *fob);
+
+/*
+ * return the file position corresponding to the read position
+ */
+#define map_tell(mf)  ((mf)->offset + (mf)->pos)
+
+/*
+ * refill the window of a stream such that at least n bytes
+ * follow the read position. The data before the read position
+ * are discarded. Returns READ_REC_DATA when the stream ends
+ * before.
+ */
+err_id map_fill(map_file_t *mf, size_t n);
+
+/*
+ * move the window of a stream to file position fpos. The window
+ * is filled when data are read.
+ */
+err_id map_window(map_file_t *mf, size_t fpos);
+
+/*
+ * read the records of an element from a stream into the buffer
+ * of mf, up to and including the ENDEL record. The read position
+ * of mf is set to the beginning of the element data. The buffer
+ * is reused by subsequent calls and must be set to zero before
+ * the first call.
+ */
+err_id map_read_element(map_file_t *mf, FILE *fob);
+
+
+/* ------------------------------------------------------------------
+ *  Inline functions for reading data
+ */
+
+/*
+ * return a pointer to the next n bytes without advancing the
+ * read position, or NULL if there are fewer than n bytes left.
+ */
+static INLINE uint8_t *
+map_peek(map_file_t *mf, size_t n)
+{
+   if (mf->size - mf->pos < n && (mf->fob == NULL || map_fill(mf, n)))
+      return NULL;
+
+   return mf->base + mf->pos;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * return a pointer to the next n bytes and advance the read
+ * position, or NULL if there are fewer than n bytes left.
+ */
+static INLINE uint8_t *
+map_data(map_file_t *mf, size_t n)
+{
+   uint8_t *p;
+
+   if ( !(p = map_peek(mf, n)) )
+      return NULL;
+   mf->pos += n;
+
+   return p;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * set the read position to file position fpos
+ */
+static INLINE err_id
+map_seek(map_file_t *mf, size_t fpos)
+{
+   if (fpos < mf->offset || fpos - mf->offset > mf->size)
+      return mf->fob ? map_window(mf, fpos) : READ_REC_HEADER;
+   mf->pos = fpos - mf->offset;
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_record_hdr(map_file_t *mf, uint16_t *rtype, uint16_t *rlen)
+{
+   uint16_t hdr[2];
+   uint8_t *p;
+
+   if ( !(p = map_data(mf, 2*sizeof(uint16_t))) )
+      return READ_REC_HEADER;
+   memcpy(hdr, p, 2*sizeof(uint16_t));
+   byte_reverse_n(hdr, 2);
+
+   *rtype = hdr[1];
+   *rlen  = hdr[0] - 2*sizeof(uint16_t);
+   STATS_REC_READ(hdr[1], hdr[0]);
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_word_n(map_file_t *mf, uint16_t *data, int n)
+{
+   uint8_t *p;
+
+   if ( !(p = map_data(mf, n*sizeof(uint16_t))) )
+      return READ_WORD;
+   memcpy(data, p, n*sizeof(uint16_t));
+   byte_reverse_n(data, n);
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_word(map_file_t *mf, uint16_t *data)
+{
+   return map_word_n(mf, data, 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_int_n(map_file_t *mf, int32_t *data, int n)
+{
+   uint8_t *p;
+
+   if ( !(p = map_data(mf, n*sizeof(int32_t))) )
+      return READ_INT;
+   memcpy(data, p, n*sizeof(int32_t));
+   byte_reverse32_n(data, n);
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_int(map_file_t *mf, int32_t *data)
+{
+   return map_int_n(mf, data, 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_string(map_file_t *mf, char *str, int nchar)
+{
+   uint8_t *p;
+
+   if ( !(p = map_data(mf, nchar)) )
+      return READ_CHAR;
+   memcpy(str, p, nchar);
+
+   /* make sure it is terminated */
+   str[nchar] = '\0';
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_real8(map_file_t *mf, double *rnum)
+{
+   uint64_t e64num;
+   uint8_t *p;
+
+   if ( !(p = map_data(mf, sizeof(uint64_t))) )
+      return READ_FLOAT;
+   memcpy(&e64num, p, sizeof(uint64_t));
+
+   *rnum = excess64_to_ieee754(&e64num);
+
+   return A_OK;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static INLINE err_id
+map_ignore(map_file_t *mf, int numb)
+{
+   if ( !map_data(mf, numb) )
+      return READ_CHAR;
+
+   return A_OK;
+}
+
+/*-----------------------------------------------------------------*/
+
+#endif /* _MAPIO_H */
@@ -8,7 +8,10 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include "mexfuncs.h"
+#include "gdsstats.h"
 
 
 /*-----------------------------------------------------------------*/
@@ -142,5 +145,56 @@ empty_matrix(void)
 
 /*-----------------------------------------------------------------*/
 
+#if defined GDS_STATS
 
-   
+/* counters of this mex function (see gdsstats.h) */
+gds_stats_t gds_stats;
+
+
+/*-----------------------------------------------------------------*/
+
+void
+stats_flush(void)
+{
+   mxArray *pv;
+   double *pd;
+   uint64_t *pc;
+   size_t k;
+
+   /* the counters of all mex functions are accumulated here */
+   pv = mexGetVariable("global", GDS_STATS_VAR);
+   if (pv == NULL || !mxIsDouble(pv) || mxGetNumberOfElements(pv) != ST_NTOTAL) {
+      if (pv != NULL)
+         mxDestroyArray(pv);
+      pv = mxCreateDoubleMatrix(1, ST_NTOTAL, mxREAL);
+   }
+
+   pd = mxGetPr(pv);
+   pc = (uint64_t *)&gds_stats;
+   for (k=0; k<ST_NTOTAL; k++)
+      pd[k] += (double)pc[k];
+   mexPutVariable("global", GDS_STATS_VAR, pv);
+   mxDestroyArray(pv);
+
+   memset(&gds_stats, 0, sizeof(gds_stats_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+uint64_t
+stats_ns(void)
+{
+#if defined CLOCK_MONOTONIC
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+   return (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+#endif
+}
+
+#endif /* GDS_STATS */
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,3377 @@
+/*
+ * Conversion between GDSII and OASIS libraries
+ * Copyright (c) 2026
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gdstypes.h"
+#include "gdsio.h"
+#include "oasis.h"
+#include "refgraph.h"
+
+#if defined HAVE_ZLIB
+   #include <zlib.h>
+#endif
+
+/* OASIS record IDs */
+#define O_PAD           0
+#define O_START         1
+#define O_END           2
+#define O_CELLNAME      3
+#define O_TEXTSTRING    5
+#define O_PROPNAME      7
+#define O_PROPSTRING_R 10
+#define O_LAYERNAME    11
+#define O_LAYERNAME_T  12
+#define O_CELL_R       13
+#define O_CELL         14
+#define O_XYABSOLUTE   15
+#define O_XYRELATIVE   16
+#define O_PLACEMENT    17
+#define O_PLACEMENT_T  18
+#define O_TEXT         19
+#define O_RECTANGLE    20
+#define O_POLYGON      21
+#define O_PATH         22
+#define O_TRAPEZOID    23
+#define O_TRAPEZOID_A  24
+#define O_TRAPEZOID_B  25
+#define O_CTRAPEZOID   26
+#define O_CIRCLE       27
+#define O_PROPERTY     28
+#define O_PROPERTY_REP 29
+#define O_XNAME        30
+#define O_XNAME_R      31
+#define O_XELEMENT     32
+#define O_XGEOMETRY    33
+#define O_CBLOCK       34
+
+/* property value types */
+#define V_UNSIGNED     8
+#define V_SIGNED       9
+#define V_BSTRING     11
+#define V_NSTRING     12
+#define V_REFERENCE   13
+
+/* name tables */
+enum {T_CELL = 0, T_TEXT, T_PROPNAME, T_PROPSTRING, T_NUM};
+
+/* repetitions */
+enum {REP_NONE = 0, REP_LATTICE, REP_LIST};
+
+#define GDS_PROPERTY  "S_GDS_PROPERTY"   /* element properties */
+#define LIB_PROPERTY  "GDSII_LIBRARY"    /* library name and user unit */
+#define DEF_LIBNAME   "OASIS"            /* when a file has no library name */
+#define END_BYTES     256                /* length of the END record */
+#define MAX_DIM       32767              /* aref columns and rows */
+#define MAX_REF       (1<<28)            /* largest reference number */
+#define MAX_COUNT     ((uint64_t)1<<32)  /* largest repetition */
+#define READ_CHUNK    (1<<16)
+
+#define ABS(x)  ((uint64_t)((x) < 0 ? -(x) : (x)))
+
+#ifndef M_PI
+   #define M_PI 3.14159265358979323846
+#endif
+
+
+/*-- Types --------------------------------------------------------*/
+
+/*
+ * a growing byte buffer
+ */
+typedef struct {
+   uint8_t *p;       /* data */
+   size_t n;         /* number of bytes used */
+   size_t a;         /* number of bytes allocated */
+   int err;          /* allocation failed */
+} oa_buffer_t;
+
+
+/*
+ * a table of names read from the name records. When writing,
+ * names are interned in a nametab_t and the reference number of
+ * a name is its index, i.e. numbers are assigned in order of
+ * first use.
+ */
+typedef struct {
+   char **s;         /* names by reference number, NULL if undefined */
+   size_t n;         /* number of reference numbers */
+   size_t a;         /* allocated length of s */
+} oa_names_t;
+
+
+/*
+ * position in an OASIS file
+ */
+typedef struct {
+   const uint8_t *p;
+   const uint8_t *end;
+   int err;          /* invalid or truncated record */
+} oa_cursor_t;
+
+
+/*
+ * an element read from a GDSII library
+ */
+typedef struct {
+   element_kind kind;
+   uint16_t layer;
+   uint16_t dtype;   /* data, text, node or box type */
+   uint16_t ptype;
+   uint16_t flags;   /* strans flags */
+   uint16_t ncol;
+   uint16_t nrow;
+   uint16_t attr;    /* last property attribute */
+   int32_t width;
+   int32_t bgnextn;
+   int32_t endextn;
+   double mag;
+   double angle;
+   int32_t *xy;      /* vertices of all XY records */
+   size_t nxy;       /* number of vertices */
+   size_t axy;       /* allocated vertices */
+   size_t *poly;     /* first vertex of each polygon */
+   size_t npoly;
+   size_t apoly;
+   size_t last;      /* vertices in the last XY record */
+   oa_buffer_t str;  /* text string or structure name */
+   oa_buffer_t val;  /* property value */
+   oa_buffer_t prop; /* OASIS PROPERTY records */
+} ow_element_t;
+
+
+/*
+ * state of the GDSII to OASIS conversion
+ */
+typedef struct {
+   FILE *fob;
+   int cblock;       /* compress cells */
+   oa_buffer_t out;  /* records not yet written */
+   oa_buffer_t cmp;  /* compressed records */
+   oa_buffer_t lib;  /* library name */
+   nametab_t cells;
+   nametab_t texts;
+   ow_element_t el;
+   /* modal variables, -1 when undefined */
+   int64_t layer, dtype;
+   int64_t tlayer, ttype;
+   int64_t gw, gh, hw;
+   int sext, eext;   /* path extension schemes */
+   int64_t sval, eval;
+   int64_t gx, gy, px, py, tx, ty;
+   int64_t pcell, tstring;
+} ow_state_t;
+
+
+/*
+ * vertices of a polygon or path, relative to its position. The
+ * first vertex is always (0,0).
+ */
+typedef struct {
+   int64_t *p;
+   size_t n;         /* number of vertices */
+   size_t a;         /* allocated vertices */
+} or_points_t;
+
+
+typedef struct {
+   int type;         /* REP_NONE, REP_LATTICE or REP_LIST */
+   uint64_t n, m;    /* lattice dimensions */
+   int64_t ax, ay;   /* first lattice vector */
+   int64_t bx, by;   /* second lattice vector */
+   or_points_t pos;  /* positions of a list */
+} or_repetition_t;
+
+
+typedef struct {
+   uint64_t type;    /* value type */
+   int64_t i;        /* integer values */
+   double d;         /* real values */
+   size_t s;         /* strings: offset in value buffer */
+   size_t ns;        /* strings: length */
+} or_value_t;
+
+
+/*
+ * state of the OASIS to GDSII conversion
+ */
+typedef struct {
+   int pass;         /* 1: name tables, 2: conversion */
+   FILE *fob;
+   const char *msg;
+   int end;          /* END record was read */
+   int in_cell;
+   int target;       /* properties belong to 0: nothing, 1: file, 2: element */
+   int offset_flag;
+   double unit;      /* database units per micron */
+   double uunit;     /* user units per database unit, 0 if unknown */
+   oa_buffer_t lib;  /* library name */
+   oa_names_t names[T_NUM];
+   size_t next[T_NUM];  /* next implicit reference numbers */
+   /* modal variables */
+   int xyrel;
+   uint64_t layer, dtype;
+   uint64_t tlayer, ttype;
+   uint64_t gw, gh, hw, radius;
+   int64_t sext, eext;
+   int64_t gx, gy, px, py, tx, ty;
+   uint64_t ctype;
+   oa_buffer_t pcell;
+   oa_buffer_t tstring;
+   or_points_t ppoly, ppath;
+   or_repetition_t rep;
+   oa_buffer_t pname;
+   or_value_t *val;
+   size_t nval;
+   size_t aval;
+   oa_buffer_t vstr;   /* strings of the property values */
+   /* the pending element */
+   element_kind kind;  /* 0 if none */
+   int has_rep;
+   int64_t x, y;
+   or_points_t *pts;
+   or_points_t tmp;
+   uint16_t el_layer, el_dtype, ptype;
+   int32_t width, bgnextn, endextn;
+   int flip;
+   double mag, angle;
+   oa_buffer_t *str;
+   oa_buffer_t props;  /* GDSII PROPATTR and PROPVALUE records */
+   int32_t *xy;        /* GDSII vertices */
+   size_t axy;
+} or_state_t;
+
+
+/*-- Data ---------------------------------------------------------*/
+
+/* directions of 2-deltas, 3-deltas and g-deltas */
+static const int odx[8] = {1, 0, -1,  0, 1, -1, -1,  1};
+static const int ody[8] = {0, 1,  0, -1, 1,  1, -1, -1};
+
+/*
+ * vertices of the CTRAPEZOID types with x = a*w + b*h and
+ * y = c*w + d*h for each vertex {a,b,c,d}. Triangles have 3 vertices.
+ */
+static const signed char ctrap[26][4][4] = {
+   {{0,0,0,0}, {0,0,0,1}, {1,-1,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,0,1}, {1,-1,0,0}},
+   {{0,0,0,0}, {0,1,0,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,1,0,0}, {0,0,0,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,1,0,1}, {1,-1,0,1}, {1,0,0,0}},
+   {{0,1,0,0}, {0,0,0,1}, {1,0,0,1}, {1,-1,0,0}},
+   {{0,0,0,0}, {0,1,0,1}, {1,0,0,1}, {1,-1,0,0}},
+   {{0,1,0,0}, {0,0,0,1}, {1,-1,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,-1,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,-1,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,0,1}, {1,0,1,0}},
+   {{0,0,1,0}, {0,0,0,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,-1,1}, {1,0,1,0}},
+   {{0,0,1,0}, {0,0,-1,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,-1,1}, {1,0,0,1}, {1,0,1,0}},
+   {{0,0,1,0}, {0,0,0,1}, {1,0,-1,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,1,0}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,1,0}, {1,0,1,0}},
+   {{0,0,0,0}, {1,0,1,0}, {1,0,0,0}},
+   {{0,0,1,0}, {1,0,1,0}, {1,0,0,0}},
+   {{0,0,0,0}, {0,1,0,1}, {1,0,0,0}},
+   {{0,0,0,1}, {1,0,0,1}, {0,1,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,1,0}},
+   {{1,0,0,0}, {0,0,1,0}, {1,0,0,1}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,0,1}, {1,0,0,0}},
+   {{0,0,0,0}, {0,0,0,1}, {1,0,0,1}, {1,0,0,0}}};
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+/* GDSII to OASIS */
+static const char *read_element(FILE *fin, ow_element_t *pe, uint16_t rtype);
+static int read_text(FILE *fin, oa_buffer_t *b, uint16_t rlen);
+static int read_xy(FILE *fin, ow_element_t *pe, uint16_t rlen);
+static void put_start(ow_state_t *w, double uunit, double dbunit);
+static const char *begin_cell(ow_state_t *w);
+static const char *end_cell(ow_state_t *w);
+static void put_tables(ow_state_t *w);
+static const char *put_element(ow_state_t *w);
+static void put_boundary(ow_state_t *w, const int32_t *xy, size_t n);
+static void put_rectangle(ow_state_t *w, uint16_t dtype, int64_t x, int64_t y,
+                          int64_t wd, int64_t ht);
+static void put_trapezoid(ow_state_t *w, const int64_t *t);
+static void put_path(ow_state_t *w, const int32_t *xy, size_t n);
+static void put_text(ow_state_t *w, int64_t x, int64_t y);
+static void put_placement(ow_state_t *w, int64_t x, int64_t y, const int64_t *rep);
+static int layer_info(ow_state_t *w, uint16_t dtype);
+static void put_layer(ow_state_t *w, int info, uint16_t dtype);
+static void put_geometry_xy(ow_state_t *w, int info, int64_t x, int64_t y);
+static void put_property(oa_buffer_t *b, uint16_t attr, const uint8_t *s, size_t n);
+static void put_point_list(oa_buffer_t *b, const int32_t *xy, size_t n, int polygon);
+static void put_lattice(oa_buffer_t *b, int64_t ncol, int64_t nrow,
+                        int64_t cx, int64_t cy, int64_t rx, int64_t ry);
+static int trapezoid(const int32_t *xy, int64_t *t);
+static int same_polygon(const int32_t *xy, const int64_t *p);
+static const char *put_file(ow_state_t *w, oa_buffer_t *b);
+static int direction(int64_t dx, int64_t dy, uint64_t *mag);
+static void put_byte(oa_buffer_t *b, unsigned int c);
+static void put_bytes(oa_buffer_t *b, const void *d, size_t n);
+static void put_uint(oa_buffer_t *b, uint64_t u);
+static void put_sint(oa_buffer_t *b, int64_t s);
+static void put_real(oa_buffer_t *b, double d);
+static void put_string(oa_buffer_t *b, const void *s, size_t n);
+static void put_gdelta(oa_buffer_t *b, int64_t dx, int64_t dy);
+
+/* OASIS to GDSII */
+static void parse_records(or_state_t *s, oa_cursor_t *c);
+static void reset_state(or_state_t *s, int pass);
+static void get_start(or_state_t *s, oa_cursor_t *c);
+static void get_end(or_state_t *s, oa_cursor_t *c);
+static void get_name(or_state_t *s, oa_cursor_t *c, uint64_t rid);
+static void get_cell(or_state_t *s, oa_cursor_t *c, uint64_t rid);
+static void get_placement(or_state_t *s, oa_cursor_t *c, uint64_t rid);
+static void get_text(or_state_t *s, oa_cursor_t *c);
+static void get_rectangle(or_state_t *s, oa_cursor_t *c);
+static void get_polygon(or_state_t *s, oa_cursor_t *c);
+static void get_path(or_state_t *s, oa_cursor_t *c);
+static void get_trapezoid(or_state_t *s, oa_cursor_t *c, uint64_t rid);
+static void get_ctrapezoid(or_state_t *s, oa_cursor_t *c);
+static void get_circle(or_state_t *s, oa_cursor_t *c);
+static void get_xgeometry(or_state_t *s, oa_cursor_t *c);
+static void get_property(or_state_t *s, oa_cursor_t *c, int repeat);
+static void get_value(or_state_t *s, oa_cursor_t *c, or_value_t *v);
+static void get_cblock(or_state_t *s, oa_cursor_t *c);
+static void get_layer(or_state_t *s, oa_cursor_t *c, int info);
+static void get_geometry_xy(or_state_t *s, oa_cursor_t *c, int info);
+static void get_points(or_state_t *s, oa_cursor_t *c, or_points_t *pl, int polygon);
+static void get_repetition(or_state_t *s, oa_cursor_t *c);
+static void get_interval(oa_cursor_t *c);
+static const char *get_reference(or_state_t *s, oa_cursor_t *c, int t, size_t *n);
+static void set_boundary(or_state_t *s, or_points_t *pl);
+static void close_cell(or_state_t *s);
+static void flush_element(or_state_t *s);
+static void gds_header(or_state_t *s);
+static void gds_element(or_state_t *s, int64_t dx, int64_t dy);
+static void gds_aref(or_state_t *s);
+static void gds_strans(or_state_t *s);
+static void gds_xy(or_state_t *s, const or_points_t *pl, int64_t x, int64_t y, int closed);
+static void gds_word(or_state_t *s, uint16_t rtype, uint16_t w);
+static void gds_int(or_state_t *s, uint16_t rtype, int32_t i);
+static void gds_real(or_state_t *s, uint16_t rtype, double d);
+static void gds_string(or_state_t *s, uint16_t rtype, const uint8_t *str, size_t n);
+static void gds_empty(or_state_t *s, uint16_t rtype);
+static void put_gds_string(oa_buffer_t *b, uint16_t rtype, const uint8_t *str, size_t n);
+static void put_be16(oa_buffer_t *b, uint16_t w);
+static int add_point(or_points_t *pl, int64_t x, int64_t y);
+static int get_byte(oa_cursor_t *c);
+static const uint8_t *get_bytes(oa_cursor_t *c, size_t n);
+static uint64_t get_uint(oa_cursor_t *c);
+static int64_t get_sint(oa_cursor_t *c);
+static double get_real(oa_cursor_t *c, uint64_t type);
+static const uint8_t *get_string(oa_cursor_t *c, size_t *n);
+static void get_gdelta(oa_cursor_t *c, int64_t *dx, int64_t *dy);
+
+/* common */
+static int reserve(oa_buffer_t *b, size_t n);
+static int set_string(oa_buffer_t *b, const void *s, size_t n);
+static int names_set(oa_names_t *t, uint64_t ref, const uint8_t *s, size_t n);
+static const char *names_get(const oa_names_t *t, uint64_t ref);
+static void names_free(oa_names_t *t);
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+oas_write(FILE *fin, FILE *fob, int cblock)
+{
+   ow_state_t w;
+   const char *msg = NULL;
+   uint16_t rtype, rlen;
+   double units[2];
+   int first = 1, done = 0;
+
+   memset(&w, 0, sizeof(ow_state_t));
+   w.fob = fob;
+   w.cblock = cblock;
+   if ( nametab_init(&w.cells, 0) || nametab_init(&w.texts, 0) ) {
+      nametab_free(&w.cells);
+      return "failed to allocate memory.";
+   }
+
+   while (!msg && !done) {
+
+      if ( read_record_hdr(fin, &rtype, &rlen) != A_OK ) {
+	 msg = first ? "not a GDSII library file." : "library ends without ENDLIB record.";
+	 break;
+      }
+      if (first && rtype != HEADER) {
+	 msg = "not a GDSII library file.";
+	 break;
+      }
+      first = 0;
+
+      switch (rtype) {
+
+	 case LIBNAME:
+	    if ( read_text(fin, &w.lib, rlen) )
+	       msg = "failed to read LIBNAME record.";
+	    break;
+
+	 case UNITS:
+	    if ( read_real8(fin, &units[0]) || read_real8(fin, &units[1]) )
+	       msg = "failed to read UNITS record.";
+	    else {
+	       put_start(&w, units[0], units[1]);
+	       msg = put_file(&w, &w.out);
+	    }
+	    break;
+
+	 case STRNAME:
+	    if ( read_text(fin, &w.el.str, rlen) )
+	       msg = "failed to read STRNAME record.";
+	    else
+	       msg = begin_cell(&w);
+	    break;
+
+	 case ENDSTR:
+	    msg = end_cell(&w);
+	    break;
+
+	 case BOUNDARY:
+	 case PATH:
+	 case BOX:
+	 case NODE:
+	 case TEXT:
+	 case SREF:
+	 case AREF:
+	    if ( !(msg = read_element(fin, &w.el, rtype)) )
+	       msg = put_element(&w);
+	    break;
+
+	 case ENDLIB:
+	    put_tables(&w);
+	    msg = put_file(&w, &w.out);
+	    done = 1;
+	    break;
+
+	 default:
+	    if (rlen && read_ignore(fin, rlen) != A_OK)
+	       msg = "failed to read record.";
+      }
+
+      if (!msg && (w.out.err || w.el.str.err || w.el.prop.err))
+	 msg = "failed to allocate memory.";
+   }
+
+   free(w.out.p);
+   free(w.cmp.p);
+   free(w.lib.p);
+   free(w.el.xy);
+   free(w.el.poly);
+   free(w.el.str.p);
+   free(w.el.val.p);
+   free(w.el.prop.p);
+   nametab_free(&w.cells);
+   nametab_free(&w.texts);
+
+   return msg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+oas_read(FILE *fin, FILE *fob)
+{
+   or_state_t s;
+   oa_buffer_t file;
+   oa_cursor_t c;
+   size_t nr;
+   int k;
+
+   /* the whole file is read into memory */
+   memset(&file, 0, sizeof(oa_buffer_t));
+   do {
+      if ( reserve(&file, READ_CHUNK) ) {
+	 free(file.p);
+	 return "failed to allocate memory.";
+      }
+      nr = fread(file.p + file.n, 1, READ_CHUNK, fin);
+      file.n += nr;
+   } while (nr == READ_CHUNK);
+
+   if (file.n < OAS_MAGIC_LEN || memcmp(file.p, OAS_MAGIC, OAS_MAGIC_LEN)) {
+      free(file.p);
+      return "not an OASIS file.";
+   }
+
+   /*
+    * the first pass collects the name tables and the library
+    * name, the second pass writes the GDSII library
+    */
+   memset(&s, 0, sizeof(or_state_t));
+   s.fob = fob;
+
+   for (k=1; k<=2 && !s.msg; k++) {
+
+      reset_state(&s, k);
+      c.p = file.p + OAS_MAGIC_LEN;
+      c.end = file.p + file.n;
+      c.err = 0;
+
+      if (k == 2)
+	 gds_header(&s);
+      parse_records(&s, &c);
+      flush_element(&s);
+
+      if (!s.msg && s.unit <= 0.0)
+	 s.msg = "OASIS file has no valid START record.";
+      if (!s.msg && !s.end)
+	 s.msg = "OASIS file ends without END record.";
+   }
+
+   if (!s.msg) {
+      close_cell(&s);
+      gds_empty(&s, ENDLIB);
+   }
+
+   free(file.p);
+   free(s.lib.p);
+   for (k=0; k<T_NUM; k++)
+      names_free(&s.names[k]);
+   free(s.pcell.p);
+   free(s.tstring.p);
+   free(s.ppoly.p);
+   free(s.ppath.p);
+   free(s.rep.pos.p);
+   free(s.pname.p);
+   free(s.val);
+   free(s.vstr.p);
+   free(s.tmp.p);
+   free(s.props.p);
+   free(s.xy);
+
+   return s.msg;
+}
+
+
+/*=================================================================
+ * GDSII to OASIS
+ */
+
+/*
+ * reads the records of an element up to the ENDEL record
+ */
+static const char *
+read_element(FILE *fin, ow_element_t *pe, uint16_t rtype)
+{
+   uint16_t rlen;
+   err_id err;
+
+   switch (rtype) {
+      case BOUNDARY: pe->kind = GDS_BOUNDARY; break;
+      case PATH:     pe->kind = GDS_PATH; break;
+      case BOX:      pe->kind = GDS_BOX; break;
+      case NODE:     pe->kind = GDS_NODE; break;
+      case TEXT:     pe->kind = GDS_TEXT; break;
+      case SREF:     pe->kind = GDS_SREF; break;
+      default:       pe->kind = GDS_AREF;
+   }
+   pe->layer = pe->dtype = pe->ptype = pe->flags = pe->attr = 0;
+   pe->ncol = pe->nrow = 1;
+   pe->width = pe->bgnextn = pe->endextn = 0;
+   pe->mag = 1.0;
+   pe->angle = 0.0;
+   pe->nxy = pe->npoly = pe->last = 0;
+   pe->prop.n = 0;
+   set_string(&pe->str, "", 0);
+
+   while (1) {
+
+      if ( read_record_hdr(fin, &rtype, &rlen) != A_OK )
+	 return "failed to read element.";
+
+      switch (rtype) {
+
+	 case ENDEL:
+	    return pe->nxy ? NULL : "element has no XY record.";
+
+	 case ENDSTR:
+	 case ENDLIB:
+	    return "element without ENDEL record.";
+
+	 case LAYER:
+	    err = read_word(fin, &pe->layer);
+	    break;
+
+	 case DATATYPE:
+	 case TEXTTYPE:
+	 case BOXTYPE:
+	 case NODETYPE:
+	    err = read_word(fin, &pe->dtype);
+	    break;
+
+	 case PATHTYPE:
+	    err = read_word(fin, &pe->ptype);
+	    break;
+
+	 case STRANS:
+	    err = read_word(fin, &pe->flags);
+	    break;
+
+	 case COLROW:
+	    err = read_word(fin, &pe->ncol);
+	    if (!err)
+	       err = read_word(fin, &pe->nrow);
+	    break;
+
+	 case WIDTH:
+	    err = read_int(fin, &pe->width);
+	    break;
+
+	 case BGNEXTN:
+	    err = read_int(fin, &pe->bgnextn);
+	    break;
+
+	 case ENDEXTN:
+	    err = read_int(fin, &pe->endextn);
+	    break;
+
+	 case MAG:
+	    err = read_real8(fin, &pe->mag);
+	    break;
+
+	 case ANGLE:
+	    err = read_real8(fin, &pe->angle);
+	    break;
+
+	 case SNAME:
+	 case STRING:
+	    err = read_text(fin, &pe->str, rlen);
+	    break;
+
+	 case XY:
+	    err = read_xy(fin, pe, rlen);
+	    break;
+
+	 case PROPATTR:
+	    err = read_word(fin, &pe->attr);
+	    break;
+
+	 case PROPVALUE:
+	    err = read_text(fin, &pe->val, rlen);
+	    if (!err)
+	       put_property(&pe->prop, pe->attr, pe->val.p, pe->val.n);
+	    break;
+
+	 default:
+	    err = rlen ? read_ignore(fin, rlen) : A_OK;
+      }
+
+      if (err)
+	 return "failed to read element.";
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads a string; the padding is removed
+ */
+static int
+read_text(FILE *fin, oa_buffer_t *b, uint16_t rlen)
+{
+   b->n = 0;
+   if ( reserve(b, rlen + 1) )
+      return 1;
+   if ( read_string(fin, (char *)b->p, rlen) != A_OK )
+      return 1;
+   b->n = strlen((char *)b->p);
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * appends the vertices of an XY record. A record that continues
+ * a full record (see put_xy in elwrite.c) is part of the same
+ * polygon.
+ */
+static int
+read_xy(FILE *fin, ow_element_t *pe, uint16_t rlen)
+{
+   int32_t *pv;
+   size_t n = rlen / (2*sizeof(int32_t));
+   void *pn;
+
+   if (pe->nxy + n > pe->axy) {
+      pe->axy = pe->axy ? 2*pe->axy : 1024;
+      while (pe->axy < pe->nxy + n)
+	 pe->axy *= 2;
+      pn = realloc(pe->xy, 2*pe->axy*sizeof(int32_t));
+      if (pn == NULL)
+	 return 1;
+      pe->xy = pn;
+   }
+   if (pe->npoly == pe->apoly) {
+      pe->apoly = pe->apoly ? 2*pe->apoly : 16;
+      pn = realloc(pe->poly, pe->apoly*sizeof(size_t));
+      if (pn == NULL)
+	 return 1;
+      pe->poly = pn;
+   }
+
+   pv = pe->xy + 2*pe->nxy;
+   if ( read_int_n(fin, pv, 2*n) != A_OK )
+      return 1;
+
+   if (pe->last == MAX_XY_VERTICES && n > 0 &&
+       pv[0] == pv[-2] && pv[1] == pv[-1]) {
+      memmove(pv, pv+2, 2*(n-1)*sizeof(int32_t));
+      pe->nxy += n-1;
+   }
+   else {
+      pe->poly[pe->npoly++] = pe->nxy;
+      pe->nxy += n;
+   }
+   pe->last = n;
+
+   if (rlen % (2*sizeof(int32_t)))
+      return read_ignore(fin, rlen % (2*sizeof(int32_t))) != A_OK;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the START record, the library name and user unit, and the name
+ * of the element properties with reference number 0
+ */
+static void
+put_start(ow_state_t *w, double uunit, double dbunit)
+{
+   oa_buffer_t *b = &w->out;
+   double unit, r;
+   int k;
+
+   /* database units per micron, integer if possible */
+   unit = 1e-6 / dbunit;
+   r = floor(unit + 0.5);
+   if (fabs(unit - r) < 1e-9 * unit)
+      unit = r;
+
+   put_bytes(b, OAS_MAGIC, OAS_MAGIC_LEN);
+   put_uint(b, O_START);
+   put_string(b, "1.0", 3);
+   put_real(b, unit);
+   put_uint(b, 0);            /* table offsets follow */
+   for (k=0; k<12; k++)
+      put_uint(b, 0);
+
+   put_uint(b, O_PROPERTY);
+   put_byte(b, 0x24);         /* two values, explicit name */
+   put_string(b, LIB_PROPERTY, strlen(LIB_PROPERTY));
+   put_uint(b, V_BSTRING);
+   put_string(b, w->lib.p, w->lib.n);
+   put_real(b, uunit);
+
+   put_uint(b, O_PROPNAME);
+   put_string(b, GDS_PROPERTY, strlen(GDS_PROPERTY));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes the CELL record and resets the modal variables
+ */
+static const char *
+begin_cell(ow_state_t *w)
+{
+   const char *msg;
+   int32_t ref;
+   int added;
+
+   if ( (msg = put_file(w, &w->out)) )
+      return msg;
+   if ( (ref = nametab_intern(&w->cells, (char *)w->el.str.p, &added)) < 0 )
+      return "failed to allocate memory.";
+
+   put_uint(&w->out, O_CELL_R);
+   put_uint(&w->out, ref);
+   if ( (msg = put_file(w, &w->out)) )
+      return msg;
+
+   w->layer = w->dtype = w->tlayer = w->ttype = -1;
+   w->gw = w->gh = w->hw = -1;
+   w->sext = w->eext = -1;
+   w->sval = w->eval = 0;
+   w->gx = w->gy = w->px = w->py = w->tx = w->ty = 0;
+   w->pcell = w->tstring = -1;
+
+   put_uint(&w->out, O_XYRELATIVE);
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes the records of a cell, compressed in a CBLOCK record
+ * when that is shorter
+ */
+static const char *
+end_cell(ow_state_t *w)
+{
+#if defined HAVE_ZLIB
+   oa_buffer_t *b = &w->cmp;
+   z_stream zs;
+   size_t hlen;
+   int ret;
+
+   if (w->cblock && w->out.n > 64) {
+
+      b->n = 0;
+      put_uint(b, O_CBLOCK);
+      put_uint(b, 0);         /* deflate */
+      put_uint(b, w->out.n);
+      hlen = b->n;
+
+      memset(&zs, 0, sizeof(z_stream));
+      if ( deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+			Z_DEFAULT_STRATEGY) != Z_OK )
+	 return "failed to initialize compression.";
+      if ( reserve(b, 10 + deflateBound(&zs, w->out.n)) ) {
+	 deflateEnd(&zs);
+	 return "failed to allocate memory.";
+      }
+
+      /* room for the length of the compressed data */
+      zs.next_in = w->out.p;
+      zs.avail_in = w->out.n;
+      zs.next_out = b->p + hlen + 10;
+      zs.avail_out = b->a - hlen - 10;
+      ret = deflate(&zs, Z_FINISH);
+      deflateEnd(&zs);
+      if (ret != Z_STREAM_END)
+	 return "failed to compress cell.";
+
+      if (hlen + 10 + zs.total_out < w->out.n) {
+	 put_uint(b, zs.total_out);
+	 memmove(b->p + b->n, b->p + hlen + 10, zs.total_out);
+	 b->n += zs.total_out;
+	 w->out.n = 0;
+	 return put_file(w, b);
+      }
+   }
+#endif
+
+   return put_file(w, &w->out);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the name tables and the END record
+ */
+static void
+put_tables(ow_state_t *w)
+{
+   oa_buffer_t *b = &w->out;
+   size_t k;
+
+   for (k=0; k<w->cells.n; k++) {
+      put_uint(b, O_CELLNAME);
+      put_string(b, w->cells.name[k], strlen(w->cells.name[k]));
+   }
+   for (k=0; k<w->texts.n; k++) {
+      put_uint(b, O_TEXTSTRING);
+      put_string(b, w->texts.name[k], strlen(w->texts.name[k]));
+   }
+
+   /* END record with padding and without validation */
+   put_uint(b, O_END);
+   if ( !reserve(b, END_BYTES) ) {
+      put_uint(b, END_BYTES - 4);
+      memset(b->p + b->n, 0, END_BYTES - 4);
+      b->n += END_BYTES - 4;
+   }
+   put_uint(b, 0);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * converts an element with one or more polygons or positions.
+ * The properties are written after the last record. Returns an
+ * error message for elements that cannot be written exactly.
+ */
+static const char *
+put_element(ow_state_t *w)
+{
+   ow_element_t *pe = &w->el;
+   const int32_t *xy;
+   int64_t rep[4], d[4];
+   size_t k, j, n, nout;
+   int64_t x0, y0, x1, y1;
+
+   /* elements without an OASIS equivalent */
+   if (pe->kind == GDS_NODE)
+      return "node elements cannot be written to an OASIS file.";
+   if (pe->kind == GDS_PATH && pe->ptype == 1)
+      return "paths with round ends cannot be written to an OASIS file.";
+
+   nout = w->out.n;
+
+   for (k=0; k<pe->npoly; k++) {
+
+      xy = pe->xy + 2*pe->poly[k];
+      n = (k+1 < pe->npoly ? pe->poly[k+1] : pe->nxy) - pe->poly[k];
+
+      switch (pe->kind) {
+
+	 case GDS_BOUNDARY:
+	    put_boundary(w, xy, n);
+	    break;
+
+	 case GDS_PATH:
+	    put_path(w, xy, n);
+	    break;
+
+	 case GDS_BOX:
+	    x0 = x1 = xy[0];
+	    y0 = y1 = xy[1];
+	    for (j=1; j<n; j++) {
+	       if (xy[2*j] < x0)   x0 = xy[2*j];
+	       if (xy[2*j] > x1)   x1 = xy[2*j];
+	       if (xy[2*j+1] < y0) y0 = xy[2*j+1];
+	       if (xy[2*j+1] > y1) y1 = xy[2*j+1];
+	    }
+	    put_rectangle(w, pe->dtype, x0, y0, x1 - x0, y1 - y0);
+	    break;
+
+	 case GDS_TEXT:
+	    put_text(w, xy[0], xy[1]);
+	    break;
+
+	 case GDS_SREF:
+	    for (j=0; j<n; j++)
+	       put_placement(w, xy[2*j], xy[2*j+1], NULL);
+	    break;
+
+	 case GDS_AREF:
+	    if (n < 3 || pe->ncol == 0 || pe->nrow == 0)
+	       break;
+	    d[0] = (int64_t)xy[2] - xy[0];
+	    d[1] = (int64_t)xy[3] - xy[1];
+	    d[2] = (int64_t)xy[4] - xy[0];
+	    d[3] = (int64_t)xy[5] - xy[1];
+	    if (d[0] % pe->ncol || d[1] % pe->ncol || d[2] % pe->nrow || d[3] % pe->nrow)
+	       return "array reference pitch is not a multiple of the database unit.";
+	    rep[0] = d[0] / pe->ncol;
+	    rep[1] = d[1] / pe->ncol;
+	    rep[2] = d[2] / pe->nrow;
+	    rep[3] = d[3] / pe->nrow;
+	    put_placement(w, xy[0], xy[1], rep);
+	    break;
+
+	 default:
+	    break;
+      }
+   }
+
+   if (w->out.n > nout)
+      put_bytes(&w->out, pe->prop.p, pe->prop.n);
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * boundaries are written as rectangles or trapezoids if possible
+ */
+static void
+put_boundary(ow_state_t *w, const int32_t *xy, size_t n)
+{
+   ow_element_t *pe = &w->el;
+   oa_buffer_t *b = &w->out;
+   int64_t t[7];
+   int info;
+
+   /* the closing vertex is implied */
+   while (n > 1 && xy[2*n-2] == xy[0] && xy[2*n-1] == xy[1])
+      n--;
+   if (n < 3)
+      return;
+
+   if (n == 4 && trapezoid(xy, t)) {
+      if (t[4] == 0 && t[5] == 0)
+	 put_rectangle(w, pe->dtype, t[0], t[1], t[2], t[3]);
+      else
+	 put_trapezoid(w, t);
+      return;
+   }
+
+   info = layer_info(w, pe->dtype) | 0x20;
+   if (xy[0] != w->gx) info |= 0x10;
+   if (xy[1] != w->gy) info |= 0x08;
+
+   put_uint(b, O_POLYGON);
+   put_layer(w, info, pe->dtype);
+   put_point_list(b, xy, n, 1);
+   put_geometry_xy(w, info, xy[0], xy[1]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_rectangle(ow_state_t *w, uint16_t dtype, int64_t x, int64_t y,
+              int64_t wd, int64_t ht)
+{
+   oa_buffer_t *b = &w->out;
+   int info;
+
+   info = layer_info(w, dtype);
+   if (wd == ht)
+      info |= 0x80;
+   if (wd != w->gw) info |= 0x40;
+   if (wd != ht && ht != w->gh) info |= 0x20;
+   if (x != w->gx) info |= 0x10;
+   if (y != w->gy) info |= 0x08;
+
+   put_uint(b, O_RECTANGLE);
+   put_layer(w, info, dtype);
+   if (info & 0x40)
+      put_uint(b, wd);
+   if (info & 0x20)
+      put_uint(b, ht);
+   w->gw = wd;
+   w->gh = ht;
+   put_geometry_xy(w, info, x, y);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * t: x, y, width, height, delta-a, delta-b, vertical
+ */
+static void
+put_trapezoid(ow_state_t *w, const int64_t *t)
+{
+   oa_buffer_t *b = &w->out;
+   int info;
+
+   info = layer_info(w, w->el.dtype);
+   if (t[6])          info |= 0x80;
+   if (t[2] != w->gw) info |= 0x40;
+   if (t[3] != w->gh) info |= 0x20;
+   if (t[0] != w->gx) info |= 0x10;
+   if (t[1] != w->gy) info |= 0x08;
+
+   if (t[5] == 0)
+      put_uint(b, O_TRAPEZOID_A);
+   else if (t[4] == 0)
+      put_uint(b, O_TRAPEZOID_B);
+   else
+      put_uint(b, O_TRAPEZOID);
+   put_layer(w, info, w->el.dtype);
+   if (info & 0x40)
+      put_uint(b, t[2]);
+   if (info & 0x20)
+      put_uint(b, t[3]);
+   w->gw = t[2];
+   w->gh = t[3];
+   if (t[4])
+      put_sint(b, t[4]);
+   if (t[5])
+      put_sint(b, t[5]);
+   put_geometry_xy(w, info, t[0], t[1]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * paths with square ends (path type 2) get half-width extensions
+ */
+static void
+put_path(ow_state_t *w, const int32_t *xy, size_t n)
+{
+   ow_element_t *pe = &w->el;
+   oa_buffer_t *b = &w->out;
+   int64_t hw, sval, eval;
+   int info, sext, eext, ss, ee;
+
+   if (n < 2)
+      return;
+
+   hw = (ABS((int64_t)pe->width) + 1) / 2;
+   switch (pe->ptype) {
+      case 0:
+	 sext = eext = 1;
+	 sval = eval = 0;
+	 break;
+      case 4:
+	 sext = eext = 3;
+	 sval = pe->bgnextn;
+	 eval = pe->endextn;
+	 break;
+      default:
+	 sext = eext = 2;
+	 sval = eval = hw;
+   }
+   ss = (sext != w->sext || sval != w->sval) ? sext : 0;
+   ee = (eext != w->eext || eval != w->eval) ? eext : 0;
+
+   info = layer_info(w, pe->dtype) | 0x20;
+   if (ss || ee)        info |= 0x80;
+   if (hw != w->hw)     info |= 0x40;
+   if (xy[0] != w->gx)  info |= 0x10;
+   if (xy[1] != w->gy)  info |= 0x08;
+
+   put_uint(b, O_PATH);
+   put_layer(w, info, pe->dtype);
+   if (info & 0x40)
+      put_uint(b, w->hw = hw);
+   if (info & 0x80) {
+      put_uint(b, (ss << 2) | ee);
+      if (ss == 3)
+	 put_sint(b, sval);
+      if (ee == 3)
+	 put_sint(b, eval);
+   }
+   if (ss) {
+      w->sext = sext;
+      w->sval = sval;
+   }
+   if (ee) {
+      w->eext = eext;
+      w->eval = eval;
+   }
+   put_point_list(b, xy, n, 0);
+   put_geometry_xy(w, info, xy[0], xy[1]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_text(ow_state_t *w, int64_t x, int64_t y)
+{
+   ow_element_t *pe = &w->el;
+   oa_buffer_t *b = &w->out;
+   int32_t ref;
+   int info = 0, added;
+
+   if ( (ref = nametab_intern(&w->texts, (char *)pe->str.p, &added)) < 0 ) {
+      b->err = 1;
+      return;
+   }
+
+   if ((int64_t)ref != w->tstring) info |= 0x60;
+   if (x != w->tx)                 info |= 0x10;
+   if (y != w->ty)                 info |= 0x08;
+   if (pe->dtype != w->ttype)      info |= 0x02;
+   if (pe->layer != w->tlayer)     info |= 0x01;
+
+   put_uint(b, O_TEXT);
+   put_byte(b, info);
+   if (info & 0x40)
+      put_uint(b, w->tstring = ref);
+   if (info & 0x01)
+      put_uint(b, w->tlayer = pe->layer);
+   if (info & 0x02)
+      put_uint(b, w->ttype = pe->dtype);
+   if (info & 0x10) {
+      put_sint(b, x - w->tx);
+      w->tx = x;
+   }
+   if (info & 0x08) {
+      put_sint(b, y - w->ty);
+      w->ty = y;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * rep : lattice vectors of an aref or NULL
+ */
+static void
+put_placement(ow_state_t *w, int64_t x, int64_t y, const int64_t *rep)
+{
+   ow_element_t *pe = &w->el;
+   oa_buffer_t *b = &w->out;
+   double q;
+   int32_t ref;
+   int info = 0, manhattan, added;
+
+   if ( (ref = nametab_intern(&w->cells, (char *)pe->str.p, &added)) < 0 ) {
+      b->err = 1;
+      return;
+   }
+
+   q = pe->angle / 90.0;
+   manhattan = pe->mag == 1.0 && q == floor(q) && fabs(q) < 4e9;
+
+   if ((int64_t)ref != w->pcell)     info |= 0xc0;
+   if (x != w->px)                   info |= 0x20;
+   if (y != w->py)                   info |= 0x10;
+   if (rep && (pe->ncol > 1 || pe->nrow > 1))
+      info |= 0x08;
+   if (pe->flags & 0x8000)           info |= 0x01;
+   if (manhattan)
+      info |= ((((long)q % 4) + 4) % 4) << 1;
+   else {
+      if (pe->mag != 1.0)            info |= 0x04;
+      if (pe->angle != 0.0)          info |= 0x02;
+   }
+
+   put_uint(b, manhattan ? O_PLACEMENT : O_PLACEMENT_T);
+   put_byte(b, info);
+   if (info & 0x80)
+      put_uint(b, w->pcell = ref);
+   if (!manhattan) {
+      if (info & 0x04)
+	 put_real(b, pe->mag);
+      if (info & 0x02)
+	 put_real(b, pe->angle);
+   }
+   if (info & 0x20) {
+      put_sint(b, x - w->px);
+      w->px = x;
+   }
+   if (info & 0x10) {
+      put_sint(b, y - w->py);
+      w->py = y;
+   }
+   if (info & 0x08)
+      put_lattice(b, pe->ncol, pe->nrow, rep[0], rep[1], rep[2], rep[3]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the layer and datatype bits of an info byte
+ */
+static int
+layer_info(ow_state_t *w, uint16_t dtype)
+{
+   int info = 0;
+
+   if (w->el.layer != w->layer) info |= 0x01;
+   if (dtype != w->dtype)       info |= 0x02;
+
+   return info;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the info byte, layer and datatype of a geometry record
+ */
+static void
+put_layer(ow_state_t *w, int info, uint16_t dtype)
+{
+   put_byte(&w->out, info);
+   if (info & 0x01)
+      put_uint(&w->out, w->layer = w->el.layer);
+   if (info & 0x02)
+      put_uint(&w->out, w->dtype = dtype);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_geometry_xy(ow_state_t *w, int info, int64_t x, int64_t y)
+{
+   if (info & 0x10) {
+      put_sint(&w->out, x - w->gx);
+      w->gx = x;
+   }
+   if (info & 0x08) {
+      put_sint(&w->out, y - w->gy);
+      w->gy = y;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a GDSII property as S_GDS_PROPERTY (reference number 0)
+ */
+static void
+put_property(oa_buffer_t *b, uint16_t attr, const uint8_t *s, size_t n)
+{
+   put_uint(b, O_PROPERTY);
+   put_byte(b, 0x27);         /* two values, name reference, standard */
+   put_uint(b, 0);
+   put_uint(b, V_UNSIGNED);
+   put_uint(b, attr);
+   put_uint(b, V_BSTRING);
+   put_string(b, s, n);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a point list with the n-1 vertices after the first. Manhattan
+ * and octangular polygons and paths use the shorter encodings;
+ * the closing edge of a polygon must have the same class.
+ */
+static void
+put_point_list(oa_buffer_t *b, const int32_t *xy, size_t n, int polygon)
+{
+   int64_t dx, dy;
+   uint64_t mag;
+   size_t k, j;
+   int d, type = 2;
+
+   for (k=0; k<(polygon ? n : n-1); k++) {
+      j = (k+1) % n;
+      d = direction((int64_t)xy[2*j] - xy[2*k], (int64_t)xy[2*j+1] - xy[2*k+1], &mag);
+      if (d < 0) {
+	 type = 4;
+	 break;
+      }
+      if (d > 3)
+	 type = 3;
+   }
+
+   put_uint(b, type);
+   put_uint(b, n-1);
+   for (k=1; k<n; k++) {
+      dx = (int64_t)xy[2*k] - xy[2*k-2];
+      dy = (int64_t)xy[2*k+1] - xy[2*k-1];
+      d = direction(dx, dy, &mag);
+      if (type == 2)
+	 put_uint(b, (mag << 2) | d);
+      else if (type == 3)
+	 put_uint(b, (mag << 3) | d);
+      else
+	 put_gdelta(b, dx, dy);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the repetition of an aref; counts are stored minus 2
+ */
+static void
+put_lattice(oa_buffer_t *b, int64_t ncol, int64_t nrow,
+            int64_t cx, int64_t cy, int64_t rx, int64_t ry)
+{
+   if (ncol > 1 && nrow > 1) {
+      if (cy == 0 && rx == 0 && cx >= 0 && ry >= 0) {
+	 put_uint(b, 1);
+	 put_uint(b, ncol - 2);
+	 put_uint(b, nrow - 2);
+	 put_uint(b, cx);
+	 put_uint(b, ry);
+      }
+      else {
+	 put_uint(b, 8);
+	 put_uint(b, ncol - 2);
+	 put_uint(b, nrow - 2);
+	 put_gdelta(b, cx, cy);
+	 put_gdelta(b, rx, ry);
+      }
+   }
+   else if (ncol > 1) {
+      if (cy == 0 && cx >= 0) {
+	 put_uint(b, 2);
+	 put_uint(b, ncol - 2);
+	 put_uint(b, cx);
+      }
+      else {
+	 put_uint(b, 9);
+	 put_uint(b, ncol - 2);
+	 put_gdelta(b, cx, cy);
+      }
+   }
+   else {
+      if (rx == 0 && ry >= 0) {
+	 put_uint(b, 3);
+	 put_uint(b, nrow - 2);
+	 put_uint(b, ry);
+      }
+      else {
+	 put_uint(b, 9);
+	 put_uint(b, nrow - 2);
+	 put_gdelta(b, rx, ry);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * checks if a polygon with 4 vertices is a horizontal or vertical
+ * trapezoid. Returns 1 and x, y, width, height, delta-a, delta-b
+ * and the orientation in t if it is.
+ */
+static int
+trapezoid(const int32_t *xy, int64_t *t)
+{
+   int64_t p[8], lo0, lo1, hi0, hi1, c0, c1;
+   int o, s, k, e0, e1;
+
+   for (o=0; o<2; o++) {        /* o = 1: vertical */
+      for (s=0; s<2; s++) {
+
+	 /* edges s and s+2 are parallel to the x (o = 0) or y axis */
+	 e0 = s;
+	 e1 = s+2;
+	 if (xy[2*e0+1-o] != xy[2*((e0+1)%4)+1-o] || xy[2*e1+1-o] != xy[2*((e1+1)%4)+1-o])
+	    continue;
+	 c0 = xy[2*e0+1-o];
+	 c1 = xy[2*e1+1-o];
+	 if (c0 == c1)
+	    continue;
+	 if (c0 > c1) {
+	    k = e0; e0 = e1; e1 = k;
+	    c0 = xy[2*e0+1-o];
+	    c1 = xy[2*e1+1-o];
+	 }
+
+	 /* edge e0 is at the lower coordinate */
+	 lo0 = xy[2*e0+o] < xy[2*((e0+1)%4)+o] ? xy[2*e0+o] : xy[2*((e0+1)%4)+o];
+	 lo1 = xy[2*e0+o] < xy[2*((e0+1)%4)+o] ? xy[2*((e0+1)%4)+o] : xy[2*e0+o];
+	 hi0 = xy[2*e1+o] < xy[2*((e1+1)%4)+o] ? xy[2*e1+o] : xy[2*((e1+1)%4)+o];
+	 hi1 = xy[2*e1+o] < xy[2*((e1+1)%4)+o] ? xy[2*((e1+1)%4)+o] : xy[2*e1+o];
+
+	 if (o == 0) {
+	    t[0] = lo0 < hi0 ? lo0 : hi0;
+	    t[1] = c0;
+	    t[2] = (lo1 > hi1 ? lo1 : hi1) - t[0];
+	    t[3] = c1 - c0;
+	    t[4] = hi0 - lo0;
+	    t[5] = hi1 - lo1;
+	 }
+	 else {
+	    t[0] = c0;
+	    t[1] = lo0 < hi0 ? lo0 : hi0;
+	    t[2] = c1 - c0;
+	    t[3] = (lo1 > hi1 ? lo1 : hi1) - t[1];
+	    t[4] = lo0 - hi0;
+	    t[5] = lo1 - hi1;
+	 }
+	 t[6] = o;
+
+	 /* the trapezoid defined by t must be the polygon */
+	 if (o == 0) {
+	    p[0] = (t[4] > 0 ? t[4] : 0);          p[1] = t[3];
+	    p[2] = t[2] + (t[5] < 0 ? t[5] : 0);   p[3] = t[3];
+	    p[4] = t[2] - (t[5] > 0 ? t[5] : 0);   p[5] = 0;
+	    p[6] = -(t[4] < 0 ? t[4] : 0);         p[7] = 0;
+	 }
+	 else {
+	    p[0] = 0;      p[1] = (t[4] > 0 ? t[4] : 0);
+	    p[2] = 0;      p[3] = t[3] + (t[5] < 0 ? t[5] : 0);
+	    p[4] = t[2];   p[5] = t[3] - (t[5] > 0 ? t[5] : 0);
+	    p[6] = t[2];   p[7] = -(t[4] < 0 ? t[4] : 0);
+	 }
+	 for (k=0; k<4; k++) {
+	    p[2*k] += t[0];
+	    p[2*k+1] += t[1];
+	 }
+	 if ( same_polygon(xy, p) )
+	    return 1;
+      }
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * checks if two polygons with 4 vertices are the same, starting
+ * at any vertex and in either orientation
+ */
+static int
+same_polygon(const int32_t *xy, const int64_t *p)
+{
+   int s, d, k, j;
+
+   for (s=0; s<4; s++) {
+      for (d=1; d<4; d+=2) {
+	 for (k=0; k<4; k++) {
+	    j = (s + d*k) % 4;
+	    if (xy[2*k] != p[2*j] || xy[2*k+1] != p[2*j+1])
+	       break;
+	 }
+	 if (k == 4)
+	    return 1;
+      }
+   }
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static const char *
+put_file(ow_state_t *w, oa_buffer_t *b)
+{
+   if (b->err)
+      return "failed to allocate memory.";
+   if ( fwrite(b->p, 1, b->n, w->fob) != b->n )
+      return "failed to write OASIS file.";
+   b->n = 0;
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns the octangular direction (E, N, W, S, NE, NW, SW, SE)
+ * and magnitude of a displacement, or -1
+ */
+static int
+direction(int64_t dx, int64_t dy, uint64_t *mag)
+{
+   if (dy == 0) {
+      *mag = ABS(dx);
+      return dx < 0 ? 2 : 0;
+   }
+   if (dx == 0) {
+      *mag = ABS(dy);
+      return dy < 0 ? 3 : 1;
+   }
+   if (dx == dy || dx == -dy) {
+      *mag = ABS(dx);
+      if (dx > 0)
+	 return dy > 0 ? 4 : 7;
+      else
+	 return dy > 0 ? 5 : 6;
+   }
+
+   return -1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_byte(oa_buffer_t *b, unsigned int c)
+{
+   if ( reserve(b, 1) )
+      return;
+   b->p[b->n++] = c;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_bytes(oa_buffer_t *b, const void *d, size_t n)
+{
+   if ( n == 0 || reserve(b, n) )
+      return;
+   memcpy(b->p + b->n, d, n);
+   b->n += n;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * unsigned integers are stored in groups of 7 bits, least
+ * significant first
+ */
+static void
+put_uint(oa_buffer_t *b, uint64_t u)
+{
+   unsigned int c;
+
+   do {
+      c = u & 0x7f;
+      u >>= 7;
+      put_byte(b, u ? c | 0x80 : c);
+   } while (u);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * signed integers have the sign in bit 0
+ */
+static void
+put_sint(oa_buffer_t *b, int64_t s)
+{
+   put_uint(b, s < 0 ? (ABS(s) << 1) | 1 : (uint64_t)s << 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * integers are written as type 0 or 1, all other values as
+ * IEEE double (type 7)
+ */
+static void
+put_real(oa_buffer_t *b, double d)
+{
+   uint64_t u;
+   int k;
+
+   if (d == floor(d) && fabs(d) < 9007199254740992.0) {
+      put_uint(b, d < 0.0);
+      put_uint(b, (uint64_t)fabs(d));
+   }
+   else {
+      put_uint(b, 7);
+      memcpy(&u, &d, sizeof(double));
+      for (k=0; k<8; k++) {
+	 put_byte(b, u & 0xff);
+	 u >>= 8;
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_string(oa_buffer_t *b, const void *s, size_t n)
+{
+   put_uint(b, n);
+   put_bytes(b, s, n);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * g-deltas are octangular (form 1) or arbitrary (form 2)
+ */
+static void
+put_gdelta(oa_buffer_t *b, int64_t dx, int64_t dy)
+{
+   uint64_t mag;
+   int d;
+
+   d = direction(dx, dy, &mag);
+   if (d >= 0)
+      put_uint(b, (mag << 4) | (d << 1));
+   else {
+      put_uint(b, (ABS(dx) << 2) | ((dx < 0) << 1) | 1);
+      put_sint(b, dy);
+   }
+}
+
+
+/*=================================================================
+ * OASIS to GDSII
+ */
+
+static void
+parse_records(or_state_t *s, oa_cursor_t *c)
+{
+   uint64_t rid;
+
+   while (!s->msg && !s->end && !c->err && c->p < c->end) {
+
+      rid = get_uint(c);
+
+      /* properties belong to the pending element */
+      if (rid != O_PROPERTY && rid != O_PROPERTY_REP &&
+	  rid != O_PAD && rid != O_CBLOCK)
+	 flush_element(s);
+
+      switch (rid) {
+
+	 case O_PAD:
+	    break;
+
+	 case O_START:
+	    get_start(s, c);
+	    break;
+
+	 case O_END:
+	    get_end(s, c);
+	    break;
+
+	 case O_CELLNAME:
+	 case O_CELLNAME+1:
+	 case O_TEXTSTRING:
+	 case O_TEXTSTRING+1:
+	 case O_PROPNAME:
+	 case O_PROPNAME+1:
+	 case O_PROPSTRING_R-1:
+	 case O_PROPSTRING_R:
+	    get_name(s, c, rid);
+	    break;
+
+	 case O_LAYERNAME:
+	 case O_LAYERNAME_T:
+	    close_cell(s);
+	    get_string(c, NULL);
+	    get_interval(c);
+	    get_interval(c);
+	    break;
+
+	 case O_CELL_R:
+	 case O_CELL:
+	    get_cell(s, c, rid);
+	    break;
+
+	 case O_XYABSOLUTE:
+	    s->xyrel = 0;
+	    break;
+
+	 case O_XYRELATIVE:
+	    s->xyrel = 1;
+	    break;
+
+	 case O_PLACEMENT:
+	 case O_PLACEMENT_T:
+	    get_placement(s, c, rid);
+	    break;
+
+	 case O_TEXT:
+	    get_text(s, c);
+	    break;
+
+	 case O_RECTANGLE:
+	    get_rectangle(s, c);
+	    break;
+
+	 case O_POLYGON:
+	    get_polygon(s, c);
+	    break;
+
+	 case O_PATH:
+	    get_path(s, c);
+	    break;
+
+	 case O_TRAPEZOID:
+	 case O_TRAPEZOID_A:
+	 case O_TRAPEZOID_B:
+	    get_trapezoid(s, c, rid);
+	    break;
+
+	 case O_CTRAPEZOID:
+	    get_ctrapezoid(s, c);
+	    break;
+
+	 case O_CIRCLE:
+	    get_circle(s, c);
+	    break;
+
+	 case O_PROPERTY:
+	    get_property(s, c, 0);
+	    break;
+
+	 case O_PROPERTY_REP:
+	    get_property(s, c, 1);
+	    break;
+
+	 case O_XNAME:
+	 case O_XNAME_R:
+	    close_cell(s);
+	    get_uint(c);
+	    get_string(c, NULL);
+	    if (rid == O_XNAME_R)
+	       get_uint(c);
+	    break;
+
+	 case O_XELEMENT:
+	    get_uint(c);
+	    get_string(c, NULL);
+	    break;
+
+	 case O_XGEOMETRY:
+	    get_xgeometry(s, c);
+	    break;
+
+	 case O_CBLOCK:
+	    get_cblock(s, c);
+	    break;
+
+	 default:
+	    s->msg = "unknown record in OASIS file.";
+      }
+   }
+
+   if (c->err && !s->msg)
+      s->msg = "invalid or truncated OASIS file.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * resets the state at the beginning of a pass; the name tables
+ * and the library data are kept
+ */
+static void
+reset_state(or_state_t *s, int pass)
+{
+   int k;
+
+   s->pass = pass;
+   s->end = s->in_cell = s->target = 0;
+   for (k=0; k<T_NUM; k++)
+      s->next[k] = 0;
+   s->xyrel = 0;
+   s->layer = s->dtype = s->tlayer = s->ttype = 0;
+   s->gw = s->gh = s->hw = s->radius = s->ctype = 0;
+   s->sext = s->eext = 0;
+   s->gx = s->gy = s->px = s->py = s->tx = s->ty = 0;
+   s->pcell.n = s->tstring.n = s->pname.n = 0;
+   s->ppoly.n = s->ppath.n = 0;
+   s->rep.type = REP_NONE;
+   s->nval = 0;
+   s->kind = 0;
+   s->props.n = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_start(or_state_t *s, oa_cursor_t *c)
+{
+   double unit;
+   int k;
+
+   get_string(c, NULL);       /* version */
+   unit = get_real(c, get_uint(c));
+   s->offset_flag = get_uint(c);
+   if (s->offset_flag == 0) {
+      for (k=0; k<12; k++)
+	 get_uint(c);
+   }
+   if (s->pass == 1)
+      s->unit = unit;
+   s->target = 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_end(or_state_t *s, oa_cursor_t *c)
+{
+   int k;
+
+   close_cell(s);
+   if (s->offset_flag) {
+      for (k=0; k<12; k++)
+	 get_uint(c);
+   }
+   get_string(c, NULL);       /* padding */
+   if ( get_uint(c) )         /* validation */
+      get_bytes(c, 4);
+   s->end = 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * CELLNAME, TEXTSTRING, PROPNAME and PROPSTRING records with
+ * implicit (odd record ID) or explicit reference numbers
+ */
+static void
+get_name(or_state_t *s, oa_cursor_t *c, uint64_t rid)
+{
+   const uint8_t *p;
+   uint64_t ref;
+   size_t n = 0;
+   int t = (rid - O_CELLNAME) / 2;
+
+   close_cell(s);
+
+   p = get_string(c, &n);
+   ref = (rid % 2) ? s->next[t]++ : get_uint(c);
+   if (c->err)
+      return;
+
+   if (s->pass == 1 && names_set(&s->names[t], ref, p, n))
+      s->msg = "failed to store name of OASIS file.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_cell(or_state_t *s, oa_cursor_t *c, uint64_t rid)
+{
+   const char *name;
+   size_t n;
+   date_t d;
+
+   close_cell(s);
+
+   if (rid == O_CELL_R)
+      name = get_reference(s, c, T_CELL, &n);
+   else
+      name = (const char *)get_string(c, &n);
+   if (name == NULL || c->err)
+      return;
+
+   if (s->pass == 2) {
+      now(d);
+      if ( write_record_hdr(s->fob, BGNSTR, 2*sizeof(date_t)) || write_word_n(s->fob, d, 6) )
+	 s->msg = "failed to write GDSII library.";
+      now(d);
+      if ( write_word_n(s->fob, d, 6) )
+	 s->msg = "failed to write GDSII library.";
+      gds_string(s, STRNAME, (const uint8_t *)name, n);
+   }
+
+   /* the modal variables are reset */
+   s->in_cell = 1;
+   s->xyrel = 0;
+   s->gx = s->gy = s->px = s->py = s->tx = s->ty = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_placement(or_state_t *s, oa_cursor_t *c, uint64_t rid)
+{
+   const char *name;
+   size_t n;
+   int64_t v;
+   int info;
+
+   info = get_byte(c);
+
+   if (info & 0x80) {
+      if (info & 0x40)
+	 name = get_reference(s, c, T_CELL, &n);
+      else
+	 name = (const char *)get_string(c, &n);
+      if (name == NULL)
+	 return;
+      if ( set_string(&s->pcell, name, n) ) {
+	 s->msg = "failed to allocate memory.";
+	 return;
+      }
+   }
+
+   if (rid == O_PLACEMENT) {
+      s->mag = 1.0;
+      s->angle = 90.0 * ((info >> 1) & 3);
+   }
+   else {
+      s->mag = (info & 0x04) ? get_real(c, get_uint(c)) : 1.0;
+      s->angle = (info & 0x02) ? get_real(c, get_uint(c)) : 0.0;
+   }
+   s->flip = info & 0x01;
+
+   if (info & 0x20) {
+      v = get_sint(c);
+      s->px = s->xyrel ? s->px + v : v;
+   }
+   if (info & 0x10) {
+      v = get_sint(c);
+      s->py = s->xyrel ? s->py + v : v;
+   }
+   s->has_rep = (info & 0x08) != 0;
+   if (s->has_rep)
+      get_repetition(s, c);
+
+   s->kind = GDS_SREF;
+   s->x = s->px;
+   s->y = s->py;
+   s->str = &s->pcell;
+   s->target = 2;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_text(or_state_t *s, oa_cursor_t *c)
+{
+   const char *str;
+   size_t n;
+   int64_t v;
+   int info;
+
+   info = get_byte(c);
+
+   if (info & 0x40) {
+      if (info & 0x20)
+	 str = get_reference(s, c, T_TEXT, &n);
+      else
+	 str = (const char *)get_string(c, &n);
+      if (str == NULL)
+	 return;
+      if ( set_string(&s->tstring, str, n) ) {
+	 s->msg = "failed to allocate memory.";
+	 return;
+      }
+   }
+   if (info & 0x01)
+      s->tlayer = get_uint(c);
+   if (info & 0x02)
+      s->ttype = get_uint(c);
+   if (info & 0x10) {
+      v = get_sint(c);
+      s->tx = s->xyrel ? s->tx + v : v;
+   }
+   if (info & 0x08) {
+      v = get_sint(c);
+      s->ty = s->xyrel ? s->ty + v : v;
+   }
+   s->has_rep = (info & 0x04) != 0;
+   if (s->has_rep)
+      get_repetition(s, c);
+
+   s->kind = GDS_TEXT;
+   s->el_layer = s->tlayer;
+   s->el_dtype = s->ttype;
+   s->x = s->tx;
+   s->y = s->ty;
+   s->str = &s->tstring;
+   s->target = 2;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_rectangle(or_state_t *s, oa_cursor_t *c)
+{
+   int info;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x40)
+      s->gw = get_uint(c);
+   if (info & 0x20)
+      s->gh = get_uint(c);
+   if (info & 0x80)
+      s->gh = s->gw;
+   get_geometry_xy(s, c, info);
+
+   s->tmp.n = 0;
+   add_point(&s->tmp, 0, 0);
+   add_point(&s->tmp, 0, s->gh);
+   add_point(&s->tmp, s->gw, s->gh);
+   if ( add_point(&s->tmp, s->gw, 0) )
+      s->msg = "failed to allocate memory.";
+   set_boundary(s, &s->tmp);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_polygon(or_state_t *s, oa_cursor_t *c)
+{
+   int info;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x20)
+      get_points(s, c, &s->ppoly, 1);
+   get_geometry_xy(s, c, info);
+   set_boundary(s, &s->ppoly);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_path(or_state_t *s, oa_cursor_t *c)
+{
+   uint64_t u;
+   int info;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x40)
+      s->hw = get_uint(c);
+   if (info & 0x80) {
+      u = get_uint(c);
+      switch ((u >> 2) & 3) {
+	 case 1: s->sext = 0; break;
+	 case 2: s->sext = s->hw; break;
+	 case 3: s->sext = get_sint(c); break;
+      }
+      switch (u & 3) {
+	 case 1: s->eext = 0; break;
+	 case 2: s->eext = s->hw; break;
+	 case 3: s->eext = get_sint(c); break;
+      }
+   }
+   if (info & 0x20)
+      get_points(s, c, &s->ppath, 0);
+   get_geometry_xy(s, c, info);
+
+   s->kind = GDS_PATH;
+   s->el_layer = s->layer;
+   s->el_dtype = s->dtype;
+   s->x = s->gx;
+   s->y = s->gy;
+   s->pts = &s->ppath;
+   s->width = 2 * s->hw;
+   if (s->sext == 0 && s->eext == 0)
+      s->ptype = 0;
+   else if (s->sext == (int64_t)s->hw && s->eext == (int64_t)s->hw)
+      s->ptype = 2;
+   else {
+      s->ptype = 4;
+      s->bgnextn = s->sext;
+      s->endextn = s->eext;
+   }
+   s->target = 2;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_trapezoid(or_state_t *s, oa_cursor_t *c, uint64_t rid)
+{
+   int64_t a = 0, b = 0, w, h;
+   int info;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x40)
+      s->gw = get_uint(c);
+   if (info & 0x20)
+      s->gh = get_uint(c);
+   if (rid != O_TRAPEZOID_B)
+      a = get_sint(c);
+   if (rid != O_TRAPEZOID_A)
+      b = get_sint(c);
+   get_geometry_xy(s, c, info);
+
+   w = s->gw;
+   h = s->gh;
+   s->tmp.n = 0;
+   if (info & 0x80) {
+      add_point(&s->tmp, 0, a > 0 ? a : 0);
+      add_point(&s->tmp, 0, h + (b < 0 ? b : 0));
+      add_point(&s->tmp, w, h - (b > 0 ? b : 0));
+      add_point(&s->tmp, w, -(a < 0 ? a : 0));
+   }
+   else {
+      add_point(&s->tmp, a > 0 ? a : 0, h);
+      add_point(&s->tmp, w + (b < 0 ? b : 0), h);
+      add_point(&s->tmp, w - (b > 0 ? b : 0), 0);
+      add_point(&s->tmp, -(a < 0 ? a : 0), 0);
+   }
+   set_boundary(s, &s->tmp);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_ctrapezoid(or_state_t *s, oa_cursor_t *c)
+{
+   const signed char (*v)[4];
+   int64_t w, h;
+   int info, k, n;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x80)
+      s->ctype = get_uint(c);
+   if (info & 0x40)
+      s->gw = get_uint(c);
+   if (info & 0x20)
+      s->gh = get_uint(c);
+   get_geometry_xy(s, c, info);
+
+   if (s->ctype > 25) {
+      s->msg = "invalid CTRAPEZOID type in OASIS file.";
+      return;
+   }
+
+   /* implied dimensions */
+   if ((s->ctype >= 16 && s->ctype <= 19) || s->ctype == 25)
+      s->gh = s->gw;
+   else if (s->ctype == 20 || s->ctype == 21)
+      s->gw = 2*s->gh;
+   else if (s->ctype == 22 || s->ctype == 23)
+      s->gh = 2*s->gw;
+
+   w = s->gw;
+   h = s->gh;
+   v = ctrap[s->ctype];
+   n = (s->ctype >= 16 && s->ctype <= 23) ? 3 : 4;
+   s->tmp.n = 0;
+   for (k=0; k<n; k++)
+      add_point(&s->tmp, v[k][0]*w + v[k][1]*h, v[k][2]*w + v[k][3]*h);
+   set_boundary(s, &s->tmp);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_circle(or_state_t *s, oa_cursor_t *c)
+{
+   double a, r;
+   int info, k;
+
+   info = get_byte(c);
+   get_layer(s, c, info);
+   if (info & 0x20)
+      s->radius = get_uint(c);
+   get_geometry_xy(s, c, info);
+
+   r = s->radius;
+   s->tmp.n = 0;
+   for (k=0; k<CIRCLE_VERTICES; k++) {
+      a = 2.0 * M_PI * k / CIRCLE_VERTICES;
+      add_point(&s->tmp, (int64_t)floor(r*cos(a) + 0.5), (int64_t)floor(r*sin(a) + 0.5));
+   }
+   set_boundary(s, &s->tmp);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * XGEOMETRY records are skipped but change the modal variables
+ */
+static void
+get_xgeometry(or_state_t *s, oa_cursor_t *c)
+{
+   int info;
+
+   info = get_byte(c);
+   get_uint(c);               /* attribute */
+   get_layer(s, c, info);
+   get_string(c, NULL);
+   get_geometry_xy(s, c, info);
+   s->target = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * S_GDS_PROPERTY properties of elements become GDSII properties,
+ * the file property GDSII_LIBRARY has the library name and user
+ * unit. All other properties are ignored.
+ */
+static void
+get_property(or_state_t *s, oa_cursor_t *c, int repeat)
+{
+   const char *name;
+   or_value_t *v;
+   size_t n, k;
+   void *pn;
+   int info;
+
+   if (!repeat) {
+
+      info = get_byte(c);
+
+      if (info & 0x04) {
+	 if (info & 0x02)
+	    name = get_reference(s, c, T_PROPNAME, &n);
+	 else
+	    name = (const char *)get_string(c, &n);
+	 if (name == NULL)
+	    return;
+	 if ( set_string(&s->pname, name, n) ) {
+	    s->msg = "failed to allocate memory.";
+	    return;
+	 }
+      }
+
+      if ( !(info & 0x08) ) {
+	 n = info >> 4;
+	 if (n == 15)
+	    n = get_uint(c);
+	 if (n > (size_t)(c->end - c->p)) {
+	    c->err = 1;
+	    return;
+	 }
+	 if (n > s->aval) {
+	    pn = realloc(s->val, n * sizeof(or_value_t));
+	    if (pn == NULL) {
+	       s->msg = "failed to allocate memory.";
+	       return;
+	    }
+	    s->val = pn;
+	    s->aval = n;
+	 }
+	 s->vstr.n = 0;
+	 for (k=0; k<n && !c->err && !s->msg; k++)
+	    get_value(s, c, &s->val[k]);
+	 s->nval = n;
+      }
+   }
+   if (c->err || s->msg || s->pname.p == NULL)
+      return;
+   name = (const char *)s->pname.p;
+   v = s->val;
+
+   if (s->target == 1 && s->pass == 1 && !strcmp(name, LIB_PROPERTY) && s->nval >= 2 &&
+       v[0].type >= 10 && v[0].type <= 12 && v[1].type <= 7) {
+      if ( set_string(&s->lib, s->vstr.p + v[0].s, v[0].ns) )
+	 s->msg = "failed to allocate memory.";
+      s->uunit = v[1].d;
+   }
+
+   if (s->target == 2 && s->pass == 2 && !strcmp(name, GDS_PROPERTY) && s->nval >= 2 &&
+       (v[0].type == V_UNSIGNED || v[0].type == V_SIGNED) && v[1].type >= 10) {
+      put_be16(&s->props, 6);
+      put_be16(&s->props, PROPATTR);
+      put_be16(&s->props, (uint16_t)v[0].i);
+      put_gds_string(&s->props, PROPVALUE, s->vstr.p + v[1].s, v[1].ns);
+      if (s->props.err)
+	 s->msg = "failed to allocate memory.";
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_value(or_state_t *s, oa_cursor_t *c, or_value_t *v)
+{
+   const uint8_t *p;
+   size_t n;
+
+   v->type = get_uint(c);
+   v->i = 0;
+   v->d = 0.0;
+   v->s = v->ns = 0;
+
+   if (v->type <= 7)
+      v->d = get_real(c, v->type);
+   else if (v->type == V_UNSIGNED)
+      v->i = get_uint(c);
+   else if (v->type == V_SIGNED)
+      v->i = get_sint(c);
+   else if (v->type <= V_REFERENCE + 2) {
+      if (v->type <= V_NSTRING)
+	 p = get_string(c, &n);
+      else if (s->pass == 2)
+	 p = (const uint8_t *)get_reference(s, c, T_PROPSTRING, &n);
+      else {
+	 get_uint(c);
+	 p = (const uint8_t *)"";
+	 n = 0;
+      }
+      if (p == NULL)
+	 return;
+      v->s = s->vstr.n;
+      v->ns = n;
+      put_bytes(&s->vstr, p, n);
+      if (s->vstr.err)
+	 s->msg = "failed to allocate memory.";
+   }
+   else
+      c->err = 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the records in a CBLOCK are decompressed and parsed in place
+ */
+static void
+get_cblock(or_state_t *s, oa_cursor_t *c)
+{
+   const uint8_t *p;
+   uint64_t comp, nu, nc;
+
+   comp = get_uint(c);
+   nu = get_uint(c);
+   nc = get_uint(c);
+   if (c->err || nc > (uint64_t)(c->end - c->p)) {
+      c->err = 1;
+      return;
+   }
+   p = get_bytes(c, nc);
+   if (comp != 0) {
+      s->msg = "unknown compression type of CBLOCK record.";
+      return;
+   }
+
+#if defined HAVE_ZLIB
+   {
+      oa_cursor_t cc;
+      uint8_t *buf;
+      z_stream zs;
+      int ret;
+
+      if (nu == 0)
+	 return;
+      if (nu > 0xffffffffu || nc > 0xffffffffu) {
+	 s->msg = "CBLOCK record is too large.";
+	 return;
+      }
+      buf = malloc(nu);
+      if (buf == NULL) {
+	 s->msg = "failed to allocate memory.";
+	 return;
+      }
+
+      memset(&zs, 0, sizeof(z_stream));
+      if ( inflateInit2(&zs, -15) != Z_OK ) {
+	 free(buf);
+	 s->msg = "failed to initialize decompression.";
+	 return;
+      }
+      zs.next_in = (uint8_t *)p;
+      zs.avail_in = nc;
+      zs.next_out = buf;
+      zs.avail_out = nu;
+      ret = inflate(&zs, Z_FINISH);
+      inflateEnd(&zs);
+
+      if (ret != Z_STREAM_END || zs.total_out != nu)
+	 s->msg = "failed to decompress CBLOCK record.";
+      else {
+	 cc.p = buf;
+	 cc.end = buf + nu;
+	 cc.err = 0;
+	 parse_records(s, &cc);
+      }
+      free(buf);
+   }
+#else
+   (void)p;
+   (void)nu;
+   s->msg = "CBLOCK records can only be read when compiled with HAVE_ZLIB.";
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_layer(or_state_t *s, oa_cursor_t *c, int info)
+{
+   if (info & 0x01)
+      s->layer = get_uint(c);
+   if (info & 0x02)
+      s->dtype = get_uint(c);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * position and repetition of a geometry record
+ */
+static void
+get_geometry_xy(or_state_t *s, oa_cursor_t *c, int info)
+{
+   int64_t v;
+
+   if (info & 0x10) {
+      v = get_sint(c);
+      s->gx = s->xyrel ? s->gx + v : v;
+   }
+   if (info & 0x08) {
+      v = get_sint(c);
+      s->gy = s->xyrel ? s->gy + v : v;
+   }
+   s->has_rep = (info & 0x04) != 0;
+   if (s->has_rep)
+      get_repetition(s, c);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads a point list. The first vertex (0,0) is stored, too.
+ */
+static void
+get_points(or_state_t *s, oa_cursor_t *c, or_points_t *pl, int polygon)
+{
+   uint64_t type, n, k, u;
+   int64_t x = 0, y = 0, dx, dy, ddx = 0, ddy = 0;
+   int h;
+
+   type = get_uint(c);
+   n = get_uint(c);
+   if (c->err || n > (uint64_t)(c->end - c->p) || type > 5) {
+      c->err = 1;
+      return;
+   }
+
+   pl->n = 0;
+   add_point(pl, 0, 0);
+   for (k=0; k<n && !c->err; k++) {
+      switch (type) {
+	 case 0:
+	 case 1:
+	    h = (type == 0) == (k % 2 == 0);
+	    if (h)
+	       x += get_sint(c);
+	    else
+	       y += get_sint(c);
+	    break;
+	 case 2:
+	    u = get_uint(c);
+	    x += odx[u & 3] * (int64_t)(u >> 2);
+	    y += ody[u & 3] * (int64_t)(u >> 2);
+	    break;
+	 case 3:
+	    u = get_uint(c);
+	    x += odx[u & 7] * (int64_t)(u >> 3);
+	    y += ody[u & 7] * (int64_t)(u >> 3);
+	    break;
+	 case 4:
+	    get_gdelta(c, &dx, &dy);
+	    x += dx;
+	    y += dy;
+	    break;
+	 case 5:
+	    get_gdelta(c, &dx, &dy);
+	    ddx += dx;
+	    ddy += dy;
+	    x += ddx;
+	    y += ddy;
+	    break;
+      }
+      add_point(pl, x, y);
+   }
+
+   /* the vertex before the closing edge of a Manhattan polygon is implied */
+   if (polygon && type <= 1) {
+      if ((type == 0) == (n % 2 == 0))
+	 add_point(pl, 0, y);
+      else
+	 add_point(pl, x, 0);
+   }
+
+   if (pl->n < n+1)
+      s->msg = "failed to allocate memory.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads a repetition into the modal repetition
+ */
+static void
+get_repetition(or_state_t *s, oa_cursor_t *c)
+{
+   or_repetition_t *r = &s->rep;
+   uint64_t type, n, m, k, grid = 1;
+   int64_t x = 0, y = 0, dx, dy;
+
+   type = get_uint(c);
+
+   switch (type) {
+
+      case 0:
+	 if (r->type == REP_NONE)
+	    c->err = 1;
+	 return;
+
+      case 1:
+      case 8:
+	 n = get_uint(c) + 2;
+	 m = get_uint(c) + 2;
+	 if (type == 1) {
+	    r->ax = get_uint(c); r->ay = 0;
+	    r->bx = 0;           r->by = get_uint(c);
+	 }
+	 else {
+	    get_gdelta(c, &r->ax, &r->ay);
+	    get_gdelta(c, &r->bx, &r->by);
+	 }
+	 break;
+
+      case 2:
+      case 3:
+      case 9:
+	 n = get_uint(c) + 2;
+	 m = 1;
+	 r->bx = r->by = 0;
+	 if (type == 2) {
+	    r->ax = get_uint(c);
+	    r->ay = 0;
+	 }
+	 else if (type == 3) {
+	    r->ax = 0;
+	    r->ay = get_uint(c);
+	 }
+	 else
+	    get_gdelta(c, &r->ax, &r->ay);
+	 break;
+
+      case 4:
+      case 5:
+      case 6:
+      case 7:
+      case 10:
+      case 11:
+	 n = get_uint(c) + 2;
+	 if (type == 5 || type == 7 || type == 11)
+	    grid = get_uint(c);
+	 if (n > (uint64_t)(c->end - c->p) + 1) {
+	    c->err = 1;
+	    return;
+	 }
+	 r->pos.n = 0;
+	 add_point(&r->pos, 0, 0);
+	 for (k=1; k<n && !c->err; k++) {
+	    if (type <= 5)
+	       x += get_uint(c) * grid;
+	    else if (type <= 7)
+	       y += get_uint(c) * grid;
+	    else {
+	       get_gdelta(c, &dx, &dy);
+	       x += dx * (int64_t)grid;
+	       y += dy * (int64_t)grid;
+	    }
+	    add_point(&r->pos, x, y);
+	 }
+	 if (r->pos.n < n && !c->err)
+	    s->msg = "failed to allocate memory.";
+	 r->type = REP_LIST;
+	 return;
+
+      default:
+	 c->err = 1;
+	 return;
+   }
+
+   if (n > MAX_COUNT || m > MAX_COUNT || n*m > MAX_COUNT) {
+      s->msg = "repetition in OASIS file is too large.";
+      return;
+   }
+   r->type = REP_LATTICE;
+   r->n = n;
+   r->m = m;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_interval(oa_cursor_t *c)
+{
+   switch (get_uint(c)) {
+      case 0:
+	 break;
+      case 4:
+	 get_uint(c);
+	 get_uint(c);
+	 break;
+      default:
+	 get_uint(c);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * a name given by its reference number. During the first pass
+ * names may not yet be defined.
+ */
+static const char *
+get_reference(or_state_t *s, oa_cursor_t *c, int t, size_t *n)
+{
+   const char *name;
+   uint64_t ref;
+
+   ref = get_uint(c);
+   if (c->err)
+      return NULL;
+
+   name = names_get(&s->names[t], ref);
+   if (name == NULL) {
+      if (s->pass == 2) {
+	 s->msg = "undefined name reference in OASIS file.";
+	 return NULL;
+      }
+      name = "";
+   }
+   *n = strlen(name);
+
+   return name;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+set_boundary(or_state_t *s, or_points_t *pl)
+{
+   s->kind = GDS_BOUNDARY;
+   s->el_layer = s->layer;
+   s->el_dtype = s->dtype;
+   s->x = s->gx;
+   s->y = s->gy;
+   s->pts = pl;
+   s->target = 2;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+close_cell(or_state_t *s)
+{
+   flush_element(s);
+   if (s->in_cell && s->pass == 2)
+      gds_empty(s, ENDSTR);
+   s->in_cell = 0;
+   s->target = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes the pending element, once for each position of its
+ * repetition. Placements with a regular repetition become arefs.
+ */
+static void
+flush_element(or_state_t *s)
+{
+   const or_repetition_t *r = &s->rep;
+   uint64_t k, n;
+   int64_t dx, dy;
+
+   if (s->kind && s->pass == 2 && s->in_cell && !s->msg) {
+
+      if (s->kind == GDS_SREF && s->has_rep && r->type == REP_LATTICE &&
+	  r->n <= MAX_DIM && r->m <= MAX_DIM)
+	 gds_aref(s);
+
+      else if (!s->has_rep)
+	 gds_element(s, 0, 0);
+
+      else {
+	 n = r->type == REP_LATTICE ? r->n * r->m : r->pos.n;
+	 for (k=0; k<n && !s->msg; k++) {
+	    if (r->type == REP_LATTICE) {
+	       dx = (k % r->n) * r->ax + (k / r->n) * r->bx;
+	       dy = (k % r->n) * r->ay + (k / r->n) * r->by;
+	    }
+	    else {
+	       dx = r->pos.p[2*k];
+	       dy = r->pos.p[2*k+1];
+	    }
+	    gds_element(s, dx, dy);
+	 }
+      }
+   }
+
+   s->kind = 0;
+   s->props.n = 0;
+   s->target = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_header(or_state_t *s)
+{
+   date_t d;
+   double dbunit, uunit;
+
+   dbunit = 1e-6 / s->unit;
+   uunit = s->uunit > 0.0 ? s->uunit : 1.0 / s->unit;
+
+   gds_word(s, HEADER, 7);
+   now(d);
+   if ( write_record_hdr(s->fob, BGNLIB, 2*sizeof(date_t)) || write_word_n(s->fob, d, 6) )
+      s->msg = "failed to write GDSII library.";
+   now(d);
+   if ( write_word_n(s->fob, d, 6) )
+      s->msg = "failed to write GDSII library.";
+   if (s->lib.n)
+      gds_string(s, LIBNAME, s->lib.p, s->lib.n);
+   else
+      gds_string(s, LIBNAME, (const uint8_t *)DEF_LIBNAME, strlen(DEF_LIBNAME));
+   if ( write_record_hdr(s->fob, UNITS, 16) || write_real8(s->fob, uunit) ||
+	write_real8(s->fob, dbunit) )
+      s->msg = "failed to write GDSII library.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_element(or_state_t *s, int64_t dx, int64_t dy)
+{
+   or_points_t p;
+   int64_t pos[2];
+
+   switch (s->kind) {
+
+      case GDS_BOUNDARY:
+	 gds_empty(s, BOUNDARY);
+	 gds_word(s, LAYER, s->el_layer);
+	 gds_word(s, DATATYPE, s->el_dtype);
+	 gds_xy(s, s->pts, s->x + dx, s->y + dy, 1);
+	 break;
+
+      case GDS_PATH:
+	 gds_empty(s, PATH);
+	 gds_word(s, LAYER, s->el_layer);
+	 gds_word(s, DATATYPE, s->el_dtype);
+	 if (s->ptype)
+	    gds_word(s, PATHTYPE, s->ptype);
+	 gds_int(s, WIDTH, s->width);
+	 if (s->ptype == 4) {
+	    gds_int(s, BGNEXTN, s->bgnextn);
+	    gds_int(s, ENDEXTN, s->endextn);
+	 }
+	 gds_xy(s, s->pts, s->x + dx, s->y + dy, 0);
+	 break;
+
+      case GDS_TEXT:
+	 gds_empty(s, TEXT);
+	 gds_word(s, LAYER, s->el_layer);
+	 gds_word(s, TEXTTYPE, s->el_dtype);
+	 pos[0] = pos[1] = 0;
+	 p.p = pos;
+	 p.n = 1;
+	 gds_xy(s, &p, s->x + dx, s->y + dy, 0);
+	 gds_string(s, STRING, s->str->p, s->str->n);
+	 break;
+
+      default:
+	 gds_empty(s, SREF);
+	 gds_string(s, SNAME, s->str->p, s->str->n);
+	 gds_strans(s);
+	 pos[0] = pos[1] = 0;
+	 p.p = pos;
+	 p.n = 1;
+	 gds_xy(s, &p, s->x + dx, s->y + dy, 0);
+   }
+
+   if ( s->props.n && fwrite(s->props.p, 1, s->props.n, s->fob) != s->props.n )
+      s->msg = "failed to write GDSII library.";
+   gds_empty(s, ENDEL);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the second lattice vector of a one dimensional array is
+ * perpendicular to the first
+ */
+static void
+gds_aref(or_state_t *s)
+{
+   const or_repetition_t *r = &s->rep;
+   or_points_t p;
+   int64_t v[6], ax, ay, bx, by;
+
+   ax = r->ax; ay = r->ay;
+   bx = r->bx; by = r->by;
+   if (r->m == 1) {
+      bx = -ay;
+      by = ax;
+   }
+
+   v[0] = v[1] = 0;
+   v[2] = r->n * ax;
+   v[3] = r->n * ay;
+   v[4] = r->m * bx;
+   v[5] = r->m * by;
+   p.p = v;
+   p.n = 3;
+
+   gds_empty(s, AREF);
+   gds_string(s, SNAME, s->str->p, s->str->n);
+   gds_strans(s);
+   if ( write_record_hdr(s->fob, COLROW, 4) || write_word(s->fob, r->n) ||
+	write_word(s->fob, r->m) )
+      s->msg = "failed to write GDSII library.";
+   gds_xy(s, &p, s->x, s->y, 0);
+
+   if ( s->props.n && fwrite(s->props.p, 1, s->props.n, s->fob) != s->props.n )
+      s->msg = "failed to write GDSII library.";
+   gds_empty(s, ENDEL);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_strans(or_state_t *s)
+{
+   if (!s->flip && s->mag == 1.0 && s->angle == 0.0)
+      return;
+
+   gds_word(s, STRANS, s->flip ? 0x8000 : 0);
+   if (s->mag != 1.0)
+      gds_real(s, MAG, s->mag);
+   if (s->angle != 0.0)
+      gds_real(s, ANGLE, s->angle);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes the vertices of a point list at x,y as XY records. Long
+ * point lists are split as in put_xy (elwrite.c).
+ */
+static void
+gds_xy(or_state_t *s, const or_points_t *pl, int64_t x, int64_t y, int closed)
+{
+   size_t n, k, m;
+   int32_t last[2];
+   void *pn;
+
+   n = pl->n + (closed != 0);
+   if (n > s->axy) {
+      pn = realloc(s->xy, 2*n*sizeof(int32_t));
+      if (pn == NULL) {
+	 s->msg = "failed to allocate memory.";
+	 return;
+      }
+      s->xy = pn;
+      s->axy = n;
+   }
+   for (k=0; k<pl->n; k++) {
+      s->xy[2*k] = x + pl->p[2*k];
+      s->xy[2*k+1] = y + pl->p[2*k+1];
+   }
+   if (closed) {
+      s->xy[2*n-2] = s->xy[0];
+      s->xy[2*n-1] = s->xy[1];
+   }
+
+   /* write_int_n changes the byte order */
+   for (k=0; 1; k+=m-1) {
+      m = n - k > MAX_XY_VERTICES ? MAX_XY_VERTICES : n - k;
+      last[0] = s->xy[2*(k+m-1)];
+      last[1] = s->xy[2*(k+m-1)+1];
+      if ( write_record_hdr(s->fob, XY, 2*m*sizeof(int32_t)) ||
+	   write_int_n(s->fob, s->xy + 2*k, 2*m) ) {
+	 s->msg = "failed to write GDSII library.";
+	 return;
+      }
+      if (k + m >= n)
+	 break;
+      s->xy[2*(k+m-1)] = last[0];
+      s->xy[2*(k+m-1)+1] = last[1];
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_word(or_state_t *s, uint16_t rtype, uint16_t w)
+{
+   if ( write_record_hdr(s->fob, rtype, sizeof(uint16_t)) || write_word(s->fob, w) )
+      s->msg = "failed to write GDSII library.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_int(or_state_t *s, uint16_t rtype, int32_t i)
+{
+   if ( write_record_hdr(s->fob, rtype, sizeof(int32_t)) || write_int(s->fob, i) )
+      s->msg = "failed to write GDSII library.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_real(or_state_t *s, uint16_t rtype, double d)
+{
+   if ( write_record_hdr(s->fob, rtype, 8) || write_real8(s->fob, d) )
+      s->msg = "failed to write GDSII library.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_string(or_state_t *s, uint16_t rtype, const uint8_t *str, size_t n)
+{
+   oa_buffer_t b;
+
+   memset(&b, 0, sizeof(oa_buffer_t));
+   put_gds_string(&b, rtype, str, n);
+   if ( b.err || fwrite(b.p, 1, b.n, s->fob) != b.n )
+      s->msg = "failed to write GDSII library.";
+   free(b.p);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+gds_empty(or_state_t *s, uint16_t rtype)
+{
+   if ( write_record_hdr(s->fob, rtype, 0) )
+      s->msg = "failed to write GDSII library.";
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * appends a string record, padded to an even length. Strings
+ * longer than a record are truncated.
+ */
+static void
+put_gds_string(oa_buffer_t *b, uint16_t rtype, const uint8_t *str, size_t n)
+{
+   if (n > 65530)
+      n = 65530;
+
+   put_be16(b, 4 + n + n % 2);
+   put_be16(b, rtype);
+   put_bytes(b, str, n);
+   if (n % 2)
+      put_byte(b, 0);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+put_be16(oa_buffer_t *b, uint16_t w)
+{
+   put_byte(b, w >> 8);
+   put_byte(b, w & 0xff);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns 1 when memory could not be allocated
+ */
+static int
+add_point(or_points_t *pl, int64_t x, int64_t y)
+{
+   void *pn;
+
+   if (pl->n == pl->a) {
+      pl->a = pl->a ? 2*pl->a : 64;
+      pn = realloc(pl->p, 2*pl->a*sizeof(int64_t));
+      if (pn == NULL) {
+	 pl->a = pl->n;
+	 return 1;
+      }
+      pl->p = pn;
+   }
+   pl->p[2*pl->n] = x;
+   pl->p[2*pl->n+1] = y;
+   pl->n++;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+get_byte(oa_cursor_t *c)
+{
+   if (c->p >= c->end) {
+      c->err = 1;
+      return 0;
+   }
+
+   return *c->p++;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static const uint8_t *
+get_bytes(oa_cursor_t *c, size_t n)
+{
+   const uint8_t *p = c->p;
+
+   if (n > (size_t)(c->end - c->p)) {
+      c->err = 1;
+      return NULL;
+   }
+   c->p += n;
+
+   return p;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static uint64_t
+get_uint(oa_cursor_t *c)
+{
+   uint64_t u = 0;
+   int b, s = 0;
+
+   do {
+      if (s > 63) {
+	 c->err = 1;
+	 return 0;
+      }
+      b = get_byte(c);
+      u |= (uint64_t)(b & 0x7f) << s;
+      s += 7;
+   } while (b & 0x80);
+
+   return u;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int64_t
+get_sint(oa_cursor_t *c)
+{
+   uint64_t u = get_uint(c);
+
+   return (u & 1) ? -(int64_t)(u >> 1) : (int64_t)(u >> 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * reads a real number of the given type
+ */
+static double
+get_real(oa_cursor_t *c, uint64_t type)
+{
+   const uint8_t *p;
+   uint64_t u = 0;
+   uint32_t f = 0;
+   double d, v;
+   float g;
+   int k;
+
+   switch (type) {
+
+      case 0:
+      case 1:
+	 d = (double)get_uint(c);
+	 return type ? -d : d;
+
+      case 2:
+      case 3:
+	 d = 1.0 / (double)get_uint(c);
+	 return type == 3 ? -d : d;
+
+      case 4:
+      case 5:
+	 d = (double)get_uint(c);
+	 v = (double)get_uint(c);
+	 return type == 5 ? -d/v : d/v;
+
+      case 6:
+	 if ( (p = get_bytes(c, 4)) == NULL )
+	    return 0.0;
+	 for (k=3; k>=0; k--)
+	    f = (f << 8) | p[k];
+	 memcpy(&g, &f, sizeof(float));
+	 return g;
+
+      case 7:
+	 if ( (p = get_bytes(c, 8)) == NULL )
+	    return 0.0;
+	 for (k=7; k>=0; k--)
+	    u = (u << 8) | p[k];
+	 memcpy(&d, &u, sizeof(double));
+	 return d;
+
+      default:
+	 c->err = 1;
+	 return 0.0;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * returns a string in the file, which is not terminated
+ */
+static const uint8_t *
+get_string(oa_cursor_t *c, size_t *n)
+{
+   uint64_t len;
+
+   len = get_uint(c);
+   if (c->err || len > (uint64_t)(c->end - c->p)) {
+      c->err = 1;
+      return NULL;
+   }
+   if (n)
+      *n = len;
+
+   return get_bytes(c, len);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+get_gdelta(oa_cursor_t *c, int64_t *dx, int64_t *dy)
+{
+   uint64_t u;
+   int d;
+
+   u = get_uint(c);
+   if (u & 1) {
+      *dx = (u & 2) ? -(int64_t)(u >> 2) : (int64_t)(u >> 2);
+      *dy = get_sint(c);
+   }
+   else {
+      d = (u >> 1) & 7;
+      *dx = odx[d] * (int64_t)(u >> 4);
+      *dy = ody[d] * (int64_t)(u >> 4);
+   }
+}
+
+
+/*=================================================================
+ * Common functions
+ */
+
+static int
+reserve(oa_buffer_t *b, size_t n)
+{
+   void *pn;
+   size_t a;
+
+   if (b->n + n <= b->a)
+      return 0;
+
+   a = b->a ? b->a : 4096;
+   while (a < b->n + n)
+      a *= 2;
+   pn = realloc(b->p, a);
+   if (pn == NULL) {
+      b->err = 1;
+      return 1;
+   }
+   b->p = pn;
+   b->a = a;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies a string into a buffer and terminates it
+ */
+static int
+set_string(oa_buffer_t *b, const void *s, size_t n)
+{
+   b->n = 0;
+   if ( reserve(b, n + 1) )
+      return 1;
+   memcpy(b->p, s, n);
+   b->p[n] = '\0';
+   b->n = n;
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+names_set(oa_names_t *t, uint64_t ref, const uint8_t *s, size_t n)
+{
+   size_t a;
+   void *pn;
+
+   if (ref >= MAX_REF)
+      return 1;
+
+   if (ref >= t->a) {
+      a = t->a ? 2*t->a : 64;
+      while (a <= ref)
+	 a *= 2;
+      pn = realloc(t->s, a*sizeof(char *));
+      if (pn == NULL)
+	 return 1;
+      t->s = pn;
+      memset(t->s + t->a, 0, (a - t->a)*sizeof(char *));
+      t->a = a;
+   }
+   if (ref >= t->n)
+      t->n = ref + 1;
+
+   free(t->s[ref]);
+   t->s[ref] = malloc(n + 1);
+   if (t->s[ref] == NULL)
+      return 1;
+   memcpy(t->s[ref], s, n);
+   t->s[ref][n] = '\0';
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static const char *
+names_get(const oa_names_t *t, uint64_t ref)
+{
+   return ref < t->n ? t->s[ref] : NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+names_free(oa_names_t *t)
+{
+   size_t k;
+
+   for (k=0; k<t->n; k++)
+      free(t->s[k]);
+   free(t->s);
+}
+
+/*-----------------------------------------------------------------*/
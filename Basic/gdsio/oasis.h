@@ -0,0 +1,81 @@
+/*
+ * Conversion between GDSII and OASIS (SEMI P39) libraries.
+ *
+ * OASIS files are read and written by converting them to and from
+ * GDSII streams (see gdsstream.h), so that all functions working on
+ * GDSII streams, including the structure index and lazy reading of
+ * structures, can be used with OASIS files. Library, structure and
+ * element data are mapped as follows:
+ *
+ *   library name, user unit     file property GDSII_LIBRARY
+ *   database unit               unit of the START record
+ *   structures                  CELL records, names in CELLNAME records
+ *   boundaries                  RECTANGLE, TRAPEZOID or POLYGON
+ *   boxes                       RECTANGLE with the box type as datatype
+ *   paths                       PATH with half width and extensions
+ *   texts                       TEXT, strings in TEXTSTRING records
+ *   srefs, arefs                PLACEMENT, arefs with a repetition
+ *   element properties          S_GDS_PROPERTY properties
+ *
+ * When writing, coordinates are stored relative to the preceding
+ * element, modal variables are not repeated, and the records of each
+ * cell are compressed in a CBLOCK when the toolbox is compiled with
+ * HAVE_ZLIB. Element flags, plex numbers and text presentations and
+ * transformations have no OASIS equivalent and are not written;
+ * paths with an odd width are written with the next larger even
+ * width. Libraries with node elements, paths with round ends (path
+ * type 1), or array references whose pitch is not a multiple of the
+ * database unit cannot be converted and are rejected.
+ *
+ * When reading, all geometry records are supported, including
+ * CTRAPEZOID and CIRCLE (written as boundaries with CIRCLE_VERTICES
+ * vertices) and all repetition types. Placements with a regular
+ * repetition become arefs; all other repetitions are expanded into
+ * one element per position. CBLOCK records can only be read when
+ * the toolbox was compiled with HAVE_ZLIB. Other properties, layer
+ * names and extension records are ignored.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _OASIS_H
+#define _OASIS_H
+
+#include <stdio.h>
+
+/* the first bytes of an OASIS file */
+#define OAS_MAGIC      "%SEMI-OASIS\r\n"
+#define OAS_MAGIC_LEN  13
+
+/* vertices of boundaries for CIRCLE records */
+#define CIRCLE_VERTICES  64
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * converts a GDSII library into an OASIS file. The input stream
+ * must be positioned at the beginning of the library; conversion
+ * ends with the ENDLIB record. Returns NULL on success or an error
+ * message.
+ *
+ * fin :     input stream with a GDSII library
+ * fob :     output stream for the OASIS file
+ * cblock :  when != 0, the records of each cell are compressed
+ *           (only with HAVE_ZLIB)
+ */
+const char *oas_write(FILE *fin, FILE *fob, int cblock);
+
+/*
+ * converts an OASIS file into a GDSII library. The input stream
+ * must be positioned at the beginning of the file. Returns NULL on
+ * success or an error message.
+ *
+ * fin :  input stream with an OASIS file
+ * fob :  output stream for the GDSII library
+ */
+const char *oas_read(FILE *fin, FILE *fob);
+
+#endif /* _OASIS_H */
@@ -0,0 +1,217 @@
+/*
+ * Conversion of GDSII paths to polygons (see pathpoly.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <math.h>
+#include "pathpoly.h"
+
+#ifndef M_PI
+   #define M_PI 3.14159265358979323846
+#endif
+
+/* relative size below which adjacent segments are anti-parallel */
+#define MITER_EPS  1e-12
+
+
+/*-----------------------------------------------------------------*/
+
+/* index of the next vertex after i that differs from vertex i */
+static size_t
+next_vertex(const double *x, const double *y, size_t nv, size_t stride,
+            size_t i)
+{
+   size_t j;
+
+   for (j=i+1; j<nv; j++) {
+      if (x[j*stride] != x[i*stride] || y[j*stride] != y[i*stride])
+	 break;
+   }
+   return j;
+}
+
+
+/* number of distinct vertices */
+static size_t
+distinct_vertices(const double *x, const double *y, size_t nv, size_t stride)
+{
+   size_t i, m = 0;
+
+   for (i=0; i<nv; i=next_vertex(x, y, nv, stride, i))
+      m++;
+   return m;
+}
+
+
+/* the path types that are rendered differently from type 0 */
+static int
+path_type(int ptype)
+{
+   return (ptype == 1 || ptype == 2 || ptype == 4) ? ptype : 0;
+}
+
+
+/* unit vector from vertex i to vertex j */
+static void
+unit_vector(const double *x, const double *y, size_t stride,
+            size_t i, size_t j, double *ux, double *uy)
+{
+   double dx = x[j*stride] - x[i*stride];
+   double dy = y[j*stride] - y[i*stride];
+   double d = sqrt(dx*dx + dy*dy);
+
+   *ux = dx / d;
+   *uy = dy / d;
+}
+
+
+/* half circle around (cx,cy) starting in direction a0 */
+static void
+half_circle(double cx, double cy, double r, double a0,
+            double *px, double *py, size_t ostride)
+{
+   double a;
+   int k;
+
+   for (k=1; k<=PP_ARC_POINTS; k++) {
+      a = a0 + k * M_PI / (PP_ARC_POINTS + 1);
+      px[(k-1)*ostride] = cx + r * cos(a);
+      py[(k-1)*ostride] = cy + r * sin(a);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+size_t
+pathpoly_size(const double *x, const double *y, size_t nv,
+              size_t stride, int ptype)
+{
+   size_t m = distinct_vertices(x, y, nv, stride);
+
+   if (m < 2)
+      return 0;
+   return 2*m + 1 + (path_type(ptype) == 1 ? 2*PP_ARC_POINTS : 0);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+size_t
+pathpoly(const double *x, const double *y, size_t nv, size_t stride,
+         double hw, int ptype, const double *ext,
+         double *px, double *py, size_t ostride)
+{
+   double ux, uy, vx, vy, mx, my, d, e0 = 0.0, e1 = 0.0;
+   size_t m, na, ia, ib, ic, k, r, l;
+
+   m = distinct_vertices(x, y, nv, stride);
+   if (m < 2)
+      return 0;
+
+   ptype = path_type(ptype);
+   na = ptype == 1 ? PP_ARC_POINTS : 0;
+   if (ptype == 2)
+      e0 = e1 = hw;
+   else if (ptype == 4 && ext != NULL) {
+      e0 = ext[0];
+      e1 = ext[1];
+   }
+
+   /* the right side is stored in positions 0 ... m-1, the left
+      side in reverse order in positions m+na ... 2*m+na-1 */
+   ia = 0;
+   ib = next_vertex(x, y, nv, stride, ia);
+   unit_vector(x, y, stride, ia, ib, &ux, &uy);
+   r = 0;
+   l = 2*m + na - 1;
+   px[r*ostride] = x[0] + hw*uy - e0*ux;
+   py[r*ostride] = y[0] - hw*ux - e0*uy;
+   px[l*ostride] = x[0] - hw*uy - e0*ux;
+   py[l*ostride] = y[0] + hw*ux - e0*uy;
+
+   /* mitered interior vertices */
+   for (k=1; (ic = next_vertex(x, y, nv, stride, ib)) < nv; k++) {
+      unit_vector(x, y, stride, ib, ic, &vx, &vy);
+      d = 1.0 + ux*vx + uy*vy;
+      if (d > MITER_EPS) {
+	 mx = -(uy + vy) / d;        /* (n1 + n2) / (1 + n1.n2) */
+	 my =  (ux + vx) / d;
+      }
+      else {                         /* path reverses direction */
+	 mx = -uy;
+	 my =  ux;
+      }
+      r = k;
+      l = 2*m + na - 1 - k;
+      px[r*ostride] = x[ib*stride] - hw*mx;
+      py[r*ostride] = y[ib*stride] - hw*my;
+      px[l*ostride] = x[ib*stride] + hw*mx;
+      py[l*ostride] = y[ib*stride] + hw*my;
+      ux = vx;
+      uy = vy;
+      ib = ic;
+   }
+
+   /* end of the path */
+   r = m - 1;
+   l = m + na;
+   px[r*ostride] = x[ib*stride] + hw*uy + e1*ux;
+   py[r*ostride] = y[ib*stride] - hw*ux + e1*uy;
+   px[l*ostride] = x[ib*stride] - hw*uy + e1*ux;
+   py[l*ostride] = y[ib*stride] + hw*ux + e1*uy;
+
+   /* round ends from the right to the left side and back */
+   if (ptype == 1) {
+      half_circle(x[ib*stride], y[ib*stride], hw, atan2(-ux, uy),
+                  px + m*ostride, py + m*ostride, ostride);
+      unit_vector(x, y, stride, 0, next_vertex(x, y, nv, stride, 0), &ux, &uy);
+      half_circle(x[0], y[0], hw, atan2(ux, -uy),
+                  px + (2*m + na)*ostride, py + (2*m + na)*ostride, ostride);
+   }
+
+   /* close the polygon */
+   k = 2*m + 2*na;
+   px[k*ostride] = px[0];
+   py[k*ostride] = py[0];
+
+   return k + 1;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+pathpoly_offsets(const double *x, const double *y, const size_t *off,
+                 size_t npath, const int *ptype, int pt1, size_t *poff)
+{
+   size_t k;
+
+   poff[0] = 0;
+   for (k=0; k<npath; k++)
+      poff[k+1] = poff[k] + pathpoly_size(x + off[k], y + off[k],
+                                          off[k+1] - off[k], 1,
+                                          ptype[pt1 ? 0 : k]);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+pathpoly_batch(const double *x, const double *y, const size_t *off,
+               size_t npath, const double *hw, int hw1,
+               const int *ptype, int pt1, const double *ext, int ext1,
+               const size_t *poff, double *px, double *py)
+{
+   size_t k;
+
+   for (k=0; k<npath; k++) {
+      if (poff[k+1] == poff[k])
+	 continue;
+      pathpoly(x + off[k], y + off[k], off[k+1] - off[k], 1,
+               hw[hw1 ? 0 : k], ptype[pt1 ? 0 : k],
+               ext == NULL ? NULL : ext + 2*(ext1 ? 0 : k),
+               px + poff[k], py + poff[k], 1);
+   }
+}
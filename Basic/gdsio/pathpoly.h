@@ -0,0 +1,76 @@
+/*
+ * Conversion of GDSII paths to polygons.
+ *
+ * A path is rendered as a closed, counter-clockwise polygon that
+ * runs forward along the right side of the path and back along the
+ * left side. Interior vertices are mitered. The path ends depend on
+ * the path type:
+ *
+ *   0 :  square ends, flush with the end points
+ *   1 :  round ends (half circles with PP_ARC_POINTS interior points)
+ *   2 :  square ends, extended by half the path width
+ *   4 :  square ends, extended by the begin and end extensions
+ *
+ * Unknown path types are rendered as type 0. Repeated vertices are
+ * ignored; a path with fewer than 2 distinct vertices has no polygon.
+ *
+ * Coordinates are read as x[k*stride], y[k*stride] and written with
+ * stride ostride, which covers packed x,y pairs (stride 2) as well
+ * as the separate columns of a V x 2 MATLAB matrix (stride 1).
+ *
+ * The functions do not use the MATLAB API and are shared by the mex
+ * functions, the hierarchy flattener, and the WebAssembly module.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _PATHPOLY_H
+#define _PATHPOLY_H
+
+#include <stddef.h>
+
+/* number of points on a round path end without its end points */
+#define PP_ARC_POINTS  28
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * returns the number of polygon vertices (including the closing
+ * vertex) of a path with nv vertices, or 0 when the path has fewer
+ * than 2 distinct vertices.
+ */
+size_t pathpoly_size(const double *x, const double *y, size_t nv,
+                     size_t stride, int ptype);
+
+/*
+ * writes the polygon of a path to px, py, which must have room for
+ * pathpoly_size() vertices. hw is half the path width; ext contains
+ * the begin and end extensions of type 4 paths and can be NULL for
+ * other path types. Returns the number of vertices written.
+ */
+size_t pathpoly(const double *x, const double *y, size_t nv, size_t stride,
+                double hw, int ptype, const double *ext,
+                double *px, double *py, size_t ostride);
+
+/*
+ * converts npath paths in a packed vertex buffer; the vertices of
+ * path k are x[off[k]] ... x[off[k+1]-1]. hw, ptype and ext (two
+ * values per path, may be NULL) hold the path parameters; an array
+ * with a single entry applies to all paths when the corresponding
+ * scalar flag (hw1, pt1, ext1) is set. poff (npath+1 entries) must
+ * have been filled by pathpoly_offsets; the polygon of path k is
+ * written to px[poff[k]] ... px[poff[k+1]-1]. Paths without a
+ * polygon are empty.
+ */
+void pathpoly_offsets(const double *x, const double *y, const size_t *off,
+                      size_t npath, const int *ptype, int pt1, size_t *poff);
+
+void pathpoly_batch(const double *x, const double *y, const size_t *off,
+                    size_t npath, const double *hw, int hw1,
+                    const int *ptype, int pt1, const double *ext, int ext1,
+                    const size_t *poff, double *px, double *py);
+
+#endif /* _PATHPOLY_H */
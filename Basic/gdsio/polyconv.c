@@ -0,0 +1,159 @@
+/*
+ * Parallel conversion of paths to polygons (see polyconv.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include "pathpoly.h"
+#include "polyconv.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+
+
+/*
+ * a range of groups processed by one thread
+ */
+typedef struct {
+   pc_path_t *pp;
+   size_t first, last;    /* paths first ... last-1 */
+   int size;              /* 1: count vertices, 0: write polygons */
+} pc_job_t;
+
+
+/*-----------------------------------------------------------------*/
+
+static void *
+pc_worker(void *arg)
+{
+   pc_job_t *job = (pc_job_t *)arg;
+   pc_path_t *p;
+   size_t k;
+
+   for (k=job->first; k<job->last; k++) {
+      p = &job->pp[k];
+      if (job->size)
+	 p->np = pathpoly_size(p->xy, p->xy + p->nv, p->nv, 1, p->ptype);
+      else if (p->np)
+	 pathpoly(p->xy, p->xy + p->nv, p->nv, 1, p->hw, p->ptype, p->ext,
+		  p->pxy, p->pxy + p->np, 1);
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+num_processors(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * divides the groups into ranges with similar vertex numbers and
+ * runs one thread for each range
+ */
+static void
+run_jobs(pc_path_t *pp, const size_t *first, size_t ngroup, int nthreads,
+         int size)
+{
+   pc_job_t job[MAXTHREADS];
+   size_t k, g, nvert, share, acc;
+   int nt;
+#if defined HAVE_PTHREADS
+   int t;
+   pthread_t tid[MAXTHREADS];
+   int started[MAXTHREADS];
+#endif
+
+   nvert = 0;
+   for (k=first[0]; k<first[ngroup]; k++)
+      nvert += pp[k].nv;
+
+   /* number of threads */
+   if (nthreads < 1)
+      nthreads = num_processors();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+   if (nvert < PC_MIN_PARALLEL || ngroup < 2)
+      nthreads = 1;
+#if !defined HAVE_PTHREADS
+   nthreads = 1;
+#endif
+
+   /* whole groups are assigned to the threads */
+   share = (nvert + nthreads - 1) / nthreads;
+   nt = 0;
+   g = 0;
+   while (g < ngroup && nt < nthreads) {
+      job[nt].pp = pp;
+      job[nt].size = size;
+      job[nt].first = first[g];
+      if (nt == nthreads - 1)
+	 g = ngroup;
+      else {
+	 acc = 0;
+	 while (g < ngroup && acc < share) {
+	    for (k=first[g]; k<first[g+1]; k++)
+	       acc += pp[k].nv;
+	    g++;
+	 }
+      }
+      job[nt++].last = first[g];
+   }
+
+   if (nt <= 1) {
+      if (nt)
+	 pc_worker(&job[0]);
+      return;
+   }
+
+#if defined HAVE_PTHREADS
+   /* the calling thread takes the first range */
+   for (t=1; t<nt; t++)
+      started[t] = !pthread_create(&tid[t], NULL, pc_worker, &job[t]);
+   pc_worker(&job[0]);
+   for (t=1; t<nt; t++) {
+      if (started[t])
+	 pthread_join(tid[t], NULL);
+      else
+	 pc_worker(&job[t]);
+   }
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+polyconv_size(pc_path_t *pp, const size_t *first, size_t ngroup, int nthreads)
+{
+   run_jobs(pp, first, ngroup, nthreads, 1);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+polyconv_paths(pc_path_t *pp, const size_t *first, size_t ngroup, int nthreads)
+{
+   run_jobs(pp, first, ngroup, nthreads, 0);
+}
+
+/*-----------------------------------------------------------------*/
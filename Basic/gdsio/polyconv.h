@@ -0,0 +1,68 @@
+/*
+ * Parallel conversion of paths to polygons.
+ *
+ * The paths of many structures, e.g. all paths of a library, are
+ * converted to boundary polygons with the path-to-polygon kernel
+ * in pathpoly.h. The paths are grouped by structure; the groups
+ * are divided into ranges with similar numbers of path vertices,
+ * and each range is converted by one thread. The conversion runs
+ * in two passes: the first pass determines the number of polygon
+ * vertices of each path, which lets the caller allocate the
+ * output, the second pass writes the polygons.
+ *
+ * The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _POLYCONV_H
+#define _POLYCONV_H
+
+#include <stddef.h>
+
+
+/*
+ * a path and its polygon. The vertices are stored column-major,
+ * like a V x 2 MATLAB matrix.
+ */
+typedef struct {
+   const double *xy;     /* nv x 2 path vertices */
+   size_t nv;            /* number of path vertices */
+   double hw;            /* half width */
+   int ptype;            /* path type */
+   double ext[2];        /* begin and end extensions (type 4) */
+   double *pxy;          /* np x 2 polygon vertices */
+   size_t np;            /* number of polygon vertices */
+} pc_path_t;
+
+
+/* path batches with fewer vertices are processed by one thread */
+#define PC_MIN_PARALLEL  65536
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * determine the number of polygon vertices np of each path; np is
+ * 0 for paths with fewer than 2 distinct vertices. Group k contains
+ * the paths first[k] ... first[k+1]-1. nthreads < 1 uses one thread
+ * per processor.
+ *
+ * pp :      paths
+ * first :   ngroup+1 indices of the first path in each group
+ * ngroup :  number of groups
+ * nthreads: number of threads
+ */
+void polyconv_size(pc_path_t *pp, const size_t *first, size_t ngroup,
+                   int nthreads);
+
+/*
+ * write the polygons of the paths to pxy, which must have room
+ * for np vertices (see polyconv_size). Arguments as above.
+ */
+void polyconv_paths(pc_path_t *pp, const size_t *first, size_t ngroup,
+                    int nthreads);
+
+#endif /* _POLYCONV_H */
@@ -0,0 +1,195 @@
+/*
+ * Batch computation of polygon properties (see polystats.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "polystats.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#ifdef __GNUC__
+   #define RESTRICT __restrict
+#else
+   #define RESTRICT
+#endif
+
+#define MAXTHREADS 256
+
+
+/*
+ * a range of polygons processed by one thread
+ */
+typedef struct {
+   const double *x, *y;
+   const size_t *off;
+   size_t npoly;          /* total number of polygons (bbox stride) */
+   size_t first, last;    /* polygons first ... last-1 */
+   polystats_t *ps;
+} ps_job_t;
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * signed area and perimeter of one polygon. The coordinates are
+ * taken relative to the first vertex, which reduces the rounding
+ * error for polygons far from the origin.
+ */
+static void
+polygon_props(const double * RESTRICT x, const double * RESTRICT y,
+              size_t n, double *area, double *perim, double *bb)
+{
+   double x0 = x[0], y0 = y[0];
+   double a = 0.0, p = 0.0;
+   double dx, dy;
+   double xmin = x0, xmax = x0, ymin = y0, ymax = y0;
+   size_t k;
+
+   for (k=0; k<n-1; k++) {
+      a += (x[k] - x0) * (y[k+1] - y0) - (x[k+1] - x0) * (y[k] - y0);
+      dx = x[k+1] - x[k];
+      dy = y[k+1] - y[k];
+      p += sqrt(dx*dx + dy*dy);
+      xmin = x[k+1] < xmin ? x[k+1] : xmin;
+      xmax = x[k+1] > xmax ? x[k+1] : xmax;
+      ymin = y[k+1] < ymin ? y[k+1] : ymin;
+      ymax = y[k+1] > ymax ? y[k+1] : ymax;
+   }
+
+   /* closing edge; the area term is 0 */
+   dx = x0 - x[n-1];
+   dy = y0 - y[n-1];
+   p += sqrt(dx*dx + dy*dy);
+
+   *area = 0.5 * a;
+   *perim = p;
+   bb[0] = xmin; bb[1] = ymin;
+   bb[2] = xmax; bb[3] = ymax;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void *
+ps_worker(void *arg)
+{
+   ps_job_t *job = (ps_job_t *)arg;
+   polystats_t *ps = job->ps;
+   double area, perim, bb[4];
+   size_t k, b;
+
+   for (k=job->first; k<job->last; k++) {
+
+      b = job->off[k];
+      polygon_props(job->x + b, job->y + b, job->off[k+1] - b,
+                    &area, &perim, bb);
+
+      if (ps->area)
+	 ps->area[k] = area;
+      if (ps->perim)
+	 ps->perim[k] = perim;
+      if (ps->cw)
+	 ps->cw[k] = area < 0.0;
+      if (ps->bbox) {
+	 ps->bbox[k] = bb[0];
+	 ps->bbox[job->npoly + k] = bb[1];
+	 ps->bbox[2*job->npoly + k] = bb[2];
+	 ps->bbox[3*job->npoly + k] = bb[3];
+      }
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+num_processors(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+polystats(const double *x, const double *y, const size_t *off,
+          size_t npoly, polystats_t *ps, int nthreads)
+{
+   ps_job_t job[MAXTHREADS];
+   size_t k, nvert, share;
+   int nt;
+#if defined HAVE_PTHREADS
+   int t;
+   pthread_t tid[MAXTHREADS];
+   int started[MAXTHREADS];
+#endif
+
+   for (k=0; k<npoly; k++)
+      if (off[k+1] < off[k] + 3)
+	 return -1;
+   nvert = off[npoly] - off[0];
+
+   /* number of threads */
+   if (nthreads < 1)
+      nthreads = num_processors();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+   if (nvert < PS_MIN_PARALLEL || npoly < 2)
+      nthreads = 1;
+#if !defined HAVE_PTHREADS
+   nthreads = 1;
+#endif
+
+   /* split the polygons into ranges with similar vertex numbers */
+   share = (nvert + nthreads - 1) / nthreads;
+   nt = 0;
+   k = 0;
+   while (k < npoly && nt < nthreads) {
+      job[nt].x = x;
+      job[nt].y = y;
+      job[nt].off = off;
+      job[nt].npoly = npoly;
+      job[nt].ps = ps;
+      job[nt].first = k;
+      if (nt == nthreads - 1)
+	 k = npoly;
+      else
+	 while (k < npoly && off[k] - off[job[nt].first] < share)
+	    k++;
+      job[nt++].last = k;
+   }
+
+   if (nt == 1) {
+      ps_worker(&job[0]);
+      return 0;
+   }
+
+#if defined HAVE_PTHREADS
+   /* the calling thread takes the first range */
+   for (t=1; t<nt; t++)
+      started[t] = !pthread_create(&tid[t], NULL, ps_worker, &job[t]);
+   ps_worker(&job[0]);
+   for (t=1; t<nt; t++) {
+      if (started[t])
+	 pthread_join(tid[t], NULL);
+      else
+	 ps_worker(&job[t]);
+   }
+#endif
+
+   return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Batch computation of polygon properties.
+ *
+ * The vertices of many polygons are passed in one packed buffer
+ * with separate x and y arrays (the column-major layout of a V x 2
+ * MATLAB matrix). The vertices of polygon k are
+ * x[off[k]] ... x[off[k+1]-1]. Polygons may be open or closed (last
+ * vertex repeats the first); the closing edge is always added and
+ * has length 0 for closed polygons. The loops over the vertices of
+ * a polygon have no branches; compilers vectorize them when the
+ * reassociation of floating point sums is permitted (-ffast-math).
+ *
+ * The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _POLYSTATS_H
+#define _POLYSTATS_H
+
+#include <stddef.h>
+
+
+/*
+ * polygon properties; arrays with one entry per polygon.
+ * Any of the arrays can be NULL when the property is not needed.
+ */
+typedef struct {
+   double *area;     /* signed area; > 0 for counter-clockwise polygons */
+   double *perim;    /* perimeter */
+   double *bbox;     /* npoly x 4 column-major: llx, lly, urx, ury */
+   unsigned char *cw; /* 1 for clockwise polygons */
+} polystats_t;
+
+
+/* polygon batches with fewer vertices are processed by one thread */
+#define PS_MIN_PARALLEL  65536
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * compute the properties of npoly polygons. off has npoly+1 entries.
+ * nthreads is the number of threads used for batches with at least
+ * PS_MIN_PARALLEL vertices; nthreads < 1 uses one thread per
+ * processor. Returns 0 on success or -1 when a polygon has fewer
+ * than 3 vertices.
+ */
+int polystats(const double *x, const double *y, const size_t *off,
+              size_t npoly, polystats_t *ps, int nthreads);
+
+#endif /* _POLYSTATS_H */
@@ -1,22 +1,63 @@
-function [glib] = read_gds_library(gdsname, verbose, hdronly)
-%function [glib] = read_gds_library(gdsname, verbose, hdronly)
+function [glib] = read_gds_library(gdsname, verbose, hdronly, sname, lazy, window, columns)
+%function [glib] = read_gds_library(gdsname, verbose, hdronly, sname, lazy, window, columns)
 %  
 % Reads a GDSII file and returns its structures and elements as a
 % gds_library object. Can also be used to read and display the header
 % portion of a GDSII file.
 %
 % gdsname :  name of a GDSII file to read (with or without .gds extension).
+%            Files compressed with gzip or zstd are decompressed while
+%            they are read, OASIS files are converted to GDSII before
+%            they are read (see gds_open).
 % verbose :  when > 0, print out information about the file and
 %            structure names during reading. Default is 0 (quiet).
 % hdronly :  when > 0, only the header information will be displayed and 
 %            the header structure will be returned. Implies verbose = 1. 
 %            Default is 0.
+% sname :    (Optional) name of a structure. When given, only this
+%            structure and the structures in its subtree are read. 
+%            The structure offsets are taken from the structure index
+%            of the file (see gds_library_index).
+% lazy :     (Optional) when > 0, the vertices and properties of the
+%            elements are not decoded while the file is read. They
+%            are kept as raw records and decoded when they are
+%            accessed, e.g. with the xy or prop methods. This reduces
+%            the read time and memory use when most elements are
+%            only selected by layer, type, or structure name.
+%            Default is 0.
+% window :   (Optional) [llx,lly,urx,ury] in user units. When given,
+%            only the structures and elements that are visible through
+%            the window in the top structure (sname, or all structures
+%            that are not referenced) are read. References outside the
+%            window and array rows and columns that miss it are
+%            skipped using the bounding boxes of the structures, so
+%            that only objects in the window are created.
+%            Elements that overlap the window are read in full; in
+%            lazy mode, only boundaries and boxes are tested.
+% columns :  (Optional) when > 0, the elements of each structure are
+%            also stored in a columnar table (see columns method of
+%            gds_structure), which is created while the file is read.
+%            Selections by element type, layer, and data type can
+%            then be made without accessing the element objects (see
+%            selectel). The columns are not created in lazy mode.
+%            Default is 0.
 % glib :     library object with GDS elements and structures
 %
+% NOTE: when no window is given, each structure records the file
+% name and the position of the structure in the file. Structures
+% that are not modified are copied from the file when the library
+% is written (see write_gds_library), which is much faster than
+% encoding their elements.
+%
 
 % Initial version, Ulf Griesmann, NIST, November 2011
+% Read OASIS files, October 2026
 
     % check arguments
+    if nargin < 7, columns = []; end
+    if nargin < 6, window = []; end
+    if nargin < 5, lazy = []; end
+    if nargin < 4, sname = []; end
     if nargin < 3, hdronly = []; end
     if nargin < 2, verbose = []; end
     if nargin < 1 
@@ -30,6 +71,8 @@ function [glib] = read_gds_library(gdsname, verbose, hdronly)
     if isempty(hdronly), hdronly = 0; end
     if hdronly, verbose = 1; end
     if isempty(verbose), verbose = 0; end
+    if isempty(lazy), lazy = 0; end
+    if isempty(columns), columns = 0; end
     
     % open file for reading
     if ~gds_file_exists(gdsname)
@@ -37,6 +80,8 @@ function [glib] = read_gds_library(gdsname, verbose, hdronly)
             gdsname = [gdsname, '.gds'];
         elseif gds_file_exists([gdsname,'.cgds'])
             gdsname = [gdsname, '.cgds'];
+        elseif gds_file_exists([gdsname,'.oas'])
+            gdsname = [gdsname, '.oas'];
         else
             error('input file does not exist.');
         end
@@ -75,35 +120,43 @@ function [glib] = read_gds_library(gdsname, verbose, hdronly)
         fprintf('Structures    :\n');
     end
     
-    % element and structure counters
-    tnel = 0;
-    nstr = 0;
-    
-    while 1
-  
-        rtype = gds_record_info(gf);
+    % structure offsets when only a subtree is read
+    offsets = [];
+    if ~isempty(sname)
+        idx = gds_library_index(gdsname, sname);
+        offsets = [idx.offset];
+    end
+
+    % read all structures with a single call to the mex function
+    [S, tnel] = gds_read_library_mex(gf, ldata.uunit, ldata.dbunit, [], verbose, offsets, [], lazy, ...
+                                     window, sname, columns);
+
+    % source of the structures; structures in a window are incomplete
+    src = [];
+    if isempty(window)
+        src.file = gdsname;
+        if gdsname(1) ~= filesep && ~(ispc && numel(gdsname) > 1 && gdsname(2) == ':')
+            src.file = fullfile(pwd, gdsname);
+        end
+        d = dir(gdsname);
+        src.fsize = d.bytes;
+        src.fdate = d.datenum;
+        src.dbunit = ldata.dbunit;
+    end
 
-        switch rtype
-            
-          case 1024 % ENDLIB
-            break
-  
-          case 1282 % BGNSTR - beginning of structure
-            nstr = nstr + 1;
-            S = gds_read_struct(gf, ldata.uunit, ldata.dbunit);
-            glib(nstr) = S;
-            tnel = tnel + numel(S);
-            if verbose  % print structure information and progress info
-                fpos = gds_ftell(gf);
-                fprintf('%d ... %3.1f%% ... %s (%d)\n', ...
-                        nstr, 100*fpos/fsize, sname(S), numel(S));
-            end
-            
-          otherwise
-            fclose(gf); % something is wrong - get out
-            error('invalid GDS file - ENDLIB or BGNSTR expected.');
+    % create the structure objects; the element data are returned by
+    % the mex function in the layout of gds_element objects, which are
+    % created with a single call to 'class' for each structure
+    for k = 1:numel(S)
+        elist = num2cell(class(S(k).el, 'gds_element'));
+        gst = gds_structure(S(k).sname, elist);
+        gst = set(gst, 'cdate',S(k).cdate, 'mdate',S(k).mdate, 'ebox',S(k).bbox, ...
+                  'cols',S(k).cols);
+        if ~isempty(src)
+            src.span = S(k).span;
+            gst = set(gst, 'src',src);
         end
-        
+        glib(k) = gst;
     end
 
     % close the GDS file
@@ -0,0 +1,378 @@
+/*
+ * Reference graph of the structures in a GDSII library
+ * (see refgraph.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "refgraph.h"
+
+
+/*-- name table ---------------------------------------------------*/
+
+uint32_t
+nametab_hash(const char *name)
+{
+   uint32_t h = 2166136261u;   /* FNV-1a */
+
+   while (*name) {
+      h ^= (uint8_t)*name++;
+      h *= 16777619u;
+   }
+   return h;
+}
+
+
+static int
+nametab_rehash(nametab_t *tab, size_t nslot)
+{
+   uint32_t *slot;
+   size_t k, s;
+
+   slot = (uint32_t *)calloc(nslot, sizeof(uint32_t));
+   if (slot == NULL)
+      return -1;
+   for (k=0; k<tab->n; k++) {
+      s = nametab_hash(tab->name[k]) & (nslot - 1);
+      while (slot[s])
+	 s = (s + 1) & (nslot - 1);
+      slot[s] = k + 1;
+   }
+   free(tab->slot);
+   tab->slot = slot;
+   tab->nslot = nslot;
+   return 0;
+}
+
+
+int
+nametab_init(nametab_t *tab, size_t n)
+{
+   size_t nslot = 64;
+
+   memset(tab, 0, sizeof(nametab_t));
+   while (nslot < 2*n)
+      nslot *= 2;
+   tab->alloc = n > 16 ? n : 16;
+   tab->name = (char **)malloc(tab->alloc * sizeof(char *));
+   tab->slot = (uint32_t *)calloc(nslot, sizeof(uint32_t));
+   if (tab->name == NULL || tab->slot == NULL) {
+      nametab_free(tab);
+      return -1;
+   }
+   tab->nslot = nslot;
+   return 0;
+}
+
+
+int32_t
+nametab_find(const nametab_t *tab, const char *name)
+{
+   size_t s;
+
+   s = nametab_hash(name) & (tab->nslot - 1);
+   while (tab->slot[s]) {
+      if ( !strcmp(tab->name[tab->slot[s] - 1], name) )
+	 return tab->slot[s] - 1;
+      s = (s + 1) & (tab->nslot - 1);
+   }
+   return -1;
+}
+
+
+int32_t
+nametab_intern(nametab_t *tab, const char *name, int *added)
+{
+   char **pn;
+   size_t s;
+   int32_t k;
+
+   *added = 0;
+   if ( (k = nametab_find(tab, name)) >= 0 )
+      return k;
+
+   /* keep the table at most half full */
+   if (2*(tab->n + 1) > tab->nslot && nametab_rehash(tab, 2*tab->nslot))
+      return -1;
+   if (tab->n == tab->alloc) {
+      pn = (char **)realloc(tab->name, 2 * tab->alloc * sizeof(char *));
+      if (pn == NULL)
+	 return -1;
+      tab->name = pn;
+      tab->alloc *= 2;
+   }
+   tab->name[tab->n] = (char *)malloc(strlen(name) + 1);
+   if (tab->name[tab->n] == NULL)
+      return -1;
+   strcpy(tab->name[tab->n], name);
+
+   s = nametab_hash(name) & (tab->nslot - 1);
+   while (tab->slot[s])
+      s = (s + 1) & (tab->nslot - 1);
+   tab->slot[s] = ++tab->n;
+   *added = 1;
+
+   return tab->n - 1;
+}
+
+
+void
+nametab_free(nametab_t *tab)
+{
+   size_t k;
+
+   if (tab->name) {
+      for (k=0; k<tab->n; k++)
+	 free(tab->name[k]);
+      free(tab->name);
+   }
+   free(tab->slot);
+   memset(tab, 0, sizeof(nametab_t));
+}
+
+
+/*-- graph --------------------------------------------------------*/
+
+/*
+ * marks the structures in strongly connected components with more
+ * than one structure, or with a reference to itself, as cyclic
+ * (iterative version of Tarjan's algorithm). Only structures that
+ * are not in the topological order can be part of a cycle.
+ */
+static int
+mark_cycles(refgraph_t *g)
+{
+   uint32_t *index, *low, *stack, *call;
+   size_t *edge;
+   uint8_t *onstack;
+   uint32_t v, w, next = 1;
+   size_t k, r, sp = 0, cp = 0, first;
+   int ret = -1;
+
+   index = (uint32_t *)calloc(g->n, sizeof(uint32_t));
+   low = (uint32_t *)malloc(g->n * sizeof(uint32_t));
+   stack = (uint32_t *)malloc(g->n * sizeof(uint32_t));
+   call = (uint32_t *)malloc(g->n * sizeof(uint32_t));
+   edge = (size_t *)malloc(g->n * sizeof(size_t));
+   onstack = (uint8_t *)calloc(g->n, 1);
+   if (!index || !low || !stack || !call || !edge || !onstack)
+      goto done;
+
+   /* structures in the topological order are not visited */
+   for (k=0; k<g->norder; k++)
+      index[g->order[k]] = (uint32_t)-1;
+
+   for (r=0; r<g->n; r++) {
+
+      if (index[r])
+	 continue;
+
+      /* start a depth first search at r */
+      call[cp] = r;
+      edge[cp++] = g->rowptr[r];
+      index[r] = low[r] = next++;
+      stack[sp++] = r;
+      onstack[r] = 1;
+
+      while (cp) {
+
+	 v = call[cp-1];
+	 if (edge[cp-1] < g->rowptr[v+1]) {
+	    w = g->child[edge[cp-1]++];
+	    if (w == v)
+	       g->cyclic[v] = 1;
+	    if (!index[w]) {
+	       call[cp] = w;
+	       edge[cp++] = g->rowptr[w];
+	       index[w] = low[w] = next++;
+	       stack[sp++] = w;
+	       onstack[w] = 1;
+	    }
+	    else if (onstack[w] && index[w] < low[v])
+	       low[v] = index[w];
+	    continue;
+	 }
+
+	 /* all children of v are done */
+	 cp--;
+	 if (cp && low[v] < low[call[cp-1]])
+	    low[call[cp-1]] = low[v];
+
+	 if (low[v] == index[v]) {   /* v is the root of a component */
+	    first = sp;
+	    do {
+	       w = stack[--first];
+	       onstack[w] = 0;
+	    } while (w != v);
+	    if (sp - first > 1)
+	       for (k=first; k<sp; k++)
+		  g->cyclic[stack[k]] = 1;
+	    sp = first;
+	 }
+      }
+   }
+   ret = 0;
+
+ done:
+   free(index);
+   free(low);
+   free(stack);
+   free(call);
+   free(edge);
+   free(onstack);
+   return ret;
+}
+
+
+int
+refgraph_build(refgraph_t *g, size_t n, const uint32_t *src,
+               const uint32_t *dst, const double *cnt, size_t nedge)
+{
+   size_t *next = NULL, *prowptr = NULL, *where = NULL;
+   uint32_t *parent = NULL, *pending = NULL, *stamp = NULL;
+   uint32_t c, p;
+   size_t k, m, e, head, tail;
+   int ret = -1;
+
+   memset(g, 0, sizeof(refgraph_t));
+   g->n = n;
+   g->rowptr = (size_t *)calloc(n + 1, sizeof(size_t));
+   g->child = (uint32_t *)malloc((nedge ? nedge : 1) * sizeof(uint32_t));
+   g->count = (double *)malloc((nedge ? nedge : 1) * sizeof(double));
+   g->nparent = (uint32_t *)calloc(n ? n : 1, sizeof(uint32_t));
+   g->order = (uint32_t *)malloc((n ? n : 1) * sizeof(uint32_t));
+   g->cyclic = (uint8_t *)calloc(n ? n : 1, 1);
+   next = (size_t *)malloc((n + 1) * sizeof(size_t));
+   stamp = (uint32_t *)calloc(n ? n : 1, sizeof(uint32_t));
+   where = (size_t *)malloc((n ? n : 1) * sizeof(size_t));
+   if (!g->rowptr || !g->child || !g->count || !g->nparent || !g->order ||
+       !g->cyclic || !next || !stamp || !where)
+      goto done;
+
+   /* sort the edges by source (counting sort) */
+   for (k=0; k<nedge; k++)
+      g->rowptr[src[k] + 1]++;
+   for (k=0; k<n; k++)
+      g->rowptr[k+1] += g->rowptr[k];
+   memcpy(next, g->rowptr, (n + 1) * sizeof(size_t));
+   for (k=0; k<nedge; k++) {
+      e = next[src[k]]++;
+      g->child[e] = dst[k];
+      g->count[e] = cnt ? cnt[k] : 1.0;
+   }
+
+   /* merge edges to the same child */
+   e = 0;
+   for (k=0; k<n; k++) {
+      m = g->rowptr[k];
+      g->rowptr[k] = e;
+      for (; m<next[k]; m++) {
+	 c = g->child[m];
+	 if (stamp[c] == k + 1)
+	    g->count[where[c]] += g->count[m];
+	 else {
+	    stamp[c] = k + 1;
+	    where[c] = e;
+	    g->child[e] = c;
+	    g->count[e++] = g->count[m];
+	 }
+      }
+   }
+   g->rowptr[n] = e;
+   g->nedge = e;
+
+   /* parents of each structure (transposed graph) */
+   prowptr = (size_t *)calloc(n + 1, sizeof(size_t));
+   parent = (uint32_t *)malloc((e ? e : 1) * sizeof(uint32_t));
+   pending = (uint32_t *)malloc((n ? n : 1) * sizeof(uint32_t));
+   if (!prowptr || !parent || !pending)
+      goto done;
+   for (k=0; k<e; k++) {
+      g->nparent[g->child[k]]++;
+      prowptr[g->child[k] + 1]++;
+   }
+   for (k=0; k<n; k++)
+      prowptr[k+1] += prowptr[k];
+   memcpy(next, prowptr, (n + 1) * sizeof(size_t));
+   for (k=0; k<n; k++)
+      for (m=g->rowptr[k]; m<g->rowptr[k+1]; m++)
+	 parent[next[g->child[m]]++] = k;
+
+   /* topological order: a structure follows all of its children */
+   head = tail = 0;
+   for (k=0; k<n; k++) {
+      pending[k] = g->rowptr[k+1] - g->rowptr[k];
+      if (!pending[k])
+	 g->order[tail++] = k;
+   }
+   while (head < tail) {
+      c = g->order[head++];
+      for (m=prowptr[c]; m<prowptr[c+1]; m++) {
+	 p = parent[m];
+	 if (--pending[p] == 0)
+	    g->order[tail++] = p;
+      }
+   }
+   g->norder = tail;
+
+   /* find the structures in cycles */
+   if (g->norder < n && mark_cycles(g))
+      goto done;
+   ret = 0;
+
+ done:
+   free(next);
+   free(stamp);
+   free(where);
+   free(prowptr);
+   free(parent);
+   free(pending);
+   if (ret)
+      refgraph_free(g);
+   return ret;
+}
+
+
+long
+refgraph_subtree(const refgraph_t *g, uint32_t top, uint8_t *mark)
+{
+   uint32_t *stack, v, w;
+   size_t sp = 0, m;
+   long nmark = 1;
+
+   stack = (uint32_t *)malloc((g->n ? g->n : 1) * sizeof(uint32_t));
+   if (stack == NULL)
+      return -1;
+
+   mark[top] = 1;
+   stack[sp++] = top;
+   while (sp) {
+      v = stack[--sp];
+      for (m=g->rowptr[v]; m<g->rowptr[v+1]; m++) {
+	 w = g->child[m];
+	 if (!mark[w]) {
+	    mark[w] = 1;
+	    stack[sp++] = w;
+	    nmark++;
+	 }
+      }
+   }
+
+   free(stack);
+   return nmark;
+}
+
+
+void
+refgraph_free(refgraph_t *g)
+{
+   free(g->rowptr);
+   free(g->child);
+   free(g->count);
+   free(g->nparent);
+   free(g->order);
+   free(g->cyclic);
+   memset(g, 0, sizeof(refgraph_t));
+}
@@ -0,0 +1,111 @@
+/*
+ * Reference graph of the structures in a GDSII library.
+ *
+ * Structure names are interned in a hash table and the references
+ * between structures are stored as a sparse graph in compressed
+ * row (CSR) format: the children of structure k are
+ * child[rowptr[k]] ... child[rowptr[k+1]-1]. Multiple references
+ * of a structure to the same child are merged into one edge with
+ * the total number of placed instances (array references count
+ * columns x rows instances). All operations are linear in the
+ * number of structures and references.
+ *
+ * The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _REFGRAPH_H
+#define _REFGRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ * hash table with interned structure names
+ */
+typedef struct {
+   char **name;          /* names in insertion order */
+   size_t n, alloc;
+   uint32_t *slot;       /* open addressing table; entries are
+                            index + 1, 0 marks empty slots */
+   size_t nslot;         /* a power of 2 */
+} nametab_t;
+
+
+/*
+ * reference graph
+ */
+typedef struct {
+   size_t n;             /* number of structures */
+   size_t nedge;         /* number of edges */
+   size_t *rowptr;       /* n+1 row offsets */
+   uint32_t *child;      /* nedge child indices */
+   double *count;        /* nedge instance counts */
+   uint32_t *nparent;    /* number of distinct parents of each structure */
+   uint32_t *order;      /* topological order, children before parents */
+   size_t norder;        /* < n when the graph contains cycles */
+   uint8_t *cyclic;      /* 1 for structures that are part of a cycle */
+} refgraph_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * initialize a name table for about n names. Returns 0 on success
+ * or -1 when memory is exhausted.
+ */
+int nametab_init(nametab_t *tab, size_t n);
+
+/*
+ * return the index of a name, adding it to the table if it is not
+ * in the table yet. *added is set to 1 for new names. Returns -1
+ * when memory is exhausted.
+ */
+int32_t nametab_intern(nametab_t *tab, const char *name, int *added);
+
+/*
+ * return the index of a name or -1 if it is not in the table
+ */
+int32_t nametab_find(const nametab_t *tab, const char *name);
+
+/*
+ * release the memory of a name table
+ */
+void nametab_free(nametab_t *tab);
+
+/*
+ * hash of a name. The slots of a name table are probed linearly
+ * from nametab_hash(name) & (nslot-1); tables that keep slots in
+ * this layout but store the names elsewhere (namehashmex) must use
+ * the same function.
+ */
+uint32_t nametab_hash(const char *name);
+
+/*
+ * build the graph of n structures from nedge references
+ * src[k] -> dst[k], each placing cnt[k] instances (cnt may be NULL
+ * for 1 instance per reference). Computes the topological order
+ * and marks the structures in cycles. Returns 0 on success or -1
+ * when memory is exhausted.
+ */
+int refgraph_build(refgraph_t *g, size_t n, const uint32_t *src,
+                   const uint32_t *dst, const double *cnt, size_t nedge);
+
+/*
+ * mark all structures reachable from structure top, including
+ * top, in the array mark (n elements, set to 0 by the caller).
+ * Returns the number of marked structures or -1 when memory is
+ * exhausted.
+ */
+long refgraph_subtree(const refgraph_t *g, uint32_t top, uint8_t *mark);
+
+/*
+ * release the memory of a graph
+ */
+void refgraph_free(refgraph_t *g);
+
+#endif /* _REFGRAPH_H */
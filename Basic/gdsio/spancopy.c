@@ -0,0 +1,219 @@
+/*
+ * Copying of structures from a library file to an output stream
+ * Copyright (c) 2026
+ */
+
+#define _GNU_SOURCE   /* for copy_file_range */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gdstypes.h"
+#include "spancopy.h"
+
+#if defined __linux__
+   #include <errno.h>
+   #include <unistd.h>
+   #include <sys/sendfile.h>
+   #define HAVE_KERNEL_COPY
+   #if defined __GLIBC__ && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+      #define HAVE_COPY_FILE_RANGE
+   #endif
+#endif
+
+#define CBUFSIZE  (1<<20)    /* size of the copy buffer */
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static const char *open_source(span_src_t *src, const char *fname);
+static int is_record(const uint8_t *p, uint16_t rtype);
+static const char *buffer_copy(FILE *fob, span_src_t *src, uint64_t offset,
+                               uint64_t nbytes);
+#if defined HAVE_KERNEL_COPY
+static int kernel_copy(FILE *fob, int ifd, uint64_t offset, uint64_t nbytes,
+                       const char **msg);
+#endif
+
+
+/*-----------------------------------------------------------------*/
+
+const char *
+span_copy(FILE *fob, span_src_t *src, const char *fname,
+          uint64_t offset, uint64_t nbytes)
+{
+   const char *msg = NULL;
+
+   if (nbytes < 8)
+      return "invalid structure span.";
+   if ( (msg = open_source(src, fname)) )
+      return msg;
+
+#if defined HAVE_KERNEL_COPY
+   /* OASIS sources are converted into a plain temporary file */
+   if ((src->kind == STREAM_PLAIN || src->kind == STREAM_OASIS) && fileno(fob) >= 0) {
+      if ( !kernel_copy(fob, fileno(src->fin), offset, nbytes, &msg) )
+	 return msg;
+   }
+#endif
+
+   return buffer_copy(fob, src, offset, nbytes);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+span_close(span_src_t *src)
+{
+   if (src->fin)
+      fclose(src->fin);
+   free(src->fname);
+   free(src->buf);
+   memset(src, 0, sizeof(span_src_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the library file stays open while structures are copied from it
+ */
+static const char *
+open_source(span_src_t *src, const char *fname)
+{
+   if (src->fname && !strcmp(src->fname, fname))
+      return NULL;
+
+   if (src->fin)
+      fclose(src->fin);
+   free(src->fname);
+   src->fname = NULL;
+
+   src->fin = stream_open(fname, "rb", &src->kind);
+   if (src->fin == NULL)
+      return "could not open library file of unmodified structure.";
+   src->fname = malloc(strlen(fname) + 1);
+   if (src->fname == NULL)
+      return "failed to allocate memory.";
+   strcpy(src->fname, fname);
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * checks the type of the record with the header at p
+ */
+static int
+is_record(const uint8_t *p, uint16_t rtype)
+{
+   return p[2] == (rtype >> 8) && p[3] == (rtype & 0xff);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * copies through a memory buffer; works for all streams
+ */
+static const char *
+buffer_copy(FILE *fob, span_src_t *src, uint64_t offset, uint64_t nbytes)
+{
+   uint64_t n;
+   size_t m;
+   int first = 1;
+
+   if (src->buf == NULL) {
+      src->buf = malloc(CBUFSIZE);
+      if (src->buf == NULL)
+	 return "failed to allocate memory.";
+   }
+
+   if ( fseek(src->fin, (long)offset, SEEK_SET) < 0 )
+      return "could not set position in library file.";
+
+   for (n=nbytes; n>0; n-=m) {
+      m = n > CBUFSIZE ? CBUFSIZE : (size_t)n;
+      if ( fread(src->buf, 1, m, src->fin) != m )
+	 return "library file is shorter than the structure span.";
+      if (first && !is_record(src->buf, BGNSTR))
+	 return "structure span does not begin with BGNSTR.";
+      if (m == n && (m < 4 || !is_record(src->buf + m - 4, ENDSTR)))
+	 return "structure span does not end with ENDSTR.";
+      if ( fwrite(src->buf, 1, m, fob) != m )
+	 return "failed to write structure.";
+      first = 0;
+   }
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+#if defined HAVE_KERNEL_COPY
+
+/*
+ * copies between file descriptors in the kernel. Returns 1 when
+ * the kernel cannot copy between the files and nothing was written;
+ * otherwise returns 0 with an error message or NULL in msg.
+ */
+static int
+kernel_copy(FILE *fob, int ifd, uint64_t offset, uint64_t nbytes,
+            const char **msg)
+{
+   uint8_t hdr[4];
+   off_t off = (off_t)offset;
+   uint64_t n = nbytes;
+   ssize_t m = -1;
+   int ofd = fileno(fob);
+
+   /* check the span */
+   if ( pread(ifd, hdr, 4, off) != 4 || !is_record(hdr, BGNSTR) ) {
+      *msg = "structure span does not begin with BGNSTR.";
+      return 0;
+   }
+   if ( pread(ifd, hdr, 4, off + nbytes - 4) != 4 || !is_record(hdr, ENDSTR) ) {
+      *msg = "structure span does not end with ENDSTR.";
+      return 0;
+   }
+
+   /* data in the stream buffer go first */
+   if ( fflush(fob) ) {
+      *msg = "failed to write structure.";
+      return 0;
+   }
+
+#if defined HAVE_COPY_FILE_RANGE
+   while (n > 0) {
+      m = copy_file_range(ifd, &off, ofd, NULL, (size_t)n, 0);
+      if (m <= 0)
+	 break;
+      n -= m;
+   }
+#endif
+   while (n > 0) {
+      m = sendfile(ofd, ifd, &off, (size_t)n);
+      if (m <= 0)
+	 break;
+      n -= m;
+   }
+   if (n == nbytes && m < 0 && (errno == EINVAL || errno == ENOSYS || errno == EXDEV))
+      return 1;  /* not supported for these files */
+
+   *msg = n ? "failed to copy structure." : NULL;
+
+   /* the stream position follows the descriptor */
+   if ( fseek(fob, (long)lseek(ofd, 0, SEEK_CUR), SEEK_SET) < 0 )
+      *msg = "failed to set position in output file.";
+
+   return 0;
+}
+
+#endif
+
+/*-----------------------------------------------------------------*/
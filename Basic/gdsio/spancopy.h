@@ -0,0 +1,59 @@
+/*
+ * Copying of structures from a library file to an output stream.
+ *
+ * Structures of a library that was read from a file and was not
+ * modified can be written by copying the bytes from the BGNSTR
+ * record to the ENDSTR record (the span of the structure) from
+ * the library file instead of encoding the elements again. When
+ * both files are uncompressed, the data are copied by the kernel
+ * with copy_file_range or sendfile where these are available;
+ * otherwise they are copied through a memory buffer.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _SPANCOPY_H
+#define _SPANCOPY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "gdsstream.h"
+
+
+/*
+ * the library file from which structures are copied. It is kept
+ * open between calls and must be set to zero before the first call.
+ */
+typedef struct {
+   char *fname;          /* name of the open file or NULL */
+   FILE *fin;            /* library file */
+   stream_kind kind;     /* compression format */
+   uint8_t *buf;         /* copy buffer */
+} span_src_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * copy the span of a structure from a library file to a stream.
+ * It is an error when the span does not begin with a BGNSTR record
+ * and end with an ENDSTR record, e.g. because the library file was
+ * changed. Returns NULL on success or an error message.
+ *
+ * fob :     output stream
+ * src :     state of the library file
+ * fname :   name of the library file
+ * offset :  file position of the BGNSTR record
+ * nbytes :  number of bytes up to and including the ENDSTR record
+ */
+const char *span_copy(FILE *fob, span_src_t *src, const char *fname,
+                      uint64_t offset, uint64_t nbytes);
+
+/*
+ * close the library file and release the copy buffer
+ */
+void span_close(span_src_t *src);
+
+#endif /* _SPANCOPY_H */
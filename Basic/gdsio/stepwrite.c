@@ -0,0 +1,935 @@
+/*
+ * Output of extruded polygons as STEP files (see stepwrite.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "stepwrite.h"
+
+/* size of the stdio buffer of the STEP file */
+#define STEP_BUFSIZE  (1 << 20)
+
+#define ID(n)  ((unsigned long)(n))
+
+
+/* sort key of a ring vertex */
+typedef struct {
+   double x, y;
+   size_t i;
+} vkey_t;
+
+/* sort key of a ring edge; a < b are unique vertices */
+typedef struct {
+   size_t a, b;
+   size_t i;
+} ekey_t;
+
+
+/*
+ * state of a STEP file and the work arrays of a prism
+ */
+struct step_file {
+   FILE *fp;
+   char *fname;           /* copy of the file name */
+   int err;               /* first write error */
+   size_t id;             /* last entity number */
+   size_t ctx, pds, axis; /* context, product shape and origin */
+   size_t dz, dmz, dx;    /* directions +z, -z and +x */
+
+   int colors;            /* solids are colored by group */
+   size_t ngroup;
+   char **gname;          /* copies of the group names or NULL */
+   double *rgb;           /* copy of the group colors */
+
+   size_t *solid;         /* entity numbers of the solids */
+   size_t nsolid, capsolid;
+   size_t *styled;        /* styled items */
+   size_t nstyled, capstyled;
+   size_t *style;         /* style of each group; 0 before it is written */
+
+   size_t cap;            /* capacity of the work arrays */
+   double *cx, *cy;       /* ring vertices */
+   size_t *uv;            /* unique vertex of each ring vertex */
+   vkey_t *vk;
+   ekey_t *ek;
+   unsigned char *bridge; /* ring edge is a keyhole edge */
+   unsigned char *used;
+   size_t *pb, *pt;       /* bottom and top points of unique vertices */
+   size_t *vb, *vt;       /* bottom and top vertices */
+   size_t *vert;          /* vertical edges */
+   size_t *eb, *et;       /* bottom and top edges of ring edges */
+   size_t *edir;          /* directions of ring edges */
+   size_t *fout, *fnext;  /* ring edges starting at a unique vertex */
+   size_t *loop;          /* ring edges of the loops, in loop order */
+   size_t *lstart;        /* first entry of each loop in loop */
+   size_t *lbound;        /* bounds of a cap */
+};
+
+
+/*-----------------------------------------------------------------*/
+
+/* writes a real number; STEP reals need a decimal point */
+static void
+put_real(FILE *fp, double v)
+{
+   char buf[48];
+   char *e;
+   size_t n;
+
+   if (v == 0.0)
+      v = 0.0;  /* no negative zero */
+   sprintf(buf, "%.15G", v);
+   if (strchr(buf, '.') == NULL) {
+      e = strchr(buf, 'E');
+      if (e == NULL)
+	 strcat(buf, ".");
+      else {
+	 n = strlen(e);
+	 memmove(e + 1, e, n + 1);
+	 *e = '.';
+      }
+   }
+   fputs(buf, fp);
+}
+
+
+/* writes a string; apostrophes and backslashes are doubled */
+static void
+put_string(FILE *fp, const char *s)
+{
+   fputc('\'', fp);
+   if (s) {
+      for ( ; *s; s++) {
+	 if (*s == '\'' || *s == '\\')
+	    fputc(*s, fp);
+	 if ((unsigned char)*s >= 32 && (unsigned char)*s < 127)
+	    fputc(*s, fp);
+      }
+   }
+   fputc('\'', fp);
+}
+
+
+/* starts the next entity and returns its number */
+static size_t
+begin(step_file_t *st)
+{
+   fprintf(st->fp, "#%lu=", ID(++st->id));
+   return st->id;
+}
+
+
+static void
+end(step_file_t *st)
+{
+   fputs(";\n", st->fp);
+}
+
+
+/* writes a list of entity numbers */
+static void
+put_list(FILE *fp, const size_t *id, size_t n)
+{
+   size_t k;
+
+   fputc('(', fp);
+   for (k=0; k<n; k++)
+      fprintf(fp, k ? ",#%lu" : "#%lu", ID(id[k]));
+   fputc(')', fp);
+}
+
+
+static size_t
+point(step_file_t *st, double x, double y, double z)
+{
+   size_t id = begin(st);
+   fputs("CARTESIAN_POINT('',(", st->fp);
+   put_real(st->fp, x);
+   fputc(',', st->fp);
+   put_real(st->fp, y);
+   fputc(',', st->fp);
+   put_real(st->fp, z);
+   fputs("))", st->fp);
+   end(st);
+   return id;
+}
+
+
+static size_t
+direction(step_file_t *st, double x, double y, double z)
+{
+   size_t id = begin(st);
+   fputs("DIRECTION('',(", st->fp);
+   put_real(st->fp, x);
+   fputc(',', st->fp);
+   put_real(st->fp, y);
+   fputc(',', st->fp);
+   put_real(st->fp, z);
+   fputs("))", st->fp);
+   end(st);
+   return id;
+}
+
+
+/* line through point p with direction d; returns the edge curve */
+static size_t
+edge_curve(step_file_t *st, size_t v1, size_t v2, size_t p, size_t vec)
+{
+   size_t line;
+
+   line = begin(st);
+   fprintf(st->fp, "LINE('',#%lu,#%lu)", ID(p), ID(vec));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "EDGE_CURVE('',#%lu,#%lu,#%lu,.T.)", ID(v1), ID(v2), ID(line));
+   end(st);
+   return st->id;
+}
+
+
+static size_t
+oriented_edge(step_file_t *st, size_t edge, int sense)
+{
+   size_t id = begin(st);
+   fprintf(st->fp, "ORIENTED_EDGE('',*,*,#%lu,%s)", ID(edge), sense ? ".T." : ".F.");
+   end(st);
+   return id;
+}
+
+
+/* planar face through point p with normal n and reference direction r */
+static size_t
+plane(step_file_t *st, size_t p, size_t n, size_t r)
+{
+   size_t ax = begin(st);
+   fprintf(st->fp, "AXIS2_PLACEMENT_3D('',#%lu,#%lu,#%lu)", ID(p), ID(n), ID(r));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "PLANE('',#%lu)", ID(ax));
+   end(st);
+   return st->id;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/* appends an entity number to a growing array */
+static int
+append(size_t **a, size_t *n, size_t *cap, size_t id)
+{
+   size_t *p;
+
+   if (*n == *cap) {
+      *cap = *cap ? 2 * *cap : 1024;
+      p = realloc(*a, *cap * sizeof(size_t));
+      if (p == NULL)
+	 return STEP_ERR_MEMORY;
+      *a = p;
+   }
+   (*a)[(*n)++] = id;
+   return 0;
+}
+
+
+static void
+free_work(step_file_t *st)
+{
+   free(st->cx); free(st->cy);
+   free(st->uv); free(st->vk); free(st->ek);
+   free(st->bridge); free(st->used);
+   free(st->pb); free(st->pt); free(st->vb); free(st->vt); free(st->vert);
+   free(st->eb); free(st->et); free(st->edir);
+   free(st->fout); free(st->fnext);
+   free(st->loop); free(st->lstart); free(st->lbound);
+}
+
+
+/* work arrays for polygons with n vertices */
+static int
+grow_work(step_file_t *st, size_t n)
+{
+   if (n <= st->cap)
+      return 0;
+   free_work(st);
+   st->cap = n;
+   st->cx = malloc(n * sizeof(double));
+   st->cy = malloc(n * sizeof(double));
+   st->uv = malloc(n * sizeof(size_t));
+   st->vk = malloc(n * sizeof(vkey_t));
+   st->ek = malloc(n * sizeof(ekey_t));
+   st->bridge = malloc(n);
+   st->used = malloc(n);
+   st->pb = malloc(n * sizeof(size_t));
+   st->pt = malloc(n * sizeof(size_t));
+   st->vb = malloc(n * sizeof(size_t));
+   st->vt = malloc(n * sizeof(size_t));
+   st->vert = malloc(n * sizeof(size_t));
+   st->eb = malloc(n * sizeof(size_t));
+   st->et = malloc(n * sizeof(size_t));
+   st->edir = malloc(n * sizeof(size_t));
+   st->fout = malloc(n * sizeof(size_t));
+   st->fnext = malloc(n * sizeof(size_t));
+   st->loop = malloc(n * sizeof(size_t));
+   st->lstart = malloc((n + 1) * sizeof(size_t));
+   st->lbound = malloc((n + 2) * sizeof(size_t));
+   if (!st->cx || !st->cy || !st->uv || !st->vk || !st->ek ||
+       !st->bridge || !st->used || !st->pb || !st->pt || !st->vb ||
+       !st->vt || !st->vert || !st->eb || !st->et || !st->edir ||
+       !st->fout || !st->fnext || !st->loop || !st->lstart || !st->lbound) {
+      st->cap = 0;
+      return STEP_ERR_MEMORY;
+   }
+   return 0;
+}
+
+
+static int
+cmp_vkey(const void *p, const void *q)
+{
+   const vkey_t *a = (const vkey_t *)p, *b = (const vkey_t *)q;
+
+   if (a->x != b->x)
+      return a->x < b->x ? -1 : 1;
+   if (a->y != b->y)
+      return a->y < b->y ? -1 : 1;
+   return a->i < b->i ? -1 : (a->i > b->i);
+}
+
+
+static int
+cmp_ekey(const void *p, const void *q)
+{
+   const ekey_t *a = (const ekey_t *)p, *b = (const ekey_t *)q;
+
+   if (a->a != b->a)
+      return a->a < b->a ? -1 : 1;
+   if (a->b != b->b)
+      return a->b < b->b ? -1 : 1;
+   return a->i < b->i ? -1 : (a->i > b->i);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * presentation style of a group color
+ */
+static size_t
+group_style(step_file_t *st, const double *rgb, size_t ngroup, size_t g)
+{
+   size_t c;
+
+   if (st->style[g])
+      return st->style[g];
+
+   c = begin(st);
+   fputs("COLOUR_RGB('',", st->fp);
+   put_real(st->fp, rgb[g]);
+   fputc(',', st->fp);
+   put_real(st->fp, rgb[ngroup + g]);
+   fputc(',', st->fp);
+   put_real(st->fp, rgb[2*ngroup + g]);
+   fputc(')', st->fp);
+   end(st);
+   begin(st);
+   fprintf(st->fp, "FILL_AREA_STYLE_COLOUR('',#%lu)", ID(c));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "FILL_AREA_STYLE('',(#%lu))", ID(st->id - 1));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "SURFACE_STYLE_FILL_AREA(#%lu)", ID(st->id - 1));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "SURFACE_SIDE_STYLE('',(#%lu))", ID(st->id - 1));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "SURFACE_STYLE_USAGE(.BOTH.,#%lu)", ID(st->id - 1));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "PRESENTATION_STYLE_ASSIGNMENT((#%lu))", ID(st->id - 1));
+   end(st);
+
+   st->style[g] = st->id;
+   return st->id;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes the prism of polygon k; returns the solid or 0 for
+ * degenerate polygons
+ */
+static size_t
+prism(step_file_t *st, const prisms_t *pr, size_t k, const char *name)
+{
+   const double *x = pr->x + pr->off[k];
+   const double *y = pr->y + pr->off[k];
+   size_t n = pr->off[k+1] - pr->off[k];
+   double *cx = st->cx, *cy = st->cy;
+   double zb = pr->zb[k] * pr->scale, zt = pr->zt[k] * pr->scale;
+   double a, t, dx, dy, len, best;
+   size_t m, i, j, u, nu, e, nl, pos, l, outer, nb, vvec, shell;
+   size_t dir, vec, oe[4];
+
+   /* distinct vertices */
+   m = 0;
+   for (i=0; i<n; i++) {
+      if (m > 0 && x[i] * pr->scale == cx[m-1] && y[i] * pr->scale == cy[m-1])
+	 continue;
+      cx[m] = x[i] * pr->scale;
+      cy[m] = y[i] * pr->scale;
+      m++;
+   }
+   while (m > 1 && cx[m-1] == cx[0] && cy[m-1] == cy[0])
+      m--;
+   if (m < 3 || zt == zb)
+      return 0;
+
+   /* counter-clockwise ring */
+   a = 0.0;
+   for (i=1; i<m-1; i++)
+      a += (cx[i] - cx[0]) * (cy[i+1] - cy[0]) - (cx[i+1] - cx[0]) * (cy[i] - cy[0]);
+   if (a == 0.0)
+      return 0;
+   if (a < 0.0) {
+      for (i=0, j=m-1; i<j; i++, j--) {
+	 t = cx[i]; cx[i] = cx[j]; cx[j] = t;
+	 t = cy[i]; cy[i] = cy[j]; cy[j] = t;
+      }
+   }
+   if (zt < zb) {
+      t = zb; zb = zt; zt = t;
+   }
+
+   /* unique vertices */
+   for (i=0; i<m; i++) {
+      st->vk[i].x = cx[i];
+      st->vk[i].y = cy[i];
+      st->vk[i].i = i;
+   }
+   qsort(st->vk, m, sizeof(vkey_t), cmp_vkey);
+   nu = 0;
+   for (i=0; i<m; i++) {
+      if (i > 0 && (st->vk[i].x != st->vk[i-1].x || st->vk[i].y != st->vk[i-1].y))
+	 nu++;
+      st->uv[st->vk[i].i] = nu;
+   }
+   nu++;
+
+   /* keyhole edges are traversed in both directions */
+   for (i=0; i<m; i++) {
+      j = i + 1 < m ? i + 1 : 0;
+      st->ek[i].a = st->uv[i] < st->uv[j] ? st->uv[i] : st->uv[j];
+      st->ek[i].b = st->uv[i] < st->uv[j] ? st->uv[j] : st->uv[i];
+      st->ek[i].i = i;
+      st->bridge[i] = 0;
+      st->used[i] = 0;
+   }
+   qsort(st->ek, m, sizeof(ekey_t), cmp_ekey);
+   for (i=0; i+1<m; i++) {
+      if (st->ek[i].a == st->ek[i+1].a && st->ek[i].b == st->ek[i+1].b &&
+	  st->uv[st->ek[i].i] != st->uv[st->ek[i+1].i]) {
+	 st->bridge[st->ek[i].i] = 1;
+	 st->bridge[st->ek[i+1].i] = 1;
+	 i++;
+      }
+   }
+
+   /* points and vertices */
+   for (u=0; u<nu; u++)
+      st->vert[u] = 0;
+   for (i=0; i<m; i++) {
+      u = st->uv[i];
+      if (st->vert[u])
+	 continue;
+      st->pb[u] = point(st, cx[i], cy[i], zb);
+      st->vb[u] = begin(st);
+      fprintf(st->fp, "VERTEX_POINT('',#%lu)", ID(st->pb[u]));
+      end(st);
+      st->pt[u] = point(st, cx[i], cy[i], zt);
+      st->vt[u] = begin(st);
+      fprintf(st->fp, "VERTEX_POINT('',#%lu)", ID(st->pt[u]));
+      end(st);
+      st->vert[u] = 1;
+   }
+
+   /* vertical edges */
+   vvec = begin(st);
+   fprintf(st->fp, "VECTOR('',#%lu,", ID(st->dz));
+   put_real(st->fp, zt - zb);
+   fputc(')', st->fp);
+   end(st);
+   for (u=0; u<nu; u++)
+      st->vert[u] = 0;
+   for (i=0; i<m; i++) {
+      if (st->bridge[i])
+	 continue;
+      u = st->uv[i];
+      if (!st->vert[u])
+	 st->vert[u] = edge_curve(st, st->vb[u], st->vt[u], st->pb[u], vvec);
+   }
+
+   /* bottom and top edges */
+   for (u=0; u<nu; u++)
+      st->fout[u] = m;
+   for (i=0; i<m; i++) {
+      if (st->bridge[i])
+	 continue;
+      j = i + 1 < m ? i + 1 : 0;
+      dx = cx[j] - cx[i];
+      dy = cy[j] - cy[i];
+      len = sqrt(dx*dx + dy*dy);
+      dir = direction(st, dx / len, dy / len, 0.0);
+      vec = begin(st);
+      fprintf(st->fp, "VECTOR('',#%lu,", ID(dir));
+      put_real(st->fp, len);
+      fputc(')', st->fp);
+      end(st);
+      st->eb[i] = edge_curve(st, st->vb[st->uv[i]], st->vb[st->uv[j]], st->pb[st->uv[i]], vec);
+      st->et[i] = edge_curve(st, st->vt[st->uv[i]], st->vt[st->uv[j]], st->pt[st->uv[i]], vec);
+      st->edir[i] = dir;
+
+      /* ring edges by start vertex, for the loops */
+      st->fnext[i] = st->fout[st->uv[i]];
+      st->fout[st->uv[i]] = i;
+   }
+
+   /* side walls */
+   nb = 0;
+   for (i=0; i<m; i++) {
+      if (st->bridge[i])
+	 continue;
+      j = i + 1 < m ? i + 1 : 0;
+      dx = cx[j] - cx[i];
+      dy = cy[j] - cy[i];
+      len = sqrt(dx*dx + dy*dy);
+      oe[0] = oriented_edge(st, st->eb[i], 1);
+      oe[1] = oriented_edge(st, st->vert[st->uv[j]], 1);
+      oe[2] = oriented_edge(st, st->et[i], 0);
+      oe[3] = oriented_edge(st, st->vert[st->uv[i]], 0);
+      begin(st);
+      fputs("EDGE_LOOP('',", st->fp);
+      put_list(st->fp, oe, 4);
+      fputc(')', st->fp);
+      end(st);
+      begin(st);
+      fprintf(st->fp, "FACE_OUTER_BOUND('',#%lu,.T.)", ID(st->id - 1));
+      end(st);
+      e = st->id;
+      dir = direction(st, dy / len, -dx / len, 0.0);
+      l = plane(st, st->pb[st->uv[i]], dir, st->edir[i]);
+      st->lbound[nb++] = begin(st);
+      fprintf(st->fp, "ADVANCED_FACE('',(#%lu),#%lu,.T.)", ID(e), ID(l));
+      end(st);
+   }
+
+   /* loops of the caps; keyhole edges separate outer and inner loops */
+   nl = 0;
+   pos = 0;
+   for (e=0; e<m; e++) {
+      if (st->bridge[e] || st->used[e])
+	 continue;
+      st->lstart[nl] = pos;
+      i = e;
+      for (;;) {
+	 st->used[i] = 1;
+	 st->loop[pos++] = i;
+	 j = i + 1 < m ? i + 1 : 0;
+	 if (!st->bridge[j] && !st->used[j])
+	    i = j;
+	 else {
+	    for (i=st->fout[st->uv[j]]; i<m && st->used[i]; i=st->fnext[i])
+	       ;
+	    if (i >= m)
+	       break;
+	 }
+      }
+      nl++;
+   }
+   st->lstart[nl] = pos;
+
+   /* the loop with the largest area is the outer bound */
+   outer = 0;
+   best = -HUGE_VAL;
+   for (l=0; l<nl; l++) {
+      a = 0.0;
+      for (pos=st->lstart[l]; pos<st->lstart[l+1]; pos++) {
+	 i = st->loop[pos];
+	 j = i + 1 < m ? i + 1 : 0;
+	 a += (cx[i] - cx[0]) * (cy[j] - cy[0]) - (cx[j] - cx[0]) * (cy[i] - cy[0]);
+      }
+      if (a > best) {
+	 best = a;
+	 outer = l;
+      }
+   }
+
+   /* caps: top, then bottom with reversed loops */
+   for (j=0; j<2; j++) {
+      size_t first = nb;
+      for (l=0; l<nl; l++) {
+	 size_t ls = st->lstart[l], le = st->lstart[l+1], p0 = st->id + 1;
+	 for (pos=ls; pos<le; pos++) {
+	    if (j == 0)
+	       oriented_edge(st, st->et[st->loop[pos]], 1);
+	    else
+	       oriented_edge(st, st->eb[st->loop[le - 1 - (pos - ls)]], 0);
+	 }
+	 begin(st);
+	 fputs("EDGE_LOOP('',(", st->fp);
+	 for (pos=0; pos<le-ls; pos++)
+	    fprintf(st->fp, pos ? ",#%lu" : "#%lu", ID(p0 + pos));
+	 fputs("))", st->fp);
+	 end(st);
+	 st->lbound[nb++] = begin(st);
+	 fprintf(st->fp, "%s('',#%lu,.T.)", l == outer ? "FACE_OUTER_BOUND" : "FACE_BOUND", ID(st->id - 1));
+	 end(st);
+      }
+      u = st->uv[st->loop[st->lstart[outer]]];
+      if (j == 0)
+	 l = plane(st, st->pt[u], st->dz, st->dx);
+      else
+	 l = plane(st, st->pb[u], st->dmz, st->dx);
+      begin(st);
+      fputs("ADVANCED_FACE('',", st->fp);
+      put_list(st->fp, st->lbound + first, nb - first);
+      fprintf(st->fp, ",#%lu,.T.)", ID(l));
+      end(st);
+      nb = first;
+      st->lbound[nb++] = st->id;
+   }
+
+   shell = begin(st);
+   fputs("CLOSED_SHELL('',", st->fp);
+   put_list(st->fp, st->lbound, nb);
+   fputc(')', st->fp);
+   end(st);
+   begin(st);
+   fputs("MANIFOLD_SOLID_BREP(", st->fp);
+   put_string(st->fp, name);
+   fprintf(st->fp, ",#%lu)", ID(shell));
+   end(st);
+
+   return st->id;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void
+write_header(step_file_t *st, const char *fname, const step_options_t *opt)
+{
+   char stamp[32];
+   time_t now = time(NULL);
+   const char *base;
+
+   strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+   base = strrchr(fname, '/');
+   base = base ? base + 1 : fname;
+
+   fputs("ISO-10303-21;\nHEADER;\n", st->fp);
+   fputs("FILE_DESCRIPTION(('GDSII layout extruded to solids'),'2;1');\n", st->fp);
+   fputs("FILE_NAME(", st->fp);
+   put_string(st->fp, base);
+   fprintf(st->fp, ",'%s',(''),(''),'gdsii-toolbox-146','gds_step_mex','');\n", stamp);
+   if (opt->ap214)
+      fputs("FILE_SCHEMA(('AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }'));\n", st->fp);
+   else
+      fputs("FILE_SCHEMA(('CONFIG_CONTROL_DESIGN'));\n", st->fp);
+   fputs("ENDSEC;\nDATA;\n", st->fp);
+}
+
+
+/* product, units and representation context; returns the context */
+static size_t
+write_context(step_file_t *st, const step_options_t *opt, size_t *pds)
+{
+   const char *product = opt->product ? opt->product : "gds_solids";
+   size_t app, pc, pdc, prod, pdf, pd, len, ang, sol, unc;
+
+   app = begin(st);
+   if (opt->ap214)
+      fputs("APPLICATION_CONTEXT('core data for automotive mechanical design processes')", st->fp);
+   else
+      fputs("APPLICATION_CONTEXT('configuration controlled 3D designs of mechanical parts and assemblies')", st->fp);
+   end(st);
+   begin(st);
+   if (opt->ap214)
+      fprintf(st->fp, "APPLICATION_PROTOCOL_DEFINITION('international standard','automotive_design',2000,#%lu)", ID(app));
+   else
+      fprintf(st->fp, "APPLICATION_PROTOCOL_DEFINITION('international standard','config_control_design',1994,#%lu)", ID(app));
+   end(st);
+   pc = begin(st);
+   fprintf(st->fp, "PRODUCT_CONTEXT('',#%lu,'mechanical')", ID(app));
+   end(st);
+   pdc = begin(st);
+   fprintf(st->fp, "PRODUCT_DEFINITION_CONTEXT('part definition',#%lu,'design')", ID(app));
+   end(st);
+   prod = begin(st);
+   fputs("PRODUCT(", st->fp);
+   put_string(st->fp, product);
+   fputc(',', st->fp);
+   put_string(st->fp, product);
+   fprintf(st->fp, ",'',(#%lu))", ID(pc));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "PRODUCT_RELATED_PRODUCT_CATEGORY('part',$,(#%lu))", ID(prod));
+   end(st);
+   pdf = begin(st);
+   fprintf(st->fp, "PRODUCT_DEFINITION_FORMATION('','',#%lu)", ID(prod));
+   end(st);
+   pd = begin(st);
+   fprintf(st->fp, "PRODUCT_DEFINITION('design','',#%lu,#%lu)", ID(pdf), ID(pdc));
+   end(st);
+   *pds = begin(st);
+   fprintf(st->fp, "PRODUCT_DEFINITION_SHAPE('','',#%lu)", ID(pd));
+   end(st);
+
+   len = begin(st);
+   fputs("(LENGTH_UNIT()NAMED_UNIT(*)SI_UNIT(.MILLI.,.METRE.))", st->fp);
+   end(st);
+   ang = begin(st);
+   fputs("(NAMED_UNIT(*)PLANE_ANGLE_UNIT()SI_UNIT($,.RADIAN.))", st->fp);
+   end(st);
+   sol = begin(st);
+   fputs("(NAMED_UNIT(*)SI_UNIT($,.STERADIAN.)SOLID_ANGLE_UNIT())", st->fp);
+   end(st);
+   unc = begin(st);
+   fputs("UNCERTAINTY_MEASURE_WITH_UNIT(LENGTH_MEASURE(", st->fp);
+   put_real(st->fp, opt->tolerance > 0.0 ? opt->tolerance : 1e-6);
+   fprintf(st->fp, "),#%lu,'distance_accuracy_value','confusion accuracy')", ID(len));
+   end(st);
+   begin(st);
+   fprintf(st->fp, "(GEOMETRIC_REPRESENTATION_CONTEXT(3)"
+	   "GLOBAL_UNCERTAINTY_ASSIGNED_CONTEXT((#%lu))"
+	   "GLOBAL_UNIT_ASSIGNED_CONTEXT((#%lu,#%lu,#%lu))"
+	   "REPRESENTATION_CONTEXT('',''))", ID(unc), ID(len), ID(ang), ID(sol));
+   end(st);
+
+   return st->id;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static char *
+copy_string(const char *s)
+{
+   char *c;
+
+   if (s == NULL)
+      s = "";
+   c = malloc(strlen(s) + 1);
+   if (c)
+      strcpy(c, s);
+   return c;
+}
+
+
+/* releases a STEP file state */
+static void
+free_file(step_file_t *st)
+{
+   size_t g;
+
+   free_work(st);
+   free(st->solid);
+   free(st->styled);
+   free(st->style);
+   free(st->rgb);
+   if (st->gname) {
+      for (g=0; g<st->ngroup; g++)
+	 free(st->gname[g]);
+      free(st->gname);
+   }
+   free(st->fname);
+   free(st);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+step_file_t *
+step_open(const char *fname, const step_options_t *opt, int *err)
+{
+   step_file_t *st;
+   size_t g, origin;
+
+   *err = 0;
+   st = calloc(1, sizeof(step_file_t));
+   if (st == NULL) {
+      *err = STEP_ERR_MEMORY;
+      return NULL;
+   }
+
+   /* names and colors are used until the file is closed */
+   st->fname = copy_string(fname);
+   if (st->fname == NULL)
+      goto nomem;
+   st->ngroup = opt->ngroup;
+   if (opt->gname && opt->ngroup) {
+      st->gname = calloc(opt->ngroup, sizeof(char *));
+      if (st->gname == NULL)
+	 goto nomem;
+      for (g=0; g<opt->ngroup; g++)
+	 if ((st->gname[g] = copy_string(opt->gname[g])) == NULL)
+	    goto nomem;
+   }
+   st->colors = opt->ap214 && opt->rgb && opt->ngroup;
+   if (st->colors) {
+      st->rgb = malloc(3 * opt->ngroup * sizeof(double));
+      st->style = calloc(opt->ngroup, sizeof(size_t));
+      if (st->rgb == NULL || st->style == NULL)
+	 goto nomem;
+      memcpy(st->rgb, opt->rgb, 3 * opt->ngroup * sizeof(double));
+   }
+
+   st->fp = fopen(fname, "wb");
+   if (st->fp == NULL) {
+      free_file(st);
+      *err = STEP_ERR_OPEN;
+      return NULL;
+   }
+   setvbuf(st->fp, NULL, _IOFBF, STEP_BUFSIZE);
+
+   write_header(st, fname, opt);
+   st->ctx = write_context(st, opt, &st->pds);
+   origin = point(st, 0.0, 0.0, 0.0);
+   st->dz = direction(st, 0.0, 0.0, 1.0);
+   st->dmz = direction(st, 0.0, 0.0, -1.0);
+   st->dx = direction(st, 1.0, 0.0, 0.0);
+   st->axis = begin(st);
+   fprintf(st->fp, "AXIS2_PLACEMENT_3D('',#%lu,#%lu,#%lu)", ID(origin), ID(st->dz), ID(st->dx));
+   end(st);
+   if (ferror(st->fp))
+      st->err = STEP_ERR_WRITE;
+
+   return st;
+
+ nomem:
+   free_file(st);
+   *err = STEP_ERR_MEMORY;
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+step_append_prisms(step_file_t *st, const prisms_t *pr, const uint32_t *group)
+{
+   size_t k, n, g, solid, style;
+   const char *name;
+
+   if (st->err)
+      return st->err;
+   if (group) {
+      for (k=0; k<pr->npoly; k++)
+	 if (group[k] >= st->ngroup)
+	    return STEP_ERR_GROUP;
+   }
+
+   for (k=0; k<pr->npoly && !st->err; k++) {
+      n = pr->off[k+1] - pr->off[k];
+      if (n < 3)
+	 continue;
+      if ((st->err = grow_work(st, n)))
+	 break;
+
+      g = group ? group[k] : 0;
+      name = group && st->gname ? st->gname[g] : NULL;
+      solid = prism(st, pr, k, name);
+      if (solid == 0)
+	 continue;
+      st->err = append(&st->solid, &st->nsolid, &st->capsolid, solid);
+
+      if (!st->err && st->colors && group) {
+	 style = group_style(st, st->rgb, st->ngroup, g);
+	 begin(st);
+	 fprintf(st->fp, "STYLED_ITEM('color',(#%lu),#%lu)", ID(style), ID(solid));
+	 end(st);
+	 st->err = append(&st->styled, &st->nstyled, &st->capstyled, st->id);
+      }
+      if (!st->err && ferror(st->fp))
+	 st->err = STEP_ERR_WRITE;
+   }
+
+   return st->err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+step_close(step_file_t *st, size_t *nsolid)
+{
+   size_t k, rep;
+   int err = st->err;
+
+   *nsolid = 0;
+
+   /* shape representation of all solids */
+   if (!err) {
+      rep = begin(st);
+      fprintf(st->fp, "ADVANCED_BREP_SHAPE_REPRESENTATION('',(#%lu", ID(st->axis));
+      for (k=0; k<st->nsolid; k++)
+	 fprintf(st->fp, ",#%lu", ID(st->solid[k]));
+      fprintf(st->fp, "),#%lu)", ID(st->ctx));
+      end(st);
+      begin(st);
+      fprintf(st->fp, "SHAPE_DEFINITION_REPRESENTATION(#%lu,#%lu)", ID(st->pds), ID(rep));
+      end(st);
+      if (st->nstyled) {
+	 begin(st);
+	 fputs("MECHANICAL_DESIGN_GEOMETRIC_PRESENTATION_REPRESENTATION('',", st->fp);
+	 put_list(st->fp, st->styled, st->nstyled);
+	 fprintf(st->fp, ",#%lu)", ID(st->ctx));
+	 end(st);
+      }
+      fputs("ENDSEC;\nEND-ISO-10303-21;\n", st->fp);
+      if (ferror(st->fp))
+	 err = STEP_ERR_WRITE;
+   }
+
+   if (fclose(st->fp) && !err)
+      err = STEP_ERR_WRITE;
+   if (err)
+      remove(st->fname);
+   else
+      *nsolid = st->nsolid;
+
+   free_file(st);
+   return err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+step_write_prisms(const char *fname, const prisms_t *pr,
+                  const step_options_t *opt, size_t *nsolid)
+{
+   step_file_t *st;
+   size_t k;
+   int err;
+
+   *nsolid = 0;
+   if (opt->group) {
+      for (k=0; k<pr->npoly; k++)
+	 if (opt->group[k] >= opt->ngroup)
+	    return STEP_ERR_GROUP;
+   }
+
+   st = step_open(fname, opt, &err);
+   if (st == NULL)
+      return err;
+   step_append_prisms(st, pr, opt->group);
+   return step_close(st, nsolid);
+}
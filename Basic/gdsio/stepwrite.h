@@ -0,0 +1,95 @@
+/*
+ * Output of extruded GDSII polygons as STEP (ISO 10303-21) files.
+ *
+ * Every polygon becomes a prism, a MANIFOLD_SOLID_BREP of planar
+ * ADVANCED_FACEs: a bottom and a top cap and one side wall per edge.
+ * Caps and walls share their vertices and edges. Repeated vertices
+ * and the closing vertex are dropped, and keyhole polygons, whose
+ * holes are cut into the outer polygon along an edge traversed in
+ * both directions, are written as caps with inner bounds and without
+ * walls along the keyhole edges. The polygons are passed as in
+ * stlwrite.h.
+ *
+ * The entities are written while the prisms are generated, only the
+ * entity numbers of the solids are kept until the shape
+ * representation is written at the end. Lengths are in millimetres
+ * after scaling. Files use the AP203 (config_control_design) or the
+ * AP214 (automotive_design) schema; with AP214, solids can be named
+ * and colored by group, e.g. by layer.
+ *
+ * A file can also be written in parts, e.g. tile by tile, by opening
+ * it, appending any number of prism sets and closing it. Only the
+ * entity numbers of the solids are kept between the parts.
+ *
+ * The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _STEPWRITE_H
+#define _STEPWRITE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stlwrite.h"
+
+
+/* options of a STEP file */
+typedef struct {
+   int ap214;             /* 1 for AP214, 0 for AP203 */
+   double tolerance;      /* length uncertainty */
+   const char *product;   /* product name, can be NULL */
+   const uint32_t *group; /* group of each polygon (zero-based) or NULL */
+   size_t ngroup;
+   const char *const *gname;  /* group names (solid names) or NULL */
+   const double *rgb;     /* ngroup x 3 column-major colors 0..1 or NULL;
+                             only used with AP214 */
+} step_options_t;
+
+
+/* error codes */
+#define STEP_ERR_OPEN   -1
+#define STEP_ERR_WRITE  -2
+#define STEP_ERR_MEMORY -3
+#define STEP_ERR_GROUP  -4  /* group number out of range */
+
+
+/* state of a STEP file written in parts */
+typedef struct step_file step_file_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * writes the prisms of the polygons to a STEP file. The number of
+ * solids written is returned in nsolid; degenerate polygons have no
+ * solid. Returns 0 on success or a negative error code.
+ */
+int step_write_prisms(const char *fname, const prisms_t *pr,
+                      const step_options_t *opt, size_t *nsolid);
+
+/*
+ * opens a STEP file and writes the header and the context. The group
+ * member of the options is not used; names and colors are copied.
+ * Returns NULL and an error code in err on failure.
+ */
+step_file_t *step_open(const char *fname, const step_options_t *opt, int *err);
+
+/*
+ * appends the prisms of the polygons to an open STEP file. group has
+ * the group of each polygon (zero-based) or is NULL. Returns 0 on
+ * success or a negative error code; after a write error all further
+ * calls fail and the file is removed when it is closed.
+ */
+int step_append_prisms(step_file_t *st, const prisms_t *pr, const uint32_t *group);
+
+/*
+ * writes the shape representation, closes the file and frees the
+ * state. The number of solids in the file is returned in nsolid.
+ * Returns 0 on success or a negative error code.
+ */
+int step_close(step_file_t *st, size_t *nsolid);
+
+#endif /* _STEPWRITE_H */
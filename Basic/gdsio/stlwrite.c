@@ -0,0 +1,555 @@
+/*
+ * Extrusion of polygons and binary STL output (see stlwrite.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#if !defined _WIN32 && !defined _POSIX_C_SOURCE
+   #define _POSIX_C_SOURCE 200112L   /* for sysconf */
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stlwrite.h"
+#include "triangulate.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+
+/* blocks with fewer vertices are processed by one thread */
+#define STL_MIN_PARALLEL  8192
+
+/* size of the stdio buffer of the STL file */
+#define STL_BUFSIZE  (1 << 20)
+
+
+/*
+ * a range of polygons processed by one thread; the output is either
+ * STL facets or vertex triples and faces of an indexed mesh
+ */
+typedef struct {
+   const prisms_t *pr;
+   size_t first, last;    /* polygons first ... last-1 */
+   int mesh;              /* 1 for an indexed mesh */
+   unsigned char *facets; /* STL facets */
+   size_t nfacet;
+   double *vert;          /* x,y,z triples */
+   size_t nvert;
+   uint32_t *face;        /* zero-based vertex indices */
+   size_t nface;
+   int err;
+} stl_job_t;
+
+
+/*-----------------------------------------------------------------*/
+
+/* stores a float in little endian byte order */
+static unsigned char *
+put_float(unsigned char *p, double v)
+{
+   float f = (float)v;
+   uint32_t u;
+
+   memcpy(&u, &f, sizeof(u));
+   p[0] = (unsigned char)(u & 0xff);
+   p[1] = (unsigned char)((u >> 8) & 0xff);
+   p[2] = (unsigned char)((u >> 16) & 0xff);
+   p[3] = (unsigned char)((u >> 24) & 0xff);
+   return p + 4;
+}
+
+
+/* stores an unsigned integer in little endian byte order */
+static void
+put_uint32(unsigned char *p, uint32_t u)
+{
+   p[0] = (unsigned char)(u & 0xff);
+   p[1] = (unsigned char)((u >> 8) & 0xff);
+   p[2] = (unsigned char)((u >> 16) & 0xff);
+   p[3] = (unsigned char)((u >> 24) & 0xff);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * appends the facet with corners a, b, c of a prism with vertices
+ * vx, vy, vz
+ */
+static void
+add_facet(stl_job_t *job, const double *vx, const double *vy, const double *vz,
+          size_t a, size_t b, size_t c)
+{
+   unsigned char *p = job->facets + job->nfacet * STL_FACET_BYTES;
+   double ux, uy, uz, wx, wy, wz, nx, ny, nz, len;
+
+   ux = vx[b] - vx[a]; uy = vy[b] - vy[a]; uz = vz[b] - vz[a];
+   wx = vx[c] - vx[a]; wy = vy[c] - vy[a]; wz = vz[c] - vz[a];
+   nx = uy * wz - uz * wy;
+   ny = uz * wx - ux * wz;
+   nz = ux * wy - uy * wx;
+   len = sqrt(nx*nx + ny*ny + nz*nz);
+   if (len > 0.0) {
+      nx /= len; ny /= len; nz /= len;
+   }
+   else {
+      nx = 0.0; ny = 0.0; nz = 1.0;  /* degenerate facet */
+   }
+
+   p = put_float(p, nx);
+   p = put_float(p, ny);
+   p = put_float(p, nz);
+   p = put_float(p, vx[a]); p = put_float(p, vy[a]); p = put_float(p, vz[a]);
+   p = put_float(p, vx[b]); p = put_float(p, vy[b]); p = put_float(p, vz[b]);
+   p = put_float(p, vx[c]); p = put_float(p, vy[c]); p = put_float(p, vz[c]);
+   p[0] = p[1] = 0;      /* attribute byte count */
+
+   job->nfacet++;
+}
+
+
+/* appends a triangle of the prism whose bottom ring starts at vertex base */
+static void
+add_triangle(stl_job_t *job, const double *vx, const double *vy, const double *vz,
+             size_t base, size_t a, size_t b, size_t c)
+{
+   uint32_t *f;
+
+   if (job->mesh) {
+      f = job->face + 3 * job->nface++;
+      f[0] = (uint32_t)(base + a);
+      f[1] = (uint32_t)(base + b);
+      f[2] = (uint32_t)(base + c);
+   }
+   else
+      add_facet(job, vx, vy, vz, a, b, c);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * extrudes polygon k. cx, cy, cz have room for 2n vertices, work and
+ * tri are the triangulation arrays for n vertices.
+ */
+static void
+prism(stl_job_t *job, size_t k, double *cx, double *cy, double *cz,
+      size_t *work, uint32_t *tri)
+{
+   const prisms_t *pr = job->pr;
+   const double *x = pr->x + pr->off[k];
+   const double *y = pr->y + pr->off[k];
+   size_t n = pr->off[k+1] - pr->off[k];
+   size_t m, i, j, t, nt, base = 0;
+   double a;
+
+   /* distinct vertices */
+   m = 0;
+   for (i=0; i<n; i++) {
+      if (m > 0 && x[i] == cx[m-1] && y[i] == cy[m-1])
+	 continue;
+      cx[m] = x[i];
+      cy[m] = y[i];
+      m++;
+   }
+   while (m > 1 && cx[m-1] == cx[0] && cy[m-1] == cy[0])
+      m--;
+   if (m < 3)
+      return;
+
+   /* orientation, relative to the first vertex */
+   a = 0.0;
+   for (i=1; i<m-1; i++)
+      a += (cx[i] - cx[0]) * (cy[i+1] - cy[0]) - (cx[i+1] - cx[0]) * (cy[i] - cy[0]);
+   if (a == 0.0)
+      return;
+
+   nt = triangulate(cx, cy, m, 1, work, tri);
+
+   /* bottom ring, then top ring */
+   for (i=0; i<m; i++) {
+      cx[i] *= pr->scale;
+      cy[i] *= pr->scale;
+      cx[m+i] = cx[i];
+      cy[m+i] = cy[i];
+      cz[i] = pr->zb[k] * pr->scale;
+      cz[m+i] = pr->zt[k] * pr->scale;
+   }
+
+   if (job->mesh) {
+      base = job->nvert;
+      for (i=0; i<2*m; i++) {
+	 job->vert[3*(base+i)] = cx[i];
+	 job->vert[3*(base+i)+1] = cy[i];
+	 job->vert[3*(base+i)+2] = cz[i];
+      }
+      job->nvert += 2*m;
+   }
+
+   /* caps; the triangles are counter-clockwise */
+   for (t=0; t<nt; t++) {
+      add_triangle(job, cx, cy, cz, base, m+tri[3*t], m+tri[3*t+1], m+tri[3*t+2]);
+      add_triangle(job, cx, cy, cz, base, tri[3*t], tri[3*t+2], tri[3*t+1]);
+   }
+
+   /* side walls */
+   for (i=0; i<m; i++) {
+      j = i + 1 < m ? i + 1 : 0;
+      if (a > 0.0) {
+	 add_triangle(job, cx, cy, cz, base, i, j, m+j);
+	 add_triangle(job, cx, cy, cz, base, i, m+j, m+i);
+      }
+      else {
+	 add_triangle(job, cx, cy, cz, base, j, i, m+i);
+	 add_triangle(job, cx, cy, cz, base, j, m+i, m+j);
+      }
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void *
+stl_worker(void *arg)
+{
+   stl_job_t *job = (stl_job_t *)arg;
+   const size_t *off = job->pr->off;
+   size_t k, n, nmax = 0, ntot = 0;
+   double *cx = NULL, *cy = NULL, *cz = NULL;
+   size_t *work = NULL;
+   uint32_t *tri = NULL;
+
+   for (k=job->first; k<job->last; k++) {
+      n = off[k+1] - off[k];
+      ntot += n;
+      if (n > nmax)
+	 nmax = n;
+   }
+   if (nmax < 3)
+      return NULL;
+
+   /* a prism has at most 2n vertices and 4n-4 triangles */
+   cx = malloc(2 * nmax * sizeof(double));
+   cy = malloc(2 * nmax * sizeof(double));
+   cz = malloc(2 * nmax * sizeof(double));
+   work = malloc(TRI_WORK(nmax) * sizeof(size_t));
+   tri = malloc(3 * TRI_MAX(nmax) * sizeof(uint32_t));
+   if (job->mesh) {
+      job->vert = malloc(3 * 2 * ntot * sizeof(double));
+      job->face = malloc(3 * 4 * ntot * sizeof(uint32_t));
+   }
+   else
+      job->facets = malloc(4 * ntot * STL_FACET_BYTES);
+
+   if (!cx || !cy || !cz || !work || !tri ||
+       (job->mesh ? (!job->vert || !job->face) : !job->facets)) {
+      job->err = STL_ERR_MEMORY;
+      goto done;
+   }
+
+   for (k=job->first; k<job->last; k++)
+      if (off[k+1] - off[k] >= 3)
+	 prism(job, k, cx, cy, cz, work, tri);
+
+ done:
+   free(cx);
+   free(cy);
+   free(cz);
+   free(work);
+   free(tri);
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+num_processors(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+
+/*
+ * splits polygons first ... last-1 into ranges with similar vertex
+ * numbers and processes them. Returns the number of jobs.
+ */
+static int
+run_jobs(const prisms_t *pr, size_t first, size_t last, int mesh,
+         int nthreads, stl_job_t *job)
+{
+   const size_t *off = pr->off;
+   size_t k, nvert, share;
+   int nt;
+#if defined HAVE_PTHREADS
+   int t;
+   pthread_t tid[MAXTHREADS];
+   int started[MAXTHREADS];
+#endif
+
+   nvert = off[last] - off[first];
+   if (nthreads < 1)
+      nthreads = num_processors();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+   if (nvert < STL_MIN_PARALLEL || last - first < 2)
+      nthreads = 1;
+#if !defined HAVE_PTHREADS
+   nthreads = 1;
+#endif
+
+   share = (nvert + nthreads - 1) / nthreads;
+   nt = 0;
+   k = first;
+   do {
+      memset(&job[nt], 0, sizeof(stl_job_t));
+      job[nt].pr = pr;
+      job[nt].mesh = mesh;
+      job[nt].first = k;
+      if (nt == nthreads - 1)
+	 k = last;
+      else
+	 while (k < last && off[k] - off[job[nt].first] < share)
+	    k++;
+      job[nt++].last = k;
+   } while (k < last && nt < nthreads);
+
+   if (nt == 1) {
+      stl_worker(&job[0]);
+      return 1;
+   }
+
+#if defined HAVE_PTHREADS
+   /* the calling thread takes the first range */
+   for (t=1; t<nt; t++)
+      started[t] = !pthread_create(&tid[t], NULL, stl_worker, &job[t]);
+   stl_worker(&job[0]);
+   for (t=1; t<nt; t++) {
+      if (started[t])
+	 pthread_join(tid[t], NULL);
+      else
+	 stl_worker(&job[t]);
+   }
+#endif
+
+   return nt;
+}
+
+
+/* releases the output of jobs */
+static void
+free_jobs(stl_job_t *job, int nt)
+{
+   int t;
+
+   for (t=0; t<nt; t++) {
+      free(job[t].facets);
+      free(job[t].vert);
+      free(job[t].face);
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+stl_open(stl_file_t *sf, const char *fname, const char *header,
+         int nthreads)
+{
+   unsigned char head[84];
+
+   memset(sf, 0, sizeof(stl_file_t));
+   sf->nthreads = nthreads;
+
+   sf->fname = malloc(strlen(fname) + 1);
+   if (sf->fname == NULL)
+      return STL_ERR_MEMORY;
+   strcpy(sf->fname, fname);
+
+   sf->fp = fopen(fname, "wb");
+   if (sf->fp == NULL) {
+      free(sf->fname);
+      sf->fname = NULL;
+      return STL_ERR_OPEN;
+   }
+   setvbuf(sf->fp, NULL, _IOFBF, STL_BUFSIZE);
+
+   /* header and facet count, which is written at the end */
+   memset(head, ' ', 80);
+   if (header)
+      memcpy(head, header, strlen(header) < 80 ? strlen(header) : 80);
+   put_uint32(head + 80, 0);
+   if (fwrite(head, 1, 84, sf->fp) != 84)
+      sf->err = STL_ERR_WRITE;
+
+   return sf->err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+stl_append_prisms(stl_file_t *sf, const prisms_t *pr)
+{
+   stl_job_t job[MAXTHREADS];
+   size_t first, last, nv;
+   int t, nt;
+
+   last = 0;
+   while (!sf->err && last < pr->npoly) {
+
+      /* next block */
+      first = last;
+      nv = 0;
+      while (last < pr->npoly && nv < STL_BLOCK_VERTICES) {
+	 nv += pr->off[last+1] - pr->off[last];
+	 last++;
+      }
+
+      nt = run_jobs(pr, first, last, 0, sf->nthreads, job);
+      for (t=0; t<nt && !sf->err; t++) {
+	 if (job[t].err)
+	    sf->err = job[t].err;
+	 else if (job[t].nfacet &&
+		  fwrite(job[t].facets, STL_FACET_BYTES, job[t].nfacet, sf->fp) != job[t].nfacet)
+	    sf->err = STL_ERR_WRITE;
+	 sf->nfacet += job[t].nfacet;
+      }
+      free_jobs(job, nt);
+
+      if (sf->nfacet > 0xffffffffUL)
+	 sf->err = STL_ERR_COUNT;
+   }
+
+   return sf->err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+stl_close(stl_file_t *sf, size_t *nfacet)
+{
+   unsigned char head[4];
+   int err = sf->err;
+
+   *nfacet = 0;
+   if (!err) {
+      put_uint32(head, (uint32_t)sf->nfacet);
+      if (fseek(sf->fp, 80, SEEK_SET) || fwrite(head, 1, 4, sf->fp) != 4)
+	 err = STL_ERR_WRITE;
+   }
+   if (fclose(sf->fp) && !err)
+      err = STL_ERR_WRITE;
+   if (err)
+      remove(sf->fname);
+   else
+      *nfacet = sf->nfacet;
+
+   free(sf->fname);
+   sf->fname = NULL;
+   sf->fp = NULL;
+   return err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+stl_write_prisms(const char *fname, const char *header,
+                 const prisms_t *pr, int nthreads, size_t *nfacet)
+{
+   stl_file_t sf;
+   int err;
+
+   *nfacet = 0;
+   if ((err = stl_open(&sf, fname, header, nthreads))) {
+      if (sf.fp)
+	 stl_close(&sf, nfacet);
+      return err;
+   }
+   stl_append_prisms(&sf, pr);
+   return stl_close(&sf, nfacet);
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+prism_mesh(const prisms_t *pr, int nthreads, prism_mesh_t *mesh)
+{
+   stl_job_t job[MAXTHREADS];
+   size_t k, v, f, nvert = 0, nface = 0;
+   int t, nt;
+
+   memset(mesh, 0, sizeof(prism_mesh_t));
+   if (pr->npoly == 0)
+      return 0;
+
+   nt = run_jobs(pr, 0, pr->npoly, 1, nthreads, job);
+   for (t=0; t<nt; t++) {
+      if (job[t].err) {
+	 free_jobs(job, nt);
+	 return job[t].err;
+      }
+      nvert += job[t].nvert;
+      nface += job[t].nface;
+   }
+   if (nvert > 0xffffffffUL) {
+      free_jobs(job, nt);
+      return STL_ERR_COUNT;
+   }
+
+   mesh->vert = malloc((nvert ? 3 * nvert : 1) * sizeof(double));
+   mesh->face = malloc((nface ? 3 * nface : 1) * sizeof(uint32_t));
+   if (!mesh->vert || !mesh->face) {
+      free_jobs(job, nt);
+      prism_mesh_free(mesh);
+      return STL_ERR_MEMORY;
+   }
+
+   /* concatenate the jobs; vertices are stored column-major */
+   v = f = 0;
+   for (t=0; t<nt; t++) {
+      for (k=0; k<job[t].nvert; k++) {
+	 mesh->vert[v+k] = job[t].vert[3*k];
+	 mesh->vert[nvert+v+k] = job[t].vert[3*k+1];
+	 mesh->vert[2*nvert+v+k] = job[t].vert[3*k+2];
+      }
+      for (k=0; k<3*job[t].nface; k++)
+	 mesh->face[3*f+k] = job[t].face[k] + (uint32_t)v;
+      v += job[t].nvert;
+      f += job[t].nface;
+   }
+   free_jobs(job, nt);
+
+   mesh->nvert = nvert;
+   mesh->nface = nface;
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+prism_mesh_free(prism_mesh_t *mesh)
+{
+   free(mesh->vert);
+   free(mesh->face);
+   mesh->vert = NULL;
+   mesh->face = NULL;
+   mesh->nvert = 0;
+   mesh->nface = 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Extrusion of GDSII polygons into prisms and output of the prisms
+ * as binary STL files.
+ *
+ * The polygons are passed in one packed buffer with separate x and y
+ * arrays (the column-major layout of a V x 2 MATLAB matrix), as in
+ * polystats.h. Polygon k has the vertices x[off[k]] ... x[off[k+1]-1]
+ * and extends from z = zb[k] to z = zt[k]. Repeated vertices and the
+ * closing vertex are dropped. The caps are triangulated by ear
+ * clipping (triangulate.h), so keyhole polygons are supported; the
+ * side walls are two triangles per edge. All facets face outwards
+ * for both polygon orientations.
+ *
+ * The prism of a polygon with m distinct vertices has 2m vertices:
+ * the bottom ring followed by the top ring. Binary STL repeats the
+ * vertices in every facet; prism_mesh returns the shared vertices
+ * and the faces that index them instead.
+ *
+ * Polygons are processed in blocks of STL_BLOCK_VERTICES vertices;
+ * the polygons of a block are split among threads and the facets of
+ * a block are written in one call, so that the memory used does not
+ * depend on the number of polygons. Files can also be written in
+ * parts with stl_open, stl_append_prisms and stl_close, e.g. one
+ * part for each tile of a layout.
+ *
+ * The functions do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _STLWRITE_H
+#define _STLWRITE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+
+/* polygons extruded between z levels */
+typedef struct {
+   const double *x, *y;   /* packed vertices */
+   const size_t *off;     /* npoly+1 vertex offsets */
+   const double *zb;      /* bottom of each polygon */
+   const double *zt;      /* top of each polygon */
+   size_t npoly;
+   double scale;          /* applied to all coordinates */
+} prisms_t;
+
+
+/* indexed mesh of prisms; allocated with malloc */
+typedef struct {
+   double *vert;          /* nvert x 3 column-major */
+   size_t nvert;
+   uint32_t *face;        /* nface x 3 row-major, zero-based */
+   size_t nface;
+} prism_mesh_t;
+
+
+/* binary STL file that is written in parts */
+typedef struct {
+   FILE *fp;
+   char *fname;           /* copy of the file name */
+   size_t nfacet;         /* facets written so far */
+   int nthreads;
+   int err;               /* first error */
+} stl_file_t;
+
+
+/* bytes of a binary STL facet */
+#define STL_FACET_BYTES    50
+
+/* vertices of the polygons processed in one block */
+#define STL_BLOCK_VERTICES (1 << 17)
+
+/* error codes */
+#define STL_ERR_OPEN   -1
+#define STL_ERR_WRITE  -2
+#define STL_ERR_MEMORY -3
+#define STL_ERR_COUNT  -4  /* more than 2^32-1 facets */
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * writes the prisms of the polygons to a binary STL file. header is
+ * copied into the 80 byte file header (can be NULL). nthreads < 1
+ * uses one thread per processor. The number of facets written is
+ * returned in nfacet. Returns 0 on success or a negative error code.
+ */
+int stl_write_prisms(const char *fname, const char *header,
+                     const prisms_t *pr, int nthreads, size_t *nfacet);
+
+/*
+ * creates a binary STL file and writes the header. The facet count
+ * is written by stl_close. Returns 0 on success or a negative error
+ * code.
+ */
+int stl_open(stl_file_t *sf, const char *fname, const char *header,
+             int nthreads);
+
+/*
+ * appends the prisms of the polygons to an STL file. Returns 0 on
+ * success or a negative error code; after an error, no more facets
+ * are written.
+ */
+int stl_append_prisms(stl_file_t *sf, const prisms_t *pr);
+
+/*
+ * writes the facet count and closes an STL file. The number of
+ * facets is returned in nfacet. The file is removed when an error
+ * occurred while it was written. Returns 0 on success or a negative
+ * error code.
+ */
+int stl_close(stl_file_t *sf, size_t *nfacet);
+
+/*
+ * returns the prisms of the polygons as an indexed mesh with the
+ * vertices shared by caps and side walls. The arrays in mesh must
+ * be released with prism_mesh_free. Returns 0 on success or a
+ * negative error code.
+ */
+int prism_mesh(const prisms_t *pr, int nthreads, prism_mesh_t *mesh);
+
+/*
+ * releases the arrays of a mesh
+ */
+void prism_mesh_free(prism_mesh_t *mesh);
+
+#endif /* _STLWRITE_H */
@@ -0,0 +1,189 @@
+/*
+ * Triangulation of GDSII polygons by ear clipping (see triangulate.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include "triangulate.h"
+
+
+/*-----------------------------------------------------------------*/
+
+#define X(i)  x[(i)*stride]
+#define Y(i)  y[(i)*stride]
+
+/* twice the signed area of triangle a, b, c */
+static double
+cross(const double *x, const double *y, size_t stride,
+      size_t a, size_t b, size_t c)
+{
+   return (X(b) - X(a)) * (Y(c) - Y(a)) - (Y(b) - Y(a)) * (X(c) - X(a));
+}
+
+
+/* vertices i and j are at the same position */
+static int
+same(const double *x, const double *y, size_t stride, size_t i, size_t j)
+{
+   return X(i) == X(j) && Y(i) == Y(j);
+}
+
+
+/* appends triangle a, b, c counter-clockwise */
+static size_t
+emit(uint32_t *tri, size_t nt, size_t a, size_t b, size_t c, double s)
+{
+   tri[3*nt] = (uint32_t)a;
+   tri[3*nt+1] = (uint32_t)(s > 0 ? b : c);
+   tri[3*nt+2] = (uint32_t)(s > 0 ? c : b);
+   return nt + 1;
+}
+
+
+/*
+ * returns 1 when vertex b with neighbours a, c is an ear, 0 when it
+ * is not, and -1 when it is collinear with its neighbours. s is the
+ * orientation of the ring.
+ */
+static int
+is_ear(const double *x, const double *y, size_t stride,
+       const size_t *next, size_t a, size_t b, size_t c, double s)
+{
+   double cr = s * cross(x, y, stride, a, b, c);
+   double llx, lly, urx, ury;
+   size_t p;
+
+   if (cr == 0)
+      return -1;
+   if (cr < 0)
+      return 0;
+
+   llx = X(a) < X(b) ? (X(a) < X(c) ? X(a) : X(c)) : (X(b) < X(c) ? X(b) : X(c));
+   lly = Y(a) < Y(b) ? (Y(a) < Y(c) ? Y(a) : Y(c)) : (Y(b) < Y(c) ? Y(b) : Y(c));
+   urx = X(a) > X(b) ? (X(a) > X(c) ? X(a) : X(c)) : (X(b) > X(c) ? X(b) : X(c));
+   ury = Y(a) > Y(b) ? (Y(a) > Y(c) ? Y(a) : Y(c)) : (Y(b) > Y(c) ? Y(b) : Y(c));
+
+   /* no other vertex may lie in the ear; keyhole vertices that
+      coincide with a corner do not count */
+   for (p=next[c]; p!=a; p=next[p]) {
+      if (X(p) < llx || X(p) > urx || Y(p) < lly || Y(p) > ury)
+	 continue;
+      if (same(x, y, stride, p, a) || same(x, y, stride, p, b) ||
+	  same(x, y, stride, p, c))
+	 continue;
+      if (s * cross(x, y, stride, a, b, p) >= 0 &&
+	  s * cross(x, y, stride, b, c, p) >= 0 &&
+	  s * cross(x, y, stride, c, a, p) >= 0)
+	 return 0;
+   }
+   return 1;
+}
+
+
+/* removes vertex b from the ring */
+static void
+unlink_vertex(size_t *next, size_t *prev, size_t b)
+{
+   next[prev[b]] = next[b];
+   prev[next[b]] = prev[b];
+}
+
+
+/*-----------------------------------------------------------------*/
+
+size_t
+triangulate(const double *x, const double *y, size_t nv,
+            size_t stride, size_t *work, uint32_t *tri)
+{
+   size_t *next = work;
+   size_t *prev = work + nv;
+   size_t first, last, b, c, stop, m, nt = 0;
+   double area = 0, s;
+   int reflex = 0, r;
+
+   if (nv < 3)
+      return 0;
+
+   /* ring of distinct vertices without the closing vertex */
+   first = last = 0;
+   m = 1;
+   for (b=1; b<nv; b++) {
+      if (same(x, y, stride, b, last))
+	 continue;
+      next[last] = b;
+      prev[b] = last;
+      last = b;
+      m++;
+   }
+   while (m > 1 && same(x, y, stride, last, first)) {
+      last = prev[last];
+      m--;
+   }
+   if (m < 3)
+      return 0;
+   next[last] = first;
+   prev[first] = last;
+
+   /* orientation */
+   b = first;
+   do {
+      c = next[b];
+      area += X(b) * Y(c) - X(c) * Y(b);
+      b = c;
+   } while (b != first);
+   if (area == 0)
+      return 0;
+   s = area > 0 ? 1 : -1;
+
+   /* convex polygons, e.g. rectangles, are fans */
+   b = first;
+   do {
+      if (s * cross(x, y, stride, prev[b], b, next[b]) < 0)
+	 reflex = 1;
+      b = next[b];
+   } while (!reflex && b != first);
+   if (!reflex) {
+      for (b=next[first]; next[b]!=first; b=next[b]) {
+	 if (cross(x, y, stride, first, b, next[b]) != 0)
+	    nt = emit(tri, nt, first, b, next[b], s);
+      }
+      return nt;
+   }
+
+   /* clip ears until a triangle remains */
+   b = stop = first;
+   while (m > 3) {
+      c = next[b];
+      r = is_ear(x, y, stride, next, prev[b], b, c, s);
+      if (r != 0) {
+	 if (r > 0)
+	    nt = emit(tri, nt, prev[b], b, c, s);
+	 unlink_vertex(next, prev, b);
+	 m--;
+	 b = stop = c;
+	 continue;
+      }
+
+      b = c;
+      if (b == stop) {
+	 /* no ear: the polygon intersects itself. Clip the next
+	    convex vertex, or drop a vertex when there is none. */
+	 do {
+	    if (s * cross(x, y, stride, prev[b], b, next[b]) > 0)
+	       break;
+	    b = next[b];
+	 } while (b != stop);
+	 c = next[b];
+	 if (s * cross(x, y, stride, prev[b], b, c) > 0)
+	    nt = emit(tri, nt, prev[b], b, c, s);
+	 unlink_vertex(next, prev, b);
+	 m--;
+	 b = stop = c;
+      }
+   }
+
+   if (s * cross(x, y, stride, prev[b], b, next[b]) > 0)
+      nt = emit(tri, nt, prev[b], b, next[b], s);
+
+   return nt;
+}
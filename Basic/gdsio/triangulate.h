@@ -0,0 +1,48 @@
+/*
+ * Triangulation of GDSII polygons by ear clipping.
+ *
+ * GDSII boundaries have no holes; a hole is cut into its outer
+ * polygon along a keyhole edge that is traversed twice. The ear
+ * test ignores vertices that coincide with a corner of the ear, so
+ * keyhole polygons are triangulated like polygons with holes.
+ * Repeated vertices, the closing vertex and collinear vertices are
+ * dropped without producing a triangle. Both orientations are
+ * accepted. Self-intersecting polygons are triangulated without
+ * failure but their fill is undefined.
+ *
+ * Coordinates are read as x[k*stride], y[k*stride], which covers
+ * packed x,y pairs (stride 2) as well as separate columns (stride 1).
+ *
+ * The functions do not use the MATLAB API and do not allocate
+ * memory; they are used by the WebAssembly module.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _TRIANGULATE_H
+#define _TRIANGULATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* number of work array entries for a polygon with nv vertices */
+#define TRI_WORK(nv)  (2 * (nv))
+
+/* maximum number of triangles of a polygon with nv vertices */
+#define TRI_MAX(nv)   ((nv) > 2 ? (nv) - 2 : 0)
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * triangulates a polygon with nv vertices. work must have room for
+ * TRI_WORK(nv) entries and tri for 3 * TRI_MAX(nv) vertex indices.
+ * The corners of triangle t are vertices tri[3*t] ... tri[3*t+2]
+ * of the input, counter-clockwise. Returns the number of triangles.
+ */
+size_t triangulate(const double *x, const double *y, size_t nv,
+                   size_t stride, size_t *work, uint32_t *tri);
+
+#endif /* _TRIANGULATE_H */
@@ -0,0 +1,351 @@
+/*
+ * Conversion of vertex coordinates between the big-endian 32-bit
+ * integers stored in GDSII XY records and double precision numbers.
+ * Each function fuses byte swapping, conversion, scaling and
+ * (de)interleaving of the coordinates into a single pass over the
+ * data. Vectorized versions are used on x86 (SSE2, and AVX2 when the
+ * processor supports it), on 64-bit ARM (NEON) and for WebAssembly
+ * (SIMD128, when compiled with -msimd128). Other platforms use the
+ * portable C versions.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _XYCONV_H
+#define _XYCONV_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "byteswap.h"
+
+#if defined __GNUC__ && defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+   #if defined __x86_64__ || (defined __i386__ && defined __SSE2__)
+      #define XY_SSE2
+      #define XY_AVX2
+      #include <immintrin.h>
+   #elif defined __aarch64__
+      #define XY_NEON
+      #include <arm_neon.h>
+   #elif defined __wasm_simd128__
+      #define XY_WASM
+      #include <wasm_simd128.h>
+   #endif
+#endif
+
+
+/* ------------------------------------------------------------------
+ *  Vectorized kernels. They process as many coordinates as fit into
+ *  whole vectors and return the number of values (decode) or vertices
+ *  (encode, deinterleave) done; the rest is left to the C versions.
+ */
+
+#if defined XY_SSE2
+
+/* reverse the bytes in each 32-bit lane */
+static INLINE __m128i
+bswap32_sse2(__m128i v)
+{
+   v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xb1), 0xb1);
+}
+
+static INLINE size_t
+xy_decode_simd(const uint8_t *src, double *dst, size_t n, double scale)
+{
+   __m128i v;
+   __m128d s = _mm_set1_pd(scale);
+   size_t k;
+
+   for (k=0; k+4<=n; k+=4) {
+      v = bswap32_sse2(_mm_loadu_si128((const __m128i *)(src + 4*k)));
+      _mm_storeu_pd(dst+k,   _mm_mul_pd(_mm_cvtepi32_pd(v), s));
+      _mm_storeu_pd(dst+k+2, _mm_mul_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(v, 0xee)), s));
+   }
+
+   return k;
+}
+
+/* floor(0.5 + v*s) with truncation and correction (SSE2 has no floor) */
+static INLINE __m128i
+round_sse2(__m128d v, __m128d s)
+{
+   __m128d t;
+   __m128i i, c;
+
+   t = _mm_add_pd(_mm_mul_pd(v, s), _mm_set1_pd(0.5));
+   i = _mm_cvttpd_epi32(t);
+   c = _mm_castpd_si128(_mm_cmpgt_pd(_mm_cvtepi32_pd(i), t));
+   return _mm_add_epi32(i, _mm_shuffle_epi32(c, 0x08));
+}
+
+static INLINE size_t
+xy_encode_simd(const double *x, const double *y, int32_t *dst, size_t m, double scale)
+{
+   __m128i xi, yi;
+   __m128d s = _mm_set1_pd(scale);
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      xi = round_sse2(_mm_loadu_pd(x+k), s);
+      yi = round_sse2(_mm_loadu_pd(y+k), s);
+      _mm_storeu_si128((__m128i *)(dst + 2*k), bswap32_sse2(_mm_unpacklo_epi32(xi, yi)));
+   }
+
+   return k;
+}
+
+static INLINE size_t
+xy_deinterleave_simd(const double *src, double *x, double *y, size_t m)
+{
+   __m128d a, b;
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      a = _mm_loadu_pd(src + 2*k);
+      b = _mm_loadu_pd(src + 2*k + 2);
+      _mm_storeu_pd(x+k, _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd(y+k, _mm_unpackhi_pd(a, b));
+   }
+
+   return k;
+}
+
+#endif /* XY_SSE2 */
+
+
+#if defined XY_AVX2
+
+__attribute__((target("avx2"))) static INLINE size_t
+xy_decode_avx2(const uint8_t *src, double *dst, size_t n, double scale)
+{
+   __m256i v;
+   __m256d s = _mm256_set1_pd(scale);
+   const __m256i rev = _mm256_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12,
+                                        3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12);
+   size_t k;
+
+   for (k=0; k+8<=n; k+=8) {
+      v = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src + 4*k)), rev);
+      _mm256_storeu_pd(dst+k,   _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), s));
+      _mm256_storeu_pd(dst+k+4, _mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), s));
+   }
+
+   return k;
+}
+
+__attribute__((target("avx2"))) static INLINE size_t
+xy_encode_avx2(const double *x, const double *y, int32_t *dst, size_t m, double scale)
+{
+   __m128i xi, yi;
+   __m256d s = _mm256_set1_pd(scale);
+   __m256d h = _mm256_set1_pd(0.5);
+   const __m128i rev = _mm_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12);
+   size_t k;
+
+   for (k=0; k+4<=m; k+=4) {
+      xi = _mm256_cvtpd_epi32(_mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(x+k), s), h)));
+      yi = _mm256_cvtpd_epi32(_mm256_floor_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(y+k), s), h)));
+      _mm_storeu_si128((__m128i *)(dst + 2*k),     _mm_shuffle_epi8(_mm_unpacklo_epi32(xi, yi), rev));
+      _mm_storeu_si128((__m128i *)(dst + 2*k + 4), _mm_shuffle_epi8(_mm_unpackhi_epi32(xi, yi), rev));
+   }
+
+   return k;
+}
+
+#endif /* XY_AVX2 */
+
+
+#if defined XY_NEON
+
+static INLINE size_t
+xy_decode_simd(const uint8_t *src, double *dst, size_t n, double scale)
+{
+   int32x4_t v;
+   float64x2_t s = vdupq_n_f64(scale);
+   size_t k;
+
+   for (k=0; k+4<=n; k+=4) {
+      v = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8(src + 4*k)));
+      vst1q_f64(dst+k,   vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(v))), s));
+      vst1q_f64(dst+k+2, vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_high_s32(v))), s));
+   }
+
+   return k;
+}
+
+static INLINE size_t
+xy_encode_simd(const double *x, const double *y, int32_t *dst, size_t m, double scale)
+{
+   int32x2x2_t z;
+   int32x2_t xi, yi;
+   float64x2_t s = vdupq_n_f64(scale);
+   float64x2_t h = vdupq_n_f64(0.5);
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      xi = vmovn_s64(vcvtq_s64_f64(vrndmq_f64(vaddq_f64(vmulq_f64(vld1q_f64(x+k), s), h))));
+      yi = vmovn_s64(vcvtq_s64_f64(vrndmq_f64(vaddq_f64(vmulq_f64(vld1q_f64(y+k), s), h))));
+      z = vzip_s32(xi, yi);
+      vst1q_u8((uint8_t *)(dst + 2*k),
+               vrev32q_u8(vreinterpretq_u8_s32(vcombine_s32(z.val[0], z.val[1]))));
+   }
+
+   return k;
+}
+
+static INLINE size_t
+xy_deinterleave_simd(const double *src, double *x, double *y, size_t m)
+{
+   float64x2x2_t v;
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      v = vld2q_f64(src + 2*k);
+      vst1q_f64(x+k, v.val[0]);
+      vst1q_f64(y+k, v.val[1]);
+   }
+
+   return k;
+}
+
+#endif /* XY_NEON */
+
+
+#if defined XY_WASM
+
+#define BSWAP32_WASM(v)  wasm_i8x16_shuffle(v, v, 3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12)
+
+static INLINE size_t
+xy_decode_simd(const uint8_t *src, double *dst, size_t n, double scale)
+{
+   v128_t v;
+   v128_t s = wasm_f64x2_splat(scale);
+   size_t k;
+
+   for (k=0; k+4<=n; k+=4) {
+      v = wasm_v128_load(src + 4*k);
+      v = BSWAP32_WASM(v);
+      wasm_v128_store(dst+k,   wasm_f64x2_mul(wasm_f64x2_convert_low_i32x4(v), s));
+      wasm_v128_store(dst+k+2, wasm_f64x2_mul(wasm_f64x2_convert_low_i32x4(wasm_i32x4_shuffle(v, v, 2,3,0,1)), s));
+   }
+
+   return k;
+}
+
+static INLINE size_t
+xy_encode_simd(const double *x, const double *y, int32_t *dst, size_t m, double scale)
+{
+   v128_t xi, yi, z;
+   v128_t s = wasm_f64x2_splat(scale);
+   v128_t h = wasm_f64x2_splat(0.5);
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      xi = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_floor(wasm_f64x2_add(wasm_f64x2_mul(wasm_v128_load(x+k), s), h)));
+      yi = wasm_i32x4_trunc_sat_f64x2_zero(wasm_f64x2_floor(wasm_f64x2_add(wasm_f64x2_mul(wasm_v128_load(y+k), s), h)));
+      z = wasm_i32x4_shuffle(xi, yi, 0,4,1,5);
+      wasm_v128_store(dst + 2*k, BSWAP32_WASM(z));
+   }
+
+   return k;
+}
+
+static INLINE size_t
+xy_deinterleave_simd(const double *src, double *x, double *y, size_t m)
+{
+   v128_t a, b;
+   size_t k;
+
+   for (k=0; k+2<=m; k+=2) {
+      a = wasm_v128_load(src + 2*k);
+      b = wasm_v128_load(src + 2*k + 2);
+      wasm_v128_store(x+k, wasm_i64x2_shuffle(a, b, 0,2));
+      wasm_v128_store(y+k, wasm_i64x2_shuffle(a, b, 1,3));
+   }
+
+   return k;
+}
+
+#endif /* XY_WASM */
+
+
+/* ------------------------------------------------------------------
+ *  Conversion functions
+ */
+
+/*
+ * convert n big-endian 32-bit integers at src to doubles and
+ * multiply them by scale: dst[k] = scale * src[k]
+ */
+static INLINE void
+xy_decode(const uint8_t *src, double *dst, size_t n, double scale)
+{
+   int32_t v;
+   size_t k = 0;
+
+#if defined XY_AVX2
+   if ( __builtin_cpu_supports("avx2") )
+      k = xy_decode_avx2(src, dst, n, scale);
+   else
+#endif
+#if defined XY_SSE2 || defined XY_NEON || defined XY_WASM
+      k = xy_decode_simd(src, dst, n, scale);
+#endif
+
+   for (src+=4*k; k<n; k++, src+=4) {
+      memcpy(&v, src, sizeof(int32_t));
+      byte_reverse32(&v);
+      dst[k] = (double)v * scale;
+   }
+}
+
+
+/*
+ * scale the m vertices with coordinates x and y, round them to
+ * integers and store them as interleaved big-endian 32-bit integers
+ * in dst: dst[2k] = floor(0.5 + x[k]*scale), dst[2k+1] = ... y[k]
+ */
+static INLINE void
+xy_encode(const double *x, const double *y, int32_t *dst, size_t m, double scale)
+{
+   size_t k = 0;
+
+#if defined XY_AVX2
+   if ( __builtin_cpu_supports("avx2") )
+      k = xy_encode_avx2(x, y, dst, m, scale);
+   else
+#endif
+#if defined XY_SSE2 || defined XY_NEON || defined XY_WASM
+      k = xy_encode_simd(x, y, dst, m, scale);
+#endif
+
+   for (; k<m; k++) {
+      dst[2*k]   = floor(0.5 + x[k] * scale);
+      dst[2*k+1] = floor(0.5 + y[k] * scale);
+      byte_reverse32(&dst[2*k]);
+      byte_reverse32(&dst[2*k+1]);
+   }
+}
+
+
+/*
+ * split m interleaved x,y pairs into x and y coordinates
+ */
+static INLINE void
+xy_deinterleave(const double *src, double *x, double *y, size_t m)
+{
+   size_t k = 0;
+
+#if defined XY_SSE2 || defined XY_NEON || defined XY_WASM
+   k = xy_deinterleave_simd(src, x, y, m);
+#endif
+
+   for (; k<m; k++) {
+      x[k] = src[2*k];
+      y[k] = src[2*k+1];
+   }
+}
+
+#endif /* _XYCONV_H */
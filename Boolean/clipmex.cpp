@@ -0,0 +1,103 @@
+// Conversion of polygons between MATLAB/Octave cell arrays and
+// Clipper paths (see clipmex.hpp)
+//
+// Copyright (c) 2026
+
+#include <stdio.h>
+#include "mex.h"
+#include "clipper.hpp"
+#include "clipmex.hpp"
+
+#define ERR_LEN 128
+
+
+namespace ClipperLib {
+
+//-----------------------------------------------------------------
+
+void
+CellToPaths(const mxArray *pcell, Paths &P, double ud,
+	    const char *fname, const char *aname)
+{
+   mxArray *par;         // ptr to mxArray structure
+   double *pda;          // ptr to polynomial data
+   unsigned int N, vnu;
+   unsigned int k, m;
+   char errmsg[ERR_LEN];
+
+   N = mxGetM(pcell)*mxGetN(pcell);
+   P.resize(N);
+   for (k=0; k<N; k++) {
+
+      // get the next polygon from the cell array
+      par = mxGetCell(pcell, k);     // ptr to mxArray
+      if ( par == NULL || mxIsEmpty(par) ) {
+	 snprintf(errmsg, ERR_LEN, "%s :  empty polygon in %s.", fname, aname);
+	 mexErrMsgTxt(errmsg);
+      }
+      pda = (double*)mxGetData(par); // ptr to a data
+      vnu = mxGetM(par);             // rows = vertex number
+
+      // copy polygon and transpose, scale
+      P[k].resize(vnu);
+      for (m=0; m<vnu; m++) {
+	 P[k][m].X = (cInt)(ud * pda[m]     + 0.5);
+	 P[k][m].Y = (cInt)(ud * pda[m+vnu] + 0.5);
+      }
+
+      // make sure polygons have positive orientation
+      if ( !Orientation(P[k]) )
+	  ReversePath(P[k]);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+mxArray *
+PathsToCell(const Paths &P, double iud)
+{
+   mxArray *pc, *par;
+   double *pda;
+   unsigned int k, m, vnu;
+
+   pc = mxCreateCellMatrix(1, P.size());
+   for (k=0; k<P.size(); k++) {
+
+      // allocate matrix for boundary
+      vnu = P[k].size();
+      par = mxCreateDoubleMatrix(vnu, 2, mxREAL);
+      pda = (double*)mxGetData(par);
+
+      // copy vertex array, transpose, and scale back to user units
+      for (m=0; m<vnu; m++) {
+         pda[m]     = iud * P[k][m].X;
+         pda[vnu+m] = iud * P[k][m].Y;
+      }
+
+      // store in cell array
+      mxSetCell(pc, k, par);
+   }
+
+   return pc;
+}
+
+
+//-----------------------------------------------------------------
+
+mxArray *
+HoleFlags(const Paths &P)
+{
+   mxArray *pf;
+   mxLogical *ph;
+   unsigned int k;
+
+   pf = mxCreateLogicalMatrix(1, P.size());
+   ph = (mxLogical*)mxGetData(pf);
+   for (k=0; k<P.size(); k++)
+      ph[k] = !Orientation(P[k]); // same as input == no hole
+
+   return pf;
+}
+
+} // ClipperLib namespace
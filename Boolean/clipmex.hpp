@@ -0,0 +1,42 @@
+// Conversion of polygons between MATLAB/Octave cell arrays and
+// Clipper paths for the mex functions of the GDS II toolbox
+//
+// Copyright (c) 2026
+
+#ifndef _CLIPMEX_HPP
+#define _CLIPMEX_HPP
+
+#include "mex.h"
+#include "clipper.hpp"
+
+namespace ClipperLib {
+
+//
+// copy the polygons (nx2 matrices) in a cell array to a path
+// vector, scale them to database units, and orient them
+// positively. The paths in P are reused to avoid reallocating
+// vertex storage. Errors are reported with mexErrMsgTxt.
+//
+// pcell :  cell array with polygons
+// P :      output paths
+// ud :     conversion factor user units --> database units
+// fname :  function name for error messages
+// aname :  argument name for error messages
+//
+void CellToPaths(const mxArray *pcell, Paths &P, double ud,
+                 const char *fname, const char *aname);
+
+//
+// returns a cell array with the polygons in P, scaled to user units
+//
+mxArray *PathsToCell(const Paths &P, double iud);
+
+//
+// returns a logical array with flags that are set for polygons
+// that are the interior boundaries of holes
+//
+mxArray *HoleFlags(const Paths &P);
+
+} // ClipperLib namespace
+
+#endif // _CLIPMEX_HPP
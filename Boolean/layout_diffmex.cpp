@@ -0,0 +1,166 @@
+// A mex function for the comparison of two layouts
+// for the GDS II toolbox
+//
+// [D, S] = layout_diffmex(cellsA, namesA, topA, cellsB, namesB, topB, layers, ud, nthreads);
+//
+// cellsA :   cell array with one entry per structure of layout A; each
+//            entry is a cell array with the element data structures of
+//            the structure (as returned by get(gelm) for an element gelm).
+// namesA :   cell array with the structure names of layout A
+// topA :     index of the top structure of layout A
+// cellsB, namesB, topB :
+//            the same for layout B
+// layers :   vector with the layers that are compared; all layers
+//            are compared when it is empty.
+// ud :       conversion factor from user units to database units
+// nthreads : (Optional) number of threads used for the exclusive or.
+//            Default is the number of processors.
+//
+// D :        structure array with one entry for each (layer, data type)
+//            pair on which the layouts differ, with the fields
+//               layer : layer number
+//               dtype : data type
+//               xy    : cell array with the difference polygons
+//               hole  : logical array; true for polygons that are holes
+//               area  : area of the difference in user units^2
+// S :        structure with comparison statistics (see layoutdiff.hpp)
+//
+// Copyright (c) 2026
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "mex.h"
+#include "clipper.hpp"
+#include "clipmex.hpp"
+#include "layoutdiff.hpp"
+#include "flatlib.h"
+
+#define FNAME  "layout_diffmex"
+
+
+//-----------------------------------------------------------------
+
+using namespace ClipperLib;
+
+// declare static to release the memory after errors
+static fl_library_t liba, libb;
+static DiffResult res;
+
+
+//-----------------------------------------------------------------
+
+static void
+failed(const char *msg)
+{
+   char errmsg[256];
+
+   fl_library_free(&liba);
+   fl_library_free(&libb);
+   std::vector<LayerDiff>().swap(res.layers);
+   snprintf(errmsg, sizeof(errmsg), "%s :  %s.", FNAME, msg);
+   mexErrMsgTxt(errmsg);
+}
+
+
+//-----------------------------------------------------------------
+
+static size_t
+top_index(const mxArray *names, const mxArray *top)
+{
+   size_t t = (size_t)mxGetScalar(top);
+
+   if (t < 1 || t > mxGetNumberOfElements(names))
+      mexErrMsgTxt(FNAME " :  invalid top structure index.");
+
+   return t - 1;
+}
+
+
+//-----------------------------------------------------------------
+
+static mxArray *
+scalar(double v)
+{
+   return mxCreateDoubleScalar(v);
+}
+
+
+//-----------------------------------------------------------------
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   const char *dfields[] = {"layer", "dtype", "xy", "hole", "area"};
+   const char *sfields[] = {"ncell", "nsame", "npair", "nskip", "nwin", "nshape"};
+   std::vector<int> lay;
+   const char *msg;
+   double *pd, ud;
+   size_t k, nl, topa, topb;
+   int m, nthreads = 0;
+
+   // check arguments
+   if (nrhs < 8)
+      mexErrMsgTxt(FNAME " :  at least 8 arguments required.");
+   for (m=0; m<2; m++) {
+      if ( !mxIsCell(prhs[3*m]) || !mxIsCell(prhs[3*m+1]) )
+	 mexErrMsgTxt(FNAME " :  cells and names must be cell arrays.");
+      if (mxGetNumberOfElements(prhs[3*m]) != mxGetNumberOfElements(prhs[3*m+1]))
+	 mexErrMsgTxt(FNAME " :  cells and names must have the same length.");
+   }
+   topa = top_index(prhs[1], prhs[2]);
+   topb = top_index(prhs[4], prhs[5]);
+   if ( !mxIsEmpty(prhs[6]) && !mxIsDouble(prhs[6]) )
+      mexErrMsgTxt(FNAME " :  layers must be a vector of layer numbers.");
+   ud = mxGetScalar(prhs[7]);
+   if (ud <= 0.0)
+      mexErrMsgTxt(FNAME " :  unit conversion factor must be positive.");
+   if (nrhs > 8 && !mxIsEmpty(prhs[8]))
+      nthreads = (int)mxGetScalar(prhs[8]);
+
+   nl = mxGetNumberOfElements(prhs[6]);
+   pd = mxGetPr(prhs[6]);
+   for (k=0; k<nl; k++)
+      lay.push_back((int)pd[k]);
+
+   // structure hierarchies
+   if ( (msg = fl_build_library(&liba, prhs[0], prhs[1])) )
+      failed(msg);
+   if ( (msg = fl_build_library(&libb, prhs[3], prhs[4])) )
+      failed(msg);
+
+   // compare
+   if ( (msg = LayoutDiff(&liba, topa, &libb, topb, lay, ud, nthreads, res)) )
+      failed(msg);
+   fl_library_free(&liba);
+   fl_library_free(&libb);
+
+   // return results
+   plhs[0] = mxCreateStructMatrix(res.layers.size(), 1, 5, dfields);
+   for (k=0; k<res.layers.size(); k++) {
+      const LayerDiff &ld = res.layers[k];
+      mxSetFieldByNumber(plhs[0], k, 0, scalar(ld.layer));
+      mxSetFieldByNumber(plhs[0], k, 1, scalar(ld.dtype));
+      mxSetFieldByNumber(plhs[0], k, 2, PathsToCell(ld.poly, 1.0 / ud));
+      mxSetFieldByNumber(plhs[0], k, 3, HoleFlags(ld.poly));
+      mxSetFieldByNumber(plhs[0], k, 4, scalar(ld.area / (ud * ud)));
+   }
+   std::vector<LayerDiff>().swap(res.layers);
+
+   if (nlhs > 1) {
+      plhs[1] = mxCreateStructMatrix(1, 1, 6, sfields);
+      mxSetFieldByNumber(plhs[1], 0, 0, mxCreateDoubleMatrix(1, 2, mxREAL));
+      pd = mxGetPr(mxGetFieldByNumber(plhs[1], 0, 0));
+      pd[0] = res.ncell[0];  pd[1] = res.ncell[1];
+      mxSetFieldByNumber(plhs[1], 0, 1, mxCreateDoubleMatrix(1, 2, mxREAL));
+      pd = mxGetPr(mxGetFieldByNumber(plhs[1], 0, 1));
+      pd[0] = res.nsame[0];  pd[1] = res.nsame[1];
+      mxSetFieldByNumber(plhs[1], 0, 2, scalar(res.npair));
+      mxSetFieldByNumber(plhs[1], 0, 3, scalar(res.nskip));
+      mxSetFieldByNumber(plhs[1], 0, 4, scalar(res.nwin));
+      mxSetFieldByNumber(plhs[1], 0, 5, mxCreateDoubleMatrix(1, 2, mxREAL));
+      pd = mxGetPr(mxGetFieldByNumber(plhs[1], 0, 5));
+      pd[0] = res.nshape[0];  pd[1] = res.nshape[1];
+   }
+}
@@ -0,0 +1,953 @@
+// Hierarchical layout comparison for the GDS II toolbox
+// (see layoutdiff.hpp)
+//
+// Copyright (c) 2026
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "clipper.hpp"
+#include "polytiles.hpp"
+#include "layoutdiff.hpp"
+
+extern "C" {
+#include "pathpoly.h"
+}
+
+#define MAX_DEPTH  1024    // deeper hierarchies are certainly cyclic
+#define MAX_WIN    1048576 // windows of an array; larger arrays get one
+                           // window spanning all instances per difference
+#define NLAYER     65536L
+#define MAX_TILES  32      // tiles in x and y for the exclusive or
+#define TILE_VERT  50000   // approximate number of vertices per tile
+#define WILDCARD   -1      // window key that matches all layers
+
+#define MISSING    0x6d697373696e67ULL   // hash of a missing structure
+
+
+namespace ClipperLib {
+
+//-----------------------------------------------------------------
+
+// hash of an element in a structure
+struct ElHash {
+   uint64_t h;
+   uint32_t idx;         // shape or reference index
+   bool ref;
+   bool operator<(const ElHash &e) const { return h < e.h; }
+};
+
+// hashes of a structure
+struct CellHash {
+   std::vector<ElHash> el;    // sorted element hashes
+   uint64_t h;
+   int state;                 // 0 = new, 1 = in progress, 2 = done
+};
+
+// a window in which the layouts may differ
+struct Window {
+   double b[4];
+   long key;                  // layer + NLAYER * dtype or WILDCARD
+};
+
+// one of the two layouts
+struct Side {
+   fl_library_t *lib;
+   std::vector<CellHash> cell;
+   std::vector<char> used;    // structure is below the top structure
+   std::map<long, Paths> flat; // expanded shapes of each layer key
+   size_t nshape;
+};
+
+// a grid index of the windows
+struct WindowIndex {
+   double x0, y0, dx, dy;
+   int nx, ny;
+   std::vector< std::vector<unsigned int> > bin;
+};
+
+// state of a comparison
+struct Diff {
+   Side s[2];
+   std::vector<char> lsel;    // selected layers
+   double ud;
+   std::map< std::pair<size_t,size_t>, std::vector<Window> > memo;
+   std::vector<Window> win;   // windows in top structure coordinates
+   WindowIndex wi;
+   size_t npair, nskip;
+};
+
+// windows of one layer key for the tile function
+struct TileWindows {
+   std::vector<Path> rect;
+   std::vector<IntRect> box;
+};
+
+
+//-----------------------------------------------------------------
+
+static inline uint64_t
+mix64(uint64_t z)
+{
+   z += 0x9e3779b97f4a7c15ULL;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   return z ^ (z >> 31);
+}
+
+
+//-----------------------------------------------------------------
+
+static inline void
+hash_add(uint64_t &h, uint64_t v)
+{
+   h = mix64(h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+
+//-----------------------------------------------------------------
+
+static inline uint64_t
+quant(double x, double s)
+{
+   return (uint64_t)(int64_t)floor(s * x + 0.5);
+}
+
+
+//-----------------------------------------------------------------
+
+static inline void
+empty_box(double *b)
+{
+   b[0] = b[1] = HUGE_VAL;
+   b[2] = b[3] = -HUGE_VAL;
+}
+
+
+//-----------------------------------------------------------------
+
+static inline void
+add_box(double *b, const double *t)
+{
+   if (t[0] < b[0]) b[0] = t[0];
+   if (t[1] < b[1]) b[1] = t[1];
+   if (t[2] > b[2]) b[2] = t[2];
+   if (t[3] > b[3]) b[3] = t[3];
+}
+
+
+//-----------------------------------------------------------------
+
+static inline bool
+overlaps(const double *a, const double *b)
+{
+   return a[0] <= b[2] && a[2] >= b[0] && a[1] <= b[3] && a[3] >= b[1];
+}
+
+
+//-----------------------------------------------------------------
+
+// bounding box of a transformed bounding box
+static void
+box_transform(double *tb, const double *bb, const affine_t &T)
+{
+   double x, y, u, v;
+   int k;
+
+   empty_box(tb);
+   if (bb[0] > bb[2])
+      return;
+
+   for (k=0; k<4; k++) {
+      x = bb[k & 1 ? 2 : 0];
+      y = bb[k & 2 ? 3 : 1];
+      u = T.a11 * x + T.a12 * y + T.tx;
+      v = T.a21 * x + T.a22 * y + T.ty;
+      if (u < tb[0]) tb[0] = u;
+      if (u > tb[2]) tb[2] = u;
+      if (v < tb[1]) tb[1] = v;
+      if (v > tb[3]) tb[3] = v;
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// transformation of the instance (i,j) of a reference
+static inline void
+instance_transform(affine_t &Ti, const affine_t &T, const fl_ref_t *r, int i, int j)
+{
+   affine_t R = r->T;
+
+   R.tx += i * r->dcol[0] + j * r->drow[0];
+   R.ty += i * r->dcol[1] + j * r->drow[1];
+   affine_compose(&Ti, &T, &R);
+}
+
+
+//-----------------------------------------------------------------
+
+// transforms a vertex list to database units
+static void
+transform_vertices(const double *xy, size_t nv, const affine_t &T, double ud, Path &p)
+{
+   size_t k;
+   double x, y;
+
+   p.resize(nv);
+   for (k=0; k<nv; k++) {
+      x = T.a11 * xy[2*k] + T.a12 * xy[2*k+1] + T.tx;
+      y = T.a21 * xy[2*k] + T.a22 * xy[2*k+1] + T.ty;
+      p[k] = IntPoint((cInt)floor(ud * x + 0.5), (cInt)floor(ud * y + 0.5));
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// appends the transformed, positively oriented polygons of a shape
+static void
+shape_polygons(const fl_cell_t *c, const fl_shape_t *sh, const affine_t &T,
+               double ud, std::vector<double> &buf, Paths &out)
+{
+   Path p;
+   const fl_poly_t *pl;
+   const double *xy;
+   size_t k, m;
+
+   for (k=0; k<sh->npoly; k++) {
+
+      pl = &c->poly[sh->poly + k];
+      xy = c->xy + 2*pl->v;
+
+      if (sh->kind != GDS_PATH) {
+	 transform_vertices(xy, pl->nv, T, ud, p);
+	 if (p.size() < 3)
+	    continue;
+	 if ( !Orientation(p) )
+	    ReversePath(p);
+	 out.push_back(p);
+	 continue;
+      }
+
+      // paths are converted to polygons in the structure coordinates
+      if (sh->hw <= 0.0)
+	 continue;
+      buf.resize(2 * pathpoly_size(xy, xy + 1, pl->nv, 2, sh->ptype));
+      if ( buf.empty() )
+	 continue;
+      m = pathpoly(xy, xy + 1, pl->nv, 2, sh->hw, sh->ptype, sh->ext,
+                   &buf[0], &buf[1], 2);
+      transform_vertices(&buf[0], m, T, ud, p);
+      if ( !Orientation(p) )
+	 ReversePath(p);
+      out.push_back(p);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// true for shapes that take part in the comparison
+static inline bool
+compared(const Diff &df, const fl_shape_t *sh)
+{
+   return sh->kind != GDS_TEXT && sh->kind != GDS_NODE && df.lsel[sh->layer];
+}
+
+
+//-----------------------------------------------------------------
+
+static inline long
+layer_key(const fl_shape_t *sh)
+{
+   return (long)sh->layer + NLAYER * (long)sh->dtype;
+}
+
+
+//-----------------------------------------------------------------
+
+// hash of a shape in database units
+static uint64_t
+shape_hash(const fl_cell_t *c, const fl_shape_t *sh, double ud)
+{
+   const fl_poly_t *pl;
+   const double *xy;
+   uint64_t h = mix64(sh->kind);
+   size_t k, m;
+
+   hash_add(h, layer_key(sh));
+   hash_add(h, sh->ptype);
+   hash_add(h, quant(sh->hw, ud));
+   hash_add(h, quant(sh->ext[0], ud));
+   hash_add(h, quant(sh->ext[1], ud));
+   hash_add(h, sh->npoly);
+   for (k=0; k<sh->npoly; k++) {
+      pl = &c->poly[sh->poly + k];
+      xy = c->xy + 2*pl->v;
+      hash_add(h, pl->nv);
+      for (m=0; m<2*pl->nv; m++)
+	 hash_add(h, quant(xy[m], ud));
+   }
+
+   return h;
+}
+
+
+//-----------------------------------------------------------------
+
+// hash of the placement of a reference, without the referenced structure
+static uint64_t
+placement_hash(const fl_ref_t *r, double ud)
+{
+   uint64_t h = mix64(r->is_aref);
+
+   hash_add(h, quant(r->T.a11, 1e9));
+   hash_add(h, quant(r->T.a12, 1e9));
+   hash_add(h, quant(r->T.a21, 1e9));
+   hash_add(h, quant(r->T.a22, 1e9));
+   hash_add(h, quant(r->T.tx, ud));
+   hash_add(h, quant(r->T.ty, ud));
+   hash_add(h, r->ncol);
+   hash_add(h, r->nrow);
+   hash_add(h, quant(r->dcol[0], ud));
+   hash_add(h, quant(r->dcol[1], ud));
+   hash_add(h, quant(r->drow[0], ud));
+   hash_add(h, quant(r->drow[1], ud));
+   hash_add(h, r->absolute);
+
+   return h;
+}
+
+
+//-----------------------------------------------------------------
+
+// computes the element hashes and the hash of structure k
+static const char *
+hash_cell(Diff &df, Side &sd, size_t k, int depth)
+{
+   CellHash &ch = sd.cell[k];
+   fl_cell_t *c = &sd.lib->cell[k];
+   fl_shape_t *sh;
+   fl_ref_t *r;
+   const char *msg;
+   uint64_t h;
+   ElHash e;
+   size_t m;
+
+   if (ch.state == 2)
+      return NULL;
+   if (ch.state == 1 || depth > MAX_DEPTH)
+      return "the structure hierarchy contains a cycle";
+   ch.state = 1;
+   sd.used[k] = 1;
+
+   for (m=0; m<c->nsh; m++) {
+      sh = &c->sh[m];
+      if ( !compared(df, sh) )
+	 continue;
+      e.h = shape_hash(c, sh, df.ud);
+      e.idx = (uint32_t)m;
+      e.ref = false;
+      ch.el.push_back(e);
+   }
+
+   for (m=0; m<c->nref; m++) {
+      r = &c->ref[m];
+      h = MISSING;
+      if (r->cell >= 0) {
+	 if ( (msg = hash_cell(df, sd, r->cell, depth+1)) )
+	    return msg;
+	 h = sd.cell[r->cell].h;
+      }
+      e.h = placement_hash(r, df.ud);
+      hash_add(e.h, h);
+      e.idx = (uint32_t)m;
+      e.ref = true;
+      ch.el.push_back(e);
+   }
+
+   // the structure hash does not depend on the element order
+   std::sort(ch.el.begin(), ch.el.end());
+   ch.h = mix64(ch.el.size());
+   for (m=0; m<ch.el.size(); m++)
+      hash_add(ch.h, ch.el[m].h);
+
+   ch.state = 2;
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+static inline void
+push_window(std::vector<Window> &w, const double *b, long key)
+{
+   Window wn;
+
+   if (b[0] > b[2])
+      return;
+   wn.b[0] = b[0];  wn.b[1] = b[1];
+   wn.b[2] = b[2];  wn.b[3] = b[3];
+   wn.key = key;
+   w.push_back(wn);
+}
+
+
+//-----------------------------------------------------------------
+
+// appends the windows cw of a referenced structure pair for all
+// instances of reference r
+static void
+instance_windows(const std::vector<Window> &cw, const fl_ref_t *r,
+                 std::vector<Window> &w)
+{
+   affine_t I = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+   affine_t Ti;
+   double tb[4], eb[4], dx, dy;
+   size_t k;
+   int i, j, q;
+
+   if ((size_t)r->ncol * r->nrow * cw.size() <= MAX_WIN) {
+      for (j=0; j<r->nrow; j++) {
+	 for (i=0; i<r->ncol; i++) {
+	    instance_transform(Ti, I, r, i, j);
+	    for (k=0; k<cw.size(); k++) {
+	       box_transform(tb, cw[k].b, Ti);
+	       push_window(w, tb, cw[k].key);
+	    }
+	 }
+      }
+      return;
+   }
+
+   // large arrays: one window spanning all instances
+   for (k=0; k<cw.size(); k++) {
+      box_transform(tb, cw[k].b, r->T);
+      empty_box(eb);
+      for (q=0; q<4; q++) {
+	 double cq[4];
+	 dx = dy = 0.0;
+	 if (q & 1) {
+	    dx += (r->ncol - 1) * r->dcol[0];
+	    dy += (r->ncol - 1) * r->dcol[1];
+	 }
+	 if (q & 2) {
+	    dx += (r->nrow - 1) * r->drow[0];
+	    dy += (r->nrow - 1) * r->drow[1];
+	 }
+	 cq[0] = tb[0] + dx;  cq[2] = tb[2] + dx;
+	 cq[1] = tb[1] + dy;  cq[3] = tb[3] + dy;
+	 add_box(eb, cq);
+      }
+      push_window(w, eb, cw[k].key);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// sorts references by their placement
+static void
+ref_placements(const Diff &df, const Side &sd, size_t k,
+               const std::vector<uint32_t> &ref,
+               std::vector< std::pair<uint64_t,uint32_t> > &pl)
+{
+   size_t m;
+
+   pl.resize(ref.size());
+   for (m=0; m<ref.size(); m++) {
+      pl[m].first = placement_hash(&sd.lib->cell[k].ref[ref[m]], df.ud);
+      pl[m].second = ref[m];
+   }
+   std::sort(pl.begin(), pl.end());
+}
+
+
+//-----------------------------------------------------------------
+
+// an unmatched reference may differ on all layers
+static const char *
+ref_window(const Side &sd, const fl_ref_t *r, std::vector<Window> &w)
+{
+   double bb[4];
+
+   if ( fl_ref_bbox(sd.lib, r, bb) )
+      return "failed to compute a bounding box";
+   push_window(w, bb, WILDCARD);
+
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+// windows in which structure a of layout A and structure b of
+// layout B differ, in the coordinates of the structures
+static const char *
+diff_pair(Diff &df, size_t a, size_t b, int depth, std::vector<Window> &w)
+{
+   const CellHash &ca = df.s[0].cell[a];
+   const CellHash &cb = df.s[1].cell[b];
+   std::vector<uint32_t> ref[2];
+   std::vector< std::pair<uint64_t,uint32_t> > pl[2];
+   std::vector<Window> cw;
+   std::map< std::pair<size_t,size_t>, std::vector<Window> >::iterator it;
+   std::pair<size_t,size_t> key;
+   const fl_ref_t *ra, *rb;
+   const char *msg;
+   size_t i, j;
+
+   w.clear();
+   if (depth > MAX_DEPTH)
+      return "the structure hierarchy contains a cycle";
+
+   df.npair++;
+   if (ca.h == cb.h) {
+      df.nskip++;
+      return NULL;
+   }
+
+   // elements that are not in the other structure
+   i = j = 0;
+   while (i < ca.el.size() || j < cb.el.size()) {
+      if (j == cb.el.size() || (i < ca.el.size() && ca.el[i].h < cb.el[j].h)) {
+	 if (ca.el[i].ref)
+	    ref[0].push_back(ca.el[i].idx);
+	 else {
+	    const fl_shape_t *sh = &df.s[0].lib->cell[a].sh[ca.el[i].idx];
+	    push_window(w, sh->bbox, layer_key(sh));
+	 }
+	 i++;
+      }
+      else if (i == ca.el.size() || cb.el[j].h < ca.el[i].h) {
+	 if (cb.el[j].ref)
+	    ref[1].push_back(cb.el[j].idx);
+	 else {
+	    const fl_shape_t *sh = &df.s[1].lib->cell[b].sh[cb.el[j].idx];
+	    push_window(w, sh->bbox, layer_key(sh));
+	 }
+	 j++;
+      }
+      else {
+	 i++;
+	 j++;
+      }
+   }
+
+   // references with the same placement are compared recursively
+   ref_placements(df, df.s[0], a, ref[0], pl[0]);
+   ref_placements(df, df.s[1], b, ref[1], pl[1]);
+   i = j = 0;
+   while (i < pl[0].size() || j < pl[1].size()) {
+      ra = i < pl[0].size() ? &df.s[0].lib->cell[a].ref[pl[0][i].second] : NULL;
+      rb = j < pl[1].size() ? &df.s[1].lib->cell[b].ref[pl[1][j].second] : NULL;
+
+      if (ra && rb && pl[0][i].first == pl[1][j].first) {
+	 if (ra->cell >= 0 && rb->cell >= 0) {
+	    key = std::make_pair((size_t)ra->cell, (size_t)rb->cell);
+	    it = df.memo.find(key);
+	    if (it == df.memo.end()) {
+	       if ( (msg = diff_pair(df, ra->cell, rb->cell, depth+1, cw)) )
+		  return msg;
+	       it = df.memo.insert(std::make_pair(key, cw)).first;
+	    }
+	    instance_windows(it->second, ra, w);
+	 }
+	 else {
+	    if ( (msg = ref_window(df.s[0], ra, w)) || (msg = ref_window(df.s[1], rb, w)) )
+	       return msg;
+	 }
+	 i++;
+	 j++;
+      }
+      else if (ra && (!rb || pl[0][i].first < pl[1][j].first)) {
+	 if ( (msg = ref_window(df.s[0], ra, w)) )
+	    return msg;
+	 i++;
+      }
+      else {
+	 if ( (msg = ref_window(df.s[1], rb, w)) )
+	    return msg;
+	 j++;
+      }
+   }
+
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+static inline int
+clamp(double k, int n)
+{
+   return k < 0 ? 0 : (k >= n ? n-1 : (int)k);
+}
+
+
+//-----------------------------------------------------------------
+
+// enters the windows into a grid
+static void
+index_windows(Diff &df)
+{
+   WindowIndex &wi = df.wi;
+   double bb[4];
+   size_t k;
+   int i, j, ilo, ihi, jlo, jhi;
+
+   empty_box(bb);
+   for (k=0; k<df.win.size(); k++)
+      add_box(bb, df.win[k].b);
+
+   wi.nx = wi.ny = clamp(sqrt((double)df.win.size()), 512) + 1;
+   wi.x0 = bb[0];
+   wi.y0 = bb[1];
+   wi.dx = (bb[2] - bb[0]) / wi.nx;
+   wi.dy = (bb[3] - bb[1]) / wi.ny;
+   if (wi.dx <= 0.0) wi.dx = 1.0;
+   if (wi.dy <= 0.0) wi.dy = 1.0;
+   wi.bin.assign((size_t)wi.nx * wi.ny, std::vector<unsigned int>());
+
+   for (k=0; k<df.win.size(); k++) {
+      const double *b = df.win[k].b;
+      ilo = clamp(floor((b[0] - wi.x0) / wi.dx), wi.nx);
+      ihi = clamp(floor((b[2] - wi.x0) / wi.dx), wi.nx);
+      jlo = clamp(floor((b[1] - wi.y0) / wi.dy), wi.ny);
+      jhi = clamp(floor((b[3] - wi.y0) / wi.dy), wi.ny);
+      for (i=ilo; i<=ihi; i++)
+	 for (j=jlo; j<=jhi; j++)
+	    wi.bin[(size_t)i*wi.ny + j].push_back((unsigned int)k);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// true if the box b overlaps a window of layer key; key WILDCARD
+// matches the windows of all layers
+static bool
+in_window(const Diff &df, const double *b, long key)
+{
+   const WindowIndex &wi = df.wi;
+   const Window *pw;
+   int i, j, ilo, ihi, jlo, jhi;
+   size_t k;
+
+   if (b[0] > b[2] || df.win.empty())
+      return false;
+   if (b[2] < wi.x0 || b[3] < wi.y0 ||
+       b[0] > wi.x0 + wi.nx * wi.dx || b[1] > wi.y0 + wi.ny * wi.dy)
+      return false;
+
+   ilo = clamp(floor((b[0] - wi.x0) / wi.dx), wi.nx);
+   ihi = clamp(floor((b[2] - wi.x0) / wi.dx), wi.nx);
+   jlo = clamp(floor((b[1] - wi.y0) / wi.dy), wi.ny);
+   jhi = clamp(floor((b[3] - wi.y0) / wi.dy), wi.ny);
+   for (i=ilo; i<=ihi; i++) {
+      for (j=jlo; j<=jhi; j++) {
+	 const std::vector<unsigned int> &bin = wi.bin[(size_t)i*wi.ny + j];
+	 for (k=0; k<bin.size(); k++) {
+	    pw = &df.win[bin[k]];
+	    if ((key == WILDCARD || pw->key == WILDCARD || pw->key == key) &&
+		overlaps(pw->b, b))
+	       return true;
+	 }
+      }
+   }
+
+   return false;
+}
+
+
+//-----------------------------------------------------------------
+
+// expands the shapes of structure k that overlap a window
+static const char *
+expand_cell(Diff &df, Side &sd, size_t k, const affine_t &T, int depth,
+            std::vector<double> &buf)
+{
+   fl_cell_t *c = &sd.lib->cell[k];
+   fl_shape_t *sh;
+   fl_ref_t *r;
+   affine_t Ti;
+   double tb[4], cb[4];
+   const char *msg;
+   size_t m;
+   int i, j;
+
+   if (depth > MAX_DEPTH)
+      return "the structure hierarchy contains a cycle";
+
+   // shapes
+   for (m=0; m<c->nsh; m++) {
+      sh = &c->sh[m];
+      if ( !compared(df, sh) )
+	 continue;
+      box_transform(tb, sh->bbox, T);
+      if ( in_window(df, tb, layer_key(sh)) ) {
+	 shape_polygons(c, sh, T, df.ud, buf, sd.flat[layer_key(sh)]);
+	 sd.nshape++;
+      }
+   }
+
+   // references
+   for (m=0; m<c->nref; m++) {
+
+      r = &c->ref[m];
+      if (r->cell < 0)
+	 continue;
+      if ( fl_ref_bbox(sd.lib, r, cb) )
+	 return "failed to compute a bounding box";
+      box_transform(tb, cb, T);
+      if ( !in_window(df, tb, WILDCARD) )
+	 continue;
+      memcpy(cb, sd.lib->cell[r->cell].bbox, 4*sizeof(double));
+
+      for (j=0; j<r->nrow; j++) {
+	 for (i=0; i<r->ncol; i++) {
+	    instance_transform(Ti, T, r, i, j);
+	    box_transform(tb, cb, Ti);
+	    if ( !in_window(df, tb, WILDCARD) )
+	       continue;
+	    if ( (msg = expand_cell(df, sd, r->cell, Ti, depth+1, buf)) )
+	       return msg;
+	 }
+      }
+   }
+
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+// exclusive or of the shapes of one tile within the windows
+static bool
+xor_tile(Clipper &C, Paths &a, Paths &b, const Path &rect, PolyTree &res, void *arg)
+{
+   const TileWindows &tw = *(const TileWindows *)arg;
+   IntRect tr;
+   Paths x;
+   size_t k, n = 0;
+
+   if (a.empty() && b.empty())
+      return true;
+   C.AddPaths(a, ptSubject, true);
+   C.AddPaths(b, ptClip, true);
+   if ( !C.Execute(ctXor, x, pftNonZero, pftNonZero) )
+      return false;
+   C.Clear();
+   if ( x.empty() )
+      return true;
+
+   // windows that overlap the tile
+   tr.left = tr.right = rect[0].X;
+   tr.bottom = tr.top = rect[0].Y;
+   for (k=1; k<rect.size(); k++) {
+      if (rect[k].X < tr.left) tr.left = rect[k].X;
+      if (rect[k].X > tr.right) tr.right = rect[k].X;
+      if (rect[k].Y < tr.top) tr.top = rect[k].Y;
+      if (rect[k].Y > tr.bottom) tr.bottom = rect[k].Y;
+   }
+   for (k=0; k<tw.rect.size(); k++) {
+      const IntRect &wb = tw.box[k];
+      if (wb.left < tr.right && wb.right > tr.left &&
+	  wb.top < tr.bottom && wb.bottom > tr.top) {
+	 C.AddPath(tw.rect[k], ptClip, true);
+	 n++;
+      }
+   }
+   if (!n)
+      return true;
+   C.AddPaths(x, ptSubject, true);
+
+   return C.Execute(ctIntersection, res, pftNonZero, pftNonZero);
+}
+
+
+//-----------------------------------------------------------------
+
+// window rectangles of a layer key in database units, enlarged by
+// one database unit to include shape edges on the window border
+static void
+layer_windows(const Diff &df, long key, TileWindows &tw)
+{
+   const Window *pw;
+   IntRect r;
+   Path p(4);
+   size_t k;
+
+   for (k=0; k<df.win.size(); k++) {
+      pw = &df.win[k];
+      if (pw->key != WILDCARD && pw->key != key)
+	 continue;
+      r.left = (cInt)floor(df.ud * pw->b[0]) - 1;
+      r.top = (cInt)floor(df.ud * pw->b[1]) - 1;
+      r.right = (cInt)ceil(df.ud * pw->b[2]) + 1;
+      r.bottom = (cInt)ceil(df.ud * pw->b[3]) + 1;
+      p[0] = IntPoint(r.left, r.top);
+      p[1] = IntPoint(r.right, r.top);
+      p[2] = IntPoint(r.right, r.bottom);
+      p[3] = IntPoint(r.left, r.bottom);
+      tw.rect.push_back(p);
+      tw.box.push_back(r);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// exclusive or of the expanded shapes on one layer key
+static bool
+layer_xor(Diff &df, long key, const Paths &pa, const Paths &pb, int nthreads,
+          LayerDiff &ld)
+{
+   TileWindows tw;
+   size_t k, nv = 0;
+   int n;
+
+   ld.layer = (int)(key % NLAYER);
+   ld.dtype = (int)(key / NLAYER);
+   ld.area = 0.0;
+   ld.poly.clear();
+
+   for (k=0; k<pa.size(); k++)
+      nv += pa[k].size();
+   for (k=0; k<pb.size(); k++)
+      nv += pb[k].size();
+   n = (int)ceil(sqrt((double)nv / TILE_VERT));
+   if (n < 1) n = 1;
+   if (n > MAX_TILES) n = MAX_TILES;
+
+   layer_windows(df, key, tw);
+   if ( !TiledExecute(pa, pb, n, n, 0, pftNonZero, nthreads, xor_tile, &tw, ld.poly) )
+      return false;
+   for (k=0; k<ld.poly.size(); k++)
+      ld.area += Area(ld.poly[k]);
+
+   return true;
+}
+
+
+//-----------------------------------------------------------------
+
+// counts the structures of one layout with an identical structure
+// in the other layout
+static size_t
+count_same(const Side &s, const Side &o)
+{
+   std::vector<uint64_t> h;
+   size_t k, n = 0;
+
+   for (k=0; k<o.cell.size(); k++)
+      if (o.used[k])
+	 h.push_back(o.cell[k].h);
+   std::sort(h.begin(), h.end());
+   for (k=0; k<s.cell.size(); k++)
+      if (s.used[k] && std::binary_search(h.begin(), h.end(), s.cell[k].h))
+	 n++;
+
+   return n;
+}
+
+
+//-----------------------------------------------------------------
+
+const char *
+LayoutDiff(fl_library_t *liba, size_t topa,
+           fl_library_t *libb, size_t topb,
+           const std::vector<int> &lay, double ud,
+           int nthreads, DiffResult &res)
+{
+   affine_t I = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+   fl_library_t *lib[2] = {liba, libb};
+   size_t top[2] = {topa, topb};
+   std::map<long, Paths>::iterator it;
+   std::vector<long> keys;
+   std::vector<double> buf;
+   LayerDiff ld;
+   Diff df;
+   const char *msg;
+   double bb[4];
+   size_t k;
+   int s;
+
+   if (topa >= liba->ncell || topb >= libb->ncell)
+      return "invalid top structure";
+   if (ud <= 0.0)
+      return "invalid database unit";
+
+   df.ud = ud;
+   df.npair = df.nskip = 0;
+   df.lsel.assign(NLAYER, lay.empty() ? 1 : 0);
+   for (k=0; k<lay.size(); k++)
+      if (lay[k] >= 0 && lay[k] < NLAYER)
+	 df.lsel[lay[k]] = 1;
+
+   res.layers.clear();
+
+   try {
+      // structure hashes and bounding boxes
+      for (s=0; s<2; s++) {
+	 Side &sd = df.s[s];
+	 sd.lib = lib[s];
+	 sd.nshape = 0;
+	 sd.cell.resize(lib[s]->ncell);
+	 for (k=0; k<lib[s]->ncell; k++)
+	    sd.cell[k].state = 0;
+	 sd.used.assign(lib[s]->ncell, 0);
+	 if ( (msg = hash_cell(df, sd, top[s], 0)) )
+	    return msg;
+	 if ( fl_cell_bbox(lib[s], top[s], bb) )
+	    return "failed to compute a bounding box";
+	 res.ncell[s] = std::count(sd.used.begin(), sd.used.end(), 1);
+      }
+      res.nsame[0] = count_same(df.s[0], df.s[1]);
+      res.nsame[1] = count_same(df.s[1], df.s[0]);
+
+      // windows with differences
+      if ( (msg = diff_pair(df, topa, topb, 0, df.win)) )
+	 return msg;
+      res.npair = df.npair;
+      res.nskip = df.nskip;
+      res.nwin = df.win.size();
+      df.memo.clear();
+
+      // expand the shapes in the windows
+      index_windows(df);
+      for (s=0; s<2 && !df.win.empty(); s++)
+	 if ( (msg = expand_cell(df, df.s[s], top[s], I, 0, buf)) )
+	    return msg;
+      res.nshape[0] = df.s[0].nshape;
+      res.nshape[1] = df.s[1].nshape;
+
+      // exclusive or of each layer
+      for (s=0; s<2; s++)
+	 for (it=df.s[s].flat.begin(); it!=df.s[s].flat.end(); it++)
+	    keys.push_back(it->first);
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+      for (k=0; k<keys.size(); k++) {
+	 if ( !layer_xor(df, keys[k], df.s[0].flat[keys[k]], df.s[1].flat[keys[k]],
+	                 nthreads, ld) )
+	    return "Clipper library error";
+	 df.s[0].flat.erase(keys[k]);
+	 df.s[1].flat.erase(keys[k]);
+	 if ( !ld.poly.empty() )
+	    res.layers.push_back(ld);
+      }
+   }
+   catch (...) {
+      return "Clipper library error";
+   }
+
+   return NULL;
+}
+
+} // ClipperLib namespace
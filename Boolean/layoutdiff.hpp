@@ -0,0 +1,77 @@
+// Hierarchical layout comparison for the GDS II toolbox
+//
+// Computes the geometric difference (exclusive or) of the resolved
+// hierarchies below two structures, which are usually the top
+// structures of two revisions of a layout. Each hierarchy is
+// described by a library of structures (see Basic/gdsio/flatten.h).
+//
+// The content of every structure is hashed bottom-up: each element
+// is hashed with its layer, type and vertices in database units,
+// references with their transformation and the hash of the
+// referenced structure, and the sorted element hashes are combined
+// into the structure hash. Structures with the same hash, and all
+// structures below them, are identical and are not compared. For
+// two structures with different hashes, the elements that do not
+// occur in the other structure are found by their hashes; references
+// with the same placement to structures that differ are compared
+// recursively. The bounding boxes of the remaining elements are the
+// windows in which the layouts can differ. Only the shapes that
+// overlap a window are expanded, and their exclusive or within the
+// windows is computed on each (layer, data type) pair with the
+// Clipper library in tiles that are processed in parallel.
+//
+// Copyright (c) 2026
+
+#ifndef _LAYOUTDIFF_HPP
+#define _LAYOUTDIFF_HPP
+
+#include <vector>
+#include "clipper.hpp"
+
+extern "C" {
+#include "flatten.h"
+}
+
+namespace ClipperLib {
+
+//
+// the difference on one (layer, data type) pair. The polygons are
+// in database units; holes have negative orientation.
+//
+struct LayerDiff {
+   int layer;
+   int dtype;
+   Paths poly;           // difference polygons
+   double area;          // area of the difference in database units^2
+};
+
+//
+// result of a comparison
+//
+struct DiffResult {
+   std::vector<LayerDiff> layers;   // layers with differences
+   size_t ncell[2];      // structures below the two top structures
+   size_t nsame[2];      // of these, structures with an identical
+                         // structure below the other top structure
+   size_t npair;         // pairs of structures that were compared
+   size_t nskip;         // of these, identical pairs that were skipped
+   size_t nwin;          // windows with possible differences
+   size_t nshape[2];     // shapes expanded for the exclusive or
+};
+
+//
+// compares the resolved structures topa in liba and topb in libb.
+// ud is the conversion factor from user units to database units;
+// the shapes are compared with database unit resolution. When lay
+// is not empty, only shapes on the layers in lay (all data types)
+// are compared. nthreads < 1 selects one thread per processor.
+// Returns NULL on success or an error message.
+//
+const char *LayoutDiff(fl_library_t *liba, size_t topa,
+                       fl_library_t *libb, size_t topb,
+                       const std::vector<int> &lay, double ud,
+                       int nthreads, DiffResult &res);
+
+} // ClipperLib namespace
+
+#endif // _LAYOUTDIFF_HPP
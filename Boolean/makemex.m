@@ -1,4 +1,7 @@
 %
 % script to make .mex files
 %
-mex -O poly_boolmex.cpp clipper.cpp
+mex -O -I../Basic/gdsio poly_boolmex.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/mexfuncs.c
+mex -O poly_offsetmex.cpp clipmex.cpp clipper.cpp polytiles.cpp
+mex -O -I../Basic/gdsio poly_densitymex.cpp polydensity.cpp clipper.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
+mex -O -I../Basic/gdsio layout_diffmex.cpp layoutdiff.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
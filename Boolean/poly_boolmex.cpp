@@ -1,10 +1,15 @@
 // A mex interface to the Clipper library
 // for the GDS II toolbox
-// 
+//
 // [pc, hf] =  = poly_boolmex(pa, pb, op, ud);
+// [pc, hf, ng] = poly_boolmex(ga, gb, op, ud);
+// [pc, hf] = poly_boolmex(pa, pb, op, ud, tiles, nthreads);
 //
 // pa :  cell array with polygons (nx2 matrices)
-// pb :  cell array with polygons (nx2 matrices)
+// pb :  cell array with polygons (nx2 matrices). For the 'or'
+//       operation, pb can be empty; the polygons in pa are then
+//       merged with the nonzero fill rule, i.e. overlapping
+//       polygons are united.
 // op :  polygon operation
 // ud :  conversion factor for conversion from user
 //       coordinates to database coordinates
@@ -13,6 +18,25 @@
 // hf :  hole flag array; when hf(k)==1, pc{k} is the interior boundary
 //       of a hole.
 //
+// Batch operation:
+// ga :  cell array with G operand groups, each a cell array
+//       with polygons like pa.
+// gb :  cell array with G operand groups like ga, or a single cell
+//       array with polygons that is used with all groups in ga.
+//       Empty groups are allowed.
+// pc :  a cell array with the result polygons of all groups. The
+//       results of group k follow those of group k-1.
+// hf :  hole flags for all polygons in pc
+// ng :  1xG vector with the number of result polygons of each group
+//
+// Tiled operation:
+// tiles :    [nx, ny] or n; the bounding box of all polygons is divided
+//            into nx x ny (or n x n) tiles that are processed in
+//            parallel. Polygons crossing tile borders are merged
+//            after all tiles were processed.
+// nthreads : (Optional) number of threads used for processing the tiles.
+//            Default is the number of processors.
+//
 // polygon operations are:
 //   'and' :             polygon intersection
 //   'or' :              polygon union
@@ -23,15 +47,22 @@
 
 // NOTE:
 // C++ memory management in mex functions is a nightmare. In C,
-// calls to malloc can simply be redirected to mxMalloc etc., but in C++, 
-// memory management is baked into the language. I am not sure that 
-// all memory allocated by the Clipper library is freed, and memory 
-// leaks are possible. Need to keep an eye on this ... 
-
+// calls to malloc can simply be redirected to mxMalloc etc., but in C++,
+// memory management is baked into the language. I am not sure that
+// all memory allocated by the Clipper library is freed, and memory
+// leaks are possible. Need to keep an eye on this ...
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
 #include "mex.h"
 #include "clipper.hpp"
+#include "polytiles.hpp"
+#include "clipmex.hpp"
+#include "gdsstats.h"
 
 #define STR_LEN    8
+#define FNAME      "poly_boolmex"
 
 
 //-----------------------------------------------------------------
@@ -39,21 +70,94 @@
 using namespace ClipperLib;
 
 // declare static to avoid memory leaks when the mex function exits
-static Paths pa, pb, pc;
+static Paths pa, pb, pc, pr;
+static std::vector<double> ng;
 static Clipper C;
 
-void 
+// operation and fill rule of the tiles
+struct tile_op {
+   ClipType op;
+   PolyFillType fill;
+};
+
+
+//-----------------------------------------------------------------
+
+#if defined GDS_STATS
+// number of vertices of a set of polygons
+static uint64_t
+count_vertices(const Paths &p)
+{
+   uint64_t n = 0;
+
+   for (size_t k=0; k<p.size(); k++)
+      n += p[k].size();
+
+   return n;
+}
+#endif
+
+
+//-----------------------------------------------------------------
+
+// clip the polygons in pa and pb and append the results to pr
+static void
+clip_polygons(ClipType pop, PolyFillType fill)
+{
+   unsigned int k;
+   STATS_TIMER(t);
+
+   C.AddPaths(pa, ptSubject, true);
+   C.AddPaths(pb, ptClip, true);
+
+   if ( !C.Execute(pop, pc, fill, fill) )
+       mexErrMsgTxt("polyboolmex :  Clipper library error.");
+   C.Clear();
+
+   STATS_ELAPSED(ST_CLIP_NS, t);
+   STATS_ADD(ST_CLIP_CALLS, 1);
+   STATS_ADD(ST_CLIP_VERT_IN, count_vertices(pa) + count_vertices(pb));
+   STATS_ADD(ST_CLIP_VERT_OUT, count_vertices(pc));
+
+   for (k=0; k<pc.size(); k++) {
+      pr.push_back(Path());
+      pr.back().swap(pc[k]);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// boolean operation on the polygons of one tile
+static bool
+clip_tile(Clipper &T, Paths &a, Paths &b, const Path &rect, PolyTree &res, void *arg)
+{
+   T.AddPaths(a, ptSubject, true);
+   T.AddPaths(b, ptClip, true);
+
+   tile_op *top = (tile_op *)arg;
+
+   return T.Execute(top->op, res, top->fill, top->fill);
+}
+
+
+//-----------------------------------------------------------------
+
+void
 mexFunction(int nlhs, mxArray *plhs[],
 	    int nrhs, const mxArray *prhs[])
 {
-   mxArray *par;         // ptr to mxArray structure 
+   mxArray *par;         // ptr to mxArray structure
    double *pda;          // ptr to polynomial data
    double *pud;          // pointer to unit conversion factor
-   mxLogical *ph;        // pointer to hole flags
    double ud, iud;
-   unsigned int Na, Nb, vnu;
+   unsigned int Na, Nb;
    unsigned int k, m;
+   int batch, bgroups;
+   int nx = 0, ny = 0, nthreads = 0;
    ClipType pop;
+   PolyFillType fill;
+   tile_op top;
    char ostr[STR_LEN];   //string with polygon operation
 
 
@@ -62,10 +166,10 @@ mexFunction(int nlhs, mxArray *plhs[],
    //
 
    // argument number
-   if (nrhs != 4) {
-      mexErrMsgTxt("polyboolmex :  expected 4 input arguments.");
+   if (nrhs < 4 || nrhs > 6) {
+      mexErrMsgTxt("polyboolmex :  expected 4 to 6 input arguments.");
    }
-   
+
    // argument pa
    if ( !mxIsCell(prhs[0]) ) {
       mexErrMsgTxt("polyboolmex :  argument pa must be a cell array.");
@@ -74,140 +178,139 @@ mexFunction(int nlhs, mxArray *plhs[],
    if (!Na) {
       mexErrMsgTxt("polyboolmex :  no input polygons pa.");
    }
-   
-   // argument pb
-   if ( !mxIsCell(prhs[1]) ) {
-      mexErrMsgTxt("polyboolmex :  argument pb must be a cell array.");
-   }
-   Nb = mxGetM(prhs[1])*mxGetN(prhs[1]);
-   if (!Nb) {
-      mexErrMsgTxt("polyboolmex :  no input polygons pb.");
-   }
 
    // get operation argument
    mxGetString(prhs[2], ostr, STR_LEN);
    if ( !strncmp(ostr, "or", 2) )
-      pop = ctUnion; 
+      pop = ctUnion;
    else if ( !strncmp(ostr, "and", 3) )
-      pop = ctIntersection; 
+      pop = ctIntersection;
    else if ( !strncmp(ostr, "notb", 4) )
-      pop = ctDifference; 
+      pop = ctDifference;
    else if ( !strncmp(ostr, "diff", 4) )
-      pop = ctDifference; 
+      pop = ctDifference;
    else if ( !strncmp(ostr, "xor", 3) )
-      pop = ctXor; 
+      pop = ctXor;
    else {
       mexErrMsgTxt("polyboolmex :  unknown boolean set algebra operation.");
    }
 
+   // argument pb; without pb, the polygons in pa are merged
+   if ( !mxIsCell(prhs[1]) ) {
+      mexErrMsgTxt("polyboolmex :  argument pb must be a cell array.");
+   }
+   Nb = mxGetM(prhs[1])*mxGetN(prhs[1]);
+   if (!Nb && pop != ctUnion) {
+      mexErrMsgTxt("polyboolmex :  no input polygons pb.");
+   }
+   fill = Nb ? pftEvenOdd : pftNonZero;
+
+   // batch operation with operand groups
+   par = mxGetCell(prhs[0], 0);
+   batch = par != NULL && mxIsCell(par);
+   par = Nb ? mxGetCell(prhs[1], 0) : NULL;
+   bgroups = batch && par != NULL && mxIsCell(par);
+   if (bgroups && Na != Nb) {
+      mexErrMsgTxt("polyboolmex :  number of operand groups must match.");
+   }
+
    // conversion factor argument
-   pud = (double*)mxGetData(prhs[3]);  
+   pud = (double*)mxGetData(prhs[3]);
    ud = *pud;
    iud = 1.0/ud;
 
-
-   ////////////////////////
-   // copy and prepare data
-   //
-
-   // pa
-   pa.resize(Na);
-   for (k=0; k<Na; k++) {
-
-      // get the next polygon from the cell array 
-      par = mxGetCell(prhs[0], k);   // ptr to mxArray
-      if ( mxIsEmpty(par) ) {
-	 mexErrMsgTxt("poly_boolmex :  empty polygon in pa.");
-      }
-      pda = (double*)mxGetData(par); // ptr to a data     
-      vnu = mxGetM(par);             // rows = vertex number
-
-      // copy polygon and transpose, scale
-      pa[k].resize(vnu);
-      for (m=0; m<vnu; m++) {
-	 pa[k][m].X = (cInt)(ud * pda[m]     + 0.5);
-	 pa[k][m].Y = (cInt)(ud * pda[m+vnu] + 0.5);
-      }
-
-      // make sure polygons have positive orientation
-      if ( !Orientation(pa[k]) )
-	  ReversePath(pa[k]);
+   // tiles and threads
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      pda = (double*)mxGetData(prhs[4]);
+      nx = (int)pda[0];
+      ny = mxGetNumberOfElements(prhs[4]) > 1 ? (int)pda[1] : nx;
+      if (nx < 1 || ny < 1)
+	 mexErrMsgTxt("polyboolmex :  number of tiles must be > 0.");
+      if (batch)
+	 mexErrMsgTxt("polyboolmex :  tiles cannot be used with operand groups.");
    }
-
-   // pb
-   pb.resize(Nb);
-   for (k=0; k<Nb; k++) {
-
-      // get the next polygon 
-      par = mxGetCell(prhs[1], k);   // ptr to mxArray
-      if ( mxIsEmpty(par) ) {
-	 mexErrMsgTxt("poly_boolmex :  empty polygon in pb.");
-      }
-      pda = (double*)mxGetData(par); // ptr to a data     
-      vnu = mxGetM(par);             // rows = vertex number
-
-      // copy polygon and transpose, scale
-      pb[k].resize(vnu);
-      for (m=0; m<vnu; m++) {
-	 pb[k][m].X = (cInt)(ud * pda[m]     + 0.5);
-	 pb[k][m].Y = (cInt)(ud * pda[m+vnu] + 0.5);
-      }
-
-      // make sure polygons have positive orientation
-      if ( !Orientation(pb[k]) )
-	  ReversePath(pb[k]);
+   if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+      pda = (double*)mxGetData(prhs[5]);
+      nthreads = (int)pda[0];
    }
 
 
    ////////////////////
    // clip the polygons
    //
-   C.AddPaths(pa, ptSubject, true);
-   C.AddPaths(pb, ptClip, true);
-
-   if ( !C.Execute(pop, pc, pftEvenOdd, pftEvenOdd) )
-       mexErrMsgTxt("polyboolmex :  Clipper library error.");
+   C.Clear();
+   pr.resize(0);
+   if (batch) {
+
+      // a common clip operand is converted only once
+      if (!bgroups)
+	 CellToPaths(prhs[1], pb, ud, FNAME, "pb");
+
+      ng.resize(Na);
+      for (k=0; k<Na; k++) {
+	 par = mxGetCell(prhs[0], k);
+	 if ( par == NULL || !mxIsCell(par) )
+	    mexErrMsgTxt("polyboolmex :  operand groups must be cell arrays.");
+	 CellToPaths(par, pa, ud, FNAME, "pa");
+	 if (bgroups) {
+	    par = mxGetCell(prhs[1], k);
+	    if ( par == NULL || !mxIsCell(par) )
+	       mexErrMsgTxt("polyboolmex :  operand groups must be cell arrays.");
+	    CellToPaths(par, pb, ud, FNAME, "pb");
+	 }
+	 m = pr.size();
+	 clip_polygons(pop, fill);
+	 ng[k] = pr.size() - m;
+      }
+   }
+   else if (nx) {
+      CellToPaths(prhs[0], pa, ud, FNAME, "pa");
+      CellToPaths(prhs[1], pb, ud, FNAME, "pb");
+      top.op = pop;
+      top.fill = fill;
+      STATS_TIMER(t);
+      if ( !TiledExecute(pa, pb, nx, ny, 0, fill, nthreads,
+			  clip_tile, &top, pr) )
+	 mexErrMsgTxt("polyboolmex :  Clipper library error.");
+      STATS_ELAPSED(ST_CLIP_NS, t);
+      STATS_ADD(ST_CLIP_CALLS, 1);
+      STATS_ADD(ST_CLIP_VERT_IN, count_vertices(pa) + count_vertices(pb));
+      STATS_ADD(ST_CLIP_VERT_OUT, count_vertices(pr));
+   }
+   else {
+      CellToPaths(prhs[0], pa, ud, FNAME, "pa");
+      CellToPaths(prhs[1], pb, ud, FNAME, "pb");
+      clip_polygons(pop, fill);
+   }
 
 
-   //////////////////////////////////////////
-   // create a cell array for output argument
+   ///////////////////////////////////////
+   // return clipping results and hole flags
    //
-   plhs[0] = mxCreateCellMatrix(1, pc.size());
+   plhs[0] = PathsToCell(pr, iud);
+   plhs[1] = HoleFlags(pr);
 
-   //////////////////////////
-   // return clipping results
+   ////////////////////////////////////
+   // return number of polygons per group
    //
-   for (k=0; k<pc.size(); k++) {
-      
-      // allocate matrix for boundary
-      vnu = pc[k].size();
-      par = mxCreateDoubleMatrix(vnu, 2, mxREAL);
-      pda = (double*)mxGetData(par);
-    
-      // copy vertex array, transpose, and scale back to user units
-      for (m=0; m<vnu; m++) {
-         pda[m]     = iud * pc[k][m].X;
-         pda[vnu+m] = iud * pc[k][m].Y;
-      }
-
-      // store in cell array
-      mxSetCell(plhs[0], k, par);
+   if (nlhs > 2) {
+      plhs[2] = mxCreateDoubleMatrix(1, batch ? Na : 1, mxREAL);
+      pda = (double*)mxGetData(plhs[2]);
+      if (batch)
+	 for (k=0; k<Na; k++)
+	    pda[k] = ng[k];
+      else
+	 pda[0] = pr.size();
    }
 
-   ///////////////////
-   // return hole flags
-   //
-   plhs[1] = mxCreateLogicalMatrix(1, pc.size());
-   ph = (mxLogical*)mxGetData(plhs[1]);
-   for (k=0; k<pc.size(); k++) 
-      ph[k] = !Orientation(pc[k]); // same as input == no hole
-
    ///////////////////
    // clean up
    //
-   C.Clear();
    pa.resize(0);
    pb.resize(0);
    pc.resize(0);
-}
+   pr.resize(0);
+   ng.resize(0);
 
+   STATS_FLUSH();
+}
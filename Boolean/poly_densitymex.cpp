@@ -0,0 +1,169 @@
+// A mex function for layer density maps
+// for the GDS II toolbox
+//
+// [A, win] = poly_densitymex(cells, names, top, layers, win, pitch, ud, exact, nthreads);
+//
+// cells :    cell array with one entry per structure; each entry is
+//            a cell array with the element data structures of the
+//            structure (as returned by get(gelm) for an element gelm).
+// names :    cell array with the structure names
+// top :      index of the structure for which the density is computed
+// layers :   vector with L layer numbers
+// win :      [llx,lly,urx,ury] rectangle covered by the grid. When it
+//            is empty, the bounding box of the shapes on the layers
+//            in the resolved top structure is used.
+// pitch :    tile size, [dx,dy] or a scalar for square tiles
+// ud :       conversion factor from user units to database units
+// exact :    (Optional) when > 0, all structure instances are expanded
+//            and clipped (see polydensity.hpp). Default is 0.
+// nthreads : (Optional) number of threads used for processing the
+//            tiles. Default is the number of processors.
+//
+// A :        ny x nx x L array with the area in user units^2 of each
+//            tile covered by shapes on each layer. A(j,i,k) is the area
+//            of the tile in column i and row j on layer layers(k).
+// win :      the rectangle covered by the nx x ny tiles; it is
+//            enlarged to a multiple of the tile size.
+//
+// Copyright (c) 2026
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+#include "mex.h"
+#include "clipper.hpp"
+#include "polydensity.hpp"
+#include "flatlib.h"
+
+#define FNAME  "poly_densitymex"
+
+
+//-----------------------------------------------------------------
+
+using namespace ClipperLib;
+
+// declare static to release the memory after errors
+static fl_library_t lib;
+static std::vector<double> area;
+static std::vector<int> lay;
+
+
+//-----------------------------------------------------------------
+
+static void
+failed(const char *msg)
+{
+   char errmsg[256];
+
+   fl_library_free(&lib);
+   std::vector<double>().swap(area);
+   snprintf(errmsg, sizeof(errmsg), "%s :  %s.", FNAME, msg);
+   mexErrMsgTxt(errmsg);
+}
+
+
+//-----------------------------------------------------------------
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   DensityGrid g;
+   mwSize dims[3];
+   const char *msg;
+   double *pd, win[4], ud;
+   size_t k, nl, top;
+   int nthreads = 0;
+   bool exact = false;
+
+   // check arguments
+   if (nrhs < 7)
+      mexErrMsgTxt(FNAME " :  at least 7 arguments required.");
+   if ( !mxIsCell(prhs[0]) || !mxIsCell(prhs[1]) )
+      mexErrMsgTxt(FNAME " :  cells and names must be cell arrays.");
+   if (mxGetNumberOfElements(prhs[0]) != mxGetNumberOfElements(prhs[1]))
+      mexErrMsgTxt(FNAME " :  cells and names must have the same length.");
+   top = (size_t)mxGetScalar(prhs[2]);
+   if (top < 1 || top > mxGetNumberOfElements(prhs[1]))
+      mexErrMsgTxt(FNAME " :  invalid top structure index.");
+   top--;
+   if ( !mxIsDouble(prhs[3]) || mxIsEmpty(prhs[3]) )
+      mexErrMsgTxt(FNAME " :  layers must be a vector of layer numbers.");
+   if ( !mxIsEmpty(prhs[4]) && mxGetNumberOfElements(prhs[4]) != 4 )
+      mexErrMsgTxt(FNAME " :  window must have 4 elements.");
+   if ( !mxIsDouble(prhs[5]) || mxIsEmpty(prhs[5]) || mxGetNumberOfElements(prhs[5]) > 2 )
+      mexErrMsgTxt(FNAME " :  pitch must be a scalar or a vector [dx,dy].");
+   pd = mxGetPr(prhs[5]);
+   g.dx = pd[0];
+   g.dy = mxGetNumberOfElements(prhs[5]) > 1 ? pd[1] : pd[0];
+   if (g.dx <= 0.0 || g.dy <= 0.0)
+      mexErrMsgTxt(FNAME " :  pitch must be positive.");
+   ud = mxGetScalar(prhs[6]);
+   if (ud <= 0.0)
+      mexErrMsgTxt(FNAME " :  unit conversion factor must be positive.");
+   if (nrhs > 7 && !mxIsEmpty(prhs[7]))
+      exact = mxGetScalar(prhs[7]) > 0;
+   if (nrhs > 8 && !mxIsEmpty(prhs[8]))
+      nthreads = (int)mxGetScalar(prhs[8]);
+
+   nl = mxGetNumberOfElements(prhs[3]);
+   pd = mxGetPr(prhs[3]);
+   lay.resize(nl);
+   for (k=0; k<nl; k++)
+      lay[k] = (int)pd[k];
+
+   // structure hierarchy
+   if ( (msg = fl_build_library(&lib, prhs[0], prhs[1])) )
+      failed(msg);
+
+   // the grid
+   if ( mxIsEmpty(prhs[4]) ) {
+      if ( (msg = DensityBBox(&lib, top, lay, win)) )
+	 failed(msg);
+   }
+   else {
+      pd = mxGetPr(prhs[4]);
+      win[0] = fmin(pd[0], pd[2]);
+      win[2] = fmax(pd[0], pd[2]);
+      win[1] = fmin(pd[1], pd[3]);
+      win[3] = fmax(pd[1], pd[3]);
+   }
+   if (win[0] > win[2]) {   // nothing on the layers
+      g.nx = g.ny = 0;
+      win[0] = win[1] = win[2] = win[3] = 0.0;
+   }
+   else {
+      g.nx = (int)ceil((win[2] - win[0]) / g.dx);
+      g.ny = (int)ceil((win[3] - win[1]) / g.dy);
+      if (g.nx < 1) g.nx = 1;
+      if (g.ny < 1) g.ny = 1;
+   }
+   g.x0 = win[0];
+   g.y0 = win[1];
+
+   // compute the tile areas
+   if (g.nx > 0) {
+      if ( (msg = LayerDensity(&lib, top, lay, g, ud, exact, nthreads, area)) )
+	 failed(msg);
+   }
+   fl_library_free(&lib);
+
+   // return results
+   dims[0] = g.ny;
+   dims[1] = g.nx;
+   dims[2] = nl;
+   plhs[0] = mxCreateNumericArray(3, dims, mxDOUBLE_CLASS, mxREAL);
+   if (g.nx > 0)
+      memcpy(mxGetPr(plhs[0]), &area[0], area.size() * sizeof(double));
+   std::vector<double>().swap(area);
+
+   if (nlhs > 1) {
+      plhs[1] = mxCreateDoubleMatrix(1, 4, mxREAL);
+      pd = mxGetPr(plhs[1]);
+      pd[0] = win[0];
+      pd[1] = win[1];
+      pd[2] = win[0] + g.nx * g.dx;
+      pd[3] = win[1] + g.ny * g.dy;
+   }
+}
@@ -0,0 +1,311 @@
+// A mex interface to the polygon offsetting functions of
+// the Clipper library for the GDS II toolbox
+//
+// [pc, hf] = poly_offsetmex(pa, delta, ud, jtype, limit);
+// [pc, hf, ng] = poly_offsetmex(ga, delta, ud, jtype, limit);
+// [pc, hf] = poly_offsetmex(pa, delta, ud, jtype, limit, tiles, nthreads);
+//
+// pa :     cell array with polygons (nx2 matrices)
+// delta :  offset in user units. Polygons grow when delta > 0 and
+//          shrink when delta < 0. Overlapping polygons are merged
+//          before they are offset.
+// ud :     conversion factor for conversion from user
+//          coordinates to database coordinates
+// jtype :  join type at convex corners: 'miter', 'round', or 'square'.
+// limit :  for miter joins, the maximum distance of a mitered vertex
+//          in multiples of delta (default is 2, smaller values are
+//          set to 2). For round joins, the maximum deviation of the
+//          arcs from a true circle in user units (default is
+//          0.25 database units). Ignored for square joins.
+//          An empty matrix selects the default.
+// pc :     a cell array containing the polygons that result
+//          from offsetting the polygons in pa.
+// hf :     hole flag array; when hf(k)==1, pc{k} is the interior boundary
+//          of a hole.
+//
+// Batch operation:
+// ga :     cell array with G groups, each a cell array with polygons
+//          like pa. Each group is offset separately. delta can be a
+//          scalar or a vector with one offset for each group.
+// ng :     1xG vector with the number of result polygons of each group
+//
+// Tiled operation:
+// tiles :    [nx, ny] or n; the bounding box of all polygons is divided
+//            into nx x ny (or n x n) tiles that are processed in
+//            parallel (see poly_boolmex).
+// nthreads : (Optional) number of threads used for processing the tiles.
+//            Default is the number of processors.
+//
+// Copyright (c) 2026
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "mex.h"
+#include "clipper.hpp"
+#include "polytiles.hpp"
+#include "clipmex.hpp"
+
+#define STR_LEN    8
+#define FNAME      "poly_offsetmex"
+
+
+//-----------------------------------------------------------------
+
+using namespace ClipperLib;
+
+// parameters of a tiled offset operation
+struct OffsetArg {
+   JoinType jt;
+   double delta;          // offset in database units
+   double limit;          // miter limit
+   double atol;           // arc tolerance in database units
+   cInt margin;           // tile margin
+   cInt x0, y0, x1, y1;   // bounding box of the input polygons
+};
+
+// declare static to avoid memory leaks when the mex function exits
+static Paths pa, pb, pc, pr;
+static std::vector<double> ng;
+static Clipper C;
+static ClipperOffset O;
+
+
+//-----------------------------------------------------------------
+
+// merge and offset the polygons in pa and append the results to pr
+static void
+offset_polygons(JoinType jt, double delta)
+{
+   unsigned int k;
+
+   C.AddPaths(pa, ptSubject, true);
+   if ( !C.Execute(ctUnion, pc, pftNonZero, pftNonZero) )
+      mexErrMsgTxt("poly_offsetmex :  Clipper library error.");
+   C.Clear();
+
+   O.Clear();
+   O.AddPaths(pc, jt, etClosedPolygon);
+   O.Execute(pc, delta);
+   O.Clear();
+
+   for (k=0; k<pc.size(); k++) {
+      pr.push_back(Path());
+      pr.back().swap(pc[k]);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// offset the (merged) polygons of one tile and clip the result to the tile.
+// Tiles at the border of the tile grid are extended to make room
+// for polygons that grow beyond the bounding box.
+static bool
+offset_tile(Clipper &T, Paths &a, Paths &b, const Path &rect, PolyTree &res, void *arg)
+{
+   OffsetArg *po = (OffsetArg *)arg;
+   ClipperOffset TO(po->limit, po->atol);
+   Paths off;
+   Path r = rect;
+
+   TO.AddPaths(a, po->jt, etClosedPolygon);
+   TO.Execute(off, po->delta);
+   if ( off.empty() )
+      return true;
+
+   if (r[0].X <= po->x0) { r[0].X -= po->margin;  r[3].X -= po->margin; }
+   if (r[1].X >= po->x1) { r[1].X += po->margin;  r[2].X += po->margin; }
+   if (r[0].Y <= po->y0) { r[0].Y -= po->margin;  r[1].Y -= po->margin; }
+   if (r[2].Y >= po->y1) { r[2].Y += po->margin;  r[3].Y += po->margin; }
+
+   T.AddPaths(off, ptSubject, true);
+   T.AddPath(r, ptClip, true);
+
+   return T.Execute(ctIntersection, res, pftNonZero, pftNonZero);
+}
+
+
+//-----------------------------------------------------------------
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+	    int nrhs, const mxArray *prhs[])
+{
+   mxArray *par;         // ptr to mxArray structure
+   double *pda;          // ptr to data
+   double *pdelta;       // offsets
+   double ud, iud, mlimit, atol, ext;
+   unsigned int Na, Nd;
+   unsigned int k, m;
+   int batch;
+   int nx = 0, ny = 0, nthreads = 0;
+   JoinType jt;
+   OffsetArg oa;
+   char jstr[STR_LEN];   // string with join type
+
+
+   //////////////////
+   // check arguments
+   //
+
+   // argument number
+   if (nrhs < 3 || nrhs > 7) {
+      mexErrMsgTxt("poly_offsetmex :  expected 3 to 7 input arguments.");
+   }
+
+   // argument pa
+   if ( !mxIsCell(prhs[0]) ) {
+      mexErrMsgTxt("poly_offsetmex :  argument pa must be a cell array.");
+   }
+   Na = mxGetM(prhs[0])*mxGetN(prhs[0]);
+   if (!Na) {
+      mexErrMsgTxt("poly_offsetmex :  no input polygons pa.");
+   }
+
+   // batch operation with polygon groups
+   par = mxGetCell(prhs[0], 0);
+   batch = par != NULL && mxIsCell(par);
+
+   // offset argument
+   if ( !mxIsDouble(prhs[1]) || mxIsEmpty(prhs[1]) ) {
+      mexErrMsgTxt("poly_offsetmex :  argument delta must be a number.");
+   }
+   pdelta = (double*)mxGetData(prhs[1]);
+   Nd = mxGetNumberOfElements(prhs[1]);
+   if ( Nd > 1 && (!batch || Nd != Na) ) {
+      mexErrMsgTxt("poly_offsetmex :  delta must be a scalar or have one element per group.");
+   }
+
+   // conversion factor argument
+   ud = *(double*)mxGetData(prhs[2]);
+   iud = 1.0/ud;
+
+   // join type
+   jt = jtMiter;
+   if (nrhs > 3 && !mxIsEmpty(prhs[3])) {
+      mxGetString(prhs[3], jstr, STR_LEN);
+      if ( !strncmp(jstr, "miter", 5) )
+	 jt = jtMiter;
+      else if ( !strncmp(jstr, "round", 5) )
+	 jt = jtRound;
+      else if ( !strncmp(jstr, "square", 6) )
+	 jt = jtSquare;
+      else
+	 mexErrMsgTxt("poly_offsetmex :  unknown join type.");
+   }
+
+   // miter limit or arc tolerance
+   mlimit = 2.0;
+   atol = 0.25;
+   if (nrhs > 4 && !mxIsEmpty(prhs[4])) {
+      pda = (double*)mxGetData(prhs[4]);
+      if (pda[0] <= 0)
+	 mexErrMsgTxt("poly_offsetmex :  limit must be > 0.");
+      if (jt == jtRound)
+	 atol = ud * pda[0];
+      else
+	 mlimit = pda[0];
+   }
+
+   // tiles and threads
+   if (nrhs > 5 && !mxIsEmpty(prhs[5])) {
+      pda = (double*)mxGetData(prhs[5]);
+      nx = (int)pda[0];
+      ny = mxGetNumberOfElements(prhs[5]) > 1 ? (int)pda[1] : nx;
+      if (nx < 1 || ny < 1)
+	 mexErrMsgTxt("poly_offsetmex :  number of tiles must be > 0.");
+      if (batch)
+	 mexErrMsgTxt("poly_offsetmex :  tiles cannot be used with polygon groups.");
+   }
+   if (nrhs > 6 && !mxIsEmpty(prhs[6])) {
+      pda = (double*)mxGetData(prhs[6]);
+      nthreads = (int)pda[0];
+   }
+
+
+   //////////////////////
+   // offset the polygons
+   //
+   O.MiterLimit = mlimit;
+   O.ArcTolerance = atol;
+   C.Clear();
+   pr.resize(0);
+   if (batch) {
+      ng.resize(Na);
+      for (k=0; k<Na; k++) {
+	 par = mxGetCell(prhs[0], k);
+	 if ( par == NULL || !mxIsCell(par) )
+	    mexErrMsgTxt("poly_offsetmex :  polygon groups must be cell arrays.");
+	 CellToPaths(par, pa, ud, FNAME, "pa");
+	 m = pr.size();
+	 offset_polygons(jt, ud * pdelta[Nd > 1 ? k : 0]);
+	 ng[k] = pr.size() - m;
+      }
+   }
+   else if (nx) {
+      CellToPaths(prhs[0], pa, ud, FNAME, "pa");
+
+      // the margin must contain all vertices that can affect a tile
+      if (jt == jtMiter)
+	 ext = mlimit > 2.0 ? mlimit : 2.0;
+      else if (jt == jtSquare)
+	 ext = 1.5;
+      else
+	 ext = 1.0;
+      oa.jt = jt;
+      oa.delta = ud * pdelta[0];
+      oa.limit = mlimit;
+      oa.atol = atol;
+      oa.margin = (cInt)ceil(ext * fabs(oa.delta)) + 2;
+
+      // bounding box of the input polygons
+      oa.x0 = oa.x1 = pa[0][0].X;
+      oa.y0 = oa.y1 = pa[0][0].Y;
+      for (k=0; k<pa.size(); k++) {
+	 for (m=0; m<pa[k].size(); m++) {
+	    if (pa[k][m].X < oa.x0) oa.x0 = pa[k][m].X;
+	    if (pa[k][m].X > oa.x1) oa.x1 = pa[k][m].X;
+	    if (pa[k][m].Y < oa.y0) oa.y0 = pa[k][m].Y;
+	    if (pa[k][m].Y > oa.y1) oa.y1 = pa[k][m].Y;
+	 }
+      }
+
+      pb.resize(0);
+      if ( !TiledExecute(pa, pb, nx, ny, oa.margin, pftNonZero, nthreads,
+			 offset_tile, &oa, pr) )
+	 mexErrMsgTxt("poly_offsetmex :  Clipper library error.");
+   }
+   else {
+      CellToPaths(prhs[0], pa, ud, FNAME, "pa");
+      offset_polygons(jt, ud * pdelta[0]);
+   }
+
+
+   ////////////////////////////////////////
+   // return offset polygons and hole flags
+   //
+   plhs[0] = PathsToCell(pr, iud);
+   plhs[1] = HoleFlags(pr);
+
+   ////////////////////////////////////
+   // return number of polygons per group
+   //
+   if (nlhs > 2) {
+      plhs[2] = mxCreateDoubleMatrix(1, batch ? Na : 1, mxREAL);
+      pda = (double*)mxGetData(plhs[2]);
+      if (batch)
+	 for (k=0; k<Na; k++)
+	    pda[k] = ng[k];
+      else
+	 pda[0] = pr.size();
+   }
+
+   ///////////////////
+   // clean up
+   //
+   pa.resize(0);
+   pc.resize(0);
+   pr.resize(0);
+   ng.resize(0);
+}
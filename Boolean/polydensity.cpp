@@ -0,0 +1,705 @@
+// Layer density maps for the GDS II toolbox (see polydensity.hpp)
+//
+// Copyright (c) 2026
+
+#include <math.h>
+#include <vector>
+#include "clipper.hpp"
+#include "polydensity.hpp"
+
+extern "C" {
+#include "pathpoly.h"
+}
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+#define MAX_DEPTH  1024    // deeper hierarchies are certainly cyclic
+#define NLAYER     65536
+
+
+namespace ClipperLib {
+
+//-----------------------------------------------------------------
+
+// state of a density computation
+struct Density {
+   fl_library_t *lib;
+   int nlay;                         // number of selected layers
+   std::vector<int> lmap;            // GDS layer --> selected layer or -1
+   double ud;
+   bool exact;
+   DensityGrid g;
+   double win[4];                    // grid rectangle
+   std::vector<int> state;           // 0 = new, 1 = in progress, 2 = done
+   std::vector<double> bbox;         // resolved box of each structure and layer
+   std::vector<double> carea;        // resolved area of each structure and layer
+   std::vector<Paths> flat;          // expanded polygons of each layer
+   std::vector<double> *area;        // tile areas
+   Clipper C;
+   std::vector<double> buf;          // polygon of a path
+};
+
+// a rectangle
+struct IntBox {
+   cInt x0, y0, x1, y1;
+};
+
+// state shared by the threads that process the tiles
+struct DensityPool {
+   Density *ds;
+   std::vector< std::vector<IntBox> > box;            // polygon boxes of each layer
+   std::vector< std::vector<unsigned int> > til;      // polygons in each layer tile
+   int next;
+   bool error;
+#if defined HAVE_PTHREADS
+   pthread_mutex_t lock;
+#endif
+};
+
+
+//-----------------------------------------------------------------
+
+static inline void
+empty_box(double *b)
+{
+   b[0] = b[1] = HUGE_VAL;
+   b[2] = b[3] = -HUGE_VAL;
+}
+
+
+//-----------------------------------------------------------------
+
+static inline void
+add_box(double *b, const double *t)
+{
+   if (t[0] < b[0]) b[0] = t[0];
+   if (t[1] < b[1]) b[1] = t[1];
+   if (t[2] > b[2]) b[2] = t[2];
+   if (t[3] > b[3]) b[3] = t[3];
+}
+
+
+//-----------------------------------------------------------------
+
+static inline bool
+overlaps(const double *a, const double *b)
+{
+   return a[0] < b[2] && a[2] > b[0] && a[1] < b[3] && a[3] > b[1];
+}
+
+
+//-----------------------------------------------------------------
+
+// bounding box of a transformed bounding box
+static void
+box_transform(double *tb, const double *bb, const affine_t &T)
+{
+   double x, y, u, v;
+   int k;
+
+   empty_box(tb);
+   if (bb[0] > bb[2])
+      return;
+
+   for (k=0; k<4; k++) {
+      x = bb[k & 1 ? 2 : 0];
+      y = bb[k & 2 ? 3 : 1];
+      u = T.a11 * x + T.a12 * y + T.tx;
+      v = T.a21 * x + T.a22 * y + T.ty;
+      if (u < tb[0]) tb[0] = u;
+      if (u > tb[2]) tb[2] = u;
+      if (v < tb[1]) tb[1] = v;
+      if (v > tb[3]) tb[3] = v;
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+static inline double
+affine_det(const affine_t &T)
+{
+   return fabs(T.a11 * T.a22 - T.a12 * T.a21);
+}
+
+
+//-----------------------------------------------------------------
+
+// transformation of the instance (i,j) of a reference
+static inline void
+instance_transform(affine_t &Ti, const affine_t &T, const fl_ref_t *r, int i, int j)
+{
+   affine_t R = r->T;
+
+   R.tx += i * r->dcol[0] + j * r->drow[0];
+   R.ty += i * r->dcol[1] + j * r->drow[1];
+   affine_compose(&Ti, &T, &R);
+}
+
+
+//-----------------------------------------------------------------
+
+// transforms a vertex list to database units
+static void
+transform_vertices(const double *xy, size_t nv, const affine_t &T, double ud, Path &p)
+{
+   size_t k;
+   double x, y;
+
+   p.resize(nv);
+   for (k=0; k<nv; k++) {
+      x = T.a11 * xy[2*k] + T.a12 * xy[2*k+1] + T.tx;
+      y = T.a21 * xy[2*k] + T.a22 * xy[2*k+1] + T.ty;
+      p[k] = IntPoint((cInt)floor(ud * x + 0.5), (cInt)floor(ud * y + 0.5));
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// appends the transformed, positively oriented polygons of a shape
+static void
+shape_polygons(Density &ds, const fl_cell_t *c, const fl_shape_t *sh,
+               const affine_t &T, Paths &out)
+{
+   Path p;
+   const fl_poly_t *pl;
+   const double *xy;
+   size_t k, m;
+
+   if (sh->kind == GDS_TEXT || sh->kind == GDS_NODE)
+      return;
+
+   for (k=0; k<sh->npoly; k++) {
+
+      pl = &c->poly[sh->poly + k];
+      xy = c->xy + 2*pl->v;
+
+      if (sh->kind != GDS_PATH) {
+	 transform_vertices(xy, pl->nv, T, ds.ud, p);
+	 if (p.size() < 3)
+	    continue;
+	 if ( !Orientation(p) )
+	    ReversePath(p);
+	 out.push_back(p);
+	 continue;
+      }
+
+      // paths are converted to polygons in the structure coordinates
+      if (sh->hw <= 0.0)
+	 continue;
+      ds.buf.resize(2 * pathpoly_size(xy, xy + 1, pl->nv, 2, sh->ptype));
+      if ( ds.buf.empty() )
+	 continue;
+      m = pathpoly(xy, xy + 1, pl->nv, 2, sh->hw, sh->ptype, sh->ext,
+                   &ds.buf[0], &ds.buf[1], 2);
+      transform_vertices(&ds.buf[0], m, T, ds.ud, p);
+      if ( !Orientation(p) )
+	 ReversePath(p);
+      out.push_back(p);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// area of the union of polygons in database units^2
+static double
+union_area(Clipper &C, const Paths &P)
+{
+   Paths sol;
+   double a = 0.0;
+   size_t k;
+
+   if ( P.empty() )
+      return 0.0;
+   C.AddPaths(P, ptSubject, true);
+   C.Execute(ctUnion, sol, pftNonZero, pftNonZero);
+   C.Clear();
+   for (k=0; k<sol.size(); k++)
+      a += Area(sol[k]);
+
+   return a;
+}
+
+
+//-----------------------------------------------------------------
+
+// computes the resolved bounding boxes and areas of a structure
+static const char *
+resolve_cell(Density &ds, size_t k, int depth, bool need_area)
+{
+   affine_t I = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+   fl_cell_t *c = &ds.lib->cell[k];
+   fl_shape_t *sh;
+   fl_ref_t *r;
+   std::vector<Paths> local;
+   double *bb = &ds.bbox[4*k*ds.nlay];
+   double *ca = &ds.carea[k*ds.nlay];
+   double *cb, tb[4], n;
+   const char *msg;
+   size_t m;
+   int l, q;
+
+   if (ds.state[k] == 2)
+      return NULL;
+   if (ds.state[k] == 1 || depth > MAX_DEPTH)
+      return "the structure hierarchy contains a cycle";
+   ds.state[k] = 1;
+
+   // shapes of the structure
+   for (l=0; l<ds.nlay; l++)
+      empty_box(bb + 4*l);
+   if (need_area)
+      local.resize(ds.nlay);
+   for (m=0; m<c->nsh; m++) {
+      sh = &c->sh[m];
+      l = ds.lmap[sh->layer];
+      if (l < 0 || sh->kind == GDS_TEXT || sh->kind == GDS_NODE)
+	 continue;
+      add_box(bb + 4*l, sh->bbox);
+      if (need_area)
+	 shape_polygons(ds, c, sh, I, local[l]);
+   }
+   for (l=0; l<ds.nlay; l++)
+      ca[l] = need_area ? union_area(ds.C, local[l]) / (ds.ud * ds.ud) : 0.0;
+
+   // referenced structures
+   for (m=0; m<c->nref; m++) {
+      r = &c->ref[m];
+      if (r->cell < 0)
+	 continue;
+      if ( (msg = resolve_cell(ds, r->cell, depth+1, need_area)) )
+	 return msg;
+      cb = &ds.bbox[4*r->cell*ds.nlay];
+      n = (double)r->ncol * r->nrow * affine_det(r->T);
+      for (l=0; l<ds.nlay; l++) {
+	 ca[l] += n * ds.carea[r->cell*ds.nlay + l];
+	 box_transform(tb, cb + 4*l, r->T);
+	 if (tb[0] > tb[2])
+	    continue;
+
+	 // the array instances in the four corners
+	 for (q=0; q<4; q++) {
+	    double dx = 0.0, dy = 0.0, cq[4];
+	    if (q & 1) {
+	       dx += (r->ncol - 1) * r->dcol[0];
+	       dy += (r->ncol - 1) * r->dcol[1];
+	    }
+	    if (q & 2) {
+	       dx += (r->nrow - 1) * r->drow[0];
+	       dy += (r->nrow - 1) * r->drow[1];
+	    }
+	    cq[0] = tb[0] + dx;  cq[2] = tb[2] + dx;
+	    cq[1] = tb[1] + dy;  cq[3] = tb[3] + dy;
+	    add_box(bb + 4*l, cq);
+	 }
+      }
+   }
+
+   ds.state[k] = 2;
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+// returns the tile containing the box b or -1 when the box is not
+// within a single tile of the grid
+static long
+single_tile(const DensityGrid &g, const double *b)
+{
+   double i0, i1, j0, j1;
+
+   i0 = floor((b[0] - g.x0) / g.dx);
+   i1 = ceil((b[2] - g.x0) / g.dx) - 1;
+   j0 = floor((b[1] - g.y0) / g.dy);
+   j1 = ceil((b[3] - g.y0) / g.dy) - 1;
+   if (i1 < i0) i1 = i0;
+   if (j1 < j0) j1 = j0;
+   if (i0 != i1 || j0 != j1 || i0 < 0 || j0 < 0 || i0 >= g.nx || j0 >= g.ny)
+      return -1;
+
+   return (long)i0 * g.ny + (long)j0;
+}
+
+
+//-----------------------------------------------------------------
+
+// expands structure k with transformation T on the layers in mask
+static const char *
+expand_cell(Density &ds, size_t k, const affine_t &T, int depth,
+            const std::vector<char> &mask)
+{
+   fl_cell_t *c = &ds.lib->cell[k];
+   fl_shape_t *sh;
+   fl_ref_t *r;
+   std::vector<char> sub(ds.nlay);
+   affine_t Ti;
+   const double *cb;
+   double tb[4], det;
+   const char *msg;
+   size_t m;
+   long t;
+   int i, j, l;
+   bool any;
+
+   if (depth > MAX_DEPTH)
+      return "the structure hierarchy contains a cycle";
+
+   // shapes
+   for (m=0; m<c->nsh; m++) {
+      sh = &c->sh[m];
+      l = ds.lmap[sh->layer];
+      if (l < 0 || !mask[l])
+	 continue;
+      box_transform(tb, sh->bbox, T);
+      if ( overlaps(tb, ds.win) )
+	 shape_polygons(ds, c, sh, T, ds.flat[l]);
+   }
+
+   // references
+   for (m=0; m<c->nref; m++) {
+
+      r = &c->ref[m];
+      if (r->cell < 0)
+	 continue;
+      cb = &ds.bbox[4*r->cell*ds.nlay];
+
+      for (j=0; j<r->nrow; j++) {
+	 for (i=0; i<r->ncol; i++) {
+
+	    instance_transform(Ti, T, r, i, j);
+	    det = affine_det(Ti);
+	    any = false;
+	    for (l=0; l<ds.nlay; l++) {
+	       sub[l] = 0;
+	       if (!mask[l])
+		  continue;
+	       box_transform(tb, cb + 4*l, Ti);
+	       if (tb[0] > tb[2] || !overlaps(tb, ds.win))
+		  continue;
+	       if (!ds.exact && (t = single_tile(ds.g, tb)) >= 0) {
+		  (*ds.area)[(size_t)l * ds.g.nx * ds.g.ny + t] +=
+		     det * ds.carea[r->cell*ds.nlay + l];
+		  continue;
+	       }
+	       sub[l] = 1;
+	       any = true;
+	    }
+
+	    if (any && (msg = expand_cell(ds, r->cell, Ti, depth+1, sub)))
+	       return msg;
+	 }
+      }
+   }
+
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+static IntBox
+path_box(const Path &p)
+{
+   IntBox b;
+   size_t k;
+
+   b.x0 = b.x1 = p[0].X;
+   b.y0 = b.y1 = p[0].Y;
+   for (k=1; k<p.size(); k++) {
+      if (p[k].X < b.x0) b.x0 = p[k].X;
+      if (p[k].X > b.x1) b.x1 = p[k].X;
+      if (p[k].Y < b.y0) b.y0 = p[k].Y;
+      if (p[k].Y > b.y1) b.y1 = p[k].Y;
+   }
+
+   return b;
+}
+
+
+//-----------------------------------------------------------------
+
+static inline int
+clamp(double k, int n)
+{
+   return k < 0 ? 0 : (k >= n ? n-1 : (int)k);
+}
+
+
+//-----------------------------------------------------------------
+
+// enters the expanded polygons into the tiles they overlap
+static void
+bin_polygons(DensityPool &dp)
+{
+   Density &ds = *dp.ds;
+   const DensityGrid &g = ds.g;
+   size_t nt = (size_t)g.nx * g.ny;
+   unsigned int k;
+   int l, i, j, ilo, ihi, jlo, jhi;
+   IntBox b;
+
+   dp.box.resize(ds.nlay);
+   dp.til.resize(ds.nlay * nt);
+   for (l=0; l<ds.nlay; l++) {
+      dp.box[l].resize(ds.flat[l].size());
+      for (k=0; k<ds.flat[l].size(); k++) {
+	 b = dp.box[l][k] = path_box(ds.flat[l][k]);
+	 ilo = clamp(floor((b.x0 / ds.ud - g.x0) / g.dx), g.nx);
+	 ihi = clamp(floor((b.x1 / ds.ud - g.x0) / g.dx), g.nx);
+	 jlo = clamp(floor((b.y0 / ds.ud - g.y0) / g.dy), g.ny);
+	 jhi = clamp(floor((b.y1 / ds.ud - g.y0) / g.dy), g.ny);
+	 for (i=ilo; i<=ihi; i++)
+	    for (j=jlo; j<=jhi; j++)
+	       dp.til[l*nt + (size_t)i*g.ny + j].push_back(k);
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// computes the covered area of one tile on one layer
+static void
+process_tile(DensityPool &dp, Clipper &C, size_t t)
+{
+   Density &ds = *dp.ds;
+   const DensityGrid &g = ds.g;
+   size_t nt = (size_t)g.nx * g.ny;
+   const std::vector<unsigned int> &idx = dp.til[t];
+   int l = (int)(t / nt);
+   int i = (int)((t % nt) / g.ny);
+   int j = (int)((t % nt) % g.ny);
+   const Paths &P = ds.flat[l];
+   Paths sol;
+   Path rect(4);
+   IntBox r, b;
+   double a = 0.0;
+   size_t k;
+
+   if ( idx.empty() )
+      return;
+
+   r.x0 = (cInt)floor(ds.ud * (g.x0 + i * g.dx) + 0.5);
+   r.x1 = (cInt)floor(ds.ud * (g.x0 + (i+1) * g.dx) + 0.5);
+   r.y0 = (cInt)floor(ds.ud * (g.y0 + j * g.dy) + 0.5);
+   r.y1 = (cInt)floor(ds.ud * (g.y0 + (j+1) * g.dy) + 0.5);
+
+   // a single polygon within the tile needs no clipping
+   b = dp.box[l][idx[0]];
+   if (idx.size() == 1 &&
+       b.x0 >= r.x0 && b.x1 <= r.x1 && b.y0 >= r.y0 && b.y1 <= r.y1) {
+      a = Area(P[idx[0]]);
+   }
+   else {
+      rect[0] = IntPoint(r.x0, r.y0);
+      rect[1] = IntPoint(r.x1, r.y0);
+      rect[2] = IntPoint(r.x1, r.y1);
+      rect[3] = IntPoint(r.x0, r.y1);
+      for (k=0; k<idx.size(); k++)
+	 C.AddPath(P[idx[k]], ptSubject, true);
+      C.AddPath(rect, ptClip, true);
+      C.Execute(ctIntersection, sol, pftNonZero, pftNonZero);
+      C.Clear();
+      for (k=0; k<sol.size(); k++)
+	 a += Area(sol[k]);
+   }
+
+   (*ds.area)[t] += a / (ds.ud * ds.ud);
+}
+
+
+//-----------------------------------------------------------------
+
+// processes tiles until none are left
+static void
+process_tiles(DensityPool &dp)
+{
+   Clipper C;
+   size_t ntil = dp.til.size();
+   bool ok;
+   long t;
+
+   while (1) {
+#if defined HAVE_PTHREADS
+      pthread_mutex_lock(&dp.lock);
+#endif
+      t = dp.error ? -1 : dp.next++;
+#if defined HAVE_PTHREADS
+      pthread_mutex_unlock(&dp.lock);
+#endif
+      if (t < 0 || (size_t)t >= ntil)
+	 break;
+
+      try {
+	 process_tile(dp, C, (size_t)t);
+	 ok = true;
+      }
+      catch (...) {
+	 ok = false;
+	 C.Clear();
+      }
+
+      if (!ok) {
+#if defined HAVE_PTHREADS
+	 pthread_mutex_lock(&dp.lock);
+#endif
+	 dp.error = true;
+#if defined HAVE_PTHREADS
+	 pthread_mutex_unlock(&dp.lock);
+#endif
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+#if defined HAVE_PTHREADS
+static void *
+tile_thread(void *arg)
+{
+   process_tiles(*(DensityPool *)arg);
+   return NULL;
+}
+#endif
+
+
+//-----------------------------------------------------------------
+
+// initializes the density state
+static void
+init_density(Density &ds, fl_library_t *lib, const std::vector<int> &lay)
+{
+   size_t k;
+
+   ds.lib = lib;
+   ds.nlay = (int)lay.size();
+   ds.lmap.assign(NLAYER, -1);
+   for (k=0; k<lay.size(); k++)
+      if (lay[k] >= 0 && lay[k] < NLAYER && ds.lmap[lay[k]] < 0)
+	 ds.lmap[lay[k]] = (int)k;
+   ds.state.assign(lib->ncell, 0);
+   ds.bbox.resize(4 * lib->ncell * lay.size());
+   ds.carea.resize(lib->ncell * lay.size());
+   ds.ud = 1.0;
+}
+
+
+//-----------------------------------------------------------------
+
+const char *
+DensityBBox(fl_library_t *lib, size_t top, const std::vector<int> &lay, double *bbox)
+{
+   Density ds;
+   const char *msg;
+   int l;
+
+   if (top >= lib->ncell)
+      return "invalid top structure";
+
+   init_density(ds, lib, lay);
+   if ( (msg = resolve_cell(ds, top, 0, false)) )
+      return msg;
+
+   empty_box(bbox);
+   for (l=0; l<ds.nlay; l++)
+      add_box(bbox, &ds.bbox[4*(top*ds.nlay + l)]);
+
+   return NULL;
+}
+
+
+//-----------------------------------------------------------------
+
+const char *
+LayerDensity(fl_library_t *lib, size_t top, const std::vector<int> &lay,
+             const DensityGrid &g, double ud, bool exact, int nthreads,
+             std::vector<double> &area)
+{
+   affine_t I = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+   Density ds;
+   DensityPool dp;
+   const char *msg;
+   int t, nstarted = 0;
+#if defined HAVE_PTHREADS
+   pthread_t tid[MAXTHREADS];
+#endif
+
+   if (top >= lib->ncell)
+      return "invalid top structure";
+   if (g.nx < 1 || g.ny < 1 || g.dx <= 0.0 || g.dy <= 0.0)
+      return "invalid density grid";
+
+   init_density(ds, lib, lay);
+   ds.ud = ud;
+   ds.exact = exact;
+   ds.g = g;
+   ds.win[0] = g.x0;
+   ds.win[1] = g.y0;
+   ds.win[2] = g.x0 + g.nx * g.dx;
+   ds.win[3] = g.y0 + g.ny * g.dy;
+   ds.flat.resize(ds.nlay);
+   ds.area = &area;
+   area.assign(lay.size() * g.nx * g.ny, 0.0);
+
+   try {
+      // resolved areas once per structure, then expand the
+      // instances that cross tile borders
+      if ( (msg = resolve_cell(ds, top, 0, !exact)) )
+	 return msg;
+      if ( (msg = expand_cell(ds, top, I, 0, std::vector<char>(ds.nlay, 1))) )
+	 return msg;
+   }
+   catch (...) {
+      return "Clipper library error";
+   }
+
+   // clip the expanded polygons to the tiles
+   dp.ds = &ds;
+   dp.next = 0;
+   dp.error = false;
+   bin_polygons(dp);
+
+   if (nthreads < 1) {
+#if defined HAVE_PTHREADS
+      nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+      nthreads = 1;
+#endif
+   }
+   if ((size_t)nthreads > dp.til.size())
+      nthreads = (int)dp.til.size();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+
+#if defined HAVE_PTHREADS
+   pthread_mutex_init(&dp.lock, NULL);
+   if (nthreads > 1) {
+      for (nstarted=0; nstarted<nthreads; nstarted++) {
+	 if ( pthread_create(&tid[nstarted], NULL, tile_thread, &dp) )
+	    break;
+      }
+   }
+#endif
+   if (!nstarted)
+      process_tiles(dp);
+#if defined HAVE_PTHREADS
+   for (t=0; t<nstarted; t++)
+      pthread_join(tid[t], NULL);
+   pthread_mutex_destroy(&dp.lock);
+#endif
+   if (dp.error)
+      return "Clipper library error";
+
+   return NULL;
+}
+
+} // ClipperLib namespace
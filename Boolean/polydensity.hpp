@@ -0,0 +1,70 @@
+// Layer density maps for the GDS II toolbox
+//
+// Computes the area covered by the shapes on a set of layers in
+// each tile of a rectangular grid over the resolved hierarchy of a
+// structure. The hierarchy is described by a library of structures
+// (see Basic/gdsio/flatten.h).
+//
+// Hierarchical reuse: the area of each structure on each layer
+// (including everything it references) is computed only once.
+// An instance of a structure whose transformed bounding box lies
+// within a single tile contributes its area to that tile without
+// being expanded; this applies to each element of an array
+// reference separately. The shapes of instances that cross tile
+// borders are transformed and clipped to the tiles with the Clipper
+// library, and the tiles are processed in parallel. Overlapping
+// shapes within a tile are merged, but shapes of instances that are
+// not expanded are assumed not to overlap other shapes on the same
+// layer. The exact mode expands all instances.
+//
+// Copyright (c) 2026
+
+#ifndef _POLYDENSITY_HPP
+#define _POLYDENSITY_HPP
+
+#include <vector>
+#include "clipper.hpp"
+
+extern "C" {
+#include "flatten.h"
+}
+
+namespace ClipperLib {
+
+//
+// the density grid; tile (i,j) is the rectangle
+// [x0 + i*dx, y0 + j*dy, x0 + (i+1)*dx, y0 + (j+1)*dy]
+//
+struct DensityGrid {
+   double x0, y0;        // lower left corner of the grid
+   double dx, dy;        // tile size
+   int nx, ny;           // number of tiles
+};
+
+//
+// returns the bounding box [llx,lly,urx,ury] of the shapes on the
+// layers lay (all data types) in the resolved structure top. The
+// box is empty (llx > urx) when there are no shapes on the layers.
+// Returns NULL on success or an error message.
+//
+const char *DensityBBox(fl_library_t *lib, size_t top,
+                        const std::vector<int> &lay, double *bbox);
+
+//
+// computes the covered area in user units^2 of each tile on each
+// layer in lay. area has lay.size() * ny * nx elements; the area of
+// tile (i,j) on layer k is area[(k*nx + i)*ny + j], i.e. each layer
+// is an ny x nx matrix in column-major order. ud is the conversion
+// factor from user units to database units; the shapes are clipped
+// with database unit resolution. When exact is true, all instances
+// are expanded. nthreads < 1 selects one thread per processor.
+// Returns NULL on success or an error message.
+//
+const char *LayerDensity(fl_library_t *lib, size_t top,
+                         const std::vector<int> &lay, const DensityGrid &g,
+                         double ud, bool exact, int nthreads,
+                         std::vector<double> &area);
+
+} // ClipperLib namespace
+
+#endif // _POLYDENSITY_HPP
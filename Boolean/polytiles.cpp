@@ -0,0 +1,392 @@
+// Tiled processing of polygon sets with the Clipper library
+// for the GDS II toolbox (see polytiles.hpp)
+//
+// Copyright (c) 2026
+
+#include <vector>
+#include "clipper.hpp"
+#include "polytiles.hpp"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+
+
+namespace ClipperLib {
+
+//-----------------------------------------------------------------
+
+// a rectangle
+struct Box {
+   cInt x0, y0, x1, y1;
+};
+
+// the result of one tile
+struct TileResult {
+   Paths inner;      // polygons (with holes) inside the tile
+   Paths border;     // polygons that touch the tile border
+};
+
+// state shared by the threads
+struct TilePool {
+   const Paths *pa, *pb;
+   std::vector<Box> boxa, boxb;      // bounding boxes of the polygons
+   std::vector< std::vector<unsigned int> > tila, tilb; // polygons in tiles
+   std::vector<TileResult> res;
+   cInt x0, y0, dx, dy, margin;
+   int nx, ny;
+   PolyFillType fill;                // fill rule of the input polygons
+   TileFunc func;
+   void *arg;
+   int next;                         // next tile to process
+   bool error;
+#if defined HAVE_PTHREADS
+   pthread_mutex_t lock;
+#endif
+};
+
+
+//-----------------------------------------------------------------
+
+static Box
+path_box(const Path &p)
+{
+   Box b;
+   unsigned int k;
+
+   b.x0 = b.x1 = p[0].X;
+   b.y0 = b.y1 = p[0].Y;
+   for (k=1; k<p.size(); k++) {
+      if (p[k].X < b.x0) b.x0 = p[k].X;
+      if (p[k].X > b.x1) b.x1 = p[k].X;
+      if (p[k].Y < b.y0) b.y0 = p[k].Y;
+      if (p[k].Y > b.y1) b.y1 = p[k].Y;
+   }
+
+   return b;
+}
+
+
+//-----------------------------------------------------------------
+
+// floor division for a positive divisor
+static inline cInt
+floor_div(cInt a, cInt b)
+{
+   return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+
+//-----------------------------------------------------------------
+
+static inline int
+clamp(cInt k, int n)
+{
+   return k < 0 ? 0 : (k >= n ? n-1 : (int)k);
+}
+
+
+//-----------------------------------------------------------------
+
+// enters the polygons into the tiles they overlap
+static void
+bin_polygons(TilePool &tp, const Paths &P, std::vector<Box> &box,
+	     std::vector< std::vector<unsigned int> > &til)
+{
+   unsigned int k;
+   int i, j, ilo, ihi, jlo, jhi;
+
+   box.resize(P.size());
+   for (k=0; k<P.size(); k++) {
+      box[k] = path_box(P[k]);
+      ilo = clamp(floor_div(box[k].x0 - tp.margin - tp.x0, tp.dx), tp.nx);
+      ihi = clamp(floor_div(box[k].x1 + tp.margin - tp.x0, tp.dx), tp.nx);
+      jlo = clamp(floor_div(box[k].y0 - tp.margin - tp.y0, tp.dy), tp.ny);
+      jhi = clamp(floor_div(box[k].y1 + tp.margin - tp.y0, tp.dy), tp.ny);
+      for (j=jlo; j<=jhi; j++)
+	 for (i=ilo; i<=ihi; i++)
+	    til[j*tp.nx + i].push_back(k);
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+// returns the polygons of a tile clipped to the rectangle r
+static void
+tile_polygons(Clipper &C, const Paths &P, const std::vector<Box> &box,
+	      const std::vector<unsigned int> &idx, const Box &r,
+	      PolyFillType fill, Paths &out)
+{
+   Paths cross, clipped;
+   Path rect(4);
+   unsigned int k, n;
+
+   // even-odd filling is additive: polygons inside the tile are
+   // kept as they are and polygons crossing the border can be
+   // clipped separately. With other fill rules all polygons are
+   // clipped, which also merges them.
+   out.clear();
+   for (k=0; k<idx.size(); k++) {
+      n = idx[k];
+      if (fill == pftEvenOdd &&
+	  box[n].x0 >= r.x0 && box[n].x1 <= r.x1 &&
+	  box[n].y0 >= r.y0 && box[n].y1 <= r.y1)
+	 out.push_back(P[n]);
+      else
+	 cross.push_back(P[n]);
+   }
+
+   if ( cross.size() ) {
+      rect[0] = IntPoint(r.x0, r.y0);
+      rect[1] = IntPoint(r.x1, r.y0);
+      rect[2] = IntPoint(r.x1, r.y1);
+      rect[3] = IntPoint(r.x0, r.y1);
+      C.AddPaths(cross, ptSubject, true);
+      C.AddPath(rect, ptClip, true);
+      C.Execute(ctIntersection, clipped, fill, pftNonZero);
+      C.Clear();
+      out.insert(out.end(), clipped.begin(), clipped.end());
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+static bool
+touches_box(const Path &p, const Box &r)
+{
+   unsigned int k;
+
+   for (k=0; k<p.size(); k++) {
+      if (p[k].X <= r.x0 || p[k].X >= r.x1 || p[k].Y <= r.y0 || p[k].Y >= r.y1)
+	 return true;
+   }
+
+   return false;
+}
+
+
+//-----------------------------------------------------------------
+
+// processes one tile; returns false if an error occurred
+static bool
+process_tile(TilePool &tp, Clipper &C, int t)
+{
+   Paths a, b;
+   PolyTree tree;
+   PolyNode *pn;
+   Box r, er;
+   Path rect(4);
+   Paths *dest;
+   int i, j, k;
+
+   i = t % tp.nx;
+   j = t / tp.nx;
+   if ( tp.tila[t].empty() && tp.tilb[t].empty() )
+      return true;
+
+   // tile rectangle and tile with margin
+   r.x0 = tp.x0 + i*tp.dx;  r.x1 = r.x0 + tp.dx;
+   r.y0 = tp.y0 + j*tp.dy;  r.y1 = r.y0 + tp.dy;
+   er.x0 = r.x0 - tp.margin;  er.x1 = r.x1 + tp.margin;
+   er.y0 = r.y0 - tp.margin;  er.y1 = r.y1 + tp.margin;
+   rect[0] = IntPoint(r.x0, r.y0);
+   rect[1] = IntPoint(r.x1, r.y0);
+   rect[2] = IntPoint(r.x1, r.y1);
+   rect[3] = IntPoint(r.x0, r.y1);
+
+   tile_polygons(C, *tp.pa, tp.boxa, tp.tila[t], er, tp.fill, a);
+   tile_polygons(C, *tp.pb, tp.boxb, tp.tilb[t], er, tp.fill, b);
+
+   // polygons that only touch the tile are clipped away; Clipper
+   // reports an error for an empty input
+   if ( a.empty() && b.empty() )
+      return true;
+
+   if ( !tp.func(C, a, b, rect, tree, tp.arg) )
+      return false;
+   C.Clear();
+
+   // sort the polygons with their holes
+   for (pn = tree.GetFirst(); pn; pn = pn->GetNext()) {
+      if ( pn->IsHole() )
+	 continue;
+      dest = touches_box(pn->Contour, r) ? &tp.res[t].border : &tp.res[t].inner;
+      dest->push_back(pn->Contour);
+      for (k=0; k<pn->ChildCount(); k++)
+	 dest->push_back(pn->Childs[k]->Contour);
+   }
+
+   return true;
+}
+
+
+//-----------------------------------------------------------------
+
+// processes tiles until none are left
+static void
+process_tiles(TilePool &tp)
+{
+   Clipper C;
+   bool ok;
+   int t;
+
+   while (1) {
+#if defined HAVE_PTHREADS
+      pthread_mutex_lock(&tp.lock);
+#endif
+      t = tp.error ? -1 : tp.next++;
+#if defined HAVE_PTHREADS
+      pthread_mutex_unlock(&tp.lock);
+#endif
+      if (t < 0 || t >= tp.nx*tp.ny)
+	 break;
+
+      try {
+	 ok = process_tile(tp, C, t);
+      }
+      catch (...) {
+	 ok = false;
+	 C.Clear();
+      }
+
+      if (!ok) {
+#if defined HAVE_PTHREADS
+	 pthread_mutex_lock(&tp.lock);
+#endif
+	 tp.error = true;
+#if defined HAVE_PTHREADS
+	 pthread_mutex_unlock(&tp.lock);
+#endif
+      }
+   }
+}
+
+
+//-----------------------------------------------------------------
+
+#if defined HAVE_PTHREADS
+static void *
+tile_thread(void *arg)
+{
+   process_tiles(*(TilePool *)arg);
+   return NULL;
+}
+#endif
+
+
+//-----------------------------------------------------------------
+
+bool
+TiledExecute(const Paths &pa, const Paths &pb, int nx, int ny, cInt margin,
+	     PolyFillType fill, int nthreads, TileFunc func, void *arg, Paths &pc)
+{
+   TilePool tp;
+   Paths border, merged;
+   Box bb, b;
+   Clipper U;
+   unsigned int k;
+   int t, nt, nstarted = 0;
+#if defined HAVE_PTHREADS
+   pthread_t tid[MAXTHREADS];
+#endif
+
+   if ( pa.empty() && pb.empty() )
+      return true;
+
+   // bounding box of all polygons
+   bb = !pa.empty() ? path_box(pa[0]) : path_box(pb[0]);
+   for (k=0; k<pa.size()+pb.size(); k++) {
+      b = path_box(k < pa.size() ? pa[k] : pb[k-pa.size()]);
+      if (b.x0 < bb.x0) bb.x0 = b.x0;
+      if (b.x1 > bb.x1) bb.x1 = b.x1;
+      if (b.y0 < bb.y0) bb.y0 = b.y0;
+      if (b.y1 > bb.y1) bb.y1 = b.y1;
+   }
+
+   // tile grid
+   if (nx < 1) nx = 1;
+   if (ny < 1) ny = 1;
+   tp.nx = nx;
+   tp.ny = ny;
+   tp.x0 = bb.x0;
+   tp.y0 = bb.y0;
+   tp.dx = (bb.x1 - bb.x0 + nx - 1) / nx;
+   tp.dy = (bb.y1 - bb.y0 + ny - 1) / ny;
+   if (tp.dx < 1) tp.dx = 1;
+   if (tp.dy < 1) tp.dy = 1;
+   tp.margin = margin;
+   tp.pa = &pa;
+   tp.pb = &pb;
+   tp.fill = fill;
+   tp.func = func;
+   tp.arg = arg;
+   tp.next = 0;
+   tp.error = false;
+   nt = nx*ny;
+   tp.tila.resize(nt);
+   tp.tilb.resize(nt);
+   tp.res.resize(nt);
+   bin_polygons(tp, pa, tp.boxa, tp.tila);
+   bin_polygons(tp, pb, tp.boxb, tp.tilb);
+
+   // process the tiles
+   if (nthreads < 1) {
+#if defined HAVE_PTHREADS
+      nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+      nthreads = 1;
+#endif
+   }
+   if (nthreads > nt)
+      nthreads = nt;
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+
+#if defined HAVE_PTHREADS
+   pthread_mutex_init(&tp.lock, NULL);
+   if (nthreads > 1) {
+      for (nstarted=0; nstarted<nthreads; nstarted++) {
+	 if ( pthread_create(&tid[nstarted], NULL, tile_thread, &tp) )
+	    break;
+      }
+   }
+#endif
+   if (!nstarted)
+      process_tiles(tp);
+#if defined HAVE_PTHREADS
+   for (t=0; t<nstarted; t++)
+      pthread_join(tid[t], NULL);
+   pthread_mutex_destroy(&tp.lock);
+#endif
+   if (tp.error)
+      return false;
+
+   // collect the results in tile order
+   for (t=0; t<nt; t++) {
+      pc.insert(pc.end(), tp.res[t].inner.begin(), tp.res[t].inner.end());
+      border.insert(border.end(), tp.res[t].border.begin(), tp.res[t].border.end());
+   }
+
+   // merge the polygons along the tile borders
+   if ( border.size() ) {
+      try {
+	 U.AddPaths(border, ptSubject, true);
+	 if ( !U.Execute(ctUnion, merged, pftNonZero, pftNonZero) )
+	    return false;
+      }
+      catch (...) {
+	 return false;
+      }
+      pc.insert(pc.end(), merged.begin(), merged.end());
+   }
+
+   return true;
+}
+
+} // ClipperLib namespace
@@ -0,0 +1,43 @@
+// Tiled processing of polygon sets with the Clipper library
+// for the GDS II toolbox
+//
+// The bounding box of the input polygons is divided into a grid of
+// tiles. The polygons are clipped to each tile, the tiles are
+// processed in parallel by a pool of threads, each with its own
+// Clipper object, and the result polygons that touch a tile border
+// are merged at the end. Result polygons that lie entirely within
+// a tile are returned as they are.
+//
+// Copyright (c) 2026
+
+#ifndef _POLYTILES_HPP
+#define _POLYTILES_HPP
+
+#include "clipper.hpp"
+
+namespace ClipperLib {
+
+//
+// computes the result for one tile. The input polygons a and b are
+// clipped to the tile rectangle enlarged by the margin; rect is the
+// tile rectangle without margin. The result polygons must lie within
+// rect. Returns false if an error occurred.
+//
+typedef bool (*TileFunc)(Clipper &C, Paths &a, Paths &b, const Path &rect,
+                         PolyTree &res, void *arg);
+
+//
+// processes the polygons pa and pb in nx x ny tiles with nthreads
+// threads and appends the merged results to pc. Polygons in pa and
+// pb are filled with the rule fill when they are clipped to the
+// tiles. For fill rules other than pftEvenOdd the polygons passed
+// to the tile function are merged. When nthreads < 1 the number of
+// processors is used. Returns false if an error occurred.
+//
+bool TiledExecute(const Paths &pa, const Paths &pb, int nx, int ny, cInt margin,
+                  PolyFillType fill, int nthreads, TileFunc func, void *arg,
+                  Paths &pc);
+
+} // ClipperLib namespace
+
+#endif // _POLYTILES_HPP
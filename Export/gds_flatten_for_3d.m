@@ -18,6 +18,10 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
 %       'structure_name'  - Name of structure to flatten (for gds_library input)
 %                           If not specified, uses top-level structure
 %       'max_depth'       - Maximum recursion depth (default: unlimited = -1)
+%       'window'          - [llx, lly, urx, ury]; only elements whose bounding
+%                           box overlaps the window are returned (default: [])
+%       'convert_paths'   - when true, path elements are returned as
+%                           boundary elements (default: false)
 %       'verbose'         - Verbosity level 0/1/2 (default: 0)
 %
 % OUTPUT:
@@ -27,18 +31,15 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
 %                  copies of their referenced structures
 %
 % ALGORITHM:
-%   1. Build structure lookup table from library
-%   2. For each structure, recursively flatten references bottom-up
-%   3. For each sref element:
-%      - Retrieve referenced structure
-%      - Apply strans transformation (reflection, rotation, magnification)
-%      - Translate to reference position
-%      - Replace sref with transformed elements
-%   4. For each aref element:
-%      - Retrieve referenced structure
-%      - Apply strans to individual instances
-%      - Replicate across array with proper spacing
-%      - Replace aref with all array instances
+%   1. Collect the element data of all structures (once per structure)
+%   2. gds_flatten_mex walks the hierarchy below the target structure:
+%      - the strans of each sref and aref is composed with the
+%        transformation of its parent into a 2x3 affine transformation
+%      - aref lattices are expanded without copying the structure
+%      - the transformed vertices of all shapes are written to one
+%        vertex buffer per layer
+%      - with a window, references outside the window are skipped
+%   3. Transformed copies of the elements are created from the buffers
 %
 % TRANSFORMATION ORDER (per GDSII spec):
 %   1. Reflection about x-axis (if strans.reflect = 1)
@@ -64,17 +65,19 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
 %   gstruct_flat = gds_flatten_for_3d(gstruct);
 %
 % NOTES:
-%   - This function does NOT convert paths to boundaries (use poly_convert)
-%   - Text and node elements are preserved but not transformed
+%   - Paths are converted to boundaries only with 'convert_paths'; the
+%     conversion is done in compiled code while the hierarchy is flattened
+%   - Text and node positions are transformed; path widths are magnified
 %   - Handles nested references (references within references)
 %   - Preserves layer/datatype information
 %   - Absolute magnification/angle (strans.absmag, strans.absang) not supported
-%   - Very deep hierarchies may cause stack overflow or long processing times
+%   - Cyclic references are reported as an error
 %
 % PERFORMANCE:
-%   - Complexity: O(N * D) where N = elements, D = hierarchy depth
+%   - The hierarchy is flattened in compiled code (gds_flatten_mex);
+%     the time is dominated by creating the output elements
 %   - Memory: Proportional to flattened element count
-%   - For large designs with deep hierarchies, consider max_depth limit
+%   - For large designs, use a window or a max_depth limit
 %
 % SEE ALSO:
 %   poly_convert, gds_layer_to_3d, gds_to_step, adjmatrix, topstruct
@@ -114,7 +117,7 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
     end
 
 % =========================================================================
-% GET TARGET STRUCTURE AND BUILD STRUCTURE LOOKUP
+% GET TARGET STRUCTURE AND COLLECT STRUCTURES
 % =========================================================================
 
     % Determine if input is library or structure
@@ -145,33 +148,26 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
             end
         end
         
-        % Build structure lookup table from library
-        struct_map = build_structure_map(glib);
-        
-        % Get target structure
-        if ~isKey(struct_map, target_name)
+        % All structures of the library
+        structs = glib.st;
+        names = cellfun(@(s) get(s, 'sname'), structs, 'UniformOutput', false);
+        top = find(strcmp(names, target_name), 1);
+        if isempty(top)
             error('gds_flatten_for_3d:StructureNotFound', ...
                   'Structure "%s" not found in library', target_name);
         end
-        gstruct = struct_map(target_name);
         
     else
-        % Input is already a structure
-        gstruct = gds_input;
-        target_name = get(gstruct, 'sname');
+        % Input is already a structure; references to other
+        % structures cannot be resolved and are skipped
+        target_name = get(gds_input, 'sname');
+        structs = {gds_input};
+        names = {target_name};
+        top = 1;
         
         if params.verbose >= 1
             fprintf('Target structure: %s\n', target_name);
         end
-        
-        % Build structure map with just this structure (limited flattening)
-        % This will only work if all referenced structures are available
-        % For now, create a minimal map with just this structure
-        struct_map = containers.Map('KeyType', 'char', 'ValueType', 'any');
-        struct_map(target_name) = gstruct;
-        
-        % Note: If gstruct references other structures not in map,
-        % those references will be skipped with a warning
     end
 
 % =========================================================================
@@ -185,8 +181,34 @@ function gstruct_flat = gds_flatten_for_3d(gds_input, varargin)
         fprintf('Flattening structure hierarchy...\n');
     end
     
-    % Flatten recursively
-    [gstruct_flat, stats] = flatten_structure(gstruct, struct_map, params, 0);
+    % element data of all structures; each structure is converted
+    % only once, no matter how often it is referenced
+    el_cells = cell(size(structs));
+    el_data = cell(size(structs));
+    for k = 1:numel(structs)
+        el_cells{k} = get(structs{k});
+        el_data{k} = cellfun(@get, el_cells{k}, 'UniformOutput', false);
+    end
+    
+    % compose the transformations and transform all shapes
+    [lay, ins, stats] = gds_flatten_mex(el_data, names, top, ...
+                                        params.max_depth, params.window, ...
+                                        params.convert_paths);
+    
+    if stats.missing_refs > 0 && params.verbose >= 1
+        warning('gds_flatten_for_3d:MissingReference', ...
+                '%d references to missing structures were skipped', ...
+                stats.missing_refs);
+    end
+    if stats.absolute_strans > 0
+        warning('gds_flatten_for_3d:UnsupportedAbsMagAng', ...
+                'Absolute magnification/angle (strans.absmag, strans.absang) not supported');
+    end
+    
+    % create the output elements from the transformed vertices
+    gstruct_flat = gds_structure(target_name, ...
+                                 create_elements(el_cells, lay, ins, ...
+                                               params.convert_paths));
     
     % Report results
     if params.verbose >= 1
@@ -217,6 +239,8 @@ function params = parse_parameters(varargin)
     params.structure_name = '';
     params.max_depth = -1;  % Unlimited
     params.verbose = 0;
+    params.window = [];
+    params.convert_paths = false;
     
     % Parse varargin
     k = 1;
@@ -253,6 +277,17 @@ function params = parse_parameters(varargin)
                 end
                 params.verbose = round(param_value);
                 
+            case 'window'
+                if ~isnumeric(param_value) || ...
+                   (~isempty(param_value) && numel(param_value) ~= 4)
+                    error('gds_flatten_for_3d:InvalidWindow', ...
+                          'window must be a vector [llx, lly, urx, ury]');
+                end
+                params.window = param_value;
+                
+            case 'convert_paths'
+                params.convert_paths = logical(param_value);
+                
             otherwise
                 warning('gds_flatten_for_3d:UnknownParameter', ...
                         'Unknown parameter: %s', varargin{k});
@@ -264,386 +299,57 @@ end
 
 
 %% ========================================================================
-%% HELPER FUNCTION: BUILD STRUCTURE MAP
-%% ========================================================================
-
-function struct_map = build_structure_map(glib)
-% Build a map from structure names to gds_structure objects
-
-    num_structs = length(glib);
-    struct_map = containers.Map('KeyType', 'char', 'ValueType', 'any');
-    
-    for k = 1:num_structs
-        gstruct = glib.st{k};
-        sname_str = get(gstruct, 'sname');
-        struct_map(sname_str) = gstruct;
-    end
-end
-
-
-%% ========================================================================
-%% CORE FUNCTION: FLATTEN STRUCTURE RECURSIVELY
+%% HELPER FUNCTION: CREATE ELEMENTS
 %% ========================================================================
 
-function [gstruct_out, stats] = flatten_structure(gstruct, struct_map, params, depth)
-% Recursively flatten a structure by resolving all references
+function new_elements = create_elements(el_cells, lay, ins, convert_paths)
+% Create the elements of the flattened structure
 %
 % INPUT:
-%   gstruct    : gds_structure to flatten
-%   struct_map : Map of structure names to gds_structure objects
-%   params     : Parameter structure
-%   depth      : Current recursion depth
+%   el_cells      : cell array with the element cell arrays of all structures
+%   lay           : layer vertex buffers returned by gds_flatten_mex
+%   ins           : shape instances returned by gds_flatten_mex
+%   convert_paths : paths were returned as polygons by gds_flatten_mex
 %
 % OUTPUT:
-%   gstruct_out : Flattened gds_structure
-%   stats       : Statistics structure
+%   new_elements : cell array with transformed copies of the elements
 
-    % Initialize statistics
-    stats.refs_resolved = 0;
-    stats.arefs_resolved = 0;
-    stats.elements_created = 0;
-    stats.max_depth_reached = depth;
-    
-    % Check depth limit
-    if params.max_depth >= 0 && depth > params.max_depth
-        if params.verbose >= 2
-            fprintf('  [Depth %d] Max depth reached, stopping recursion\n', depth);
-        end
-        gstruct_out = gstruct;
-        return;
+    % split the vertex buffers into polygons
+    lay_poly = cell(1, numel(lay));
+    for k = 1:numel(lay)
+        lay_poly{k} = mat2cell(lay(k).xy, lay(k).nv, 2);
     end
     
-    % Get structure name and elements
-    struct_name = get(gstruct, 'sname');
-    el_cell = gstruct(:);  % Get all elements as cell array
-    num_elements = length(el_cell);
-    
-    if params.verbose >= 2
-        fprintf('  [Depth %d] Flattening structure: %s (%d elements)\n', ...
-                depth, struct_name, num_elements);
-    end
-    
-    % Create output structure - we'll rebuild it from scratch
-    new_elements = {};
-    
-    % Process each element
-    for k = 1:num_elements
-        gel = el_cell{k};
+    new_elements = cell(1, size(ins,1));
+    for k = 1:size(ins,1)
+        gel = el_cells{ins(k,1)}{ins(k,2)};
+        pxy = lay_poly{ins(k,3)}(ins(k,4):ins(k,4)+ins(k,5)-1);
         
-        % Check if element is a reference
-        if is_ref(gel)
-            % Get reference name
-            ref_name = sname(gel);
-            
-            % Check if referenced structure exists in map
-            if ~isKey(struct_map, ref_name)
-                if params.verbose >= 1
-                    warning('gds_flatten_for_3d:MissingReference', ...
-                            'Referenced structure "%s" not found, skipping', ref_name);
-                end
-                continue;
-            end
-            
-            % Get referenced structure
-            ref_struct = struct_map(ref_name);
-            
-            % Recursively flatten referenced structure first
-            [ref_struct_flat, ref_stats] = flatten_structure(ref_struct, struct_map, params, depth + 1);
-            
-            % Accumulate statistics
-            stats.refs_resolved = stats.refs_resolved + ref_stats.refs_resolved;
-            stats.arefs_resolved = stats.arefs_resolved + ref_stats.arefs_resolved;
-            stats.elements_created = stats.elements_created + ref_stats.elements_created;
-            stats.max_depth_reached = max(stats.max_depth_reached, ref_stats.max_depth_reached);
-            
-            % Determine if sref or aref
-            gel_type = etype(gel);
-            
-            if strcmp(gel_type, 'sref')
-                % Handle structure reference
-                transformed_elements = flatten_sref(gel, ref_struct_flat, params, depth);
-                stats.refs_resolved = stats.refs_resolved + 1;
-                stats.elements_created = stats.elements_created + length(transformed_elements);
-                
-            elseif strcmp(gel_type, 'aref')
-                % Handle array reference
-                transformed_elements = flatten_aref(gel, ref_struct_flat, params, depth);
-                stats.arefs_resolved = stats.arefs_resolved + 1;
-                stats.elements_created = stats.elements_created + length(transformed_elements);
+        switch etype(gel)
+            case 'boundary'
+                gel = set(gel, 'xy', pxy(:)');
                 
-            else
-                % Should not reach here
-                warning('gds_flatten_for_3d:UnexpectedRefType', ...
-                        'Unexpected reference type: %s', gel_type);
-                transformed_elements = {};
-            end
-            
-            % Add transformed elements to output
-            new_elements = [new_elements, transformed_elements];
-            
-        else
-            % Not a reference, keep element as-is
-            new_elements{end+1} = gel;
-        end
-    end
-    
-    % Create new structure with flattened elements
-    % We need to create a new gds_structure from scratch
-    gstruct_out = gds_structure(struct_name, new_elements);
-    
-    if params.verbose >= 2
-        fprintf('  [Depth %d] Flattened %s: %d -> %d elements\n', ...
-                depth, struct_name, num_elements, length(new_elements));
-    end
-end
-
-
-%% ========================================================================
-%% HELPER FUNCTION: FLATTEN SREF
-%% ========================================================================
-
-function transformed_elements = flatten_sref(sref_element, ref_struct, params, depth)
-% Flatten a single structure reference (sref)
-%
-% Applies transformation according to GDSII spec:
-%   1. Reflect about x-axis (if strans.reflect = 1)
-%   2. Rotate by strans.angle degrees
-%   3. Magnify by strans.mag
-%   4. Translate to sref xy position
-
-    transformed_elements = {};
-    
-    % Get sref properties
-    ref_xy = get(sref_element, 'xy');
-    if iscell(ref_xy)
-        ref_xy = ref_xy{1};  % Extract from cell if needed
-    end
-    ref_pos = ref_xy(1, :);  % Reference position
-    
-    % Get strans (may be empty)
-    try
-        ref_strans = strans(sref_element);
-    catch
-        ref_strans = [];
-    end
-    
-    if params.verbose >= 2
-        fprintf('    [Depth %d] Resolving sref: %s at [%.2f, %.2f]\n', ...
-                depth, sname(sref_element), ref_pos(1), ref_pos(2));
-    end
-    
-    % Get all elements from referenced structure
-    ref_elements = ref_struct(:);
-    
-    % Transform each element
-    for k = 1:length(ref_elements)
-        gel = ref_elements{k};
-        
-        % Skip reference elements (should already be flattened)
-        if is_ref(gel)
-            continue;
-        end
-        
-        % Transform element
-        gel_transformed = apply_transformation_to_element(gel, ref_strans, ref_pos);
-        
-        if ~isempty(gel_transformed)
-            transformed_elements{end+1} = gel_transformed;
-        end
-    end
-end
-
-
-%% ========================================================================
-%% HELPER FUNCTION: FLATTEN AREF
-%% ========================================================================
-
-function transformed_elements = flatten_aref(aref_element, ref_struct, params, depth)
-% Flatten an array reference (aref)
-%
-% For each instance in the array:
-%   1. Apply strans to individual instance
-%   2. Calculate array position
-%   3. Translate to array position
-
-    transformed_elements = {};
-    
-    % Get aref properties
-    ref_xy = get(aref_element, 'xy');
-    if iscell(ref_xy)
-        ref_xy = ref_xy{1};
-    end
-    
-    % aref xy contains 3 points:
-    %   xy(1,:) = origin (reference point)
-    %   xy(2,:) = column_spacing * num_columns + origin
-    %   xy(3,:) = row_spacing * num_rows + origin
-    origin = ref_xy(1, :);
-    col_vec = ref_xy(2, :);
-    row_vec = ref_xy(3, :);
-    
-    % Get array dimensions
-    ref_adim = adim(aref_element);
-    num_cols = ref_adim.col;
-    num_rows = ref_adim.row;
-    
-    % Calculate spacing vectors
-    col_spacing = (col_vec - origin) / num_cols;
-    row_spacing = (row_vec - origin) / num_rows;
-    
-    % Get strans (may be empty)
-    try
-        ref_strans = strans(aref_element);
-    catch
-        ref_strans = [];
-    end
-    
-    if params.verbose >= 2
-        fprintf('    [Depth %d] Resolving aref: %s [%d x %d array]\n', ...
-                depth, sname(aref_element), num_rows, num_cols);
-    end
-    
-    % Get all elements from referenced structure
-    ref_elements = ref_struct(:);
-    
-    % Replicate across array
-    for row = 0:(num_rows-1)
-        for col = 0:(num_cols-1)
-            % Calculate position for this instance
-            instance_pos = origin + col * col_spacing + row * row_spacing;
-            
-            % Transform each element for this instance
-            for k = 1:length(ref_elements)
-                gel = ref_elements{k};
-                
-                % Skip reference elements
-                if is_ref(gel)
-                    continue;
+            case 'path'
+                if convert_paths
+                    gel = gds_element('boundary', 'xy', pxy(:)', ...
+                                      'layer', get(gel, 'layer'), ...
+                                      'dtype', get(gel, 'dtype'));
+                    new_elements{k} = gel;
+                    continue
+                end
+                gel = set(gel, 'xy', pxy(:)');
+                width = get(gel, 'width');
+                if ins(k,6) ~= 1 && ~isempty(width)
+                    gel = set(gel, 'width', width * ins(k,6));
                 end
                 
-                % Transform element
-                gel_transformed = apply_transformation_to_element(gel, ref_strans, instance_pos);
-                
-                if ~isempty(gel_transformed)
-                    transformed_elements{end+1} = gel_transformed;
+            otherwise  % box, text, node
+                if ~isempty(pxy)
+                    gel = set(gel, 'xy', pxy{1});
                 end
-            end
-        end
-    end
-end
-
-
-%% ========================================================================
-%% HELPER FUNCTION: APPLY TRANSFORMATION TO ELEMENT
-%% ========================================================================
-
-function gel_transformed = apply_transformation_to_element(gel, strans_record, translation)
-% Apply strans transformation and translation to a gds_element
-%
-% Transformation order (GDSII spec):
-%   1. Reflection about x-axis (if strans.reflect = 1)
-%   2. Rotation by strans.angle degrees
-%   3. Magnification by strans.mag
-%   4. Translation to reference position
-%
-% INPUT:
-%   gel            : gds_element to transform
-%   strans_record  : strans structure (may be empty)
-%   translation    : [x, y] translation vector
-%
-% OUTPUT:
-%   gel_transformed : transformed gds_element
-
-    gel_transformed = [];
-    
-    % Get element type
-    gel_type = etype(gel);
-    
-    % Only transform elements with xy coordinates
-    if ~ismember(gel_type, {'boundary', 'path', 'box'})
-        % For text, node, and other elements, just translate position
-        if ismember(gel_type, {'text', 'node'})
-            gel_transformed = gel;
-            xy_orig = get(gel, 'xy');
-            if iscell(xy_orig)
-                xy_orig = xy_orig{1};
-            end
-            xy_new = apply_strans_to_coords(xy_orig, strans_record, translation);
-            gel_transformed = set(gel_transformed, 'xy', xy_new);
-        end
-        return;
-    end
-    
-    % Get original xy coordinates
-    xy_orig = get(gel, 'xy');
-    
-    % Handle cell array of polygons (boundary, path)
-    if iscell(xy_orig)
-        xy_new = cell(size(xy_orig));
-        for k = 1:length(xy_orig)
-            xy_new{k} = apply_strans_to_coords(xy_orig{k}, strans_record, translation);
-        end
-    else
-        % Single matrix (box)
-        xy_new = apply_strans_to_coords(xy_orig, strans_record, translation);
-    end
-    
-    % Create transformed element with new coordinates
-    gel_transformed = gel;
-    gel_transformed = set(gel_transformed, 'xy', xy_new);
-end
-
-
-%% ========================================================================
-%% HELPER FUNCTION: APPLY STRANS TO COORDINATES
-%% ========================================================================
-
-function xy_transformed = apply_strans_to_coords(xy, strans_record, translation)
-% Apply strans transformation and translation to coordinate matrix
-%
-% INPUT:
-%   xy             : Nx2 matrix of coordinates
-%   strans_record  : strans structure (may be empty)
-%   translation    : [x, y] translation vector
-%
-% OUTPUT:
-%   xy_transformed : Nx2 matrix of transformed coordinates
-
-    xy_transformed = xy;
-    
-    % Apply transformations in order (per GDSII spec)
-    
-    % 1. Reflection about x-axis (do this FIRST, before rotation)
-    if ~isempty(strans_record) && isfield(strans_record, 'reflect') && strans_record.reflect
-        xy_transformed(:, 2) = -xy_transformed(:, 2);
-    end
-    
-    % 2. Rotation
-    if ~isempty(strans_record) && isfield(strans_record, 'angle') && ...
-       ~isempty(strans_record.angle) && strans_record.angle ~= 0
-        % Use existing poly_rotzd function for rotation
-        xy_transformed = poly_rotzd(xy_transformed, strans_record.angle);
-    end
-    
-    % 3. Magnification
-    if ~isempty(strans_record) && isfield(strans_record, 'mag') && ...
-       ~isempty(strans_record.mag) && strans_record.mag ~= 1
-        xy_transformed = xy_transformed * strans_record.mag;
-    end
-    
-    % 4. Translation
-    xy_transformed = bsxfun(@plus, xy_transformed, translation);
-    
-    % Check for unsupported features
-    if ~isempty(strans_record)
-        if isfield(strans_record, 'absmag') && strans_record.absmag
-            warning('gds_flatten_for_3d:UnsupportedAbsMag', ...
-                    'Absolute magnification (strans.absmag) not supported');
-        end
-        if isfield(strans_record, 'absang') && strans_record.absang
-            warning('gds_flatten_for_3d:UnsupportedAbsAng', ...
-                    'Absolute angle (strans.absang) not supported');
         end
+        
+        new_elements{k} = gel;
     end
 end
 
@@ -77,6 +77,12 @@ function layer_data = gds_layer_to_3d(gds_input, layer_config, varargin)
 %   - Coordinate system: GDSII xy-plane becomes 3D xy-plane, z from config
 %
 % PERFORMANCE:
+%   - The configuration and the filters are compiled once into a
+%     256 x 256 layer table, so that each element is mapped to its
+%     layer stack entry with a single lookup
+%   - When gds_flatten_mex is compiled, the hierarchy is flattened and
+%     the shapes are mapped with the layer table in compiled code; no
+%     flattened elements are created
 %   - For large designs, consider filtering by layers_filter
 %   - Flattening deep hierarchies may take significant time
 %   - Use enabled_only=true to skip disabled layers
@@ -219,8 +225,16 @@ function layer_data = gds_layer_to_3d(gds_input, layer_config, varargin)
         gstruct = gds_input;
     end
     
-    % Flatten hierarchy if requested
-    if params.flatten
+    % The layer filters and enabled flags are folded into the table
+    table = layer_table(layer_config, params.layers_filter, ...
+                        params.datatypes_filter, params.enabled_only);
+    
+    % Flatten hierarchy if requested; in compiled code, the shapes are
+    % mapped to their layers while the hierarchy is flattened
+    use_mex = params.flatten && exist('gds_flatten_mex', 'file') == 3;
+    if use_mex
+        gstruct_flat = [];
+    elseif params.flatten
         try
             % poly_convert flattens references and converts paths to boundaries
             gstruct_flat = poly_convert(gstruct);
@@ -260,89 +274,77 @@ function layer_data = gds_layer_to_3d(gds_input, layer_config, varargin)
 % EXTRACT POLYGONS FROM ELEMENTS
 % =========================================================================
 
-    % Get all elements from the structure
-    % Workaround for Octave subsref issue: use indexed access instead of (:)
-    num_elements = numel(gstruct_flat);
-    el_cell = cell(1, num_elements);
-    
-    % Extract elements one by one using indexed access
-    for idx = 1:num_elements
-        el_cell{idx} = gstruct_flat(idx);
-    end
+    if use_mex
+        [layers_out, stats] = extract_flattened(gds_input, gstruct, table, ...
+                                                layers_out, stats, params);
+    else
+        % Get all elements from the structure
+        % Workaround for Octave subsref issue: use indexed access instead of (:)
+        num_elements = numel(gstruct_flat);
+        el_cell = cell(1, num_elements);
     
-    for elem_idx = 1:num_elements
-        gel = el_cell{elem_idx};
-        stats.total_elements = stats.total_elements + 1;
-        
-        % Skip reference elements (should be flattened already)
-        if is_ref(gel)
-            continue;
-        end
-        
-        % Get element layer and datatype using get method
-        el_layer = get(gel, 'layer');
-        el_dtype = get(gel, 'dtype');
-        
-        % Apply layer filters
-        if ~isempty(params.layers_filter) && ~ismember(el_layer, params.layers_filter)
-            continue;
+        % Extract elements one by one using indexed access
+        for idx = 1:num_elements
+            el_cell{idx} = gstruct_flat(idx);
         end
-        if ~isempty(params.datatypes_filter) && ~ismember(el_dtype, params.datatypes_filter)
-            continue;
-        end
-        
-        % Look up layer in configuration
-        layer_idx = el_layer + 1;  % MATLAB 1-based indexing
-        dtype_idx = el_dtype + 1;
+    
+        for elem_idx = 1:num_elements
+            gel = el_cell{elem_idx};
+            stats.total_elements = stats.total_elements + 1;
         
-        if layer_idx > 256 || dtype_idx > 256
-            continue;  % Invalid layer/datatype
-        end
+            % Skip reference elements (should be flattened already)
+            if is_ref(gel)
+                continue;
+            end
         
-        config_idx = layer_config.layer_map(layer_idx, dtype_idx);
+            % Get element layer and datatype using get method
+            el_layer = get(gel, 'layer');
+            el_dtype = get(gel, 'dtype');
         
-        if config_idx == 0
-            % Layer not in configuration - skip
-            continue;
-        end
+            if el_layer > 255 || el_dtype > 255
+                continue;  % Invalid layer/datatype
+            end
         
-        % Check if layer is enabled
-        if params.enabled_only && ~layer_config.layers(config_idx).enabled
-            continue;
-        end
+            % Look up the layer stack entry (MATLAB 1-based indexing);
+            % filtered, disabled and unknown layers have no entry
+            config_idx = table(el_layer + 1, el_dtype + 1);
+            if config_idx == 0
+                continue;
+            end
         
-        % Extract polygon(s) from element
-        polys = extract_element_polygons(gel, params.convert_paths);
+            % Extract polygon(s) from element
+            polys = extract_element_polygons(gel, params.convert_paths);
         
-        if isempty(polys)
-            continue;
-        end
+            if isempty(polys)
+                continue;
+            end
         
-        % Add polygons to layer
-        for p = 1:length(polys)
-            poly = polys{p};
+            % Add polygons to layer
+            for p = 1:length(polys)
+                poly = polys{p};
             
-            if size(poly, 1) < 3
-                continue;  % Invalid polygon
-            end
+                if size(poly, 1) < 3
+                    continue;  % Invalid polygon
+                end
             
-            % Add to layer data
-            layers_out(config_idx).polygons{end+1} = poly;
-            layers_out(config_idx).num_polygons = layers_out(config_idx).num_polygons + 1;
+                % Add to layer data
+                layers_out(config_idx).polygons{end+1} = poly;
+                layers_out(config_idx).num_polygons = layers_out(config_idx).num_polygons + 1;
             
-            % Update bounding box
-            bbox_cur = layers_out(config_idx).bbox;
-            bbox_cur(1) = min(bbox_cur(1), min(poly(:,1)));
-            bbox_cur(2) = min(bbox_cur(2), min(poly(:,2)));
-            bbox_cur(3) = max(bbox_cur(3), max(poly(:,1)));
-            bbox_cur(4) = max(bbox_cur(4), max(poly(:,2)));
-            layers_out(config_idx).bbox = bbox_cur;
+                % Update bounding box
+                bbox_cur = layers_out(config_idx).bbox;
+                bbox_cur(1) = min(bbox_cur(1), min(poly(:,1)));
+                bbox_cur(2) = min(bbox_cur(2), min(poly(:,2)));
+                bbox_cur(3) = max(bbox_cur(3), max(poly(:,1)));
+                bbox_cur(4) = max(bbox_cur(4), max(poly(:,2)));
+                layers_out(config_idx).bbox = bbox_cur;
             
-            % Update area (using shoelace formula)
-            area_poly = polygon_area(poly);
-            layers_out(config_idx).area = layers_out(config_idx).area + area_poly;
+                % Update area (using shoelace formula)
+                area_poly = polygon_area(poly);
+                layers_out(config_idx).area = layers_out(config_idx).area + area_poly;
             
-            stats.total_polygons = stats.total_polygons + 1;
+                stats.total_polygons = stats.total_polygons + 1;
+            end
         end
     end
 
@@ -380,6 +382,63 @@ function layer_data = gds_layer_to_3d(gds_input, layer_config, varargin)
 
 end
 
+% =========================================================================
+% HELPER FUNCTION: EXTRACT FLATTENED POLYGONS
+% =========================================================================
+
+function [layers_out, stats] = extract_flattened(gds_input, gstruct, table, ...
+                                                 layers_out, stats, params)
+% extract_flattened: Flatten the structure in compiled code
+%
+% The shapes are mapped to their layer stack entries with the layer
+% table while the hierarchy is flattened (gds_flatten_mex); paths
+% are converted to polygons in the same pass.
+
+    if isa(gds_input, 'gds_library')
+        structs = gds_input.st;
+        names = cellfun(@(s) get(s, 'sname'), structs, 'UniformOutput', false);
+        top = find(strcmp(names, sname(gstruct)), 1);
+    else
+        structs = {gstruct};
+        names = {sname(gstruct)};
+        top = 1;
+    end
+    
+    el_data = cell(size(structs));
+    for k = 1:numel(structs)
+        el_data{k} = cellfun(@get, get(structs{k}), 'UniformOutput', false);
+    end
+    
+    try
+        [lay, ins] = gds_flatten_mex(el_data, names, top, -1, [], ...
+                                     params.convert_paths, table);
+    catch ME
+        error('gds_layer_to_3d:FlattenFailed', ...
+              'Failed to flatten structure: %s', ME.message);
+    end
+    stats.total_elements = size(ins, 1);
+    
+    for k = 1:numel(lay)
+        c = lay(k).entry;
+        p = mat2cell(lay(k).xy, lay(k).nv(:), 2);
+        p = p(lay(k).nv(:) >= 3);
+        if isempty(p)
+            continue;
+        end
+        
+        pxy = vertcat(p{:});
+        L = layers_out(c);
+        L.polygons = [L.polygons, p(:)'];
+        L.num_polygons = L.num_polygons + numel(p);
+        L.bbox = [min(L.bbox(1:2), min(pxy, [], 1)), ...
+                  max(L.bbox(3:4), max(pxy, [], 1))];
+        L.area = L.area + sum(cellfun(@polygon_area, p));
+        layers_out(c) = L;
+        
+        stats.total_polygons = stats.total_polygons + numel(p);
+    end
+end
+
 % =========================================================================
 % HELPER FUNCTION: EXTRACT POLYGONS FROM ELEMENT
 % =========================================================================
@@ -421,20 +480,29 @@ function polys = extract_element_polygons(gel, convert_paths)
                         xy_data = {xy_data};
                     end
                     
-                    % Get path width
+                    % Get path width, type and extensions
                     try
                         path_width = get(gel, 'width');
                     catch
                         path_width = 1;  % default width
                     end
+                    path_type = 0;
+                    path_ext = [0, 0];
+                    try
+                        path_type = get(gel, 'ptype');
+                        ext = get(gel, 'ext');
+                        path_ext = [ext.beg, ext.end];
+                    catch
+                    end
+                    if isempty(path_type)
+                        path_type = 0;
+                    end
                     
-                    % Convert each path segment
-                    for k = 1:length(xy_data)
-                        path_xy = xy_data{k};
-                        if size(path_xy, 1) >= 2
-                            % Convert path to polygon using width
-                            poly = path_to_polygon(path_xy, path_width);
-                            polys{end+1} = poly;
+                    % Convert all path segments in one call
+                    pc = gds_pathpoly_mex(xy_data, [], path_width, path_type, path_ext);
+                    for k = 1:length(pc)
+                        if ~isempty(pc{k})
+                            polys{end+1} = pc{k};
                         end
                     end
                 catch ME
@@ -452,61 +520,6 @@ function polys = extract_element_polygons(gel, convert_paths)
     end
 end
 
-% =========================================================================
-% HELPER FUNCTION: PATH TO POLYGON CONVERSION
-% =========================================================================
-
-function poly = path_to_polygon(path_xy, width)
-% path_to_polygon: Convert a path with width to a closed polygon
-%
-% Simple rectangular offset implementation
-
-    if size(path_xy, 1) < 2
-        poly = [];
-        return;
-    end
-    
-    % For simplicity, create rectangular caps
-    % More sophisticated version would use proper offsetting
-    
-    n = size(path_xy, 1);
-    half_width = abs(width) / 2;
-    
-    % Calculate perpendicular offsets
-    left_side = zeros(n, 2);
-    right_side = zeros(n, 2);
-    
-    for k = 1:n
-        if k == 1
-            % First segment - use direction to next point
-            dx = path_xy(2,1) - path_xy(1,1);
-            dy = path_xy(2,2) - path_xy(1,2);
-        elseif k == n
-            % Last segment - use direction from previous point
-            dx = path_xy(n,1) - path_xy(n-1,1);
-            dy = path_xy(n,2) - path_xy(n-1,2);
-        else
-            % Middle segments - average of incoming and outgoing directions
-            dx = (path_xy(k+1,1) - path_xy(k-1,1));
-            dy = (path_xy(k+1,2) - path_xy(k-1,2));
-        end
-        
-        % Normalize
-        len = sqrt(dx^2 + dy^2);
-        if len > 0
-            dx = dx / len;
-            dy = dy / len;
-        end
-        
-        % Perpendicular offset
-        left_side(k,:) = path_xy(k,:) + half_width * [-dy, dx];
-        right_side(k,:) = path_xy(k,:) + half_width * [dy, -dx];
-    end
-    
-    % Combine into closed polygon: left side forward + right side backward
-    poly = [left_side; flipud(right_side); left_side(1,:)];
-end
-
 % =========================================================================
 % HELPER FUNCTION: POLYGON AREA
 % =========================================================================
@@ -7,7 +7,12 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
 %
 % Merges overlapping 3D solids using Boolean operations via pythonOCC.
 % Solids are grouped by layer name and z-coordinates, then merged within
-% each group.
+% each group. Unions of prismatic solids are computed in 2D where
+% possible: stacks of solids with the same material and footprint
+% that touch in z become one solid, and the footprints of solids on
+% the same layer and z-interval are united with the Clipper library
+% before they are extruded again. Only solids on a layer whose
+% z-intervals partially overlap are merged with 3D Boolean operations.
 %
 % INPUT:
 %   solids    : Cell array of 3D solid structures from gds_extrude_polygon
@@ -22,7 +27,13 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
 %   Optional parameter/value pairs:
 %       'operation'   - Boolean operation: 'union', 'intersection', 'difference'
 %                       (default: 'union')
-%       'precision'   - Geometric tolerance (default: 1e-6)
+%       'precision'   - Geometric tolerance (default: 1e-6); the 2D unions
+%                       are computed on a grid with this spacing
+%       'method'      - 'auto' merges in 2D where possible (see above),
+%                       '3d' uses 3D Boolean operations for all solids
+%                       (default: 'auto')
+%       'tiles'       - Number of polygons above which the footprints of
+%                       a layer are united in parallel tiles (default: 5000)
 %       'python_cmd'  - Python command (default: 'python3')
 %       'keep_temp'   - Keep temporary files for debugging (default: false)
 %       'verbose'     - Verbosity level 0/1/2 (default: 1)
@@ -32,8 +43,11 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
 %                   Same format as input, but with solids merged by layer
 %
 % NOTES:
-%   - This is computationally expensive and optional
-%   - Requires Python 3.x with pythonOCC installed
+%   - 3D Boolean operations are computationally expensive and optional
+%   - Requires Python 3.x with pythonOCC installed for 3D operations;
+%     2D unions require poly_boolmex (see Boolean/makemex)
+%   - Holes created by 2D unions are cut into their outer polygons
+%     along keyhole edges
 %   - Solids are grouped by (layer_name, z_bottom, z_top) before merging
 %   - If merging fails, original solids are returned
 %   - Union operation is most commonly used to merge overlapping features
@@ -141,6 +155,41 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
         fprintf('      All solids valid\n\n');
     end
 
+% =========================================================================
+% 2.5D MERGE OF PRISMATIC SOLIDS
+% =========================================================================
+
+    num_input = length(solids);
+    merged_2d = {};
+    
+    if strcmp(options.operation, 'union') && strcmp(options.method, 'auto') && ...
+       exist('poly_boolmex', 'file') == 3
+        
+        if options.verbose >= 1
+            fprintf('      Merging footprints in 2D...\n');
+        end
+        
+        [merged_2d, solids] = merge_solids_2d(solids, options);
+        
+        if options.verbose >= 1
+            fprintf('      %d solids merged in 2D into %d solids\n', ...
+                    num_input - length(solids), length(merged_2d));
+            fprintf('      %d solids left for 3D Boolean operations\n\n', length(solids));
+        end
+        
+        if isempty(solids)
+            merged_solids = merged_2d;
+            if options.verbose >= 1
+                fprintf('========================================\n');
+                fprintf('Boolean operations completed!\n');
+                fprintf('Input solids:  %d\n', num_input);
+                fprintf('Output solids: %d\n', length(merged_solids));
+                fprintf('========================================\n\n');
+            end
+            return;
+        end
+    end
+
 % =========================================================================
 % CREATE TEMPORARY FILES
 % =========================================================================
@@ -455,10 +504,12 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
         end
     end
     
+    merged_solids = [merged_2d, merged_solids];
+    
     if options.verbose >= 1
         fprintf('========================================\n');
         fprintf('Boolean operations completed!\n');
-        fprintf('Input solids:  %d\n', length(solids));
+        fprintf('Input solids:  %d\n', num_input);
         fprintf('Output solids: %d\n', length(merged_solids));
         fprintf('========================================\n\n');
     end
@@ -466,6 +517,183 @@ function merged_solids = gds_merge_solids_3d(solids, varargin)
 end
 
 
+%% ========================================================================
+%% HELPER FUNCTION: 2.5D MERGE
+%% ========================================================================
+
+function [merged, rest] = merge_solids_2d(solids, options)
+% Merge prismatic solids with 2D polygon unions. Returns the merged
+% solids and the solids that need 3D Boolean operations.
+
+    N = length(solids);
+    poly = cell(1, N);
+    zb = zeros(1, N);
+    zt = zeros(1, N);
+    name = cell(1, N);
+    mat = cell(1, N);
+    for k = 1:N
+        s = solids{k};
+        poly{k} = base_polygon(s);
+        zb(k) = s.z_bottom;
+        zt(k) = s.z_top;
+        if isfield(s, 'layer_name')
+            name{k} = s.layer_name;
+        else
+            name{k} = sprintf('layer_%d', k);
+        end
+        if isfield(s, 'material')
+            mat{k} = s.material;
+        else
+            mat{k} = '';
+        end
+    end
+    
+    % grid coordinates for exact comparisons
+    q = options.precision;
+    
+    % stacks of solids with the same material and footprint that
+    % touch in z become one solid, as with the 3D merge
+    fkey = cell(1, N);
+    for k = 1:N
+        fkey{k} = [mat{k}, '|', sprintf('%d,', round(poly{k}(:) / q))];
+    end
+    [~, ~, fid] = unique(fkey);
+    keep = true(1, N);
+    stacks = {};
+    for f = find(accumarray(fid(:), 1)' > 1)
+        members = find(fid' == f);
+        [~, order] = sort(zb(members));
+        members = members(order);
+        chain = members(1);
+        top = zt(chain);
+        for m = [members(2:end), 0]
+            if m > 0 && abs(zb(m) - top) < q
+                chain(end+1) = m;
+                top = max(top, zt(m));
+                continue;
+            end
+            if length(chain) > 1
+                template = solids{chain(1)};
+                template.layer_name = [mat{chain(1)}, '_continuous'];
+                template.z_bottom = min(zb(chain));
+                template.z_top = top;
+                stacks = [stacks, extrude_footprints(poly(chain(1)), false, template)];
+                keep(chain) = false;
+            end
+            if m > 0
+                chain = m;
+                top = zt(m);
+            end
+        end
+    end
+    for k = 1:length(stacks)
+        solids{end+1} = stacks{k};
+        poly{end+1} = base_polygon(stacks{k});
+        zb(end+1) = stacks{k}.z_bottom;
+        zt(end+1) = stacks{k}.z_top;
+        name{end+1} = stacks{k}.layer_name;
+        keep(end+1) = true;
+    end
+    
+    % groups of solids on the same layer and z-interval
+    idx = find(keep);
+    gkey = cell(1, length(idx));
+    for k = 1:length(idx)
+        i = idx(k);
+        gkey{k} = sprintf('%s|%d|%d', name{i}, round(zb(i) / q), round(zt(i) / q));
+    end
+    [~, first, gid] = unique(gkey);
+    G = length(first);
+    gmembers = cell(1, G);
+    bbox = zeros(G, 4);
+    for g = 1:G
+        gmembers{g} = idx(gid == g);
+        xy = vertcat(poly{gmembers{g}});
+        bbox(g, :) = [min(xy, [], 1), max(xy, [], 1)];
+    end
+    
+    % groups on a layer with partially overlapping z-intervals and
+    % intersecting footprints need 3D Boolean operations
+    need3d = false(1, G);
+    gfirst = idx(first);
+    for g = 1:G
+        for h = g+1:G
+            i = gfirst(g);
+            j = gfirst(h);
+            if ~strcmp(name{i}, name{j})
+                continue;
+            end
+            if min(zt(i), zt(j)) - max(zb(i), zb(j)) > q && ...
+               all(bbox(g, 1:2) <= bbox(h, 3:4)) && all(bbox(h, 1:2) <= bbox(g, 3:4))
+                need3d([g, h]) = true;
+            end
+        end
+    end
+    rest = solids([gmembers{need3d}]);
+    
+    % unite the footprints of the other groups; small groups are
+    % merged with one call, large groups in parallel tiles
+    merged = {};
+    udf = 1 / q;
+    batch = {};
+    bgroups = [];
+    for g = find(~need3d)
+        members = gmembers{g};
+        if length(members) == 1
+            merged{end+1} = solids{members};
+        elseif length(members) > options.tiles
+            n = ceil(sqrt(length(members) / options.tiles)) + 1;
+            [pc, hf] = poly_boolmex(poly(members), {}, 'or', udf, n);
+            merged = [merged, extrude_footprints(pc, hf, solids{members(1)})];
+        else
+            batch{end+1} = poly(members);
+            bgroups(end+1) = g;
+        end
+    end
+    if ~isempty(batch)
+        [pc, hf, ng] = poly_boolmex(batch, {}, 'or', udf);
+        last = cumsum(ng);
+        for k = 1:length(bgroups)
+            r = last(k)-ng(k)+1:last(k);
+            template = solids{gmembers{bgroups(k)}(1)};
+            merged = [merged, extrude_footprints(pc(r), hf(r), template)];
+        end
+    end
+end
+
+
+function polygon = base_polygon(solid)
+% Footprint of an extruded solid
+
+    if isfield(solid, 'polygon_xy')
+        polygon = solid.polygon_xy;
+    else
+        n_base = size(solid.vertices, 1) / 2;
+        polygon = solid.vertices(1:n_base, 1:2);
+    end
+end
+
+
+function solids = extrude_footprints(pc, hf, template)
+% Extrude the result polygons of a union with the z-interval and
+% metadata of a template solid
+
+    polys = cut_holes(pc, hf);
+    solids = cell(1, length(polys));
+    for k = 1:length(polys)
+        solid = gds_extrude_polygon(polys{k}, template.z_bottom, template.z_top);
+        fields = {'layer_name', 'material', 'color', 'gds_layer', 'gds_datatype'};
+        for f = 1:length(fields)
+            if isfield(template, fields{f})
+                solid.(fields{f}) = template.(fields{f});
+            end
+        end
+        solid.polygon_xy = polys{k};
+        solids{k} = solid;
+    end
+end
+
+
 %% ========================================================================
 %% HELPER FUNCTION: PARSE OPTIONS
 %% ========================================================================
@@ -479,6 +707,8 @@ function options = parse_options(varargin)
     options.python_cmd = 'python3';
     options.keep_temp = false;
     options.verbose = 1;
+    options.method = 'auto';
+    options.tiles = 5000;
     
     % Parse parameter/value pairs
     k = 1;
@@ -518,6 +748,16 @@ function options = parse_options(varargin)
             case 'keep_temp'
                 options.keep_temp = logical(param_value);
                 
+            case 'method'
+                options.method = lower(char(param_value));
+                if ~ismember(options.method, {'auto', '3d'})
+                    error('gds_merge_solids_3d:InvalidMethod', ...
+                          'Method must be ''auto'' or ''3d''');
+                end
+                
+            case 'tiles'
+                options.tiles = double(param_value);
+                
             case 'verbose'
                 if ~isnumeric(param_value) || ~isscalar(param_value)
                     error('gds_merge_solids_3d:InvalidVerbose', ...
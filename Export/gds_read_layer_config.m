@@ -47,8 +47,10 @@ function layer_config = gds_read_layer_config(config_file)
 %           .simplify_polygons - Simplification tolerance (numeric)
 %           .tolerance - General tolerance (numeric)
 %
-%       .layer_map      - Quick lookup map: layer_map(gds_layer, gds_datatype)
-%                         Returns index into .layers array, or 0 if not found
+%       .layer_map      - Quick lookup map: layer_map(gds_layer+1, gds_datatype+1)
+%                         Returns index into .layers array, or 0 if not found.
+%                         The 256 x 256 map is also the layer table that
+%                         gds_flatten_mex uses to map shapes in compiled code
 %
 % USAGE EXAMPLES:
 %   % Load IHP SG13G2 process configuration
@@ -26,6 +26,12 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
 %       'python_cmd'      - Python command for STEP writer (default: 'python3')
 %       'precision'       - Geometric tolerance (default: 1e-6)
 %       'keep_temp'       - Keep temporary files for debugging (default: false)
+%       'stream'          - Convert tile by tile (default: false)
+%       'memory'          - Memory budget of a tile in MB for streaming
+%                           (default: 1024)
+%       'tile_size'       - Maximum tile edge length in user units for
+%                           streaming; overrides the tiles derived from
+%                           'memory'
 %
 % OUTPUT:
 %   Writes STEP (or STL) file to disk
@@ -45,6 +51,10 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
 %               'format', 'stl', ...
 %               'units', 1e-6);  % Convert to meters
 %
+%   % Large layout converted tile by tile within 2 GB
+%   gds_to_step('chip.gds', 'config.json', 'chip.step', ...
+%               'stream', true, 'memory', 2048);
+%
 %   % Specify structure and flatten hierarchy
 %   gds_to_step('design.gds', 'config.json', 'design.step', ...
 %               'structure_name', 'TopCell', ...
@@ -61,9 +71,29 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
 %   7. Optional: Merge overlapping solids
 %   8. Write STEP (or STL) file
 %
+%   With 'stream', steps 3-8 are pipelined: the layout is divided into
+%   tiles and each tile is flattened (windowed), merged per layer,
+%   extruded and appended to the output file before the next tile is
+%   read. The tiles are chosen from the vertex count of the structure
+%   tree so that a tile fits the memory budget; tiles that turn out to
+%   be too large are split in four. Progress is reported per tile.
+%
 % NOTES:
-%   - For large designs, use 'window' to extract regions
-%   - STEP format requires Python with pythonOCC installed
+%   - For large designs, use 'window' to extract regions, or 'stream'
+%     to convert the whole design with bounded memory
+%   - With 'window', structures and elements outside the window are
+%     skipped while the library is read (see read_gds_library), so
+%     that the read time is dominated by the window, not the design
+%   - Streaming needs gds_flatten_mex and gds_step_mex (gds_stl_mex
+%     for STL) and always flattens the hierarchy. Unmerged polygons
+%     are written by the tile containing the lower left corner of
+%     their bounding box; with 'merge', polygons are united per layer
+%     and the solids are clipped at the tile borders. The library
+%     itself is still read at once.
+%   - STEP format uses gds_step_mex, or Python with pythonOCC when it is
+%     not compiled
+%   - Merging unites footprints in 2D (poly_boolmex); Python with
+%     pythonOCC is only needed for partially overlapping z-ranges
 %   - STL format works without external dependencies
 %   - Automatic fallback to STL if Python/pythonOCC unavailable
 %   - All coordinates are in GDS user units unless scaled
@@ -141,7 +171,14 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
     t_step = tic;
     
     try
-        glib = read_gds_library(gds_file);
+        % with a window, only the structures and elements that are
+        % visible through it are read
+        if isempty(options.window)
+            glib = read_gds_library(gds_file);
+        else
+            glib = read_gds_library(gds_file, [], [], options.structure_name, [], ...
+                                    options.window);
+        end
         
         if options.verbose >= 2
             fprintf('      Library name: %s\n', get(glib, 'lname'));
@@ -184,6 +221,15 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
               'Failed to load layer config: %s\n%s', layer_config_file, ME.message);
     end
 
+% =========================================================================
+% STREAMING CONVERSION (OPTIONAL)
+% =========================================================================
+
+    if options.stream
+        convert_streaming(glib, layer_config, output_file, options, t_total);
+        return;
+    end
+
 % =========================================================================
 % STEP 3: APPLY WINDOWING (OPTIONAL)
 % =========================================================================
@@ -196,10 +242,10 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
         t_step = tic;
         
         try
-            % Apply windowing using existing bbox-based filtering
-            % This will be done during layer extraction for efficiency
+            % Structures and elements outside the window were skipped
+            % while reading; the polygons are filtered after extraction
             if options.verbose >= 1
-                fprintf('      Window filter will be applied during extraction\n');
+                fprintf('      Window applied while reading the library\n');
                 fprintf('      Completed in %.2f seconds\n\n', toc(t_step));
             end
         catch ME
@@ -303,66 +349,82 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
 % STEP 6: EXTRUDE POLYGONS TO 3D SOLIDS
 % =========================================================================
 
-    if options.verbose >= 1
-        fprintf('[6/8] Extruding polygons to 3D solids...\n');
+    total_polygons = 0;
+    for k = 1:length(layer_data.layers)
+        total_polygons = total_polygons + layer_data.layers(k).num_polygons;
     end
-    t_step = tic;
-    
-    try
-        all_solids = {};
-        extrusion_options = struct();
-        extrusion_options.check_orientation = true;
-        extrusion_options.tolerance = options.precision;
-        
-        total_polygons = 0;
-        for k = 1:length(layer_data.layers)
-            total_polygons = total_polygons + layer_data.layers(k).num_polygons;
+
+    % Unmerged output is extruded natively by gds_write_stl and
+    % gds_write_step; merging needs the solids
+    if strcmp(options.format, 'stl')
+        native = ~options.merge && exist('gds_stl_mex', 'file') == 3;
+    else
+        native = ~options.merge && exist('gds_step_mex', 'file') == 3;
+    end
+
+    if native
+        if options.verbose >= 1
+            fprintf('[6/8] Extrusion deferred to the %s writer\n\n', upper(options.format));
         end
+    else
+
+        if options.verbose >= 1
+            fprintf('[6/8] Extruding polygons to 3D solids...\n');
+        end
+        t_step = tic;
+    
+        try
+            all_solids = {};
+            extrusion_options = struct();
+            extrusion_options.check_orientation = true;
+            extrusion_options.tolerance = options.precision;
         
-        solid_count = 0;
-        for k = 1:length(layer_data.layers)
-            layer = layer_data.layers(k);
+            solid_count = 0;
+            for k = 1:length(layer_data.layers)
+                layer = layer_data.layers(k);
             
-            if options.verbose >= 2
-                fprintf('      Processing layer %s (%d polygons)...\n', ...
-                        layer.config.name, layer.num_polygons);
-            end
+                if options.verbose >= 2
+                    fprintf('      Processing layer %s (%d polygons)...\n', ...
+                            layer.config.name, layer.num_polygons);
+                end
             
-            for p = 1:layer.num_polygons
-                poly = layer.polygons{p};
+                for p = 1:layer.num_polygons
+                    poly = layer.polygons{p};
                 
-                % Extrude polygon to 3D
-                solid = gds_extrude_polygon(poly, ...
-                                           layer.config.z_bottom, ...
-                                           layer.config.z_top, ...
-                                           extrusion_options);
+                    % Extrude polygon to 3D
+                    solid = gds_extrude_polygon(poly, ...
+                                               layer.config.z_bottom, ...
+                                               layer.config.z_top, ...
+                                               extrusion_options);
                 
-                % Add metadata
-                solid.material = layer.config.material;
-                solid.color = layer.config.color;
-                solid.layer_name = layer.config.name;
-                solid.gds_layer = layer.config.gds_layer;
-                solid.gds_datatype = layer.config.gds_datatype;
-                solid.polygon_xy = poly;  % Store original 2D polygon
+                    % Add metadata
+                    solid.material = layer.config.material;
+                    solid.color = layer.config.color;
+                    solid.layer_name = layer.config.name;
+                    solid.gds_layer = layer.config.gds_layer;
+                    solid.gds_datatype = layer.config.gds_datatype;
+                    solid.polygon_xy = poly;  % Store original 2D polygon
                 
-                all_solids{end+1} = solid;
-                solid_count = solid_count + 1;
+                    all_solids{end+1} = solid;
+                    solid_count = solid_count + 1;
                 
-                % Progress indicator for verbose mode
-                if options.verbose >= 2 && mod(solid_count, 100) == 0
-                    fprintf('      Progress: %d/%d solids (%.1f%%)\n', ...
-                            solid_count, total_polygons, 100*solid_count/total_polygons);
+                    % Progress indicator for verbose mode
+                    if options.verbose >= 2 && mod(solid_count, 100) == 0
+                        fprintf('      Progress: %d/%d solids (%.1f%%)\n', ...
+                                solid_count, total_polygons, 100*solid_count/total_polygons);
+                    end
                 end
             end
-        end
         
-        if options.verbose >= 1
-            fprintf('      Created %d 3D solids\n', length(all_solids));
-            fprintf('      Completed in %.2f seconds\n\n', toc(t_step));
+            if options.verbose >= 1
+                fprintf('      Created %d 3D solids\n', length(all_solids));
+                fprintf('      Completed in %.2f seconds\n\n', toc(t_step));
+            end
+        catch ME
+            error('gds_to_step:ExtrusionError', ...
+                  'Failed to extrude polygons: %s', ME.message);
         end
-    catch ME
-        error('gds_to_step:ExtrusionError', ...
-              'Failed to extrude polygons: %s', ME.message);
+
     end
 
 % =========================================================================
@@ -430,13 +492,21 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
             % Write STL file
             write_options.format = 'binary';  % Default to binary STL
             write_options.solid_name = 'gds_solid';
-            gds_write_stl(all_solids, output_file, write_options);
+            if native
+                gds_write_stl(layer_data, output_file, write_options);
+            else
+                gds_write_stl(all_solids, output_file, write_options);
+            end
         else
             % Write STEP file
             write_options.format = 'AP203';
             write_options.materials = true;
             write_options.python_cmd = options.python_cmd;
-            gds_write_step(all_solids, output_file, write_options);
+            if native
+                gds_write_step(layer_data, output_file, write_options);
+            else
+                gds_write_step(all_solids, output_file, write_options);
+            end
         end
         
         if options.verbose >= 1
@@ -459,7 +529,11 @@ function gds_to_step(gds_file, layer_config_file, output_file, varargin)
         fprintf('  Conversion Summary\n');
         fprintf('========================================\n');
         fprintf('Total polygons: %d\n', total_polygons);
-        fprintf('Total solids:   %d\n', length(all_solids));
+        if native
+            fprintf('Total solids:   %d\n', total_polygons);
+        else
+            fprintf('Total solids:   %d\n', length(all_solids));
+        end
         fprintf('Output format:  %s\n', upper(options.format));
         fprintf('Total time:     %.2f seconds\n', total_time);
         fprintf('========================================\n');
@@ -489,6 +563,9 @@ function options = parse_options(varargin)
     options.python_cmd = 'python3';
     options.precision = 1e-6;
     options.keep_temp = false;
+    options.stream = false;
+    options.memory = 1024;
+    options.tile_size = [];
     
     % Parse parameter/value pairs
     k = 1;
@@ -565,6 +642,23 @@ function options = parse_options(varargin)
             case 'keep_temp'
                 options.keep_temp = logical(param_value);
                 
+            case 'stream'
+                options.stream = logical(param_value);
+                
+            case 'memory'
+                if ~isnumeric(param_value) || ~isscalar(param_value) || param_value <= 0
+                    error('gds_to_step:InvalidMemory', ...
+                          'Memory must be a positive number of MB');
+                end
+                options.memory = double(param_value);
+                
+            case 'tile_size'
+                if ~isnumeric(param_value) || ~isscalar(param_value) || param_value <= 0
+                    error('gds_to_step:InvalidTileSize', ...
+                          'Tile size must be a positive number');
+                end
+                options.tile_size = double(param_value);
+                
             otherwise
                 warning('gds_to_step:UnknownParameter', ...
                         'Unknown parameter: %s', varargin{k});
@@ -643,3 +737,287 @@ function layer_data = apply_window_filter(layer_data, window)
     layer_data.layers = layer_data.layers(non_empty);
     
 end
+
+
+
+%% ========================================================================
+%% HELPER FUNCTION: STREAMING CONVERSION
+%% ========================================================================
+
+function convert_streaming(glib, layer_config, output_file, options, t_total)
+% Flatten, merge, extrude and write the layout tile by tile; only the
+% polygons of one tile are held in memory
+
+    is_stl = strcmp(options.format, 'stl');
+    if is_stl
+        writer = 'gds_stl_mex';
+    else
+        writer = 'gds_step_mex';
+    end
+    if exist('gds_flatten_mex', 'file') ~= 3 || exist(writer, 'file') ~= 3
+        error('gds_to_step:StreamUnavailable', ...
+              'Streaming requires the compiled gds_flatten_mex and %s', writer);
+    end
+    
+    % working memory per flattened vertex in bytes: vertex buffers,
+    % polygon cell arrays, Boolean operations and packed output
+    bytes_per_vertex = 200;
+    budget = options.memory * 2^20;
+    max_split = 6;
+    
+    % target structure
+    structs = glib.st;
+    names = cellfun(@(s) get(s, 'sname'), structs, 'UniformOutput', false);
+    if isempty(options.structure_name)
+        top_structs = topstruct(glib);
+        if isempty(top_structs)
+            error('gds_to_step:NoTopStruct', ...
+                  'Cannot find top-level structure in library');
+        end
+        target_name = top_structs{1};
+    else
+        target_name = options.structure_name;
+    end
+    top = find(strcmp(names, target_name), 1);
+    if isempty(top)
+        error('gds_to_step:StructureNotFound', ...
+              'Structure "%s" not found in library', target_name);
+    end
+    
+    % element data of all structures, converted once for all tiles
+    el_data = cell(size(structs));
+    for k = 1:numel(structs)
+        el_data{k} = cellfun(@get, get(structs{k}), 'UniformOutput', false);
+    end
+    
+    % layer table; the shapes are mapped to their stack entries
+    % while each tile is flattened
+    table = layer_table(layer_config, options.layers_filter, ...
+                        options.datatypes_filter, true);
+    
+    % region and vertex count of the resolved structure
+    H = tree_summary(structs);
+    bbox = H.bbox(top, :);
+    nvert = full(sum(H.cnt{top}(:, 6)));
+    if isempty(options.window)
+        region = bbox;
+    else
+        region = options.window;
+        overlap = max(0, min(bbox(3:4), region(3:4)) - max(bbox(1:2), region(1:2)));
+        nvert = nvert * min(1, prod(overlap) / max(prod(bbox(3:4) - bbox(1:2)), eps));
+    end
+    
+    % grid of tiles; each tile should fit the memory budget
+    width = region(3) - region(1);
+    height = region(4) - region(2);
+    if ~all(isfinite(region))
+        nx = 0;
+        ny = 0;
+    elseif ~isempty(options.tile_size)
+        nx = max(1, ceil(width / options.tile_size));
+        ny = max(1, ceil(height / options.tile_size));
+    else
+        ntiles = max(1, ceil(nvert * bytes_per_vertex / budget));
+        nx = min(ntiles, max(1, round(sqrt(ntiles * width / max(height, eps)))));
+        ny = ceil(ntiles / nx);
+    end
+    xs = region(1) + (0:nx) * width / max(nx, 1);
+    ys = region(2) + (0:ny) * height / max(ny, 1);
+    queue = zeros(nx * ny, 4);
+    for j = 1:ny
+        for i = 1:nx
+            queue((j-1)*nx + i, :) = [xs(i), ys(j), xs(i+1), ys(j+1)];
+        end
+    end
+    levels = zeros(nx * ny, 1);
+    
+    if options.verbose >= 1
+        fprintf('[3/8] Streaming steps 3-8 tile by tile...\n');
+        fprintf('      Structure: %s\n', target_name);
+        fprintf('      Region: [%.3f %.3f %.3f %.3f]\n', region);
+        fprintf('      Estimated vertices: %d, memory budget: %g MB\n', ...
+                round(nvert), options.memory);
+        fprintf('      Tiles: %d x %d\n', nx, ny);
+    end
+    
+    % output file written in parts
+    cfg = layer_config.layers;
+    if is_stl
+        h = gds_stl_mex('open', output_file, 0);
+    else
+        rgb = 0.5 * ones(numel(cfg), 3);
+        for k = 1:numel(cfg)
+            if isfield(cfg(k), 'color') && numel(cfg(k).color) == 3
+                rgb(k, :) = cfg(k).color(:)';
+            end
+        end
+        h = gds_step_mex('open', output_file, {cfg.name}, rgb, 'AP203', ...
+                         options.precision);
+    end
+    is_open = true;
+    
+    t_stream = tic;
+    done = 0;
+    total_polygons = 0;
+    try
+        while ~isempty(queue)
+            win = queue(1, :);
+            level = levels(1);
+            queue(1, :) = [];
+            levels(1) = [];
+            
+            % window -> flatten
+            lay = gds_flatten_mex(el_data, names, top, -1, win, 1, table);
+            
+            % tiles above the memory budget are split in four
+            tile_vert = sum(arrayfun(@(L) size(L.xy, 1), lay));
+            if tile_vert * bytes_per_vertex > budget && level < max_split
+                xm = (win(1) + win(3)) / 2;
+                ym = (win(2) + win(4)) / 2;
+                split = [win(1), win(2), xm, ym; xm, win(2), win(3), ym; ...
+                         win(1), ym, xm, win(4); xm, ym, win(3), win(4)];
+                queue = [split; queue];
+                levels = [repmat(level + 1, 4, 1); levels];
+                if options.verbose >= 2
+                    fprintf('      Tile split in four (%d vertices)\n', tile_vert);
+                end
+                continue;
+            end
+            
+            % per-layer selection and boolean -> extrude -> write
+            [xy, nv, z, group] = tile_polygons(lay, win, region, layer_config, options);
+            clear lay
+            if ~isempty(nv)
+                if is_stl
+                    gds_stl_mex('write', h, xy, nv, z, options.units);
+                else
+                    gds_step_mex('write', h, xy, nv, z, options.units, group);
+                end
+            end
+            
+            done = done + 1;
+            total_polygons = total_polygons + numel(nv);
+            if options.verbose >= 1
+                elapsed = toc(t_stream);
+                remaining = size(queue, 1);
+                fprintf('      Tile %d/%d: %d polygons, %.1f s elapsed, %.1f s remaining\n', ...
+                        done, done + remaining, numel(nv), elapsed, ...
+                        elapsed / done * remaining);
+            end
+        end
+        
+        is_open = false;
+        if is_stl
+            gds_stl_mex('close', h);
+            total_solids = total_polygons;
+        else
+            total_solids = gds_step_mex('close', h);
+        end
+    catch ME
+        if is_open
+            try
+                feval(writer, 'close', h);
+            catch
+            end
+        end
+        if exist(output_file, 'file')
+            delete(output_file);
+        end
+        error('gds_to_step:StreamError', ...
+              'Streaming conversion failed: %s', ME.message);
+    end
+    
+    if options.verbose >= 1
+        fprintf('      Output file: %s\n', output_file);
+        fprintf('      Completed in %.2f seconds\n\n', toc(t_stream));
+        fprintf('========================================\n');
+        fprintf('  Conversion Summary\n');
+        fprintf('========================================\n');
+        fprintf('Tiles:          %d\n', done);
+        fprintf('Total polygons: %d\n', total_polygons);
+        fprintf('Total solids:   %d\n', total_solids);
+        fprintf('Output format:  %s\n', upper(options.format));
+        fprintf('Total time:     %.2f seconds\n', toc(t_total));
+        fprintf('========================================\n');
+        fprintf('Conversion completed successfully!\n\n');
+    end
+end
+
+
+function [xy, nv, z, group] = tile_polygons(lay, win, region, layer_config, options)
+% Pack the polygons of a flattened tile with the z range and the
+% configuration index of their layer. The layers were mapped to
+% their stack entries with the layer table. Without merging, a polygon
+% belongs to the tile that contains the lower left corner of its
+% bounding box; with merging, the polygons of a layer are united
+% and clipped to the tile.
+
+    % tiles at the upper and right edges of the region also own the
+    % corners on these edges
+    own = win;
+    if win(3) >= region(3)
+        own(3) = Inf;
+    end
+    if win(4) >= region(4)
+        own(4) = Inf;
+    end
+    
+    ncfg = numel(layer_config.layers);
+    polys = repmat({cell(0, 1)}, 1, ncfg);
+    for k = 1:numel(lay)
+        L = lay(k);
+        c = L.entry;
+        if isempty(L.nv) || c == 0
+            continue;
+        end
+        
+        % polygons of boundaries, boxes and paths
+        keep = L.nv(:) >= 3;
+        p = mat2cell(L.xy, L.nv(:), 2);
+        p = p(keep);
+        if isempty(p)
+            continue;
+        end
+        
+        if ~options.merge
+            ll = cell2mat(cellfun(@(q) min(q, [], 1), p, 'UniformOutput', false));
+            ll = bsxfun(@max, ll, region(1:2));
+            mine = ll(:, 1) >= own(1) & ll(:, 1) < own(3) & ...
+                   ll(:, 2) >= own(2) & ll(:, 2) < own(4);
+            p = p(mine);
+        end
+        polys{c} = [polys{c}; p];
+    end
+    
+    % united layers clipped to the tile
+    if options.merge
+        udf = 1 / options.precision;
+        rect = [win([1 3 3 1])', win([2 2 4 4])'];
+        for c = find(~cellfun(@isempty, polys))
+            [pc, hf] = poly_boolmex(polys{c}', {}, 'or', udf);
+            if ~isempty(pc)
+                [pc, hf] = poly_boolmex(pc, {rect}, 'and', udf);
+            end
+            pc = cut_holes(pc, hf);
+            polys{c} = pc(:);
+        end
+    end
+    
+    % packed vertex buffer
+    allp = vertcat(polys{:});
+    nv = cellfun(@(q) size(q, 1), allp);
+    xy = vertcat(allp{:});
+    if isempty(xy)
+        xy = zeros(0, 2);
+    end
+    z = zeros(numel(nv), 2);
+    group = zeros(numel(nv), 1);
+    idx = 0;
+    for c = 1:ncfg
+        n = numel(polys{c});
+        z(idx+1:idx+n, 1) = layer_config.layers(c).z_bottom;
+        z(idx+1:idx+n, 2) = layer_config.layers(c).z_top;
+        group(idx+1:idx+n) = c;
+        idx = idx + n;
+    end
+end
@@ -9,7 +9,12 @@ function windowed_output = gds_window_library(gds_input, window_bbox, varargin)
 % interest from large chip designs for faster 3D processing.
 %
 % INPUT:
-%   gds_input   : gds_library or gds_structure object to filter
+%   gds_input   : gds_library or gds_structure object to filter, or
+%                 the name of a GDSII file. A file is read with the
+%                 window pushed down into the reader (see
+%                 read_gds_library): only the structures and
+%                 elements visible through the window in the top
+%                 structure are read, and the hierarchy is kept.
 %   window_bbox : [xmin ymin xmax ymax] bounding box in user units
 %   
 %   Optional parameter/value pairs:
@@ -40,10 +45,19 @@ function windowed_output = gds_window_library(gds_input, window_bbox, varargin)
 %   windowed = gds_window_library(glib, [0 0 1000 1000], ...
 %                                 'structure_name', 'TopCell');
 %
+%   % Read only the region from a file
+%   windowed = gds_window_library('chip.gds', [0 0 1000 1000], ...
+%                                 'structure_name', 'TopCell');
+%
 % PERFORMANCE NOTES:
 %   - For large designs, windowing significantly reduces processing time
-%   - Element filtering is fast (bounding box tests only)
+%   - Element filtering is fast: a spatial index of the element
+%     bounding boxes (see spindex) is queried for each structure
 %   - Polygon clipping is slower but more precise
+%   - For a file, the cost is proportional to the window: references
+%     and array rows/columns outside it are skipped with the bounding
+%     boxes of the structures. Clipping is not available for files
+%     because the window applies to the top structure only
 %   - Use margin=0 and clip=false for fastest extraction
 %
 % USE CASE:
@@ -70,9 +84,13 @@ function windowed_output = gds_window_library(gds_input, window_bbox, varargin)
     end
     
     % Validate input type
-    if ~isa(gds_input, 'gds_library') && ~isa(gds_input, 'gds_structure')
+    if isstring(gds_input)
+        gds_input = char(gds_input);
+    end
+    if ~isa(gds_input, 'gds_library') && ~isa(gds_input, 'gds_structure') && ...
+       ~ischar(gds_input)
         error('gds_window_library:InvalidInput', ...
-              'First argument must be gds_library or gds_structure object');
+              'First argument must be gds_library or gds_structure object or a file name');
     end
     
     % Validate window bbox
@@ -169,7 +187,9 @@ function windowed_output = gds_window_library(gds_input, window_bbox, varargin)
         fprintf('=============================\n\n');
     end
     
-    if isa(gds_input, 'gds_library')
+    if ischar(gds_input)
+        windowed_output = window_file(gds_input, window_bbox, options);
+    elseif isa(gds_input, 'gds_library')
         windowed_output = window_library(gds_input, window_bbox, options);
     else
         windowed_output = window_structure(gds_input, window_bbox, options);
@@ -260,6 +280,38 @@ function windowed_lib = window_library(glib, window_bbox, options)
 end
 
 
+%% ========================================================================
+%% HELPER FUNCTION: WINDOW FILE
+%% ========================================================================
+
+function windowed_lib = window_file(gds_file, window_bbox, options)
+% Read the part of a GDSII file that is visible through a window
+%
+% Strategy:
+%   - The reader finds the window of each structure from the
+%     structure bounding boxes and the reference transformations
+%   - Only structures with instances in the window are returned,
+%     with the elements that overlap their window
+
+    if options.clip
+        warning('gds_window_library:NoClip', ...
+                'Clipping is not available when reading from a file; ignored.');
+    end
+
+    if options.verbose >= 1
+        fprintf('Reading window from file: %s\n', gds_file);
+    end
+
+    windowed_lib = read_gds_library(gds_file, options.verbose >= 2, [], ...
+                                    options.structure_name, [], window_bbox);
+
+    if options.verbose >= 1
+        fprintf('\nWindowed library contains %d structure(s)\n', length(windowed_lib));
+    end
+
+end
+
+
 %% ========================================================================
 %% HELPER FUNCTION: WINDOW STRUCTURE
 %% ========================================================================
@@ -268,75 +320,44 @@ function windowed_struct = window_structure(gstruct, window_bbox, options)
 % Filter a gds_structure by window
 %
 % Strategy:
-%   - Iterate through all elements
-%   - Check if element bbox intersects window
+%   - Query the spatial index of the structure (see spindex) for
+%     elements whose bbox intersects the window
+%   - Keep reference elements, which have no bbox
 %   - If clip=true, clip polygon elements to window boundary
 %   - Create new structure with filtered elements
 
-    xmin = window_bbox(1);
-    ymin = window_bbox(2);
-    xmax = window_bbox(3);
-    ymax = window_bbox(4);
-    
-    % Get all elements
-    el_cell = gstruct(:);
-    num_elements = length(el_cell);
+    % Build the spatial index; the element bounding boxes are
+    % usually known from reading the library
+    if isempty(get(gstruct, 'rtree'))
+        gstruct = spindex(gstruct);
+    end
+    ebox = get(gstruct, 'ebox');
+    all_el = get(gstruct);
+    num_elements = numel(all_el);
     
     if options.verbose >= 2
         fprintf('  Processing %d elements...\n', num_elements);
     end
     
+    % Elements overlapping the window
+    [~, win_idx] = findel(gstruct, window_bbox);
+    
+    % Reference elements are kept - they'll be resolved during flattening
+    nobox_idx = find(isinf(ebox(:,1)))';
+    ref_idx = nobox_idx(logical(cellfun(@is_ref, all_el(nobox_idx))));
+    
+    keep_idx = sort([win_idx, ref_idx]);
+    el_cell = all_el(keep_idx);
+    
     % Collect filtered elements
     filtered_elements = {};
     elements_kept = 0;
     elements_clipped = 0;
-    elements_discarded = 0;
+    elements_discarded = num_elements - numel(keep_idx);
     
-    for k = 1:num_elements
+    for k = 1:numel(el_cell)
         gel = el_cell{k};
         
-        % Get element bounding box
-        try
-            el_bbox = bbox(gel);
-        catch
-            % Element has no bbox (e.g., text, node) - keep it if requested
-            if options.verbose >= 2
-                fprintf('  Element %d: no bbox (type=%s), keeping\n', k, etype(gel));
-            end
-            filtered_elements{end+1} = gel;
-            elements_kept = elements_kept + 1;
-            continue;
-        end
-        
-        % Check if element bbox is valid
-        if any(isinf(el_bbox))
-            % Invalid bbox (e.g., reference elements)
-            % Keep reference elements - they'll be resolved during flattening
-            if is_ref(gel)
-                filtered_elements{end+1} = gel;
-                elements_kept = elements_kept + 1;
-            else
-                elements_discarded = elements_discarded + 1;
-            end
-            continue;
-        end
-        
-        % Test for overlap with window
-        el_xmin = el_bbox(1);
-        el_ymin = el_bbox(2);
-        el_xmax = el_bbox(3);
-        el_ymax = el_bbox(4);
-        
-        % Check if bounding boxes overlap
-        overlaps = (el_xmax >= xmin && el_xmin <= xmax && ...
-                    el_ymax >= ymin && el_ymin <= ymax);
-        
-        if ~overlaps
-            % Element completely outside window
-            elements_discarded = elements_discarded + 1;
-            continue;
-        end
-        
         % Element overlaps window - process it
         if options.clip && is_boundary_like(gel)
             % Clip polygon to window boundary
@@ -346,7 +367,7 @@ function windowed_struct = window_structure(gstruct, window_bbox, options)
                 if isempty(clipped_el)
                     % Clipping produced no valid polygon
                     if options.verbose >= 2
-                        fprintf('  Element %d: clipping produced empty result\n', k);
+                        fprintf('  Element %d: clipping produced empty result\n', keep_idx(k));
                     end
                     elements_discarded = elements_discarded + 1;
                 else
@@ -358,7 +379,7 @@ function windowed_struct = window_structure(gstruct, window_bbox, options)
                 % Clipping failed - keep original element
                 if options.verbose >= 2
                     fprintf('  Element %d: clipping failed (%s), keeping original\n', ...
-                            k, ME.message);
+                            keep_idx(k), ME.message);
                 end
                 filtered_elements{end+1} = gel;
                 elements_kept = elements_kept + 1;
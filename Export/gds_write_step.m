@@ -3,9 +3,12 @@ function gds_write_step(solids, filename, options)
 %
 % gds_write_step(solids, filename)
 % gds_write_step(solids, filename, options)
+% gds_write_step(layer_data, filename, options)
 %
-% Writes an array of 3D solids to STEP AP203/AP214 format
-% Uses Python pythonOCC bridge for STEP generation
+% Writes an array of 3D solids to STEP AP203/AP214 format. Solids
+% are written as B-rep prisms by the compiled writer gds_step_mex;
+% when it is not available, or with options.python, the Python
+% pythonOCC bridge generates the STEP file.
 %
 % INPUT:
 %   solids   : structure array of 3D solids from gds_extrude_polygon()
@@ -19,12 +22,18 @@ function gds_write_step(solids, filename, options)
 %                .material     - Material name (string)
 %                .color        - RGB color [r g b] or hex string
 %                .layer_name   - Layer name for metadata
+%              Alternatively, layer data from gds_layer_to_3d; the
+%              polygons of each layer are extruded between
+%              config.z_bottom and config.z_top and the solids are
+%              named and colored by layer.
 %   filename : output STEP file path
 %   options  : (Optional) structure with fields:
 %       .format     - 'AP203' or 'AP214' (default: 'AP203')
 %       .precision  - Geometric tolerance (default: 1e-6)
 %       .materials  - Include material metadata (default: true)
 %       .units      - Unit scaling factor (default: 1.0)
+%       .python     - Use the Python writer even when gds_step_mex
+%                     is available (default: false)
 %       .python_cmd - Python command to use (default: 'python3')
 %       .keep_temp  - Keep temporary JSON file (default: false)
 %       .verbose    - Print progress messages (default: false)
@@ -33,8 +42,8 @@ function gds_write_step(solids, filename, options)
 %   Writes STEP file to disk
 %
 % REQUIRES:
-%   - Python 3.x with pythonOCC installed
-%   - System python must be accessible via system() calls
+%   - gds_step_mex (see makemex), or
+%   - Python 3.x with pythonOCC installed, accessible via system()
 %
 % INSTALLATION:
 %   To install pythonOCC:
@@ -60,7 +69,10 @@ function gds_write_step(solids, filename, options)
 %   - STEP format preserves exact geometry (no triangulation)
 %   - Supports material properties and metadata
 %   - Industry standard for CAD/CAM interchange
-%   - Falls back to STL if Python/pythonOCC not available
+%   - Lengths are written in millimetres after unit scaling
+%   - Colors are only written to AP214 files by gds_step_mex
+%   - Falls back to STL if neither gds_step_mex nor Python/pythonOCC
+%     is available
 %
 % SEE ALSO: gds_extrude_polygon, gds_write_stl, gds_to_step
 
@@ -85,6 +97,10 @@ if ~isfield(options, 'units')
     options.units = 1.0;
 end
 
+if ~isfield(options, 'python')
+    options.python = false;
+end
+
 if ~isfield(options, 'python_cmd')
     options.python_cmd = 'python3';
 end
@@ -102,6 +118,17 @@ if ~ismember(options.format, {'AP203', 'AP214'})
     error('gds_write_step: format must be ''AP203'' or ''AP214'' --> %s', options.format);
 end
 
+native = ~options.python && exist('gds_step_mex', 'file') == 3;
+
+% Layer data are extruded and written natively
+if isstruct(solids) && isfield(solids, 'layers')
+    if native
+        write_step_layers(solids.layers, filename, options);
+        return;
+    end
+    solids = extrude_layers(solids.layers);
+end
+
 % Ensure solids is a cell array
 if ~iscell(solids) && isstruct(solids)
     if length(solids) == 1
@@ -121,6 +148,12 @@ if isempty(solids)
     error('gds_write_step: no solids provided');
 end
 
+% Native STEP writer
+if native
+    write_step_solids(solids, filename, options);
+    return;
+end
+
 % Check if Python and pythonOCC are available
 if ~check_python_available(options.python_cmd)
     warning('gds_write_step: Python not available, falling back to STL format');
@@ -198,6 +231,139 @@ end
 end
 
 
+%% Native STEP Writer for Layer Data
+function write_step_layers(layers, filename, options)
+% Pack the polygons of all layers with their z ranges and write them
+% with gds_step_mex; solids are named and colored by layer
+
+if isempty(layers)
+    error('gds_write_step: no solids provided');
+end
+
+polygons = [layers.polygons];
+nv = cellfun(@(p) size(p, 1), polygons(:));
+xy = vertcat(polygons{:});
+if isempty(xy)
+    xy = zeros(0, 2);
+end
+
+L = length(layers);
+z = zeros(numel(nv), 2);
+group = zeros(numel(nv), 1);
+names = cell(L, 1);
+rgb = 0.5 * ones(L, 3);
+idx = 0;
+for k = 1:L
+    n = numel(layers(k).polygons);
+    z(idx+1:idx+n, 1) = layers(k).config.z_bottom;
+    z(idx+1:idx+n, 2) = layers(k).config.z_top;
+    group(idx+1:idx+n) = k;
+    idx = idx + n;
+    names{k} = layers(k).config.name;
+    if isfield(layers(k).config, 'color') && numel(layers(k).config.color) == 3
+        rgb(k, :) = layers(k).config.color(:)';
+    end
+end
+
+ns = gds_step_mex(filename, xy, nv, z, options.units, group, names, rgb, ...
+                  options.format, options.precision);
+
+if options.verbose
+    fprintf('STEP file written successfully: %s (%d solids)\n', filename, ns);
+end
+
+end
+
+
+%% Native STEP Writer for Solids
+function write_step_solids(solids, filename, options)
+% Pack the base polygons of extruded solids and write them with
+% gds_step_mex; solids are named and colored by layer or material
+
+N = length(solids);
+polygons = cell(N, 1);
+z = zeros(N, 2);
+keys = cell(N, 1);
+colors = 0.5 * ones(N, 3);
+
+for i = 1:N
+    solid = solids{i};
+    if isfield(solid, 'polygon_xy')
+        polygons{i} = solid.polygon_xy;
+    elseif isfield(solid, 'top_face') && ~isempty(solid.top_face)
+        polygons{i} = solid.vertices(solid.top_face, 1:2);
+    else
+        error('Cannot extract polygon from solid %d', i);
+    end
+
+    if isfield(solid, 'z_bottom')
+        z(i, 1) = solid.z_bottom;
+    else
+        z(i, 1) = min(solid.vertices(:, 3));
+    end
+    if isfield(solid, 'z_top')
+        z(i, 2) = solid.z_top;
+    else
+        z(i, 2) = max(solid.vertices(:, 3));
+    end
+
+    keys{i} = '';
+    if isfield(solid, 'layer_name')
+        keys{i} = solid.layer_name;
+    elseif options.materials && isfield(solid, 'material')
+        keys{i} = solid.material;
+    end
+
+    if isfield(solid, 'color')
+        if ischar(solid.color) && length(solid.color) == 7
+            colors(i, :) = sscanf(solid.color(2:end), '%2x')' / 255;
+        elseif isnumeric(solid.color) && length(solid.color) == 3
+            colors(i, :) = solid.color(:)';
+        end
+    end
+end
+
+% one group per name; the first solid of a group gives its color
+[names, first, group] = unique(keys, 'first');
+rgb = colors(first, :);
+
+nv = cellfun(@(p) size(p, 1), polygons);
+xy = vertcat(polygons{:});
+
+ns = gds_step_mex(filename, xy, nv, z, options.units, group, names, rgb, ...
+                  options.format, options.precision);
+
+if options.verbose
+    fprintf('STEP file written successfully: %s (%d solids)\n', filename, ns);
+end
+
+end
+
+
+%% Helper: Extrude layer data in MATLAB
+function solids = extrude_layers(layers)
+% Extrude the polygons of all layers for the Python writer
+
+solids = {};
+for k = 1:length(layers)
+    for p = 1:numel(layers(k).polygons)
+        solid = gds_extrude_polygon(layers(k).polygons{p}, ...
+                                    layers(k).config.z_bottom, ...
+                                    layers(k).config.z_top);
+        solid.layer_name = layers(k).config.name;
+        if isfield(layers(k).config, 'color')
+            solid.color = layers(k).config.color;
+        end
+        if isfield(layers(k).config, 'material')
+            solid.material = layers(k).config.material;
+        end
+        solids{end+1} = solid;
+    end
+end
+
+end
+
+
 %% Helper: Check if Python is available
 function available = check_python_available(python_cmd)
 % Check if Python command works
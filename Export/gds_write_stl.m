@@ -1,14 +1,18 @@
-function gds_write_stl(solids, filename, options)
+function mesh = gds_write_stl(solids, filename, options)
 % GDS_WRITE_STL - Write 3D solids to STL file
 %
 % gds_write_stl(solids, filename)
 % gds_write_stl(solids, filename, options)
+% mesh = gds_write_stl(layer_data, filename, options)
 %
 % Writes an array of 3D solids to STL format (ASCII or binary)
 % This is the MVP implementation - simpler than STEP format
 %
 % INPUT:
-%   solids   : structure array of 3D solids from gds_extrude_polygon()
+%   solids   : structure array of 3D solids from gds_extrude_polygon(),
+%              or the layer data returned by gds_layer_to_3d(). Layer
+%              data are extruded, triangulated and written to a binary
+%              STL file in one multi-threaded pass by gds_stl_mex.
 %              Each solid must have fields:
 %                .vertices     - Mx3 matrix of 3D vertices [x y z]
 %                .faces        - Cell array or struct defining faces
@@ -21,9 +25,15 @@ function gds_write_stl(solids, filename, options)
 %       .units  - Unit scaling factor (default: 1.0)
 %       .solid_name - Name for STL solid (default: 'gds_solid')
 %       .merge_solids - Merge all solids into one STL (default: false)
+%       .threads - Number of threads for layer data (default: 0, one
+%                  thread per processor)
+%       .dedup   - Return the prisms of layer data as an indexed mesh
+%                  with shared vertices (default: false)
 %
 % OUTPUT:
 %   Writes STL file to disk
+%   mesh : (Optional) for layer data with options.dedup, a structure
+%          with fields .vertices (Mx3) and .faces (Kx3), e.g. for patch()
 %
 % EXAMPLE:
 %   % Single solid
@@ -65,11 +75,35 @@ if ~isfield(options, 'merge_solids')
     options.merge_solids = false;
 end
 
+if ~isfield(options, 'threads')
+    options.threads = 0;
+end
+
+if ~isfield(options, 'dedup')
+    options.dedup = false;
+end
+
 % Validate format
 if ~ismember(options.format, {'ascii', 'binary'})
     error('gds_write_stl: format must be ''ascii'' or ''binary'' --> %s', options.format);
 end
 
+mesh = [];
+
+% Layer data are extruded and written natively
+if isstruct(solids) && isfield(solids, 'layers')
+    if strcmp(options.format, 'binary') && exist('gds_stl_mex', 'file') == 3
+        try
+            mesh = write_stl_layers(solids.layers, filename, options);
+        catch err
+            error('gds_write_stl: failed to write STL file --> %s: %s', ...
+                  filename, err.message);
+        end
+        return;
+    end
+    solids = extrude_layers(solids.layers);
+end
+
 % Ensure solids is an array
 if ~iscell(solids) && isstruct(solids)
     if length(solids) == 1
@@ -264,6 +298,57 @@ end
 end
 
 
+%% Native STL Writer for Layer Data
+function mesh = write_stl_layers(layers, filename, options)
+% Pack the polygons of all layers with their z ranges and write them
+% with gds_stl_mex
+
+mesh = [];
+if isempty(layers)
+    error('gds_write_stl: no solids provided');
+end
+
+polygons = [layers.polygons];
+nv = cellfun(@(p) size(p, 1), polygons(:));
+xy = vertcat(polygons{:});
+if isempty(xy)
+    xy = zeros(0, 2);
+end
+
+z = zeros(numel(nv), 2);
+idx = 0;
+for k = 1:length(layers)
+    n = numel(layers(k).polygons);
+    z(idx+1:idx+n, 1) = layers(k).config.z_bottom;
+    z(idx+1:idx+n, 2) = layers(k).config.z_top;
+    idx = idx + n;
+end
+
+gds_stl_mex(filename, xy, nv, z, options.units, options.threads);
+
+if options.dedup
+    [mesh.vertices, mesh.faces] = gds_stl_mex([], xy, nv, z, options.units, options.threads);
+end
+
+end
+
+
+%% Helper: Extrude layer data in MATLAB
+function solids = extrude_layers(layers)
+% Convert layer data to solids when gds_stl_mex is not available
+
+solids = {};
+for k = 1:length(layers)
+    for p = 1:numel(layers(k).polygons)
+        solids{end+1} = gds_extrude_polygon(layers(k).polygons{p}, ...
+                                            layers(k).config.z_bottom, ...
+                                            layers(k).config.z_top);
+    end
+end
+
+end
+
+
 %% Helper: Triangulate solid faces
 function triangles = triangulate_solid(solid, unit_scale)
 % Convert solid faces to triangle list
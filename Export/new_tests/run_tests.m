@@ -29,7 +29,8 @@ function overall_results = run_tests(varargin)
         'test_extrusion_core',
         'test_file_export',
         'test_layer_extraction',
-        'test_basic_pipeline'
+        'test_basic_pipeline',
+        'test_library_names'
     };
     
     % Optional tests (run if requested)
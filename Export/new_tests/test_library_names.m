@@ -0,0 +1,136 @@
+function results = test_library_names()
+% TEST_LIBRARY_NAMES - Test the structure name index of gds_library
+%
+% Tests that structures are found by name after they were renamed,
+% including libraries in which several structures share a name.
+%
+% COVERAGE:
+%   - Lookup of structures by name (getstruct, '.' indexing)
+%   - Renaming of structures (srename)
+%   - Duplicate structure names
+%
+% USAGE:
+%   results = test_library_names()
+%
+% RETURNS:
+%   results - Structure with test results and statistics
+%
+% Part of essential GDS-STL-STEP test suite
+
+    fprintf('\n');
+    fprintf('========================================\n');
+    fprintf('Testing Library Name Index\n');
+    fprintf('========================================\n\n');
+    
+    % Standardized path setup
+    script_dir = fileparts(mfilename('fullpath'));
+    export_dir = fileparts(script_dir);
+    toolbox_root = fileparts(export_dir);
+    
+    % Add required paths (only if not already in path)
+    basic_path = fullfile(toolbox_root, 'Basic');
+    if isempty(strfind(path, basic_path)) && exist(basic_path, 'dir')
+        addpath(genpath(basic_path));
+    end
+    
+    % Initialize results
+    results = struct();
+    results.total = 0;
+    results.passed = 0;
+    results.failed = 0;
+    results.test_names = {};
+    results.test_status = {};
+    
+    % Run tests
+    results = run_test(results, 'Structure lookup after rename', ...
+                       @() test_rename());
+    
+    results = run_test(results, 'Rename of a duplicate structure name', ...
+                       @() test_rename_duplicate());
+    
+    % Print summary
+    fprintf('\n========================================\n');
+    fprintf('Library Name Index Test Summary\n');
+    fprintf('========================================\n');
+    fprintf('Total tests:  %d\n', results.total);
+    fprintf('Passed:       %d\n', results.passed);
+    fprintf('Failed:       %d\n', results.failed);
+    fprintf('Success rate: %.1f%%\n', 100 * results.passed / results.total);
+    fprintf('========================================\n\n');
+    
+    if results.failed == 0
+        fprintf('✓ ALL TESTS PASSED\n\n');
+    else
+        fprintf('✗ SOME TESTS FAILED\n\n');
+    end
+end
+
+%% Helper Functions
+
+function results = run_test(results, test_name, test_func)
+    fprintf('TEST %d: %s\n', results.total + 1, test_name);
+    fprintf('----------------------------------------\n');
+    results.total = results.total + 1;
+    results.test_names{end+1} = test_name;
+    
+    try
+        test_func();
+        fprintf('✓ PASSED\n\n');
+        results.passed = results.passed + 1;
+        results.test_status{end+1} = 'PASS';
+    catch ME
+        fprintf('✗ FAILED: %s\n\n', ME.message);
+        results.failed = results.failed + 1;
+        results.test_status{end+1} = 'FAIL';
+    end
+end
+
+function gs = make_struct(name, nel)
+    % structure with nel boundary elements
+    gs = gds_structure(name);
+    for k = 1:nel
+        rect = [0 0; 10 0; 10 10; 0 10; 0 0] + 20*k;
+        gs = add_element(gs, gds_element('boundary', 'xy', rect, 'layer', k));
+    end
+end
+
+%% Individual Test Functions
+
+function test_rename()
+    % Test lookup by old and new name after a rename
+    
+    glib = gds_library('TestLib', make_struct('A', 1), make_struct('B', 2));
+    glib = srename(glib, 'A', 'C');
+    
+    cas = getstruct(glib, 'C');
+    assert(numel(cas{1}) == 1, 'Renamed structure not found');
+    assert(numel(glib.B) == 2, 'Structure B not found');
+    
+    found = true;
+    try
+        getstruct(glib, 'A');
+    catch
+        found = false;
+    end
+    assert(~found, 'Old structure name still found');
+    
+    fprintf('  ✓ Renamed structure found by its new name\n');
+end
+
+function test_rename_duplicate()
+    % Rename the first of two structures with the same name; the
+    % second one must still be found by the shared name
+    
+    glib = gds_library('TestLib', make_struct('A', 1), make_struct('A', 2));
+    glib = srename(glib, 'A', 'C');
+    
+    cas = getstruct(glib, 'A');
+    assert(numel(cas{1}) == 2, 'Second structure A not found by getstruct');
+    assert(numel(glib.A) == 2, 'Second structure A not found by name');
+    assert(numel(glib.C) == 1, 'Renamed structure not found');
+    
+    glib = srename(glib, 'A', 'D');
+    assert(numel(glib.D) == 2, 'Second structure A could not be renamed');
+    
+    fprintf('  ✓ Structure with duplicate name found after rename\n');
+end
@@ -0,0 +1,108 @@
+function polys = cut_holes(pc, hf)
+%function polys = cut_holes(pc, hf)
+%
+% cut_holes :  cuts the holes returned by poly_boolmex into their
+%              outer polygons along keyhole edges; extruded solids
+%              have a single boundary.
+%
+% pc :     cell array with polygons
+% hf :     hole flags of the polygons
+% polys :  cell array with the outer polygons, counter-clockwise,
+%          with their holes spliced in
+
+    hf = logical(hf);
+    polys = pc(~hf);
+    holes = pc(hf);
+    if isempty(holes)
+        return;
+    end
+    
+    % counter-clockwise outer polygons, clockwise holes
+    area = zeros(1, length(polys));
+    for k = 1:length(polys)
+        area(k) = signed_area(polys{k});
+        if area(k) < 0
+            polys{k} = flipud(polys{k});
+            area(k) = -area(k);
+        end
+    end
+    
+    % each hole belongs to the smallest outer polygon containing it
+    owner = zeros(1, length(holes));
+    hmax = zeros(1, length(holes));
+    for h = 1:length(holes)
+        if signed_area(holes{h}) > 0
+            holes{h} = flipud(holes{h});
+        end
+        p = holes{h}(1, :);
+        best = Inf;
+        for k = 1:length(polys)
+            if area(k) < best && inpolygon(p(1), p(2), polys{k}(:,1), polys{k}(:,2))
+                best = area(k);
+                owner(h) = k;
+            end
+        end
+        hmax(h) = max(holes{h}(:,1));
+    end
+    
+    % holes are bridged from right to left, so a bridge can end on
+    % a hole that was cut before
+    [~, order] = sort(hmax, 'descend');
+    for h = order
+        if owner(h)
+            polys{owner(h)} = bridge_hole(polys{owner(h)}, holes{h});
+        end
+    end
+end
+
+
+function p = bridge_hole(p, h)
+% Connect the rightmost vertex M of hole h to a visible vertex P of
+% polygon p and splice the hole into p at P
+
+    [~, m] = max(h(:,1));
+    M = h(m, :);
+    n = size(p, 1);
+    a = p;
+    b = p([2:n, 1], :);
+    
+    % nearest edge crossed by the ray from M in +x direction
+    cross = (a(:,2) - M(2)) .* (b(:,2) - M(2)) <= 0 & a(:,2) ~= b(:,2);
+    x = a(:,1) + (M(2) - a(:,2)) .* (b(:,1) - a(:,1)) ./ (b(:,2) - a(:,2) + ~cross);
+    x(~cross | x < M(1)) = Inf;
+    [xi, e] = min(x);
+    if isinf(xi)
+        return;
+    end
+    if a(e, 1) >= b(e, 1)
+        ip = e;
+    else
+        ip = mod(e, n) + 1;
+    end
+    
+    % a vertex inside the triangle M, I, P blocks the view of P; the
+    % vertex with the smallest angle to the ray is visible
+    P = p(ip, :);
+    if P(1) ~= xi || P(2) ~= M(2)
+        tx = [M(1), xi, P(1)];
+        ty = [M(2), M(2), P(2)];
+        inside = find(inpolygon(p(:,1), p(:,2), tx, ty) & p(:,1) >= M(1));
+        inside = inside(inside ~= ip);
+        if ~isempty(inside)
+            d = p(inside, :) - M;
+            ang = atan2(abs(d(:,2)), d(:,1));
+            dist = sum(d.^2, 2);
+            [~, best] = sortrows([ang, dist]);
+            ip = inside(best(1));
+        end
+    end
+    
+    p = [p(1:ip, :); h(m:end, :); h(1:m, :); p(ip:end, :)];
+end
+
+
+function a = signed_area(p)
+% Signed area of a polygon; positive for counter-clockwise polygons
+
+    a = 0.5 * sum(p(:,1) .* p([2:end, 1], 2) - p([2:end, 1], 1) .* p(:,2));
+end
@@ -0,0 +1,45 @@
+function T = layer_table(layer_config, layers_filter, datatypes_filter, enabled_only)
+%function T = layer_table(layer_config, layers_filter, datatypes_filter, enabled_only)
+%
+% layer_table :  compiles a layer configuration into a 256 x 256
+%                layer table. T(layer+1, dtype+1) is the index of the
+%                layer stack entry of a (layer, data type) pair in
+%                layer_config.layers, or 0 when elements on the pair
+%                are not converted. The filters and the enabled flags
+%                are folded into the table, so that an element is
+%                mapped with a single lookup, also in compiled code
+%                (see gds_flatten_mex).
+%
+% layer_config :      layer configuration (see gds_read_layer_config)
+% layers_filter :     (Optional) layers to convert; all when empty
+% datatypes_filter :  (Optional) data types to convert; all when empty
+% enabled_only :      (Optional) when true, disabled stack entries are
+%                     removed. Default is true.
+% T :                 256 x 256 layer table
+
+    if nargin < 4, enabled_only = true; end
+    if nargin < 3, datatypes_filter = []; end
+    if nargin < 2, layers_filter = []; end
+
+    T = double(layer_config.layer_map);
+
+    if enabled_only && ~isempty(layer_config.layers)
+        off = find(~[layer_config.layers.enabled]);
+        T(ismember(T, off)) = 0;
+    end
+
+    if ~isempty(layers_filter)
+        keep = false(256, 1);
+        lf = layers_filter(layers_filter >= 0 & layers_filter <= 255);
+        keep(lf + 1) = true;
+        T(~keep, :) = 0;
+    end
+
+    if ~isempty(datatypes_filter)
+        keep = false(1, 256);
+        df = datatypes_filter(datatypes_filter >= 0 & datatypes_filter <= 255);
+        keep(df + 1) = true;
+        T(:, ~keep) = 0;
+    end
+
+end
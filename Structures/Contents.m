@@ -2,7 +2,7 @@
 % ===========================================
 %
 % gdsii_bitmap      - return the representation of a bitmap
-%                     made from boundary element pixels.
+%                     made from rectangles or boundary element pixels.
 % gdsii_datamatrix  - return a Datamatrix encoding of a 
 %                     user supplied string.
 % gdsii_cdfeature   - return a critical dimension pattern
@@ -18,6 +18,12 @@
 % gdsii_zonelens    - returns a layout consisting of concentric
 %                     rings (e.g. a zone lens).
 %
+% Functions that Write to a Library File
+% ======================================
+%
+% gdsii_zonelens_write - write the layout of a zone lens directly
+%                        to a file opened with gds_initialize.
+%
 % Ulf Griesmann, NIST, 2008 - 2015
 % -------------------------------------------------------
 
@@ -15,11 +15,14 @@ function [bms] = gdsii_bitmap(bmap, pixel, sname, layer)
 %          By default, a pixel is defined by a square boundary
 %          and only the width of the pixel needs to be specified. For 
 %          rectangular pixels the pixel height must also be specified.
-%          The function generates a gds_structure object containing the pixel
-%          which has the default name BITMAP_PIXEL. If more than one bitmap is
-%          used in a layout, the name can be made unique by specifying pixel.sname.
+%          By default, adjacent black pixels are merged into rectangles,
+%          which are returned as one boundary element in a single
+%          gds_structure object. When pixel.psname is specified, the
+%          function generates a gds_structure object containing the pixel,
+%          and the bitmap is composed of references to it. If more than
+%          one bitmap is used in a layout, the name must be unique.
 %          Finally, a pixel can also be defined by an external structure specified
-%          in pixel.rsname.
+%          in pixel.esname.
 % sname :  (Optional) name of the created structure. Default is 'BITMAP'.
 % layer :  (Optional) layer to which the pattern is
 %          written. Default is 1.
@@ -27,6 +30,7 @@ function [bms] = gdsii_bitmap(bmap, pixel, sname, layer)
 %         
 % initial version: Ulf Griesmann, NIST, Feb 2011
 % removed global variable gdsii_layer, Jan 2012, U.G.
+% merge pixels into rectangles with bitmapmex, Oct 2026
 %
 
     % check arguments
@@ -52,11 +56,23 @@ function [bms] = gdsii_bitmap(bmap, pixel, sname, layer)
     % create output cell array
     bms = {};
 
+    % merge black pixels into rectangles
+    if ~isfield(pixel, 'esname') && ~isfield(pixel, 'psname')
+        if issparse(bmap) || ~(islogical(bmap) || isa(bmap,'double') || ...
+                               isa(bmap,'uint8') || isa(bmap,'int8'))
+            bmap = full(bmap ~= 0);
+        end
+        R = bitmapmex(bmap, pixel.width, pixel.height);
+        if isempty(R)
+            bms{1} = gds_structure(sname);
+        else
+            bms{1} = gds_structure(sname, gds_element('boundary', 'xy',R, 'layer',layer));
+        end
+        return
+    end
+
     % create pixel if no external pixel structure is referenced
     if ~isfield(pixel, 'esname')
-        if ~isfield(pixel, 'psname')
-            pixel.psname = 'BITMAP_PIXEL';
-	end
 	bm_pixel = [0,0; pixel.width,0; pixel.width,pixel.height; 0,pixel.height; 0,0];
 	bms{end+1} = gdsii_pattern(pixel.psname, bm_pixel, layer);
     else
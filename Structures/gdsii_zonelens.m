@@ -45,6 +45,9 @@ function [cas] = gdsii_zonelens(sname,rad,pos,maxpe,ctrblack,papprox,layer,apert
 % of several zone lenses. In the unlikely case of a name collision the
 % layout script should be run again to avoid the collision.
 % 3) The number of vertices in a zone segment has an upper limit of 800.
+% 4) Large zone plates without aperture are written much faster
+% with gdsii_zonelens_write, which writes the same layout directly
+% to a library file.
 
 % Ulf Griesmann, NIST, Feb. 2008
 %   U.G., Aug. 2008: added writing to different layers
@@ -54,6 +57,7 @@ function [cas] = gdsii_zonelens(sname,rad,pos,maxpe,ctrblack,papprox,layer,apert
 %   U.G., October 2012: return gds_structure object
 %   U.G., August 2014, renovated
 %   U.G., March 2015, fixed a couple bugs
+%   October 2026: zone segments are computed by zonelensmex
 
     % check input parameters
     if nargin < 9, verbose = false; end
@@ -140,6 +144,13 @@ function [cas] = gdsii_zonelens(sname,rad,pos,maxpe,ctrblack,papprox,layer,apert
     if verbose
         fprintf('Processing %d zones ...\n',nzon);
     end
+    ri = cellfun(@(z)z.ri, zpar);
+    ro = cellfun(@(z)z.ro, zpar);
+    [sxy, nseg] = zonelensmex(ri, ro, maxpe, papprox);
+    for k = 1:nzon
+        zpar{k}.xy = sxy{k};
+        zpar{k}.ns = nseg(k);
+    end
     cas = cellfun(@single_zone, zpar, 'UniformOutput',0);
         
     % add references to main structure & flatten cell array if necessary
@@ -187,17 +198,16 @@ function [zos] = single_zone(zpar);
 %         zpar.pe - zone polygon error
 %         zpar.ap - aperture
 %         zpar.vb - verbose flag
+%         zpar.xy - polygon of the first zone segment
+%         zpar.ns - number of zone segments
 %
 % zos :   EITHER a cell array of gds_structure objects, one for
 %         each zone, OR a cell array of cell arrays each
 %         containting a pair of gds_structure objects.
 
-    % calculate number of segments with about 800 vertices
-    np = calc_phi(zpar.ro, zpar.pe, pi/2, zpar.pa);
-    nseg = max(round(4*np/400),8); % 8 segments || < 800 vertices
-        
-    % generate boundary data for a segment centered at 0
-    xy = generate_segment(zpar.ri, zpar.ro, 2*pi/nseg, zpar.pe, zpar.pa);
+    % segment boundary (computed by zonelensmex)
+    xy = zpar.xy;
+    nseg = zpar.ns;
     
     if ~isempty(zpar.ap)               % replicate polygon "manually"
         
@@ -238,88 +248,6 @@ function [zos] = single_zone(zpar);
 end
 
 
-%---------------------------------------------------------
-
-function [xy] = generate_segment(r1, r2, sa, pe, pap);
-%
-% generate the description of 1/8 of a ring in the first
-% quadrant using a polygon (or boundary)
-%
-% r1  : inner radius (r1 == 0 is the center)
-% r2  : outer radius
-% sa  : segment angle in radians
-% pe  : max polygon error (or sag)
-% pap : type of polygon approximation (equal area or equal arc length)
-
-    % calculate number of inner points (and correction factor)
-    % needed for the desired polygon error
-    if r1 > 0
-        [np1, cfac1] = calc_phi(r1, pe, sa, pap);
-    end
-
-    % calculate number of outer points needed (and correction factor) 
-    % for desired polygon error
-    [np2, cfac2] = calc_phi(r2, pe, sa, pap);
-    
-    % generate all points in polar coordinates
-    % ra(:,1) is the angle
-    % ra(:,2) is the radius
-    if r1 > 0
-        ra1 = zeros(np1, 2);
-        ra1(:,1) = (0 : sa/(np1-1) : sa)'; % angle in first column
-        ra1(:,2) = cfac1 * r1;                       % radius in 2nd column
-    end
-    ra2 = zeros(np2, 2);
-    ra2(:,1) = (sa : -sa/(np2-1) : 0)';
-    ra2(:,2) = cfac2 * r2;
-    
-    % assemble the boundary vertices
-    if r1 > 0
-        ra = vertcat(ra1,ra2,ra1(1,:));
-    else
-        ra = vertcat(ra2,[0,0],ra2(1,:)); % the whole quadrant
-    end
-    if length(ra) > 2^15 - 1
-        error('too many points in boundary');
-    end
-    
-    % and transform it to cartesian coordinates
-    xy = pol_cart(ra(:,1), ra(:,2));
-
-end
-
-
-%---------------------------------------------------------
-
-function XY = pol_cart(T,R);
-% convert from polar to cartesian coordinates
-    XY = [R.*cos(T),R.*sin(T)];
-end
-
-
-%---------------------------------------------------------
-
-function [np, cfac] = calc_phi(R, E, A, pap);
-% calculate number of vertices on an arc needed for the 
-% desired polygon error and the correction factor for the radii
-    alpha = 1 + E / R;
-    if pap == 1     % equal area
-        phi  = sqrt(6) * sqrt((alpha^2-1)/alpha^2); % 3rd order approx.
-        np   = 1 + ceil(A / phi);                   % vertices per segemnt
-        phi = A / (np - 1);                         % corrected angle
-        cfac = sqrt( phi / sin(phi) );
-    elseif pap == 2 % equal arc length 
-        phi = 2 * sqrt(6 * (alpha-1)/alpha);        % 3rd order approx.
-        np   = 1 + ceil(A / phi);                   % vertices per segment
-        phi = A / (np - 1);                         % corrected angle
-        cfac = 0.5 * phi / sin(phi/2); 
-    else
-        error('unknown circle approximation method.');
-    end
-    
-end
-
-
 %---------------------------------------------------------
 
 function data = flatten_cells(data)
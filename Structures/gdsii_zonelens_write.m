@@ -0,0 +1,87 @@
+function gdsii_zonelens_write(gf,sname,rad,pos,maxpe,ctrblack,papprox,layer,maxvert)
+%function gdsii_zonelens_write(gf,sname,rad,pos,maxpe,ctrblack,papprox,layer,maxvert)
+%
+% Writes the layout of a zone plate directly to a GDSII library
+% file. The layout is the same as the layout returned by
+% gdsii_zonelens without an aperture, but the zone polygons are
+% computed and written by a mex function without creating
+% gds_structure or gds_element objects. This is much faster for
+% zone plates with many zones or very small polygon errors.
+%
+% gf       : a file handle returned by gds_initialize. The layout
+%            is written with the units passed to gds_initialize.
+% sname    : name of the top level GDSII structure. Default is ZONE_LENS.
+% rad      : a vector with zone radii in GDS user units
+% pos      : (OPTIONAL) position of the zone plate on the photomask in GDS
+%            user coordinates. Default is [0,0].
+% maxpe    : (OPTIONAL) polygon error (or sag) in GDS user units which
+%            controls how well the circles are approximated by
+%            polygons. Default is 1.
+% ctrblack : (OPTIONAL) if set to 1, the central area will be
+%            black, otherwise it will be transparent. Default is 0.
+% papprox  : (OPTIONAL) method used to approximate circles by
+%            polygons. Can have the following values:
+%              1 = the polygons approximating circles have the same
+%                  area as the circles. (This is the DEFAULT)
+%              2 = the polygons approximating circles have a length
+%                  equal to the circumference of the circles.
+% layer    : (OPTIONAL) layer to which the layout is written. Default is 1.
+% maxvert  : (OPTIONAL) maximum number of vertices in a zone segment.
+%            Zones are divided into at least 8 segments. Default
+%            is 800. Segments with more than 8191 vertices are
+%            written with several XY records.
+%
+% Example:
+%            gf = gds_initialize('lens.gds', 1e-6, 1e-9, 'LENS');
+%            gdsii_zonelens_write(gf, 'LENS', sqrt(1:20000), [], 1e-3);
+%            gds_endlib(gf);
+%            gds_close(gf);
+%
+% NOTE
+% Structure names used internally by the function contain a random
+% number to ensure that the names are unique even when a layout consist
+% of several zone lenses (see gdsii_zonelens).
+
+% Initial version, October 2026
+
+    % global variables
+    global gdsii_uunit;
+
+    % check input parameters
+    if nargin < 9, maxvert = []; end
+    if nargin < 8, layer = []; end
+    if nargin < 7, papprox = []; end
+    if nargin < 6, ctrblack = []; end
+    if nargin < 5, maxpe = []; end
+    if nargin < 4, pos = []; end
+    if nargin < 3
+        error('gdsii_zonelens_write :  requires at least three arguments');
+    end
+
+    if isempty(sname), sname = 'ZONE_LENS'; end
+    if isempty(pos), pos = [0,0]; end
+    if isempty(maxpe), maxpe = 1; end
+    if isempty(ctrblack), ctrblack = 0; end
+    if isempty(papprox), papprox = 1; end
+    if isempty(layer), layer = 1; end
+    if isempty(maxvert), maxvert = 800; end
+    if isempty(gdsii_uunit)
+        error('gdsii_zonelens_write :  library file must be created with gds_initialize.');
+    end
+
+    % inner and outer zone radii
+    rad = rad(:)';
+    if ctrblack == 0
+        ri = rad(1:2:end-1);
+        ro = rad(2:2:end);
+    else
+        ri = [0, rad(2:2:end-1)];
+        ro = rad(1:2:end);
+    end
+
+    % write the zone plate
+    zpid = floor(10000*rand(1));   % unique zone plate id
+    zonewritemex(gf, sname, ri, ro, pos, maxpe, papprox, maxvert, ...
+                 layer, zpid, gdsii_uunit);
+
+end
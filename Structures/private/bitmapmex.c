@@ -0,0 +1,108 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Covers the black pixels of a bitmap with rectangles (see
+ * bmrect.h). Runs of black pixels in a row, and runs with the
+ * same columns in consecutive rows, become one rectangle.
+ *
+ * R = bitmapmex(bmap, width, height);
+ *
+ * Input
+ * bmap :    matrix with elements ~= 0 for black pixels. Must be a
+ *           logical, uint8, int8, or double matrix. The first row
+ *           of the matrix is at the top of the bitmap.
+ * width :   width of a pixel in user units
+ * height :  height of a pixel in user units
+ *
+ * Output
+ * R :       cell array with one closed polygon (5x2 matrix) per
+ *           rectangle in user units. The lower left corner of the
+ *           bitmap is at the origin.
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include "mex.h"
+
+#include "bmrect.h"
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   bm_list_t ls;
+   bm_rect_t *pr;
+   mxArray *pa;
+   uint8_t *pix;
+   const uint8_t *pb;
+   const double *pd;
+   double *pxy;
+   double w, h, x0, y0, x1, y1;
+   size_t nrow, ncol, k, r, c;
+
+   /* check arguments */
+   if (nrhs != 3)
+      mexErrMsgTxt("bitmapmex :  3 input arguments expected.");
+   if ( mxGetNumberOfDimensions(prhs[0]) != 2 )
+      mexErrMsgTxt("bitmapmex :  bitmap must be a matrix.");
+   if ( !mxIsLogical(prhs[0]) && !mxIsUint8(prhs[0]) && !mxIsInt8(prhs[0]) &&
+        !mxIsDouble(prhs[0]) )
+      mexErrMsgTxt("bitmapmex :  bitmap must be a logical, uint8, int8, or double matrix.");
+   if ( mxIsComplex(prhs[0]) )
+      mexErrMsgTxt("bitmapmex :  bitmap must be real.");
+   nrow = mxGetM(prhs[0]);
+   ncol = mxGetN(prhs[0]);
+   if (nrow > INT32_MAX || ncol > INT32_MAX)
+      mexErrMsgTxt("bitmapmex :  bitmap is too large.");
+   w = mxGetScalar(prhs[1]);
+   h = mxGetScalar(prhs[2]);
+
+   /* bitmap by rows, bottom row first */
+   pix = mxMalloc(nrow * ncol + 1);
+   if ( mxIsDouble(prhs[0]) ) {
+      pd = mxGetPr(prhs[0]);
+      for (c=0; c<ncol; c++)
+	 for (r=0; r<nrow; r++)
+	    pix[(nrow-1-r)*ncol + c] = pd[r + c*nrow] != 0.0;
+   }
+   else {
+      pb = (const uint8_t *)mxGetData(prhs[0]);
+      for (c=0; c<ncol; c++)
+	 for (r=0; r<nrow; r++)
+	    pix[(nrow-1-r)*ncol + c] = pb[r + c*nrow] != 0;
+   }
+
+   memset(&ls, 0, sizeof(bm_list_t));
+   if ( bm_rectangles(pix, (int32_t)ncol, (int32_t)nrow, &ls) ) {
+      bm_list_free(&ls);
+      mexErrMsgTxt("bitmapmex :  failed to allocate memory.");
+   }
+   mxFree(pix);
+
+   /* return the rectangles as polygons */
+   plhs[0] = mxCreateCellMatrix(1, ls.nrect);
+   for (k=0; k<ls.nrect; k++) {
+      pr = &ls.rect[k];
+      x0 = w * pr->x;
+      y0 = h * pr->y;
+      x1 = w * (pr->x + pr->w);
+      y1 = h * (pr->y + pr->h);
+      pa = mxCreateDoubleMatrix(5, 2, mxREAL);
+      pxy = mxGetPr(pa);
+      pxy[0] = x0; pxy[5] = y0;
+      pxy[1] = x1; pxy[6] = y0;
+      pxy[2] = x1; pxy[7] = y1;
+      pxy[3] = x0; pxy[8] = y1;
+      pxy[4] = x0; pxy[9] = y0;
+      mxSetCell(plhs[0], k, pa);
+   }
+
+   bm_list_free(&ls);
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,137 @@
+/*
+ * Decomposition of bitmaps into rectangles
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "bmrect.h"
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int add_rect(bm_list_t *pl, const bm_rect_t *pr);
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the rectangles that end in the previous row are open; they are
+ * continued when the current row has a run with the same columns
+ * and added to the list otherwise.
+ */
+int
+bm_rectangles(const uint8_t *pix, int32_t ncol, int32_t nrow, bm_list_t *pl)
+{
+   bm_rect_t *open, *next, *pt;
+   const uint8_t *row;
+   size_t nopen, nnext, k;
+   int32_t x, x0, y;
+   int ret = -1;
+
+   if (ncol <= 0 || nrow <= 0)
+      return 0;
+
+   /* a row has at most (ncol+1)/2 runs */
+   open = malloc(((size_t)ncol + 1) * sizeof(bm_rect_t));
+   if (open == NULL)
+      return -1;
+   next = open + (ncol + 1) / 2;
+   nopen = 0;
+
+   for (y=0; y<nrow; y++) {
+
+      row = pix + (size_t)y * ncol;
+      nnext = 0;
+      k = 0;
+
+      for (x=0; x<ncol; ) {
+
+	 /* next run */
+	 while (x < ncol && !row[x])
+	    x++;
+	 if (x == ncol)
+	    break;
+	 x0 = x;
+	 while (x < ncol && row[x])
+	    x++;
+
+	 /* open rectangles left of the run end */
+	 while (k < nopen && open[k].x < x0) {
+	    if ( add_rect(pl, &open[k++]) )
+	       goto done;
+	 }
+
+	 if (k < nopen && open[k].x == x0 && open[k].w == x - x0) {
+	    next[nnext] = open[k++];
+	    next[nnext++].h++;
+	 }
+	 else {
+	    if (k < nopen && open[k].x == x0) {
+	       if ( add_rect(pl, &open[k++]) )
+		  goto done;
+	    }
+	    next[nnext].x = x0;
+	    next[nnext].y = y;
+	    next[nnext].w = x - x0;
+	    next[nnext++].h = 1;
+	 }
+      }
+
+      /* rectangles without continuation */
+      while (k < nopen) {
+	 if ( add_rect(pl, &open[k++]) )
+	    goto done;
+      }
+
+      pt = open;
+      open = next;
+      next = pt;
+      nopen = nnext;
+   }
+
+   for (k=0; k<nopen; k++) {
+      if ( add_rect(pl, &open[k]) )
+	 goto done;
+   }
+   ret = 0;
+
+ done:
+   free(open < next ? open : next);
+   return ret;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+bm_list_free(bm_list_t *pl)
+{
+   free(pl->rect);
+   memset(pl, 0, sizeof(bm_list_t));
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+add_rect(bm_list_t *pl, const bm_rect_t *pr)
+{
+   void *pn;
+   size_t na;
+
+   if (pl->nrect == pl->arect) {
+      na = pl->arect ? 2 * pl->arect : 1024;
+      pn = realloc(pl->rect, na * sizeof(bm_rect_t));
+      if (pn == NULL)
+	 return -1;
+      pl->rect = pn;
+      pl->arect = na;
+   }
+   pl->rect[pl->nrect++] = *pr;
+
+   return 0;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,65 @@
+/*
+ * Decomposition of bitmaps into rectangles.
+ *
+ * The black pixels of a bitmap are covered with rectangles that
+ * do not overlap. Each row of the bitmap is split into runs of
+ * black pixels, and runs with the same first and last column in
+ * consecutive rows are merged into one rectangle. A bitmap with
+ * large black areas is described by far fewer rectangles than
+ * pixels; the time is proportional to the number of pixels.
+ *
+ * Coordinates are in pixels. The functions do not use the MATLAB
+ * API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _BMRECT_H
+#define _BMRECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*
+ * a rectangle of black pixels
+ */
+typedef struct {
+   int32_t x, y;         /* lower left pixel */
+   int32_t w, h;         /* width and height in pixels */
+} bm_rect_t;
+
+
+/*
+ * list of rectangles; set to zero before the first call of
+ * bm_rectangles.
+ */
+typedef struct {
+   bm_rect_t *rect;      /* rectangles */
+   size_t nrect;         /* number of rectangles */
+   size_t arect;         /* allocated length of rect */
+} bm_list_t;
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * adds the rectangles covering the black pixels of a bitmap to a
+ * list. Returns 0 on success or -1 when memory cannot be allocated.
+ *
+ * pix :   bitmap with ncol x nrow bytes, stored by rows; the first
+ *         row is at y = 0. Pixels != 0 are black.
+ * ncol :  number of columns
+ * nrow :  number of rows
+ * pl :    list of rectangles
+ */
+int bm_rectangles(const uint8_t *pix, int32_t ncol, int32_t nrow, bm_list_t *pl);
+
+/*
+ * release the list of rectangles
+ */
+void bm_list_free(bm_list_t *pl);
+
+#endif /* _BMRECT_H */
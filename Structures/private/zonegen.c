@@ -0,0 +1,299 @@
+/*
+ * Generation of zone plate layouts (see zonegen.h).
+ *
+ * Copyright (c) 2026
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "zonegen.h"
+
+#if !defined _WIN32
+   #include <pthread.h>
+   #include <unistd.h>
+   #define HAVE_PTHREADS
+#endif
+
+#define MAXTHREADS 256
+
+/* upper limit for the number of vertices on an arc */
+#define MAXARC  1.0e9
+
+#ifndef M_PI
+   #define M_PI 3.14159265358979323846
+#endif
+
+
+/*
+ * the zones computed by one thread: first, first+step, ...
+ */
+typedef struct {
+   zg_zone_t *pz;
+   size_t nz;
+   size_t first, step;
+   double pe;
+   int pap;
+   int err;
+} zg_job_t;
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int zone_segment(zg_zone_t *pz, double pe, int pap);
+static void *zg_worker(void *arg);
+static int num_processors(void);
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the angle phi of a chord with sag pe is approximated to 3rd
+ * order; the angle is then reduced such that the arc is divided
+ * into equal chords.
+ */
+size_t
+zg_arc(double r, double pe, double a, int pap, double *cfac)
+{
+   double alpha, phi, n;
+   size_t np;
+
+   if (r <= 0.0 || pe <= 0.0 || a <= 0.0)
+      return 0;
+
+   alpha = 1.0 + pe / r;
+   if (pap == ZG_EQUAL_AREA)
+      phi = sqrt(6.0) * sqrt((alpha*alpha - 1.0) / (alpha*alpha));
+   else if (pap == ZG_EQUAL_LENGTH)
+      phi = 2.0 * sqrt(6.0 * (alpha - 1.0) / alpha);
+   else
+      return 0;
+
+   n = ceil(a / phi);
+   if ( !(n < MAXARC) )
+      return 0;
+   np = 1 + (size_t)n;
+
+   phi = a / (double)(np - 1);
+   if (pap == ZG_EQUAL_AREA)
+      *cfac = sqrt(phi / sin(phi));
+   else
+      *cfac = 0.5 * phi / sin(0.5 * phi);
+
+   return np;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+zg_segments(double ro, double pe, int pap, size_t maxv)
+{
+   double cfac, nseg;
+   size_t np;
+
+   np = zg_arc(ro, pe, 0.5 * M_PI, pap, &cfac);
+   if (np == 0 || maxv < 2)
+      return 0;
+
+   /* about maxv/2 vertices on the outer arc */
+   nseg = floor(4.0 * np / (0.5 * maxv) + 0.5);
+   if (nseg < ZG_MIN_SEG)
+      nseg = ZG_MIN_SEG;
+   if (nseg > MAXARC)
+      return 0;
+
+   return (int)nseg;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+int
+zg_zones(zg_zone_t *pz, size_t nz, double pe, int pap, size_t maxv,
+         int nthreads)
+{
+   zg_job_t job[MAXTHREADS];
+   double cfac, nvert;
+   size_t k;
+   int nt, t, err;
+#if defined HAVE_PTHREADS
+   pthread_t tid[MAXTHREADS];
+   int started[MAXTHREADS];
+#endif
+
+   if (nz == 0)
+      return 0;
+
+   /* check the zones; estimate the number of vertices */
+   nvert = 0.0;
+   for (k=0; k<nz; k++) {
+      pz[k].xy = NULL;
+      pz[k].nv = 0;
+      if (pz[k].ri < 0.0 || pz[k].ro <= pz[k].ri)
+	 return 1;
+      if ( (pz[k].nseg = zg_segments(pz[k].ro, pe, pap, maxv)) == 0 )
+	 return 1;
+      nvert += zg_arc(pz[k].ro, pe, 2.0 * M_PI, pap, &cfac);
+   }
+
+   /* number of threads */
+   if (nthreads < 1)
+      nthreads = num_processors();
+   if (nthreads > MAXTHREADS)
+      nthreads = MAXTHREADS;
+   if (nvert < ZG_MIN_PARALLEL || nz < 2)
+      nthreads = 1;
+   if ((size_t)nthreads > nz)
+      nthreads = (int)nz;
+#if !defined HAVE_PTHREADS
+   nthreads = 1;
+#endif
+
+   /* neighbouring zones have similar sizes; the zones are dealt to
+      the threads like cards */
+   nt = nthreads;
+   for (t=0; t<nt; t++) {
+      job[t].pz = pz;
+      job[t].nz = nz;
+      job[t].first = t;
+      job[t].step = nt;
+      job[t].pe = pe;
+      job[t].pap = pap;
+      job[t].err = 0;
+   }
+
+#if defined HAVE_PTHREADS
+   /* the calling thread takes the first share */
+   for (t=1; t<nt; t++)
+      started[t] = !pthread_create(&tid[t], NULL, zg_worker, &job[t]);
+   zg_worker(&job[0]);
+   for (t=1; t<nt; t++) {
+      if (started[t])
+	 pthread_join(tid[t], NULL);
+      else
+	 zg_worker(&job[t]);
+   }
+#else
+   zg_worker(&job[0]);
+#endif
+
+   err = 0;
+   for (t=0; t<nt; t++) {
+      if (job[t].err)
+	 err = job[t].err;
+   }
+   if (err)
+      zg_zones_free(pz, nz);
+
+   return err;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+void
+zg_zones_free(zg_zone_t *pz, size_t nz)
+{
+   size_t k;
+
+   for (k=0; k<nz; k++) {
+      free(pz[k].xy);
+      pz[k].xy = NULL;
+      pz[k].nv = 0;
+   }
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * the segment polygon runs along the inner arc from angle 0 to the
+ * segment angle and back along the outer arc. The segment of the
+ * central zone (ri == 0) is a circular sector.
+ */
+static int
+zone_segment(zg_zone_t *pz, double pe, int pap)
+{
+   double sa, cfi, cfo, ri, ro, t;
+   double *px, *py;
+   size_t npi, npo, k, n;
+
+   sa = 2.0 * M_PI / pz->nseg;
+   cfi = 1.0;
+   npi = 0;
+   if (pz->ri > 0.0) {
+      npi = zg_arc(pz->ri, pe, sa, pap, &cfi);
+      if (npi == 0)
+	 return 1;
+   }
+   npo = zg_arc(pz->ro, pe, sa, pap, &cfo);
+   if (npo == 0)
+      return 1;
+
+   pz->nv = (npi ? npi : 1) + npo + 1;
+   pz->xy = malloc(2 * pz->nv * sizeof(double));
+   if (pz->xy == NULL) {
+      pz->nv = 0;
+      return -1;
+   }
+   px = pz->xy;
+   py = pz->xy + pz->nv;
+   n = 0;
+
+   /* inner arc */
+   ri = cfi * pz->ri;
+   for (k=0; k<npi; k++, n++) {
+      t = k+1 == npi ? sa : k * sa / (npi - 1);
+      px[n] = ri * cos(t);
+      py[n] = ri * sin(t);
+   }
+
+   /* outer arc */
+   ro = cfo * pz->ro;
+   for (k=0; k<npo; k++, n++) {
+      t = k+1 == npo ? 0.0 : sa - k * sa / (npo - 1);
+      px[n] = ro * cos(t);
+      py[n] = ro * sin(t);
+   }
+
+   /* center of a sector, and the closing vertex */
+   if (npi == 0) {
+      px[n] = 0.0;
+      py[n++] = 0.0;
+   }
+   px[n] = px[0];
+   py[n] = py[0];
+
+   return 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static void *
+zg_worker(void *arg)
+{
+   zg_job_t *job = (zg_job_t *)arg;
+   size_t k;
+
+   for (k=job->first; k<job->nz && !job->err; k+=job->step)
+      job->err = zone_segment(&job->pz[k], job->pe, job->pap);
+
+   return NULL;
+}
+
+
+/*-----------------------------------------------------------------*/
+
+static int
+num_processors(void)
+{
+#if defined HAVE_PTHREADS && defined _SC_NPROCESSORS_ONLN
+   long n = sysconf(_SC_NPROCESSORS_ONLN);
+   return n > 0 ? (int)n : 1;
+#else
+   return 1;
+#endif
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,104 @@
+/*
+ * Generation of zone plate layouts.
+ *
+ * A zone plate consists of concentric rings (zones). Each zone is
+ * divided into nseg equal segments; the layout contains the polygon
+ * of the first segment, which starts at angle 0, and the zone is
+ * created by rotating the segment in steps of 360/nseg degrees.
+ * The circular arcs of a segment are approximated by polygon
+ * chords; the number of chords is chosen such that the polygon
+ * error (sag) does not exceed a given value, and the radii of the
+ * vertices are corrected such that the polygon has the same area,
+ * or the same length, as the arc.
+ *
+ * The zones are computed by several threads. The number of vertices
+ * of a segment is not limited; the GDSII writer (see elwrite.h)
+ * splits long vertex lists into several XY records. The functions
+ * do not use the MATLAB API.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _ZONEGEN_H
+#define _ZONEGEN_H
+
+#include <stddef.h>
+
+
+/* polygon approximation of circular arcs */
+#define ZG_EQUAL_AREA    1
+#define ZG_EQUAL_LENGTH  2
+
+/* default maximum number of vertices of a segment */
+#define ZG_MAX_VERT    800
+
+/* minimum number of segments of a zone */
+#define ZG_MIN_SEG     8
+
+
+/*
+ * a zone and the polygon of its first segment. The vertices are
+ * stored column-major, like an nv x 2 MATLAB matrix.
+ */
+typedef struct {
+   double ri;         /* inner radius; 0 for the center */
+   double ro;         /* outer radius */
+   int nseg;          /* number of segments */
+   double *xy;        /* nv x 2 polygon vertices (closed) */
+   size_t nv;         /* number of vertices */
+} zg_zone_t;
+
+
+/* zone batches with fewer vertices are computed by one thread */
+#define ZG_MIN_PARALLEL  65536
+
+
+/* ------------------------------------------------------------------
+ *  Function prototypes
+ */
+
+/*
+ * returns the number of vertices on an arc with radius r and
+ * angle a for a polygon error pe, and the correction factor for
+ * the radius in cfac. Returns 0 when the arguments are invalid.
+ *
+ * r :     radius
+ * pe :    polygon error
+ * a :     arc angle in radians
+ * pap :   ZG_EQUAL_AREA or ZG_EQUAL_LENGTH
+ * cfac :  radius correction factor
+ */
+size_t zg_arc(double r, double pe, double a, int pap, double *cfac);
+
+/*
+ * returns the number of segments of a zone with outer radius ro.
+ * Zones are divided into segments with at most about maxv vertices,
+ * and into at least ZG_MIN_SEG segments. Returns 0 when the
+ * arguments are invalid.
+ */
+int zg_segments(double ro, double pe, int pap, size_t maxv);
+
+/*
+ * computes the number of segments and the segment polygons of
+ * zones. The vertices of each zone are allocated with malloc and
+ * must be released with zg_zones_free. nthreads < 1 uses one thread
+ * per processor. Returns 0 on success, 1 when the zone radii or the
+ * polygon error are invalid, and -1 when memory cannot be allocated.
+ *
+ * pz :      zones with ri and ro
+ * nz :      number of zones
+ * pe :      polygon error
+ * pap :     ZG_EQUAL_AREA or ZG_EQUAL_LENGTH
+ * maxv :    maximum number of vertices of a segment (see
+ *           zg_segments)
+ * nthreads: number of threads
+ */
+int zg_zones(zg_zone_t *pz, size_t nz, double pe, int pap, size_t maxv,
+             int nthreads);
+
+/*
+ * releases the vertices of zones
+ */
+void zg_zones_free(zg_zone_t *pz, size_t nz);
+
+#endif /* _ZONEGEN_H */
@@ -0,0 +1,84 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Computes the segment polygons of the zones of a zone plate (see
+ * zonegen.h). The zones are computed in parallel.
+ *
+ * [xy, nseg] = zonelensmex(ri, ro, pe, papprox);
+ *
+ * Input
+ * ri :      vector with inner zone radii; 0 for the center
+ * ro :      vector with outer zone radii
+ * pe :      polygon error
+ * papprox : polygon approximation, 1 = equal area, 2 = equal length
+ *
+ * Output
+ * xy :      cell array with the closed polygon (nv x 2 matrix) of
+ *           the first segment of each zone
+ * nseg :    vector with the number of segments of each zone
+ */
+
+#include <string.h>
+#include "mex.h"
+
+#include "zonegen.h"
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   zg_zone_t *pz;
+   mxArray *pa;
+   const double *ri, *ro;
+   double *pd, pe;
+   size_t nz, k;
+   int pap, err;
+
+   /* check arguments */
+   if (nrhs != 4)
+      mexErrMsgTxt("zonelensmex :  4 input arguments expected.");
+   if ( !mxIsDouble(prhs[0]) || !mxIsDouble(prhs[1]) )
+      mexErrMsgTxt("zonelensmex :  zone radii must be double vectors.");
+   nz = mxGetNumberOfElements(prhs[0]);
+   if (mxGetNumberOfElements(prhs[1]) != nz)
+      mexErrMsgTxt("zonelensmex :  inner and outer radii must have the same length.");
+   ri = mxGetPr(prhs[0]);
+   ro = mxGetPr(prhs[1]);
+   pe = mxGetScalar(prhs[2]);
+   pap = (int)mxGetScalar(prhs[3]);
+   if (pap != ZG_EQUAL_AREA && pap != ZG_EQUAL_LENGTH)
+      mexErrMsgTxt("zonelensmex :  unknown circle approximation method.");
+
+   /* compute the zones */
+   pz = mxMalloc((nz + 1) * sizeof(zg_zone_t));
+   for (k=0; k<nz; k++) {
+      pz[k].ri = ri[k];
+      pz[k].ro = ro[k];
+   }
+   err = zg_zones(pz, nz, pe, pap, ZG_MAX_VERT, 0);
+   if (err > 0)
+      mexErrMsgTxt("zonelensmex :  invalid zone radii or polygon error.");
+   else if (err < 0)
+      mexErrMsgTxt("zonelensmex :  failed to allocate memory.");
+
+   /* return the segments */
+   plhs[0] = mxCreateCellMatrix(nz, 1);
+   plhs[1] = mxCreateDoubleMatrix(1, nz, mxREAL);
+   pd = mxGetPr(plhs[1]);
+   for (k=0; k<nz; k++) {
+      pa = mxCreateDoubleMatrix(pz[k].nv, 2, mxREAL);
+      memcpy(mxGetPr(pa), pz[k].xy, 2 * pz[k].nv * sizeof(double));
+      mxSetCell(plhs[0], k, pa);
+      pd[k] = pz[k].nseg;
+   }
+
+   zg_zones_free(pz, nz);
+   mxFree(pz);
+}
+
+/*-----------------------------------------------------------------*/
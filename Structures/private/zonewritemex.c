@@ -0,0 +1,252 @@
+/*
+ * Part of the GDSII toolbox for Octave & MATLAB
+ * Copyright (c) 2026
+ *
+ * Description:
+ * Writes the structures of a zone plate to a GDSII library file.
+ * The segment polygons are computed in parallel (see zonegen.h)
+ * and encoded with the functions in elwrite.h; no MATLAB data are
+ * created for the elements. The zones are processed in blocks to
+ * limit the memory needed for very large zone plates.
+ *
+ * The structures are the same as those created by gdsii_zonelens
+ * without an aperture: a structure ZBND_id_k with the segment
+ * boundary and a structure ZONE_id_k with nseg rotated references
+ * to it for each zone k, and a top level structure with references
+ * to all zone structures.
+ *
+ * zonewritemex(gf, sname, ri, ro, pos, pe, papprox, maxv, layer, id, uu_to_dbu);
+ *
+ * Input
+ * gf :        a file handle returned by gds_open
+ * sname :     name of the top level structure
+ * ri :        vector with inner zone radii; 0 for the center
+ * ro :        vector with outer zone radii
+ * pos :       position of the zone plate center
+ * pe :        polygon error
+ * papprox :   polygon approximation, 1 = equal area, 2 = equal length
+ * maxv :      maximum number of vertices of a segment
+ * layer :     layer of the segment boundaries
+ * id :        zone plate id used in the structure names
+ * uu_to_dbu : conversion factor user units --> database units
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mex.h"
+
+#include "gdsio.h"
+#include "gdstypes.h"
+#include "mexfuncs.h"
+#include "elwrite.h"
+#include "gdsstats.h"
+#include "zonegen.h"
+
+#define BLOCK   256    /* zones computed at a time */
+#define NAMELEN 64
+
+
+/*-- Local Functions ----------------------------------------------*/
+
+static int write_structure(FILE *fob, const char *sname, ew_buffer_t *wb);
+
+
+/*-----------------------------------------------------------------*/
+
+void
+mexFunction(int nlhs, mxArray *plhs[],
+            int nrhs, const mxArray *prhs[])
+{
+   FILE *fob;
+   zg_zone_t *pz;
+   ew_buffer_t wb;
+   ew_list_t ls;
+   ew_element_t *pe;
+   ew_xy_t org;
+   char *sname;
+   char bname[NAMELEN], zname[NAMELEN];
+   const double *ri, *ro, *pos;
+   double pel, uu_to_dbu, origin[2] = {0.0, 0.0};
+   size_t nz, maxv, k, first, nb, nel;
+   int pap, layer, id, err, j;
+   const char *msg = NULL;
+
+   /* check arguments */
+   if (nrhs != 11)
+      mexErrMsgTxt("zonewritemex :  11 input arguments expected.");
+
+   fob = get_file_ptr((mxArray *)prhs[0]);
+   sname = mxArrayToString(prhs[1]);
+   if (sname == NULL)
+      mexErrMsgTxt("zonewritemex :  structure name must be a string.");
+   if ( !mxIsDouble(prhs[2]) || !mxIsDouble(prhs[3]) )
+      mexErrMsgTxt("zonewritemex :  zone radii must be double vectors.");
+   nz = mxGetNumberOfElements(prhs[2]);
+   if (mxGetNumberOfElements(prhs[3]) != nz)
+      mexErrMsgTxt("zonewritemex :  inner and outer radii must have the same length.");
+   ri = mxGetPr(prhs[2]);
+   ro = mxGetPr(prhs[3]);
+   if ( !mxIsDouble(prhs[4]) || mxGetNumberOfElements(prhs[4]) != 2 )
+      mexErrMsgTxt("zonewritemex :  position must be a 1x2 vector.");
+   pos = mxGetPr(prhs[4]);
+   pel = mxGetScalar(prhs[5]);
+   pap = (int)mxGetScalar(prhs[6]);
+   if (pap != ZG_EQUAL_AREA && pap != ZG_EQUAL_LENGTH)
+      mexErrMsgTxt("zonewritemex :  unknown circle approximation method.");
+   if (mxGetScalar(prhs[7]) < 4.0)
+      mexErrMsgTxt("zonewritemex :  segments must have at least 4 vertices.");
+   maxv = (size_t)mxGetScalar(prhs[7]);
+   layer = (int)mxGetScalar(prhs[8]);
+   if (layer < 0 || layer > 65535)
+      mexErrMsgTxt("zonewritemex :  invalid layer number.");
+   id = (int)mxGetScalar(prhs[9]);
+   uu_to_dbu = mxGetScalar(prhs[10]);
+
+   memset(&wb, 0, sizeof(ew_buffer_t));
+   memset(&ls, 0, sizeof(ew_list_t));
+   pz = mxMalloc(BLOCK * sizeof(zg_zone_t));
+   ls.xy = mxMalloc(sizeof(ew_xy_t));
+   ls.axy = 1;
+   ls.nxy = 1;
+
+   /* zone structures */
+   for (first=0; first<nz && !msg; first+=BLOCK) {
+
+      nb = nz - first < BLOCK ? nz - first : BLOCK;
+      for (k=0; k<nb; k++) {
+	 pz[k].ri = ri[first+k];
+	 pz[k].ro = ro[first+k];
+      }
+      err = zg_zones(pz, nb, pel, pap, maxv, 0);
+      if (err) {
+	 msg = err > 0 ? "invalid zone radii or polygon error." :
+	                 "failed to allocate memory.";
+	 break;
+      }
+
+      for (k=0; k<nb; k++) {
+
+	 snprintf(bname, NAMELEN, "ZBND_%d_%lu", id, (unsigned long)(first+k+1));
+	 snprintf(zname, NAMELEN, "ZONE_%d_%lu", id, (unsigned long)(first+k+1));
+
+	 /* references to the rotated segments */
+	 nel = pz[k].nseg;
+	 if (nel > ls.ael) {
+	    ls.el = mxRealloc(ls.el, nel * sizeof(ew_element_t));
+	    ls.ael = nel;
+	 }
+	 ls.nel = nel;
+	 ls.str = bname;
+	 ls.xy[0].xy = pos;
+	 ls.xy[0].m = 1;
+	 for (j=0; j<pz[k].nseg; j++) {
+	    pe = &ls.el[j];
+	    memset(pe, 0, sizeof(ew_element_t));
+	    pe->el.kind = GDS_SREF;
+	    pe->el.has = HAS_STRANS | HAS_ANGLE;
+	    pe->el.strans.mag = 1.0;
+	    pe->el.strans.angle = j * 360.0 / pz[k].nseg;
+	    pe->nxy = 1;
+	 }
+	 ew_buffer_clear(&wb);
+	 if ( encode_elements(&wb, &ls, uu_to_dbu, 0) ) {
+	    msg = "failed to allocate memory.";
+	    break;
+	 }
+	 if ( write_structure(fob, zname, &wb) ) {
+	    msg = "failed to write structure.";
+	    break;
+	 }
+
+	 /* segment boundary */
+	 pe = &ls.el[0];
+	 memset(pe, 0, sizeof(ew_element_t));
+	 pe->el.kind = GDS_BOUNDARY;
+	 pe->el.layer = (uint16_t)layer;
+	 pe->nxy = 1;
+	 ls.nel = 1;
+	 ls.xy[0].xy = pz[k].xy;
+	 ls.xy[0].m = pz[k].nv;
+	 ew_buffer_clear(&wb);
+	 if ( encode_elements(&wb, &ls, uu_to_dbu, 0) ) {
+	    msg = "failed to allocate memory.";
+	    break;
+	 }
+	 if ( write_structure(fob, bname, &wb) ) {
+	    msg = "failed to write structure.";
+	    break;
+	 }
+      }
+
+      zg_zones_free(pz, nb);
+   }
+
+   /* top level structure with references to the zones */
+   if (!msg) {
+      ew_buffer_clear(&wb);
+      org.xy = origin;
+      org.m = 1;
+      ls.el = mxRealloc(ls.el, sizeof(ew_element_t));
+      ls.nel = 1;
+      ls.xy[0] = org;
+      pe = &ls.el[0];
+      memset(pe, 0, sizeof(ew_element_t));
+      pe->el.kind = GDS_SREF;
+      pe->nxy = 1;
+      for (k=0; k<nz && !msg; k++) {
+	 snprintf(zname, NAMELEN, "ZONE_%d_%lu", id, (unsigned long)(k+1));
+	 ls.str = zname;
+	 if ( encode_elements(&wb, &ls, uu_to_dbu, 0) )
+	    msg = "failed to allocate memory.";
+      }
+      if ( !msg && write_structure(fob, sname, &wb) )
+	 msg = "failed to write structure.";
+   }
+
+   ew_buffer_free(&wb);
+   mxFree(ls.el);
+   mxFree(ls.xy);
+   mxFree(pz);
+   mxFree(sname);
+
+   if (msg) {
+      snprintf(zname, NAMELEN, "zonewritemex :  %s", msg);
+      mexErrMsgTxt(zname);
+   }
+
+   STATS_FLUSH();
+}
+
+
+/*-----------------------------------------------------------------*/
+
+/*
+ * writes a structure with the encoded elements in a buffer
+ */
+static int
+write_structure(FILE *fob, const char *sname, ew_buffer_t *wb)
+{
+   date_t cdate, mdate;
+   int len = strlen(sname);
+
+   if ( write_record_hdr(fob, BGNSTR, 2*sizeof(date_t)) )
+      return 1;
+   now(cdate);
+   if ( write_word_n(fob, cdate, 6) )
+      return 1;
+   now(mdate);
+   if ( write_word_n(fob, mdate, 6) )
+      return 1;
+   if ( write_record_hdr(fob, STRNAME, len) )
+      return 1;
+   if ( write_string(fob, (char *)sname, len) )
+      return 1;
+   if ( fwrite(wb->base, 1, wb->size, fob) != wb->size )
+      return 1;
+   if ( write_record_hdr(fob, ENDSTR, 0) )
+      return 1;
+
+   return 0;
+}
+
+/*-----------------------------------------------------------------*/
@@ -0,0 +1,22 @@
+#version 300 es
+precision highp float;
+
+// Vertex attributes (cell coordinates)
+in vec2 a_position;
+
+// Instance attributes: columns of the cell-to-world transform
+in vec2 a_instanceX;            // (m11, m21)
+in vec2 a_instanceY;            // (m12, m22)
+in vec2 a_instanceOffset;       // (m13, m23)
+
+// Uniforms
+uniform mat3 u_viewMatrix;      // View transformation (camera)
+
+void main() {
+  // Place the cell, then apply view transformation
+  vec2 worldPos = a_instanceX * a_position.x + a_instanceY * a_position.y + a_instanceOffset;
+  vec3 viewPos = u_viewMatrix * vec3(worldPos, 1.0);
+
+  // Output position (Z is always 0 for 2D)
+  gl_Position = vec4(viewPos.xy, 0.0, 1.0);
+}
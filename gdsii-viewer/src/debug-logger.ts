@@ -436,4 +436,4 @@ export class DebugLogger {
 export const logger = new DebugLogger();
 
 // Make it available globally for debugging
-(window as any).debugLogger = logger;
+(globalThis as any).debugLogger = logger;
@@ -104,6 +104,7 @@ export interface GDSPathElement extends GDSElementBase {
   beginExtension?: number;      // Extension at path beginning (type 4)
   endExtension?: number;        // Extension at path end (type 4)
   paths: GDSPoint[][];          // Multiple path segments
+  outlines?: GDSPoint[][];      // Closed polygons of the path segments
 }
 
 // Box element (rectangle)
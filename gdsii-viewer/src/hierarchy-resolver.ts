@@ -24,6 +24,7 @@ import {
 } from './gdsii-types';
 
 import {
+  createIdentityMatrix,
   stransToMatrix,
   multiplyMatrices,
   transformPoint,
@@ -41,6 +42,7 @@ interface HierarchyCache {
   resolvedStructures: Map<string, GDSElement[]>;
   flattenedStructures: Map<string, GDSElement[]>;
   structureBBoxes: Map<string, GDSBBox>;
+  structureLayers: Map<string, Set<string>>;
   transformMatrices: Map<string, GDSTransformMatrix>;
 }
 
@@ -52,6 +54,7 @@ export function createHierarchyCache(): HierarchyCache {
     resolvedStructures: new Map(),
     flattenedStructures: new Map(),
     structureBBoxes: new Map(),
+    structureLayers: new Map(),
     transformMatrices: new Map()
   };
 }
@@ -307,6 +310,7 @@ export function transformElement(
       transformedElement = {
         ...pathEl,
         paths: transformPolygons(pathEl.paths, transform),
+        outlines: pathEl.outlines && transformPolygons(pathEl.outlines, transform),
         bounds: undefined // Will be recalculated below
       };
       break;
@@ -445,37 +449,175 @@ export function flattenLibrary(
   return flattenedStructures;
 }
 
+/**
+ * Collects the placements of every structure below the top structures
+ * (those no other structure references) for instanced drawing. Each
+ * placement is [m11, m21, m12, m22, m13, m23] of the structure-to-top
+ * transform; top structures have the identity. AREF lattices are
+ * expanded, element geometry is not copied. References on cycles and
+ * below maxDepth are skipped.
+ */
+export function collectPlacements(
+  library: GDSLibrary,
+  maxDepth: number = 100
+): Map<GDSStructure, number[]> {
+  const byName = new Map<string, GDSStructure>();
+  const referenced = new Set<string>();
+  for (const structure of library.structures) {
+    byName.set(structure.name, structure);
+    for (const element of structure.elements) {
+      if (element.type === 'sref' || element.type === 'aref') {
+        referenced.add(element.referenceName);
+      }
+    }
+  }
+
+  const placements = new Map<GDSStructure, number[]>();
+  const active = new Set<GDSStructure>();
+
+  const place = (structure: GDSStructure, m: GDSTransformMatrix, depth: number): void => {
+    let list = placements.get(structure);
+    if (!list) {
+      list = [];
+      placements.set(structure, list);
+    }
+    list.push(m.m11, m.m21, m.m12, m.m22, m.m13, m.m23);
+    if (depth >= maxDepth) return;
+
+    active.add(structure);
+    for (const element of structure.elements) {
+      if (element.type !== 'sref' && element.type !== 'aref') continue;
+      const child = byName.get(element.referenceName);
+      if (!child || active.has(child)) continue;
+
+      if (element.type === 'sref') {
+        for (const position of element.positions) {
+          place(child, multiplyMatrices(m, createSRefTransformMatrix(element, position)), depth + 1);
+        }
+      } else {
+        for (const transform of createARefTransformMatrices(element)) {
+          place(child, multiplyMatrices(m, transform), depth + 1);
+        }
+      }
+    }
+    active.delete(structure);
+  };
+
+  const identity = createIdentityMatrix();
+  for (const structure of library.structures) {
+    if (!referenced.has(structure.name)) {
+      place(structure, identity, 0);
+    }
+  }
+
+  return placements;
+}
+
 // ============================================================================
 // BOUNDING BOX CALCULATION
 // ============================================================================
 
+const EMPTY_BBOX: GDSBBox = { minX: Infinity, minY: Infinity, maxX: -Infinity, maxY: -Infinity };
+
 /**
- * Calculates the bounding box for a structure including all references
+ * Transforms a bounding box and returns the bounding box of the result
  */
-export function calculateStructureBBox(
+function transformBBox(bbox: GDSBBox, matrix: GDSTransformMatrix): GDSBBox {
+  const corners = transformPoints([
+    { x: bbox.minX, y: bbox.minY },
+    { x: bbox.maxX, y: bbox.minY },
+    { x: bbox.maxX, y: bbox.maxY },
+    { x: bbox.minX, y: bbox.maxY }
+  ], matrix);
+
+  return {
+    minX: Math.min(...corners.map(p => p.x)),
+    minY: Math.min(...corners.map(p => p.y)),
+    maxX: Math.max(...corners.map(p => p.x)),
+    maxY: Math.max(...corners.map(p => p.y))
+  };
+}
+
+/**
+ * Returns the transformations of the instances of a reference that
+ * determine its bounding box: all positions of an SREF and the four
+ * corner instances of an AREF
+ */
+function referenceExtremeTransforms(element: GDSSRefElement | GDSARefElement): GDSTransformMatrix[] {
+  if (element.type === 'sref') {
+    return element.positions.map(position => createSRefTransformMatrix(element, position));
+  }
+
+  const transform = element.transformation || {
+    reflection: false,
+    absoluteMagnification: false,
+    absoluteAngle: false,
+    magnification: 1.0,
+    angle: 0.0
+  };
+  const [origin, colPoint, rowPoint] = element.corners;
+  const lastCol = (element.columns - 1) / element.columns;
+  const lastRow = (element.rows - 1) / element.rows;
+  const colEnd = { x: (colPoint.x - origin.x) * lastCol, y: (colPoint.y - origin.y) * lastCol };
+  const rowEnd = { x: (rowPoint.x - origin.x) * lastRow, y: (rowPoint.y - origin.y) * lastRow };
+
+  return [
+    origin,
+    { x: origin.x + colEnd.x, y: origin.y + colEnd.y },
+    { x: origin.x + rowEnd.x, y: origin.y + rowEnd.y },
+    { x: origin.x + colEnd.x + rowEnd.x, y: origin.y + colEnd.y + rowEnd.y }
+  ].map(position => stransToMatrix(transform, position));
+}
+
+/**
+ * Computes the hierarchical bounding box and layer set of a structure
+ * bottom-up: the summaries of referenced structures are computed once
+ * and cached, and are combined with the local elements of the structure.
+ * The bounding box is empty (Infinity) for structures without elements.
+ */
+function summarizeStructure(
   library: GDSLibrary,
   structure: GDSStructure,
-  cache: HierarchyCache
+  cache: HierarchyCache,
+  active: Set<string> = new Set()
 ): GDSBBox {
-  if (cache.structureBBoxes.has(structure.name)) {
-    return cache.structureBBoxes.get(structure.name)!;
+  const cached = cache.structureBBoxes.get(structure.name);
+  if (cached) {
+    return cached;
   }
 
-  const identityMatrix: GDSTransformMatrix = {
-    m11: 1, m12: 0, m13: 0,
-    m21: 0, m22: 1, m23: 0,
-    m31: 0, m32: 0, m33: 1
-  };
+  if (active.has(structure.name)) {
+    console.warn(`Circular reference detected at structure ${structure.name}`);
+    return EMPTY_BBOX;
+  }
+  active.add(structure.name);
 
-  const resolvedElements = resolveStructure(library, structure, identityMatrix, cache);
-  let bbox = { minX: Infinity, minY: Infinity, maxX: -Infinity, maxY: -Infinity };
-  let validBBoxCount = 0;
+  let bbox = EMPTY_BBOX;
+  const layers = new Set<string>();
+
+  for (const element of structure.elements) {
+    if (element.type === 'sref' || element.type === 'aref') {
+      const child = findStructureByName(library, element.referenceName);
+      if (!child) {
+        continue;
+      }
+
+      const childBBox = summarizeStructure(library, child, cache, active);
+      cache.structureLayers.get(child.name)?.forEach(key => layers.add(key));
+      if (childBBox.minX === Infinity) {
+        continue;
+      }
+
+      for (const matrix of referenceExtremeTransforms(element)) {
+        bbox = mergeBBoxes(bbox, transformBBox(childBBox, matrix));
+      }
+      continue;
+    }
+
+    layers.add(`${element.layer}_${element.dataType}`);
 
-  for (const element of resolvedElements) {
     // Try to use pre-calculated bounds first
     let elementBBox = element.bounds;
-    
-    // If bounds don't exist or are invalid, calculate them
     if (!elementBBox || elementBBox.minX === Infinity || elementBBox.maxX === -Infinity) {
       try {
         elementBBox = calculateElementBBox(element);
@@ -485,23 +627,75 @@ export function calculateStructureBBox(
       }
     }
 
-    // Only merge valid bounding boxes
     if (elementBBox.minX !== Infinity && elementBBox.maxX !== -Infinity) {
       bbox = mergeBBoxes(bbox, elementBBox);
-      validBBoxCount++;
     }
   }
 
+  active.delete(structure.name);
+  cache.structureBBoxes.set(structure.name, bbox);
+  cache.structureLayers.set(structure.name, layers);
+  return bbox;
+}
+
+/**
+ * Calculates the bounding box for a structure including all references
+ */
+export function calculateStructureBBox(
+  library: GDSLibrary,
+  structure: GDSStructure,
+  cache: HierarchyCache
+): GDSBBox {
+  const bbox = summarizeStructure(library, structure, cache);
+
   // If no valid bboxes were found, return empty bbox instead of Infinity values
-  if (validBBoxCount === 0) {
+  if (bbox.minX === Infinity) {
     console.warn(`No valid bounding boxes found for structure ${structure.name}`);
-    bbox = { minX: 0, minY: 0, maxX: 0, maxY: 0 };
+    return { minX: 0, minY: 0, maxX: 0, maxY: 0 };
   }
 
-  cache.structureBBoxes.set(structure.name, bbox);
   return bbox;
 }
 
+/**
+ * Returns the layer keys (layer_dataType) used anywhere in the
+ * hierarchy of a structure
+ */
+export function getStructureLayers(
+  library: GDSLibrary,
+  structure: GDSStructure,
+  cache: HierarchyCache
+): Set<string> {
+  summarizeStructure(library, structure, cache);
+  return cache.structureLayers.get(structure.name)!;
+}
+
+/**
+ * Removes the cached summaries of a modified structure and of all
+ * structures that reference it, directly or indirectly
+ */
+export function invalidateStructure(
+  library: GDSLibrary,
+  structureName: string,
+  cache: HierarchyCache
+): void {
+  const pending = [structureName];
+
+  while (pending.length > 0) {
+    const name = pending.pop()!;
+    if (!cache.structureBBoxes.delete(name)) {
+      continue;
+    }
+    cache.structureLayers.delete(name);
+    cache.resolvedStructures.delete(name);
+    cache.flattenedStructures.delete(name);
+
+    for (const parent of getParentStructures(library, name)) {
+      pending.push(parent.name);
+    }
+  }
+}
+
 /**
  * Calculates the bounding box for the entire library
  */
@@ -511,7 +705,7 @@ export function calculateLibraryBBox(library: GDSLibrary): GDSBBox {
   let validStructureCount = 0;
 
   for (const structure of library.structures) {
-    const structureBBox = calculateStructureBBox(library, structure, cache);
+    const structureBBox = summarizeStructure(library, structure, cache);
     
     // Only merge valid bounding boxes (not empty or Infinity)
     if (structureBBox.minX !== Infinity && structureBBox.maxX !== -Infinity) {
@@ -587,45 +781,184 @@ export function extractLayersFromLibrary(
 // ============================================================================
 
 /**
- * Detects circular references in the structure hierarchy
+ * Reference graph of a library in compressed row (CSR) format: the
+ * children of structure k are children[rowPtr[k]] ... children[rowPtr[k+1]-1],
+ * and counts holds the number of instances placed by each edge
+ * (AREFs place columns x rows instances). Structure names are interned
+ * in a map, so building the graph is linear in the number of elements.
+ */
+export interface ReferenceGraph {
+  names: string[];
+  index: Map<string, number>;
+  rowPtr: Uint32Array;
+  children: Uint32Array;
+  counts: Float64Array;
+}
+
+/**
+ * Builds the reference graph of a library
+ */
+export function buildReferenceGraph(library: GDSLibrary): ReferenceGraph {
+  const names = library.structures.map(structure => structure.name);
+  const index = new Map<string, number>();
+  names.forEach((name, k) => {
+    if (!index.has(name)) {
+      index.set(name, k);
+    }
+  });
+
+  const rowPtr = new Uint32Array(names.length + 1);
+  const children: number[] = [];
+  const counts: number[] = [];
+  const slot = new Map<number, number>();
+
+  library.structures.forEach((structure, k) => {
+    slot.clear();
+    for (const element of structure.elements) {
+      if (element.type !== 'sref' && element.type !== 'aref') {
+        continue;
+      }
+      const child = index.get(element.referenceName);
+      if (child === undefined) {
+        continue;
+      }
+      const instances = element.type === 'sref'
+        ? element.positions.length
+        : element.columns * element.rows;
+
+      const edge = slot.get(child);
+      if (edge === undefined) {
+        slot.set(child, children.length);
+        children.push(child);
+        counts.push(instances);
+      } else {
+        counts[edge] += instances;
+      }
+    }
+    rowPtr[k + 1] = children.length;
+  });
+
+  return {
+    names,
+    index,
+    rowPtr,
+    children: Uint32Array.from(children),
+    counts: Float64Array.from(counts)
+  };
+}
+
+/**
+ * Detects circular references in the structure hierarchy. Returns one
+ * cycle (a list of structure names that starts and ends with the same
+ * name) for every strongly connected component of the reference graph
+ * that contains a cycle. Runs in linear time (iterative Tarjan).
  */
 export function detectCircularReferences(library: GDSLibrary): string[][] {
+  const graph = buildReferenceGraph(library);
+  const { rowPtr, children, names } = graph;
+  const n = names.length;
   const cycles: string[][] = [];
-  const visited = new Set<string>();
-  const recursionStack = new Set<string>();
-
-  function dfs(structureName: string, path: string[]): void {
-    if (recursionStack.has(structureName)) {
-      // Found a cycle
-      const cycleStart = path.indexOf(structureName);
-      cycles.push([...path.slice(cycleStart), structureName]);
-      return;
-    }
 
-    if (visited.has(structureName)) {
-      return;
+  const order = new Int32Array(n);     // discovery index + 1, 0 = unvisited
+  const low = new Int32Array(n);
+  const onStack = new Uint8Array(n);
+  const component = new Int32Array(n).fill(-1);
+  const stack: number[] = [];
+  const callStack: number[] = [];
+  const edgeStack: number[] = [];
+  let next = 1;
+
+  for (let root = 0; root < n; root++) {
+    if (order[root]) {
+      continue;
     }
 
-    visited.add(structureName);
-    recursionStack.add(structureName);
+    callStack.push(root);
+    edgeStack.push(rowPtr[root]);
+    order[root] = low[root] = next++;
+    stack.push(root);
+    onStack[root] = 1;
+
+    while (callStack.length > 0) {
+      const top = callStack.length - 1;
+      const v = callStack[top];
+
+      if (edgeStack[top] < rowPtr[v + 1]) {
+        const w = children[edgeStack[top]++];
+        if (!order[w]) {
+          callStack.push(w);
+          edgeStack.push(rowPtr[w]);
+          order[w] = low[w] = next++;
+          stack.push(w);
+          onStack[w] = 1;
+        } else if (onStack[w]) {
+          low[v] = Math.min(low[v], order[w]);
+        }
+        continue;
+      }
 
-    const structure = findStructureByName(library, structureName);
-    if (structure) {
-      const children = getChildStructures(library, structure);
+      callStack.pop();
+      edgeStack.pop();
+      if (callStack.length > 0) {
+        const parent = callStack[callStack.length - 1];
+        low[parent] = Math.min(low[parent], low[v]);
+      }
 
-      for (const child of children) {
-        dfs(child.name, [...path, structureName]);
+      if (low[v] === order[v]) {
+        let w: number;
+        do {
+          w = stack.pop()!;
+          onStack[w] = 0;
+          component[w] = v;
+        } while (w !== v);
+
+        const cycle = findCycleInComponent(graph, component, v);
+        if (cycle) {
+          cycles.push(cycle.map(k => names[k]));
+        }
       }
     }
-
-    recursionStack.delete(structureName);
   }
 
-  for (const structure of library.structures) {
-    if (!visited.has(structure.name)) {
-      dfs(structure.name, []);
+  return cycles;
+}
+
+/**
+ * Returns a cycle through structure start within its strongly
+ * connected component (breadth first search back to start), or
+ * null if the component has no cycle
+ */
+function findCycleInComponent(
+  graph: ReferenceGraph,
+  component: Int32Array,
+  start: number
+): number[] | null {
+  const { rowPtr, children } = graph;
+  const previous = new Map<number, number>();
+  const queue = [start];
+
+  for (let head = 0; head < queue.length; head++) {
+    const v = queue[head];
+    for (let e = rowPtr[v]; e < rowPtr[v + 1]; e++) {
+      const w = children[e];
+      if (component[w] !== start) {
+        continue;
+      }
+      if (w === start) {
+        const path = [start];
+        for (let u = v; u !== start; u = previous.get(u)!) {
+          path.push(u);
+        }
+        path.push(start);
+        path.reverse();
+        return path;
+      }
+      if (!previous.has(w)) {
+        previous.set(w, v);
+        queue.push(w);
+      }
     }
   }
 
-  return cycles;
-}
\ No newline at end of file
+  return null;
+}
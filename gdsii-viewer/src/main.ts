@@ -20,7 +20,8 @@ import {
   loadWASMModule,
   validateWASMModule,
   loadConfig,
-  autoLoadGDSFile
+  autoLoadGDSFile,
+  loadGDSFileFromSource
 } from './wasm-interface';
 
 import {
@@ -36,6 +37,7 @@ import {
 } from './renderer';
 
 import type { Viewport } from './scene';
+import { SceneWorkerClient, type SceneSummary } from './worker';
 import { logger, LogCategory } from './debug-logger';
 
 class GDSViewer {
@@ -57,6 +59,16 @@ class GDSViewer {
   private libraryBBox: GDSBBox | null = null;
   private renderOptions: GDSRenderOptions = { ...DEFAULT_RENDER_OPTIONS };
 
+  // Off-main-thread pipeline: the worker parses, builds the scene and
+  // renders into the canvas; the page keeps only a summary
+  private sceneWorker: SceneWorkerClient | null = null;
+  private sceneSummary: SceneSummary | null = null;
+  private workerBackend: string = '';
+
+  // Canvas size in device pixels; the canvas of the worker cannot be resized here
+  private pixelWidth: number = 0;
+  private pixelHeight: number = 0;
+
   // Viewport state (used by new renderer)
   private viewport: Viewport = {
     center: { x: 0, y: 0 },
@@ -93,10 +105,50 @@ class GDSViewer {
     logger.initializeUI();
     logger.info(LogCategory.SYSTEM, 'Application starting...');
     
-    this.initializeRenderer();
-    this.initializeWASM();
     this.setupEventListeners();
     this.resizeCanvas();
+    if (SceneWorkerClient.isSupported()) {
+      this.initializeSceneWorker();
+    } else {
+      this.initializeRenderer();
+      this.initializeWASM();
+    }
+  }
+
+  /**
+   * Initialize the scene worker, which loads the WASM module itself
+   */
+  private async initializeSceneWorker(): Promise<void> {
+    try {
+      console.log('🎨 Starting scene worker...');
+      this.sceneWorker = new SceneWorkerClient();
+      this.sceneWorker.onFrame = (stats) => this.updateStatistics(stats);
+      this.workerBackend = await this.sceneWorker.attachCanvas(this.canvas, 'auto');
+      this.sceneWorker.resize(this.pixelWidth, this.pixelHeight);
+      console.log(`✓ Scene worker rendering with ${this.workerBackend.toUpperCase()} backend`);
+      this.updateBackendInfo();
+
+      await this.initializeAutoLoad();
+    } catch (error) {
+      console.error('Failed to start scene worker:', error);
+      this.showMessage(`Failed to start scene worker: ${error instanceof Error ? error.message : 'Unknown error'}`);
+    }
+  }
+
+  /**
+   * Parses a file and builds its scene in the scene worker
+   */
+  private async loadInWorker(data: Uint8Array, fileName: string): Promise<void> {
+    if (!this.sceneWorker) return;
+
+    this.sceneSummary = await this.sceneWorker.load(data, (parsed, total) =>
+      this.showMessage(`Parsing ${fileName}: ${parsed} / ${total} structures`));
+    this.libraryBBox = this.sceneSummary.bounds;
+
+    console.log(`✓ Processed ${this.sceneSummary.structureCount} structures in the scene worker`);
+    this.updateFileInfo(fileName);
+    this.updateLayerList();
+    this.resetView();
   }
 
   /**
@@ -158,6 +210,19 @@ class GDSViewer {
       const config = await loadConfig();
       console.log('✓ Configuration loaded:', config);
 
+      if (this.sceneWorker) {
+        const source = config.autoLoad?.enabled
+          ? config.autoLoad.url || config.autoLoad.filePath
+          : undefined;
+        if (source) {
+          await this.loadInWorker(await loadGDSFileFromSource(source), 'auto-loaded.gds');
+          console.log('✓ Auto-loaded GDSII file processed and rendered');
+        } else {
+          console.log('ℹ️ Auto-load disabled - showing placeholder');
+        }
+        return;
+      }
+
       // Attempt auto-load if enabled
       const library = await autoLoadGDSFile(config);
 
@@ -189,16 +254,20 @@ class GDSViewer {
     this.zoomOutButton.addEventListener('click', () => this.zoom(0.8));
     this.resetViewButton.addEventListener('click', () => this.resetView());
 
-    this.canvas.addEventListener('mousedown', (e) => this.handleMouseDown(e));
-    this.canvas.addEventListener('mousemove', (e) => this.handleMouseMove(e));
-    this.canvas.addEventListener('mouseup', () => this.handleMouseUp());
-    this.canvas.addEventListener('wheel', (e) => this.handleWheel(e));
+    this.bindCanvasEvents();
 
     this.backendSelector.addEventListener('change', () => this.switchBackend());
 
     window.addEventListener('resize', () => this.resizeCanvas());
   }
 
+  private bindCanvasEvents() {
+    this.canvas.addEventListener('mousedown', (e) => this.handleMouseDown(e));
+    this.canvas.addEventListener('mousemove', (e) => this.handleMouseMove(e));
+    this.canvas.addEventListener('mouseup', () => this.handleMouseUp());
+    this.canvas.addEventListener('wheel', (e) => this.handleWheel(e));
+  }
+
   private async loadFile() {
     this.fileInput.click();
   }
@@ -221,9 +290,17 @@ class GDSViewer {
       const arrayBuffer = await file.arrayBuffer();
       const data = new Uint8Array(arrayBuffer);
 
+      if (this.sceneWorker) {
+        await this.loadInWorker(data, file.name);
+        return;
+      }
+
       // Parse the GDSII file using WASM or fallback
       if (this.wasmLoaded && validateWASMModule()) {
-        this.currentLibrary = await parseGDSII(data);
+        this.currentLibrary = await parseGDSII(data, {
+          onProgress: (parsed, total) =>
+            this.showMessage(`Parsing ${file.name}: ${parsed} / ${total} structures`)
+        });
       } else {
         // Fallback to placeholder data if WASM is not available
         this.currentLibrary = await this.parseGDSIIPlaceholder(data);
@@ -345,11 +422,17 @@ class GDSViewer {
    * Render the current scene using the new renderer
    */
   private render(): void {
-    if (!this.renderer) return;
-
     // Update viewport dimensions
-    this.viewport.width = this.canvas.width;
-    this.viewport.height = this.canvas.height;
+    this.viewport.width = this.pixelWidth;
+    this.viewport.height = this.pixelHeight;
+
+    // The scene worker draws the frame and reports its statistics
+    if (this.sceneWorker) {
+      this.sceneWorker.setViewport(this.viewport);
+      return;
+    }
+
+    if (!this.renderer) return;
 
     // Render using the new renderer
     this.renderer.render(this.viewport);
@@ -360,20 +443,38 @@ class GDSViewer {
   }
 
   private updateFileInfo(fileName: string) {
-    if (!this.currentLibrary) return;
-
-    const totalElements = this.currentLibrary.structures
-      .reduce((sum, struct) => sum + struct.elements.length, 0);
+    let name: string;
+    let structureCount: number;
+    let totalElements: number;
+
+    if (this.sceneSummary) {
+      ({ name, structureCount, elementCount: totalElements } = this.sceneSummary);
+    } else if (this.currentLibrary) {
+      name = this.currentLibrary.name;
+      structureCount = this.currentLibrary.structures.length;
+      totalElements = this.currentLibrary.structures
+        .reduce((sum, struct) => sum + struct.elements.length, 0);
+    } else {
+      return;
+    }
 
     this.fileInfo.innerHTML = `
       <strong>File:</strong> ${fileName}<br>
-      <strong>Library:</strong> ${this.currentLibrary.name}<br>
-      <strong>Structures:</strong> ${this.currentLibrary.structures.length}<br>
+      <strong>Library:</strong> ${name}<br>
+      <strong>Structures:</strong> ${structureCount}<br>
       <strong>Total Elements:</strong> ${totalElements}
     `;
   }
 
   private updateLayerList() {
+    if (this.sceneSummary) {
+      this.layerList.innerHTML = '';
+      for (const { layer, dataType, color } of this.sceneSummary.layers) {
+        this.addLayerItem(`${layer}_${dataType}`, color);
+      }
+      return;
+    }
+
     if (!this.currentLibrary || !this.renderer) return;
 
     this.layerList.innerHTML = '';
@@ -408,30 +509,39 @@ class GDSViewer {
       });
 
     sortedLayers.forEach(([layerKey, layerStyle]) => {
-      const layerItem = document.createElement('div');
-      layerItem.className = 'layer-item';
-      
-      const [layerNum, dataType] = layerKey.split('_');
-      
-      layerItem.innerHTML = `
-        <input type="checkbox" id="layer-${layerKey}" checked>
-        <span class="layer-color" style="background-color: ${layerStyle.color}"></span>
-        <label for="layer-${layerKey}">Layer ${layerNum}:${dataType}</label>
-      `;
+      this.addLayerItem(layerKey, layerStyle.color);
+    });
+  }
 
-      const checkbox = layerItem.querySelector('input') as HTMLInputElement;
-      checkbox.addEventListener('change', () => {
-        this.toggleLayer(layerKey, checkbox.checked);
-      });
+  private addLayerItem(layerKey: string, color: string) {
+    const layerItem = document.createElement('div');
+    layerItem.className = 'layer-item';
+
+    const [layerNum, dataType] = layerKey.split('_');
 
-      this.layerList.appendChild(layerItem);
+    layerItem.innerHTML = `
+      <input type="checkbox" id="layer-${layerKey}" checked>
+      <span class="layer-color" style="background-color: ${color}"></span>
+      <label for="layer-${layerKey}">Layer ${layerNum}:${dataType}</label>
+    `;
+
+    const checkbox = layerItem.querySelector('input') as HTMLInputElement;
+    checkbox.addEventListener('change', () => {
+      this.toggleLayer(layerKey, checkbox.checked);
     });
+
+    this.layerList.appendChild(layerItem);
   }
 
   private toggleLayer(layerKey: string, visible: boolean) {
-    if (!this.renderer) return;
-    
     const [layer, dataType] = layerKey.split('_').map(Number);
+
+    if (this.sceneWorker) {
+      this.sceneWorker.setLayerVisible(layer, dataType, visible);
+      return;
+    }
+
+    if (!this.renderer) return;
     this.renderer.setLayerVisible(layer, dataType, visible);
     this.render();
   }
@@ -489,7 +599,22 @@ class GDSViewer {
     
     try {
       this.showMessage(`Switching to ${selectedBackend.toUpperCase()} renderer...`);
-      
+
+      // The old canvas belongs to the worker; the new backend gets a new one
+      if (this.sceneWorker) {
+        const canvas = this.canvas.cloneNode(false) as HTMLCanvasElement;
+        this.canvas.replaceWith(canvas);
+        this.canvas = canvas;
+        this.bindCanvasEvents();
+
+        this.workerBackend = await this.sceneWorker.attachCanvas(canvas, selectedBackend);
+        this.sceneWorker.resize(this.pixelWidth, this.pixelHeight);
+        this.updateBackendInfo();
+        this.render();
+        this.showMessage(`Switched to ${this.workerBackend.toUpperCase()} renderer`);
+        return;
+      }
+
       // Store current state
       const currentLibrary = this.currentLibrary;
       const currentViewport = { ...this.viewport };
@@ -529,12 +654,15 @@ class GDSViewer {
    * Updates the backend info display
    */
   private updateBackendInfo(): void {
-    if (!this.renderer) return;
-    
-    const caps = this.renderer.getCapabilities();
+    const backend = this.sceneWorker ? this.workerBackend : this.renderer?.getCapabilities().backend;
+    if (!backend) return;
+
     const backends = RendererFactory.getAvailableBackends();
-    
-    let infoText = `Active: ${caps.backend.toUpperCase()}`;
+
+    let infoText = `Active: ${backend.toUpperCase()}`;
+    if (this.sceneWorker) {
+      infoText += ' (worker)';
+    }
     if (!backends.webgl2) {
       infoText += ' (WebGL2 unavailable)';
     }
@@ -557,8 +685,8 @@ class GDSViewer {
       // No valid bounds, reset to default view
       this.viewport = {
         center: { x: 0, y: 0 },
-        width: this.canvas.width,
-        height: this.canvas.height,
+        width: this.pixelWidth,
+        height: this.pixelHeight,
         zoom: 1
       };
     } else {
@@ -568,8 +696,8 @@ class GDSViewer {
       
       // Calculate zoom to fit the bbox in the canvas with 10% padding
       // Zoom represents canvas pixels per world unit
-      const scaleX = (this.canvas.width * 0.9) / bboxWidth;
-      const scaleY = (this.canvas.height * 0.9) / bboxHeight;
+      const scaleX = (this.pixelWidth * 0.9) / bboxWidth;
+      const scaleY = (this.pixelHeight * 0.9) / bboxHeight;
       const zoom = Math.min(scaleX, scaleY);
 
       this.viewport = {
@@ -577,12 +705,12 @@ class GDSViewer {
           x: (this.libraryBBox.minX + this.libraryBBox.maxX) / 2,
           y: (this.libraryBBox.minY + this.libraryBBox.maxY) / 2
         },
-        width: this.canvas.width,
-        height: this.canvas.height,
+        width: this.pixelWidth,
+        height: this.pixelHeight,
         zoom: zoom
       };
       
-      console.log(`Reset view: bbox ${bboxWidth.toFixed(0)}x${bboxHeight.toFixed(0)}, canvas ${this.canvas.width}x${this.canvas.height}, zoom ${zoom.toFixed(4)}`);
+      console.log(`Reset view: bbox ${bboxWidth.toFixed(0)}x${bboxHeight.toFixed(0)}, canvas ${this.pixelWidth}x${this.pixelHeight}, zoom ${zoom.toFixed(4)}`);
       console.log(`Viewport center: (${this.viewport.center.x.toFixed(0)}, ${this.viewport.center.y.toFixed(0)})`);
     }
 
@@ -627,8 +755,8 @@ class GDSViewer {
     const mouseY = e.clientY - rect.top;
 
     // Convert to world coordinates before zoom
-    const worldX = this.viewport.center.x + (mouseX - this.canvas.width / 2) / this.viewport.zoom;
-    const worldY = this.viewport.center.y - (mouseY - this.canvas.height / 2) / this.viewport.zoom;
+    const worldX = this.viewport.center.x + (mouseX - this.pixelWidth / 2) / this.viewport.zoom;
+    const worldY = this.viewport.center.y - (mouseY - this.pixelHeight / 2) / this.viewport.zoom;
 
     // Apply zoom
     const zoomFactor = e.deltaY > 0 ? 0.9 : 1.1;
@@ -636,8 +764,8 @@ class GDSViewer {
     this.viewport.zoom = Math.max(0.01, Math.min(100, newZoom));
 
     // Adjust center to keep mouse position fixed in world space
-    this.viewport.center.x = worldX - (mouseX - this.canvas.width / 2) / this.viewport.zoom;
-    this.viewport.center.y = worldY + (mouseY - this.canvas.height / 2) / this.viewport.zoom;
+    this.viewport.center.x = worldX - (mouseX - this.pixelWidth / 2) / this.viewport.zoom;
+    this.viewport.center.y = worldY + (mouseY - this.pixelHeight / 2) / this.viewport.zoom;
 
     this.render();
   }
@@ -655,14 +783,24 @@ class GDSViewer {
 
     // Set canvas size with device pixel ratio for sharp rendering
     const dpr = window.devicePixelRatio || 1;
-    this.canvas.width = width * dpr;
-    this.canvas.height = height * dpr;
+    this.pixelWidth = Math.round(width * dpr);
+    this.pixelHeight = Math.round(height * dpr);
     this.canvas.style.width = `${width}px`;
     this.canvas.style.height = `${height}px`;
 
     // Update viewport dimensions
-    this.viewport.width = this.canvas.width;
-    this.viewport.height = this.canvas.height;
+    this.viewport.width = this.pixelWidth;
+    this.viewport.height = this.pixelHeight;
+
+    // A canvas handed to the worker is resized there
+    if (this.sceneWorker) {
+      this.sceneWorker.resize(this.pixelWidth, this.pixelHeight);
+      this.render();
+      return;
+    }
+
+    this.canvas.width = this.pixelWidth;
+    this.canvas.height = this.pixelHeight;
 
     // Notify renderer of resize by just re-rendering with updated viewport
     if (this.renderer) {
@@ -712,6 +850,14 @@ class GDSViewer {
    * Get library information for debugging
    */
   public getLibraryInfo() {
+    if (this.sceneSummary) {
+      return {
+        name: this.sceneSummary.name,
+        structureCount: this.sceneSummary.structureCount,
+        totalElements: this.sceneSummary.elementCount,
+        bounds: this.libraryBBox
+      };
+    }
     if (!this.currentLibrary) {
       return null;
     }
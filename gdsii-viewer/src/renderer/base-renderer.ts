@@ -17,6 +17,7 @@ import type {
   RenderStatistics,
   RenderOptions,
   RendererCapabilities,
+  RenderCanvas,
   DEFAULT_LAYER_STYLE
 } from './renderer-interface';
 
@@ -30,7 +31,7 @@ import { flattenLibrary } from '../hierarchy-resolver';
  * Abstract base class for renderers
  */
 export abstract class BaseRenderer implements IRenderer {
-  protected canvas: HTMLCanvasElement | null = null;
+  protected canvas: RenderCanvas | null = null;
   protected sceneGraph: SceneGraph;
   protected library: GDSLibrary | null = null;
   protected layerStyles: Map<string, LayerStyle> = new Map();
@@ -63,7 +64,7 @@ export abstract class BaseRenderer implements IRenderer {
   // Abstract methods that must be implemented by subclasses
   // ========================================================================
 
-  abstract initialize(canvas: HTMLCanvasElement): Promise<void>;
+  abstract initialize(canvas: RenderCanvas): Promise<void>;
   abstract dispose(): void;
   abstract renderImmediate(viewport: Viewport): void;
   abstract getCapabilities(): RendererCapabilities;
@@ -136,6 +137,11 @@ export abstract class BaseRenderer implements IRenderer {
       return;
     }
 
+    // workers of some browsers have no animation frames
+    if (typeof requestAnimationFrame === 'undefined') {
+      return;
+    }
+
     this.renderRequested = true;
 
     if (this.animationFrameId !== null) {
@@ -353,11 +359,11 @@ export abstract class BaseRenderer implements IRenderer {
     return this.sceneGraph;
   }
 
-  protected getCanvas(): HTMLCanvasElement | null {
+  protected getCanvas(): RenderCanvas | null {
     return this.canvas;
   }
 
-  protected setCanvas(canvas: HTMLCanvasElement): void {
+  protected setCanvas(canvas: RenderCanvas | null): void {
     this.canvas = canvas;
   }
 }
@@ -14,6 +14,7 @@ import type {
 
 import type {
   RendererCapabilities,
+  RenderCanvas,
   LayerStyle
 } from './renderer-interface';
 
@@ -26,13 +27,13 @@ import { logger, LogCategory } from '../debug-logger';
  * Canvas2D renderer implementation
  */
 export class Canvas2DRenderer extends BaseRenderer {
-  private ctx: CanvasRenderingContext2D | null = null;
+  private ctx: CanvasRenderingContext2D | OffscreenCanvasRenderingContext2D | null = null;
 
   // ========================================================================
   // Lifecycle Management
   // ========================================================================
 
-  async initialize(canvas: HTMLCanvasElement): Promise<void> {
+  async initialize(canvas: RenderCanvas): Promise<void> {
     logger.info(LogCategory.RENDERER, 'Initializing Canvas2D renderer...');
     this.setCanvas(canvas);
     
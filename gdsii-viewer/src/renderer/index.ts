@@ -11,7 +11,8 @@ export type {
   RenderStatistics,
   PickResult,
   RenderOptions,
-  RendererCapabilities
+  RendererCapabilities,
+  RenderCanvas
 } from './renderer-interface';
 
 export {
@@ -5,7 +5,7 @@
  * Handles fallback to Canvas2D if WebGL is not available.
  */
 
-import type { IRenderer } from './renderer-interface';
+import type { IRenderer, RenderCanvas } from './renderer-interface';
 import { Canvas2DRenderer } from './canvas2d-renderer';
 import { WebGLRenderer } from './webgl/webgl-renderer';
 
@@ -42,7 +42,7 @@ export class RendererFactory {
    * Creates a renderer instance based on configuration
    */
   static async create(
-    canvas: HTMLCanvasElement,
+    canvas: RenderCanvas,
     config: RendererConfig = {}
   ): Promise<IRenderer> {
     const fullConfig = { ...DEFAULT_CONFIG, ...config };
@@ -101,7 +101,7 @@ export class RendererFactory {
    * Creates a renderer for the specified backend
    */
   private static async createBackend(
-    canvas: HTMLCanvasElement,
+    canvas: RenderCanvas,
     backend: RendererBackend
   ): Promise<IRenderer> {
     switch (backend) {
@@ -121,7 +121,7 @@ export class RendererFactory {
    * Creates a Canvas2D renderer instance
    */
   private static async createCanvas2DRenderer(
-    canvas: HTMLCanvasElement
+    canvas: RenderCanvas
   ): Promise<IRenderer> {
     const renderer = new Canvas2DRenderer();
     await renderer.initialize(canvas);
@@ -132,20 +132,30 @@ export class RendererFactory {
    * Creates a WebGL renderer instance
    */
   private static async createWebGLRenderer(
-    canvas: HTMLCanvasElement
+    canvas: RenderCanvas
   ): Promise<IRenderer> {
     const renderer = new WebGLRenderer();
     await renderer.initialize(canvas);
     return renderer;
   }
 
+  /**
+   * Creates a canvas for feature detection; workers have no document
+   */
+  private static createProbeCanvas(): RenderCanvas {
+    if (typeof document === 'undefined') {
+      return new OffscreenCanvas(1, 1);
+    }
+    return document.createElement('canvas');
+  }
+
   /**
    * Checks if WebGL is supported
    */
   private static supportsWebGL(): boolean {
     try {
-      const canvas = document.createElement('canvas');
-      const gl = canvas.getContext('webgl') || canvas.getContext('experimental-webgl');
+      const canvas = this.createProbeCanvas();
+      const gl = canvas.getContext('webgl');
       return gl !== null;
     } catch {
       return false;
@@ -157,7 +167,7 @@ export class RendererFactory {
    */
   private static supportsWebGL2(): boolean {
     try {
-      const canvas = document.createElement('canvas');
+      const canvas = this.createProbeCanvas();
       const gl = canvas.getContext('webgl2');
       return gl !== null;
     } catch {
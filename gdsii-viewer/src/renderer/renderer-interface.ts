@@ -15,6 +15,11 @@ import type {
 import type { Viewport } from '../scene/scene-graph';
 import type { SpatialElement } from '../scene/spatial-index';
 
+/**
+ * Canvas a renderer draws into; an OffscreenCanvas when rendering in a worker
+ */
+export type RenderCanvas = HTMLCanvasElement | OffscreenCanvas;
+
 /**
  * Layer rendering style
  */
@@ -84,9 +89,9 @@ export interface IRenderer {
   // ========================================================================
 
   /**
-   * Initializes the renderer with a canvas element
+   * Initializes the renderer with a canvas element or an OffscreenCanvas
    */
-  initialize(canvas: HTMLCanvasElement): Promise<void>;
+  initialize(canvas: RenderCanvas): Promise<void>;
 
   /**
    * Disposes of all renderer resources
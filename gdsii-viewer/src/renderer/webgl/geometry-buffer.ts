@@ -112,6 +112,41 @@ export class GeometryBuffer {
     this.gl.bufferSubData(this.gl.ARRAY_BUFFER, offset, vertices);
   }
 
+  /**
+   * Allocates uninitialized buffers, to be filled with updateVertices
+   * and updateIndices
+   * 
+   * @param vertexCount Number of vertices (2 floats each)
+   * @param indexCount Number of indices
+   */
+  allocate(vertexCount: number, indexCount: number): void {
+    if (!this.vertexBuffer || !this.indexBuffer) {
+      throw new Error('Buffers not initialized');
+    }
+
+    this.gl.bindBuffer(this.gl.ARRAY_BUFFER, this.vertexBuffer);
+    this.gl.bufferData(this.gl.ARRAY_BUFFER, vertexCount * 2 * 4, this.usage);
+    this.gl.bindBuffer(this.gl.ELEMENT_ARRAY_BUFFER, this.indexBuffer);
+    this.gl.bufferData(this.gl.ELEMENT_ARRAY_BUFFER, indexCount * 4, this.usage);
+    this.vertexCount = vertexCount;
+    this.indexCount = indexCount;
+  }
+
+  /**
+   * Updates a portion of the index buffer
+   * 
+   * @param indices New index data
+   * @param offset Offset in bytes
+   */
+  updateIndices(indices: Uint32Array, offset: number = 0): void {
+    if (!this.indexBuffer) {
+      throw new Error('Index buffer not initialized');
+    }
+
+    this.gl.bindBuffer(this.gl.ELEMENT_ARRAY_BUFFER, this.indexBuffer);
+    this.gl.bufferSubData(this.gl.ELEMENT_ARRAY_BUFFER, offset, indices);
+  }
+
   /**
    * Binds the vertex buffer and sets up vertex attributes
    * 
@@ -178,6 +213,26 @@ export class GeometryBuffer {
     );
   }
 
+  /**
+   * Draws the geometry once per instance; instance attributes must be
+   * bound with a divisor
+   *
+   * @param instanceCount Number of instances
+   */
+  drawInstanced(instanceCount: number): void {
+    if (this.indexCount === 0 || instanceCount === 0) {
+      return;
+    }
+
+    this.gl.drawElementsInstanced(
+      this.gl.TRIANGLES,
+      this.indexCount,
+      this.gl.UNSIGNED_INT,
+      0,
+      instanceCount
+    );
+  }
+
   /**
    * Gets buffer statistics
    */
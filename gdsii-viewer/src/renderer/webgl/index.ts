@@ -1,6 +1,7 @@
 // WebGL Renderer Module
 export { ShaderProgram } from './shader-program';
 export { GeometryBuffer, BufferPool, BufferUsage } from './geometry-buffer';
-export { triangulate, triangulateMultiple, flattenPolygon, validatePolygon } from './triangulator';
+export { triangulate, triangulateMultiple, flattenPolygon, validatePolygon, elementPolygons } from './triangulator';
 export { LayerBatch, LayerBatchManager } from './layer-batch';
 export { WebGLRenderer } from './webgl-renderer';
+export { InstancedScene } from './instanced-scene';
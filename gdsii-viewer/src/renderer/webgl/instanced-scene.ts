@@ -0,0 +1,340 @@
+/**
+ * Instanced Scene
+ *
+ * Draws the hierarchy of a library with instanced draw calls instead of
+ * flattened geometry. The own geometry of every placed structure (cell) is
+ * triangulated and uploaded once per layer in cell coordinates; SREF and
+ * AREF placements become per-instance transforms. Placements are culled
+ * against the view with a packed R-tree over their bounds per cell, and
+ * the transforms in view are streamed to a shared instance buffer.
+ */
+
+import type { GDSBBox, GDSLibrary, GDSPoint } from '../../gdsii-types';
+import { collectPlacements } from '../../hierarchy-resolver';
+import { PackedRTree } from '../../scene/spatial-index';
+import { GeometryBuffer, BufferUsage } from './geometry-buffer';
+import { triangulateMultiple, elementPolygons } from './triangulator';
+
+/** Floats per placement: m11, m21, m12, m22, m13, m23 */
+const TRANSFORM_FLOATS = 6;
+
+/**
+ * Attribute locations of the instanced shader program
+ */
+export interface InstanceAttributes {
+  position: number;
+  instanceX: number;
+  instanceY: number;
+  instanceOffset: number;
+}
+
+/**
+ * Geometry of a cell on one layer, in cell coordinates
+ */
+interface CellLayer {
+  layerKey: string;
+  buffer: GeometryBuffer;
+  triangleCount: number;
+}
+
+/**
+ * A structure with own geometry and all its placements
+ */
+interface InstancedCell {
+  name: string;
+  layers: CellLayer[];
+  transforms: Float32Array;
+  placementCount: number;
+  tree: PackedRTree;
+  instanceBuffer: WebGLBuffer;
+}
+
+/**
+ * Instancing statistics
+ */
+export interface InstancingStats {
+  cellCount: number;
+  placementCount: number;
+  triangleCount: number;
+  flattenedTriangleCount: number;
+  instancesDrawn: number;
+  totalBytes: number;
+}
+
+/**
+ * Cells of a library with their placements, ready for instanced drawing
+ */
+export class InstancedScene {
+  private cells: InstancedCell[] = [];
+  private streamBuffer: WebGLBuffer | null = null;
+  private scratch: Float32Array = new Float32Array(TRANSFORM_FLOATS * 1024);
+  private hasReferences = false;
+  private instancesDrawn = 0;
+
+  constructor(private readonly gl: WebGL2RenderingContext) {}
+
+  /**
+   * Builds the cells of a library; references deeper than maxDepth and
+   * references on cycles are not drawn
+   */
+  build(library: GDSLibrary, maxDepth: number = 100): void {
+    this.clear();
+
+    this.hasReferences = library.structures.some(s =>
+      s.elements.some(e => e.type === 'sref' || e.type === 'aref')
+    );
+    if (!this.hasReferences) {
+      return;
+    }
+
+    for (const [structure, placements] of collectPlacements(library, maxDepth)) {
+      const polygonsByLayer = new Map<string, GDSPoint[][]>();
+      for (const element of structure.elements) {
+        const polygons = elementPolygons(element);
+        if (polygons.length === 0) continue;
+
+        const layerKey = `${element.layer}_${element.dataType}`;
+        let list = polygonsByLayer.get(layerKey);
+        if (!list) {
+          list = [];
+          polygonsByLayer.set(layerKey, list);
+        }
+        for (const polygon of polygons) {
+          list.push(polygon);
+        }
+      }
+
+      const bounds: GDSBBox = { minX: Infinity, minY: Infinity, maxX: -Infinity, maxY: -Infinity };
+      const layers: CellLayer[] = [];
+      for (const [layerKey, polygons] of polygonsByLayer) {
+        const { vertices, indices, triangleCount } = triangulateMultiple(polygons);
+        if (indices.length === 0) continue;
+
+        for (let i = 0; i < vertices.length; i += 2) {
+          if (vertices[i] < bounds.minX) bounds.minX = vertices[i];
+          if (vertices[i] > bounds.maxX) bounds.maxX = vertices[i];
+          if (vertices[i + 1] < bounds.minY) bounds.minY = vertices[i + 1];
+          if (vertices[i + 1] > bounds.maxY) bounds.maxY = vertices[i + 1];
+        }
+
+        const buffer = new GeometryBuffer(this.gl, BufferUsage.STATIC);
+        buffer.uploadVertices(vertices);
+        buffer.uploadIndices(indices);
+        layers.push({ layerKey, buffer, triangleCount });
+      }
+      if (layers.length === 0) continue;
+
+      const placementCount = placements.length / TRANSFORM_FLOATS;
+      const tree = new PackedRTree(placementCount);
+      for (let i = 0; i < placements.length; i += TRANSFORM_FLOATS) {
+        addPlacementBounds(tree, placements, i, bounds);
+      }
+      tree.finish();
+
+      const transforms = new Float32Array(placements);
+      const instanceBuffer = this.gl.createBuffer();
+      if (!instanceBuffer) {
+        throw new Error('Failed to create instance buffer');
+      }
+      this.gl.bindBuffer(this.gl.ARRAY_BUFFER, instanceBuffer);
+      this.gl.bufferData(this.gl.ARRAY_BUFFER, transforms, this.gl.STATIC_DRAW);
+
+      this.cells.push({
+        name: structure.name,
+        layers,
+        transforms,
+        placementCount,
+        tree,
+        instanceBuffer
+      });
+    }
+  }
+
+  /**
+   * Checks if the library has references, i.e. if instancing applies
+   */
+  hasInstances(): boolean {
+    return this.hasReferences && this.cells.length > 0;
+  }
+
+  /**
+   * Draws the placements in view. beginLayer sets up a layer and returns
+   * false for layers that are not drawn.
+   * @returns Number of draw calls
+   */
+  render(
+    view: GDSBBox,
+    attributes: InstanceAttributes,
+    beginLayer: (layerKey: string) => boolean
+  ): number {
+    const gl = this.gl;
+    let drawCalls = 0;
+    this.instancesDrawn = 0;
+
+    for (const cell of this.cells) {
+      const count = cell.tree.search(view.minX, view.minY, view.maxX, view.maxY);
+      if (count === 0) continue;
+
+      if (count === cell.placementCount) {
+        gl.bindBuffer(gl.ARRAY_BUFFER, cell.instanceBuffer);
+      } else {
+        gl.bindBuffer(gl.ARRAY_BUFFER, this.gatherVisible(cell, count));
+      }
+      this.bindInstanceAttributes(attributes);
+
+      for (const layer of cell.layers) {
+        if (!beginLayer(layer.layerKey)) continue;
+        layer.buffer.bindVertexBuffer(attributes.position);
+        layer.buffer.bindIndexBuffer();
+        layer.buffer.drawInstanced(count);
+        drawCalls++;
+      }
+      this.instancesDrawn += count;
+    }
+
+    this.unbindInstanceAttributes(attributes);
+    return drawCalls;
+  }
+
+  /**
+   * Copies the transforms of the placements found by the last search into
+   * the stream buffer
+   */
+  private gatherVisible(cell: InstancedCell, count: number): WebGLBuffer {
+    const gl = this.gl;
+    if (!this.streamBuffer) {
+      this.streamBuffer = gl.createBuffer();
+      if (!this.streamBuffer) {
+        throw new Error('Failed to create instance buffer');
+      }
+    }
+
+    const needed = count * TRANSFORM_FLOATS;
+    if (this.scratch.length < needed) {
+      let length = this.scratch.length;
+      while (length < needed) length *= 2;
+      this.scratch = new Float32Array(length);
+    }
+
+    const ids = cell.tree.getResults();
+    const transforms = cell.transforms;
+    for (let i = 0; i < count; i++) {
+      const src = ids[i] * TRANSFORM_FLOATS;
+      const dst = i * TRANSFORM_FLOATS;
+      for (let k = 0; k < TRANSFORM_FLOATS; k++) {
+        this.scratch[dst + k] = transforms[src + k];
+      }
+    }
+
+    gl.bindBuffer(gl.ARRAY_BUFFER, this.streamBuffer);
+    gl.bufferData(gl.ARRAY_BUFFER, this.scratch.subarray(0, needed), gl.STREAM_DRAW);
+    return this.streamBuffer;
+  }
+
+  /**
+   * Points the instance attributes at the bound array buffer
+   */
+  private bindInstanceAttributes(attributes: InstanceAttributes): void {
+    const gl = this.gl;
+    const stride = TRANSFORM_FLOATS * 4;
+    const columns = [attributes.instanceX, attributes.instanceY, attributes.instanceOffset];
+
+    columns.forEach((location, column) => {
+      gl.enableVertexAttribArray(location);
+      gl.vertexAttribPointer(location, 2, gl.FLOAT, false, stride, column * 8);
+      gl.vertexAttribDivisor(location, 1);
+    });
+  }
+
+  /**
+   * Restores per-vertex attributes for the other shader programs
+   */
+  private unbindInstanceAttributes(attributes: InstanceAttributes): void {
+    const gl = this.gl;
+    for (const location of [attributes.instanceX, attributes.instanceY, attributes.instanceOffset]) {
+      gl.vertexAttribDivisor(location, 0);
+      gl.disableVertexAttribArray(location);
+    }
+  }
+
+  /**
+   * Gets instancing statistics
+   */
+  getStats(): InstancingStats {
+    let placementCount = 0;
+    let triangleCount = 0;
+    let flattenedTriangleCount = 0;
+    let totalBytes = 0;
+
+    for (const cell of this.cells) {
+      placementCount += cell.placementCount;
+      totalBytes += cell.transforms.byteLength;
+      for (const layer of cell.layers) {
+        triangleCount += layer.triangleCount;
+        flattenedTriangleCount += layer.triangleCount * cell.placementCount;
+        totalBytes += layer.buffer.getStats().totalBytes;
+      }
+    }
+
+    return {
+      cellCount: this.cells.length,
+      placementCount,
+      triangleCount,
+      flattenedTriangleCount,
+      instancesDrawn: this.instancesDrawn,
+      totalBytes
+    };
+  }
+
+  /**
+   * Deletes the geometry and instance buffers of all cells
+   */
+  clear(): void {
+    for (const cell of this.cells) {
+      for (const layer of cell.layers) {
+        layer.buffer.dispose();
+      }
+      this.gl.deleteBuffer(cell.instanceBuffer);
+    }
+    this.cells = [];
+    this.hasReferences = false;
+    this.instancesDrawn = 0;
+  }
+
+  /**
+   * Disposes of all buffers
+   */
+  dispose(): void {
+    this.clear();
+    if (this.streamBuffer) {
+      this.gl.deleteBuffer(this.streamBuffer);
+      this.streamBuffer = null;
+    }
+  }
+}
+
+/**
+ * Adds the bounds of a cell placed by the transform at offset i
+ */
+function addPlacementBounds(
+  tree: PackedRTree,
+  t: number[],
+  i: number,
+  bounds: GDSBBox
+): void {
+  const m11 = t[i], m21 = t[i + 1], m12 = t[i + 2], m22 = t[i + 3], m13 = t[i + 4], m23 = t[i + 5];
+  let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity;
+
+  for (const x of [bounds.minX, bounds.maxX]) {
+    for (const y of [bounds.minY, bounds.maxY]) {
+      const wx = m11 * x + m12 * y + m13;
+      const wy = m21 * x + m22 * y + m23;
+      if (wx < minX) minX = wx;
+      if (wx > maxX) maxX = wx;
+      if (wy < minY) minY = wy;
+      if (wy > maxY) maxY = wy;
+    }
+  }
+
+  tree.add(minX, minY, maxX, maxY);
+}
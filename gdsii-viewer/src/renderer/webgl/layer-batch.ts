@@ -2,22 +2,52 @@
  * Layer Batch Manager
  * 
  * Combines multiple elements within a layer into a single geometry batch
- * to minimize draw calls and improve rendering performance.
+ * to minimize draw calls and improve rendering performance. A batch is
+ * split into spatial chunks that own ranges of the layer's GPU buffers:
+ * a changed chunk is re-triangulated and uploaded with bufferSubData in
+ * place, and only the chunks in view are drawn. Colors and opacity are
+ * uniforms, so style and visibility changes never touch the geometry.
  */
 
-import type { GDSElement } from '../../gdsii-types';
+import type { GDSBBox } from '../../gdsii-types';
 import type { SpatialElement } from '../../scene/spatial-index';
 import type { LayerStyle } from '../renderer-interface';
 import { GeometryBuffer, BufferUsage } from './geometry-buffer';
-import { triangulateMultiple } from './triangulator';
+import { triangulateMultiple, elementPolygons } from './triangulator';
+
+/** Target number of elements per chunk */
+const CHUNK_ELEMENTS = 1024;
+
+/** Spare room in chunk ranges, so that edited chunks can grow in place */
+const CHUNK_SLACK = 1.25;
+
+/**
+ * Spatial chunk of a batch and its ranges in the buffers
+ */
+interface BatchChunk {
+  bounds: GDSBBox;
+  elements: SpatialElement[];
+  vertexStart: number;
+  vertexCapacity: number;
+  vertexCount: number;
+  indexStart: number;
+  indexCapacity: number;
+  indexCount: number;
+  dirty: boolean;
+}
+
+type ChunkGeometry = { vertices: Float32Array; indices: Uint32Array };
+
+const intersects = (a: GDSBBox, b: GDSBBox): boolean =>
+  a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY;
 
 /**
  * Represents a batch of geometry for a single layer
  */
 export class LayerBatch {
   private buffer: GeometryBuffer;
-  private vertexCount: number = 0;
-  private indexCount: number = 0;
+  private chunks: BatchChunk[] = [];
+  private laidOut: boolean = false;
   private dirty: boolean = true;
   private layerKey: string;
   private style: LayerStyle;
@@ -36,78 +66,224 @@ export class LayerBatch {
    * Updates the batch with new elements
    */
   update(elements: SpatialElement[]): void {
+    this.setElements(elements);
+    this.flush();
+  }
+
+  /**
+   * Replaces the elements of the batch and splits them into chunks on a
+   * grid over their bounds; the geometry is built by the next flush()
+   */
+  setElements(elements: SpatialElement[]): void {
+    this.chunks = [];
+    this.laidOut = false;
+    this.dirty = true;
     if (elements.length === 0) {
-      this.vertexCount = 0;
-      this.indexCount = 0;
-      this.dirty = false;
       return;
     }
 
-    // Collect all polygons from all elements
-    const allPolygons: any[] = [];
-    
-    for (const spatialElement of elements) {
-      const element = spatialElement.element;
-      const polygons = this.extractPolygons(element);
-      allPolygons.push(...polygons);
+    let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity;
+    for (const { bounds } of elements) {
+      if (bounds.minX < minX) minX = bounds.minX;
+      if (bounds.minY < minY) minY = bounds.minY;
+      if (bounds.maxX > maxX) maxX = bounds.maxX;
+      if (bounds.maxY > maxY) maxY = bounds.maxY;
     }
 
-    if (allPolygons.length === 0) {
-      this.vertexCount = 0;
-      this.indexCount = 0;
-      this.dirty = false;
-      return;
+    const grid = Math.ceil(Math.sqrt(Math.ceil(elements.length / CHUNK_ELEMENTS)));
+    const cellWidth = (maxX - minX) / grid || 1;
+    const cellHeight = (maxY - minY) / grid || 1;
+    const cells: (BatchChunk | undefined)[] = new Array(grid * grid);
+
+    for (const element of elements) {
+      const { bounds } = element;
+      const cx = Math.min(grid - 1, Math.floor(((bounds.minX + bounds.maxX) / 2 - minX) / cellWidth));
+      const cy = Math.min(grid - 1, Math.floor(((bounds.minY + bounds.maxY) / 2 - minY) / cellHeight));
+      let chunk = cells[cy * grid + cx];
+      if (!chunk) {
+        chunk = {
+          bounds: { ...bounds },
+          elements: [],
+          vertexStart: 0,
+          vertexCapacity: 0,
+          vertexCount: 0,
+          indexStart: 0,
+          indexCapacity: 0,
+          indexCount: 0,
+          dirty: true
+        };
+        cells[cy * grid + cx] = chunk;
+      }
+      chunk.elements.push(element);
+      if (bounds.minX < chunk.bounds.minX) chunk.bounds.minX = bounds.minX;
+      if (bounds.minY < chunk.bounds.minY) chunk.bounds.minY = bounds.minY;
+      if (bounds.maxX > chunk.bounds.maxX) chunk.bounds.maxX = bounds.maxX;
+      if (bounds.maxY > chunk.bounds.maxY) chunk.bounds.maxY = bounds.maxY;
     }
 
-    // Triangulate all polygons together
-    const { vertices, indices } = triangulateMultiple(allPolygons);
+    for (const chunk of cells) {
+      if (chunk) this.chunks.push(chunk);
+    }
+  }
 
-    // Upload to GPU
-    this.buffer.uploadVertices(vertices);
-    this.buffer.uploadIndices(indices);
+  /**
+   * Checks if the batch holds elements
+   */
+  hasElements(): boolean {
+    return this.chunks.length > 0;
+  }
 
-    this.vertexCount = vertices.length / 2;
-    this.indexCount = indices.length;
+  /**
+   * Marks the chunks that overlap a region as changed, e.g. after their
+   * elements were edited in place
+   */
+  invalidateRegion(region: GDSBBox): void {
+    for (const chunk of this.chunks) {
+      if (intersects(chunk.bounds, region)) {
+        chunk.dirty = true;
+        this.dirty = true;
+      }
+    }
+  }
+
+  /**
+   * Rebuilds and uploads the changed chunks. Chunks that still fit their
+   * ranges are uploaded in place; otherwise the buffers are laid out anew.
+   */
+  flush(): void {
+    if (!this.dirty) {
+      return;
+    }
+
+    const rebuilt = new Map<BatchChunk, ChunkGeometry>();
+    let fits = this.laidOut;
+    for (const chunk of this.chunks) {
+      if (!chunk.dirty) continue;
+      const geometry = this.triangulateChunk(chunk);
+      rebuilt.set(chunk, geometry);
+      if (geometry.vertices.length / 2 > chunk.vertexCapacity ||
+          geometry.indices.length > chunk.indexCapacity) {
+        fits = false;
+      }
+    }
+
+    if (fits) {
+      for (const [chunk, geometry] of rebuilt) {
+        this.uploadChunk(chunk, geometry);
+      }
+    } else {
+      this.layout(rebuilt);
+    }
     this.dirty = false;
   }
 
   /**
-   * Extracts polygons from an element
+   * Assigns buffer ranges with spare room to all chunks and uploads them
    */
-  private extractPolygons(element: GDSElement): any[] {
-    const polygons: any[] = [];
+  private layout(rebuilt: Map<BatchChunk, ChunkGeometry>): void {
+    const geometries: ChunkGeometry[] = [];
+    let vertexTotal = 0;
+    let indexTotal = 0;
+
+    for (const chunk of this.chunks) {
+      const geometry = rebuilt.get(chunk) ?? this.triangulateChunk(chunk);
+      geometries.push(geometry);
+      chunk.vertexStart = vertexTotal;
+      chunk.vertexCapacity = Math.ceil(geometry.vertices.length / 2 * CHUNK_SLACK);
+      chunk.indexStart = indexTotal;
+      chunk.indexCapacity = 3 * Math.ceil(geometry.indices.length / 3 * CHUNK_SLACK);
+      vertexTotal += chunk.vertexCapacity;
+      indexTotal += chunk.indexCapacity;
+    }
+
+    this.buffer.allocate(vertexTotal, indexTotal);
+    this.chunks.forEach((chunk, i) => this.uploadChunk(chunk, geometries[i]));
+    this.laidOut = true;
+  }
 
-    if (element.type === 'boundary') {
-      const boundaryEl = element as any;
-      polygons.push(...boundaryEl.polygons);
-    } else if (element.type === 'path') {
-      const pathEl = element as any;
-      polygons.push(...pathEl.paths);
-    } else if (element.type === 'box') {
-      const boxEl = element as any;
-      if (boxEl.points && boxEl.points.length >= 4) {
-        polygons.push(boxEl.points);
+  /**
+   * Uploads the geometry of a chunk into its ranges. The unused part of
+   * the index range is zeroed: degenerate triangles draw nothing, so
+   * adjacent chunks can be drawn with one call.
+   */
+  private uploadChunk(chunk: BatchChunk, geometry: ChunkGeometry): void {
+    if (geometry.vertices.length > 0) {
+      this.buffer.updateVertices(geometry.vertices, chunk.vertexStart * 2 * 4);
+    }
+    if (chunk.indexCapacity > 0) {
+      const indices = new Uint32Array(chunk.indexCapacity);
+      for (let i = 0; i < geometry.indices.length; i++) {
+        indices[i] = geometry.indices[i] + chunk.vertexStart;
       }
+      this.buffer.updateIndices(indices, chunk.indexStart * 4);
     }
+    chunk.vertexCount = geometry.vertices.length / 2;
+    chunk.indexCount = geometry.indices.length;
+    chunk.dirty = false;
+  }
 
-    return polygons;
+  /**
+   * Triangulates the elements of a chunk
+   */
+  private triangulateChunk(chunk: BatchChunk): ChunkGeometry {
+    const allPolygons: any[] = [];
+    for (const spatialElement of chunk.elements) {
+      const polygons = elementPolygons(spatialElement.element);
+      for (const polygon of polygons) {
+        allPolygons.push(polygon);
+      }
+    }
+    return triangulateMultiple(allPolygons);
   }
 
   /**
-   * Renders the batch
+   * Renders the chunks that overlap a view (all chunks without one);
+   * chunks that are adjacent in the buffer share a draw call
+   * @returns Number of draw calls
    */
-  render(positionLoc: number): void {
-    if (this.indexCount === 0) return;
+  render(positionLoc: number, view?: GDSBBox): number {
+    if (!this.laidOut) return 0;
+
+    let drawCalls = 0;
+    let first = -1;
+    let drawEnd = 0;
+    let rangeEnd = -1;
 
-    this.buffer.bindVertexBuffer(positionLoc);
-    this.buffer.bindIndexBuffer();
-    this.buffer.draw();
+    for (const chunk of this.chunks) {
+      if (chunk.indexCount === 0 || (view && !intersects(chunk.bounds, view))) {
+        continue;
+      }
+      if (first < 0) {
+        this.buffer.bindVertexBuffer(positionLoc);
+        this.buffer.bindIndexBuffer();
+      }
+      if (first >= 0 && chunk.indexStart === rangeEnd) {
+        drawEnd = chunk.indexStart + chunk.indexCount;
+      } else {
+        if (first >= 0) {
+          this.buffer.drawRange(first, drawEnd - first);
+          drawCalls++;
+        }
+        first = chunk.indexStart;
+        drawEnd = first + chunk.indexCount;
+      }
+      rangeEnd = chunk.indexStart + chunk.indexCapacity;
+    }
+
+    if (first >= 0) {
+      this.buffer.drawRange(first, drawEnd - first);
+      drawCalls++;
+    }
+    return drawCalls;
   }
 
   /**
    * Marks the batch as dirty (needs update)
    */
   markDirty(): void {
+    for (const chunk of this.chunks) {
+      chunk.dirty = true;
+    }
     this.dirty = true;
   }
 
@@ -136,11 +312,19 @@ export class LayerBatch {
    * Gets statistics about this batch
    */
   getStats() {
+    let vertexCount = 0;
+    let indexCount = 0;
+    for (const chunk of this.chunks) {
+      vertexCount += chunk.vertexCount;
+      indexCount += chunk.indexCount;
+    }
+
     return {
       layerKey: this.layerKey,
-      vertexCount: this.vertexCount,
-      indexCount: this.indexCount,
-      triangleCount: this.indexCount / 3,
+      chunkCount: this.chunks.length,
+      vertexCount,
+      indexCount,
+      triangleCount: indexCount / 3,
       dirty: this.dirty
     };
   }
@@ -189,6 +373,15 @@ export class LayerBatchManager {
     batch.update(elements);
   }
 
+  /**
+   * Marks the chunks of all batches that overlap a region as changed
+   */
+  invalidateRegion(region: GDSBBox): void {
+    for (const batch of this.batches.values()) {
+      batch.invalidateRegion(region);
+    }
+  }
+
   /**
    * Marks all batches as dirty
    */
@@ -219,6 +412,7 @@ export class LayerBatchManager {
    * Gets overall statistics
    */
   getStats() {
+    let totalChunks = 0;
     let totalVertices = 0;
     let totalIndices = 0;
     let totalTriangles = 0;
@@ -226,6 +420,7 @@ export class LayerBatchManager {
 
     for (const batch of this.batches.values()) {
       const stats = batch.getStats();
+      totalChunks += stats.chunkCount;
       totalVertices += stats.vertexCount;
       totalIndices += stats.indexCount;
       totalTriangles += stats.triangleCount;
@@ -234,6 +429,7 @@ export class LayerBatchManager {
 
     return {
       batchCount: this.batches.size,
+      totalChunks,
       totalVertices,
       totalIndices,
       totalTriangles,
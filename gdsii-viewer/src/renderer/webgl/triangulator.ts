@@ -6,7 +6,7 @@
  */
 
 import earcut from 'earcut';
-import type { GDSPoint } from '../../gdsii-types';
+import type { GDSElement, GDSPoint } from '../../gdsii-types';
 
 /**
  * Triangulates a polygon into triangle indices
@@ -111,6 +111,57 @@ export function triangulateMultiple(polygons: GDSPoint[][]): {
   };
 }
 
+/**
+ * Triangulates polygons in packed form, e.g. the bulk geometry export of
+ * the WASM module (see readStructureGeometry), without building point
+ * objects. The vertices of polygon p are polygonVertices[p] ...
+ * polygonVertices[p+1]-1 in the interleaved vertex array.
+ *
+ * @param vertices Interleaved [x1, y1, x2, y2, ...] coordinates
+ * @param polygonVertices Vertex offsets of the polygons
+ * @param firstPolygon Index of the first polygon to triangulate
+ * @param lastPolygon Index after the last polygon to triangulate
+ * @returns Combined vertices and indices for the polygons
+ */
+export function triangulatePacked(
+  vertices: Float32Array,
+  polygonVertices: Int32Array,
+  firstPolygon = 0,
+  lastPolygon = polygonVertices.length - 1
+): {
+  vertices: Float32Array;
+  indices: Uint32Array;
+  triangleCount: number;
+} {
+  const v0 = polygonVertices[firstPolygon];
+  const v1 = polygonVertices[lastPolygon];
+  const allIndices: number[] = [];
+
+  for (let p = firstPolygon; p < lastPolygon; p++) {
+    const start = polygonVertices[p];
+    let end = polygonVertices[p + 1];
+    if (end - start < 3) continue;
+
+    // Remove duplicate closing vertex if present
+    if (end - start > 3 &&
+        vertices[2 * start] === vertices[2 * end - 2] &&
+        vertices[2 * start + 1] === vertices[2 * end - 1]) {
+      end--;
+    }
+
+    const indices = earcut(vertices.subarray(2 * start, 2 * end));
+    for (const index of indices) {
+      allIndices.push(index + start - v0);
+    }
+  }
+
+  return {
+    vertices: vertices.subarray(2 * v0, 2 * v1),
+    indices: new Uint32Array(allIndices),
+    triangleCount: allIndices.length / 3
+  };
+}
+
 /**
  * Validates polygon geometry
  * 
@@ -131,3 +182,20 @@ export function validatePolygon(polygon: GDSPoint[]): boolean {
 
   return true;
 }
+
+/**
+ * Gets the polygons drawn for an element: boundaries, path outlines and
+ * boxes; references, texts and nodes have none
+ */
+export function elementPolygons(element: GDSElement): GDSPoint[][] {
+  if (element.type === 'boundary') {
+    return element.polygons;
+  } else if (element.type === 'path') {
+    return element.outlines ?? element.paths;
+  } else if (element.type === 'box') {
+    if (element.points.length >= 4) {
+      return [element.points];
+    }
+  }
+  return [];
+}
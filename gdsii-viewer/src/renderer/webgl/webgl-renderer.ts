@@ -5,14 +5,11 @@
  * Implements IRenderer interface for compatibility with the rendering system.
  */
 
-import type {
-  GDSBoundaryElement,
-  GDSPathElement,
-  GDSElement
-} from '../../gdsii-types';
+import type { GDSElement, GDSBBox } from '../../gdsii-types';
 
 import type {
   RendererCapabilities,
+  RenderCanvas,
   LayerStyle
 } from '../renderer-interface';
 
@@ -21,11 +18,13 @@ import type { Viewport } from '../../scene/scene-graph';
 import type { SpatialElement } from '../../scene/spatial-index';
 import { ShaderProgram } from './shader-program';
 import { GeometryBuffer, BufferPool, BufferUsage } from './geometry-buffer';
-import { triangulateMultiple } from './triangulator';
+import { triangulateMultiple, elementPolygons } from './triangulator';
 import { LayerBatchManager } from './layer-batch';
+import { InstancedScene, type InstanceAttributes } from './instanced-scene';
 
 // Import shader sources
 import vertexShaderSource from '../../../shaders/basic.vert?raw';
+import instancedVertexShaderSource from '../../../shaders/instanced.vert?raw';
 import fragmentShaderSource from '../../../shaders/basic.frag?raw';
 
 /**
@@ -36,8 +35,11 @@ export class WebGLRenderer extends BaseRenderer {
   private shaderProgram: ShaderProgram | null = null;
   private bufferPool: BufferPool | null = null;
   private batchManager: LayerBatchManager | null = null;
+  private instancedProgram: ShaderProgram | null = null;
+  private instancedScene: InstancedScene | null = null;
   private identityMatrix: Float32Array;
   private useBatching: boolean = true; // Enable batching by default
+  private useInstancing: boolean = true; // Draw references as instances
 
   constructor() {
     super();
@@ -53,7 +55,7 @@ export class WebGLRenderer extends BaseRenderer {
   // Lifecycle Management
   // ========================================================================
 
-  async initialize(canvas: HTMLCanvasElement): Promise<void> {
+  async initialize(canvas: RenderCanvas): Promise<void> {
     console.log('🎨 Initializing WebGL renderer...');
     this.setCanvas(canvas);
 
@@ -79,11 +81,17 @@ export class WebGLRenderer extends BaseRenderer {
       throw new Error('Failed to compile shaders');
     }
 
+    this.instancedProgram = new ShaderProgram(this.gl, instancedVertexShaderSource, fragmentShaderSource);
+    if (!this.instancedProgram.compile()) {
+      throw new Error('Failed to compile instanced shaders');
+    }
+
     // Create buffer pool
     this.bufferPool = new BufferPool(this.gl, BufferUsage.DYNAMIC);
 
     // Create batch manager
     this.batchManager = new LayerBatchManager(this.gl);
+    this.instancedScene = new InstancedScene(this.gl);
 
     console.log('✓ WebGL renderer initialized');
   }
@@ -105,6 +113,19 @@ export class WebGLRenderer extends BaseRenderer {
     this.gl.clearColor(1.0, 1.0, 1.0, 1.0);
   }
 
+  updateSceneGraph(): void {
+    // batches hold the elements of the previous scene
+    this.batchManager?.clear();
+    super.updateSceneGraph();
+    this.buildInstancedScene();
+  }
+
+  clearScene(): void {
+    this.batchManager?.clear();
+    this.instancedScene?.clear();
+    super.clearScene();
+  }
+
   dispose(): void {
     if (this.shaderProgram) {
       this.shaderProgram.dispose();
@@ -121,6 +142,16 @@ export class WebGLRenderer extends BaseRenderer {
       this.batchManager = null;
     }
 
+    if (this.instancedProgram) {
+      this.instancedProgram.dispose();
+      this.instancedProgram = null;
+    }
+
+    if (this.instancedScene) {
+      this.instancedScene.dispose();
+      this.instancedScene = null;
+    }
+
     this.gl = null;
     this.setCanvas(null);
     this.clearScene();
@@ -167,49 +198,71 @@ export class WebGLRenderer extends BaseRenderer {
     // Clear canvas
     this.gl.clear(this.gl.COLOR_BUFFER_BIT);
 
-    // Query visible elements using spatial index
-    const visibleElements = this.sceneGraph.queryViewport(viewport);
-    const totalElements = this.sceneGraph.getAllElements().length;
-    const culledElements = totalElements - visibleElements.length;
+    // Count visible elements using spatial index
+    const viewBBox = this.viewportToBBox(viewport, canvas);
+    const visibleCount = this.sceneGraph.queryRegionIds(viewBBox).count;
+    const totalElements = this.sceneGraph.getElementCount();
+    const culledElements = totalElements - visibleCount;
 
-    if (visibleElements.length === 0) {
+    if (visibleCount === 0) {
       this.updateStatistics(0, totalElements, 0);
       return;
     }
 
-    // Use shader program
-    this.shaderProgram.use();
-
     // Create view matrix from viewport
     const viewMatrix = this.createViewMatrix(viewport, canvas);
+    const layerGroups = this.sceneGraph.getLayerGroups();
+    let drawCalls = 0;
+
+    if (this.isInstancing()) {
+      drawCalls = this.renderInstanced(viewMatrix, viewBBox);
+      this.updateStatistics(visibleCount, culledElements, drawCalls);
+      return;
+    }
+
+    // Use shader program
+    this.shaderProgram.use();
     this.shaderProgram.setUniformMatrix3fv('u_viewMatrix', viewMatrix);
     this.shaderProgram.setUniformMatrix3fv('u_worldMatrix', this.identityMatrix);
 
     // Get position attribute location
     const positionLoc = this.shaderProgram.getAttributeLocation('a_position');
 
-    // Group elements by layer for efficient rendering
-    const elementsByLayer = this.groupElementsByLayer(visibleElements);
-
-    // Render each layer
-    let drawCalls = 0;
-    for (const [layerKey, elements] of elementsByLayer) {
-      const layerStyle = this.layerStyles.get(layerKey);
-      if (!layerStyle) {
-        continue;
+    if (this.useBatching && this.batchManager) {
+      // Batches hold whole layers and draw the chunks in view; hidden
+      // layers are skipped without touching their geometry
+      for (const [layerKey, group] of layerGroups) {
+        const layerStyle = this.layerStyles.get(layerKey);
+        if (!layerStyle || !group.visible) {
+          continue;
+        }
+        this.setLayerUniforms(this.shaderProgram, layerStyle);
+        drawCalls += this.renderLayerBatched(layerKey, group.elements, layerStyle, positionLoc, viewBBox);
+      }
+    } else {
+      // Group elements by layer for efficient rendering
+      const visibleElements = this.sceneGraph.queryRegion(viewBBox);
+      const elementsByLayer = this.groupElementsByLayer(visibleElements);
+
+      // Render each layer
+      for (const [layerKey, elements] of elementsByLayer) {
+        const layerStyle = this.layerStyles.get(layerKey);
+        if (!layerStyle || layerGroups.get(layerKey)?.visible === false) {
+          continue;
+        }
+        this.setLayerUniforms(this.shaderProgram, layerStyle);
+        drawCalls += this.renderLayerUnbatched(elements, positionLoc);
       }
-
-      drawCalls += this.renderLayer(elements, layerStyle, positionLoc);
     }
 
     // Update statistics
-    this.updateStatistics(visibleElements.length, culledElements, drawCalls);
+    this.updateStatistics(visibleCount, culledElements, drawCalls);
 
     const renderTime = performance.now() - startTime;
     
     if (this.debugMode && culledElements > 0) {
       const cullRate = ((culledElements / totalElements) * 100).toFixed(1);
-      console.log(`🎯 WebGL rendered ${visibleElements.length}/${totalElements} elements ` +
+      console.log(`🎯 WebGL rendered ${visibleCount}/${totalElements} elements ` +
                   `(${cullRate}% culled) in ${renderTime.toFixed(2)}ms`);
     }
   }
@@ -218,10 +271,25 @@ export class WebGLRenderer extends BaseRenderer {
   // View Matrix Creation
   // ========================================================================
 
+  /**
+   * World region shown by a viewport
+   */
+  private viewportToBBox(viewport: Viewport, canvas: RenderCanvas): GDSBBox {
+    const halfWidth = canvas.width / (2 * viewport.zoom);
+    const halfHeight = canvas.height / (2 * viewport.zoom);
+
+    return {
+      minX: viewport.center.x - halfWidth,
+      minY: viewport.center.y - halfHeight,
+      maxX: viewport.center.x + halfWidth,
+      maxY: viewport.center.y + halfHeight
+    };
+  }
+
   /**
    * Creates a view transformation matrix from viewport parameters
    */
-  private createViewMatrix(viewport: Viewport, canvas: HTMLCanvasElement): Float32Array {
+  private createViewMatrix(viewport: Viewport, canvas: RenderCanvas): Float32Array {
     const { center, zoom } = viewport;
     const { width, height } = canvas;
 
@@ -264,63 +332,69 @@ export class WebGLRenderer extends BaseRenderer {
   }
 
   /**
-   * Renders all elements in a layer
+   * Sets the color and opacity of a layer; styles are uniforms, so
+   * changing them does not rebuild geometry
    */
-  private renderLayer(
-    elements: SpatialElement[],
-    style: LayerStyle,
-    positionLoc: number
-  ): number {
-    if (!this.gl || !this.shaderProgram) {
-      return 0;
-    }
-
-    // Set layer color and opacity
+  private setLayerUniforms(program: ShaderProgram, style: LayerStyle): void {
     const color = this.parseColor(style.color);
-    this.shaderProgram.setUniformVec4('u_color', color[0], color[1], color[2], color[3]);
-    this.shaderProgram.setUniformFloat('u_opacity', style.opacity);
+    program.setUniformVec4('u_color', color[0], color[1], color[2], color[3]);
+    program.setUniformFloat('u_opacity', style.opacity);
+  }
 
-    // Use batching if enabled and batch manager available
-    if (this.useBatching && this.batchManager) {
-      return this.renderLayerBatched(elements, style, positionLoc);
-    } else {
-      return this.renderLayerUnbatched(elements, positionLoc);
-    }
+  /**
+   * Draws the hierarchy with one instanced draw call per cell and layer
+   */
+  private renderInstanced(viewMatrix: Float32Array, view: GDSBBox): number {
+    const program = this.instancedProgram;
+    if (!program || !this.instancedScene) return 0;
+
+    program.use();
+    program.setUniformMatrix3fv('u_viewMatrix', viewMatrix);
+
+    const attributes: InstanceAttributes = {
+      position: program.getAttributeLocation('a_position'),
+      instanceX: program.getAttributeLocation('a_instanceX'),
+      instanceY: program.getAttributeLocation('a_instanceY'),
+      instanceOffset: program.getAttributeLocation('a_instanceOffset')
+    };
+
+    const layerGroups = this.sceneGraph.getLayerGroups();
+    return this.instancedScene.render(view, attributes, layerKey => {
+      const style = this.layerStyles.get(layerKey);
+      if (!style || layerGroups.get(layerKey)?.visible === false) {
+        return false;
+      }
+      this.setLayerUniforms(program, style);
+      return true;
+    });
   }
 
   /**
-   * Renders a layer using batching (combines all elements into one draw call)
+   * Renders a layer from its batch; the batch is built from all elements
+   * of the layer once per scene and draws the chunks in view
    */
   private renderLayerBatched(
+    layerKey: string,
     elements: SpatialElement[],
     style: LayerStyle,
-    positionLoc: number
+    positionLoc: number,
+    view: GDSBBox
   ): number {
     if (!this.batchManager) return 0;
 
-    // Filter out non-renderable elements
-    const renderableElements = elements.filter(e => {
-      const type = e.element.type;
-      return type !== 'sref' && type !== 'aref' && type !== 'text';
-    });
-
-    if (renderableElements.length === 0) return 0;
-
-    // Get layer key
-    const layerKey = `${renderableElements[0].element.layer}_${renderableElements[0].element.dataType}`;
-
     // Get or create batch for this layer
     const batch = this.batchManager.getBatch(layerKey, style);
-
-    // Update batch if dirty or elements changed
-    if (batch.isDirty()) {
-      batch.update(renderableElements);
+    if (!batch.hasElements() && batch.isDirty()) {
+      batch.setElements(elements.filter(e => {
+        const type = e.element.type;
+        return type !== 'sref' && type !== 'aref' && type !== 'text';
+      }));
     }
 
-    // Render the batch (single draw call for entire layer)
-    batch.render(positionLoc);
+    // Upload changed chunks only
+    batch.flush();
 
-    return 1; // One draw call for entire layer
+    return batch.render(positionLoc, view);
   }
 
   /**
@@ -357,25 +431,7 @@ export class WebGLRenderer extends BaseRenderer {
       return 0;
     }
 
-    let polygons: any[] = [];
-
-    // Extract polygons based on element type
-    if (element.type === 'boundary') {
-      const boundaryEl = element as GDSBoundaryElement;
-      polygons = boundaryEl.polygons;
-    } else if (element.type === 'path') {
-      const pathEl = element as GDSPathElement;
-      polygons = pathEl.paths;
-    } else if (element.type === 'box') {
-      const boxEl = element as any;
-      if (boxEl.points && boxEl.points.length >= 4) {
-        polygons = [boxEl.points];
-      }
-    } else if (element.type === 'node') {
-      // Skip nodes for now (could render as points)
-      return 0;
-    }
-
+    const polygons = elementPolygons(element);
     if (polygons.length === 0) {
       return 0;
     }
@@ -440,7 +496,53 @@ export class WebGLRenderer extends BaseRenderer {
   }
 
   /**
-   * Invalidates all batches (forces re-triangulation)
+   * Enables or disables instanced drawing of references; without it the
+   * flattened scene is drawn
+   */
+  setInstancingEnabled(enabled: boolean): void {
+    this.useInstancing = enabled;
+    if (enabled) {
+      this.buildInstancedScene();
+    } else {
+      this.instancedScene?.clear();
+    }
+    this.requestRender();
+  }
+
+  /**
+   * Gets instancing statistics, or null when references are not drawn
+   * as instances
+   */
+  getInstancingStats() {
+    if (!this.isInstancing()) {
+      return null;
+    }
+    return this.instancedScene!.getStats();
+  }
+
+  /**
+   * Checks if the current frame is drawn with instancing
+   */
+  private isInstancing(): boolean {
+    return this.useInstancing && this.instancedScene !== null && this.instancedScene.hasInstances();
+  }
+
+  /**
+   * Uploads the cells of the library for instanced drawing; libraries
+   * without references keep the batched path
+   */
+  private buildInstancedScene(): void {
+    if (!this.instancedScene || !this.library || !this.useInstancing) {
+      return;
+    }
+    console.time('Build Instanced Scene');
+    this.instancedScene.build(this.library, 100);
+    console.timeEnd('Build Instanced Scene');
+  }
+
+  /**
+   * Invalidates all batches (forces re-triangulation). Style and
+   * visibility changes do not need this.
    */
   invalidateBatches(): void {
     if (this.batchManager) {
@@ -17,5 +17,7 @@ export {
   QuadTree,
   createQuadTree,
   buildQuadTree,
+  PackedRTree,
+  buildPackedRTree,
   type SpatialElement
 } from './spatial-index';
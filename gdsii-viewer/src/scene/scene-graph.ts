@@ -24,6 +24,8 @@ import {
 import {
   QuadTree,
   createQuadTree,
+  PackedRTree,
+  buildPackedRTree,
   type SpatialElement
 } from './spatial-index';
 
@@ -69,7 +71,9 @@ export interface SceneStatistics {
  * Scene Graph manages spatial organization of GDSII elements
  */
 export class SceneGraph {
-  private spatialIndex: QuadTree | null = null;
+  private spatialIndex: PackedRTree | null = null;
+  // only built to compare against in testCullingEfficiency
+  private quadTree: QuadTree | null = null;
   private layerGroups: Map<string, LayerGroup> = new Map();
   private allElements: SpatialElement[] = [];
   private bounds: GDSBBox = createEmptyBBox();
@@ -167,22 +171,15 @@ export class SceneGraph {
       bounds: libraryBounds
     });
 
-    // Build spatial index
+    // Build spatial index; element ids are indices into allElements
     if (isValidBBox(libraryBounds)) {
-      logger.debug(LogCategory.SPATIAL_INDEX, 'Building QuadTree...');
-      // Add 10% padding to bounds for better edge handling
-      const paddedBounds = this.padBounds(libraryBounds, 1.1);
-      this.spatialIndex = createQuadTree(paddedBounds);
-      
-      logger.debug(LogCategory.SPATIAL_INDEX, 'Inserting elements into QuadTree...');
-      for (const element of allSpatialElements) {
-        this.spatialIndex.insert(element);
-      }
-      logger.info(LogCategory.SPATIAL_INDEX, 'QuadTree built', {
+      logger.debug(LogCategory.SPATIAL_INDEX, 'Building packed R-tree...');
+      this.spatialIndex = buildPackedRTree(allSpatialElements);
+      logger.info(LogCategory.SPATIAL_INDEX, 'Packed R-tree built', {
         elementCount: allSpatialElements.length
       });
     } else {
-      logger.error(LogCategory.SPATIAL_INDEX, 'Cannot build QuadTree: invalid bounds', {
+      logger.error(LogCategory.SPATIAL_INDEX, 'Cannot build spatial index: invalid bounds', {
         bounds: libraryBounds
       });
     }
@@ -205,48 +202,55 @@ export class SceneGraph {
     }
 
     const viewportBBox = this.viewportToBBox(viewport);
-    logger.debug(LogCategory.SPATIAL_INDEX, 'Querying viewport', {
-      viewport,
-      bbox: viewportBBox
-    });
-    
-    const results = this.spatialIndex.query(viewportBBox);
-    
-    // Deduplicate results (QuadTree can return same element multiple times)
-    const uniqueElements = this.deduplicateSpatialElements(results);
-    
+    const results = this.queryRegion(viewportBBox);
+
     logger.debug(LogCategory.SPATIAL_INDEX, 'Viewport query results', {
-      rawCount: results.length,
-      uniqueCount: uniqueElements.length,
-      duplicates: results.length - uniqueElements.length,
+      bbox: viewportBBox,
+      count: results.length,
       totalElements: this.allElements.length
     });
-    
-    return uniqueElements;
+
+    return results;
   }
 
   /**
-   * Queries elements at a specific point (for picking)
+   * Queries the ids of the elements in a rectangular region without
+   * allocating. The ids index getElement() and are in the returned
+   * buffer from 0 to count - 1 until the next query.
    */
-  queryPoint(point: GDSPoint): SpatialElement[] {
+  queryRegionIds(bbox: GDSBBox): { ids: Uint32Array; count: number } {
     if (!this.spatialIndex) {
-      return [];
+      return { ids: new Uint32Array(0), count: 0 };
     }
 
-    const results = this.spatialIndex.queryPoint(point);
-    return this.deduplicateSpatialElements(results);
+    const count = this.spatialIndex.search(bbox.minX, bbox.minY, bbox.maxX, bbox.maxY);
+    return { ids: this.spatialIndex.getResults(), count };
+  }
+
+  /**
+   * Gets the element with an id returned by queryRegionIds()
+   */
+  getElement(id: number): SpatialElement {
+    return this.allElements[id];
+  }
+
+  /**
+   * Queries elements at a specific point (for picking)
+   */
+  queryPoint(point: GDSPoint): SpatialElement[] {
+    return this.queryRegion({ minX: point.x, minY: point.y, maxX: point.x, maxY: point.y });
   }
 
   /**
    * Queries elements in a rectangular region
    */
   queryRegion(bbox: GDSBBox): SpatialElement[] {
-    if (!this.spatialIndex) {
-      return [];
+    const { ids, count } = this.queryRegionIds(bbox);
+    const results: SpatialElement[] = new Array(count);
+    for (let i = 0; i < count; i++) {
+      results[i] = this.allElements[ids[i]];
     }
-
-    const results = this.spatialIndex.query(bbox);
-    return this.deduplicateSpatialElements(results);
+    return results;
   }
 
   /**
@@ -315,30 +319,12 @@ export class SceneGraph {
     };
   }
 
-  /**
-   * Deduplicates spatial elements by creating unique keys
-   * @private
-   */
-  private deduplicateSpatialElements(elements: SpatialElement[]): SpatialElement[] {
-    // Use a Map with a unique key per element to deduplicate
-    const uniqueMap = new Map<string, SpatialElement>();
-    
-    for (const element of elements) {
-      // Create a unique key combining structure name and element index
-      const key = `${element.structureName}_${element.elementIndex}`;
-      if (!uniqueMap.has(key)) {
-        uniqueMap.set(key, element);
-      }
-    }
-    
-    return Array.from(uniqueMap.values());
-  }
-
   /**
    * Clears the scene graph
    */
   clear(): void {
     this.spatialIndex = null;
+    this.quadTree = null;
     this.layerGroups.clear();
     this.allElements = [];
     this.bounds = createEmptyBBox();
@@ -354,14 +340,8 @@ export class SceneGraph {
     }
 
     console.time('Spatial Index Rebuild');
-    
-    const paddedBounds = this.padBounds(this.bounds, 1.1);
-    this.spatialIndex = createQuadTree(paddedBounds);
-
-    for (const element of this.allElements) {
-      this.spatialIndex.insert(element);
-    }
-
+    this.spatialIndex = buildPackedRTree(this.allElements);
+    this.quadTree = null;
     console.timeEnd('Spatial Index Rebuild');
   }
 
@@ -407,6 +387,13 @@ export class SceneGraph {
     return this.library;
   }
 
+  /**
+   * Gets the number of spatial elements without copying them
+   */
+  getElementCount(): number {
+    return this.allElements.length;
+  }
+
   /**
    * Gets all spatial elements
    */
@@ -415,20 +402,48 @@ export class SceneGraph {
   }
 
   /**
-   * Tests culling efficiency for a viewport
+   * Tests culling efficiency for a viewport, comparing the packed R-tree
+   * with a QuadTree over the same elements
    */
   testCullingEfficiency(viewport: Viewport): {
     totalElements: number;
     visibleElements: number;
     cullRate: number;
+    rtree: { queryTime: number; candidates: number; totalNodes: number };
+    quadTree: { queryTime: number; candidates: number; totalNodes: number };
   } {
-    const visibleElements = this.queryViewport(viewport);
-    const cullRate = 1 - (visibleElements.length / this.allElements.length);
+    const bbox = this.viewportToBBox(viewport);
+
+    let start = performance.now();
+    const { count } = this.queryRegionIds(bbox);
+    const rtreeTime = performance.now() - start;
+
+    if (!this.quadTree && isValidBBox(this.bounds)) {
+      this.quadTree = createQuadTree(this.padBounds(this.bounds, 1.1));
+      for (const element of this.allElements) {
+        this.quadTree.insert(element);
+      }
+    }
+
+    // the QuadTree returns elements once per overlapping leaf
+    start = performance.now();
+    const quadResults = this.quadTree ? this.quadTree.query(bbox) : [];
+    const quadTime = performance.now() - start;
 
     return {
       totalElements: this.allElements.length,
-      visibleElements: visibleElements.length,
-      cullRate
+      visibleElements: count,
+      cullRate: this.allElements.length > 0 ? 1 - count / this.allElements.length : 0,
+      rtree: {
+        queryTime: rtreeTime,
+        candidates: count,
+        totalNodes: this.spatialIndex?.getStatistics().totalNodes ?? 0
+      },
+      quadTree: {
+        queryTime: quadTime,
+        candidates: quadResults.length,
+        totalNodes: this.quadTree?.getStatistics().totalNodes ?? 0
+      }
     };
   }
 }
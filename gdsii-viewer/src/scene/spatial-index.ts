@@ -1,8 +1,9 @@
 /**
- * Spatial Index Implementation (QuadTree)
+ * Spatial Index Implementation (QuadTree and packed R-tree)
  * 
  * Provides efficient spatial queries for viewport culling and element picking.
- * Uses a QuadTree data structure to organize elements by their bounding boxes.
+ * The QuadTree organizes element objects by their bounding boxes; the packed
+ * R-tree is bulk loaded into typed arrays and returns element ids.
  */
 
 import type { GDSBBox, GDSElement, GDSPoint } from '../gdsii-types';
@@ -337,3 +338,314 @@ export function buildQuadTree(
 
   return tree;
 }
+
+/**
+ * Static R-tree packed into typed arrays
+ *
+ * The items are sorted along a Hilbert curve and grouped bottom-up into
+ * nodes of nodeSize entries, so the tree is built in O(n log n) without
+ * per-node objects and every item is stored exactly once. Boxes of items
+ * and nodes share one Float64Array (4 values each, items first, root
+ * last). Queries write item ids into a buffer owned by the tree and do not
+ * allocate once the buffers have grown to the largest result.
+ *
+ * Usage: add() every item in id order, finish(), then search().
+ */
+export class PackedRTree {
+  readonly numItems: number;
+  readonly nodeSize: number;
+  private readonly boxes: Float64Array;
+  /** item id for items, position of the first child box for nodes */
+  private readonly indices: Uint32Array;
+  /** end of each level in boxes, items first */
+  private readonly levelBounds: number[];
+  private pos = 0;
+  private minX = Infinity;
+  private minY = Infinity;
+  private maxX = -Infinity;
+  private maxY = -Infinity;
+  private stack = new Uint32Array(64);
+  private results = new Uint32Array(256);
+
+  /**
+   * Creates a tree for a fixed number of items
+   * @param numItems Number of items that will be added
+   * @param nodeSize Entries per node (default: 16)
+   */
+  constructor(numItems: number, nodeSize: number = 16) {
+    this.numItems = numItems;
+    this.nodeSize = Math.min(Math.max(nodeSize, 2), 65535);
+
+    let n = numItems;
+    let numNodes = n;
+    this.levelBounds = [n * 4];
+    do {
+      n = Math.ceil(n / this.nodeSize);
+      numNodes += n;
+      this.levelBounds.push(numNodes * 4);
+    } while (n > 1);
+
+    this.boxes = new Float64Array(numNodes * 4);
+    this.indices = new Uint32Array(numNodes);
+  }
+
+  /**
+   * Adds the next item; its id is the number of items added before
+   */
+  add(minX: number, minY: number, maxX: number, maxY: number): number {
+    const index = this.pos >> 2;
+    this.indices[index] = index;
+    this.boxes[this.pos++] = minX;
+    this.boxes[this.pos++] = minY;
+    this.boxes[this.pos++] = maxX;
+    this.boxes[this.pos++] = maxY;
+
+    if (minX < this.minX) this.minX = minX;
+    if (minY < this.minY) this.minY = minY;
+    if (maxX > this.maxX) this.maxX = maxX;
+    if (maxY > this.maxY) this.maxY = maxY;
+    return index;
+  }
+
+  /**
+   * Sorts the items and builds the nodes
+   */
+  finish(): void {
+    if (this.pos >> 2 !== this.numItems) {
+      throw new Error(`Added ${this.pos >> 2} items instead of ${this.numItems}`);
+    }
+    const boxes = this.boxes;
+
+    if (this.numItems === 0) {
+      return;
+    }
+    if (this.numItems <= this.nodeSize) {
+      // the root holds the items
+      this.indices[this.pos >> 2] = 0;
+      boxes[this.pos++] = this.minX;
+      boxes[this.pos++] = this.minY;
+      boxes[this.pos++] = this.maxX;
+      boxes[this.pos++] = this.maxY;
+      return;
+    }
+
+    // Hilbert value of the center of each item on a 2^16 grid
+    const width = this.maxX - this.minX || 1;
+    const height = this.maxY - this.minY || 1;
+    const hilbertMax = (1 << 16) - 1;
+    const values = new Uint32Array(this.numItems);
+    for (let i = 0, p = 0; i < this.numItems; i++, p += 4) {
+      const x = Math.floor(hilbertMax * ((boxes[p] + boxes[p + 2]) / 2 - this.minX) / width);
+      const y = Math.floor(hilbertMax * ((boxes[p + 1] + boxes[p + 3]) / 2 - this.minY) / height);
+      values[i] = hilbert(x, y);
+    }
+    sortByValue(values, boxes, this.indices, 0, this.numItems - 1, this.nodeSize);
+
+    // each level groups nodeSize entries of the level below
+    for (let i = 0, pos = 0; i < this.levelBounds.length - 1; i++) {
+      const end = this.levelBounds[i];
+      while (pos < end) {
+        const first = pos;
+        let minX = Infinity, minY = Infinity, maxX = -Infinity, maxY = -Infinity;
+        for (let j = 0; j < this.nodeSize && pos < end; j++, pos += 4) {
+          if (boxes[pos] < minX) minX = boxes[pos];
+          if (boxes[pos + 1] < minY) minY = boxes[pos + 1];
+          if (boxes[pos + 2] > maxX) maxX = boxes[pos + 2];
+          if (boxes[pos + 3] > maxY) maxY = boxes[pos + 3];
+        }
+        this.indices[this.pos >> 2] = first;
+        boxes[this.pos++] = minX;
+        boxes[this.pos++] = minY;
+        boxes[this.pos++] = maxX;
+        boxes[this.pos++] = maxY;
+      }
+    }
+  }
+
+  /**
+   * Finds the items whose boxes intersect a range. The ids are in
+   * getResults()[0 ... count-1] until the next search.
+   * @returns Number of items found
+   */
+  search(minX: number, minY: number, maxX: number, maxY: number): number {
+    if (this.pos !== this.boxes.length) {
+      throw new Error('PackedRTree.finish() has not been called');
+    }
+    if (this.numItems === 0) {
+      return 0;
+    }
+
+    const boxes = this.boxes;
+    const itemEnd = this.numItems * 4;
+    let nodeIndex = boxes.length - 4;
+    let level = this.levelBounds.length - 1;
+    let sp = 0;
+    let count = 0;
+
+    for (;;) {
+      // the entries of the node, up to the end of its level
+      const end = Math.min(nodeIndex + this.nodeSize * 4, this.levelBounds[level]);
+      for (let pos = nodeIndex; pos < end; pos += 4) {
+        if (maxX < boxes[pos] || maxY < boxes[pos + 1] ||
+            minX > boxes[pos + 2] || minY > boxes[pos + 3]) {
+          continue;
+        }
+        const index = this.indices[pos >> 2];
+        if (nodeIndex >= itemEnd) {
+          if (sp + 2 > this.stack.length) this.stack = grow(this.stack, sp + 2);
+          this.stack[sp++] = index;
+          this.stack[sp++] = level - 1;
+        } else {
+          if (count === this.results.length) this.results = grow(this.results, count + 1);
+          this.results[count++] = index;
+        }
+      }
+
+      if (sp === 0) {
+        return count;
+      }
+      level = this.stack[--sp];
+      nodeIndex = this.stack[--sp];
+    }
+  }
+
+  /**
+   * Finds the items whose boxes contain a point
+   * @returns Number of items found (ids in getResults())
+   */
+  searchPoint(x: number, y: number): number {
+    return this.search(x, y, x, y);
+  }
+
+  /**
+   * Result buffer of the last search; valid until the next search
+   */
+  getResults(): Uint32Array {
+    return this.results;
+  }
+
+  /**
+   * Gets the bounds of all items
+   */
+  getBounds(): GDSBBox {
+    return { minX: this.minX, minY: this.minY, maxX: this.maxX, maxY: this.maxY };
+  }
+
+  /**
+   * Gets statistics about the tree
+   */
+  getStatistics(): {
+    totalElements: number;
+    totalNodes: number;
+    maxDepth: number;
+    avgElementsPerNode: number;
+    bytes: number;
+  } {
+    const totalNodes = this.indices.length - this.numItems;
+    return {
+      totalElements: this.numItems,
+      totalNodes,
+      maxDepth: this.levelBounds.length - 1,
+      avgElementsPerNode: totalNodes > 0 ? this.numItems / Math.ceil(this.numItems / this.nodeSize) : 0,
+      bytes: this.boxes.byteLength + this.indices.byteLength
+    };
+  }
+}
+
+/**
+ * Position of (x, y) along a Hilbert curve through a 2^16 x 2^16 grid
+ */
+function hilbert(x: number, y: number): number {
+  const n = 1 << 16;
+  let d = 0;
+  for (let s = n >> 1; s > 0; s >>= 1) {
+    const rx = (x & s) > 0 ? 1 : 0;
+    const ry = (y & s) > 0 ? 1 : 0;
+    d += s * s * ((3 * rx) ^ ry);
+    if (ry === 0) {
+      if (rx === 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      const t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
+
+/**
+ * Quicksorts items by value, moving their boxes and ids along. Items
+ * that end up in the same node are left unsorted.
+ */
+function sortByValue(
+  values: Uint32Array,
+  boxes: Float64Array,
+  indices: Uint32Array,
+  left: number,
+  right: number,
+  nodeSize: number
+): void {
+  while (Math.floor(left / nodeSize) < Math.floor(right / nodeSize)) {
+    const pivot = values[(left + right) >> 1];
+    let i = left - 1;
+    let j = right + 1;
+
+    for (;;) {
+      do i++; while (values[i] < pivot);
+      do j--; while (values[j] > pivot);
+      if (i >= j) break;
+      swapItems(values, boxes, indices, i, j);
+    }
+
+    // recurse into the smaller part to bound the stack depth
+    if (j - left < right - j) {
+      sortByValue(values, boxes, indices, left, j, nodeSize);
+      left = j + 1;
+    } else {
+      sortByValue(values, boxes, indices, j + 1, right, nodeSize);
+      right = j;
+    }
+  }
+}
+
+function swapItems(values: Uint32Array, boxes: Float64Array, indices: Uint32Array, i: number, j: number): void {
+  const v = values[i];
+  values[i] = values[j];
+  values[j] = v;
+
+  const a = 4 * i;
+  const b = 4 * j;
+  for (let k = 0; k < 4; k++) {
+    const t = boxes[a + k];
+    boxes[a + k] = boxes[b + k];
+    boxes[b + k] = t;
+  }
+
+  const index = indices[i];
+  indices[i] = indices[j];
+  indices[j] = index;
+}
+
+/**
+ * Returns a copy of a buffer with room for at least n entries
+ */
+function grow(buffer: Uint32Array, n: number): Uint32Array {
+  const grown = new Uint32Array(Math.max(n, 2 * buffer.length));
+  grown.set(buffer);
+  return grown;
+}
+
+/**
+ * Helper function to build a packed R-tree from an array of spatial
+ * elements; the id of an element is its index in the array
+ */
+export function buildPackedRTree(elements: SpatialElement[], nodeSize: number = 16): PackedRTree {
+  const tree = new PackedRTree(elements.length, nodeSize);
+  for (const { bounds } of elements) {
+    tree.add(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+  }
+  tree.finish();
+  return tree;
+}
@@ -0,0 +1,82 @@
+/**
+ * Snapshot Store
+ *
+ * Keeps snapshots of parsed libraries (see gds_save_snapshot) in the
+ * Origin Private File System, keyed by the SHA-256 hash of the GDSII
+ * file, so that reopening a file maps the snapshot instead of parsing it.
+ * Every operation fails soft: without OPFS, or when the quota is
+ * exhausted, the viewer simply parses the file.
+ */
+
+const SNAPSHOT_DIRECTORY = 'gds-snapshots';
+const SNAPSHOT_EXTENSION = '.gdssnap';
+
+/**
+ * Hex SHA-256 hash of a file, used as snapshot key
+ */
+export async function hashFile(data: Uint8Array): Promise<string> {
+  const digest = await crypto.subtle.digest('SHA-256', data);
+  return Array.from(new Uint8Array(digest), b => b.toString(16).padStart(2, '0')).join('');
+}
+
+/**
+ * Snapshot directory, or null when the browser has no OPFS
+ */
+async function snapshotDirectory(): Promise<FileSystemDirectoryHandle | null> {
+  if (typeof navigator === 'undefined' || !navigator.storage?.getDirectory) {
+    return null;
+  }
+  try {
+    const root = await navigator.storage.getDirectory();
+    return await root.getDirectoryHandle(SNAPSHOT_DIRECTORY, { create: true });
+  } catch {
+    return null;
+  }
+}
+
+/**
+ * Reads the snapshot stored for a key, or null
+ */
+export async function readSnapshot(key: string): Promise<Uint8Array | null> {
+  const dir = await snapshotDirectory();
+  if (!dir) {
+    return null;
+  }
+  try {
+    const handle = await dir.getFileHandle(key + SNAPSHOT_EXTENSION);
+    const file = await handle.getFile();
+    return new Uint8Array(await file.arrayBuffer());
+  } catch {
+    return null;
+  }
+}
+
+/**
+ * Stores a snapshot for a key; returns false when it could not be stored
+ */
+export async function writeSnapshot(key: string, snapshot: Uint8Array): Promise<boolean> {
+  const dir = await snapshotDirectory();
+  if (!dir) {
+    return false;
+  }
+  const name = key + SNAPSHOT_EXTENSION;
+  try {
+    const handle = await dir.getFileHandle(name, { create: true });
+    const writable = await handle.createWritable();
+    await writable.write(snapshot);
+    await writable.close();
+    return true;
+  } catch {
+    // a partly written snapshot is rejected on load, but takes space
+    await dir.removeEntry(name).catch(() => undefined);
+    return false;
+  }
+}
+
+/**
+ * Removes the snapshot of a key, e.g. after it failed to load
+ */
+export async function removeSnapshot(key: string): Promise<void> {
+  const dir = await snapshotDirectory();
+  await dir?.removeEntry(key + SNAPSHOT_EXTENSION).catch(() => undefined);
+}
@@ -27,6 +27,7 @@ import type {
 } from './gdsii-types';
 
 import { GDS_RECORD_TYPES } from './gdsii-types';
+import { hashFile, readSnapshot, writeSnapshot, removeSnapshot } from './snapshot-store';
 
 // ============================================================================
 // TYPES AND INTERFACES
@@ -118,15 +119,49 @@ class WASMMemoryError extends WASMError {
 let wasmModule: EnhancedWASMModule | null = null;
 let isInitialized = false;
 
+/**
+ * Build variants of the parser module. The pthreads build parses structures
+ * on worker threads but needs SharedArrayBuffer, which browsers only provide
+ * on cross-origin isolated pages (COOP/COEP headers, see vite.config.ts).
+ */
+interface WASMModuleVariant {
+  script: string;
+  binary: string;
+  exportName: string;
+  threaded: boolean;
+}
+
+const SINGLE_THREAD_MODULE: WASMModuleVariant = {
+  script: '/gds-parser.js',
+  binary: 'gds-parser.wasm',
+  exportName: 'GDSParserModule',
+  threaded: false
+};
+
+const MULTI_THREAD_MODULE: WASMModuleVariant = {
+  script: '/gds-parser-mt.js',
+  binary: 'gds-parser-mt.wasm',
+  exportName: 'GDSParserModuleMT',
+  threaded: true
+};
+
+/**
+ * Whether the page can run the pthreads build
+ */
+const supportsThreads = (): boolean =>
+  typeof SharedArrayBuffer !== 'undefined' &&
+  (globalThis as any).crossOriginIsolated === true;
+
 /**
  * Validates browser environment for WASM execution
  */
 const validateBrowserEnvironment = (): void => {
-  if (typeof window === 'undefined') {
+  // self is the window on pages and the global scope in workers
+  if (typeof self === 'undefined') {
     throw new WASMInitializationError('WASM module loading requires browser environment');
   }
 
-  if (!window.WebAssembly) {
+  if (typeof WebAssembly === 'undefined') {
     throw new WASMInitializationError('WebAssembly is not supported in this browser');
   }
 };
@@ -171,7 +206,7 @@ const attachMemoryViews = (module: any): void => {
   // Let's check if we can access them through the module scope or global scope
 
   // Try to access the internal Emscripten Module object
-  const globalModule = (window as any).Module || module.Module;
+  const globalModule = (globalThis as any).Module || module.Module;
   if (globalModule) {
     console.log('Found Emscripten Module object, checking for memory views...');
 
@@ -482,6 +517,38 @@ const validateMemoryViews = (module: EnhancedWASMModule): void => {
   console.log(`✓ Memory views validated (${buffer.byteLength} bytes)`);
 };
 
+/**
+ * Loads the Emscripten script of a module variant and returns its factory.
+ * Workers have no script elements; there the script is fetched and
+ * evaluated in the global scope instead.
+ */
+async function loadModuleFactory(variant: WASMModuleVariant): Promise<any> {
+  if (typeof document === 'undefined') {
+    const response = await fetch(variant.script);
+    if (!response.ok) {
+      throw new Error(`Failed to fetch ${variant.script}: ${response.status}`);
+    }
+    // indirect eval runs in the global scope, like a classic script
+    (0, eval)(await response.text());
+  } else {
+    await new Promise<void>((resolve, reject) => {
+      const script = document.createElement('script');
+      script.src = variant.script;
+      script.async = true;
+      script.addEventListener('load', () => resolve(), { once: true });
+      script.addEventListener('error', () =>
+        reject(new Error('Failed to load GDS parser WASM module script')), { once: true });
+      document.head.appendChild(script);
+    });
+  }
+
+  const factory = (globalThis as any)[variant.exportName];
+  if (!factory) {
+    throw new Error(`${variant.exportName} not found in global scope`);
+  }
+  return factory;
+}
+
 /**
  * Loads the WASM module with comprehensive error handling
  */
@@ -493,92 +560,68 @@ export async function loadWASMModule(): Promise<EnhancedWASMModule> {
   try {
     validateBrowserEnvironment();
 
-    // Preload the WASM binary to avoid synchronous fetch issues
+    // Preload the WASM binary to avoid synchronous fetch issues; the
+    // pthreads build is used when the page is cross-origin isolated and the
+    // build is deployed, the single-threaded build otherwise
     console.log('Preloading WASM binary...');
-    const wasmResponse = await fetch('/gds-parser.wasm');
+    let variant = supportsThreads() ? MULTI_THREAD_MODULE : SINGLE_THREAD_MODULE;
+    let wasmResponse = await fetch('/' + variant.binary);
+    if (!wasmResponse.ok && variant.threaded) {
+      console.warn('pthreads WASM build not available, using single-threaded build');
+      variant = SINGLE_THREAD_MODULE;
+      wasmResponse = await fetch('/' + variant.binary);
+    }
     if (!wasmResponse.ok) {
       throw new Error(`Failed to fetch WASM binary: ${wasmResponse.status}`);
     }
     const wasmArrayBuffer = await wasmResponse.arrayBuffer();
-    console.log('✓ WASM binary preloaded');
-
-    return new Promise<EnhancedWASMModule>((resolve, reject) => {
-      const script = document.createElement('script');
-      script.src = '/gds-parser.js';
-      script.async = true;
-
-      const handleLoad = async (): Promise<void> => {
-        try {
-          const GDSParserModule = (window as any).GDSParserModule;
-          if (!GDSParserModule) {
-            throw new Error('GDSParserModule not found in global scope');
-          }
-
-          console.log('Loading WASM module with preloaded binary...');
-          // Pass the preloaded WASM binary as a module option
-          // Wait for runtime initialization to ensure memory views are created
-          const module = await new Promise<any>((resolveModule) => {
-            GDSParserModule({
-              wasmBinary: wasmArrayBuffer,
-              locateFile: (path: string) => {
-                if (path.endsWith('.wasm')) {
-                  return 'gds-parser.wasm';
-                }
-                return path;
-              },
-              onRuntimeInitialized: function() {
-                // At this point, Emscripten has called updateMemoryViews()
-                // and HEAP8, HEAPU8, HEAP32, HEAPF64 are available
-                console.log('✓ Emscripten runtime initialized, memory views ready');
-                resolveModule(this);
-              }
-            });
-          });
-          console.log('WASM module loaded successfully');
-
-          // Memory views should now be available - verify
-          if (!module.HEAPU8 || !module.HEAP8 || !module.HEAP32 || !module.HEAPF64) {
-            console.warn('Memory views not found, attempting manual attachment...');
-            attachMemoryViews(module);
-          } else {
-            console.log('✓ Memory views already attached by Emscripten');
+    console.log(`✓ WASM binary preloaded (${variant.threaded ? 'multi-threaded' : 'single-threaded'})`);
+
+    const GDSParserModule = await loadModuleFactory(variant);
+
+    console.log('Loading WASM module with preloaded binary...');
+    // Pass the preloaded WASM binary as a module option
+    // Wait for runtime initialization to ensure memory views are created
+    const module = await new Promise<any>((resolveModule) => {
+      GDSParserModule({
+        wasmBinary: wasmArrayBuffer,
+        // pthread workers load the module script themselves
+        mainScriptUrlOrBlob: variant.script,
+        locateFile: (path: string) => {
+          if (path.endsWith('.wasm')) {
+            return variant.binary;
           }
+          return path;
+        },
+        onRuntimeInitialized: function() {
+          // At this point, Emscripten has called updateMemoryViews()
+          // and HEAP8, HEAPU8, HEAP32, HEAPF64 are available
+          console.log('✓ Emscripten runtime initialized, memory views ready');
+          resolveModule(this);
+        }
+      });
+    });
+    console.log('WASM module loaded successfully');
 
-          // Validate that all required functions are available
-          validateWASMFunctions(module as EnhancedWASMModule);
-
-          // Validate that memory views are properly attached
-          validateMemoryViews(module as EnhancedWASMModule);
-
-          wasmModule = module as EnhancedWASMModule;
-          isInitialized = true;
+    // Memory views should now be available - verify
+    if (!module.HEAPU8 || !module.HEAP8 || !module.HEAP32 || !module.HEAPF64) {
+      console.warn('Memory views not found, attempting manual attachment...');
+      attachMemoryViews(module);
+    } else {
+      console.log('✓ Memory views already attached by Emscripten');
+    }
 
-          console.log('✓ WASM module initialization completed successfully');
-          resolve(wasmModule);
-        } catch (error) {
-          reject(new WASMInitializationError(
-            'Failed to initialize GDS parser WASM module',
-            error instanceof Error ? error : new Error(String(error))
-          ));
-        } finally {
-          cleanup();
-        }
-      };
+    // Validate that all required functions are available
+    validateWASMFunctions(module as EnhancedWASMModule);
 
-      const handleError = (): void => {
-        reject(new WASMInitializationError('Failed to load GDS parser WASM module script'));
-        cleanup();
-      };
+    // Validate that memory views are properly attached
+    validateMemoryViews(module as EnhancedWASMModule);
 
-      const cleanup = (): void => {
-        script.removeEventListener('load', handleLoad);
-        script.removeEventListener('error', handleError);
-      };
+    wasmModule = module as EnhancedWASMModule;
+    isInitialized = true;
 
-      script.addEventListener('load', handleLoad);
-      script.addEventListener('error', handleError);
-      document.head.appendChild(script);
-    });
+    console.log('✓ WASM module initialization completed successfully');
+    return wasmModule;
   } catch (error) {
     throw new WASMInitializationError(
       'Failed to load GDS parser WASM module',
@@ -886,10 +929,137 @@ export function readWASMFloat(ptr: number): number {
 // MAIN PARSING INTERFACE
 // ============================================================================
 
+/**
+ * Options for parseGDSII
+ */
+export interface ParseOptions {
+  /** Called while the structures are parsed, at most once per frame */
+  onProgress?: (parsedStructures: number, totalStructures: number) => void;
+  /** Worker threads for the pthreads build (default: hardware concurrency) */
+  threadCount?: number;
+  /**
+   * Reopen files from stored snapshots of their parsed libraries and store
+   * a snapshot after parsing a new file (default: true)
+   */
+  snapshots?: boolean;
+}
+
+const nextTask = (): Promise<void> => new Promise(resolve => setTimeout(resolve, 0));
+
+/**
+ * Recreates the memory views when the shared memory of the pthreads build
+ * was grown by a worker thread; the views of the main thread keep the old size
+ */
+const refreshMemoryViews = (module: EnhancedWASMModule): void => {
+  const memory = module.wasmMemory;
+  if (!memory || module.HEAPU8.buffer === memory.buffer) {
+    return;
+  }
+  const buffer = memory.buffer;
+  module.HEAPU8 = new Uint8Array(buffer);
+  module.HEAP8 = new Int8Array(buffer);
+  module.HEAP32 = new Int32Array(buffer);
+  module.HEAPF64 = new Float64Array(buffer);
+  module.HEAPF32 = new Float32Array(buffer);
+};
+
+/**
+ * Parses the elements of all structures without blocking the page. The
+ * pthreads build parses on worker threads while this thread only polls the
+ * progress counter; the single-threaded build parses one structure after
+ * the other in time slices between tasks.
+ */
+async function parseStructures(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  options: ParseOptions
+): Promise<void> {
+  const total = module._gds_get_structure_count(libraryPtr);
+  if (total <= 0) {
+    return;
+  }
+
+  const threadCount = options.threadCount ?? (navigator.hardwareConcurrency || 4);
+  const started = module._gds_parse_structures_start
+    ? module._gds_parse_structures_start(libraryPtr, threadCount)
+    : 0;
+
+  if (started > 0 && module._gds_get_parsed_structure_count && module._gds_parse_structures_wait) {
+    let parsed = 0;
+    while (parsed < total) {
+      await nextTask();
+      parsed = module._gds_get_parsed_structure_count(libraryPtr);
+      options.onProgress?.(parsed, total);
+    }
+    if (module._gds_parse_structures_wait(libraryPtr) !== 0) {
+      throw new WASMParsingError('Failed to parse the elements of a structure');
+    }
+    refreshMemoryViews(module);
+    return;
+  }
+
+  const SLICE_MS = 12;
+  let next = 0;
+  while (next < total) {
+    const end = performance.now() + SLICE_MS;
+    while (next < total && performance.now() < end) {
+      module._gds_get_element_count(libraryPtr, next++);
+    }
+    options.onProgress?.(next, total);
+    if (next < total) {
+      await nextTask();
+    }
+  }
+}
+
+/**
+ * Maps the stored snapshot of a file into a library; returns 0 when there
+ * is none or it was written by another build of the module
+ */
+async function loadSnapshot(module: EnhancedWASMModule, key: string): Promise<number> {
+  const snapshot = await readSnapshot(key);
+  if (!snapshot || !module._gds_load_snapshot_begin || !module._gds_load_snapshot_buffer ||
+      !module._gds_load_snapshot_end) {
+    return 0;
+  }
+
+  const libraryPtr = module._gds_load_snapshot_begin(snapshot.length);
+  if (libraryPtr === 0) {
+    return 0;
+  }
+  refreshMemoryViews(module);
+  module.HEAPU8.set(snapshot, module._gds_load_snapshot_buffer(libraryPtr));
+  if (module._gds_load_snapshot_end(libraryPtr) !== 0) {
+    module._gds_free_library(libraryPtr);
+    await removeSnapshot(key);
+    return 0;
+  }
+  return libraryPtr;
+}
+
+/**
+ * Stores the snapshot of a parsed library in the background
+ */
+function saveSnapshot(module: EnhancedWASMModule, libraryPtr: number, key: string): void {
+  if (!module._gds_save_snapshot || !module._gds_get_snapshot_buffer || !module._gds_free_snapshot) {
+    return;
+  }
+
+  const size = module._gds_save_snapshot(libraryPtr);
+  if (size <= 0) {
+    return;
+  }
+  refreshMemoryViews(module);
+  const ptr = module._gds_get_snapshot_buffer(libraryPtr);
+  const snapshot = module.HEAPU8.slice(ptr, ptr + size);
+  module._gds_free_snapshot(libraryPtr);
+  void writeSnapshot(key, snapshot);
+}
+
 /**
  * Parses GDSII data from a Uint8Array with comprehensive error handling
  */
-export async function parseGDSII(data: Uint8Array): Promise<GDSLibrary> {
+export async function parseGDSII(data: Uint8Array, options: ParseOptions = {}): Promise<GDSLibrary> {
   if (!data || data.length === 0) {
     throw new WASMParsingError('No data provided for parsing');
   }
@@ -899,6 +1069,21 @@ export async function parseGDSII(data: Uint8Array): Promise<GDSLibrary> {
   try {
     const module = getWASMModule();
 
+    // a file that was opened before is mapped from its snapshot
+    const key = options.snapshots !== false && module._gds_load_snapshot_begin
+      ? await hashFile(data).catch(() => null)
+      : null;
+    const snapshotPtr = key ? await loadSnapshot(module, key) : 0;
+    if (snapshotPtr !== 0) {
+      try {
+        const total = module._gds_get_structure_count(snapshotPtr);
+        options.onProgress?.(total, total);
+        return extractLibraryData(module, snapshotPtr);
+      } finally {
+        module._gds_free_library(snapshotPtr);
+      }
+    }
+
     // Allocate memory for the data
     const dataPtr = copyArrayToWASM(data);
     memoryContext.free(dataPtr); // Transfer ownership to memory context
@@ -923,11 +1108,18 @@ export async function parseGDSII(data: Uint8Array): Promise<GDSLibrary> {
         throw new WASMParsingError(errorDesc, errorCode);
       }
 
-      // Extract the library data
-      const library = extractLibraryData(module, libraryPtr);
-
-      // Clean up the library
-      module._gds_free_library(libraryPtr);
+      // Parse the structures, then extract the library data
+      let library: GDSLibrary;
+      try {
+        await parseStructures(module, libraryPtr, options);
+        if (key) {
+          saveSnapshot(module, libraryPtr, key);
+        }
+        library = extractLibraryData(module, libraryPtr);
+      } finally {
+        // Clean up the library
+        module._gds_free_library(libraryPtr);
+      }
 
       return library;
     } finally {
@@ -1012,6 +1204,464 @@ function extractLibraryData(module: EnhancedWASMModule, libraryPtr: number): GDS
   };
 }
 
+/**
+ * Packed geometry of a structure (see gds_get_structure_geometry in
+ * wasm-glue/include/gds-wasm-adapter.h). The arrays are views into the
+ * WASM heap; they are valid until the next call into the module.
+ */
+export interface PackedStructureGeometry {
+  elementCount: number;
+  kinds: Int32Array;
+  layers: Int32Array;
+  dataTypes: Int32Array;
+  /** polygons of element k are elementPolygons[k] ... elementPolygons[k+1]-1 */
+  elementPolygons: Int32Array;
+  /** vertices of polygon p are polygonVertices[p] ... polygonVertices[p+1]-1 */
+  polygonVertices: Int32Array;
+  /** interleaved [x1, y1, x2, y2, ...] */
+  vertices: Float32Array;
+  /** [minX, minY, maxX, maxY] per element */
+  bboxes: Float32Array;
+}
+
+// word offsets in the header of the packed geometry buffer
+const GEOM_ELEMENT_COUNT = 0;
+const GEOM_POLYGON_COUNT = 1;
+const GEOM_VERTEX_COUNT = 2;
+const GEOM_KINDS = 3;
+const GEOM_LAYERS = 4;
+const GEOM_DTYPES = 5;
+const GEOM_ELEMENT_POLYGONS = 6;
+const GEOM_POLYGON_VERTICES = 7;
+const GEOM_VERTICES = 8;
+const GEOM_BBOXES = 9;
+
+/**
+ * Reads the geometry of all elements of a structure with one call into
+ * the module. Returns null when the module has no bulk export. When
+ * pathOutlines is set, paths are returned as closed outline polygons.
+ */
+export function readStructureGeometry(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  structureIndex: number,
+  pathOutlines = false
+): PackedStructureGeometry | null {
+  if (typeof module._gds_get_structure_geometry !== 'function' ||
+      typeof module._gds_get_structure_geometry_buffer !== 'function') {
+    return null;
+  }
+
+  const words = module._gds_get_structure_geometry(libraryPtr, structureIndex, pathOutlines ? 1 : 0);
+  const ptr = module._gds_get_structure_geometry_buffer(libraryPtr);
+  if (words < 0) {
+    return null;
+  }
+  return packedGeometryViews(module, ptr);
+}
+
+/**
+ * Views into a packed geometry buffer in the WASM heap
+ */
+function packedGeometryViews(module: EnhancedWASMModule, ptr: number): PackedStructureGeometry | null {
+  if (ptr === 0 || !module.HEAP32 || !module.HEAPF32) {
+    return null;
+  }
+
+  // the int32 and float32 arrays share one buffer of 4-byte words
+  const base = ptr >> 2;
+  const header = module.HEAP32.subarray(base, base + GEOM_BBOXES + 1);
+  const n = header[GEOM_ELEMENT_COUNT];
+  const np = header[GEOM_POLYGON_COUNT];
+  const nv = header[GEOM_VERTEX_COUNT];
+  const ints = (offset: number, count: number) =>
+    module.HEAP32!.subarray(base + header[offset], base + header[offset] + count);
+  const floats = (offset: number, count: number) =>
+    module.HEAPF32!.subarray(base + header[offset], base + header[offset] + count);
+
+  return {
+    elementCount: n,
+    kinds: ints(GEOM_KINDS, n),
+    layers: ints(GEOM_LAYERS, n),
+    dataTypes: ints(GEOM_DTYPES, n),
+    elementPolygons: ints(GEOM_ELEMENT_POLYGONS, n + 1),
+    polygonVertices: ints(GEOM_POLYGON_VERTICES, np + 1),
+    vertices: floats(GEOM_VERTICES, 2 * nv),
+    bboxes: floats(GEOM_BBOXES, 4 * n)
+  };
+}
+
+/** number of level of detail levels per structure (GDS_LOD_LEVELS) */
+const LOD_LEVELS = 32;
+
+/**
+ * Level of detail for a zoom: the coarsest level whose pixel of 2^level
+ * database units is not larger than one screen pixel
+ */
+export function lodLevel(databaseUnitsPerPixel: number): number {
+  if (!(databaseUnitsPerPixel > 1)) return 0;
+  return Math.min(LOD_LEVELS - 1, Math.floor(Math.log2(databaseUnitsPerPixel)));
+}
+
+/**
+ * Reads level of detail `level` of a structure (see gds_get_structure_lod):
+ * packed geometry with polygons below a pixel merged into density tiles
+ * and larger polygons decimated. The module keeps the levels it builds,
+ * so asking again for a level costs one call. Returns null when the
+ * module has no level of detail export.
+ */
+export function readStructureLod(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  structureIndex: number,
+  level: number
+): PackedStructureGeometry | null {
+  if (typeof module._gds_get_structure_lod !== 'function' ||
+      typeof module._gds_get_structure_lod_buffer !== 'function') {
+    return null;
+  }
+
+  const words = module._gds_get_structure_lod(libraryPtr, structureIndex, level);
+  if (words < 0) {
+    return null;
+  }
+  return packedGeometryViews(module, module._gds_get_structure_lod_buffer(libraryPtr));
+}
+
+/**
+ * Bounding box of a structure with all references expanded, or null.
+ * Structures that cover less than a pixel can be drawn as their box.
+ */
+export function readStructureBBox(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  structureIndex: number
+): GDSBBox | null {
+  if (typeof module._gds_get_structure_bbox !== 'function') {
+    return null;
+  }
+
+  const ptr = module._malloc(4 * 8);
+  if (ptr === 0) {
+    return null;
+  }
+  try {
+    if (module._gds_get_structure_bbox(libraryPtr, structureIndex, ptr) !== 0 || !module.HEAPF64) {
+      return null;
+    }
+    const b = module.HEAPF64.subarray(ptr >> 3, (ptr >> 3) + 4);
+    return { minX: b[0], minY: b[1], maxX: b[2], maxY: b[3] };
+  } finally {
+    module._free(ptr);
+  }
+}
+
+/**
+ * Triangles of a structure grouped by (layer, data type), as views into
+ * the WASM heap (see gds_get_structure_triangles)
+ */
+export interface StructureTriangles {
+  layerCount: number;
+  /** layer and data type of each layer, in ascending order */
+  layers: Int32Array;
+  /** vertices of layer l are layerVertices[l] ... layerVertices[l+1]-1 */
+  layerVertices: Int32Array;
+  /** indices of layer l are layerIndices[l] ... layerIndices[l+1]-1 */
+  layerIndices: Int32Array;
+  /** interleaved [x1, y1, x2, y2, ...] */
+  vertices: Float32Array;
+  /** 3 per triangle, relative to the first vertex of the layer */
+  indices: Uint32Array;
+}
+
+// word offsets in the header of the triangle buffer
+const TRI_LAYER_COUNT = 0;
+const TRI_VERTEX_COUNT = 1;
+const TRI_INDEX_COUNT = 2;
+const TRI_LAYERS = 3;
+const TRI_LAYER_VERTICES = 4;
+const TRI_LAYER_INDICES = 5;
+const TRI_VERTICES = 6;
+const TRI_INDICES = 7;
+
+/**
+ * Reads the triangulated layers of a structure. The module triangulates
+ * a structure once and keeps the result, so revisiting a cell costs one
+ * call. The views are only valid until the heap grows; upload them
+ * right away. Returns null when the module has no triangulation export.
+ */
+export function readStructureTriangles(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  structureIndex: number
+): StructureTriangles | null {
+  if (typeof module._gds_get_structure_triangles !== 'function' ||
+      typeof module._gds_get_structure_triangles_buffer !== 'function') {
+    return null;
+  }
+
+  const words = module._gds_get_structure_triangles(libraryPtr, structureIndex);
+  const ptr = module._gds_get_structure_triangles_buffer(libraryPtr);
+  if (words < 0 || ptr === 0 || !module.HEAP32 || !module.HEAPF32 || !module.HEAPU32) {
+    return null;
+  }
+
+  // the int32, float32 and uint32 arrays share one buffer of 4-byte words
+  const base = ptr >> 2;
+  const h = module.HEAP32;
+  const layerCount = h[base + TRI_LAYER_COUNT];
+  const vertexCount = h[base + TRI_VERTEX_COUNT];
+  const indexCount = h[base + TRI_INDEX_COUNT];
+  const at = (k: number) => base + h[base + k];
+
+  return {
+    layerCount,
+    layers: h.subarray(at(TRI_LAYERS), at(TRI_LAYERS) + 2 * layerCount),
+    layerVertices: h.subarray(at(TRI_LAYER_VERTICES), at(TRI_LAYER_VERTICES) + layerCount + 1),
+    layerIndices: h.subarray(at(TRI_LAYER_INDICES), at(TRI_LAYER_INDICES) + layerCount + 1),
+    vertices: module.HEAPF32.subarray(at(TRI_VERTICES), at(TRI_VERTICES) + 2 * vertexCount),
+    indices: module.HEAPU32.subarray(at(TRI_INDICES), at(TRI_INDICES) + indexCount)
+  };
+}
+
+/**
+ * Vertex and index arrays of one layer, ready for
+ * GeometryBuffer.uploadVertices and uploadIndices
+ */
+export function layerTriangles(
+  triangles: StructureTriangles,
+  layer: number
+): { vertices: Float32Array; indices: Uint32Array } {
+  const v = triangles.layerVertices;
+  const i = triangles.layerIndices;
+  return {
+    vertices: triangles.vertices.subarray(2 * v[layer], 2 * v[layer + 1]),
+    indices: triangles.indices.subarray(i[layer], i[layer + 1])
+  };
+}
+
+/**
+ * Copies the views of packed geometry out of the WASM heap
+ */
+function copyStructureGeometry(g: PackedStructureGeometry): PackedStructureGeometry {
+  return {
+    elementCount: g.elementCount,
+    kinds: g.kinds.slice(),
+    layers: g.layers.slice(),
+    dataTypes: g.dataTypes.slice(),
+    elementPolygons: g.elementPolygons.slice(),
+    polygonVertices: g.polygonVertices.slice(),
+    vertices: g.vertices.slice(),
+    bboxes: g.bboxes.slice()
+  };
+}
+
+/**
+ * Instance table of a library (see gds_get_instance_table in
+ * wasm-glue/include/gds-wasm-adapter.h): the SREF and AREF placements of
+ * all structures, one level deep. AREF lattices are kept symbolic. The
+ * arrays are copied out of the WASM heap.
+ */
+export interface InstanceTable {
+  structureCount: number;
+  instanceCount: number;
+  /** instances placed in structure s are structureInstances[s] ... structureInstances[s+1]-1 */
+  structureInstances: Int32Array;
+  /** referenced structure index per instance, -1 if missing */
+  cells: Int32Array;
+  /** element index of the reference in its structure */
+  elements: Int32Array;
+  /** [a11, a21, a12, a22, tx, ty] per instance */
+  transforms: Float32Array;
+  /** [columns, rows] per instance, [1, 1] for SREFs */
+  lattices: Int32Array;
+  /** [colX, colY, rowX, rowY] per instance */
+  steps: Float32Array;
+}
+
+// word offsets in the header of the packed instance table
+const INST_STRUCTURE_COUNT = 0;
+const INST_COUNT = 1;
+const INST_STRUCTURE_INSTANCES = 2;
+const INST_CELLS = 3;
+const INST_ELEMENTS = 4;
+const INST_TRANSFORMS = 5;
+const INST_LATTICES = 6;
+const INST_STEPS = 7;
+
+/**
+ * Reads the instance table of a library with one call into the module.
+ * Returns null when the module has no instance table export.
+ */
+export function readInstanceTable(
+  module: EnhancedWASMModule,
+  libraryPtr: number
+): InstanceTable | null {
+  if (typeof module._gds_get_instance_table !== 'function' ||
+      typeof module._gds_get_instance_table_buffer !== 'function') {
+    return null;
+  }
+
+  const words = module._gds_get_instance_table(libraryPtr);
+  const ptr = module._gds_get_instance_table_buffer(libraryPtr);
+  if (words < 0 || ptr === 0 || !module.HEAP32 || !module.HEAPF32) {
+    return null;
+  }
+
+  const base = ptr >> 2;
+  const header = module.HEAP32.subarray(base, base + INST_STEPS + 1);
+  const ns = header[INST_STRUCTURE_COUNT];
+  const ni = header[INST_COUNT];
+  const ints = (offset: number, count: number) =>
+    module.HEAP32!.slice(base + header[offset], base + header[offset] + count);
+  const floats = (offset: number, count: number) =>
+    module.HEAPF32!.slice(base + header[offset], base + header[offset] + count);
+
+  return {
+    structureCount: ns,
+    instanceCount: ni,
+    structureInstances: ints(INST_STRUCTURE_INSTANCES, ns + 1),
+    cells: ints(INST_CELLS, ni),
+    elements: ints(INST_ELEMENTS, ni),
+    transforms: floats(INST_TRANSFORMS, 6 * ni),
+    lattices: ints(INST_LATTICES, 2 * ni),
+    steps: floats(INST_STEPS, 4 * ni)
+  };
+}
+
+/**
+ * Composes the instance table below a top structure into the placements
+ * of every structure in top coordinates, for instanced drawing of the
+ * geometry of each structure. Returns for each placed structure its
+ * transforms [a11, a21, a12, a22, tx, ty, ...]; the top structure has
+ * the identity. Lattices are expanded here, structure geometry is not
+ * copied. References on cycles are skipped.
+ */
+export function collectInstanceTransforms(
+  table: InstanceTable,
+  top: number,
+  maxDepth = -1
+): Map<number, Float32Array> {
+  const lists = new Map<number, number[]>();
+  const active = new Uint8Array(table.structureCount);
+
+  const place = (s: number, m: number[], depth: number) => {
+    let list = lists.get(s);
+    if (!list) {
+      list = [];
+      lists.set(s, list);
+    }
+    list.push(m[0], m[1], m[2], m[3], m[4], m[5]);
+    if (maxDepth >= 0 && depth >= maxDepth) return;
+
+    active[s] = 1;
+    for (let i = table.structureInstances[s]; i < table.structureInstances[s + 1]; i++) {
+      const child = table.cells[i];
+      if (child < 0 || active[child]) continue;
+
+      const t = table.transforms.subarray(6 * i, 6 * i + 6);
+      // C = M o T, the transform of the instance is applied first
+      const a11 = m[0] * t[0] + m[2] * t[1];
+      const a21 = m[1] * t[0] + m[3] * t[1];
+      const a12 = m[0] * t[2] + m[2] * t[3];
+      const a22 = m[1] * t[2] + m[3] * t[3];
+      const tx = m[0] * t[4] + m[2] * t[5] + m[4];
+      const ty = m[1] * t[4] + m[3] * t[5] + m[5];
+
+      // lattice steps are in the coordinates of s
+      const cols = table.lattices[2 * i];
+      const rows = table.lattices[2 * i + 1];
+      const cx = table.steps[4 * i], cy = table.steps[4 * i + 1];
+      const rx = table.steps[4 * i + 2], ry = table.steps[4 * i + 3];
+      for (let r = 0; r < rows; r++) {
+        for (let c = 0; c < cols; c++) {
+          const dx = c * cx + r * rx;
+          const dy = c * cy + r * ry;
+          place(child, [a11, a21, a12, a22,
+                        tx + m[0] * dx + m[2] * dy,
+                        ty + m[1] * dx + m[3] * dy], depth + 1);
+        }
+      }
+    }
+    active[s] = 0;
+  };
+
+  if (top >= 0 && top < table.structureCount) {
+    place(top, [1, 0, 0, 1, 0, 0], 0);
+  }
+
+  const result = new Map<number, Float32Array>();
+  lists.forEach((list, s) => result.set(s, Float32Array.from(list)));
+  return result;
+}
+
+/**
+ * Returns the polygons of an element in packed geometry
+ */
+function packedPolygons(g: PackedStructureGeometry, elementIndex: number): GDSPoint[][] {
+  const polygons: GDSPoint[][] = [];
+
+  for (let p = g.elementPolygons[elementIndex]; p < g.elementPolygons[elementIndex + 1]; p++) {
+    const polygon: GDSPoint[] = [];
+    for (let j = g.polygonVertices[p]; j < g.polygonVertices[p + 1]; j++) {
+      polygon.push({ x: g.vertices[2 * j], y: g.vertices[2 * j + 1] });
+    }
+    polygons.push(polygon);
+  }
+
+  return polygons;
+}
+
+/**
+ * Extracts a boundary or path element from packed geometry; the
+ * vertices need no further calls into the module.
+ */
+function extractPackedElement(
+  module: EnhancedWASMModule,
+  libraryPtr: number,
+  structureIndex: number,
+  elementIndex: number,
+  lines: PackedStructureGeometry,
+  outlines: PackedStructureGeometry | null
+): GDSElement | null {
+  const kind = mapElementKind(lines.kinds[elementIndex]);
+  if (kind !== 'boundary' && kind !== 'path') {
+    return null;
+  }
+
+  const layer = lines.layers[elementIndex];
+  const dataType = lines.dataTypes[elementIndex];
+  const properties = extractProperties(module, libraryPtr, structureIndex, elementIndex);
+  let element: GDSElement;
+
+  if (kind === 'boundary') {
+    element = {
+      type: 'boundary',
+      layer,
+      dataType,
+      polygons: packedPolygons(lines, elementIndex).filter(p => p.length >= 3),
+      properties
+    };
+  } else {
+    element = {
+      type: 'path',
+      layer,
+      dataType,
+      pathType: module._gds_get_element_path_type(libraryPtr, structureIndex, elementIndex),
+      width: module._gds_get_element_path_width(libraryPtr, structureIndex, elementIndex),
+      beginExtension: module._gds_get_element_path_begin_extension(libraryPtr, structureIndex, elementIndex),
+      endExtension: module._gds_get_element_path_end_extension(libraryPtr, structureIndex, elementIndex),
+      paths: packedPolygons(lines, elementIndex).filter(p => p.length >= 2),
+      outlines: outlines ? packedPolygons(outlines, elementIndex) : undefined,
+      properties
+    };
+  }
+
+  element.elflags = module._gds_get_element_elflags(libraryPtr, structureIndex, elementIndex);
+  element.plex = 0;
+  return element;
+}
+
 /**
  * Extracts structure data from WASM
  */
@@ -1029,9 +1679,18 @@ function extractStructureData(
   let creationDate: GDSDate | undefined;
   let modificationDate: GDSDate | undefined;
 
+  // the views are copied because the next bulk call reuses the buffer and
+  // heap growth during element extraction detaches them
+  const packed = readStructureGeometry(module, libraryPtr, structureIndex, false);
+  const lines = packed ? copyStructureGeometry(packed) : null;
+  const packedOutlines = lines ? readStructureGeometry(module, libraryPtr, structureIndex, true) : null;
+  const outlines = packedOutlines ? copyStructureGeometry(packedOutlines) : null;
+
   for (let i = 0; i < elementCount; i++) {
     try {
-      elements.push(extractElementData(module, libraryPtr, structureIndex, i));
+      const element = lines && lines.elementCount === elementCount ?
+        extractPackedElement(module, libraryPtr, structureIndex, i, lines, outlines) : null;
+      elements.push(element ?? extractElementData(module, libraryPtr, structureIndex, i));
     } catch (error) {
       console.warn(`Failed to extract element ${i} from structure ${structureIndex}:`, error);
       // Continue processing other elements
@@ -1173,6 +1832,9 @@ function extractPathElement(
 ): GDSPathElement {
   const polygonCount = module._gds_get_element_polygon_count(libraryPtr, structureIndex, elementIndex);
   const paths: GDSPoint[][] = [];
+  const outlines: GDSPoint[][] = [];
+  const hasOutlines = typeof module._gds_get_element_path_outline === 'function' &&
+                      typeof module._gds_get_element_path_outline_vertices === 'function';
 
   for (let i = 0; i < polygonCount; i++) {
     const vertexCount = module._gds_get_element_polygon_vertex_count(
@@ -1197,6 +1859,22 @@ function extractPathElement(
         paths.push(path);
       }
     }
+
+    // the path polygon is computed by the same kernel as in the toolbox
+    if (hasOutlines) {
+      const outlineCount = module._gds_get_element_path_outline!(
+        libraryPtr, structureIndex, elementIndex, i
+      );
+      const outlinePtr = module._gds_get_element_path_outline_vertices!(libraryPtr);
+      if (outlineCount > 0 && outlinePtr !== 0) {
+        const vertices = readWASMDoubleArray(outlinePtr, outlineCount * 2);
+        const outline: GDSPoint[] = [];
+        for (let j = 0; j < outlineCount; j++) {
+          outline.push({ x: vertices[j * 2], y: vertices[j * 2 + 1] });
+        }
+        outlines.push(outline);
+      }
+    }
   }
 
   // Extract path-specific properties
@@ -1214,6 +1892,7 @@ function extractPathElement(
     beginExtension: beginExt,
     endExtension: endExt,
     paths,
+    outlines: hasOutlines ? outlines : undefined,
     properties: extractProperties(module, libraryPtr, structureIndex, elementIndex)
   };
 }
@@ -12,6 +12,14 @@ export interface GDSWASMModule {
   // Core Parsing Functions
   // =========================================================================
   _gds_parse_from_memory: (dataPtr: number, size: number, errorCodePtr: number) => number;
+
+  // Snapshots of parsed libraries (optional in older builds)
+  _gds_save_snapshot?: (libraryPtr: number) => number;
+  _gds_get_snapshot_buffer?: (libraryPtr: number) => number;
+  _gds_free_snapshot?: (libraryPtr: number) => void;
+  _gds_load_snapshot_begin?: (size: number) => number;
+  _gds_load_snapshot_buffer?: (libraryPtr: number) => number;
+  _gds_load_snapshot_end?: (libraryPtr: number) => number;
   _gds_free_library: (libraryPtr: number) => void;
 
   // =========================================================================
@@ -52,6 +60,40 @@ export interface GDSWASMModule {
   _gds_get_element_path_type: (libraryPtr: number, structureIndex: number, elementIndex: number) => number;
   _gds_get_element_path_begin_extension: (libraryPtr: number, structureIndex: number, elementIndex: number) => number;
   _gds_get_element_path_end_extension: (libraryPtr: number, structureIndex: number, elementIndex: number) => number;
+  _gds_get_element_path_outline?: (libraryPtr: number, structureIndex: number, elementIndex: number, pathIndex: number) => number;
+  _gds_get_element_path_outline_vertices?: (libraryPtr: number) => number;
+
+  // =========================================================================
+  // Bulk Geometry Export (one packed buffer per structure)
+  // =========================================================================
+  _gds_get_structure_geometry?: (libraryPtr: number, structureIndex: number, pathOutlines: number) => number;
+  _gds_get_structure_geometry_buffer?: (libraryPtr: number) => number;
+
+  // =========================================================================
+  // Instance Table (SREF/AREF placements of all structures)
+  // =========================================================================
+  _gds_get_instance_table?: (libraryPtr: number) => number;
+  _gds_get_instance_table_buffer?: (libraryPtr: number) => number;
+
+  // =========================================================================
+  // Level of Detail (packed geometry per structure and pixel size)
+  // =========================================================================
+  _gds_get_structure_lod?: (libraryPtr: number, structureIndex: number, level: number) => number;
+  _gds_get_structure_lod_buffer?: (libraryPtr: number) => number;
+  _gds_get_structure_bbox?: (libraryPtr: number, structureIndex: number, bboxPtr: number) => number;
+
+  // =========================================================================
+  // Triangulated layers (vertex and index buffers per structure)
+  // =========================================================================
+  _gds_get_structure_triangles?: (libraryPtr: number, structureIndex: number) => number;
+  _gds_get_structure_triangles_buffer?: (libraryPtr: number) => number;
+
+  // =========================================================================
+  // Parallel Parsing (worker threads in the pthreads build)
+  // =========================================================================
+  _gds_parse_structures_start?: (libraryPtr: number, threadCount: number) => number;
+  _gds_get_parsed_structure_count?: (libraryPtr: number) => number;
+  _gds_parse_structures_wait?: (libraryPtr: number) => number;
 
   // =========================================================================
   // Element Access - Text Specific
@@ -96,7 +138,8 @@ export interface GDSWASMModule {
   _gds_validate_library: (libraryPtr: number) => number;
   _gds_get_memory_usage: (totalAllocatedPtr: number, peakUsagePtr: number) => void;
   _gds_get_cache_statistics: (libraryPtr: number, totalStructuresPtr: number,
-    totalElementsPtr: number, memorySizePtr: number) => void;
+    totalElementsPtr: number, memorySizePtr: number,
+    parseStatsPtr: number, parseStatsCount: number) => number;
   _gds_parse_all_elements: (libraryPtr: number) => number;
 
   // =========================================================================
@@ -116,6 +159,7 @@ export interface GDSWASMModule {
   HEAPU32?: Uint32Array;
   HEAPF32?: Float32Array;
   HEAPF64?: Float64Array;
+  wasmMemory?: WebAssembly.Memory;  // pthreads build: shared, growable memory
 
   // =========================================================================
   // Helper Functions (may or may not be present)
@@ -0,0 +1,14 @@
+/**
+ * Worker Module Exports
+ * 
+ * Central export point for the off-main-thread scene pipeline.
+ */
+
+export { SceneWorkerClient } from './scene-worker-client';
+
+export type {
+  SceneLayer,
+  SceneSummary,
+  SceneWorkerRequest,
+  SceneWorkerResponse
+} from './scene-protocol';
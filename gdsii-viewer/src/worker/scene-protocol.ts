@@ -0,0 +1,54 @@
+/**
+ * Scene Worker Protocol
+ *
+ * Messages exchanged between the page and the scene worker. The page sends
+ * the canvas (as an OffscreenCanvas), file contents and input; the worker
+ * owns the WASM module, the flattened hierarchy, the scene graph and the
+ * renderer, and only returns summaries and frame statistics. File contents
+ * are transferred, not copied.
+ */
+
+import type { GDSBBox } from '../gdsii-types';
+import type { Viewport } from '../scene/scene-graph';
+import type { RendererBackend, RenderStatistics } from '../renderer';
+
+/**
+ * Layer of a loaded scene, as shown in the layer list
+ */
+export interface SceneLayer {
+  layer: number;
+  dataType: number;
+  color: string;
+}
+
+/**
+ * Summary of a loaded library; the library itself stays in the worker
+ */
+export interface SceneSummary {
+  name: string;
+  structureCount: number;
+  elementCount: number;
+  bounds: GDSBBox;
+  layers: SceneLayer[];
+}
+
+/**
+ * Messages from the page to the worker. Messages with an id are answered
+ * by a message with the same id.
+ */
+export type SceneWorkerRequest =
+  | { type: 'canvas'; id: number; canvas: OffscreenCanvas; backend: RendererBackend }
+  | { type: 'load'; id: number; data: ArrayBuffer }
+  | { type: 'viewport'; viewport: Viewport }
+  | { type: 'resize'; width: number; height: number }
+  | { type: 'layer-visible'; layer: number; dataType: number; visible: boolean };
+
+/**
+ * Messages from the worker to the page
+ */
+export type SceneWorkerResponse =
+  | { type: 'canvas'; id: number; backend: string }
+  | { type: 'loaded'; id: number; summary: SceneSummary }
+  | { type: 'progress'; id: number; parsed: number; total: number }
+  | { type: 'error'; id: number; message: string }
+  | { type: 'frame'; statistics: RenderStatistics };
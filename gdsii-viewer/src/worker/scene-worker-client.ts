@@ -0,0 +1,160 @@
+/**
+ * Scene Worker Client
+ *
+ * Page side of the scene worker (see scene-worker.ts). Requests that are
+ * answered return promises; viewport changes are posted at most once per
+ * animation frame.
+ */
+
+import type { Viewport } from '../scene/scene-graph';
+import type { RendererBackend, RenderStatistics } from '../renderer';
+import type { SceneSummary, SceneWorkerRequest, SceneWorkerResponse } from './scene-protocol';
+
+interface PendingRequest {
+  resolve: (value: any) => void;
+  reject: (error: Error) => void;
+  onProgress?: (parsed: number, total: number) => void;
+}
+
+export class SceneWorkerClient {
+  private worker: Worker;
+  private nextId = 1;
+  private pending: Map<number, PendingRequest> = new Map();
+  private pendingViewport: Viewport | null = null;
+
+  /** Called with the statistics of every frame drawn by the worker */
+  onFrame: ((statistics: RenderStatistics) => void) | null = null;
+
+  /**
+   * Checks if the browser can render from a worker
+   */
+  static isSupported(): boolean {
+    return typeof Worker !== 'undefined' &&
+      typeof OffscreenCanvas !== 'undefined' &&
+      typeof HTMLCanvasElement !== 'undefined' &&
+      'transferControlToOffscreen' in HTMLCanvasElement.prototype;
+  }
+
+  constructor() {
+    this.worker = new Worker(new URL('./scene-worker.ts', import.meta.url), { type: 'module' });
+    this.worker.onmessage = (event: MessageEvent<SceneWorkerResponse>) => this.handleMessage(event.data);
+    this.worker.onerror = (event: ErrorEvent) => {
+      this.rejectAll(new Error(event.message || 'Scene worker failed'));
+    };
+  }
+
+  /**
+   * Hands a canvas to the worker, which renders into it from then on. A
+   * canvas can be attached only once; returns the backend in use.
+   */
+  attachCanvas(canvas: HTMLCanvasElement, backend: RendererBackend): Promise<string> {
+    const offscreen = canvas.transferControlToOffscreen();
+    return this.request({ type: 'canvas', id: 0, canvas: offscreen, backend }, [offscreen]);
+  }
+
+  /**
+   * Parses a file and builds its scene in the worker. The buffer of data
+   * is transferred and cannot be used afterwards.
+   */
+  load(
+    data: Uint8Array,
+    onProgress?: (parsed: number, total: number) => void
+  ): Promise<SceneSummary> {
+    const buffer = data.byteOffset === 0 && data.byteLength === data.buffer.byteLength
+      ? data.buffer as ArrayBuffer
+      : data.slice().buffer;
+    return this.request({ type: 'load', id: 0, data: buffer }, [buffer], onProgress);
+  }
+
+  /**
+   * Draws a viewport; only the latest viewport of a frame is sent
+   */
+  setViewport(viewport: Viewport): void {
+    const scheduled = this.pendingViewport !== null;
+    this.pendingViewport = { ...viewport, center: { ...viewport.center } };
+    if (scheduled) {
+      return;
+    }
+    requestAnimationFrame(() => {
+      const latest = this.pendingViewport;
+      this.pendingViewport = null;
+      if (latest) {
+        this.post({ type: 'viewport', viewport: latest });
+      }
+    });
+  }
+
+  /**
+   * Resizes the canvas in device pixels
+   */
+  resize(width: number, height: number): void {
+    this.post({ type: 'resize', width, height });
+  }
+
+  /**
+   * Sets the visibility of a layer
+   */
+  setLayerVisible(layer: number, dataType: number, visible: boolean): void {
+    this.post({ type: 'layer-visible', layer, dataType, visible });
+  }
+
+  /**
+   * Stops the worker and rejects the open requests
+   */
+  terminate(): void {
+    this.worker.terminate();
+    this.rejectAll(new Error('Scene worker terminated'));
+  }
+
+  private post(message: SceneWorkerRequest, transfer: Transferable[] = []): void {
+    this.worker.postMessage(message, transfer);
+  }
+
+  private request<T>(
+    message: SceneWorkerRequest & { id: number },
+    transfer: Transferable[],
+    onProgress?: (parsed: number, total: number) => void
+  ): Promise<T> {
+    const id = this.nextId++;
+    message.id = id;
+    return new Promise<T>((resolve, reject) => {
+      this.pending.set(id, { resolve, reject, onProgress });
+      this.post(message, transfer);
+    });
+  }
+
+  private handleMessage(message: SceneWorkerResponse): void {
+    if (message.type === 'frame') {
+      this.onFrame?.(message.statistics);
+      return;
+    }
+
+    const pending = this.pending.get(message.id);
+    if (!pending) {
+      return;
+    }
+
+    switch (message.type) {
+      case 'progress':
+        pending.onProgress?.(message.parsed, message.total);
+        return;
+      case 'canvas':
+        pending.resolve(message.backend);
+        break;
+      case 'loaded':
+        pending.resolve(message.summary);
+        break;
+      case 'error':
+        pending.reject(new Error(message.message));
+        break;
+    }
+    this.pending.delete(message.id);
+  }
+
+  private rejectAll(error: Error): void {
+    for (const pending of this.pending.values()) {
+      pending.reject(error);
+    }
+    this.pending.clear();
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * Scene Worker
+ *
+ * Parses GDSII files, flattens the hierarchy, builds the scene graph and
+ * its spatial index, and renders into an OffscreenCanvas, so that the page
+ * only handles input. Viewport changes are coalesced: only the latest
+ * viewport is drawn once per frame.
+ */
+
+import type { GDSLibrary } from '../gdsii-types';
+import type { Viewport } from '../scene/scene-graph';
+import { parseGDSII, loadWASMModule } from '../wasm-interface';
+import { RendererFactory, type IRenderer, type RendererBackend } from '../renderer';
+import type {
+  SceneLayer,
+  SceneSummary,
+  SceneWorkerRequest,
+  SceneWorkerResponse
+} from './scene-protocol';
+
+let renderer: IRenderer | null = null;
+let canvas: OffscreenCanvas | null = null;
+let library: GDSLibrary | null = null;
+let viewport: Viewport | null = null;
+let frameScheduled = false;
+
+const post = (message: SceneWorkerResponse): void => {
+  (self as any).postMessage(message);
+};
+
+const errorMessage = (error: unknown): string =>
+  error instanceof Error ? error.message : String(error);
+
+/**
+ * Draws the latest viewport at the next frame
+ */
+function scheduleFrame(): void {
+  if (frameScheduled) {
+    return;
+  }
+  frameScheduled = true;
+
+  const frame = (): void => {
+    frameScheduled = false;
+    if (!renderer || !viewport || !canvas) {
+      return;
+    }
+    viewport.width = canvas.width;
+    viewport.height = canvas.height;
+    renderer.render(viewport);
+    post({ type: 'frame', statistics: renderer.getStatistics() });
+  };
+
+  if (typeof requestAnimationFrame !== 'undefined') {
+    requestAnimationFrame(frame);
+  } else {
+    setTimeout(frame, 0);
+  }
+}
+
+/**
+ * Creates the renderer for a canvas; a canvas of the page can only be
+ * transferred once, so switching the backend comes with a new canvas
+ */
+async function attachCanvas(target: OffscreenCanvas, backend: RendererBackend): Promise<string> {
+  renderer?.dispose();
+  renderer = null;
+  canvas = target;
+
+  renderer = await RendererFactory.create(target, {
+    backend,
+    debug: true,
+    preferWebGL: backend !== 'canvas2d'
+  });
+  if (library) {
+    renderer.setLibrary(library);
+  }
+  scheduleFrame();
+  return renderer.getCapabilities().backend;
+}
+
+/**
+ * Parses a file and builds its scene
+ */
+async function load(id: number, data: ArrayBuffer): Promise<SceneSummary> {
+  await loadWASMModule();
+  library = await parseGDSII(new Uint8Array(data), {
+    onProgress: (parsed, total) => post({ type: 'progress', id, parsed, total })
+  });
+
+  if (!renderer) {
+    throw new Error('No canvas attached to the scene worker');
+  }
+  renderer.clearScene();
+  renderer.setLibrary(library);
+  scheduleFrame();
+
+  const sceneGraph = renderer.getSceneGraph();
+  const layers: SceneLayer[] = [];
+  for (const group of sceneGraph.getLayerGroups().values()) {
+    const style = renderer.getLayerStyle(group.layer, group.dataType);
+    layers.push({ layer: group.layer, dataType: group.dataType, color: style?.color ?? group.color });
+  }
+  layers.sort((a, b) => a.layer - b.layer || a.dataType - b.dataType);
+
+  return {
+    name: library.name,
+    structureCount: library.structures.length,
+    elementCount: library.structures.reduce((sum, s) => sum + s.elements.length, 0),
+    bounds: sceneGraph.getBounds(),
+    layers
+  };
+}
+
+self.onmessage = async (event: MessageEvent<SceneWorkerRequest>) => {
+  const request = event.data;
+
+  switch (request.type) {
+    case 'canvas':
+      try {
+        const backend = await attachCanvas(request.canvas, request.backend);
+        post({ type: 'canvas', id: request.id, backend });
+      } catch (error) {
+        post({ type: 'error', id: request.id, message: errorMessage(error) });
+      }
+      break;
+
+    case 'load':
+      try {
+        const summary = await load(request.id, request.data);
+        post({ type: 'loaded', id: request.id, summary });
+      } catch (error) {
+        post({ type: 'error', id: request.id, message: errorMessage(error) });
+      }
+      break;
+
+    case 'viewport':
+      viewport = request.viewport;
+      scheduleFrame();
+      break;
+
+    case 'resize':
+      if (canvas) {
+        canvas.width = request.width;
+        canvas.height = request.height;
+        scheduleFrame();
+      }
+      break;
+
+    case 'layer-visible':
+      renderer?.setLayerVisible(request.layer, request.dataType, request.visible);
+      scheduleFrame();
+      break;
+  }
+};
@@ -26,6 +26,10 @@ export default defineConfig({
       }
     }
   },
+  worker: {
+    // the scene worker is created as a module worker
+    format: 'es'
+  },
   assetsInclude: ['**/*.wasm'],
   optimizeDeps: {
     // Exclude WASM from optimization
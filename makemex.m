@@ -17,18 +17,43 @@ if ~(exist('OCTAVE_VERSION')==5)
     fprintf('Compiling mex functions for low-level i/o on MATLAB ...\n');
 
     cd Basic/gdsio
-    mex -O gds_open.c mexfuncs.c
+    if isunix  % gzip compressed libraries
+        mex -O -DHAVE_ZLIB gds_open.c gdsstream.c oasis.c refgraph.c gdsio.c mexfuncs.c -lz
+    else
+        mex -O gds_open.c gdsstream.c oasis.c refgraph.c gdsio.c mexfuncs.c
+    end
     mex -O gds_close.c mexfuncs.c
     mex -O gds_ftell.c mexfuncs.c
+    mex -O gds_fseek.c mexfuncs.c
     mex -O gds_structdata.c gdsio.c mexfuncs.c 
     mex -O gds_libdata.c gdsio.c mexfuncs.c
     mex -O gds_beginstruct.c gdsio.c mexfuncs.c
     mex -O gds_endstruct.c gdsio.c mexfuncs.c
     mex -O gds_beginlib.c gdsio.c mexfuncs.c
     mex -O gds_endlib.c gdsio.c mexfuncs.c
-    mex -O gds_write_element.c gdsio.c mexfuncs.c
-    mex -O gds_read_element.c gdsio.c mexfuncs.c mxlist.c
+    mex -O gds_write_element.c elwrite.c elgather.c mexfuncs.c
+    mex -O gds_read_element.c elread.c mapio.c gdsio.c mexfuncs.c
+    mex -O gds_read_library_mex.c elread.c flatten.c pathpoly.c layerstats.c mapio.c gdsio.c mexfuncs.c
     mex -O gds_record_info.c gdsio.c mexfuncs.c
+    mex -O gds_flatten_mex.c flatlib.c flatten.c pathpoly.c mexfuncs.c
+    mex -O gds_refgraph_mex.c refgraph.c
+    mex -O gds_polystats_mex.c polystats.c
+    mex -O gds_pathpoly_mex.c pathpoly.c
+    mex -O gds_poly_convert_mex.c polyconv.c pathpoly.c mexfuncs.c
+    mex -O gds_stl_mex.c stlwrite.c triangulate.c
+    mex -O gds_step_mex.c stepwrite.c
+    mex -O gds_cgdsconv_mex.c cgdsconv.c mexfuncs.c
+    mex -O gds_aref_compress_mex.c arefcomp.c mexfuncs.c
+    mex -O gds_stats.c
+    if isunix
+        mex -O -DHAVE_ZLIB gds_library_index.c libindex.c refgraph.c mapio.c gdsstream.c oasis.c gdsio.c mexfuncs.c -lz
+        mex -O -DHAVE_ZLIB gds_merge_mex.c gdsmerge.c libindex.c refgraph.c mapio.c gdsio.c gdsstream.c oasis.c mexfuncs.c -lz
+        mex -O -DHAVE_ZLIB gds_write_structures_mex.c elwrite.c elgather.c spancopy.c gdsio.c gdsstream.c oasis.c refgraph.c mexfuncs.c -lz
+    else
+        mex -O gds_library_index.c libindex.c refgraph.c mapio.c gdsstream.c oasis.c gdsio.c mexfuncs.c
+        mex -O gds_merge_mex.c gdsmerge.c libindex.c refgraph.c mapio.c gdsio.c gdsstream.c oasis.c mexfuncs.c
+        mex -O gds_write_structures_mex.c elwrite.c elgather.c spancopy.c gdsio.c gdsstream.c oasis.c refgraph.c mexfuncs.c
+    end
 
     cd ../@gds_element/private
     mex -O poly_iscwmex.c
@@ -40,16 +65,29 @@ if ~(exist('OCTAVE_VERSION')==5)
     mex -O -I../../gdsio has_property.c
     mex -O -I../../gdsio get_element_data.c ../../gdsio/mexfuncs.c
     mex -O -I../../gdsio set_element_data.c ../../gdsio/mexfuncs.c
+    mex -O -I../../gdsio decode_raw.c ../../gdsio/elread.c ../../gdsio/mapio.c ../../gdsio/gdsio.c ../../gdsio/mexfuncs.c
+
+    cd ../../@gds_structure/private
+    mex -O rtreemex.c
+
+    cd ../../@gds_library/private
+    mex -O -I../../gdsio namehashmex.c ../../gdsio/refgraph.c
 
     cd ../../../Structures/private
     mex -O datamatrixmex.c
+    mex -O bitmapmex.c bmrect.c
+    mex -O zonelensmex.c zonegen.c
+    mex -O -I../../Basic/gdsio zonewritemex.c zonegen.c ../../Basic/gdsio/elwrite.c ../../Basic/gdsio/gdsio.c ../../Basic/gdsio/mexfuncs.c
 
     % Boolean functions
     fprintf('Compiling Boolean set algebra functions (Clipper)...\n');
 
     % for Clipper library
     cd ../../Boolean
-    mex -O poly_boolmex.cpp clipper.cpp
+    mex -O -I../Basic/gdsio poly_boolmex.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/mexfuncs.c
+    mex -O poly_offsetmex.cpp clipmex.cpp clipper.cpp polytiles.cpp
+    mex -O -I../Basic/gdsio poly_densitymex.cpp polydensity.cpp clipper.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
+    mex -O -I../Basic/gdsio layout_diffmex.cpp layoutdiff.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
 
     % back up
     cd ..
@@ -63,18 +101,33 @@ else % we are on Octave with gcc
     setenv('CXXFLAGS', '-O3 -fomit-frame-pointer -march=native -mtune=native');
 
     cd Basic/gdsio
-    mex gds_open.c mexfuncs.c
+    mex gds_open.c gdsstream.c oasis.c refgraph.c gdsio.c mexfuncs.c
     mex gds_close.c mexfuncs.c
     mex gds_ftell.c mexfuncs.c
+    mex gds_fseek.c mexfuncs.c
     mex gds_structdata.c gdsio.c mexfuncs.c 
     mex gds_libdata.c gdsio.c mexfuncs.c
     mex gds_beginstruct.c gdsio.c mexfuncs.c
     mex gds_endstruct.c gdsio.c mexfuncs.c
     mex gds_beginlib.c gdsio.c mexfuncs.c
     mex gds_endlib.c gdsio.c mexfuncs.c
-    mex gds_write_element.c gdsio.c mexfuncs.c
-    mex gds_read_element.c gdsio.c mexfuncs.c mxlist.c
+    mex gds_write_element.c elwrite.c elgather.c mexfuncs.c
+    mex gds_write_structures_mex.c elwrite.c elgather.c spancopy.c gdsio.c gdsstream.c oasis.c refgraph.c mexfuncs.c
+    mex gds_read_element.c elread.c mapio.c gdsio.c mexfuncs.c
+    mex gds_read_library_mex.c elread.c flatten.c pathpoly.c layerstats.c mapio.c gdsio.c mexfuncs.c
     mex gds_record_info.c gdsio.c mexfuncs.c
+    mex gds_flatten_mex.c flatlib.c flatten.c pathpoly.c mexfuncs.c
+    mex gds_refgraph_mex.c refgraph.c
+    mex gds_polystats_mex.c polystats.c
+    mex gds_pathpoly_mex.c pathpoly.c
+    mex gds_poly_convert_mex.c polyconv.c pathpoly.c mexfuncs.c
+    mex gds_stl_mex.c stlwrite.c triangulate.c
+    mex gds_step_mex.c stepwrite.c
+    mex gds_cgdsconv_mex.c cgdsconv.c mexfuncs.c
+    mex gds_aref_compress_mex.c arefcomp.c mexfuncs.c
+    mex gds_stats.c
+    mex gds_library_index.c libindex.c refgraph.c mapio.c gdsstream.c oasis.c gdsio.c mexfuncs.c
+    mex gds_merge_mex.c gdsmerge.c libindex.c refgraph.c mapio.c gdsio.c gdsstream.c oasis.c mexfuncs.c
 
     cd ../@gds_element/private
     mex poly_iscwmex.c
@@ -86,16 +139,29 @@ else % we are on Octave with gcc
     mex -I../../gdsio has_property.c
     mex -I../../gdsio get_element_data.c ../../gdsio/mexfuncs.c
     mex -I../../gdsio set_element_data.c ../../gdsio/mexfuncs.c
+    mex -I../../gdsio decode_raw.c ../../gdsio/elread.c ../../gdsio/mapio.c ../../gdsio/gdsio.c ../../gdsio/mexfuncs.c
+
+    cd ../../@gds_structure/private
+    mex rtreemex.c
+
+    cd ../../@gds_library/private
+    mex -I../../gdsio namehashmex.c ../../gdsio/refgraph.c
 
     cd ../../../Structures/private
     mex datamatrixmex.c
+    mex bitmapmex.c bmrect.c
+    mex zonelensmex.c zonegen.c
+    mex -I../../Basic/gdsio zonewritemex.c zonegen.c ../../Basic/gdsio/elwrite.c ../../Basic/gdsio/gdsio.c ../../Basic/gdsio/mexfuncs.c
     
     % Boolean functions
     fprintf('Compiling Boolean set algebra functions (Clipper)...\n');
     
     % for Clipper library
     cd ../../Boolean
-    mex poly_boolmex.cpp clipper.cpp
+    mex -I../Basic/gdsio poly_boolmex.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/mexfuncs.c
+    mex poly_offsetmex.cpp clipmex.cpp clipper.cpp polytiles.cpp
+    mex -I../Basic/gdsio poly_densitymex.cpp polydensity.cpp clipper.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
+    mex -I../Basic/gdsio layout_diffmex.cpp layoutdiff.cpp clipmex.cpp clipper.cpp polytiles.cpp ../Basic/gdsio/flatlib.c ../Basic/gdsio/flatten.c ../Basic/gdsio/pathpoly.c
     
     % back up
     cd ..
@@ -9,13 +9,19 @@ SOURCES=(
   "$SCRIPT_DIR/src/gds-wasm-adapter.c"
   "$SCRIPT_DIR/src/wasm-element-cache.c"
   "$SCRIPT_DIR/src/wasm-memory-manager.c"
+  "$PROJECT_ROOT/Basic/gdsio/flatten.c"
+  "$PROJECT_ROOT/Basic/gdsio/pathpoly.c"
+  "$PROJECT_ROOT/Basic/gdsio/triangulate.c"
 )
 
-EXPORTED_FUNCTIONS='[_malloc,_free,_gds_parse_from_memory,_gds_free_library,_gds_get_library_name,_gds_get_user_units_per_db_unit,_gds_get_meters_per_db_unit,_gds_get_structure_count,_gds_get_structure_name,_gds_get_library_creation_date,_gds_get_library_modification_date,_gds_get_element_count,_gds_get_element_type,_gds_get_element_layer,_gds_get_element_data_type,_gds_get_element_elflags,_gds_get_element_plex,_gds_get_element_polygon_count,_gds_get_element_polygon_vertex_count,_gds_get_element_polygon_vertices,_gds_get_element_path_width,_gds_get_element_path_type,_gds_get_element_path_begin_extension,_gds_get_element_path_end_extension,_gds_get_element_text,_gds_get_element_text_position,_gds_get_element_text_type,_gds_get_element_text_presentation,_gds_get_element_reference_name,_gds_get_element_array_columns,_gds_get_element_array_rows,_gds_get_element_reference_corners,_gds_get_element_strans_flags,_gds_get_element_magnification,_gds_get_element_rotation_angle,_gds_get_element_property_count,_gds_get_element_property_attribute,_gds_get_element_property_value,_gds_get_last_error,_gds_clear_error,_gds_validate_library,_gds_get_memory_usage]'
+EXPORTED_FUNCTIONS='[_malloc,_free,_gds_parse_from_memory,_gds_stream_begin,_gds_stream_reserve,_gds_stream_commit,_gds_stream_end,_gds_save_snapshot,_gds_get_snapshot_buffer,_gds_free_snapshot,_gds_load_snapshot_begin,_gds_load_snapshot_buffer,_gds_load_snapshot_end,_gds_free_library,_gds_get_library_name,_gds_get_user_units_per_db_unit,_gds_get_meters_per_db_unit,_gds_get_structure_count,_gds_get_structure_name,_gds_get_library_creation_date,_gds_get_library_modification_date,_gds_get_element_count,_gds_get_element_type,_gds_get_element_layer,_gds_get_element_data_type,_gds_get_element_elflags,_gds_get_element_plex,_gds_get_element_polygon_count,_gds_get_element_polygon_vertex_count,_gds_get_element_polygon_vertices,_gds_get_element_path_width,_gds_get_element_path_type,_gds_get_element_path_begin_extension,_gds_get_element_path_end_extension,_gds_get_element_path_outline,_gds_get_element_path_outline_vertices,_gds_get_element_text,_gds_get_element_text_position,_gds_get_element_text_type,_gds_get_element_text_presentation,_gds_get_element_reference_name,_gds_get_element_array_columns,_gds_get_element_array_rows,_gds_get_element_reference_corners,_gds_get_element_strans_flags,_gds_get_element_magnification,_gds_get_element_rotation_angle,_gds_get_element_property_count,_gds_get_element_property_attribute,_gds_get_element_property_value,_gds_flatten_structure,_gds_get_flat_layer_count,_gds_get_flat_layer,_gds_get_flat_data_type,_gds_get_flat_vertex_count,_gds_get_flat_vertices,_gds_get_flat_polygon_count,_gds_get_flat_polygon_sizes,_gds_get_flat_instance_count,_gds_free_flat_result,_gds_get_structure_geometry,_gds_get_structure_geometry_buffer,_gds_get_instance_table,_gds_get_instance_table_buffer,_gds_get_structure_lod,_gds_get_structure_lod_buffer,_gds_get_structure_bbox,_gds_get_structure_triangles,_gds_get_structure_triangles_buffer,_gds_parse_structures_start,_gds_get_parsed_structure_count,_gds_parse_structures_wait,_gds_get_last_error,_gds_clear_error,_gds_validate_library,_gds_get_memory_usage,_gds_get_cache_statistics]'
 
-COMMON="-s WASM=1 -s ALLOW_MEMORY_GROWTH=1 -s MODULARIZE=1 -s ENVIRONMENT='web' -s FILESYSTEM=0 -s EXPORTED_RUNTIME_METHODS=['ccall','cwrap','getValue','setValue','UTF8ToString','stringToUTF8','writeArrayToMemory'] -s EXPORTED_FUNCTIONS=$EXPORTED_FUNCTIONS"
+COMMON="-msimd128 -s WASM=1 -s ALLOW_MEMORY_GROWTH=1 -s MODULARIZE=1 -s ENVIRONMENT='web' -s FILESYSTEM=0 -s EXPORTED_RUNTIME_METHODS=['ccall','cwrap','getValue','setValue','UTF8ToString','stringToUTF8','writeArrayToMemory'] -s EXPORTED_FUNCTIONS=$EXPORTED_FUNCTIONS"
 RELEASE_FLAGS="-O3 -flto -s WASM_ASYNC_COMPILATION=0 -s ASSERTIONS=0 -s STACK_SIZE=2097152 -s INITIAL_MEMORY=67108864"
-DEBUG_FLAGS="-O1 -g4 --source-map-base http://localhost:3000/ -s ASSERTIONS=1 -s STACK_SIZE=4194304 -s INITIAL_MEMORY=134217728"
+# pthreads variant: needs SharedArrayBuffer, i.e. a cross-origin isolated page
+# (COOP/COEP headers); the viewer falls back to the release module otherwise
+THREAD_FLAGS="-O3 -flto -pthread -DWASM_THREADS -s ENVIRONMENT='web,worker' -s PTHREAD_POOL_SIZE=navigator.hardwareConcurrency -s ASSERTIONS=0 -s STACK_SIZE=2097152 -s INITIAL_MEMORY=268435456 -s MAXIMUM_MEMORY=4294967296 -s EXPORTED_RUNTIME_METHODS=['ccall','cwrap','getValue','setValue','UTF8ToString','stringToUTF8','writeArrayToMemory','wasmMemory']"
+DEBUG_FLAGS="-O1 -g4 -DGDS_STATS --source-map-base http://localhost:3000/ -s ASSERTIONS=1 -s STACK_SIZE=4194304 -s INITIAL_MEMORY=134217728"
 
 mkdir -p "$OUTPUT_DIR"
 
@@ -27,6 +33,13 @@ case "${1:-release}" in
       --pre-js "$SCRIPT_DIR/src/pre.js" \
       --post-js "$SCRIPT_DIR/src/post.js"
     ;;
+  threads)
+    emcc "${SOURCES[@]}" "${INCLUDES[@]}" -o "$OUTPUT_DIR/gds-parser-mt.js" \
+      $COMMON $THREAD_FLAGS \
+      -s EXPORT_NAME="'GDSParserModuleMT'" \
+      --pre-js "$SCRIPT_DIR/src/pre.js" \
+      --post-js "$SCRIPT_DIR/src/post.js"
+    ;;
   debug)
     emcc "${SOURCES[@]}" "${INCLUDES[@]}" -o "$OUTPUT_DIR/gds-parser-debug.js" \
       $COMMON $DEBUG_FLAGS \
@@ -35,10 +48,11 @@ case "${1:-release}" in
     ;;
   clean)
     rm -f "$OUTPUT_DIR/gds-parser.js" "$OUTPUT_DIR/gds-parser.wasm" \
-          "$OUTPUT_DIR/gds-parser-debug.js" "$OUTPUT_DIR/gds-parser-debug.wasm"
+          "$OUTPUT_DIR/gds-parser-debug.js" "$OUTPUT_DIR/gds-parser-debug.wasm" \
+          "$OUTPUT_DIR/gds-parser-mt.js" "$OUTPUT_DIR/gds-parser-mt.wasm"
     ;;
   *)
-    echo "Usage: $0 [release|debug|clean]" >&2
+    echo "Usage: $0 [release|threads|debug|clean]" >&2
     exit 1
     ;;
 esac
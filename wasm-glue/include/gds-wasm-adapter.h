@@ -20,6 +20,34 @@ extern "C" {
 // Main parsing function - returns library pointer or 0 on error
 void* gds_parse_from_memory(uint8_t* data, size_t size, int* error_code);
 
+// Streaming ingestion. gds_stream_begin creates an empty library that owns
+// its file buffer (size_hint: expected file size or 0). Each chunk is
+// written to the room returned by gds_stream_reserve (valid until the next
+// call) and appended with gds_stream_commit, which returns the number of
+// complete structures so far, or -1 on error. Complete structures can be
+// accessed while the stream continues; gds_stream_end returns 0 when the
+// whole library has arrived. The library is released with gds_free_library.
+void* gds_stream_begin(size_t size_hint);
+uint8_t* gds_stream_reserve(void* library_ptr, size_t size);
+int gds_stream_commit(void* library_ptr, size_t size);
+int gds_stream_end(void* library_ptr);
+
+// Snapshots of parsed libraries, for reopening a file without parsing it.
+// gds_save_snapshot parses all structures and writes the snapshot to a
+// buffer kept by the library until gds_free_snapshot or gds_free_library;
+// it returns the snapshot size in bytes or -1 on error. To load a snapshot,
+// gds_load_snapshot_begin creates a library for a snapshot of the given
+// size, the snapshot is written to gds_load_snapshot_buffer, and
+// gds_load_snapshot_end maps it in place; it returns 0, or -1 when the
+// snapshot is invalid or was written by another build, in which case the
+// library is released with gds_free_library and the file is parsed.
+int gds_save_snapshot(void* library_ptr);
+uint8_t* gds_get_snapshot_buffer(void* library_ptr);
+void gds_free_snapshot(void* library_ptr);
+void* gds_load_snapshot_begin(size_t size);
+uint8_t* gds_load_snapshot_buffer(void* library_ptr);
+int gds_load_snapshot_end(void* library_ptr);
+
 // Library management (using existing gds_libdata infrastructure)
 void gds_free_library(void* library_ptr);
 const char* gds_get_library_name(void* library_ptr);
@@ -57,6 +85,12 @@ uint16_t gds_get_element_path_type(void* library_ptr, int structure_index, int e
 float gds_get_element_path_begin_extension(void* library_ptr, int structure_index, int element_index);
 float gds_get_element_path_end_extension(void* library_ptr, int structure_index, int element_index);
 
+// Path outlines (Basic/gdsio/pathpoly.h). Converts path segment path_index of
+// a path element to a closed polygon and returns its number of vertices, or 0.
+// The vertices [x1, y1, x2, y2, ...] are valid until the next call.
+int gds_get_element_path_outline(void* library_ptr, int structure_index, int element_index, int path_index);
+double* gds_get_element_path_outline_vertices(void* library_ptr);
+
 // Text-specific data (from element_t text_data)
 const char* gds_get_element_text(void* library_ptr, int structure_index, int element_index);
 void gds_get_element_text_position(void* library_ptr, int structure_index, int element_index, float* x, float* y);
@@ -80,6 +114,138 @@ int gds_get_element_property_count(void* library_ptr, int structure_index, int e
 uint16_t gds_get_element_property_attribute(void* library_ptr, int structure_index, int element_index, int property_index);
 const char* gds_get_element_property_value(void* library_ptr, int structure_index, int element_index, int property_index);
 
+// Hierarchy flattening (Basic/gdsio/flatten.h). Flattens a structure into one
+// vertex buffer per (layer, data type); returns the number of layers or -1.
+// window is NULL or [llx, lly, urx, ury]; kinds is a bit mask of element
+// kinds (1 << GDS_BOUNDARY, ...), 0 for all. Paths are returned as closed
+// polygons (see gds_get_element_path_outline). The result is kept until the
+// next call, gds_free_flat_result, or gds_free_library.
+int gds_flatten_structure(void* library_ptr, int structure_index, int max_depth,
+                          const double* window, unsigned int kinds);
+int gds_get_flat_layer_count(void* library_ptr);
+int gds_get_flat_layer(void* library_ptr, int layer_index);
+int gds_get_flat_data_type(void* library_ptr, int layer_index);
+int gds_get_flat_vertex_count(void* library_ptr, int layer_index);
+double* gds_get_flat_vertices(void* library_ptr, int layer_index);
+int gds_get_flat_polygon_count(void* library_ptr, int layer_index);
+uint32_t* gds_get_flat_polygon_sizes(void* library_ptr, int layer_index);
+int gds_get_flat_instance_count(void* library_ptr);
+void gds_free_flat_result(void* library_ptr);
+
+// Bulk geometry export. Packs the geometry of all elements of a structure
+// into one buffer of 4-byte words that JS can read through HEAP32/HEAPF32
+// views without further calls. The buffer starts with GDS_GEOM_HEADER_WORDS
+// words: counts and the word offsets of the arrays below (struct of arrays).
+//   kinds, layers, dtypes   int32 per element
+//   element_polygons        int32, n+1 entries; polygons of element k are
+//                           element_polygons[k] ... element_polygons[k+1]-1
+//   polygon_vertices        int32, P+1 entries; vertex offsets of polygon p
+//   vertices                float32 [x1, y1, x2, y2, ...], V vertices
+//   bboxes                  float32 [min_x, min_y, max_x, max_y] per element
+// Text and reference elements have no polygons. When path_outlines is set,
+// paths are returned as closed polygons (see gds_get_element_path_outline)
+// instead of center lines. Returns the buffer size in words, or -1 on error;
+// the buffer is valid until the next call or gds_free_library.
+#define GDS_GEOM_ELEMENT_COUNT     0
+#define GDS_GEOM_POLYGON_COUNT     1
+#define GDS_GEOM_VERTEX_COUNT      2
+#define GDS_GEOM_KINDS             3
+#define GDS_GEOM_LAYERS            4
+#define GDS_GEOM_DTYPES            5
+#define GDS_GEOM_ELEMENT_POLYGONS  6
+#define GDS_GEOM_POLYGON_VERTICES  7
+#define GDS_GEOM_VERTICES          8
+#define GDS_GEOM_BBOXES            9
+#define GDS_GEOM_HEADER_WORDS      10
+int gds_get_structure_geometry(void* library_ptr, int structure_index, int path_outlines);
+int32_t* gds_get_structure_geometry_buffer(void* library_ptr);
+
+// Instance table. Packs the SREF and AREF elements of all structures into one
+// buffer of 4-byte words, so that the geometry of each structure (see
+// gds_get_structure_geometry) can be drawn once per instance with instanced
+// drawing instead of being copied into every instance. The buffer starts with
+// GDS_INST_HEADER_WORDS words: counts and the word offsets of the arrays below.
+//   structure_instances  int32, S+1 entries; instances placed in structure s
+//                        are structure_instances[s] ... structure_instances[s+1]-1
+//   cells                int32 per instance; referenced structure, -1 if missing
+//   elements             int32 per instance; element index in its structure
+//   transforms           float32 [a11, a21, a12, a22, tx, ty] per instance:
+//                        x' = a11*x + a12*y + tx, y' = a21*x + a22*y + ty
+//   lattices             int32 [columns, rows] per instance, [1, 1] for SREFs
+//   steps                float32 [col_x, col_y, row_x, row_y] per instance
+// AREF lattices are kept symbolic: element (i, j) of the array is placed by the
+// transform of the instance translated by i * column step + j * row step.
+// Instances are one level deep; the hierarchy is composed by the caller.
+// Returns the buffer size in words, or -1 on error; the buffer is valid until
+// the next call or gds_free_library.
+#define GDS_INST_STRUCTURE_COUNT     0
+#define GDS_INST_COUNT               1
+#define GDS_INST_STRUCTURE_INSTANCES 2
+#define GDS_INST_CELLS               3
+#define GDS_INST_ELEMENTS            4
+#define GDS_INST_TRANSFORMS          5
+#define GDS_INST_LATTICES            6
+#define GDS_INST_STEPS               7
+#define GDS_INST_HEADER_WORDS        8
+int gds_get_instance_table(void* library_ptr);
+int32_t* gds_get_instance_table_buffer(void* library_ptr);
+
+// Level of detail. Level L of a structure is its geometry for a pixel size of
+// 2^L database units, in the layout of gds_get_structure_geometry (paths as
+// outline polygons). Polygons smaller than a pixel are replaced by density
+// tiles of one pixel: one boundary element per (layer, data type) holds the
+// covered tiles, merged into rectangles along rows. Larger polygons are
+// decimated to a tolerance of half a pixel, or replaced by their bounding box
+// when fewer than three vertices remain. Texts and references are left out;
+// the instance table places the levels of referenced structures. Levels are
+// built on first use and kept until gds_free_library. Returns the buffer size
+// in words or -1 on error; gds_get_structure_lod_buffer returns the buffer
+// of the last call.
+#define GDS_LOD_LEVELS 32
+int gds_get_structure_lod(void* library_ptr, int structure_index, int level);
+int32_t* gds_get_structure_lod_buffer(void* library_ptr);
+
+// Bounding box [llx, lly, urx, ury] of a structure with all references
+// expanded, for replacing cells smaller than a pixel by their box.
+// Returns 0, or -1 on error (e.g. a reference cycle).
+int gds_get_structure_bbox(void* library_ptr, int structure_index, double* bbox);
+
+// Triangulated layers. The polygons of a structure (paths as outline polygons,
+// texts and references left out) are triangulated by ear clipping and grouped
+// by (layer, data type) in ascending order. The buffer starts with
+// GDS_TRI_HEADER_WORDS words: counts and word offsets of the arrays
+//   layers          int32    2 per layer: layer, data type
+//   layer vertices  int32    layer l has vertices v[l] ... v[l+1]-1
+//   layer indices   int32    layer l has indices i[l] ... i[l+1]-1
+//   vertices        float32  x, y per vertex
+//   indices         uint32   3 per triangle, relative to the first vertex of
+//                            the layer, counter-clockwise
+// so that the vertices and indices of a layer are uploaded to the GPU as
+// they are. Structures are triangulated on first use and kept until
+// gds_free_library. Returns the buffer size in words or -1 on error;
+// gds_get_structure_triangles_buffer returns the buffer of the last call.
+#define GDS_TRI_LAYER_COUNT     0
+#define GDS_TRI_VERTEX_COUNT    1
+#define GDS_TRI_INDEX_COUNT     2
+#define GDS_TRI_LAYERS          3
+#define GDS_TRI_LAYER_VERTICES  4
+#define GDS_TRI_LAYER_INDICES   5
+#define GDS_TRI_VERTICES        6
+#define GDS_TRI_INDICES         7
+#define GDS_TRI_HEADER_WORDS    8
+int gds_get_structure_triangles(void* library_ptr, int structure_index);
+int32_t* gds_get_structure_triangles_buffer(void* library_ptr);
+
+// Parallel parsing. Starts thread_count workers (pthreads build) that parse
+// the elements of all structures and returns the number of workers started;
+// 0 means the module has no threads and structures are parsed on demand
+// (e.g. by gds_get_element_count between frames). While workers run, only
+// gds_get_parsed_structure_count may be called, so JS can report progress;
+// gds_parse_structures_wait returns 0 when all structures are parsed.
+int gds_parse_structures_start(void* library_ptr, int thread_count);
+int gds_get_parsed_structure_count(void* library_ptr);
+int gds_parse_structures_wait(void* library_ptr);
+
 // Error handling (from existing error system)
 const char* gds_get_last_error(void);
 void gds_clear_error(void);
@@ -17,6 +17,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "../../Basic/gdsio/gdstypes.h"
+#include "../../Basic/gdsio/flatten.h"
 #include "mem-file.h"
 
 #ifdef __cplusplus
@@ -25,7 +26,6 @@ extern "C" {
 
 // Maximum limits for WASM interface
 #define MAX_ELEMENTS_PER_STRUCTURE 10000
-#define MAX_VERTICES_PER_ELEMENT   8192
 #define MAX_POLYGONS_PER_ELEMENT   100
 #define MAX_PROPERTIES_PER_ELEMENT 50
 #define MAX_STRUCTURE_NAME_LEN     256
@@ -39,29 +39,38 @@ extern "C" {
  * Cached polygon data for WASM access
  */
 typedef struct {
-    double* vertices;         // Flattened vertex array [x1, y1, x2, y2, ...]
+    int32_t* vertices;        // Flattened vertex array [x1, y1, x2, y2, ...] in database units
     int vertex_count;         // Number of vertices
-    int capacity;             // Allocated capacity
 } wasm_polygon_t;
 
 /**
- * Cached text data for WASM access
+ * Transformation of a text or reference
  */
 typedef struct {
-    char text[MAX_TEXT_LEN];  // Text string
-    double x, y;              // Text position
-    uint16_t text_type;       // Text type
+    uint16_t flags;           // STRANS flags
+    double magnification;
+    double rotation_angle;    // degrees
+} wasm_strans_t;
+
+/**
+ * Cached text data for WASM access (side table of the structure)
+ */
+typedef struct {
+    const char* text;         // Text string (in the string pool)
+    int32_t x, y;             // Text position
     uint16_t presentation;    // Presentation flags
+    wasm_strans_t strans;
 } wasm_text_data_t;
 
 /**
- * Cached reference data for WASM access
+ * Cached reference data for WASM access (side table of the structure)
  */
 typedef struct {
-    char structure_name[MAX_STRUCTURE_NAME_LEN];  // Referenced structure name
-    double x, y;                                // Position
+    const char* structure_name;                 // Referenced structure name (in the string pool)
+    int32_t x, y;                               // Position
     uint16_t nrow, ncol;                        // Array dimensions (for AREF)
-    double corners[6];                          // AREF corners [x1, y1, x2, y2, x3, y3]
+    int32_t corners[4];                         // AREF column and row points [xc, yc, xr, yr]
+    wasm_strans_t strans;
 } wasm_reference_data_t;
 
 /**
@@ -69,51 +78,44 @@ typedef struct {
  */
 typedef struct {
     uint16_t attribute;
-    char value[256];
+    const char* value;        // Property value (in the string pool)
 } wasm_property_t;
 
 /**
  * Cached element for WASM access
+ *
+ * Only the data that all elements have are stored in the element; the
+ * kind selects the member of the data union. Texts and references, which
+ * are rare compared to boundaries, point to records in side tables.
+ * Coordinates are in database units.
  */
 typedef struct {
-    // Core element data (from element_t)
-    element_kind kind;
+    uint8_t kind;        // element_kind
     uint16_t layer;
-    uint16_t dtype;
-    uint16_t ptype;      // Path type
-    uint16_t ttype;      // Text type
-    uint16_t btype;      // Box type
-    uint16_t ntype;      // Node type
-    uint16_t present;    // Text presentation
-
-    // Element flags
+    uint16_t dtype;      // Data type, text type, box type or node type
     uint16_t elflags;
     int32_t plex;
 
-    // Transformation data
-    uint16_t strans_flags;
-    double magnification;
-    double rotation_angle;
-
-    // Path-specific data
-    float width;
-    float begin_extension;
-    float end_extension;
+    // Calculated bounding box
+    int32_t bounds[4];   // [min_x, min_y, max_x, max_y]
 
     // Geometry data
     int polygon_count;
-    wasm_polygon_t* polygons;
-
-    // Element-specific data
-    wasm_text_data_t text_data;
-    wasm_reference_data_t reference_data;
-
-    // Properties
     int property_count;
+    wasm_polygon_t* polygons;
     wasm_property_t* properties;
 
-    // Calculated bounding box
-    double bounds[4];  // [min_x, min_y, max_x, max_y]
+    // Element-specific data
+    union {
+        struct {
+            float width;
+            float begin_extension;
+            float end_extension;
+            uint16_t ptype;  // Path type
+        } path;                               // GDS_PATH
+        wasm_text_data_t* text;               // GDS_TEXT
+        wasm_reference_data_t* reference;     // GDS_SREF, GDS_AREF
+    } data;
 
 } wasm_cached_element_t;
 
@@ -125,10 +127,13 @@ typedef struct {
     uint16_t creation_date[6];
     uint16_t modification_date[6];
 
-    // Element cache
+    // Element cache. The elements, their polygons, vertices, properties
+    // and strings are stored in one block (arena) that is released at once.
     int element_count;
     int element_capacity;
     wasm_cached_element_t* elements;
+    void* arena;
+    size_t arena_size;
 
     // Structure parsing info
     long file_offset;
@@ -137,6 +142,22 @@ typedef struct {
 
 } wasm_structure_cache_t;
 
+/**
+ * Parse statistics of a library cache. The counters are only collected
+ * in builds with GDS_STATS (see Basic/gdsio/gdsstats.h).
+ */
+typedef struct {
+    uint64_t records;         // Records parsed
+    uint64_t bytes;           // Bytes of the records
+    uint64_t vertices;        // Vertices of XY records
+    uint64_t elements[8];     // Elements by kind (element_kind)
+    uint64_t arena_allocs;    // Parse arena allocations
+    uint64_t arena_bytes;     // Size of the parse arenas
+    uint64_t parse_ns;        // Time parsing structures (ns)
+} wasm_parse_stats_t;
+
+#define WASM_PARSE_STATS_COUNT (sizeof(wasm_parse_stats_t) / sizeof(uint64_t))
+
 /**
  * Library cache for WASM access
  */
@@ -161,6 +182,28 @@ typedef struct {
     // Memory file handle for parsing
     mem_file_t* mem_file;
 
+    // Streaming ingestion (wasm_create_stream_cache)
+    int owns_data;            // raw_data is allocated by the cache
+    size_t data_alloc;        // Allocated size of raw_data
+    size_t scan_pos;          // Offset of the first record not scanned yet
+    int stream_open;          // BGNSTR received, ENDSTR not yet
+    int stream_complete;      // ENDLIB received
+    int arenas_in_data;       // Structure arenas are in raw_data (snapshot)
+
+    // Vertices returned by wasm_get_element_polygon_vertices
+    double* vertex_buffer;
+    size_t vertex_buffer_alloc;
+
+    // Parallel parsing of structures (builds with WASM_THREADS)
+    int next_structure;       // Next structure taken by a parse worker
+    int parsed_structures;    // Number of parsed structures
+    int parse_failed;         // A parse worker failed
+    int parse_thread_count;   // Running parse workers
+    void* parse_threads;
+
+    // Parse statistics (builds with GDS_STATS)
+    wasm_parse_stats_t parse_stats;
+
 } wasm_library_cache_t;
 
 // ============================================================================
@@ -181,6 +224,47 @@ wasm_library_cache_t* wasm_create_library_cache(uint8_t* data, size_t size);
  */
 void wasm_free_library_cache(wasm_library_cache_t* cache);
 
+/**
+ * Creates an empty library cache that is filled by pushing chunks of the
+ * file (wasm_stream_reserve / wasm_stream_commit) as they arrive.
+ * @param size_hint Expected file size (e.g. Content-Length), or 0
+ * @return Library cache pointer or NULL on failure
+ */
+wasm_library_cache_t* wasm_create_stream_cache(size_t size_hint);
+
+/**
+ * Reserves room for the next chunk at the end of the file buffer of a
+ * stream cache. The pointer is valid until the next call.
+ * @param cache Library cache created by wasm_create_stream_cache
+ * @param size Size of the chunk
+ * @return Pointer to write the chunk to, or NULL on error
+ */
+uint8_t* wasm_stream_reserve(wasm_library_cache_t* cache, size_t size);
+
+/**
+ * Appends the chunk written to the reserved room and scans the records
+ * that are now complete. A structure becomes visible (is counted in
+ * structure_count) when its ENDSTR record has arrived; its elements can
+ * then be accessed while the rest of the file is still streaming in.
+ * @param cache Library cache created by wasm_create_stream_cache
+ * @param size Size of the chunk
+ * @return Number of complete structures, or -1 on error
+ */
+int wasm_stream_commit(wasm_library_cache_t* cache, size_t size);
+
+/**
+ * Appends a chunk (wasm_stream_reserve, copy, wasm_stream_commit)
+ * @return Number of complete structures, or -1 on error
+ */
+int wasm_stream_push(wasm_library_cache_t* cache, const uint8_t* data, size_t size);
+
+/**
+ * Ends the stream.
+ * @param cache Library cache created by wasm_create_stream_cache
+ * @return 0 if the library is complete (ENDLIB received), -1 otherwise
+ */
+int wasm_stream_finish(wasm_library_cache_t* cache);
+
 /**
  * Parses all structures in the library
  * @param cache Library cache
@@ -189,7 +273,8 @@ void wasm_free_library_cache(wasm_library_cache_t* cache);
 int wasm_parse_library_structures(wasm_library_cache_t* cache);
 
 /**
- * Parses elements for a specific structure
+ * Parses elements for a specific structure in one pass over its records.
+ * The elements and their data are stored in the arena of the structure.
  * @param cache Library cache
  * @param structure_index Index of structure to parse
  * @return 0 on success, -1 on error
@@ -256,7 +341,9 @@ int wasm_get_element_polygon_vertex_count(wasm_library_cache_t* cache,
                                          int structure_index, int element_index, int polygon_index);
 
 /**
- * Gets polygon vertices (returns pointer to cached vertex array)
+ * Gets polygon vertices converted to doubles. The vertices are cached as
+ * integers; the returned array is owned by the cache and valid until the
+ * next call.
  * @param cache Library cache
  * @param structure_index Structure index
  * @param element_index Element index
@@ -335,6 +422,15 @@ int wasm_validate_cache(wasm_library_cache_t* cache);
 void wasm_get_cache_stats(wasm_library_cache_t* cache, int* total_structures,
                         int* total_elements, size_t* memory_usage);
 
+/**
+ * Gets the parse statistics in the order of wasm_parse_stats_t
+ * @param cache Library cache
+ * @param values Array for the counters
+ * @param count Size of the array
+ * @return Number of counters stored; 0 in builds without GDS_STATS
+ */
+int wasm_get_parse_stats(wasm_library_cache_t* cache, double* values, int count);
+
 /**
  * Forces parsing of all lazy-loaded data
  * @param cache Library cache
@@ -342,6 +438,92 @@ void wasm_get_cache_stats(wasm_library_cache_t* cache, int* total_structures,
  */
 int wasm_parse_all_data(wasm_library_cache_t* cache);
 
+/**
+ * Describes all structures of the cache for hierarchy flattening
+ * (see Basic/gdsio/flatten.h). All structures are parsed and
+ * references are resolved by structure name.
+ * @param cache Library cache
+ * @param flib Flattening library; released with fl_library_free
+ * @return 0 on success, -1 on error
+ */
+int wasm_build_flatten_library(wasm_library_cache_t* cache, fl_library_t* flib);
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+// Snapshot format version; snapshots of other versions are rejected
+#define WASM_SNAPSHOT_VERSION 1
+
+/**
+ * Gets the size of the snapshot of a library: the parsed arenas of all
+ * structures with their structure table and the library metadata. All
+ * structures are parsed first.
+ * @param cache Library cache (a stream cache must be complete)
+ * @return Snapshot size in bytes, or 0 on error
+ */
+size_t wasm_snapshot_size(wasm_library_cache_t* cache);
+
+/**
+ * Writes the snapshot of a library. Snapshots depend on the build (pointer
+ * size and element layout) and are meant to be stored next to the file
+ * they were made from, e.g. keyed by its hash.
+ * @param cache Library cache
+ * @param out Buffer of wasm_snapshot_size bytes
+ * @param size Size of the buffer
+ * @return 0 on success, -1 on error
+ */
+int wasm_write_snapshot(wasm_library_cache_t* cache, uint8_t* out, size_t size);
+
+/**
+ * Creates an empty library cache for a snapshot of the given size. The
+ * snapshot is written to cache->raw_data and loaded with wasm_load_snapshot.
+ * @param size Snapshot size in bytes
+ * @return Library cache pointer or NULL on failure
+ */
+wasm_library_cache_t* wasm_create_snapshot_cache(size_t size);
+
+/**
+ * Loads the snapshot in the file buffer of a snapshot cache. The arenas
+ * are relocated in place, so no element is parsed or copied; all
+ * structures are fully parsed afterwards.
+ * @param cache Library cache created by wasm_create_snapshot_cache
+ * @return 0 on success, -1 if the snapshot is invalid or of another version
+ */
+int wasm_load_snapshot(wasm_library_cache_t* cache);
+
+// ============================================================================
+// PARALLEL PARSING
+// ============================================================================
+
+/**
+ * Starts worker threads that parse the elements of all structures and
+ * returns without waiting for them. Until wasm_wait_parallel_parse
+ * returns, only wasm_get_parsed_structure_count may be called on the
+ * cache. Without WASM_THREADS no threads are started and the caller
+ * parses the structures itself (e.g. one at a time between UI frames).
+ * @param cache Library cache
+ * @param thread_count Number of worker threads
+ * @return Number of threads started, 0 if none, -1 on error
+ */
+int wasm_start_parallel_parse(wasm_library_cache_t* cache, int thread_count);
+
+/**
+ * Gets the number of structures whose elements are parsed (including
+ * structures that parse workers failed to parse); may be called while
+ * parse workers run.
+ * @param cache Library cache
+ * @return Number of parsed structures or -1 on error
+ */
+int wasm_get_parsed_structure_count(wasm_library_cache_t* cache);
+
+/**
+ * Waits for the parse workers started by wasm_start_parallel_parse.
+ * @param cache Library cache
+ * @return 0 on success, -1 if a structure could not be parsed
+ */
+int wasm_wait_parallel_parse(wasm_library_cache_t* cache);
+
 #ifdef __cplusplus
 }
 #endif
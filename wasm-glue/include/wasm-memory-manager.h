@@ -0,0 +1,102 @@
+/*
+ * WASM Memory Manager
+ *
+ * Accounting allocator for the WASM GDSII parser. Every allocation made
+ * through WASM_MALLOC and friends carries a small header with its size
+ * and category, so the counters are exact and a free is O(1). Sampled
+ * allocations are additionally recorded with their call site in a hash
+ * table, which is used for leak reports.
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef WASM_MEMORY_MANAGER_H
+#define WASM_MEMORY_MANAGER_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Memory categories
+typedef enum {
+    WASM_MEMORY_OTHER = 0,
+    WASM_MEMORY_CACHE,        // Library caches and structure tables
+    WASM_MEMORY_BUFFER,       // File and vertex buffers
+    WASM_MEMORY_ELEMENT,      // Element arenas of parsed structures
+    WASM_MEMORY_CATEGORIES
+} wasm_memory_category_t;
+
+// Default sampling interval: about one allocation is recorded per
+// interval bytes allocated, allocations of at least this size always
+#define WASM_MEMORY_SAMPLE_INTERVAL (512 * 1024)
+
+// Allocation functions; memory must be released with wasm_free
+void* wasm_malloc(size_t size, int category, const char* file, int line, const char* function);
+void* wasm_calloc(size_t count, size_t size, int category, const char* file, int line, const char* function);
+void* wasm_realloc(void* ptr, size_t new_size, int category, const char* file, int line, const char* function);
+void wasm_free(void* ptr, const char* file, int line, const char* function);
+
+#ifdef DEBUG
+#define WASM_MALLOC(size, category) wasm_malloc(size, category, __FILE__, __LINE__, __FUNCTION__)
+#define WASM_CALLOC(count, size, category) wasm_calloc(count, size, category, __FILE__, __LINE__, __FUNCTION__)
+#define WASM_REALLOC(ptr, size, category) wasm_realloc(ptr, size, category, __FILE__, __LINE__, __FUNCTION__)
+#define WASM_FREE(ptr) wasm_free(ptr, __FILE__, __LINE__, __FUNCTION__)
+#else
+#define WASM_MALLOC(size, category) wasm_malloc(size, category, NULL, 0, NULL)
+#define WASM_CALLOC(count, size, category) wasm_calloc(count, size, category, NULL, 0, NULL)
+#define WASM_REALLOC(ptr, size, category) wasm_realloc(ptr, size, category, NULL, 0, NULL)
+#define WASM_FREE(ptr) wasm_free(ptr, NULL, 0, NULL)
+#endif
+
+/**
+ * Sets the tracking mode. The counters are always maintained.
+ * @param enable_tracking Record every allocation (1) or sampled ones (0)
+ * @param debug_mode Print leaks and warnings
+ */
+void wasm_memory_init(int enable_tracking, int debug_mode);
+
+/**
+ * Sets the sampling interval in bytes: 0 records no allocation, 1 every
+ * allocation. Allocations recorded before are kept.
+ */
+void wasm_memory_set_sample_interval(size_t interval);
+
+/**
+ * Reports the recorded allocations that are still live as leaks and
+ * clears the allocation table
+ */
+void wasm_memory_shutdown(void);
+
+/**
+ * Gets the memory statistics
+ * @param total_allocated Bytes currently allocated
+ * @param peak_usage Highest value of total_allocated
+ * @param allocation_count Number of allocations made
+ * @param leak_count Leaks found by the last wasm_memory_shutdown
+ */
+void wasm_memory_get_stats(size_t* total_allocated, size_t* peak_usage,
+                           int* allocation_count, int* leak_count);
+
+/**
+ * Sets the peak usage to the bytes currently allocated, so that the
+ * peak of a single operation can be measured
+ */
+void wasm_memory_reset_peak(void);
+
+/**
+ * Gets the bytes currently allocated in a category
+ */
+size_t wasm_memory_get_category_usage(int category);
+
+/**
+ * Prints the memory statistics
+ */
+void wasm_memory_dump_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WASM_MEMORY_MANAGER_H
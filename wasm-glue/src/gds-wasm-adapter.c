@@ -11,16 +11,20 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <limits.h>
 #include <math.h>
 #include "gds-wasm-adapter.h"
 
 // Include our new parsing infrastructure
 #include "wasm-element-cache.h"
+#include "wasm-memory-manager.h"
 #include "mem-file.h"
 
 // Include the existing GDS parsing infrastructure
 #include "../../Basic/gdsio/gdsio.h"
 #include "../../Basic/gdsio/gdstypes.h"
+#include "../../Basic/gdsio/pathpoly.h"
+#include "../../Basic/gdsio/triangulate.h"
 
 // ============================================================================
 // ENHANCED LIBRARY STRUCTURE WITH REAL PARSING
@@ -38,21 +42,61 @@ typedef struct {
     double user_units_per_db_unit;
     double meters_per_db_unit;
 
-    // Structure metadata cache
+    // Number of structures (complete structures while streaming)
     int structure_count;
-    char structure_names[128][256];
-    int structure_element_counts[128];
 
     // Validation and state
     int is_initialized;
     int parse_all_on_load;
 
+    // Hierarchy flattening
+    fl_library_t flat_lib;
+    int flat_lib_valid;
+    fl_result_t flat;
+
+    // Path outline of the last gds_get_element_path_outline call
+    double* outline;
+    size_t outline_alloc;
+
+    // Packed structure geometry (gds_get_structure_geometry)
+    int32_t* geom;
+    size_t geom_alloc;
+
+    // Packed instance table (gds_get_instance_table)
+    int32_t* inst;
+    size_t inst_alloc;
+
+    // Level of detail pyramid, GDS_LOD_LEVELS buffers per structure
+    // (gds_get_structure_lod)
+    int32_t** lod;
+    int lod_structures;
+    int32_t* lod_last;
+
+    // Triangulated layers, one buffer per structure
+    // (gds_get_structure_triangles)
+    int32_t** tri;
+    int tri_structures;
+    int32_t* tri_last;
+
+    // Snapshot written by gds_save_snapshot
+    uint8_t* snapshot;
+
 } enhanced_wasm_library_t;
 
 // ============================================================================
 // MAIN PARSING FUNCTION WITH REAL INTEGRATION
 // ============================================================================
 
+// copies the library metadata of the cache
+static void sync_library(enhanced_wasm_library_t* lib) {
+    strncpy(lib->name, lib->cache->name, sizeof(lib->name) - 1);
+    lib->name[sizeof(lib->name) - 1] = '\0';
+    lib->libver = lib->cache->version;
+    lib->user_units_per_db_unit = lib->cache->user_units_per_db_unit;
+    lib->meters_per_db_unit = lib->cache->meters_per_db_unit;
+    lib->structure_count = lib->cache->structure_count;
+}
+
 void* gds_parse_from_memory(uint8_t* data, size_t size, int* error_code) {
     if (error_code) *error_code = 0;
 
@@ -78,14 +122,7 @@ void* gds_parse_from_memory(uint8_t* data, size_t size, int* error_code) {
         return NULL;
     }
 
-    // Extract library metadata from cache
-    strncpy(lib->name, lib->cache->name, sizeof(lib->name) - 1);
-    lib->name[sizeof(lib->name) - 1] = '\0';
-
-    lib->user_units_per_db_unit = lib->cache->user_units_per_db_unit;
-    lib->meters_per_db_unit = lib->cache->meters_per_db_unit;
-
-    // Parse library structures
+    // Parse library structures; elements are parsed on demand
     if (wasm_parse_library_structures(lib->cache) != 0) {
         wasm_free_library_cache(lib->cache);
         free(lib);
@@ -93,24 +130,118 @@ void* gds_parse_from_memory(uint8_t* data, size_t size, int* error_code) {
         return NULL;
     }
 
-    lib->structure_count = lib->cache->structure_count;
+    // Extract library metadata from cache
+    sync_library(lib);
+    lib->is_initialized = 1;
 
-    // Cache structure names and element counts
-    for (int i = 0; i < lib->structure_count; i++) {
-        wasm_structure_cache_t* struct_cache = &lib->cache->structures[i];
+    return lib;
+}
 
-        strncpy(lib->structure_names[i], struct_cache->name, sizeof(lib->structure_names[i]) - 1);
-        lib->structure_names[i][sizeof(lib->structure_names[i]) - 1] = '\0';
+// ============================================================================
+// STREAMING INGESTION
+// ============================================================================
 
-        // Element count will be determined on-demand
-        lib->structure_element_counts[i] = -1;
+void* gds_stream_begin(size_t size_hint) {
+    enhanced_wasm_library_t* lib = malloc(sizeof(enhanced_wasm_library_t));
+    if (!lib) return NULL;
+    memset(lib, 0, sizeof(enhanced_wasm_library_t));
+
+    lib->cache = wasm_create_stream_cache(size_hint);
+    if (!lib->cache) {
+        free(lib);
+        return NULL;
     }
+    return lib;
+}
 
-    lib->is_initialized = 1;
+uint8_t* gds_stream_reserve(void* library_ptr, size_t size) {
+    if (!library_ptr) return NULL;
+    return wasm_stream_reserve(((enhanced_wasm_library_t*)library_ptr)->cache, size);
+}
+
+int gds_stream_commit(void* library_ptr, size_t size) {
+    if (!library_ptr) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    int ready = wasm_stream_commit(lib->cache, size);
+    if (ready >= 0) {
+        sync_library(lib);
+        lib->is_initialized = 1;
+    }
+    return ready;
+}
+
+int gds_stream_end(void* library_ptr) {
+    if (!library_ptr) return -1;
+    return wasm_stream_finish(((enhanced_wasm_library_t*)library_ptr)->cache);
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+int gds_save_snapshot(void* library_ptr) {
+    if (!library_ptr) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    gds_free_snapshot(library_ptr);
 
+    size_t size = wasm_snapshot_size(lib->cache);
+    if (size == 0 || size > INT_MAX) return -1;
+
+    lib->snapshot = malloc(size);
+    if (!lib->snapshot) return -1;
+    if (wasm_write_snapshot(lib->cache, lib->snapshot, size) != 0) {
+        gds_free_snapshot(library_ptr);
+        return -1;
+    }
+    return (int)size;
+}
+
+uint8_t* gds_get_snapshot_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->snapshot;
+}
+
+void gds_free_snapshot(void* library_ptr) {
+    if (!library_ptr) return;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    free(lib->snapshot);
+    lib->snapshot = NULL;
+}
+
+void* gds_load_snapshot_begin(size_t size) {
+    enhanced_wasm_library_t* lib = malloc(sizeof(enhanced_wasm_library_t));
+    if (!lib) return NULL;
+    memset(lib, 0, sizeof(enhanced_wasm_library_t));
+
+    lib->cache = wasm_create_snapshot_cache(size);
+    if (!lib->cache) {
+        free(lib);
+        return NULL;
+    }
     return lib;
 }
 
+uint8_t* gds_load_snapshot_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    return lib->is_initialized ? NULL : lib->cache->raw_data;
+}
+
+int gds_load_snapshot_end(void* library_ptr) {
+    if (!library_ptr) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (lib->is_initialized || wasm_load_snapshot(lib->cache) != 0) return -1;
+
+    sync_library(lib);
+    lib->is_initialized = 1;
+    return 0;
+}
+
 void gds_free_library(void* library_ptr) {
     if (library_ptr) {
         enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
@@ -119,6 +250,20 @@ void gds_free_library(void* library_ptr) {
             wasm_free_library_cache(lib->cache);
         }
 
+        fl_result_free(&lib->flat);
+        fl_library_free(&lib->flat_lib);
+        free(lib->outline);
+        free(lib->geom);
+        free(lib->inst);
+        for (int k = 0; k < lib->lod_structures * GDS_LOD_LEVELS; k++) {
+            free(lib->lod[k]);
+        }
+        free(lib->lod);
+        for (int k = 0; k < lib->tri_structures; k++) {
+            free(lib->tri[k]);
+        }
+        free(lib->tri);
+        free(lib->snapshot);
         free(lib);
     }
 }
@@ -152,10 +297,10 @@ int gds_get_structure_count(void* library_ptr) {
 }
 
 const char* gds_get_structure_name(void* library_ptr, int structure_index) {
-    if (!library_ptr || structure_index < 0 || structure_index >= 128) return "";
+    if (!library_ptr || structure_index < 0) return "";
     enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
     if (structure_index >= lib->structure_count) return "";
-    return lib->structure_names[structure_index];
+    return lib->cache->structures[structure_index].name;
 }
 
 void gds_get_library_creation_date(void* library_ptr, uint16_t* date_array) {
@@ -184,18 +329,8 @@ int gds_get_element_count(void* library_ptr, int structure_index) {
     enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
     if (structure_index >= lib->structure_count) return -1;
 
-    // Check if we have cached element count
-    if (lib->structure_element_counts[structure_index] >= 0) {
-        return lib->structure_element_counts[structure_index];
-    }
-
-    // Parse structure elements and cache the count
-    int count = wasm_get_element_count(lib->cache, structure_index);
-    if (count >= 0) {
-        lib->structure_element_counts[structure_index] = count;
-    }
-
-    return count;
+    // Parses the structure elements on first access
+    return wasm_get_element_count(lib->cache, structure_index);
 }
 
 int gds_get_element_type(void* library_ptr, int structure_index, int element_index) {
@@ -318,6 +453,56 @@ float gds_get_element_path_end_extension(void* library_ptr, int structure_index,
     return wasm_get_element_path_end_extension(lib->cache, structure_index, element_index);
 }
 
+// converts a path segment of a cached element to a polygon in lib->outline
+static int element_path_outline(enhanced_wasm_library_t* lib, int structure_index,
+                                int element_index, int path_index) {
+    const wasm_cached_element_t* el =
+        &lib->cache->structures[structure_index].elements[element_index];
+    if (path_index < 0 || path_index >= el->polygon_count) return 0;
+
+    const wasm_polygon_t* poly = &el->polygons[path_index];
+    if (poly->vertex_count <= 0 || !poly->vertices) return 0;
+
+    // the cache converts the integer vertices to doubles
+    const double* xy = wasm_get_element_polygon_vertices(lib->cache, structure_index,
+                                                         element_index, path_index);
+    if (!xy) return 0;
+
+    double hw = 0.5 * fabs(el->data.path.width);
+    double ext[2];
+    ext[0] = el->data.path.begin_extension;
+    ext[1] = el->data.path.end_extension;
+
+    size_t nv = (size_t)poly->vertex_count;
+    size_t n = pathpoly_size(xy, xy + 1, nv, 2, el->data.path.ptype);
+    if (n == 0) return 0;
+    if (n > lib->outline_alloc) {
+        double* p = realloc(lib->outline, 2 * n * sizeof(double));
+        if (!p) return 0;
+        lib->outline = p;
+        lib->outline_alloc = n;
+    }
+
+    return (int)pathpoly(xy, xy + 1, nv, 2, hw, el->data.path.ptype, ext,
+                         lib->outline, lib->outline + 1, 2);
+}
+
+int gds_get_element_path_outline(void* library_ptr, int structure_index,
+                                 int element_index, int path_index) {
+    if (!library_ptr || structure_index < 0) return 0;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (structure_index >= lib->structure_count) return 0;
+    if (wasm_get_element_type(lib->cache, structure_index, element_index) != GDS_PATH) return 0;
+
+    return element_path_outline(lib, structure_index, element_index, path_index);
+}
+
+double* gds_get_element_path_outline_vertices(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->outline;
+}
+
 // ============================================================================
 // TEXT-SPECIFIC DATA (REAL IMPLEMENTATIONS)
 // ============================================================================
@@ -486,6 +671,866 @@ const char* gds_get_element_property_value(void* library_ptr, int structure_inde
                                          element_index, property_index);
 }
 
+// ============================================================================
+// HIERARCHY FLATTENING
+// ============================================================================
+
+// the structures are converted once and reused by later calls
+static int flatten_library(enhanced_wasm_library_t* lib) {
+    if (!lib->flat_lib_valid) {
+        if (wasm_build_flatten_library(lib->cache, &lib->flat_lib) != 0) {
+            return -1;
+        }
+        lib->flat_lib_valid = 1;
+    }
+    return 0;
+}
+
+int gds_flatten_structure(void* library_ptr, int structure_index, int max_depth,
+                          const double* window, unsigned int kinds) {
+    if (!library_ptr) return -1;
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+
+    if (structure_index < 0 || structure_index >= lib->structure_count) {
+        return -1;
+    }
+
+    if (flatten_library(lib) != 0) {
+        return -1;
+    }
+
+    fl_options_t opt;
+    memset(&opt, 0, sizeof(fl_options_t));
+    opt.max_depth = max_depth;
+    opt.kinds = kinds;
+    opt.path_polygons = 1;
+    if (window) {
+        opt.has_window = 1;
+        memcpy(opt.win, window, 4 * sizeof(double));
+    }
+
+    if (fl_flatten(&lib->flat_lib, structure_index, &opt, &lib->flat) != FL_OK) {
+        fl_result_free(&lib->flat);
+        return -1;
+    }
+
+    return (int)lib->flat.nlay;
+}
+
+static fl_layer_t* flat_layer(void* library_ptr, int layer_index) {
+    if (!library_ptr) return NULL;
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+
+    if (layer_index < 0 || (size_t)layer_index >= lib->flat.nlay) {
+        return NULL;
+    }
+    return &lib->flat.lay[layer_index];
+}
+
+int gds_get_flat_layer_count(void* library_ptr) {
+    if (!library_ptr) return 0;
+    return (int)((enhanced_wasm_library_t*)library_ptr)->flat.nlay;
+}
+
+int gds_get_flat_layer(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? L->layer : -1;
+}
+
+int gds_get_flat_data_type(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? L->dtype : -1;
+}
+
+int gds_get_flat_vertex_count(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? (int)L->nxy : 0;
+}
+
+double* gds_get_flat_vertices(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? L->xy : NULL;
+}
+
+int gds_get_flat_polygon_count(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? (int)L->npoly : 0;
+}
+
+uint32_t* gds_get_flat_polygon_sizes(void* library_ptr, int layer_index) {
+    fl_layer_t* L = flat_layer(library_ptr, layer_index);
+    return L ? L->nv : NULL;
+}
+
+int gds_get_flat_instance_count(void* library_ptr) {
+    if (!library_ptr) return 0;
+    return (int)((enhanced_wasm_library_t*)library_ptr)->flat.nins;
+}
+
+void gds_free_flat_result(void* library_ptr) {
+    if (!library_ptr) return;
+    fl_result_free(&((enhanced_wasm_library_t*)library_ptr)->flat);
+}
+
+// ============================================================================
+// BULK GEOMETRY EXPORT
+// ============================================================================
+
+// makes room for n words in the geometry buffer
+static int32_t* geometry_reserve(enhanced_wasm_library_t* lib, size_t n) {
+    if (n > lib->geom_alloc) {
+        int32_t* p = realloc(lib->geom, n * sizeof(int32_t));
+        if (!p) return NULL;
+        lib->geom = p;
+        lib->geom_alloc = n;
+    }
+    return lib->geom;
+}
+
+// number of vertices of polygon p of an element in the packed buffer
+static int geometry_polygon_size(enhanced_wasm_library_t* lib, int structure_index,
+                                 int element_index, int p, int path_outlines) {
+    const wasm_cached_element_t* el =
+        &lib->cache->structures[structure_index].elements[element_index];
+    const wasm_polygon_t* poly = &el->polygons[p];
+
+    if (poly->vertex_count <= 0 || !poly->vertices) return 0;
+    if (path_outlines && el->kind == GDS_PATH) {
+        const double* xy = wasm_get_element_polygon_vertices(lib->cache, structure_index,
+                                                             element_index, p);
+        if (!xy) return 0;
+        return (int)pathpoly_size(xy, xy + 1, (size_t)poly->vertex_count, 2,
+                                  el->data.path.ptype);
+    }
+    return poly->vertex_count;
+}
+
+int gds_get_structure_geometry(void* library_ptr, int structure_index, int path_outlines) {
+    if (!library_ptr || structure_index < 0) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (structure_index >= lib->structure_count) return -1;
+
+    int n = gds_get_element_count(library_ptr, structure_index);
+    if (n < 0) return -1;
+    const wasm_cached_element_t* els = lib->cache->structures[structure_index].elements;
+
+    // first pass: sizes of the arrays
+    size_t np = 0, nv = 0;
+    for (int k = 0; k < n; k++) {
+        const wasm_cached_element_t* el = &els[k];
+        if (el->kind == GDS_TEXT || el->kind == GDS_SREF || el->kind == GDS_AREF) continue;
+        for (int p = 0; p < el->polygon_count; p++) {
+            int m = geometry_polygon_size(lib, structure_index, k, p, path_outlines);
+            if (m > 0) {
+                np++;
+                nv += (size_t)m;
+            }
+        }
+    }
+
+    size_t o_kinds = GDS_GEOM_HEADER_WORDS;
+    size_t o_layers = o_kinds + n;
+    size_t o_dtypes = o_layers + n;
+    size_t o_epoly = o_dtypes + n;
+    size_t o_pvert = o_epoly + n + 1;
+    size_t o_vert = o_pvert + np + 1;
+    size_t o_bbox = o_vert + 2 * nv;
+    size_t total = o_bbox + 4 * (size_t)n;
+    if (total > INT32_MAX) return -1;
+
+    int32_t* g = geometry_reserve(lib, total);
+    if (!g) return -1;
+
+    g[GDS_GEOM_ELEMENT_COUNT] = n;
+    g[GDS_GEOM_POLYGON_COUNT] = (int32_t)np;
+    g[GDS_GEOM_VERTEX_COUNT] = (int32_t)nv;
+    g[GDS_GEOM_KINDS] = (int32_t)o_kinds;
+    g[GDS_GEOM_LAYERS] = (int32_t)o_layers;
+    g[GDS_GEOM_DTYPES] = (int32_t)o_dtypes;
+    g[GDS_GEOM_ELEMENT_POLYGONS] = (int32_t)o_epoly;
+    g[GDS_GEOM_POLYGON_VERTICES] = (int32_t)o_pvert;
+    g[GDS_GEOM_VERTICES] = (int32_t)o_vert;
+    g[GDS_GEOM_BBOXES] = (int32_t)o_bbox;
+
+    // second pass: fill the arrays; float32 and int32 share the word buffer
+    float* vert = (float*)(g + o_vert);
+    float* bbox = (float*)(g + o_bbox);
+    size_t ip = 0, iv = 0;
+    g[o_pvert] = 0;
+    for (int k = 0; k < n; k++) {
+        const wasm_cached_element_t* el = &els[k];
+        int has_xy = !(el->kind == GDS_TEXT || el->kind == GDS_SREF || el->kind == GDS_AREF);
+
+        g[o_kinds + k] = (int32_t)el->kind;
+        g[o_layers + k] = el->layer;
+        g[o_dtypes + k] = el->dtype;
+        g[o_epoly + k] = (int32_t)ip;
+        for (int j = 0; j < 4; j++) {
+            bbox[4 * k + j] = (float)el->bounds[j];
+        }
+
+        for (int p = 0; has_xy && p < el->polygon_count; p++) {
+            const wasm_polygon_t* poly = &el->polygons[p];
+            int m = geometry_polygon_size(lib, structure_index, k, p, path_outlines);
+            if (m <= 0) continue;
+
+            if (path_outlines && el->kind == GDS_PATH) {
+                m = element_path_outline(lib, structure_index, k, p);
+                for (int i = 0; i < 2 * m; i++) {
+                    vert[2 * iv + i] = (float)lib->outline[i];
+                }
+            } else {
+                for (int i = 0; i < 2 * m; i++) {
+                    vert[2 * iv + i] = (float)poly->vertices[i];
+                }
+            }
+            iv += (size_t)m;
+            g[o_pvert + ++ip] = (int32_t)iv;
+        }
+    }
+    g[o_epoly + n] = (int32_t)ip;
+
+    return (int)total;
+}
+
+int32_t* gds_get_structure_geometry_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->geom;
+}
+
+// ============================================================================
+// INSTANCE TABLE
+// ============================================================================
+
+int gds_get_instance_table(void* library_ptr) {
+    if (!library_ptr) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (flatten_library(lib) != 0) return -1;
+    const fl_library_t* flib = &lib->flat_lib;
+
+    size_t ns = flib->ncell, ni = 0;
+    for (size_t s = 0; s < ns; s++) {
+        ni += flib->cell[s].nref;
+    }
+
+    size_t o_sinst = GDS_INST_HEADER_WORDS;
+    size_t o_cells = o_sinst + ns + 1;
+    size_t o_elements = o_cells + ni;
+    size_t o_transforms = o_elements + ni;
+    size_t o_lattices = o_transforms + 6 * ni;
+    size_t o_steps = o_lattices + 2 * ni;
+    size_t total = o_steps + 4 * ni;
+    if (total > INT32_MAX) return -1;
+
+    if (total > lib->inst_alloc) {
+        int32_t* p = realloc(lib->inst, total * sizeof(int32_t));
+        if (!p) return -1;
+        lib->inst = p;
+        lib->inst_alloc = total;
+    }
+    int32_t* t = lib->inst;
+
+    t[GDS_INST_STRUCTURE_COUNT] = (int32_t)ns;
+    t[GDS_INST_COUNT] = (int32_t)ni;
+    t[GDS_INST_STRUCTURE_INSTANCES] = (int32_t)o_sinst;
+    t[GDS_INST_CELLS] = (int32_t)o_cells;
+    t[GDS_INST_ELEMENTS] = (int32_t)o_elements;
+    t[GDS_INST_TRANSFORMS] = (int32_t)o_transforms;
+    t[GDS_INST_LATTICES] = (int32_t)o_lattices;
+    t[GDS_INST_STEPS] = (int32_t)o_steps;
+
+    // float32 and int32 share the word buffer
+    float* tr = (float*)(t + o_transforms);
+    float* st = (float*)(t + o_steps);
+    size_t i = 0;
+    for (size_t s = 0; s < ns; s++) {
+        const fl_cell_t* c = &flib->cell[s];
+        t[o_sinst + s] = (int32_t)i;
+        for (size_t k = 0; k < c->nref; k++, i++) {
+            const fl_ref_t* r = &c->ref[k];
+            t[o_cells + i] = r->cell;
+            t[o_elements + i] = (int32_t)r->el;
+            tr[6 * i + 0] = (float)r->T.a11;
+            tr[6 * i + 1] = (float)r->T.a21;
+            tr[6 * i + 2] = (float)r->T.a12;
+            tr[6 * i + 3] = (float)r->T.a22;
+            tr[6 * i + 4] = (float)r->T.tx;
+            tr[6 * i + 5] = (float)r->T.ty;
+            t[o_lattices + 2 * i] = r->ncol;
+            t[o_lattices + 2 * i + 1] = r->nrow;
+            st[4 * i + 0] = (float)r->dcol[0];
+            st[4 * i + 1] = (float)r->dcol[1];
+            st[4 * i + 2] = (float)r->drow[0];
+            st[4 * i + 3] = (float)r->drow[1];
+        }
+    }
+    t[o_sinst + ns] = (int32_t)i;
+
+    return (int)total;
+}
+
+int32_t* gds_get_instance_table_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->inst;
+}
+
+// ============================================================================
+// LEVEL OF DETAIL
+// ============================================================================
+
+typedef struct {
+    int32_t kind, layer, dtype;
+    size_t poly;              // first polygon
+    float bbox[4];
+} lod_element_t;
+
+typedef struct {
+    uint16_t layer, dtype;
+    int32_t ix, iy;
+} lod_tile_t;
+
+typedef struct {
+    lod_element_t* el;  size_t nel, ael;
+    int32_t* pv;        size_t npv, apv;    // vertex offsets of the polygons
+    float* xy;          size_t nxy, axy;    // x,y pairs
+    lod_tile_t* tile;   size_t ntile, atile;
+    unsigned char* keep; size_t akeep;
+    size_t* stack;      size_t astack;
+} lod_builder_t;
+
+static int lod_grow(void** p, size_t* alloc, size_t n, size_t size) {
+    if (n <= *alloc) return 0;
+    size_t a = *alloc ? *alloc : 64;
+    while (a < n) a *= 2;
+    void* q = realloc(*p, a * size);
+    if (!q) return -1;
+    *p = q;
+    *alloc = a;
+    return 0;
+}
+
+static void lod_builder_free(lod_builder_t* b) {
+    free(b->el);
+    free(b->pv);
+    free(b->xy);
+    free(b->tile);
+    free(b->keep);
+    free(b->stack);
+}
+
+// starts an output element
+static int lod_add_element(lod_builder_t* b, int kind, int layer, int dtype) {
+    if (lod_grow((void**)&b->el, &b->ael, b->nel + 1, sizeof(lod_element_t)) != 0) return -1;
+    lod_element_t* e = &b->el[b->nel++];
+    e->kind = kind;
+    e->layer = layer;
+    e->dtype = dtype;
+    e->poly = b->npv;
+    e->bbox[0] = e->bbox[1] = HUGE_VALF;
+    e->bbox[2] = e->bbox[3] = -HUGE_VALF;
+    return 0;
+}
+
+// closes a polygon of n vertices appended to b->xy
+static int lod_end_polygon(lod_builder_t* b, size_t n) {
+    if (lod_grow((void**)&b->pv, &b->apv, b->npv + 1, sizeof(int32_t)) != 0) return -1;
+    b->nxy += n;
+    b->pv[b->npv++] = (int32_t)b->nxy;
+    return 0;
+}
+
+static int lod_add_rect(lod_builder_t* b, double x0, double y0, double x1, double y1) {
+    if (lod_grow((void**)&b->xy, &b->axy, b->nxy + 4, 2 * sizeof(float)) != 0) return -1;
+    float* v = b->xy + 2 * b->nxy;
+    v[0] = (float)x0; v[1] = (float)y0;
+    v[2] = (float)x1; v[3] = (float)y0;
+    v[4] = (float)x1; v[5] = (float)y1;
+    v[6] = (float)x0; v[7] = (float)y1;
+    return lod_end_polygon(b, 4);
+}
+
+// squared distance of p from the line through a and b
+static double lod_line_dist2(const double* p, const double* a, const double* b) {
+    double dx = b[0] - a[0], dy = b[1] - a[1];
+    double l2 = dx * dx + dy * dy;
+    double px = p[0] - a[0], py = p[1] - a[1];
+    if (l2 == 0.0) return px * px + py * py;
+    double c = px * dy - py * dx;
+    return c * c / l2;
+}
+
+/*
+ * Simplifies a closed ring of n vertices with the Douglas-Peucker
+ * algorithm and appends the kept vertices to b->xy. Returns the number
+ * of kept vertices or -1 on error.
+ */
+static long lod_simplify(lod_builder_t* b, const double* xy, size_t n, double tol) {
+    // the closing vertex of boundaries is dropped
+    if (n > 1 && xy[0] == xy[2 * n - 2] && xy[1] == xy[2 * n - 1]) n--;
+    if (n < 3) return 0;
+
+    if (lod_grow((void**)&b->keep, &b->akeep, n + 1, 1) != 0 ||
+        lod_grow((void**)&b->stack, &b->astack, 2 * n + 4, sizeof(size_t)) != 0 ||
+        lod_grow((void**)&b->xy, &b->axy, b->nxy + n, 2 * sizeof(float)) != 0) {
+        return -1;
+    }
+    memset(b->keep, 0, n + 1);
+
+    // the ring is split at vertex 0 and the vertex farthest from it;
+    // index n stands for vertex 0
+    size_t f = 0;
+    double fd = -1.0;
+    for (size_t k = 1; k < n; k++) {
+        double dx = xy[2 * k] - xy[0], dy = xy[2 * k + 1] - xy[1];
+        if (dx * dx + dy * dy > fd) {
+            fd = dx * dx + dy * dy;
+            f = k;
+        }
+    }
+    b->keep[0] = b->keep[f] = 1;
+
+    size_t top = 0;
+    b->stack[top++] = 0; b->stack[top++] = f;
+    b->stack[top++] = f; b->stack[top++] = n;
+    double tol2 = tol * tol;
+    while (top > 0) {
+        size_t j = b->stack[--top], i = b->stack[--top];
+        const double* a = xy + 2 * i;
+        const double* e = xy + 2 * (j % n);
+        size_t m = 0;
+        double md = tol2;
+        for (size_t k = i + 1; k < j; k++) {
+            double d = lod_line_dist2(xy + 2 * k, a, e);
+            if (d > md) {
+                md = d;
+                m = k;
+            }
+        }
+        if (m) {
+            b->keep[m] = 1;
+            b->stack[top++] = i; b->stack[top++] = m;
+            b->stack[top++] = m; b->stack[top++] = j;
+        }
+    }
+
+    float* v = b->xy + 2 * b->nxy;
+    size_t kept = 0;
+    for (size_t k = 0; k < n; k++) {
+        if (b->keep[k]) {
+            v[2 * kept] = (float)xy[2 * k];
+            v[2 * kept + 1] = (float)xy[2 * k + 1];
+            kept++;
+        }
+    }
+    return (long)kept;
+}
+
+static int lod_tile_cmp(const void* pa, const void* pb) {
+    const lod_tile_t* a = pa;
+    const lod_tile_t* b = pb;
+    if (a->layer != b->layer) return a->layer < b->layer ? -1 : 1;
+    if (a->dtype != b->dtype) return a->dtype < b->dtype ? -1 : 1;
+    if (a->iy != b->iy) return a->iy < b->iy ? -1 : 1;
+    if (a->ix != b->ix) return a->ix < b->ix ? -1 : 1;
+    return 0;
+}
+
+// emits the tiles as one boundary element per (layer, data type); runs
+// of tiles in a row become one rectangle
+static int lod_emit_tiles(lod_builder_t* b, double pixel) {
+    qsort(b->tile, b->ntile, sizeof(lod_tile_t), lod_tile_cmp);
+
+    size_t k = 0;
+    while (k < b->ntile) {
+        const lod_tile_t* t0 = &b->tile[k];
+        if (lod_add_element(b, GDS_BOUNDARY, t0->layer, t0->dtype) != 0) return -1;
+        lod_element_t* e = &b->el[b->nel - 1];
+
+        while (k < b->ntile && b->tile[k].layer == t0->layer && b->tile[k].dtype == t0->dtype) {
+            const lod_tile_t* r = &b->tile[k];
+            int32_t end = r->ix;
+            while (++k < b->ntile &&
+                   b->tile[k].layer == r->layer && b->tile[k].dtype == r->dtype &&
+                   b->tile[k].iy == r->iy && b->tile[k].ix <= end + 1) {
+                end = b->tile[k].ix;
+            }
+            double x0 = r->ix * pixel, y0 = r->iy * pixel;
+            double x1 = (end + 1) * pixel, y1 = (r->iy + 1) * pixel;
+            if (lod_add_rect(b, x0, y0, x1, y1) != 0) return -1;
+            e->bbox[0] = fminf(e->bbox[0], (float)x0);
+            e->bbox[1] = fminf(e->bbox[1], (float)y0);
+            e->bbox[2] = fmaxf(e->bbox[2], (float)x1);
+            e->bbox[3] = fmaxf(e->bbox[3], (float)y1);
+        }
+    }
+    return 0;
+}
+
+// builds level `level` of a structure in the packed geometry layout
+static int32_t* lod_build(enhanced_wasm_library_t* lib, int structure_index, int level) {
+    const double pixel = ldexp(1.0, level);
+    int n = gds_get_element_count(lib, structure_index);
+    if (n < 0) return NULL;
+
+    lod_builder_t b;
+    memset(&b, 0, sizeof(lod_builder_t));
+    int32_t* g = NULL;
+
+    for (int k = 0; k < n; k++) {
+        const wasm_cached_element_t* el = &lib->cache->structures[structure_index].elements[k];
+        if (el->kind == GDS_TEXT || el->kind == GDS_SREF || el->kind == GDS_AREF) continue;
+
+        size_t first = b.npv;
+        if (lod_add_element(&b, el->kind, el->layer, el->dtype) != 0) goto fail;
+
+        for (int p = 0; p < el->polygon_count; p++) {
+            const double* xy;
+            size_t m;
+            if (el->kind == GDS_PATH) {
+                m = (size_t)element_path_outline(lib, structure_index, k, p);
+                xy = lib->outline;
+            } else {
+                m = (size_t)el->polygons[p].vertex_count;
+                xy = wasm_get_element_polygon_vertices(lib->cache, structure_index, k, p);
+            }
+            if (m == 0 || !xy) continue;
+
+            double bb[4] = {xy[0], xy[1], xy[0], xy[1]};
+            for (size_t i = 1; i < m; i++) {
+                bb[0] = fmin(bb[0], xy[2 * i]);
+                bb[1] = fmin(bb[1], xy[2 * i + 1]);
+                bb[2] = fmax(bb[2], xy[2 * i]);
+                bb[3] = fmax(bb[3], xy[2 * i + 1]);
+            }
+
+            if (bb[2] - bb[0] < pixel && bb[3] - bb[1] < pixel) {
+                // below a pixel the polygon only adds to the coverage of a tile
+                if (lod_grow((void**)&b.tile, &b.atile, b.ntile + 1, sizeof(lod_tile_t)) != 0) goto fail;
+                lod_tile_t* t = &b.tile[b.ntile++];
+                t->layer = el->layer;
+                t->dtype = el->dtype;
+                t->ix = (int32_t)floor(0.5 * (bb[0] + bb[2]) / pixel);
+                t->iy = (int32_t)floor(0.5 * (bb[1] + bb[3]) / pixel);
+                continue;
+            }
+
+            long kept = lod_simplify(&b, xy, m, 0.5 * pixel);
+            if (kept < 0) goto fail;
+            if (kept >= 3) {
+                if (lod_end_polygon(&b, (size_t)kept) != 0) goto fail;
+            } else if (lod_add_rect(&b, bb[0], bb[1], bb[2], bb[3]) != 0) {
+                goto fail;
+            }
+
+            lod_element_t* e = &b.el[b.nel - 1];
+            e->bbox[0] = fminf(e->bbox[0], (float)bb[0]);
+            e->bbox[1] = fminf(e->bbox[1], (float)bb[1]);
+            e->bbox[2] = fmaxf(e->bbox[2], (float)bb[2]);
+            e->bbox[3] = fmaxf(e->bbox[3], (float)bb[3]);
+        }
+
+        // elements without polygons at this level are dropped
+        if (b.npv == first) b.nel--;
+    }
+    if (lod_emit_tiles(&b, pixel) != 0) goto fail;
+
+    size_t ne = b.nel, np = b.npv, nv = b.nxy;
+    size_t o_kinds = GDS_GEOM_HEADER_WORDS;
+    size_t o_layers = o_kinds + ne;
+    size_t o_dtypes = o_layers + ne;
+    size_t o_epoly = o_dtypes + ne;
+    size_t o_pvert = o_epoly + ne + 1;
+    size_t o_vert = o_pvert + np + 1;
+    size_t o_bbox = o_vert + 2 * nv;
+    size_t total = o_bbox + 4 * ne;
+    if (total > INT32_MAX) goto fail;
+
+    g = malloc(total * sizeof(int32_t));
+    if (!g) goto fail;
+
+    g[GDS_GEOM_ELEMENT_COUNT] = (int32_t)ne;
+    g[GDS_GEOM_POLYGON_COUNT] = (int32_t)np;
+    g[GDS_GEOM_VERTEX_COUNT] = (int32_t)nv;
+    g[GDS_GEOM_KINDS] = (int32_t)o_kinds;
+    g[GDS_GEOM_LAYERS] = (int32_t)o_layers;
+    g[GDS_GEOM_DTYPES] = (int32_t)o_dtypes;
+    g[GDS_GEOM_ELEMENT_POLYGONS] = (int32_t)o_epoly;
+    g[GDS_GEOM_POLYGON_VERTICES] = (int32_t)o_pvert;
+    g[GDS_GEOM_VERTICES] = (int32_t)o_vert;
+    g[GDS_GEOM_BBOXES] = (int32_t)o_bbox;
+
+    for (size_t k = 0; k < ne; k++) {
+        g[o_kinds + k] = b.el[k].kind;
+        g[o_layers + k] = b.el[k].layer;
+        g[o_dtypes + k] = b.el[k].dtype;
+        g[o_epoly + k] = (int32_t)b.el[k].poly;
+        memcpy(g + o_bbox + 4 * k, b.el[k].bbox, 4 * sizeof(float));
+    }
+    g[o_epoly + ne] = (int32_t)np;
+    g[o_pvert] = 0;
+    if (np) memcpy(g + o_pvert + 1, b.pv, np * sizeof(int32_t));
+    if (nv) memcpy(g + o_vert, b.xy, 2 * nv * sizeof(float));
+
+fail:
+    lod_builder_free(&b);
+    return g;
+}
+
+int gds_get_structure_lod(void* library_ptr, int structure_index, int level) {
+    if (!library_ptr || structure_index < 0 || level < 0 || level >= GDS_LOD_LEVELS) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (structure_index >= lib->structure_count) return -1;
+
+    // the table grows with the structures that arrive while streaming
+    if (structure_index >= lib->lod_structures) {
+        int ns = lib->structure_count;
+        int32_t** t = realloc(lib->lod, (size_t)ns * GDS_LOD_LEVELS * sizeof(int32_t*));
+        if (!t) return -1;
+        memset(t + (size_t)lib->lod_structures * GDS_LOD_LEVELS, 0,
+               (size_t)(ns - lib->lod_structures) * GDS_LOD_LEVELS * sizeof(int32_t*));
+        lib->lod = t;
+        lib->lod_structures = ns;
+    }
+
+    // levels are built on first use and kept
+    int32_t** slot = &lib->lod[(size_t)structure_index * GDS_LOD_LEVELS + level];
+    if (!*slot) {
+        *slot = lod_build(lib, structure_index, level);
+        if (!*slot) return -1;
+    }
+    lib->lod_last = *slot;
+
+    const int32_t* g = *slot;
+    return g[GDS_GEOM_BBOXES] + 4 * g[GDS_GEOM_ELEMENT_COUNT];
+}
+
+int32_t* gds_get_structure_lod_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->lod_last;
+}
+
+int gds_get_structure_bbox(void* library_ptr, int structure_index, double* bbox) {
+    if (!library_ptr || !bbox || structure_index < 0) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (structure_index >= lib->structure_count) return -1;
+    if (flatten_library(lib) != 0) return -1;
+    if ((size_t)structure_index >= lib->flat_lib.ncell) return -1;
+
+    return fl_cell_bbox(&lib->flat_lib, (size_t)structure_index, bbox) == FL_OK ? 0 : -1;
+}
+
+// ============================================================================
+// TRIANGULATION
+// ============================================================================
+
+typedef struct {
+    int32_t layer, dtype;
+    size_t seq;               // keeps the element order within a layer
+    size_t vert, nvert;       // vertices in the builder
+    size_t idx, nidx;         // indices in the builder, relative to vert
+} tri_polygon_t;
+
+typedef struct {
+    tri_polygon_t* poly; size_t npoly, apoly;
+    float* xy;           size_t nxy, axy;     // x,y pairs
+    uint32_t* idx;       size_t nidx, aidx;
+    size_t* work;        size_t awork;
+} tri_builder_t;
+
+static void tri_builder_free(tri_builder_t* b) {
+    free(b->poly);
+    free(b->xy);
+    free(b->idx);
+    free(b->work);
+}
+
+static int tri_polygon_cmp(const void* pa, const void* pb) {
+    const tri_polygon_t* a = (const tri_polygon_t*)pa;
+    const tri_polygon_t* b = (const tri_polygon_t*)pb;
+    if (a->layer != b->layer) return a->layer < b->layer ? -1 : 1;
+    if (a->dtype != b->dtype) return a->dtype < b->dtype ? -1 : 1;
+    return a->seq < b->seq ? -1 : a->seq > b->seq;
+}
+
+// polygon i of the sorted polygons starts a (layer, data type)
+static int tri_new_layer(const tri_builder_t* b, size_t i) {
+    return i == 0 || b->poly[i - 1].layer != b->poly[i].layer ||
+           b->poly[i - 1].dtype != b->poly[i].dtype;
+}
+
+// triangulates a polygon of m vertices and appends it to the builder
+static int tri_add_polygon(tri_builder_t* b, const double* xy, size_t m, int layer, int dtype) {
+    // the closing vertex is not needed for triangles
+    if (m > 3 && xy[0] == xy[2 * m - 2] && xy[1] == xy[2 * m - 1]) m--;
+    if (m < 3) return 0;
+
+    if (lod_grow((void**)&b->work, &b->awork, TRI_WORK(m), sizeof(size_t)) != 0 ||
+        lod_grow((void**)&b->idx, &b->aidx, b->nidx + 3 * TRI_MAX(m), sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    size_t nt = triangulate(xy, xy + 1, m, 2, b->work, b->idx + b->nidx);
+    if (nt == 0) return 0;
+
+    if (lod_grow((void**)&b->poly, &b->apoly, b->npoly + 1, sizeof(tri_polygon_t)) != 0 ||
+        lod_grow((void**)&b->xy, &b->axy, 2 * (b->nxy + m), sizeof(float)) != 0) {
+        return -1;
+    }
+    tri_polygon_t* t = &b->poly[b->npoly];
+    t->layer = layer;
+    t->dtype = dtype;
+    t->seq = b->npoly++;
+    t->vert = b->nxy;
+    t->nvert = m;
+    t->idx = b->nidx;
+    t->nidx = 3 * nt;
+
+    for (size_t i = 0; i < 2 * m; i++) {
+        b->xy[2 * b->nxy + i] = (float)xy[i];
+    }
+    b->nxy += m;
+    b->nidx += 3 * nt;
+    return 0;
+}
+
+// triangulates the polygons of a structure and groups them by layer
+static int32_t* tri_build(enhanced_wasm_library_t* lib, int structure_index) {
+    int n = gds_get_element_count(lib, structure_index);
+    if (n < 0) return NULL;
+
+    tri_builder_t b;
+    memset(&b, 0, sizeof(tri_builder_t));
+    int32_t* g = NULL;
+
+    for (int k = 0; k < n; k++) {
+        const wasm_cached_element_t* el = &lib->cache->structures[structure_index].elements[k];
+        if (el->kind == GDS_TEXT || el->kind == GDS_SREF || el->kind == GDS_AREF) continue;
+
+        for (int p = 0; p < el->polygon_count; p++) {
+            const double* xy;
+            size_t m;
+            if (el->kind == GDS_PATH) {
+                m = (size_t)element_path_outline(lib, structure_index, k, p);
+                xy = lib->outline;
+            } else {
+                m = (size_t)el->polygons[p].vertex_count;
+                xy = wasm_get_element_polygon_vertices(lib->cache, structure_index, k, p);
+            }
+            if (m == 0 || !xy) continue;
+            if (tri_add_polygon(&b, xy, m, el->layer, el->dtype) != 0) goto fail;
+        }
+    }
+
+    qsort(b.poly, b.npoly, sizeof(tri_polygon_t), tri_polygon_cmp);
+    size_t nl = 0;
+    for (size_t i = 0; i < b.npoly; i++) {
+        if (tri_new_layer(&b, i)) nl++;
+    }
+
+    size_t o_layers = GDS_TRI_HEADER_WORDS;
+    size_t o_lvert = o_layers + 2 * nl;
+    size_t o_lidx = o_lvert + nl + 1;
+    size_t o_vert = o_lidx + nl + 1;
+    size_t o_idx = o_vert + 2 * b.nxy;
+    size_t total = o_idx + b.nidx;
+    if (total > INT32_MAX) goto fail;
+
+    g = malloc(total * sizeof(int32_t));
+    if (!g) goto fail;
+
+    g[GDS_TRI_LAYER_COUNT] = (int32_t)nl;
+    g[GDS_TRI_VERTEX_COUNT] = (int32_t)b.nxy;
+    g[GDS_TRI_INDEX_COUNT] = (int32_t)b.nidx;
+    g[GDS_TRI_LAYERS] = (int32_t)o_layers;
+    g[GDS_TRI_LAYER_VERTICES] = (int32_t)o_lvert;
+    g[GDS_TRI_LAYER_INDICES] = (int32_t)o_lidx;
+    g[GDS_TRI_VERTICES] = (int32_t)o_vert;
+    g[GDS_TRI_INDICES] = (int32_t)o_idx;
+
+    // float32 and uint32 share the word buffer
+    float* vert = (float*)(g + o_vert);
+    uint32_t* idx = (uint32_t*)(g + o_idx);
+    size_t l = 0, iv = 0, ii = 0, base = 0;
+    for (size_t i = 0; i < b.npoly; i++) {
+        const tri_polygon_t* t = &b.poly[i];
+        if (tri_new_layer(&b, i)) {
+            g[o_layers + 2 * l] = t->layer;
+            g[o_layers + 2 * l + 1] = t->dtype;
+            g[o_lvert + l] = (int32_t)iv;
+            g[o_lidx + l] = (int32_t)ii;
+            base = iv;
+            l++;
+        }
+        memcpy(vert + 2 * iv, b.xy + 2 * t->vert, 2 * t->nvert * sizeof(float));
+        for (size_t j = 0; j < t->nidx; j++) {
+            idx[ii + j] = b.idx[t->idx + j] + (uint32_t)(iv - base);
+        }
+        iv += t->nvert;
+        ii += t->nidx;
+    }
+    g[o_lvert + nl] = (int32_t)iv;
+    g[o_lidx + nl] = (int32_t)ii;
+
+fail:
+    tri_builder_free(&b);
+    return g;
+}
+
+int gds_get_structure_triangles(void* library_ptr, int structure_index) {
+    if (!library_ptr || structure_index < 0) return -1;
+
+    enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
+    if (structure_index >= lib->structure_count) return -1;
+
+    // the table grows with the structures that arrive while streaming
+    if (structure_index >= lib->tri_structures) {
+        int ns = lib->structure_count;
+        int32_t** t = realloc(lib->tri, (size_t)ns * sizeof(int32_t*));
+        if (!t) return -1;
+        memset(t + lib->tri_structures, 0, (size_t)(ns - lib->tri_structures) * sizeof(int32_t*));
+        lib->tri = t;
+        lib->tri_structures = ns;
+    }
+
+    // structures are triangulated on first use and kept
+    int32_t** slot = &lib->tri[structure_index];
+    if (!*slot) {
+        *slot = tri_build(lib, structure_index);
+        if (!*slot) return -1;
+    }
+    lib->tri_last = *slot;
+
+    const int32_t* g = *slot;
+    return g[GDS_TRI_INDICES] + g[GDS_TRI_INDEX_COUNT];
+}
+
+int32_t* gds_get_structure_triangles_buffer(void* library_ptr) {
+    if (!library_ptr) return NULL;
+    return ((enhanced_wasm_library_t*)library_ptr)->tri_last;
+}
+
+// ============================================================================
+// PARALLEL PARSING
+// ============================================================================
+
+int gds_parse_structures_start(void* library_ptr, int thread_count) {
+    if (!library_ptr) return -1;
+    return wasm_start_parallel_parse(((enhanced_wasm_library_t*)library_ptr)->cache, thread_count);
+}
+
+int gds_get_parsed_structure_count(void* library_ptr) {
+    if (!library_ptr) return -1;
+    return wasm_get_parsed_structure_count(((enhanced_wasm_library_t*)library_ptr)->cache);
+}
+
+int gds_parse_structures_wait(void* library_ptr) {
+    if (!library_ptr) return -1;
+    return wasm_wait_parallel_parse(((enhanced_wasm_library_t*)library_ptr)->cache);
+}
+
 // ============================================================================
 // ENHANCED ERROR HANDLING AND VALIDATION
 // ============================================================================
@@ -511,10 +1556,11 @@ int gds_validate_library(void* library_ptr) {
 void gds_get_memory_usage(int* total_allocated, int* peak_usage) {
     if (!total_allocated && !peak_usage) return;
 
-    // Use cache statistics
-    // This would need access to the global cache or be passed a library pointer
-    if (total_allocated) *total_allocated = 0;
-    if (peak_usage) *peak_usage = 0;
+    // Memory of all library caches, from the memory manager counters
+    size_t total = 0, peak = 0;
+    wasm_memory_get_stats(&total, &peak, NULL, NULL);
+    if (total_allocated) *total_allocated = total > INT_MAX ? INT_MAX : (int)total;
+    if (peak_usage) *peak_usage = peak > INT_MAX ? INT_MAX : (int)peak;
 }
 
 // ============================================================================
@@ -522,19 +1568,25 @@ void gds_get_memory_usage(int* total_allocated, int* peak_usage) {
 // ============================================================================
 
 /**
- * Get cache statistics for a library
+ * Get cache statistics for a library. In builds with GDS_STATS the
+ * parse statistics (records, bytes, vertices, elements by kind, arena
+ * allocations and bytes, parse time in ns; see wasm_parse_stats_t) are
+ * stored in parse_stats, which may be NULL.
+ * @return Number of parse statistics stored
  */
-void gds_get_cache_statistics(void* library_ptr, int* total_structures,
-                            int* total_elements, size_t* memory_usage) {
+int gds_get_cache_statistics(void* library_ptr, int* total_structures,
+                             int* total_elements, size_t* memory_usage,
+                             double* parse_stats, int parse_stats_count) {
     if (!library_ptr) {
         if (total_structures) *total_structures = 0;
         if (total_elements) *total_elements = 0;
         if (memory_usage) *memory_usage = 0;
-        return;
+        return 0;
     }
 
     enhanced_wasm_library_t* lib = (enhanced_wasm_library_t*)library_ptr;
     wasm_get_cache_stats(lib->cache, total_structures, total_elements, memory_usage);
+    return wasm_get_parse_stats(lib->cache, parse_stats, parse_stats_count);
 }
 
 /**
@@ -6,12 +6,23 @@
  * Copyright (c) 2025
  */
 
+#if defined GDS_STATS && !defined _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L   // for clock_gettime
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <math.h>
+#ifdef GDS_STATS
+#include <time.h>
+#endif
+#ifdef WASM_THREADS
+#include <pthread.h>
+#endif
 #include "wasm-element-cache.h"
+#include "wasm-memory-manager.h"
 #include "mem-file.h"
 
 // Include existing GDS parsing infrastructure
@@ -72,29 +83,503 @@ static element_kind map_record_type_to_element_kind(uint16_t record_type) {
     }
 }
 
-static void calculate_bounds_from_vertices(double* vertices, int vertex_count, double bounds[4]) {
-    if (vertex_count == 0) {
-        bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0.0;
-        return;
+static uint16_t get_be16(const uint8_t* p) {
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static uint32_t get_be32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// GDSII excess-64 real
+static double get_real(const uint8_t* p) {
+    uint64_t u;
+    memcpy(&u, p, 8); // Preserve byte order in memory for converter
+    return excess64_to_ieee754(&u);
+}
+
+// ============================================================================
+// STRUCTURE ARENAS
+// ============================================================================
+
+/*
+ * A structure is parsed in one pass into growable arrays: the elements,
+ * the side tables of texts and references, the polygons and properties,
+ * one slab for all vertices, and a pool in which each distinct string is
+ * stored once. While parsing, the arrays
+ * refer to each other by offsets because they move when they grow. When
+ * the structure is complete, everything is copied into one block and the
+ * offsets are turned into pointers.
+ */
+typedef struct {
+    size_t polygon;           // First polygon of the element
+    size_t property;          // First property of the element
+    size_t text;              // Text string
+    size_t sname;             // Referenced structure name
+    size_t side;              // Text or reference record in its side table
+} parse_element_t;
+
+typedef struct {
+    size_t xy;                // Offset of the vertices in the slab
+    int vertex_count;
+} parse_polygon_t;
+
+typedef struct {
+    uint16_t attribute;
+    size_t value;             // Offset of the value in the string pool
+} parse_property_t;
+
+typedef struct {
+    wasm_cached_element_t* el;
+    size_t nel, ael;
+    parse_element_t* pel;
+    size_t apel;
+
+    wasm_text_data_t* text;
+    size_t ntext, atext;
+
+    wasm_reference_data_t* ref;
+    size_t nref, aref;
+
+    parse_polygon_t* poly;
+    size_t npoly, apoly;
+
+    int32_t* xy;
+    size_t nxy, axy;          // in coordinates
+
+    parse_property_t* prop;
+    size_t nprop, aprop;
+
+    char* str;
+    size_t nstr, astr;
+
+    size_t* hash;             // Open addressing table of string offsets, 0 is empty
+    size_t nhash, ahash;
+} parse_arena_t;
+
+#define ARENA_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+// grows an array to hold at least n items of the given size
+static int arena_grow(void** p, size_t* alloc, size_t n, size_t size) {
+    if (n <= *alloc) {
+        return 0;
+    }
+    size_t a = *alloc ? *alloc : 16;
+    while (a < n) {
+        a *= 2;
+    }
+    void* q = realloc(*p, a * size);
+    if (!q) {
+        return -1;
+    }
+    *p = q;
+    *alloc = a;
+    return 0;
+}
+
+// same for the buffers kept by the cache, which are accounted
+static int buffer_grow(void** p, size_t* alloc, size_t n, size_t size) {
+    if (n <= *alloc) {
+        return 0;
+    }
+    size_t a = *alloc ? *alloc : 16;
+    while (a < n) {
+        a *= 2;
+    }
+    void* q = WASM_REALLOC(*p, a * size, WASM_MEMORY_BUFFER);
+    if (!q) {
+        return -1;
+    }
+    *p = q;
+    *alloc = a;
+    return 0;
+}
+
+// parse statistics are only collected in builds with GDS_STATS
+#ifdef GDS_STATS
+#define PARSE_STATS(s) s
+
+static uint64_t parse_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// allocations of an array that grew by doubling from first to alloc items
+static void arena_count(wasm_parse_stats_t* st, size_t alloc, size_t first, size_t size) {
+    for (size_t a = first; alloc && a <= alloc; a *= 2) {
+        st->arena_allocs++;
+    }
+    st->arena_bytes += alloc * size;
+}
+
+static void arena_stats(const parse_arena_t* ar, wasm_parse_stats_t* st) {
+    arena_count(st, ar->ael, 16, sizeof(wasm_cached_element_t));
+    arena_count(st, ar->apel, 16, sizeof(parse_element_t));
+    arena_count(st, ar->atext, 16, sizeof(wasm_text_data_t));
+    arena_count(st, ar->aref, 16, sizeof(wasm_reference_data_t));
+    arena_count(st, ar->apoly, 16, sizeof(parse_polygon_t));
+    arena_count(st, ar->axy, 16, sizeof(int32_t));
+    arena_count(st, ar->aprop, 16, sizeof(parse_property_t));
+    arena_count(st, ar->astr, 16, 1);
+    arena_count(st, ar->ahash, 64, sizeof(size_t));
+}
+
+// adds the statistics of a structure; structures may be parsed in parallel
+static void parse_stats_add(wasm_parse_stats_t* to, const wasm_parse_stats_t* st) {
+    uint64_t* t = (uint64_t*)to;
+    const uint64_t* s = (const uint64_t*)st;
+    for (size_t k = 0; k < WASM_PARSE_STATS_COUNT; k++) {
+        __atomic_add_fetch(&t[k], s[k], __ATOMIC_RELAXED);
+    }
+}
+#else
+#define PARSE_STATS(s)
+#endif
+
+static void arena_free(parse_arena_t* ar) {
+    free(ar->el);
+    free(ar->pel);
+    free(ar->text);
+    free(ar->ref);
+    free(ar->poly);
+    free(ar->xy);
+    free(ar->prop);
+    free(ar->str);
+    free(ar->hash);
+}
+
+static size_t string_hash(const char* s, size_t n) {
+    uint32_t h = 2166136261u;
+    for (size_t k = 0; k < n; k++) {
+        h = (h ^ (uint8_t)s[k]) * 16777619u;
+    }
+    return h;
+}
+
+/*
+ * Adds the string of a GDSII record (padded with NUL) to the string pool
+ * unless it is already there, and returns its offset in *off. Offset 0 is
+ * the empty string.
+ */
+static int arena_intern(parse_arena_t* ar, const uint8_t* data, size_t len, size_t* off) {
+    const char* s = (const char*)data;
+    while (len > 0 && s[len - 1] == '\0') {
+        len--;
+    }
+    if (len == 0) {
+        *off = 0;
+        return 0;
+    }
+
+    // the table is kept at most half full
+    if (2 * (ar->nhash + 1) > ar->ahash) {
+        size_t a = ar->ahash ? 2 * ar->ahash : 64;
+        size_t* h = calloc(a, sizeof(size_t));
+        if (!h) {
+            return -1;
+        }
+        for (size_t k = 0; k < ar->ahash; k++) {
+            if (ar->hash[k]) {
+                const char* t = ar->str + ar->hash[k];
+                size_t i = string_hash(t, strlen(t)) & (a - 1);
+                while (h[i]) i = (i + 1) & (a - 1);
+                h[i] = ar->hash[k];
+            }
+        }
+        free(ar->hash);
+        ar->hash = h;
+        ar->ahash = a;
+    }
+
+    size_t i = string_hash(s, len) & (ar->ahash - 1);
+    while (ar->hash[i]) {
+        const char* t = ar->str + ar->hash[i];
+        if (strncmp(t, s, len) == 0 && t[len] == '\0') {
+            *off = ar->hash[i];
+            return 0;
+        }
+        i = (i + 1) & (ar->ahash - 1);
+    }
+
+    if (arena_grow((void**)&ar->str, &ar->astr, ar->nstr + len + 2, 1) != 0) {
+        return -1;
+    }
+    if (ar->nstr == 0) {
+        ar->str[ar->nstr++] = '\0';
+    }
+    memcpy(ar->str + ar->nstr, s, len);
+    ar->str[ar->nstr + len] = '\0';
+    *off = ar->nstr;
+    ar->hash[i] = ar->nstr;
+    ar->nhash++;
+    ar->nstr += len + 1;
+    return 0;
+}
+
+// starts a new element in the arena
+static wasm_cached_element_t* arena_add_element(parse_arena_t* ar, element_kind kind) {
+    if (arena_grow((void**)&ar->el, &ar->ael, ar->nel + 1, sizeof(wasm_cached_element_t)) != 0 ||
+        arena_grow((void**)&ar->pel, &ar->apel, ar->nel + 1, sizeof(parse_element_t)) != 0) {
+        return NULL;
+    }
+
+    // Texts and references get a record in their side table; the
+    // element points to it when the structure is complete
+    wasm_strans_t* strans = NULL;
+    size_t side = 0;
+    if (kind == GDS_TEXT) {
+        if (arena_grow((void**)&ar->text, &ar->atext, ar->ntext + 1, sizeof(wasm_text_data_t)) != 0) {
+            return NULL;
+        }
+        side = ar->ntext++;
+        memset(&ar->text[side], 0, sizeof(wasm_text_data_t));
+        strans = &ar->text[side].strans;
+    } else if (kind == GDS_SREF || kind == GDS_AREF) {
+        if (arena_grow((void**)&ar->ref, &ar->aref, ar->nref + 1, sizeof(wasm_reference_data_t)) != 0) {
+            return NULL;
+        }
+        side = ar->nref++;
+        memset(&ar->ref[side], 0, sizeof(wasm_reference_data_t));
+        strans = &ar->ref[side].strans;
+    }
+
+    // Texts and references without MAG record are not magnified
+    if (strans) {
+        strans->magnification = 1.0;
+    }
+
+    wasm_cached_element_t* element = &ar->el[ar->nel];
+    memset(element, 0, sizeof(wasm_cached_element_t));
+    element->kind = (uint8_t)kind;
+
+    parse_element_t* pe = &ar->pel[ar->nel++];
+    pe->polygon = ar->npoly;
+    pe->property = ar->nprop;
+    pe->text = 0;
+    pe->sname = 0;
+    pe->side = side;
+
+    return element;
+}
+
+/**
+ * Reads the vertices of an XY record into the polygons of the current
+ * (last) element of the arena.
+ *
+ * Boundaries and paths may have several XY records, each one a polygon.
+ * A full record (MAX_XY_VERTICES vertices) is continued by the next
+ * record when that record starts with the last vertex of the full one;
+ * this is how polygons with more vertices than fit into a single record
+ * are written. Boxes and nodes keep only the last XY record.
+ *
+ * @param ar Arena of the structure being parsed
+ * @param data XY record data
+ * @param vertex_count Number of vertices in the record
+ * @param last_count Vertices in the previous XY record of the element (updated)
+ * @return 0 on success, -1 on allocation failure
+ */
+static int arena_read_xy(parse_arena_t* ar, const uint8_t* data,
+                         int vertex_count, int* last_count) {
+    wasm_cached_element_t* element = &ar->el[ar->nel - 1];
+    parse_polygon_t* poly = NULL;
+    int skip = 0;
+
+    if (element->polygon_count > 0 &&
+        element->kind != GDS_BOUNDARY && element->kind != GDS_PATH) {
+        // Only the last XY record is used
+        ar->npoly = ar->pel[ar->nel - 1].polygon;
+        element->polygon_count = 0;
+    }
+
+    // Room for the vertices; the polygons of the element are the last
+    // ones in the slab, so a continued polygon stays contiguous
+    if (arena_grow((void**)&ar->xy, &ar->axy, ar->nxy + 2 * (size_t)vertex_count,
+                   sizeof(int32_t)) != 0) {
+        return -1;
+    }
+    int32_t* v = ar->xy + ar->nxy;
+    for (size_t k = 0; k < 2 * (size_t)vertex_count; k++) {
+        v[k] = (int32_t)get_be32(data + 4 * k);
+    }
+
+    // The first vertex tells if the record continues the previous one
+    if (element->polygon_count > 0 && *last_count == MAX_XY_VERTICES) {
+        parse_polygon_t* prev = &ar->poly[ar->npoly - 1];
+        if (v[-2] == v[0] && v[-1] == v[1]) {
+            poly = prev;
+            skip = 1;
+        }
+    }
+    *last_count = vertex_count;
+
+    if (!poly) {
+        if (arena_grow((void**)&ar->poly, &ar->apoly, ar->npoly + 1, sizeof(parse_polygon_t)) != 0) {
+            return -1;
+        }
+        poly = &ar->poly[ar->npoly++];
+        poly->xy = ar->nxy;
+        poly->vertex_count = 0;
+        element->polygon_count++;
+    } else {
+        memmove(v, v + 2, 2 * (size_t)(vertex_count - 1) * sizeof(int32_t));
+    }
+
+    int added = vertex_count - skip;
+    ar->nxy += 2 * (size_t)added;
+    poly->vertex_count += added;
+
+    // Extend the element bounds
+    for (int k = 0; k < added; k++) {
+        int32_t x = v[2 * k], y = v[2 * k + 1];
+        if (element->polygon_count == 1 && poly->vertex_count == added && k == 0) {
+            element->bounds[0] = element->bounds[2] = x;
+            element->bounds[1] = element->bounds[3] = y;
+        }
+        if (x < element->bounds[0]) element->bounds[0] = x;
+        if (y < element->bounds[1]) element->bounds[1] = y;
+        if (x > element->bounds[2]) element->bounds[2] = x;
+        if (y > element->bounds[3]) element->bounds[3] = y;
+    }
+
+    return 0;
+}
+
+/*
+ * Copies the arrays of the arena into one block owned by the structure
+ * and resolves the offsets.
+ */
+static int arena_finish(parse_arena_t* ar, wasm_structure_cache_t* sc) {
+    // an empty string pool still holds the empty string at offset 0
+    size_t nstr = ar->nstr ? ar->nstr : 1;
+    size_t o_el = 0;
+    size_t o_text = o_el + ARENA_ALIGN(ar->nel * sizeof(wasm_cached_element_t));
+    size_t o_ref = o_text + ARENA_ALIGN(ar->ntext * sizeof(wasm_text_data_t));
+    size_t o_poly = o_ref + ARENA_ALIGN(ar->nref * sizeof(wasm_reference_data_t));
+    size_t o_prop = o_poly + ARENA_ALIGN(ar->npoly * sizeof(wasm_polygon_t));
+    size_t o_xy = o_prop + ARENA_ALIGN(ar->nprop * sizeof(wasm_property_t));
+    size_t o_str = o_xy + ar->nxy * sizeof(int32_t);
+    size_t total = o_str + nstr;
+
+    uint8_t* block = WASM_MALLOC(total, WASM_MEMORY_ELEMENT);
+    if (!block) {
+        return -1;
+    }
+
+    wasm_cached_element_t* el = (wasm_cached_element_t*)(block + o_el);
+    wasm_text_data_t* text = (wasm_text_data_t*)(block + o_text);
+    wasm_reference_data_t* ref = (wasm_reference_data_t*)(block + o_ref);
+    wasm_polygon_t* poly = (wasm_polygon_t*)(block + o_poly);
+    wasm_property_t* prop = (wasm_property_t*)(block + o_prop);
+    int32_t* xy = (int32_t*)(block + o_xy);
+    char* str = (char*)(block + o_str);
+
+    if (ar->nel) memcpy(el, ar->el, ar->nel * sizeof(wasm_cached_element_t));
+    if (ar->ntext) memcpy(text, ar->text, ar->ntext * sizeof(wasm_text_data_t));
+    if (ar->nref) memcpy(ref, ar->ref, ar->nref * sizeof(wasm_reference_data_t));
+    if (ar->nxy) memcpy(xy, ar->xy, ar->nxy * sizeof(int32_t));
+    if (ar->nstr) memcpy(str, ar->str, ar->nstr);
+    str[0] = '\0';
+
+    for (size_t k = 0; k < ar->npoly; k++) {
+        poly[k].vertices = xy + ar->poly[k].xy;
+        poly[k].vertex_count = ar->poly[k].vertex_count;
+    }
+    for (size_t k = 0; k < ar->nprop; k++) {
+        prop[k].attribute = ar->prop[k].attribute;
+        prop[k].value = str + ar->prop[k].value;
+    }
+    for (size_t k = 0; k < ar->nel; k++) {
+        const parse_element_t* pe = &ar->pel[k];
+        el[k].polygons = el[k].polygon_count ? poly + pe->polygon : NULL;
+        el[k].properties = el[k].property_count ? prop + pe->property : NULL;
+        if (el[k].kind == GDS_TEXT) {
+            el[k].data.text = text + pe->side;
+            el[k].data.text->text = str + pe->text;
+        } else if (el[k].kind == GDS_SREF || el[k].kind == GDS_AREF) {
+            el[k].data.reference = ref + pe->side;
+            el[k].data.reference->structure_name = str + pe->sname;
+        }
     }
 
-    double min_x = vertices[0], max_x = vertices[0];
-    double min_y = vertices[1], max_y = vertices[1];
+    sc->arena = block;
+    sc->arena_size = total;
+    sc->elements = ar->nel ? el : NULL;
+    sc->element_count = (int)ar->nel;
+    sc->element_capacity = (int)ar->nel;
+    return 0;
+}
+
+// transformation of the current text or reference of the arena, or NULL
+static wasm_strans_t* arena_strans(parse_arena_t* ar, const wasm_cached_element_t* element) {
+    size_t side = ar->pel[ar->nel - 1].side;
+    if (element->kind == GDS_TEXT) return &ar->text[side].strans;
+    if (element->kind == GDS_SREF || element->kind == GDS_AREF) return &ar->ref[side].strans;
+    return NULL;
+}
+
+/*
+ * Stores the XY record of an element: polygons of boundaries, paths,
+ * boxes and nodes, the position of texts and SREFs and the lattice
+ * vectors of AREFs.
+ */
+static int read_element_xy(parse_arena_t* ar, wasm_cached_element_t* element,
+                           const uint8_t* rec, int vertex_count, int* last_count) {
+    const parse_element_t* pe = &ar->pel[ar->nel - 1];
+    int32_t xy[6];
+    int n = 1;
+
+    switch (element->kind) {
+        case GDS_BOUNDARY:
+        case GDS_PATH:
+        case GDS_BOX:
+        case GDS_NODE:
+            return arena_read_xy(ar, rec, vertex_count, last_count);
+
+        case GDS_TEXT:
+            // TEXT has exactly 1 point (text position)
+            xy[0] = (int32_t)get_be32(rec);
+            xy[1] = (int32_t)get_be32(rec + 4);
+            ar->text[pe->side].x = xy[0];
+            ar->text[pe->side].y = xy[1];
+            break;
+
+        case GDS_SREF:
+            // SREF has exactly 1 point (reference position); the bounds
+            // will be expanded by hierarchy resolution
+            xy[0] = (int32_t)get_be32(rec);
+            xy[1] = (int32_t)get_be32(rec + 4);
+            ar->ref[pe->side].x = xy[0];
+            ar->ref[pe->side].y = xy[1];
+            break;
+
+        case GDS_AREF:
+            // AREF has exactly 3 points (origin, col_pt, row_pt); the
+            // array spans from the origin to the farthest corner
+            if (vertex_count < 3) return 0;
+            for (int k = 0; k < 6; k++) {
+                xy[k] = (int32_t)get_be32(rec + 4 * k);
+            }
+            ar->ref[pe->side].x = xy[0];
+            ar->ref[pe->side].y = xy[1];
+            memcpy(ar->ref[pe->side].corners, xy + 2, 4 * sizeof(int32_t));
+            n = 3;
+            break;
 
-    for (int i = 1; i < vertex_count; i++) {
-        double x = vertices[i * 2];
-        double y = vertices[i * 2 + 1];
+        default:
+            return 0;
+    }
 
-        if (x < min_x) min_x = x;
-        if (x > max_x) max_x = x;
-        if (y < min_y) min_y = y;
-        if (y > max_y) max_y = y;
+    element->bounds[0] = element->bounds[2] = xy[0];
+    element->bounds[1] = element->bounds[3] = xy[1];
+    for (int k = 1; k < n; k++) {
+        if (xy[2*k] < element->bounds[0]) element->bounds[0] = xy[2*k];
+        if (xy[2*k] > element->bounds[2]) element->bounds[2] = xy[2*k];
+        if (xy[2*k+1] < element->bounds[1]) element->bounds[1] = xy[2*k+1];
+        if (xy[2*k+1] > element->bounds[3]) element->bounds[3] = xy[2*k+1];
     }
 
-    bounds[0] = min_x;
-    bounds[1] = min_y;
-    bounds[2] = max_x;
-    bounds[3] = max_y;
+    return 0;
 }
 
 // ============================================================================
@@ -106,7 +591,7 @@ wasm_library_cache_t* wasm_create_library_cache(uint8_t* data, size_t size) {
         return NULL;
     }
 
-    wasm_library_cache_t* cache = malloc(sizeof(wasm_library_cache_t));
+    wasm_library_cache_t* cache = WASM_MALLOC(sizeof(wasm_library_cache_t), WASM_MEMORY_CACHE);
     if (!cache) {
         return NULL;
     }
@@ -119,7 +604,7 @@ wasm_library_cache_t* wasm_create_library_cache(uint8_t* data, size_t size) {
     // Create memory file handle
     cache->mem_file = wasm_fopen(data, size);
     if (!cache->mem_file) {
-        free(cache);
+        WASM_FREE(cache);
         return NULL;
     }
 
@@ -198,43 +683,34 @@ void wasm_free_library_cache(wasm_library_cache_t* cache) {
         return;
     }
 
+    // Parse workers must not outlive the cache
+    wasm_wait_parallel_parse(cache);
+
     // Free structures
     if (cache->structures) {
         for (int i = 0; i < cache->structure_count; i++) {
             wasm_structure_cache_t* struct_cache = &cache->structures[i];
 
-            // Free elements
-            if (struct_cache->elements) {
-                for (int j = 0; j < struct_cache->element_count; j++) {
-                    wasm_cached_element_t* element = &struct_cache->elements[j];
-
-                    // Free polygons
-                    if (element->polygons) {
-                        for (int k = 0; k < element->polygon_count; k++) {
-                            if (element->polygons[k].vertices) {
-                                free(element->polygons[k].vertices);
-                            }
-                        }
-                        free(element->polygons);
-                    }
-
-                    // Free properties
-                    if (element->properties) {
-                        free(element->properties);
-                    }
-                }
-                free(struct_cache->elements);
+            // Elements, polygons, vertices, properties and strings;
+            // the arenas of a snapshot are part of the file buffer
+            if (!cache->arenas_in_data) {
+                WASM_FREE(struct_cache->arena);
             }
         }
-        free(cache->structures);
+        WASM_FREE(cache->structures);
     }
 
     // Close memory file
     if (cache->mem_file) {
         mem_fclose(cache->mem_file);
+        free(cache->mem_file);
+    }
+    if (cache->owns_data) {
+        WASM_FREE(cache->raw_data);
     }
 
-    free(cache);
+    WASM_FREE(cache->vertex_buffer);
+    WASM_FREE(cache);
 }
 
 // ============================================================================
@@ -272,7 +748,8 @@ int wasm_parse_library_structures(wasm_library_cache_t* cache) {
 
     // Allocate structure array
     cache->structure_capacity = structure_count + 16; // Extra space
-    cache->structures = malloc(cache->structure_capacity * sizeof(wasm_structure_cache_t));
+    cache->structures = WASM_MALLOC(cache->structure_capacity * sizeof(wasm_structure_cache_t),
+                                   WASM_MEMORY_CACHE);
     if (!cache->structures) {
         return -1;
     }
@@ -325,6 +802,162 @@ int wasm_parse_library_structures(wasm_library_cache_t* cache) {
     return 0;
 }
 
+// ============================================================================
+// STREAMING INGESTION
+// ============================================================================
+
+#define STREAM_INITIAL_SIZE 65536
+
+wasm_library_cache_t* wasm_create_stream_cache(size_t size_hint) {
+    wasm_library_cache_t* cache = WASM_MALLOC(sizeof(wasm_library_cache_t), WASM_MEMORY_CACHE);
+    if (!cache) {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(wasm_library_cache_t));
+
+    // With the expected size the file is received without reallocation
+    cache->data_alloc = size_hint ? size_hint : STREAM_INITIAL_SIZE;
+    cache->raw_data = WASM_MALLOC(cache->data_alloc, WASM_MEMORY_BUFFER);
+    cache->owns_data = 1;
+    if (cache->raw_data) {
+        cache->mem_file = wasm_fopen(cache->raw_data, cache->data_alloc);
+    }
+    if (!cache->mem_file) {
+        wasm_free_library_cache(cache);
+        return NULL;
+    }
+    cache->mem_file->size = 0;
+
+    return cache;
+}
+
+uint8_t* wasm_stream_reserve(wasm_library_cache_t* cache, size_t size) {
+    if (!cache || !cache->owns_data || cache->stream_complete) {
+        return NULL;
+    }
+
+    if (buffer_grow((void**)&cache->raw_data, &cache->data_alloc, cache->data_size + size, 1) != 0) {
+        return NULL;
+    }
+    cache->mem_file->data = cache->raw_data;
+
+    return cache->raw_data + cache->data_size;
+}
+
+/*
+ * Scans the complete records from scan_pos on. Only the library header
+ * and the structure boundaries are read here; the elements of a structure
+ * are parsed when they are first accessed.
+ */
+static int stream_scan(wasm_library_cache_t* cache) {
+    const uint8_t* data = cache->raw_data;
+
+    while (!cache->stream_complete && cache->scan_pos + 4 <= cache->data_size) {
+        size_t pos = cache->scan_pos;
+        uint16_t record_length = get_be16(data + pos);
+        uint16_t record_type = get_be16(data + pos + 2);
+        if (record_length < 4 || (pos == 0 && record_type != HEADER)) {
+            return -1; // Not a GDSII file or corrupted record
+        }
+        if (pos + record_length > cache->data_size) {
+            break; // The rest of the record is still to come
+        }
+        const uint8_t* rec = data + pos + 4;
+        size_t len = record_length - 4;
+        cache->scan_pos += record_length;
+
+        switch (record_type) {
+            case HEADER:
+                if (len == 2) cache->version = get_be16(rec);
+                break;
+            case LIBNAME: {
+                size_t n = len < sizeof(cache->name) - 1 ? len : sizeof(cache->name) - 1;
+                memcpy(cache->name, rec, n);
+                cache->name[n] = '\0';
+                break;
+            }
+            case UNITS:
+                if (len == 16) {
+                    cache->user_units_per_db_unit = get_real(rec);
+                    cache->meters_per_db_unit = get_real(rec + 8);
+                }
+                break;
+            case BGNSTR:
+                // The structure is counted when its ENDSTR arrives
+                if (cache->structure_count + 1 > cache->structure_capacity) {
+                    int capacity = cache->structure_capacity ? 2 * cache->structure_capacity : 16;
+                    wasm_structure_cache_t* s = WASM_REALLOC(cache->structures,
+                                                             capacity * sizeof(wasm_structure_cache_t),
+                                                             WASM_MEMORY_CACHE);
+                    if (!s) {
+                        return -1;
+                    }
+                    cache->structures = s;
+                    cache->structure_capacity = capacity;
+                }
+                memset(&cache->structures[cache->structure_count], 0, sizeof(wasm_structure_cache_t));
+                cache->structures[cache->structure_count].file_offset = (long)pos;
+                cache->stream_open = 1;
+                break;
+            case STRNAME:
+                if (cache->stream_open) {
+                    char* name = cache->structures[cache->structure_count].name;
+                    size_t n = len < MAX_STRUCTURE_NAME_LEN - 1 ? len : MAX_STRUCTURE_NAME_LEN - 1;
+                    memcpy(name, rec, n);
+                    name[n] = '\0';
+                }
+                break;
+            case ENDSTR:
+                if (cache->stream_open) {
+                    wasm_structure_cache_t* sc = &cache->structures[cache->structure_count];
+                    sc->data_size = cache->scan_pos - (size_t)sc->file_offset;
+                    cache->structure_count++;
+                    cache->stream_open = 0;
+                }
+                break;
+            case ENDLIB:
+                cache->stream_complete = 1;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return cache->structure_count;
+}
+
+int wasm_stream_commit(wasm_library_cache_t* cache, size_t size) {
+    if (!cache || !cache->owns_data || cache->data_size + size > cache->data_alloc) {
+        return -1;
+    }
+
+    cache->data_size += size;
+    cache->mem_file->size = cache->data_size;
+    return stream_scan(cache);
+}
+
+int wasm_stream_push(wasm_library_cache_t* cache, const uint8_t* data, size_t size) {
+    if (!data && size > 0) {
+        return -1;
+    }
+
+    uint8_t* p = wasm_stream_reserve(cache, size);
+    if (!p) {
+        return -1;
+    }
+    if (size > 0) {
+        memcpy(p, data, size);
+    }
+    return wasm_stream_commit(cache, size);
+}
+
+int wasm_stream_finish(wasm_library_cache_t* cache) {
+    if (!cache || !cache->owns_data) {
+        return -1;
+    }
+    return cache->stream_complete && !cache->stream_open ? 0 : -1;
+}
+
 // ============================================================================
 // PROPERTY ACCESSORS
 // ============================================================================
@@ -386,253 +1019,163 @@ int wasm_parse_structure_elements(wasm_library_cache_t* cache, int structure_ind
         return 0; // Already parsed
     }
 
-    // Seek to structure start
-    mem_fseek(cache->mem_file, struct_cache->file_offset, SEEK_SET);
-
-    // Count elements in structure
-    int element_count = 0;
-    size_t pos = struct_cache->file_offset;
-    uint16_t record_type, record_length;
-    int in_structure = 0;
+    parse_arena_t ar;
+    memset(&ar, 0, sizeof(parse_arena_t));
+    PARSE_STATS(wasm_parse_stats_t st; memset(&st, 0, sizeof(st)); uint64_t t0 = parse_ns());
+
+    // One pass over the records of the structure; the record data are
+    // read in place from the file buffer
+    const uint8_t* data = cache->mem_file->data;
+    size_t size = cache->mem_file->size;
+    size_t pos = (size_t)struct_cache->file_offset;
+    wasm_cached_element_t* element = NULL;
+    int last_xy_count = 0;
+    int status = 0;
+
+    while (status == 0 && pos + 4 <= size) {
+        uint16_t record_length = ((uint16_t)data[pos] << 8) | data[pos + 1];
+        uint16_t record_type = ((uint16_t)data[pos + 2] << 8) | data[pos + 3];
+        if (record_length < 4 || pos + record_length > size) {
+            break; // Truncated or corrupted record
+        }
+        const uint8_t* rec = data + pos + 4;
+        size_t len = record_length - 4;
+        pos += record_length;
+        PARSE_STATS(st.records++; st.bytes += record_length);
 
-    while (pos + 4 <= cache->data_size) {
-        if (!mem_fread_gdsii_header(cache->mem_file, &record_type, &record_length)) {
-            break;
+        if (record_type == ENDSTR) {
+            break; // End of our structure
         }
 
-        if (record_type == BGNSTR) {
-            in_structure = 1;
-        } else if (record_type == ENDSTR) {
-            if (in_structure) {
-                break; // End of our structure
+        if (record_type == BOUNDARY || record_type == PATH || record_type == TEXT ||
+            record_type == SREF || record_type == AREF || record_type == BOX ||
+            record_type == NODE) {
+            element = arena_add_element(&ar, map_record_type_to_element_kind(record_type));
+            last_xy_count = 0;
+            if (!element) {
+                status = -1;
             }
-        } else if (in_structure &&
-                  (record_type == BOUNDARY || record_type == PATH || record_type == TEXT ||
-                   record_type == SREF || record_type == AREF || record_type == BOX ||
-                   record_type == NODE)) {
-            element_count++;
+            PARSE_STATS(if (element) st.elements[element->kind & 7]++);
+            continue;
         }
 
-        pos += 4 + record_length;
-        mem_fseek(cache->mem_file, pos, SEEK_SET);
-    }
+        if (!element) {
+            continue; // BGNSTR, STRNAME, ...
+        }
 
-    if (element_count == 0) {
-        struct_cache->is_fully_parsed = 1;
-        return 0;
+        parse_element_t* pe = &ar.pel[ar.nel - 1];
+        wasm_strans_t* strans = arena_strans(&ar, element);
+
+        switch (record_type) {
+            case ENDEL:
+                element = NULL;
+                break;
+            case LAYER:
+                if (len == 2) element->layer = get_be16(rec);
+                break;
+            case DATATYPE:
+                if (len == 2) element->dtype = get_be16(rec);
+                break;
+            case TEXTTYPE:
+            case BOXTYPE:
+            case NODETYPE:
+                if (len == 2) element->dtype = get_be16(rec);
+                break;
+            case PRESENTATION:
+                if (len == 2 && element->kind == GDS_TEXT) {
+                    ar.text[pe->side].presentation = get_be16(rec);
+                }
+                break;
+            case ELFLAGS:
+                if (len == 2) element->elflags = get_be16(rec);
+                break;
+            case PLEX:
+                if (len == 4) element->plex = (int32_t)get_be32(rec);
+                break;
+            case PATHTYPE:
+                if (len == 2 && element->kind == GDS_PATH) {
+                    element->data.path.ptype = get_be16(rec);
+                }
+                break;
+            case WIDTH:
+                if (len == 4 && element->kind == GDS_PATH) {
+                    element->data.path.width = (float)(int32_t)get_be32(rec);
+                }
+                break;
+            case BGNEXTN:
+                if (len == 4 && element->kind == GDS_PATH) {
+                    element->data.path.begin_extension = (float)(int32_t)get_be32(rec);
+                }
+                break;
+            case ENDEXTN:
+                if (len == 4 && element->kind == GDS_PATH) {
+                    element->data.path.end_extension = (float)(int32_t)get_be32(rec);
+                }
+                break;
+            case STRANS:
+                if (len == 2 && strans) strans->flags = get_be16(rec);
+                break;
+            case MAG:
+                if (len == 8 && strans) strans->magnification = get_real(rec);
+                break;
+            case ANGLE:
+                if (len == 8 && strans) strans->rotation_angle = get_real(rec);
+                break;
+            case COLROW:
+                if (len == 4 && element->kind == GDS_AREF) {
+                    ar.ref[pe->side].ncol = get_be16(rec);
+                    ar.ref[pe->side].nrow = get_be16(rec + 2);
+                }
+                break;
+            case STRING:
+                status = arena_intern(&ar, rec, len, &pe->text);
+                break;
+            case SNAME:
+                status = arena_intern(&ar, rec, len, &pe->sname);
+                break;
+            case PROPATTR:
+                if (len == 2) {
+                    status = arena_grow((void**)&ar.prop, &ar.aprop, ar.nprop + 1,
+                                        sizeof(parse_property_t));
+                    if (status == 0) {
+                        ar.prop[ar.nprop].attribute = get_be16(rec);
+                        ar.prop[ar.nprop].value = 0;
+                        ar.nprop++;
+                        element->property_count++;
+                    }
+                }
+                break;
+            case PROPVALUE:
+                if (element->property_count > 0) {
+                    status = arena_intern(&ar, rec, len, &ar.prop[ar.nprop - 1].value);
+                }
+                break;
+            case XY:
+                // XY coordinates are ALWAYS 32-bit signed integers in GDSII
+                if (len >= 8) {
+                    status = read_element_xy(&ar, element, rec, (int)(len / 8), &last_xy_count);
+                    PARSE_STATS(st.vertices += len / 8);
+                }
+                break;
+            default:
+                break; // Skip unknown records
+        }
     }
 
-    // Allocate element array
-    struct_cache->element_capacity = element_count;
-    struct_cache->elements = malloc(element_count * sizeof(wasm_cached_element_t));
-    if (!struct_cache->elements) {
+    if (status == 0) {
+        status = arena_finish(&ar, struct_cache);
+    }
+    PARSE_STATS(arena_stats(&ar, &st); st.parse_ns = parse_ns() - t0;
+                parse_stats_add(&cache->parse_stats, &st));
+    arena_free(&ar);
+    if (status != 0) {
         return -1;
     }
 
-    memset(struct_cache->elements, 0, element_count * sizeof(wasm_cached_element_t));
-
-    // Parse elements
-    mem_fseek(cache->mem_file, struct_cache->file_offset, SEEK_SET);
-    pos = struct_cache->file_offset;
-    int current_element = 0;
-    in_structure = 0;
-
-    while (pos + 4 <= cache->data_size && current_element < element_count) {
-        if (!mem_fread_gdsii_header(cache->mem_file, &record_type, &record_length)) {
-            break;
-        }
-
-        if (record_type == BGNSTR) {
-            in_structure = 1;
-        } else if (record_type == ENDSTR) {
-            if (in_structure) {
-                break; // End of our structure
-            }
-        } else if (in_structure && current_element < element_count &&
-                  (record_type == BOUNDARY || record_type == PATH || record_type == TEXT ||
-                   record_type == SREF || record_type == AREF || record_type == BOX ||
-                   record_type == NODE)) {
-
-            wasm_cached_element_t* element = &struct_cache->elements[current_element];
-            element->kind = map_record_type_to_element_kind(record_type);
-
-            // Parse element data (simplified - full implementation would use existing gds_read_element logic)
-            (void)record_type; // Mark record_type as used to suppress warning
-            pos += 4; // Skip element header
-            mem_fseek(cache->mem_file, pos, SEEK_SET);
-
-            // Parse element properties
-            uint16_t prop_type, prop_length;
-            int layer_set = 0, dtype_set = 0;
-
-            while (pos + 4 <= cache->data_size) {
-                if (!mem_fread_gdsii_header(cache->mem_file, &prop_type, &prop_length)) {
-                    break;
-                }
-
-                if (prop_type == ENDEL) {
-                    break; // End of element
-                }
-
-                switch (prop_type) {
-                    case LAYER:
-                        if (prop_length == 2) {
-                            mem_fread_be16(cache->mem_file, &element->layer);
-                            layer_set = 1;
-                        }
-                        break;
-                    case DATATYPE:
-                        if (prop_length == 2) {
-                            mem_fread_be16(cache->mem_file, &element->dtype);
-                            dtype_set = 1;
-                        }
-                        break;
-                    case ELFLAGS:
-                        if (prop_length == 2) {
-                            mem_fread_be16(cache->mem_file, &element->elflags);
-                        }
-                        break;
-                    case PLEX:
-                        if (prop_length == 4) {
-                            mem_fread_be32(cache->mem_file, (uint32_t*)&element->plex);
-                        }
-                        break;
-                    case XY:
-                        // Parse coordinate data - XY coordinates are ALWAYS 32-bit signed integers in GDSII
-                        if (prop_length >= 8) {
-                            // Each coordinate is 4 bytes (32-bit), so each vertex (x,y) is 8 bytes
-                            int vertex_count = prop_length / 8;
-                            
-                            if (element->kind == GDS_BOUNDARY || element->kind == GDS_PATH || 
-                                element->kind == GDS_BOX || element->kind == GDS_NODE) {
-                                // These elements have polygon/path/node data
-                                if (vertex_count > 0) {
-                                    element->polygon_count = 1;
-                                    element->polygons = malloc(sizeof(wasm_polygon_t));
-                                    if (element->polygons) {
-                                        element->polygons[0].vertices = malloc(vertex_count * 2 * sizeof(double));
-                                        if (element->polygons[0].vertices) {
-                                            element->polygons[0].vertex_count = vertex_count;
-                                            element->polygons[0].capacity = vertex_count;
-
-                                            // Read vertices (big-endian 32-bit signed integers, convert to double)
-                                            for (int i = 0; i < vertex_count; i++) {
-                                                int32_t x_int, y_int;
-                                                mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                                mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                                element->polygons[0].vertices[i * 2] = (double)x_int;
-                                                element->polygons[0].vertices[i * 2 + 1] = (double)y_int;
-                                            }
-
-                                            // Calculate bounds
-                                            calculate_bounds_from_vertices(element->polygons[0].vertices,
-                                                                      vertex_count, element->bounds);
-                                        }
-                                    }
-                                }
-                            } else if (element->kind == GDS_TEXT) {
-                                // TEXT has exactly 1 point (text position)
-                                if (vertex_count >= 1) {
-                                    int32_t x_int, y_int;
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                    element->text_data.x = (double)x_int;
-                                    element->text_data.y = (double)y_int;
-                                    
-                                    // Set bounds to text position
-                                    element->bounds[0] = element->bounds[2] = element->text_data.x;
-                                    element->bounds[1] = element->bounds[3] = element->text_data.y;
-                                }
-                            } else if (element->kind == GDS_SREF) {
-                                // SREF has exactly 1 point (reference position)
-                                if (vertex_count >= 1) {
-                                    int32_t x_int, y_int;
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                    element->reference_data.x = (double)x_int;
-                                    element->reference_data.y = (double)y_int;
-                                    
-                                    // Set bounds to reference position (will be expanded by hierarchy resolution)
-                                    element->bounds[0] = element->bounds[2] = element->reference_data.x;
-                                    element->bounds[1] = element->bounds[3] = element->reference_data.y;
-                                }
-                            } else if (element->kind == GDS_AREF) {
-                                // AREF has exactly 3 points (origin, col_pt, row_pt)
-                                if (vertex_count >= 3) {
-                                    int32_t x_int, y_int;
-                                    
-                                    // Origin point (reference position)
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                    element->reference_data.x = (double)x_int;
-                                    element->reference_data.y = (double)y_int;
-                                    
-                                    // Column point (defines column spacing vector)
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                    element->reference_data.corners[0] = (double)x_int;
-                                    element->reference_data.corners[1] = (double)y_int;
-                                    
-                                    // Row point (defines row spacing vector)
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&x_int);
-                                    mem_fread_be32(cache->mem_file, (uint32_t*)&y_int);
-                                    element->reference_data.corners[2] = (double)x_int;
-                                    element->reference_data.corners[3] = (double)y_int;
-                                    
-                                    // Calculate bounding box from array extent
-                                    // The array spans from origin to the farthest corner
-                                    double min_x = element->reference_data.x;
-                                    double max_x = element->reference_data.x;
-                                    double min_y = element->reference_data.y;
-                                    double max_y = element->reference_data.y;
-                                    
-                                    // Include column endpoint
-                                    if (element->reference_data.corners[0] < min_x) min_x = element->reference_data.corners[0];
-                                    if (element->reference_data.corners[0] > max_x) max_x = element->reference_data.corners[0];
-                                    if (element->reference_data.corners[1] < min_y) min_y = element->reference_data.corners[1];
-                                    if (element->reference_data.corners[1] > max_y) max_y = element->reference_data.corners[1];
-                                    
-                                    // Include row endpoint
-                                    if (element->reference_data.corners[2] < min_x) min_x = element->reference_data.corners[2];
-                                    if (element->reference_data.corners[2] > max_x) max_x = element->reference_data.corners[2];
-                                    if (element->reference_data.corners[3] < min_y) min_y = element->reference_data.corners[3];
-                                    if (element->reference_data.corners[3] > max_y) max_y = element->reference_data.corners[3];
-                                    
-                                    element->bounds[0] = min_x;
-                                    element->bounds[1] = min_y;
-                                    element->bounds[2] = max_x;
-                                    element->bounds[3] = max_y;
-                                }
-                            }
-                        }
-                        break;
-                    // Add more property parsing as needed
-                    default:
-                        // Skip unknown properties
-                        mem_fseek(cache->mem_file, pos + 4 + prop_length, SEEK_SET);
-                        break;
-                }
-
-                pos += 4 + prop_length;
-                mem_fseek(cache->mem_file, pos, SEEK_SET);
-            }
-
-            // Set defaults if not specified
-            if (!layer_set) element->layer = 0;
-            if (!dtype_set) element->dtype = 0;
-
-            current_element++;
-        }
-
-        pos += 4 + record_length;
-        mem_fseek(cache->mem_file, pos, SEEK_SET);
-    }
-
-    struct_cache->element_count = current_element;
-    struct_cache->is_fully_parsed = 1;
-
-    return 0;
-}
+    struct_cache->is_fully_parsed = 1;
+    __atomic_add_fetch(&cache->parsed_structures, 1, __ATOMIC_RELEASE);
+    return 0;
+}
 
 // ============================================================================
 // ELEMENT ACCESS FUNCTIONS (Basic implementations - to be expanded)
@@ -653,90 +1196,82 @@ int wasm_get_element_count(wasm_library_cache_t* cache, int structure_index) {
     return struct_cache->element_count;
 }
 
-int wasm_get_element_type(wasm_library_cache_t* cache, int structure_index, int element_index) {
+// element of a structure, which is parsed first if needed; NULL on error
+static const wasm_cached_element_t* cached_element(wasm_library_cache_t* cache,
+                                                   int structure_index, int element_index) {
     if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return -1;
+        return NULL;
     }
 
     wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
     if (!struct_cache->is_fully_parsed) {
         if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return -1;
+            return NULL;
         }
     }
 
     if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return -1;
+        return NULL;
     }
 
-    return (int)struct_cache->elements[element_index].kind;
+    return &struct_cache->elements[element_index];
 }
 
-int wasm_get_element_layer(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return -1;
+// text record of an element or NULL
+static const wasm_text_data_t* cached_text(wasm_library_cache_t* cache,
+                                           int structure_index, int element_index) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element || element->kind != GDS_TEXT) {
+        return NULL;
     }
+    return element->data.text;
+}
 
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return -1;
-        }
+// reference record of an element or NULL
+static const wasm_reference_data_t* cached_reference(wasm_library_cache_t* cache,
+                                                     int structure_index, int element_index) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element || (element->kind != GDS_SREF && element->kind != GDS_AREF)) {
+        return NULL;
     }
+    return element->data.reference;
+}
 
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return -1;
+// transformation of a text or reference or NULL
+static const wasm_strans_t* cached_strans(wasm_library_cache_t* cache,
+                                          int structure_index, int element_index) {
+    const wasm_text_data_t* text = cached_text(cache, structure_index, element_index);
+    if (text) {
+        return &text->strans;
     }
+    const wasm_reference_data_t* ref = cached_reference(cache, structure_index, element_index);
+    return ref ? &ref->strans : NULL;
+}
 
-    return struct_cache->elements[element_index].layer;
+int wasm_get_element_type(wasm_library_cache_t* cache, int structure_index, int element_index) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? (int)element->kind : -1;
 }
 
-// Additional element access functions would be implemented here...
-// For now, providing stub implementations
+int wasm_get_element_layer(wasm_library_cache_t* cache, int structure_index, int element_index) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? element->layer : -1;
+}
 
 int wasm_get_element_data_type(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    (void)cache; (void)structure_index; (void)element_index;
-    return 0; // Default
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? element->dtype : 0;
 }
 
 int wasm_get_element_polygon_count(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return -1;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return -1;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return -1;
-    }
-
-    return struct_cache->elements[element_index].polygon_count;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? element->polygon_count : -1;
 }
 
 int wasm_get_element_polygon_vertex_count(wasm_library_cache_t* cache,
                                          int structure_index, int element_index, int polygon_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return -1;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return -1;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return -1;
-    }
-
-    wasm_cached_element_t* element = &struct_cache->elements[element_index];
-    if (polygon_index < 0 || polygon_index >= element->polygon_count) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element || polygon_index < 0 || polygon_index >= element->polygon_count) {
         return -1;
     }
 
@@ -745,27 +1280,23 @@ int wasm_get_element_polygon_vertex_count(wasm_library_cache_t* cache,
 
 double* wasm_get_element_polygon_vertices(wasm_library_cache_t* cache,
                                          int structure_index, int element_index, int polygon_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element || polygon_index < 0 || polygon_index >= element->polygon_count) {
         return NULL;
     }
 
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return NULL;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
+    // The integer vertices are converted into the vertex buffer of the cache
+    const wasm_polygon_t* poly = &element->polygons[polygon_index];
+    size_t n = 2 * (size_t)poly->vertex_count;
+    if (buffer_grow((void**)&cache->vertex_buffer, &cache->vertex_buffer_alloc,
+                   n ? n : 1, sizeof(double)) != 0) {
         return NULL;
     }
-
-    wasm_cached_element_t* element = &struct_cache->elements[element_index];
-    if (polygon_index < 0 || polygon_index >= element->polygon_count) {
-        return NULL;
+    for (size_t k = 0; k < n; k++) {
+        cache->vertex_buffer[k] = poly->vertices[k];
     }
 
-    return element->polygons[polygon_index].vertices;
+    return cache->vertex_buffer;
 }
 
 // ============================================================================
@@ -773,286 +1304,84 @@ double* wasm_get_element_polygon_vertices(wasm_library_cache_t* cache,
 // ============================================================================
 
 uint16_t wasm_get_element_elflags(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].elflags;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? element->elflags : 0;
 }
 
 int32_t wasm_get_element_plex(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].plex;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element ? element->plex : 0;
 }
 
 float wasm_get_element_path_width(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0.0f;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0.0f;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0.0f;
-    }
-
-    return struct_cache->elements[element_index].width;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element && element->kind == GDS_PATH ? element->data.path.width : 0.0f;
 }
 
 uint16_t wasm_get_element_path_type(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].ptype;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element && element->kind == GDS_PATH ? element->data.path.ptype : 0;
 }
 
 float wasm_get_element_path_begin_extension(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0.0f;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0.0f;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0.0f;
-    }
-
-    return struct_cache->elements[element_index].begin_extension;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element && element->kind == GDS_PATH ? element->data.path.begin_extension : 0.0f;
 }
 
 float wasm_get_element_path_end_extension(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0.0f;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0.0f;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0.0f;
-    }
-
-    return struct_cache->elements[element_index].end_extension;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element && element->kind == GDS_PATH ? element->data.path.end_extension : 0.0f;
 }
 
 const char* wasm_get_element_text(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return "";
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return "";
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return "";
-    }
-
-    return struct_cache->elements[element_index].text_data.text;
+    const wasm_text_data_t* text = cached_text(cache, structure_index, element_index);
+    return text ? text->text : "";
 }
 
 void wasm_get_element_text_position(wasm_library_cache_t* cache, int structure_index,
                                    int element_index, float* x, float* y) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        if (x) *x = 0.0f;
-        if (y) *y = 0.0f;
-        return;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            if (x) *x = 0.0f;
-            if (y) *y = 0.0f;
-            return;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        if (x) *x = 0.0f;
-        if (y) *y = 0.0f;
-        return;
-    }
-
-    if (x) *x = struct_cache->elements[element_index].text_data.x;
-    if (y) *y = struct_cache->elements[element_index].text_data.y;
+    const wasm_text_data_t* text = cached_text(cache, structure_index, element_index);
+    if (x) *x = text ? (float)text->x : 0.0f;
+    if (y) *y = text ? (float)text->y : 0.0f;
 }
 
 uint16_t wasm_get_element_text_type(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].text_data.text_type;
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    return element && element->kind == GDS_TEXT ? element->dtype : 0;
 }
 
 uint16_t wasm_get_element_text_presentation(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].text_data.presentation;
+    const wasm_text_data_t* text = cached_text(cache, structure_index, element_index);
+    return text ? text->presentation : 0;
 }
 
 const char* wasm_get_element_reference_name(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return "";
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return "";
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return "";
-    }
-
-    return struct_cache->elements[element_index].reference_data.structure_name;
+    const wasm_reference_data_t* ref = cached_reference(cache, structure_index, element_index);
+    return ref ? ref->structure_name : "";
 }
 
 int wasm_get_element_array_columns(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 1;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 1;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element) {
         return 1;
     }
-
-    return struct_cache->elements[element_index].reference_data.ncol;
+    const wasm_reference_data_t* ref = cached_reference(cache, structure_index, element_index);
+    return ref ? ref->ncol : 0;
 }
 
 int wasm_get_element_array_rows(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 1;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 1;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element) {
         return 1;
     }
-
-    return struct_cache->elements[element_index].reference_data.nrow;
+    const wasm_reference_data_t* ref = cached_reference(cache, structure_index, element_index);
+    return ref ? ref->nrow : 0;
 }
 
 void wasm_get_element_reference_corners(wasm_library_cache_t* cache, int structure_index, int element_index,
                                       float* x1, float* y1, float* x2, float* y2, float* x3, float* y3) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        if (x1) *x1 = 0.0f;
-        if (y1) *y1 = 0.0f;
-        if (x2) *x2 = 1.0f;
-        if (y2) *y2 = 0.0f;
-        if (x3) *x3 = 0.0f;
-        if (y3) *y3 = 1.0f;
-        return;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            if (x1) *x1 = 0.0f;
-            if (y1) *y1 = 0.0f;
-            if (x2) *x2 = 1.0f;
-            if (y2) *y2 = 0.0f;
-            if (x3) *x3 = 0.0f;
-            if (y3) *y3 = 1.0f;
-            return;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
+    const wasm_cached_element_t* element = cached_element(cache, structure_index, element_index);
+    if (!element) {
         if (x1) *x1 = 0.0f;
         if (y1) *y1 = 0.0f;
         if (x2) *x2 = 1.0f;
@@ -1062,69 +1391,28 @@ void wasm_get_element_reference_corners(wasm_library_cache_t* cache, int structu
         return;
     }
 
-    if (x1) *x1 = struct_cache->elements[element_index].reference_data.corners[0];
-    if (y1) *y1 = struct_cache->elements[element_index].reference_data.corners[1];
-    if (x2) *x2 = struct_cache->elements[element_index].reference_data.corners[2];
-    if (y2) *y2 = struct_cache->elements[element_index].reference_data.corners[3];
-    if (x3) *x3 = struct_cache->elements[element_index].reference_data.corners[4];
-    if (y3) *y3 = struct_cache->elements[element_index].reference_data.corners[5];
+    const wasm_reference_data_t* ref = cached_reference(cache, structure_index, element_index);
+    if (x1) *x1 = ref ? (float)ref->corners[0] : 0.0f;
+    if (y1) *y1 = ref ? (float)ref->corners[1] : 0.0f;
+    if (x2) *x2 = ref ? (float)ref->corners[2] : 0.0f;
+    if (y2) *y2 = ref ? (float)ref->corners[3] : 0.0f;
+    if (x3) *x3 = 0.0f;
+    if (y3) *y3 = 0.0f;
 }
 
 uint16_t wasm_get_element_strans_flags(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0;
-    }
-
-    return struct_cache->elements[element_index].strans_flags;
+    const wasm_strans_t* strans = cached_strans(cache, structure_index, element_index);
+    return strans ? strans->flags : 0;
 }
 
 double wasm_get_element_magnification(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 1.0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 1.0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 1.0;
-    }
-
-    return struct_cache->elements[element_index].magnification;
+    const wasm_strans_t* strans = cached_strans(cache, structure_index, element_index);
+    return strans ? strans->magnification : 1.0;
 }
 
 double wasm_get_element_rotation_angle(wasm_library_cache_t* cache, int structure_index, int element_index) {
-    if (!cache || structure_index < 0 || structure_index >= cache->structure_count) {
-        return 0.0;
-    }
-
-    wasm_structure_cache_t* struct_cache = &cache->structures[structure_index];
-    if (!struct_cache->is_fully_parsed) {
-        if (wasm_parse_structure_elements(cache, structure_index) != 0) {
-            return 0.0;
-        }
-    }
-
-    if (element_index < 0 || element_index >= struct_cache->element_count) {
-        return 0.0;
-    }
-
-    return struct_cache->elements[element_index].rotation_angle;
+    const wasm_strans_t* strans = cached_strans(cache, structure_index, element_index);
+    return strans ? strans->rotation_angle : 0.0;
 }
 
 // Note: wasm_get_element_property_count, wasm_get_element_property_attribute, and 
@@ -1167,23 +1455,8 @@ void wasm_get_cache_stats(wasm_library_cache_t* cache, int* total_structures,
                 wasm_structure_cache_t* struct_cache = &cache->structures[i];
                 elements += struct_cache->element_count;
 
-                if (struct_cache->elements) {
-                    memory += struct_cache->element_capacity * sizeof(wasm_cached_element_t);
-
-                    for (int j = 0; j < struct_cache->element_count; j++) {
-                        wasm_cached_element_t* element = &struct_cache->elements[j];
-
-                        if (element->polygons) {
-                            memory += element->polygon_count * sizeof(wasm_polygon_t);
-                            for (int k = 0; k < element->polygon_count; k++) {
-                                memory += element->polygons[k].capacity * 2 * sizeof(double);
-                            }
-                        }
-
-                        if (element->properties) {
-                            memory += element->property_count * sizeof(wasm_property_t);
-                        }
-                    }
+                if (!cache->arenas_in_data) {
+                    memory += struct_cache->arena_size;
                 }
             }
         }
@@ -1193,6 +1466,25 @@ void wasm_get_cache_stats(wasm_library_cache_t* cache, int* total_structures,
     }
 }
 
+int wasm_get_parse_stats(wasm_library_cache_t* cache, double* values, int count) {
+#ifdef GDS_STATS
+    if (!cache || !values || count <= 0) {
+        return 0;
+    }
+    const uint64_t* s = (const uint64_t*)&cache->parse_stats;
+    int n = count < (int)WASM_PARSE_STATS_COUNT ? count : (int)WASM_PARSE_STATS_COUNT;
+    for (int k = 0; k < n; k++) {
+        values[k] = (double)__atomic_load_n(&s[k], __ATOMIC_RELAXED);
+    }
+    return n;
+#else
+    (void)cache;
+    (void)values;
+    (void)count;
+    return 0;
+#endif
+}
+
 int wasm_parse_all_data(wasm_library_cache_t* cache) {
     if (!cache) {
         return -1;
@@ -1215,4 +1507,532 @@ int wasm_parse_all_data(wasm_library_cache_t* cache) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+// ============================================================================
+// HIERARCHY FLATTENING
+// ============================================================================
+
+static wasm_library_cache_t* sort_cache;   // used by compare_structure_names
+
+static int compare_structure_names(const void* a, const void* b) {
+    return strcmp(sort_cache->structures[*(const int*)a].name,
+                  sort_cache->structures[*(const int*)b].name);
+}
+
+static int find_structure(wasm_library_cache_t* cache, const int* order, const char* name) {
+    int lo = 0, hi = cache->structure_count;
+
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int c = strcmp(name, cache->structures[order[mid]].name);
+        if (c == 0) return order[mid];
+        if (c < 0) hi = mid;
+        else lo = mid + 1;
+    }
+    return -1;
+}
+
+static fl_status add_cached_element(wasm_library_cache_t* cache, fl_cell_t* c, uint32_t el,
+                                    int32_t target, const wasm_cached_element_t* ce) {
+    element_t e;
+    double xy[6];
+    fl_status st;
+
+    memset(&e, 0, sizeof(element_t));
+    e.kind = ce->kind;
+    e.layer = ce->layer;
+    e.dtype = e.ttype = e.btype = e.ntype = ce->dtype;
+
+    if (ce->kind == GDS_SREF || ce->kind == GDS_AREF) {
+        const wasm_reference_data_t* ref = ce->data.reference;
+        if (ref->strans.flags || ref->strans.magnification != 1.0 ||
+            ref->strans.rotation_angle != 0.0) {
+            e.has = HAS_STRANS | HAS_MAG | HAS_ANGLE;
+            e.strans.flags = ref->strans.flags;
+            e.strans.mag = ref->strans.magnification;
+            e.strans.angle = ref->strans.rotation_angle;
+        }
+        e.ncol = ref->ncol;
+        e.nrow = ref->nrow;
+        xy[0] = ref->x;
+        xy[1] = ref->y;
+        for (int k = 0; k < 4; k++) {
+            xy[2 + k] = ref->corners[k];
+        }
+        return fl_add_ref(c, el, target, &e, xy);
+    }
+
+    if (ce->kind == GDS_PATH) {
+        e.has = HAS_PTYPE | HAS_BGNEXTN | HAS_ENDEXTN;
+        e.ptype = ce->data.path.ptype;
+        e.bgnextn = ce->data.path.begin_extension;
+        e.endextn = ce->data.path.end_extension;
+        if (ce->data.path.width != 0.0f) {
+            e.has |= HAS_WIDTH;
+            e.width = ce->data.path.width;
+        }
+    }
+    if ((st = fl_add_shape(c, el, &e)) != FL_OK) {
+        return st;
+    }
+
+    if (ce->kind == GDS_TEXT) {
+        xy[0] = ce->data.text->x;
+        xy[1] = ce->data.text->y;
+        return fl_add_vertices(c, xy, xy + 1, 1, 2);
+    }
+
+    // the integer vertices are converted in the vertex buffer of the cache
+    for (int p = 0; p < ce->polygon_count; p++) {
+        const wasm_polygon_t* poly = &ce->polygons[p];
+        size_t n = 2 * (size_t)poly->vertex_count;
+        if (n == 0) continue;
+        if (buffer_grow((void**)&cache->vertex_buffer, &cache->vertex_buffer_alloc,
+                       n, sizeof(double)) != 0) {
+            return FL_MEMORY;
+        }
+        for (size_t k = 0; k < n; k++) {
+            cache->vertex_buffer[k] = poly->vertices[k];
+        }
+        st = fl_add_vertices(c, cache->vertex_buffer, cache->vertex_buffer + 1,
+                             (size_t)poly->vertex_count, 2);
+        if (st != FL_OK) return st;
+    }
+    return FL_OK;
+}
+
+int wasm_build_flatten_library(wasm_library_cache_t* cache, fl_library_t* flib) {
+    if (!cache || !flib || wasm_parse_all_data(cache) != 0) {
+        return -1;
+    }
+
+    // structure names sorted for the lookup of references
+    int* order = malloc((cache->structure_count + 1) * sizeof(int));
+    if (!order) {
+        return -1;
+    }
+    for (int i = 0; i < cache->structure_count; i++) {
+        order[i] = i;
+    }
+    sort_cache = cache;
+    qsort(order, cache->structure_count, sizeof(int), compare_structure_names);
+
+    if (fl_library_init(flib, cache->structure_count) != FL_OK) {
+        free(order);
+        return -1;
+    }
+
+    for (int i = 0; i < cache->structure_count; i++) {
+        wasm_structure_cache_t* sc = &cache->structures[i];
+        for (int k = 0; k < sc->element_count; k++) {
+            const wasm_cached_element_t* ce = &sc->elements[k];
+            int32_t target = -1;
+            if (ce->kind == GDS_SREF || ce->kind == GDS_AREF) {
+                target = find_structure(cache, order, ce->data.reference->structure_name);
+            }
+            if (add_cached_element(cache, &flib->cell[i], k, target, ce) != FL_OK) {
+                fl_library_free(flib);
+                free(order);
+                return -1;
+            }
+        }
+    }
+
+    free(order);
+    return 0;
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+#define SNAPSHOT_MAGIC "GDSSNAP"
+
+/*
+ * A snapshot holds the header, the structure table and the arenas of all
+ * structures at 8-byte aligned offsets. Pointers in the arenas are stored
+ * as offset from the arena + 1 (0 for NULL), so that a snapshot is loaded
+ * by relocating the pointers in place. The record sizes in the header
+ * reject snapshots written by a build with a different element layout.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t structure_count;
+    uint16_t layout[6];
+    uint16_t libver;
+    uint16_t creation_date[6];
+    uint16_t modification_date[6];
+    char name[MAX_STRUCTURE_NAME_LEN];
+    double user_units_per_db_unit;
+    double meters_per_db_unit;
+} snapshot_header_t;
+
+typedef struct {
+    char name[MAX_STRUCTURE_NAME_LEN];
+    uint16_t creation_date[6];
+    uint16_t modification_date[6];
+    int32_t element_count;
+    uint64_t arena_offset;
+    uint64_t arena_size;
+} snapshot_structure_t;
+
+static void snapshot_layout(uint16_t* layout) {
+    layout[0] = (uint16_t)sizeof(void*);
+    layout[1] = (uint16_t)sizeof(wasm_cached_element_t);
+    layout[2] = (uint16_t)sizeof(wasm_polygon_t);
+    layout[3] = (uint16_t)sizeof(wasm_text_data_t);
+    layout[4] = (uint16_t)sizeof(wasm_reference_data_t);
+    layout[5] = (uint16_t)sizeof(wasm_property_t);
+}
+
+static size_t snapshot_table_offset(void) {
+    return ARENA_ALIGN(sizeof(snapshot_header_t));
+}
+
+static size_t snapshot_arena_offset(int structure_count) {
+    return snapshot_table_offset() + ARENA_ALIGN((size_t)structure_count * sizeof(snapshot_structure_t));
+}
+
+size_t wasm_snapshot_size(wasm_library_cache_t* cache) {
+    // a library that is still streaming in has no snapshot yet
+    if (!cache || (cache->owns_data && !cache->stream_complete)) {
+        return 0;
+    }
+    if (wasm_parse_all_data(cache) != 0) {
+        return 0;
+    }
+
+    size_t size = snapshot_arena_offset(cache->structure_count);
+    for (int i = 0; i < cache->structure_count; i++) {
+        size += ARENA_ALIGN(cache->structures[i].arena_size);
+    }
+    return size;
+}
+
+// offset + 1 of a pointer into the arena at base, 0 for NULL
+#define SNAPSHOT_OFFSET(p, base) \
+    ((p) ? (void*)((uintptr_t)((const uint8_t*)(p) - (base)) + 1) : NULL)
+
+int wasm_write_snapshot(wasm_library_cache_t* cache, uint8_t* out, size_t size) {
+    if (!out || size != wasm_snapshot_size(cache) || size == 0) {
+        return -1;
+    }
+    memset(out, 0, size);
+
+    snapshot_header_t* h = (snapshot_header_t*)out;
+    memcpy(h->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    h->version = WASM_SNAPSHOT_VERSION;
+    h->structure_count = (uint32_t)cache->structure_count;
+    snapshot_layout(h->layout);
+    h->libver = cache->version;
+    memcpy(h->creation_date, cache->creation_date, sizeof(h->creation_date));
+    memcpy(h->modification_date, cache->modification_date, sizeof(h->modification_date));
+    memcpy(h->name, cache->name, sizeof(h->name));
+    h->user_units_per_db_unit = cache->user_units_per_db_unit;
+    h->meters_per_db_unit = cache->meters_per_db_unit;
+
+    snapshot_structure_t* table = (snapshot_structure_t*)(out + snapshot_table_offset());
+    size_t offset = snapshot_arena_offset(cache->structure_count);
+    for (int i = 0; i < cache->structure_count; i++) {
+        const wasm_structure_cache_t* sc = &cache->structures[i];
+        snapshot_structure_t* st = &table[i];
+        memcpy(st->name, sc->name, sizeof(st->name));
+        memcpy(st->creation_date, sc->creation_date, sizeof(st->creation_date));
+        memcpy(st->modification_date, sc->modification_date, sizeof(st->modification_date));
+        st->element_count = sc->element_count;
+        st->arena_offset = offset;
+        st->arena_size = sc->arena_size;
+        if (!sc->arena_size) continue;
+
+        // copy the arena, then replace the pointers of the copy by offsets;
+        // the records of the copy are found at the offsets of the originals
+        const uint8_t* base = sc->arena;
+        uint8_t* dst = out + offset;
+        memcpy(dst, base, sc->arena_size);
+#define SNAPSHOT_COPY(p) ((void*)(dst + ((const uint8_t*)(p) - base)))
+
+        for (int k = 0; k < sc->element_count; k++) {
+            const wasm_cached_element_t* el = &sc->elements[k];
+            wasm_cached_element_t* cel = SNAPSHOT_COPY(el);
+
+            for (int p = 0; p < el->polygon_count; p++) {
+                wasm_polygon_t* cpoly = SNAPSHOT_COPY(&el->polygons[p]);
+                cpoly->vertices = SNAPSHOT_OFFSET(el->polygons[p].vertices, base);
+            }
+            for (int p = 0; p < el->property_count; p++) {
+                wasm_property_t* cprop = SNAPSHOT_COPY(&el->properties[p]);
+                cprop->value = SNAPSHOT_OFFSET(el->properties[p].value, base);
+            }
+            if (el->kind == GDS_TEXT && el->data.text) {
+                wasm_text_data_t* ctext = SNAPSHOT_COPY(el->data.text);
+                ctext->text = SNAPSHOT_OFFSET(el->data.text->text, base);
+                cel->data.text = SNAPSHOT_OFFSET(el->data.text, base);
+            } else if ((el->kind == GDS_SREF || el->kind == GDS_AREF) && el->data.reference) {
+                wasm_reference_data_t* cref = SNAPSHOT_COPY(el->data.reference);
+                cref->structure_name = SNAPSHOT_OFFSET(el->data.reference->structure_name, base);
+                cel->data.reference = SNAPSHOT_OFFSET(el->data.reference, base);
+            }
+            cel->polygons = SNAPSHOT_OFFSET(el->polygons, base);
+            cel->properties = SNAPSHOT_OFFSET(el->properties, base);
+        }
+#undef SNAPSHOT_COPY
+
+        offset += ARENA_ALIGN(sc->arena_size);
+    }
+    return 0;
+}
+
+/*
+ * Replaces a stored offset by the pointer into the arena. The count
+ * records of the given size must lie in the arena.
+ */
+static int snapshot_pointer(void** p, uint8_t* base, size_t size, size_t count, size_t record) {
+    uintptr_t v = (uintptr_t)*p;
+    if (v == 0) {
+        return 0;
+    }
+    // records in an arena are aligned to their size, up to 8 bytes
+    size_t align = record & (~record + 1);
+    size_t off = (size_t)(v - 1);
+    if (off > size || count > (size - off) / record || off % (align < 8 ? align : 8) != 0) {
+        return -1;
+    }
+    *p = base + off;
+    return 0;
+}
+
+#define SNAPSHOT_RELOCATE(field, count, record) \
+    do { \
+        void* p_ = (void*)(field); \
+        if (snapshot_pointer(&p_, base, size, (count), (record)) != 0) return -1; \
+        (field) = p_; \
+    } while (0)
+
+// relocates the pointers of an arena that was written by wasm_write_snapshot
+static int snapshot_relocate(uint8_t* base, size_t size, int element_count) {
+    // strings end in the arena; the last string is terminated
+    if (size == 0 || base[size - 1] != '\0' ||
+        (size_t)element_count > size / sizeof(wasm_cached_element_t)) {
+        return -1;
+    }
+
+    wasm_cached_element_t* els = (wasm_cached_element_t*)base;
+    for (int k = 0; k < element_count; k++) {
+        wasm_cached_element_t* el = &els[k];
+        if (el->polygon_count < 0 || el->property_count < 0) return -1;
+
+        SNAPSHOT_RELOCATE(el->polygons, (size_t)el->polygon_count, sizeof(wasm_polygon_t));
+        SNAPSHOT_RELOCATE(el->properties, (size_t)el->property_count, sizeof(wasm_property_t));
+        if ((el->polygon_count && !el->polygons) || (el->property_count && !el->properties)) return -1;
+
+        for (int p = 0; p < el->polygon_count; p++) {
+            wasm_polygon_t* poly = &el->polygons[p];
+            if (poly->vertex_count < 0) return -1;
+            SNAPSHOT_RELOCATE(poly->vertices, 2 * (size_t)poly->vertex_count, sizeof(int32_t));
+        }
+        for (int p = 0; p < el->property_count; p++) {
+            SNAPSHOT_RELOCATE(el->properties[p].value, 1, 1);
+        }
+        if (el->kind == GDS_TEXT) {
+            SNAPSHOT_RELOCATE(el->data.text, 1, sizeof(wasm_text_data_t));
+            if (el->data.text) SNAPSHOT_RELOCATE(el->data.text->text, 1, 1);
+        } else if (el->kind == GDS_SREF || el->kind == GDS_AREF) {
+            SNAPSHOT_RELOCATE(el->data.reference, 1, sizeof(wasm_reference_data_t));
+            if (el->data.reference) SNAPSHOT_RELOCATE(el->data.reference->structure_name, 1, 1);
+        }
+    }
+    return 0;
+}
+
+#undef SNAPSHOT_RELOCATE
+
+wasm_library_cache_t* wasm_create_snapshot_cache(size_t size) {
+    if (size < sizeof(snapshot_header_t)) {
+        return NULL;
+    }
+
+    wasm_library_cache_t* cache = WASM_MALLOC(sizeof(wasm_library_cache_t), WASM_MEMORY_CACHE);
+    if (!cache) {
+        return NULL;
+    }
+    memset(cache, 0, sizeof(wasm_library_cache_t));
+
+    // the snapshot is written to the file buffer and stays there: the
+    // arenas of the structures are relocated in place
+    cache->raw_data = WASM_MALLOC(size, WASM_MEMORY_BUFFER);
+    cache->owns_data = 1;
+    cache->arenas_in_data = 1;
+    cache->stream_complete = 1;
+    cache->data_alloc = size;
+    cache->data_size = size;
+    if (cache->raw_data) {
+        cache->mem_file = wasm_fopen(cache->raw_data, size);
+    }
+    if (!cache->mem_file) {
+        wasm_free_library_cache(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+int wasm_load_snapshot(wasm_library_cache_t* cache) {
+    if (!cache || !cache->arenas_in_data || cache->structures) {
+        return -1;
+    }
+
+    uint8_t* data = cache->raw_data;
+    size_t size = cache->data_size;
+    const snapshot_header_t* h = (const snapshot_header_t*)data;
+    uint16_t layout[6];
+    snapshot_layout(layout);
+    if (memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        h->version != WASM_SNAPSHOT_VERSION ||
+        memcmp(h->layout, layout, sizeof(layout)) != 0 ||
+        h->structure_count > INT32_MAX / 2 ||
+        snapshot_arena_offset((int)h->structure_count) > size) {
+        return -1;
+    }
+
+    int n = (int)h->structure_count;
+    wasm_structure_cache_t* structures = WASM_CALLOC(n ? (size_t)n : 1, sizeof(wasm_structure_cache_t),
+                                                     WASM_MEMORY_CACHE);
+    if (!structures) {
+        return -1;
+    }
+
+    const snapshot_structure_t* table = (const snapshot_structure_t*)(data + snapshot_table_offset());
+    for (int i = 0; i < n; i++) {
+        const snapshot_structure_t* st = &table[i];
+        wasm_structure_cache_t* sc = &structures[i];
+        if (st->arena_offset % 8 != 0 || st->arena_offset > size ||
+            st->arena_size > size - st->arena_offset || st->element_count < 0) {
+            WASM_FREE(structures);
+            return -1;
+        }
+
+        memcpy(sc->name, st->name, sizeof(sc->name));
+        sc->name[sizeof(sc->name) - 1] = '\0';
+        memcpy(sc->creation_date, st->creation_date, sizeof(sc->creation_date));
+        memcpy(sc->modification_date, st->modification_date, sizeof(sc->modification_date));
+        sc->arena_size = (size_t)st->arena_size;
+        sc->arena = sc->arena_size ? data + st->arena_offset : NULL;
+        if (sc->arena && snapshot_relocate(sc->arena, sc->arena_size, st->element_count) != 0) {
+            WASM_FREE(structures);
+            return -1;
+        }
+        sc->element_count = st->element_count;
+        sc->element_capacity = st->element_count;
+        sc->elements = st->element_count ? (wasm_cached_element_t*)sc->arena : NULL;
+        sc->is_fully_parsed = 1;
+    }
+
+    memcpy(cache->name, h->name, sizeof(cache->name));
+    cache->name[sizeof(cache->name) - 1] = '\0';
+    cache->version = h->libver;
+    memcpy(cache->creation_date, h->creation_date, sizeof(cache->creation_date));
+    memcpy(cache->modification_date, h->modification_date, sizeof(cache->modification_date));
+    cache->user_units_per_db_unit = h->user_units_per_db_unit;
+    cache->meters_per_db_unit = h->meters_per_db_unit;
+
+    cache->structures = structures;
+    cache->structure_count = n;
+    cache->structure_capacity = n;
+    cache->parsed_structures = n;
+    return 0;
+}
+
+// ============================================================================
+// PARALLEL PARSING
+// ============================================================================
+
+/*
+ * The structures are independent: a worker parses the records of a
+ * structure from the shared file buffer into the arena of the structure.
+ * Workers take the next unparsed structure from a shared counter, so
+ * large and small structures are balanced without a schedule.
+ */
+#ifdef WASM_THREADS
+static void* parse_worker(void* arg) {
+    wasm_library_cache_t* cache = (wasm_library_cache_t*)arg;
+
+    for (;;) {
+        int s = __atomic_fetch_add(&cache->next_structure, 1, __ATOMIC_RELAXED);
+        if (s >= cache->structure_count) {
+            break;
+        }
+        if (cache->structures[s].is_fully_parsed) {
+            continue;
+        }
+        if (wasm_parse_structure_elements(cache, s) != 0) {
+            // counted as well, so that progress reaches the structure count
+            __atomic_store_n(&cache->parse_failed, 1, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&cache->parsed_structures, 1, __ATOMIC_RELEASE);
+        }
+    }
+    return NULL;
+}
+#endif
+
+int wasm_start_parallel_parse(wasm_library_cache_t* cache, int thread_count) {
+    if (!cache || thread_count < 0 || cache->parse_thread_count > 0) {
+        return -1;
+    }
+
+#ifdef WASM_THREADS
+    if (thread_count > cache->structure_count) {
+        thread_count = cache->structure_count;
+    }
+    if (thread_count == 0) {
+        return 0;
+    }
+
+    pthread_t* threads = malloc((size_t)thread_count * sizeof(pthread_t));
+    if (!threads) {
+        return -1;
+    }
+
+    cache->next_structure = 0;
+    cache->parse_failed = 0;
+    int started = 0;
+    while (started < thread_count &&
+           pthread_create(&threads[started], NULL, parse_worker, cache) == 0) {
+        started++;
+    }
+    if (started == 0) {
+        free(threads);
+        return 0; // The caller parses on its own thread
+    }
+
+    cache->parse_threads = threads;
+    cache->parse_thread_count = started;
+    return started;
+#else
+    return 0;
+#endif
+}
+
+int wasm_get_parsed_structure_count(wasm_library_cache_t* cache) {
+    if (!cache) {
+        return -1;
+    }
+    return __atomic_load_n(&cache->parsed_structures, __ATOMIC_ACQUIRE);
+}
+
+int wasm_wait_parallel_parse(wasm_library_cache_t* cache) {
+    if (!cache) {
+        return -1;
+    }
+
+#ifdef WASM_THREADS
+    pthread_t* threads = (pthread_t*)cache->parse_threads;
+    for (int k = 0; k < cache->parse_thread_count; k++) {
+        pthread_join(threads[k], NULL);
+    }
+    free(threads);
+    cache->parse_threads = NULL;
+    cache->parse_thread_count = 0;
+#endif
+
+    return cache->parse_failed ? -1 : 0;
+}
@@ -12,93 +12,216 @@
 #include <string.h>
 #include <stdint.h>
 #include <assert.h>
-#include "wasm-element-cache.h"
-#include "mem-file.h"
+#ifdef WASM_THREADS
+#include <pthread.h>
+#endif
+#include "wasm-memory-manager.h"
 
 // ============================================================================
 // MEMORY TRACKING STRUCTURES
 // ============================================================================
 
-typedef struct memory_allocation {
+/*
+ * Header in front of every allocation. It keeps the user block aligned
+ * like malloc does and makes the size known at free time.
+ */
+typedef union {
+    struct {
+        size_t size;
+        uint16_t category;
+        uint16_t sampled;     // Recorded in the allocation table
+    } h;
+    double align[2];
+} allocation_header_t;
+
+// Entry of the allocation table; ptr == NULL marks a free slot
+typedef struct {
     void* ptr;
     size_t size;
     const char* file;
     int line;
     const char* function;
-    struct memory_allocation* next;
 } memory_allocation_t;
 
 typedef struct {
+    // Updated with atomic operations
     size_t total_allocated;
     size_t peak_usage;
+    size_t category_memory[WASM_MEMORY_CATEGORIES];
+    size_t sample_bytes;          // Bytes allocated, for sampling
     int allocation_count;
+    int live_allocations;
     int leak_count;
 
-    memory_allocation_t* allocations;
-    size_t max_allocations;
-
-    // Statistics
-    size_t cache_memory;
-    size_t buffer_memory;
-    size_t element_memory;
+    // Sampled allocations, open addressing with linear probing
+    memory_allocation_t* table;
+    size_t table_size;            // Power of two
+    size_t table_used;
 
-    int tracking_enabled;
+    size_t sample_interval;
     int debug_mode;
 } wasm_memory_manager_t;
 
-static wasm_memory_manager_t g_memory_manager = {0};
+static wasm_memory_manager_t g_memory_manager = {
+    .sample_interval = WASM_MEMORY_SAMPLE_INTERVAL
+};
+
+#ifdef WASM_THREADS
+static pthread_mutex_t g_table_lock = PTHREAD_MUTEX_INITIALIZER;
+#define TABLE_LOCK() pthread_mutex_lock(&g_table_lock)
+#define TABLE_UNLOCK() pthread_mutex_unlock(&g_table_lock)
+#else
+#define TABLE_LOCK()
+#define TABLE_UNLOCK()
+#endif
 
 // ============================================================================
-// MEMORY ALLOCATION TRACKING
+// ALLOCATION TABLE
 // ============================================================================
 
-static void track_allocation(void* ptr, size_t size, const char* file, int line, const char* function) {
-    if (!g_memory_manager.tracking_enabled || !ptr) {
-        return;
-    }
+static size_t table_slot(const void* ptr, size_t table_size) {
+    uint64_t h = (uint64_t)(uintptr_t)ptr * 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 32) & (table_size - 1);
+}
 
-    // Update statistics
-    g_memory_manager.total_allocated += size;
-    g_memory_manager.allocation_count++;
+// inserts an entry; the table has a free slot
+static void table_put(memory_allocation_t* table, size_t table_size, const memory_allocation_t* a) {
+    size_t i = table_slot(a->ptr, table_size);
+    while (table[i].ptr) {
+        i = (i + 1) & (table_size - 1);
+    }
+    table[i] = *a;
+}
 
-    if (g_memory_manager.total_allocated > g_memory_manager.peak_usage) {
-        g_memory_manager.peak_usage = g_memory_manager.total_allocated;
+// keeps the load factor at most 1/2
+static int table_reserve(void) {
+    wasm_memory_manager_t* m = &g_memory_manager;
+    if (2 * (m->table_used + 1) <= m->table_size) {
+        return 0;
     }
 
-    // Add to allocation list
-    memory_allocation_t* alloc = malloc(sizeof(memory_allocation_t));
-    if (alloc) {
-        alloc->ptr = ptr;
-        alloc->size = size;
-        alloc->file = file;
-        alloc->line = line;
-        alloc->function = function;
-        alloc->next = g_memory_manager.allocations;
-        g_memory_manager.allocations = alloc;
+    size_t size = m->table_size ? 2 * m->table_size : 1024;
+    memory_allocation_t* table = calloc(size, sizeof(memory_allocation_t));
+    if (!table) {
+        return -1;
     }
+    for (size_t i = 0; i < m->table_size; i++) {
+        if (m->table[i].ptr) {
+            table_put(table, size, &m->table[i]);
+        }
+    }
+    free(m->table);
+    m->table = table;
+    m->table_size = size;
+    return 0;
 }
 
-static void untrack_allocation(void* ptr, const char* file, int line, const char* function) {
-    if (!g_memory_manager.tracking_enabled || !ptr) {
-        return;
+static int table_insert(const memory_allocation_t* a) {
+    int ok = 0;
+    TABLE_LOCK();
+    if (table_reserve() == 0) {
+        table_put(g_memory_manager.table, g_memory_manager.table_size, a);
+        g_memory_manager.table_used++;
+        ok = 1;
     }
+    TABLE_UNLOCK();
+    return ok;
+}
 
-    memory_allocation_t** current = &g_memory_manager.allocations;
-    while (*current) {
-        if ((*current)->ptr == ptr) {
-            memory_allocation_t* to_remove = *current;
-            *current = (*current)->next;
+static int table_remove(const void* ptr) {
+    wasm_memory_manager_t* m = &g_memory_manager;
+    int found = 0;
 
-            g_memory_manager.total_allocated -= to_remove->size;
-            free(to_remove);
-            return;
+    TABLE_LOCK();
+    if (m->table_size) {
+        size_t mask = m->table_size - 1;
+        size_t i = table_slot(ptr, m->table_size);
+        while (m->table[i].ptr && m->table[i].ptr != ptr) {
+            i = (i + 1) & mask;
+        }
+        if (m->table[i].ptr) {
+            found = 1;
+            m->table_used--;
+
+            // shifts back the entries of the probe sequence
+            size_t j = i;
+            for (;;) {
+                m->table[i].ptr = NULL;
+                size_t home;
+                do {
+                    j = (j + 1) & mask;
+                    if (!m->table[j].ptr) {
+                        goto done;
+                    }
+                    home = table_slot(m->table[j].ptr, m->table_size);
+                } while (i <= j ? (i < home && home <= j) : (i < home || home <= j));
+                m->table[i] = m->table[j];
+                i = j;
+            }
         }
-        current = &(*current)->next;
     }
+done:
+    TABLE_UNLOCK();
+    return found;
+}
 
-    if (g_memory_manager.debug_mode) {
-        printf("WARNING: Attempting to free untracked pointer %p from %s:%d (%s)\n",
-               ptr, file, line, function);
+// ============================================================================
+// MEMORY ALLOCATION TRACKING
+// ============================================================================
+
+// samples about one allocation per sample_interval bytes
+static int sample_allocation(size_t size) {
+    size_t interval = __atomic_load_n(&g_memory_manager.sample_interval, __ATOMIC_RELAXED);
+    if (interval == 0) {
+        return 0;
+    }
+    if (size >= interval) {
+        return 1;
+    }
+    size_t before = __atomic_fetch_add(&g_memory_manager.sample_bytes, size, __ATOMIC_RELAXED);
+    return before / interval != (before + size) / interval;
+}
+
+static void track_allocation(allocation_header_t* hdr, size_t size, int category,
+                             const char* file, int line, const char* function) {
+    wasm_memory_manager_t* m = &g_memory_manager;
+
+    if (category < 0 || category >= WASM_MEMORY_CATEGORIES) {
+        category = WASM_MEMORY_OTHER;
+    }
+    hdr->h.size = size;
+    hdr->h.category = (uint16_t)category;
+    hdr->h.sampled = 0;
+
+    // Update statistics
+    size_t total = __atomic_add_fetch(&m->total_allocated, size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&m->category_memory[category], size, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&m->allocation_count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&m->live_allocations, 1, __ATOMIC_RELAXED);
+
+    size_t peak = __atomic_load_n(&m->peak_usage, __ATOMIC_RELAXED);
+    while (total > peak &&
+           !__atomic_compare_exchange_n(&m->peak_usage, &peak, total, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+
+    if (sample_allocation(size)) {
+        memory_allocation_t a = {hdr + 1, size, file, line, function};
+        hdr->h.sampled = (uint16_t)table_insert(&a);
+    }
+}
+
+static void untrack_allocation(allocation_header_t* hdr, const char* file, int line, const char* function) {
+    wasm_memory_manager_t* m = &g_memory_manager;
+
+    __atomic_sub_fetch(&m->total_allocated, hdr->h.size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&m->category_memory[hdr->h.category], hdr->h.size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&m->live_allocations, 1, __ATOMIC_RELAXED);
+
+    // Only sampled allocations are in the table
+    if (hdr->h.sampled && !table_remove(hdr + 1) && m->debug_mode) {
+        printf("WARNING: Sampled pointer %p freed from %s:%d (%s) is not in the table\n",
+               (void*)(hdr + 1), file, line, function);
     }
 }
 
@@ -106,121 +229,154 @@ static void untrack_allocation(void* ptr, const char* file, int line, const char
 // WRAPPER FUNCTIONS FOR MALLOC/FREE
 // ============================================================================
 
-void* wasm_malloc(size_t size, const char* file, int line, const char* function) {
-    void* ptr = malloc(size);
-    if (ptr) {
-        track_allocation(ptr, size, file, line, function);
+void* wasm_malloc(size_t size, int category, const char* file, int line, const char* function) {
+    if (size > SIZE_MAX - sizeof(allocation_header_t)) {
+        return NULL;
     }
-    return ptr;
+
+    allocation_header_t* hdr = malloc(sizeof(allocation_header_t) + size);
+    if (!hdr) {
+        return NULL;
+    }
+    track_allocation(hdr, size, category, file, line, function);
+    return hdr + 1;
 }
 
-void* wasm_calloc(size_t count, size_t size, const char* file, int line, const char* function) {
-    void* ptr = calloc(count, size);
+void* wasm_calloc(size_t count, size_t size, int category, const char* file, int line, const char* function) {
+    if (size && count > (SIZE_MAX - sizeof(allocation_header_t)) / size) {
+        return NULL;
+    }
+
+    void* ptr = wasm_malloc(count * size, category, file, line, function);
     if (ptr) {
-        track_allocation(ptr, count * size, file, line, function);
+        memset(ptr, 0, count * size);
     }
     return ptr;
 }
 
-void* wasm_realloc(void* ptr, size_t new_size, const char* file, int line, const char* function) {
-    if (ptr) {
-        untrack_allocation(ptr, file, line, function);
+void* wasm_realloc(void* ptr, size_t new_size, int category, const char* file, int line, const char* function) {
+    if (!ptr) {
+        return wasm_malloc(new_size, category, file, line, function);
+    }
+    if (new_size > SIZE_MAX - sizeof(allocation_header_t)) {
+        return NULL;
     }
 
-    void* new_ptr = realloc(ptr, new_size);
-    if (new_ptr) {
-        track_allocation(new_ptr, new_size, file, line, function);
+    // The old block stays tracked if realloc fails
+    allocation_header_t* hdr = (allocation_header_t*)ptr - 1;
+    allocation_header_t old = *hdr;
+    allocation_header_t* new_hdr = realloc(hdr, sizeof(allocation_header_t) + new_size);
+    if (!new_hdr) {
+        return NULL;
     }
 
-    return new_ptr;
+    // The entry of a sampled block is keyed by its old address
+    if (old.h.sampled) {
+        table_remove(ptr);
+        new_hdr->h.sampled = 0;
+    }
+    untrack_allocation(new_hdr, file, line, function);
+    __atomic_sub_fetch(&g_memory_manager.allocation_count, 1, __ATOMIC_RELAXED);
+    track_allocation(new_hdr, new_size, old.h.category, file, line, function);
+    return new_hdr + 1;
 }
 
 void wasm_free(void* ptr, const char* file, int line, const char* function) {
     if (ptr) {
-        untrack_allocation(ptr, file, line, function);
-        free(ptr);
+        allocation_header_t* hdr = (allocation_header_t*)ptr - 1;
+        untrack_allocation(hdr, file, line, function);
+        free(hdr);
     }
 }
 
-// ============================================================================
-// CONVENIENCE MACROS
-// ============================================================================
-
-#ifdef DEBUG
-#define WASM_MALLOC(size) wasm_malloc(size, __FILE__, __LINE__, __FUNCTION__)
-#define WASM_CALLOC(count, size) wasm_calloc(count, size, __FILE__, __LINE__, __FUNCTION__)
-#define WASM_REALLOC(ptr, size) wasm_realloc(ptr, size, __FILE__, __LINE__, __FUNCTION__)
-#define WASM_FREE(ptr) wasm_free(ptr, __FILE__, __LINE__, __FUNCTION__)
-#else
-#define WASM_MALLOC(size) wasm_malloc(size, NULL, 0, NULL)
-#define WASM_CALLOC(count, size) wasm_calloc(count, size, NULL, 0, NULL)
-#define WASM_REALLOC(ptr, size) wasm_realloc(ptr, size, NULL, 0, NULL)
-#define WASM_FREE(ptr) wasm_free(ptr, NULL, 0, NULL)
-#endif
-
 // ============================================================================
 // MEMORY MANAGER API
 // ============================================================================
 
 void wasm_memory_init(int enable_tracking, int debug_mode) {
-    memset(&g_memory_manager, 0, sizeof(wasm_memory_manager_t));
-    g_memory_manager.tracking_enabled = enable_tracking;
+    // The counters describe live memory and are not reset
     g_memory_manager.debug_mode = debug_mode;
-    g_memory_manager.max_allocations = 10000; // Max tracked allocations
+    g_memory_manager.leak_count = 0;
+    wasm_memory_set_sample_interval(enable_tracking ? 1 : WASM_MEMORY_SAMPLE_INTERVAL);
+}
+
+void wasm_memory_set_sample_interval(size_t interval) {
+    __atomic_store_n(&g_memory_manager.sample_interval, interval, __ATOMIC_RELAXED);
 }
 
 void wasm_memory_shutdown(void) {
-    if (g_memory_manager.tracking_enabled && g_memory_manager.allocations) {
-        g_memory_manager.leak_count = 0;
-        memory_allocation_t* current = g_memory_manager.allocations;
-
-        while (current) {
-            g_memory_manager.leak_count++;
-            if (g_memory_manager.debug_mode) {
-                printf("MEMORY LEAK: %zu bytes at %p allocated in %s (%s:%d)\n",
-                       current->size, current->ptr, current->function,
-                       current->file, current->line);
-            }
-            current = current->next;
+    wasm_memory_manager_t* m = &g_memory_manager;
+
+    TABLE_LOCK();
+    m->leak_count = 0;
+    size_t leaked = 0;
+    for (size_t i = 0; i < m->table_size; i++) {
+        memory_allocation_t* a = &m->table[i];
+        if (!a->ptr) {
+            continue;
         }
-
-        if (g_memory_manager.leak_count > 0) {
-            printf("WARNING: %d memory leaks detected (%zu bytes total)\n",
-                   g_memory_manager.leak_count, g_memory_manager.total_allocated);
+        m->leak_count++;
+        leaked += a->size;
+        if (m->debug_mode) {
+            printf("MEMORY LEAK: %zu bytes at %p allocated in %s (%s:%d)\n",
+                   a->size, a->ptr, a->function ? a->function : "?",
+                   a->file ? a->file : "?", a->line);
         }
+        // The block is no longer recorded when it is freed later
+        ((allocation_header_t*)a->ptr - 1)->h.sampled = 0;
     }
 
-    // Clean up allocation tracking
-    memory_allocation_t* current = g_memory_manager.allocations;
-    while (current) {
-        memory_allocation_t* next = current->next;
-        free(current);
-        current = next;
+    if (m->leak_count > 0) {
+        printf("WARNING: %d memory leaks detected (%zu bytes total)\n",
+               m->leak_count, leaked);
     }
 
-    memset(&g_memory_manager, 0, sizeof(wasm_memory_manager_t));
+    // Clean up allocation tracking
+    free(m->table);
+    m->table = NULL;
+    m->table_size = 0;
+    m->table_used = 0;
+    TABLE_UNLOCK();
 }
 
 void wasm_memory_get_stats(size_t* total_allocated, size_t* peak_usage,
                          int* allocation_count, int* leak_count) {
-    if (total_allocated) *total_allocated = g_memory_manager.total_allocated;
-    if (peak_usage) *peak_usage = g_memory_manager.peak_usage;
-    if (allocation_count) *allocation_count = g_memory_manager.allocation_count;
-    if (leak_count) *leak_count = g_memory_manager.leak_count;
+    wasm_memory_manager_t* m = &g_memory_manager;
+    if (total_allocated) *total_allocated = __atomic_load_n(&m->total_allocated, __ATOMIC_RELAXED);
+    if (peak_usage) *peak_usage = __atomic_load_n(&m->peak_usage, __ATOMIC_RELAXED);
+    if (allocation_count) *allocation_count = __atomic_load_n(&m->allocation_count, __ATOMIC_RELAXED);
+    if (leak_count) *leak_count = m->leak_count;
+}
+
+void wasm_memory_reset_peak(void) {
+    wasm_memory_manager_t* m = &g_memory_manager;
+    __atomic_store_n(&m->peak_usage, __atomic_load_n(&m->total_allocated, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+}
+
+size_t wasm_memory_get_category_usage(int category) {
+    if (category < 0 || category >= WASM_MEMORY_CATEGORIES) {
+        return 0;
+    }
+    return __atomic_load_n(&g_memory_manager.category_memory[category], __ATOMIC_RELAXED);
 }
 
 void wasm_memory_dump_stats(void) {
-    printf("=== WASM Memory Statistics ===\n");
-    printf("Total allocated: %zu bytes\n", g_memory_manager.total_allocated);
-    printf("Peak usage: %zu bytes\n", g_memory_manager.peak_usage);
-    printf("Allocation count: %d\n", g_memory_manager.allocation_count);
-    printf("Current allocations: %zu\n", g_memory_manager.total_allocated);
-    printf("Cache memory: %zu bytes\n", g_memory_manager.cache_memory);
-    printf("Buffer memory: %zu bytes\n", g_memory_manager.buffer_memory);
-    printf("Element memory: %zu bytes\n", g_memory_manager.element_memory);
+    wasm_memory_manager_t* m = &g_memory_manager;
 
-    if (g_memory_manager.leak_count > 0) {
-        printf("Leaked allocations: %d\n", g_memory_manager.leak_count);
+    printf("=== WASM Memory Statistics ===\n");
+    printf("Total allocated: %zu bytes\n", m->total_allocated);
+    printf("Peak usage: %zu bytes\n", m->peak_usage);
+    printf("Allocation count: %d\n", m->allocation_count);
+    printf("Current allocations: %d\n", m->live_allocations);
+    printf("Cache memory: %zu bytes\n", m->category_memory[WASM_MEMORY_CACHE]);
+    printf("Buffer memory: %zu bytes\n", m->category_memory[WASM_MEMORY_BUFFER]);
+    printf("Element memory: %zu bytes\n", m->category_memory[WASM_MEMORY_ELEMENT]);
+    printf("Recorded allocations: %zu (sample interval %zu bytes)\n",
+           m->table_used, m->sample_interval);
+
+    if (m->leak_count > 0) {
+        printf("Leaked allocations: %d\n", m->leak_count);
     }
     printf("==============================\n");
 }
@@ -240,7 +396,7 @@ typedef struct memory_pool {
 static memory_pool_t* g_pools = NULL;
 
 memory_pool_t* wasm_create_pool(size_t block_size, int initial_blocks) {
-    memory_pool_t* pool = WASM_MALLOC(sizeof(memory_pool_t));
+    memory_pool_t* pool = WASM_MALLOC(sizeof(memory_pool_t), WASM_MEMORY_OTHER);
     if (!pool) {
         return NULL;
     }
@@ -251,7 +407,7 @@ memory_pool_t* wasm_create_pool(size_t block_size, int initial_blocks) {
 
     // Allocate initial blocks
     for (int i = 0; i < initial_blocks && i < 16; i++) {
-        pool->blocks[i] = WASM_MALLOC(block_size);
+        pool->blocks[i] = WASM_MALLOC(block_size, WASM_MEMORY_OTHER);
         if (pool->blocks[i]) {
             pool->used_blocks++;
         }
@@ -265,7 +421,7 @@ memory_pool_t* wasm_create_pool(size_t block_size, int initial_blocks) {
 
 void* wasm_pool_alloc(memory_pool_t* pool) {
     if (!pool) {
-        return WASM_MALLOC(1024); // Default size
+        return WASM_MALLOC(1024, WASM_MEMORY_OTHER); // Default size
     }
 
     // Find unused block
@@ -279,7 +435,7 @@ void* wasm_pool_alloc(memory_pool_t* pool) {
 
     // Allocate new block if possible
     if (pool->used_blocks < 16) {
-        void* ptr = WASM_MALLOC(pool->block_size);
+        void* ptr = WASM_MALLOC(pool->block_size, WASM_MEMORY_OTHER);
         if (ptr) {
             pool->blocks[pool->used_blocks] = NULL;
             pool->used_blocks++;
@@ -346,20 +502,26 @@ void wasm_destroy_all_pools(void) {
 // ============================================================================
 
 int wasm_validate_memory(void) {
-    if (!g_memory_manager.tracking_enabled) {
-        return 1; // Validation not enabled
-    }
-
     int valid = 1;
-    memory_allocation_t* current = g_memory_manager.allocations;
 
-    while (current) {
+    // Only recorded allocations can be checked
+    TABLE_LOCK();
+    for (size_t i = 0; i < g_memory_manager.table_size; i++) {
+        memory_allocation_t* current = &g_memory_manager.table[i];
+        if (!current->ptr) {
+            continue;
+        }
+
         // Simple check: see if pointer is accessible
         volatile char test = *(char*)current->ptr;
         (void)test; // Suppress unused variable warning
 
-        current = current->next;
+        allocation_header_t* hdr = (allocation_header_t*)current->ptr - 1;
+        if (hdr->h.size != current->size || !hdr->h.sampled) {
+            valid = 0;
+        }
     }
+    TABLE_UNLOCK();
 
     return valid;
 }
@@ -372,23 +534,6 @@ void wasm_memory_gc(void) {
     }
 }
 
-// ============================================================================
-// INTEGRATION WITH CACHE SYSTEM
-// ============================================================================
-
-void wasm_memory_track_cache_memory(wasm_library_cache_t* cache) {
-    if (!cache) {
-        return;
-    }
-
-    size_t cache_memory = 0;
-    int total_structures = 0;
-    int total_elements = 0;
-
-    wasm_get_cache_stats(cache, &total_structures, &total_elements, &cache_memory);
-    g_memory_manager.cache_memory = cache_memory;
-}
-
 // ============================================================================
 // CLEANUP HELPERS
 // ============================================================================
@@ -398,7 +543,5 @@ void wasm_cleanup_all_resources(void) {
     wasm_destroy_all_pools();
 
     // Check for memory leaks
-    if (g_memory_manager.tracking_enabled) {
-        wasm_memory_shutdown();
-    }
-}
\ No newline at end of file
+    wasm_memory_shutdown();
+}
@@ -0,0 +1,151 @@
+/*
+ * Benchmark: Polygon Clipping (Boolean/poly_boolmex)
+ *
+ * Measures the throughput of the polygon operations of poly_boolmex
+ * with the Clipper library. The boundaries of the flat and dense
+ * standard layouts (see gen-layout.h) are divided into two operands
+ * by layer: boundaries on odd layers form the subject, those on even
+ * layers the clip polygons. The operations are applied as in
+ * poly_boolmex, including the merging of a single operand (or with
+ * an empty clip operand) and the tiled operation with all processors
+ * (4 x 4 tiles). The throughput is reported in input vertices per
+ * second; the number of result polygons is reported as a check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "clipper.hpp"
+#include "polytiles.hpp"
+
+extern "C" {
+#include "elwrite.h"
+#include "gen-layout.h"
+}
+#include "bench.h"
+
+#define BENCH "boolean"
+
+using namespace ClipperLib;
+
+struct bool_op {
+    const char *name;
+    ClipType op;
+    int merge;        // or with an empty clip operand
+    int tiles;        // tiles in x and y; 0 without tiles
+};
+
+static const bool_op ops[] = {
+    {"and",   ctIntersection, 0, 0},
+    {"or",    ctUnion,        0, 0},
+    {"diff",  ctDifference,   0, 0},
+    {"xor",   ctXor,          0, 0},
+    {"merge", ctUnion,        1, 0},
+    {"or_tiled", ctUnion,     0, 4},
+};
+
+struct tile_op {
+    ClipType op;
+    PolyFillType fill;
+};
+
+static bool clip_tile(Clipper &T, Paths &a, Paths &b, const Path &rect, PolyTree &res, void *arg) {
+    (void)rect;
+    T.AddPaths(a, ptSubject, true);
+    T.AddPaths(b, ptClip, true);
+
+    tile_op *top = (tile_op *)arg;
+
+    return T.Execute(top->op, res, top->fill, top->fill);
+}
+
+// apply an operation as poly_boolmex does
+static bool run_op(const bool_op &bo, const Paths &pa, const Paths &pb, Paths &pr) {
+    static const Paths empty;
+    const Paths &b = bo.merge ? empty : pb;
+    PolyFillType fill = bo.merge ? pftNonZero : pftEvenOdd;
+    Clipper C;
+
+    pr.clear();
+    if (bo.tiles) {
+        tile_op top = {bo.op, fill};
+        return TiledExecute(pa, b, bo.tiles, bo.tiles, 0, fill, 0, clip_tile, &top, pr);
+    }
+
+    C.AddPaths(pa, ptSubject, true);
+    C.AddPaths(b, ptClip, true);
+    return C.Execute(bo.op, pr, fill, fill);
+}
+
+static int bench_case(const gen_case_t *gc, int repeat) {
+    gen_layout_t gl;
+    Paths pa, pb, pr;
+    size_t nvert = 0, nvert_a = 0;
+    char metric[32];
+    int k, r;
+
+    if (gen_build(&gl, &gc->p)) {
+        fprintf(stderr, "%s: cannot build layout %s\n", BENCH, gc->name);
+        return -1;
+    }
+
+    // operands in database units
+    for (int s = 0; s < gl.nstruct; s++) {
+        const ew_list_t *ls = &gl.ls[s];
+        for (size_t e = 0; e < ls->nel; e++) {
+            const ew_element_t *pe = &ls->el[e];
+            if (pe->el.kind != GDS_BOUNDARY)
+                continue;
+            const ew_xy_t *pxy = &ls->xy[pe->xy];
+            Path p(pxy->m);
+            for (size_t j = 0; j < pxy->m; j++) {
+                p[j].X = (cInt)(pxy->xy[j] * GEN_UU_TO_DBU + 0.5);
+                p[j].Y = (cInt)(pxy->xy[pxy->m + j] * GEN_UU_TO_DBU + 0.5);
+            }
+            if (pe->el.layer % 2) {
+                pa.push_back(p);
+                nvert_a += pxy->m;
+            }
+            else
+                pb.push_back(p);
+            nvert += pxy->m;
+        }
+    }
+    gen_free(&gl);
+
+    for (k = 0; k < (int)(sizeof(ops)/sizeof(ops[0])); k++) {
+        double t, best = 1e30;
+        size_t nin = ops[k].merge ? nvert_a : nvert;
+
+        for (r = 0; r < repeat; r++) {
+            t = bench_now();
+            if (!run_op(ops[k], pa, pb, pr)) {
+                fprintf(stderr, "%s: %s failed for layout %s\n", BENCH, ops[k].name, gc->name);
+                return -1;
+            }
+            t = bench_now() - t;
+            if (t < best) best = t;
+        }
+        bench_result(BENCH, gc->name, ops[k].name, nin / best, "vert/s");
+        snprintf(metric, sizeof(metric), "%s_polygons", ops[k].name);
+        bench_result(BENCH, gc->name, metric, (double)pr.size(), "poly");
+    }
+
+    return 0;
+}
+
+int main(void) {
+    const gen_case_t *gc;
+    int ncase, k, err = 0;
+
+    // clipping is benchmarked on the flat layouts
+    gc = gen_standard_cases(bench_quick(), &ncase);
+    for (k = 0; k < ncase; k++) {
+        if (gc[k].p.depth == 1)
+            err |= bench_case(&gc[k], bench_repeat());
+    }
+
+    return err ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * Benchmark: GDSII Reading and Writing (Basic/gdsio)
+ *
+ * Measures for each standard layout (see gen-layout.h):
+ *   write    encoding of all elements into a library in memory with
+ *            encode_elements, as in write_gds_library
+ *   index    building the structure index of the library with
+ *            index_build, the first pass of reading a library
+ *   decode   reading all records and converting all vertices to
+ *            user units with xy_decode, as when the elements are read
+ * The throughput is reported in MB/s of library data and in elements
+ * per second. The library data are in memory, so that the numbers do
+ * not depend on the file system.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gdstypes.h"
+#include "mapio.h"
+#include "libindex.h"
+#include "xyconv.h"
+#include "elwrite.h"
+#include "gen-layout.h"
+#include "bench.h"
+
+#define BENCH "gdsio"
+
+// sink for the decoded coordinates
+static volatile double sink;
+
+/*
+ * reads all records and decodes the vertices; returns the number
+ * of elements or -1 on error
+ */
+static long decode_library(const uint8_t* data, size_t size) {
+    static double xy[16384];
+    map_file_t mf;
+    uint16_t rtype, rlen;
+    uint8_t* p;
+    long nel = 0;
+    double sum = 0.0;
+
+    memset(&mf, 0, sizeof(mf));
+    mf.base = (uint8_t*)data;
+    mf.size = size;
+
+    while (map_record_hdr(&mf, &rtype, &rlen) == A_OK) {
+        if (!(p = map_data(&mf, rlen)))
+            return -1;
+        if (rtype == XY) {
+            xy_decode(p, xy, rlen / 4, 1.0 / GEN_UU_TO_DBU);
+            sum += xy[0];
+        } else if (rtype == ENDEL) {
+            nel++;
+        } else if (rtype == ENDLIB) {
+            break;
+        }
+    }
+    sink = sum;
+
+    return nel;
+}
+
+static int bench_case(const gen_case_t* gc, int repeat) {
+    gen_layout_t gl;
+    ew_buffer_t wb;
+    lib_index_t li;
+    map_file_t mf;
+    double t, best;
+    double mb;
+    int k;
+
+    if (gen_build(&gl, &gc->p)) {
+        fprintf(stderr, "%s: cannot build layout %s\n", BENCH, gc->name);
+        return -1;
+    }
+    memset(&wb, 0, sizeof(wb));
+
+    // write
+    best = 1e30;
+    for (k = 0; k < repeat; k++) {
+        ew_buffer_clear(&wb);
+        t = bench_now();
+        if (gen_encode(&gl, &wb)) {
+            fprintf(stderr, "%s: cannot encode layout %s\n", BENCH, gc->name);
+            return -1;
+        }
+        t = bench_now() - t;
+        if (t < best) best = t;
+    }
+    mb = wb.size / 1048576.0;
+    bench_result(BENCH, gc->name, "size", mb, "MB");
+    bench_result(BENCH, gc->name, "elements", (double)gl.nel, "el");
+    bench_result(BENCH, gc->name, "write", mb / best, "MB/s");
+    bench_result(BENCH, gc->name, "write_elements", gl.nel / best, "el/s");
+
+    // structure index
+    best = 1e30;
+    for (k = 0; k < repeat; k++) {
+        memset(&li, 0, sizeof(li));
+        memset(&mf, 0, sizeof(mf));
+        mf.base = wb.base;
+        mf.size = wb.size;
+        t = bench_now();
+        if (index_build(&li, &mf) != A_OK || li.nstruct != (uint32_t)gl.nstruct) {
+            fprintf(stderr, "%s: cannot index layout %s\n", BENCH, gc->name);
+            return -1;
+        }
+        t = bench_now() - t;
+        index_free(&li);
+        if (t < best) best = t;
+    }
+    bench_result(BENCH, gc->name, "index", mb / best, "MB/s");
+
+    // decode all elements
+    best = 1e30;
+    for (k = 0; k < repeat; k++) {
+        t = bench_now();
+        if (decode_library(wb.base, wb.size) != (long)gl.nel) {
+            fprintf(stderr, "%s: cannot decode layout %s\n", BENCH, gc->name);
+            return -1;
+        }
+        t = bench_now() - t;
+        if (t < best) best = t;
+    }
+    bench_result(BENCH, gc->name, "decode", mb / best, "MB/s");
+    bench_result(BENCH, gc->name, "decode_elements", gl.nel / best, "el/s");
+
+    ew_buffer_free(&wb);
+    gen_free(&gl);
+    return 0;
+}
+
+int main(void) {
+    const gen_case_t* gc;
+    int ncase, k, err = 0;
+
+    gc = gen_standard_cases(bench_quick(), &ncase);
+    for (k = 0; k < ncase; k++)
+        err |= bench_case(&gc[k], bench_repeat());
+
+    return err ? 1 : 0;
+}
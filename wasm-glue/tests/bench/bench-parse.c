@@ -0,0 +1,79 @@
+/*
+ * Benchmark: Library Parsing in the Viewer (wasm-glue)
+ *
+ * Measures for each standard layout (see gen-layout.h) the time to
+ * create a library cache, find the structures and parse all elements
+ * with wasm_parse_all_data, and the peak heap memory allocated through
+ * the memory manager during parsing. The library data are not counted
+ * in the peak because they are owned by the caller.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "wasm-element-cache.h"
+#include "wasm-memory-manager.h"
+#include "elwrite.h"
+#include "gen-layout.h"
+#include "bench.h"
+
+#define BENCH "parse"
+
+static int bench_case(const gen_case_t* gc, int repeat) {
+    gen_layout_t gl;
+    ew_buffer_t wb;
+    wasm_library_cache_t* cache;
+    size_t base, peak;
+    double t, best;
+    double mb;
+    int k;
+
+    memset(&wb, 0, sizeof(wb));
+    if (gen_build(&gl, &gc->p) || gen_encode(&gl, &wb)) {
+        fprintf(stderr, "%s: cannot generate layout %s\n", BENCH, gc->name);
+        return -1;
+    }
+    gen_free(&gl);
+    mb = wb.size / 1048576.0;
+
+    best = 1e30;
+    peak = 0;
+    for (k = 0; k < repeat; k++) {
+        wasm_memory_get_stats(&base, NULL, NULL, NULL);
+        wasm_memory_reset_peak();
+
+        t = bench_now();
+        cache = wasm_create_library_cache(wb.base, wb.size);
+        if (!cache || wasm_parse_all_data(cache) != 0) {
+            fprintf(stderr, "%s: cannot parse layout %s\n", BENCH, gc->name);
+            return -1;
+        }
+        t = bench_now() - t;
+        if (t < best) best = t;
+
+        wasm_memory_get_stats(NULL, &peak, NULL, NULL);
+        wasm_free_library_cache(cache);
+    }
+
+    bench_result(BENCH, gc->name, "size", mb, "MB");
+    bench_result(BENCH, gc->name, "parse_time", 1e3 * best, "ms");
+    bench_result(BENCH, gc->name, "parse", mb / best, "MB/s");
+    bench_result(BENCH, gc->name, "heap_peak", (peak - base) / 1048576.0, "MB");
+
+    ew_buffer_free(&wb);
+    return 0;
+}
+
+int main(void) {
+    const gen_case_t* gc;
+    int ncase, k, err = 0;
+
+    wasm_memory_init(0, 0);
+    gc = gen_standard_cases(bench_quick(), &ncase);
+    for (k = 0; k < ncase; k++)
+        err |= bench_case(&gc[k], bench_repeat());
+
+    return err ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Benchmark Helpers
+ *
+ * Timing, repetition and result output shared by the benchmarks.
+ * Each measurement is repeated and the fastest run is reported, which
+ * is the most stable statistic on a busy machine. Results are written
+ * as tab-separated lines
+ *
+ *     commit  benchmark  case  metric  value  unit
+ *
+ * to standard output, so that the results of two commits can be
+ * compared line by line (see compare-bench.sh). The commit is taken
+ * from the environment variable BENCH_COMMIT.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+// Default number of repetitions of each measurement
+#define BENCH_REPEAT 5
+
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+/*
+ * number of repetitions from BENCH_REPEAT in the environment
+ */
+static inline int bench_repeat(void) {
+    const char* s = getenv("BENCH_REPEAT");
+    int n = s ? atoi(s) : 0;
+    return n > 0 ? n : BENCH_REPEAT;
+}
+
+/*
+ * quick mode (BENCH_QUICK=1) uses smaller layouts
+ */
+static inline int bench_quick(void) {
+    const char* s = getenv("BENCH_QUICK");
+    return s && atoi(s) > 0;
+}
+
+static inline void bench_result(const char* bench, const char* name,
+                                const char* metric, double value, const char* unit) {
+    const char* commit = getenv("BENCH_COMMIT");
+    printf("%s\t%s\t%s\t%s\t%.6g\t%s\n", commit && *commit ? commit : "unknown",
+           bench, name, metric, value, unit);
+    fflush(stdout);
+}
+
+/*
+ * deterministic pseudo-random numbers (linear congruential generator),
+ * so that every run generates the same layouts
+ */
+static inline uint32_t bench_rand(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// uniform number in [0, 1)
+static inline double bench_uniform(uint32_t* state) {
+    return bench_rand(state) / 16777216.0;
+}
+
+#endif /* BENCH_H */
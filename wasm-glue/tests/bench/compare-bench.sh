@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# Compares two benchmark result tables written by run-bench.sh
+#
+# Usage: compare-bench.sh [--threshold PCT] OLD.tsv NEW.tsv
+#
+# Prints the ratio new/old of every metric found in both tables.
+# Throughput metrics (unit ending in /s) regress when they drop,
+# times and memory (ms, MB) when they grow; result counts must be
+# equal. Changes beyond the threshold (default 10 percent) are
+# marked, and the exit status is 1 when any metric regressed.
+
+THRESHOLD=10
+if [ "$1" = "--threshold" ]; then
+    THRESHOLD="$2"
+    shift 2
+fi
+
+if [ $# -ne 2 ]; then
+    echo "usage: $0 [--threshold PCT] OLD.tsv NEW.tsv" >&2
+    exit 2
+fi
+
+awk -F '\t' -v thr="$THRESHOLD" '
+    FNR == 1 { next }
+    NR == FNR { old[$2 "\t" $3 "\t" $4] = $5; next }
+    {
+        key = $2 "\t" $3 "\t" $4
+        if (!(key in old)) next
+        o = old[key]; n = $5; mark = ""
+        ratio = o != 0 ? n / o : (n == 0 ? 1 : 0)
+        if ($4 == "size" || $4 == "elements")
+            next
+        if ($6 == "poly" || $6 == "el") {
+            if (n != o) { mark = "CHANGED"; bad = 1 }
+        } else if ($6 ~ /\/s$/) {
+            if (ratio < 1 - thr / 100) { mark = "REGRESSION"; bad = 1 }
+            else if (ratio > 1 + thr / 100) mark = "improved"
+        } else {
+            if (ratio > 1 + thr / 100) { mark = "REGRESSION"; bad = 1 }
+            else if (ratio < 1 - thr / 100) mark = "improved"
+        }
+        printf "%-8s %-6s %-20s %12.4g %12.4g %7.3f  %s\n", $2, $3, $4, o, n, ratio, mark
+    }
+    END { exit bad }
+' "$1" "$2"
@@ -0,0 +1,250 @@
+/*
+ * Synthetic Layout Generator (see gen-layout.h)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gdstypes.h"
+#include "byteswap.h"
+#include "convert_float_gcc.h"
+#include "elwrite.h"
+#include "gen-layout.h"
+#include "bench.h"
+
+// area of the random element positions in user units
+#define GEN_EXTENT 1000.0
+
+// pitch of the array references in user units
+#define GEN_PITCH 10.0
+
+/*
+ * Standard layouts:
+ *   flat    one structure with many small polygons and paths
+ *   dense   one structure with polygons of many vertices
+ *   hier    four levels of structures with srefs and some arefs
+ *   arefs   two levels where most references are arefs
+ */
+static const gen_case_t standard_cases[] = {
+    //          depth cells refs  elements vert path aref dim lay seed
+    {"flat",  {1,    0,    0,    200000,  8,   20,  0,   0,  16, 1}},
+    {"dense", {1,    0,    0,    10000,   256, 0,   0,   0,  4,  2}},
+    {"hier",  {4,    40,   25,   2000,    6,   20,  20,  8,  16, 3}},
+    {"arefs", {2,    100,  2000, 50,      5,   0,   80,  16, 8,  4}},
+};
+
+static const gen_case_t quick_cases[] = {
+    {"flat",  {1,    0,    0,    20000,   8,   20,  0,   0,  16, 1}},
+    {"dense", {1,    0,    0,    1000,    256, 0,   0,   0,  4,  2}},
+    {"hier",  {4,    10,   5,    200,     6,   20,  20,  8,  16, 3}},
+    {"arefs", {2,    20,   200,  20,      5,   0,   80,  16, 8,  4}},
+};
+
+const gen_case_t* gen_standard_cases(int quick, int* ncase) {
+    *ncase = 4;
+    return quick ? quick_cases : standard_cases;
+}
+
+/*
+ * Helpers for appending records to an encoding buffer
+ */
+static int reserve(ew_buffer_t* wb, size_t n) {
+    if (wb->size + n > wb->alloc) {
+        size_t na = wb->alloc ? wb->alloc : 65536;
+        while (na < wb->size + n) na *= 2;
+        uint8_t* pn = realloc(wb->base, na);
+        if (!pn) {
+            wb->err = 1;
+            return -1;
+        }
+        wb->base = pn;
+        wb->alloc = na;
+    }
+    return 0;
+}
+
+static void put_u16(ew_buffer_t* wb, uint16_t v) {
+    if (reserve(wb, 2)) return;
+    wb->base[wb->size++] = v >> 8;
+    wb->base[wb->size++] = v & 0xFF;
+}
+
+static void put_header(ew_buffer_t* wb, uint16_t type, uint16_t ndata) {
+    put_u16(wb, ndata + 4);
+    put_u16(wb, type);
+}
+
+static void put_string(ew_buffer_t* wb, uint16_t type, const char* s) {
+    size_t n = strlen(s);
+    size_t np = n + (n & 1);
+    put_header(wb, type, (uint16_t)np);
+    if (reserve(wb, np)) return;
+    memcpy(wb->base + wb->size, s, n);
+    if (np > n) wb->base[wb->size + n] = 0;
+    wb->size += np;
+}
+
+static void put_real8(ew_buffer_t* wb, double d) {
+    uint64_t e;
+    ieee754_to_excess64(d, &e);
+    if (reserve(wb, sizeof(e))) return;
+    memcpy(wb->base + wb->size, &e, sizeof(e));
+    wb->size += sizeof(e);
+}
+
+static void put_dates(ew_buffer_t* wb, uint16_t type) {
+    static const uint16_t date[6] = {2014, 1, 1, 0, 0, 0};
+    put_header(wb, type, 24);
+    for (int i = 0; i < 12; i++) put_u16(wb, date[i % 6]);
+}
+
+/*
+ * elements of one structure
+ */
+static int build_structure(gen_layout_t* gl, int s, int level, const gen_params_t* p,
+                           uint32_t* rng) {
+    ew_list_t* ls = &gl->ls[s];
+    int nref = level < p->depth - 1 ? p->refs : 0;
+    int nel = p->elements + nref;
+    int m = p->vertices;
+
+    memset(ls, 0, sizeof(ew_list_t));
+    ls->el = calloc(nel ? nel : 1, sizeof(ew_element_t));
+    ls->xy = calloc(nel ? nel : 1, sizeof(ew_xy_t));
+    ls->str = malloc(nref * 16 + 1);
+    gl->pool[s] = malloc(((size_t)p->elements * 2 * m + (size_t)nref * 6 + 1) * sizeof(double));
+    if (!ls->el || !ls->xy || !ls->str || !gl->pool[s]) return -1;
+    ls->ael = ls->axy = nel;
+    ls->astr = nref * 16 + 1;
+
+    double* v = gl->pool[s];
+    for (int k = 0; k < p->elements; k++) {
+        ew_element_t* pe = &ls->el[ls->nel++];
+        double cx = GEN_EXTENT * bench_uniform(rng);
+        double cy = GEN_EXTENT * bench_uniform(rng);
+        double r = 0.5 + 4.5 * bench_uniform(rng);
+
+        pe->el.layer = 1 + bench_rand(rng) % p->layers;
+        pe->xy = ls->nxy;
+        pe->nxy = 1;
+        if ((int)(bench_rand(rng) % 100) < p->path_pct) {
+            pe->el.kind = GDS_PATH;
+            pe->el.has = HAS_WIDTH;
+            pe->el.width = 0.2f;
+            for (int j = 0; j < m; j++) {
+                v[j] = cx + j * r;
+                v[m + j] = cy + (j % 2) * r;
+            }
+        } else {
+            // star-shaped polygon; closed by the encoder
+            pe->el.kind = GDS_BOUNDARY;
+            for (int j = 0; j < m; j++) {
+                double a = 2.0 * M_PI * j / m;
+                double rj = j % 2 ? 0.6 * r : r;
+                v[j] = cx + rj * cos(a);
+                v[m + j] = cy + rj * sin(a);
+            }
+        }
+        ls->xy[ls->nxy].xy = v;
+        ls->xy[ls->nxy++].m = m;
+        v += 2 * m;
+        gl->nvert += m;
+    }
+
+    for (int k = 0; k < nref; k++) {
+        ew_element_t* pe = &ls->el[ls->nel++];
+        int child = 1 + level * p->cells + (s * 7 + k) % p->cells;
+        double x = GEN_EXTENT * bench_uniform(rng);
+        double y = GEN_EXTENT * bench_uniform(rng);
+
+        pe->str = ls->nstr;
+        strcpy(ls->str + ls->nstr, gl->names[child]);
+        ls->nstr += strlen(gl->names[child]) + 1;
+        pe->xy = ls->nxy;
+        pe->nxy = 1;
+        if ((int)(bench_rand(rng) % 100) < p->aref_pct) {
+            pe->el.kind = GDS_AREF;
+            pe->el.ncol = pe->el.nrow = p->aref_dim;
+            v[0] = x;  v[1] = x + p->aref_dim * GEN_PITCH;  v[2] = x;
+            v[3] = y;  v[4] = y;  v[5] = y + p->aref_dim * GEN_PITCH;
+            ls->xy[ls->nxy].m = 3;
+        } else {
+            pe->el.kind = GDS_SREF;
+            v[0] = x;
+            v[1] = y;
+            ls->xy[ls->nxy].m = 1;
+        }
+        ls->xy[ls->nxy++].xy = v;
+        v += 2 * ls->xy[ls->nxy - 1].m;
+    }
+
+    gl->nel += nel;
+    return 0;
+}
+
+int gen_build(gen_layout_t* gl, const gen_params_t* p) {
+    uint32_t rng = p->seed;
+
+    memset(gl, 0, sizeof(gen_layout_t));
+    gl->nstruct = 1 + (p->depth - 1) * p->cells;
+    gl->names = calloc(gl->nstruct, sizeof(*gl->names));
+    gl->ls = calloc(gl->nstruct, sizeof(ew_list_t));
+    gl->pool = calloc(gl->nstruct, sizeof(double*));
+    if (!gl->names || !gl->ls || !gl->pool) {
+        gen_free(gl);
+        return -1;
+    }
+
+    strcpy(gl->names[0], "TOP");
+    for (int l = 1; l < p->depth; l++)
+        for (int k = 0; k < p->cells; k++)
+            snprintf(gl->names[1 + (l - 1) * p->cells + k], 16, "L%hu_%hu",
+                     (unsigned short)l, (unsigned short)k);
+
+    for (int s = 0; s < gl->nstruct; s++) {
+        int level = s == 0 ? 0 : 1 + (s - 1) / p->cells;
+        if (build_structure(gl, s, level, p, &rng)) {
+            gen_free(gl);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int gen_encode(const gen_layout_t* gl, ew_buffer_t* wb) {
+    put_header(wb, HEADER, 2);
+    put_u16(wb, 600);
+    put_dates(wb, BGNLIB);
+    put_string(wb, LIBNAME, "BENCHLIB");
+    put_header(wb, UNITS, 16);
+    put_real8(wb, 1.0 / GEN_UU_TO_DBU);
+    put_real8(wb, 1e-9);
+
+    // referenced structures first
+    for (int s = gl->nstruct - 1; s >= 0; s--) {
+        put_dates(wb, BGNSTR);
+        put_string(wb, STRNAME, gl->names[s]);
+        if (encode_elements(wb, &gl->ls[s], GEN_UU_TO_DBU, 0)) return -1;
+        put_header(wb, ENDSTR, 0);
+    }
+    put_header(wb, ENDLIB, 0);
+
+    return wb->err ? -1 : 0;
+}
+
+void gen_free(gen_layout_t* gl) {
+    for (int s = 0; gl->ls && s < gl->nstruct; s++) {
+        free(gl->ls[s].el);
+        free(gl->ls[s].xy);
+        free(gl->ls[s].str);
+    }
+    for (int s = 0; gl->pool && s < gl->nstruct; s++)
+        free(gl->pool[s]);
+    free(gl->ls);
+    free(gl->pool);
+    free(gl->names);
+    memset(gl, 0, sizeof(gen_layout_t));
+}
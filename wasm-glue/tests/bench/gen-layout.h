@@ -0,0 +1,78 @@
+/*
+ * Synthetic Layout Generator
+ *
+ * Generates GDSII libraries with a given number of elements, vertices
+ * per polygon, hierarchy depth and density of array references for
+ * the benchmarks. The elements of each structure are first built as
+ * element lists (see elwrite.h) and then encoded into a library in
+ * memory with encode_elements, the function that writes libraries in
+ * write_gds_library. The layouts depend only on the parameters.
+ *
+ * Hierarchy: the top structure is at level 0. Each level below holds
+ * `cells` structures; every structure above the last level references
+ * `refs` structures of the next level, and `aref_pct` percent of these
+ * references are aref_dim x aref_dim array references. Every structure
+ * holds `elements` boundaries and paths.
+ */
+
+#ifndef GEN_LAYOUT_H
+#define GEN_LAYOUT_H
+
+#include <stdint.h>
+#include "elwrite.h"
+
+// user units to database units of the generated libraries
+#define GEN_UU_TO_DBU 1000.0
+
+typedef struct {
+    int depth;          // number of hierarchy levels, >= 1
+    int cells;          // structures on each level below the top
+    int refs;           // references in each structure above the last level
+    int elements;       // boundaries and paths in each structure
+    int vertices;       // vertices of each polygon or path, >= 3
+    int path_pct;       // percentage of elements that are paths
+    int aref_pct;       // percentage of references that are arefs
+    int aref_dim;       // rows and columns of the arefs
+    int layers;         // number of layers
+    uint32_t seed;      // seed of the random positions
+} gen_params_t;
+
+// a named parameter set
+typedef struct {
+    const char* name;
+    gen_params_t p;
+} gen_case_t;
+
+typedef struct {
+    int nstruct;        // number of structures
+    char (*names)[16];  // structure names
+    ew_list_t* ls;      // elements of each structure
+    double** pool;      // vertices of each structure
+    uint64_t nel;       // number of elements, including references
+    uint64_t nvert;     // number of vertices
+} gen_layout_t;
+
+/*
+ * returns the standard layouts of the benchmarks; quick != 0 selects
+ * smaller layouts with the same structure
+ */
+const gen_case_t* gen_standard_cases(int quick, int* ncase);
+
+/*
+ * builds the element lists of a layout. Returns 0 on success or -1
+ * when memory cannot be allocated.
+ */
+int gen_build(gen_layout_t* gl, const gen_params_t* p);
+
+/*
+ * encodes the layout as a complete library and appends it to wb.
+ * Returns 0 on success or -1 when memory cannot be allocated.
+ */
+int gen_encode(const gen_layout_t* gl, ew_buffer_t* wb);
+
+/*
+ * releases the memory of a layout
+ */
+void gen_free(gen_layout_t* gl);
+
+#endif /* GEN_LAYOUT_H */
@@ -0,0 +1,49 @@
+#!/bin/bash
+
+# Benchmark Runner for the GDSII Toolbox
+# Runs the gdsio, parser and polygon clipping benchmarks and writes
+# the results as a tab-separated table to results/<commit>.tsv
+#
+# Usage: run-bench.sh [--quick] [--repeat N] [--output FILE]
+
+set -e
+
+BENCH_DIR="$(cd "$(dirname "$0")" && pwd)"
+RESULTS_DIR="$BENCH_DIR/results"
+BENCHMARKS="bench-gdsio bench-parse bench-boolean"
+
+export BENCH_REPEAT=${BENCH_REPEAT:-5}
+OUTPUT=""
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        --quick)  export BENCH_QUICK=1 ;;
+        --repeat) shift; export BENCH_REPEAT="$1" ;;
+        --output) shift; OUTPUT="$1" ;;
+        *)        echo "usage: $0 [--quick] [--repeat N] [--output FILE]" >&2; exit 2 ;;
+    esac
+    shift
+done
+
+# results are tagged with the commit; uncommitted changes are marked
+if [ -z "$BENCH_COMMIT" ]; then
+    BENCH_COMMIT=$(git -C "$BENCH_DIR" rev-parse --short HEAD 2>/dev/null || echo unknown)
+    if ! git -C "$BENCH_DIR" diff --quiet HEAD -- 2>/dev/null; then
+        BENCH_COMMIT="$BENCH_COMMIT-dirty"
+    fi
+fi
+export BENCH_COMMIT
+
+make -s -C "$BENCH_DIR/.." bench-build
+
+mkdir -p "$RESULTS_DIR"
+OUTPUT=${OUTPUT:-$RESULTS_DIR/$BENCH_COMMIT.tsv}
+
+{
+    printf "commit\tbench\tcase\tmetric\tvalue\tunit\n"
+    for b in $BENCHMARKS; do
+        "$BENCH_DIR/$b"
+    done
+} > "$OUTPUT"
+
+echo "Benchmark results written to $OUTPUT"
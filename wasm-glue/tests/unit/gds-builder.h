@@ -0,0 +1,105 @@
+/*
+ * GDSII Library Builder for the Unit Tests - Header Only Implementation
+ *
+ * Writes GDSII records into a memory buffer that grows as needed.
+ * Test libraries are built record by record; each test keeps only
+ * the records of its own scenario. The buffer is allocated with the
+ * first record and released by the caller with free(b.data).
+ *
+ * Copyright (c) 2026
+ */
+
+#ifndef _GDS_BUILDER_H
+#define _GDS_BUILDER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gdstypes.h"
+
+typedef struct {
+    uint8_t* data;
+    size_t pos;
+    size_t cap;
+} gds_buffer_t;
+
+static inline uint8_t* put_space(gds_buffer_t* b, size_t n) {
+    if (b->pos + n > b->cap) {
+        size_t cap = b->cap ? 2 * b->cap : 4096;
+        while (cap < b->pos + n)
+            cap *= 2;
+        b->data = realloc(b->data, cap);
+        if (b->data == NULL) {
+            fprintf(stderr, "gds-builder: out of memory\n");
+            exit(1);
+        }
+        b->cap = cap;
+    }
+    b->pos += n;
+    return b->data + b->pos - n;
+}
+
+static inline void put_bytes(gds_buffer_t* b, const void* p, size_t n) {
+    memcpy(put_space(b, n), p, n);
+}
+
+static inline void put_u16(gds_buffer_t* b, uint16_t v) {
+    uint8_t* p = put_space(b, 2);
+    p[0] = v >> 8;
+    p[1] = v & 0xFF;
+}
+
+static inline void put_i32(gds_buffer_t* b, int32_t v) {
+    uint32_t u = (uint32_t)v;
+    uint8_t* p = put_space(b, 4);
+    p[0] = u >> 24;
+    p[1] = (u >> 16) & 0xFF;
+    p[2] = (u >> 8) & 0xFF;
+    p[3] = u & 0xFF;
+}
+
+static inline void put_header(gds_buffer_t* b, uint16_t type, uint16_t ndata) {
+    put_u16(b, ndata + 4);
+    put_u16(b, type);
+}
+
+// string record, padded with a zero byte to an even length
+static inline void put_string(gds_buffer_t* b, uint16_t type, const char* s) {
+    size_t n = strlen(s);
+    size_t np = n + (n & 1);
+    put_header(b, type, np);
+    memset(put_space(b, np), 0, np);
+    memcpy(b->data + b->pos - np, s, n);
+}
+
+static inline void put_xy(gds_buffer_t* b, const int32_t* xy, int n) {
+    put_header(b, XY, 8 * n);
+    for (int i = 0; i < 2 * n; i++) put_i32(b, xy[i]);
+}
+
+// HEADER, BGNLIB and LIBNAME records; units are written by the caller
+static inline void put_library_header(gds_buffer_t* b, uint16_t version, const char* name) {
+    put_header(b, HEADER, 2);
+    put_u16(b, version);
+    put_header(b, BGNLIB, 24);
+    for (int i = 0; i < 12; i++) put_u16(b, 0);
+    put_string(b, LIBNAME, name);
+}
+
+// library header with zero units; the wasm parser does not need them
+static inline void put_library(gds_buffer_t* b, const char* name) {
+    put_library_header(b, 5, name);
+    put_header(b, UNITS, 16);
+    memset(put_space(b, 16), 0, 16);
+}
+
+// BGNSTR with zero dates and STRNAME
+static inline void put_structure(gds_buffer_t* b, const char* name) {
+    put_header(b, BGNSTR, 24);
+    for (int i = 0; i < 12; i++) put_u16(b, 0);
+    put_string(b, STRNAME, name);
+}
+
+#endif /* _GDS_BUILDER_H */
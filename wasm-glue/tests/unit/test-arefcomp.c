@@ -0,0 +1,264 @@
+/*
+ * Test Suite: Array Reference Compression
+ *
+ * Tests verify the detection of regular arrays of identical
+ * elements (Basic/gdsio/arefcomp.c): equal keys share a class,
+ * regular grids become arrays with the right origin, pitch and
+ * dimensions, elements of different classes or off the grid are
+ * not combined, and the minimum repetition count is respected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arefcomp.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+static void add_item(ac_item_t *it, size_t *n, uint32_t cls, int32_t x, int32_t y) {
+    it[*n].cls = cls;
+    it[*n].x = x;
+    it[*n].y = y;
+    it[*n].item = (uint32_t)*n;
+    it[*n].array = -2;
+    (*n)++;
+}
+
+static size_t count_in_arrays(const ac_item_t *it, size_t n) {
+    size_t k, c = 0;
+
+    for (k = 0; k < n; k++)
+        c += it[k].array >= 0;
+    return c;
+}
+
+/*
+ * Test: element classes
+ */
+static void test_classes(void) {
+    ac_classes_t cl;
+    int32_t a[5] = {0, 1, 0, 4, 100};
+    int32_t b[5] = {0, 1, 0, 4, 101};
+    int32_t key[3];
+    uint32_t ca, cb, k, c;
+    int ok = 1;
+
+    printf("\nTest: Element classes\n");
+
+    memset(&cl, 0, sizeof(cl));
+    ca = ac_class(&cl, a, 5);
+    cb = ac_class(&cl, b, 5);
+    TEST_ASSERT(ca == 0 && cb == 1, "Different keys get new classes");
+    TEST_ASSERT(ac_class(&cl, a, 5) == ca, "Equal keys share a class");
+    TEST_ASSERT(ac_class(&cl, a, 4) != ca, "Key length is part of the key");
+
+    // many classes force the table to grow
+    for (k = 0; k < 5000; k++) {
+        key[0] = 7;
+        key[1] = (int32_t)k;
+        key[2] = -(int32_t)k;
+        c = ac_class(&cl, key, 3);
+        if (c != k + 3)
+            ok = 0;
+    }
+    for (k = 0; k < 5000 && ok; k++) {
+        key[0] = 7;
+        key[1] = (int32_t)k;
+        key[2] = -(int32_t)k;
+        if (ac_class(&cl, key, 3) != k + 3)
+            ok = 0;
+    }
+    TEST_ASSERT(ok && cl.n == 5003, "Classes are found after the table grows");
+    TEST_ASSERT(ac_class(&cl, b, 5) == cb, "First classes survive the growth");
+
+    ac_class_free(&cl);
+    TEST_ASSERT(cl.n == 0 && cl.slot == NULL, "Class table is released");
+}
+
+/*
+ * Test: a full grid, a row, and a column
+ */
+static void test_grids(void) {
+    ac_item_t it[200];
+    ac_array_t *arr;
+    size_t n = 0, narr, k;
+    int r, c, ok;
+
+    printf("\nTest: Regular grids\n");
+
+    // 5 x 4 grid of class 0, added in reverse order
+    for (r = 3; r >= 0; r--)
+        for (c = 4; c >= 0; c--)
+            add_item(it, &n, 0, -100 + 20 * c, 50 + 30 * r);
+
+    // row of 6 elements of class 1
+    for (c = 0; c < 6; c++)
+        add_item(it, &n, 1, 1000 + 7 * c, 0);
+
+    // column of 3 elements of class 2
+    for (r = 0; r < 3; r++)
+        add_item(it, &n, 2, 0, -500 + 11 * r);
+
+    TEST_ASSERT(ac_find_arrays(it, n, 2, &arr, &narr) == 0, "Arrays are found");
+    TEST_ASSERT(narr == 3, "Three arrays");
+    TEST_ASSERT(count_in_arrays(it, n) == n, "All elements are in arrays");
+
+    ok = narr == 3;
+    for (k = 0; k < narr && ok; k++) {
+        if (arr[k].cls == 0)
+            ok = arr[k].x == -100 && arr[k].y == 50 && arr[k].dc == 20 &&
+                 arr[k].dr == 30 && arr[k].ncol == 5 && arr[k].nrow == 4 &&
+                 arr[k].item == 19;
+    }
+    TEST_ASSERT(ok, "Grid origin, pitch and dimensions");
+
+    ok = 0;
+    for (k = 0; k < narr; k++) {
+        if (arr[k].cls == 1)
+            ok = arr[k].x == 1000 && arr[k].ncol == 6 && arr[k].nrow == 1 &&
+                 arr[k].dc == 7 && arr[k].dr == 7;
+    }
+    TEST_ASSERT(ok, "Single row repeats the column pitch");
+
+    ok = 0;
+    for (k = 0; k < narr; k++) {
+        if (arr[k].cls == 2)
+            ok = arr[k].y == -500 && arr[k].ncol == 1 && arr[k].nrow == 3 &&
+                 arr[k].dr == 11 && arr[k].dc == 11;
+    }
+    TEST_ASSERT(ok, "Single column repeats the row pitch");
+
+    ok = 1;
+    for (k = 0; k < n; k++)
+        if (arr[it[k].array].cls != it[k].cls)
+            ok = 0;
+    TEST_ASSERT(ok, "Elements are assigned to the array of their class");
+
+    free(arr);
+}
+
+/*
+ * Test: irregular positions, duplicates and minrep
+ */
+static void test_irregular(void) {
+    ac_item_t it[100];
+    ac_array_t *arr;
+    size_t n = 0, narr;
+    int c;
+
+    printf("\nTest: Irregular positions\n");
+
+    // rows of different length are not stacked
+    for (c = 0; c < 4; c++)
+        add_item(it, &n, 0, 10 * c, 0);
+    for (c = 0; c < 3; c++)
+        add_item(it, &n, 0, 10 * c, 10);
+    ac_find_arrays(it, n, 2, &arr, &narr);
+    TEST_ASSERT(narr == 2 && count_in_arrays(it, n) == 7, "Rows of different length");
+    free(arr);
+
+    // elements of different classes are not combined
+    n = 0;
+    for (c = 0; c < 6; c++)
+        add_item(it, &n, (uint32_t)(c % 2), 10 * c, 0);
+    ac_find_arrays(it, n, 4, &arr, &narr);
+    TEST_ASSERT(narr == 0 && count_in_arrays(it, n) == 0, "Alternating classes");
+    free(arr);
+
+    // elements at the same position are not combined
+    n = 0;
+    for (c = 0; c < 4; c++)
+        add_item(it, &n, 3, 5, 5);
+    ac_find_arrays(it, n, 2, &arr, &narr);
+    TEST_ASSERT(narr == 0, "Duplicate elements");
+    free(arr);
+
+    // minimum repetition count
+    n = 0;
+    for (c = 0; c < 3; c++)
+        add_item(it, &n, 0, 10 * c, 0);
+    ac_find_arrays(it, n, 4, &arr, &narr);
+    TEST_ASSERT(narr == 0 && it[0].array == -1, "Too few elements for an array");
+    free(arr);
+    ac_find_arrays(it, n, 3, &arr, &narr);
+    TEST_ASSERT(narr == 1 && arr[0].ncol == 3, "Exactly minrep elements");
+    free(arr);
+    ac_find_arrays(it, n, 0, &arr, &narr);
+    TEST_ASSERT(narr == 1, "minrep below 2 is raised to 2");
+    free(arr);
+
+    // a single element and no elements
+    ac_find_arrays(it, 1, 2, &arr, &narr);
+    TEST_ASSERT(narr == 0 && arr == NULL, "Single element");
+    ac_find_arrays(it, 0, 2, &arr, &narr);
+    TEST_ASSERT(narr == 0 && arr == NULL, "No elements");
+
+    // corner points outside the coordinate range
+    n = 0;
+    for (c = 0; c < 4; c++)
+        add_item(it, &n, 0, 2000000000 + 40000000 * c, 0);
+    ac_find_arrays(it, n, 2, &arr, &narr);
+    TEST_ASSERT(narr == 0, "Arrays must fit into 32-bit coordinates");
+    free(arr);
+}
+
+/*
+ * Test: rows longer than the maximum aref dimension are split
+ */
+static void test_large(void) {
+    size_t n = 0, narr, k, total = 0;
+    ac_item_t *it;
+    ac_array_t *arr;
+    int32_t c;
+
+    printf("\nTest: Large arrays\n");
+
+    it = malloc((AC_MAXDIM + 10) * sizeof(ac_item_t));
+    for (c = 0; c < AC_MAXDIM + 10; c++)
+        add_item(it, &n, 0, 3 * c, 0);
+    ac_find_arrays(it, n, 2, &arr, &narr);
+    for (k = 0; k < narr; k++) {
+        total += arr[k].ncol;
+    }
+    TEST_ASSERT(narr == 2 && arr[0].ncol <= AC_MAXDIM && total == n,
+                "Long row is split into two arrays");
+    free(arr);
+    free(it);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Array Reference Compression Tests\n");
+    printf("========================================\n");
+
+    test_classes();
+    test_grids();
+    test_irregular();
+    test_large();
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * Test Suite: Bitmap Decomposition
+ *
+ * Tests verify the decomposition of bitmaps into rectangles
+ * (Structures/private/bmrect.c) used by gdsii_bitmap: the rectangles
+ * must cover every black pixel exactly once and no white pixel, and
+ * runs in consecutive rows with the same columns must be merged.
+ */
+
+#define _POSIX_C_SOURCE 199309L   // for clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "bmrect.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * every black pixel is covered once, no white pixel is covered
+ */
+static int check_cover(const uint8_t* pix, int ncol, int nrow, const bm_list_t* ls) {
+    uint8_t* cnt = calloc((size_t)ncol * nrow, 1);
+    int ok = 1;
+
+    for (size_t k = 0; k < ls->nrect && ok; k++) {
+        const bm_rect_t* r = &ls->rect[k];
+        if (r->x < 0 || r->y < 0 || r->w <= 0 || r->h <= 0 ||
+            r->x + r->w > ncol || r->y + r->h > nrow) {
+            ok = 0;
+            break;
+        }
+        for (int y = r->y; y < r->y + r->h; y++)
+            for (int x = r->x; x < r->x + r->w; x++)
+                cnt[(size_t)y * ncol + x]++;
+    }
+    for (size_t k = 0; k < (size_t)ncol * nrow && ok; k++)
+        ok = cnt[k] == (pix[k] != 0);
+
+    free(cnt);
+    return ok;
+}
+
+static size_t decompose(const uint8_t* pix, int ncol, int nrow, bm_list_t* ls) {
+    memset(ls, 0, sizeof(bm_list_t));
+    if (bm_rectangles(pix, ncol, nrow, ls)) return (size_t)-1;
+    return ls->nrect;
+}
+
+static uint8_t* parse_bitmap(const char* rows[], int nrow, int* ncol) {
+    uint8_t* pix;
+
+    *ncol = (int)strlen(rows[0]);
+    pix = malloc((size_t)*ncol * nrow);
+    for (int y = 0; y < nrow; y++)
+        for (int x = 0; x < *ncol; x++)
+            pix[y * *ncol + x] = rows[nrow - 1 - y][x] == '#';   // first row at the top
+    return pix;
+}
+
+/*
+ * Test 1: simple bitmaps
+ */
+static void test_simple(void) {
+    printf("\n=== Test 1: Simple Bitmaps ===\n");
+
+    bm_list_t ls;
+    uint8_t pix[64];
+
+    memset(pix, 0, sizeof(pix));
+    TEST_ASSERT(decompose(pix, 8, 8, &ls) == 0, "Empty bitmap has no rectangles");
+    bm_list_free(&ls);
+
+    memset(pix, 1, sizeof(pix));
+    TEST_ASSERT(decompose(pix, 8, 8, &ls) == 1, "Full bitmap is one rectangle");
+    TEST_ASSERT(ls.rect[0].x == 0 && ls.rect[0].y == 0 && ls.rect[0].w == 8 && ls.rect[0].h == 8,
+                "Rectangle covers the bitmap");
+    bm_list_free(&ls);
+
+    for (int k = 0; k < 64; k++) pix[k] = ((k % 8) + (k / 8)) % 2;
+    TEST_ASSERT(decompose(pix, 8, 8, &ls) == 32, "Checkerboard has one rectangle per pixel");
+    TEST_ASSERT(check_cover(pix, 8, 8, &ls), "Checkerboard is covered");
+    bm_list_free(&ls);
+
+    TEST_ASSERT(decompose(pix, 0, 8, &ls) == 0 && decompose(pix, 8, 0, &ls) == 0,
+                "Bitmap without pixels");
+}
+
+/*
+ * Test 2: merging of runs
+ */
+static void test_merge(void) {
+    printf("\n=== Test 2: Merging ===\n");
+
+    static const char* ring[] = {
+        "########",
+        "########",
+        "##....##",
+        "##....##",
+        "########"};
+    static const char* shapes[] = {
+        "#.....#.",
+        "###...#.",
+        "###...##",
+        "......##",
+        "##.#.###"};
+    bm_list_t ls;
+    uint8_t* pix;
+    int ncol;
+
+    pix = parse_bitmap(ring, 5, &ncol);
+    TEST_ASSERT(decompose(pix, ncol, 5, &ls) == 4, "Ring is 4 rectangles");
+    TEST_ASSERT(check_cover(pix, ncol, 5, &ls), "Ring is covered");
+    int top = 0;
+    for (size_t k = 0; k < ls.nrect; k++)
+        top += ls.rect[k].x == 0 && ls.rect[k].y == 3 && ls.rect[k].w == 8 && ls.rect[k].h == 2;
+    TEST_ASSERT(top == 1, "Rows with the same runs are merged");
+    bm_list_free(&ls);
+    free(pix);
+
+    pix = parse_bitmap(shapes, 5, &ncol);
+    TEST_ASSERT(decompose(pix, ncol, 5, &ls) == 7, "Shapes are 7 rectangles");
+    TEST_ASSERT(check_cover(pix, ncol, 5, &ls), "Shapes are covered");
+    bm_list_free(&ls);
+    free(pix);
+}
+
+/*
+ * Test 3: random bitmaps
+ */
+static void test_random(void) {
+    printf("\n=== Test 3: Random Bitmaps ===\n");
+
+    bm_list_t ls;
+    int ok = 1;
+
+    srand(12345);
+    for (int t = 0; t < 200 && ok; t++) {
+        int ncol = 1 + rand() % 40;
+        int nrow = 1 + rand() % 40;
+        int density = rand() % 100;
+        uint8_t* pix = malloc((size_t)ncol * nrow);
+        size_t nrun = 0;
+
+        for (int k = 0; k < ncol * nrow; k++) pix[k] = rand() % 100 < density;
+        for (int k = 0; k < ncol * nrow; k++)
+            nrun += pix[k] && (k % ncol == 0 || !pix[k - 1]);
+
+        ok = decompose(pix, ncol, nrow, &ls) != (size_t)-1 &&
+             check_cover(pix, ncol, nrow, &ls) && ls.nrect <= nrun;
+        bm_list_free(&ls);
+        free(pix);
+    }
+    TEST_ASSERT(ok, "Random bitmaps are covered with at most one rectangle per run");
+}
+
+/*
+ * Test 4: large bitmap with square modules, as in a DataMatrix
+ */
+static void test_large(void) {
+    printf("\n=== Test 4: Large Bitmap ===\n");
+
+    const int n = 4096, m = 16;
+    uint8_t* pix = malloc((size_t)n * n);
+    uint8_t* mod = malloc((size_t)(n / m) * (n / m));
+    struct timespec t0, t1;
+    size_t nblack = 0;
+    bm_list_t ls;
+    char msg[128];
+
+    srand(54321);
+    for (int k = 0; k < (n / m) * (n / m); k++) mod[k] = rand() % 2;
+    for (int y = 0; y < n; y++)
+        for (int x = 0; x < n; x++)
+            nblack += pix[(size_t)y * n + x] = mod[(y / m) * (n / m) + x / m];
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    decompose(pix, n, n, &ls);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    snprintf(msg, sizeof(msg), "%zu black pixels in %zu rectangles (%.1f ms)", nblack, ls.nrect,
+             1e3 * (t1.tv_sec - t0.tv_sec) + 1e-6 * (t1.tv_nsec - t0.tv_nsec));
+    TEST_ASSERT(ls.nrect > 0 && ls.nrect * 100 <= nblack, msg);
+    TEST_ASSERT(check_cover(pix, n, n, &ls), "Large bitmap is covered");
+
+    bm_list_free(&ls);
+    free(mod);
+    free(pix);
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - Bitmap Decomposition Tests ===\n");
+
+    test_simple();
+    test_merge();
+    test_random();
+    test_large();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
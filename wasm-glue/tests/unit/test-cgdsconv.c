@@ -0,0 +1,381 @@
+/*
+ * Test Suite: Compound Library Conversion
+ *
+ * Tests verify that compound GDSII libraries are converted to
+ * standard GDSII (Basic/gdsio/cgdsconv.c): boundaries and paths
+ * with several XY records are split into one element per polygon,
+ * continued XY records of long polygons stay in one element, srefs
+ * with several positions are split into one sref per position, the
+ * element header and property records are repeated for each new
+ * element, and all other records are copied unchanged.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gdsio.h"
+#include "cgdsconv.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define LIB_IN  "/tmp/test-cgdsconv-in.cgds"
+#define LIB_OUT "/tmp/test-cgdsconv-out.gds"
+#define MAXEL   16
+
+// elements found in the output library
+typedef struct {
+    uint16_t kind;
+    int nxy;            // number of XY records
+    int nv;             // number of vertices of all XY records
+    int32_t x0, y0;     // first vertex
+    int nprop;          // number of PROPATTR records
+    int has_angle;      // has ANGLE record
+    uint16_t layer;
+} out_element_t;
+
+static out_element_t oel[MAXEL];
+static int noel;
+static long hdr_len;    // length of the library header in the input
+
+/*
+ * writes an XY record with m vertices starting at (x, y)
+ */
+static void put_xy(FILE* fob, int m, int32_t x, int32_t y, int32_t dx) {
+    int32_t* xy = malloc(2 * m * sizeof(int32_t));
+    int k;
+    for (k = 0; k < m; k++) {
+        xy[2*k] = x + k * dx;
+        xy[2*k+1] = y;
+    }
+    write_record_hdr(fob, XY, 2 * m * sizeof(int32_t));
+    write_int_n(fob, xy, 2 * m);
+    free(xy);
+}
+
+static void put_layer(FILE* fob, uint16_t rtype, uint16_t layer, uint16_t ltype, uint16_t dtype) {
+    write_record_hdr(fob, rtype, 0);
+    write_record_hdr(fob, LAYER, 2);
+    write_word(fob, layer);
+    write_record_hdr(fob, ltype, 2);
+    write_word(fob, dtype);
+}
+
+static void put_property(FILE* fob) {
+    write_record_hdr(fob, PROPATTR, 2);
+    write_word(fob, 7);
+    write_record_hdr(fob, PROPVALUE, 4);
+    write_string(fob, "abcd", 4);
+}
+
+/*
+ * compound library with
+ *  - a boundary with 3 polygons and a property
+ *  - a path with a long polygon (2 continued XY records) and a short one
+ *  - an sref with 3 positions
+ *  - a text element
+ *  - a boundary with one polygon
+ */
+static void make_library(void) {
+    FILE* fob;
+    uint16_t date[12] = {114, 1, 1, 0, 0, 0, 114, 1, 1, 0, 0, 0};
+    int32_t xy[6] = {0, 0, 100, 0, 200, 0};
+
+    fob = fopen(LIB_IN, "wb");
+    write_record_hdr(fob, HEADER, 2);
+    write_word(fob, 7);
+    write_record_hdr(fob, BGNLIB, sizeof(date));
+    write_word_n(fob, date, 12);
+    write_record_hdr(fob, LIBNAME, 4);
+    write_string(fob, "LIB\0", 4);
+    write_record_hdr(fob, UNITS, 16);
+    write_real8(fob, 1e-3);
+    write_real8(fob, 1e-9);
+    hdr_len = ftell(fob);
+
+    write_record_hdr(fob, BGNSTR, sizeof(date));
+    write_word_n(fob, date, 12);
+    write_record_hdr(fob, STRNAME, 4);
+    write_string(fob, "TOP\0", 4);
+
+    // compound boundary
+    put_layer(fob, BOUNDARY, 1, DATATYPE, 0);
+    put_xy(fob, 5, 0, 0, 1);
+    put_xy(fob, 5, 10, 0, 1);
+    put_xy(fob, 5, 20, 0, 1);
+    put_property(fob);
+    write_record_hdr(fob, ENDEL, 0);
+
+    // compound path; the second XY record continues the first
+    put_layer(fob, PATH, 2, DATATYPE, 0);
+    write_record_hdr(fob, WIDTH, 4);
+    write_int(fob, 10);
+    put_xy(fob, 8191, 0, 5, 1);
+    put_xy(fob, 10, 8190, 5, 1);
+    put_xy(fob, 2, 0, 50, 100);
+    write_record_hdr(fob, ENDEL, 0);
+
+    // compound sref
+    write_record_hdr(fob, SREF, 0);
+    write_record_hdr(fob, SNAME, 4);
+    write_string(fob, "SUB\0", 4);
+    write_record_hdr(fob, STRANS, 2);
+    write_word(fob, 0);
+    write_record_hdr(fob, ANGLE, 8);
+    write_real8(fob, 90.0);
+    write_record_hdr(fob, XY, sizeof(xy));
+    write_int_n(fob, xy, 6);
+    write_record_hdr(fob, ENDEL, 0);
+
+    // text
+    put_layer(fob, TEXT, 3, TEXTTYPE, 0);
+    put_xy(fob, 1, 5, 5, 0);
+    write_record_hdr(fob, STRING, 2);
+    write_string(fob, "T", 2);
+    write_record_hdr(fob, ENDEL, 0);
+
+    // simple boundary
+    put_layer(fob, BOUNDARY, 4, DATATYPE, 0);
+    put_xy(fob, 5, 0, 0, 2);
+    write_record_hdr(fob, ENDEL, 0);
+
+    write_record_hdr(fob, ENDSTR, 0);
+
+    write_record_hdr(fob, BGNSTR, sizeof(date));
+    write_word_n(fob, date, 12);
+    write_record_hdr(fob, STRNAME, 4);
+    write_string(fob, "SUB\0", 4);
+    write_record_hdr(fob, ENDSTR, 0);
+
+    write_record_hdr(fob, ENDLIB, 0);
+    fclose(fob);
+}
+
+static uint8_t* read_file(const char* fname, size_t* n) {
+    FILE* fob = fopen(fname, "rb");
+    uint8_t* p;
+    fseek(fob, 0L, SEEK_END);
+    *n = (size_t)ftell(fob);
+    fseek(fob, 0L, SEEK_SET);
+    p = malloc(*n ? *n : 1);
+    if (fread(p, 1, *n, fob) != *n)
+        *n = 0;
+    fclose(fob);
+    return p;
+}
+
+static int32_t get_int(const uint8_t* p) {
+    return (int32_t)(((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]);
+}
+
+/*
+ * collects the elements of a library; returns 0 for a library
+ * without ENDLIB record
+ */
+static int scan_library(const uint8_t* p, size_t n) {
+    size_t pos = 0;
+    uint16_t rlen, rtype;
+    out_element_t* pe = NULL;
+
+    noel = 0;
+    while (pos + 4 <= n) {
+        rlen = (p[pos] << 8) | p[pos+1];
+        rtype = (p[pos+2] << 8) | p[pos+3];
+        if (rlen < 4 || pos + rlen > n)
+            return 0;
+        switch (rtype) {
+            case BOUNDARY: case PATH: case SREF: case AREF: case TEXT: case BOX: case NODE:
+                if (noel == MAXEL)
+                    return 0;
+                pe = &oel[noel++];
+                memset(pe, 0, sizeof(out_element_t));
+                pe->kind = rtype;
+                break;
+            case LAYER:
+                if (pe) pe->layer = (p[pos+4] << 8) | p[pos+5];
+                break;
+            case XY:
+                if (pe) {
+                    if (pe->nxy == 0) {
+                        pe->x0 = get_int(p + pos + 4);
+                        pe->y0 = get_int(p + pos + 8);
+                    }
+                    pe->nxy++;
+                    pe->nv += (rlen - 4) / 8;
+                }
+                break;
+            case PROPATTR:
+                if (pe) pe->nprop++;
+                break;
+            case ANGLE:
+                if (pe) pe->has_angle = 1;
+                break;
+            case ENDEL:
+                pe = NULL;
+                break;
+            case ENDLIB:
+                return 1;
+        }
+        pos += rlen;
+    }
+    return 0;
+}
+
+static const char* convert(const char* in, const char* out, cgds_stats_t* st) {
+    FILE* fin = fopen(in, "rb");
+    FILE* fob = fopen(out, "wb");
+    const char* msg = cgds_convert(fin, fob, st);
+    fclose(fin);
+    fclose(fob);
+    return msg;
+}
+
+/*
+ * Test: splitting of compound elements
+ */
+static void test_convert(void) {
+    cgds_stats_t st;
+    const char* msg;
+    uint8_t *pin, *pout;
+    size_t nin, nout;
+    int k;
+
+    printf("\nTest: Splitting of compound elements\n");
+
+    make_library();
+    msg = convert(LIB_IN, LIB_OUT, &st);
+    TEST_ASSERT(msg == NULL, "Library is converted");
+    TEST_ASSERT(st.nel == 5, "Five elements are read");
+    TEST_ASSERT(st.ncomp == 3, "Three compound elements are found");
+    TEST_ASSERT(st.nsplit == 8, "Eight elements are written for them");
+
+    pin = read_file(LIB_IN, &nin);
+    pout = read_file(LIB_OUT, &nout);
+    TEST_ASSERT(scan_library(pout, nout), "Output ends with ENDLIB");
+    TEST_ASSERT(noel == 10, "Output has ten elements");
+    TEST_ASSERT(nout > (size_t)hdr_len && memcmp(pin, pout, hdr_len) == 0,
+                "Library header is copied unchanged");
+
+    // boundaries
+    for (k = 0; k < 3; k++) {
+        if (oel[k].kind != BOUNDARY || oel[k].nxy != 1 || oel[k].x0 != 10*k ||
+            oel[k].nprop != 1 || oel[k].layer != 1)
+            break;
+    }
+    TEST_ASSERT(k == 3, "Boundary is split into three boundaries with properties");
+
+    // paths
+    TEST_ASSERT(oel[3].kind == PATH && oel[3].nxy == 2 && oel[3].nv == 8201,
+                "Continued XY records stay in one path");
+    TEST_ASSERT(oel[4].kind == PATH && oel[4].nxy == 1 && oel[4].y0 == 50 && oel[4].layer == 2,
+                "Second polygon becomes a separate path");
+
+    // srefs
+    for (k = 0; k < 3; k++) {
+        if (oel[5+k].kind != SREF || oel[5+k].nv != 1 || oel[5+k].x0 != 100*k ||
+            !oel[5+k].has_angle)
+            break;
+    }
+    TEST_ASSERT(k == 3, "Sref is split into three srefs with transformation");
+
+    TEST_ASSERT(oel[8].kind == TEXT && oel[8].layer == 3, "Text is copied");
+    TEST_ASSERT(oel[9].kind == BOUNDARY && oel[9].nv == 5 && oel[9].layer == 4,
+                "Simple boundary is copied");
+
+    // a library without compound elements is copied unchanged
+    free(pin);
+    pin = pout;
+    nin = nout;
+    msg = convert(LIB_OUT, LIB_IN, &st);
+    pout = read_file(LIB_IN, &nout);
+    TEST_ASSERT(msg == NULL && st.ncomp == 0 && st.nel == 10, "Converted library has no compound elements");
+    TEST_ASSERT(nout == nin && memcmp(pin, pout, nin) == 0, "Standard library is copied byte for byte");
+
+    free(pin);
+    free(pout);
+}
+
+/*
+ * Test: invalid libraries
+ */
+static void test_errors(void) {
+    FILE* fob;
+    const char* msg;
+    uint8_t* p;
+    size_t n;
+
+    printf("\nTest: Invalid libraries\n");
+
+    fob = fopen(LIB_IN, "wb");
+    fwrite("not a library file", 1, 18, fob);
+    fclose(fob);
+    msg = convert(LIB_IN, LIB_OUT, NULL);
+    TEST_ASSERT(msg != NULL && strstr(msg, "not a GDSII"), "Other files are rejected");
+
+    // truncated library
+    make_library();
+    p = read_file(LIB_IN, &n);
+    fob = fopen(LIB_IN, "wb");
+    fwrite(p, 1, n - 4, fob);
+    fclose(fob);
+    msg = convert(LIB_IN, LIB_OUT, NULL);
+    TEST_ASSERT(msg != NULL && strstr(msg, "ENDLIB"), "Missing ENDLIB record is reported");
+
+    // library truncated inside the first element
+    fob = fopen(LIB_IN, "wb");
+    fwrite(p, 1, hdr_len + 60, fob);
+    fclose(fob);
+    msg = convert(LIB_IN, LIB_OUT, NULL);
+    TEST_ASSERT(msg != NULL, "Truncated element is reported");
+    free(p);
+
+    // element without ENDEL
+    fob = fopen(LIB_IN, "wb");
+    write_record_hdr(fob, HEADER, 2);
+    write_word(fob, 7);
+    put_layer(fob, BOUNDARY, 1, DATATYPE, 0);
+    put_xy(fob, 5, 0, 0, 1);
+    write_record_hdr(fob, ENDSTR, 0);
+    write_record_hdr(fob, ENDLIB, 0);
+    fclose(fob);
+    msg = convert(LIB_IN, LIB_OUT, NULL);
+    TEST_ASSERT(msg != NULL && strstr(msg, "ENDEL"), "Element without ENDEL is reported");
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Compound Library Conversion Tests\n");
+    printf("========================================\n");
+
+    test_convert();
+    test_errors();
+
+    remove(LIB_IN);
+    remove(LIB_OUT);
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
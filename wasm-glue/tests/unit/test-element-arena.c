@@ -0,0 +1,229 @@
+/*
+ * Test Suite: Structure Arenas
+ *
+ * Tests verify the one-pass element parser (wasm_parse_structure_elements):
+ * elements, polygons, vertices, properties and strings of a structure are
+ * stored in one block, repeated strings are stored once, XY records of
+ * more than MAX_XY_VERTICES vertices are continued, and boxes keep only
+ * their last XY record. Vertices are stored as integers and texts and
+ * references in side tables.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "wasm-element-cache.h"
+#include "mem-file.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+static void put_layer(gds_buffer_t* b, uint16_t layer) {
+    put_header(b, LAYER, 2);
+    put_u16(b, layer);
+}
+
+static void put_text(gds_buffer_t* b, const char* s, int32_t x, int32_t y) {
+    const int32_t xy[] = {x, y};
+    put_header(b, TEXT, 0);
+    put_layer(b, 3);
+    put_header(b, TEXTTYPE, 2);
+    put_u16(b, 7);
+    put_xy(b, xy, 1);
+    put_string(b, STRING, s);
+    put_header(b, ENDEL, 0);
+}
+
+static void put_sref(gds_buffer_t* b, const char* sname, int32_t x) {
+    const int32_t xy[] = {x, 0};
+    put_header(b, SREF, 0);
+    put_string(b, SNAME, sname);
+    put_xy(b, xy, 1);
+    put_header(b, ENDEL, 0);
+}
+
+/*
+ * LEAF is empty. TOP contains two texts with the same string, two
+ * SREFs of LEAF, a boundary with properties whose outline is written
+ * in two XY records, and a box with two XY records.
+ */
+#define LONG_VERTICES (MAX_XY_VERTICES + 100)
+
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t box1[] = {0,0, 1,0, 1,1, 0,1, 0,0};
+    const int32_t box2[] = {0,0, 4,0, 4,2, 0,2, 0,0};
+
+    put_library(&b, "ARENALIB");
+
+    put_structure(&b, "LEAF");
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "TOP");
+
+    put_text(&b, "VDD", 1, 2);
+    put_text(&b, "VDD", 3, 4);
+    put_sref(&b, "LEAF", 0);
+    put_sref(&b, "LEAF", 100);
+
+    // a polygon with the vertices (k, k^2 mod 977) in two records
+    put_header(&b, BOUNDARY, 0);
+    put_layer(&b, 1);
+    put_header(&b, PROPATTR, 2);
+    put_u16(&b, 1);
+    put_string(&b, PROPVALUE, "first");
+    put_header(&b, PROPATTR, 2);
+    put_u16(&b, 2);
+    put_string(&b, PROPVALUE, "VDD");
+    put_header(&b, XY, 8 * MAX_XY_VERTICES);
+    for (int k = 0; k < MAX_XY_VERTICES; k++) {
+        put_i32(&b, k);
+        put_i32(&b, (k * k) % 977);
+    }
+    put_header(&b, XY, 8 * (LONG_VERTICES - MAX_XY_VERTICES + 1));
+    for (int k = MAX_XY_VERTICES - 1; k < LONG_VERTICES; k++) {
+        put_i32(&b, k);
+        put_i32(&b, (k * k) % 977);
+    }
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, BOX, 0);
+    put_layer(&b, 2);
+    put_xy(&b, box1, 5);
+    put_xy(&b, box2, 5);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, ENDSTR, 0);
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * Test 1: strings
+ */
+static void test_strings(wasm_library_cache_t* cache) {
+    printf("\n=== Test 1: Strings ===\n");
+
+    TEST_ASSERT(wasm_get_element_count(cache, 0) == 0, "LEAF has no elements");
+    TEST_ASSERT(wasm_get_element_count(cache, 1) == 6, "Six elements in TOP");
+
+    const char* t0 = wasm_get_element_text(cache, 1, 0);
+    const char* t1 = wasm_get_element_text(cache, 1, 1);
+    TEST_ASSERT(t0 && strcmp(t0, "VDD") == 0, "Text string parsed");
+    TEST_ASSERT(t0 == t1, "Repeated text stored once");
+    TEST_ASSERT(wasm_get_element_text_type(cache, 1, 1) == 7, "Text type parsed");
+
+    const char* s0 = wasm_get_element_reference_name(cache, 1, 2);
+    const char* s1 = wasm_get_element_reference_name(cache, 1, 3);
+    TEST_ASSERT(s0 && strcmp(s0, "LEAF") == 0 && s0 == s1, "Structure names interned");
+    TEST_ASSERT(strcmp(wasm_get_element_text(cache, 1, 4), "") == 0,
+                "Boundary has an empty text");
+}
+
+/*
+ * Test 2: properties and geometry
+ */
+static void test_geometry(wasm_library_cache_t* cache) {
+    printf("\n=== Test 2: Properties and Geometry ===\n");
+
+    TEST_ASSERT(wasm_get_element_property_count(cache, 1, 4) == 2, "Two properties");
+    TEST_ASSERT(wasm_get_element_property_attribute(cache, 1, 4, 1) == 2, "Property attribute");
+    TEST_ASSERT(wasm_get_element_property_value(cache, 1, 4, 1) == wasm_get_element_text(cache, 1, 0),
+                "Property value shares the string pool");
+
+    TEST_ASSERT(wasm_get_element_polygon_count(cache, 1, 4) == 1, "Continued XY record is one polygon");
+    TEST_ASSERT(wasm_get_element_polygon_vertex_count(cache, 1, 4, 0) == LONG_VERTICES,
+                "Continued polygon vertex count");
+    const double* v = wasm_get_element_polygon_vertices(cache, 1, 4, 0);
+    int ok = v != NULL;
+    for (int k = 0; ok && k < LONG_VERTICES; k++) {
+        ok = v[2*k] == k && v[2*k+1] == (k * k) % 977;
+    }
+    TEST_ASSERT(ok, "Continued polygon vertices");
+
+    TEST_ASSERT(wasm_get_element_polygon_count(cache, 1, 5) == 1 &&
+                wasm_get_element_polygon_vertices(cache, 1, 5, 0)[4] == 4.0,
+                "Box keeps the last XY record");
+
+    wasm_structure_cache_t* sc = &cache->structures[1];
+    const uint8_t* a = sc->arena;
+    const int32_t* xy = sc->elements[4].polygons[0].vertices;
+    TEST_ASSERT(a && (const uint8_t*)sc->elements == a &&
+                (const uint8_t*)xy > a && (const uint8_t*)xy < a + sc->arena_size &&
+                (const uint8_t*)wasm_get_element_text(cache, 1, 0) < a + sc->arena_size,
+                "Structure data in one block");
+    TEST_ASSERT(xy[2 * (LONG_VERTICES - 1)] == LONG_VERTICES - 1, "Vertices cached as integers");
+}
+
+/*
+ * Test 3: side tables of texts and references
+ */
+static void test_side_tables(wasm_library_cache_t* cache) {
+    printf("\n=== Test 3: Side Tables ===\n");
+
+    wasm_structure_cache_t* sc = &cache->structures[1];
+    const wasm_cached_element_t* el = sc->elements;
+    const uint8_t* a = sc->arena;
+
+    TEST_ASSERT(el[0].data.text->x == 1 && el[1].data.text->y == 4, "Text positions");
+    TEST_ASSERT(el[1].data.text == el[0].data.text + 1 &&
+                (const uint8_t*)el[0].data.text > a &&
+                (const uint8_t*)el[0].data.text < a + sc->arena_size,
+                "Texts in a side table");
+    TEST_ASSERT(el[3].data.reference == el[2].data.reference + 1 &&
+                el[3].data.reference->x == 100, "References in a side table");
+    TEST_ASSERT(el[3].bounds[0] == 100 && el[3].bounds[2] == 100, "Reference bounds");
+    TEST_ASSERT(wasm_get_element_magnification(cache, 1, 2) == 1.0 &&
+                wasm_get_element_magnification(cache, 1, 4) == 1.0,
+                "References are not magnified");
+    TEST_ASSERT(wasm_get_element_text_type(cache, 1, 0) == 7 &&
+                wasm_get_element_data_type(cache, 1, 0) == 7, "Text type in the data type");
+    TEST_ASSERT(wasm_get_element_reference_name(cache, 1, 0)[0] == '\0' &&
+                wasm_get_element_array_columns(cache, 1, 0) == 0, "Text has no reference");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Structure Arena Tests ===\n");
+
+    size_t size;
+    uint8_t* data = create_test_library(&size);
+    wasm_library_cache_t* cache = wasm_create_library_cache(data, size);
+    TEST_ASSERT(cache != NULL, "Library cache created");
+    if (!cache) return 1;
+    TEST_ASSERT(wasm_parse_library_structures(cache) == 0, "Library structures parsed");
+
+    test_strings(cache);
+    test_geometry(cache);
+    test_side_tables(cache);
+
+    wasm_free_library_cache(cache);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,419 @@
+/*
+ * Test Suite: Element Encoding
+ *
+ * Tests verify that elements are encoded into memory buffers
+ * (Basic/gdsio/elwrite.c) with the same records that the stream
+ * functions in gdsio.c write: boundaries that are closed, long
+ * boundaries and paths in continued XY records, compound elements,
+ * path extensions, sref, aref, text, node and box elements,
+ * properties and strings of odd length, and the range of 8-byte
+ * reals.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gdsio.h"
+#include "elwrite.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define UU_TO_DBU 1000.0
+
+/*
+ * element list with room for a few elements
+ */
+typedef struct {
+    ew_list_t ls;
+    ew_element_t el[8];
+    ew_xy_t xy[8];
+    ew_prop_t prop[8];
+    char str[256];
+} test_list_t;
+
+static void list_init(test_list_t* tl) {
+    memset(tl, 0, sizeof(test_list_t));
+    tl->ls.el = tl->el;     tl->ls.ael = 8;
+    tl->ls.xy = tl->xy;     tl->ls.axy = 8;
+    tl->ls.prop = tl->prop; tl->ls.aprop = 8;
+    tl->ls.str = tl->str;   tl->ls.astr = sizeof(tl->str);
+}
+
+static size_t add_string(test_list_t* tl, const char* s) {
+    size_t off = tl->ls.nstr;
+    strcpy(tl->str + off, s);
+    tl->ls.nstr += strlen(s) + 1;
+    return off;
+}
+
+static ew_element_t* add_element(test_list_t* tl, element_kind kind, const double* xy, size_t m) {
+    ew_element_t* pe = &tl->el[tl->ls.nel++];
+    memset(pe, 0, sizeof(ew_element_t));
+    pe->el.kind = kind;
+    pe->el.layer = 3;
+    pe->el.dtype = 1;
+    pe->xy = tl->ls.nxy;
+    pe->nxy = 1;
+    tl->xy[tl->ls.nxy].xy = xy;
+    tl->xy[tl->ls.nxy++].m = m;
+    return pe;
+}
+
+/*
+ * reference records written with the stream functions
+ */
+static FILE* ref;
+
+static void ref_string(uint16_t rtype, const char* s) {
+    int len = (int)strlen(s);
+    write_record_hdr(ref, rtype, (uint16_t)(len + len % 2));
+    write_string(ref, (char*)s, len);
+    if (len % 2)
+        write_string(ref, "\0", 1);
+}
+
+static void ref_xy(const double* x, const double* y, int m, int close, int cont) {
+    int32_t* v = malloc(2 * (m + 1) * sizeof(int32_t));
+    int k, n;
+    for (k = 0; k < m; k++) {
+        v[2*k] = (int32_t)floor(0.5 + x[k] * UU_TO_DBU);
+        v[2*k+1] = (int32_t)floor(0.5 + y[k] * UU_TO_DBU);
+    }
+    if (close && (v[0] != v[2*m-2] || v[1] != v[2*m-1])) {
+        v[2*m] = v[0];
+        v[2*m+1] = v[1];
+        m++;
+    }
+    k = 0;
+    while (1) {
+        n = m - k > MAX_XY_VERTICES ? MAX_XY_VERTICES : m - k;
+        write_record_hdr(ref, XY, 2*n*sizeof(int32_t));
+        write_int_n(ref, v + 2*k, 2*n);   /* swaps in place; not reused */
+        if (k + n == m)
+            break;
+        k += cont ? n - 1 : n;
+        if (cont) {   /* the shared vertex was swapped */
+            v[2*k] = (int32_t)floor(0.5 + x[k] * UU_TO_DBU);
+            v[2*k+1] = (int32_t)floor(0.5 + y[k] * UU_TO_DBU);
+        }
+    }
+    free(v);
+}
+
+static void ref_word(uint16_t rtype, uint16_t w) {
+    write_record_hdr(ref, rtype, sizeof(uint16_t));
+    write_word(ref, w);
+}
+
+static void ref_int(uint16_t rtype, int32_t i) {
+    write_record_hdr(ref, rtype, sizeof(int32_t));
+    write_int(ref, i);
+}
+
+/*
+ * compares the encoded elements with the reference records
+ */
+static int same_records(const test_list_t* tl, int compound) {
+    ew_buffer_t wb;
+    unsigned char* rb;
+    long n;
+    int same;
+
+    memset(&wb, 0, sizeof(wb));
+    if (encode_elements(&wb, &tl->ls, UU_TO_DBU, compound))
+        return 0;
+
+    n = ftell(ref);
+    rb = malloc(n ? n : 1);
+    rewind(ref);
+    same = fread(rb, 1, n, ref) == (size_t)n && (size_t)n == wb.size &&
+           !memcmp(rb, wb.base, n);
+    if (!same)
+        printf("    encoded %zu bytes, reference %ld bytes\n", wb.size, n);
+
+    free(rb);
+    ew_buffer_free(&wb);
+    fclose(ref);
+    ref = tmpfile();
+    return same;
+}
+
+static void test_boundary(void) {
+    test_list_t tl;
+    ew_element_t* pe;
+    double sq[] = {0, 1, 1, 0,  0, 0, 1, 1};
+    double tri[] = {0, 2, 1, 0,  0, 0, 1.0005, 0};
+    double* big;
+    int k, m = 20000;
+
+    printf("\nTest: Boundaries\n");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_BOUNDARY, sq, 4);
+    pe->el.has = HAS_ELFLAGS | HAS_PLEX;
+    pe->el.elflags = 2;
+    pe->el.plex = 77;
+    write_record_hdr(ref, BOUNDARY, 0);
+    ref_word(ELFLAGS, 2);
+    ref_int(PLEX, 77);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_xy(sq, sq + 4, 4, 1, 1);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Open polygon is closed");
+
+    list_init(&tl);
+    add_element(&tl, GDS_BOUNDARY, tri, 4);
+    write_record_hdr(ref, BOUNDARY, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_xy(tri, tri + 4, 4, 1, 1);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Closed polygon and rounding");
+
+    big = malloc(2 * m * sizeof(double));
+    for (k = 0; k < m; k++) {
+        big[k] = cos(8 * atan(1.0) * k / m);
+        big[k + m] = sin(8 * atan(1.0) * k / m);
+    }
+    list_init(&tl);
+    add_element(&tl, GDS_BOUNDARY, big, m);
+    write_record_hdr(ref, BOUNDARY, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_xy(big, big + m, m, 1, 1);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "20000 vertices in continued XY records");
+    free(big);
+
+    /* two polygons */
+    list_init(&tl);
+    pe = add_element(&tl, GDS_BOUNDARY, sq, 4);
+    tl.xy[tl.ls.nxy].xy = tri;
+    tl.xy[tl.ls.nxy++].m = 4;
+    pe->nxy = 2;
+    for (k = 0; k < 2; k++) {
+        write_record_hdr(ref, BOUNDARY, 0);
+        ref_word(LAYER, 3);
+        ref_word(DATATYPE, 1);
+        ref_xy(k ? tri : sq, k ? tri + 4 : sq + 4, 4, 1, 1);
+        write_record_hdr(ref, ENDEL, 0);
+    }
+    TEST_ASSERT(same_records(&tl, 0), "Two polygons as two boundaries");
+    write_record_hdr(ref, BOUNDARY, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_xy(sq, sq + 4, 4, 1, 1);
+    ref_xy(tri, tri + 4, 4, 1, 1);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 1), "Two polygons as compound boundary");
+}
+
+static void test_path(void) {
+    test_list_t tl;
+    ew_element_t* pe;
+    double p[] = {0, 5, 5,  0, 0, 3};
+
+    printf("\nTest: Paths\n");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_PATH, p, 3);
+    pe->el.has = HAS_PTYPE | HAS_WIDTH | HAS_BGNEXTN | HAS_ENDEXTN;
+    pe->el.ptype = 4;
+    pe->el.width = 0.25f;
+    pe->el.bgnextn = 0.1f;
+    pe->el.endextn = 0.3f;
+    pe->prop = 0;
+    pe->nprop = 1;
+    tl.prop[0].attr = 5;
+    tl.prop[0].value = add_string(&tl, "odd");
+    tl.ls.nprop = 1;
+    write_record_hdr(ref, PATH, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_word(PATHTYPE, 4);
+    ref_int(WIDTH, (int32_t)floor(pe->el.width * UU_TO_DBU + 0.5));
+    ref_int(BGNEXTN, (int32_t)floor(pe->el.bgnextn * UU_TO_DBU + 0.5));
+    ref_int(ENDEXTN, (int32_t)floor(pe->el.endextn * UU_TO_DBU + 0.5));
+    ref_xy(p, p + 3, 3, 0, 1);
+    ref_word(PROPATTR, 5);
+    ref_string(PROPVALUE, "odd");
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Path with extensions and property");
+
+    pe->el.ptype = 2;
+    pe->el.has = HAS_PTYPE;
+    write_record_hdr(ref, PATH, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_word(PATHTYPE, 2);
+    ref_xy(p, p + 3, 3, 0, 1);
+    ref_word(PROPATTR, 5);
+    ref_string(PROPVALUE, "odd");
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Extensions only with path type 4");
+}
+
+static void test_references(void) {
+    test_list_t tl;
+    ew_element_t* pe;
+    double pos[] = {1, 2,  3, 4};
+    double axy[] = {0, 10, 0,  0, 0, 5};
+    int64_t before;
+    int k;
+
+    printf("\nTest: References\n");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_SREF, pos, 2);
+    pe->el.has = HAS_STRANS | HAS_MAG | HAS_ANGLE;
+    pe->el.strans.flags = 0x8000;
+    pe->el.strans.mag = 2.5;
+    pe->el.strans.angle = 90.0;
+    pe->str = add_string(&tl, "CELL");
+    for (k = 0; k < 2; k++) {
+        write_record_hdr(ref, SREF, 0);
+        ref_string(SNAME, "CELL");
+        ref_word(STRANS, 0x8000);
+        write_record_hdr(ref, MAG, 8);
+        write_real8(ref, 2.5);
+        write_record_hdr(ref, ANGLE, 8);
+        write_real8(ref, 90.0);
+        ref_xy(pos + k, pos + k + 2, 1, 0, 0);
+        write_record_hdr(ref, ENDEL, 0);
+    }
+    TEST_ASSERT(same_records(&tl, 0), "Sref with two positions");
+
+    write_record_hdr(ref, SREF, 0);
+    ref_string(SNAME, "CELL");
+    ref_word(STRANS, 0x8000);
+    write_record_hdr(ref, MAG, 8);
+    write_real8(ref, 2.5);
+    write_record_hdr(ref, ANGLE, 8);
+    write_real8(ref, 90.0);
+    ref_xy(pos, pos + 2, 2, 0, 0);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 1), "Compound sref");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_AREF, axy, 3);
+    pe->el.has = HAS_STRANS | HAS_MAG;
+    pe->el.strans.mag = 1.0;     /* not written */
+    pe->el.nrow = 2;
+    pe->el.ncol = 7;
+    pe->str = add_string(&tl, "ARR");
+    write_record_hdr(ref, AREF, 0);
+    ref_string(SNAME, "ARR");
+    ref_word(STRANS, 0);
+    write_record_hdr(ref, COLROW, 4);
+    write_word(ref, 7);
+    write_word(ref, 2);
+    ref_xy(axy, axy + 3, 3, 0, 0);
+    write_record_hdr(ref, ENDEL, 0);
+    before = ftell(ref);
+    TEST_ASSERT(before > 0 && same_records(&tl, 0), "Aref with odd name length");
+
+    TEST_ASSERT(real8_valid(2.5) && real8_valid(-1e-20) && real8_valid(1e70),
+                "Representable 8-byte reals");
+    TEST_ASSERT(!real8_valid(0.0) && !real8_valid(1e80) && !real8_valid(1e-80),
+                "Numbers outside the excess-64 range");
+}
+
+static void test_other(void) {
+    test_list_t tl;
+    ew_element_t* pe;
+    double txy[] = {1.5, 2.5};
+    double nxy[] = {0, 1,  0, 1};
+    double bxy[] = {0, 2, 2, 0,  0, 0, 1, 1};
+
+    printf("\nTest: Text, node and box elements\n");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_TEXT, txy, 1);
+    pe->el.has = HAS_DTYPE | HAS_PRESTN | HAS_WIDTH;
+    pe->el.ttype = 9;
+    pe->el.present = 5;
+    pe->el.width = 12.0f;
+    pe->str = add_string(&tl, "Hello");
+    write_record_hdr(ref, TEXT, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_word(TEXTTYPE, 9);
+    ref_word(PRESENTATION, 5);
+    ref_int(WIDTH, 12);
+    ref_xy(txy, txy + 1, 1, 0, 0);
+    ref_string(STRING, "Hello");
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Text with odd string length");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_NODE, nxy, 2);
+    pe->el.has = HAS_PLEX;
+    pe->el.plex = 3;
+    pe->el.ntype = 4;
+    write_record_hdr(ref, NODE, 0);
+    ref_int(PLEX, 3);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_word(NODETYPE, 4);
+    ref_xy(nxy, nxy + 2, 2, 0, 0);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Node with PLEX record");
+
+    list_init(&tl);
+    pe = add_element(&tl, GDS_BOX, bxy, 4);
+    pe->el.btype = 6;
+    write_record_hdr(ref, BOX, 0);
+    ref_word(LAYER, 3);
+    ref_word(DATATYPE, 1);
+    ref_word(BOXTYPE, 6);
+    ref_xy(bxy, bxy + 4, 4, 1, 0);
+    write_record_hdr(ref, ENDEL, 0);
+    TEST_ASSERT(same_records(&tl, 0), "Box with 4 vertices is closed");
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Element Encoding Tests\n");
+    printf("========================================\n");
+
+    ref = tmpfile();
+    if (ref == NULL) {
+        printf("cannot create temporary file\n");
+        return 1;
+    }
+
+    test_boundary();
+    test_path();
+    test_references();
+    test_other();
+    fclose(ref);
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,366 @@
+/*
+ * Test Suite: Hierarchy Flattening
+ *
+ * Tests verify that structure references are flattened correctly into
+ * per-layer vertex buffers (Basic/gdsio/flatten.c): strans composition
+ * (reflection, rotation, magnification), AREF lattice expansion, window
+ * culling, element kind selection, the windows of referenced
+ * structures and the layer table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "wasm-element-cache.h"
+#include "mem-file.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_EQ(expected, actual, epsilon, message) \
+    do { \
+        tests_run++; \
+        double diff = fabs((expected) - (actual)); \
+        if (diff < (epsilon)) { \
+            tests_passed++; \
+            printf("  ✓ %s (%.2f)\n", message, (double)(actual)); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s - expected %.2f, got %.2f\n", \
+                   message, (double)(expected), (double)(actual)); \
+        } \
+    } while(0)
+
+// GDSII real with an exactly representable excess-64 value
+static void put_real(gds_buffer_t* b, uint16_t type, uint8_t exponent, uint8_t mantissa) {
+    const uint8_t r[8] = {exponent, mantissa, 0, 0, 0, 0, 0, 0};
+    put_header(b, type, 8);
+    put_bytes(b, r, 8);
+}
+
+static void put_boundary(gds_buffer_t* b, uint16_t layer, const int32_t* xy) {
+    put_header(b, BOUNDARY, 0);
+    put_header(b, LAYER, 2);
+    put_u16(b, layer);
+    put_header(b, DATATYPE, 2);
+    put_u16(b, 0);
+    put_xy(b, xy, 5);
+    put_header(b, ENDEL, 0);
+}
+
+/*
+ * LEAF contains a 10 x 5 rectangle on layer 1. TOP references LEAF
+ * with a reflected, rotated and magnified SREF and with a 3 x 2 AREF,
+ * and has a rectangle on layer 2.
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t leaf[] = {0,0, 10,0, 10,5, 0,5, 0,0};
+    const int32_t far[] = {500,500, 510,500, 510,510, 500,510, 500,500};
+    const int32_t sref_xy[] = {100, 0};
+    const int32_t aref_xy[] = {0,0, 60,0, 0,40};
+
+    put_library(&b, "FLATLIB");
+
+    put_structure(&b, "LEAF");
+    put_boundary(&b, 1, leaf);
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "TOP");
+
+    put_header(&b, SREF, 0);
+    put_string(&b, SNAME, "LEAF");
+    put_header(&b, STRANS, 2);
+    put_u16(&b, 0x8000);
+    put_real(&b, MAG, 0x41, 0x20);     // 2.0
+    put_real(&b, ANGLE, 0x42, 0x5A);   // 90.0
+    put_xy(&b, sref_xy, 1);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, AREF, 0);
+    put_string(&b, SNAME, "LEAF");
+    put_header(&b, COLROW, 4);
+    put_u16(&b, 3);
+    put_u16(&b, 2);
+    put_xy(&b, aref_xy, 3);
+    put_header(&b, ENDEL, 0);
+
+    put_boundary(&b, 2, far);
+    put_header(&b, ENDSTR, 0);
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+static int find_layer(const fl_result_t* res, int layer) {
+    for (size_t k = 0; k < res->nlay; k++) {
+        if (res->lay[k].layer == layer) return (int)k;
+    }
+    return -1;
+}
+
+/*
+ * Test 1: references are parsed
+ */
+static void test_reference_parsing(wasm_library_cache_t* cache) {
+    printf("\n=== Test 1: Reference Records ===\n");
+
+    TEST_ASSERT(cache->structure_count == 2, "Two structures found");
+    TEST_ASSERT(wasm_get_element_count(cache, 1) == 3, "Three elements in TOP");
+    TEST_ASSERT(strcmp(wasm_get_element_reference_name(cache, 1, 0), "LEAF") == 0,
+                "SREF structure name parsed");
+    TEST_ASSERT(wasm_get_element_strans_flags(cache, 1, 0) == 0x8000, "SREF reflection parsed");
+    TEST_ASSERT_DOUBLE_EQ(2.0, wasm_get_element_magnification(cache, 1, 0), 1e-12,
+                          "SREF magnification parsed");
+    TEST_ASSERT_DOUBLE_EQ(90.0, wasm_get_element_rotation_angle(cache, 1, 0), 1e-12,
+                          "SREF angle parsed");
+    TEST_ASSERT_DOUBLE_EQ(1.0, wasm_get_element_magnification(cache, 1, 1), 1e-12,
+                          "AREF without MAG is not magnified");
+    TEST_ASSERT(wasm_get_element_array_columns(cache, 1, 1) == 3, "AREF columns parsed");
+    TEST_ASSERT(wasm_get_element_array_rows(cache, 1, 1) == 2, "AREF rows parsed");
+}
+
+/*
+ * Test 2: full flattening
+ */
+static void test_flatten(fl_library_t* flib) {
+    printf("\n=== Test 2: Flattening ===\n");
+
+    fl_options_t opt;
+    fl_result_t res;
+    memset(&opt, 0, sizeof(opt));
+    memset(&res, 0, sizeof(res));
+    opt.max_depth = -1;
+
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "TOP flattened");
+    TEST_ASSERT(res.nlay == 2, "Two output layers");
+    TEST_ASSERT(res.nins == 8, "Eight shape instances");
+    TEST_ASSERT(res.nsref == 1 && res.naref == 1, "One SREF and one AREF expanded");
+
+    int l1 = find_layer(&res, 1);
+    TEST_ASSERT(l1 >= 0 && res.lay[l1].npoly == 7, "Seven polygons on layer 1");
+    if (l1 >= 0 && res.lay[l1].npoly == 7) {
+        const double* xy = res.lay[l1].xy;
+
+        // SREF: (10,5) -> reflect (10,-5) -> rotate (5,10) -> mag (10,20) -> (110,20)
+        TEST_ASSERT_DOUBLE_EQ(110.0, xy[4], 1e-9, "SREF vertex x");
+        TEST_ASSERT_DOUBLE_EQ(20.0, xy[5], 1e-9, "SREF vertex y");
+
+        // last AREF instance (column 2, row 1) starts at (40,20)
+        const double* last = xy + 2 * 5 * 6;
+        TEST_ASSERT_DOUBLE_EQ(40.0, last[0], 1e-9, "AREF lattice x");
+        TEST_ASSERT_DOUBLE_EQ(20.0, last[1], 1e-9, "AREF lattice y");
+    }
+
+    fl_result_free(&res);
+}
+
+/*
+ * Test 3: window and element kinds
+ */
+static void test_window(fl_library_t* flib) {
+    printf("\n=== Test 3: Window and Element Kinds ===\n");
+
+    fl_options_t opt;
+    fl_result_t res;
+    memset(&opt, 0, sizeof(opt));
+    memset(&res, 0, sizeof(res));
+    opt.max_depth = -1;
+    opt.has_window = 1;
+    opt.win[0] = -1.0;  opt.win[1] = -1.0;
+    opt.win[2] = 5.0;   opt.win[3] = 5.0;
+
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "TOP flattened with window");
+    TEST_ASSERT(res.nins == 1, "One shape instance in window");
+    TEST_ASSERT(res.nlay == 1 && res.lay[0].layer == 1, "Only layer 1 in window");
+
+    opt.has_window = 0;
+    opt.kinds = 1u << GDS_BOX;
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "TOP flattened for boxes");
+    TEST_ASSERT(res.nins == 0, "No box elements");
+
+    opt.kinds = 0;
+    opt.max_depth = 0;
+    TEST_ASSERT(fl_flatten(flib, 0, &opt, &res) == FL_OK, "LEAF flattened");
+    TEST_ASSERT(res.nins == 1 && res.depth == 0, "LEAF has one shape");
+
+    fl_result_free(&res);
+}
+
+/*
+ * Test 4: windows of the referenced structures
+ */
+static void test_window_cells(fl_library_t* flib) {
+    printf("\n=== Test 4: Structure Windows ===\n");
+
+    double b[4], lwin[8];
+
+    TEST_ASSERT(fl_ref_bbox(flib, &flib->cell[1].ref[0], b) == FL_OK, "SREF bounding box");
+    TEST_ASSERT(b[0] == 100.0 && b[1] == 0.0 && b[2] == 110.0 && b[3] == 20.0,
+                "SREF bounding box is transformed");
+    TEST_ASSERT(fl_ref_bbox(flib, &flib->cell[1].ref[1], b) == FL_OK, "AREF bounding box");
+    TEST_ASSERT(b[0] == 0.0 && b[1] == 0.0 && b[2] == 50.0 && b[3] == 25.0,
+                "AREF bounding box covers all instances");
+
+    // columns 1 and 2 of row 0 overlap the window
+    const double w1[] = {25.0, -1.0, 45.0, 3.0};
+    TEST_ASSERT(fl_window_cells(flib, 1, w1, lwin) == FL_OK, "Windows of AREF instances");
+    TEST_ASSERT(memcmp(lwin + 4, w1, sizeof(w1)) == 0, "Top structure has the window");
+    TEST_ASSERT(lwin[0] == 0.0 && lwin[1] == 0.0 && lwin[2] == 10.0 && lwin[3] == 3.0,
+                "LEAF window is the union over the AREF instances");
+
+    // (x,y) in LEAF is at (2y+100, 2x) in TOP
+    const double w2[] = {104.0, 4.0, 106.0, 6.0};
+    TEST_ASSERT(fl_window_cells(flib, 1, w2, lwin) == FL_OK, "Window of SREF instance");
+    TEST_ASSERT_DOUBLE_EQ(2.0, lwin[0], 1e-12, "LEAF window llx");
+    TEST_ASSERT_DOUBLE_EQ(2.0, lwin[1], 1e-12, "LEAF window lly");
+    TEST_ASSERT_DOUBLE_EQ(3.0, lwin[2], 1e-12, "LEAF window urx");
+    TEST_ASSERT_DOUBLE_EQ(3.0, lwin[3], 1e-12, "LEAF window ury");
+
+    const double w3[] = {400.0, 400.0, 600.0, 600.0};
+    TEST_ASSERT(fl_window_cells(flib, 1, w3, lwin) == FL_OK, "Window without instances");
+    TEST_ASSERT(lwin[0] > lwin[2], "LEAF window is empty");
+}
+
+/*
+ * Test 5: only the rows and columns of a large array in the window
+ * are expanded
+ */
+static void test_array_window(void) {
+    printf("\n=== Test 5: Large Array in Window ===\n");
+
+    fl_library_t lib;
+    fl_options_t opt;
+    fl_result_t res;
+    element_t e;
+    double x[] = {0.0, 5.0, 5.0, 0.0};
+    double y[] = {0.0, 0.0, 5.0, 5.0};
+    double rxy[] = {0.0, 0.0, 10000.0, 0.0, 0.0, 10000.0};
+    double lwin[8];
+
+    TEST_ASSERT(fl_library_init(&lib, 2) == FL_OK, "Library created");
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_BOUNDARY;
+    e.layer = 1;
+    fl_add_shape(&lib.cell[1], 0, &e);
+    fl_add_vertices(&lib.cell[1], x, y, 4, 1);
+
+    // 1000 x 1000 array with a pitch of 10
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_AREF;
+    e.ncol = 1000;
+    e.nrow = 1000;
+    fl_add_ref(&lib.cell[0], 0, 1, &e, rxy);
+
+    memset(&opt, 0, sizeof(opt));
+    memset(&res, 0, sizeof(res));
+    opt.max_depth = -1;
+    opt.has_window = 1;
+    opt.win[0] = 102.0;  opt.win[1] = 102.0;
+    opt.win[2] = 131.0;  opt.win[3] = 118.0;
+
+    TEST_ASSERT(fl_flatten(&lib, 0, &opt, &res) == FL_OK, "Array flattened with window");
+    TEST_ASSERT(res.nins == 8, "Four columns in two rows are in the window");
+    if (res.nlay == 1 && res.lay[0].npoly == 8) {
+        TEST_ASSERT_DOUBLE_EQ(100.0, res.lay[0].xy[0], 1e-9, "First instance x");
+        TEST_ASSERT_DOUBLE_EQ(100.0, res.lay[0].xy[1], 1e-9, "First instance y");
+        TEST_ASSERT_DOUBLE_EQ(130.0, res.lay[0].xy[2 * 4 * 7], 1e-9, "Last instance x");
+        TEST_ASSERT_DOUBLE_EQ(110.0, res.lay[0].xy[2 * 4 * 7 + 1], 1e-9, "Last instance y");
+    }
+
+    TEST_ASSERT(fl_window_cells(&lib, 0, opt.win, lwin) == FL_OK, "Window of the array cell");
+    TEST_ASSERT(lwin[4] == 0.0 && lwin[5] == 0.0 && lwin[6] == 5.0 && lwin[7] == 5.0,
+                "Array cell window is clipped to its bounding box");
+
+    fl_result_free(&res);
+    fl_library_free(&lib);
+}
+
+/*
+ * Test 6: shapes are mapped with a layer table
+ */
+static void test_layer_table(fl_library_t* flib) {
+    printf("\n=== Test 6: Layer Table ===\n");
+
+    static uint16_t table[FL_TABLE_SIZE];
+    fl_options_t opt;
+    fl_result_t res;
+    memset(&opt, 0, sizeof(opt));
+    memset(&res, 0, sizeof(res));
+    opt.max_depth = -1;
+    opt.table = table;
+
+    table[FL_TABLE_INDEX(2, 0)] = 7;
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "TOP flattened with layer table");
+    TEST_ASSERT(res.nins == 1, "Only the shape on the mapped layer");
+    TEST_ASSERT(res.nlay == 1 && res.lay[0].layer == 2 && res.lay[0].entry == 7,
+                "Output layer has its stack entry");
+
+    table[FL_TABLE_INDEX(1, 0)] = 3;
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "Both layers mapped");
+    TEST_ASSERT(res.nins == 8, "All shapes are mapped");
+    int l1 = find_layer(&res, 1);
+    TEST_ASSERT(l1 >= 0 && res.lay[l1].entry == 3, "Layer 1 has stack entry 3");
+
+    opt.table = NULL;
+    TEST_ASSERT(fl_flatten(flib, 1, &opt, &res) == FL_OK, "Flattened without table");
+    TEST_ASSERT(res.nlay == 2 && res.lay[0].entry == 0, "No stack entries without table");
+
+    fl_result_free(&res);
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Hierarchy Flattening Tests ===\n");
+
+    size_t size;
+    uint8_t* data = create_test_library(&size);
+    wasm_library_cache_t* cache = wasm_create_library_cache(data, size);
+    TEST_ASSERT(cache != NULL, "Library cache created");
+    if (!cache) return 1;
+    TEST_ASSERT(wasm_parse_library_structures(cache) == 0, "Library structures parsed");
+
+    test_reference_parsing(cache);
+
+    fl_library_t flib;
+    TEST_ASSERT(wasm_build_flatten_library(cache, &flib) == 0, "Flattening input built");
+    TEST_ASSERT(flib.cell[1].nref == 2 && flib.cell[1].ref[0].cell == 0,
+                "References resolved by name");
+
+    test_flatten(&flib);
+    test_window(&flib);
+    test_window_cells(&flib);
+    test_array_window();
+    test_layer_table(&flib);
+
+    fl_library_free(&flib);
+    wasm_free_library_cache(cache);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
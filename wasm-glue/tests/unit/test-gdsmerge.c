@@ -0,0 +1,466 @@
+/*
+ * Test Suite: Library Merging
+ *
+ * Tests verify that libraries are merged without decoding the
+ * elements (Basic/gdsio/gdsmerge.c): structures are copied byte
+ * for byte, structures with duplicate names are renamed together
+ * with the references to them, names of odd length are padded,
+ * coordinates are rescaled when the database units differ, and
+ * the new top level structure references the top structures of
+ * all input libraries. The structure index resolves references to
+ * index entries, and a sidecar index is only used when it matches
+ * the library file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gdsio.h"
+#include "mapio.h"
+#include "libindex.h"
+#include "gdsmerge.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define LIB_A   "/tmp/test-gdsmerge-a.gds"
+#define LIB_B   "/tmp/test-gdsmerge-b.gds"
+#define LIB_C   "/tmp/test-gdsmerge-c.gds"
+#define LIB_D   "/tmp/test-gdsmerge-d.gds"
+#define LIB_OUT "/tmp/test-gdsmerge-out.gds"
+#define IDX_D   "/tmp/test-gdsmerge-d.gds.idx"
+
+/*
+ * library writing helpers
+ */
+static void put_name(FILE* fob, uint16_t rtype, const char* name) {
+    int len = (int)strlen(name);
+    write_record_hdr(fob, rtype, len + (len & 1));
+    write_string(fob, (char*)name, len);
+    if (len & 1)
+        fputc('\0', fob);
+}
+
+static FILE* begin_lib(const char* fname, double dbunit) {
+    FILE* fob = fopen(fname, "wb");
+    if (fob == NULL)
+        return NULL;
+    write_record_hdr(fob, HEADER, 2);
+    write_word(fob, 7);
+    write_record_hdr(fob, UNITS, 16);
+    write_real8(fob, 1e-6 / dbunit);
+    write_real8(fob, dbunit);
+    return fob;
+}
+
+static void begin_struct(FILE* fob, const char* sname) {
+    uint16_t date[12] = {114, 1, 1, 0, 0, 0, 114, 1, 1, 0, 0, 0};
+    write_record_hdr(fob, BGNSTR, sizeof(date));
+    write_word_n(fob, date, 12);
+    put_name(fob, STRNAME, sname);
+}
+
+static void put_sref(FILE* fob, const char* sname, int32_t x, int32_t y) {
+    int32_t xy[2];
+    xy[0] = x; xy[1] = y;
+    write_record_hdr(fob, SREF, 0);
+    put_name(fob, SNAME, sname);
+    write_record_hdr(fob, XY, sizeof(xy));
+    write_int_n(fob, xy, 2);
+    write_record_hdr(fob, ENDEL, 0);
+}
+
+static void put_path(FILE* fob, int32_t width, int32_t x0, int32_t x1) {
+    int32_t xy[4];
+    xy[0] = x0; xy[1] = -x0; xy[2] = x1; xy[3] = -x1;
+    write_record_hdr(fob, PATH, 0);
+    write_record_hdr(fob, LAYER, 2);
+    write_word(fob, 1);
+    write_record_hdr(fob, DATATYPE, 2);
+    write_word(fob, 0);
+    write_record_hdr(fob, WIDTH, 4);
+    write_int(fob, width);
+    write_record_hdr(fob, XY, sizeof(xy));
+    write_int_n(fob, xy, 4);
+    write_record_hdr(fob, ENDEL, 0);
+}
+
+static void end_lib(FILE* fob) {
+    write_record_hdr(fob, ENDLIB, 0);
+    fclose(fob);
+}
+
+/*
+ * merges libraries into LIB_OUT and builds the index of the output
+ */
+static const char* merge(const char** fnames, int nfiles, double dbunit,
+                         const char* top, merge_t* mg, lib_index_t* li,
+                         map_file_t* mf) {
+    FILE* fob;
+    const char* msg;
+
+    memset(mg, 0, sizeof(merge_t));
+    mg->dbunit = dbunit;
+    mg->top = top;
+
+    fob = begin_lib(LIB_OUT, dbunit);
+    msg = merge_libraries(fob, fnames, nfiles, mg);
+    end_lib(fob);
+    if (msg)
+        return msg;
+
+    fob = fopen(LIB_OUT, "rb");
+    map_open(mf, fob);
+    fclose(fob);
+    index_build(li, mf);
+
+    return NULL;
+}
+
+static int has_ref(lib_index_t* li, const char* sname, const char* ref) {
+    int k = index_find(li, sname);
+    uint32_t j;
+    if (k < 0)
+        return 0;
+    for (j = 0; j < li->st[k].nref; j++) {
+        if (!strcmp(li->st[k].refs[j], ref))
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ * returns the WIDTH and XY values of the first path in a structure
+ */
+static int first_path(lib_index_t* li, map_file_t* mf, const char* sname,
+                      int32_t* width, int32_t* xy) {
+    uint16_t rtype, rlen;
+    int k = index_find(li, sname);
+    if (k < 0 || map_seek(mf, li->st[k].offset))
+        return 1;
+    while (!map_record_hdr(mf, &rtype, &rlen) && rtype != ENDSTR) {
+        if (rtype == WIDTH)
+            map_int(mf, width);
+        else if (rtype == XY) {
+            map_int_n(mf, xy, 4);
+            return 0;
+        }
+        else
+            map_ignore(mf, rlen);
+    }
+    return 1;
+}
+
+/*
+ * the raw bytes of a structure
+ */
+static uint8_t* struct_bytes(const char* fname, const char* sname, uint64_t* nbytes) {
+    FILE* fob;
+    map_file_t mf;
+    lib_index_t li;
+    uint8_t* p = NULL;
+    int k;
+
+    fob = fopen(fname, "rb");
+    map_open(&mf, fob);
+    fclose(fob);
+    index_build(&li, &mf);
+    k = index_find(&li, sname);
+    if (k >= 0) {
+        *nbytes = li.st[k].nbytes;
+        p = malloc(*nbytes);
+        memcpy(p, mf.base + li.st[k].offset, *nbytes);
+    }
+    index_free(&li);
+    map_close(&mf, NULL);
+    return p;
+}
+
+static void make_libraries(void) {
+    FILE* fob;
+
+    // A: TOP -> SUB
+    fob = begin_lib(LIB_A, 1e-9);
+    begin_struct(fob, "SUB");
+    put_path(fob, 100, 0, 1000);
+    write_record_hdr(fob, ENDSTR, 0);
+    begin_struct(fob, "TOP");
+    put_sref(fob, "SUB", 10, 20);
+    write_record_hdr(fob, ENDSTR, 0);
+    end_lib(fob);
+
+    // B: TOPB -> SUB, SUB_1 (SUB collides, SUB_1 blocks the first new name)
+    fob = begin_lib(LIB_B, 1e-9);
+    begin_struct(fob, "SUB");
+    put_path(fob, 200, 5, 2000);
+    write_record_hdr(fob, ENDSTR, 0);
+    begin_struct(fob, "SUB_1");
+    put_path(fob, 300, 7, 3000);
+    write_record_hdr(fob, ENDSTR, 0);
+    begin_struct(fob, "TOPB");
+    put_sref(fob, "SUB", 0, 0);
+    put_sref(fob, "SUB_1", 0, 0);
+    write_record_hdr(fob, ENDSTR, 0);
+    end_lib(fob);
+
+    // D: TOPD -> SUB (repeated), SUB_1, external EXT
+    fob = begin_lib(LIB_D, 1e-9);
+    begin_struct(fob, "SUB");
+    put_path(fob, 100, 0, 1000);
+    write_record_hdr(fob, ENDSTR, 0);
+    begin_struct(fob, "SUB_1");
+    put_path(fob, 100, 0, 1000);
+    write_record_hdr(fob, ENDSTR, 0);
+    begin_struct(fob, "TOPD");
+    put_sref(fob, "SUB", 0, 0);
+    put_sref(fob, "SUB_1", 0, 0);
+    put_sref(fob, "SUB", 10, 0);
+    put_sref(fob, "EXT", 0, 0);
+    put_sref(fob, "SUB", 20, 0);
+    write_record_hdr(fob, ENDSTR, 0);
+    end_lib(fob);
+
+    // C: database unit 10 nm
+    fob = begin_lib(LIB_C, 1e-8);
+    begin_struct(fob, "CELLC");
+    put_path(fob, -15, -3, 123456);
+    write_record_hdr(fob, ENDSTR, 0);
+    end_lib(fob);
+}
+
+/*
+ * Test: structures with duplicate names are renamed
+ */
+static void test_rename(void) {
+    const char* fnames[2] = {LIB_A, LIB_B};
+    merge_t mg;
+    lib_index_t li;
+    map_file_t mf;
+    const char* msg;
+    uint8_t *pa, *po;
+    uint64_t na, no;
+
+    printf("\nTest: Renaming of duplicate structures\n");
+
+    msg = merge(fnames, 2, 1e-9, "CHIP", &mg, &li, &mf);
+    TEST_ASSERT(msg == NULL, "Libraries are merged");
+    if (msg)
+        return;
+
+    TEST_ASSERT(li.nstruct == 6, "Output contains 6 structures");
+    TEST_ASSERT(mg.nren == 1, "One structure is renamed");
+    TEST_ASSERT(mg.nren == 1 && mg.ren[0].file == 1,
+                "Renamed structure belongs to the second library");
+    TEST_ASSERT(mg.nren == 1 && !strcmp(mg.ren[0].oname, "SUB") &&
+                !strcmp(mg.ren[0].nname, "SUB_2"),
+                "SUB is renamed to SUB_2 because SUB_1 exists");
+    TEST_ASSERT(index_find(&li, "SUB_2") >= 0 && index_find(&li, "SUB_1") >= 0,
+                "Renamed and unique structures are in the output");
+    TEST_ASSERT(has_ref(&li, "TOPB", "SUB_2") && has_ref(&li, "TOPB", "SUB_1"),
+                "References to renamed structures are renamed");
+    TEST_ASSERT(has_ref(&li, "TOP", "SUB"), "References in the first library are unchanged");
+    TEST_ASSERT(has_ref(&li, "CHIP", "TOP") && has_ref(&li, "CHIP", "TOPB") &&
+                li.st[index_find(&li, "CHIP")].nref == 2,
+                "New top structure references the top structures");
+
+    // first library is copied unchanged
+    pa = struct_bytes(LIB_A, "TOP", &na);
+    po = struct_bytes(LIB_OUT, "TOP", &no);
+    TEST_ASSERT(pa && po && na == no && !memcmp(pa, po, na),
+                "Structures without changes are copied byte for byte");
+    free(pa);
+    free(po);
+
+    // padding of renamed structures
+    TEST_ASSERT(li.st[index_find(&li, "SUB_2")].nbytes == li.st[index_find(&li, "SUB")].nbytes + 2,
+                "Names of odd length are padded");
+
+    index_free(&li);
+    map_close(&mf, NULL);
+    merge_free(&mg);
+
+    // top structure name collides with an input structure
+    fnames[0] = LIB_A;
+    msg = merge(fnames, 1, 1e-9, "TOP", &mg, &li, &mf);
+    TEST_ASSERT(msg == NULL && mg.nren == 1 && !strcmp(mg.ren[0].nname, "TOP_1"),
+                "Input structure with the name of the new top is renamed");
+    if (msg == NULL) {
+        TEST_ASSERT(has_ref(&li, "TOP", "TOP_1"), "New top references renamed structure");
+        index_free(&li);
+        map_close(&mf, NULL);
+    }
+    merge_free(&mg);
+}
+
+/*
+ * Test: coordinates are rescaled when the database units differ
+ */
+static void test_units(void) {
+    const char* fnames[2] = {LIB_A, LIB_C};
+    merge_t mg;
+    lib_index_t li;
+    map_file_t mf;
+    const char* msg;
+    int32_t width = 0, xy[4] = {0, 0, 0, 0};
+
+    printf("\nTest: Rescaling of coordinates\n");
+
+    msg = merge(fnames, 2, 1e-9, NULL, &mg, &li, &mf);
+    TEST_ASSERT(msg == NULL, "Libraries with different units are merged");
+    if (msg)
+        return;
+    TEST_ASSERT(li.nstruct == 3, "No top structure is written without a name");
+
+    first_path(&li, &mf, "CELLC", &width, xy);
+    TEST_ASSERT(width == -150, "Width is rescaled");
+    TEST_ASSERT(xy[0] == -30 && xy[1] == 30 && xy[2] == 1234560 && xy[3] == -1234560,
+                "XY coordinates are rescaled");
+    first_path(&li, &mf, "SUB", &width, xy);
+    TEST_ASSERT(width == 100 && xy[2] == 1000, "Library with output units is not rescaled");
+
+    index_free(&li);
+    map_close(&mf, NULL);
+    merge_free(&mg);
+
+    // coarser output grid: values are rounded
+    fnames[0] = LIB_C;
+    msg = merge(fnames, 1, 1e-7, NULL, &mg, &li, &mf);
+    TEST_ASSERT(msg == NULL, "Library is merged to a coarser grid");
+    if (msg == NULL) {
+        first_path(&li, &mf, "CELLC", &width, xy);
+        TEST_ASSERT(width == -1 && xy[0] == 0 && xy[2] == 12346, "Coordinates are rounded");
+        index_free(&li);
+        map_close(&mf, NULL);
+    }
+    merge_free(&mg);
+
+    // overflow
+    msg = merge(fnames, 1, 1e-13, NULL, &mg, &li, &mf);
+    TEST_ASSERT(msg != NULL && strstr(msg, "out of range"),
+                "Coordinate overflow is reported");
+    merge_free(&mg);
+}
+
+/*
+ * Test: error handling
+ */
+static void test_errors(void) {
+    const char* fnames[2] = {LIB_A, "/tmp/test-gdsmerge-missing.gds"};
+    merge_t mg;
+    lib_index_t li;
+    map_file_t mf;
+    const char* msg;
+
+    printf("\nTest: Error handling\n");
+
+    msg = merge(fnames, 2, 1e-9, NULL, &mg, &li, &mf);
+    TEST_ASSERT(msg != NULL, "Missing input file is reported");
+    TEST_ASSERT(mg.nren == 0, "Nothing is renamed after an error");
+    merge_free(&mg);
+
+    fnames[1] = LIB_A;
+    msg = merge(fnames, 2, 1e-9, NULL, &mg, &li, &mf);
+    TEST_ASSERT(msg == NULL && mg.nren == 2, "Library merged with itself is renamed");
+    if (msg == NULL) {
+        TEST_ASSERT(has_ref(&li, "TOP_1", "SUB_1"), "References of the copy are renamed");
+        index_free(&li);
+        map_close(&mf, NULL);
+    }
+    merge_free(&mg);
+}
+
+/*
+ * Test: structure index and sidecar file
+ */
+static void test_index(void) {
+    FILE* fob;
+    map_file_t mf;
+    lib_index_t li, ls;
+    uint64_t fsize;
+    int64_t mtime;
+    int k;
+
+    printf("\nTest: Structure index\n");
+
+    fob = fopen(LIB_D, "rb");
+    map_open(&mf, fob);
+    TEST_ASSERT(index_build(&li, &mf) == A_OK && li.nstruct == 3, "Index is built");
+    map_close(&mf, NULL);
+
+    k = index_find(&li, "TOPD");
+    TEST_ASSERT(k == 2 && li.st[k].nref == 3, "Repeated references are recorded once");
+    TEST_ASSERT(k == 2 && li.st[k].rsi[0] == index_find(&li, "SUB") &&
+                li.st[k].rsi[1] == index_find(&li, "SUB_1"),
+                "References are resolved to index entries");
+    TEST_ASSERT(k == 2 && li.st[k].rsi[2] == -1 && index_find(&li, "EXT") == -1,
+                "External references are not resolved");
+
+    // sidecar file
+    TEST_ASSERT(index_stat(LIB_D, &fsize, &mtime) == A_OK && fsize == li.fsize,
+                "Library size and time stamp are returned");
+    li.mtime = mtime;
+    TEST_ASSERT(index_save(&li, IDX_D) == A_OK, "Index is saved");
+    TEST_ASSERT(index_load(&ls, IDX_D, fsize, mtime) == A_OK && ls.nstruct == 3 &&
+                ls.st[2].rsi[0] == 0 && index_find(&ls, "SUB_1") == 1,
+                "Index is loaded and references are resolved");
+    TEST_ASSERT(index_verify(&ls, fob) == A_OK, "Loaded index matches the library");
+    fclose(fob);
+
+    // a library with other structures at the same positions
+    fob = fopen(LIB_A, "rb");
+    TEST_ASSERT(index_verify(&ls, fob) != A_OK, "Index of another library is rejected");
+    fclose(fob);
+    index_free(&ls);
+
+    TEST_ASSERT(index_load(&ls, IDX_D, fsize, mtime + 1) != A_OK,
+                "Index with a different time stamp is rejected");
+    TEST_ASSERT(index_load(&ls, IDX_D, fsize + 2, mtime) != A_OK,
+                "Index with a different library size is rejected");
+
+    index_free(&li);
+    remove(IDX_D);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Library Merging Tests\n");
+    printf("========================================\n");
+
+    make_libraries();
+    test_rename();
+    test_units();
+    test_errors();
+    test_index();
+
+    remove(LIB_A);
+    remove(LIB_B);
+    remove(LIB_C);
+    remove(LIB_D);
+    remove(LIB_OUT);
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,378 @@
+/*
+ * Test Suite: Compressed Library Streams
+ *
+ * Tests verify the compressed stdio streams of stream_open
+ * (Basic/gdsio/gdsstream.c): data written to gzip and zstd streams
+ * must be read back unchanged, the writers must finish the
+ * compressed file when the stream is closed, and seeks in streams
+ * opened for reading must land on the right byte when they move
+ * into the preceding decompressed block, when they require
+ * decompression to restart at the beginning of the file, and when
+ * reads cross block boundaries. The window in which mapio.c keeps
+ * the data of a compressed stream must stay bounded while it is
+ * refilled, and progress must be measurable on the compressed file.
+ * The zstd tests are compiled only when the test is built with
+ * HAVE_ZSTD.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#if defined HAVE_ZSTD
+   #include <zstd.h>
+#endif
+
+#include "gdsstream.h"
+#include "mapio.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define GZ_FILE  "/tmp/test-gdsstream.gds.gz"
+#define ZST_FILE "/tmp/test-gdsstream.gds.zst"
+#define PLAIN_FILE "/tmp/test-gdsstream.gds"
+
+#define BLKSIZE  262144                // decompressed block size in gdsstream.c
+#define NDATA    (3*BLKSIZE + 1234)    // data spans four blocks
+#define NLARGE   (48*BLKSIZE)          // for multi-threaded zstd compression
+
+/*
+ * the test data; byte k depends on the position so that a read at
+ * a wrong position is detected
+ */
+static uint8_t data_byte(size_t k) {
+    return (uint8_t)((k * 7) ^ (k >> 11));
+}
+
+static uint8_t* make_data(size_t n) {
+    uint8_t* p = malloc(n);
+    size_t k;
+    if (p == NULL)
+        return NULL;
+    for (k = 0; k < n; k++)
+        p[k] = data_byte(k);
+    return p;
+}
+
+/*
+ * writes n bytes through a stream in chunks of irregular size
+ */
+static int write_stream(const char* fname, const uint8_t* data, size_t n, stream_kind* kind) {
+    FILE* fob;
+    size_t k = 0, m;
+    int err = 0;
+
+    fob = stream_open(fname, "wb", kind);
+    if (fob == NULL)
+        return 1;
+    while (k < n && !err) {
+        m = 1000 + (k % 7919);
+        if (m > n - k)
+            m = n - k;
+        err = fwrite(data + k, 1, m, fob) != m;
+        k += m;
+    }
+    return fclose(fob) || err;
+}
+
+/*
+ * returns the whole content of a file
+ */
+static uint8_t* file_bytes(const char* fname, size_t* n) {
+    FILE* fob;
+    uint8_t* p;
+    long len;
+
+    fob = fopen(fname, "rb");
+    if (fob == NULL)
+        return NULL;
+    fseek(fob, 0L, SEEK_END);
+    len = ftell(fob);
+    fseek(fob, 0L, SEEK_SET);
+    p = malloc(len > 0 ? len : 1);
+    if (p != NULL && fread(p, 1, len, fob) != (size_t)len) {
+        free(p);
+        p = NULL;
+    }
+    fclose(fob);
+    *n = (size_t)len;
+    return p;
+}
+
+/*
+ * reads n bytes at position pos and compares them with the test data
+ */
+static int read_at(FILE* fob, long pos, size_t n) {
+    uint8_t* buf;
+    size_t k;
+    int ok;
+
+    if (fseek(fob, pos, SEEK_SET) < 0 || ftell(fob) != pos)
+        return 0;
+    buf = malloc(n);
+    ok = buf != NULL && fread(buf, 1, n, fob) == n;
+    for (k = 0; ok && k < n; k++)
+        ok = buf[k] == data_byte(pos + k);
+    free(buf);
+    return ok;
+}
+
+/*
+ * round trip and seeks in a compressed stream
+ */
+static void check_stream(const char* fname, stream_kind expect, const char* name) {
+    FILE* fob;
+    stream_kind kind;
+    uint8_t *data, *buf;
+    size_t n;
+    char msg[128];
+
+    data = make_data(NDATA);
+    buf = malloc(NDATA + 16);
+
+    sprintf(msg, "%s stream is written", name);
+    TEST_ASSERT(write_stream(fname, data, NDATA, &kind) == 0 && kind == expect, msg);
+
+    // round trip
+    fob = stream_open(fname, "rb", &kind);
+    sprintf(msg, "%s compression is detected when reading", name);
+    TEST_ASSERT(fob != NULL && kind == expect, msg);
+    if (fob == NULL) {
+        free(data);
+        free(buf);
+        return;
+    }
+    n = fread(buf, 1, NDATA + 16, fob);
+    sprintf(msg, "%s stream is read back unchanged", name);
+    TEST_ASSERT(n == NDATA && !memcmp(buf, data, NDATA), msg);
+    TEST_ASSERT(feof(fob) && ftell(fob) == NDATA, "Stream ends after the data");
+
+    // from the end of the file into the last and the preceding block
+    sprintf(msg, "%s: backward seek within the current block", name);
+    TEST_ASSERT(read_at(fob, 3*BLKSIZE + 100, 500), msg);
+    sprintf(msg, "%s: backward seek into the preceding block", name);
+    TEST_ASSERT(read_at(fob, 2*BLKSIZE + 17, 1000), msg);
+    sprintf(msg, "%s: forward seek into the block that was decompressed", name);
+    TEST_ASSERT(read_at(fob, 3*BLKSIZE + 1000, 234), msg);
+
+    // further back than the preceding block
+    sprintf(msg, "%s: backward seek restarts at the beginning of the file", name);
+    TEST_ASSERT(read_at(fob, 11, 100), msg);
+
+    // reads across block boundaries
+    sprintf(msg, "%s: read across a block boundary", name);
+    TEST_ASSERT(read_at(fob, BLKSIZE - 50, 100), msg);
+    sprintf(msg, "%s: read spanning three blocks", name);
+    TEST_ASSERT(read_at(fob, BLKSIZE - 3, BLKSIZE + 6), msg);
+
+    // relative and invalid seeks
+    sprintf(msg, "%s: relative seek", name);
+    TEST_ASSERT(fseek(fob, 100, SEEK_CUR) == 0 && ftell(fob) == 2*BLKSIZE + 103, msg);
+    sprintf(msg, "%s: seek from the end is rejected", name);
+    TEST_ASSERT(fseek(fob, -10, SEEK_END) != 0, msg);
+    sprintf(msg, "%s: seek beyond the end is rejected", name);
+    TEST_ASSERT(fseek(fob, NDATA + 1000, SEEK_SET) != 0, msg);
+    fclose(fob);
+
+    // writers cannot be repositioned
+    fob = stream_open(fname, "wb", &kind);
+    TEST_ASSERT(fob != NULL && fwrite(data, 1, 1000, fob) == 1000 && ftell(fob) == 1000,
+                "Position of a writer is the number of bytes written");
+    if (fob != NULL) {
+        sprintf(msg, "%s: writer cannot seek backward", name);
+        TEST_ASSERT(fseek(fob, 10, SEEK_SET) != 0, msg);
+        fclose(fob);
+    }
+
+    free(data);
+    free(buf);
+}
+
+/*
+ * reads a compressed stream through the window of mapio.c (built
+ * with a small MAP_WINDOW)
+ */
+static void check_window(const char* fname, const char* name) {
+    FILE* fob;
+    map_file_t mf;
+    stream_kind kind;
+    struct stat st;
+    uint8_t* p;
+    size_t pos, n;
+    off_t coff = 0;
+    int ok = 1, bounded = 1, grows = 1, fd;
+    char msg[128];
+
+    fob = stream_open(fname, "rb", &kind);
+    fd = stream_fileno();
+    sprintf(msg, "%s: descriptor of the compressed file is known", name);
+    TEST_ASSERT(fob != NULL && fd >= 0 && fstat(fd, &st) == 0, msg);
+    if (fob == NULL)
+        return;
+
+    sprintf(msg, "%s: window is opened at the stream position", name);
+    TEST_ASSERT(fseek(fob, 100, SEEK_SET) == 0 && map_open(&mf, fob) == A_OK &&
+                map_tell(&mf) == 100 && mf.fob == fob, msg);
+
+    // sequential reads refill the window
+    for (pos = 100; pos < NDATA && ok; pos += n) {
+        n = 1 + pos % 997;
+        if (n > NDATA - pos)
+            n = NDATA - pos;
+        p = map_data(&mf, n);
+        ok = p != NULL && p[0] == data_byte(pos) && p[n-1] == data_byte(pos + n - 1);
+        bounded = bounded && mf.alloc == MAP_WINDOW;
+        if (fd >= 0) {
+            grows = grows && lseek(fd, 0, SEEK_CUR) >= coff;
+            coff = lseek(fd, 0, SEEK_CUR);
+        }
+    }
+    sprintf(msg, "%s: sequential reads through the window", name);
+    TEST_ASSERT(ok && map_tell(&mf) == NDATA && map_data(&mf, 1) == NULL, msg);
+    sprintf(msg, "%s: window is not larger than MAP_WINDOW", name);
+    TEST_ASSERT(bounded, msg);
+    sprintf(msg, "%s: offset in the compressed file grows to its size", name);
+    TEST_ASSERT(grows && coff == st.st_size, msg);
+
+    // seeks out of the window and requests larger than the window
+    sprintf(msg, "%s: backward seek out of the window", name);
+    TEST_ASSERT(map_seek(&mf, 200) == A_OK && (p = map_data(&mf, 10)) != NULL &&
+                p[0] == data_byte(200) && p[9] == data_byte(209), msg);
+    sprintf(msg, "%s: window grows for data larger than the window", name);
+    TEST_ASSERT(map_seek(&mf, BLKSIZE) == A_OK && (p = map_peek(&mf, 3*MAP_WINDOW)) != NULL &&
+                p[0] == data_byte(BLKSIZE) && p[3*MAP_WINDOW-1] == data_byte(BLKSIZE + 3*MAP_WINDOW - 1) &&
+                map_tell(&mf) == BLKSIZE && mf.alloc >= 3*MAP_WINDOW, msg);
+    sprintf(msg, "%s: seek to the end of the data", name);
+    TEST_ASSERT(map_seek(&mf, NDATA) == A_OK && map_data(&mf, 1) == NULL, msg);
+
+    // the stream is positioned at the read position when closing
+    map_seek(&mf, 5000);
+    sprintf(msg, "%s: stream position is set when the window is closed", name);
+    TEST_ASSERT(map_close(&mf, fob) == A_OK && ftell(fob) == 5000, msg);
+    fclose(fob);
+}
+
+/*
+ * Test: gzip streams
+ */
+static void test_gzip(void) {
+    FILE* fob;
+    stream_kind kind;
+    uint8_t* p;
+    size_t n;
+    uint32_t isize;
+
+    printf("\nTest: gzip streams\n");
+    check_stream(GZ_FILE, STREAM_GZIP, "gzip");
+
+    // the gzip trailer is written when the stream is closed
+    p = make_data(NDATA);
+    write_stream(GZ_FILE, p, NDATA, &kind);
+    free(p);
+    p = file_bytes(GZ_FILE, &n);
+    isize = p && n > 18 ? (uint32_t)p[n-4] | (uint32_t)p[n-3] << 8 |
+                          (uint32_t)p[n-2] << 16 | (uint32_t)p[n-1] << 24 : 0;
+    TEST_ASSERT(isize == NDATA, "gzip trailer with the data size is written on closing");
+    free(p);
+
+    check_window(GZ_FILE, "gzip");
+
+    remove(GZ_FILE);
+
+    // uncompressed files have no compressed descriptor
+    fob = stream_open(PLAIN_FILE, "wb", &kind);
+    TEST_ASSERT(fob != NULL && kind == STREAM_PLAIN && stream_fileno() < 0,
+                "No compressed descriptor for an uncompressed file");
+    if (fob)
+        fclose(fob);
+    remove(PLAIN_FILE);
+}
+
+#if defined HAVE_ZSTD
+
+/*
+ * Test: zstd streams
+ */
+static void test_zstd(void) {
+    FILE* fob;
+    stream_kind kind;
+    uint8_t *p, *data, *buf;
+    size_t n;
+
+    printf("\nTest: zstd streams\n");
+    check_stream(ZST_FILE, STREAM_ZSTD, "zstd");
+
+    // the end of the frame is flushed when the stream is closed
+    p = file_bytes(ZST_FILE, &n);
+    TEST_ASSERT(p && ZSTD_findFrameCompressedSize(p, n) == n,
+                "zstd file is a single complete frame");
+    TEST_ASSERT(p && ZSTD_findFrameCompressedSize(p, n - 1) != n - 1 &&
+                ZSTD_isError(ZSTD_findFrameCompressedSize(p, n - 1)),
+                "Truncated zstd frame is detected");
+    free(p);
+
+    // large data are compressed by the worker threads
+    data = make_data(NLARGE);
+    TEST_ASSERT(write_stream(ZST_FILE, data, NLARGE, &kind) == 0,
+                "Large zstd stream is written with worker threads");
+    p = file_bytes(ZST_FILE, &n);
+    TEST_ASSERT(p && n < NLARGE && ZSTD_findFrameCompressedSize(p, n) == n,
+                "Large zstd stream is a complete frame");
+    free(p);
+    buf = malloc(NLARGE);
+    fob = stream_open(ZST_FILE, "rb", &kind);
+    TEST_ASSERT(fob && buf && fread(buf, 1, NLARGE, fob) == NLARGE && !memcmp(buf, data, NLARGE),
+                "Large zstd stream is read back unchanged");
+    if (fob)
+        fclose(fob);
+    free(buf);
+    free(data);
+
+    write_stream(ZST_FILE, p = make_data(NDATA), NDATA, &kind);
+    free(p);
+    check_window(ZST_FILE, "zstd");
+
+    remove(ZST_FILE);
+}
+
+#endif
+
+int main(void) {
+    printf("========================================\n");
+    printf("Compressed Stream Tests\n");
+    printf("========================================\n");
+
+    test_gzip();
+#if defined HAVE_ZSTD
+    test_zstd();
+#else
+    printf("\nzstd streams are not tested (built without HAVE_ZSTD)\n");
+#endif
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+/*
+ * Test Suite: Bulk Geometry Export
+ *
+ * Tests verify that gds_get_structure_geometry packs the geometry of a
+ * structure into one struct-of-arrays buffer (kinds, layers, data types,
+ * polygon and vertex offsets, float32 vertices and bounding boxes), with
+ * paths as center lines or as outline polygons.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gds-wasm-adapter.h"
+#include "wasm-element-cache.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_EQ(expected, actual, epsilon, message) \
+    do { \
+        tests_run++; \
+        double diff = fabs((expected) - (actual)); \
+        if (diff < (epsilon)) { \
+            tests_passed++; \
+            printf("  ✓ %s (%.2f)\n", message, (double)(actual)); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s - expected %.2f, got %.2f\n", \
+                   message, (double)(expected), (double)(actual)); \
+        } \
+    } while(0)
+
+/*
+ * TOP contains a 10 x 5 rectangle on layer 1 / data type 3, a path of
+ * width 2 and type 2 on layer 2, and a text on layer 5.
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t rect[] = {0,0, 10,0, 10,5, 0,5, 0,0};
+    const int32_t path[] = {20,0, 30,0};
+    const int32_t text[] = {7, 8};
+
+    put_library(&b, "GEOMLIB");
+
+    put_structure(&b, "TOP");
+
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 3);
+    put_xy(&b, rect, 5);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, PATH, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 2);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_header(&b, PATHTYPE, 2);
+    put_u16(&b, 2);
+    put_header(&b, WIDTH, 4);
+    put_i32(&b, 2);
+    put_xy(&b, path, 2);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, TEXT, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 5);
+    put_header(&b, TEXTTYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, text, 1);
+    put_string(&b, STRING, "A");
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, ENDSTR, 0);
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * signed area of a closed polygon with packed float32 vertices
+ */
+static double polygon_area(const float* xy, int n) {
+    double a = 0.0;
+    for (int k = 0; k + 1 < n; k++) {
+        a += (double)xy[2*k] * xy[2*k+3] - (double)xy[2*k+2] * xy[2*k+1];
+    }
+    return 0.5 * a;
+}
+
+/*
+ * Test 1: path records are parsed
+ */
+static void test_path_records(void* lib) {
+    printf("\n=== Test 1: Path Records ===\n");
+
+    TEST_ASSERT(gds_get_element_count(lib, 0) == 3, "Three elements in TOP");
+    TEST_ASSERT(gds_get_element_path_type(lib, 0, 1) == 2, "Path type parsed");
+    TEST_ASSERT_DOUBLE_EQ(2.0, gds_get_element_path_width(lib, 0, 1), 1e-12, "Path width parsed");
+}
+
+/*
+ * Test 2: packed center lines
+ */
+static void test_center_lines(void* lib) {
+    printf("\n=== Test 2: Packed Geometry ===\n");
+
+    int words = gds_get_structure_geometry(lib, 0, 0);
+    const int32_t* g = gds_get_structure_geometry_buffer(lib);
+    TEST_ASSERT(words > GDS_GEOM_HEADER_WORDS && g != NULL, "Geometry buffer filled");
+    if (words <= 0 || !g) return;
+
+    TEST_ASSERT(g[GDS_GEOM_ELEMENT_COUNT] == 3 && g[GDS_GEOM_POLYGON_COUNT] == 2 &&
+                g[GDS_GEOM_VERTEX_COUNT] == 7, "Element, polygon and vertex counts");
+    TEST_ASSERT(g[GDS_GEOM_BBOXES] + 4 * 3 == words, "Bounding boxes end the buffer");
+
+    const int32_t* kinds = g + g[GDS_GEOM_KINDS];
+    const int32_t* layers = g + g[GDS_GEOM_LAYERS];
+    const int32_t* dtypes = g + g[GDS_GEOM_DTYPES];
+    TEST_ASSERT(kinds[0] == GDS_BOUNDARY && kinds[1] == GDS_PATH && kinds[2] == GDS_TEXT,
+                "Element kinds");
+    TEST_ASSERT(layers[0] == 1 && layers[1] == 2 && layers[2] == 5, "Element layers");
+    TEST_ASSERT(dtypes[0] == 3 && dtypes[1] == 0, "Element data types");
+
+    const int32_t* epoly = g + g[GDS_GEOM_ELEMENT_POLYGONS];
+    const int32_t* pvert = g + g[GDS_GEOM_POLYGON_VERTICES];
+    TEST_ASSERT(epoly[0] == 0 && epoly[1] == 1 && epoly[2] == 2 && epoly[3] == 2,
+                "Text element has no polygons");
+    TEST_ASSERT(pvert[0] == 0 && pvert[1] == 5 && pvert[2] == 7, "Polygon vertex offsets");
+
+    const float* vert = (const float*)(g + g[GDS_GEOM_VERTICES]);
+    TEST_ASSERT_DOUBLE_EQ(50.0, polygon_area(vert, 5), 1e-9, "Rectangle area");
+    TEST_ASSERT(vert[10] == 20.0f && vert[12] == 30.0f, "Path center line");
+
+    const float* bbox = (const float*)(g + g[GDS_GEOM_BBOXES]);
+    TEST_ASSERT(bbox[0] == 0.0f && bbox[1] == 0.0f && bbox[2] == 10.0f && bbox[3] == 5.0f,
+                "Rectangle bounding box");
+    TEST_ASSERT(bbox[8] == 7.0f && bbox[9] == 8.0f, "Text bounding box");
+}
+
+/*
+ * Test 3: paths as outline polygons
+ */
+static void test_outlines(void* lib) {
+    printf("\n=== Test 3: Path Outlines ===\n");
+
+    int words = gds_get_structure_geometry(lib, 0, 1);
+    const int32_t* g = gds_get_structure_geometry_buffer(lib);
+    TEST_ASSERT(words > GDS_GEOM_HEADER_WORDS && g != NULL, "Geometry buffer filled");
+    if (words <= 0 || !g) return;
+
+    const int32_t* pvert = g + g[GDS_GEOM_POLYGON_VERTICES];
+    TEST_ASSERT(g[GDS_GEOM_VERTEX_COUNT] == 10 && pvert[2] == 10, "Path outline has 5 vertices");
+
+    const float* vert = (const float*)(g + g[GDS_GEOM_VERTICES]);
+    TEST_ASSERT_DOUBLE_EQ(24.0, polygon_area(vert + 2 * pvert[1], 5), 1e-9,
+                          "Extended path outline area");
+
+    TEST_ASSERT(gds_get_structure_geometry(lib, 1, 0) == -1, "Invalid structure rejected");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Bulk Geometry Export Tests ===\n");
+
+    size_t size;
+    int err;
+    uint8_t* data = create_test_library(&size);
+    void* lib = gds_parse_from_memory(data, size, &err);
+    TEST_ASSERT(lib != NULL && err == 0, "Library parsed");
+    if (!lib) return 1;
+
+    test_path_records(lib);
+    test_center_lines(lib);
+    test_outlines(lib);
+
+    gds_free_library(lib);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
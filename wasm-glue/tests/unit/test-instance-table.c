@@ -0,0 +1,158 @@
+/*
+ * Test Suite: Instance Table
+ *
+ * Tests verify that gds_get_instance_table packs the references of all
+ * structures into one buffer with the referenced structure, the element
+ * index, the 2 x 3 transform and the symbolic lattice of each instance.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gds-wasm-adapter.h"
+#include "wasm-element-cache.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * CELL holds a 4 x 2 rectangle. TOP places CELL reflected and rotated
+ * by 90 degrees at (100, 50), a 3 x 2 array of CELL with a pitch of
+ * (20, 10) at (0, 0), and a structure that does not exist.
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t rect[] = {0,0, 4,0, 4,2, 0,2, 0,0};
+    const int32_t sref[] = {100, 50};
+    const int32_t aref[] = {0,0, 60,0, 0,20};
+    const int32_t origin[] = {0, 0};
+    // 90.0 in GDSII excess-64 format
+    const uint8_t angle[8] = {0x42, 0x5a, 0, 0, 0, 0, 0, 0};
+
+    put_library(&b, "INSTLIB");
+
+    put_structure(&b, "CELL");
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, rect, 5);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "TOP");
+    put_header(&b, SREF, 0);
+    put_string(&b, SNAME, "CELL");
+    put_header(&b, STRANS, 2);
+    put_u16(&b, 0x8000);
+    put_header(&b, ANGLE, 8);
+    put_bytes(&b, angle, 8);
+    put_xy(&b, sref, 1);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, AREF, 0);
+    put_string(&b, SNAME, "CELL");
+    put_header(&b, COLROW, 4);
+    put_u16(&b, 3);
+    put_u16(&b, 2);
+    put_xy(&b, aref, 3);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, SREF, 0);
+    put_string(&b, SNAME, "NOWHERE");
+    put_xy(&b, origin, 1);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+static int near(float a, double b) {
+    return fabs(a - b) < 1e-4;
+}
+
+/*
+ * Test 1: instance table
+ */
+static void test_instance_table(void* lib) {
+    printf("\n=== Test 1: Instance Table ===\n");
+
+    int words = gds_get_instance_table(lib);
+    const int32_t* t = gds_get_instance_table_buffer(lib);
+    TEST_ASSERT(words > GDS_INST_HEADER_WORDS && t != NULL, "Instance table created");
+    if (words <= 0 || !t) return;
+
+    TEST_ASSERT(t[GDS_INST_STRUCTURE_COUNT] == 2 && t[GDS_INST_COUNT] == 3, "Counts");
+
+    const int32_t* sinst = t + t[GDS_INST_STRUCTURE_INSTANCES];
+    TEST_ASSERT(sinst[0] == 0 && sinst[1] == 0 && sinst[2] == 3, "CELL has none, TOP three instances");
+
+    const int32_t* cells = t + t[GDS_INST_CELLS];
+    const int32_t* elements = t + t[GDS_INST_ELEMENTS];
+    TEST_ASSERT(cells[0] == 0 && cells[1] == 0 && cells[2] == -1, "Referenced structures");
+    TEST_ASSERT(elements[0] == 0 && elements[1] == 1 && elements[2] == 2, "Element indices");
+
+    // reflection about the x-axis, then rotation by 90 degrees:
+    // (x, y) -> (y + 100, x + 50)
+    const float* tr = (const float*)(t + t[GDS_INST_TRANSFORMS]);
+    TEST_ASSERT(near(tr[0], 0) && near(tr[1], 1) && near(tr[2], 1) && near(tr[3], 0) &&
+                near(tr[4], 100) && near(tr[5], 50), "Reflected and rotated transform");
+    TEST_ASSERT(near(tr[6], 1) && near(tr[7], 0) && near(tr[8], 0) && near(tr[9], 1) &&
+                near(tr[10], 0) && near(tr[11], 0), "Array transform");
+
+    const int32_t* lat = t + t[GDS_INST_LATTICES];
+    const float* st = (const float*)(t + t[GDS_INST_STEPS]);
+    TEST_ASSERT(lat[0] == 1 && lat[1] == 1 && lat[2] == 3 && lat[3] == 2, "Lattice dimensions");
+    TEST_ASSERT(near(st[4], 20) && near(st[5], 0) && near(st[6], 0) && near(st[7], 10),
+                "Lattice steps");
+    TEST_ASSERT(words == GDS_INST_HEADER_WORDS + 3 + 14 * 3, "Buffer size");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Instance Table Tests ===\n");
+
+    size_t size;
+    uint8_t* data = create_test_library(&size);
+    int err = 0;
+    void* lib = gds_parse_from_memory(data, size, &err);
+    if (!lib) {
+        printf("FAILED: library not parsed (error %d)\n", err);
+        return 1;
+    }
+
+    test_instance_table(lib);
+    TEST_ASSERT(gds_get_instance_table(NULL) == -1, "NULL library rejected");
+
+    gds_free_library(lib);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
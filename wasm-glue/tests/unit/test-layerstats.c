@@ -0,0 +1,193 @@
+/*
+ * Test Suite: Layer Statistics
+ *
+ * Tests verify the layer statistics of structures and libraries
+ * (Basic/gdsio/layerstats.c): counts, vertices and areas on (layer,
+ * data type) pairs, polygon and path areas, layers and data types
+ * above 255, the number of instances through sref and aref elements,
+ * top structures, cycles, and the flat and hierarchical totals.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "layerstats.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_EQ(expected, actual, epsilon, message) \
+    do { \
+        tests_run++; \
+        double diff = fabs((expected) - (actual)); \
+        if (diff < (epsilon)) { \
+            tests_passed++; \
+            printf("  ✓ %s (%.4f)\n", message, (double)(actual)); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s - expected %.4f, got %.4f\n", \
+                   message, (double)(expected), (double)(actual)); \
+        } \
+    } while(0)
+
+static void test_areas(void) {
+    ls_struct_t st;
+    double sq[] = {0,0, 2,0, 2,3, 0,3, 0,0};          /* closed, cw or ccw */
+    double cw[] = {0,0, 0,3, 2,3, 2,0};
+    double path[] = {0,0, 10,0};
+    double ext[] = {1.0, 2.0};
+
+    printf("\nTest: Polygon and path areas\n");
+    memset(&st, 0, sizeof(st));
+
+    TEST_ASSERT_DOUBLE_EQ(6.0, ls_polygon_area(sq, sq+1, 5, 2), 1e-12, "Closed rectangle");
+    TEST_ASSERT_DOUBLE_EQ(6.0, ls_polygon_area(cw, cw+1, 4, 2), 1e-12, "Open clockwise rectangle");
+    TEST_ASSERT_DOUBLE_EQ(0.0, ls_polygon_area(sq, sq+1, 2, 2), 1e-12, "Degenerate polygon");
+    TEST_ASSERT_DOUBLE_EQ(20.0, ls_path_area(&st, path, path+1, 2, 2, 1.0, 0, NULL), 1e-9,
+                          "Flush path");
+    TEST_ASSERT_DOUBLE_EQ(24.0, ls_path_area(&st, path, path+1, 2, 2, 1.0, 2, NULL), 1e-9,
+                          "Path extended by half the width");
+    TEST_ASSERT_DOUBLE_EQ(26.0, ls_path_area(&st, path, path+1, 2, 2, 1.0, 4, ext), 1e-9,
+                          "Path with extensions");
+    TEST_ASSERT_DOUBLE_EQ(0.0, ls_path_area(&st, path, path+1, 2, 2, 0.0, 0, NULL), 1e-12,
+                          "Zero width path");
+
+    ls_struct_free(&st);
+}
+
+static void test_structure(void) {
+    ls_struct_t st;
+    const ls_entry_t* pe;
+    int k, ok = 1;
+
+    printf("\nTest: Statistics of a structure\n");
+    memset(&st, 0, sizeof(st));
+
+    TEST_ASSERT(ls_add(&st, 31, 0, LS_BOUNDARY, 1, 5, 6.0) == 0, "Boundary added");
+    TEST_ASSERT(ls_add(&st, 31, 0, LS_BOUNDARY, 1, 5, 4.0) == 0, "Second boundary added");
+    TEST_ASSERT(ls_add(&st, 31, 0, LS_PATH, 1, 2, 20.0) == 0, "Path added");
+    TEST_ASSERT(ls_add(&st, 31, 7, LS_TEXT, 1, 1, 0.0) == 0, "Text on another data type added");
+    TEST_ASSERT(ls_add(&st, 65535, 65535, LS_BOX, 1, 5, 1.0) == 0, "Box on layer 65535 added");
+
+    pe = ls_find(&st, LS_KEY(31,0));
+    TEST_ASSERT(pe && pe->val[LS_BOUNDARY] == 2 && pe->val[LS_PATH] == 1 &&
+                pe->val[LS_VERTICES] == 12 && pe->val[LS_AREA] == 30.0,
+                "Counts, vertices and area on 31/0");
+    pe = ls_find(&st, LS_KEY(31,7));
+    TEST_ASSERT(pe && pe->val[LS_TEXT] == 1 && pe->val[LS_BOUNDARY] == 0, "Text on 31/7");
+    pe = ls_find(&st, LS_KEY(65535,65535));
+    TEST_ASSERT(pe && pe->val[LS_BOX] == 1, "Largest layer and data type");
+    TEST_ASSERT(ls_find(&st, LS_KEY(32,0)) == NULL, "Missing pair is not found");
+
+    /* many pairs grow the hash table */
+    for (k = 0; k < 3000; k++)
+        ok = ok && ls_add(&st, (uint16_t)k, (uint16_t)(k % 3), LS_NODE, 1, 1, 0.0) == 0;
+    for (k = 0; k < 3000; k++) {
+        pe = ls_find(&st, LS_KEY(k, k % 3));
+        ok = ok && pe && pe->val[LS_NODE] == 1;
+    }
+    TEST_ASSERT(ok, "3000 pairs are found after the table grew");
+
+    ls_struct_free(&st);
+}
+
+/*
+ * TOP references A 2 times (sref) and B as a 3 x 4 array;
+ * A references B once. C is not referenced.
+ */
+static void make_library(ls_struct_t* st) {
+    memset(st, 0, 4*sizeof(ls_struct_t));
+    ls_add_ref(&st[0], "A", 1);
+    ls_add_ref(&st[0], "A", 1);
+    ls_add_ref(&st[0], "B", 12);
+    ls_add_ref(&st[0], "UNKNOWN", 1);
+    ls_add(&st[0], 1, 0, LS_BOUNDARY, 1, 5, 100.0);
+    ls_add_ref(&st[1], "B", 1);
+    ls_add(&st[1], 2, 0, LS_BOUNDARY, 1, 5, 10.0);
+    ls_add(&st[2], 3, 0, LS_BOX, 1, 5, 1.0);
+    ls_add(&st[3], 2, 0, LS_PATH, 1, 2, 5.0);
+}
+
+static void test_hierarchy(void) {
+    ls_struct_t st[4], flat, hier;
+    const char* names[] = {"TOP", "A", "B", "C"};
+    double inst[4];
+    const ls_entry_t* pe;
+
+    printf("\nTest: Instances and totals\n");
+    make_library(st);
+
+    TEST_ASSERT(ls_instances(st, names, 4, NULL, inst) == 0, "Instances of all top structures");
+    TEST_ASSERT(inst[0] == 1 && inst[1] == 2 && inst[2] == 14 && inst[3] == 1,
+                "TOP 1, A 2, B 12 + 2, C 1");
+
+    memset(&flat, 0, sizeof(flat));
+    memset(&hier, 0, sizeof(hier));
+    TEST_ASSERT(ls_total(st, 4, NULL, &flat) == 0, "Flat totals");
+    TEST_ASSERT(ls_total(st, 4, inst, &hier) == 0, "Hierarchical totals");
+    TEST_ASSERT(flat.nent == 3 && flat.ent[0].key == LS_KEY(1,0) &&
+                flat.ent[1].key == LS_KEY(2,0) && flat.ent[2].key == LS_KEY(3,0),
+                "Totals sorted by layer");
+    pe = ls_find(&flat, LS_KEY(2,0));
+    TEST_ASSERT(pe && pe->val[LS_BOUNDARY] == 1 && pe->val[LS_PATH] == 1 &&
+                pe->val[LS_AREA] == 15.0, "Flat counts on layer 2");
+    pe = ls_find(&hier, LS_KEY(2,0));
+    TEST_ASSERT(pe && pe->val[LS_BOUNDARY] == 2 && pe->val[LS_PATH] == 1 &&
+                pe->val[LS_AREA] == 25.0, "Hierarchical counts on layer 2");
+    pe = ls_find(&hier, LS_KEY(3,0));
+    TEST_ASSERT(pe && pe->val[LS_BOX] == 14 && pe->val[LS_VERTICES] == 70,
+                "Array and nested instances of B");
+    ls_struct_free(&flat);
+    ls_struct_free(&hier);
+
+    TEST_ASSERT(ls_instances(st, names, 4, "A", inst) == 0, "Instances below A");
+    TEST_ASSERT(inst[0] == 0 && inst[1] == 1 && inst[2] == 1 && inst[3] == 0,
+                "Only A and B are below A");
+    TEST_ASSERT(ls_instances(st, names, 4, "NONE", inst) == -2, "Unknown top structure");
+
+    /* B references TOP: a cycle */
+    ls_add_ref(&st[2], "TOP", 1);
+    TEST_ASSERT(ls_instances(st, names, 4, NULL, inst) == -3, "Cycle is reported");
+
+    ls_struct_free(&st[0]);
+    ls_struct_free(&st[1]);
+    ls_struct_free(&st[2]);
+    ls_struct_free(&st[3]);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Layer Statistics Tests\n");
+    printf("========================================\n");
+
+    test_areas();
+    test_structure();
+    test_hierarchy();
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,324 @@
+/*
+ * Test Suite: Hierarchical Layout Diff
+ *
+ * Tests verify the layout comparison in Boolean/layoutdiff.cpp used
+ * by gdsdiff: identical hierarchies are skipped without expanding
+ * shapes, differences in referenced structures and arrays are found
+ * with the exact exclusive or area, shapes that differ only in their
+ * decomposition give no difference, and the layer selection and
+ * cycle detection work.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+
+#include "layoutdiff.hpp"
+
+using namespace ClipperLib;
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+static const double UD = 1000.0;   // 1 nm database unit for um user units
+
+static void add_rect(fl_library_t* lib, int k, int layer,
+                     double x0, double y0, double x1, double y1) {
+    fl_cell_t* c = &lib->cell[k];
+    element_t e;
+    double xy[10] = {x0, y0, x1, y0, x1, y1, x0, y1, x0, y0};
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_BOUNDARY;
+    e.layer = (uint16_t)layer;
+    fl_add_shape(c, (uint32_t)(c->nsh + c->nref), &e);
+    fl_add_vertices(c, xy, xy + 1, 5, 2);
+}
+
+static void add_sref(fl_library_t* lib, int k, int cell, double x, double y, double angle) {
+    fl_cell_t* c = &lib->cell[k];
+    element_t e;
+    double xy[6] = {x, y, 0, 0, 0, 0};
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_SREF;
+    if (angle != 0.0) {
+        e.has = HAS_STRANS | HAS_ANGLE;
+        e.strans.mag = 1.0;
+        e.strans.angle = angle;
+    }
+    fl_add_ref(c, (uint32_t)(c->nsh + c->nref), cell, &e, xy);
+}
+
+static void add_aref(fl_library_t* lib, int k, int cell, double x, double y,
+                     int ncol, int nrow, double dx, double dy) {
+    fl_cell_t* c = &lib->cell[k];
+    element_t e;
+    double xy[6] = {x, y, x + ncol * dx, y, x, y + nrow * dy};
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_AREF;
+    e.ncol = (uint16_t)ncol;
+    e.nrow = (uint16_t)nrow;
+    fl_add_ref(c, (uint32_t)(c->nsh + c->nref), cell, &e, xy);
+}
+
+/*
+ * a small chip: a leaf with two rectangles, a block with an array
+ * of leaves, and a top structure with two rotated blocks. The
+ * structures are stored in a different order when reversed is set;
+ * w is the width of the first leaf rectangle.
+ */
+static void build_chip(fl_library_t* lib, bool reversed, double w) {
+    int leaf = reversed ? 2 : 0, block = 1, top = reversed ? 0 : 2;
+
+    fl_library_init(lib, 3);
+    if (reversed) {
+        add_rect(lib, leaf, 2, 0, 0, 2, 8);
+        add_rect(lib, leaf, 1, 0, 0, w, 10);
+    }
+    else {
+        add_rect(lib, leaf, 1, 0, 0, w, 10);
+        add_rect(lib, leaf, 2, 0, 0, 2, 8);
+    }
+    add_aref(lib, block, leaf, 0, 0, 3, 3, 20, 20);
+    add_rect(lib, block, 1, -10, -10, 70, -5);
+    add_sref(lib, top, block, 0, 0, 0.0);
+    add_sref(lib, top, block, 500, 0, 90.0);
+}
+
+static const LayerDiff* find_layer(const DiffResult& res, int layer) {
+    for (size_t k = 0; k < res.layers.size(); k++)
+        if (res.layers[k].layer == layer)
+            return &res.layers[k];
+    return NULL;
+}
+
+static double area_uu(const LayerDiff* ld) {
+    return ld ? ld->area / (UD * UD) : 0.0;
+}
+
+/*
+ * Test 1: identical layouts
+ */
+static void test_identical(void) {
+    printf("\n=== Test 1: Identical Layouts ===\n");
+
+    fl_library_t a, b;
+    DiffResult res;
+    std::vector<int> all;
+
+    build_chip(&a, false, 10);
+    build_chip(&b, true, 10);
+    const char* msg = LayoutDiff(&a, 2, &b, 0, all, UD, 1, res);
+
+    TEST_ASSERT(msg == NULL, "Layouts are compared");
+    TEST_ASSERT(res.layers.empty(), "Identical layouts have no differences");
+    TEST_ASSERT(res.ncell[0] == 3 && res.nsame[0] == 3 && res.nsame[1] == 3,
+                "All structures are identical despite structure and element order");
+    TEST_ASSERT(res.npair == 1 && res.nskip == 1 && res.nwin == 0,
+                "Identical top structures are skipped");
+    TEST_ASSERT(res.nshape[0] == 0 && res.nshape[1] == 0, "No shapes are expanded");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+}
+
+/*
+ * Test 2: a modified leaf structure
+ */
+static void test_modified_leaf(void) {
+    printf("\n=== Test 2: Modified Leaf Structure ===\n");
+
+    fl_library_t a, b;
+    DiffResult res;
+    std::vector<int> all;
+
+    build_chip(&a, false, 10);
+    build_chip(&b, false, 12);   // leaf rectangle 10 --> 12 wide
+
+    const char* msg = LayoutDiff(&a, 2, &b, 2, all, UD, 2, res);
+    const LayerDiff* l1 = find_layer(res, 1);
+
+    TEST_ASSERT(msg == NULL && res.layers.size() == 1 && l1 != NULL,
+                "The difference is on layer 1 only");
+    TEST_ASSERT(fabs(area_uu(l1) - 2 * 9 * 20.0) < 1e-6,
+                "Exclusive or area of 18 leaf instances is exact");
+    TEST_ASSERT(res.nsame[0] == 0 && res.npair == 3 && res.nskip == 0,
+                "Changed structures are compared once per pair");
+    TEST_ASSERT(res.nshape[0] < 2 * 9 * 2 + 2,
+                "Only shapes in the difference windows are expanded");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+}
+
+/*
+ * Test 3: an added reference and a layer selection
+ */
+static void test_added_reference(void) {
+    printf("\n=== Test 3: Added Reference and Layer Selection ===\n");
+
+    fl_library_t a, b;
+    DiffResult res;
+    std::vector<int> all, lay2(1, 2);
+
+    build_chip(&a, false, 10);
+    build_chip(&b, false, 10);
+    add_sref(&b, 2, 0, -100, -100, 0.0);
+
+    const char* msg = LayoutDiff(&a, 2, &b, 2, all, UD, 1, res);
+    TEST_ASSERT(msg == NULL && res.layers.size() == 2, "Differences on two layers");
+    TEST_ASSERT(fabs(area_uu(find_layer(res, 1)) - 100.0) < 1e-6 &&
+                fabs(area_uu(find_layer(res, 2)) - 16.0) < 1e-6,
+                "Added reference gives the area of the referenced structure");
+    TEST_ASSERT(res.nsame[0] == 2 && res.nsame[1] == 2,
+                "Structures below the top structure are identical");
+
+    msg = LayoutDiff(&a, 2, &b, 2, lay2, UD, 1, res);
+    TEST_ASSERT(msg == NULL && res.layers.size() == 1 && res.layers[0].layer == 2,
+                "Only selected layers are compared");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+}
+
+/*
+ * Test 4: same geometry, different shapes
+ */
+static void test_same_geometry(void) {
+    printf("\n=== Test 4: Same Geometry with Different Shapes ===\n");
+
+    fl_library_t a, b;
+    DiffResult res;
+    std::vector<int> all;
+
+    fl_library_init(&a, 1);
+    fl_library_init(&b, 1);
+    add_rect(&a, 0, 1, 0, 0, 10, 10);
+    add_rect(&a, 0, 1, 10, 0, 20, 10);
+    add_rect(&b, 0, 1, 0, 0, 20, 10);
+    add_rect(&a, 0, 3, 0, 0, 1, 1);
+    add_rect(&b, 0, 3, 0, 0, 1, 1);
+    add_rect(&b, 0, 3, 0.2, 0.2, 0.8, 0.8);   // covered by the first
+
+    const char* msg = LayoutDiff(&a, 0, &b, 0, all, UD, 1, res);
+    TEST_ASSERT(msg == NULL && res.nwin == 4, "Differing shapes give windows");
+    TEST_ASSERT(res.layers.empty(), "Merged and overlapping shapes have no geometric difference");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+}
+
+/*
+ * Test 5: a large array
+ */
+static void build_array(fl_library_t* lib, double h, double x1) {
+    // leaf with 100 rectangles in an array of 100 x 100 instances
+    fl_library_init(lib, 3);
+    add_rect(lib, 0, 1, 0, 0, 0.5, h);
+    for (int k = 1; k < 100; k++)
+        add_rect(lib, 0, 1, k % 10, k / 10, k % 10 + 0.5, k / 10 + 0.5);
+    add_aref(lib, 1, 0, 0, 0, 100, 100, 10, 10);
+    add_sref(lib, 2, 1, 0, 0, 0.0);
+    add_rect(lib, 2, 1, -20, -20, x1, -10);
+}
+
+static void test_large_array(void) {
+    printf("\n=== Test 5: Large Array ===\n");
+
+    fl_library_t a, b, c;
+    DiffResult res;
+    std::vector<int> all;
+    char msgbuf[160];
+    clock_t t0;
+    double ms;
+
+    build_array(&a, 0.5, -10);
+    build_array(&b, 0.5, -9);      // top rectangle 1 wider
+    build_array(&c, 0.75, -10);    // first leaf rectangle 0.25 taller
+
+    t0 = clock();
+    const char* msg = LayoutDiff(&a, 2, &b, 2, all, UD, 0, res);
+    ms = 1e3 * (clock() - t0) / CLOCKS_PER_SEC;
+
+    TEST_ASSERT(msg == NULL && res.layers.size() == 1, "Difference is found");
+    TEST_ASSERT(fabs(area_uu(find_layer(res, 1)) - 10.0) < 1e-6, "Exclusive or area is exact");
+    snprintf(msgbuf, sizeof(msgbuf), "%zu of 2000002 shapes expanded in %.1f ms",
+             res.nshape[0] + res.nshape[1], ms);
+    TEST_ASSERT(res.nshape[0] + res.nshape[1] == 2, msgbuf);
+
+    // a change in the leaf affects all instances
+    t0 = clock();
+    msg = LayoutDiff(&c, 2, &b, 2, all, UD, 0, res);
+    ms = 1e3 * (clock() - t0) / CLOCKS_PER_SEC;
+    snprintf(msgbuf, sizeof(msgbuf), "Leaf change in 10000 instances found in %.1f ms", ms);
+    TEST_ASSERT(msg == NULL && fabs(area_uu(find_layer(res, 1)) - 10.0 - 10000 * 0.125) < 1e-3,
+                msgbuf);
+    TEST_ASSERT(res.nshape[0] == 10001 && res.nshape[1] == 10001,
+                "Only the changed leaf shapes are expanded");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+    fl_library_free(&c);
+}
+
+/*
+ * Test 6: invalid arguments
+ */
+static void test_errors(void) {
+    printf("\n=== Test 6: Invalid Arguments ===\n");
+
+    fl_library_t a, b;
+    DiffResult res;
+    std::vector<int> all;
+
+    fl_library_init(&a, 2);
+    fl_library_init(&b, 1);
+    add_sref(&a, 0, 1, 0, 0, 0.0);
+    add_sref(&a, 1, 0, 0, 0, 0.0);
+    add_rect(&b, 0, 1, 0, 0, 1, 1);
+
+    const char* msg = LayoutDiff(&a, 0, &b, 0, all, UD, 1, res);
+    TEST_ASSERT(msg != NULL && strstr(msg, "cycle") != NULL, "Cyclic hierarchy is detected");
+    TEST_ASSERT(LayoutDiff(&a, 5, &b, 0, all, UD, 1, res) != NULL, "Invalid top structure is rejected");
+    TEST_ASSERT(LayoutDiff(&b, 0, &b, 0, all, 0.0, 1, res) != NULL, "Invalid unit is rejected");
+
+    fl_library_free(&a);
+    fl_library_free(&b);
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - Hierarchical Layout Diff Tests ===\n");
+
+    test_identical();
+    test_modified_leaf();
+    test_added_reference();
+    test_same_geometry();
+    test_large_array();
+    test_errors();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/*
+ * Test Suite: Level of Detail
+ *
+ * Tests verify that gds_get_structure_lod builds the geometry of a
+ * structure for a pixel size, with polygons below a pixel merged into
+ * density tiles and larger polygons decimated, that levels are kept,
+ * and that gds_get_structure_bbox includes the references.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gds-wasm-adapter.h"
+#include "wasm-element-cache.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * TOP holds a 1000 x 1000 square on layer 1 whose edges have a vertex
+ * every 100 units, one of them 1 unit off the edge; five 2 x 2 squares
+ * on layer 2 at x = 0, 4, ..., 16; a text; and a reference to SUB, a
+ * 10 x 10 square, at (5000, 5000).
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    int32_t ring[2 * 42];
+    int n = 0;
+    for (int k = 0; k < 10; k++) { ring[2*n] = 100 * k; ring[2*n+1] = 0; n++; }
+    for (int k = 0; k < 10; k++) { ring[2*n] = 1000; ring[2*n+1] = 100 * k; n++; }
+    for (int k = 0; k < 10; k++) { ring[2*n] = 1000 - 100 * k; ring[2*n+1] = 1000; n++; }
+    for (int k = 0; k < 10; k++) { ring[2*n] = 0; ring[2*n+1] = 1000 - 100 * k; n++; }
+    ring[2*5+1] = 1;
+    ring[2*n] = 0; ring[2*n+1] = 0; n++;
+    const int32_t sub[] = {0,0, 10,0, 10,10, 0,10, 0,0};
+    const int32_t pos[] = {5000, 5000};
+    const int32_t text[] = {3, 3};
+
+    put_library(&b, "LODLIB");
+
+    put_structure(&b, "TOP");
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, ring, n);
+    put_header(&b, ENDEL, 0);
+
+    for (int k = 0; k < 5; k++) {
+        const int32_t sq[] = {4*k,0, 4*k+2,0, 4*k+2,2, 4*k,2, 4*k,0};
+        put_header(&b, BOUNDARY, 0);
+        put_header(&b, LAYER, 2);
+        put_u16(&b, 2);
+        put_header(&b, DATATYPE, 2);
+        put_u16(&b, 0);
+        put_xy(&b, sq, 5);
+        put_header(&b, ENDEL, 0);
+    }
+
+    put_header(&b, TEXT, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 5);
+    put_header(&b, TEXTTYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, text, 1);
+    put_string(&b, STRING, "A");
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, SREF, 0);
+    put_string(&b, SNAME, "SUB");
+    put_xy(&b, pos, 1);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "SUB");
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, sub, 5);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * Test 1: full detail
+ */
+static void test_level_zero(void* lib) {
+    printf("\n=== Test 1: Level 0 ===\n");
+
+    int words = gds_get_structure_lod(lib, 0, 0);
+    const int32_t* g = gds_get_structure_lod_buffer(lib);
+    TEST_ASSERT(words > GDS_GEOM_HEADER_WORDS && g != NULL, "Level built");
+    if (words <= 0 || !g) return;
+
+    const int32_t* pvert = g + g[GDS_GEOM_POLYGON_VERTICES];
+    TEST_ASSERT(g[GDS_GEOM_ELEMENT_COUNT] == 6 && g[GDS_GEOM_POLYGON_COUNT] == 6,
+                "Text and reference left out");
+    // the corners, the offset vertex and its two neighbors, which are
+    // 0.8 units off the lines to the offset vertex
+    TEST_ASSERT(pvert[1] == 7, "Collinear vertices removed, offset vertex kept");
+    TEST_ASSERT(g[GDS_GEOM_BBOXES] + 4 * 6 == words, "Bounding boxes end the buffer");
+}
+
+/*
+ * Test 2: coarse levels
+ */
+static void test_coarse_levels(void* lib) {
+    printf("\n=== Test 2: Coarse Levels ===\n");
+
+    // pixel of 8 units: the offset vertex goes, the small squares are tiles
+    gds_get_structure_lod(lib, 0, 3);
+    const int32_t* g = gds_get_structure_lod_buffer(lib);
+    if (!g) return;
+    const int32_t* kinds = g + g[GDS_GEOM_KINDS];
+    const int32_t* layers = g + g[GDS_GEOM_LAYERS];
+    const int32_t* pvert = g + g[GDS_GEOM_POLYGON_VERTICES];
+    const float* vert = (const float*)(g + g[GDS_GEOM_VERTICES]);
+    TEST_ASSERT(g[GDS_GEOM_ELEMENT_COUNT] == 2 && pvert[1] == 4, "Square decimated");
+    TEST_ASSERT(kinds[1] == GDS_BOUNDARY && layers[1] == 2 && pvert[2] - pvert[1] == 4,
+                "Small squares merged into one tile row");
+    TEST_ASSERT(vert[8] == 0.0f && vert[9] == 0.0f && vert[12] == 24.0f && vert[13] == 8.0f,
+                "Tile row covers three tiles");
+
+    // pixel of 2048 units: the large square is a tile too
+    gds_get_structure_lod(lib, 0, 11);
+    g = gds_get_structure_lod_buffer(lib);
+    if (!g) return;
+    layers = g + g[GDS_GEOM_LAYERS];
+    TEST_ASSERT(g[GDS_GEOM_ELEMENT_COUNT] == 2 && g[GDS_GEOM_POLYGON_COUNT] == 2 &&
+                layers[0] == 1 && layers[1] == 2, "One tile per layer");
+
+    const int32_t* first = g;
+    gds_get_structure_lod(lib, 0, 3);
+    gds_get_structure_lod(lib, 0, 11);
+    TEST_ASSERT(gds_get_structure_lod_buffer(lib) == first, "Levels are kept");
+    TEST_ASSERT(gds_get_structure_lod(lib, 0, GDS_LOD_LEVELS) == -1 &&
+                gds_get_structure_lod(lib, 2, 0) == -1, "Invalid arguments rejected");
+}
+
+/*
+ * Test 3: structure bounding box
+ */
+static void test_bbox(void* lib) {
+    printf("\n=== Test 3: Structure Bounding Box ===\n");
+
+    double bb[4];
+    TEST_ASSERT(gds_get_structure_bbox(lib, 0, bb) == 0 &&
+                bb[0] == 0.0 && bb[1] == 0.0 && bb[2] == 5010.0 && bb[3] == 5010.0,
+                "Reference included");
+    TEST_ASSERT(gds_get_structure_bbox(lib, 1, bb) == 0 && bb[2] == 10.0, "Leaf structure");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Level of Detail Tests ===\n");
+
+    size_t size;
+    int err;
+    uint8_t* data = create_test_library(&size);
+    void* lib = gds_parse_from_memory(data, size, &err);
+    TEST_ASSERT(lib != NULL && err == 0, "Library parsed");
+    if (!lib) return 1;
+
+    test_level_zero(lib);
+    test_coarse_levels(lib);
+    test_bbox(lib);
+
+    gds_free_library(lib);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ * Test Suite: Memory Accounting
+ *
+ * Tests verify the counters of the memory manager (total, peak and per
+ * category), that every allocation is recorded when tracking is on and
+ * only sampled ones otherwise, that leaks are reported, that the
+ * library caches account their memory, and that the counters stay
+ * consistent when threads allocate concurrently.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "wasm-memory-manager.h"
+#include "wasm-element-cache.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+int wasm_validate_memory(void);
+
+static size_t total_allocated(void) {
+    size_t total;
+    wasm_memory_get_stats(&total, NULL, NULL, NULL);
+    return total;
+}
+
+static int leak_count(void) {
+    int leaks;
+    wasm_memory_get_stats(NULL, NULL, NULL, &leaks);
+    return leaks;
+}
+
+/*
+ * Test 1: counters
+ */
+static void test_counters(void) {
+    printf("\n=== Test 1: Counters ===\n");
+
+    size_t base = total_allocated();
+    size_t base_element = wasm_memory_get_category_usage(WASM_MEMORY_ELEMENT);
+
+    char* a = WASM_MALLOC(100, WASM_MEMORY_ELEMENT);
+    int* b = WASM_CALLOC(10, sizeof(int), WASM_MEMORY_BUFFER);
+    TEST_ASSERT(a && b && ((uintptr_t)a % 8) == 0 && ((uintptr_t)b % 8) == 0, "Aligned blocks");
+    TEST_ASSERT(total_allocated() == base + 100 + 10 * sizeof(int), "Total counts both blocks");
+    TEST_ASSERT(wasm_memory_get_category_usage(WASM_MEMORY_ELEMENT) == base_element + 100,
+                "Element category");
+
+    int zero = 1;
+    for (int i = 0; i < 10; i++) zero = zero && b[i] == 0;
+    TEST_ASSERT(zero, "Calloc clears the block");
+
+    memset(a, 7, 100);
+    a = WASM_REALLOC(a, 5000, WASM_MEMORY_OTHER);
+    TEST_ASSERT(a && a[99] == 7, "Realloc keeps the data");
+    TEST_ASSERT(wasm_memory_get_category_usage(WASM_MEMORY_ELEMENT) == base_element + 5000,
+                "Realloc keeps the category");
+
+    size_t peak;
+    wasm_memory_get_stats(NULL, &peak, NULL, NULL);
+    TEST_ASSERT(peak >= base + 5000 + 10 * sizeof(int), "Peak usage");
+
+    WASM_FREE(a);
+    WASM_FREE(b);
+    WASM_FREE(NULL);
+    TEST_ASSERT(total_allocated() == base, "Frees return to the start");
+    TEST_ASSERT(WASM_MALLOC(SIZE_MAX - 4, WASM_MEMORY_OTHER) == NULL &&
+                WASM_CALLOC(SIZE_MAX / 2, 4, WASM_MEMORY_OTHER) == NULL, "Overflow rejected");
+}
+
+/*
+ * Test 2: recorded allocations and leaks
+ */
+static void test_tracking(void) {
+    printf("\n=== Test 2: Tracking and Leaks ===\n");
+
+    // every allocation is recorded
+    wasm_memory_init(1, 0);
+    void* blocks[1000];
+    for (int i = 0; i < 1000; i++) blocks[i] = WASM_MALLOC(16 + i % 7, WASM_MEMORY_OTHER);
+    for (int i = 0; i < 1000; i += 2) WASM_FREE(blocks[i]);
+    TEST_ASSERT(wasm_validate_memory(), "Table consistent after removals");
+    for (int i = 1; i < 999; i += 2) WASM_FREE(blocks[i]);
+    wasm_memory_shutdown();
+    TEST_ASSERT(leak_count() == 1, "One leak reported");
+    WASM_FREE(blocks[999]);
+
+    // nothing is recorded
+    wasm_memory_init(0, 0);
+    wasm_memory_set_sample_interval(0);
+    void* p = WASM_MALLOC(1 << 20, WASM_MEMORY_OTHER);
+    wasm_memory_shutdown();
+    TEST_ASSERT(leak_count() == 0, "No table without sampling");
+    WASM_FREE(p);
+
+    // about one in interval bytes is recorded, large blocks always
+    wasm_memory_init(0, 0);
+    wasm_memory_set_sample_interval(1024);
+    void* big = WASM_MALLOC(4096, WASM_MEMORY_OTHER);
+    for (int i = 0; i < 64; i++) blocks[i] = WASM_MALLOC(64, WASM_MEMORY_OTHER);
+    wasm_memory_shutdown();
+    int leaks = leak_count();
+    TEST_ASSERT(leaks >= 4 && leaks <= 6, "Sampled allocations recorded");
+    for (int i = 0; i < 64; i++) WASM_FREE(blocks[i]);
+    WASM_FREE(big);
+    wasm_memory_init(0, 0);
+}
+
+/*
+ * Test 3: library caches
+ */
+static void test_cache(void) {
+    printf("\n=== Test 3: Library Cache Accounting ===\n");
+
+    size_t base = total_allocated();
+    wasm_library_cache_t* cache = wasm_create_stream_cache(4096);
+    TEST_ASSERT(cache != NULL, "Stream cache created");
+    if (!cache) return;
+    TEST_ASSERT(wasm_memory_get_category_usage(WASM_MEMORY_CACHE) >= sizeof(wasm_library_cache_t) &&
+                wasm_memory_get_category_usage(WASM_MEMORY_BUFFER) >= 4096, "Cache and buffer accounted");
+    wasm_free_library_cache(cache);
+    TEST_ASSERT(total_allocated() == base, "Cache memory released");
+}
+
+/*
+ * Test 4: concurrent allocations
+ */
+static void* alloc_worker(void* arg) {
+    (void)arg;
+    void* blocks[64];
+    for (int round = 0; round < 200; round++) {
+        for (int i = 0; i < 64; i++) blocks[i] = WASM_MALLOC(8 + (size_t)(round + i) % 200, i % 4);
+        for (int i = 0; i < 64; i++) blocks[i] = WASM_REALLOC(blocks[i], 300, WASM_MEMORY_OTHER);
+        for (int i = 0; i < 64; i++) WASM_FREE(blocks[i]);
+    }
+    return NULL;
+}
+
+static void test_threads(void) {
+    printf("\n=== Test 4: Concurrent Allocations ===\n");
+
+    size_t base = total_allocated();
+    wasm_memory_set_sample_interval(4096);
+
+    pthread_t threads[4];
+    for (int k = 0; k < 4; k++) pthread_create(&threads[k], NULL, alloc_worker, NULL);
+    for (int k = 0; k < 4; k++) pthread_join(threads[k], NULL);
+
+    TEST_ASSERT(total_allocated() == base, "Counters balanced");
+    wasm_memory_shutdown();
+    TEST_ASSERT(leak_count() == 0, "Sampled entries removed");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Memory Accounting Tests ===\n");
+
+    test_counters();
+    test_tracking();
+    test_cache();
+    test_threads();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,836 @@
+/*
+ * Test Suite: OASIS Conversion
+ *
+ * Tests verify the conversion between GDSII libraries and OASIS files
+ * (Basic/gdsio/oasis.c): libraries written as OASIS files and read
+ * back must contain the same structures and elements, OASIS files
+ * with repetitions, CTRAPEZOID, CIRCLE and CBLOCK records must be
+ * read, and OASIS files must be opened through stream_open.
+ *
+ * Elements are compared in a normal form: the vertices of boundaries
+ * start at the lowest vertex and run counterclockwise.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <zlib.h>
+
+#include "gdsio.h"
+#include "gdsstream.h"
+#include "oasis.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define LIB_OAS "/tmp/test-oasis.oas"
+
+#define LONG_VERTICES 9000
+
+/*
+ * Helpers for writing GDSII records
+ */
+static void g_empty(FILE* f, uint16_t type) {
+    write_record_hdr(f, type, 0);
+}
+
+static void g_word(FILE* f, uint16_t type, uint16_t w) {
+    write_record_hdr(f, type, 2);
+    write_word(f, w);
+}
+
+static void g_int(FILE* f, uint16_t type, int32_t i) {
+    write_record_hdr(f, type, 4);
+    write_int(f, i);
+}
+
+static void g_real(FILE* f, uint16_t type, double d) {
+    write_record_hdr(f, type, 8);
+    write_real8(f, d);
+}
+
+static void g_string(FILE* f, uint16_t type, const char* s) {
+    int n = (int)strlen(s);
+    write_record_hdr(f, type, n + n % 2);
+    write_string(f, (char*)s, n);
+    if (n % 2) fputc(0, f);
+}
+
+static void g_date(FILE* f, uint16_t type) {
+    uint16_t d[12] = {2014, 1, 1, 0, 0, 0, 2014, 1, 1, 0, 0, 0};
+    write_record_hdr(f, type, sizeof(d));
+    write_word_n(f, d, 12);
+}
+
+// long vertex lists continue in the next XY record with the last vertex
+static void g_xy(FILE* f, const int32_t* xy, int n) {
+    int32_t buf[2 * MAX_XY_VERTICES];
+    int k, m;
+
+    for (k = 0; 1; k += m - 1) {
+        m = n - k > MAX_XY_VERTICES ? MAX_XY_VERTICES : n - k;
+        memcpy(buf, xy + 2 * k, 2 * m * sizeof(int32_t));
+        write_record_hdr(f, XY, 2 * m * sizeof(int32_t));
+        write_int_n(f, buf, 2 * m);
+        if (k + m >= n) break;
+    }
+}
+
+static void g_boundary(FILE* f, int layer, int dtype, const int32_t* xy, int n) {
+    g_empty(f, BOUNDARY);
+    g_word(f, LAYER, layer);
+    g_word(f, DATATYPE, dtype);
+    g_xy(f, xy, n);
+    g_empty(f, ENDEL);
+}
+
+static void g_begin(FILE* f, const char* libname) {
+    g_word(f, HEADER, 7);
+    g_date(f, BGNLIB);
+    g_string(f, LIBNAME, libname);
+    write_record_hdr(f, UNITS, 16);
+    write_real8(f, 0.001);
+    write_real8(f, 1e-9);
+}
+
+static void g_structure(FILE* f, const char* name) {
+    g_date(f, BGNSTR);
+    g_string(f, STRNAME, name);
+}
+
+/*
+ * a library with all elements that are converted without changes
+ */
+static FILE* create_test_library(void) {
+    static const int32_t rect[] = {0,0, 100,0, 100,50, 0,50, 0,0};
+    static const int32_t trap[] = {0,100, 100,100, 80,150, 20,150, 0,100};
+    static const int32_t poly[] = {0,200, 100,200, 100,220, 20,220, 20,300, 0,300, 0,200};
+    static const int32_t path[] = {0,400, 200,400, 200,600};
+    static const int32_t text[] = {50,700};
+    static const int32_t sref[] = {1000,2000};
+    static const int32_t aref[] = {0,5000, 3000,5000, 0,7000};
+    FILE* f = tmpfile();
+    int32_t* lxy;
+    int k;
+
+    g_begin(f, "OASLIB");
+
+    g_structure(f, "CELLA");
+    g_boundary(f, 1, 0, rect, 5);
+    g_boundary(f, 1, 2, trap, 5);
+    g_boundary(f, 2, 0, poly, 7);
+
+    // boundary with a property
+    g_empty(f, BOUNDARY);
+    g_word(f, LAYER, 3);
+    g_word(f, DATATYPE, 0);
+    g_xy(f, rect, 5);
+    g_word(f, PROPATTR, 7);
+    g_string(f, PROPVALUE, "net1");
+    g_empty(f, ENDEL);
+
+    // paths with flush, square and variable ends
+    for (k = 0; k < 3; k++) {
+        g_empty(f, PATH);
+        g_word(f, LAYER, 4);
+        g_word(f, DATATYPE, k);
+        if (k) g_word(f, PATHTYPE, 2 * k);
+        g_int(f, WIDTH, 20);
+        if (k == 2) {
+            g_int(f, BGNEXTN, 5);
+            g_int(f, ENDEXTN, -3);
+        }
+        g_xy(f, path, 3);
+        g_empty(f, ENDEL);
+    }
+
+    g_empty(f, TEXT);
+    g_word(f, LAYER, 5);
+    g_word(f, TEXTTYPE, 1);
+    g_xy(f, text, 1);
+    g_string(f, STRING, "hello");
+    g_empty(f, ENDEL);
+
+    // boundary with more vertices than fit in one XY record
+    lxy = malloc(2 * (LONG_VERTICES + 1) * sizeof(int32_t));
+    for (k = 0; k < LONG_VERTICES - 2; k++) {
+        lxy[2 * k] = k;
+        lxy[2 * k + 1] = k % 2 ? 1010 : 1000;
+    }
+    lxy[2 * LONG_VERTICES - 4] = LONG_VERTICES - 3;
+    lxy[2 * LONG_VERTICES - 3] = 900;
+    lxy[2 * LONG_VERTICES - 2] = 0;
+    lxy[2 * LONG_VERTICES - 1] = 900;
+    lxy[2 * LONG_VERTICES] = lxy[0];
+    lxy[2 * LONG_VERTICES + 1] = lxy[1];
+    g_boundary(f, 6, 0, lxy, LONG_VERTICES + 1);
+    free(lxy);
+    g_empty(f, ENDSTR);
+
+    // repeated rectangles are compressed well
+    g_structure(f, "CELLB");
+    for (k = 0; k < 200; k++) {
+        const int32_t r[] = {0,10*k, 5,10*k, 5,10*k+5, 0,10*k+5, 0,10*k};
+        g_boundary(f, 7, 0, r, 5);
+    }
+    g_empty(f, ENDSTR);
+
+    g_structure(f, "TOP");
+    g_empty(f, SREF);
+    g_string(f, SNAME, "CELLA");
+    g_word(f, STRANS, 0x8000);
+    g_real(f, MAG, 2.0);
+    g_real(f, ANGLE, 90.0);
+    g_xy(f, sref, 1);
+    g_empty(f, ENDEL);
+
+    g_empty(f, SREF);
+    g_string(f, SNAME, "CELLB");
+    g_word(f, STRANS, 0);
+    g_real(f, ANGLE, 270.0);
+    g_xy(f, sref, 1);
+    g_empty(f, ENDEL);
+
+    g_empty(f, AREF);
+    g_string(f, SNAME, "CELLA");
+    write_record_hdr(f, COLROW, 4);
+    write_word(f, 3);
+    write_word(f, 2);
+    g_xy(f, aref, 3);
+    g_empty(f, ENDEL);
+    g_empty(f, ENDSTR);
+
+    g_empty(f, ENDLIB);
+    rewind(f);
+    return f;
+}
+
+/*
+ * Normal form of a GDSII library as text, one line per element
+ */
+typedef struct {
+    char* p;
+    size_t n, a;
+} text_t;
+
+static void append(text_t* t, const char* fmt, ...) {
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (t->n + n + 1 > t->a) {
+        t->a = 2 * (t->n + n + 1);
+        t->p = realloc(t->p, t->a);
+    }
+    va_start(ap, fmt);
+    vsnprintf(t->p + t->n, n + 1, fmt, ap);
+    va_end(ap);
+    t->n += n;
+}
+
+static void append_xy(text_t* t, int32_t* xy, int n, int boundary) {
+    double area = 0.0;
+    int k, j, s = 0;
+
+    if (boundary) {
+        if (n > 1 && xy[0] == xy[2 * n - 2] && xy[1] == xy[2 * n - 1]) n--;
+        for (k = 0; k < n; k++) {
+            j = (k + 1) % n;
+            area += (double)xy[2 * k] * xy[2 * j + 1] - (double)xy[2 * j] * xy[2 * k + 1];
+            if (xy[2 * k + 1] < xy[2 * s + 1] ||
+                (xy[2 * k + 1] == xy[2 * s + 1] && xy[2 * k] < xy[2 * s])) s = k;
+        }
+    }
+    append(t, " XY(%d)", n);
+    for (k = 0; k < n; k++) {
+        j = !boundary ? k : area >= 0.0 ? (s + k) % n : (s - k + n) % n;
+        append(t, " %d,%d", xy[2 * j], xy[2 * j + 1]);
+    }
+}
+
+static char* dump_library(FILE* f) {
+    text_t t = {NULL, 0, 0};
+    char str[1024];
+    int32_t* xy = malloc(2 * (LONG_VERTICES + 2) * sizeof(int32_t));
+    uint16_t rtype, rlen, w[2];
+    int32_t i;
+    double d[2];
+    int nxy = 0, kind = 0;
+
+    append(&t, "");
+    while (read_record_hdr(f, &rtype, &rlen) == A_OK) {
+        switch (rtype) {
+            case STRNAME:
+                read_string(f, str, rlen);
+                append(&t, "STRUCTURE '%s'\n", str);
+                break;
+            case LIBNAME: case SNAME: case STRING: case PROPVALUE:
+                read_string(f, str, rlen);
+                append(&t, " '%s'", str);
+                break;
+            case UNITS:
+                read_real8(f, &d[0]);
+                read_real8(f, &d[1]);
+                append(&t, " UNITS %.9g %.9g\n", d[0], d[1]);
+                break;
+            case BOUNDARY: case PATH: case TEXT: case SREF: case AREF: case BOX:
+                kind = rtype;
+                nxy = 0;
+                append(&t, "%s", rtype == BOUNDARY ? "BOUNDARY" : rtype == PATH ? "PATH" :
+                       rtype == TEXT ? "TEXT" : rtype == SREF ? "SREF" : rtype == AREF ? "AREF" : "BOX");
+                break;
+            case LAYER: case DATATYPE: case TEXTTYPE: case PATHTYPE: case STRANS: case PROPATTR:
+                read_word(f, &w[0]);
+                append(&t, " %04x:%d", rtype, w[0]);
+                break;
+            case WIDTH: case BGNEXTN: case ENDEXTN:
+                read_int(f, &i);
+                append(&t, " %04x:%d", rtype, i);
+                break;
+            case MAG: case ANGLE:
+                read_real8(f, &d[0]);
+                append(&t, " %04x:%g", rtype, d[0]);
+                break;
+            case COLROW:
+                read_word_n(f, w, 2);
+                append(&t, " COLROW %d %d", w[0], w[1]);
+                break;
+            case XY:
+                // a continuation record repeats the last vertex
+                if (nxy) nxy--;
+                if (nxy + rlen / 8 <= LONG_VERTICES + 2) read_int_n(f, xy + 2 * nxy, rlen / 4);
+                nxy += rlen / 8;
+                break;
+            case ENDEL:
+                append_xy(&t, xy, nxy, kind == BOUNDARY);
+                append(&t, "\n");
+                break;
+            case ENDSTR:
+                append(&t, "ENDSTR\n");
+                break;
+            case ENDLIB:
+                append(&t, "ENDLIB\n");
+                break;
+            default:
+                read_ignore(f, rlen);
+        }
+        if (rtype == ENDLIB) break;
+    }
+
+    free(xy);
+    return t.p;
+}
+
+static int count_lines(const char* s, const char* prefix) {
+    int n = 0;
+    for (const char* p = s; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (strncmp(p, prefix, strlen(prefix)) == 0) n++;
+    }
+    return n;
+}
+
+static const char* find_line(const char* s, const char* prefix, int k) {
+    for (const char* p = s; p; p = strchr(p, '\n')) {
+        if (*p == '\n') p++;
+        if (strncmp(p, prefix, strlen(prefix)) == 0 && k-- == 0) return p;
+    }
+    return NULL;
+}
+
+// s occurs in the line starting at p
+static int line_has(const char* p, const char* s) {
+    const char* q = p ? strstr(p, s) : NULL;
+    return q != NULL && q < strchr(p, '\n');
+}
+
+static long file_size(FILE* f) {
+    fseek(f, 0, SEEK_END);
+    return ftell(f);
+}
+
+/*
+ * Test 1: GDSII -> OASIS -> GDSII
+ */
+static void test_roundtrip(void) {
+    printf("\n=== Test 1: Round Trip ===\n");
+
+    FILE* gin = create_test_library();
+    FILE* oas = tmpfile();
+    FILE* oasc = tmpfile();
+    FILE* gout = tmpfile();
+    FILE* goutc = tmpfile();
+    char magic[OAS_MAGIC_LEN];
+    char *d0, *d1, *d2;
+
+    TEST_ASSERT(oas_write(gin, oas, 0) == NULL, "Library written as OASIS file");
+    rewind(gin);
+    TEST_ASSERT(oas_write(gin, oasc, 1) == NULL, "Library written with CBLOCKs");
+    rewind(oas);
+    TEST_ASSERT(fread(magic, 1, OAS_MAGIC_LEN, oas) == OAS_MAGIC_LEN &&
+                memcmp(magic, OAS_MAGIC, OAS_MAGIC_LEN) == 0, "OASIS magic bytes");
+    TEST_ASSERT(file_size(oasc) < file_size(oas) / 2, "CBLOCKs are smaller");
+
+    rewind(oas);
+    rewind(oasc);
+    TEST_ASSERT(oas_read(oas, gout) == NULL, "OASIS file read");
+    TEST_ASSERT(oas_read(oasc, goutc) == NULL, "OASIS file with CBLOCKs read");
+
+    rewind(gin);
+    rewind(gout);
+    rewind(goutc);
+    d0 = dump_library(gin);
+    d1 = dump_library(gout);
+    d2 = dump_library(goutc);
+    TEST_ASSERT(strcmp(d0, d1) == 0, "Same library after round trip");
+    TEST_ASSERT(strcmp(d0, d2) == 0, "Same library after round trip with CBLOCKs");
+    TEST_ASSERT(strstr(d1, " 'OASLIB' UNITS 0.001 1e-09\n") != NULL, "Library name and units");
+    TEST_ASSERT(count_lines(d1, "BOUNDARY") == 205, "All boundaries");
+
+    fclose(gin);
+    fclose(oas);
+    fclose(oasc);
+    fclose(gout);
+    fclose(goutc);
+    free(d0);
+    free(d1);
+    free(d2);
+}
+
+/*
+ * Test 2: elements that are changed by the conversion
+ */
+static void test_mapping(void) {
+    printf("\n=== Test 2: Element Mapping ===\n");
+
+    static const int32_t box[] = {0,0, 40,0, 40,30, 0,30, 0,0};
+    static const int32_t path[] = {0,0, 100,0};
+    FILE* gin = tmpfile();
+    FILE* oas = tmpfile();
+    FILE* gout = tmpfile();
+    char* d;
+
+    g_begin(gin, "MAP");
+    g_structure(gin, "S");
+    g_empty(gin, BOX);
+    g_word(gin, LAYER, 1);
+    g_word(gin, BOXTYPE, 3);
+    g_xy(gin, box, 5);
+    g_empty(gin, ENDEL);
+    g_empty(gin, PATH);
+    g_word(gin, LAYER, 2);
+    g_word(gin, DATATYPE, 0);
+    g_word(gin, PATHTYPE, 2);
+    g_int(gin, WIDTH, 11);
+    g_xy(gin, path, 2);
+    g_empty(gin, ENDEL);
+    g_empty(gin, ENDSTR);
+    g_empty(gin, ENDLIB);
+    rewind(gin);
+
+    TEST_ASSERT(oas_write(gin, oas, 1) == NULL, "Library written as OASIS file");
+    rewind(oas);
+    TEST_ASSERT(oas_read(oas, gout) == NULL, "OASIS file read");
+    rewind(gout);
+    d = dump_library(gout);
+
+    TEST_ASSERT(strstr(d, "BOUNDARY 0d02:1 0e02:3 XY(4) 0,0 40,0 40,30 0,30\n") != NULL,
+                "Box becomes boundary with box type as datatype");
+    TEST_ASSERT(strstr(d, "PATH 0d02:2 0e02:0 2102:2 0f03:12 XY(2) 0,0 100,0\n") != NULL,
+                "Odd path width rounded up");
+    TEST_ASSERT(count_lines(d, "BOUNDARY") == 1 && count_lines(d, "PATH") == 1,
+                "One element each");
+
+    fclose(gin);
+    fclose(oas);
+    fclose(gout);
+    free(d);
+}
+
+/*
+ * Helpers for writing OASIS records
+ */
+typedef struct {
+    uint8_t data[4096];
+    size_t pos;
+} oas_buffer_t;
+
+static void o_byte(oas_buffer_t* b, int c) {
+    b->data[b->pos++] = c;
+}
+
+static void o_uint(oas_buffer_t* b, uint64_t u) {
+    do {
+        o_byte(b, (u & 0x7f) | (u > 0x7f ? 0x80 : 0));
+        u >>= 7;
+    } while (u);
+}
+
+static void o_sint(oas_buffer_t* b, int64_t s) {
+    o_uint(b, s < 0 ? ((uint64_t)-s << 1) | 1 : (uint64_t)s << 1);
+}
+
+static void o_string(oas_buffer_t* b, const char* s) {
+    o_uint(b, strlen(s));
+    memcpy(b->data + b->pos, s, strlen(s));
+    b->pos += strlen(s);
+}
+
+/*
+ * cell A: 3 rectangles, a triangle and a circle
+ * cell B: an array and 3 placements of A, in a CBLOCK
+ */
+static FILE* create_test_oasis(void) {
+    oas_buffer_t b, cb;
+    uint8_t z[1024];
+    z_stream zs;
+    FILE* f = tmpfile();
+    int k;
+
+    memset(&b, 0, sizeof(b));
+    memcpy(b.data, OAS_MAGIC, OAS_MAGIC_LEN);
+    b.pos = OAS_MAGIC_LEN;
+
+    o_uint(&b, 1);                          // START
+    o_string(&b, "1.0");
+    o_uint(&b, 0);                          // unit 1000 / um
+    o_uint(&b, 1000);
+    o_uint(&b, 0);                          // tables in START
+    for (k = 0; k < 12; k++) o_uint(&b, 0);
+
+    o_uint(&b, 3);                          // CELLNAME A, reference 0
+    o_string(&b, "A");
+
+    o_uint(&b, 13);                         // CELL 0
+    o_uint(&b, 0);
+    o_uint(&b, 20);                         // RECTANGLE with repetition
+    o_byte(&b, 0x7f);
+    o_uint(&b, 1);                          // layer
+    o_uint(&b, 0);                          // datatype
+    o_uint(&b, 10);                         // width
+    o_uint(&b, 20);                         // height
+    o_sint(&b, 0);
+    o_sint(&b, 0);
+    o_uint(&b, 2);                          // 3 in x, spacing 100
+    o_uint(&b, 1);
+    o_uint(&b, 100);
+    o_uint(&b, 26);                         // CTRAPEZOID type 16
+    o_byte(&b, 0xd8);
+    o_uint(&b, 16);
+    o_uint(&b, 30);
+    o_sint(&b, 1000);
+    o_sint(&b, 0);
+    o_uint(&b, 27);                         // CIRCLE
+    o_byte(&b, 0x38);
+    o_uint(&b, 50);
+    o_sint(&b, 2000);
+    o_sint(&b, 0);
+
+    // the records of cell B are compressed
+    memset(&cb, 0, sizeof(cb));
+    o_uint(&cb, 14);                        // CELL B
+    o_string(&cb, "B");
+    o_uint(&cb, 17);                        // PLACEMENT of A with 4 x 2 array
+    o_byte(&cb, 0xf8);
+    o_uint(&cb, 0);
+    o_sint(&cb, 0);
+    o_sint(&cb, 0);
+    o_uint(&cb, 1);
+    o_uint(&cb, 2);
+    o_uint(&cb, 0);
+    o_uint(&cb, 500);
+    o_uint(&cb, 600);
+    o_uint(&cb, 17);                        // PLACEMENT with irregular repetition
+    o_byte(&cb, 0x3a);                      // rotated by 90 degrees
+    o_sint(&cb, 100);
+    o_sint(&cb, 200);
+    o_uint(&cb, 4);                         // 3 in x at 0, 10, 30
+    o_uint(&cb, 1);
+    o_uint(&cb, 10);
+    o_uint(&cb, 20);
+
+    memset(&zs, 0, sizeof(zs));
+    deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    zs.next_in = cb.data;
+    zs.avail_in = cb.pos;
+    zs.next_out = z;
+    zs.avail_out = sizeof(z);
+    deflate(&zs, Z_FINISH);
+    o_uint(&b, 34);                         // CBLOCK
+    o_uint(&b, 0);
+    o_uint(&b, cb.pos);
+    o_uint(&b, zs.total_out);
+    memcpy(b.data + b.pos, z, zs.total_out);
+    b.pos += zs.total_out;
+    deflateEnd(&zs);
+
+    o_uint(&b, 2);                          // END, 256 bytes
+    o_uint(&b, 252);
+    b.pos += 252;
+    o_uint(&b, 0);
+
+    fwrite(b.data, 1, b.pos, f);
+    rewind(f);
+    return f;
+}
+
+/*
+ * Test 3: reading OASIS records
+ */
+static void test_read(void) {
+    printf("\n=== Test 3: Reading OASIS Records ===\n");
+
+    FILE* oas = create_test_oasis();
+    FILE* gout = tmpfile();
+    const char* p;
+    char* d;
+
+    TEST_ASSERT(oas_read(oas, gout) == NULL, "OASIS file read");
+    rewind(gout);
+    d = dump_library(gout);
+
+    TEST_ASSERT(strstr(d, " UNITS 0.001 1e-09\n") != NULL, "Units from START record");
+    TEST_ASSERT(count_lines(d, "BOUNDARY") == 5, "All boundaries");
+    p = find_line(d, "BOUNDARY", 2);
+    TEST_ASSERT(p && strncmp(p, "BOUNDARY 0d02:1 0e02:0 XY(4) 200,0 210,0 210,20 200,20\n",
+                             strlen("BOUNDARY 0d02:1 0e02:0 XY(4) 200,0 210,0 210,20 200,20\n")) == 0,
+                "Rectangles of a repetition");
+    p = find_line(d, "BOUNDARY", 3);
+    TEST_ASSERT(line_has(p, "XY(3) ") && line_has(p, " 1000,0") && line_has(p, " 1030,0"),
+                "CTRAPEZOID becomes triangle");
+    p = find_line(d, "BOUNDARY", 4);
+    char circle[64];
+    snprintf(circle, sizeof(circle), "XY(%d) ", CIRCLE_VERTICES);
+    TEST_ASSERT(line_has(p, circle), "CIRCLE becomes boundary");
+
+    TEST_ASSERT(strstr(d, "ENDSTR\nSTRUCTURE 'B'\n") != NULL, "Structure from CBLOCK");
+    TEST_ASSERT(strstr(d, "AREF 'A' COLROW 4 2 XY(3) 0,0 2000,0 0,1200\n") != NULL,
+                "Array placement becomes aref");
+    TEST_ASSERT(count_lines(d, "SREF 'A' 1a01:0 1c05:90 XY(1) ") == 3 &&
+                strstr(d, "XY(1) 100,200\n") && strstr(d, "XY(1) 110,200\n") &&
+                strstr(d, "XY(1) 130,200\n"), "Irregular repetition is expanded");
+
+    fclose(oas);
+    fclose(gout);
+    free(d);
+}
+
+/*
+ * Test 4: OASIS files with stream_open
+ */
+static void test_stream(void) {
+    printf("\n=== Test 4: Streams ===\n");
+
+    FILE* gin = create_test_library();
+    FILE* f;
+    stream_kind kind = STREAM_PLAIN;
+    char magic[OAS_MAGIC_LEN];
+    char buf[4096];
+    size_t n;
+    char *d0, *d1;
+
+    f = stream_open(LIB_OAS, "wb", &kind);
+    TEST_ASSERT(f != NULL && kind == STREAM_OASIS, "OASIS file opened for writing");
+    if (f == NULL) return;
+    while ((n = fread(buf, 1, sizeof(buf), gin)) > 0)
+        fwrite(buf, 1, n, f);
+    TEST_ASSERT(fclose(f) == 0, "Library converted when closed");
+
+    f = fopen(LIB_OAS, "rb");
+    TEST_ASSERT(f && fread(magic, 1, OAS_MAGIC_LEN, f) == OAS_MAGIC_LEN &&
+                memcmp(magic, OAS_MAGIC, OAS_MAGIC_LEN) == 0, "OASIS file written");
+    if (f) fclose(f);
+
+    kind = STREAM_PLAIN;
+    f = stream_open(LIB_OAS, "rb", &kind);
+    TEST_ASSERT(f != NULL && kind == STREAM_OASIS, "OASIS file detected when reading");
+    if (f == NULL) return;
+    rewind(gin);
+    d0 = dump_library(gin);
+    d1 = dump_library(f);
+    TEST_ASSERT(strcmp(d0, d1) == 0, "Same library from stream");
+    TEST_ASSERT(fseek(f, 0, SEEK_SET) == 0 && fread(magic, 1, 4, f) == 4 &&
+                magic[2] == 0 && magic[3] == 2, "Stream is seekable GDSII");
+
+    fclose(f);
+    fclose(gin);
+    free(d0);
+    free(d1);
+    remove(LIB_OAS);
+}
+
+/*
+ * Test 5: invalid files
+ */
+static void test_invalid(void) {
+    printf("\n=== Test 5: Invalid Files ===\n");
+
+    FILE* in = tmpfile();
+    FILE* out = tmpfile();
+    FILE* oas = create_test_oasis();
+    char buf[4096];
+    size_t n;
+
+    fputs("not an OASIS file", in);
+    rewind(in);
+    TEST_ASSERT(oas_read(in, out) != NULL, "Other files are rejected");
+    fclose(in);
+
+    // without the END record
+    n = fread(buf, 1, sizeof(buf), oas);
+    in = tmpfile();
+    fwrite(buf, 1, n - 256, in);
+    rewind(in);
+    TEST_ASSERT(oas_read(in, out) != NULL, "Truncated file is rejected");
+    fclose(in);
+
+    // invalid CTRAPEZOID type
+    for (size_t k = 0; k + 1 < n; k++) {
+        if (buf[k] == 26 && (uint8_t)buf[k + 1] == 0xd8) {
+            buf[k + 2] = 30;
+            break;
+        }
+    }
+    in = tmpfile();
+    fwrite(buf, 1, n, in);
+    rewind(in);
+    TEST_ASSERT(oas_read(in, out) != NULL, "Invalid record is rejected");
+
+    fclose(in);
+    fclose(out);
+    fclose(oas);
+}
+
+/*
+ * a library with one element (or a 2 x 2 array of S) in structure T
+ */
+static FILE* element_library(uint16_t etype, uint16_t ptype, const int32_t* xy, int n) {
+    FILE* f = tmpfile();
+
+    g_begin(f, "ELLIB");
+    g_structure(f, "S");
+    g_empty(f, ENDSTR);
+    g_structure(f, "T");
+    g_empty(f, etype);
+    if (etype == AREF) {
+        g_string(f, SNAME, "S");
+        write_record_hdr(f, COLROW, 4);
+        write_word(f, 2);
+        write_word(f, 2);
+    }
+    else {
+        g_word(f, LAYER, 1);
+        g_word(f, etype == NODE ? NODETYPE : DATATYPE, 0);
+    }
+    if (etype == PATH) {
+        g_word(f, PATHTYPE, ptype);
+        g_int(f, WIDTH, 10);
+    }
+    g_xy(f, xy, n);
+    g_empty(f, ENDEL);
+    g_empty(f, ENDSTR);
+    g_empty(f, ENDLIB);
+    rewind(f);
+    return f;
+}
+
+/*
+ * Test 6: elements that cannot be converted exactly
+ */
+static void test_rejected(void) {
+    printf("\n=== Test 6: Rejected Elements ===\n");
+
+    static const int32_t node[] = {0,0};
+    static const int32_t path[] = {0,0, 100,0};
+    static const int32_t odd[] = {0,0, 101,0, 0,20};
+    static const int32_t wide[] = {-2000000000,0, 2000000000,0, -2000000000,20};
+    FILE* gin;
+    FILE* out = tmpfile();
+    FILE* f;
+    const char* msg;
+    stream_kind kind;
+    char buf[4096];
+    size_t n;
+    char* d;
+
+    gin = element_library(NODE, 0, node, 1);
+    msg = oas_write(gin, out, 0);
+    TEST_ASSERT(msg && strstr(msg, "node"), "Node element is rejected");
+    fclose(gin);
+
+    gin = element_library(PATH, 1, path, 2);
+    msg = oas_write(gin, out, 0);
+    TEST_ASSERT(msg && strstr(msg, "round ends"), "Path with round ends is rejected");
+    fclose(gin);
+
+    gin = element_library(AREF, 0, odd, 3);
+    msg = oas_write(gin, out, 0);
+    TEST_ASSERT(msg && strstr(msg, "pitch"), "Array with a non-integral pitch is rejected");
+    fclose(gin);
+
+    // the column vector does not fit in 32 bits
+    gin = element_library(AREF, 0, wide, 3);
+    rewind(out);
+    TEST_ASSERT(oas_write(gin, out, 0) == NULL, "Array with a pitch of 2e9 is written");
+    fclose(gin);
+    gin = tmpfile();
+    rewind(out);
+    TEST_ASSERT(oas_read(out, gin) == NULL, "Array with a pitch of 2e9 is read");
+    rewind(gin);
+    d = dump_library(gin);
+    TEST_ASSERT(strstr(d, "XY(3) -2000000000,0 2000000000,0 -2000000000,20\n") != NULL,
+                "Same array after round trip");
+    free(d);
+    fclose(gin);
+    fclose(out);
+
+    // the reason is available after fclose
+    gin = element_library(NODE, 0, node, 1);
+    f = stream_open(LIB_OAS, "wb", &kind);
+    TEST_ASSERT(f != NULL && stream_error() == NULL, "OASIS file opened for writing");
+    if (f == NULL) return;
+    while ((n = fread(buf, 1, sizeof(buf), gin)) > 0)
+        fwrite(buf, 1, n, f);
+    TEST_ASSERT(fclose(f) != 0, "Conversion fails when the stream is closed");
+    msg = stream_error();
+    TEST_ASSERT(msg && strstr(msg, "node"), "Reason of the failed conversion");
+    TEST_ASSERT(fopen(LIB_OAS, "rb") == NULL, "No incomplete OASIS file");
+    fclose(gin);
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - OASIS Conversion Tests ===\n");
+
+    test_roundtrip();
+    test_mapping();
+    test_read();
+    test_stream();
+    test_invalid();
+    test_rejected();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
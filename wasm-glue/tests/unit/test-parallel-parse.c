@@ -0,0 +1,139 @@
+/*
+ * Test Suite: Parallel Structure Parsing
+ *
+ * Tests verify that parse workers (wasm_start_parallel_parse, built with
+ * WASM_THREADS) parse all structures of a library, report their progress
+ * through wasm_get_parsed_structure_count, and produce the same elements
+ * as parsing the structures one after the other.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "wasm-element-cache.h"
+#include "mem-file.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * Structure S<k> holds k + 1 rectangles on layer k; rectangle j is
+ * j wide and k high.
+ */
+#define STRUCTURE_COUNT 64
+
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    char name[16];
+
+    put_library(&b, "PARLIB");
+
+    for (int k = 0; k < STRUCTURE_COUNT; k++) {
+        snprintf(name, sizeof(name), "S%d", k);
+        put_structure(&b, name);
+        for (int j = 0; j <= k; j++) {
+            const int32_t xy[] = {0,0, j,0, j,k, 0,k, 0,0};
+            put_header(&b, BOUNDARY, 0);
+            put_header(&b, LAYER, 2);
+            put_u16(&b, k);
+            put_header(&b, XY, sizeof(xy));
+            for (int i = 0; i < 10; i++) put_i32(&b, xy[i]);
+            put_header(&b, ENDEL, 0);
+        }
+        put_header(&b, ENDSTR, 0);
+    }
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * Test 1: parse workers
+ */
+static void test_parallel(wasm_library_cache_t* cache) {
+    printf("\n=== Test 1: Parse Workers ===\n");
+
+    TEST_ASSERT(wasm_get_parsed_structure_count(cache) == 0, "Nothing parsed yet");
+    int started = wasm_start_parallel_parse(cache, 4);
+#ifdef WASM_THREADS
+    TEST_ASSERT(started == 4, "Four workers started");
+    TEST_ASSERT(wasm_start_parallel_parse(cache, 4) == -1, "Workers already running");
+#else
+    TEST_ASSERT(started == 0, "No workers without threads");
+    wasm_parse_all_data(cache);
+#endif
+    TEST_ASSERT(wasm_wait_parallel_parse(cache) == 0, "Workers finished");
+    TEST_ASSERT(wasm_get_parsed_structure_count(cache) == STRUCTURE_COUNT,
+                "All structures counted");
+
+    int ok = 1;
+    for (int k = 0; k < STRUCTURE_COUNT; k++) {
+        ok = ok && cache->structures[k].is_fully_parsed &&
+             cache->structures[k].element_count == k + 1;
+    }
+    TEST_ASSERT(ok, "All structures parsed");
+}
+
+/*
+ * Test 2: same elements as sequential parsing
+ */
+static void test_elements(wasm_library_cache_t* cache) {
+    printf("\n=== Test 2: Elements ===\n");
+
+    int ok = 1;
+    for (int k = 0; ok && k < STRUCTURE_COUNT; k++) {
+        for (int j = 0; ok && j <= k; j++) {
+            const wasm_cached_element_t* el = &cache->structures[k].elements[j];
+            ok = el->layer == k && el->polygon_count == 1 &&
+                 el->bounds[2] == j && el->bounds[3] == k;
+        }
+    }
+    TEST_ASSERT(ok, "Element layers and bounds");
+    TEST_ASSERT(wasm_start_parallel_parse(cache, 2) >= 0 && wasm_wait_parallel_parse(cache) == 0 &&
+                wasm_get_parsed_structure_count(cache) == STRUCTURE_COUNT,
+                "Parsed structures are not parsed again");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Parallel Parsing Tests ===\n");
+
+    size_t size;
+    uint8_t* data = create_test_library(&size);
+    wasm_library_cache_t* cache = wasm_create_library_cache(data, size);
+    TEST_ASSERT(cache != NULL, "Library cache created");
+    if (!cache) return 1;
+    TEST_ASSERT(wasm_parse_library_structures(cache) == 0 &&
+                cache->structure_count == STRUCTURE_COUNT, "Library structures parsed");
+
+    test_parallel(cache);
+    test_elements(cache);
+
+    wasm_free_library_cache(cache);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
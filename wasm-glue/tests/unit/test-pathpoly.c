@@ -0,0 +1,199 @@
+/*
+ * Test Suite: Path to Polygon Conversion
+ *
+ * Tests verify that paths are converted to closed polygons for all
+ * path types (Basic/gdsio/pathpoly.c): square, round and extended
+ * ends, mitered interior vertices, repeated vertices, batch
+ * conversion, and paths returned as polygons by the flattener.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "pathpoly.h"
+#include "flatten.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_EQ(expected, actual, epsilon, message) \
+    do { \
+        tests_run++; \
+        double diff = fabs((expected) - (actual)); \
+        if (diff < (epsilon)) { \
+            tests_passed++; \
+            printf("  ✓ %s (%.4f)\n", message, (double)(actual)); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s - expected %.4f, got %.4f\n", \
+                   message, (double)(expected), (double)(actual)); \
+        } \
+    } while(0)
+
+/*
+ * signed area of a closed polygon with vertices x[k*stride], y[k*stride]
+ */
+static double polygon_area(const double* x, const double* y, size_t n, size_t stride) {
+    double a = 0.0;
+    size_t k;
+    for (k = 0; k + 1 < n; k++) {
+        a += x[k*stride] * y[(k+1)*stride] - x[(k+1)*stride] * y[k*stride];
+    }
+    return 0.5 * a;
+}
+
+/*
+ * Test 1: path types of a straight path
+ */
+static void test_path_types(void) {
+    printf("\n=== Test 1: Path Types ===\n");
+
+    double x[2] = {0.0, 10.0};
+    double y[2] = {0.0, 0.0};
+    double ext[2] = {1.0, 3.0};
+    double px[128], py[128];
+    size_t n;
+
+    n = pathpoly(x, y, 2, 1, 1.0, 0, NULL, px, py, 1);
+    TEST_ASSERT(n == 5 && n == pathpoly_size(x, y, 2, 1, 0), "Type 0 has 5 vertices");
+    TEST_ASSERT(px[0] == px[n-1] && py[0] == py[n-1], "Polygon is closed");
+    TEST_ASSERT_DOUBLE_EQ(20.0, polygon_area(px, py, n, 1), 1e-9, "Type 0 area");
+
+    n = pathpoly(x, y, 2, 1, 1.0, 1, NULL, px, py, 1);
+    TEST_ASSERT(n == 5 + 2 * PP_ARC_POINTS, "Type 1 has round ends");
+    TEST_ASSERT_DOUBLE_EQ(20.0 + 3.14159265, polygon_area(px, py, n, 1), 0.02, "Type 1 area");
+
+    n = pathpoly(x, y, 2, 1, 1.0, 2, NULL, px, py, 1);
+    TEST_ASSERT_DOUBLE_EQ(24.0, polygon_area(px, py, n, 1), 1e-9, "Type 2 area");
+
+    n = pathpoly(x, y, 2, 1, 1.0, 4, ext, px, py, 1);
+    TEST_ASSERT_DOUBLE_EQ(28.0, polygon_area(px, py, n, 1), 1e-9, "Type 4 area");
+    TEST_ASSERT_DOUBLE_EQ(-1.0, px[0], 1e-9, "Type 4 begin extension");
+}
+
+/*
+ * Test 2: mitered corners and degenerate paths
+ */
+static void test_corners(void) {
+    printf("\n=== Test 2: Corners and Degenerate Paths ===\n");
+
+    // interleaved x,y pairs with a repeated vertex
+    double xy[8] = {0.0, 0.0,  10.0, 0.0,  10.0, 0.0,  10.0, 10.0};
+    double pxy[64];
+    size_t n;
+
+    n = pathpoly(xy, xy + 1, 4, 2, 1.0, 0, NULL, pxy, pxy + 1, 2);
+    TEST_ASSERT(n == 7, "Repeated vertex ignored");
+    TEST_ASSERT_DOUBLE_EQ(40.0, polygon_area(pxy, pxy + 1, n, 2), 1e-9, "L-shaped path area");
+    TEST_ASSERT_DOUBLE_EQ(11.0, pxy[2], 1e-9, "Outer miter x");
+    TEST_ASSERT_DOUBLE_EQ(-1.0, pxy[3], 1e-9, "Outer miter y");
+
+    double pt[4] = {5.0, 5.0, 5.0, 5.0};
+    TEST_ASSERT(pathpoly_size(pt, pt + 2, 2, 1, 0) == 0, "Single point has no polygon");
+}
+
+/*
+ * Test 3: batch conversion
+ */
+static void test_batch(void) {
+    printf("\n=== Test 3: Batch Conversion ===\n");
+
+    double x[5] = {0.0, 10.0,  0.0, 10.0, 10.0};
+    double y[5] = {0.0, 0.0,   0.0, 0.0, 10.0};
+    size_t off[3] = {0, 2, 5};
+    size_t poff[3];
+    double hw[2] = {1.0, 0.5};
+    int ptype[1] = {2};
+    double px[32], py[32];
+
+    pathpoly_offsets(x, y, off, 2, ptype, 1, poff);
+    TEST_ASSERT(poff[1] == 5 && poff[2] == 12, "Polygon offsets");
+    pathpoly_batch(x, y, off, 2, hw, 0, ptype, 1, NULL, 0, poff, px, py);
+    TEST_ASSERT_DOUBLE_EQ(24.0, polygon_area(px, py, 5, 1), 1e-9, "First path area");
+    TEST_ASSERT_DOUBLE_EQ(21.0, polygon_area(px + 5, py + 5, 7, 1), 1e-9, "Second path area");
+}
+
+/*
+ * Test 4: paths returned as polygons by the flattener
+ */
+static void test_flatten(void) {
+    printf("\n=== Test 4: Flattened Path Polygons ===\n");
+
+    fl_library_t lib;
+    fl_options_t opt;
+    fl_result_t res;
+    element_t e;
+    double x[2] = {0.0, 10.0};
+    double y[2] = {0.0, 0.0};
+    double rxy[2] = {100.0, 0.0};
+
+    TEST_ASSERT(fl_library_init(&lib, 2) == FL_OK, "Library created");
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_PATH;
+    e.layer = 1;
+    e.has = HAS_WIDTH | HAS_PTYPE;
+    e.width = 2.0;
+    e.ptype = 2;
+    fl_add_shape(&lib.cell[1], 0, &e);
+    fl_add_vertices(&lib.cell[1], x, y, 2, 1);
+
+    memset(&e, 0, sizeof(e));
+    e.kind = GDS_SREF;
+    e.has = HAS_STRANS | HAS_MAG | HAS_ANGLE;
+    e.strans.mag = 2.0;
+    e.strans.angle = 90.0;
+    fl_add_ref(&lib.cell[0], 0, 1, &e, rxy);
+
+    memset(&opt, 0, sizeof(opt));
+    memset(&res, 0, sizeof(res));
+    opt.max_depth = -1;
+    TEST_ASSERT(fl_flatten(&lib, 0, &opt, &res) == FL_OK, "Flattened with center lines");
+    TEST_ASSERT(res.nlay == 1 && res.lay[0].nxy == 2, "Center line has 2 vertices");
+
+    opt.path_polygons = 1;
+    TEST_ASSERT(fl_flatten(&lib, 0, &opt, &res) == FL_OK, "Flattened with path polygons");
+    TEST_ASSERT(res.nlay == 1 && res.lay[0].nxy == 5 && res.ins[0].npoly == 1,
+                "Path polygon has 5 vertices");
+    if (res.nlay == 1 && res.lay[0].nxy == 5) {
+        TEST_ASSERT_DOUBLE_EQ(96.0, polygon_area(res.lay[0].xy, res.lay[0].xy + 1, 5, 2),
+                              1e-9, "Transformed path polygon area");
+    }
+
+    fl_result_free(&res);
+    fl_library_free(&lib);
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Path Polygon Tests ===\n");
+
+    test_path_types();
+    test_corners();
+    test_batch();
+    test_flatten();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
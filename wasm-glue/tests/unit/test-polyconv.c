@@ -0,0 +1,213 @@
+/*
+ * Test Suite: Parallel Path Conversion
+ *
+ * Tests verify that paths grouped by structure are converted to
+ * polygons in parallel (Basic/gdsio/polyconv.c): the vertex counts
+ * and polygons are identical to those of the path-to-polygon kernel
+ * (pathpoly.c) for any number of threads, paths without a polygon
+ * are reported with 0 vertices, and empty groups are handled.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pathpoly.h"
+#include "polyconv.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define NGROUP  40
+#define NPATH   (NGROUP * 25)
+
+static double* vert[NPATH];
+static pc_path_t paths[NPATH];
+static size_t first[NGROUP + 1];
+
+/*
+ * paths with different vertex numbers, widths and types; every
+ * group has 25 paths, except that group 3 is empty and the last
+ * group takes its paths
+ */
+static void make_paths(void) {
+    static const int ptypes[4] = {0, 1, 2, 4};
+    size_t k, j, nv;
+    int g;
+
+    for (k = 0; k < NPATH; k++) {
+        nv = 2 + (k * 37) % 300;
+        vert[k] = malloc(2 * nv * sizeof(double));
+        for (j = 0; j < nv; j++) {
+            vert[k][j] = 10.0 * j + k;                 // x column
+            vert[k][nv + j] = (j % 2) * 3.0 + 0.5 * k; // y column
+        }
+        if (k % 97 == 0)  // all vertices equal: no polygon
+            for (j = 0; j < nv; j++) {
+                vert[k][j] = 1.0;
+                vert[k][nv + j] = 2.0;
+            }
+        memset(&paths[k], 0, sizeof(pc_path_t));
+        paths[k].xy = vert[k];
+        paths[k].nv = nv;
+        paths[k].hw = 0.5 + (k % 5);
+        paths[k].ptype = ptypes[k % 4];
+        paths[k].ext[0] = 1.5;
+        paths[k].ext[1] = 2.5;
+    }
+
+    for (g = 0, k = 0; g < NGROUP; g++) {
+        first[g] = k;
+        if (g != 3)
+            k += 25;
+    }
+    first[NGROUP] = NPATH;
+}
+
+static void free_paths(void) {
+    size_t k;
+    for (k = 0; k < NPATH; k++) {
+        free(vert[k]);
+        free(paths[k].pxy);
+        paths[k].pxy = NULL;
+    }
+}
+
+/*
+ * converts all paths and compares with the sequential kernel
+ */
+static int convert_and_check(int nthreads, size_t* nempty) {
+    size_t k, np, nw;
+    double* ref;
+    int ok = 1;
+
+    for (k = 0; k < NPATH; k++) {
+        free(paths[k].pxy);
+        paths[k].pxy = NULL;
+        paths[k].np = 12345;
+    }
+
+    polyconv_size(paths, first, NGROUP, nthreads);
+    for (k = 0; k < NPATH; k++)
+        if (paths[k].np)
+            paths[k].pxy = malloc(2 * paths[k].np * sizeof(double));
+    polyconv_paths(paths, first, NGROUP, nthreads);
+
+    *nempty = 0;
+    for (k = 0; k < NPATH; k++) {
+        np = pathpoly_size(vert[k], vert[k] + paths[k].nv, paths[k].nv, 1, paths[k].ptype);
+        if (np != paths[k].np) {
+            ok = 0;
+            break;
+        }
+        if (np == 0) {
+            *nempty += 1;
+            continue;
+        }
+        ref = malloc(2 * np * sizeof(double));
+        nw = pathpoly(vert[k], vert[k] + paths[k].nv, paths[k].nv, 1, paths[k].hw,
+                      paths[k].ptype, paths[k].ext, ref, ref + np, 1);
+        if (nw != np || memcmp(ref, paths[k].pxy, 2 * np * sizeof(double)))
+            ok = 0;
+        free(ref);
+        if (!ok)
+            break;
+    }
+
+    return ok;
+}
+
+/*
+ * Test: conversion with one and several threads
+ */
+static void test_threads(void) {
+    size_t nvert = 0, nempty, k;
+
+    printf("\nTest: Conversion with one and several threads\n");
+
+    make_paths();
+    for (k = 0; k < NPATH; k++)
+        nvert += paths[k].nv;
+    TEST_ASSERT(nvert >= PC_MIN_PARALLEL, "Paths have enough vertices for parallel conversion");
+
+    TEST_ASSERT(convert_and_check(1, &nempty), "One thread matches the path kernel");
+    TEST_ASSERT(nempty == (NPATH + 96) / 97, "Paths without distinct vertices have no polygon");
+    TEST_ASSERT(convert_and_check(4, &nempty), "Four threads match the path kernel");
+    TEST_ASSERT(convert_and_check(64, &nempty), "More threads than needed match the path kernel");
+    TEST_ASSERT(convert_and_check(0, &nempty), "One thread per processor matches the path kernel");
+
+    free_paths();
+}
+
+/*
+ * Test: small batches and empty groups
+ */
+static void test_small(void) {
+    pc_path_t p[2];
+    double xy[8] = {0.0, 10.0, 10.0, 20.0,   // x
+                    0.0, 0.0, 10.0, 10.0};   // y
+    size_t fg[4] = {0, 0, 2, 2};
+    size_t f0[1] = {0};
+
+    printf("\nTest: Small batches\n");
+
+    memset(p, 0, sizeof(p));
+    p[0].xy = xy;
+    p[0].nv = 4;
+    p[0].hw = 1.0;
+    p[1] = p[0];
+    p[1].ptype = 2;
+
+    polyconv_size(p, fg, 3, 8);
+    TEST_ASSERT(p[0].np == pathpoly_size(xy, xy + 4, 4, 1, 0) && p[0].np > 0,
+                "Vertex count of a type 0 path");
+    TEST_ASSERT(p[1].np == p[0].np, "Type 2 path has the same vertex count");
+
+    p[0].pxy = malloc(2 * p[0].np * sizeof(double));
+    p[1].pxy = malloc(2 * p[1].np * sizeof(double));
+    polyconv_paths(p, fg, 3, 8);
+    TEST_ASSERT(p[0].pxy[0] == 0.0 && p[0].pxy[p[0].np] == -1.0,
+                "First polygon vertex of a type 0 path");
+    TEST_ASSERT(p[1].pxy[0] == -1.0 && p[1].pxy[p[1].np] == -1.0,
+                "First polygon vertex of a type 2 path is extended");
+    free(p[0].pxy);
+    free(p[1].pxy);
+
+    p[0].np = 7;
+    polyconv_size(p, f0, 0, 4);
+    polyconv_paths(p, f0, 0, 4);
+    TEST_ASSERT(p[0].np == 7, "Empty batch leaves the paths unchanged");
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Parallel Path Conversion Tests\n");
+    printf("========================================\n");
+
+    test_threads();
+    test_small();
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
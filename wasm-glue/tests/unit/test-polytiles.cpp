@@ -0,0 +1,257 @@
+/*
+ * Test Suite: Tiled Polygon Operations
+ *
+ * Tests verify the tiled execution of Boolean operations in
+ * Boolean/polytiles.cpp used by poly_boolmex and poly_offsetmex:
+ * for Manhattan polygons the merged result of and, or, notb and
+ * xor computed in tiles must cover exactly the same area as the
+ * result of a single Clipper call, for even-odd and non-zero
+ * filling, with polygons crossing tile borders, overlapping
+ * polygons within one operand, polygons with holes, polygons that
+ * only touch a tile, and any number of tiles and threads.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <vector>
+
+#include "clipper.hpp"
+#include "polytiles.hpp"
+
+using namespace ClipperLib;
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+struct tile_op {
+    ClipType op;
+    PolyFillType fill;
+};
+
+static const struct {
+    const char* name;
+    ClipType op;
+} ops[] = {
+    {"and",  ctIntersection},
+    {"or",   ctUnion},
+    {"notb", ctDifference},
+    {"xor",  ctXor},
+};
+
+// boolean operation on the polygons of one tile (as in poly_boolmex)
+static bool clip_tile(Clipper &T, Paths &a, Paths &b, const Path &rect, PolyTree &res, void *arg) {
+    tile_op *top = (tile_op *)arg;
+    (void)rect;
+    T.AddPaths(a, ptSubject, true);
+    T.AddPaths(b, ptClip, true);
+    return T.Execute(top->op, res, top->fill, top->fill);
+}
+
+static unsigned int seed = 12345;
+
+static int rnd(int n) {
+    seed = seed * 1103515245u + 12345u;
+    return (int)((seed >> 16) % (unsigned int)n);
+}
+
+static Path rect(cInt x0, cInt y0, cInt x1, cInt y1) {
+    Path p(4);
+    p[0] = IntPoint(x0, y0);
+    p[1] = IntPoint(x1, y0);
+    p[2] = IntPoint(x1, y1);
+    p[3] = IntPoint(x0, y1);
+    return p;
+}
+
+// an L shaped polygon
+static Path ell(cInt x, cInt y, cInt w, cInt h, cInt t) {
+    Path p(6);
+    p[0] = IntPoint(x, y);
+    p[1] = IntPoint(x + w, y);
+    p[2] = IntPoint(x + w, y + t);
+    p[3] = IntPoint(x + t, y + t);
+    p[4] = IntPoint(x + t, y + h);
+    p[5] = IntPoint(x, y + h);
+    return p;
+}
+
+// Manhattan polygons; many of them overlap each other
+static void make_operand(Paths &P, int n, cInt size) {
+    cInt x, y, w, h;
+    int k;
+
+    for (k = 0; k < n; k++) {
+        x = rnd((int)size);
+        y = rnd((int)size);
+        w = 1 + rnd((int)size / (k % 5 ? 10 : 2));   // some cross many tiles
+        h = 1 + rnd((int)size / (k % 7 ? 10 : 2));
+        if (k % 3)
+            P.push_back(rect(x, y, x + w, y + h));
+        else
+            P.push_back(ell(x, y, w + 4, h + 4, 1 + rnd(4)));
+    }
+}
+
+// net area of polygons with holes
+static double area(const Paths &P) {
+    double a = 0.0;
+    for (size_t k = 0; k < P.size(); k++)
+        a += Area(P[k]);
+    return a;
+}
+
+// area of the exclusive or of two results
+static double xor_area(const Paths &P, const Paths &Q) {
+    Clipper C;
+    Paths R;
+
+    C.AddPaths(P, ptSubject, true);
+    C.AddPaths(Q, ptClip, true);
+    C.Execute(ctXor, R, pftNonZero, pftNonZero);
+    return fabs(area(R));
+}
+
+/*
+ * compares tiled and untiled results for all operations
+ */
+static void compare(const Paths &pa, const Paths &pb, PolyFillType fill,
+                    int nx, int ny, int nthreads, const char* label) {
+    Paths ref, tiled;
+    char msg[160];
+    bool ok;
+    int k;
+
+    for (k = 0; k < 4; k++) {
+        Clipper C;
+        tile_op top = {ops[k].op, fill};
+
+        ref.clear();
+        tiled.clear();
+        C.AddPaths(pa, ptSubject, true);
+        C.AddPaths(pb, ptClip, true);
+        C.Execute(ops[k].op, ref, fill, fill);
+        ok = TiledExecute(pa, pb, nx, ny, 0, fill, nthreads, clip_tile, &top, tiled);
+
+        snprintf(msg, sizeof(msg), "%s, %s, %dx%d tiles, %d threads: same area (%.0f)",
+                 label, ops[k].name, nx, ny, nthreads, area(ref));
+        TEST_ASSERT(ok && area(ref) > 0.0 && area(tiled) == area(ref), msg);
+        snprintf(msg, sizeof(msg), "%s, %s, %dx%d tiles, %d threads: no exclusive or",
+                 label, ops[k].name, nx, ny, nthreads);
+        TEST_ASSERT(ok && xor_area(ref, tiled) == 0.0, msg);
+    }
+}
+
+/*
+ * Test: a few polygons crossing the tile borders
+ */
+static void test_borders(void) {
+    Paths pa, pb;
+
+    printf("\nTest: Polygons crossing tile borders\n");
+
+    // bounding box 0..100: tile borders at 25, 50, 75 for 4 tiles
+    pa.push_back(rect(0, 0, 60, 60));
+    pa.push_back(rect(40, 40, 100, 100));     // overlaps the first one
+    pa.push_back(rect(10, 70, 90, 80));
+    pb.push_back(rect(25, 0, 50, 100));       // edges on tile borders
+    pb.push_back(rect(20, 20, 80, 30));
+    pb.push_back(ell(55, 5, 40, 40, 10));
+
+    compare(pa, pb, pftNonZero, 4, 4, 1, "non-zero");
+    compare(pa, pb, pftEvenOdd, 4, 4, 1, "even-odd");
+    compare(pa, pb, pftNonZero, 3, 7, 2, "non-zero");
+}
+
+/*
+ * Test: a polygon with a hole and a polygon in the hole
+ */
+static void test_holes(void) {
+    Paths pa, pb;
+    Path hole = rect(30, 30, 70, 70);
+
+    printf("\nTest: Polygons with holes\n");
+
+    ReversePath(hole);
+    pa.push_back(rect(0, 0, 100, 100));
+    pa.push_back(hole);
+    pa.push_back(rect(45, 45, 55, 55));
+    pb.push_back(rect(20, 40, 80, 60));
+
+    compare(pa, pb, pftNonZero, 5, 5, 1, "hole");
+    compare(pa, pb, pftNonZero, 8, 3, 4, "hole");
+}
+
+/*
+ * Test: many overlapping Manhattan polygons
+ */
+static void test_random(void) {
+    Paths pa, pb;
+
+    printf("\nTest: Overlapping Manhattan polygons\n");
+
+    make_operand(pa, 400, 10000);
+    make_operand(pb, 300, 10000);
+
+    compare(pa, pb, pftNonZero, 1, 1, 1, "random non-zero");
+    compare(pa, pb, pftNonZero, 7, 5, 1, "random non-zero");
+    compare(pa, pb, pftNonZero, 16, 16, 4, "random non-zero");
+    compare(pa, pb, pftEvenOdd, 7, 5, 1, "random even-odd");
+    compare(pa, pb, pftEvenOdd, 16, 16, 4, "random even-odd");
+}
+
+/*
+ * Test: empty operands
+ */
+static void test_empty(void) {
+    Paths pa, pb, pc;
+    tile_op top = {ctUnion, pftNonZero};
+
+    printf("\nTest: Empty operands\n");
+
+    TEST_ASSERT(TiledExecute(pa, pb, 4, 4, 0, pftNonZero, 1, clip_tile, &top, pc) && pc.empty(),
+                "Empty operands give an empty result");
+    pa.push_back(rect(0, 0, 10, 10));
+    TEST_ASSERT(TiledExecute(pa, pb, 4, 4, 0, pftNonZero, 2, clip_tile, &top, pc) &&
+                area(pc) == 100.0, "Union with an empty operand");
+
+    // the first polygon ends on the border of the second tile, which
+    // contains nothing else
+    pa.clear();
+    pc.clear();
+    pa.push_back(rect(0, 0, 25, 10));
+    pa.push_back(rect(80, 0, 100, 10));
+    TEST_ASSERT(TiledExecute(pa, pb, 4, 1, 0, pftNonZero, 1, clip_tile, &top, pc) &&
+                area(pc) == 450.0, "Tile with a polygon touching only its border");
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - Tiled Polygon Operation Tests ===\n");
+
+    test_borders();
+    test_holes();
+    test_random();
+    test_empty();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,244 @@
+/*
+ * Test Suite: Library Snapshots
+ *
+ * Tests verify that a snapshot written by gds_save_snapshot loads into a
+ * library with the same structures and elements without parsing, that
+ * the loaded library supports the hierarchy functions, and that invalid
+ * snapshots and incomplete libraries are rejected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "gds-wasm-adapter.h"
+#include "wasm-element-cache.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * CELL holds a rectangle with a property and a path of width 4. TOP
+ * holds a text and a reference to CELL. EMPTY has no elements.
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t rect[] = {0,0, 4,0, 4,2, 0,2, 0,0};
+    const int32_t path[] = {0,10, 20,10, 20,30};
+    const int32_t pos[] = {100, 50};
+
+    put_library(&b, "SNAPLIB");
+
+    put_structure(&b, "CELL");
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 3);
+    put_xy(&b, rect, 5);
+    put_header(&b, PROPATTR, 2);
+    put_u16(&b, 7);
+    put_string(&b, PROPVALUE, "net1");
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, PATH, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 2);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_header(&b, WIDTH, 4);
+    put_i32(&b, 4);
+    put_xy(&b, path, 3);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "TOP");
+    put_header(&b, TEXT, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 5);
+    put_header(&b, TEXTTYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, pos, 1);
+    put_string(&b, STRING, "hello");
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, SREF, 0);
+    put_string(&b, SNAME, "CELL");
+    put_xy(&b, pos, 1);
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_structure(&b, "EMPTY");
+    put_header(&b, ENDSTR, 0);
+
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+// loads a snapshot; returns the library or NULL
+static void* load_snapshot(const uint8_t* snap, size_t size) {
+    void* lib = gds_load_snapshot_begin(size);
+    if (!lib) return NULL;
+    memcpy(gds_load_snapshot_buffer(lib), snap, size);
+    if (gds_load_snapshot_end(lib) != 0) {
+        gds_free_library(lib);
+        return NULL;
+    }
+    return lib;
+}
+
+/*
+ * Test 1: save and load
+ */
+static void test_round_trip(void* lib, uint8_t** out, int* out_size) {
+    printf("\n=== Test 1: Save and Load ===\n");
+
+    int size = gds_save_snapshot(lib);
+    const uint8_t* buf = gds_get_snapshot_buffer(lib);
+    TEST_ASSERT(size > 0 && buf != NULL, "Snapshot written");
+    if (size <= 0 || !buf) return;
+
+    // the caller stores a copy of the snapshot
+    uint8_t* snap = malloc((size_t)size);
+    memcpy(snap, buf, (size_t)size);
+    gds_free_snapshot(lib);
+    TEST_ASSERT(gds_get_snapshot_buffer(lib) == NULL, "Snapshot buffer released");
+    *out = snap;
+    *out_size = size;
+
+    void* copy = load_snapshot(snap, (size_t)size);
+    TEST_ASSERT(copy != NULL, "Snapshot loaded");
+    if (!copy) return;
+
+    TEST_ASSERT(strcmp(gds_get_library_name(copy), "SNAPLIB") == 0 &&
+                gds_get_structure_count(copy) == 3, "Library metadata");
+    TEST_ASSERT(strcmp(gds_get_structure_name(copy, 1), "TOP") == 0 &&
+                gds_get_element_count(copy, 0) == 2 && gds_get_element_count(copy, 1) == 2 &&
+                gds_get_element_count(copy, 2) == 0, "Structures");
+
+    const double* xy = gds_get_element_polygon_vertices(copy, 0, 0, 0);
+    TEST_ASSERT(gds_get_element_data_type(copy, 0, 0) == 3 &&
+                gds_get_element_polygon_vertex_count(copy, 0, 0, 0) == 5 &&
+                xy && xy[2] == 4.0 && xy[5] == 2.0, "Boundary");
+    TEST_ASSERT(gds_get_element_property_count(copy, 0, 0) == 1 &&
+                strcmp(gds_get_element_property_value(copy, 0, 0, 0), "net1") == 0, "Property");
+    TEST_ASSERT(gds_get_element_path_width(copy, 0, 1) == 4.0f &&
+                gds_get_element_polygon_vertex_count(copy, 0, 1, 0) == 3, "Path");
+    TEST_ASSERT(strcmp(gds_get_element_text(copy, 1, 0), "hello") == 0 &&
+                strcmp(gds_get_element_reference_name(copy, 1, 1), "CELL") == 0,
+                "Text and reference");
+
+    int words = gds_get_instance_table(copy);
+    const int32_t* t = gds_get_instance_table_buffer(copy);
+    TEST_ASSERT(words > 0 && t && t[GDS_INST_COUNT] == 1 && t[t[GDS_INST_CELLS]] == 0,
+                "References resolved");
+
+    gds_free_library(copy);
+}
+
+/*
+ * Test 2: invalid snapshots
+ */
+static void test_invalid(const uint8_t* snap, int size) {
+    printf("\n=== Test 2: Invalid Snapshots ===\n");
+
+    uint8_t* bad = malloc((size_t)size);
+
+    memcpy(bad, snap, (size_t)size);
+    bad[0] ^= 1;
+    TEST_ASSERT(load_snapshot(bad, (size_t)size) == NULL, "Wrong magic rejected");
+
+    memcpy(bad, snap, (size_t)size);
+    bad[8] += 1;
+    TEST_ASSERT(load_snapshot(bad, (size_t)size) == NULL, "Other version rejected");
+
+    TEST_ASSERT(load_snapshot(snap, (size_t)size / 2) == NULL, "Truncated snapshot rejected");
+
+    // a pointer of the first arena that points past its end
+    memcpy(bad, snap, (size_t)size);
+    void* copy = load_snapshot(bad, (size_t)size);
+    TEST_ASSERT(copy != NULL, "Copy loads");
+    if (copy) gds_free_library(copy);
+    // the first arena starts with the boundary of CELL, found by its bounds
+    const int32_t bounds[4] = {0, 0, 4, 2};
+    size_t arena = (size_t)size;
+    for (size_t k = offsetof(wasm_cached_element_t, bounds); k + sizeof(bounds) <= (size_t)size; k += 4) {
+        if (memcmp(bad + k, bounds, sizeof(bounds)) == 0) {
+            arena = k - offsetof(wasm_cached_element_t, bounds);
+            break;
+        }
+    }
+    wasm_cached_element_t el;
+    memcpy(&el, bad + arena, sizeof(el));
+    el.polygons = (wasm_polygon_t*)(uintptr_t)(1 << 20);
+    memcpy(bad + arena, &el, sizeof(el));
+    TEST_ASSERT(arena < (size_t)size && load_snapshot(bad, (size_t)size) == NULL,
+                "Pointer outside the arena rejected");
+
+    TEST_ASSERT(gds_load_snapshot_begin(4) == NULL, "Too small for a snapshot");
+    free(bad);
+}
+
+/*
+ * Test 3: incomplete stream
+ */
+static void test_stream(const uint8_t* data, size_t size) {
+    printf("\n=== Test 3: Incomplete Stream ===\n");
+
+    void* lib = gds_stream_begin(size);
+    memcpy(gds_stream_reserve(lib, size - 4), data, size - 4);
+    gds_stream_commit(lib, size - 4);
+    TEST_ASSERT(gds_save_snapshot(lib) == -1, "No snapshot before ENDLIB");
+    memcpy(gds_stream_reserve(lib, 4), data + size - 4, 4);
+    gds_stream_commit(lib, 4);
+    TEST_ASSERT(gds_save_snapshot(lib) > 0, "Snapshot of the complete stream");
+    gds_free_library(lib);
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Snapshot Tests ===\n");
+
+    size_t size;
+    int err;
+    uint8_t* data = create_test_library(&size);
+    void* lib = gds_parse_from_memory(data, size, &err);
+    TEST_ASSERT(lib != NULL && err == 0, "Library parsed");
+    if (!lib) return 1;
+
+    uint8_t* snap = NULL;
+    int snap_size = 0;
+    test_round_trip(lib, &snap, &snap_size);
+    if (snap) test_invalid(snap, snap_size);
+    test_stream(data, size);
+
+    free(snap);
+    gds_free_library(lib);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
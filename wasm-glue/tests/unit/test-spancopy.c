@@ -0,0 +1,259 @@
+/*
+ * Test Suite: Structure Span Copying
+ *
+ * Tests verify that structures are copied from a library file to
+ * an output stream (Basic/gdsio/spancopy.c): the copied bytes are
+ * identical to the structure in the library, data written to the
+ * stream before and after a copy stay in order, large structures
+ * are copied through the buffer in several blocks, streams without
+ * a file descriptor are supported, and spans that do not begin with
+ * BGNSTR or end with ENDSTR are rejected.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "gdsio.h"
+#include "spancopy.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define LIB_IN  "/tmp/test-spancopy-in.gds"
+#define LIB_OUT "/tmp/test-spancopy-out.gds"
+#define NSTRUCT 3
+
+static uint64_t offset[NSTRUCT];
+static uint64_t nbytes[NSTRUCT];
+static uint8_t* lib;
+static size_t lib_size;
+
+/*
+ * library with a small, a large (> 1 MB) and another small structure
+ */
+static void make_library(void) {
+    FILE* fob;
+    uint16_t date[12] = {114, 1, 1, 0, 0, 0, 114, 1, 1, 0, 0, 0};
+    int32_t xy[10];
+    int k, n, nel;
+
+    fob = fopen(LIB_IN, "wb");
+    write_record_hdr(fob, HEADER, 2);
+    write_word(fob, 7);
+    for (k = 0; k < NSTRUCT; k++) {
+        offset[k] = (uint64_t)ftell(fob);
+        write_record_hdr(fob, BGNSTR, sizeof(date));
+        write_word_n(fob, date, 12);
+        write_record_hdr(fob, STRNAME, 2);
+        write_string(fob, k == 1 ? "BB" : (k ? "CC" : "AA"), 2);
+        nel = k == 1 ? 20000 : 3;
+        for (n = 0; n < nel; n++) {
+            xy[0] = n;      xy[1] = k;
+            xy[2] = n + 10; xy[3] = k;
+            xy[4] = n + 10; xy[5] = k + 10;
+            xy[6] = n;      xy[7] = k + 10;
+            xy[8] = n;      xy[9] = k;
+            write_record_hdr(fob, BOUNDARY, 0);
+            write_record_hdr(fob, LAYER, 2);
+            write_word(fob, (uint16_t)k);
+            write_record_hdr(fob, DATATYPE, 2);
+            write_word(fob, 0);
+            write_record_hdr(fob, XY, sizeof(xy));
+            write_int_n(fob, xy, 10);
+            write_record_hdr(fob, ENDEL, 0);
+        }
+        write_record_hdr(fob, ENDSTR, 0);
+        nbytes[k] = (uint64_t)ftell(fob) - offset[k];
+    }
+    write_record_hdr(fob, ENDLIB, 0);
+    fclose(fob);
+
+    fob = fopen(LIB_IN, "rb");
+    fseek(fob, 0L, SEEK_END);
+    lib_size = (size_t)ftell(fob);
+    fseek(fob, 0L, SEEK_SET);
+    lib = malloc(lib_size);
+    if (fread(lib, 1, lib_size, fob) != lib_size)
+        lib_size = 0;
+    fclose(fob);
+}
+
+static const int order[NSTRUCT] = {2, 0, 1};
+
+/*
+ * writes a marker, structures 2, 0, 1, and another marker
+ */
+static const char* write_spans(FILE* fob) {
+    span_src_t src;
+    const char* msg = NULL;
+    int k;
+
+    memset(&src, 0, sizeof(span_src_t));
+    fwrite("HEAD", 1, 4, fob);
+    for (k = 0; k < NSTRUCT && !msg; k++)
+        msg = span_copy(fob, &src, LIB_IN, offset[order[k]], nbytes[order[k]]);
+    fwrite("TAIL", 1, 4, fob);
+    span_close(&src);
+
+    return msg;
+}
+
+/*
+ * checks the output of write_spans
+ */
+static int check_output(const uint8_t* out, size_t nout) {
+    size_t pos = 4;
+    int k;
+
+    if (out == NULL || nout != 8 + offset[NSTRUCT-1] + nbytes[NSTRUCT-1] - offset[0])
+        return 0;
+    if (memcmp(out, "HEAD", 4))
+        return 0;
+    for (k = 0; k < NSTRUCT; k++) {
+        if (memcmp(out + pos, lib + offset[order[k]], nbytes[order[k]]))
+            return 0;
+        pos += nbytes[order[k]];
+    }
+    return !memcmp(out + pos, "TAIL", 4);
+}
+
+static uint8_t* read_file(const char* fname, size_t* n) {
+    FILE* fob = fopen(fname, "rb");
+    uint8_t* p;
+    fseek(fob, 0L, SEEK_END);
+    *n = (size_t)ftell(fob);
+    fseek(fob, 0L, SEEK_SET);
+    p = malloc(*n ? *n : 1);
+    if (fread(p, 1, *n, fob) != *n)
+        *n = 0;
+    fclose(fob);
+    return p;
+}
+
+/*
+ * Test: copying to a file
+ */
+static void test_file(void) {
+    FILE* fob;
+    span_src_t src;
+    const char* msg;
+    uint8_t* out;
+    size_t nout;
+
+    printf("\nTest: Copying to a file\n");
+
+    TEST_ASSERT(nbytes[1] > (1 << 20), "Large structure is larger than the copy buffer");
+
+    // a small stream buffer makes sure that buffered data are flushed
+    fob = fopen(LIB_OUT, "wb");
+    setvbuf(fob, NULL, _IOFBF, 64);
+    msg = write_spans(fob);
+    fclose(fob);
+    TEST_ASSERT(msg == NULL, "Structures are copied");
+
+    out = read_file(LIB_OUT, &nout);
+    TEST_ASSERT(check_output(out, nout), "Output contains markers and structures in order");
+    free(out);
+
+    // stream position follows the copied data
+    fob = fopen(LIB_OUT, "wb");
+    memset(&src, 0, sizeof(span_src_t));
+    fwrite("HEAD", 1, 4, fob);
+    msg = span_copy(fob, &src, LIB_IN, offset[1], nbytes[1]);
+    TEST_ASSERT(msg == NULL && ftell(fob) == (long)(4 + nbytes[1]),
+                "Stream position is after the copied structure");
+    span_close(&src);
+    fclose(fob);
+}
+
+/*
+ * Test: copying to a stream without file descriptor
+ */
+static void test_memory(void) {
+    FILE* fob;
+    char* buf = NULL;
+    size_t n = 0;
+    const char* msg;
+
+    printf("\nTest: Copying to a memory stream\n");
+
+    fob = open_memstream(&buf, &n);
+    TEST_ASSERT(fob != NULL, "Memory stream is opened");
+    if (fob == NULL)
+        return;
+    msg = write_spans(fob);
+    fclose(fob);
+    TEST_ASSERT(msg == NULL, "Structures are copied through the buffer");
+    TEST_ASSERT(check_output((uint8_t*)buf, n), "Memory stream has the expected contents");
+    free(buf);
+}
+
+/*
+ * Test: invalid spans
+ */
+static void test_errors(void) {
+    FILE* fob;
+    span_src_t src;
+    const char* msg;
+
+    printf("\nTest: Invalid spans\n");
+
+    fob = fopen(LIB_OUT, "wb");
+    memset(&src, 0, sizeof(span_src_t));
+
+    msg = span_copy(fob, &src, LIB_IN, offset[0] + 4, nbytes[0]);
+    TEST_ASSERT(msg != NULL && strstr(msg, "BGNSTR"), "Span must begin with BGNSTR");
+    msg = span_copy(fob, &src, LIB_IN, offset[0], nbytes[0] - 4);
+    TEST_ASSERT(msg != NULL && strstr(msg, "ENDSTR"), "Span must end with ENDSTR");
+    msg = span_copy(fob, &src, LIB_IN, offset[2], nbytes[2] + 100);
+    TEST_ASSERT(msg != NULL, "Span beyond the end of the file is rejected");
+    TEST_ASSERT(ftell(fob) == 0, "Nothing is written for invalid spans");
+    msg = span_copy(fob, &src, "/tmp/test-spancopy-missing.gds", offset[0], nbytes[0]);
+    TEST_ASSERT(msg != NULL, "Missing library file is reported");
+    msg = span_copy(fob, &src, LIB_IN, offset[0], nbytes[0]);
+    TEST_ASSERT(msg == NULL, "Library file is opened again after an error");
+
+    span_close(&src);
+    fclose(fob);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Structure Span Copying Tests\n");
+    printf("========================================\n");
+
+    make_library();
+    test_file();
+    test_memory();
+    test_errors();
+
+    remove(LIB_IN);
+    remove(LIB_OUT);
+    free(lib);
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
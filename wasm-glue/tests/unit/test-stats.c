@@ -0,0 +1,253 @@
+/*
+ * Test Suite: I/O and Parse Statistics
+ *
+ * Tests verify the counters that are compiled in with GDS_STATS:
+ * the records, bytes, vertices and elements counted when elements are
+ * encoded (Basic/gdsio/elwrite.c) and when records are read from a
+ * memory mapped library (mapio.h), and the parse statistics of a
+ * library cache (wasm_get_parse_stats), also with parse workers.
+ */
+
+#define _POSIX_C_SOURCE 199309L   // for clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "gdsio.h"
+#include "mapio.h"
+#include "elwrite.h"
+#include "gdsstats.h"
+#include "wasm-element-cache.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define RT(r) ((r) >> 8)
+
+/*
+ * the counters are defined in mexfuncs.c for the mex functions
+ */
+gds_stats_t gds_stats;
+
+void stats_flush(void) {
+    memset(&gds_stats, 0, sizeof(gds_stats));
+}
+
+uint64_t stats_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * a boundary with 5 and a path with 3 vertices
+ */
+static int encode_test_elements(ew_buffer_t* wb) {
+    static const double bxy[] = {0,1,1,0,0, 0,0,1,1,0};
+    static const double pxy[] = {0,2,4, 0,0,1};
+    ew_element_t el[2];
+    ew_xy_t xy[2];
+    ew_list_t ls;
+
+    memset(el, 0, sizeof(el));
+    memset(&ls, 0, sizeof(ls));
+    el[0].el.kind = GDS_BOUNDARY;
+    el[0].xy = 0;
+    el[0].nxy = 1;
+    el[1].el.kind = GDS_PATH;
+    el[1].el.width = 0.1;
+    el[1].xy = 1;
+    el[1].nxy = 1;
+    xy[0].xy = bxy;
+    xy[0].m = 5;
+    xy[1].xy = pxy;
+    xy[1].m = 3;
+    ls.el = el;   ls.nel = 2; ls.ael = 2;
+    ls.xy = xy;   ls.nxy = 2; ls.axy = 2;
+
+    memset(wb, 0, sizeof(ew_buffer_t));
+    return encode_elements(wb, &ls, 1000.0, 0);
+}
+
+/*
+ * Test 1: counters of encoded elements
+ */
+static void test_write(void) {
+    printf("\n=== Test 1: Writing ===\n");
+
+    ew_buffer_t wb;
+    stats_flush();
+    TEST_ASSERT(encode_test_elements(&wb) == 0, "Elements encoded");
+
+    TEST_ASSERT(gds_stats.el_written[GDS_BOUNDARY] == 1 && gds_stats.el_written[GDS_PATH] == 1,
+                "Elements counted by kind");
+    TEST_ASSERT(gds_stats.count[ST_VERT_WRITTEN] == 8, "Vertices counted");
+    TEST_ASSERT(gds_stats.rec_written[RT(BOUNDARY)] == 1 && gds_stats.rec_written[RT(PATH)] == 1 &&
+                gds_stats.rec_written[RT(XY)] == 2 && gds_stats.rec_written[RT(ENDEL)] == 2,
+                "Records counted by type");
+    TEST_ASSERT(gds_stats.count[ST_BYTES_WRITTEN] == wb.size, "Bytes counted");
+
+    uint64_t n = 0;
+    for (int k = 0; k < ST_NRTYPE; k++) n += gds_stats.rec_written[k];
+    TEST_ASSERT(n == gds_stats.count[ST_REC_WRITTEN], "Records by type add up");
+    TEST_ASSERT(gds_stats.count[ST_ALLOC] > 0 && gds_stats.count[ST_ALLOC_BYTES] >= wb.size,
+                "Buffer allocations counted");
+
+    ew_buffer_free(&wb);
+}
+
+/*
+ * Test 2: counters of records read
+ */
+static void test_read(void) {
+    printf("\n=== Test 2: Reading ===\n");
+
+    ew_buffer_t wb;
+    map_file_t mf;
+    uint16_t rtype, rlen;
+    uint64_t written;
+
+    stats_flush();
+    encode_test_elements(&wb);
+    written = gds_stats.count[ST_REC_WRITTEN];
+    stats_flush();
+
+    memset(&mf, 0, sizeof(mf));
+    mf.base = wb.base;
+    mf.size = wb.size;
+    while (map_record_hdr(&mf, &rtype, &rlen) == A_OK && map_data(&mf, rlen))
+        ;
+
+    TEST_ASSERT(gds_stats.count[ST_REC_READ] == written, "All records counted");
+    TEST_ASSERT(gds_stats.count[ST_BYTES_READ] == wb.size, "Bytes counted");
+    TEST_ASSERT(gds_stats.rec_read[RT(XY)] == 2, "Records counted by type");
+
+    stats_flush();
+    TEST_ASSERT(gds_stats.count[ST_REC_READ] == 0, "Counters cleared");
+
+    ew_buffer_free(&wb);
+}
+
+/*
+ * Structure S<k> holds k + 1 rectangles and one SREF
+ */
+#define STRUCTURE_COUNT 16
+
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    char name[8];
+
+    put_library(&b, "LIB1");
+
+    for (int k = 0; k < STRUCTURE_COUNT; k++) {
+        snprintf(name, sizeof(name), "S%03d", k);
+        put_structure(&b, name);
+        for (int j = 0; j <= k; j++) {
+            const int32_t xy[] = {0,0, j,0, j,k, 0,k, 0,0};
+            put_header(&b, BOUNDARY, 0);
+            put_header(&b, LAYER, 2);
+            put_u16(&b, k);
+            put_xy(&b, xy, 5);
+            put_header(&b, ENDEL, 0);
+        }
+        put_header(&b, SREF, 0);
+        put_string(&b, SNAME, "S000");
+        put_header(&b, XY, 8);
+        put_i32(&b, k);
+        put_i32(&b, 0);
+        put_header(&b, ENDEL, 0);
+        put_header(&b, ENDSTR, 0);
+    }
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+#define NSTATS ((int)WASM_PARSE_STATS_COUNT)
+
+static int parse_library(const uint8_t* data, size_t size, int threads, double* st) {
+    wasm_library_cache_t* cache = wasm_create_library_cache((uint8_t*)data, size);
+    int n = -1;
+
+    if (cache && wasm_parse_library_structures(cache) == 0) {
+        if (wasm_start_parallel_parse(cache, threads) == 0) {
+            wasm_parse_all_data(cache);
+        }
+        if (wasm_wait_parallel_parse(cache) == 0) {
+            n = wasm_get_parse_stats(cache, st, NSTATS);
+        }
+    }
+    wasm_free_library_cache(cache);
+    return n;
+}
+
+/*
+ * Test 3: parse statistics of a library cache
+ */
+static void test_parse(void) {
+    printf("\n=== Test 3: Parsing ===\n");
+
+    double st[NSTATS], mt[NSTATS];
+    size_t size;
+    uint8_t* data = create_test_library(&size);
+    int nel = STRUCTURE_COUNT * (STRUCTURE_COUNT + 1) / 2;
+
+    TEST_ASSERT(parse_library(data, size, 0, st) == NSTATS, "All counters returned");
+    TEST_ASSERT(st[offsetof(wasm_parse_stats_t, elements) / 8 + GDS_BOUNDARY] == nel &&
+                st[offsetof(wasm_parse_stats_t, elements) / 8 + GDS_SREF] == STRUCTURE_COUNT,
+                "Elements counted by kind");
+    TEST_ASSERT(st[offsetof(wasm_parse_stats_t, vertices) / 8] == 5 * nel + STRUCTURE_COUNT,
+                "Vertices counted");
+    // BOUNDARY, LAYER, XY, ENDEL; SREF, SNAME, XY, ENDEL, BGNSTR, STRNAME, ENDSTR
+    TEST_ASSERT(st[offsetof(wasm_parse_stats_t, records) / 8] == 4 * nel + 7 * STRUCTURE_COUNT,
+                "Records counted");
+    TEST_ASSERT(st[offsetof(wasm_parse_stats_t, arena_allocs) / 8] > 0 &&
+                st[offsetof(wasm_parse_stats_t, arena_bytes) / 8] > 0, "Arena allocations counted");
+    TEST_ASSERT(wasm_get_parse_stats(NULL, st, NSTATS) == 0, "Invalid arguments");
+
+    // counters of parse workers add up to the same values
+    TEST_ASSERT(parse_library(data, size, 4, mt) == NSTATS, "Parsed with workers");
+    int same = 1;
+    for (int k = 0; k < NSTATS; k++) {
+        if (k != (int)(offsetof(wasm_parse_stats_t, parse_ns) / 8)) same = same && st[k] == mt[k];
+    }
+    TEST_ASSERT(same, "Same counters with workers");
+
+    free(data);
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - Statistics Tests ===\n");
+
+    test_write();
+    test_read();
+    test_parse();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
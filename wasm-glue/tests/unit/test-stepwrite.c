@@ -0,0 +1,395 @@
+/*
+ * Test Suite: STEP Output of Extruded Polygons
+ *
+ * Tests verify that polygons are written as B-rep prisms to STEP
+ * files (Basic/gdsio/stepwrite.c): file structure, entity counts and
+ * the Euler characteristic of the solids, keyhole polygons with inner
+ * bounds, references to undefined entities, AP214 names and colors,
+ * degenerate polygons, error codes and files written in parts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "stepwrite.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define STEP_FILE "test-stepwrite.stp"
+
+/*
+ * STEP file read back into a string
+ */
+static char* read_step(const char* fname) {
+    FILE* fp = fopen(fname, "rb");
+    char* text;
+    long size;
+
+    if (!fp) return NULL;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    text = malloc((size_t)size + 1);
+    size = (long)fread(text, 1, (size_t)size, fp);
+    text[size] = '\0';
+    fclose(fp);
+    return text;
+}
+
+static int count(const char* text, const char* s) {
+    int n = 0;
+    size_t len = strlen(s);
+
+    while ((text = strstr(text, s)) != NULL) {
+        n++;
+        text += len;
+    }
+    return n;
+}
+
+/*
+ * Returns 1 when every referenced entity is defined
+ */
+static int references_defined(const char* text) {
+    const char* data = strstr(text, "DATA;");
+    const char* p;
+    unsigned char* defined;
+    unsigned long id, maxid = 0;
+    int ok = 1;
+
+    if (!data) return 0;
+    for (p = data; (p = strchr(p, '#')) != NULL; p++) {
+        id = strtoul(p + 1, NULL, 10);
+        if (id > maxid) maxid = id;
+    }
+    defined = calloc(maxid + 1, 1);
+    for (p = data; (p = strstr(p, "\n#")) != NULL; p++) {
+        char* end;
+        id = strtoul(p + 2, &end, 10);
+        if (*end == '=') defined[id] = 1;
+    }
+    for (p = data; (p = strchr(p, '#')) != NULL; p++) {
+        if (!defined[strtoul(p + 1, NULL, 10)]) ok = 0;
+    }
+    free(defined);
+    return ok;
+}
+
+/*
+ * Returns 1 when all real numbers of the points have a decimal point
+ */
+static int reals_have_point(const char* text) {
+    const char* p = text;
+
+    while ((p = strstr(p, "CARTESIAN_POINT('',(")) != NULL) {
+        const char* end = strchr(p, ')');
+        const char* q = p + 20;
+        while (q < end) {
+            const char* c = strchr(q, ',');
+            const char* dot;
+            if (!c || c > end) c = end;
+            dot = memchr(q, '.', (size_t)(c - q));
+            if (!dot) return 0;
+            q = c + 1;
+        }
+        p = end;
+    }
+    return 1;
+}
+
+static prisms_t make_prisms(const double* x, const double* y, const size_t* off,
+                            const double* zb, const double* zt, size_t npoly) {
+    prisms_t pr;
+    pr.x = x;
+    pr.y = y;
+    pr.off = off;
+    pr.zb = zb;
+    pr.zt = zt;
+    pr.npoly = npoly;
+    pr.scale = 1.0;
+    return pr;
+}
+
+static step_options_t default_options(void) {
+    step_options_t opt;
+    memset(&opt, 0, sizeof(opt));
+    opt.tolerance = 1e-6;
+    return opt;
+}
+
+/*
+ * Test 1: A square becomes a box
+ */
+static void test_box(void) {
+    printf("\nTest 1: Square extruded into a box\n");
+
+    double x[] = { 0, 10, 10, 0, 0 };
+    double y[] = { 0, 0, 10, 10, 0 };
+    size_t off[] = { 0, 5 };
+    double zb[] = { 0 }, zt[] = { 2 };
+    prisms_t pr = make_prisms(x, y, off, zb, zt, 1);
+    step_options_t opt = default_options();
+    size_t nsolid = 0;
+    char* text;
+    int V, E, F;
+
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0, "box is written");
+    TEST_ASSERT(nsolid == 1, "one solid");
+
+    text = read_step(STEP_FILE);
+    TEST_ASSERT(text != NULL, "file can be read");
+    if (!text) return;
+
+    TEST_ASSERT(strncmp(text, "ISO-10303-21;\nHEADER;", 21) == 0, "file starts with the header");
+    TEST_ASSERT(strstr(text, "FILE_SCHEMA(('CONFIG_CONTROL_DESIGN'));") != NULL, "AP203 schema");
+    TEST_ASSERT(strlen(text) > 26 &&
+                strcmp(text + strlen(text) - 26, "ENDSEC;\nEND-ISO-10303-21;\n") == 0,
+                "file ends with END-ISO-10303-21");
+    TEST_ASSERT(strstr(text, "SI_UNIT(.MILLI.,.METRE.)") != NULL, "millimetre units");
+
+    V = count(text, "=VERTEX_POINT(");
+    E = count(text, "=EDGE_CURVE(");
+    F = count(text, "=ADVANCED_FACE(");
+    TEST_ASSERT(count(text, "=MANIFOLD_SOLID_BREP(") == 1, "one MANIFOLD_SOLID_BREP");
+    TEST_ASSERT(count(text, "=CLOSED_SHELL(") == 1, "one CLOSED_SHELL");
+    TEST_ASSERT(V == 8 && E == 12 && F == 6, "8 vertices, 12 edges, 6 faces");
+    TEST_ASSERT(V - E + F == 2, "Euler characteristic is 2");
+    TEST_ASSERT(count(text, "=FACE_BOUND(") == 0, "no inner bounds");
+    TEST_ASSERT(count(text, "=ADVANCED_BREP_SHAPE_REPRESENTATION(") == 1, "one shape representation");
+    TEST_ASSERT(count(text, "=SHAPE_DEFINITION_REPRESENTATION(") == 1, "shape definition representation");
+    TEST_ASSERT(count(text, "STYLED_ITEM") == 0, "no colors with AP203");
+    TEST_ASSERT(references_defined(text), "all referenced entities are defined");
+    TEST_ASSERT(reals_have_point(text), "real numbers have a decimal point");
+    TEST_ASSERT(strstr(text, "VECTOR('',#") != NULL && strstr(text, ",2.)") != NULL,
+                "vertical edges have the height as magnitude");
+    free(text);
+
+    /* scale and clockwise orientation give the same topology */
+    {
+        double cx[] = { 0, 0, 10, 10 };
+        double cy[] = { 0, 10, 10, 0 };
+        size_t coff[] = { 0, 4 };
+        prisms_t cw = make_prisms(cx, cy, coff, zb, zt, 1);
+        cw.scale = 0.001;
+        TEST_ASSERT(step_write_prisms(STEP_FILE, &cw, &opt, &nsolid) == 0 && nsolid == 1,
+                    "clockwise square is written");
+        text = read_step(STEP_FILE);
+        TEST_ASSERT(count(text, "=ADVANCED_FACE(") == 6, "clockwise square has 6 faces");
+        TEST_ASSERT(strstr(text, "(0.01,0.01,0.002)") != NULL, "coordinates are scaled");
+        free(text);
+    }
+}
+
+/*
+ * Test 2: Keyhole polygons have caps with inner bounds
+ */
+static void test_keyhole(void) {
+    printf("\nTest 2: Keyhole polygon\n");
+
+    double x[] = { 0, 10, 10, 0, 0, 3, 3, 7, 7, 3, 3, 0 };
+    double y[] = { 0, 0, 10, 10, 5, 5, 7, 7, 3, 3, 5, 5 };
+    size_t off[] = { 0, 12 };
+    double zb[] = { 1 }, zt[] = { 4 };
+    prisms_t pr = make_prisms(x, y, off, zb, zt, 1);
+    step_options_t opt = default_options();
+    size_t nsolid = 0;
+    char* text;
+    int V, E, F, R;
+
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0 && nsolid == 1,
+                "keyhole polygon is written");
+    text = read_step(STEP_FILE);
+    if (!text) return;
+
+    V = count(text, "=VERTEX_POINT(");
+    E = count(text, "=EDGE_CURVE(");
+    F = count(text, "=ADVANCED_FACE(");
+    R = count(text, "=FACE_BOUND(");
+    TEST_ASSERT(V == 20, "keyhole vertices are shared (20 vertices)");
+    TEST_ASSERT(E == 30, "no edges along the keyhole (30 edges)");
+    TEST_ASSERT(F == 12, "10 walls and 2 caps");
+    TEST_ASSERT(R == 2, "each cap has one inner bound");
+    TEST_ASSERT(count(text, "=FACE_OUTER_BOUND(") == 12, "every face has an outer bound");
+    TEST_ASSERT(V - E + F - R == 0, "Euler-Poincare formula for a solid with a hole");
+    TEST_ASSERT(references_defined(text), "all referenced entities are defined");
+    free(text);
+}
+
+/*
+ * Test 3: AP214 names and colors
+ */
+static void test_ap214(void) {
+    printf("\nTest 3: AP214 names and colors\n");
+
+    double x[] = { 0, 1, 1, 0,   2, 3, 3, 2,   4, 5, 5, 4 };
+    double y[] = { 0, 0, 1, 1,   0, 0, 1, 1,   0, 0, 1, 1 };
+    size_t off[] = { 0, 4, 8, 12 };
+    double zb[] = { 0, 0, 1 }, zt[] = { 1, 1, 2 };
+    uint32_t group[] = { 0, 1, 0 };
+    const char* names[] = { "metal1", "O'Brien" };
+    double rgb[] = { 1, 0, 0.5, 0, 0, 1 };
+    prisms_t pr = make_prisms(x, y, off, zb, zt, 3);
+    step_options_t opt = default_options();
+    size_t nsolid = 0;
+    char* text;
+
+    opt.ap214 = 1;
+    opt.product = "chip";
+    opt.group = group;
+    opt.ngroup = 2;
+    opt.gname = names;
+    opt.rgb = rgb;
+
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0 && nsolid == 3,
+                "three solids are written");
+    text = read_step(STEP_FILE);
+    if (!text) return;
+
+    TEST_ASSERT(strstr(text, "AUTOMOTIVE_DESIGN { 1 0 10303 214 1 1 1 1 }") != NULL, "AP214 schema");
+    TEST_ASSERT(strstr(text, "PRODUCT('chip','chip'") != NULL, "product name");
+    TEST_ASSERT(count(text, "MANIFOLD_SOLID_BREP('metal1',") == 2, "solids are named by group");
+    TEST_ASSERT(count(text, "MANIFOLD_SOLID_BREP('O''Brien',") == 1, "apostrophes are escaped");
+    TEST_ASSERT(count(text, "=COLOUR_RGB(") == 2, "one color per group");
+    TEST_ASSERT(strstr(text, "COLOUR_RGB('',1.,0.5,0.)") != NULL, "color of group 0");
+    TEST_ASSERT(count(text, "=STYLED_ITEM(") == 3, "one styled item per solid");
+    TEST_ASSERT(count(text, "=MECHANICAL_DESIGN_GEOMETRIC_PRESENTATION_REPRESENTATION(") == 1,
+                "presentation representation");
+    TEST_ASSERT(references_defined(text), "all referenced entities are defined");
+    free(text);
+
+    group[2] = 2;
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == STEP_ERR_GROUP,
+                "group out of range is an error");
+}
+
+/*
+ * Test 4: Degenerate polygons and errors
+ */
+static void test_degenerate(void) {
+    printf("\nTest 4: Degenerate polygons and errors\n");
+
+    double x[] = { 0, 1, 2,   0, 0, 1, 1, 1, 0,   0, 1 };
+    double y[] = { 0, 1, 2,   0, 0, 0, 1, 1, 1,   0, 0 };
+    size_t off[] = { 0, 3, 9, 11 };
+    double zb[] = { 0, 0, 0 }, zt[] = { 1, 1, 1 };
+    prisms_t pr = make_prisms(x, y, off, zb, zt, 3);
+    step_options_t opt = default_options();
+    size_t nsolid = 99;
+    char* text;
+
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0, "polygons are written");
+    TEST_ASSERT(nsolid == 1, "collinear and two-vertex polygons have no solid");
+    text = read_step(STEP_FILE);
+    if (text) {
+        TEST_ASSERT(count(text, "=VERTEX_POINT(") == 8, "repeated vertices are dropped");
+        TEST_ASSERT(references_defined(text), "all referenced entities are defined");
+        free(text);
+    }
+
+    zt[1] = 0;
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0 && nsolid == 0,
+                "polygons without height have no solid");
+    text = read_step(STEP_FILE);
+    if (text) {
+        TEST_ASSERT(strstr(text, "ADVANCED_BREP_SHAPE_REPRESENTATION") != NULL &&
+                    strstr(text, "END-ISO-10303-21;") != NULL, "empty file is complete");
+        free(text);
+    }
+
+    TEST_ASSERT(step_write_prisms("/nonexistent/dir/file.stp", &pr, &opt, &nsolid) == STEP_ERR_OPEN,
+                "unwritable file is an error");
+}
+
+/*
+ * Test 5: A file written in parts
+ */
+static void test_parts(void) {
+    printf("\nTest 5: Writing in parts\n");
+
+    double x[] = { 0, 1, 1, 0,   2, 3, 3, 2,   4, 5, 5, 4 };
+    double y[] = { 0, 0, 1, 1,   0, 0, 1, 1,   0, 0, 1, 1 };
+    size_t off[] = { 0, 4, 8, 12 };
+    double zb[] = { 0, 0, 1 }, zt[] = { 1, 1, 2 };
+    uint32_t group[] = { 0, 1, 0 }, bad[] = { 2 };
+    const char* names[] = { "metal1", "via1" };
+    double rgb[] = { 1, 0, 0.5, 0, 0, 1 };
+    prisms_t pr = make_prisms(x, y, off, zb, zt, 3);
+    prisms_t p1 = make_prisms(x, y, off, zb, zt, 1);
+    prisms_t p2 = make_prisms(x, y, off + 1, zb + 1, zt + 1, 2);
+    step_options_t opt = default_options();
+    step_file_t* st;
+    size_t nsolid = 0, nparts = 0;
+    char *whole, *parts;
+    int err;
+
+    opt.ap214 = 1;
+    opt.group = group;
+    opt.ngroup = 2;
+    opt.gname = names;
+    opt.rgb = rgb;
+
+    TEST_ASSERT(step_write_prisms(STEP_FILE, &pr, &opt, &nsolid) == 0, "file written at once");
+    whole = read_step(STEP_FILE);
+
+    st = step_open(STEP_FILE, &opt, &err);
+    TEST_ASSERT(st != NULL && err == 0, "file opened");
+    if (!st) {
+        free(whole);
+        return;
+    }
+    TEST_ASSERT(step_append_prisms(st, &p1, group) == 0, "first part appended");
+    TEST_ASSERT(step_append_prisms(st, &p1, bad) == STEP_ERR_GROUP, "group out of range is an error");
+    TEST_ASSERT(step_append_prisms(st, &p2, group + 1) == 0, "file can be written after a group error");
+    TEST_ASSERT(step_close(st, &nparts) == 0 && nparts == nsolid, "file closed with all solids");
+    parts = read_step(STEP_FILE);
+
+    TEST_ASSERT(whole && parts && strstr(whole, "DATA;") && strstr(parts, "DATA;") &&
+                strcmp(strstr(whole, "DATA;"), strstr(parts, "DATA;")) == 0,
+                "parts give the same entities");
+    free(whole);
+    free(parts);
+
+    TEST_ASSERT(step_open("/nonexistent/dir/file.stp", &opt, &err) == NULL && err == STEP_ERR_OPEN,
+                "unwritable file is an error on open");
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("STEP Output Tests\n");
+    printf("========================================\n");
+
+    test_box();
+    test_keyhole();
+    test_ap214();
+    test_degenerate();
+    test_parts();
+
+    remove(STEP_FILE);
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
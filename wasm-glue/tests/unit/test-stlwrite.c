@@ -0,0 +1,387 @@
+/*
+ * Test Suite: Polygon Extrusion and Binary STL Output
+ *
+ * Tests verify that polygons are extruded into closed prisms with
+ * outward facing facets (Basic/gdsio/stlwrite.c): facet counts, STL
+ * header and file size, normals, volumes of indexed meshes for both
+ * orientations and for keyhole polygons, repeated vertices, polygon
+ * sets that span several blocks and threads, and files written in
+ * parts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "stlwrite.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+#define TEST_ASSERT_DOUBLE_EQ(expected, actual, epsilon, message) \
+    do { \
+        tests_run++; \
+        double diff = fabs((expected) - (actual)); \
+        if (diff < (epsilon)) { \
+            tests_passed++; \
+            printf("  ✓ %s (%.4f)\n", message, (double)(actual)); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s - expected %.4f, got %.4f\n", \
+                   message, (double)(expected), (double)(actual)); \
+        } \
+    } while(0)
+
+#define STL_FILE "test-stlwrite.stl"
+
+/*
+ * STL file read back into memory
+ */
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    uint32_t count;
+} stl_data_t;
+
+static int read_stl(const char* fname, stl_data_t* stl) {
+    FILE* fp = fopen(fname, "rb");
+    long size;
+
+    if (!fp) return -1;
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    stl->data = malloc(size > 0 ? (size_t)size : 1);
+    stl->size = fread(stl->data, 1, (size_t)size, fp);
+    fclose(fp);
+    stl->count = 0;
+    if (stl->size >= 84) {
+        stl->count = (uint32_t)stl->data[80] | ((uint32_t)stl->data[81] << 8) |
+                     ((uint32_t)stl->data[82] << 16) | ((uint32_t)stl->data[83] << 24);
+    }
+    return 0;
+}
+
+static float facet_float(const stl_data_t* stl, size_t facet, int k) {
+    const unsigned char* p = stl->data + 84 + facet * STL_FACET_BYTES + 4 * k;
+    uint32_t u = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/*
+ * volume enclosed by the facets of an STL file, from the divergence
+ * theorem; negative when facets face inwards
+ */
+static double stl_volume(const stl_data_t* stl) {
+    double v = 0.0;
+    size_t t;
+    for (t = 0; t < stl->count; t++) {
+        double ax = facet_float(stl, t, 3), ay = facet_float(stl, t, 4), az = facet_float(stl, t, 5);
+        double bx = facet_float(stl, t, 6), by = facet_float(stl, t, 7), bz = facet_float(stl, t, 8);
+        double cx = facet_float(stl, t, 9), cy = facet_float(stl, t, 10), cz = facet_float(stl, t, 11);
+        v += ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) + az * (bx * cy - by * cx);
+    }
+    return v / 6.0;
+}
+
+/*
+ * volume enclosed by an indexed mesh
+ */
+static double mesh_volume(const prism_mesh_t* mesh) {
+    const double* x = mesh->vert;
+    const double* y = mesh->vert + mesh->nvert;
+    const double* z = mesh->vert + 2 * mesh->nvert;
+    double v = 0.0;
+    size_t t;
+    for (t = 0; t < mesh->nface; t++) {
+        uint32_t a = mesh->face[3*t], b = mesh->face[3*t+1], c = mesh->face[3*t+2];
+        v += x[a] * (y[b] * z[c] - z[b] * y[c]) - y[a] * (x[b] * z[c] - z[b] * x[c]) +
+             z[a] * (x[b] * y[c] - y[b] * x[c]);
+    }
+    return v / 6.0;
+}
+
+/*
+ * Test 1: extruded square written to an STL file
+ */
+static void test_square_stl(void) {
+    printf("\n=== Test 1: Square Prism ===\n");
+
+    double xy[10] = {0, 10, 10, 0, 0,   0, 0, 5, 5, 0};
+    size_t off[2] = {0, 5};
+    double zb = 1.0, zt = 3.0;
+    prisms_t pr = {xy, xy + 5, off, &zb, &zt, 1, 1.0};
+    stl_data_t stl;
+    size_t nfacet = 0, t;
+    int outward = 1, unit = 1;
+
+    TEST_ASSERT(stl_write_prisms(STL_FILE, "test header", &pr, 1, &nfacet) == 0, "STL file written");
+    TEST_ASSERT(nfacet == 12, "Square prism has 12 facets");
+    TEST_ASSERT(read_stl(STL_FILE, &stl) == 0, "STL file read back");
+    TEST_ASSERT(stl.size == 84 + 12 * STL_FACET_BYTES, "File size matches the facet count");
+    TEST_ASSERT(stl.count == 12, "Header holds the facet count");
+    TEST_ASSERT(memcmp(stl.data, "test header", 11) == 0 && stl.data[11] == ' ', "Header text is padded");
+
+    for (t = 0; t < stl.count; t++) {
+        double nx = facet_float(&stl, t, 0), ny = facet_float(&stl, t, 1), nz = facet_float(&stl, t, 2);
+        double cx = 0, cy = 0, cz = 0;
+        int k;
+        for (k = 0; k < 3; k++) {
+            cx += facet_float(&stl, t, 3 + 3*k) / 3.0;
+            cy += facet_float(&stl, t, 4 + 3*k) / 3.0;
+            cz += facet_float(&stl, t, 5 + 3*k) / 3.0;
+        }
+        if (fabs(nx*nx + ny*ny + nz*nz - 1.0) > 1e-6) unit = 0;
+        if (nx * (cx - 5.0) + ny * (cy - 2.5) + nz * (cz - 2.0) <= 0) outward = 0;
+    }
+    TEST_ASSERT(unit, "Normals have unit length");
+    TEST_ASSERT(outward, "Normals face outwards");
+    TEST_ASSERT_DOUBLE_EQ(100.0, stl_volume(&stl), 1e-6, "Enclosed volume");
+
+    free(stl.data);
+    remove(STL_FILE);
+}
+
+/*
+ * Test 2: orientation and repeated vertices
+ */
+static void test_orientation(void) {
+    printf("\n=== Test 2: Orientation and Repeated Vertices ===\n");
+
+    /* clockwise square with a repeated vertex, open */
+    double xy[10] = {0, 0, 4, 4, 4,   0, 4, 4, 4, 0};
+    size_t off[2] = {0, 5};
+    double zb = 0.0, zt = 2.0;
+    prisms_t pr = {xy, xy + 5, off, &zb, &zt, 1, 1.0};
+    prism_mesh_t mesh;
+
+    TEST_ASSERT(prism_mesh(&pr, 1, &mesh) == 0, "Mesh of clockwise polygon");
+    TEST_ASSERT(mesh.nvert == 8, "Repeated vertex is dropped (8 vertices)");
+    TEST_ASSERT(mesh.nface == 12, "12 faces");
+    TEST_ASSERT_DOUBLE_EQ(32.0, mesh_volume(&mesh), 1e-9, "Faces of clockwise polygon face outwards");
+    prism_mesh_free(&mesh);
+
+    pr.scale = 0.5;
+    TEST_ASSERT(prism_mesh(&pr, 1, &mesh) == 0, "Mesh with scale");
+    TEST_ASSERT_DOUBLE_EQ(4.0, mesh_volume(&mesh), 1e-9, "Scale applies to all coordinates");
+    prism_mesh_free(&mesh);
+}
+
+/*
+ * Test 3: keyhole polygon, L shape and degenerate polygons
+ */
+static void test_shapes(void) {
+    printf("\n=== Test 3: Keyhole, Concave and Degenerate Polygons ===\n");
+
+    /* 10x10 square with a 4x4 hole cut along y = 3 */
+    double kx[11] = {0, 10, 10, 0, 0, 3, 3, 7, 7, 3, 0};
+    double ky[11] = {0, 0, 10, 10, 3, 3, 7, 7, 3, 3, 3};
+    /* L shape */
+    double lx[6] = {0, 6, 6, 2, 2, 0};
+    double ly[6] = {0, 0, 2, 2, 6, 6};
+    /* line and point */
+    double dx[5] = {0, 1, 2, 5, 5};
+    double dy[5] = {0, 1, 2, 5, 5};
+    double xy[2 * 22];
+    size_t off[4] = {0, 11, 17, 22};
+    double zb[3] = {0, 0, 0}, zt[3] = {1, 3, 1};
+    prisms_t pr = {xy, xy + 22, off, zb, zt, 3, 1.0};
+    prism_mesh_t mesh;
+    size_t nfacet, nface;
+    stl_data_t stl;
+
+    memcpy(xy, kx, sizeof(kx));
+    memcpy(xy + 11, lx, sizeof(lx));
+    memcpy(xy + 17, dx, sizeof(dx));
+    memcpy(xy + 22, ky, sizeof(ky));
+    memcpy(xy + 33, ly, sizeof(ly));
+    memcpy(xy + 39, dy, sizeof(dy));
+
+    TEST_ASSERT(prism_mesh(&pr, 1, &mesh) == 0, "Mesh of three polygons");
+    TEST_ASSERT(mesh.nvert == 2 * 11 + 2 * 6, "Degenerate polygon has no prism");
+    TEST_ASSERT_DOUBLE_EQ(84.0 * 1 + 20.0 * 3, mesh_volume(&mesh), 1e-9, "Volume of keyhole and L prisms");
+    nface = mesh.nface;
+    prism_mesh_free(&mesh);
+
+    TEST_ASSERT(stl_write_prisms(STL_FILE, NULL, &pr, 1, &nfacet) == 0, "STL file written");
+    read_stl(STL_FILE, &stl);
+    TEST_ASSERT(stl.count == nfacet && nfacet == nface, "STL has the faces of the mesh");
+    TEST_ASSERT_DOUBLE_EQ(144.0, stl_volume(&stl), 1e-4, "STL volume matches the mesh");
+    free(stl.data);
+    remove(STL_FILE);
+}
+
+/*
+ * Test 4: polygon sets larger than a block, processed by threads
+ */
+static void test_blocks_and_threads(void) {
+    printf("\n=== Test 4: Blocks and Threads ===\n");
+
+    const size_t n = STL_BLOCK_VERTICES / 2;   /* 2 blocks of squares */
+    double* xy = malloc(8 * n * sizeof(double));
+    size_t* off = malloc((n + 1) * sizeof(size_t));
+    double* zb = malloc(n * sizeof(double));
+    double* zt = malloc(n * sizeof(double));
+    prisms_t pr;
+    prism_mesh_t m1, m4;
+    size_t k, nf1 = 0, nf4 = 0;
+    stl_data_t s1, s4;
+    int same;
+
+    for (k = 0; k < n; k++) {
+        double x0 = (double)(k % 1000) * 2.0, y0 = (double)(k / 1000) * 2.0;
+        xy[4*k] = x0;       xy[4*n + 4*k] = y0;
+        xy[4*k+1] = x0 + 1; xy[4*n + 4*k+1] = y0;
+        xy[4*k+2] = x0 + 1; xy[4*n + 4*k+2] = y0 + 1;
+        xy[4*k+3] = x0;     xy[4*n + 4*k+3] = y0 + 1;
+        off[k] = 4 * k;
+        zb[k] = (double)(k % 3);
+        zt[k] = zb[k] + 1.0;
+    }
+    off[n] = 4 * n;
+    pr.x = xy;
+    pr.y = xy + 4 * n;
+    pr.off = off;
+    pr.zb = zb;
+    pr.zt = zt;
+    pr.npoly = n;
+    pr.scale = 1.0;
+
+    TEST_ASSERT(stl_write_prisms(STL_FILE, NULL, &pr, 1, &nf1) == 0, "One thread");
+    read_stl(STL_FILE, &s1);
+    TEST_ASSERT(stl_write_prisms(STL_FILE, NULL, &pr, 4, &nf4) == 0, "Four threads");
+    read_stl(STL_FILE, &s4);
+    remove(STL_FILE);
+
+    TEST_ASSERT(nf1 == 12 * n && nf4 == nf1 && s4.count == nf4, "All facets written");
+    same = s1.size == s4.size && memcmp(s1.data, s4.data, s1.size) == 0;
+    TEST_ASSERT(same, "Threads write the same file");
+    free(s1.data);
+    free(s4.data);
+
+    TEST_ASSERT(prism_mesh(&pr, 1, &m1) == 0 && prism_mesh(&pr, 4, &m4) == 0, "Meshes with 1 and 4 threads");
+    TEST_ASSERT(m1.nvert == 8 * n && m4.nvert == m1.nvert && m4.nface == m1.nface, "Mesh sizes");
+    same = memcmp(m1.vert, m4.vert, 3 * m1.nvert * sizeof(double)) == 0 &&
+           memcmp(m1.face, m4.face, 3 * m1.nface * sizeof(uint32_t)) == 0;
+    TEST_ASSERT(same, "Threads build the same mesh");
+    TEST_ASSERT_DOUBLE_EQ((double)n, mesh_volume(&m4), 1e-6, "Volume of all prisms");
+    prism_mesh_free(&m1);
+    prism_mesh_free(&m4);
+
+    TEST_ASSERT(stl_write_prisms("/nonexistent/dir/x.stl", NULL, &pr, 1, &nf1) == STL_ERR_OPEN,
+                "Unwritable file is reported");
+
+    free(xy);
+    free(off);
+    free(zb);
+    free(zt);
+}
+
+/*
+ * Test 5: a file written in parts equals the file written at once
+ */
+static void test_parts(void) {
+    printf("\n=== Test 5: Writing in Parts ===\n");
+
+    const size_t n = 300, h = 120;
+    double* xy = malloc(8 * n * sizeof(double));
+    size_t* off = malloc((n + 1) * sizeof(size_t));
+    double* zb = malloc(n * sizeof(double));
+    double* zt = malloc(n * sizeof(double));
+    prisms_t pr, p1, p2;
+    stl_file_t sf;
+    size_t k, nf = 0, nfp = 0;
+    stl_data_t s1, s2;
+    int same;
+
+    for (k = 0; k < n; k++) {
+        double x0 = (double)(k % 20) * 3.0, y0 = (double)(k / 20) * 3.0;
+        xy[4*k] = x0;       xy[4*n + 4*k] = y0;
+        xy[4*k+1] = x0 + 2; xy[4*n + 4*k+1] = y0;
+        xy[4*k+2] = x0 + 2; xy[4*n + 4*k+2] = y0 + 1;
+        xy[4*k+3] = x0;     xy[4*n + 4*k+3] = y0 + 1;
+        off[k] = 4 * k;
+        zb[k] = 0.0;
+        zt[k] = 1.0 + (double)(k % 2);
+    }
+    off[n] = 4 * n;
+    pr.x = xy;
+    pr.y = xy + 4 * n;
+    pr.off = off;
+    pr.zb = zb;
+    pr.zt = zt;
+    pr.npoly = n;
+    pr.scale = 1.0;
+
+    /* the offsets of the parts still refer to the whole vertex buffer */
+    p1 = pr;
+    p1.npoly = h;
+    p2 = pr;
+    p2.off = off + h;
+    p2.zb = zb + h;
+    p2.zt = zt + h;
+    p2.npoly = n - h;
+
+    TEST_ASSERT(stl_write_prisms(STL_FILE, "parts", &pr, 2, &nf) == 0, "File written at once");
+    read_stl(STL_FILE, &s1);
+    TEST_ASSERT(stl_open(&sf, STL_FILE, "parts", 2) == 0, "File opened");
+    TEST_ASSERT(stl_append_prisms(&sf, &p1) == 0, "First part appended");
+    TEST_ASSERT(stl_append_prisms(&sf, &p2) == 0, "Second part appended");
+    TEST_ASSERT(stl_close(&sf, &nfp) == 0, "File closed");
+    read_stl(STL_FILE, &s2);
+    remove(STL_FILE);
+
+    TEST_ASSERT(nfp == nf && s2.count == nf, "Facet count patched into the header");
+    same = s1.size == s2.size && memcmp(s1.data, s2.data, s1.size) == 0;
+    TEST_ASSERT(same, "Parts give the same file");
+    free(s1.data);
+    free(s2.data);
+
+    TEST_ASSERT(stl_open(&sf, "/nonexistent/dir/x.stl", NULL, 1) == STL_ERR_OPEN,
+                "Unwritable file is reported on open");
+
+    free(xy);
+    free(off);
+    free(zb);
+    free(zt);
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("Polygon Extrusion and STL Output Tests\n");
+    printf("========================================\n");
+
+    test_square_stl();
+    test_orientation();
+    test_shapes();
+    test_blocks_and_threads();
+    test_parts();
+
+    printf("\n========================================\n");
+    printf("Test Summary\n");
+    printf("========================================\n");
+    printf("Tests run:    %d\n", tests_run);
+    printf("Tests passed: %d\n", tests_passed);
+    printf("Tests failed: %d\n", tests_failed);
+
+    return tests_failed > 0 ? 1 : 0;
+}
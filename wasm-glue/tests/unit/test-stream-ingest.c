@@ -0,0 +1,157 @@
+/*
+ * Test Suite: Streaming Ingestion
+ *
+ * Tests verify that a stream cache (wasm_create_stream_cache) fed with
+ * small chunks scans records split across chunks, makes each structure
+ * visible when its ENDSTR arrives, lets complete structures be parsed
+ * while the stream continues, and rejects data that is not GDSII.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "wasm-element-cache.h"
+#include "mem-file.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * Structure S<k> holds k + 1 rectangles on layer k; rectangle j is
+ * j wide and k high.
+ */
+#define STRUCTURE_COUNT 8
+
+static uint8_t* create_test_library(size_t* out_size, size_t* endstr) {
+    gds_buffer_t b = {NULL, 0, 0};
+    char name[16];
+
+    // 1e-3 and 1e-9 in GDSII excess-64 format
+    const uint8_t units[16] = {0x3e, 0x41, 0x89, 0x37, 0x4b, 0xc6, 0xa7, 0xef,
+                               0x39, 0x44, 0xb8, 0x2f, 0xa0, 0x9b, 0x5a, 0x54};
+
+    put_library_header(&b, 600, "STREAMLIB");
+    put_header(&b, UNITS, 16);
+    put_bytes(&b, units, 16);
+
+    for (int k = 0; k < STRUCTURE_COUNT; k++) {
+        snprintf(name, sizeof(name), "S%d", k);
+        put_structure(&b, name);
+        for (int j = 0; j <= k; j++) {
+            const int32_t xy[] = {0,0, j,0, j,k, 0,k, 0,0};
+            put_header(&b, BOUNDARY, 0);
+            put_header(&b, LAYER, 2);
+            put_u16(&b, k);
+            put_header(&b, XY, sizeof(xy));
+            for (int i = 0; i < 10; i++) put_i32(&b, xy[i]);
+            put_header(&b, ENDEL, 0);
+        }
+        put_header(&b, ENDSTR, 0);
+        endstr[k] = b.pos;
+    }
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * Test 1: chunks
+ */
+static void test_chunks(const uint8_t* data, size_t size, const size_t* endstr) {
+    printf("\n=== Test 1: Chunks ===\n");
+
+    wasm_library_cache_t* cache = wasm_create_stream_cache(0);
+    TEST_ASSERT(cache != NULL && cache->structure_count == 0, "Stream cache created");
+    if (!cache) return;
+
+    // 7-byte chunks split every record; structure k is visible once the
+    // chunk with its ENDSTR is committed
+    int ok = 1, parsed_early = 1;
+    for (size_t pos = 0; ok && pos < size; pos += 7) {
+        size_t n = size - pos < 7 ? size - pos : 7;
+        int ready = wasm_stream_push(cache, data + pos, n);
+        int expected = 0;
+        while (expected < STRUCTURE_COUNT && endstr[expected] <= pos + n) expected++;
+        ok = ready == expected;
+        if (ok && ready > 0 && pos + n < size) {
+            parsed_early = parsed_early &&
+                wasm_get_element_count(cache, ready - 1) == ready &&
+                wasm_get_element_layer(cache, ready - 1, 0) == ready - 1;
+        }
+    }
+    TEST_ASSERT(ok, "Structures become visible at their ENDSTR");
+    TEST_ASSERT(parsed_early, "Complete structures parsed while streaming");
+    TEST_ASSERT(wasm_stream_finish(cache) == 0, "Stream complete");
+    TEST_ASSERT(strcmp(cache->name, "STREAMLIB") == 0 && cache->version == 600, "Library header");
+    TEST_ASSERT(fabs(cache->user_units_per_db_unit - 1e-3) < 1e-12 &&
+                fabs(cache->meters_per_db_unit - 1e-9) < 1e-18, "Library units");
+    TEST_ASSERT(strcmp(cache->structures[STRUCTURE_COUNT - 1].name, "S7") == 0 &&
+                wasm_get_element_count(cache, STRUCTURE_COUNT - 1) == STRUCTURE_COUNT &&
+                cache->structures[STRUCTURE_COUNT - 1].elements[3].bounds[2] == 3,
+                "Last structure");
+    TEST_ASSERT(wasm_stream_push(cache, data, 4) == -1, "No data after ENDLIB");
+
+    wasm_free_library_cache(cache);
+}
+
+/*
+ * Test 2: truncated and invalid streams
+ */
+static void test_errors(const uint8_t* data, size_t size, const size_t* endstr) {
+    printf("\n=== Test 2: Truncated and Invalid Streams ===\n");
+
+    // the expected size is allocated at once
+    wasm_library_cache_t* cache = wasm_create_stream_cache(size);
+    TEST_ASSERT(cache && cache->data_alloc == size, "Buffer of the expected size");
+    if (!cache) return;
+    TEST_ASSERT(wasm_stream_push(cache, data, endstr[2] + 10) == 3, "Three structures received");
+    TEST_ASSERT(wasm_stream_finish(cache) == -1, "Truncated stream is incomplete");
+    TEST_ASSERT(wasm_get_element_count(cache, 3) == -1, "Open structure not accessible");
+    wasm_free_library_cache(cache);
+
+    const uint8_t junk[8] = {0, 8, 0x05, 0x02, 1, 2, 3, 4};
+    cache = wasm_create_stream_cache(0);
+    TEST_ASSERT(cache && wasm_stream_push(cache, junk, sizeof(junk)) == -1,
+                "Data without HEADER rejected");
+    wasm_free_library_cache(cache);
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Streaming Ingestion Tests ===\n");
+
+    size_t size;
+    size_t endstr[STRUCTURE_COUNT];
+    uint8_t* data = create_test_library(&size, endstr);
+
+    test_chunks(data, size, endstr);
+    test_errors(data, size, endstr);
+
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,226 @@
+/*
+ * Test Suite: Triangulation
+ *
+ * Tests verify that the ear clipping kernel covers convex, concave and
+ * keyhole polygons of either orientation exactly with counter-clockwise
+ * triangles, and that gds_get_structure_triangles groups the triangles
+ * of a structure by layer and keeps them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "gds-wasm-adapter.h"
+#include "wasm-element-cache.h"
+#include "triangulate.h"
+#include "gds-builder.h"
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+/*
+ * Triangulates a polygon of packed x,y pairs; returns the number of
+ * triangles and their total area, and counts clockwise triangles and
+ * triangles that contain the point (px, py).
+ */
+static size_t run(const double* xy, size_t nv, double* area, int* cw,
+                  double px, double py, int* covered) {
+    size_t work[64];
+    uint32_t tri[192];
+    size_t nt = triangulate(xy, xy + 1, nv, 2, work, tri);
+
+    *area = 0;
+    *cw = *covered = 0;
+    for (size_t t = 0; t < nt; t++) {
+        const double* a = xy + 2 * tri[3*t];
+        const double* b = xy + 2 * tri[3*t+1];
+        const double* c = xy + 2 * tri[3*t+2];
+        double cr = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        *area += 0.5 * cr;
+        if (cr < 0) (*cw)++;
+        double d1 = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+        double d2 = (c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]);
+        double d3 = (a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]);
+        if (d1 > 0 && d2 > 0 && d3 > 0) (*covered)++;
+    }
+    return nt;
+}
+
+/*
+ * Test 1: triangulation kernel
+ */
+static void test_kernel(void) {
+    printf("\n=== Test 1: Ear Clipping ===\n");
+
+    double area;
+    int cw, covered;
+
+    const double square[] = {0,0, 1,0, 1,1, 0,1, 0,0};
+    TEST_ASSERT(run(square, 5, &area, &cw, 0.5, 0.2, &covered) == 2 && area == 1.0 && cw == 0,
+                "Closed square");
+
+    // clockwise L shape
+    const double ell[] = {0,0, 0,4, 2,4, 2,2, 4,2, 4,0};
+    size_t nt = run(ell, 6, &area, &cw, 3, 3, &covered);
+    TEST_ASSERT(nt == 4 && area == 12.0 && cw == 0, "Clockwise concave polygon");
+    TEST_ASSERT(covered == 0, "Notch left empty");
+
+    // 10 x 10 square with a 4 x 4 hole cut in along y = 5
+    const double keyhole[] = {0,0, 10,0, 10,10, 0,10, 0,5, 3,5, 3,7, 7,7, 7,3, 3,3, 3,5, 0,5};
+    nt = run(keyhole, 12, &area, &cw, 5, 5, &covered);
+    TEST_ASSERT(nt == 10 && area == 84.0 && cw == 0, "Keyhole polygon");
+    TEST_ASSERT(covered == 0, "Hole left empty");
+
+    const double collinear[] = {0,0, 5,0, 10,0, 10,2, 10,2, 0,2};
+    TEST_ASSERT(run(collinear, 6, &area, &cw, 1, 1, &covered) == 2 && area == 20.0,
+                "Collinear and repeated vertices dropped");
+
+    const double line[] = {0,0, 5,0, 0,0};
+    TEST_ASSERT(run(line, 3, &area, &cw, 1, 1, &covered) == 0, "Degenerate polygon");
+}
+
+/*
+ * TOP holds a 2 x 2 square on layer 2, an L shape and a horizontal
+ * path of width 2 and length 10 on layer 1, and a text.
+ */
+static uint8_t* create_test_library(size_t* out_size) {
+    gds_buffer_t b = {NULL, 0, 0};
+    const int32_t square[] = {0,0, 2,0, 2,2, 0,2, 0,0};
+    const int32_t ell[] = {0,0, 4,0, 4,2, 2,2, 2,4, 0,4, 0,0};
+    const int32_t path[] = {0,10, 10,10};
+    const int32_t text[] = {3, 3};
+
+    put_library(&b, "TRILIB");
+
+    put_structure(&b, "TOP");
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 2);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, square, 5);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, BOUNDARY, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, ell, 7);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, PATH, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 1);
+    put_header(&b, DATATYPE, 2);
+    put_u16(&b, 0);
+    put_header(&b, WIDTH, 4);
+    put_i32(&b, 2);
+    put_xy(&b, path, 2);
+    put_header(&b, ENDEL, 0);
+
+    put_header(&b, TEXT, 0);
+    put_header(&b, LAYER, 2);
+    put_u16(&b, 5);
+    put_header(&b, TEXTTYPE, 2);
+    put_u16(&b, 0);
+    put_xy(&b, text, 1);
+    put_string(&b, STRING, "A");
+    put_header(&b, ENDEL, 0);
+    put_header(&b, ENDSTR, 0);
+
+    put_header(&b, ENDLIB, 0);
+
+    *out_size = b.pos;
+    return b.data;
+}
+
+/*
+ * Test 2: triangulated layers of a structure
+ */
+static void test_structure(void* lib) {
+    printf("\n=== Test 2: Structure Triangles ===\n");
+
+    int words = gds_get_structure_triangles(lib, 0);
+    const int32_t* g = gds_get_structure_triangles_buffer(lib);
+    TEST_ASSERT(words > GDS_TRI_HEADER_WORDS && g != NULL, "Structure triangulated");
+    if (words <= 0 || !g) return;
+
+    const int32_t* layers = g + g[GDS_TRI_LAYERS];
+    const int32_t* lvert = g + g[GDS_TRI_LAYER_VERTICES];
+    const int32_t* lidx = g + g[GDS_TRI_LAYER_INDICES];
+    const float* vert = (const float*)(g + g[GDS_TRI_VERTICES]);
+    const uint32_t* idx = (const uint32_t*)(g + g[GDS_TRI_INDICES]);
+
+    TEST_ASSERT(g[GDS_TRI_LAYER_COUNT] == 2 && layers[0] == 1 && layers[1] == 0 &&
+                layers[2] == 2 && layers[3] == 0, "Layers in ascending order, text left out");
+    // L shape and path outline without closing vertices
+    TEST_ASSERT(lvert[0] == 0 && lvert[1] == 10 && lvert[2] == 14 &&
+                g[GDS_TRI_VERTEX_COUNT] == 14, "Layer vertices");
+    TEST_ASSERT(lidx[0] == 0 && lidx[1] == 3 * 6 && lidx[2] == 3 * 8 &&
+                g[GDS_TRI_INDEX_COUNT] == 3 * 8, "Layer indices");
+
+    int relative = 1;
+    double area[2] = {0, 0};
+    for (int l = 0; l < 2; l++) {
+        const float* v = vert + 2 * lvert[l];
+        for (int i = lidx[l]; i < lidx[l + 1]; i += 3) {
+            uint32_t a = idx[i], b = idx[i + 1], c = idx[i + 2];
+            if (a >= (uint32_t)(lvert[l + 1] - lvert[l]) || b >= (uint32_t)(lvert[l + 1] - lvert[l]) ||
+                c >= (uint32_t)(lvert[l + 1] - lvert[l])) relative = 0;
+            area[l] += 0.5 * ((v[2*b] - v[2*a]) * (v[2*c+1] - v[2*a+1]) -
+                              (v[2*b+1] - v[2*a+1]) * (v[2*c] - v[2*a]));
+        }
+    }
+    TEST_ASSERT(relative, "Indices relative to the layer");
+    TEST_ASSERT(area[0] == 12.0 + 20.0 && area[1] == 4.0, "Layers covered");
+    TEST_ASSERT(words == g[GDS_TRI_INDICES] + g[GDS_TRI_INDEX_COUNT], "Indices end the buffer");
+
+    gds_get_structure_triangles(lib, 0);
+    TEST_ASSERT(gds_get_structure_triangles_buffer(lib) == g, "Triangles are kept");
+    TEST_ASSERT(gds_get_structure_triangles(lib, 1) == -1 &&
+                gds_get_structure_triangles(NULL, 0) == -1, "Invalid arguments rejected");
+}
+
+int main(void) {
+    printf("\n=== WASM GDSII Parser - Triangulation Tests ===\n");
+
+    test_kernel();
+
+    size_t size;
+    int err;
+    uint8_t* data = create_test_library(&size);
+    void* lib = gds_parse_from_memory(data, size, &err);
+    TEST_ASSERT(lib != NULL && err == 0, "Library parsed");
+    if (!lib) return 1;
+
+    test_structure(lib);
+
+    gds_free_library(lib);
+    free(data);
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/*
+ * Test Suite: Zone Plate Generation
+ *
+ * Tests verify the zone segment polygons computed by
+ * Structures/private/zonegen.c for gdsii_zonelens and
+ * gdsii_zonelens_write: the polygon error must not exceed the
+ * requested value, equal-area polygons must have the area of the
+ * rings, segments are not limited to 8191 vertices, and the
+ * parallel computation must give the same polygons as one thread.
+ */
+
+#define _POSIX_C_SOURCE 199309L   // for clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "zonegen.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Test result tracking
+static int tests_run = 0;
+static int tests_passed = 0;
+static int tests_failed = 0;
+
+// Helper macros
+#define TEST_ASSERT(condition, message) \
+    do { \
+        tests_run++; \
+        if (condition) { \
+            tests_passed++; \
+            printf("  ✓ %s\n", message); \
+        } else { \
+            tests_failed++; \
+            printf("  ✗ FAILED: %s\n", message); \
+        } \
+    } while(0)
+
+static double polygon_area(const zg_zone_t* pz) {
+    const double* x = pz->xy;
+    const double* y = pz->xy + pz->nv;
+    double a = 0.0;
+
+    for (size_t k = 0; k + 1 < pz->nv; k++)
+        a += x[k] * y[k + 1] - x[k + 1] * y[k];
+    return 0.5 * a;
+}
+
+/*
+ * largest deviation of the arc vertices and chord midpoints of a
+ * segment from the circles with radii ri and ro
+ */
+static double max_error(const zg_zone_t* pz) {
+    const double* x = pz->xy;
+    const double* y = pz->xy + pz->nv;
+    double err = 0.0;
+
+    for (size_t k = 0; k + 1 < pz->nv; k++) {
+        double r0 = hypot(x[k], y[k]);
+        double r1 = hypot(x[k + 1], y[k + 1]);
+        double rm = hypot(0.5 * (x[k] + x[k + 1]), 0.5 * (y[k] + y[k + 1]));
+        double r = fabs(r0 - pz->ro) < fabs(r0 - pz->ri) ? pz->ro : pz->ri;
+
+        if (r0 < 1e-12 || r1 < 1e-12 || fabs(r1 - r0) > 0.5 * (pz->ro - pz->ri))
+            continue;   // center of a sector, or a radial edge
+        err = fmax(err, fabs(r0 - r));
+        err = fmax(err, fabs(rm - r));
+    }
+    return err;
+}
+
+/*
+ * Test 1: arcs and segments
+ */
+static void test_arcs(void) {
+    printf("\n=== Test 1: Arcs and Segments ===\n");
+
+    double cfac;
+    size_t np;
+
+    np = zg_arc(1000.0, 1.0, M_PI / 2, ZG_EQUAL_AREA, &cfac);
+    TEST_ASSERT(np == 1 + (size_t)ceil(M_PI / 2 / (sqrt(6.0) * sqrt((1.001 * 1.001 - 1) / (1.001 * 1.001)))),
+                "Number of arc vertices for equal area");
+    TEST_ASSERT(cfac > 1.0 && cfac < 1.001, "Equal-area radius correction is small");
+    np = zg_arc(1000.0, 1.0, M_PI / 2, ZG_EQUAL_LENGTH, &cfac);
+    TEST_ASSERT(np > 2 && cfac > 1.0 && cfac < 1.001, "Equal-length arc");
+
+    TEST_ASSERT(zg_arc(0.0, 1.0, 1.0, ZG_EQUAL_AREA, &cfac) == 0 &&
+                zg_arc(1.0, 0.0, 1.0, ZG_EQUAL_AREA, &cfac) == 0 &&
+                zg_arc(1.0, 1.0, 1.0, 3, &cfac) == 0, "Invalid arcs are rejected");
+
+    TEST_ASSERT(zg_segments(10.0, 1.0, ZG_EQUAL_AREA, ZG_MAX_VERT) == ZG_MIN_SEG,
+                "Small zones have the minimum number of segments");
+    int nseg = zg_segments(1e5, 1e-3, ZG_EQUAL_AREA, ZG_MAX_VERT);
+    np = zg_arc(1e5, 1e-3, M_PI / 2, ZG_EQUAL_AREA, &cfac);
+    TEST_ASSERT(nseg == (int)floor(4.0 * np / 400 + 0.5), "Large zones have segments with about 800 vertices");
+}
+
+/*
+ * Test 2: zone polygons
+ */
+static void test_zones(void) {
+    printf("\n=== Test 2: Zone Polygons ===\n");
+
+    zg_zone_t z[3] = {{0.0, 50.0, 0, NULL, 0}, {100.0, 150.0, 0, NULL, 0}, {1e4, 1e4 + 2, 0, NULL, 0}};
+    double pe = 0.01;
+
+    TEST_ASSERT(zg_zones(z, 3, pe, ZG_EQUAL_AREA, ZG_MAX_VERT, 1) == 0, "Zones are computed");
+
+    int closed = 1, errok = 1, areaok = 1, sizeok = 1;
+    for (int k = 0; k < 3; k++) {
+        const double* x = z[k].xy;
+        const double* y = z[k].xy + z[k].nv;
+        double aseg = M_PI * (z[k].ro * z[k].ro - z[k].ri * z[k].ri) / z[k].nseg;
+
+        closed &= x[0] == x[z[k].nv - 1] && y[0] == y[z[k].nv - 1];
+        errok &= max_error(&z[k]) <= 1.01 * pe;
+        areaok &= fabs(fabs(polygon_area(&z[k])) - aseg) < 1e-3 * aseg;
+        sizeok &= z[k].nv <= ZG_MAX_VERT + 3;
+    }
+    TEST_ASSERT(closed, "Segment polygons are closed");
+    TEST_ASSERT(errok, "Polygon error does not exceed the requested value");
+    TEST_ASSERT(areaok, "Equal-area segments have the area of the ring segment");
+    TEST_ASSERT(sizeok, "Segments have at most about 800 vertices");
+    TEST_ASSERT(z[0].xy[z[0].nv - 2] == 0.0 && z[0].xy[2 * z[0].nv - 2] == 0.0,
+                "Central zone is a sector");
+    TEST_ASSERT(polygon_area(&z[1]) < 0.0, "Segments are clockwise, as in gdsii_zonelens");
+    zg_zones_free(z, 3);
+
+    zg_zone_t bad[2] = {{10.0, 20.0, 0, NULL, 0}, {30.0, 25.0, 0, NULL, 0}};
+    TEST_ASSERT(zg_zones(bad, 2, pe, ZG_EQUAL_AREA, ZG_MAX_VERT, 1) == 1 && bad[0].xy == NULL,
+                "Invalid zone radii are rejected");
+    TEST_ASSERT(zg_zones(z, 1, -1.0, ZG_EQUAL_AREA, ZG_MAX_VERT, 1) == 1,
+                "Invalid polygon error is rejected");
+}
+
+/*
+ * Test 3: segments without vertex limit
+ */
+static void test_large_segments(void) {
+    printf("\n=== Test 3: Large Segments ===\n");
+
+    zg_zone_t z = {1e5, 1e5 + 1, 0, NULL, 0};
+    char msg[128];
+
+    TEST_ASSERT(zg_zones(&z, 1, 1e-4, ZG_EQUAL_AREA, (size_t)1 << 30, 1) == 0,
+                "Zone with unlimited segment size is computed");
+    snprintf(msg, sizeof(msg), "%d segments with %zu vertices", z.nseg, z.nv);
+    TEST_ASSERT(z.nseg == ZG_MIN_SEG && z.nv > 8191, msg);
+    TEST_ASSERT(max_error(&z) <= 1.01e-4, "Polygon error of the large segment");
+    zg_zones_free(&z, 1);
+}
+
+/*
+ * Test 4: parallel computation
+ */
+static void test_parallel(void) {
+    printf("\n=== Test 4: Parallel Computation ===\n");
+
+    const size_t nz = 5000;
+    zg_zone_t* z1 = calloc(nz, sizeof(zg_zone_t));
+    zg_zone_t* z2 = calloc(nz, sizeof(zg_zone_t));
+    struct timespec t0, t1, t2;
+    size_t nvert = 0;
+    int same = 1;
+    char msg[160];
+
+    for (size_t k = 0; k < nz; k++) {
+        z1[k].ri = z2[k].ri = 100.0 * sqrt(2.0 * k + 1);
+        z1[k].ro = z2[k].ro = 100.0 * sqrt(2.0 * k + 2);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int e1 = zg_zones(z1, nz, 1e-3, ZG_EQUAL_AREA, ZG_MAX_VERT, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    int e2 = zg_zones(z2, nz, 1e-3, ZG_EQUAL_AREA, ZG_MAX_VERT, 4);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+
+    for (size_t k = 0; k < nz && same && !e1 && !e2; k++) {
+        same = z1[k].nseg == z2[k].nseg && z1[k].nv == z2[k].nv &&
+               !memcmp(z1[k].xy, z2[k].xy, 2 * z1[k].nv * sizeof(double));
+        nvert += z1[k].nv;
+    }
+    TEST_ASSERT(!e1 && !e2, "Zones are computed with one and with four threads");
+    TEST_ASSERT(same, "Parallel computation gives the same polygons");
+
+    snprintf(msg, sizeof(msg), "%zu zones, %zu segment vertices: %.1f ms (1 thread), %.1f ms (4 threads)",
+             nz, nvert, 1e3 * (t1.tv_sec - t0.tv_sec) + 1e-6 * (t1.tv_nsec - t0.tv_nsec),
+             1e3 * (t2.tv_sec - t1.tv_sec) + 1e-6 * (t2.tv_nsec - t1.tv_nsec));
+    TEST_ASSERT(nvert > 0, msg);
+
+    zg_zones_free(z1, nz);
+    zg_zones_free(z2, nz);
+    free(z1);
+    free(z2);
+}
+
+int main(void) {
+    printf("\n=== GDSII Toolbox - Zone Plate Generation Tests ===\n");
+
+    test_arcs();
+    test_zones();
+    test_large_segments();
+    test_parallel();
+
+    printf("\n=== Test Summary ===\n");
+    printf("Total tests: %d\n", tests_run);
+    printf("Passed: %d\n", tests_passed);
+    printf("Failed: %d\n", tests_failed);
+
+    return tests_failed == 0 ? 0 : 1;
+}